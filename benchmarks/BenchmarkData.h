@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <MMCZip.h>
+
+// made up inputs for the benchmarks, always the same for the same arguments
+
+inline QByteArray randomData(qint64 size, quint32 seed = 1)
+{
+    QRandomGenerator random(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (qint64 i = 0; i < size; i++)
+        data[i] = static_cast<char>(random.bounded(256));
+    return data;
+}
+
+/// write a Fabric mod jar with `classes` class files of a few KiB each to `path`
+inline bool makeModJar(const QString& path, const QString& id, int classes)
+{
+    QTemporaryDir contents;
+    QDir root(contents.path());
+    auto write = [&root](const QString& name, const QByteArray& data) {
+        root.mkpath(QFileInfo(root.filePath(name)).path());
+        QFile file(root.filePath(name));
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    };
+
+    auto manifest = QString(R"({ "schemaVersion": 1, "id": "%1", "version": "1.0.%2", "name": "Mod %1",
+        "description": "A mod made up for the benchmarks", "authors": [ "Steve" ], "icon": "assets/%1/icon.png",
+        "depends": { "fabricloader": ">=0.14", "minecraft": "1.20.x" } })")
+                        .arg(id)
+                        .arg(classes);
+    if (!write("fabric.mod.json", manifest.toUtf8()))
+        return false;
+    for (int i = 0; i < classes; i++) {
+        if (!write(QString("com/example/%1/Class%2.class").arg(id).arg(i), randomData(2048 + (i % 7) * 512, i)))
+            return false;
+    }
+
+    QFileInfoList files;
+    MMCZip::collectFileListRecursively(root.path(), {}, &files, {});
+    return MMCZip::compressDirFiles(path, root.path(), files);
+}
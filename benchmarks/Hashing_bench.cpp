@@ -0,0 +1,49 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <modplatform/helpers/HashUtils.h>
+
+#include "BenchmarkData.h"
+
+class HashingBenchmark : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_file;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_file = m_dir.filePath("data.jar");
+        QFile file(m_file);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        // about a big mod
+        file.write(randomData(32 * 1024 * 1024));
+    }
+
+    void benchmark_hashFile_data()
+    {
+        QTest::addColumn<QStringList>("types");
+        QTest::newRow("murmur2") << QStringList({ "murmur2" });
+        QTest::newRow("sha1") << QStringList({ "sha1" });
+        QTest::newRow("sha512") << QStringList({ "sha512" });
+        QTest::newRow("md5") << QStringList({ "md5" });
+        QTest::newRow("every provider") << QStringList({ "murmur2", "sha1", "sha512" });
+    }
+
+    void benchmark_hashFile()
+    {
+        QFETCH(QStringList, types);
+        QBENCHMARK
+        {
+            auto result = Hashing::hashFile(m_file, types);
+            QCOMPARE(result.hashes.size(), types.size());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(HashingBenchmark)
+
+#include "Hashing_bench.moc"
@@ -0,0 +1,83 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheBenchmark : public QObject {
+    Q_OBJECT
+
+    // a cache with about as many entries as the libraries and assets of a few modpacks
+    static constexpr int entries = 5000;
+
+    QTemporaryDir m_dir;
+
+    void fill(HttpMetaCache& cache)
+    {
+        for (int i = 0; i < entries; i++) {
+            auto path = QString("lib%1/artifact-%2.jar").arg(i % 50).arg(i);
+            auto entry = cache.resolveEntry("libraries", path);
+            QDir().mkpath(QFileInfo(entry->getFullPath()).absolutePath());
+            QFile file(entry->getFullPath());
+            if (file.open(QIODevice::WriteOnly))
+                file.write(QByteArray::number(i));
+            file.close();
+            auto md5 = QString("%1").arg(i, 32, 16, QChar('0'));
+            entry->setMD5Sum(md5);
+            entry->setETag("\"" + md5 + "\"");
+            entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+            entry->setStale(false);
+            cache.updateEntry(entry);
+        }
+    }
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        HttpMetaCache cache(m_dir.filePath("metacache"));
+        cache.addBase("libraries", m_dir.filePath("libraries"));
+        cache.Load();
+        fill(cache);
+        cache.SaveNow();
+    }
+
+    void benchmark_load()
+    {
+        QBENCHMARK
+        {
+            HttpMetaCache cache(m_dir.filePath("metacache"));
+            cache.addBase("libraries", m_dir.filePath("libraries"));
+            cache.Load();
+        }
+    }
+
+    void benchmark_save()
+    {
+        HttpMetaCache cache(m_dir.filePath("metacache"));
+        cache.addBase("libraries", m_dir.filePath("libraries"));
+        cache.Load();
+        QBENCHMARK
+        {
+            cache.SaveNow();
+        }
+    }
+
+    void benchmark_resolve()
+    {
+        HttpMetaCache cache(m_dir.filePath("metacache"));
+        cache.addBase("libraries", m_dir.filePath("libraries"));
+        cache.Load();
+        QBENCHMARK
+        {
+            for (int i = 0; i < entries; i++)
+                cache.resolveEntry("libraries", QString("lib%1/artifact-%2.jar").arg(i % 50).arg(i));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheBenchmark)
+
+#include "HttpMetaCache_bench.moc"
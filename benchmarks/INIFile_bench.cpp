@@ -0,0 +1,57 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <settings/INIFile.h>
+
+class INIFileBenchmark : public QObject {
+    Q_OBJECT
+
+    // about what a global config with every page visited holds
+    static void fill(INIFile& ini)
+    {
+        for (int i = 0; i < 300; i++) {
+            ini.set(QString("Key%1").arg(i), QString("some value with spaces and = signs %1").arg(i));
+            ini.set(QString("Flag%1").arg(i), i % 2 == 0);
+            ini.set(QString("Number%1").arg(i), i * 1024);
+        }
+        ini.set("JvmArgs", "-XX:+UseG1GC -XX:+ParallelRefProcEnabled -XX:MaxGCPauseMillis=200 -Dfile.encoding=UTF-8");
+        ini.set("Paths", QStringList({ "C:\\Users\\Steve\\AppData\\Roaming", "/home/steve/.local/share", "\"quoted\"" }));
+    }
+
+   private slots:
+    void benchmark_load()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("benchmark.cfg");
+        {
+            INIFile ini;
+            fill(ini);
+            QVERIFY(ini.saveFile(path));
+        }
+
+        QBENCHMARK
+        {
+            INIFile ini;
+            ini.loadFile(path);
+        }
+    }
+
+    void benchmark_save()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("benchmark.cfg");
+        INIFile ini;
+        fill(ini);
+        int round = 0;
+        QBENCHMARK
+        {
+            // a save that changes nothing is skipped
+            ini.set("Round", round++);
+            ini.saveFile(path);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(INIFileBenchmark)
+
+#include "INIFile_bench.moc"
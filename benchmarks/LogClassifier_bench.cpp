@@ -0,0 +1,64 @@
+#include <QDebug>
+#include <QFile>
+#include <QTest>
+
+#include <minecraft/MinecraftLogClassifier.h>
+
+class LogClassifierBenchmark : public QObject {
+    Q_OBJECT
+
+    // set PRISM_BENCHMARK_LOG to a captured game log (for example a large Forge debug log) to measure that instead
+    static QStringList log()
+    {
+        auto path = qEnvironmentVariable("PRISM_BENCHMARK_LOG");
+        if (!path.isEmpty()) {
+            QFile file(path);
+            if (file.open(QIODevice::ReadOnly))
+                return QString::fromUtf8(file.readAll()).remove(QChar::CarriageReturn).split(QChar::LineFeed);
+            qWarning() << "Couldn't read" << path << ", using a made up log";
+        }
+
+        static const QStringList sample = {
+            "[12:00:01] [main/INFO]: Loading tweak class name net.minecraftforge.fml.common.launcher.FMLTweaker",
+            "[12:00:02] [Render thread/DEBUG] [net.minecraftforge.registries.GameData/REGISTRIES]: Registry Block Add: minecraft:stone",
+            "[12:00:02] [Worker-Main-1/WARN] [mixin/]: Reference map 'examplemod.refmap.json' could not be read",
+            "2013-08-01 12:00:03 [INFO] [ForgeModLoader] Forge Mod Loader version 6.2.62.771 for Minecraft 1.6.2 loading",
+            "2013-08-01 12:00:03 [SEVERE] [ForgeModLoader] Caught exception from examplemod",
+            "java.lang.NullPointerException: Cannot invoke \"Object.toString()\" because \"value\" is null",
+            "\tat net.minecraft.client.Minecraft.run(Minecraft.java:123)",
+            "\t... 12 more",
+            "Just a plain line printed by some mod",
+        };
+        QStringList lines;
+        for (int i = 0; i < 20000; i++)
+            lines.append(sample);
+        return lines;
+    }
+
+   private slots:
+    void benchmark_classifyLines()
+    {
+        auto lines = log();
+        MinecraftLogClassifier classifier;
+        QBENCHMARK
+        {
+            for (auto& line : lines)
+                classifier.classify(line, MessageLevel::StdOut);
+        }
+    }
+
+    void benchmark_classifyBatch()
+    {
+        auto lines = log();
+        MinecraftLogClassifier classifier;
+        QBENCHMARK
+        {
+            QVector<MessageLevel::Enum> levels(lines.size(), MessageLevel::StdOut);
+            classifier.classify(lines, levels);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(LogClassifierBenchmark)
+
+#include "LogClassifier_bench.moc"
@@ -0,0 +1,44 @@
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/mod/tasks/LocalModParseTask.h>
+
+#include "BenchmarkData.h"
+
+class ModParseBenchmark : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QFileInfoList m_jars;
+
+   private slots:
+    // set PRISM_BENCHMARK_MODS to a mods folder to parse that instead
+    void initTestCase()
+    {
+        auto folder = qEnvironmentVariable("PRISM_BENCHMARK_MODS");
+        if (folder.isEmpty()) {
+            QVERIFY(m_dir.isValid());
+            for (int i = 0; i < 100; i++)
+                QVERIFY(makeModJar(m_dir.filePath(QString("mod%1.jar").arg(i)), QString("mod%1").arg(i), 20 + i % 80));
+            folder = m_dir.path();
+        }
+        m_jars = QDir(folder).entryInfoList({ "*.jar", "*.zip" }, QDir::Files);
+        QVERIFY(!m_jars.isEmpty());
+    }
+
+    void benchmark_parse()
+    {
+        QBENCHMARK
+        {
+            for (auto& jar : m_jars) {
+                LocalModParseTask task(0, ResourceType::ZIPFILE, jar);
+                task.start();
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ModParseBenchmark)
+
+#include "ModParse_bench.moc"
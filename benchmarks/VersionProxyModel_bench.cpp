@@ -0,0 +1,88 @@
+#include <QTest>
+
+#include <BaseVersion.h>
+#include <BaseVersionList.h>
+#include <Filter.h>
+#include <VersionProxyModel.h>
+
+class BenchmarkVersion : public BaseVersion {
+   public:
+    BenchmarkVersion(const QString& name, const QString& type, qint64 time) : m_name(name), m_type(type), m_time(time) {}
+    QString descriptor() override { return m_name; }
+    QString name() override { return m_name; }
+    QString typeString() const override { return m_type; }
+
+    QString m_name;
+    QString m_type;
+    qint64 m_time;
+};
+
+// about as many versions as the Minecraft list has, snapshots included
+class BenchmarkVersionList : public BaseVersionList {
+   public:
+    BenchmarkVersionList()
+    {
+        for (int i = 0; i < 5000; i++) {
+            bool snapshot = i % 4 != 0;
+            auto name = snapshot ? QString("%1w%2a").arg(10 + i / 200).arg(i % 52) : QString("1.%1.%2").arg(i / 200).arg(i % 10);
+            m_versions.append(std::make_shared<BenchmarkVersion>(name, snapshot ? "snapshot" : "release", i));
+        }
+    }
+
+    Task::Ptr getLoadTask() override { return nullptr; }
+    bool isLoaded() override { return true; }
+    const BaseVersion::Ptr at(int i) const override { return m_versions.at(i); }
+    int count() const override { return m_versions.size(); }
+    void sortVersions() override {}
+    RoleList providesRoles() const override { return { VersionPointerRole, VersionRole, VersionIdRole, TypeRole, SortRole }; }
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        if (role == SortRole && index.isValid())
+            return m_versions.at(index.row())->m_time;
+        return BaseVersionList::data(index, role);
+    }
+
+   protected:
+    void updateListData(QList<BaseVersion::Ptr>) override {}
+
+   private:
+    QList<std::shared_ptr<BenchmarkVersion>> m_versions;
+};
+
+class VersionProxyModelBenchmark : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void benchmark_filter()
+    {
+        BenchmarkVersionList list;
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        QBENCHMARK
+        {
+            model.setFilter(BaseVersionList::TypeRole, new ExactFilter("release"));
+            model.setFilter(BaseVersionList::TypeRole, new ExactFilter("snapshot"));
+            model.clearFilters();
+        }
+    }
+
+    // typing a version into the search box, one character at a time, then clearing it
+    void benchmark_search()
+    {
+        BenchmarkVersionList list;
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        const QString typed = "1.12.5";
+        QBENCHMARK
+        {
+            for (int i = 1; i <= typed.size(); i++)
+                model.setSearch(typed.left(i));
+            model.setSearch({});
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionProxyModelBenchmark)
+
+#include "VersionProxyModel_bench.moc"
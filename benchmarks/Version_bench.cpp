@@ -0,0 +1,73 @@
+#include <QTest>
+
+#include <Version.h>
+
+#include <algorithm>
+
+class VersionBenchmark : public QObject {
+    Q_OBJECT
+
+    // releases, pre-releases, loader versions and snapshots, shuffled
+    static QList<Version> versions()
+    {
+        QList<Version> versions;
+        for (int minor = 0; minor <= 20; minor++) {
+            for (int patch = 0; patch <= 6; patch++) {
+                versions.append(Version(QString("1.%1.%2").arg(minor).arg(patch)));
+                versions.append(Version(QString("1.%1.%2-pre%3").arg(minor).arg(patch).arg(patch + 1)));
+                versions.append(Version(QString("1.%1.%2-rc1").arg(minor).arg(patch)));
+            }
+            for (int loader = 0; loader < 40; loader++)
+                versions.append(Version(QString("%1.%2.%3+build.%4").arg(minor + 20).arg(loader / 10).arg(loader % 10).arg(loader)));
+        }
+        for (int year = 13; year <= 23; year++) {
+            for (int week = 1; week <= 52; week += 3)
+                versions.append(Version(QString("%1w%2a").arg(year).arg(week, 2, 10, QChar('0'))));
+        }
+        for (int i = 0; i < versions.size(); i++)
+            versions.swapItemsAt(i, (i * 7919) % versions.size());
+        return versions;
+    }
+
+   private slots:
+    void benchmark_parse()
+    {
+        QStringList strings;
+        for (auto& version : versions())
+            strings.append(version.toString());
+        QList<Version> parsed;
+        parsed.reserve(strings.size());
+        QBENCHMARK
+        {
+            parsed.clear();
+            for (auto& string : strings)
+                parsed.append(Version(string));
+        }
+    }
+
+    void benchmark_compare()
+    {
+        auto list = versions();
+        int less = 0;
+        QBENCHMARK
+        {
+            for (int i = 1; i < list.size(); i++)
+                less += list[i - 1] < list[i];
+        }
+        QVERIFY(less > 0);
+    }
+
+    void benchmark_sort()
+    {
+        auto list = versions();
+        QBENCHMARK
+        {
+            auto sorted = list;
+            std::sort(sorted.begin(), sorted.end());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionBenchmark)
+
+#include "Version_bench.moc"
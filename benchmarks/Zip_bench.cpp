@@ -0,0 +1,55 @@
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <MMCZip.h>
+
+#include "BenchmarkData.h"
+
+class ZipBenchmark : public QObject {
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QFileInfoList m_jars;
+
+   private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        QDir().mkpath(m_dir.filePath("jars"));
+        for (int i = 0; i < 10; i++) {
+            auto path = m_dir.filePath(QString("jars/mod%1.jar").arg(i));
+            QVERIFY(makeModJar(path, QString("mod%1").arg(i), 200));
+            m_jars.append(QFileInfo(path));
+        }
+    }
+
+    // what building a modded jar does
+    void benchmark_merge()
+    {
+        auto target = m_dir.filePath("merged.jar");
+        QBENCHMARK
+        {
+            QuaZip zip(target);
+            QVERIFY(zip.open(QuaZip::mdCreate));
+            QSet<QString> contained;
+            for (auto& jar : m_jars)
+                MMCZip::mergeZipFiles(&zip, jar, contained, [](const QString& name) { return name != "fabric.mod.json"; });
+            zip.close();
+        }
+    }
+
+    void benchmark_extract()
+    {
+        int round = 0;
+        QBENCHMARK
+        {
+            auto target = m_dir.filePath(QString("extracted%1").arg(round++));
+            QVERIFY(MMCZip::extractDir(m_jars.first().filePath(), target).has_value());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ZipBenchmark)
+
+#include "Zip_bench.moc"
@@ -41,9 +41,11 @@
  */
 
 #include "Application.h"
+#include "AsyncLogWriter.h"
 #include "BuildConfig.h"
 
 #include "DataMigrationTask.h"
+#include "DiskUsage.h"
 #include "net/PasteUpload.h"
 #include "pathmatcher/MultiMatcher.h"
 #include "pathmatcher/SimplePrefixMatcher.h"
@@ -87,28 +89,57 @@
 #include <QCommandLineParser>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QFileOpenEvent>
+#include <QFutureWatcher>
 #include <QIcon>
+#include <QJsonDocument>
 #include <QLibraryInfo>
 #include <QList>
 #include <QNetworkAccessManager>
 #include <QStringList>
 #include <QStyleFactory>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 #include <QTranslator>
 #include <QWindow>
 
 #include "InstanceList.h"
 #include "MTPixmapCache.h"
+#include "RemoteImageLoader.h"
+#include "minecraft/PrepareInstancesTask.h"
+#include "minecraft/mod/tasks/ResourceParseScheduler.h"
+#include "tasks/Executor.h"
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
+#include "minecraft/ServerPinger.h"
+#include "minecraft/mod/ModDetailsCache.h"
+#include "minecraft/mod/ModInventory.h"
+#include "minecraft/mod/ModIconCache.h"
+#include "modplatform/PackUpdatePreparer.h"
+#include "modplatform/flame/FlameFileCache.h"
+#include "modplatform/helpers/HashCache.h"
+#include "net/BandwidthScheduler.h"
+#include "net/ContentStore.h"
+#include "net/DownloadJournal.h"
 #include "net/HttpMetaCache.h"
+#include "net/PeerCache.h"
+#include "net/RefreshCoordinator.h"
+#include "net/SrvCache.h"
 
+#include "launch/LaunchCoordinator.h"
+
+#include "java/JavaCheckCache.h"
 #include "java/JavaUtils.h"
 
 #include "updater/ExternalUpdater.h"
 
+#include "tools/AsyncProfiler.h"
+#include "tools/FlightRecorder.h"
 #include "tools/JProfiler.h"
 #include "tools/JVisualVM.h"
 #include "tools/MCEditTool.h"
@@ -122,6 +153,8 @@
 #include <DesktopServices.h>
 #include <FileSystem.h>
 #include <LocalPeer.h>
+#include <PerfCounters.h>
+#include <Trace.h>
 
 #include <stdlib.h>
 #include <sys.h>
@@ -158,25 +191,41 @@
 
 static const QLatin1String liveCheckFile("live.check");
 
-PixmapCache* PixmapCache::s_instance = nullptr;
-
 namespace {
 
 /** This is used so that we can output to the log file in addition to the CLI. */
 void appDebugOutput(QtMsgType type, const QMessageLogContext& context, const QString& msg)
 {
-    static std::mutex loggerMutex;
-    const std::lock_guard<std::mutex> lock(loggerMutex);  // synchronized, QFile logFile is not thread-safe
+    static auto& lines = PerfCounters::counter("log.lines");
+    lines++;
 
     QString out = qFormatLogMessage(type, context, msg);
     out += QChar::LineFeed;
 
-    APPLICATION->logFile->write(out.toUtf8());
-    APPLICATION->logFile->flush();
-    QTextStream(stderr) << out.toLocal8Bit();
-    fflush(stderr);
+    APPLICATION->logWriter->write(std::move(out));
+    // what comes before a crash has to be in the log
+    if (type == QtCriticalMsg || type == QtFatalMsg)
+        APPLICATION->logWriter->flush();
 }
 
+// times a part of the startup, for the log, the trace and the performance counters
+class StartupPhase {
+   public:
+    explicit StartupPhase(QString name) : m_name(std::move(name)), m_begin(Trace::now()) { m_timer.start(); }
+    ~StartupPhase()
+    {
+        auto ms = m_timer.elapsed();
+        PerfCounters::counter("startup." + m_name + "_ms") = ms;
+        Trace::complete("startup", m_name, m_begin);
+        qDebug() << "<>" << m_name << "took" << ms << "ms";
+    }
+
+   private:
+    QString m_name;
+    qint64 m_begin;
+    QElapsedTimer m_timer;
+};
+
 }  // namespace
 
 std::tuple<QDateTime, QString, QString, QString, QString> read_lock_File(const QString& path)
@@ -207,6 +256,128 @@ std::tuple<QDateTime, QString, QString, QString, QString> read_lock_File(const Q
     return std::make_tuple(timestamp, from, to, target, data_path);
 }
 
+void Application::addCommandLineOptions(QCommandLineParser& parser)
+{
+    parser.setApplicationDescription(BuildConfig.LAUNCHER_DISPLAYNAME);
+
+    parser.addOptions(
+        { { { "d", "dir" }, "Use a custom path as application root (use '.' for current directory)", "directory" },
+          { { "l", "launch" }, "Launch the specified instance (by instance ID)", "instance" },
+          { { "s", "server" }, "Join the specified server on launch (only valid in combination with --launch)", "address" },
+          { { "a", "profile" }, "Use the account specified by its profile name (only valid in combination with --launch)", "profile" },
+          { "alive", "Write a small '" + liveCheckFile + "' file after the launcher starts" },
+          { { "I", "import" }, "Import instance or resource from specified local path or URL", "url" },
+          { "show", "Opens the window for the specified instance (by instance ID)", "show" },
+          { "trace", "Record what the launcher spends its time on to a file, for chrome://tracing or Perfetto", "file" },
+          { "perf-stats", "Write the performance counters to the log when the launcher quits" },
+          { "background", "Keep running without a window, for later invocations to hand their commands to" },
+          { "quit", "Ask the launcher running in the background to quit once nothing is left open" },
+          { "prepare",
+            "Update the specified instances (by instance ID, comma separated, or 'all') and check their mods for updates without a "
+            "window, reporting progress on stdout as JSON lines",
+            "instances" } });
+    // Has to be positional for some OS to handle that properly
+    parser.addPositionalArgument("URL", "Import the resource(s) at the given URL(s) (same as -I / --import)", "[URL...]");
+
+    parser.addHelpOption();
+    parser.addVersionOption();
+}
+
+QString Application::rootPathFor(const QString& binPath)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD) || defined(Q_OS_OPENBSD)
+    return QDir(FS::PathCombine(binPath, "..")).absolutePath();  // typically portable-root or /usr
+#elif defined(Q_OS_MAC)
+    return QDir(FS::PathCombine(binPath, "../..")).absolutePath();
+#else
+    return binPath;
+#endif
+}
+
+QString Application::dataPathFor(const QString& dirParam, const QString& rootPath, bool& portable, QString& adjustedBy)
+{
+    if (!dirParam.isEmpty()) {
+        // the dir param. it makes multimc data path point to whatever the user specified
+        // on command line
+        adjustedBy = "Command line";
+        return dirParam;
+    }
+
+    QDir foo;
+    if (DesktopServices::isSnap()) {
+        foo = QDir(getenv("SNAP_USER_COMMON"));
+    } else {
+        foo = QDir(FS::PathCombine(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation), ".."));
+    }
+    adjustedBy = "Persistent data path";
+
+#ifndef Q_OS_MACOS
+    if (QFile::exists(FS::PathCombine(rootPath, "portable.txt"))) {
+        adjustedBy = "Portable data path";
+        portable = true;
+        return rootPath;
+    }
+#endif
+    return foo.absolutePath();
+}
+
+QList<ApplicationMessage> Application::forwardedCommands(const QCommandLineParser& parser)
+{
+    if (parser.isSet("quit"))
+        return { { "quit", {} } };
+
+    auto id = parser.value("launch");
+    if (!id.isEmpty()) {
+        ApplicationMessage launch{ "launch", { { "id", id } } };
+        if (parser.isSet("server"))
+            launch.args["server"] = parser.value("server");
+        if (parser.isSet("profile"))
+            launch.args["profile"] = parser.value("profile");
+        return { launch };
+    }
+
+    QList<ApplicationMessage> commands = { { "activate", {} } };
+    for (auto& url : parser.values("import") + parser.positionalArguments())
+        commands.append({ "import", { { "url", normalizeImportUrl(url).toString() } } });
+    return commands;
+}
+
+bool Application::forwardToRunningInstance(int& argc, char** argv)
+{
+    QCoreApplication core(argc, argv);
+    // the data path depends on these
+    core.setOrganizationName(BuildConfig.LAUNCHER_NAME);
+    core.setOrganizationDomain(BuildConfig.LAUNCHER_DOMAIN);
+    core.setApplicationName(BuildConfig.LAUNCHER_NAME);
+
+    QCommandLineParser parser;
+    addCommandLineOptions(parser);
+    // the full application tells about mistakes, answers --help and starts what isn't running yet
+    if (!parser.parse(core.arguments()) || parser.isSet("help") || parser.isSet("version") || parser.isSet("background") ||
+        parser.isSet("prepare"))
+        return false;
+    if ((parser.isSet("server") || parser.isSet("profile")) && !parser.isSet("launch"))
+        return false;
+
+    bool portable = false;
+    QString adjustedBy;
+    auto dataPath = dataPathFor(parser.value("dir"), rootPathFor(QCoreApplication::applicationDirPath()), portable, adjustedBy);
+    // import paths are relative to where we were started
+    auto commands = forwardedCommands(parser);
+
+    // the id of a running copy comes from its working directory, as the system resolves it
+    auto cwd = QDir::currentPath();
+    if (!QDir(dataPath).exists() || !QDir::setCurrent(dataPath))
+        return false;
+    auto appID = ApplicationId::fromPathAndVersion(QDir::currentPath(), BuildConfig.printableVersionString());
+    QDir::setCurrent(cwd);
+
+    LocalPeer peer(nullptr, appID);
+    if (!peer.isClient())
+        return false;
+    return peer.sendMessage(ApplicationMessage::serializeBatch(commands), 2000);
+}
+
 Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 {
 #if defined Q_OS_WIN32
@@ -228,31 +399,26 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // Commandline parsing
     QCommandLineParser parser;
-    parser.setApplicationDescription(BuildConfig.LAUNCHER_DISPLAYNAME);
-
-    parser.addOptions(
-        { { { "d", "dir" }, "Use a custom path as application root (use '.' for current directory)", "directory" },
-          { { "l", "launch" }, "Launch the specified instance (by instance ID)", "instance" },
-          { { "s", "server" }, "Join the specified server on launch (only valid in combination with --launch)", "address" },
-          { { "a", "profile" }, "Use the account specified by its profile name (only valid in combination with --launch)", "profile" },
-          { "alive", "Write a small '" + liveCheckFile + "' file after the launcher starts" },
-          { { "I", "import" }, "Import instance or resource from specified local path or URL", "url" },
-          { "show", "Opens the window for the specified instance (by instance ID)", "show" } });
-    // Has to be positional for some OS to handle that properly
-    parser.addPositionalArgument("URL", "Import the resource(s) at the given URL(s) (same as -I / --import)", "[URL...]");
-
-    parser.addHelpOption();
-    parser.addVersionOption();
-
+    addCommandLineOptions(parser);
     parser.process(arguments());
 
     m_instanceIdToLaunch = parser.value("launch");
     m_serverToJoin = parser.value("server");
     m_profileToUse = parser.value("profile");
     m_liveCheck = parser.isSet("alive");
+    m_dumpPerfStats = parser.isSet("perf-stats");
+    m_background = parser.isSet("background");
+    for (auto& ids : parser.values("prepare"))
+        m_instancesToPrepare.append(ids.split(',', Qt::SkipEmptyParts));
 
     m_instanceIdToShowWindowOf = parser.value("show");
 
+    // before the working directory changes to the data directory
+    if (auto tracePath = parser.value("trace"); !tracePath.isEmpty()) {
+        QThread::currentThread()->setObjectName("Main");
+        Trace::start(QFileInfo(tracePath).absoluteFilePath());
+    }
+
     for (auto url : parser.values("import")) {
         m_urlsToImport.append(normalizeImportUrl(url));
     }
@@ -272,49 +438,15 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
     QString origcwdPath = QDir::currentPath();
     QString binPath = applicationDirPath();
 
-    {
-        // Root path is used for updates and portable data
-#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD) || defined(Q_OS_OPENBSD)
-        QDir foo(FS::PathCombine(binPath, ".."));  // typically portable-root or /usr
-        m_rootPath = foo.absolutePath();
-#elif defined(Q_OS_WIN32)
-        m_rootPath = binPath;
-#elif defined(Q_OS_MAC)
-        QDir foo(FS::PathCombine(binPath, "../.."));
-        m_rootPath = foo.absolutePath();
-        // on macOS, touch the root to force Finder to reload the .app metadata (and fix any icon change issues)
-        FS::updateTimestamp(m_rootPath);
+    // Root path is used for updates and portable data
+    m_rootPath = rootPathFor(binPath);
+#if defined(Q_OS_MAC)
+    // on macOS, touch the root to force Finder to reload the .app metadata (and fix any icon change issues)
+    FS::updateTimestamp(m_rootPath);
 #endif
-    }
 
     QString adjustedBy;
-    QString dataPath;
-    // change folder
-    QString dirParam = parser.value("dir");
-    if (!dirParam.isEmpty()) {
-        // the dir param. it makes multimc data path point to whatever the user specified
-        // on command line
-        adjustedBy = "Command line";
-        dataPath = dirParam;
-    } else {
-        QDir foo;
-        if (DesktopServices::isSnap()) {
-            foo = QDir(getenv("SNAP_USER_COMMON"));
-        } else {
-            foo = QDir(FS::PathCombine(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation), ".."));
-        }
-
-        dataPath = foo.absolutePath();
-        adjustedBy = "Persistent data path";
-
-#ifndef Q_OS_MACOS
-        if (QFile::exists(FS::PathCombine(m_rootPath, "portable.txt"))) {
-            dataPath = m_rootPath;
-            adjustedBy = "Portable data path";
-            m_portable = true;
-        }
-#endif
-    }
+    QString dataPath = dataPathFor(parser.value("dir"), m_rootPath, m_portable, adjustedBy);
 
     if (!FS::ensureFolderPathExists(dataPath)) {
         showFatalErrorMessage(
@@ -352,34 +484,19 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_peerInstance = new LocalPeer(this, appID);
         connect(m_peerInstance, &LocalPeer::messageReceived, this, &Application::messageReceived);
         if (m_peerInstance->isClient()) {
-            int timeout = 2000;
-
-            if (m_instanceIdToLaunch.isEmpty()) {
-                ApplicationMessage activate;
-                activate.command = "activate";
-                m_peerInstance->sendMessage(activate.serialize(), timeout);
-
-                if (!m_urlsToImport.isEmpty()) {
-                    for (auto url : m_urlsToImport) {
-                        ApplicationMessage import;
-                        import.command = "import";
-                        import.args.insert("url", url.toString());
-                        m_peerInstance->sendMessage(import.serialize(), timeout);
-                    }
-                }
-            } else {
-                ApplicationMessage launch;
-                launch.command = "launch";
-                launch.args["id"] = m_instanceIdToLaunch;
-
-                if (!m_serverToJoin.isEmpty()) {
-                    launch.args["server"] = m_serverToJoin;
-                }
-                if (!m_profileToUse.isEmpty()) {
-                    launch.args["profile"] = m_profileToUse;
-                }
-                m_peerInstance->sendMessage(launch.serialize(), timeout);
+            if (!m_instancesToPrepare.isEmpty()) {
+                // both would write the same files
+                std::cerr << "Instances can't be prepared while the launcher is running on the same data!" << std::endl;
+                m_status = Application::Failed;
+                return;
             }
+            int timeout = 2000;
+            m_peerInstance->sendMessage(ApplicationMessage::serializeBatch(forwardedCommands(parser)), timeout);
+            m_status = Application::Succeeded;
+            return;
+        }
+        if (parser.isSet("quit")) {
+            // nothing is running that could quit
             m_status = Application::Succeeded;
             return;
         }
@@ -404,7 +521,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         for (auto i = 4; i > 0; i--)
             moveFile(logBase.arg(i - 1), logBase.arg(i));
 
-        logFile = std::unique_ptr<QFile>(new QFile(logBase.arg(0)));
+        auto logFile = std::make_unique<QFile>(logBase.arg(0));
         if (!logFile->open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
             showFatalErrorMessage("The launcher data folder is not writable!",
                                   QString("The launcher couldn't create a log file - the data folder is not writable.\n"
@@ -416,6 +533,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
                                       .arg(dataPath));
             return;
         }
+        logWriter = std::make_unique<AsyncLogWriter>(std::move(logFile), stderr);
         qInstallMessageHandler(appDebugOutput);
 
         qSetMessagePattern(
@@ -539,8 +657,11 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // Initialize application settings
     {
+        StartupPhase phase("settings");
         // Provide a fallback for migration from PolyMC
         m_settings.reset(new INISettingsObject({ BuildConfig.LAUNCHER_CONFIGFILE, "polymc.cfg", "multimc.cfg" }, this));
+        // sliders and text fields change settings a lot, write them out once they settle
+        m_settings->setSaveDelay(1000);
 
         // Theming
         m_settings->registerSetting("IconTheme", QString());
@@ -554,6 +675,20 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
         m_settings->registerSetting("NumberOfConcurrentTasks", 10);
         m_settings->registerSetting("NumberOfConcurrentDownloads", 6);
+        m_settings->registerSetting("NumberOfConcurrentUploads", 4);
+        m_settings->registerSetting("ScreenshotUploadMaxSize", 0);
+        m_settings->registerSetting("ScreenshotUploadRecompress", false);
+        // files bigger than this many MiB get downloaded in this many ranges at once, where the server allows it
+        m_settings->registerSetting("SegmentedDownloadThreshold", 32);
+        m_settings->registerSetting("SegmentedDownloadSegments", 4);
+        // more bases serving the same files, for failing over to, one group separated by spaces per line
+        m_settings->registerSetting("DownloadMirrors", QString());
+        // site-local pull-through caches to download through, an origin base and the cache's base per line
+        m_settings->registerSetting("DownloadCacheRules", QString());
+        // share downloaded files with the other launchers on the LAN doing the same, read on startup
+        m_settings->registerSetting("LanPeerCache", false);
+        // the most all downloads together may use, in KiB/s, 0 for no limit
+        m_settings->registerSetting("DownloadBandwidthLimit", 0);
 
         QString defaultMonospace;
         int defaultSize = 11;
@@ -581,6 +716,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_settings->registerSetting("ConsoleFontSize", defaultSize);
         m_settings->registerSetting("ConsoleMaxLines", 100000);
         m_settings->registerSetting("ConsoleOverflowStop", true);
+        m_settings->registerSetting("ConsoleSessionLogs", true);
+        m_settings->registerSetting("CollectJvmMetrics", false);
 
         // Folders
         m_settings->registerSetting("InstanceDir", "instances");
@@ -618,6 +755,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_settings->registerSetting({ "MinMemAlloc", "MinMemoryAlloc" }, 512);
         m_settings->registerSetting({ "MaxMemAlloc", "MaxMemoryAlloc" }, suitableMaxMem());
         m_settings->registerSetting("PermGen", 128);
+        m_settings->registerSetting("AutoTuneMemory", false);
 
         // Java Settings
         m_settings->registerSetting("JavaPath", "");
@@ -644,6 +782,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_settings->registerSetting("EnableFeralGamemode", false);
         m_settings->registerSetting("EnableMangoHud", false);
         m_settings->registerSetting("UseDiscreteGpu", false);
+        m_settings->registerSetting("UseClassDataSharing", false);
+        m_settings->registerSetting("PrewarmLaunchFiles", false);
 
         // Game time
         m_settings->registerSetting("ShowGameTime", true);
@@ -654,6 +794,10 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         // Minecraft mods
         m_settings->registerSetting("ModMetadataDisabled", false);
         m_settings->registerSetting("ModDependenciesDisabled", false);
+        // download new versions of managed modpacks ahead, so updating them takes no waiting
+        m_settings->registerSetting("PreparePackUpdates", false);
+        // fetch the game files of the version picked for a new instance while the dialog is still open
+        m_settings->registerSetting("PrefetchNewInstances", false);
 
         // Minecraft offline player name
         m_settings->registerSetting("LastOfflinePlayerName", "");
@@ -766,6 +910,17 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
         PixmapCache::setInstance(new PixmapCache(this));
 
+        for (int i = 0; i < PixmapCache::CategoryCount; i++) {
+            auto category = static_cast<PixmapCache::Category>(i);
+            auto prefix = "pixmaps." + PixmapCache::categoryName(category);
+            PerfCounters::addGauge(prefix + ".bytes", [category] { return PixmapCache::stats(category).bytes; });
+            PerfCounters::addGauge(prefix + ".hits", [category] { return PixmapCache::stats(category).hits; });
+            PerfCounters::addGauge(prefix + ".misses", [category] { return PixmapCache::stats(category).misses; });
+        }
+        PerfCounters::addGauge("threads.global", [] { return QThreadPool::globalInstance()->activeThreadCount(); });
+        PerfCounters::addGauge("threads.executor", [] { return Executor::instance()->activeThreadCount(); });
+        PerfCounters::addGauge("threads.parse", [] { return ResourceParseScheduler::instance()->activeThreadCount(); });
+
         qDebug() << "<> Settings loaded.";
     }
 
@@ -775,6 +930,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // initialize network access and proxy setup
     {
+        StartupPhase phase("network");
         m_network.reset(new QNetworkAccessManager());
         QString proxyTypeStr = settings()->get("ProxyType").toString();
         QString addr = settings()->get("ProxyAddr").toString();
@@ -787,6 +943,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // load translations
     {
+        StartupPhase phase("translations");
         m_translations.reset(new TranslationsModel("translations"));
         auto bcp47Name = m_settings->get("Language").toString();
         m_translations->selectLanguage(bcp47Name);
@@ -796,6 +953,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // Instance icons
     {
+        StartupPhase phase("icons");
         auto setting = APPLICATION->settings()->getSetting("IconsDir");
         QStringList instFolders = { ":/icons/multimc/32x32/instances/", ":/icons/multimc/50x50/instances/",
                                     ":/icons/multimc/128x128/instances/", ":/icons/multimc/scalable/instances/" };
@@ -806,10 +964,14 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
     }
 
     // Themes
-    m_themeManager = std::make_unique<ThemeManager>();
+    {
+        StartupPhase phase("themes");
+        m_themeManager = std::make_unique<ThemeManager>();
+    }
 
     // initialize and load all instances
     {
+        StartupPhase phase("instances");
         auto InstDirSetting = m_settings->getSetting("InstanceDir");
         // instance path: check for problems with '!' in instance path and warn the user in the log
         // and remember that we have to show him a dialog when the gui starts (if it does so)
@@ -820,13 +982,15 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         }
         m_instances.reset(new InstanceList(m_settings, instDir, this));
         connect(InstDirSetting.get(), &Setting::SettingChanged, m_instances.get(), &InstanceList::on_InstFolderChanged);
+        m_instances->setSnapshotPath("cache/instances.snapshot");
         qDebug() << "Loading Instances...";
+        // the instances show up as they get loaded in the background
         m_instances->loadList();
-        qDebug() << "<> Instances loaded.";
     }
 
     // and accounts
     {
+        StartupPhase phase("accounts");
         m_accounts.reset(new AccountList(this));
         qDebug() << "Loading accounts...";
         m_accounts->setListFilePath("accounts.json", true);
@@ -837,6 +1001,7 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 
     // init the http meta cache
     {
+        StartupPhase phase("metacache");
         m_metacache.reset(new HttpMetaCache("metacache"));
         m_metacache->addBase("asset_indexes", QDir("assets/indexes").absolutePath());
         m_metacache->addBase("asset_objects", QDir("assets/objects").absolutePath());
@@ -857,17 +1022,96 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_metacache->addBase("root", QDir::currentPath());
         m_metacache->addBase("translations", QDir("translations").absolutePath());
         m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
+        m_metacache->addBase("skins", QDir("cache/skins").absolutePath());
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->Load();
+        m_refreshCoordinator.reset(new RefreshCoordinator("refresh.json"));
+        m_packUpdatePreparer.reset(new PackUpdatePreparer("prepared_updates.json"));
+        m_srvCache.reset(new SrvCache("srv.json"));
+        m_serverPinger.reset(new ServerPinger(m_srvCache.get()));
         qDebug() << "<> Cache initialized.";
     }
 
-    // now we have network, download translation updates
-    m_translations->downloadIndex();
+    // the caches below are only loaded once the main window is up, by loadDeferred()
+
+    // and the hashes of local files, shared by all instances
+    {
+        m_hashCache.reset(new Hashing::HashCache("hashcache.json"));
+    }
+
+    // and what CurseForge said about pack files, so installs and updates only ask about new ones
+    {
+        m_flameFileCache.reset(new Flame::FileCache("flamefilecache.json"));
+    }
+
+    // and what probing the Java installations found out, so only new or updated ones are probed again
+    {
+        m_javaCheckCache.reset(new JavaCheckCache("javacheckcache.json"));
+    }
+
+    // and what's in the mod files, so they aren't opened again every time a mods page shows up
+    {
+        m_modDetailsCache.reset(new ModDetailsCache("moddetailscache.json"));
+    }
+
+    // and their icons, scaled down
+    {
+        m_modIconCache.reset(new ModIconCache(QDir("cache/modicons").absolutePath()));
+    }
+
+    // and the logos of projects on the mod platforms, scaled down too
+    {
+        m_remoteImageLoader.reset(
+            new RemoteImageLoader(QDir("cache/remoteimages").absolutePath(), m_settings->get("NumberOfConcurrentDownloads").toInt()));
+    }
+
+    // and how big folders are, so size columns don't walk them every time they show up
+    {
+        m_diskUsage.reset(new DiskUsage());
+    }
+
+    // and what launches going at the same time can do once for all of them
+    {
+        m_launchCoordinator.reset(new LaunchCoordinator());
+    }
+
+    // and which instances have which mods, indexed once someone asks
+    {
+        m_modInventory.reset(new ModInventory());
+    }
+
+    // downloaded files every instance can share, by their hash
+    {
+        m_contentStore.reset(new Net::ContentStore(QDir("store").absolutePath()));
+    }
+
+    // and the ones that didn't finish, to continue after a restart
+    {
+        m_downloadJournal.reset(new Net::DownloadJournal(QDir("downloads").absolutePath()));
+    }
+
+    // and with the other launchers on the LAN, for those that ask for it
+    if (m_settings->get("LanPeerCache").toBool()) {
+        m_peerCache.reset(new Net::PeerCache(m_contentStore.get()));
+        if (!m_peerCache->start())
+            m_peerCache.reset();
+    }
+
+    // the bandwidth every request shares
+    {
+        auto setting = m_settings->getSetting("DownloadBandwidthLimit");
+        Net::BandwidthScheduler::shared().setLimit(setting->get().toLongLong() * 1024);
+        connect(setting.get(), &Setting::SettingChanged,
+                [](const Setting&, QVariant value) { Net::BandwidthScheduler::shared().setLimit(value.toLongLong() * 1024); });
+    }
 
     // FIXME: what to do with these?
     m_profilers.insert("jprofiler", std::shared_ptr<BaseProfilerFactory>(new JProfilerFactory()));
     m_profilers.insert("jvisualvm", std::shared_ptr<BaseProfilerFactory>(new JVisualVMFactory()));
+    m_profilers.insert("jfr", std::shared_ptr<BaseProfilerFactory>(new FlightRecorderFactory()));
+    m_profilers.insert("async-profiler", std::shared_ptr<BaseProfilerFactory>(new AsyncProfilerFactory()));
+    // how long the built in profilers record
+    m_settings->registerSetting("ProfileRecordingSeconds", 60);
     for (auto profiler : m_profilers.values()) {
         profiler->registerSettings(m_settings);
     }
@@ -882,19 +1126,20 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
 #endif
 
     connect(this, &Application::aboutToQuit, [this]() {
+        // saving the caches while they load would lose what's still to come
+        m_deferredLoad.waitForFinished();
         if (m_instances) {
             // save any remaining instance state
             m_instances->saveNow();
         }
-        if (logFile) {
-            logFile->flush();
-            logFile->close();
-        }
+        SettingsObject::saveAllNow();
+        if (logWriter)
+            logWriter->flush();
     });
 
     updateCapabilities();
 
-    detectLibraries();
+    probeSystem();
 
     // check update locks
     {
@@ -1028,7 +1273,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         }
     }
 
-    if (createSetupWizard()) {
+    // nobody is there to go through it
+    if (m_instancesToPrepare.isEmpty() && createSetupWizard()) {
         return;
     }
 
@@ -1143,9 +1389,39 @@ void Application::setupWizardFinished(int status)
     performMainStartupAction();
 }
 
+void Application::loadDeferred()
+{
+    // nothing the main window shows needs these, the caches only make later work faster
+    m_deferredLoad = Executor::instance()->run(Executor::Priority::Background, [this] {
+        StartupPhase phase("caches");
+        m_hashCache->load();
+        m_flameFileCache->load();
+        m_javaCheckCache->load();
+        m_modDetailsCache->load();
+    });
+
+    // now we have network, download translation updates, right away while the language is still to be picked
+    auto interval = settings()->get("Language").toString().isEmpty() ? std::chrono::hours(0) : std::chrono::hours(6);
+    m_refreshCoordinator->add("translations", interval, [this] { m_translations->downloadIndex(); });
+    if (settings()->get("PreparePackUpdates").toBool())
+        m_refreshCoordinator->add("pack-updates", std::chrono::hours(6), [this] { m_packUpdatePreparer->checkAll(); });
+    m_refreshCoordinator->start();
+}
+
 void Application::performMainStartupAction()
 {
     m_status = Application::Initialized;
+    qDebug() << "<> Started up in" << timeSinceStart() << "ms";
+    PerfCounters::counter("startup.total_ms") = timeSinceStart();
+    // after the first window got to show itself
+    QTimer::singleShot(0, this, &Application::loadDeferred);
+    if (!m_instancesToPrepare.isEmpty()) {
+        prepareInstances();
+        return;
+    }
+    if (!m_instanceIdToLaunch.isEmpty() || !m_instanceIdToShowWindowOf.isEmpty()) {
+        instances()->waitForLoaded();
+    }
     if (!m_instanceIdToLaunch.isEmpty()) {
         auto inst = instances()->getInstanceById(m_instanceIdToLaunch);
         if (inst) {
@@ -1179,7 +1455,9 @@ void Application::performMainStartupAction()
             return;
         }
     }
-    if (!m_mainWindow) {
+    if (m_background && m_urlsToImport.isEmpty()) {
+        qDebug() << "<> Running in the background.";
+    } else if (!m_mainWindow) {
         // normal main window
         showMainWindow(false);
         qDebug() << "<> Main window shown.";
@@ -1204,6 +1482,36 @@ void Application::performMainStartupAction()
     }
 }
 
+void Application::prepareInstances()
+{
+    instances()->waitForLoaded();
+    QList<InstancePtr> toPrepare;
+    if (m_instancesToPrepare.contains("all")) {
+        for (int i = 0; i < instances()->count(); i++)
+            toPrepare.append(instances()->at(i));
+    } else {
+        for (auto& id : m_instancesToPrepare) {
+            auto inst = instances()->getInstanceById(id);
+            if (!inst) {
+                std::cerr << "There is no instance with the ID " << id.toStdString() << std::endl;
+                m_status = Application::Failed;
+                return;
+            }
+            toPrepare.append(inst);
+        }
+    }
+
+    qDebug() << "<> Preparing" << toPrepare.size() << "instances";
+    auto task = makeShared<PrepareInstancesTask>(toPrepare, m_settings->get("NumberOfConcurrentTasks").toInt());
+    connect(task.get(), &PrepareInstancesTask::report, this, [](const QJsonObject& line) {
+        QTextStream(stdout) << QJsonDocument(line).toJson(QJsonDocument::Compact) << '\n';
+        fflush(stdout);
+    });
+    connect(task.get(), &Task::finished, this, [this, done = task.get()] { exit(done->wasSuccessful() ? 0 : 1); });
+    m_prepareTask = task;
+    task->start();
+}
+
 void Application::showFatalErrorMessage(const QString& title, const QString& content)
 {
     m_status = Application::Failed;
@@ -1213,8 +1521,13 @@ void Application::showFatalErrorMessage(const QString& title, const QString& con
 
 Application::~Application()
 {
+    if (m_dumpPerfStats)
+        qDebug().noquote() << "Performance counters:\n" + PerfCounters::dump();
+    Trace::stop();
+
     // Shut down logger by setting the logger function to nothing
     qInstallMessageHandler(nullptr);
+    logWriter.reset();
 
 #if defined Q_OS_WIN32
     // Detach from Windows console
@@ -1234,9 +1547,12 @@ void Application::messageReceived(const QByteArray& message)
         return;
     }
 
-    ApplicationMessage received;
-    received.parse(message);
+    for (auto& received : ApplicationMessage::parseBatch(message))
+        handleMessage(received);
+}
 
+void Application::handleMessage(const ApplicationMessage& received)
+{
     auto& command = received.command;
 
     if (command == "activate") {
@@ -1247,7 +1563,11 @@ void Application::messageReceived(const QByteArray& message)
             qWarning() << "Received" << command << "message without a zip path/URL.";
             return;
         }
-        m_mainWindow->processURLs({ normalizeImportUrl(url) });
+        showMainWindow()->processURLs({ normalizeImportUrl(url) });
+    } else if (command == "quit") {
+        m_background = false;
+        if (shouldExitNow())
+            exit(0);
     } else if (command == "launch") {
         QString id = received.args["id"];
         QString server = received.args["server"];
@@ -1255,6 +1575,7 @@ void Application::messageReceived(const QByteArray& message)
 
         InstancePtr instance;
         if (!id.isEmpty()) {
+            instances()->waitForLoaded();
             instance = instances()->getInstanceById(id);
             if (!instance) {
                 qWarning() << "Launch command requires an valid instance ID. " << id << "resolves to nothing.";
@@ -1282,7 +1603,7 @@ void Application::messageReceived(const QByteArray& message)
 
         launch(instance, true, false, serverObject, accountObject);
     } else {
-        qWarning() << "Received invalid message" << message;
+        qWarning() << "Received invalid message" << command;
     }
 }
 
@@ -1406,7 +1727,7 @@ void Application::subRunningInstance()
 
 bool Application::shouldExitNow() const
 {
-    return m_runningInstances == 0 && m_openWindows == 0;
+    return !m_background && m_runningInstances == 0 && m_openWindows == 0;
 }
 
 bool Application::updatesAreAllowed()
@@ -1601,6 +1922,31 @@ shared_qobject_ptr<HttpMetaCache> Application::metacache()
     return m_metacache;
 }
 
+shared_qobject_ptr<Hashing::HashCache> Application::hashCache()
+{
+    return m_hashCache;
+}
+
+shared_qobject_ptr<RemoteImageLoader> Application::remoteImageLoader()
+{
+    return m_remoteImageLoader;
+}
+
+shared_qobject_ptr<Flame::FileCache> Application::flameFileCache()
+{
+    return m_flameFileCache;
+}
+
+shared_qobject_ptr<JavaCheckCache> Application::javaCheckCache()
+{
+    return m_javaCheckCache;
+}
+
+shared_qobject_ptr<ModDetailsCache> Application::modDetailsCache()
+{
+    return m_modDetailsCache;
+}
+
 shared_qobject_ptr<QNetworkAccessManager> Application::network()
 {
     return m_network;
@@ -1616,28 +1962,58 @@ shared_qobject_ptr<Meta::Index> Application::metadataIndex()
 
 void Application::updateCapabilities()
 {
-    m_capabilities = None;
+    m_capabilities = m_probedCapabilities;
     if (!getMSAClientID().isEmpty())
         m_capabilities |= SupportsMSA;
     if (!getFlameAPIKey().isEmpty())
         m_capabilities |= SupportsFlame;
+}
 
+void Application::probeSystem()
+{
 #ifdef Q_OS_LINUX
-    if (gamemode_query_status() >= 0)
-        m_capabilities |= SupportsGameMode;
-
-    if (!MangoHud::getLibraryString().isEmpty())
-        m_capabilities |= SupportsMangoHud;
+    auto glfwName = BuildConfig.GLFW_LIBRARY_NAME;
+    auto openALName = BuildConfig.OPENAL_LIBRARY_NAME;
+    m_systemProbe = Executor::instance()->run(Executor::Priority::Background, [glfwName, openALName] {
+        SystemProbe probe;
+        if (gamemode_query_status() >= 0)
+            probe.capabilities |= SupportsGameMode;
+        if (!MangoHud::getLibraryString().isEmpty())
+            probe.capabilities |= SupportsMangoHud;
+        probe.glfwPath = MangoHud::findLibrary(glfwName);
+        probe.openALPath = MangoHud::findLibrary(openALName);
+        return probe;
+    });
+    auto watcher = new QFutureWatcher<SystemProbe>(this);
+    connect(watcher, &QFutureWatcher<SystemProbe>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        applySystemProbe();
+    });
+    watcher->setFuture(m_systemProbe);
+#else
+    m_systemProbed = true;
 #endif
 }
 
-void Application::detectLibraries()
+void Application::awaitSystemProbe()
 {
-#ifdef Q_OS_LINUX
-    m_detectedGLFWPath = MangoHud::findLibrary(BuildConfig.GLFW_LIBRARY_NAME);
-    m_detectedOpenALPath = MangoHud::findLibrary(BuildConfig.OPENAL_LIBRARY_NAME);
+    if (m_systemProbed)
+        return;
+    Executor::instance()->waitFor(m_systemProbe);
+    applySystemProbe();
+}
+
+void Application::applySystemProbe()
+{
+    if (m_systemProbed)
+        return;
+    m_systemProbed = true;
+    auto probe = m_systemProbe.result();
+    m_probedCapabilities = probe.capabilities;
+    m_detectedGLFWPath = probe.glfwPath;
+    m_detectedOpenALPath = probe.openALPath;
     qDebug() << "Detected native libraries:" << m_detectedGLFWPath << m_detectedOpenALPath;
-#endif
+    updateCapabilities();
 }
 
 QString Application::getJarPath(QString jarFile)
@@ -1793,8 +2169,36 @@ bool Application::handleDataMigration(const QString& currentData,
         matcher->add(std::make_shared<SimplePrefixMatcher>("mods/"));
         matcher->add(std::make_shared<SimplePrefixMatcher>("themes/"));
 
+        // on the same filesystem the files don't need to be copied at all
+        auto method = FS::copy::Method::Copy;
+        auto from = FS::statFS(oldData);
+        auto to = FS::statFS(currentData);
+        if (from.rootPath == to.rootPath && from.fsType == to.fsType) {
+            bool canClone = FS::canCloneOnFS(from);
+            QMessageBox box(QMessageBox::Question, BuildConfig.LAUNCHER_DISPLAYNAME,
+                            tr("The data of %1 is on the same drive as %2, so it doesn't have to be copied.\n\n"
+                               "Moving it is instant, but %1 won't have its data anymore.")
+                                .arg(name, BuildConfig.LAUNCHER_DISPLAYNAME));
+            if (canClone)
+                box.setInformativeText(tr("Sharing it takes no extra space until either launcher changes a file."));
+            else
+                box.setInformativeText(
+                    tr("Linking it takes no extra space, but a file changed in place by one launcher changes for both."));
+            auto move = box.addButton(tr("Move"), QMessageBox::AcceptRole);
+            auto share = box.addButton(canClone ? tr("Share") : tr("Link"), QMessageBox::AcceptRole);
+            auto copy = box.addButton(tr("Copy"), QMessageBox::AcceptRole);
+            box.setDefaultButton(canClone ? share : copy);
+            box.exec();
+            if (box.clickedButton() == move)
+                method = FS::copy::Method::Move;
+            else if (box.clickedButton() == share)
+                method = canClone ? FS::copy::Method::Clone : FS::copy::Method::HardLink;
+            else if (box.clickedButton() != copy)
+                return currentExists;
+        }
+
         ProgressDialog diag;
-        DataMigrationTask task(nullptr, oldData, currentData, matcher);
+        DataMigrationTask task(nullptr, oldData, currentData, matcher, method);
         if (diag.execWithTask(&task)) {
             qDebug() << "<> Migration succeeded";
             setDoNotMigrate();
@@ -41,6 +41,7 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QFlag>
+#include <QFuture>
 #include <QIcon>
 #include <QUrl>
 #include <memory>
@@ -51,19 +52,44 @@
 #include "ui/themes/CatPack.h"
 
 class LaunchController;
+struct ApplicationMessage;
+class QCommandLineParser;
 class LocalPeer;
 class InstanceWindow;
 class MainWindow;
 class SetupWizard;
 class GenericPageProvider;
 class QFile;
+class AsyncLogWriter;
 class HttpMetaCache;
+class RemoteImageLoader;
+namespace Hashing {
+class HashCache;
+}
+namespace Flame {
+class FileCache;
+}
+namespace Net {
+class ContentStore;
+class DownloadJournal;
+class PeerCache;
+}
+class ModDetailsCache;
+class RefreshCoordinator;
+class LaunchCoordinator;
+class PackUpdatePreparer;
+class SrvCache;
+class ServerPinger;
+class DiskUsage;
+class ModInventory;
+class ModIconCache;
 class SettingsObject;
 class InstanceList;
 class AccountList;
 class IconList;
 class QNetworkAccessManager;
 class JavaInstallList;
+class JavaCheckCache;
 class ExternalUpdater;
 class BaseProfilerFactory;
 class BaseDetachedToolFactory;
@@ -102,6 +128,12 @@ class Application : public QApplication {
     Application(int& argc, char** argv);
     virtual ~Application();
 
+    /**
+     * Hand what the command line asks for to a copy already running on the same data, before any GUI starts.
+     * Returns whether one took it, the full application has to start otherwise.
+     */
+    static bool forwardToRunningInstance(int& argc, char** argv);
+
     bool event(QEvent* event) override;
 
     std::shared_ptr<SettingsObject> settings() const { return m_settings; }
@@ -138,11 +170,46 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    shared_qobject_ptr<Hashing::HashCache> hashCache();
+
+    shared_qobject_ptr<RemoteImageLoader> remoteImageLoader();
+
+    shared_qobject_ptr<Flame::FileCache> flameFileCache();
+
+    shared_qobject_ptr<JavaCheckCache> javaCheckCache();
+
+    std::shared_ptr<Net::ContentStore> contentStore() const { return m_contentStore; }
+
+    Net::DownloadJournal* downloadJournal() const { return m_downloadJournal.get(); }
+
+    Net::PeerCache* peerCache() const { return m_peerCache.get(); }
+
+    shared_qobject_ptr<ModDetailsCache> modDetailsCache();
+
+    RefreshCoordinator* refreshCoordinator() const { return m_refreshCoordinator.get(); }
+
+    LaunchCoordinator* launchCoordinator() const { return m_launchCoordinator.get(); }
+
+    PackUpdatePreparer* packUpdatePreparer() const { return m_packUpdatePreparer.get(); }
+
+    SrvCache* srvCache() const { return m_srvCache.get(); }
+
+    ServerPinger* serverPinger() const { return m_serverPinger.get(); }
+
+    std::shared_ptr<ModIconCache> modIconCache() const { return m_modIconCache; }
+
+    shared_qobject_ptr<DiskUsage> diskUsage() const { return m_diskUsage; }
+
+    shared_qobject_ptr<ModInventory> modInventory() const { return m_modInventory; }
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     void updateCapabilities();
 
-    void detectLibraries();
+    /// look for gamemode, MangoHud and the GLFW and OpenAL of the system on the thread pool, that means searching the disk
+    void probeSystem();
+    /// what probeSystem() finds, for a launch that's about to use it
+    void awaitSystemProbe();
 
     /*!
      * Finds and returns the full path to a jar file.
@@ -185,7 +252,7 @@ class Application : public QApplication {
     bool updaterEnabled();
     QString updaterBinaryName();
 
-    QUrl normalizeImportUrl(QString const& url);
+    static QUrl normalizeImportUrl(QString const& url);
 
    signals:
     void updateAllowedChanged(bool status);
@@ -217,6 +284,17 @@ class Application : public QApplication {
     bool handleDataMigration(const QString& currentData, const QString& oldData, const QString& name, const QString& configFile) const;
     bool createSetupWizard();
     void performMainStartupAction();
+    void handleMessage(const ApplicationMessage& message);
+
+    static void addCommandLineOptions(QCommandLineParser& parser);
+    static QString rootPathFor(const QString& binPath);
+    static QString dataPathFor(const QString& dirParam, const QString& rootPath, bool& portable, QString& adjustedBy);
+    // what to tell a running copy the command line asks for
+    static QList<ApplicationMessage> forwardedCommands(const QCommandLineParser& parser);
+    // load what isn't needed before the main window shows, in the background
+    void loadDeferred();
+    // update the instances asked for on the command line without a window, then quit
+    void prepareInstances();
 
     // sets the fatal error message and m_status to Failed.
     void showFatalErrorMessage(const QString& title, const QString& content);
@@ -228,6 +306,8 @@ class Application : public QApplication {
 
    private:
     QDateTime startTime;
+    QFuture<void> m_deferredLoad;
+    Task::Ptr m_prepareTask;
 
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
@@ -235,6 +315,22 @@ class Application : public QApplication {
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
+    shared_qobject_ptr<Hashing::HashCache> m_hashCache;
+    shared_qobject_ptr<Flame::FileCache> m_flameFileCache;
+    shared_qobject_ptr<JavaCheckCache> m_javaCheckCache;
+    std::shared_ptr<Net::ContentStore> m_contentStore;
+    std::unique_ptr<Net::DownloadJournal> m_downloadJournal;
+    std::unique_ptr<Net::PeerCache> m_peerCache;
+    shared_qobject_ptr<ModDetailsCache> m_modDetailsCache;
+    std::unique_ptr<RefreshCoordinator> m_refreshCoordinator;
+    std::unique_ptr<LaunchCoordinator> m_launchCoordinator;
+    std::unique_ptr<PackUpdatePreparer> m_packUpdatePreparer;
+    std::unique_ptr<SrvCache> m_srvCache;
+    std::unique_ptr<ServerPinger> m_serverPinger;
+    std::shared_ptr<ModIconCache> m_modIconCache;
+    shared_qobject_ptr<RemoteImageLoader> m_remoteImageLoader;
+    shared_qobject_ptr<DiskUsage> m_diskUsage;
+    shared_qobject_ptr<ModInventory> m_modInventory;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
 
     std::shared_ptr<SettingsObject> m_settings;
@@ -255,6 +351,17 @@ class Application : public QApplication {
     Capabilities m_capabilities;
     bool m_portable = false;
 
+    struct SystemProbe {
+        Capabilities capabilities;
+        QString glfwPath;
+        QString openALPath;
+    };
+    void applySystemProbe();
+    QFuture<SystemProbe> m_systemProbe;
+    bool m_systemProbed = false;
+    // what the probe found, kept apart as updateCapabilities() starts over
+    Capabilities m_probedCapabilities;
+
 #ifdef Q_OS_MACOS
     Qt::ApplicationState m_prevAppState = Qt::ApplicationInactive;
 #endif
@@ -291,7 +398,11 @@ class Application : public QApplication {
     QString m_serverToJoin;
     QString m_profileToUse;
     bool m_liveCheck = false;
+    bool m_dumpPerfStats = false;
+    // keeps running with no window open, until told to quit
+    bool m_background = false;
+    QStringList m_instancesToPrepare;
     QList<QUrl> m_urlsToImport;
     QString m_instanceIdToShowWindowOf;
-    std::unique_ptr<QFile> logFile;
+    std::unique_ptr<AsyncLogWriter> logWriter;
 };
@@ -35,33 +35,65 @@
 
 #include "ApplicationMessage.h"
 
+#include <QDataStream>
+#include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include "Json.h"
 
+// starts every message in the binary format, JSON never does
+static const QByteArray binaryMagic("PLM\x01", 4);
+
 void ApplicationMessage::parse(const QByteArray& input)
 {
-    auto doc = Json::requireDocument(input, "ApplicationMessage");
-    auto root = Json::requireObject(doc, "ApplicationMessage");
+    auto messages = parseBatch(input);
+    *this = messages.isEmpty() ? ApplicationMessage() : messages.first();
+}
 
-    command = root.value("command").toString();
-    args.clear();
+QByteArray ApplicationMessage::serialize()
+{
+    return serializeBatch({ *this });
+}
 
-    auto parsedArgs = root.value("args").toObject();
-    for (auto iter = parsedArgs.constBegin(); iter != parsedArgs.constEnd(); iter++) {
-        args.insert(iter.key(), iter.value().toString());
-    }
+QByteArray ApplicationMessage::serializeBatch(const QList<ApplicationMessage>& messages)
+{
+    QByteArray output = binaryMagic;
+    QDataStream stream(&output, QIODevice::WriteOnly | QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << static_cast<quint32>(messages.size());
+    for (auto& message : messages)
+        stream << message.command << message.args;
+    return output;
 }
 
-QByteArray ApplicationMessage::serialize()
+QList<ApplicationMessage> ApplicationMessage::parseBatch(const QByteArray& input)
 {
-    QJsonObject root;
-    root.insert("command", command);
-    QJsonObject outArgs;
-    for (auto iter = args.constBegin(); iter != args.constEnd(); iter++) {
-        outArgs.insert(iter.key(), iter.value());
+    if (!input.startsWith(binaryMagic)) {
+        auto doc = Json::requireDocument(input, "ApplicationMessage");
+        auto root = Json::requireObject(doc, "ApplicationMessage");
+
+        ApplicationMessage message;
+        message.command = root.value("command").toString();
+        auto parsedArgs = root.value("args").toObject();
+        for (auto iter = parsedArgs.constBegin(); iter != parsedArgs.constEnd(); iter++) {
+            message.args.insert(iter.key(), iter.value().toString());
+        }
+        return { message };
     }
-    root.insert("args", outArgs);
 
-    return Json::toText(root);
+    QDataStream stream(input.mid(binaryMagic.size()));
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 count = 0;
+    stream >> count;
+    QList<ApplicationMessage> messages;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        ApplicationMessage message;
+        stream >> message.command >> message.args;
+        messages.append(message);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Received a broken ApplicationMessage";
+        return {};
+    }
+    return messages;
 }
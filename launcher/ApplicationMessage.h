@@ -2,6 +2,7 @@
 
 #include <QByteArray>
 #include <QHash>
+#include <QList>
 #include <QString>
 
 struct ApplicationMessage {
@@ -10,4 +11,9 @@ struct ApplicationMessage {
 
     QByteArray serialize();
     void parse(const QByteArray& input);
+
+    /// several messages in one, for an invocation to hand everything over at once
+    static QByteArray serializeBatch(const QList<ApplicationMessage>& messages);
+    /// the messages in `input`, which may also be a single message in the older JSON format
+    static QList<ApplicationMessage> parseBatch(const QByteArray& input);
 };
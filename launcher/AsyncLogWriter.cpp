@@ -0,0 +1,137 @@
+#include "AsyncLogWriter.h"
+
+#include <QFileDevice>
+
+#include <chrono>
+
+// how long written lines may wait in the buffer when nothing asks for them
+static constexpr auto s_flushInterval = std::chrono::milliseconds(100);
+
+AsyncLogWriter::AsyncLogWriter(std::unique_ptr<QIODevice> device, FILE* echo, int capacity) : m_device(std::move(device)), m_echo(echo)
+{
+    // a power of two, so positions map to slots with a mask
+    std::size_t size = 2;
+    while (size < static_cast<std::size_t>(capacity))
+        size *= 2;
+    m_mask = size - 1;
+    m_slots = std::make_unique<Slot[]>(size);
+    for (std::size_t i = 0; i < size; i++)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_thread = std::thread([this] { run(); });
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+bool AsyncLogWriter::tryPush(QString& line)
+{
+    auto pos = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+        auto& slot = m_slots[pos & m_mask];
+        auto sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.line = std::move(line);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // full, the slot still holds the line from a round ago
+            return false;
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLogWriter::tryPop(QString& line)
+{
+    auto& slot = m_slots[m_tail & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1)
+        return false;
+    line = std::move(slot.line);
+    slot.line = QString();
+    slot.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+    m_tail++;
+    return true;
+}
+
+void AsyncLogWriter::write(QString line)
+{
+    // whatever the device complains about on the writing thread can't wait for that same thread
+    if (std::this_thread::get_id() == m_thread.get_id()) {
+        writeOut(line);
+        return;
+    }
+    while (!tryPush(line)) {
+        wake();
+        std::this_thread::yield();
+    }
+}
+
+void AsyncLogWriter::flush()
+{
+    if (std::this_thread::get_id() == m_thread.get_id())
+        return;
+    auto target = m_head.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeRequested = true;
+    m_wake.notify_one();
+    // lines claimed but not filled in yet are picked up on the next round
+    while (m_written.load(std::memory_order_acquire) < target) {
+        m_flushed.wait_for(lock, s_flushInterval);
+        m_wakeRequested = true;
+        m_wake.notify_one();
+    }
+}
+
+void AsyncLogWriter::wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeRequested = true;
+    }
+    m_wake.notify_one();
+}
+
+void AsyncLogWriter::writeOut(const QString& line)
+{
+    m_device->write(line.toUtf8());
+    if (m_echo)
+        std::fputs(line.toLocal8Bit().constData(), m_echo);
+}
+
+void AsyncLogWriter::run()
+{
+    for (;;) {
+        bool wrote = false;
+        QString line;
+        while (tryPop(line)) {
+            writeOut(line);
+            wrote = true;
+        }
+        if (wrote) {
+            if (auto file = qobject_cast<QFileDevice*>(m_device.get()))
+                file->flush();
+            if (m_echo)
+                std::fflush(m_echo);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_written.store(m_tail, std::memory_order_release);
+        m_flushed.notify_all();
+        if (m_stopping && m_tail == m_head.load(std::memory_order_acquire))
+            return;
+        m_wake.wait_for(lock, s_flushInterval, [this] { return m_wakeRequested || m_stopping; });
+        m_wakeRequested = false;
+    }
+}
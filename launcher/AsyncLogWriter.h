@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QIODevice>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Writes the lines of the application log to the log file, and echoes them to a stream, on a thread of its own.
+ *
+ * The message handler used to write, flush and echo every line before the code logging it could go on, so a loop
+ * logging each of its items spent most of its time waiting for the disk. Lines go in a ring buffer instead, taking a
+ * slot without any lock, and are written out in batches a few times a second or as soon as the buffer fills up.
+ * When it's full, the ones logging wait for room rather than losing lines.
+ *
+ * flush() waits for everything logged so far to be written, for the lines that must be there if the launcher dies
+ * right after them.
+ */
+class AsyncLogWriter {
+   public:
+    // supply the opened log file, `echo` also gets every line when set
+    explicit AsyncLogWriter(std::unique_ptr<QIODevice> device, FILE* echo = nullptr, int capacity = 4096);
+    /// writes out what's left
+    ~AsyncLogWriter();
+
+    /// queue `line` to be written, it should end with a line feed
+    void write(QString line);
+    /// wait until everything written before is on the device
+    void flush();
+
+   private:
+    struct Slot {
+        // the position the slot can be written at, one past it once it holds a line
+        std::atomic<std::size_t> sequence;
+        QString line;
+    };
+
+    bool tryPush(QString& line);
+    bool tryPop(QString& line);
+    void writeOut(const QString& line);
+    void wake();
+    void run();
+
+   private:
+    std::unique_ptr<QIODevice> m_device;
+    FILE* m_echo;
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+    std::atomic<std::size_t> m_head{ 0 };
+    // only ever touched by the writing thread, published for flush() as m_written
+    std::size_t m_tail = 0;
+    std::atomic<std::size_t> m_written{ 0 };
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    bool m_wakeRequested = false;
+    bool m_stopping = false;
+
+    std::thread m_thread;
+};
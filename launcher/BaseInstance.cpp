@@ -93,6 +93,8 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
 
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleMaxLines"), nullptr);
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleOverflowStop"), nullptr);
+    m_settings->registerPassthrough(globalSettings->getSetting("ConsoleSessionLogs"), nullptr);
+    m_settings->registerPassthrough(globalSettings->getSetting("CollectJvmMetrics"), nullptr);
 
     // Managed Packs
     m_settings->registerSetting("ManagedPack", false);
@@ -391,6 +393,16 @@ QString BaseInstance::windowTitle() const
     return BuildConfig.LAUNCHER_DISPLAYNAME + ": " + name();
 }
 
+void BaseInstance::guessLevels(const QStringList& lines, QVector<MessageLevel::Enum>& levels)
+{
+    for (int i = 0; i < lines.size(); i++) {
+        auto level = levels[i];
+        if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown) {
+            levels[i] = guessLevel(lines[i], level);
+        }
+    }
+}
+
 // FIXME: why is this here? move it to MinecraftInstance!!!
 QStringList BaseInstance::extraArguments()
 {
@@ -148,8 +148,12 @@ class BaseInstance : public QObject, public std::enable_shared_from_this<BaseIns
     void copyManagedPack(BaseInstance& other);
 
     /// guess log level from a line of game log
+    /// NOTE: this is called from the log processing thread, implementations must not touch mutable instance state
     virtual MessageLevel::Enum guessLevel([[maybe_unused]] const QString& line, MessageLevel::Enum level) { return level; }
 
+    /// guess log levels for a batch of lines of game log, `levels` holds one default level per line and is updated in place
+    virtual void guessLevels(const QStringList& lines, QVector<MessageLevel::Enum>& levels);
+
     virtual QStringList extraArguments();
 
     /// Traits. Normally inside the version, depends on instance implementation.
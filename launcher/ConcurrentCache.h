@@ -0,0 +1,307 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QString>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+
+#include "PerfCounters.h"
+
+/// what an entry costs a cache, a rough count of the bytes it holds
+template <typename T>
+qint64 cacheCost(const T&)
+{
+    return sizeof(T);
+}
+inline qint64 cacheCost(const QByteArray& value)
+{
+    return sizeof(QByteArray) + value.size();
+}
+inline qint64 cacheCost(const QString& value)
+{
+    return sizeof(QString) + value.size() * static_cast<qint64>(sizeof(QChar));
+}
+
+/// how a cache writes its entries to a file and reads them back, the default goes through QDataStream
+template <typename K, typename V>
+struct CacheSerializer {
+    static void write(QDataStream& out, const K& key, const V& value) { out << key << value; }
+    static bool read(QDataStream& in, K& key, V& value)
+    {
+        in >> key >> value;
+        return in.status() == QDataStream::Ok;
+    }
+};
+
+/**
+ * A map that many threads use at once, bounded in entries, bytes and age.
+ *
+ * The keys are spread over shards that each have their own lock, so threads looking up different keys rarely wait
+ * for each other. Each shard drops its least recently used entries once it's over its part of the limits, entries
+ * older than the time to live count as gone. With a name, the hits, misses and evictions go to the performance
+ * counters as `name`.hits, `name`.misses and `name`.evictions, and what's held as `name`.entries and `name`.bytes.
+ *
+ * An entry can also be marked stale, it's still there but whoever looks at it knows it should be fetched again.
+ */
+template <typename K, typename V, typename Serializer = CacheSerializer<K, V>>
+class ConcurrentCache {
+   public:
+    struct Limits {
+        // 0 for no limit
+        qint64 maxEntries = 0;
+        qint64 maxBytes = 0;
+        std::chrono::milliseconds ttl{ 0 };
+    };
+
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qint64 entries = 0;
+        qint64 bytes = 0;
+    };
+
+    ConcurrentCache() : ConcurrentCache(Limits{}) {}
+    explicit ConcurrentCache(Limits limits, const QString& name = {})
+        : m_limits(limits)
+        , m_hits(name.isEmpty() ? m_local[0] : PerfCounters::counter(name + ".hits"))
+        , m_misses(name.isEmpty() ? m_local[1] : PerfCounters::counter(name + ".misses"))
+        , m_evictions(name.isEmpty() ? m_local[2] : PerfCounters::counter(name + ".evictions"))
+        , m_entries(name.isEmpty() ? m_local[3] : PerfCounters::counter(name + ".entries"))
+        , m_bytes(name.isEmpty() ? m_local[4] : PerfCounters::counter(name + ".bytes"))
+    {}
+    ~ConcurrentCache() { clear(); }
+
+    ConcurrentCache(const ConcurrentCache&) = delete;
+    ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+    void add(const K& key, V value)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto cost = cacheCost(key) + cacheCost(value);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            account(shard, -1, -it->cost);
+            shard.order.erase(it->position);
+            shard.entries.erase(it);
+        }
+        shard.order.push_front(key);
+        shard.entries.insert(key, { std::move(value), cost, expiry(), false, shard.order.begin() });
+        account(shard, 1, cost);
+        trim(shard);
+    }
+
+    std::optional<V> find(const K& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = lookup(shard, key);
+        if (it == shard.entries.end()) {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        shard.order.splice(shard.order.begin(), shard.order, it->position);
+        return it->value;
+    }
+    V get(const K& key) { return find(key).value_or(V()); }
+    bool get(const K& key, V& value)
+    {
+        auto found = find(key);
+        if (found)
+            value = std::move(*found);
+        return found.has_value();
+    }
+
+    bool has(const K& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        return lookup(shard, key) != shard.entries.end();
+    }
+    bool stale(const K& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = lookup(shard, key);
+        return it == shard.entries.end() || it->stale;
+    }
+    void setStale(const K& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = lookup(shard, key);
+        if (it != shard.entries.end())
+            it->stale = true;
+    }
+
+    void remove(const K& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.lock);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end())
+            drop(shard, it);
+    }
+    void clear()
+    {
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            account(shard, -shard.entryCount, -shard.bytes);
+            shard.entries.clear();
+            shard.order.clear();
+        }
+    }
+
+    [[nodiscard]] Stats stats() const
+    {
+        Stats stats{ m_hits.load(), m_misses.load(), m_evictions.load(), 0, 0 };
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            stats.entries += shard.entryCount;
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+
+    /// write the entries that haven't expired, the most recently used last so they're the ones kept when read back
+    bool save(const QString& path) const
+    {
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        QDataStream out(&file);
+        out << s_format;
+        auto now = clock::now();
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            for (auto key = shard.order.rbegin(); key != shard.order.rend(); ++key) {
+                auto entry = shard.entries.constFind(*key);
+                if (expired(*entry, now))
+                    continue;
+                out << true << entry->stale;
+                Serializer::write(out, *key, entry->value);
+            }
+        }
+        out << false;
+        return out.status() == QDataStream::Ok && file.commit();
+    }
+
+    /// add what `save` wrote, up to the first entry that can't be read
+    bool load(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        QDataStream in(&file);
+        quint32 format = 0;
+        in >> format;
+        if (format != s_format)
+            return false;
+        bool more = false;
+        for (in >> more; more && in.status() == QDataStream::Ok; in >> more) {
+            bool isStale = false;
+            K key;
+            V value;
+            in >> isStale;
+            if (!Serializer::read(in, key, value))
+                return false;
+            add(key, std::move(value));
+            if (isStale)
+                setStale(key);
+        }
+        return in.status() == QDataStream::Ok;
+    }
+
+   private:
+    using clock = std::chrono::steady_clock;
+    static constexpr int s_shards = 16;
+    static constexpr quint32 s_format = 1;
+
+    struct Entry {
+        V value;
+        qint64 cost = 0;
+        std::optional<clock::time_point> expires;
+        bool stale = false;
+        typename std::list<K>::iterator position;
+    };
+    struct Shard {
+        mutable std::mutex lock;
+        QHash<K, Entry> entries;
+        // most recently used first
+        std::list<K> order;
+        qint64 entryCount = 0;
+        qint64 bytes = 0;
+    };
+    using Iterator = typename QHash<K, Entry>::iterator;
+
+    Shard& shardFor(const K& key) { return m_shards[qHash(key) % s_shards]; }
+
+    std::optional<clock::time_point> expiry() const
+    {
+        if (m_limits.ttl.count() <= 0)
+            return std::nullopt;
+        return clock::now() + m_limits.ttl;
+    }
+    static bool expired(const Entry& entry, clock::time_point now) { return entry.expires && *entry.expires <= now; }
+
+    // the entry unless it's gone or expired, which is dropped on the way
+    Iterator lookup(Shard& shard, const K& key)
+    {
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end() && expired(*it, clock::now())) {
+            drop(shard, it);
+            return shard.entries.end();
+        }
+        return it;
+    }
+
+    void drop(Shard& shard, Iterator it)
+    {
+        account(shard, -1, -it->cost);
+        shard.order.erase(it->position);
+        shard.entries.erase(it);
+    }
+
+    void account(Shard& shard, qint64 entries, qint64 bytes)
+    {
+        shard.entryCount += entries;
+        shard.bytes += bytes;
+        m_entries.fetch_add(entries, std::memory_order_relaxed);
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // each shard keeps to its part of the limits, keys spread evenly enough for that to be close to the whole
+    void trim(Shard& shard)
+    {
+        auto maxEntries = m_limits.maxEntries > 0 ? std::max<qint64>(1, m_limits.maxEntries / s_shards) : 0;
+        auto maxBytes = m_limits.maxBytes > 0 ? std::max<qint64>(1, m_limits.maxBytes / s_shards) : 0;
+        // the one just added stays, even when it's bigger than that on its own
+        while (shard.entryCount > 1 && ((maxEntries && shard.entryCount > maxEntries) || (maxBytes && shard.bytes > maxBytes))) {
+            drop(shard, shard.entries.find(shard.order.back()));
+            m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+   private:
+    Limits m_limits;
+    std::array<Shard, s_shards> m_shards;
+    // counters of their own for caches that aren't named
+    std::array<std::atomic<qint64>, 5> m_local{};
+    std::atomic<qint64>& m_hits;
+    std::atomic<qint64>& m_misses;
+    std::atomic<qint64>& m_evictions;
+    std::atomic<qint64>& m_entries;
+    std::atomic<qint64>& m_bytes;
+};
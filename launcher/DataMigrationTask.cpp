@@ -5,74 +5,46 @@
 #include "DataMigrationTask.h"
 
 #include "FileSystem.h"
+#include "tasks/Executor.h"
 
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QMap>
 
-#include <QtConcurrent>
-
 DataMigrationTask::DataMigrationTask(QObject* parent,
                                      const QString& sourcePath,
                                      const QString& targetPath,
-                                     const IPathMatcher::Ptr pathMatcher)
+                                     const IPathMatcher::Ptr pathMatcher,
+                                     FS::copy::Method method)
     : Task(parent), m_sourcePath(sourcePath), m_targetPath(targetPath), m_pathMatcher(pathMatcher), m_copy(sourcePath, targetPath)
 {
-    m_copy.matcher(m_pathMatcher.get()).whitelist(true);
+    m_copy.matcher(m_pathMatcher.get()).whitelist(true).method(method).countBytes(true);
 }
 
 void DataMigrationTask::executeTask()
 {
     setStatus(tr("Scanning files..."));
+    m_copy.cancellation(cancellationToken());
 
-    // 1. Scan
-    // Check how many files we gotta copy
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [&] {
-        return m_copy(true);  // dry run to collect amount of files
+    // the copy tells what there is once it listed it, there's no need for a dry run before
+    connect(&m_copy, &FS::copy::scanned, this, [this](qsizetype, qint64 bytes) {
+        m_toCopy = bytes;
+        setProgress(0, m_toCopy);
     });
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-    m_copyFutureWatcher.setFuture(m_copyFuture);
-}
-
-void DataMigrationTask::dryRunFinished()
-{
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::dryRunFinished);
-    disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::dryRunAborted);
-
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    if (!m_copyFuture.isValid() || !m_copyFuture.result()) {
-#else
-    if (!m_copyFuture.result()) {
-#endif
-        emitFailed(tr("Failed to scan source path."));
-        return;
-    }
-
-    // 2. Copy
-    // Actually copy all files now.
-    m_toCopy = m_copy.totalCopied();
-    connect(&m_copy, &FS::copy::fileCopied, [&, this](const QString& relativeName) {
+    connect(&m_copy, &FS::copy::fileCopied, this, [this](const QString& relativeName) {
         QString shortenedName = relativeName;
         // shorten the filename to hopefully fit into one line
         if (shortenedName.length() > 50)
             shortenedName = relativeName.left(20) + "…" + relativeName.right(29);
-        setProgress(m_copy.totalCopied(), m_toCopy);
+        setProgress(m_copy.bytesCopied(), m_toCopy);
         setStatus(tr("Copying %1…").arg(shortenedName));
     });
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [&] {
-        return m_copy(false);  // actually copy now
-    });
+    m_copyFuture = Executor::instance()->run(Executor::Priority::Bulk, [this] { return m_copy(false); });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &DataMigrationTask::copyAborted);
     m_copyFutureWatcher.setFuture(m_copyFuture);
 }
 
-void DataMigrationTask::dryRunAborted()
-{
-    emitFailed(tr("Aborted"));
-}
-
 void DataMigrationTask::copyFinished()
 {
     disconnect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &DataMigrationTask::copyFinished);
@@ -13,20 +13,25 @@
 
 /*
  * Migrate existing data from other MMC-like launchers.
+ *
+ * It's a single pass over the source, with the files copied in parallel, or moved, linked or cloned when both are on
+ * the same filesystem. The progress is in bytes, as a few big files would otherwise look like they stall it.
  */
 
 class DataMigrationTask : public Task {
     Q_OBJECT
    public:
-    explicit DataMigrationTask(QObject* parent, const QString& sourcePath, const QString& targetPath, IPathMatcher::Ptr pathmatcher);
+    explicit DataMigrationTask(QObject* parent,
+                               const QString& sourcePath,
+                               const QString& targetPath,
+                               IPathMatcher::Ptr pathmatcher,
+                               FS::copy::Method method = FS::copy::Method::Copy);
     ~DataMigrationTask() override = default;
 
    protected:
     virtual void executeTask() override;
 
    protected slots:
-    void dryRunFinished();
-    void dryRunAborted();
     void copyFinished();
     void copyAborted();
 
@@ -36,7 +41,7 @@ class DataMigrationTask : public Task {
     const IPathMatcher::Ptr m_pathMatcher;
 
     FS::copy m_copy;
-    int m_toCopy = 0;
+    qint64 m_toCopy = 0;
     QFuture<bool> m_copyFuture;
     QFutureWatcher<bool> m_copyFutureWatcher;
 };
@@ -0,0 +1,196 @@
+#include "DiskUsage.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "RecursiveFileSystemWatcher.h"
+#include "tasks/Executor.h"
+
+DiskUsage::DiskUsage(QObject* parent) : QObject(parent) {}
+
+DiskUsage* DiskUsage::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->diskUsage().get() : nullptr;
+}
+
+QString DiskUsage::key(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+qint64 DiskUsage::size(const QString& path)
+{
+    auto folder = key(path);
+    auto bytes = total(folder);
+    if (!m_asked.contains(folder))
+        m_asked.insert(folder, bytes);
+    if (bytes < 0)
+        rescan(folder, false);
+    return bytes;
+}
+
+void DiskUsage::invalidate(const QString& path)
+{
+    auto folder = key(path);
+    forget(folder);
+    for (auto asked = m_asked.cbegin(); asked != m_asked.cend(); asked++) {
+        if (folder == asked.key() || folder.startsWith(asked.key() + '/') || asked.key().startsWith(folder + '/')) {
+            rescan(folder, true);
+            break;
+        }
+    }
+}
+
+void DiskUsage::watch(const QString& root)
+{
+    auto folder = key(root);
+    auto& watch = m_watches[folder];
+    if (watch.count++ > 0)
+        return;
+    watch.watcher = new RecursiveFileSystemWatcher(this);
+    watch.watcher->setRootDir(QDir(folder));
+    connect(watch.watcher, &RecursiveFileSystemWatcher::directoryChanged, this, [this](const QString& changed) {
+        auto folder = key(changed);
+        // only what was asked about is kept
+        if (m_folders.contains(folder) || m_scans.contains(folder))
+            rescan(folder, true);
+    });
+    watch.watcher->enable();
+}
+
+void DiskUsage::unwatch(const QString& root)
+{
+    auto watch = m_watches.find(key(root));
+    if (watch == m_watches.end() || --watch->count > 0)
+        return;
+    watch->watcher->deleteLater();
+    m_watches.erase(watch);
+}
+
+void DiskUsage::rescan(const QString& path, bool again)
+{
+    if (m_scans.contains(path)) {
+        if (again)
+            m_changed.insert(path);
+        return;
+    }
+
+    // whatever is fully known under it stays as it is, its own changes get it listed again
+    QSet<QString> known;
+    auto prefix = path + '/';
+    for (auto folder = m_folders.cbegin(); folder != m_folders.cend(); folder++) {
+        if (folder.key().startsWith(prefix) && total(folder.key()) >= 0)
+            known.insert(folder.key());
+    }
+
+    auto watcher = new QFutureWatcher<Scan>(this);
+    m_scans.insert(path, watcher);
+    connect(watcher, &QFutureWatcher<Scan>::finished, this, [this, watcher] { scanFinished(watcher); });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Background, [path, known] { return scan(path, known); }));
+}
+
+void DiskUsage::scanFinished(QFutureWatcher<Scan>* watcher)
+{
+    auto result = watcher->result();
+    m_scans.remove(result.root);
+    watcher->deleteLater();
+
+    if (!result.exists) {
+        forget(result.root);
+    } else {
+        // what went away since doesn't count anymore
+        auto old = m_folders.value(result.root);
+        auto now = result.folders.value(result.root).subfolders;
+        for (auto& subfolder : old.subfolders) {
+            if (!now.contains(subfolder))
+                forget(subfolder);
+        }
+        for (auto folder = result.folders.cbegin(); folder != result.folders.cend(); folder++)
+            m_folders.insert(folder.key(), folder.value());
+    }
+
+    if (m_changed.remove(result.root))
+        rescan(result.root, false);
+    report();
+}
+
+void DiskUsage::report()
+{
+    QList<QPair<QString, qint64>> changed;
+    for (auto asked = m_asked.begin(); asked != m_asked.end();) {
+        auto bytes = total(asked.key());
+        if (bytes < 0) {
+            if (!QFileInfo(asked.key()).isDir()) {
+                asked = m_asked.erase(asked);
+                continue;
+            }
+            // something under it was forgotten
+            rescan(asked.key(), false);
+        } else if (bytes != asked.value()) {
+            asked.value() = bytes;
+            changed.append({ asked.key(), bytes });
+        }
+        asked++;
+    }
+    for (auto& [path, bytes] : changed)
+        emit sizeChanged(path, bytes);
+}
+
+qint64 DiskUsage::total(const QString& path) const
+{
+    qint64 bytes = 0;
+    QStringList pending{ path };
+    while (!pending.isEmpty()) {
+        auto folder = m_folders.find(pending.takeLast());
+        if (folder == m_folders.end())
+            return -1;
+        bytes += folder->bytes;
+        pending.append(folder->subfolders);
+    }
+    return bytes;
+}
+
+void DiskUsage::forget(const QString& path)
+{
+    QStringList pending{ path };
+    while (!pending.isEmpty()) {
+        auto folder = m_folders.find(pending.takeLast());
+        if (folder == m_folders.end())
+            continue;
+        pending.append(folder->subfolders);
+        m_folders.erase(folder);
+    }
+}
+
+DiskUsage::Scan DiskUsage::scan(const QString& root, const QSet<QString>& known)
+{
+    Scan result;
+    result.root = root;
+    result.exists = QFileInfo(root).isDir();
+    if (!result.exists)
+        return result;
+
+    QStringList pending{ root };
+    while (!pending.isEmpty()) {
+        auto path = pending.takeLast();
+        Folder folder;
+        for (auto& info : QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)) {
+            if (!info.isDir()) {
+                folder.bytes += info.size();
+                continue;
+            }
+            // linked folders are counted where they really are
+            if (info.isSymLink())
+                continue;
+            auto subfolder = QDir::cleanPath(info.absoluteFilePath());
+            folder.subfolders.append(subfolder);
+            if (!known.contains(subfolder))
+                pending.append(subfolder);
+        }
+        result.folders.insert(path, folder);
+    }
+    return result;
+}
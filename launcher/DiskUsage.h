@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class RecursiveFileSystemWatcher;
+
+/**
+ * Sizes of folders on disk, shared by everything showing them.
+ *
+ * A folder is added up on the thread pool the first time it's asked about, and what every folder under it holds by itself
+ * is kept. Under a watched root a change in a folder only gets that folder listed again, not the whole tree. Files growing
+ * in place don't change their folder, sizes that have to include that need invalidating.
+ *
+ * Lives on the GUI thread.
+ */
+class DiskUsage : public QObject {
+    Q_OBJECT
+   public:
+    explicit DiskUsage(QObject* parent = nullptr);
+
+    /// the service of the running launcher, null when there's none like in tests
+    static DiskUsage* shared();
+
+    /// the size of everything in the folder, -1 until it's added up, sizeChanged tells when it is and whenever it changes
+    qint64 size(const QString& path);
+    /// forget what's known about the folder, it's added up again if anyone asked about it
+    void invalidate(const QString& path);
+
+    /// keep what's known under the root up to date as folders change, calls nest
+    void watch(const QString& root);
+    void unwatch(const QString& root);
+
+   signals:
+    void sizeChanged(const QString& path, qint64 bytes);
+
+   private:
+    struct Folder {
+        // the files directly in the folder
+        qint64 bytes = 0;
+        QStringList subfolders;
+    };
+    struct Scan {
+        QString root;
+        bool exists = false;
+        QHash<QString, Folder> folders;
+    };
+    struct Watch {
+        RecursiveFileSystemWatcher* watcher = nullptr;
+        int count = 0;
+    };
+
+    /// list the folder again, and whatever under it isn't known
+    void rescan(const QString& path, bool again);
+    void scanFinished(QFutureWatcher<Scan>* watcher);
+    /// tell about the sizes that were asked about and changed
+    void report();
+    /// everything in the folder, -1 if part of it isn't known
+    qint64 total(const QString& path) const;
+    void forget(const QString& path);
+
+    static QString key(const QString& path);
+    static Scan scan(const QString& root, const QSet<QString>& known);
+
+   private:
+    QHash<QString, Folder> m_folders;
+    // what was asked about, with what was told last
+    QHash<QString, qint64> m_asked;
+    QHash<QString, QFutureWatcher<Scan>*> m_scans;
+    // folders that changed while being listed
+    QSet<QString> m_changed;
+    QHash<QString, Watch> m_watches;
+};
@@ -37,15 +37,69 @@
 #include "FileIgnoreProxy.h"
 
 #include <QDebug>
+#include <QDirIterator>
 #include <QFileSystemModel>
+#include <QFutureWatcher>
 #include <QSortFilterProxyModel>
 #include <QStack>
 #include <algorithm>
 #include "FileSystem.h"
 #include "SeparatorPrefixTree.h"
 #include "StringUtils.h"
+#include "tasks/Executor.h"
+
+FileIgnoreProxy::FileIgnoreProxy(QString root, QObject* parent) : QSortFilterProxyModel(parent), root(root), m_rootDir(root)
+{
+    // toggling a few boxes in a row shouldn't go through the instance each time
+    m_estimateTimer.setSingleShot(true);
+    m_estimateTimer.setInterval(250);
+    connect(&m_estimateTimer, &QTimer::timeout, this, [this] {
+        m_estimateToken.cancel();
+        m_estimateToken = CancellationToken();
+        auto generation = ++m_estimateGeneration;
+
+        // the job gets its own copy of the filters, they may change while it runs
+        auto future = Executor::instance()->run(
+            Executor::Priority::Background,
+            [root = root, blocked = blocked, ignoreNames = m_ignoreFiles, ignorePaths = m_ignoreFilePaths, token = m_estimateToken] {
+                qint64 total = 0;
+                QDir rootDir(root);
+                QStringList todo{ root };
+                while (!todo.isEmpty() && !token.isCancelled()) {
+                    QDirIterator it(todo.takeLast(), QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden);
+                    while (it.hasNext()) {
+                        it.next();
+                        auto info = it.fileInfo();
+                        auto relative = rootDir.relativeFilePath(info.absoluteFilePath());
+                        // what is left out as a whole isn't even listed
+                        if (blocked.covers(relative) || ignorePaths.covers(relative))
+                            continue;
+                        if (info.isDir() && !info.isSymLink())
+                            todo.append(info.absoluteFilePath());
+                        else if (info.isFile() && !ignoreNames.contains(info.fileName()))
+                            total += info.size();
+                    }
+                }
+                return total;
+            },
+            m_estimateToken);
+
+        auto watcher = new QFutureWatcher<qint64>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation] {
+            watcher->deleteLater();
+            if (generation != m_estimateGeneration || watcher->isCanceled())
+                return;
+            emit sizeEstimated(watcher->result());
+        });
+        watcher->setFuture(future);
+    });
+}
+
+void FileIgnoreProxy::estimateSize()
+{
+    m_estimateTimer.start();
+}
 
-FileIgnoreProxy::FileIgnoreProxy(QString root, QObject* parent) : QSortFilterProxyModel(parent), root(root) {}
 // NOTE: Sadly, we have to do sorting ourselves.
 bool FileIgnoreProxy::lessThan(const QModelIndex& left, const QModelIndex& right) const
 {
@@ -130,7 +184,7 @@ bool FileIgnoreProxy::setData(const QModelIndex& index, const QVariant& value, i
 
 QString FileIgnoreProxy::relPath(const QString& path) const
 {
-    return QDir(root).relativeFilePath(path);
+    return m_rootDir.relativeFilePath(path);
 }
 
 bool FileIgnoreProxy::setFilterState(QModelIndex index, Qt::CheckState state)
@@ -145,43 +199,25 @@ bool FileIgnoreProxy::setFilterState(QModelIndex index, Qt::CheckState state)
     auto blockedPath = relPath(fsm->filePath(sourceIndex));
     bool changed = false;
     if (state == Qt::Unchecked) {
-        // blocking a path
-        auto& node = blocked.insert(blockedPath);
-        // get rid of all blocked nodes below
-        node.clear();
+        // blocking a path, which gets rid of all blocked nodes below
+        blocked.insert(blockedPath);
         changed = true;
     } else if (state == Qt::Checked || state == Qt::PartiallyChecked) {
-        if (!blocked.remove(blockedPath)) {
-            auto cover = blocked.cover(blockedPath);
+        auto cover = blocked.cover(blockedPath);
+        if (!blocked.remove(blockedPath) && !cover.isNull()) {
             qDebug() << "Blocked by cover" << cover;
             // uncover
             blocked.remove(cover);
-            // block all contents, except for any cover
-            QModelIndex rootIndex = fsm->index(FS::PathCombine(root, cover));
-            QModelIndex doing = rootIndex;
-            int row = 0;
-            QStack<QModelIndex> todo;
-            while (1) {
-                auto node = fsm->index(row, 0, doing);
-                if (!node.isValid()) {
-                    if (!todo.size()) {
-                        break;
-                    } else {
-                        doing = todo.pop();
-                        row = 0;
-                        continue;
-                    }
-                }
-                auto relpath = relPath(fsm->filePath(node));
-                if (blockedPath.startsWith(relpath))  // cover found?
-                {
-                    // continue processing cover later
-                    todo.push(node);
-                } else {
-                    // or just block this one.
-                    blocked.insert(relpath);
+            // block whatever is next to the path on its way down from the cover. Only the directories on the way are
+            // listed, and from the disk, as the model may not have loaded them yet
+            auto current = cover;
+            for (auto& segment : blockedPath.mid(cover.size() + 1).split('/')) {
+                QDir dir(FS::PathCombine(root, current));
+                for (auto& entry : dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden)) {
+                    if (entry != segment)
+                        blocked.insert(FS::PathCombine(current, entry));
                 }
-                row++;
+                current = FS::PathCombine(current, segment);
             }
         }
         changed = true;
@@ -197,26 +233,23 @@ bool FileIgnoreProxy::setFilterState(QModelIndex index, Qt::CheckState state)
             emit dataChanged(up, up, { Qt::CheckStateRole });
             up = up.parent();
         }
-        // and everything below the index
-        QModelIndex doing = index;
-        int row = 0;
+        // and everything below the index, a range at a time, going only into what the model has loaded already
         QStack<QModelIndex> todo;
-        while (1) {
-            auto node = this->index(row, 0, doing);
-            if (!node.isValid()) {
-                if (!todo.size()) {
-                    break;
-                } else {
-                    doing = todo.pop();
-                    row = 0;
-                    continue;
-                }
+        todo.push(index);
+        while (!todo.isEmpty()) {
+            auto parent = todo.pop();
+            auto rows = rowCount(parent);
+            if (rows == 0)
+                continue;
+            emit dataChanged(this->index(0, 0, parent), this->index(rows - 1, 0, parent), { Qt::CheckStateRole });
+            for (int row = 0; row < rows; row++) {
+                auto node = this->index(row, 0, parent);
+                if (fsm->rowCount(mapToSource(node)) > 0)
+                    todo.push(node);
             }
-            emit dataChanged(node, node, { Qt::CheckStateRole });
-            todo.push(node);
-            row++;
         }
         // siblings and unrelated nodes are ignored
+        estimateSize();
     }
     return true;
 }
@@ -229,11 +262,7 @@ bool FileIgnoreProxy::shouldExpand(QModelIndex index)
         return false;
     }
     auto blockedPath = relPath(fsm->filePath(sourceIndex));
-    auto found = blocked.find(blockedPath);
-    if (found) {
-        return !found->leaf();
-    }
-    return false;
+    return blocked.hasChildren(blockedPath);
 }
 
 void FileIgnoreProxy::setBlockedPaths(QStringList paths)
@@ -242,6 +271,7 @@ void FileIgnoreProxy::setBlockedPaths(QStringList paths)
     blocked.clear();
     blocked.insert(paths);
     endResetModel();
+    estimateSize();
 }
 
 bool FileIgnoreProxy::filterAcceptsColumn(int source_column, const QModelIndex& source_parent) const
@@ -272,5 +302,8 @@ bool FileIgnoreProxy::ignoreFile(QFileInfo fileInfo) const
 
 bool FileIgnoreProxy::filterFile(const QString& fileName) const
 {
-    return blocked.covers(fileName) || ignoreFile(QFileInfo(QDir(root), fileName));
+    // exports ask this for every file with its path relative to the root already, it doesn't need to go through a QFileInfo
+    if (blocked.covers(fileName) || m_ignoreFilePaths.covers(fileName))
+        return true;
+    return m_ignoreFiles.contains(fileName.mid(fileName.lastIndexOf('/') + 1));
 }
@@ -36,9 +36,12 @@
 
 #pragma once
 
+#include <QDir>
 #include <QFileInfo>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include "SeparatorPrefixTree.h"
+#include "tasks/CancellationToken.h"
 
 class FileIgnoreProxy : public QSortFilterProxyModel {
     Q_OBJECT
@@ -71,6 +74,13 @@ class FileIgnoreProxy : public QSortFilterProxyModel {
 
     bool filterFile(const QString& fileName) const;
 
+    /// estimate what the export would take in a moment, off this thread, and emit sizeEstimated() with it.
+    /// It's done again on its own whenever the blocked paths change.
+    void estimateSize();
+
+   signals:
+    void sizeEstimated(qint64 bytes);
+
    protected:
     bool filterAcceptsColumn(int source_column, const QModelIndex& source_parent) const;
     bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const;
@@ -79,7 +89,12 @@ class FileIgnoreProxy : public QSortFilterProxyModel {
 
    private:
     const QString root;
+    const QDir m_rootDir;
     SeparatorPrefixTree<'/'> blocked;
     QStringList m_ignoreFiles;
     SeparatorPrefixTree<'/'> m_ignoreFilePaths;
+
+    QTimer m_estimateTimer;
+    CancellationToken m_estimateToken;
+    int m_estimateGeneration = 0;
 };
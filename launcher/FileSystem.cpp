@@ -40,21 +40,31 @@
 
 #include "BuildConfig.h"
 
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QLoggingCategory>
+#include <QMutex>
 #include <QSaveFile>
 #include <QStandardPaths>
 #include <QStorageInfo>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrentMap>
 #include <QtNetwork>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <system_error>
+#include <vector>
 
 #include "DesktopServices.h"
 #include "StringUtils.h"
+#include "Trace.h"
 
 #if defined Q_OS_WIN32
 #define NOMINMAX
@@ -104,8 +114,10 @@ namespace fs = ghc::filesystem;
 #include <sys/ioctl.h>
 #include <unistd.h>
 #elif defined(Q_OS_MACOS)
+#include <fcntl.h>
 #include <sys/attr.h>
 #include <sys/clonefile.h>
+#include <unistd.h>
 #elif defined(Q_OS_WIN)
 // winbtrfs clone vs rundll32 shellbtrfs.dll,ReflinkCopy
 #include <fileapi.h>
@@ -179,6 +191,9 @@ using PFSCTL_SET_INTEGRITY_INFORMATION_BUFFER = _FSCTL_SET_INTEGRITY_INFORMATION
 
 #endif
 
+// the lines for each file, too many to be on by default
+Q_LOGGING_CATEGORY(fsLogC, "launcher.fs")
+
 namespace FS {
 
 void ensureExists(const QDir& dir)
@@ -308,10 +323,70 @@ void copyFolderAttributes(QString src, QString dst, QString relative)
  * @param offset subdirectory form src to copy to dest
  * @return if there was an error during the filecopy
  */
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+// copying small files is bound by the latency of each one, so a few copies run at once even on few cores
+static QThreadPool* copyPool()
+{
+    static QThreadPool* pool = [] {
+        auto pool = new QThreadPool;
+        pool->setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+        return pool;
+    }();
+    return pool;
+}
+#endif
+
+// fewer files than this aren't worth handing out to the pool
+static constexpr int s_parallelCopyMinimum = 32;
+
+// calls `add` with each file below `src` the matcher lets through, and its path relative to `src`. It goes a directory at
+// a time, so the files of a directory the matcher decides as a whole aren't asked about, or not even listed if left out
+static void forEachFilteredFile(const QString& src,
+                                const IPathMatcher* matcher,
+                                bool whitelist,
+                                const std::function<void(const QString&, const QString&)>& add)
+{
+    struct Directory {
+        QString path;
+        QString relative;
+        bool filtered;
+    };
+    QList<Directory> todo{ { src, QString(), matcher != nullptr } };
+    while (!todo.isEmpty()) {
+        auto dir = todo.takeLast();
+        auto relativeTo = [&dir](const QString& name) { return dir.relative.isEmpty() ? name : dir.relative + '/' + name; };
+
+        QDirIterator files(dir.path, QDir::Files | QDir::Hidden);
+        while (files.hasNext()) {
+            auto path = files.next();
+            auto relative = relativeTo(files.fileName());
+            if (!dir.filtered || matcher->matches(relative) == whitelist)
+                add(path, relative);
+        }
+
+        // like QDirIterator::Subdirectories, this doesn't go into linked directories
+        QDirIterator subdirs(dir.path, QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+        while (subdirs.hasNext()) {
+            auto path = subdirs.next();
+            auto relative = relativeTo(subdirs.fileName());
+            bool filtered = dir.filtered;
+            if (filtered) {
+                auto decided = matcher->matchesSubtree(relative);
+                if (decided && *decided != whitelist)
+                    continue;
+                filtered = !decided;
+            }
+            todo.append({ path, relative, filtered });
+        }
+    }
+}
+
 bool copy::operator()(const QString& offset, bool dryRun)
 {
+    TRACE_SPAN("fs", "copy " + PathCombine(m_src.absolutePath(), offset));
     using copy_opts = fs::copy_options;
     m_copied = 0;  // reset counter
+    m_bytesCopied = 0;
     m_failedPaths.clear();
 
 // NOTE always deep copy on windows. the alternatives are too messy.
@@ -322,8 +397,6 @@ bool copy::operator()(const QString& offset, bool dryRun)
     auto src = PathCombine(m_src.absolutePath(), offset);
     auto dst = PathCombine(m_dst.absolutePath(), offset);
 
-    std::error_code err;
-
     fs::copy_options opt = copy_opts::none;
 
     // The default behavior is to follow symlinks
@@ -333,19 +406,83 @@ bool copy::operator()(const QString& offset, bool dryRun)
     if (m_overwrite)
         opt |= copy_opts::overwrite_existing;
 
-    // Function that'll do the actual copying
-    auto copy_file = [&](QString src_path, QString relative_dst_path) {
+    // We can't use copy_opts::recursive because we need to take into account the
+    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
+    // match, we copy the file.
+    QList<QPair<QString, QString>> files;
+    auto add_file = [&](const QString& src_path, const QString& relative_dst_path) {
         if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
             return;
+        files.append({ src_path, relative_dst_path });
+    };
+
+    forEachFilteredFile(src, m_matcher, m_whitelist,
+                        [&](const QString& src_path, const QString& relative_path) { files.append({ src_path, relative_path }); });
+
+    // If the root src is not a directory, the previous iterator won't run.
+    if (!fs::is_directory(StringUtils::toStdString(src)))
+        add_file(src, "");
+
+    // counting and signals go one file at a time, the copies themselves don't have to
+    QMutex lock;
 
+    // the total is known before anything gets copied, so the progress can be told in bytes from the start
+    if (m_countBytes) {
+        qint64 total = 0;
+        for (auto& file : files)
+            total += QFileInfo(file.first).size();
+        emit scanned(files.size(), total);
+    } else {
+        emit scanned(files.size(), -1);
+    }
+
+    // places a file other than by copying it, false if it has to be copied after all
+    auto place_file = [this](const std::string& src_path, const std::string& dst_path) {
+        std::error_code err;
+        // a link or a moved symlink would keep pointing where the copy wouldn't
+        if (m_method == Method::Copy || fs::is_symlink(src_path, err))
+            return false;
+        if (m_overwrite && m_method != Method::Move)
+            fs::remove(dst_path, err);
+        switch (m_method) {
+            case Method::Clone:
+                return clone_file(StringUtils::fromStdString(src_path), StringUtils::fromStdString(dst_path), err);
+            case Method::HardLink:
+                fs::create_hard_link(src_path, dst_path, err);
+                return !err;
+            case Method::Move:
+                if (!m_overwrite && fs::exists(dst_path, err))
+                    return false;
+                fs::rename(src_path, dst_path, err);
+                return !err;
+            default:
+                return false;
+        }
+    };
+
+    // Function that'll do the actual copying
+    auto copy_file = [&](const QPair<QString, QString>& file) {
+        if (m_cancellation.isCancelled())
+            return;
+        const auto& [src_path, relative_dst_path] = file;
         auto dst_path = PathCombine(dst, relative_dst_path);
+        std::error_code err;
         if (!dryRun) {
             ensureFilePathExists(dst_path);
 #ifdef Q_OS_WIN32
             copyFolderAttributes(src, dst, relative_dst_path);
 #endif
-            fs::copy(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), opt, err);
+            auto from = StringUtils::toStdString(src_path);
+            auto to = StringUtils::toStdString(dst_path);
+            // a moved file isn't at the source anymore
+            auto size = m_countBytes ? QFileInfo(src_path).size() : 0;
+            if (!place_file(from, to))
+                fs::copy(from, to, opt, err);
+            if (!err)
+                m_bytesCopied += size;
         }
+
+        QMutexLocker locker(&lock);
         if (err) {
             qWarning() << "Failed to copy files:" << QString::fromStdString(err.message());
             qDebug() << "Source file:" << src_path;
@@ -358,24 +495,19 @@ bool copy::operator()(const QString& offset, bool dryRun)
         emit fileCopied(relative_dst_path);
     };
 
-    // We can't use copy_opts::recursive because we need to take into account the
-    // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
-    // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        copy_file(src_path, relative_path);
+    if (dryRun || files.size() < s_parallelCopyMinimum) {
+        for (auto& file : files)
+            copy_file(file);
+    } else {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        QtConcurrent::blockingMap(copyPool(), files, copy_file);
+#else
+        // no pool can be picked on Qt 5
+        QtConcurrent::blockingMap(files, copy_file);
+#endif
     }
 
-    // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
-        copy_file(src, "");
-
-    return err.value() == 0;
+    return m_failedPaths.isEmpty() && !m_cancellation.isCancelled();
 }
 
 /// qDebug print support for the LinkPair struct
@@ -389,6 +521,7 @@ QDebug operator<<(QDebug debug, const LinkPair& lp)
 
 bool create_link::operator()(const QString& offset, bool dryRun)
 {
+    TRACE_SPAN("fs", QString("link %1 paths").arg(m_path_pairs.size()));
     m_linked = 0;  // reset counter
     m_path_results.clear();
     m_links_to_make.clear();
@@ -423,7 +556,7 @@ void create_link::make_link_list(const QString& offset)
         // Function that'll do the actual linking
         auto link_file = [&](QString src_path, QString relative_dst_path) {
             if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist)) {
-                qDebug() << "path" << relative_dst_path << "in black list or not in whitelist";
+                qCDebug(fsLogC) << "path" << relative_dst_path << "in black list or not in whitelist";
                 return;
             }
 
@@ -434,11 +567,11 @@ void create_link::make_link_list(const QString& offset)
 
         if ((!m_recursive) || !fs::is_directory(StringUtils::toStdString(src))) {
             if (m_debug)
-                qDebug() << "linking single file or dir:" << src << "to" << dst;
+                qCDebug(fsLogC) << "linking single file or dir:" << src << "to" << dst;
             link_file(src, "");
         } else {
             if (m_debug)
-                qDebug() << "linking recursively:" << src << "to" << dst << ", max_depth:" << m_max_depth;
+                qCDebug(fsLogC) << "linking recursively:" << src << "to" << dst << ", max_depth:" << m_max_depth;
             QDir src_dir(src);
             QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
 
@@ -475,15 +608,15 @@ bool create_link::make_links()
         ensureFilePathExists(dst_path);
         if (m_useHardLinks) {
             if (m_debug)
-                qDebug() << "making hard link:" << src_path << "to" << dst_path;
+                qCDebug(fsLogC) << "making hard link:" << src_path << "to" << dst_path;
             fs::create_hard_link(src_path_std, dst_path_std, m_os_err);
         } else if (fs::is_directory(src_path_std)) {
             if (m_debug)
-                qDebug() << "making directory_symlink:" << src_path << "to" << dst_path;
+                qCDebug(fsLogC) << "making directory_symlink:" << src_path << "to" << dst_path;
             fs::create_directory_symlink(src_path_std, dst_path_std, m_os_err);
         } else {
             if (m_debug)
-                qDebug() << "making symlink:" << src_path << "to" << dst_path;
+                qCDebug(fsLogC) << "making symlink:" << src_path << "to" << dst_path;
             fs::create_symlink(src_path_std, dst_path_std, m_os_err);
         }
 
@@ -510,98 +643,248 @@ void create_link::runPrivileged(const QString& offset)
     m_path_results.clear();
     m_links_to_make.clear();
 
-    bool gotResults = false;
-
     make_link_list(offset);
 
-    QString serverName = BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink_server" + StringUtils::getRandomAlphaNumeric();
+    auto linker = PrivilegedLinker::instance();
+    auto id = std::make_shared<quint32>(0);
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    // the answer comes on this thread's event loop, so the id is known by then
+    *connection = connect(linker, &PrivilegedLinker::finished, this,
+                          [this, id, connection](quint32 finished_id, const QList<LinkResult>& results, bool gotResults) {
+                              if (finished_id != *id)
+                                  return;
+                              disconnect(*connection);
+                              for (auto& result : results) {
+                                  if (result.err_value) {
+                                      qDebug() << "privileged link fail" << result.src << "to" << result.dst << "code" << result.err_value
+                                               << result.err_msg;
+                                      emit linkFailed(result.src, result.dst, result.err_msg, result.err_value);
+                                  } else {
+                                      m_linked++;
+                                      emit fileLinked(result.src, result.dst);
+                                  }
+                              }
+                              m_path_results = results;
+                              emit finishedPrivileged(gotResults);
+                          });
+    *id = linker->link(m_links_to_make, m_useHardLinks);
+}
 
-    connect(&m_linkServer, &QLocalServer::newConnection, this, [&]() {
-        qDebug() << "Client connected, sending out pairs";
-        // construct block of data to send
-        QByteArray block;
-        QDataStream out(&block, QIODevice::WriteOnly);
+namespace LinkProtocol {
 
-        qint32 blocksize = quint32(sizeof(quint32));
-        for (auto link : m_links_to_make) {
-            blocksize += quint32(link.src.size());
-            blocksize += quint32(link.dst.size());
-        }
-        qDebug() << "About to write block of size:" << blocksize;
-        out << blocksize;
+static QByteArray frame(const QByteArray& payload)
+{
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out << quint32(payload.size());
+    message.append(payload);
+    return message;
+}
 
-        out << quint32(m_links_to_make.length());
-        for (auto link : m_links_to_make) {
-            out << link.src;
-            out << link.dst;
-        }
+QByteArray message(const Job& job)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << job.id << job.useHardLinks << quint32(job.links.size());
+    for (auto& link : job.links)
+        out << link.src << link.dst;
+    return frame(payload);
+}
 
-        QLocalSocket* clientConnection = m_linkServer.nextPendingConnection();
-        connect(clientConnection, &QLocalSocket::disconnected, clientConnection, &QLocalSocket::deleteLater);
+QByteArray message(const Result& result)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << result.id << result.errValues << result.errMessages;
+    return frame(payload);
+}
 
-        connect(clientConnection, &QLocalSocket::readyRead, this, [&, clientConnection]() {
-            QDataStream in;
-            quint32 blockSize = 0;
-            in.setDevice(clientConnection);
+bool takeMessage(QByteArray& buffer, QByteArray& message)
+{
+    if (buffer.size() < int(sizeof(quint32)))
+        return false;
+    quint32 size;
+    QDataStream in(buffer);
+    in >> size;
+    if (quint32(buffer.size()) - sizeof(quint32) < size)
+        return false;
+    message = buffer.mid(sizeof(quint32), size);
+    buffer.remove(0, sizeof(quint32) + size);
+    return true;
+}
 
-            qDebug() << "Reading path results from client";
-            qDebug() << "bytes available" << clientConnection->bytesAvailable();
+Job readJob(const QByteArray& message)
+{
+    Job job;
+    QDataStream in(message);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 count;
+    in >> job.id >> job.useHardLinks >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        LinkPair link;
+        in >> link.src >> link.dst;
+        job.links.append(link);
+    }
+    return job;
+}
 
-            // Relies on the fact that QDataStream serializes a quint32 into
-            // sizeof(quint32) bytes
-            if (clientConnection->bytesAvailable() < (int)sizeof(quint32))
-                return;
-            qDebug() << "reading block size";
-            in >> blockSize;
+Result readResult(const QByteArray& message)
+{
+    Result result;
+    QDataStream in(message);
+    in.setVersion(QDataStream::Qt_5_12);
+    in >> result.id >> result.errValues >> result.errMessages;
+    return result;
+}
 
-            qDebug() << "blocksize is" << blockSize;
-            qDebug() << "bytes available" << clientConnection->bytesAvailable();
-            if (clientConnection->bytesAvailable() < blockSize || in.atEnd())
-                return;
+}  // namespace LinkProtocol
 
-            quint32 numResults;
-            in >> numResults;
-            qDebug() << "numResults" << numResults;
-
-            for (quint32 i = 0; i < numResults; i++) {
-                FS::LinkResult result;
-                in >> result.src;
-                in >> result.dst;
-                in >> result.err_msg;
-                qint32 err_value;
-                in >> err_value;
-                result.err_value = err_value;
-                if (result.err_value) {
-                    qDebug() << "privileged link fail" << result.src << "to" << result.dst << "code" << result.err_value << result.err_msg;
-                    emit linkFailed(result.src, result.dst, result.err_msg, result.err_value);
-                } else {
-                    qDebug() << "privileged link success" << result.src << "to" << result.dst;
-                    m_linked++;
-                    emit fileLinked(result.src, result.dst);
-                }
-                m_path_results.append(result);
-            }
-            gotResults = true;
-            qDebug() << "results received, closing connection";
-            clientConnection->close();
-        });
-
-        qint64 byteswritten = clientConnection->write(block);
-        bool bytesflushed = clientConnection->flush();
-        qDebug() << "block flushed" << byteswritten << bytesflushed;
+// helper processes quit after this long without links to make
+static constexpr int s_helperIdleMs = 2 * 60 * 1000;
+
+PrivilegedLinker* PrivilegedLinker::instance()
+{
+    static PrivilegedLinker* s_instance = [] {
+        auto linker = new PrivilegedLinker();
+        linker->moveToThread(QCoreApplication::instance()->thread());
+        return linker;
+    }();
+    return s_instance;
+}
+
+PrivilegedLinker::PrivilegedLinker() : m_server(new QLocalServer(this)), m_idleTimer(new QTimer(this))
+{
+    qRegisterMetaType<QList<FS::LinkResult>>();
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(s_helperIdleMs);
+    connect(m_idleTimer, &QTimer::timeout, this, [this] {
+        if (m_helper && m_requests.isEmpty()) {
+            qDebug() << "Letting the idle link helper go";
+            m_helper->disconnectFromServer();
+        }
     });
+    connect(m_server, &QLocalServer::newConnection, this, &PrivilegedLinker::helperConnected);
+}
 
+quint32 PrivilegedLinker::link(const QList<LinkPair>& links, bool useHardLinks)
+{
+    auto id = m_nextId++;
+    QMetaObject::invokeMethod(this, [this, id, links, useHardLinks] { enqueue(id, links, useHardLinks); }, Qt::QueuedConnection);
+    return id;
+}
+
+void PrivilegedLinker::enqueue(quint32 id, const QList<LinkPair>& links, bool useHardLinks)
+{
+    m_idleTimer->stop();
+    auto& request = m_requests[id];
+    if (links.isEmpty()) {
+        finishIfDone(id);
+        return;
+    }
+    for (int i = 0; i < links.size(); i += LinkProtocol::maxLinksPerJob) {
+        LinkProtocol::Job job;
+        job.id = m_nextId++;
+        job.useHardLinks = useHardLinks;
+        job.links = links.mid(i, LinkProtocol::maxLinksPerJob);
+        m_sent.insert(job.id, { id, job.links });
+        request.jobsLeft++;
+        if (m_helper)
+            m_helper->write(LinkProtocol::message(job));
+        else
+            m_unsent.append(job);
+    }
+    if (!m_helperRunning)
+        startHelper();
+}
+
+void PrivilegedLinker::startHelper()
+{
+    QString serverName = BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink_server" + StringUtils::getRandomAlphaNumeric();
     qDebug() << "Listening on pipe" << serverName;
-    if (!m_linkServer.listen(serverName)) {
-        qDebug() << "Unable to start local pipe server on" << serverName << ":" << m_linkServer.errorString();
+    if (!m_server->listen(serverName)) {
+        qDebug() << "Unable to start local pipe server on" << serverName << ":" << m_server->errorString();
+        // nobody is going to answer
+        helperExited();
         return;
     }
 
-    ExternalLinkFileProcess* linkFileProcess = new ExternalLinkFileProcess(serverName, m_useHardLinks, this);
-    connect(linkFileProcess, &ExternalLinkFileProcess::processExited, this, [&]() { emit finishedPrivileged(gotResults); });
-    connect(linkFileProcess, &ExternalLinkFileProcess::finished, linkFileProcess, &QObject::deleteLater);
+    m_helperRunning = true;
+    auto process = new ExternalLinkFileProcess(serverName, this);
+    connect(process, &ExternalLinkFileProcess::processExited, this, &PrivilegedLinker::helperExited);
+    connect(process, &ExternalLinkFileProcess::finished, process, &QObject::deleteLater);
+    process->start();
+}
+
+void PrivilegedLinker::helperConnected()
+{
+    auto socket = m_server->nextPendingConnection();
+    if (m_helper) {
+        // only the helper we started gets to make links
+        socket->close();
+        return;
+    }
+    // nobody else may join the pipe from here on
+    m_server->close();
+
+    qDebug() << "Link helper connected, sending" << m_unsent.size() << "jobs";
+    m_helper = socket;
+    m_buffer.clear();
+    connect(socket, &QLocalSocket::readyRead, this, &PrivilegedLinker::readResults);
+    connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    for (auto& job : m_unsent)
+        socket->write(LinkProtocol::message(job));
+    m_unsent.clear();
+}
+
+void PrivilegedLinker::readResults()
+{
+    m_buffer.append(m_helper->readAll());
+    QByteArray message;
+    while (LinkProtocol::takeMessage(m_buffer, message)) {
+        auto result = LinkProtocol::readResult(message);
+        auto sent = m_sent.take(result.id);
+        if (!m_requests.contains(sent.request))
+            continue;
+        auto& request = m_requests[sent.request];
+        for (int i = 0; i < sent.links.size(); i++) {
+            auto& link = sent.links[i];
+            int errValue = i < result.errValues.size() ? result.errValues[i] : -1;
+            request.results.append({ link.src, link.dst, result.errMessages.value(i), errValue });
+        }
+        request.jobsLeft--;
+        finishIfDone(sent.request);
+    }
+}
+
+void PrivilegedLinker::finishIfDone(quint32 id)
+{
+    auto request = m_requests.find(id);
+    if (request == m_requests.end() || request->jobsLeft > 0)
+        return;
+    auto results = request->results;
+    m_requests.erase(request);
+    emit finished(id, results, true);
+    if (m_requests.isEmpty())
+        m_idleTimer->start();
+}
 
-    linkFileProcess->start();
+void PrivilegedLinker::helperExited()
+{
+    qDebug() << "Link helper exited";
+    m_helperRunning = false;
+    m_helper = nullptr;
+    m_server->close();
+    m_idleTimer->stop();
+    m_unsent.clear();
+    m_sent.clear();
+
+    // what didn't get answered won't be anymore
+    auto requests = m_requests;
+    m_requests.clear();
+    for (auto it = requests.begin(); it != requests.end(); ++it)
+        emit finished(it.key(), it->results, false);
 }
 
 void ExternalLinkFileProcess::runLinkFile()
@@ -610,8 +893,6 @@ void ExternalLinkFileProcess::runLinkFile()
         PathCombine(QCoreApplication::instance()->applicationDirPath(), BuildConfig.LAUNCHER_APP_BINARY_NAME + "_filelink");
     QString params = "-s " + m_server;
 
-    params += " -H " + QVariant(m_useHardLinks).toString();
-
 #if defined Q_OS_WIN32
     SHELLEXECUTEINFO ShExecInfo;
 
@@ -661,6 +942,7 @@ bool move(const QString& source, const QString& dest)
 
 bool deletePath(QString path)
 {
+    TRACE_SPAN("fs", "delete " + path);
     std::error_code err;
 
     fs::remove_all(StringUtils::toStdString(path), err);
@@ -1070,25 +1352,53 @@ bool createShortcut(QString destination, QString target, QStringList args, QStri
 #endif
 }
 
-bool overrideFolder(QString overwritten_path, QString override_path)
+// Moves `from` to `to`, going into the folders both have so only what `from` has gets replaced
+static bool moveOver(const fs::path& from, const fs::path& to)
 {
-    using copy_opts = fs::copy_options;
-
-    if (!FS::ensureFolderPathExists(overwritten_path))
-        return false;
-
     std::error_code err;
-    fs::copy_options opt = copy_opts::recursive | copy_opts::overwrite_existing;
-
-    // FIXME: hello traveller! Apparently std::copy does NOT overwrite existing files on GNU libstdc++ on Windows?
-    fs::copy(StringUtils::toStdString(override_path), StringUtils::toStdString(overwritten_path), opt, err);
-
+    bool from_dir = fs::is_directory(fs::symlink_status(from, err));
+    auto to_status = fs::symlink_status(to, err);
+    if (from_dir && fs::is_directory(to_status)) {
+        // collected first, the entries are moved away from under the iterator
+        std::vector<fs::path> entries;
+        for (fs::directory_iterator it(from, err), end; !err && it != end; it.increment(err))
+            entries.push_back(it->path());
+        if (err) {
+            qCritical() << "Failed to list" << StringUtils::fromStdString(from.native()) << ':' << QString::fromStdString(err.message());
+            return false;
+        }
+        bool moved = true;
+        for (auto& entry : entries)
+            moved = moveOver(entry, to / entry.filename()) && moved;
+        return moved;
+    }
+
+    // a file replaces a file by itself, a folder and a file can't replace each other
+    if (fs::exists(to_status) && from_dir != fs::is_directory(to_status))
+        fs::remove_all(to, err);
+    err.clear();
+    fs::rename(from, to, err);
+    if (!err)
+        return true;
+
+    // on another file system, it has to be copied
+    err.clear();
+    fs::copy(from, to, fs::copy_options::recursive | fs::copy_options::overwrite_existing, err);
     if (err) {
-        qCritical() << QString("Failed to apply override from %1 to %2").arg(override_path, overwritten_path);
+        qCritical() << QString("Failed to apply override from %1 to %2")
+                           .arg(StringUtils::fromStdString(from.native()), StringUtils::fromStdString(to.native()));
         qCritical() << "Reason:" << QString::fromStdString(err.message());
     }
+    return !err;
+}
 
-    return err.value() == 0;
+bool overrideFolder(QString overwritten_path, QString override_path)
+{
+    if (!FS::ensureFolderPathExists(overwritten_path))
+        return false;
+
+    // moved rather than copied, an update of a big pack would otherwise write all of it twice
+    return moveOver(fs::path(StringUtils::toStdString(override_path)), fs::path(StringUtils::toStdString(overwritten_path)));
 }
 
 QString getFilesystemTypeName(FilesystemType type)
@@ -1205,6 +1515,7 @@ bool canClone(const QString& src, const QString& dst)
  */
 bool clone::operator()(const QString& offset, bool dryRun)
 {
+    TRACE_SPAN("fs", "clone " + PathCombine(m_src.absolutePath(), offset));
     if (!canClone(m_src.absolutePath(), m_dst.absolutePath())) {
         qWarning() << "Can not clone: not same device or not clone/reflink filesystem";
         qDebug() << "Source path:" << m_src.absolutePath();
@@ -1222,10 +1533,7 @@ bool clone::operator()(const QString& offset, bool dryRun)
     std::error_code err;
 
     // Function that'll do the actual cloneing
-    auto cloneFile = [&](QString src_path, QString relative_dst_path) {
-        if (m_matcher && (m_matcher->matches(relative_dst_path) != m_whitelist))
-            return;
-
+    auto cloneFile = [&](const QString& src_path, const QString& relative_dst_path) {
         auto dst_path = PathCombine(dst, relative_dst_path);
         if (!dryRun) {
             ensureFilePathExists(dst_path);
@@ -1246,18 +1554,10 @@ bool clone::operator()(const QString& offset, bool dryRun)
     // We can't use copy_opts::recursive because we need to take into account the
     // blacklisted paths, so we iterate over the source directory, and if there's no blacklist
     // match, we copy the file.
-    QDir src_dir(src);
-    QDirIterator source_it(src, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::Subdirectories);
-
-    while (source_it.hasNext()) {
-        auto src_path = source_it.next();
-        auto relative_path = src_dir.relativeFilePath(src_path);
-
-        cloneFile(src_path, relative_path);
-    }
+    forEachFilteredFile(src, m_matcher, m_whitelist, cloneFile);
 
     // If the root src is not a directory, the previous iterator won't run.
-    if (!fs::is_directory(StringUtils::toStdString(src)))
+    if (!fs::is_directory(StringUtils::toStdString(src)) && (!m_matcher || m_matcher->matches("") == m_whitelist))
         cloneFile(src, "");
 
     return err.value() == 0;
@@ -1581,4 +1881,31 @@ uintmax_t hardLinkCount(const QString& path)
     return count;
 }
 
+void readAhead(const QString& path)
+{
+#if defined(Q_OS_LINUX)
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+#elif defined(Q_OS_MACOS)
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    struct radvisory advice;
+    advice.ra_offset = 0;
+    advice.ra_count = static_cast<int>(std::min<qint64>(QFileInfo(path).size(), std::numeric_limits<int>::max()));
+    ::fcntl(fd, F_RDADVISE, &advice);
+    ::close(fd);
+#else
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    char buffer[64 * 1024];
+    while (file.read(buffer, sizeof(buffer)) > 0) {
+    }
+#endif
+}
+
 }  // namespace FS
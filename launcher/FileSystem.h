@@ -39,15 +39,23 @@
 
 #include "Exception.h"
 #include "pathmatcher/IPathMatcher.h"
+#include "tasks/CancellationToken.h"
 
+#include <atomic>
 #include <system_error>
 
 #include <QDir>
 #include <QFlags>
+#include <QHash>
 #include <QLocalServer>
+#include <QLocalSocket>
+#include <QMap>
 #include <QObject>
 #include <QPair>
+#include <QPointer>
 #include <QThread>
+#include <QTimer>
+#include <QVector>
 
 namespace FS {
 
@@ -99,6 +107,17 @@ bool ensureFolderPathExists(QString filenamepath);
 class copy : public QObject {
     Q_OBJECT
    public:
+    /// how each file gets to the destination, the ones other than Copy need both sides on the same filesystem
+    enum class Method {
+        Copy,
+        // copy-on-write, where the filesystem can
+        Clone,
+        // both paths share the same data, editing one in place edits the other
+        HardLink,
+        // takes the file away from the source
+        Move,
+    };
+
     copy(const QString& src, const QString& dst, QObject* parent = nullptr) : QObject(parent)
     {
         m_src.setPath(src);
@@ -124,14 +143,36 @@ class copy : public QObject {
         m_overwrite = overwrite;
         return *this;
     }
+    /// a file that can't be placed like this is copied instead
+    copy& method(Method method)
+    {
+        m_method = method;
+        return *this;
+    }
+    /// add up the size of what's copied, for scanned() and bytesCopied(), which needs a stat of every file
+    copy& countBytes(bool count)
+    {
+        m_countBytes = count;
+        return *this;
+    }
+    /// leave out the files that aren't copied yet once `token` is cancelled, failing the copy
+    copy& cancellation(CancellationToken token)
+    {
+        m_cancellation = std::move(token);
+        return *this;
+    }
 
     bool operator()(bool dryRun = false) { return operator()(QString(), dryRun); }
 
     qsizetype totalCopied() { return m_copied; }
     qsizetype totalFailed() { return m_failedPaths.length(); }
     QStringList failed() { return m_failedPaths; }
+    /// safe to ask while the copy runs
+    qint64 bytesCopied() const { return m_bytesCopied; }
 
    signals:
+    /// everything to copy is known, before the first file is copied
+    void scanned(qsizetype files, qint64 bytes);
     void fileCopied(const QString& relativeName);
     void copyFailed(const QString& relativeName);
     // TODO: maybe add a "shouldCopy" signal in the future?
@@ -144,9 +185,13 @@ class copy : public QObject {
     const IPathMatcher* m_matcher = nullptr;
     bool m_whitelist = false;
     bool m_overwrite = false;
+    Method m_method = Method::Copy;
+    bool m_countBytes = false;
+    CancellationToken m_cancellation;
     QDir m_src;
     QDir m_dst;
     qsizetype m_copied;
+    std::atomic<qint64> m_bytesCopied = 0;
     QStringList m_failedPaths;
 };
 
@@ -162,12 +207,45 @@ struct LinkResult {
     int err_value;
 };
 
+/**
+ * The messages between the launcher and the elevated filelink helper.
+ *
+ * Each message is its size as a quint32 followed by that many bytes of QDataStream. The launcher sends jobs of many
+ * links each, the helper answers every job with the error codes of all its links and the messages of the failed ones,
+ * so the paths only go one way.
+ */
+namespace LinkProtocol {
+struct Job {
+    quint32 id = 0;
+    bool useHardLinks = false;
+    QList<LinkPair> links;
+};
+
+struct Result {
+    quint32 id = 0;
+    // one per link of the job, in order
+    QVector<qint32> errValues;
+    // by index of the link, only for the failed ones
+    QMap<quint32, QString> errMessages;
+};
+
+// links sent in one job at most, big folders take a few of them
+constexpr int maxLinksPerJob = 4096;
+
+QByteArray message(const Job& job);
+QByteArray message(const Result& result);
+
+/// take the next message off the front of the buffer, false if it didn't arrive in full yet
+bool takeMessage(QByteArray& buffer, QByteArray& message);
+
+Job readJob(const QByteArray& message);
+Result readResult(const QByteArray& message);
+}  // namespace LinkProtocol
+
 class ExternalLinkFileProcess : public QThread {
     Q_OBJECT
    public:
-    ExternalLinkFileProcess(QString server, bool useHardLinks, QObject* parent = nullptr)
-        : QThread(parent), m_useHardLinks(useHardLinks), m_server(server)
-    {}
+    ExternalLinkFileProcess(QString server, QObject* parent = nullptr) : QThread(parent), m_server(server) {}
 
     void run() override
     {
@@ -181,11 +259,62 @@ class ExternalLinkFileProcess : public QThread {
    private:
     void runLinkFile();
 
-    bool m_useHardLinks = false;
-
     QString m_server;
 };
 
+/**
+ * Hands links to the elevated filelink helper, the one helper for all the links of the session.
+ *
+ * The helper is started, and elevation asked for, when the first links come. It stays around for a while after the
+ * last ones, so linking a few things in a row doesn't ask again every time.
+ */
+class PrivilegedLinker : public QObject {
+    Q_OBJECT
+   public:
+    /// the linker of this process, living on the main thread
+    static PrivilegedLinker* instance();
+
+    /// queue links for the helper, safe to call from any thread, connect to finished() before
+    quint32 link(const QList<LinkPair>& links, bool useHardLinks);
+
+   signals:
+    /// what the helper did with the links of that call, gotResults is false if it went away before answering all of them
+    void finished(quint32 id, const QList<FS::LinkResult>& results, bool gotResults);
+
+   private:
+    PrivilegedLinker();
+
+    void enqueue(quint32 id, const QList<LinkPair>& links, bool useHardLinks);
+    void startHelper();
+    void helperConnected();
+    void readResults();
+    void helperExited();
+    void finishIfDone(quint32 id);
+
+   private:
+    struct Request {
+        QList<LinkResult> results;
+        int jobsLeft = 0;
+    };
+    struct SentJob {
+        quint32 request;
+        QList<LinkPair> links;
+    };
+
+    QLocalServer* m_server;
+    QPointer<QLocalSocket> m_helper;
+    bool m_helperRunning = false;
+    QTimer* m_idleTimer;
+    QByteArray m_buffer;
+
+    std::atomic<quint32> m_nextId{ 1 };
+    QHash<quint32, Request> m_requests;
+    // jobs waiting for the helper to connect
+    QList<LinkProtocol::Job> m_unsent;
+    // the jobs sent, by job id
+    QHash<quint32, SentJob> m_sent;
+};
+
 /**
  * @brief links (a file / a directory and it's contents) from src to dest
  */
@@ -267,8 +396,6 @@ class create_link : public QObject {
     int m_linked;
     bool m_debug = false;
     std::error_code m_os_err;
-
-    QLocalServer m_linkServer;
 };
 
 /**
@@ -345,7 +472,7 @@ bool checkProblemticPathJava(QDir folder);
 QString getDesktopDir();
 
 // Overrides one folder with the contents of another, preserving items exclusive to the first folder
-// Equivalent to doing QDir::rename, but allowing for overrides
+// Equivalent to doing QDir::rename, but allowing for overrides: the contents are moved, `override_path` is left emptied
 bool overrideFolder(QString overwritten_path, QString override_path);
 
 /**
@@ -545,4 +672,12 @@ bool canLink(const QString& src, const QString& dst);
 
 uintmax_t hardLinkCount(const QString& path);
 
+/**
+ * @brief ask the OS to bring the file into the page cache, so reading it soon doesn't wait for the disk
+ * Where there's no way to just hint that, the file is read through, which blocks until it's done.
+ */
+void readAhead(const QString& path);
+
 }  // namespace FS
+
+Q_DECLARE_METATYPE(FS::LinkResult)
@@ -35,104 +35,323 @@
 
 #include "GZip.h"
 #include <zlib.h>
+#include <QBuffer>
 #include <QByteArray>
 
+#include <limits>
+
+namespace {
+// how much of the compressed stream is held at once
+const int chunkSize = 64 * 1024;
+// deflate can't do better than about this, a trailer claiming more than that is lying
+const qint64 maxRatio = 1032;
+// zlib counts in uInt
+const qint64 maxAvail = std::numeric_limits<uInt>::max();
+
+// setting a z_stream up allocates its window and state, so one of each kind is kept per thread and reset for the next use
+template <bool Inflate>
+struct CachedStream {
+    z_stream strm;
+    bool ok = false;
+
+    CachedStream()
+    {
+        memset(&strm, 0, sizeof(strm));
+        if constexpr (Inflate)
+            ok = inflateInit2(&strm, 16 + MAX_WBITS) == Z_OK;
+        else
+            ok = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    ~CachedStream()
+    {
+        if (!ok)
+            return;
+        if constexpr (Inflate)
+            inflateEnd(&strm);
+        else
+            deflateEnd(&strm);
+    }
+
+    static std::unique_ptr<CachedStream> take()
+    {
+        if (auto& cached = slot()) {
+            auto stream = std::move(cached);
+            int err;
+            if constexpr (Inflate)
+                err = inflateReset(&stream->strm);
+            else
+                err = deflateReset(&stream->strm);
+            if (err == Z_OK)
+                return stream;
+        }
+        return std::make_unique<CachedStream>();
+    }
+    static void give(std::unique_ptr<CachedStream> stream)
+    {
+        if (stream && stream->ok && !slot())
+            slot() = std::move(stream);
+    }
+
+   private:
+    static std::unique_ptr<CachedStream>& slot()
+    {
+        thread_local std::unique_ptr<CachedStream> cached;
+        return cached;
+    }
+};
+using Inflater = CachedStream<true>;
+using Deflater = CachedStream<false>;
+}  // namespace
+
+struct GZipReader::Stream {
+    std::unique_ptr<Inflater> cached;
+};
+struct GZipWriter::Stream {
+    std::unique_ptr<Deflater> cached;
+};
+
 bool GZip::unzip(const QByteArray& compressedBytes, QByteArray& uncompressedBytes)
 {
     if (compressedBytes.size() == 0) {
         uncompressedBytes = compressedBytes;
         return true;
     }
+    // shares the data, doesn't copy it
+    QBuffer buffer;
+    buffer.setData(compressedBytes);
+    buffer.open(QIODevice::ReadOnly);
+    return unzip(buffer, uncompressedBytes);
+}
 
-    unsigned uncompLength = compressedBytes.size();
+bool GZip::zip(const QByteArray& uncompressedBytes, QByteArray& compressedBytes)
+{
+    if (uncompressedBytes.size() == 0) {
+        compressedBytes = uncompressedBytes;
+        return true;
+    }
+    compressedBytes.clear();
+    // the gzip header and trailer on top of the worst deflate can do
+    compressedBytes.reserve(static_cast<int>(compressBound(uncompressedBytes.size()) + 18));
+    QBuffer buffer(&compressedBytes);
+    buffer.open(QIODevice::WriteOnly);
+    return zip(uncompressedBytes, buffer);
+}
+
+bool GZip::unzip(QIODevice& source, QByteArray& uncompressedBytes)
+{
     uncompressedBytes.clear();
-    uncompressedBytes.resize(uncompLength);
+    if (source.atEnd())
+        return true;
 
-    z_stream strm;
-    memset(&strm, 0, sizeof(strm));
-    strm.next_in = (Bytef*)compressedBytes.data();
-    strm.avail_in = compressedBytes.size();
+    GZipReader reader(&source);
+    if (!reader.open(QIODevice::ReadOnly))
+        return false;
+    // one byte more than there is lets zlib get to the end of the stream without asking for more room
+    if (auto expected = reader.expectedSize(); expected > 0 && expected < std::numeric_limits<int>::max())
+        uncompressedBytes.reserve(static_cast<int>(expected + 1));
 
-    bool done = false;
+    qint64 size = 0;
+    while (!reader.atEnd()) {
+        // fill what was reserved first, grow by doubling once that's used up
+        qint64 room = uncompressedBytes.capacity() - size;
+        if (room <= 0)
+            room = qMax<qint64>(size, chunkSize);
+        if (size + room >= std::numeric_limits<int>::max())
+            return false;
+        uncompressedBytes.resize(static_cast<int>(size + room));
+        auto read = reader.read(uncompressedBytes.data() + size, room);
+        if (read < 0)
+            break;
+        size += read;
+        if (read == 0 && !reader.atEnd())
+            break;  // nothing more to read right now
+    }
+    uncompressedBytes.resize(static_cast<int>(size));
+    return reader.finished();
+}
 
-    if (inflateInit2(&strm, (16 + MAX_WBITS)) != Z_OK) {
+bool GZip::zip(const QByteArray& uncompressedBytes, QIODevice& target)
+{
+    GZipWriter writer(&target);
+    if (!writer.open(QIODevice::WriteOnly))
         return false;
-    }
+    if (writer.write(uncompressedBytes) != uncompressedBytes.size())
+        return false;
+    return writer.finish();
+}
 
-    int err = Z_OK;
+GZipReader::GZipReader(QIODevice* source, QObject* parent) : QIODevice(parent), m_source(source) {}
 
-    while (!done) {
-        // If our output buffer is too small
-        if (strm.total_out >= uncompLength) {
-            uncompressedBytes.resize(uncompLength * 2);
-            uncompLength *= 2;
-        }
+GZipReader::~GZipReader()
+{
+    close();
+}
 
-        strm.next_out = reinterpret_cast<Bytef*>((uncompressedBytes.data() + strm.total_out));
-        strm.avail_out = uncompLength - strm.total_out;
+bool GZipReader::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != ReadOnly || !m_source || !m_source->isReadable())
+        return false;
+    auto inflater = Inflater::take();
+    if (!inflater->ok)
+        return false;
+    m_stream.reset(new Stream{ std::move(inflater) });
+    m_input.resize(chunkSize);
+    m_started = m_finished = m_failed = false;
 
-        // Inflate another chunk.
-        err = inflate(&strm, Z_SYNC_FLUSH);
-        if (err == Z_STREAM_END)
-            done = true;
-        else if (err != Z_OK) {
-            break;
+    // ISIZE, the last 4 bytes of the stream, little endian
+    m_expected_size = -1;
+    auto size = m_source->size();
+    if (!m_source->isSequential() && size - m_source->pos() >= 18) {
+        auto pos = m_source->pos();
+        if (m_source->seek(size - 4)) {
+            auto trailer = m_source->read(4);
+            if (trailer.size() == 4) {
+                auto bytes = reinterpret_cast<const uchar*>(trailer.constData());
+                m_expected_size = qint64(bytes[0]) | qint64(bytes[1]) << 8 | qint64(bytes[2]) << 16 | qint64(bytes[3]) << 24;
+                m_expected_size = qMin(m_expected_size, (size - pos) * maxRatio);
+            }
         }
+        if (!m_source->seek(pos))
+            return false;
     }
+    // the caller's buffer is filled directly, another one in between would only copy
+    return QIODevice::open(mode | Unbuffered);
+}
 
-    if (inflateEnd(&strm) != Z_OK || !done) {
-        return false;
+void GZipReader::close()
+{
+    if (m_stream) {
+        Inflater::give(std::move(m_stream->cached));
+        m_stream.reset();
     }
+    m_input.clear();
+    QIODevice::close();
+}
 
-    uncompressedBytes.resize(strm.total_out);
-    return true;
+bool GZipReader::atEnd() const
+{
+    return m_finished || m_failed || !isOpen();
 }
 
-bool GZip::zip(const QByteArray& uncompressedBytes, QByteArray& compressedBytes)
+qint64 GZipReader::readData(char* data, qint64 maxlen)
 {
-    if (uncompressedBytes.size() == 0) {
-        compressedBytes = uncompressedBytes;
-        return true;
+    if (m_finished)
+        return 0;
+    if (m_failed || !m_stream)
+        return -1;
+
+    auto& strm = m_stream->cached->strm;
+    strm.next_out = reinterpret_cast<Bytef*>(data);
+    strm.avail_out = static_cast<uInt>(qMin(maxlen, maxAvail));
+    auto wanted = strm.avail_out;
+    while (strm.avail_out > 0) {
+        if (strm.avail_in == 0) {
+            auto read = m_source->read(m_input.data(), m_input.size());
+            if (read < 0 || (read == 0 && m_source->atEnd())) {
+                // an empty source is an empty stream, one that ends early is broken
+                if (read < 0 || m_started) {
+                    m_failed = true;
+                    setErrorString(tr("The gzip stream is truncated"));
+                } else {
+                    m_finished = true;
+                }
+                break;
+            }
+            if (read == 0)
+                break;  // more to come later
+            strm.next_in = reinterpret_cast<Bytef*>(m_input.data());
+            strm.avail_in = static_cast<uInt>(read);
+            m_started = true;
+        }
+        auto err = inflate(&strm, Z_NO_FLUSH);
+        if (err == Z_STREAM_END) {
+            m_finished = true;
+            break;
+        }
+        if (err != Z_OK && err != Z_BUF_ERROR) {
+            m_failed = true;
+            setErrorString(strm.msg ? QString::fromLatin1(strm.msg) : tr("The gzip stream is corrupt"));
+            break;
+        }
     }
+    qint64 produced = wanted - strm.avail_out;
+    return produced == 0 && m_failed ? -1 : produced;
+}
 
-    unsigned compLength = qMin(uncompressedBytes.size(), 16);
-    compressedBytes.clear();
-    compressedBytes.resize(compLength);
+GZipWriter::GZipWriter(QIODevice* target, QObject* parent) : QIODevice(parent), m_target(target) {}
 
-    z_stream zs;
-    memset(&zs, 0, sizeof(zs));
+GZipWriter::~GZipWriter()
+{
+    close();
+}
 
-    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, (16 + MAX_WBITS), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+bool GZipWriter::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != WriteOnly || !m_target || !m_target->isWritable())
         return false;
-    }
+    auto deflater = Deflater::take();
+    if (!deflater->ok)
+        return false;
+    m_stream.reset(new Stream{ std::move(deflater) });
+    m_output.resize(chunkSize);
+    m_failed = false;
+    return QIODevice::open(mode | Unbuffered);
+}
 
-    zs.next_in = (Bytef*)uncompressedBytes.data();
-    zs.avail_in = uncompressedBytes.size();
+void GZipWriter::close()
+{
+    if (isOpen())
+        finish();
+    QIODevice::close();
+}
 
-    int ret;
-    compressedBytes.resize(uncompressedBytes.size());
+bool GZipWriter::finish()
+{
+    if (!m_stream)
+        return !m_failed;
+    if (!m_failed)
+        m_failed = !deflateInto(Z_FINISH);
+    Deflater::give(std::move(m_stream->cached));
+    m_stream.reset();
+    m_output.clear();
+    return !m_failed;
+}
 
-    unsigned offset = 0;
-    unsigned temp = 0;
-    do {
-        auto remaining = compressedBytes.size() - offset;
-        if (remaining < 1) {
-            compressedBytes.resize(compressedBytes.size() * 2);
+qint64 GZipWriter::writeData(const char* data, qint64 len)
+{
+    if (m_failed || !m_stream)
+        return -1;
+    auto& strm = m_stream->cached->strm;
+    qint64 done = 0;
+    while (done < len) {
+        auto piece = qMin(len - done, maxAvail);
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + done));
+        strm.avail_in = static_cast<uInt>(piece);
+        if (!deflateInto(Z_NO_FLUSH)) {
+            m_failed = true;
+            return -1;
         }
-        zs.next_out = reinterpret_cast<Bytef*>((compressedBytes.data() + offset));
-        temp = zs.avail_out = compressedBytes.size() - offset;
-        ret = deflate(&zs, Z_FINISH);
-        offset += temp - zs.avail_out;
-    } while (ret == Z_OK);
-
-    compressedBytes.resize(offset);
-
-    if (deflateEnd(&zs) != Z_OK) {
-        return false;
+        done += piece;
     }
+    return len;
+}
 
-    if (ret != Z_STREAM_END) {
-        return false;
-    }
+// run deflate until it has taken all the input, or with Z_FINISH until the stream is complete
+bool GZipWriter::deflateInto(int flush)
+{
+    auto& strm = m_stream->cached->strm;
+    int err;
+    do {
+        strm.next_out = reinterpret_cast<Bytef*>(m_output.data());
+        strm.avail_out = static_cast<uInt>(m_output.size());
+        err = deflate(&strm, flush);
+        if (err == Z_STREAM_ERROR)
+            return false;
+        auto produced = m_output.size() - static_cast<qint64>(strm.avail_out);
+        if (produced > 0 && m_target->write(m_output.constData(), produced) != produced) {
+            setErrorString(m_target->errorString());
+            return false;
+        }
+    } while (flush == Z_FINISH ? err != Z_STREAM_END : strm.avail_out == 0);
     return true;
 }
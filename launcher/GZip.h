@@ -1,8 +1,90 @@
 #pragma once
 #include <QByteArray>
+#include <QIODevice>
+
+#include <memory>
 
 class GZip {
    public:
     static bool unzip(const QByteArray& compressedBytes, QByteArray& uncompressedBytes);
     static bool zip(const QByteArray& uncompressedBytes, QByteArray& compressedBytes);
+
+    /// decompress what's left in `source`, which has to be open, sized up front by the gzip trailer when `source` can seek
+    static bool unzip(QIODevice& source, QByteArray& uncompressedBytes);
+    /// compress straight into `target`, which has to be open
+    static bool zip(const QByteArray& uncompressedBytes, QIODevice& target);
+};
+
+/**
+ * Reads what a gzip stream decompresses to, a piece at a time.
+ *
+ * Only what's read is kept in memory, a piece of the compressed stream and whatever the caller asks for. The zlib
+ * streams are reused by the next reader on the same thread instead of being set up again. Reading stops at the end of
+ * the first gzip member, like GZip::unzip always did.
+ */
+class GZipReader : public QIODevice {
+    Q_OBJECT
+   public:
+    /// `source` is neither opened nor closed by the reader and has to outlive it
+    explicit GZipReader(QIODevice* source, QObject* parent = nullptr);
+    ~GZipReader() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    bool atEnd() const override;
+
+    /// the decompressed size the gzip trailer tells, -1 when the source can't seek. Only a hint, it's modulo 4 GiB.
+    qint64 expectedSize() const { return m_expected_size; }
+    /// whether the whole stream was read, as opposed to an error or a truncated stream
+    bool finished() const { return m_finished; }
+
+   protected:
+    qint64 readData(char* data, qint64 maxlen) override;
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+   private:
+    struct Stream;
+
+    QIODevice* m_source;
+    std::unique_ptr<Stream> m_stream;
+    QByteArray m_input;
+    qint64 m_expected_size = -1;
+    bool m_started = false;
+    bool m_finished = false;
+    bool m_failed = false;
+};
+
+/**
+ * Writes a gzip stream, compressing what's written to it as it comes.
+ *
+ * The stream is completed by finish() or close(), before that the target doesn't hold valid gzip data.
+ */
+class GZipWriter : public QIODevice {
+    Q_OBJECT
+   public:
+    /// `target` is neither opened nor closed by the writer and has to outlive it
+    explicit GZipWriter(QIODevice* target, QObject* parent = nullptr);
+    ~GZipWriter() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+
+    /// write the rest of the stream to the target, false if anything couldn't be written
+    bool finish();
+
+   protected:
+    qint64 readData(char*, qint64) override { return -1; }
+    qint64 writeData(const char* data, qint64 len) override;
+
+   private:
+    struct Stream;
+
+    bool deflateInto(int flush);
+
+    QIODevice* m_target;
+    std::unique_ptr<Stream> m_stream;
+    QByteArray m_output;
+    bool m_failed = false;
 };
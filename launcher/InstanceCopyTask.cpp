@@ -1,10 +1,11 @@
 #include "InstanceCopyTask.h"
 #include <QDebug>
-#include <QtConcurrentRun>
+#include <QRegularExpression>
 #include "FileSystem.h"
 #include "NullInstance.h"
 #include "pathmatcher/RegexpMatcher.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 
 InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyPrefs& prefs)
 {
@@ -37,6 +38,8 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, const InstanceCopyP
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
+    // copy what was changed last too
+    m_origInstance->saveNow();
 
     auto copySaves = [&]() {
         QFileInfo mcDir(FS::PathCombine(m_stagingPath, "minecraft"));
@@ -49,12 +52,12 @@ void InstanceCopyTask::executeTask()
             staging_mc_dir = dotMCDir.filePath();
 
         FS::copy savesCopy(FS::PathCombine(m_origInstance->gameRoot(), "saves"), FS::PathCombine(staging_mc_dir, "saves"));
-        savesCopy.followSymlinks(true);
+        savesCopy.followSymlinks(true).cancellation(cancellationToken());
 
         return savesCopy();
     };
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this, copySaves] {
+    m_copyFuture = Executor::instance()->run(Executor::Priority::Bulk, [this, copySaves] {
         if (m_useClone) {
             FS::clone folderClone(m_origInstance->instanceRoot(), m_stagingPath);
             folderClone.matcher(m_matcher.get());
@@ -114,10 +117,8 @@ void InstanceCopyTask::executeTask()
 
             return !there_were_errors;
         } else {
-            FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
-            folderCopy.followSymlinks(false).matcher(m_matcher.get());
-
-            return folderCopy();
+            return copyFastest(m_origInstance->instanceRoot(), m_stagingPath, "\\.?minecraft/", m_matcher.get(), false,
+                               cancellationToken());
         }
     });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &InstanceCopyTask::copyFinished);
@@ -125,6 +126,93 @@ void InstanceCopyTask::executeTask()
     m_copyFutureWatcher.setFuture(m_copyFuture);
 }
 
+namespace {
+/// splits what gets copied into the content that never changes in place and the rest, leaving out what the filter matches
+class ImmutableContentMatcher : public IPathMatcher {
+   public:
+    ImmutableContentMatcher(const QRegularExpression& immutable, const IPathMatcher* filter, bool linked)
+        : m_immutable(immutable), m_filter(filter), m_linked(linked)
+    {}
+
+    /// with linked set the files to link, for use as a whitelist, otherwise the files not to copy
+    bool matches(const QString& path) const override
+    {
+        bool filtered = m_filter && m_filter->matches(path);
+        bool immutable = m_immutable.match(path).hasMatch();
+        return m_linked ? (!filtered && immutable) : (filtered || immutable);
+    }
+
+   private:
+    const QRegularExpression& m_immutable;
+    const IPathMatcher* m_filter;
+    bool m_linked;
+};
+
+/// copy what couldn't be cloned, over whatever the failed clone left behind
+bool copyFailedClones(const QList<QPair<QString, QString>>& failed)
+{
+    bool ok = true;
+    for (auto& [src, dst] : failed) {
+        FS::copy fileCopy(src, dst);
+        ok &= fileCopy.followSymlinks(false).overwrite(true)();
+    }
+    return ok;
+}
+}  // namespace
+
+bool InstanceCopyTask::copyFastest(const QString& root,
+                                   const QString& target,
+                                   const QString& gameDir,
+                                   const IPathMatcher* filter,
+                                   bool followSymlinks,
+                                   const CancellationToken& cancel)
+{
+    const auto srcInfo = FS::statFS(root);
+    const auto dstInfo = FS::statFS(target);
+    const bool sameDevice = srcInfo.rootPath == dstInfo.rootPath;
+
+    // reflinks share the blocks until either side writes, as good as a copy and almost free
+    if (sameDevice && FS::canCloneOnFS(srcInfo) && FS::canCloneOnFS(dstInfo)) {
+        qDebug() << "Cloning instance" << root << "on" << srcInfo.fsTypeName;
+        FS::clone folderClone(root, target);
+        folderClone.matcher(filter);
+        if (folderClone())
+            return true;
+        qDebug() << "Copying" << folderClone.totalFailed() << "files that couldn't be cloned";
+        return copyFailedClones(folderClone.failed());
+    }
+
+    FS::copy folderCopy(root, target);
+    folderCopy.followSymlinks(followSymlinks).cancellation(cancel);
+    if (!sameDevice || !FS::canLinkOnFS(srcInfo)) {
+        folderCopy.matcher(filter);
+        return folderCopy();
+    }
+
+    // mods, packs and libraries are replaced as a whole when they change, never written to
+    const QRegularExpression immutable("^(" + gameDir +
+                                       "(mods|resourcepacks|texturepacks|shaderpacks|coremods)/[^/]+\\.(jar|zip|litemod)(\\.disabled)?|"
+                                       "libraries/.+|jarmods/.+)$");
+
+    // the content that is only ever replaced can be hard linked, the rest has to be a copy of its own
+    qDebug() << "Hard linking the mods, packs and libraries of instance" << root;
+    ImmutableContentMatcher linked(immutable, filter, true);
+    FS::create_link folderLink(root, target);
+    folderLink.linkRecursively(true).useHardLinks(true).matcher(&linked).whitelist(true);
+    if (!folderLink()) {
+        // copying over the links would write into the original files, start over instead
+        qDebug() << "Hard linking failed, copying everything:" << QString::fromStdString(folderLink.getOSError().message());
+        FS::deletePath(target);
+        FS::ensureFolderPathExists(target);
+        folderCopy.matcher(filter);
+        return folderCopy();
+    }
+
+    ImmutableContentMatcher notLinked(immutable, filter, false);
+    folderCopy.matcher(&notLinked);
+    return folderCopy();
+}
+
 void InstanceCopyTask::copyFinished()
 {
     auto successful = m_copyFuture.result();
@@ -16,6 +16,18 @@ class InstanceCopyTask : public InstanceTask {
    public:
     explicit InstanceCopyTask(InstancePtr origInstance, const InstanceCopyPrefs& prefs);
 
+    /**
+     * Copy `root` to `target` the fastest way that still leaves the copy independent of the original, on this thread.
+     * The files are cloned where the filesystem can, otherwise the mods, packs and libraries are hard linked and the rest
+     * is copied. `gameDir` is a pattern for the path of the game folder in `root`, with its slash, or empty if it's `root`.
+     */
+    static bool copyFastest(const QString& root,
+                            const QString& target,
+                            const QString& gameDir,
+                            const IPathMatcher* filter,
+                            bool followSymlinks,
+                            const CancellationToken& cancel);
+
    protected:
     //! Entry point for tasks.
     virtual void executeTask() override;
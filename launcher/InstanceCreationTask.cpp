@@ -1,26 +1,141 @@
 #include "InstanceCreationTask.h"
 
 #include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QEventLoop>
 #include <QFile>
+#include <QFutureWatcher>
+#include <QSet>
+
+#include "FileSystem.h"
 
 InstanceCreationTask::InstanceCreationTask() = default;
 
+void InstanceCreationTask::setPendingExtraction(QFuture<std::optional<QStringList>> extraction)
+{
+    m_extracting = true;
+    m_extraction = extraction;
+}
+
+bool InstanceCreationTask::waitForExtraction()
+{
+    if (!m_extracting)
+        return true;
+
+    if (!m_extraction.isFinished()) {
+        setStatus(tr("Extracting modpack"));
+        QEventLoop loop;
+        QFutureWatcher<std::optional<QStringList>> watcher;
+        connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(m_extraction);
+        if (!m_extraction.isFinished())
+            loop.exec();
+    }
+    m_extracting = false;
+
+    if (m_extraction.isCanceled() || !m_extraction.result().has_value()) {
+        if (m_error_message.isEmpty())
+            setError(tr("Failed to extract modpack"));
+        return false;
+    }
+    return true;
+}
+
+bool InstanceCreationTask::mergeFolder(const QString& from, const QString& to)
+{
+    if (!QFileInfo::exists(to))
+        return QDir().rename(from, to);
+
+    QDir fromDir(from);
+    bool merged = true;
+    QDirIterator it(from, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto file = it.next();
+        auto target = FS::PathCombine(to, fromDir.relativeFilePath(file));
+        if (QFileInfo::exists(target))
+            continue;
+        if (!FS::ensureFilePathExists(target) || !QFile::rename(file, target)) {
+            qWarning() << "Couldn't move" << file << "to" << target;
+            merged = false;
+        }
+    }
+    // empty folders are part of it too
+    QDirIterator dirs(from, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+    while (dirs.hasNext())
+        FS::ensureFolderPathExists(FS::PathCombine(to, fromDir.relativeFilePath(dirs.next())));
+    return FS::deletePath(from) && merged;
+}
+
+static bool sameContents(const QString& a, const QString& b)
+{
+    QFile first(a);
+    QFile second(b);
+    if (first.size() != second.size() || !first.open(QIODevice::ReadOnly) || !second.open(QIODevice::ReadOnly))
+        return false;
+    constexpr qint64 chunk = 64 * 1024;
+    while (!first.atEnd()) {
+        if (first.read(chunk) != second.read(chunk))
+            return false;
+    }
+    return true;
+}
+
+void InstanceCreationTask::diffOverrides(const QString& staged_game_root, const QStringList& new_overrides)
+{
+    if (m_old_game_root.isEmpty())
+        return;
+
+    QSet<QString> still_there;
+    QDir old_game_dir(m_old_game_root);
+    QDir staged_game_dir(staged_game_root);
+    for (auto& entry : new_overrides) {
+        if (entry.isEmpty())
+            continue;
+        still_there.insert(entry);
+        auto staged = staged_game_dir.absoluteFilePath(entry);
+        auto installed = old_game_dir.absoluteFilePath(entry);
+        if (QFileInfo(installed).isFile() && sameContents(staged, installed)) {
+            qDebug() << "Keeping unchanged override" << entry;
+            QFile::remove(staged);
+        }
+    }
+
+    for (auto& entry : m_old_overrides) {
+        if (entry.isEmpty() || still_there.contains(entry))
+            continue;
+        qDebug() << "Scheduling" << entry << "for removal";
+        m_files_to_remove.append(old_game_dir.absoluteFilePath(entry));
+    }
+}
+
 void InstanceCreationTask::executeTask()
 {
     setAbortable(true);
 
     if (updateInstance()) {
+        // the staging folder goes away once this is done
+        if (!waitForExtraction()) {
+            emitFailed(getError());
+            return;
+        }
         emitSucceeded();
         return;
     }
 
     // When the user aborted in the update stage.
     if (m_abort) {
+        waitForExtraction();
         emitAborted();
         return;
     }
 
-    if (!createInstance()) {
+    bool created = createInstance();
+    // whatever happened, nothing may still be writing into the staging folder once this is done
+    if (!waitForExtraction())
+        created = false;
+
+    if (!created) {
         if (m_abort)
             return;
 
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <QFuture>
+#include <QStringList>
+
+#include <optional>
+
 #include "BaseVersion.h"
 #include "InstanceTask.h"
 
@@ -9,6 +14,12 @@ class InstanceCreationTask : public InstanceTask {
     InstanceCreationTask();
     virtual ~InstanceCreationTask() = default;
 
+    /**
+     * The pack is still being extracted into the staging folder while this runs, and only its index is there already.
+     * Anything else in the pack has to wait for waitForExtraction(), downloads don't.
+     */
+    void setPendingExtraction(QFuture<std::optional<QStringList>> extraction);
+
    protected:
     void executeTask() final override;
 
@@ -33,6 +44,28 @@ class InstanceCreationTask : public InstanceTask {
 
     QString getError() const { return m_error_message; }
 
+    /**
+     * Waits for the rest of the pack to be extracted, if it still is.
+     *
+     * Returns whether it all got there (true) or the extraction failed or got aborted (false).
+     */
+    bool waitForExtraction();
+
+    /**
+     * Moves everything in the folder `from` into the folder `to`, keeping the files that are there already.
+     * `from` is gone afterwards. Returns whether all of it could be moved.
+     */
+    static bool mergeFolder(const QString& from, const QString& to);
+
+    /**
+     * When updating, brings only the overrides that changed over to the instance at `m_old_game_root`.
+     *
+     * The old overrides (`m_old_overrides`) the new version doesn't have anymore are scheduled for removal, the new ones
+     * (`new_overrides`, staged in `staged_game_root`) that are the same as the instance has are dropped from the staging, so
+     * the instance keeps them as they are.
+     */
+    void diffOverrides(const QString& staged_game_root, const QStringList& new_overrides);
+
    protected:
     void setError(const QString& message) { m_error_message = message; };
 
@@ -41,6 +74,13 @@ class InstanceCreationTask : public InstanceTask {
 
     QStringList m_files_to_remove;
 
+    // what the previous version of the pack put in the instance, relative to its game root
+    QString m_old_game_root;
+    QStringList m_old_overrides;
+
    private:
     QString m_error_message;
+
+    bool m_extracting = false;
+    QFuture<std::optional<QStringList>> m_extraction;
 };
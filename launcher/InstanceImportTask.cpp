@@ -45,19 +45,19 @@
 #include "icons/IconList.h"
 #include "icons/IconUtils.h"
 
+#include "modplatform/PackUpdatePreparer.h"
 #include "modplatform/flame/FlameInstanceCreationTask.h"
 #include "modplatform/modrinth/ModrinthInstanceCreationTask.h"
 #include "modplatform/technic/TechnicPackProcessor.h"
 
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 
 #include "net/ApiDownload.h"
 
-#include <QtConcurrentRun>
 #include <algorithm>
 
-#include <quazip/quazipdir.h>
 
 InstanceImportTask::InstanceImportTask(const QUrl& sourceUrl, QWidget* parent, QMap<QString, QString>&& extra_info)
     : m_sourceUrl(sourceUrl), m_extra_info(extra_info), m_parent(parent)
@@ -71,8 +71,8 @@ bool InstanceImportTask::abort()
     if (m_filesNetJob)
         m_filesNetJob->abort();
     if (m_extractFuture.isRunning()) {
-        // NOTE: The tasks created by QtConcurrent::run() can't actually get cancelled,
-        // but we can use this call to check the state when the extraction finishes.
+        // the extraction stops before its next entry and cleans up after itself
+        cancellationToken().cancel();
         m_extractFuture.cancel();
         m_extractFuture.waitForFinished();
     }
@@ -97,10 +97,16 @@ void InstanceImportTask::executeTask()
 
 void InstanceImportTask::downloadFromUrl()
 {
-    const QString path = m_sourceUrl.host() + '/' + m_sourceUrl.path();
-    auto entry = APPLICATION->metacache()->resolveEntry("general", path);
+    auto entry = PackUpdatePreparer::archiveEntry(m_sourceUrl);
+    // an update prepared in the background was downloaded and checked already
+    if (APPLICATION->packUpdatePreparer()->isArchivePrepared(m_sourceUrl)) {
+        m_archivePath = entry->getFullPath();
+        processZipPack();
+        return;
+    }
     entry->setStale(true);
     m_filesNetJob.reset(new NetJob(tr("Modpack download"), APPLICATION->network()));
+    m_filesNetJob->setPriority(Net::Priority::Bulk);
     m_filesNetJob->addNetAction(Net::ApiDownload::makeCached(m_sourceUrl, entry));
     m_archivePath = entry->getFullPath();
 
@@ -135,6 +141,20 @@ void InstanceImportTask::downloadAborted()
     m_filesNetJob.reset();
 }
 
+// the index was found through the central directory already, it's read from there instead of looking it up again in QuaZip
+bool InstanceImportTask::extractIndex(const MMCZip::ZipIndex& packIndex, const QString& name, const QString& target)
+{
+    if (auto data = packIndex.read(name)) {
+        try {
+            FS::write(target, *data);
+            return true;
+        } catch (const Exception& e) {
+            qWarning() << "Couldn't write" << target << ":" << e.cause();
+        }
+    }
+    return MMCZip::extractRelFile(m_packZip.get(), name, target);
+}
+
 void InstanceImportTask::processZipPack()
 {
     setStatus(tr("Extracting modpack"));
@@ -148,11 +168,12 @@ void InstanceImportTask::processZipPack()
         return;
     }
 
-    QuaZipDir packZipDir(m_packZip.get());
+    // telling what the pack is only takes its central directory
+    MMCZip::ZipIndex packIndex(m_archivePath);
 
     // https://docs.modrinth.com/docs/modpacks/format_definition/#storage
-    bool modrinthFound = packZipDir.exists("/modrinth.index.json");
-    bool technicFound = packZipDir.exists("/bin/modpack.jar") || packZipDir.exists("/bin/version.json");
+    bool modrinthFound = packIndex.contains("modrinth.index.json");
+    bool technicFound = packIndex.contains("bin/modpack.jar") || packIndex.contains("bin/version.json");
     QString root;
 
     // NOTE: Prioritize modpack platforms that aren't searched for recursively.
@@ -168,18 +189,18 @@ void InstanceImportTask::processZipPack()
         extractDir.cd(".minecraft");
         m_modpackType = ModpackType::Technic;
     } else {
-        QStringList paths_to_ignore{ "overrides/" };
+        // both are looked for in the same pass over the entries
+        auto roots = packIndex.findFoldersOfFiles({ "instance.cfg", "manifest.json" }, { "overrides" });
 
-        if (QString mmcRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "instance.cfg", paths_to_ignore); !mmcRoot.isNull()) {
+        if (auto mmcRoot = roots.constFind("instance.cfg"); mmcRoot != roots.constEnd()) {
             // process as MultiMC instance/pack
-            qDebug() << "MultiMC:" << mmcRoot;
-            root = mmcRoot;
+            qDebug() << "MultiMC:" << *mmcRoot;
+            root = *mmcRoot;
             m_modpackType = ModpackType::MultiMC;
-        } else if (QString flameRoot = MMCZip::findFolderOfFileInZip(m_packZip.get(), "manifest.json", paths_to_ignore);
-                   !flameRoot.isNull()) {
+        } else if (auto flameRoot = roots.constFind("manifest.json"); flameRoot != roots.constEnd()) {
             // process as Flame pack
-            qDebug() << "Flame:" << flameRoot;
-            root = flameRoot;
+            qDebug() << "Flame:" << *flameRoot;
+            root = *flameRoot;
             m_modpackType = ModpackType::Flame;
         }
     }
@@ -188,24 +209,46 @@ void InstanceImportTask::processZipPack()
         return;
     }
 
+    // Flame and Modrinth packs only need their index to get the downloads going, the rest is extracted meanwhile
+    QString index;
+    if (m_modpackType == ModpackType::Flame)
+        index = "manifest.json";
+    else if (m_modpackType == ModpackType::Modrinth)
+        index = "modrinth.index.json";
+    if (!index.isEmpty() && !extractIndex(packIndex, root + index, extractDir.absoluteFilePath(index))) {
+        qWarning() << "Couldn't extract" << index << "on its own, extracting the whole pack first";
+        index.clear();
+    }
+    // the creation task reports its own progress from then on
+    m_pipelined = !index.isEmpty();
+    MMCZip::ExtractProgress progress;
+    if (!m_pipelined)
+        progress = [this](qint64 done, qint64 total) { setProgress(done, total); };
+
     // make sure we extract just the pack
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), root, extractDir.absolutePath());
+    auto cancel = cancellationToken();
+    auto extract = [this, root, index, progress, cancel, target = extractDir.absolutePath()] {
+        auto exclude = [index](const QString& name) { return !index.isEmpty() && name == index; };
+        auto files = MMCZip::extractSubDir(m_packZip.get(), root, target, progress, exclude, cancel);
+        // done here, the creation task may pick the files up before extractFinished() runs
+        if (files)
+            fixPermissions();
+        return files;
+    };
+    m_extractFuture = Executor::instance()->run(Executor::Priority::Bulk, extract, cancel);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &InstanceImportTask::extractFinished);
     m_extractFutureWatcher.setFuture(m_extractFuture);
-}
-
-void InstanceImportTask::extractFinished()
-{
-    m_packZip.reset();
 
-    if (m_extractFuture.isCanceled())
-        return;
-    if (!m_extractFuture.result().has_value()) {
-        emitFailed(tr("Failed to extract modpack"));
-        return;
+    if (m_pipelined) {
+        if (m_modpackType == ModpackType::Flame)
+            processFlame();
+        else
+            processModrinth();
     }
+}
 
+void InstanceImportTask::fixPermissions()
+{
     QDir extractDir(m_stagingPath);
 
     qDebug() << "Fixing permissions for extracted pack files...";
@@ -224,12 +267,33 @@ void InstanceImportTask::extractFinished()
         }
         if (origPermissions != permissions) {
             if (!QFile::setPermissions(filepath, permissions)) {
-                logWarning(tr("Could not fix permissions for %1").arg(filepath));
+                m_permissionWarnings.append(tr("Could not fix permissions for %1").arg(filepath));
             } else {
                 qDebug() << "Fixed" << filepath;
             }
         }
     }
+}
+
+void InstanceImportTask::extractFinished()
+{
+    m_packZip.reset();
+
+    if (m_extractFuture.isCanceled())
+        return;
+    if (!m_extractFuture.result().has_value()) {
+        // the creation task is waiting for it, and says so itself
+        if (!m_pipelined)
+            emitFailed(tr("Failed to extract modpack"));
+        return;
+    }
+
+    for (auto& warning : m_permissionWarnings)
+        logWarning(warning);
+
+    // already on its way
+    if (m_pipelined)
+        return;
 
     switch (m_modpackType) {
         case ModpackType::MultiMC:
@@ -278,6 +342,8 @@ void InstanceImportTask::processFlame()
     inst_creation_task->setIcon(m_instIcon);
     inst_creation_task->setGroup(m_instGroup);
     inst_creation_task->setConfirmUpdate(shouldConfirmUpdate());
+    if (m_pipelined)
+        inst_creation_task->setPendingExtraction(m_extractFuture);
 
     connect(inst_creation_task.get(), &Task::succeeded, this, [this, inst_creation_task] {
         setOverride(inst_creation_task->shouldOverride(), inst_creation_task->originalInstanceID());
@@ -371,6 +437,8 @@ void InstanceImportTask::processModrinth()
     inst_creation_task->setIcon(m_instIcon);
     inst_creation_task->setGroup(m_instGroup);
     inst_creation_task->setConfirmUpdate(shouldConfirmUpdate());
+    if (m_pipelined)
+        inst_creation_task->setPendingExtraction(m_extractFuture);
 
     connect(inst_creation_task, &Task::succeeded, this, [this, inst_creation_task] {
         setOverride(inst_creation_task->shouldOverride(), inst_creation_task->originalInstanceID());
@@ -47,6 +47,9 @@
 #include <optional>
 
 class QuaZip;
+namespace MMCZip {
+class ZipIndex;
+}
 namespace Flame {
 class FileResolvingTask;
 }
@@ -65,10 +68,12 @@ class InstanceImportTask : public InstanceTask {
 
    private:
     void processZipPack();
+    bool extractIndex(const MMCZip::ZipIndex& packIndex, const QString& name, const QString& target);
     void processMultiMC();
     void processTechnic();
     void processFlame();
     void processModrinth();
+    void fixPermissions();
 
    private slots:
     void downloadSucceeded();
@@ -86,6 +91,9 @@ class InstanceImportTask : public InstanceTask {
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
+    QStringList m_permissionWarnings;
+    // the creation task got going before the extraction finished
+    bool m_pipelined = false;
     QVector<Flame::File> m_blockedMods;
     enum class ModpackType {
         Unknown,
@@ -48,6 +48,7 @@
 #include <QTextStream>
 #include <QThread>
 #include <QTimer>
+#include <QtConcurrent>
 #include <QUuid>
 #include <QXmlStreamReader>
 
@@ -55,17 +56,26 @@
 #include "ExponentialSeries.h"
 #include "FileSystem.h"
 #include "InstanceList.h"
+#include "InstanceSnapshot.h"
 #include "InstanceTask.h"
 #include "NullInstance.h"
 #include "WatchLock.h"
 #include "minecraft/MinecraftInstance.h"
+#include "net/DownloadJournal.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 
 #ifdef Q_OS_WIN32
 #include <Windows.h>
 #endif
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
+// how long loaded instances are held back so they get added to the model in batches
+const static int STAGE_INTERVAL_MS = 50;
+// changes to the list are written to the snapshot this long after they stop coming
+const static int SNAPSHOT_DELAY_MS = 5000;
+// instance settings are written out this long after they stop changing
+const static int SETTINGS_SAVE_DELAY_MS = 1000;
 
 InstanceList::InstanceList(SettingsObjectPtr settings, const QString& instDir, QObject* parent)
     : QAbstractListModel(parent), m_globalSettings(settings)
@@ -83,9 +93,27 @@ InstanceList::InstanceList(SettingsObjectPtr settings, const QString& instDir, Q
     m_watcher = new QFileSystemWatcher(this);
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &InstanceList::instanceDirContentsChanged);
     m_watcher->addPath(m_instDir);
+
+    m_stageTimer = new QTimer(this);
+    m_stageTimer->setSingleShot(true);
+    m_stageTimer->setInterval(STAGE_INTERVAL_MS);
+    connect(m_stageTimer, &QTimer::timeout, this, &InstanceList::flushLoadedInstances);
+
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(SNAPSHOT_DELAY_MS);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &InstanceList::saveSnapshot);
 }
 
-InstanceList::~InstanceList() {}
+InstanceList::~InstanceList()
+{
+    if (m_snapshotCheck)
+        m_snapshotCheck->waitForFinished();
+    for (auto watcher : m_loadWatchers) {
+        watcher->cancel();
+        watcher->waitForFinished();
+    }
+}
 
 Qt::DropActions InstanceList::supportedDragActions() const
 {
@@ -425,11 +453,11 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr>&
     return out;
 }
 
-QList<InstanceId> InstanceList::discoverInstances()
+QList<InstanceId> InstanceList::findInstances(const QString& instDir)
 {
-    qDebug() << "Discovering instances in" << m_instDir;
+    qDebug() << "Discovering instances in" << instDir;
     QList<InstanceId> out;
-    QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
+    QDirIterator iter(instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
     while (iter.hasNext()) {
         QString subDir = iter.next();
         QFileInfo dirInfo(subDir);
@@ -438,7 +466,7 @@ QList<InstanceId> InstanceList::discoverInstances()
         // if it is a symlink, ignore it if it goes to the instance folder
         if (dirInfo.isSymLink()) {
             QFileInfo targetInfo(dirInfo.symLinkTarget());
-            QFileInfo instDirInfo(m_instDir);
+            QFileInfo instDirInfo(instDir);
             if (targetInfo.canonicalPath() == instDirInfo.canonicalFilePath()) {
                 qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
                 continue;
@@ -448,33 +476,57 @@ QList<InstanceId> InstanceList::discoverInstances()
         out.append(id);
         qDebug() << "Found instance ID" << id;
     }
+    return out;
+}
+
+QList<InstanceId> InstanceList::discoverInstances()
+{
+    auto out = findInstances(m_instDir);
+    setDiscovered(out);
+    return out;
+}
+
+void InstanceList::setDiscovered(const QList<InstanceId>& ids)
+{
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    instanceSet = QSet<QString>(out.begin(), out.end());
+    instanceSet = QSet<QString>(ids.begin(), ids.end());
 #else
-    instanceSet = out.toSet();
+    instanceSet = ids.toSet();
 #endif
     m_instancesProbed = true;
-    return out;
 }
 
 InstanceList::InstListError InstanceList::loadList()
+{
+    // the first time around, show what was there last time and look at the folder in the background
+    if (!m_instancesProbed && !m_snapshotCheck && m_instances.isEmpty() && restoreSnapshot()) {
+        return NoError;
+    }
+    updateList(discoverInstances());
+    return NoError;
+}
+
+void InstanceList::updateList(const QList<InstanceId>& found)
 {
     auto existingIds = getIdMapping(m_instances);
 
-    QList<InstancePtr> newList;
+    QList<InstanceId> newIds;
+    auto loadingIds = m_loadingIds;
+    m_loadingIds.clear();
 
-    for (auto& id : discoverInstances()) {
+    for (auto& id : found) {
         if (existingIds.contains(id)) {
             auto instPair = existingIds[id];
             existingIds.remove(id);
             qDebug() << "Should keep and soft-reload" << id;
+        } else if (loadingIds.contains(id)) {
+            // still being loaded from an earlier call
+            m_loadingIds.insert(id);
         } else {
-            InstancePtr instPtr = loadInstance(id);
-            if (instPtr) {
-                newList.append(instPtr);
-            }
+            newIds.append(id);
         }
     }
+    // the ones left out are gone already and get dropped when they finish loading
 
     // TODO: looks like a general algorithm with a few specifics inserted. Do something about it.
     if (!existingIds.isEmpty()) {
@@ -488,6 +540,8 @@ InstanceList::InstListError InstanceList::loadList()
         int currentItem = -1;
         auto removeNow = [&]() {
             beginRemoveRows(QModelIndex(), front_bookmark, back_bookmark);
+            for (int i = front_bookmark; i <= back_bookmark; i++)
+                forgetPlayTime(m_instances[i].get());
             m_instances.erase(m_instances.begin() + front_bookmark, m_instances.begin() + back_bookmark + 1);
             endRemoveRows();
             front_bookmark = -1;
@@ -511,21 +565,211 @@ InstanceList::InstListError InstanceList::loadList()
         if (back_bookmark != -1) {
             removeNow();
         }
+        m_snapshotTimer->start();
     }
-    if (newList.size()) {
-        add(newList);
+    if (!newIds.isEmpty()) {
+        startLoading(newIds);
     }
     m_dirty = false;
-    updateTotalPlayTime();
-    return NoError;
 }
 
-void InstanceList::updateTotalPlayTime()
+InstanceList::LoadedSettings InstanceList::readInstanceSettings(const QString& instanceRoot)
+{
+    auto path = FS::PathCombine(instanceRoot, "instance.cfg");
+    QFileInfo info(path);
+    LoadedSettings loaded{ instanceRoot, {}, info.size(), info.lastModified().toMSecsSinceEpoch() };
+    loaded.settings.loadFile(path);
+    return loaded;
+}
+
+InstanceList::SnapshotCheck InstanceList::checkSnapshot(const QString& instDir, const QHash<InstanceId, SettingsStamp>& stamps)
+{
+    SnapshotCheck check{ instDir, findInstances(instDir), {} };
+    for (auto& id : check.found) {
+        auto stamp = stamps.constFind(id);
+        if (stamp == stamps.constEnd())
+            continue;
+
+        auto root = FS::PathCombine(instDir, id);
+        QFileInfo info(FS::PathCombine(root, "instance.cfg"));
+        if (info.size() != stamp->size || info.lastModified().toMSecsSinceEpoch() != stamp->modified)
+            check.changed.append(readInstanceSettings(root));
+    }
+    return check;
+}
+
+bool InstanceList::restoreSnapshot()
+{
+    if (m_snapshotPath.isEmpty())
+        return false;
+
+    auto snapshot = InstanceSnapshot::load(m_snapshotPath);
+    if (snapshot.instDir != m_instDir || snapshot.entries.isEmpty())
+        return false;
+
+    QList<InstancePtr> restored;
+    for (auto& entry : snapshot.entries) {
+        INIFile values;
+        for (auto it = entry.values.constBegin(); it != entry.values.constEnd(); ++it)
+            values.insert(it.key(), it.value());
+
+        // the rest of instance.cfg gets read once it's needed
+        auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(m_instDir, entry.id, "instance.cfg"), values,
+                                                            INISettingsObject::Contents::Partial);
+        if (auto instPtr = loadInstance(entry.id, settings)) {
+            restored.append(instPtr);
+            m_stamps[entry.id] = { entry.size, entry.modified };
+            m_restoredSettings.insert(entry.id, settings);
+        }
+    }
+    add(restored);
+    qDebug() << "Restored" << restored.size() << "instances from the snapshot, checking them in the background";
+
+    m_snapshotCheck = new QFutureWatcher<SnapshotCheck>(this);
+    auto watcher = m_snapshotCheck;
+    connect(watcher, &QFutureWatcher<SnapshotCheck>::finished, this, [this, watcher] {
+        if (m_snapshotCheck == watcher)
+            snapshotChecked();
+    });
+    auto check = [instDir = m_instDir, stamps = m_stamps] { return checkSnapshot(instDir, stamps); };
+    m_snapshotCheck->setFuture(Executor::instance()->run(Executor::Priority::Background, check));
+    return true;
+}
+
+void InstanceList::snapshotChecked()
+{
+    auto check = m_snapshotCheck->result();
+    m_snapshotCheck->deleteLater();
+    m_snapshotCheck = nullptr;
+
+    // the instance folder moved in the meantime
+    if (check.instDir != m_instDir)
+        return;
+
+    for (auto& loaded : check.changed) {
+        auto id = QFileInfo(loaded.instanceRoot).fileName();
+        auto settings = m_restoredSettings.value(id);
+        auto inst = getInstanceById(id);
+        if (!settings || !inst)
+            continue;
+        // it was changed while the launcher wasn't looking, what the snapshot has is outdated
+        settings->complete(loaded.settings);
+        m_stamps[id] = { loaded.size, loaded.modified };
+        propertiesChanged(inst.get());
+    }
+    // the others can be trusted until they get read for real
+    m_restoredSettings.clear();
+
+    setDiscovered(check.found);
+    updateList(check.found);
+    m_snapshotTimer->start();
+}
+
+void InstanceList::saveSnapshot()
+{
+    m_snapshotTimer->stop();
+    // it would miss the instances still being loaded
+    if (m_snapshotPath.isEmpty() || !m_instancesProbed || isLoading())
+        return;
+
+    InstanceSnapshot snapshot;
+    snapshot.instDir = m_instDir;
+    snapshot.entries.reserve(m_instances.size());
+    for (auto& inst : m_instances) {
+        auto stamp = m_stamps.value(inst->id());
+        QVariantMap values{ { "InstanceType", inst->instanceType() },
+                            { "name", inst->name() },
+                            { "iconKey", inst->iconKey() },
+                            { "lastLaunchTime", inst->lastLaunch() },
+                            { "lastTimePlayed", static_cast<qint64>(inst->lastTimePlayed()) },
+                            { "totalTimePlayed", static_cast<qint64>(inst->totalTimePlayed()) } };
+        snapshot.entries.append({ inst->id(), stamp.size, stamp.modified, values });
+    }
+    snapshot.save(m_snapshotPath);
+}
+
+void InstanceList::startLoading(const QList<InstanceId>& ids)
 {
-    totalPlayTime = 0;
-    for (auto const& itr : m_instances) {
-        totalPlayTime += itr.get()->totalTimePlayed();
+    if (!m_groupsLoaded) {
+        loadGroupList();
     }
+
+    QStringList roots;
+    for (auto& id : ids) {
+        m_loadingIds.insert(id);
+        roots.append(FS::PathCombine(m_instDir, id));
+    }
+
+    // reading the files is what takes long, creating the instances has to happen on this thread anyway
+    auto watcher = new QFutureWatcher<LoadedSettings>(this);
+    m_loadWatchers.append(watcher);
+    connect(watcher, &QFutureWatcher<LoadedSettings>::resultReadyAt, this,
+            [this, watcher](int index) { stageLoadedInstance(watcher->resultAt(index)); });
+    connect(watcher, &QFutureWatcher<LoadedSettings>::finished, this, [this, watcher] {
+        m_loadWatchers.removeOne(watcher);
+        watcher->deleteLater();
+        flushLoadedInstances();
+        if (m_loadWatchers.isEmpty()) {
+            qDebug() << "<> Instances loaded.";
+            m_snapshotTimer->start();
+        }
+    });
+    watcher->setFuture(QtConcurrent::mapped(roots, &InstanceList::readInstanceSettings));
+}
+
+void InstanceList::stageLoadedInstance(const LoadedSettings& loaded)
+{
+    auto id = QFileInfo(loaded.instanceRoot).fileName();
+    // removed since, or already taken care of by waitForLoaded()
+    if (!m_loadingIds.remove(id))
+        return;
+
+    auto settings = std::make_shared<INISettingsObject>(FS::PathCombine(loaded.instanceRoot, "instance.cfg"), loaded.settings);
+    if (auto instPtr = loadInstance(id, settings)) {
+        m_stamps[id] = { loaded.size, loaded.modified };
+        m_stagedInstances.append(instPtr);
+        if (!m_stageTimer->isActive())
+            m_stageTimer->start();
+    }
+}
+
+void InstanceList::flushLoadedInstances()
+{
+    m_stageTimer->stop();
+    if (m_stagedInstances.isEmpty())
+        return;
+
+    add(m_stagedInstances);
+    m_stagedInstances.clear();
+}
+
+void InstanceList::waitForLoaded()
+{
+    // the watchers may not have told us about everything yet, that needs the event loop
+    if (m_snapshotCheck) {
+        m_snapshotCheck->waitForFinished();
+        snapshotChecked();
+    }
+    for (auto watcher : m_loadWatchers) {
+        watcher->waitForFinished();
+        for (auto& loaded : watcher->future().results())
+            stageLoadedInstance(loaded);
+    }
+    flushLoadedInstances();
+}
+
+void InstanceList::countPlayTime(BaseInstance* inst)
+{
+    auto recorded = inst->settings()->get("totalTimePlayed").toLongLong();
+    auto& counted = m_playTimes[inst];
+    totalPlayTime += recorded - counted;
+    counted = recorded;
+}
+
+void InstanceList::forgetPlayTime(BaseInstance* inst)
+{
+    totalPlayTime -= m_playTimes.take(inst);
+    m_runningInstances.remove(inst);
 }
 
 void InstanceList::saveNow()
@@ -533,6 +777,7 @@ void InstanceList::saveNow()
     for (auto& item : m_instances) {
         item->saveNow();
     }
+    saveSnapshot();
 }
 
 void InstanceList::add(const QList<InstancePtr>& t)
@@ -540,9 +785,31 @@ void InstanceList::add(const QList<InstancePtr>& t)
     beginInsertRows(QModelIndex(), m_instances.count(), m_instances.count() + t.size() - 1);
     m_instances.append(t);
     for (auto& ptr : t) {
-        connect(ptr.get(), &BaseInstance::propertiesChanged, this, &InstanceList::propertiesChanged);
+        auto inst = ptr.get();
+        connect(inst, &BaseInstance::propertiesChanged, this, &InstanceList::propertiesChanged);
+        connect(inst, &BaseInstance::runningStatusChanged, this, [this, inst](bool running) {
+            if (!m_playTimes.contains(inst))
+                return;
+            if (running)
+                m_runningInstances.insert(inst);
+            else
+                m_runningInstances.remove(inst);
+        });
+        // whatever sets it, a game that ended or a reset
+        connect(inst->settings().get(), &SettingsObject::SettingChanged, this, [this, inst](const Setting& setting, QVariant) {
+            if (setting.id() == "totalTimePlayed" && m_playTimes.contains(inst))
+                countPlayTime(inst);
+        });
+        connect(inst->settings().get(), &SettingsObject::settingReset, this, [this, inst](const Setting& setting) {
+            if (setting.id() == "totalTimePlayed" && m_playTimes.contains(inst))
+                countPlayTime(inst);
+        });
+        countPlayTime(inst);
+        if (inst->isRunning())
+            m_runningInstances.insert(inst);
     }
     endInsertRows();
+    m_snapshotTimer->start();
 }
 
 void InstanceList::resumeWatch()
@@ -616,20 +883,21 @@ void InstanceList::propertiesChanged(BaseInstance* inst)
     int i = getInstIndex(inst);
     if (i != -1) {
         emit dataChanged(index(i), index(i));
-        updateTotalPlayTime();
+        countPlayTime(inst);
+        m_snapshotTimer->start();
     }
 }
 
-InstancePtr InstanceList::loadInstance(const InstanceId& id)
+InstancePtr InstanceList::loadInstance(const InstanceId& id, std::shared_ptr<INISettingsObject> instanceSettings)
 {
     if (!m_groupsLoaded) {
         loadGroupList();
     }
 
     auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
     InstancePtr inst;
 
+    instanceSettings->setSaveDelay(SETTINGS_SAVE_DELAY_MS);
     instanceSettings->registerSetting("InstanceType", "");
 
     QString inst_type = instanceSettings->get("InstanceType").toString();
@@ -825,7 +1093,14 @@ void InstanceList::on_InstFolderChanged([[maybe_unused]] const Setting& setting,
         m_groupsLoaded = false;
         beginRemoveRows(QModelIndex(), 0, count());
         m_instances.erase(m_instances.begin(), m_instances.end());
+        m_playTimes.clear();
+        m_runningInstances.clear();
+        totalPlayTime = 0;
         endRemoveRows();
+        // whatever is still loading comes from the old folder
+        m_loadingIds.clear();
+        m_stagedInstances.clear();
+        m_restoredSettings.clear();
         emit instancesChanged();
     }
 }
@@ -992,6 +1267,7 @@ bool InstanceList::commitStagedInstance(const QString& path,
         instanceSet.insert(instID);
 
         emit instancesChanged();
+        waitForLoaded();
         emit instanceSelectRequest(instID);
     }
 
@@ -1001,13 +1277,18 @@ bool InstanceList::commitStagedInstance(const QString& path,
 
 bool InstanceList::destroyStagingPath(const QString& keyPath)
 {
+    // what the downloads of a failed install got so far is kept for the next try
+    if (auto journal = Net::DownloadJournal::shared())
+        journal->rescue(keyPath);
     return FS::deletePath(keyPath);
 }
 
 int InstanceList::getTotalPlayTime()
 {
-    updateTotalPlayTime();
-    return totalPlayTime;
+    auto total = totalPlayTime;
+    for (auto inst : m_runningInstances)
+        total += inst->totalTimePlayed() - m_playTimes.value(inst);
+    return static_cast<int>(total);
 }
 
 #include "InstanceList.moc"
@@ -36,6 +36,8 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QPair>
@@ -43,8 +45,10 @@
 #include <QStack>
 
 #include "BaseInstance.h"
+#include "settings/INISettingsObject.h"
 
 class QFileSystemWatcher;
+class QTimer;
 class InstanceTask;
 struct InstanceName;
 
@@ -94,9 +98,23 @@ class InstanceList : public QAbstractListModel {
 
     int count() const { return m_instances.count(); }
 
+    /**
+     * Look for instances that got added or removed since the last call.
+     * New instances are loaded on worker threads and show up in the model as they finish, see waitForLoaded().
+     */
     InstListError loadList();
+    /// block until every instance found by loadList() so far is in the model
+    void waitForLoaded();
+    [[nodiscard]] bool isLoading() const { return !m_loadWatchers.isEmpty() || m_snapshotCheck; }
+    /// saves every instance, and the snapshot of the list
     void saveNow();
 
+    /**
+     * Keep a snapshot of what the list shows at `path`.
+     * The first loadList() fills the list from it right away, and only checks it against the instance folder in the background.
+     */
+    void setSnapshotPath(const QString& path) { m_snapshotPath = path; }
+
     /* O(n) */
     InstancePtr getInstanceById(QString id) const;
     /* O(n) */
@@ -167,24 +185,62 @@ class InstanceList : public QAbstractListModel {
     void propertiesChanged(BaseInstance* inst);
     void providerUpdated();
     void instanceDirContentsChanged(const QString& path);
+    void flushLoadedInstances();
+    void saveSnapshot();
 
    private:
+    /// what a worker thread read from disk for an instance
+    struct LoadedSettings {
+        QString instanceRoot;
+        INIFile settings;
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+    /// size and modification time of an instance.cfg, when it was read
+    struct SettingsStamp {
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+    /// what the instance folder looks like compared to the snapshot
+    struct SnapshotCheck {
+        QString instDir;
+        QList<InstanceId> found;
+        QList<LoadedSettings> changed;
+    };
+
+    static QList<InstanceId> findInstances(const QString& instDir);
+    static LoadedSettings readInstanceSettings(const QString& instanceRoot);
+    static SnapshotCheck checkSnapshot(const QString& instDir, const QHash<InstanceId, SettingsStamp>& stamps);
+
     int getInstIndex(BaseInstance* inst) const;
-    void updateTotalPlayTime();
+    /// bring the play time of `inst` up to date in the total
+    void countPlayTime(BaseInstance* inst);
+    void forgetPlayTime(BaseInstance* inst);
     void suspendWatch();
     void resumeWatch();
     void add(const QList<InstancePtr>& list);
     void loadGroupList();
     void saveGroupList();
     QList<InstanceId> discoverInstances();
-    InstancePtr loadInstance(const InstanceId& id);
+    void setDiscovered(const QList<InstanceId>& ids);
+    void updateList(const QList<InstanceId>& found);
+    InstancePtr loadInstance(const InstanceId& id, std::shared_ptr<INISettingsObject> instanceSettings);
+    bool restoreSnapshot();
+    void snapshotChecked();
+    void startLoading(const QList<InstanceId>& ids);
+    void stageLoadedInstance(const LoadedSettings& loaded);
 
     void increaseGroupCount(const QString& group);
     void decreaseGroupCount(const QString& group);
 
    private:
     int m_watchLevel = 0;
-    int totalPlayTime = 0;
+    // the sum of what's in m_playTimes
+    qint64 totalPlayTime = 0;
+    // the recorded play time of each instance when it was last counted, so a change is counted by its difference
+    QHash<BaseInstance*, qint64> m_playTimes;
+    // their current sessions count towards the total too
+    QSet<BaseInstance*> m_runningInstances;
     bool m_dirty = false;
     QList<InstancePtr> m_instances;
     // id -> refs
@@ -201,4 +257,18 @@ class InstanceList : public QAbstractListModel {
     bool m_instancesProbed = false;
 
     QStack<TrashHistoryItem> m_trashHistory;
+
+    QList<QFutureWatcher<LoadedSettings>*> m_loadWatchers;
+    // ids that are being loaded, and still wanted once they are
+    QSet<InstanceId> m_loadingIds;
+    // loaded on the workers, waiting to be added to the model in one go
+    QList<InstancePtr> m_stagedInstances;
+    QTimer* m_stageTimer;
+
+    QString m_snapshotPath;
+    QHash<InstanceId, SettingsStamp> m_stamps;
+    QFutureWatcher<SnapshotCheck>* m_snapshotCheck = nullptr;
+    // settings of the instances restored from the snapshot, until they're checked
+    QHash<InstanceId, std::shared_ptr<INISettingsObject>> m_restoredSettings;
+    QTimer* m_snapshotTimer;
 };
@@ -0,0 +1,59 @@
+#include "InstanceSnapshot.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+static const quint32 s_magic = 0x494C5350;  // "ILSP"
+static const quint32 s_version = 1;
+
+InstanceSnapshot InstanceSnapshot::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream in(file.readAll());
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    InstanceSnapshot snapshot;
+    in >> magic >> version >> snapshot.instDir >> count;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return {};
+
+    snapshot.entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Entry entry;
+        in >> entry.id >> entry.size >> entry.modified >> entry.values;
+        snapshot.entries.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring damaged instance list snapshot" << path;
+        return {};
+    }
+    return snapshot;
+}
+
+bool InstanceSnapshot::save(const QString& path) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    out << s_magic << s_version << instDir << static_cast<quint32>(entries.size());
+    for (auto const& entry : entries)
+        out << entry.id << entry.size << entry.modified << entry.values;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Couldn't write instance list snapshot" << path << ":" << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * What the instance list showed the last time around, so it can be shown again before any instance.cfg is read.
+ *
+ * Each entry holds the settings the list needs for display, and the size and modification time instance.cfg had
+ * when they were read, to tell whether they can still be trusted.
+ */
+struct InstanceSnapshot {
+    struct Entry {
+        QString id;
+        qint64 size = 0;
+        qint64 modified = 0;
+        // the instance.cfg values needed for display, defaults included
+        QVariantMap values;
+    };
+
+    QString instDir;
+    QList<Entry> entries;
+
+    /// read the snapshot at `path`, returns an empty one if there's none or it's unusable
+    static InstanceSnapshot load(const QString& path);
+    bool save(const QString& path) const;
+};
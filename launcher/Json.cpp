@@ -150,133 +150,451 @@ QJsonValue toJson<QVariant>(const QVariant& variant)
     return QJsonValue::fromVariant(variant);
 }
 
+// sets the reason when the caller wants one
+static bool rejectWith(const char** reason, const char* why)
+{
+    if (reason) {
+        *reason = why;
+    }
+    return false;
+}
+
 template <>
-QByteArray requireIsType<QByteArray>(const QJsonValue& value, const QString& what)
+bool readIsType<QByteArray>(const QJsonValue& value, QByteArray& out, const char** reason)
 {
-    const QString string = ensureIsType<QString>(value, what);
+    QString string;
+    if (!value.isNull() && !value.isUndefined() && !readIsType<QString>(value, string, reason)) {
+        return false;
+    }
     // ensure that the string can be safely cast to Latin1
-    if (string != QString::fromLatin1(string.toLatin1())) {
-        throw JsonException(what + " is not encodable as Latin1");
+    auto latin1 = string.toLatin1();
+    if (string != QString::fromLatin1(latin1)) {
+        return rejectWith(reason, "is not encodable as Latin1");
     }
-    return QByteArray::fromHex(string.toLatin1());
+    out = QByteArray::fromHex(latin1);
+    return true;
 }
 
 template <>
-QJsonArray requireIsType<QJsonArray>(const QJsonValue& value, const QString& what)
+bool readIsType<QJsonArray>(const QJsonValue& value, QJsonArray& out, const char** reason)
 {
     if (!value.isArray()) {
-        throw JsonException(what + " is not an array");
+        return rejectWith(reason, "is not an array");
     }
-    return value.toArray();
+    out = value.toArray();
+    return true;
 }
 
 template <>
-QString requireIsType<QString>(const QJsonValue& value, const QString& what)
+bool readIsType<QString>(const QJsonValue& value, QString& out, const char** reason)
 {
     if (!value.isString()) {
-        throw JsonException(what + " is not a string");
+        return rejectWith(reason, "is not a string");
     }
-    return value.toString();
+    out = value.toString();
+    return true;
 }
 
 template <>
-bool requireIsType<bool>(const QJsonValue& value, const QString& what)
+bool readIsType<bool>(const QJsonValue& value, bool& out, const char** reason)
 {
     if (!value.isBool()) {
-        throw JsonException(what + " is not a bool");
+        return rejectWith(reason, "is not a bool");
     }
-    return value.toBool();
+    out = value.toBool();
+    return true;
 }
 
 template <>
-double requireIsType<double>(const QJsonValue& value, const QString& what)
+bool readIsType<double>(const QJsonValue& value, double& out, const char** reason)
 {
     if (!value.isDouble()) {
-        throw JsonException(what + " is not a double");
+        return rejectWith(reason, "is not a double");
     }
-    return value.toDouble();
+    out = value.toDouble();
+    return true;
 }
 
 template <>
-int requireIsType<int>(const QJsonValue& value, const QString& what)
+bool readIsType<int>(const QJsonValue& value, int& out, const char** reason)
 {
-    const double doubl = requireIsType<double>(value, what);
+    double doubl = 0;
+    if (!readIsType<double>(value, doubl, reason)) {
+        return false;
+    }
     if (fmod(doubl, 1) != 0) {
-        throw JsonException(what + " is not an integer");
+        return rejectWith(reason, "is not an integer");
     }
-    return int(doubl);
+    out = int(doubl);
+    return true;
 }
 
 template <>
-QDateTime requireIsType<QDateTime>(const QJsonValue& value, const QString& what)
+bool readIsType<QDateTime>(const QJsonValue& value, QDateTime& out, const char** reason)
 {
-    const QString string = requireIsType<QString>(value, what);
-    const QDateTime datetime = QDateTime::fromString(string, Qt::ISODate);
-    if (!datetime.isValid()) {
-        throw JsonException(what + " is not a ISO formatted date/time value");
+    QString string;
+    if (!readIsType<QString>(value, string, reason)) {
+        return false;
+    }
+    out = QDateTime::fromString(string, Qt::ISODate);
+    if (!out.isValid()) {
+        return rejectWith(reason, "is not a ISO formatted date/time value");
     }
-    return datetime;
+    return true;
 }
 
 template <>
-QUrl requireIsType<QUrl>(const QJsonValue& value, const QString& what)
+bool readIsType<QUrl>(const QJsonValue& value, QUrl& out, const char** reason)
 {
-    const QString string = ensureIsType<QString>(value, what);
+    QString string;
+    if (!value.isNull() && !value.isUndefined() && !readIsType<QString>(value, string, reason)) {
+        return false;
+    }
     if (string.isEmpty()) {
-        return QUrl();
+        out = QUrl();
+        return true;
     }
-    const QUrl url = QUrl(string, QUrl::StrictMode);
-    if (!url.isValid()) {
-        throw JsonException(what + " is not a correctly formatted URL");
+    out = QUrl(string, QUrl::StrictMode);
+    if (!out.isValid()) {
+        return rejectWith(reason, "is not a correctly formatted URL");
     }
-    return url;
+    return true;
 }
 
 template <>
-QDir requireIsType<QDir>(const QJsonValue& value, const QString& what)
+bool readIsType<QDir>(const QJsonValue& value, QDir& out, const char** reason)
 {
-    const QString string = requireIsType<QString>(value, what);
+    QString string;
+    if (!readIsType<QString>(value, string, reason)) {
+        return false;
+    }
     // FIXME: does not handle invalid characters!
-    return QDir::current().absoluteFilePath(string);
+    out = QDir::current().absoluteFilePath(string);
+    return true;
 }
 
 template <>
-QUuid requireIsType<QUuid>(const QJsonValue& value, const QString& what)
+bool readIsType<QUuid>(const QJsonValue& value, QUuid& out, const char** reason)
 {
-    const QString string = requireIsType<QString>(value, what);
-    const QUuid uuid = QUuid(string);
-    if (uuid.toString() != string)  // converts back => valid
+    QString string;
+    if (!readIsType<QString>(value, string, reason)) {
+        return false;
+    }
+    out = QUuid(string);
+    if (out.toString() != string)  // converts back => valid
     {
-        throw JsonException(what + " is not a valid UUID");
+        return rejectWith(reason, "is not a valid UUID");
     }
-    return uuid;
+    return true;
 }
 
 template <>
-QJsonObject requireIsType<QJsonObject>(const QJsonValue& value, const QString& what)
+bool readIsType<QJsonObject>(const QJsonValue& value, QJsonObject& out, const char** reason)
 {
     if (!value.isObject()) {
-        throw JsonException(what + " is not an object");
+        return rejectWith(reason, "is not an object");
     }
-    return value.toObject();
+    out = value.toObject();
+    return true;
 }
 
 template <>
-QVariant requireIsType<QVariant>(const QJsonValue& value, const QString& what)
+bool readIsType<QVariant>(const QJsonValue& value, QVariant& out, const char** reason)
 {
     if (value.isNull() || value.isUndefined()) {
-        throw JsonException(what + " is null or undefined");
+        return rejectWith(reason, "is null or undefined");
     }
-    return value.toVariant();
+    out = value.toVariant();
+    return true;
 }
 
 template <>
-QJsonValue requireIsType<QJsonValue>(const QJsonValue& value, const QString& what)
+bool readIsType<QJsonValue>(const QJsonValue& value, QJsonValue& out, const char** reason)
 {
     if (value.isNull() || value.isUndefined()) {
-        throw JsonException(what + " is null or undefined");
+        return rejectWith(reason, "is null or undefined");
+    }
+    out = value;
+    return true;
+}
+
+Reader::Reader(const QByteArray& data) : m_data(data) {}
+
+void Reader::fail(const QString& error)
+{
+    if (m_error.isEmpty())
+        m_error = error;
+}
+
+void Reader::skipWhitespace()
+{
+    while (m_pos < m_data.size()) {
+        auto c = m_data.at(m_pos);
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return;
+        m_pos++;
+    }
+}
+
+bool Reader::expect(char c)
+{
+    if (hasError())
+        return false;
+    skipWhitespace();
+    if (m_pos >= m_data.size() || m_data.at(m_pos) != c) {
+        fail(QObject::tr("Expected '%1' at offset %2").arg(c).arg(m_pos));
+        return false;
+    }
+    m_pos++;
+    return true;
+}
+
+Reader::Type Reader::peek()
+{
+    if (hasError())
+        return Type::Invalid;
+    skipWhitespace();
+    if (m_pos >= m_data.size())
+        return Type::Invalid;
+    switch (m_data.at(m_pos)) {
+        case '{':
+            return Type::Object;
+        case '[':
+            return Type::Array;
+        case '"':
+            return Type::String;
+        case 't':
+        case 'f':
+            return Type::Boolean;
+        case 'n':
+            return Type::Null;
+        default: {
+            auto c = m_data.at(m_pos);
+            return (c == '-' || (c >= '0' && c <= '9')) ? Type::Number : Type::Invalid;
+        }
+    }
+}
+
+bool Reader::beginObject()
+{
+    if (!expect('{'))
+        return false;
+    m_first.append(true);
+    return true;
+}
+
+bool Reader::nextKey(QString& key)
+{
+    if (hasError() || m_first.isEmpty())
+        return false;
+    skipWhitespace();
+    if (m_pos < m_data.size() && m_data.at(m_pos) == '}') {
+        m_pos++;
+        m_first.removeLast();
+        return false;
+    }
+    if (!m_first.last() && !expect(','))
+        return false;
+    m_first.last() = false;
+    skipWhitespace();
+    return readRawString(key) && expect(':');
+}
+
+bool Reader::beginArray()
+{
+    if (!expect('['))
+        return false;
+    m_first.append(true);
+    return true;
+}
+
+bool Reader::nextElement()
+{
+    if (hasError() || m_first.isEmpty())
+        return false;
+    skipWhitespace();
+    if (m_pos < m_data.size() && m_data.at(m_pos) == ']') {
+        m_pos++;
+        m_first.removeLast();
+        return false;
+    }
+    if (!m_first.last() && !expect(','))
+        return false;
+    m_first.last() = false;
+    return true;
+}
+
+bool Reader::readRawString(QString& out)
+{
+    if (m_pos >= m_data.size() || m_data.at(m_pos) != '"') {
+        fail(QObject::tr("Expected a string at offset %1").arg(m_pos));
+        return false;
+    }
+    m_pos++;
+    auto start = m_pos;
+    // mostly there's nothing to unescape, take it as it is
+    while (m_pos < m_data.size() && m_data.at(m_pos) != '"' && m_data.at(m_pos) != '\\')
+        m_pos++;
+    if (m_pos < m_data.size() && m_data.at(m_pos) == '"') {
+        out = QString::fromUtf8(m_data.constData() + start, int(m_pos - start));
+        m_pos++;
+        return true;
+    }
+
+    QByteArray raw = m_data.mid(start, m_pos - start);
+    while (m_pos < m_data.size()) {
+        auto c = m_data.at(m_pos++);
+        if (c == '"') {
+            out = QString::fromUtf8(raw);
+            return true;
+        }
+        if (c != '\\') {
+            raw.append(c);
+            continue;
+        }
+        if (m_pos >= m_data.size())
+            break;
+        c = m_data.at(m_pos++);
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                raw.append(c);
+                break;
+            case 'b':
+                raw.append('\b');
+                break;
+            case 'f':
+                raw.append('\f');
+                break;
+            case 'n':
+                raw.append('\n');
+                break;
+            case 'r':
+                raw.append('\r');
+                break;
+            case 't':
+                raw.append('\t');
+                break;
+            case 'u': {
+                bool ok = false;
+                uint code = m_pos + 4 <= m_data.size() ? m_data.mid(m_pos, 4).toUInt(&ok, 16) : 0;
+                if (!ok) {
+                    fail(QObject::tr("Invalid escape sequence at offset %1").arg(m_pos));
+                    return false;
+                }
+                m_pos += 4;
+                // the second half of a surrogate pair follows as another escape
+                if (QChar::isHighSurrogate(code) && m_data.mid(m_pos, 2) == "\\u") {
+                    auto low = m_data.mid(m_pos + 2, 4).toUInt(&ok, 16);
+                    if (ok && QChar::isLowSurrogate(low)) {
+                        code = QChar::surrogateToUcs4(ushort(code), ushort(low));
+                        m_pos += 6;
+                    }
+                }
+                QString decoded;
+                if (QChar::requiresSurrogates(code)) {
+                    decoded.append(QChar(QChar::highSurrogate(code)));
+                    decoded.append(QChar(QChar::lowSurrogate(code)));
+                } else {
+                    decoded.append(QChar(ushort(code)));
+                }
+                raw.append(decoded.toUtf8());
+                break;
+            }
+            default:
+                fail(QObject::tr("Invalid escape sequence at offset %1").arg(m_pos));
+                return false;
+        }
+    }
+    fail(QObject::tr("Unterminated string"));
+    return false;
+}
+
+QString Reader::readString()
+{
+    if (hasError())
+        return {};
+    skipWhitespace();
+    QString out;
+    readRawString(out);
+    return out;
+}
+
+double Reader::readNumber()
+{
+    if (peek() != Type::Number) {
+        fail(QObject::tr("Expected a number at offset %1").arg(m_pos));
+        return 0;
+    }
+    auto start = m_pos;
+    while (m_pos < m_data.size() && QByteArray("+-.eE0123456789").indexOf(m_data.at(m_pos)) >= 0)
+        m_pos++;
+    bool ok = false;
+    auto value = QByteArray::fromRawData(m_data.constData() + start, int(m_pos - start)).toDouble(&ok);
+    if (!ok) {
+        fail(QObject::tr("Invalid number at offset %1").arg(start));
+        return 0;
     }
     return value;
 }
 
+bool Reader::readBoolean()
+{
+    if (peek() == Type::Boolean) {
+        if (m_data.mid(m_pos, 4) == "true") {
+            m_pos += 4;
+            return true;
+        }
+        if (m_data.mid(m_pos, 5) == "false") {
+            m_pos += 5;
+            return false;
+        }
+    }
+    fail(QObject::tr("Expected a boolean at offset %1").arg(m_pos));
+    return false;
+}
+
+void Reader::readNull()
+{
+    if (peek() == Type::Null && m_data.mid(m_pos, 4) == "null") {
+        m_pos += 4;
+        return;
+    }
+    fail(QObject::tr("Expected null at offset %1").arg(m_pos));
+}
+
+void Reader::skipValue()
+{
+    switch (peek()) {
+        case Type::Object: {
+            beginObject();
+            QString key;
+            while (nextKey(key))
+                skipValue();
+            break;
+        }
+        case Type::Array:
+            beginArray();
+            while (nextElement())
+                skipValue();
+            break;
+        case Type::String:
+            readString();
+            break;
+        case Type::Number:
+            readNumber();
+            break;
+        case Type::Boolean:
+            readBoolean();
+            break;
+        case Type::Null:
+            readNull();
+            break;
+        case Type::Invalid:
+            fail(QObject::tr("Expected a value at offset %1").arg(m_pos));
+            break;
+    }
+}
+
 }  // namespace Json
@@ -43,6 +43,7 @@
 #include <QUrl>
 #include <QUuid>
 #include <QVariant>
+#include <QVector>
 #include <memory>
 
 #include "Exception.h"
@@ -107,84 +108,116 @@ QJsonArray toJsonArray(const QList<T>& container)
 
 ////////////////// READING ////////////////////
 
-/// @throw JsonException
+/**
+ * Read a value as T without throwing, the parsers use these through the helpers below.
+ *
+ * On failure `reason` says what's wrong with the value, like "is not a string", without naming it. It's a static string,
+ * so neither reading a value nor failing to builds any message, that's left to the ones that throw.
+ */
 template <typename T>
-T requireIsType(const QJsonValue& value, const QString& what = "Value");
+bool readIsType(const QJsonValue& value, T& out, const char** reason = nullptr);
 
-/// @throw JsonException
 template <>
-double requireIsType<double>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<double>(const QJsonValue& value, double& out, const char** reason);
 template <>
-bool requireIsType<bool>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<bool>(const QJsonValue& value, bool& out, const char** reason);
 template <>
-int requireIsType<int>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<int>(const QJsonValue& value, int& out, const char** reason);
 template <>
-QJsonObject requireIsType<QJsonObject>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QJsonObject>(const QJsonValue& value, QJsonObject& out, const char** reason);
 template <>
-QJsonArray requireIsType<QJsonArray>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QJsonArray>(const QJsonValue& value, QJsonArray& out, const char** reason);
 template <>
-QJsonValue requireIsType<QJsonValue>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QJsonValue>(const QJsonValue& value, QJsonValue& out, const char** reason);
 template <>
-QByteArray requireIsType<QByteArray>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QByteArray>(const QJsonValue& value, QByteArray& out, const char** reason);
 template <>
-QDateTime requireIsType<QDateTime>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QDateTime>(const QJsonValue& value, QDateTime& out, const char** reason);
 template <>
-QVariant requireIsType<QVariant>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QVariant>(const QJsonValue& value, QVariant& out, const char** reason);
 template <>
-QString requireIsType<QString>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QString>(const QJsonValue& value, QString& out, const char** reason);
 template <>
-QUuid requireIsType<QUuid>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QUuid>(const QJsonValue& value, QUuid& out, const char** reason);
 template <>
-QDir requireIsType<QDir>(const QJsonValue& value, const QString& what);
-/// @throw JsonException
+bool readIsType<QDir>(const QJsonValue& value, QDir& out, const char** reason);
 template <>
-QUrl requireIsType<QUrl>(const QJsonValue& value, const QString& what);
+bool readIsType<QUrl>(const QJsonValue& value, QUrl& out, const char** reason);
+
+/// @throw JsonException
+template <typename T>
+T requireIsType(const QJsonValue& value, const QString& what = "Value")
+{
+    T out;
+    const char* reason = "is not valid";
+    if (!readIsType<T>(value, out, &reason)) {
+        throw JsonException(what + ' ' + QLatin1String(reason));
+    }
+    return out;
+}
 
 // the following functions are higher level functions, that make use of the above functions for
 // type conversion
 template <typename T>
-T ensureIsType(const QJsonValue& value, const T default_ = T(), const QString& what = "Value")
+T ensureIsType(const QJsonValue& value, const T default_ = T(), [[maybe_unused]] const QString& what = "Value")
 {
     if (value.isUndefined() || value.isNull()) {
         return default_;
     }
-    try {
-        return requireIsType<T>(value, what);
-    } catch (const JsonException&) {
+    T out;
+    if (!readIsType<T>(value, out)) {
         return default_;
     }
+    return out;
+}
+
+/// the name of a member in messages, only built once there's something to say about it
+inline QString memberWhat(const QString& what, const QString& key)
+{
+    return QString(what).replace("__placeholder__", '\'' + key + '\'');
 }
 
 /// @throw JsonException
 template <typename T>
 T requireIsType(const QJsonObject& parent, const QString& key, const QString& what = "__placeholder__")
 {
-    const QString localWhat = QString(what).replace("__placeholder__", '\'' + key + '\'');
-    if (!parent.contains(key)) {
+    auto found = parent.constFind(key);
+    if (found == parent.constEnd()) {
+        const QString localWhat = memberWhat(what, key);
         throw JsonException(localWhat + "s parent does not contain " + localWhat);
     }
-    return requireIsType<T>(parent.value(key), localWhat);
+    T out;
+    const char* reason = "is not valid";
+    if (!readIsType<T>(*found, out, &reason)) {
+        throw JsonException(memberWhat(what, key) + ' ' + QLatin1String(reason));
+    }
+    return out;
 }
 
 template <typename T>
 T ensureIsType(const QJsonObject& parent, const QString& key, const T default_ = T(), const QString& what = "__placeholder__")
 {
-    const QString localWhat = QString(what).replace("__placeholder__", '\'' + key + '\'');
-    if (!parent.contains(key)) {
+    auto found = parent.constFind(key);
+    if (found == parent.constEnd()) {
         return default_;
     }
-    return ensureIsType<T>(parent.value(key), default_, localWhat);
+    return ensureIsType<T>(*found, default_, what);
+}
+
+/// read the member `key` into `out` if it's there, which is what the version formats do with most of theirs
+/// @throw JsonException if it's there but isn't a T
+template <typename T>
+bool requireIfPresent(const QJsonObject& parent, const QString& key, T& out, const QString& what = "Value")
+{
+    auto found = parent.constFind(key);
+    if (found == parent.constEnd()) {
+        return false;
+    }
+    const char* reason = "is not valid";
+    if (!readIsType<T>(*found, out, &reason)) {
+        throw JsonException(what + ' ' + QLatin1String(reason));
+    }
+    return true;
 }
 
 template <typename T>
@@ -222,7 +255,7 @@ QVector<T> ensureIsArrayOf(const QJsonValue& value, const QVector<T> default_, c
 template <typename T>
 QVector<T> requireIsArrayOf(const QJsonObject& parent, const QString& key, const QString& what = "__placeholder__")
 {
-    const QString localWhat = QString(what).replace("__placeholder__", '\'' + key + '\'');
+    const QString localWhat = memberWhat(what, key);
     if (!parent.contains(key)) {
         throw JsonException(localWhat + "s parent does not contain " + localWhat);
     }
@@ -235,7 +268,7 @@ QVector<T> ensureIsArrayOf(const QJsonObject& parent,
                            const QVector<T>& default_ = QVector<T>(),
                            const QString& what = "__placeholder__")
 {
-    const QString localWhat = QString(what).replace("__placeholder__", '\'' + key + '\'');
+    const QString localWhat = memberWhat(what, key);
     if (!parent.contains(key)) {
         return default_;
     }
@@ -278,5 +311,66 @@ JSON_HELPERFUNCTIONS(Variant, QVariant)
 
 #undef JSON_HELPERFUNCTIONS
 
+/////////////////// STREAMING ////////////////////
+
+/**
+ * Pull reader for large JSON documents, filling the target structures directly instead of building a QJsonDocument
+ * first. Values are read in document order:
+ *
+ *     Json::Reader reader(data);
+ *     if (reader.beginObject()) {
+ *         QString key;
+ *         while (reader.nextKey(key)) {
+ *             if (key == "name")
+ *                 name = reader.readString();
+ *             else
+ *                 reader.skipValue();
+ *         }
+ *     }
+ *     if (reader.hasError()) ...
+ *
+ * The first problem stops the reader, every read after it returns nothing.
+ */
+class Reader {
+   public:
+    enum class Type { Invalid, Object, Array, String, Number, Boolean, Null };
+
+    explicit Reader(const QByteArray& data);
+
+    /// the type of the next value, without reading it
+    Type peek();
+
+    bool beginObject();
+    /// the key of the next member of the current object, false once it's closed
+    bool nextKey(QString& key);
+    bool beginArray();
+    /// whether there's another element in the current array, false once it's closed
+    bool nextElement();
+
+    QString readString();
+    double readNumber();
+    bool readBoolean();
+    void readNull();
+    void skipValue();
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    /// where the reader is, or where the problem is
+    qsizetype offset() const { return m_pos; }
+
+   private:
+    void skipWhitespace();
+    bool expect(char c);
+    void fail(const QString& error);
+    bool readRawString(QString& out);
+
+   private:
+    QByteArray m_data;
+    qsizetype m_pos = 0;
+    // whether the containers being read have had a member or element yet
+    QVector<bool> m_first;
+    QString m_error;
+};
+
 }  // namespace Json
 using JSONValidationError = Json::JsonException;
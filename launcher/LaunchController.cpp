@@ -381,6 +381,10 @@ void LaunchController::readyForLaunch()
         msg.exec();
         m_launcher->proceed();
     });
+    connect(profilerInstance, &BaseProfiler::recordingStarted, [this](const QString& message) {
+        m_launcher->onLogLine(message, MessageLevel::Launcher);
+        m_launcher->proceed();
+    });
     connect(profilerInstance, &BaseProfiler::abortLaunch, [this](const QString& message) {
         QMessageBox msg;
         msg.setText(tr("Couldn't start the profiler: %1").arg(message));
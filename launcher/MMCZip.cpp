@@ -42,10 +42,19 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QThread>
 #include <QUrl>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #if defined(LAUNCHER_APPLICATION)
-#include <QtConcurrentRun>
+#include <zlib.h>
+#include <QQueue>
+#include "tasks/Executor.h"
 #endif
 
 namespace MMCZip {
@@ -69,14 +78,17 @@ bool mergeZipFiles(QuaZip* into, QFileInfo from, QSet<QString>& contained, const
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly)) {
+        // copy the compressed data as it is, inflating and deflating it again only takes time
+        QuaZipFileInfo64 info_in;
+        int method, level;
+        if (!modZip.getCurrentFileInfo(&info_in) || !fileInsideMod.open(QIODevice::ReadOnly, &method, &level, true)) {
             qCritical() << "Failed to open " << filename << " from " << from.fileName();
             return false;
         }
 
-        QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+        QuaZipNewInfo info_out(info_in);
 
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out)) {
+        if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, info_in.crc, method, level, true)) {
             qCritical() << "Failed to open " << filename << " in the jar";
             fileInsideMod.close();
             return false;
@@ -87,12 +99,45 @@ bool mergeZipFiles(QuaZip* into, QFileInfo from, QSet<QString>& contained, const
             qCritical() << "Failed to copy data of " << filename << " into the jar";
             return false;
         }
+        // raw entries take their size and checksum from what they were opened with
         zipOutFile.close();
         fileInsideMod.close();
+        if (zipOutFile.getZipError() != 0) {
+            qCritical() << "Failed to finish " << filename << " in the jar";
+            return false;
+        }
     }
     return true;
 }
 
+// deflating these again takes long and saves next to nothing
+static bool isCompressed(const QString& name)
+{
+    static const QStringList suffixes = { "jar", "zip", "mrpack", "png", "jpg", "jpeg", "ogg", "gz", "xz", "7z" };
+    return suffixes.contains(QFileInfo(name).suffix(), Qt::CaseInsensitive);
+}
+
+bool compressFile(QuaZip* zip, QString source, QString name)
+{
+    if (!isCompressed(name))
+        return JlCompress::compressFile(zip, source, name);
+
+    QFile file(source);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QuaZipFile zipFile(zip);
+    // method 0 is stored, without any compression
+    if (!zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(name, source), nullptr, 0, 0))
+        return false;
+    if (!JlCompress::copyData(file, zipFile)) {
+        zipFile.close();
+        return false;
+    }
+    zipFile.close();
+    return zipFile.getZipError() == 0;
+}
+
 bool compressDirFiles(QuaZip* zip, QString dir, QFileInfoList files, bool followSymlinks)
 {
     QDir directory(dir);
@@ -109,7 +154,7 @@ bool compressDirFiles(QuaZip* zip, QString dir, QFileInfoList files, bool follow
                 srcPath = e.canonicalFilePath();
             }
         }
-        if (!JlCompress::compressFile(zip, srcPath, filePath))
+        if (!compressFile(zip, srcPath, filePath))
             return false;
     }
 
@@ -265,7 +310,57 @@ bool findFilesInZip(QuaZip* zip, const QString& what, QStringList& result, const
 }
 
 // ours
-std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, const QString& target)
+// archives with fewer entries than this aren't worth the threads
+static const int s_minParallelEntries = 64;
+
+namespace {
+struct ExtractJob {
+    // position of the entry in the archive
+    int index = 0;
+    QString name;
+    QString target;
+    qint64 size = 0;
+    qint64 compressedSize = 0;
+};
+
+// extract the jobs, which are in archive order, walking the archive once
+bool extractJobs(QuaZip* zip,
+                 const QVector<ExtractJob>& jobs,
+                 std::atomic<qint64>& done,
+                 const std::atomic_bool& failed,
+                 QStringList& extracted,
+                 const std::function<void()>& extractedOne = {})
+{
+    auto job = jobs.cbegin();
+    int index = 0;
+    for (bool more = zip->goToFirstFile(); more && job != jobs.cend(); more = zip->goToNextFile(), index++) {
+        if (index != job->index)
+            continue;
+        if (failed)
+            return false;
+
+        if (!JlCompress::extractFile(zip, "", job->target)) {
+            qWarning() << "Failed to extract file" << job->name << "to" << job->target;
+            return false;
+        }
+        extracted.append(job->target);
+        QFile::setPermissions(job->target,
+                              QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser);
+        done += job->size;
+        if (extractedOne)
+            extractedOne();
+        job++;
+    }
+    return job == jobs.cend();
+}
+}  // namespace
+
+std::optional<QStringList> extractSubDir(QuaZip* zip,
+                                         const QString& subdir,
+                                         const QString& target,
+                                         const ExtractProgress& progress,
+                                         const FilterFunction& exclude,
+                                         const CancellationToken& cancel)
 {
     auto target_top_dir = QUrl::fromLocalFile(target);
 
@@ -284,8 +379,19 @@ std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, con
         return std::nullopt;
     }
 
-    do {
-        QString file_name = zip->getCurrentFileName();
+    // work out where everything goes first, and make the folders while nothing else is writing
+    QVector<ExtractJob> jobs;
+    QHash<QString, int> jobForTarget;
+    qint64 totalSize = 0;
+    qint64 totalCompressed = 0;
+    int index = 0;
+    for (bool more = true; more; more = zip->goToNextFile(), index++) {
+        QuaZipFileInfo64 info;
+        if (!zip->getCurrentFileInfo(&info)) {
+            qWarning() << "Failed to read the entry" << index << "of the archive";
+            return std::nullopt;
+        }
+        QString file_name = info.name;
         if (!file_name.startsWith(subdir))
             continue;
 
@@ -295,6 +401,8 @@ std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, con
         // Fix subdirs/files ending with a / getting transformed into absolute paths
         if (relative_file_name.startsWith('/'))
             relative_file_name = relative_file_name.mid(1);
+        if (exclude && exclude(relative_file_name))
+            continue;
 
         // Fix weird "folders with a single file get squashed" thing
         QString sub_path;
@@ -320,19 +428,93 @@ std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, con
             return std::nullopt;
         }
 
-        if (!JlCompress::extractFile(zip, "", target_file_path)) {
-            qWarning() << "Failed to extract file" << original_name << "to" << target_file_path;
+        // the last entry for a path wins, like it did when they were extracted one after the other
+        if (auto previous = jobForTarget.find(target_file_path); previous != jobForTarget.end()) {
+            totalSize -= jobs[previous.value()].size;
+            totalCompressed -= jobs[previous.value()].compressedSize;
+            jobs[previous.value()].target.clear();
+        }
+        jobForTarget.insert(target_file_path, jobs.size());
+        jobs.append({ index, original_name, target_file_path, static_cast<qint64>(info.uncompressedSize),
+                      static_cast<qint64>(info.compressedSize) });
+        totalSize += info.uncompressedSize;
+        totalCompressed += info.compressedSize;
+    }
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const ExtractJob& job) { return job.target.isEmpty(); }), jobs.end());
+
+    std::atomic<qint64> done{ 0 };
+    std::atomic_bool failed{ false };
+
+    // the threads need a file to open the archive again from
+    int workers = 1;
+    if (!zip->getZipName().isEmpty() && jobs.size() >= s_minParallelEntries)
+        workers = std::max(1, std::min(QThread::idealThreadCount(), static_cast<int>(jobs.size() / (s_minParallelEntries / 4))));
+
+    if (workers == 1) {
+        auto report = [&] {
+            // stops before the next entry, like a failure
+            if (cancel.isCancelled())
+                failed = true;
+            if (progress)
+                progress(done, totalSize);
+        };
+        if (!extractJobs(zip, jobs, done, failed, extracted, report)) {
             JlCompress::removeFile(extracted);
             return std::nullopt;
         }
+        return extracted;
+    }
 
-        extracted.append(target_file_path);
-        QFile::setPermissions(target_file_path,
-                              QFileDevice::Permission::ReadUser | QFileDevice::Permission::WriteUser | QFileDevice::Permission::ExeUser);
+    // runs of about the same compressed size, so each thread reads its own stretch of the archive
+    QVector<QVector<ExtractJob>> parts(workers);
+    qint64 assigned = 0;
+    for (auto& job : jobs) {
+        auto part = std::min<qint64>(workers - 1, assigned * workers / std::max<qint64>(totalCompressed, 1));
+        parts[part].append(job);
+        assigned += job.compressedSize;
+    }
 
-        qDebug() << "Extracted file" << relative_file_name << "to" << target_file_path;
-    } while (zip->goToNextFile());
+    QVector<QStringList> extractedParts(workers);
+    std::mutex lock;
+    std::condition_variable finishedChanged;
+    int finished = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back([&, i] {
+            QuaZip handle(zip->getZipName());
+            bool ok = handle.open(QuaZip::mdUnzip) && extractJobs(&handle, parts[i], done, failed, extractedParts[i]);
+            if (!ok)
+                failed = true;
+            std::lock_guard<std::mutex> guard(lock);
+            finished++;
+            finishedChanged.notify_one();
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (finished < workers) {
+            finishedChanged.wait_for(guard, std::chrono::milliseconds(100));
+            if (cancel.isCancelled())
+                failed = true;
+            if (progress) {
+                guard.unlock();
+                progress(done, totalSize);
+                guard.lock();
+            }
+        }
+    }
+    for (auto& thread : threads)
+        thread.join();
 
+    for (auto& part : extractedParts)
+        extracted.append(part);
+    if (failed) {
+        JlCompress::removeFile(extracted);
+        return std::nullopt;
+    }
+    if (progress)
+        progress(totalSize, totalSize);
     return extracted;
 }
 
@@ -343,7 +525,7 @@ bool extractRelFile(QuaZip* zip, const QString& file, const QString& target)
 }
 
 // ours
-std::optional<QStringList> extractDir(QString fileCompressed, QString dir)
+std::optional<QStringList> extractDir(QString fileCompressed, QString dir, const CancellationToken& cancel)
 {
     QuaZip zip(fileCompressed);
     if (!zip.open(QuaZip::mdUnzip)) {
@@ -356,11 +538,11 @@ std::optional<QStringList> extractDir(QString fileCompressed, QString dir)
         ;
         return std::nullopt;
     }
-    return extractSubDir(&zip, "", dir);
+    return extractSubDir(&zip, "", dir, {}, {}, cancel);
 }
 
 // ours
-std::optional<QStringList> extractDir(QString fileCompressed, QString subdir, QString dir)
+std::optional<QStringList> extractDir(QString fileCompressed, QString subdir, QString dir, const CancellationToken& cancel)
 {
     QuaZip zip(fileCompressed);
     if (!zip.open(QuaZip::mdUnzip)) {
@@ -373,7 +555,7 @@ std::optional<QStringList> extractDir(QString fileCompressed, QString subdir, QS
         ;
         return std::nullopt;
     }
-    return extractSubDir(&zip, subdir, dir);
+    return extractSubDir(&zip, subdir, dir, {}, {}, cancel);
 }
 
 // ours
@@ -429,11 +611,76 @@ bool collectFileListRecursively(const QString& rootDir, const QString& subDir, Q
 }
 
 #if defined(LAUNCHER_APPLICATION)
+// entries up to this size are compressed in memory on the thread pool, bigger ones get streamed into the archive
+static const qint64 s_maxBufferedEntry = 16 * 1024 * 1024;
+// how much may be compressed ahead of what has been written
+static const qint64 s_maxBufferedTotal = 128 * 1024 * 1024;
+
+namespace {
+struct CompressedEntry {
+    QByteArray data;
+    quint32 crc = 0;
+    qint64 size = 0;
+    int method = Z_DEFLATED;
+    bool ok = false;
+};
+
+// what compressFile would write for the file, ready to be copied into the archive raw
+CompressedEntry compressEntry(const QString& source, const QString& name)
+{
+    CompressedEntry entry;
+    QFile file(source);
+    if (!file.open(QIODevice::ReadOnly))
+        return entry;
+    auto raw = file.readAll();
+    if (file.error() != QFileDevice::NoError)
+        return entry;
+
+    entry.size = raw.size();
+    entry.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(raw.constData()), raw.size());
+    if (isCompressed(name)) {
+        entry.method = 0;
+        entry.data = raw;
+        entry.ok = true;
+        return entry;
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // a raw stream, the zip entry has its own header
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return entry;
+    entry.data.resize(deflateBound(&zs, raw.size()));
+    zs.next_in = reinterpret_cast<Bytef*>(raw.data());
+    zs.avail_in = raw.size();
+    zs.next_out = reinterpret_cast<Bytef*>(entry.data.data());
+    zs.avail_out = entry.data.size();
+    // the bound makes sure it's done in one go
+    auto ret = deflate(&zs, Z_FINISH);
+    entry.data.resize(zs.total_out);
+    deflateEnd(&zs);
+    entry.ok = ret == Z_STREAM_END;
+    return entry;
+}
+
+bool writeCompressedEntry(QuaZip* zip, const QString& source, const QString& name, const CompressedEntry& entry)
+{
+    QuaZipNewInfo info(name, source);
+    info.uncompressedSize = entry.size;
+    QuaZipFile zipFile(zip);
+    if (!zipFile.open(QIODevice::WriteOnly, info, nullptr, entry.crc, entry.method, Z_DEFAULT_COMPRESSION, true))
+        return false;
+    auto written = zipFile.write(entry.data);
+    zipFile.close();
+    return written == entry.data.size() && zipFile.getZipError() == 0;
+}
+}  // namespace
+
 void ExportToZipTask::executeTask()
 {
     setStatus("Adding files...");
     setProgress(0, m_files.length());
-    m_build_zip_future = QtConcurrent::run(QThreadPool::globalInstance(), [this]() { return exportZip(); });
+    m_build_zip_future = Executor::instance()->run(Executor::Priority::Bulk, [this]() { return exportZip(); });
     connect(&m_build_zip_watcher, &QFutureWatcher<ZipResult>::finished, this, &ExportToZipTask::finish);
     m_build_zip_watcher.setFuture(m_build_zip_future);
 }
@@ -447,6 +694,105 @@ auto ExportToZipTask::exportZip() -> ZipResult
         return ZipResult(tr("Could not create file"));
     }
 
+    // the files get compressed on the thread pool, and written here in order as they're done
+    struct Pending {
+        QString source;
+        QString relative;
+        qint64 size = 0;
+        bool buffered = false;
+        QFuture<CompressedEntry> compressed;
+    };
+    QQueue<Pending> pending;
+    qint64 pendingBytes = 0;
+    auto maxPending = 2 * QThread::idealThreadCount();
+
+    auto writeOldest = [this, &pending, &pendingBytes]() -> ZipResult {
+        auto next = pending.dequeue();
+        setStatus("Compresing: " + next.relative);
+        setProgress(m_progress + 1, m_progressTotal);
+        auto name = m_destination_prefix + next.relative;
+        bool written;
+        if (next.buffered) {
+            pendingBytes -= next.size;
+            // compresses what's still queued itself instead of only waiting
+            Executor::instance()->waitFor(next.compressed);
+            auto entry = next.compressed.result();
+            written = entry.ok && writeCompressedEntry(&m_output, next.source, name, entry);
+        } else {
+            written = compressFile(&m_output, next.source, name);
+        }
+        if (!written) {
+            return ZipResult(tr("Could not read and compress %1").arg(next.relative));
+        }
+        return ZipResult();
+    };
+
+    // the deferred files are left for a second pass, once it's known which of them belong in the zip
+    auto addFiles = [&](bool deferred) -> ZipResult {
+        for (const QFileInfo& file : m_files) {
+            if (m_build_zip_future.isCanceled())
+                return ZipResult();
+
+            auto absolute = file.absoluteFilePath();
+            auto relative = m_dir.relativeFilePath(absolute);
+            if (m_deferred_files.contains(relative) != deferred) {
+                continue;
+            }
+            if (m_exclude_files.contains(relative)) {
+                setProgress(m_progress + 1, m_progressTotal);
+                continue;
+            }
+            if (m_follow_symlinks) {
+                if (file.isSymLink())
+                    absolute = file.symLinkTarget();
+                else
+                    absolute = file.canonicalFilePath();
+            }
+
+            Pending next{ absolute, relative, QFileInfo(absolute).size() };
+            if (next.size <= s_maxBufferedEntry) {
+                next.buffered = true;
+                auto compress = [absolute, name = m_destination_prefix + relative] { return compressEntry(absolute, name); };
+                next.compressed = Executor::instance()->run(Executor::Priority::Bulk, compress);
+                pendingBytes += next.size;
+            }
+            pending.enqueue(next);
+
+            while (!pending.isEmpty() && (pendingBytes > s_maxBufferedTotal || pending.size() > maxPending || !pending.head().buffered)) {
+                if (auto error = writeOldest())
+                    return error;
+            }
+        }
+        return ZipResult();
+    };
+
+    auto writeAll = [this, &pending, &writeOldest]() -> ZipResult {
+        while (!pending.isEmpty()) {
+            if (m_build_zip_future.isCanceled())
+                return ZipResult();
+            if (auto error = writeOldest())
+                return error;
+        }
+        return ZipResult();
+    };
+
+    if (auto error = addFiles(false))
+        return error;
+    if (auto error = writeAll())
+        return error;
+    {
+        QMutexLocker locker(&m_resolve_lock);
+        while (!m_resolved) {
+            if (m_build_zip_future.isCanceled())
+                return ZipResult();
+            m_resolved_condition.wait(&m_resolve_lock, 100);
+        }
+    }
+    if (auto error = addFiles(true))
+        return error;
+    if (auto error = writeAll())
+        return error;
+
     for (auto fileName : m_extra_files.keys()) {
         if (m_build_zip_future.isCanceled())
             return ZipResult();
@@ -457,26 +803,6 @@ auto ExportToZipTask::exportZip() -> ZipResult
         indexFile.write(m_extra_files[fileName]);
     }
 
-    for (const QFileInfo& file : m_files) {
-        if (m_build_zip_future.isCanceled())
-            return ZipResult();
-
-        auto absolute = file.absoluteFilePath();
-        auto relative = m_dir.relativeFilePath(absolute);
-        setStatus("Compresing: " + relative);
-        setProgress(m_progress + 1, m_progressTotal);
-        if (m_follow_symlinks) {
-            if (file.isSymLink())
-                absolute = file.symLinkTarget();
-            else
-                absolute = file.canonicalFilePath();
-        }
-
-        if (!m_exclude_files.contains(relative) && !JlCompress::compressFile(&m_output, absolute, m_destination_prefix + relative)) {
-            return ZipResult(tr("Could not read and compress %1").arg(relative));
-        }
-    }
-
     m_output.close();
     if (m_output.getZipError() != 0) {
         return ZipResult(tr("A zip error occurred"));
@@ -484,6 +810,23 @@ auto ExportToZipTask::exportZip() -> ZipResult
     return ZipResult();
 }
 
+void ExportToZipTask::setDeferredFiles(const QStringList& files)
+{
+    QMutexLocker locker(&m_resolve_lock);
+    m_deferred_files = QSet<QString>(files.begin(), files.end());
+    m_resolved = m_deferred_files.isEmpty();
+}
+
+void ExportToZipTask::resolveDeferred(const QStringList& excludeFiles, const QHash<QString, QByteArray>& extraFiles)
+{
+    QMutexLocker locker(&m_resolve_lock);
+    m_exclude_files += excludeFiles;
+    for (auto it = extraFiles.begin(); it != extraFiles.end(); it++)
+        m_extra_files.insert(it.key(), it.value());
+    m_resolved = true;
+    m_resolved_condition.wakeAll();
+}
+
 void ExportToZipTask::finish()
 {
     if (m_build_zip_future.isCanceled()) {
@@ -497,6 +840,260 @@ void ExportToZipTask::finish()
     }
 }
 
+namespace {
+quint16 le16(const char* data)
+{
+    return quint16(quint8(data[0])) | quint16(quint8(data[1])) << 8;
+}
+
+quint32 le32(const char* data)
+{
+    return quint32(le16(data)) | quint32(le16(data + 2)) << 16;
+}
+
+quint64 le64(const char* data)
+{
+    return quint64(le32(data)) | quint64(le32(data + 4)) << 32;
+}
+
+constexpr quint32 endOfCentralDirSig = 0x06054b50;
+constexpr quint32 zip64EndOfCentralDirSig = 0x06064b50;
+constexpr quint32 zip64LocatorSig = 0x07064b50;
+constexpr quint32 centralEntrySig = 0x02014b50;
+constexpr quint32 localEntrySig = 0x04034b50;
+}  // namespace
+
+ZipIndex::ZipIndex(const QString& path) : m_file(path)
+{
+    m_valid = load();
+}
+
+ZipIndex::ZipIndex(const ZipIndex& outer, const QString& name, qint64 max_size)
+{
+    m_valid = loadNested(outer, name, max_size);
+}
+
+ZipIndex::~ZipIndex()
+{
+    if (m_mapped)
+        m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+}
+
+bool ZipIndex::load()
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+    m_size = m_file.size();
+    if (m_size < 22)
+        return false;
+    m_data = reinterpret_cast<const char*>(m_file.map(0, m_size));
+    if (!m_data)
+        return false;
+    m_mapped = true;
+    return readDirectory();
+}
+
+bool ZipIndex::loadNested(const ZipIndex& outer, const QString& name, qint64 max_size)
+{
+    auto it = outer.m_entries.constFind(name);
+    if (!outer.m_valid || it == outer.m_entries.constEnd() || (it->flags & 0x1))
+        return false;
+    if (it->method == 0) {
+        auto start = outer.dataStart(*it);
+        if (start < 0)
+            return false;
+        m_data = outer.m_data + start;
+        m_size = it->compressedSize;
+    } else {
+        auto data = outer.read(name, max_size);
+        if (!data)
+            return false;
+        m_buffer = std::move(*data);
+        m_data = m_buffer.constData();
+        m_size = m_buffer.size();
+    }
+    return m_size >= 22 && readDirectory();
+}
+
+qint64 ZipIndex::dataStart(const Entry& entry) const
+{
+    if (entry.offset < 0 || entry.offset + 30 > m_size || le32(m_data + entry.offset) != localEntrySig)
+        return -1;
+    // the lengths in the local header may differ from the central directory's
+    qint64 start = entry.offset + 30 + le16(m_data + entry.offset + 26) + le16(m_data + entry.offset + 28);
+    if (start + entry.compressedSize > m_size)
+        return -1;
+    return start;
+}
+
+bool ZipIndex::readDirectory()
+{
+    // the end record is at most a comment away from the end
+    qint64 end = -1;
+    for (qint64 i = m_size - 22; i >= std::max<qint64>(0, m_size - 22 - 0xFFFF); i--) {
+        if (le32(m_data + i) == endOfCentralDirSig) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0)
+        return false;
+
+    const char* eocd = m_data + end;
+    qint64 count = le16(eocd + 10);
+    qint64 dirSize = le32(eocd + 12);
+    qint64 dirOffset = le32(eocd + 16);
+    if (count == 0xFFFF || dirSize == 0xFFFFFFFF || dirOffset == 0xFFFFFFFF) {
+        // the real values are in the zip64 end record, which the locator right before this one points to
+        if (end < 20 || le32(eocd - 20) != zip64LocatorSig)
+            return false;
+        auto recordOffset = qint64(le64(eocd - 20 + 8));
+        if (recordOffset < 0 || recordOffset + 56 > m_size || le32(m_data + recordOffset) != zip64EndOfCentralDirSig)
+            return false;
+        const char* record = m_data + recordOffset;
+        count = qint64(le64(record + 32));
+        dirSize = qint64(le64(record + 40));
+        dirOffset = qint64(le64(record + 48));
+    }
+    if (count < 0 || dirOffset < 0 || dirSize < 0 || dirOffset + dirSize > m_size)
+        return false;
+
+    const char* dir = m_data + dirOffset;
+    m_entries.reserve(count);
+    m_names.reserve(count);
+    qint64 pos = 0;
+    for (qint64 i = 0; i < count; i++) {
+        if (pos + 46 > dirSize || le32(dir + pos) != centralEntrySig)
+            return false;
+        const char* header = dir + pos;
+        Entry entry;
+        entry.flags = le16(header + 8);
+        entry.method = le16(header + 10);
+        entry.dosTime = le32(header + 12);
+        entry.compressedSize = le32(header + 20);
+        entry.size = le32(header + 24);
+        entry.offset = le32(header + 42);
+        int nameLength = le16(header + 28);
+        int extraLength = le16(header + 30);
+        int commentLength = le16(header + 32);
+        if (pos + 46 + nameLength + extraLength + commentLength > dirSize)
+            return false;
+        // names are UTF-8 if the flag says so, and usually are anyway
+        auto name = QString::fromUtf8(header + 46, nameLength);
+
+        const char* extra = header + 46 + nameLength;
+        for (int e = 0; e + 4 <= extraLength;) {
+            int id = le16(extra + e), length = std::min(int(le16(extra + e + 2)), extraLength - e - 4);
+            if (id == 0x0001) {
+                // zip64, with the values that didn't fit, in this order
+                int field = e + 4;
+                for (auto value : { &entry.size, &entry.compressedSize, &entry.offset }) {
+                    if (*value == 0xFFFFFFFF && field + 8 <= e + 4 + length) {
+                        *value = qint64(le64(extra + field));
+                        field += 8;
+                    }
+                }
+            } else if (id == 0x000a && length >= 32 && le16(extra + e + 8) == 0x0001) {
+                // NTFS, the modification time comes first after a reserved field
+                entry.ntfsTime = qint64(le64(extra + e + 12));
+            }
+            e += 4 + length;
+        }
+        pos += 46 + nameLength + extraLength + commentLength;
+
+        auto slash = name.indexOf('/');
+        if (slash > 0)
+            m_rootFolders.insert(name.left(slash));
+        m_entries.insert(name, entry);
+        m_names.append(name);
+    }
+    return true;
+}
+
+QDateTime ZipIndex::lastModified(const QString& name) const
+{
+    auto it = m_entries.constFind(name);
+    if (it == m_entries.constEnd())
+        return {};
+    if (it->ntfsTime > 0) {
+        // in 100ns since 1601
+        return QDateTime::fromMSecsSinceEpoch((it->ntfsTime - 116444736000000000LL) / 10000, Qt::UTC);
+    }
+    auto time = it->dosTime;
+    QDate date(1980 + (time >> 25), (time >> 21) & 0xF, (time >> 16) & 0x1F);
+    return QDateTime(date, QTime((time >> 11) & 0x1F, (time >> 5) & 0x3F, (time & 0x1F) * 2));
+}
+
+std::optional<QByteArray> ZipIndex::read(const QString& name, qint64 max_size) const
+{
+    auto it = m_entries.constFind(name);
+    // encrypted entries are left to QuaZip
+    if (!m_valid || it == m_entries.constEnd() || (it->flags & 0x1) || it->size > max_size || it->compressedSize > max_size)
+        return std::nullopt;
+
+    auto start = dataStart(*it);
+    if (start < 0)
+        return std::nullopt;
+    const char* compressed = m_data + start;
+
+    if (it->method == 0)
+        return QByteArray(compressed, it->compressedSize);
+    if (it->size == 0)
+        return QByteArray();
+    if (it->method != Z_DEFLATED)
+        return std::nullopt;
+
+    QByteArray data(it->size, Qt::Uninitialized);
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    // a raw stream, the entry has no zlib header
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        return std::nullopt;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed));
+    zs.avail_in = it->compressedSize;
+    zs.next_out = reinterpret_cast<Bytef*>(data.data());
+    zs.avail_out = data.size();
+    auto ret = inflate(&zs, Z_FINISH);
+    auto produced = zs.total_out;
+    inflateEnd(&zs);
+    if (ret != Z_STREAM_END || qint64(produced) != it->size)
+        return std::nullopt;
+    return data;
+}
+
+QString ZipIndex::findFolderOfFile(const QString& what, const QStringList& ignore_paths) const
+{
+    return findFoldersOfFiles({ what }, ignore_paths).value(what);
+}
+
+QHash<QString, QString> ZipIndex::findFoldersOfFiles(const QStringList& whats, const QStringList& ignore_paths) const
+{
+    struct Found {
+        QString folder;
+        int depth;
+    };
+    QHash<QString, Found> found;
+    for (auto& name : m_names) {
+        auto fileName = name.mid(name.lastIndexOf('/') + 1);
+        if (fileName.isEmpty() || !whats.contains(fileName))
+            continue;
+        auto folder = name.left(name.size() - fileName.size());
+        auto parts = folder.split('/', Qt::SkipEmptyParts);
+        if (std::any_of(parts.cbegin(), parts.cend(), [&ignore_paths](const QString& part) { return ignore_paths.contains(part); }))
+            continue;
+        auto it = found.find(fileName);
+        if (it == found.end())
+            found.insert(fileName, { folder.isNull() ? QString("") : folder, int(parts.size()) });
+        else if (parts.size() < it->depth || (parts.size() == it->depth && folder < it->folder))
+            *it = { folder, int(parts.size()) };
+    }
+
+    QHash<QString, QString> folders;
+    for (auto it = found.cbegin(); it != found.cend(); ++it)
+        folders.insert(it.key(), it->folder);
+    return folders;
+}
+
 bool ExportToZipTask::abort()
 {
     if (m_build_zip_future.isRunning()) {
@@ -38,13 +38,17 @@
 
 #include <quazip.h>
 #include <quazip/JlCompress.h>
+#include <QDateTime>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QHash>
+#include <QMutex>
 #include <QSet>
 #include <QString>
+#include <QWaitCondition>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -52,6 +56,7 @@
 #if defined(LAUNCHER_APPLICATION)
 #include "minecraft/mod/Mod.h"
 #endif
+#include "tasks/CancellationToken.h"
 #include "tasks/Task.h"
 
 namespace MMCZip {
@@ -59,9 +64,20 @@ using FilterFunction = std::function<bool(const QString&)>;
 
 /**
  * Merge two zip files, using a filter function
+ * The entries are copied as they are stored, without being decompressed and compressed again
  */
 bool mergeZipFiles(QuaZip* into, QFileInfo from, QSet<QString>& contained, const FilterFunction& filter = nullptr);
 
+/**
+ * Add a file to the archive
+ * Files in formats that are compressed already, like jars and images, are stored as they are
+ * \param zip target archive
+ * \param source path of the file to add
+ * \param name name of the entry in the archive
+ * \return true for success or false for failure
+ */
+bool compressFile(QuaZip* zip, QString source, QString name);
+
 /**
  * Compress directory, by providing a list of files to compress
  * \param zip target archive
@@ -105,10 +121,21 @@ QString findFolderOfFileInZip(QuaZip* zip, const QString& what, const QStringLis
  */
 bool findFilesInZip(QuaZip* zip, const QString& what, QStringList& result, const QString& root = QString());
 
+/// called with the number of uncompressed bytes extracted so far and the total
+using ExtractProgress = std::function<void(qint64 done, qint64 total)>;
+
 /**
  * Extract a subdirectory from an archive
+ * Big archives are extracted by several threads, each with a handle of its own on a part of the archive
+ * \param exclude entries to leave out, by their path relative to the subdirectory, returning true means to exclude
+ * \param cancel stops the extraction between entries, removing what was extracted, like a failure
  */
-std::optional<QStringList> extractSubDir(QuaZip* zip, const QString& subdir, const QString& target);
+std::optional<QStringList> extractSubDir(QuaZip* zip,
+                                         const QString& subdir,
+                                         const QString& target,
+                                         const ExtractProgress& progress = {},
+                                         const FilterFunction& exclude = {},
+                                         const CancellationToken& cancel = {});
 
 bool extractRelFile(QuaZip* zip, const QString& file, const QString& target);
 
@@ -117,9 +144,10 @@ bool extractRelFile(QuaZip* zip, const QString& file, const QString& target);
  *
  * \param fileCompressed The name of the archive.
  * \param dir The directory to extract to, the current directory if left empty.
+ * \param cancel stops the extraction between entries.
  * \return The list of the full paths of the files extracted, empty on failure.
  */
-std::optional<QStringList> extractDir(QString fileCompressed, QString dir);
+std::optional<QStringList> extractDir(QString fileCompressed, QString dir, const CancellationToken& cancel = {});
 
 /**
  * Extract a subdirectory from an archive
@@ -127,9 +155,10 @@ std::optional<QStringList> extractDir(QString fileCompressed, QString dir);
  * \param fileCompressed The name of the archive.
  * \param subdir The directory within the archive to extract
  * \param dir The directory to extract to, the current directory if left empty.
+ * \param cancel stops the extraction between entries.
  * \return The list of the full paths of the files extracted, empty on failure.
  */
-std::optional<QStringList> extractDir(QString fileCompressed, QString subdir, QString dir);
+std::optional<QStringList> extractDir(QString fileCompressed, QString subdir, QString dir, const CancellationToken& cancel = {});
 
 /**
  * Extract a single file from an archive into a directory
@@ -152,6 +181,78 @@ bool extractFile(QString fileCompressed, QString file, QString dir);
 bool collectFileListRecursively(const QString& rootDir, const QString& subDir, QFileInfoList* files, FilterFunction excludeFilter);
 
 #if defined(LAUNCHER_APPLICATION)
+/**
+ * Reads small entries out of a zip through its central directory, without opening it with QuaZip.
+ *
+ * Checking a pack or a mod only takes a few small entries and whether it has a folder at the root, and QuaZip reading
+ * in every entry first was most of what that cost for archives with many files. Here the archive is mapped while the
+ * index lives, the central directory is gone through once and an entry is inflated straight out of the mapping.
+ * Zip64 archives are handled, encrypted entries and archives spanning several files aren't.
+ */
+class ZipIndex {
+   public:
+    explicit ZipIndex(const QString& path);
+    /**
+     * The archive stored as the entry `name` of `outer`, like the jars mods bundle, without extracting it. A stored entry
+     * is read right where it is in the outer mapping, which has to outlive this, a compressed one is inflated first.
+     */
+    ZipIndex(const ZipIndex& outer, const QString& name, qint64 max_size = 64 * 1024 * 1024);
+    ~ZipIndex();
+    ZipIndex(const ZipIndex&) = delete;
+    ZipIndex& operator=(const ZipIndex&) = delete;
+
+    /// whether the central directory could be read
+    [[nodiscard]] bool isValid() const { return m_valid; }
+    [[nodiscard]] bool contains(const QString& name) const { return m_entries.contains(name); }
+    /// whether there's a folder with that name at the root of the archive
+    [[nodiscard]] bool hasRootFolder(const QString& name) const { return m_rootFolders.contains(name); }
+    /// the names of the entries, in the order of the archive
+    [[nodiscard]] const QStringList& names() const { return m_names; }
+    /// when the entry was last modified, as the archive says
+    [[nodiscard]] QDateTime lastModified(const QString& name) const;
+    /// the contents of the entry, nothing if it's missing, can't be read or is larger than `max_size`
+    std::optional<QByteArray> read(const QString& name, qint64 max_size = 16 * 1024 * 1024) const;
+
+    /**
+     * The folder, with a trailing slash, holding the shallowest file named `what`, skipping folders named as in `ignore_paths`.
+     * It's empty if the file is at the root, and null if there's none.
+     */
+    [[nodiscard]] QString findFolderOfFile(const QString& what, const QStringList& ignore_paths = {}) const;
+
+    /// the folder of each of the files in `whats`, as findFolderOfFile() would tell, going through the entries once.
+    /// The files that aren't there have no key.
+    [[nodiscard]] QHash<QString, QString> findFoldersOfFiles(const QStringList& whats, const QStringList& ignore_paths = {}) const;
+
+   private:
+    struct Entry {
+        quint16 method = 0;
+        quint16 flags = 0;
+        quint32 dosTime = 0;
+        qint64 ntfsTime = 0;
+        qint64 compressedSize = 0;
+        qint64 size = 0;
+        qint64 offset = 0;
+    };
+
+    bool load();
+    bool loadNested(const ZipIndex& outer, const QString& name, qint64 max_size);
+    bool readDirectory();
+    /// where the data of the entry starts, -1 if that's not in the archive
+    [[nodiscard]] qint64 dataStart(const Entry& entry) const;
+
+   private:
+    QFile m_file;
+    // the inflated archive, for one nested compressed
+    QByteArray m_buffer;
+    bool m_mapped = false;
+    const char* m_data = nullptr;
+    qint64 m_size = 0;
+    bool m_valid = false;
+    QHash<QString, Entry> m_entries;
+    QStringList m_names;
+    QSet<QString> m_rootFolders;
+};
+
 class ExportToZipTask : public Task {
    public:
     ExportToZipTask(QString outputPath, QDir dir, QFileInfoList files, QString destinationPrefix = "", bool followSymlinks = false)
@@ -171,6 +272,10 @@ class ExportToZipTask : public Task {
 
     void setExcludeFiles(QStringList excludeFiles) { m_exclude_files = excludeFiles; }
     void addExtraFile(QString fileName, QByteArray data) { m_extra_files.insert(fileName, data); }
+    /// hold the files at these relative paths back until resolveDeferred() is called, everything else is added meanwhile
+    void setDeferredFiles(const QStringList& files);
+    /// which of the deferred files to leave out and the extra files that depend on that, can be called while running
+    void resolveDeferred(const QStringList& excludeFiles, const QHash<QString, QByteArray>& extraFiles);
 
     using ZipResult = std::optional<QString>;
 
@@ -191,6 +296,11 @@ class ExportToZipTask : public Task {
     QStringList m_exclude_files;
     QHash<QString, QByteArray> m_extra_files;
 
+    QSet<QString> m_deferred_files;
+    QMutex m_resolve_lock;
+    QWaitCondition m_resolved_condition;
+    bool m_resolved = true;
+
     QFuture<ZipResult> m_build_zip_future;
     QFutureWatcher<ZipResult> m_build_zip_watcher;
 };
@@ -0,0 +1,245 @@
+#include "MTPixmapCache.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+PixmapCache* PixmapCache::s_instance = nullptr;
+
+namespace {
+constexpr qint64 MiB = 1024 * 1024;
+
+// what each category may start with, and grow up to when it keeps missing
+constexpr std::array<qint64, PixmapCache::CategoryCount> defaultBudgets = { 16 * MiB, 16 * MiB, 64 * MiB, 16 * MiB };
+constexpr std::array<qint64, PixmapCache::CategoryCount> budgetCeilings = { 64 * MiB, 64 * MiB, 256 * MiB, 64 * MiB };
+constexpr qint64 growthStep = 4 * MiB;
+
+qint64 costOf(const QPixmap& pixmap)
+{
+    return static_cast<qint64>(pixmap.width()) * pixmap.height() * std::max(1, pixmap.depth()) / 8;
+}
+}  // namespace
+
+PixmapCache::PixmapCache(QObject* parent) : QObject(parent)
+{
+    for (int i = 0; i < CategoryCount; i++) {
+        m_categories[i].stats.budget = defaultBudgets[i];
+        m_categories[i].ceiling = budgetCeilings[i];
+    }
+}
+
+QString PixmapCache::categoryName(Category category)
+{
+    switch (category) {
+        case Category::Mods:
+            return "mods";
+        case Category::Packs:
+            return "packs";
+        case Category::Screenshots:
+            return "screenshots";
+        case Category::Icons:
+            return "icons";
+    }
+    return {};
+}
+
+PixmapCache::Key PixmapCache::insertLocked(Category category, const QPixmap& pixmap)
+{
+    auto cost = costOf(pixmap);
+    auto& state = stateOf(category);
+    if (pixmap.isNull() || cost > state.stats.budget)
+        return {};
+
+    auto id = m_next_id++;
+    state.lru.push_front(id);
+    m_entries.insert(id, { pixmap, cost, category, {}, state.lru.begin() });
+    state.stats.bytes += cost;
+    state.stats.count++;
+    shrinkLocked(state);
+    return { id };
+}
+
+bool PixmapCache::findLocked(quint64 id, QPixmap* pixmap)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        return false;
+
+    auto& state = stateOf(it->category);
+    state.stats.hits++;
+    // most recently used again
+    state.lru.splice(state.lru.begin(), state.lru, it->lru_position);
+    if (pixmap)
+        *pixmap = it->pixmap;
+    return true;
+}
+
+void PixmapCache::removeLocked(quint64 id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        return;
+
+    auto& state = stateOf(it->category);
+    state.lru.erase(it->lru_position);
+    state.stats.bytes -= it->cost;
+    state.stats.count--;
+    if (!it->string_key.isEmpty())
+        m_string_keys.remove(it->string_key);
+    m_entries.erase(it);
+}
+
+void PixmapCache::shrinkLocked(CategoryState& state)
+{
+    while (state.stats.bytes > state.stats.budget && !state.lru.empty()) {
+        removeLocked(state.lru.back());
+        state.stats.evictions++;
+    }
+}
+
+PixmapCache::Key PixmapCache::insert(Category category, const QPixmap& pixmap)
+{
+    if (!s_instance)
+        return {};
+    QMutexLocker locker(&s_instance->m_lock);
+    return s_instance->insertLocked(category, pixmap);
+}
+
+bool PixmapCache::insert(Category category, const QString& key, const QPixmap& pixmap)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    auto old = s_instance->m_string_keys.constFind(key);
+    if (old != s_instance->m_string_keys.constEnd())
+        s_instance->removeLocked(*old);
+
+    auto inserted = s_instance->insertLocked(category, pixmap);
+    if (!inserted.isValid())
+        return false;
+    s_instance->m_entries[inserted.id].string_key = key;
+    s_instance->m_string_keys.insert(key, inserted.id);
+    return true;
+}
+
+bool PixmapCache::find(const Key& key, QPixmap* pixmap)
+{
+    if (!s_instance || !key.isValid())
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    return s_instance->findLocked(key.id, pixmap);
+}
+
+bool PixmapCache::find(const QString& key, QPixmap* pixmap)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    auto id = s_instance->m_string_keys.constFind(key);
+    return id != s_instance->m_string_keys.constEnd() && s_instance->findLocked(*id, pixmap);
+}
+
+bool PixmapCache::remove(const Key& key)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    s_instance->removeLocked(key.id);
+    return true;
+}
+
+bool PixmapCache::remove(const QString& key)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    auto id = s_instance->m_string_keys.constFind(key);
+    if (id != s_instance->m_string_keys.constEnd())
+        s_instance->removeLocked(*id);
+    return true;
+}
+
+bool PixmapCache::clear()
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    s_instance->m_entries.clear();
+    s_instance->m_string_keys.clear();
+    for (auto& state : s_instance->m_categories) {
+        state.lru.clear();
+        state.stats.bytes = 0;
+        state.stats.count = 0;
+    }
+    return true;
+}
+
+bool PixmapCache::setBudget(Category category, qint64 bytes)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    auto& state = s_instance->stateOf(category);
+    state.stats.budget = std::max<qint64>(0, bytes);
+    state.ceiling = std::max(state.ceiling, state.stats.budget);
+    s_instance->shrinkLocked(state);
+    return true;
+}
+
+qint64 PixmapCache::budget(Category category)
+{
+    return stats(category).budget;
+}
+
+PixmapCache::Stats PixmapCache::stats(Category category)
+{
+    if (!s_instance)
+        return {};
+    QMutexLocker locker(&s_instance->m_lock);
+    return s_instance->stateOf(category).stats;
+}
+
+bool PixmapCache::markCacheMissByEviciton(Category category)
+{
+    static constexpr int oneSecond = 1000;
+
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    auto& state = s_instance->stateOf(category);
+    state.stats.misses++;
+
+    auto now = QTime::currentTime();
+    if (!state.last_cache_miss_by_eviction.isNull()) {
+        auto diff = state.last_cache_miss_by_eviction.msecsTo(now);
+        if (diff < oneSecond) {  // less than a second ago
+            ++state.consecutive_fast_evictions;
+        } else {
+            state.consecutive_fast_evictions = 0;
+        }
+    }
+    state.last_cache_miss_by_eviction = now;
+
+    if (state.consecutive_fast_evictions < s_instance->m_consecutive_fast_evictions_threshold)
+        return false;
+    state.consecutive_fast_evictions = 0;
+
+    if (state.stats.budget >= state.ceiling) {
+        qDebug() << "Pixmap cache misses by eviction happened too fast for" << categoryName(category)
+                 << ", doing nothing as the budget reached its ceiling of" << state.ceiling << "bytes";
+        return false;
+    }
+    state.stats.budget = std::min(state.ceiling, state.stats.budget + growthStep);
+    qDebug() << "Pixmap cache misses by eviction happened too fast for" << categoryName(category) << ", increasing its budget to"
+             << state.stats.budget << "bytes";
+    return true;
+}
+
+bool PixmapCache::setFastEvictionThreshold(int threshold)
+{
+    if (!s_instance)
+        return false;
+    QMutexLocker locker(&s_instance->m_lock);
+    s_instance->m_consecutive_fast_evictions_threshold = threshold;
+    return true;
+}
@@ -1,147 +1,108 @@
 #pragma once
 
-#include <QCoreApplication>
-#include <QDebug>
-#include <QPixmapCache>
-#include <QThread>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
 #include <QTime>
-#include <limits>
-
-#define GET_TYPE()                                                          \
-    Qt::ConnectionType type;                                                \
-    if (QThread::currentThread() != QCoreApplication::instance()->thread()) \
-        type = Qt::BlockingQueuedConnection;                                \
-    else                                                                    \
-        type = Qt::DirectConnection;
-
-#define DEFINE_FUNC_NO_PARAM(NAME, RET_TYPE)                                                 \
-    static RET_TYPE NAME()                                                                   \
-    {                                                                                        \
-        RET_TYPE ret;                                                                        \
-        GET_TYPE()                                                                           \
-        QMetaObject::invokeMethod(s_instance, "_" #NAME, type, Q_RETURN_ARG(RET_TYPE, ret)); \
-        return ret;                                                                          \
-    }
-#define DEFINE_FUNC_ONE_PARAM(NAME, RET_TYPE, PARAM_1_TYPE)                                                           \
-    static RET_TYPE NAME(PARAM_1_TYPE p1)                                                                             \
-    {                                                                                                                 \
-        RET_TYPE ret;                                                                                                 \
-        GET_TYPE()                                                                                                    \
-        QMetaObject::invokeMethod(s_instance, "_" #NAME, type, Q_RETURN_ARG(RET_TYPE, ret), Q_ARG(PARAM_1_TYPE, p1)); \
-        return ret;                                                                                                   \
-    }
-#define DEFINE_FUNC_TWO_PARAM(NAME, RET_TYPE, PARAM_1_TYPE, PARAM_2_TYPE)                                            \
-    static RET_TYPE NAME(PARAM_1_TYPE p1, PARAM_2_TYPE p2)                                                           \
-    {                                                                                                                \
-        RET_TYPE ret;                                                                                                \
-        GET_TYPE()                                                                                                   \
-        QMetaObject::invokeMethod(s_instance, "_" #NAME, type, Q_RETURN_ARG(RET_TYPE, ret), Q_ARG(PARAM_1_TYPE, p1), \
-                                  Q_ARG(PARAM_2_TYPE, p2));                                                          \
-        return ret;                                                                                                  \
-    }
-
-/** A wrapper around QPixmapCache with thread affinity with the main thread.
+
+#include <array>
+#include <list>
+
+/** A thread safe pixmap cache with a memory budget.
+ *
+ *  Every pixmap belongs to a category with a budget of its own, so a folder of screenshots can't push the mod icons
+ *  out and no part of the launcher can grow the cache without bound. Pixmaps are weighed by the bytes they take, and
+ *  the least recently used ones of a category go first once it's over budget.
+ *
+ *  A category whose pixmaps keep getting evicted right before they're needed again gets its budget raised, up to a
+ *  ceiling, through markCacheMissByEviciton().
  */
 class PixmapCache final : public QObject {
     Q_OBJECT
 
    public:
-    PixmapCache(QObject* parent) : QObject(parent) {}
+    enum class Category { Mods, Packs, Screenshots, Icons };
+    static constexpr int CategoryCount = 4;
+
+    /** Handle of a cached pixmap, invalid on its own. */
+    struct Key {
+        quint64 id = 0;
+        [[nodiscard]] bool isValid() const { return id != 0; }
+    };
+
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 evictions = 0;
+        qint64 bytes = 0;
+        qint64 budget = 0;
+        int count = 0;
+    };
+
+    PixmapCache(QObject* parent);
     ~PixmapCache() override = default;
 
     static PixmapCache& instance() { return *s_instance; }
     static void setInstance(PixmapCache* i) { s_instance = i; }
 
    public:
-    DEFINE_FUNC_NO_PARAM(cacheLimit, int)
-    DEFINE_FUNC_NO_PARAM(clear, bool)
-    DEFINE_FUNC_TWO_PARAM(find, bool, const QString&, QPixmap*)
-    DEFINE_FUNC_TWO_PARAM(find, bool, const QPixmapCache::Key&, QPixmap*)
-    DEFINE_FUNC_TWO_PARAM(insert, bool, const QString&, const QPixmap&)
-    DEFINE_FUNC_ONE_PARAM(insert, QPixmapCache::Key, const QPixmap&)
-    DEFINE_FUNC_ONE_PARAM(remove, bool, const QString&)
-    DEFINE_FUNC_ONE_PARAM(remove, bool, const QPixmapCache::Key&)
-    DEFINE_FUNC_TWO_PARAM(replace, bool, const QPixmapCache::Key&, const QPixmap&)
-    DEFINE_FUNC_ONE_PARAM(setCacheLimit, bool, int)
-    DEFINE_FUNC_NO_PARAM(markCacheMissByEviciton, bool)
-    DEFINE_FUNC_ONE_PARAM(setFastEvictionThreshold, bool, int)
-
-    // NOTE: Every function returns something non-void to simplify the macros.
-   private slots:
-    int _cacheLimit() { return QPixmapCache::cacheLimit(); }
-    bool _clear()
-    {
-        QPixmapCache::clear();
-        return true;
-    }
-    bool _find(const QString& key, QPixmap* pixmap) { return QPixmapCache::find(key, pixmap); }
-    bool _find(const QPixmapCache::Key& key, QPixmap* pixmap) { return QPixmapCache::find(key, pixmap); }
-    bool _insert(const QString& key, const QPixmap& pixmap) { return QPixmapCache::insert(key, pixmap); }
-    QPixmapCache::Key _insert(const QPixmap& pixmap) { return QPixmapCache::insert(pixmap); }
-    bool _remove(const QString& key)
-    {
-        QPixmapCache::remove(key);
-        return true;
-    }
-    bool _remove(const QPixmapCache::Key& key)
-    {
-        QPixmapCache::remove(key);
-        return true;
-    }
-    bool _replace(const QPixmapCache::Key& key, const QPixmap& pixmap) { return QPixmapCache::replace(key, pixmap); }
-    bool _setCacheLimit(int n)
-    {
-        QPixmapCache::setCacheLimit(n);
-        return true;
-    }
+    /// insert a pixmap, returns an invalid key if it doesn't fit the budget at all
+    static Key insert(Category category, const QPixmap& pixmap);
+    /// insert a pixmap under a string key, replacing what was there
+    static bool insert(Category category, const QString& key, const QPixmap& pixmap);
+    static bool find(const Key& key, QPixmap* pixmap);
+    static bool find(const QString& key, QPixmap* pixmap);
+    static bool remove(const Key& key);
+    static bool remove(const QString& key);
+    static bool clear();
+
+    /// the budget of the category in bytes, dropping what doesn't fit anymore
+    static bool setBudget(Category category, qint64 bytes);
+    static qint64 budget(Category category);
+    static Stats stats(Category category);
 
     /**
-     *  Mark that a cache miss occurred because of a eviction if too many of these occur too fast the cache size is increased
-     * @return if the cache size was increased
+     *  Mark that a cache miss occurred because of a eviction if too many of these occur too fast the budget of the category is increased
+     * @return if the budget was increased
      */
-    bool _markCacheMissByEviciton()
-    {
-        static constexpr uint maxInt = static_cast<uint>(std::numeric_limits<int>::max());
-        static constexpr uint step = 10240;
-        static constexpr int oneSecond = 1000;
-
-        auto now = QTime::currentTime();
-        if (!m_last_cache_miss_by_eviciton.isNull()) {
-            auto diff = m_last_cache_miss_by_eviciton.msecsTo(now);
-            if (diff < oneSecond) {  // less than a second ago
-                ++m_consecutive_fast_evicitons;
-            } else {
-                m_consecutive_fast_evicitons = 0;
-            }
-        }
-        m_last_cache_miss_by_eviciton = now;
-        if (m_consecutive_fast_evicitons >= m_consecutive_fast_evicitons_threshold) {
-            // increase the cache size
-            uint newSize = _cacheLimit() + step;
-            if (newSize >= maxInt) {  // increase it until you overflow :D
-                newSize = maxInt;
-                qDebug() << m_consecutive_fast_evicitons
-                         << tr("pixmap cache misses by eviction happened too fast, doing nothing as the cache size reached it's limit");
-            } else {
-                qDebug() << m_consecutive_fast_evicitons
-                         << tr("pixmap cache misses by eviction happened too fast, increasing cache size to") << static_cast<int>(newSize);
-            }
-            _setCacheLimit(static_cast<int>(newSize));
-            m_consecutive_fast_evicitons = 0;
-            return true;
-        }
-        return false;
-    }
-
-    bool _setFastEvictionThreshold(int threshold)
-    {
-        m_consecutive_fast_evicitons_threshold = threshold;
-        return true;
-    }
+    static bool markCacheMissByEviciton(Category category);
+    static bool setFastEvictionThreshold(int threshold);
+
+    [[nodiscard]] static QString categoryName(Category category);
+
+   private:
+    struct Entry {
+        QPixmap pixmap;
+        qint64 cost = 0;
+        Category category;
+        QString string_key;
+        std::list<quint64>::iterator lru_position;
+    };
+
+    struct CategoryState {
+        // most recently used first
+        std::list<quint64> lru;
+        Stats stats;
+        qint64 ceiling = 0;
+        QTime last_cache_miss_by_eviction;
+        int consecutive_fast_evictions = 0;
+    };
+
+    Key insertLocked(Category category, const QPixmap& pixmap);
+    bool findLocked(quint64 id, QPixmap* pixmap);
+    void removeLocked(quint64 id);
+    void shrinkLocked(CategoryState& state);
+    CategoryState& stateOf(Category category) { return m_categories[static_cast<int>(category)]; }
 
    private:
     static PixmapCache* s_instance;
-    QTime m_last_cache_miss_by_eviciton;
-    int m_consecutive_fast_evicitons = 0;
-    int m_consecutive_fast_evicitons_threshold = 15;
+
+    QMutex m_lock;
+    quint64 m_next_id = 1;
+    QHash<quint64, Entry> m_entries;
+    QHash<QString, quint64> m_string_keys;
+    std::array<CategoryState, CategoryCount> m_categories;
+    int m_consecutive_fast_evictions_threshold = 15;
 };
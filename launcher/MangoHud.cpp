@@ -16,8 +16,10 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
 #include <QString>
 #include <QStringList>
 #include <QSysInfo>
@@ -36,9 +38,13 @@
 #include <linux/limits.h>
 #endif
 
+#include <mutex>
+#include <optional>
+
 namespace MangoHud {
 
-QString getLibraryString()
+namespace {
+QStringList layerFolders()
 {
     /*
      * Check for vulkan layers in this order:
@@ -84,7 +90,20 @@ QString getLibraryString()
         }
         vkLayerList << FS::PathCombine(xdgConfigHome, "vulkan", "implicit_layer.d");
     }
+    return vkLayerList;
+}
+
+// when each of the files changed, a new layer or one going away changes its folder
+QList<QDateTime> stamps(const QStringList& paths)
+{
+    QList<QDateTime> result;
+    for (auto& path : paths)
+        result.append(QFileInfo(path).lastModified());
+    return result;
+}
 
+QString findLibraryString(const QStringList& vkLayerList, QString& manifest)
+{
     for (QString vkLayer : vkLayerList) {
         // prefer to use architecture specific vulkan layers
         QString currentArch = QSysInfo::currentCpuArchitecture();
@@ -108,6 +127,7 @@ QString getLibraryString()
             continue;
         }
 
+        manifest = filePath;
         auto conf = Json::requireDocument(filePath, vkLayer);
         auto confObject = Json::requireObject(conf, vkLayer);
         auto layer = Json::ensureObject(confObject, "layer");
@@ -116,6 +136,37 @@ QString getLibraryString()
 
     return QString();
 }
+}  // namespace
+
+QString getLibraryString()
+{
+    // what was found stays as long as none of the folders nor the manifest changed, that's a stat each instead of a search
+    static std::mutex lock;
+    static QStringList searched;
+    // the folders and the manifest found in there
+    static QStringList watched;
+    static QList<QDateTime> watchedStamps;
+    static std::optional<QString> found;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto folders = layerFolders();
+    if (found && folders == searched && stamps(watched) == watchedStamps)
+        return *found;
+
+    QString manifest;
+    try {
+        found = findLibraryString(folders, manifest);
+    } catch (const JSONValidationError& e) {
+        qWarning() << "Couldn't read the MangoHud layer" << manifest << ":" << e.cause();
+        found = QString();
+    }
+    searched = folders;
+    watched = folders;
+    if (!manifest.isEmpty())
+        watched.append(manifest);
+    watchedStamps = stamps(watched);
+    return *found;
+}
 
 QString findLibrary(QString libName)
 {
@@ -23,6 +23,7 @@
 
 namespace MangoHud {
 
+/// the library of the MangoHud Vulkan layer, remembered until the layer folders change, on any thread
 QString getLibraryString();
 
 QString findLibrary(QString libName);
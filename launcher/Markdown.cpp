@@ -18,14 +18,61 @@
 
 #include "Markdown.h"
 
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
+
+#include <algorithm>
+
+namespace {
+// about this many characters of HTML are kept, long changelogs are a few hundred thousand
+const int s_cacheCost = 4 * 1024 * 1024;
+
+struct RenderCache {
+    QMutex lock;
+    QCache<QByteArray, QString> entries{ s_cacheCost };
+};
+
+RenderCache& renderCache()
+{
+    static RenderCache cache;
+    return cache;
+}
+
+QByteArray cacheKey(const QByteArray& markdown)
+{
+    return QCryptographicHash::hash(markdown, QCryptographicHash::Sha1);
+}
+}  // namespace
+
+std::optional<QString> cachedMarkdownToHTML(const QString& markdown)
+{
+    auto key = cacheKey(markdown.toUtf8());
+    auto& cache = renderCache();
+    QMutexLocker locker(&cache.lock);
+    if (auto html = cache.entries.object(key))
+        return *html;
+    return {};
+}
+
 QString markdownToHTML(const QString& markdown)
 {
     const QByteArray markdownData = markdown.toUtf8();
+    auto key = cacheKey(markdownData);
+    auto& cache = renderCache();
+    {
+        QMutexLocker locker(&cache.lock);
+        if (auto html = cache.entries.object(key))
+            return *html;
+    }
+
     char* buffer = cmark_markdown_to_html(markdownData.constData(), markdownData.length(), CMARK_OPT_NOBREAKS | CMARK_OPT_UNSAFE);
 
     QString htmlStr(buffer);
 
     free(buffer);
 
+    QMutexLocker locker(&cache.lock);
+    cache.entries.insert(key, new QString(htmlStr), std::max(1, static_cast<int>(htmlStr.size())));
     return htmlStr;
-}
\ No newline at end of file
+}
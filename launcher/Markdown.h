@@ -21,4 +21,9 @@
 #include <cmark.h>
 #include <QString>
 
-QString markdownToHTML(const QString& markdown);
\ No newline at end of file
+#include <optional>
+
+/// the same text is rendered once, what was rendered lately is cached by the hash of the text
+QString markdownToHTML(const QString& markdown);
+/// what markdownToHTML() returns, if it's cached already
+std::optional<QString> cachedMarkdownToHTML(const QString& markdown);
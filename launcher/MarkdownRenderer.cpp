@@ -0,0 +1,30 @@
+#include "MarkdownRenderer.h"
+
+#include <QFutureWatcher>
+
+#include "Markdown.h"
+#include "tasks/Executor.h"
+
+namespace {
+// cmark takes a few milliseconds for about this much
+const int s_renderInlineSize = 32 * 1024;
+}  // namespace
+
+void renderMarkdown(QObject* context, const QString& markdown, std::function<void(const QString& html)> done)
+{
+    if (markdown.size() < s_renderInlineSize) {
+        done(markdownToHTML(markdown));
+        return;
+    }
+    if (auto html = cachedMarkdownToHTML(markdown)) {
+        done(*html);
+        return;
+    }
+
+    auto watcher = new QFutureWatcher<QString>(context);
+    QObject::connect(watcher, &QFutureWatcher<QString>::finished, watcher, [watcher, done = std::move(done)] {
+        watcher->deleteLater();
+        done(watcher->result());
+    });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Interactive, [markdown] { return markdownToHTML(markdown); }));
+}
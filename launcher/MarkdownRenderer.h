@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+#include <functional>
+
+/** Renders the markdown of descriptions and changelogs for the views showing them.
+ *
+ *  What's cached or small is rendered right away and `done` is called before this returns. Big documents are
+ *  rendered on the executor and `done` gets them a moment later on this thread, unless `context` is gone by then, so
+ *  the view can show what it has meanwhile. Check in `done` that the view still shows the same thing.
+ */
+void renderMarkdown(QObject* context, const QString& markdown, std::function<void(const QString& html)> done);
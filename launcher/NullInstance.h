@@ -47,7 +47,7 @@ class NullInstance : public BaseInstance {
         setVersionBroken(true);
     }
     virtual ~NullInstance(){};
-    void saveNow() override {}
+    void saveNow() override { m_settings->saveNow(); }
     void loadSpecificSettings() override { setSpecificSettingsLoaded(true); }
     QString getStatusbarDescription() override { return tr("Unknown instance type"); };
     QSet<QString> traits() const override { return {}; };
@@ -0,0 +1,74 @@
+#include "PerfCounters.h"
+
+#include <QMutex>
+
+#include <map>
+
+namespace PerfCounters {
+
+namespace {
+struct Registry {
+    QMutex lock;
+    // nodes of a map stay where they are, so the counters can be handed out
+    std::map<QString, std::atomic<qint64>> counters;
+    std::map<QString, std::function<qint64()>> gauges;
+};
+
+Registry& registry()
+{
+    static Registry reg;
+    return reg;
+}
+}  // namespace
+
+std::atomic<qint64>& counter(const QString& name)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.lock);
+    return reg.counters.try_emplace(name, 0).first->second;
+}
+
+void addDuration(const QString& name, qint64 ms)
+{
+    add(name + ".count");
+    add(name + ".total_ms", ms);
+    auto& max = counter(name + ".max_ms");
+    auto current = max.load(std::memory_order_relaxed);
+    while (current < ms && !max.compare_exchange_weak(current, ms, std::memory_order_relaxed)) {
+    }
+}
+
+void addGauge(const QString& name, std::function<qint64()> read)
+{
+    auto& reg = registry();
+    QMutexLocker locker(&reg.lock);
+    reg.gauges[name] = std::move(read);
+}
+
+QMap<QString, qint64> snapshot()
+{
+    QMap<QString, qint64> values;
+    std::map<QString, std::function<qint64()>> gauges;
+    {
+        auto& reg = registry();
+        QMutexLocker locker(&reg.lock);
+        for (auto& [name, value] : reg.counters)
+            values.insert(name, value.load(std::memory_order_relaxed));
+        gauges = reg.gauges;
+    }
+    // gauges take locks of their own
+    for (auto& [name, read] : gauges)
+        values.insert(name, read());
+    return values;
+}
+
+QString dump()
+{
+    QString out;
+    auto values = snapshot();
+    for (auto it = values.constBegin(); it != values.constEnd(); it++)
+        out += QString("%1 %2\n").arg(it.key()).arg(it.value());
+    return out;
+}
+
+}  // namespace PerfCounters
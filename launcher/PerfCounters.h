@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Counts what the launcher does while it runs, like cache hits, bytes downloaded and time spent parsing.
+ *
+ * Counters are created the first time they're used and live as long as the launcher does, so code that bumps one a
+ * lot can keep a reference to it around. Gauges are read when someone asks, for things that already keep count of
+ * themselves. Everything here is thread safe.
+ */
+namespace PerfCounters {
+
+/// the counter called `name`, starting from zero
+std::atomic<qint64>& counter(const QString& name);
+
+inline void add(const QString& name, qint64 amount = 1)
+{
+    counter(name).fetch_add(amount, std::memory_order_relaxed);
+}
+
+/// count one more `name`, taking `ms` milliseconds, as `name`.count, `name`.total_ms and `name`.max_ms
+void addDuration(const QString& name, qint64 ms);
+
+/// read the value called `name` with `read` every time the counters are asked for
+void addGauge(const QString& name, std::function<qint64()> read);
+
+/// the value of every counter and gauge, by name
+QMap<QString, qint64> snapshot();
+
+/// one counter per line, for the log
+QString dump();
+
+}  // namespace PerfCounters
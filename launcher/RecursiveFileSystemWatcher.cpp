@@ -3,10 +3,23 @@
 #include <QDebug>
 #include <QRegularExpression>
 
-RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject* parent) : QObject(parent), m_watcher(new QFileSystemWatcher(this))
+#include "filewatch/FileWatchBackend.h"
+
+// how long changes are collected before they are told about, in milliseconds
+static constexpr int settleTime = 200;
+
+RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject* parent) : QObject(parent), m_backend(FileWatchBackend::create(this))
+{
+    connectBackend();
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(settleTime);
+    connect(&m_settleTimer, &QTimer::timeout, this, &RecursiveFileSystemWatcher::settled);
+}
+
+void RecursiveFileSystemWatcher::connectBackend()
 {
-    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &RecursiveFileSystemWatcher::fileChange);
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &RecursiveFileSystemWatcher::directoryChange);
+    connect(m_backend, &FileWatchBackend::fileChanged, this, &RecursiveFileSystemWatcher::fileChange);
+    connect(m_backend, &FileWatchBackend::directoryChanged, this, &RecursiveFileSystemWatcher::directoryChange);
 }
 
 void RecursiveFileSystemWatcher::setRootDir(const QDir& root)
@@ -35,7 +48,13 @@ void RecursiveFileSystemWatcher::enable()
         return;
     }
     Q_ASSERT(m_root != QDir::root());
-    addFilesToWatcherRecursive(m_root);
+    if (!m_backend->watch(m_root, m_watchFiles)) {
+        qWarning() << "Falling back to QFileSystemWatcher for" << m_root.absolutePath();
+        delete m_backend;
+        m_backend = new QtFileWatchBackend(this);
+        connectBackend();
+        m_backend->watch(m_root, m_watchFiles);
+    }
     m_isEnabled = true;
 }
 void RecursiveFileSystemWatcher::disable()
@@ -44,8 +63,10 @@ void RecursiveFileSystemWatcher::disable()
         return;
     }
     m_isEnabled = false;
-    m_watcher->removePaths(m_watcher->files());
-    m_watcher->removePaths(m_watcher->directories());
+    m_backend->stop();
+    m_settleTimer.stop();
+    m_changedDirectories.clear();
+    m_changedFiles.clear();
 }
 
 void RecursiveFileSystemWatcher::setFiles(const QStringList& files)
@@ -56,18 +77,6 @@ void RecursiveFileSystemWatcher::setFiles(const QStringList& files)
     }
 }
 
-void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir& dir)
-{
-    m_watcher->addPath(dir.absolutePath());
-    for (const QString& directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
-        addFilesToWatcherRecursive(dir.absoluteFilePath(directory));
-    }
-    if (m_watchFiles) {
-        for (const QFileInfo& info : dir.entryInfoList(QDir::Files)) {
-            m_watcher->addPath(info.absoluteFilePath());
-        }
-    }
-}
 QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir& directory)
 {
     QStringList ret;
@@ -88,9 +97,28 @@ QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir& directory)
 
 void RecursiveFileSystemWatcher::fileChange(const QString& path)
 {
-    emit fileChanged(path);
+    m_changedFiles.insert(path);
+    // not restarted, so that a steady stream of changes can't hold them back for good
+    if (!m_settleTimer.isActive())
+        m_settleTimer.start();
 }
-void RecursiveFileSystemWatcher::directoryChange([[maybe_unused]] const QString& path)
+void RecursiveFileSystemWatcher::directoryChange(const QString& path)
 {
-    setFiles(scanRecursive(m_root));
+    m_changedDirectories.insert(path);
+    if (!m_settleTimer.isActive())
+        m_settleTimer.start();
+}
+
+void RecursiveFileSystemWatcher::settled()
+{
+    auto directories = m_changedDirectories;
+    auto files = m_changedFiles;
+    m_changedDirectories.clear();
+    m_changedFiles.clear();
+    if (!directories.isEmpty())
+        setFiles(scanRecursive(m_root));
+    for (auto& path : directories)
+        emit directoryChanged(path);
+    for (auto& path : files)
+        emit fileChanged(path);
 }
@@ -1,9 +1,18 @@
 #pragma once
 
 #include <QDir>
-#include <QFileSystemWatcher>
+#include <QSet>
+#include <QTimer>
 #include "pathmatcher/IPathMatcher.h"
 
+class FileWatchBackend;
+
+/**
+ * Watches a directory tree with whatever the system has for that, see FileWatchBackend.
+ *
+ * A burst of changes, like a mod folder being copied in, is told about once: the changes are collected for a moment and
+ * every directory and file that changed is signalled once, with the files rescanned only then.
+ */
 class RecursiveFileSystemWatcher : public QObject {
     Q_OBJECT
    public:
@@ -23,6 +32,8 @@ class RecursiveFileSystemWatcher : public QObject {
    signals:
     void filesChanged();
     void fileChanged(const QString& path);
+    // something was added to, removed from or renamed in one of the watched directories
+    void directoryChanged(const QString& path);
 
    public slots:
     void enable();
@@ -34,15 +45,21 @@ class RecursiveFileSystemWatcher : public QObject {
     bool m_isEnabled = false;
     IPathMatcher::Ptr m_matcher;
 
-    QFileSystemWatcher* m_watcher;
+    FileWatchBackend* m_backend;
+    void connectBackend();
 
     QStringList m_files;
     void setFiles(const QStringList& files);
 
-    void addFilesToWatcherRecursive(const QDir& dir);
     QStringList scanRecursive(const QDir& dir);
 
+    // what changed since the last time changes were told about
+    QSet<QString> m_changedDirectories;
+    QSet<QString> m_changedFiles;
+    QTimer m_settleTimer;
+
    private slots:
     void fileChange(const QString& path);
     void directoryChange(const QString& path);
+    void settled();
 };
@@ -0,0 +1,150 @@
+#include "RemoteImageLoader.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QSaveFile>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "MTPixmapCache.h"
+#include "net/ApiDownload.h"
+#include "net/HttpMetaCache.h"
+#include "tasks/Executor.h"
+
+namespace {
+// the ones waiting beyond this were scrolled past long ago, they're asked for again when they're back in view
+const int maxQueued = 256;
+
+QString nameFor(const QUrl& url)
+{
+    return QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+}
+
+// the thumbnail made after the last download of the picture, or the picture scaled down and saved as the new one
+QImage loadThumbnail(const QString& source, const QString& thumbnail)
+{
+    QFileInfo thumbnailInfo(thumbnail);
+    if (thumbnailInfo.exists() && thumbnailInfo.lastModified() >= QFileInfo(source).lastModified()) {
+        QImage image(thumbnail, "PNG");
+        if (!image.isNull())
+            return image;
+    }
+
+    const QSize box(RemoteImageLoader::thumbnailSize, RemoteImageLoader::thumbnailSize);
+    QImageReader reader(source);
+    // formats that can decode at a smaller size skip most of the work
+    auto size = reader.size();
+    if (reader.supportsOption(QImageIOHandler::ScaledSize) && size.isValid() &&
+        (size.width() > box.width() || size.height() > box.height()))
+        reader.setScaledSize(size.scaled(box, Qt::KeepAspectRatio));
+    auto image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Couldn't read" << source << ":" << reader.errorString();
+        return {};
+    }
+    if (image.width() > box.width() || image.height() > box.height())
+        image = image.scaled(box, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    if (FS::ensureFilePathExists(thumbnail)) {
+        QSaveFile file(thumbnail);
+        if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit())
+            qWarning() << "Couldn't save thumbnail" << thumbnail << ":" << file.errorString();
+    }
+    return image;
+}
+}  // namespace
+
+RemoteImageLoader::RemoteImageLoader(QString root, int max_running, QObject* parent)
+    : QObject(parent), m_root(std::move(root)), m_max_running(std::max(1, max_running))
+{}
+
+RemoteImageLoader* RemoteImageLoader::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->remoteImageLoader().get() : nullptr;
+}
+
+std::optional<QPixmap> RemoteImageLoader::get(const QUrl& url, const QString& base)
+{
+    QPixmap pixmap;
+    if (PixmapCache::find(url.toString(), &pixmap))
+        return pixmap;
+    if (!url.isValid() || m_failed.contains(url))
+        return {};
+
+    if (m_requests.contains(url)) {
+        // still wanted, so it goes first if it's still waiting
+        if (m_queue.removeOne(url))
+            m_queue.prepend(url);
+        return {};
+    }
+    m_requests.insert(url, { base, nullptr });
+    m_queue.prepend(url);
+    while (m_queue.size() > maxQueued)
+        m_requests.remove(m_queue.takeLast());
+    startNext();
+    return {};
+}
+
+void RemoteImageLoader::startNext()
+{
+    while (m_running < m_max_running && !m_queue.isEmpty()) {
+        m_running++;
+        load(m_queue.takeFirst());
+    }
+}
+
+void RemoteImageLoader::load(const QUrl& url)
+{
+    auto& request = m_requests[url];
+    auto name = nameFor(url);
+    // where the models downloaded them to before, so what's there already counts
+    auto entry = APPLICATION->metacache()->resolveEntry(request.base, QString("logos/%1").arg(name));
+    auto source = entry->getFullPath();
+    auto thumbnail = thumbnailPath(name);
+
+    auto download = Net::ApiDownload::makeCached(url, entry);
+    download->setNetwork(APPLICATION->network());
+    download->setPriority(Net::Priority::Interactive);
+    connect(download.get(), &Task::succeeded, this, [this, url, source, thumbnail] { decode(url, source, thumbnail); });
+    connect(download.get(), &Task::failed, this, [this, url] { finish(url, {}); });
+    connect(download.get(), &Task::aborted, this, [this, url] { finish(url, {}); });
+    request.download = download;
+    download->start();
+}
+
+void RemoteImageLoader::decode(const QUrl& url, const QString& source, const QString& thumbnail)
+{
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, url] {
+        watcher->deleteLater();
+        finish(url, watcher->result());
+    });
+    watcher->setFuture(
+        Executor::instance()->run(Executor::Priority::Interactive, [source, thumbnail] { return loadThumbnail(source, thumbnail); }));
+}
+
+void RemoteImageLoader::finish(const QUrl& url, const QImage& image)
+{
+    m_running--;
+    m_requests.remove(url);
+    // neither is tried again while the launcher runs, it would only go the same way
+    if (image.isNull()) {
+        m_failed.insert(url);
+    } else if (!PixmapCache::insert(PixmapCache::Category::Icons, url.toString(), QPixmap::fromImage(image))) {
+        qWarning() << "The thumbnail of" << url << "doesn't fit the pixmap cache";
+        m_failed.insert(url);
+    } else {
+        emit loaded(url);
+    }
+    QMetaObject::invokeMethod(this, &RemoteImageLoader::startNext, Qt::QueuedConnection);
+}
+
+QString RemoteImageLoader::thumbnailPath(const QString& name) const
+{
+    return FS::PathCombine(m_root, name.left(2), name + ".png");
+}
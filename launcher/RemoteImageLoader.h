@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QUrl>
+
+#include <optional>
+
+#include "net/NetAction.h"
+
+/**
+ * Pictures from the web, like the logos of projects on Modrinth and CurseForge, scaled down for the rows showing them.
+ *
+ * Every picture is downloaded once for everything that shows it, into the metacache, which asks again only when the
+ * headers of the last response say so. It's scaled down to a thumbnail right away, on a thread of the executor, and
+ * the thumbnail is kept both on disk and in the pixmap cache, whose budget bounds how much memory they take. What was
+ * asked for last is loaded first, so the rows in view come before the ones that were scrolled past.
+ */
+class RemoteImageLoader : public QObject {
+    Q_OBJECT
+   public:
+    /// size thumbnails are scaled down to, the biggest anything shows them at
+    static constexpr int thumbnailSize = 64;
+
+    RemoteImageLoader(QString root, int max_running, QObject* parent = nullptr);
+
+    /// the loader of the running launcher, null when there's none like in tests
+    static auto shared() -> RemoteImageLoader*;
+
+    /// the thumbnail of the picture at `url` if it's loaded already, otherwise it's loaded into the metacache base `base`
+    auto get(const QUrl& url, const QString& base) -> std::optional<QPixmap>;
+
+   signals:
+    /// the thumbnail of `url` can be gotten now
+    void loaded(const QUrl& url);
+
+   private:
+    struct Request {
+        QString base;
+        NetAction::Ptr download;
+    };
+
+    void startNext();
+    void load(const QUrl& url);
+    void decode(const QUrl& url, const QString& source, const QString& thumbnail);
+    void finish(const QUrl& url, const QImage& image);
+
+    auto thumbnailPath(const QString& name) const -> QString;
+
+   private:
+    QString m_root;
+    int m_max_running;
+    int m_running = 0;
+
+    QHash<QUrl, Request> m_requests;
+    // the ones waiting, the most recently asked for first
+    QList<QUrl> m_queue;
+    QSet<QUrl> m_failed;
+};
@@ -23,8 +23,11 @@
 
 #include "minecraft/mod/ModFolderModel.h"
 #include "minecraft/mod/ResourceFolderModel.h"
+#include "modplatform/helpers/HashCache.h"
 
 #include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+#include "net/HashingValidator.h"
 
 ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
                                            ModPlatform::IndexedVersion version,
@@ -41,6 +44,7 @@ ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
     }
 
     m_filesNetJob.reset(new NetJob(tr("Resource download"), APPLICATION->network()));
+    m_filesNetJob->setPriority(Net::Priority::Bulk);
     m_filesNetJob->setStatus(tr("Downloading resource:\n%1").arg(m_pack_version.downloadUrl));
 
     QDir dir{ m_pack_model->dir() };
@@ -53,7 +57,17 @@ ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
         }
     }
 
-    m_filesNetJob->addNetAction(Net::ApiDownload::makeFile(m_pack_version.downloadUrl, dir.absoluteFilePath(getFilename())));
+    m_target_path = dir.absoluteFilePath(getFilename());
+    auto action = Net::ApiDownload::makeFile(m_pack_version.downloadUrl, m_target_path);
+    // a known digest lets the download come out of the content store
+    if (m_pack_version.hash_type == "sha1" || m_pack_version.hash_type == "sha512") {
+        auto algorithm = m_pack_version.hash_type == "sha1" ? QCryptographicHash::Sha1 : QCryptographicHash::Sha512;
+        action->addValidator(new Net::ChecksumValidator(algorithm, QByteArray::fromHex(m_pack_version.hash.toLatin1())));
+    }
+    // the update checks and the metadata ask for these right after, this way the file isn't read back for them
+    m_hashing = new Net::HashingValidator;
+    action->addValidator(m_hashing);
+    m_filesNetJob->addNetAction(action);
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, &ResourceDownloadTask::downloadSucceeded);
     connect(m_filesNetJob.get(), &NetJob::progress, this, &ResourceDownloadTask::downloadProgressChanged);
     connect(m_filesNetJob.get(), &NetJob::stepProgress, this, &ResourceDownloadTask::propagateStepProgress);
@@ -64,6 +78,11 @@ ResourceDownloadTask::ResourceDownloadTask(ModPlatform::IndexedPack::Ptr pack,
 
 void ResourceDownloadTask::downloadSucceeded()
 {
+    // nothing came through when the file was taken from the content store
+    auto hashes = m_hashing->hashes();
+    if (!hashes.isEmpty())
+        APPLICATION->hashCache()->put(m_target_path, hashes);
+    m_hashing = nullptr;
     m_filesNetJob.reset();
     auto name = std::get<0>(to_delete);
     auto filename = std::get<1>(to_delete);
@@ -83,7 +102,7 @@ void ResourceDownloadTask::downloadFailed(QString reason)
 
 void ResourceDownloadTask::downloadProgressChanged(qint64 current, qint64 total)
 {
-    emit progress(current, total);
+    setProgress(current, total);
 }
 
 // This indirection is done so that we don't delete a mod before being sure it was
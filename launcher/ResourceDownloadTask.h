@@ -26,6 +26,9 @@
 #include "modplatform/ModIndex.h"
 
 class ResourceFolderModel;
+namespace Net {
+class HashingValidator;
+}
 
 class ResourceDownloadTask : public SequentialTask {
     Q_OBJECT
@@ -50,6 +53,9 @@ class ResourceDownloadTask : public SequentialTask {
     QString m_custom_target_folder;
 
     NetJob::Ptr m_filesNetJob;
+    // owned by the download, what the bytes hashed to as they came in
+    Net::HashingValidator* m_hashing = nullptr;
+    QString m_target_path;
     LocalModUpdateTask::Ptr m_update_task;
 
     void downloadProgressChanged(qint64 current, qint64 total);
@@ -1,14 +1,31 @@
 #pragma once
-#include <QMap>
+#include <QHash>
 #include <QString>
 #include <QStringList>
+#include <QStringView>
 
+#include <algorithm>
+#include <vector>
+
+/**
+ * A set of paths, split on Tseparator, that tells whether a path or one leading up to it was put in.
+ *
+ * The export dialogs keep tens of thousands of paths in one, each looked up for every file shown or counted. The
+ * nodes live in a single array and their names in a single string, and a child is found through one open addressing
+ * table keyed by its parent and name, so walking a path allocates nothing and touches a few slots per segment.
+ * Removing leaves the nodes behind until there are as many of them as live ones, then the whole tree is packed again.
+ */
 template <char Tseparator>
 class SeparatorPrefixTree {
    public:
-    SeparatorPrefixTree(QStringList paths) { insert(paths); }
+    SeparatorPrefixTree(QStringList paths) : SeparatorPrefixTree(false) { insert(paths); }
 
-    SeparatorPrefixTree(bool contained = false) { m_contained = contained; }
+    SeparatorPrefixTree(bool contained = false)
+    {
+        m_nodes.push_back({});
+        m_nodes[0].contained = contained;
+        m_slots.assign(s_minSlots, s_empty);
+    }
 
     void insert(QStringList paths)
     {
@@ -17,214 +34,368 @@ class SeparatorPrefixTree {
         }
     }
 
-    /// insert an exact path into the tree
-    SeparatorPrefixTree& insert(QString path)
+    /// insert an exact path into the tree, what was below it is dropped as the path covers it now
+    void insert(const QString& path)
     {
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            children[path] = SeparatorPrefixTree(true);
-            return children[path];
-        } else {
-            auto prefix = path.left(sepIndex);
-            if (!children.contains(prefix)) {
-                children[prefix] = SeparatorPrefixTree(false);
+        // room for every segment up front, the indices of the nodes on the way stay valid
+        auto segments = path.count(QLatin1Char(Tseparator)) + 1;
+        if ((m_used + segments) * 10 > static_cast<int>(m_slots.size()) * 7) {
+            rebuild(segments);
+        }
+        int node = 0;
+        forEachSegment(path, [&](QStringView segment, bool last) {
+            auto hash = hashOf(segment);
+            auto child = findChild(node, segment, hash);
+            if (child < 0) {
+                child = addChild(node, segment, hash);
+            } else if (last) {
+                dropChildren(child);
             }
-            return children[prefix].insert(path.mid(sepIndex + 1));
+            node = child;
+            return true;
+        });
+        m_nodes[node].contained = true;
+    }
+
+    /// is the path in the tree? It doesn't have to be contained, like exists()
+    bool contains(const QString& path) const { return find(path) >= 0; }
+
+    /// does the tree cover a path? That means the prefix of the path is contained in the tree
+    bool covers(const QString& path) const { return coverLength(path) >= 0; }
+
+    /// return the contained path that covers the path specified
+    QString cover(const QString& path) const
+    {
+        auto length = coverLength(path);
+        if (length < 0) {
+            return QString();
         }
+        // empty, but not null
+        return length == 0 ? QString("") : path.left(length);
     }
 
-    /// is the path fully contained in the tree?
-    bool contains(QString path) const
+    /// Does the path-specified node exist in the tree? It does not have to be contained.
+    bool exists(const QString& path) const { return find(path) >= 0; }
+
+    /// does the node of the path have anything below it?
+    bool hasChildren(const QString& path) const
     {
         auto node = find(path);
-        return node != nullptr;
+        return node >= 0 && m_nodes[node].firstChild >= 0;
     }
 
-    /// does the tree cover a path? That means the prefix of the path is contained in the tree
-    bool covers(QString path) const
+    /// is this a leaf node?
+    bool leaf() const { return m_nodes[0].firstChild < 0; }
+
+    /// is this node actually contained in the tree, or is it purely structural?
+    bool contained() const { return m_nodes[0].contained; }
+
+    /// Remove a path from the tree
+    bool remove(const QString& path)
     {
-        // if we found some valid node, it's good enough. the tree covers the path
-        if (m_contained) {
+        if (path.isEmpty()) {
+            // removing the whole tree as a prefix
+            if (!m_nodes[0].contained) {
+                clear();
+            }
+            m_nodes[0].contained = false;
             return true;
         }
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            auto found = children.find(path);
-            if (found == children.end()) {
-                return false;
-            }
-            return (*found).covers(QString());
-        } else {
-            auto prefix = path.left(sepIndex);
-            auto found = children.find(prefix);
-            if (found == children.end()) {
-                return false;
+        auto node = find(path);
+        if (node < 0) {
+            return false;
+        }
+        auto& target = m_nodes[node];
+        if (target.contained && target.firstChild >= 0) {
+            // still on the way to others
+            target.contained = false;
+            return true;
+        }
+        // what's left without this one is removed too, up to the first node that's still needed
+        while (node != 0) {
+            auto parent = m_nodes[node].parent;
+            unlink(node);
+            if (m_nodes[parent].contained || m_nodes[parent].firstChild >= 0) {
+                break;
             }
-            return (*found).covers(path.mid(sepIndex + 1));
+            node = parent;
         }
+        if (m_dead > s_minRebuild && m_dead * 2 > static_cast<int>(m_nodes.size())) {
+            rebuild();
+        }
+        return true;
     }
 
-    /// return the contained path that covers the path specified
-    QString cover(QString path) const
+    /// Clear all children of this node tree node
+    void clear()
     {
-        // if we found some valid node, it's good enough. the tree covers the path
-        if (m_contained) {
-            return QString("");
-        }
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            auto found = children.find(path);
-            if (found == children.end()) {
-                return QString();
-            }
-            auto nested = (*found).cover(QString());
-            if (nested.isNull()) {
-                return nested;
-            }
-            if (nested.isEmpty())
-                return path;
-            return path + Tseparator + nested;
-        } else {
-            auto prefix = path.left(sepIndex);
-            auto found = children.find(prefix);
-            if (found == children.end()) {
-                return QString();
-            }
-            auto nested = (*found).cover(path.mid(sepIndex + 1));
-            if (nested.isNull()) {
-                return nested;
-            }
-            if (nested.isEmpty())
-                return prefix;
-            return prefix + Tseparator + nested;
-        }
+        auto contained = m_nodes[0].contained;
+        m_nodes.assign(1, Node());
+        m_nodes[0].contained = contained;
+        m_names.clear();
+        m_slots.assign(s_minSlots, s_empty);
+        m_used = 0;
+        m_dead = 0;
     }
 
-    /// Does the path-specified node exist in the tree? It does not have to be contained.
-    bool exists(QString path) const
+    QStringList toStringList() const
+    {
+        QStringList collected;
+        collect(0, QString(), collected);
+        return collected;
+    }
+
+   private:
+    struct Node {
+        int parent = -1;
+        int firstChild = -1;
+        int nextSibling = -1;
+        int previousSibling = -1;
+        int nameStart = 0;
+        int nameSize = 0;
+        uint hash = 0;
+        bool contained = false;
+    };
+
+    static constexpr int s_empty = -1;
+    static constexpr int s_deleted = -2;
+    static constexpr int s_minSlots = 64;
+    // removals leave at least this many nodes behind before the tree is packed
+    static constexpr int s_minRebuild = 64;
+
+    QStringView nameOf(const Node& node) const { return QStringView(m_names).mid(node.nameStart, node.nameSize); }
+
+    static uint hashOf(QStringView name) { return static_cast<uint>(qHash(name)); }
+
+    static std::size_t slotHash(int parent, uint hash) { return (hash ^ (static_cast<uint>(parent) * 0x9e3779b1u)) * 0x85ebca6bu; }
+
+    /// call handle(segment, last) with every segment of the path, until it returns false
+    template <typename Handle>
+    static bool forEachSegment(const QString& path, Handle handle)
     {
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            auto found = children.find(path);
-            if (found == children.end()) {
+        QStringView view(path);
+        int start = 0;
+        while (true) {
+            auto end = path.indexOf(QLatin1Char(Tseparator), start);
+            auto last = end < 0;
+            if (!handle(view.mid(start, last ? path.size() - start : end - start), last)) {
                 return false;
             }
-            return true;
-        } else {
-            auto prefix = path.left(sepIndex);
-            auto found = children.find(prefix);
-            if (found == children.end()) {
-                return false;
+            if (last) {
+                return true;
             }
-            return (*found).exists(path.mid(sepIndex + 1));
+            start = end + 1;
         }
     }
 
-    /// find a node in the tree by name
-    const SeparatorPrefixTree* find(QString path) const
+    int findChild(int parent, QStringView name, uint hash) const
     {
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            auto found = children.find(path);
-            if (found == children.end()) {
-                return nullptr;
+        std::size_t mask = m_slots.size() - 1;
+        for (auto slot = slotHash(parent, hash) & mask;; slot = (slot + 1) & mask) {
+            auto index = m_slots[slot];
+            if (index == s_empty) {
+                return -1;
             }
-            return &(*found);
-        } else {
-            auto prefix = path.left(sepIndex);
-            auto found = children.find(prefix);
-            if (found == children.end()) {
-                return nullptr;
+            if (index == s_deleted) {
+                continue;
+            }
+            auto& node = m_nodes[index];
+            if (node.parent == parent && node.hash == hash && nameOf(node) == name) {
+                return index;
             }
-            return (*found).find(path.mid(sepIndex + 1));
         }
     }
 
-    /// is this a leaf node?
-    bool leaf() const { return children.isEmpty(); }
+    void placeSlot(int index)
+    {
+        auto& node = m_nodes[index];
+        std::size_t mask = m_slots.size() - 1;
+        auto slot = slotHash(node.parent, node.hash) & mask;
+        while (m_slots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = index;
+    }
 
-    /// is this node actually contained in the tree, or is it purely structural?
-    bool contained() const { return m_contained; }
+    int addChild(int parent, QStringView name, uint hash)
+    {
+        Node node;
+        node.parent = parent;
+        node.nameStart = static_cast<int>(m_names.size());
+        node.nameSize = static_cast<int>(name.size());
+        node.hash = hash;
+        node.nextSibling = m_nodes[parent].firstChild;
+        m_names.append(name.data(), static_cast<int>(name.size()));
+        auto index = static_cast<int>(m_nodes.size());
+        if (node.nextSibling >= 0) {
+            m_nodes[node.nextSibling].previousSibling = index;
+        }
+        m_nodes[parent].firstChild = index;
+        m_nodes.push_back(node);
+        placeSlot(index);
+        m_used++;
+        return index;
+    }
 
-    /// Remove a path from the tree
-    bool remove(QString path) { return removeInternal(path) != Failed; }
+    /// take the node and everything below it out of the tree, they stay in the arrays until the next rebuild
+    void unlink(int index)
+    {
+        auto& node = m_nodes[index];
+        if (node.previousSibling >= 0) {
+            m_nodes[node.previousSibling].nextSibling = node.nextSibling;
+        } else {
+            m_nodes[node.parent].firstChild = node.nextSibling;
+        }
+        if (node.nextSibling >= 0) {
+            m_nodes[node.nextSibling].previousSibling = node.previousSibling;
+        }
+        std::vector<int> todo{ index };
+        while (!todo.empty()) {
+            auto current = todo.back();
+            todo.pop_back();
+            for (auto child = m_nodes[current].firstChild; child >= 0; child = m_nodes[child].nextSibling) {
+                todo.push_back(child);
+            }
+            releaseSlot(current);
+            m_nodes[current].firstChild = -1;
+            m_dead++;
+        }
+    }
 
-    /// Clear all children of this node tree node
-    void clear() { children.clear(); }
+    void dropChildren(int index)
+    {
+        while (m_nodes[index].firstChild >= 0) {
+            unlink(m_nodes[index].firstChild);
+        }
+    }
 
-    QStringList toStringList() const
+    void releaseSlot(int index)
     {
-        QStringList collected;
-        // collecting these is more expensive.
-        auto iter = children.begin();
-        while (iter != children.end()) {
-            QStringList list = iter.value().toStringList();
-            for (int i = 0; i < list.size(); i++) {
-                list[i] = iter.key() + Tseparator + list[i];
-            }
-            collected.append(list);
-            if ((*iter).m_contained) {
-                collected.append(iter.key());
+        auto& node = m_nodes[index];
+        std::size_t mask = m_slots.size() - 1;
+        for (auto slot = slotHash(node.parent, node.hash) & mask;; slot = (slot + 1) & mask) {
+            if (m_slots[slot] == index) {
+                // the slot is still counted as used, so it gets reclaimed by the next rebuild
+                m_slots[slot] = s_deleted;
+                return;
             }
-            iter++;
         }
-        return collected;
     }
 
-   private:
-    enum Removal { Failed, Succeeded, HasChildren };
-    Removal removeInternal(QString path = QString())
+    /// pack the live nodes and their names, and size the table for them and `extra` more, at most 70% full
+    void rebuild(int extra = 0)
     {
-        if (path.isEmpty()) {
-            if (!m_contained) {
-                // remove all children - we are removing a prefix
-                clear();
-                return Succeeded;
-            }
-            m_contained = false;
-            if (children.size()) {
-                return HasChildren;
+        std::vector<Node> nodes;
+        nodes.reserve(m_nodes.size() - m_dead);
+        QString names;
+        names.reserve(m_names.size());
+        nodes.push_back(m_nodes[0]);
+        nodes[0].firstChild = -1;
+        // old index and new index of each node whose children are still to be copied
+        std::vector<std::pair<int, int>> todo{ { 0, 0 } };
+        while (!todo.empty()) {
+            auto [from, to] = todo.back();
+            todo.pop_back();
+            for (auto child = m_nodes[from].firstChild; child >= 0; child = m_nodes[child].nextSibling) {
+                auto copy = m_nodes[child];
+                copy.parent = to;
+                copy.firstChild = -1;
+                copy.previousSibling = -1;
+                copy.nextSibling = nodes[to].firstChild;
+                copy.nameStart = static_cast<int>(names.size());
+                auto name = nameOf(m_nodes[child]);
+                names.append(name.data(), static_cast<int>(name.size()));
+                auto index = static_cast<int>(nodes.size());
+                if (copy.nextSibling >= 0) {
+                    nodes[copy.nextSibling].previousSibling = index;
+                }
+                nodes[to].firstChild = index;
+                nodes.push_back(copy);
+                todo.push_back({ child, index });
             }
-            return Succeeded;
-        }
-        Removal remStatus = Failed;
-        QString childToRemove;
-        auto sepIndex = path.indexOf(Tseparator);
-        if (sepIndex == -1) {
-            childToRemove = path;
-            auto found = children.find(childToRemove);
-            if (found == children.end()) {
-                return Failed;
+        }
+        m_nodes = std::move(nodes);
+        m_names = std::move(names);
+        m_dead = 0;
+        m_used = static_cast<int>(m_nodes.size()) - 1;
+
+        std::size_t slots = s_minSlots;
+        while (slots * 7 < static_cast<std::size_t>(m_used + extra) * 20) {
+            slots *= 2;
+        }
+        m_slots.assign(slots, s_empty);
+        for (int index = 1; index < static_cast<int>(m_nodes.size()); index++) {
+            placeSlot(index);
+        }
+    }
+
+    int find(const QString& path) const
+    {
+        int node = 0;
+        auto found = forEachSegment(path, [&](QStringView segment, bool) {
+            node = findChild(node, segment, hashOf(segment));
+            return node >= 0;
+        });
+        return found ? node : -1;
+    }
+
+    /// how much of the path the contained node covering it takes up, -1 when there's none
+    int coverLength(const QString& path) const
+    {
+        if (m_nodes[0].contained) {
+            return 0;
+        }
+        int node = 0;
+        int length = -1;
+        int consumed = 0;
+        auto walked = forEachSegment(path, [&](QStringView segment, bool last) {
+            node = findChild(node, segment, hashOf(segment));
+            if (node < 0) {
+                return false;
             }
-            remStatus = (*found).removeInternal();
-        } else {
-            childToRemove = path.left(sepIndex);
-            auto found = children.find(childToRemove);
-            if (found == children.end()) {
-                return Failed;
+            consumed += static_cast<int>(segment.size()) + (last ? 0 : 1);
+            if (m_nodes[node].contained) {
+                length = last ? consumed : consumed - 1;
+                return false;
             }
-            remStatus = (*found).removeInternal(path.mid(sepIndex + 1));
+            return true;
+        });
+        if (length >= 0 || !walked) {
+            return length;
         }
-        switch (remStatus) {
-            case Failed:
-            case HasChildren: {
-                return remStatus;
+        // a node keyed by an empty name under the last one covers it too, that's a path ending in a separator
+        auto emptyHash = hashOf(QStringView());
+        for (node = findChild(node, QStringView(), emptyHash); node >= 0; node = findChild(node, QStringView(), emptyHash)) {
+            if (m_nodes[node].contained) {
+                return path.size();
             }
-            case Succeeded: {
-                children.remove(childToRemove);
-                if (m_contained) {
-                    return HasChildren;
-                }
-                if (children.size()) {
-                    return HasChildren;
-                }
-                return Succeeded;
+        }
+        return -1;
+    }
+
+    void collect(int node, const QString& prefix, QStringList& collected) const
+    {
+        std::vector<int> children;
+        for (auto child = m_nodes[node].firstChild; child >= 0; child = m_nodes[child].nextSibling) {
+            children.push_back(child);
+        }
+        // in the order of the names, like it always was
+        std::sort(children.begin(), children.end(), [this](int a, int b) { return nameOf(m_nodes[a]) < nameOf(m_nodes[b]); });
+        for (auto child : children) {
+            auto path = prefix + nameOf(m_nodes[child]).toString();
+            collect(child, path + Tseparator, collected);
+            if (m_nodes[child].contained) {
+                collected.append(path);
             }
         }
-        return Failed;
     }
 
    private:
-    QMap<QString, SeparatorPrefixTree<Tseparator>> children;
-    bool m_contained = false;
+    std::vector<Node> m_nodes;
+    QString m_names;
+    std::vector<int> m_slots;
+    // slots taken, deleted ones included
+    int m_used = 0;
+    // nodes left behind by removals
+    int m_dead = 0;
 };
@@ -17,36 +17,62 @@
 #include "Application.h"
 #include "net/HttpMetaCache.h"
 
+#include <QCryptographicHash>
 #include <QFile>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QImage>
 #include <QPainter>
+#include <QUrl>
 
 namespace SkinUtils {
-/*
- * Given a username, return a pixmap of the cached skin (if it exists), QPixmap() otherwise
- */
-QPixmap getFaceFromCache(QString username, int height, int width)
+static QString cacheKey(const QString& url)
+{
+    // textures.minecraft.net/texture/<hash>
+    QUrl parsed(url);
+    if (parsed.host() == "textures.minecraft.net" && parsed.path().startsWith("/texture/"))
+        return parsed.fileName() + ".png";
+    return QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex() + ".png";
+}
+
+QString cachePath(const QString& url)
+{
+    return APPLICATION->metacache()->resolveEntry("skins", cacheKey(url))->getFullPath();
+}
+
+bool isCachedForGood(const QString& url)
+{
+    QUrl parsed(url);
+    return parsed.host() == "textures.minecraft.net" && QFile::exists(cachePath(url));
+}
+
+NetJob::Ptr makeFetchJob(const QString& url)
+{
+    auto job = makeShared<NetJob>(QObject::tr("Skin"), APPLICATION->network());
+    job->setPriority(Net::Priority::Background);
+    job->addNetAction(Net::Download::makeCached(QUrl(url), APPLICATION->metacache()->resolveEntry("skins", cacheKey(url))));
+    return job;
+}
+
+QPixmap renderFace(const QByteArray& png, int size)
+{
+    QImage texture;
+    if (!texture.loadFromData(png, "PNG"))
+        return {};
+
+    QImage face(8, 8, QImage::Format_ARGB32_Premultiplied);
+    face.fill(Qt::transparent);
+    QPainter painter(&face);
+    painter.drawImage(0, 0, texture.copy(8, 8, 8, 8));
+    painter.drawImage(0, 0, texture.copy(40, 8, 8, 8));
+    painter.end();
+    // the pixels are the point, they aren't smoothed over
+    return QPixmap::fromImage(face.scaled(size, size, Qt::KeepAspectRatio, Qt::FastTransformation));
+}
+
+QPixmap getFaceFromCache(QString url, int height, int width)
 {
-    QFile fskin(APPLICATION->metacache()->resolveEntry("skins", username + ".png")->getFullPath());
-
-    if (fskin.exists()) {
-        QPixmap skinTexture(fskin.fileName());
-        if (!skinTexture.isNull()) {
-            QPixmap skin = QPixmap(8, 8);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-            skin.fill(QColorConstants::Transparent);
-#else
-            skin.fill(QColor(0, 0, 0, 0));
-#endif
-            QPainter painter(&skin);
-            painter.drawPixmap(0, 0, skinTexture.copy(8, 8, 8, 8));
-            painter.drawPixmap(0, 0, skinTexture.copy(40, 8, 8, 8));
-            return skin.scaled(height, width, Qt::KeepAspectRatio);
-        }
-    }
-
-    return QPixmap();
+    QFile file(cachePath(url));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return renderFace(file.readAll(), std::min(height, width));
 }
 }  // namespace SkinUtils
@@ -15,8 +15,22 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QPixmap>
+#include <QString>
+
+#include "net/NetJob.h"
 
 namespace SkinUtils {
-QPixmap getFaceFromCache(QString id, int height = 64, int width = 64);
-}
+/// where the skin at `url` is cached, by its texture hash when the URL has one
+QString cachePath(const QString& url);
+/// whether the cached skin of `url` is good without asking again, a texture at its hash never changes
+bool isCachedForGood(const QString& url);
+/// a background job bringing the cached skin of `url` up to date, revalidated by its ETag
+NetJob::Ptr makeFetchJob(const QString& url);
+
+/// the face of the skin texture in `png` with its hat layer over it, `size` pixels square
+QPixmap renderFace(const QByteArray& png, int size = 64);
+/// the face of the cached skin at `url`
+QPixmap getFaceFromCache(QString url, int height = 64, int width = 64);
+}  // namespace SkinUtils
@@ -37,7 +37,9 @@
 #include "StringUtils.h"
 #include <qpair.h>
 
+#include <QMutex>
 #include <QRegularExpression>
+#include <QSet>
 #include <QUuid>
 #include <cmath>
 
@@ -212,3 +214,34 @@ QPair<QString, QString> StringUtils::splitFirst(const QString& s, const QRegular
     right = s.mid(end);
     return qMakePair(left, right);
 }
+
+namespace {
+// longer ones are descriptions and the like
+const int maxInternedLength = 256;
+// the pool only grows, past this everything is returned as it is
+const int maxInterned = 64 * 1024;
+
+QMutex s_interned_lock;
+QSet<QString> s_interned;
+}  // namespace
+
+QString StringUtils::intern(const QString& s)
+{
+    if (s.isEmpty() || s.size() > maxInternedLength)
+        return s;
+    QMutexLocker locker(&s_interned_lock);
+    if (auto it = s_interned.constFind(s); it != s_interned.constEnd())
+        return *it;
+    if (s_interned.size() < maxInterned)
+        s_interned.insert(s);
+    return s;
+}
+
+QStringList StringUtils::intern(const QStringList& list)
+{
+    QStringList interned;
+    interned.reserve(list.size());
+    for (auto const& s : list)
+        interned.append(intern(s));
+    return interned;
+}
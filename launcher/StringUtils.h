@@ -38,6 +38,7 @@
 
 #include <QPair>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <utility>
 
@@ -85,4 +86,11 @@ QPair<QString, QString> splitFirst(const QString& s, const QString& sep, Qt::Cas
 QPair<QString, QString> splitFirst(const QString& s, QChar sep, Qt::CaseSensitivity cs = Qt::CaseSensitive);
 QPair<QString, QString> splitFirst(const QString& s, const QRegularExpression& re);
 
+/**
+ * The one shared copy of `s`, for values a lot of objects repeat, like the loaders, authors and licenses of mods.
+ * Long strings are likely unique and are returned as they are. Thread safe.
+ */
+QString intern(const QString& s);
+QStringList intern(const QStringList& list);
+
 }  // namespace StringUtils
@@ -0,0 +1,174 @@
+#include "Trace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QThread>
+
+namespace Trace {
+
+namespace detail {
+std::atomic<bool> enabled = false;
+}
+
+namespace {
+// what's recorded is written out in chunks of about this size
+const qsizetype flushSize = 64 * 1024;
+
+struct Recording {
+    QMutex lock;
+    QFile file;
+    QByteArray buffer;
+    bool empty = true;
+    QElapsedTimer clock;
+    // bumped on every start, so threads name themselves again in the new file
+    int generation = 0;
+    int threads = 0;
+};
+
+Recording& recording()
+{
+    static Recording rec;
+    return rec;
+}
+
+struct ThreadId {
+    int generation = -1;
+    int id = 0;
+};
+thread_local ThreadId t_thread;
+
+void flush(Recording& rec)
+{
+    rec.file.write(rec.buffer);
+    rec.buffer.clear();
+}
+
+// with the lock held
+void append(Recording& rec, const QJsonObject& event)
+{
+    if (!rec.empty)
+        rec.buffer.append(",\n");
+    rec.empty = false;
+    rec.buffer.append(QJsonDocument(event).toJson(QJsonDocument::Compact));
+}
+
+void write(QJsonObject event)
+{
+    auto& rec = recording();
+    QMutexLocker locker(&rec.lock);
+    if (!rec.file.isOpen())
+        return;
+
+    auto pid = QCoreApplication::applicationPid();
+    if (t_thread.generation != rec.generation) {
+        t_thread = { rec.generation, ++rec.threads };
+        auto name = QThread::currentThread()->objectName();
+        if (name.isEmpty())
+            name = QString("Thread %1").arg(t_thread.id);
+        QJsonObject metadata{ { "ph", "M" }, { "name", "thread_name" }, { "pid", pid }, { "tid", t_thread.id } };
+        metadata.insert("args", QJsonObject{ { "name", name } });
+        append(rec, metadata);
+    }
+    event.insert("pid", pid);
+    event.insert("tid", t_thread.id);
+    append(rec, event);
+    if (rec.buffer.size() >= flushSize)
+        flush(rec);
+}
+
+QJsonObject makeEvent(const char* phase, const char* category, const QString& name, qint64 ts, const QJsonObject& args)
+{
+    QJsonObject e{ { "ph", phase }, { "cat", category }, { "name", name }, { "ts", ts } };
+    if (!args.isEmpty())
+        e.insert("args", args);
+    return e;
+}
+
+QString idString(const void* id)
+{
+    return QString("0x%1").arg(reinterpret_cast<quintptr>(id), 0, 16);
+}
+}  // namespace
+
+bool start(const QString& path)
+{
+    stop();
+    auto& rec = recording();
+    QMutexLocker locker(&rec.lock);
+    rec.file.setFileName(path);
+    if (!rec.file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Couldn't open the trace file" << path << ":" << rec.file.errorString();
+        return false;
+    }
+    rec.buffer = "[\n";
+    rec.empty = true;
+    rec.generation++;
+    rec.threads = 0;
+    rec.clock.start();
+    detail::enabled = true;
+    qDebug() << "Recording a trace to" << path;
+    return true;
+}
+
+void stop()
+{
+    detail::enabled = false;
+    auto& rec = recording();
+    QMutexLocker locker(&rec.lock);
+    if (!rec.file.isOpen())
+        return;
+    rec.buffer.append("\n]\n");
+    flush(rec);
+    rec.file.close();
+}
+
+qint64 now()
+{
+    auto& rec = recording();
+    return rec.clock.isValid() ? rec.clock.nsecsElapsed() / 1000 : 0;
+}
+
+void complete(const char* category, const QString& name, qint64 begin, const QJsonObject& args)
+{
+    if (!isEnabled())
+        return;
+    auto e = makeEvent("X", category, name, begin, args);
+    e.insert("dur", now() - begin);
+    write(e);
+}
+
+void asyncBegin(const char* category, const QString& name, const void* id, const QJsonObject& args)
+{
+    if (!isEnabled())
+        return;
+    auto e = makeEvent("b", category, name, now(), args);
+    e.insert("id", idString(id));
+    write(e);
+}
+
+void asyncEnd(const char* category, const QString& name, const void* id, const QJsonObject& args)
+{
+    if (!isEnabled())
+        return;
+    auto e = makeEvent("e", category, name, now(), args);
+    e.insert("id", idString(id));
+    write(e);
+}
+
+void instant(const char* category, const QString& name, const void* id, const QJsonObject& args)
+{
+    if (!isEnabled())
+        return;
+    auto e = makeEvent(id ? "n" : "i", category, name, now(), args);
+    if (id)
+        e.insert("id", idString(id));
+    else
+        e.insert("s", "t");
+    write(e);
+}
+
+}  // namespace Trace
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <atomic>
+
+/**
+ * Records what the launcher spends its time on, for chrome://tracing or Perfetto to show.
+ *
+ * Tasks, requests and file operations tell when they begin and end, and all of it goes to one file in the Chrome
+ * trace event format. Nothing is recorded until start() is called, and until then every call here only checks a flag,
+ * with TRACE_SPAN not even building the name of its span.
+ */
+namespace Trace {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool isEnabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// start recording to `path`, replacing what was there
+bool start(const QString& path);
+/// write out everything that was recorded and stop recording
+void stop();
+
+/// microseconds since the recording started
+qint64 now();
+
+/// something that ran on this thread from `begin` to now
+void complete(const char* category, const QString& name, qint64 begin, const QJsonObject& args = {});
+
+/// something that runs for a while, maybe across threads, its begin and end are matched by `id`
+void asyncBegin(const char* category, const QString& name, const void* id, const QJsonObject& args = {});
+void asyncEnd(const char* category, const QString& name, const void* id, const QJsonObject& args = {});
+
+/// something that happened at one point, to what `id` is, if it isn't null
+void instant(const char* category, const QString& name, const void* id = nullptr, const QJsonObject& args = {});
+
+/// records what runs on this thread while it lives, use TRACE_SPAN
+class Span {
+   public:
+    Span() = default;
+    Span(const char* category, QString name) : m_category(category), m_name(std::move(name)), m_begin(now()) {}
+    ~Span()
+    {
+        if (m_category)
+            complete(m_category, m_name, m_begin);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+   private:
+    const char* m_category = nullptr;
+    QString m_name;
+    qint64 m_begin = 0;
+};
+
+}  // namespace Trace
+
+/// record the rest of the scope, `name` is only evaluated while recording
+#define TRACE_SPAN(category, name) \
+    const Trace::Span traceSpan = Trace::isEnabled() ? Trace::Span(category, name) : Trace::Span()
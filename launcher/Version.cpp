@@ -10,65 +10,67 @@ Version::Version(QString str) : m_string(std::move(str))
     parse();
 }
 
-#define VERSION_OPERATOR(return_on_different)                                               \
-    bool exclude_our_sections = false;                                                      \
-    bool exclude_their_sections = false;                                                    \
-                                                                                            \
-    const auto size = qMax(m_sections.size(), other.m_sections.size());                     \
-    for (int i = 0; i < size; ++i) {                                                        \
-        Section sec1 = (i >= m_sections.size()) ? Section() : m_sections.at(i);             \
-        Section sec2 = (i >= other.m_sections.size()) ? Section() : other.m_sections.at(i); \
-                                                                                            \
-        { /* Don't include appendixes in the comparison */                                  \
-            if (sec1.isAppendix())                                                          \
-                exclude_our_sections = true;                                                \
-            if (sec2.isAppendix())                                                          \
-                exclude_their_sections = true;                                              \
-                                                                                            \
-            if (exclude_our_sections) {                                                     \
-                sec1 = Section();                                                           \
-                if (sec2.m_isNull)                                                          \
-                    break;                                                                  \
-            }                                                                               \
-                                                                                            \
-            if (exclude_their_sections) {                                                   \
-                sec2 = Section();                                                           \
-                if (sec1.m_isNull)                                                          \
-                    break;                                                                  \
-            }                                                                               \
-        }                                                                                   \
-                                                                                            \
-        if (sec1 != sec2)                                                                   \
-            return return_on_different;                                                     \
+int Version::compare(const Version& other) const
+{
+    static const Section s_null;
+
+    bool exclude_our_sections = false;
+    bool exclude_their_sections = false;
+
+    const auto size = qMax(m_sections.size(), other.m_sections.size());
+    for (int i = 0; i < size; ++i) {
+        // no copies, this runs a lot while sorting long version lists
+        const Section* sec1 = (i >= m_sections.size()) ? &s_null : &m_sections.at(i);
+        const Section* sec2 = (i >= other.m_sections.size()) ? &s_null : &other.m_sections.at(i);
+
+        { /* Don't include appendixes in the comparison */
+            if (sec1->isAppendix())
+                exclude_our_sections = true;
+            if (sec2->isAppendix())
+                exclude_their_sections = true;
+
+            if (exclude_our_sections) {
+                sec1 = &s_null;
+                if (sec2->m_isNull)
+                    break;
+            }
+
+            if (exclude_their_sections) {
+                sec2 = &s_null;
+                if (sec1->m_isNull)
+                    break;
+            }
+        }
+
+        if (*sec1 != *sec2)
+            return *sec1 < *sec2 ? -1 : 1;
     }
+    return 0;
+}
 
 bool Version::operator<(const Version& other) const
 {
-    VERSION_OPERATOR(sec1 < sec2)
-
-    return false;
+    return compare(other) < 0;
 }
 bool Version::operator==(const Version& other) const
 {
-    VERSION_OPERATOR(false)
-
-    return true;
+    return compare(other) == 0;
 }
 bool Version::operator!=(const Version& other) const
 {
-    return !operator==(other);
+    return compare(other) != 0;
 }
 bool Version::operator<=(const Version& other) const
 {
-    return *this < other || *this == other;
+    return compare(other) <= 0;
 }
 bool Version::operator>(const Version& other) const
 {
-    return !(*this <= other);
+    return compare(other) > 0;
 }
 bool Version::operator>=(const Version& other) const
 {
-    return !(*this < other);
+    return compare(other) >= 0;
 }
 
 void Version::parse()
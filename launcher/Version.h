@@ -93,6 +93,10 @@ class Version {
                 m_isNull = false;
                 m_stringPart = stringPart.toString();
             }
+
+            // asked on every comparison, worked out once
+            m_isAppendix = m_stringPart.startsWith('+');
+            m_isPreRelease = m_stringPart.startsWith('-') && m_stringPart.length() > 1;
         }
 
         explicit Section() = default;
@@ -104,8 +108,11 @@ class Version {
 
         QString m_fullString;
 
-        [[nodiscard]] inline bool isAppendix() const { return m_stringPart.startsWith('+'); }
-        [[nodiscard]] inline bool isPreRelease() const { return m_stringPart.startsWith('-') && m_stringPart.length() > 1; }
+        bool m_isAppendix = false;
+        bool m_isPreRelease = false;
+
+        [[nodiscard]] inline bool isAppendix() const { return m_isAppendix; }
+        [[nodiscard]] inline bool isPreRelease() const { return m_isPreRelease; }
 
         inline bool operator==(const Section& other) const
         {
@@ -160,4 +167,6 @@ class Version {
     QList<Section> m_sections;
 
     void parse();
+    /// -1 if less than other, 0 if equal, 1 otherwise, in a single pass over the sections
+    int compare(const Version& other) const;
 };
@@ -37,10 +37,18 @@
 #include "VersionProxyModel.h"
 #include <Version.h>
 #include <meta/VersionList.h>
+#include <QBitArray>
 #include <QPixmapCache>
 #include <QSortFilterProxyModel>
 #include "Application.h"
 
+/**
+ * Filters and sorts the version list for VersionProxyModel.
+ *
+ * What the filters look at is read from the list once and kept per row, along with which rows each filter and the
+ * search accept. Changing one filter only runs that filter again, typing more of a search only checks the rows the
+ * shorter search accepted, and the sort compares the kept sort keys instead of asking the list every time.
+ */
 class VersionFilterModel : public QSortFilterProxyModel {
     Q_OBJECT
    public:
@@ -51,29 +59,194 @@ class VersionFilterModel : public QSortFilterProxyModel {
         sort(0, Qt::DescendingOrder);
     }
 
-    bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const
+    void setSourceModel(QAbstractItemModel* source) override
+    {
+        for (auto& connection : m_connections)
+            disconnect(connection);
+        m_connections.clear();
+        m_stale = true;
+
+        // connected before the proxy itself, so the rows are known again by the time it filters them
+        if (source) {
+            auto stale = [this] { m_stale = true; };
+            m_connections << connect(source, &QAbstractItemModel::modelReset, this, stale)
+                          << connect(source, &QAbstractItemModel::rowsInserted, this, stale)
+                          << connect(source, &QAbstractItemModel::rowsRemoved, this, stale)
+                          << connect(source, &QAbstractItemModel::rowsMoved, this, stale)
+                          << connect(source, &QAbstractItemModel::layoutChanged, this, stale)
+                          << connect(source, &QAbstractItemModel::dataChanged, this,
+                                     [this](const QModelIndex& top_left, const QModelIndex& bottom_right) {
+                                         updateRows(top_left.row(), bottom_right.row());
+                                     });
+        }
+        QSortFilterProxyModel::setSourceModel(source);
+    }
+
+    bool filterAcceptsRow(int source_row, [[maybe_unused]] const QModelIndex& source_parent) const override
+    {
+        ensureRows();
+        return source_row < m_accepted.size() && m_accepted.testBit(source_row);
+    }
+
+    bool lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const override
+    {
+        ensureRows();
+        if (source_left.row() >= m_rows.size() || source_right.row() >= m_rows.size())
+            return QSortFilterProxyModel::lessThan(source_left, source_right);
+        return m_rows[source_left.row()].sortKey < m_rows[source_right.row()].sortKey;
+    }
+
+    void filterChanged(int role)
+    {
+        if (!m_stale) {
+            updateFilter(role);
+            updateAccepted();
+        }
+        invalidateFilter();
+    }
+
+    void searchChanged()
+    {
+        if (!m_stale) {
+            updateSearch();
+            updateAccepted();
+        }
+        invalidateFilter();
+    }
+
+    void filtersCleared()
     {
+        m_stale = true;
+        invalidateFilter();
+    }
+
+   private:
+    struct Row {
+        QString version;
+        qint64 sortKey = 0;
+    };
+
+    Row readRow(int row) const
+    {
+        auto idx = sourceModel()->index(row, 0);
+        return { sourceModel()->data(idx, BaseVersionList::VersionRole).toString(),
+                 sourceModel()->data(idx, BaseVersionList::SortRole).toLongLong() };
+    }
+
+    QString readValue(int row, int role) const { return sourceModel()->data(sourceModel()->index(row, 0), role).toString(); }
+
+    void ensureRows() const
+    {
+        if (!m_stale)
+            return;
+        m_stale = false;
+
+        int count = sourceModel() ? sourceModel()->rowCount() : 0;
+        m_rows.resize(count);
+        for (int i = 0; i < count; i++)
+            m_rows[i] = readRow(i);
+
+        m_values.clear();
+        m_filterAccepted.clear();
         const auto& filters = m_parent->filters();
-        const QString& search = m_parent->search();
-        const QModelIndex idx = sourceModel()->index(source_row, 0, source_parent);
+        for (auto it = filters.begin(); it != filters.end(); ++it)
+            updateFilter(it.key());
+        m_searchedFor.clear();
+        updateSearch();
+        updateAccepted();
+    }
 
-        if (!search.isEmpty() && !sourceModel()->data(idx, BaseVersionList::VersionRole).toString().contains(search, Qt::CaseInsensitive))
-            return false;
+    /// run the filter of that role on all rows again, reading its values only the first time
+    void updateFilter(int role) const
+    {
+        auto filter = m_parent->filters().value(static_cast<BaseVersionList::ModelRoles>(role));
+        if (!filter) {
+            m_values.remove(role);
+            m_filterAccepted.remove(role);
+            return;
+        }
+
+        int count = m_rows.size();
+        auto& values = m_values[role];
+        if (values.size() != count) {
+            values.resize(count);
+            for (int i = 0; i < count; i++)
+                values[i] = readValue(i, role);
+        }
+        auto& accepted = m_filterAccepted[role];
+        accepted.resize(count);
+        for (int i = 0; i < count; i++)
+            accepted.setBit(i, filter->accepts(values[i]));
+    }
 
-        for (auto it = filters.begin(); it != filters.end(); ++it) {
-            auto data = sourceModel()->data(idx, it.key());
-            auto match = data.toString();
-            if (!it.value()->accepts(match)) {
-                return false;
+    void updateSearch() const
+    {
+        const QString& search = m_parent->search();
+        int count = m_rows.size();
+        // whatever matches the longer search matches the shorter one as well
+        bool narrowing =
+            !m_searchedFor.isEmpty() && m_searchAccepted.size() == count && search.contains(m_searchedFor, Qt::CaseInsensitive);
+        if (!narrowing)
+            m_searchAccepted.fill(true, count);
+        if (!search.isEmpty()) {
+            for (int i = 0; i < count; i++) {
+                if (m_searchAccepted.testBit(i))
+                    m_searchAccepted.setBit(i, m_rows[i].version.contains(search, Qt::CaseInsensitive));
             }
         }
-        return true;
+        m_searchedFor = search;
+    }
+
+    void updateAccepted() const
+    {
+        m_accepted = m_searchAccepted;
+        for (auto& accepted : m_filterAccepted)
+            m_accepted &= accepted;
     }
 
-    void filterChanged() { invalidateFilter(); }
+    /// read changed rows again, before the proxy sorts and filters them
+    void updateRows(int first, int last)
+    {
+        if (m_stale)
+            return;
+        if (first < 0 || last >= m_rows.size()) {
+            m_stale = true;
+            return;
+        }
+
+        const auto& filters = m_parent->filters();
+        const QString& search = m_parent->search();
+        for (int i = first; i <= last; i++) {
+            m_rows[i] = readRow(i);
+            bool accepted = search.isEmpty() || m_rows[i].version.contains(search, Qt::CaseInsensitive);
+            m_searchAccepted.setBit(i, accepted);
+            for (auto it = m_values.begin(); it != m_values.end(); ++it) {
+                it.value()[i] = readValue(i, it.key());
+                auto filter = filters.value(static_cast<BaseVersionList::ModelRoles>(it.key()));
+                bool filterAccepted = filter && filter->accepts(it.value()[i]);
+                m_filterAccepted[it.key()].setBit(i, filterAccepted);
+                accepted &= filterAccepted;
+            }
+            m_accepted.setBit(i, accepted);
+        }
+    }
 
    private:
     VersionProxyModel* m_parent;
+    QList<QMetaObject::Connection> m_connections;
+
+    // everything below is read from the list when it's needed after the list changed
+    mutable bool m_stale = true;
+    mutable QVector<Row> m_rows;
+    // values of the filtered roles, by role
+    mutable QHash<int, QVector<QString>> m_values;
+    // the rows each filter accepts, by role
+    mutable QHash<int, QBitArray> m_filterAccepted;
+    // the rows the search accepts and what it was
+    mutable QBitArray m_searchAccepted;
+    mutable QString m_searchedFor;
+    // the rows everything accepts
+    mutable QBitArray m_accepted;
 };
 
 VersionProxyModel::VersionProxyModel(QObject* parent) : QAbstractProxyModel(parent)
@@ -368,19 +541,19 @@ void VersionProxyModel::clearFilters()
 {
     m_filters.clear();
     m_search.clear();
-    filterModel->filterChanged();
+    filterModel->filtersCleared();
 }
 
 void VersionProxyModel::setFilter(const BaseVersionList::ModelRoles column, Filter* f)
 {
     m_filters[column].reset(f);
-    filterModel->filterChanged();
+    filterModel->filterChanged(column);
 }
 
 void VersionProxyModel::setSearch(const QString& search)
 {
     m_search = search;
-    filterModel->filterChanged();
+    filterModel->searchChanged();
 }
 
 const VersionProxyModel::FilterMap& VersionProxyModel::filters() const
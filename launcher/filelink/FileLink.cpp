@@ -76,15 +76,13 @@ FileLinkApp::FileLinkApp(int& argc, char** argv) : QCoreApplication(argc, argv),
     QCommandLineParser parser;
     parser.setApplicationDescription(QObject::tr("a batch MKLINK program for windows to be used with prismlauncher"));
 
-    parser.addOptions({ { { "s", "server" }, "Join the specified server on launch", "pipe name" },
-                        { { "H", "hard" }, "use hard links instead of symbolic", "true/false" } });
+    parser.addOptions({ { { "s", "server" }, "Join the specified server on launch", "pipe name" } });
     parser.addHelpOption();
     parser.addVersionOption();
 
     parser.process(arguments());
 
     QString serverToJoin = parser.value("server");
-    m_useHardLinks = QVariant(parser.value("hard")).toBool();
 
     qDebug() << "link program launched";
 
@@ -100,13 +98,9 @@ FileLinkApp::FileLinkApp(int& argc, char** argv) : QCoreApplication(argc, argv),
 
 void FileLinkApp::joinServer(QString server)
 {
-    blockSize = 0;
-
-    in.setDevice(&socket);
-
     connect(&socket, &QLocalSocket::connected, this, [&]() { qDebug() << "connected to server"; });
 
-    connect(&socket, &QLocalSocket::readyRead, this, &FileLinkApp::readPathPairs);
+    connect(&socket, &QLocalSocket::readyRead, this, &FileLinkApp::readJobs);
 
     connect(&socket, &QLocalSocket::errorOccurred, this, [&](QLocalSocket::LocalSocketError socketError) {
         m_status = Failed;
@@ -141,107 +135,52 @@ void FileLinkApp::joinServer(QString server)
     socket.connectToServer(server);
 }
 
-void FileLinkApp::runLink()
+FS::LinkProtocol::Result FileLinkApp::runLinks(const FS::LinkProtocol::Job& job)
 {
-    std::error_code os_err;
-
-    qDebug() << "creating links";
-
-    for (auto link : m_links_to_make) {
-        QString src_path = link.src;
-        QString dst_path = link.dst;
-
-        FS::ensureFilePathExists(dst_path);
-        if (m_useHardLinks) {
-            qDebug() << "making hard link:" << src_path << "to" << dst_path;
-            fs::create_hard_link(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), os_err);
-        } else if (fs::is_directory(StringUtils::toStdString(src_path))) {
-            qDebug() << "making directory_symlink:" << src_path << "to" << dst_path;
-            fs::create_directory_symlink(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), os_err);
+    FS::LinkProtocol::Result result;
+    result.id = job.id;
+    result.errValues.reserve(job.links.size());
+
+    qDebug() << "creating" << job.links.size() << (job.useHardLinks ? "hard links" : "symlinks");
+
+    for (auto& link : job.links) {
+        std::error_code os_err;
+        auto src_path = StringUtils::toStdString(link.src);
+        auto dst_path = StringUtils::toStdString(link.dst);
+
+        FS::ensureFilePathExists(link.dst);
+        if (job.useHardLinks) {
+            fs::create_hard_link(src_path, dst_path, os_err);
+        } else if (fs::is_directory(src_path)) {
+            fs::create_directory_symlink(src_path, dst_path, os_err);
         } else {
-            qDebug() << "making symlink:" << src_path << "to" << dst_path;
-            fs::create_symlink(StringUtils::toStdString(src_path), StringUtils::toStdString(dst_path), os_err);
+            fs::create_symlink(src_path, dst_path, os_err);
         }
 
         if (os_err) {
             qWarning() << "Failed to link files:" << QString::fromStdString(os_err.message());
-            qDebug() << "Source file:" << src_path;
-            qDebug() << "Destination file:" << dst_path;
+            qDebug() << "Source file:" << link.src;
+            qDebug() << "Destination file:" << link.dst;
             qDebug() << "Error category:" << os_err.category().name();
             qDebug() << "Error code:" << os_err.value();
-
-            FS::LinkResult result = { src_path, dst_path, QString::fromStdString(os_err.message()), os_err.value() };
-            m_path_results.append(result);
-        } else {
-            FS::LinkResult result = { src_path, dst_path, "", 0 };
-            m_path_results.append(result);
+            result.errMessages.insert(result.errValues.size(), QString::fromStdString(os_err.message()));
         }
+        result.errValues.append(os_err.value());
     }
-
-    sendResults();
-    qDebug() << "done, should exit soon";
+    return result;
 }
 
-void FileLinkApp::sendResults()
+void FileLinkApp::readJobs()
 {
-    // construct block of data to send
-    QByteArray block;
-    QDataStream out(&block, QIODevice::WriteOnly);
-
-    qint32 blocksize = quint32(sizeof(quint32));
-    for (auto result : m_path_results) {
-        blocksize += quint32(result.src.size());
-        blocksize += quint32(result.dst.size());
-        blocksize += quint32(result.err_msg.size());
-        blocksize += quint32(sizeof(quint32));
-    }
-    qDebug() << "About to write block of size:" << blocksize;
-    out << blocksize;
-
-    out << quint32(m_path_results.length());
-    for (auto result : m_path_results) {
-        out << result.src;
-        out << result.dst;
-        out << result.err_msg;
-        out << quint32(result.err_value);
-    }
-
-    qint64 byteswritten = socket.write(block);
-    bool bytesflushed = socket.flush();
-    qDebug() << "block flushed" << byteswritten << bytesflushed;
-}
+    m_buffer.append(socket.readAll());
 
-void FileLinkApp::readPathPairs()
-{
-    m_links_to_make.clear();
-    qDebug() << "Reading path pairs from server";
-    qDebug() << "bytes available" << socket.bytesAvailable();
-    if (blockSize == 0) {
-        // Relies on the fact that QDataStream serializes a quint32 into
-        // sizeof(quint32) bytes
-        if (socket.bytesAvailable() < (int)sizeof(quint32))
-            return;
-        qDebug() << "reading block size";
-        in >> blockSize;
-    }
-    qDebug() << "blocksize is" << blockSize;
-    qDebug() << "bytes available" << socket.bytesAvailable();
-    if (socket.bytesAvailable() < blockSize || in.atEnd())
-        return;
-
-    quint32 numLinks;
-    in >> numLinks;
-    qDebug() << "numLinks" << numLinks;
-
-    for (quint32 i = 0; i < numLinks; i++) {
-        FS::LinkPair pair;
-        in >> pair.src;
-        in >> pair.dst;
-        qDebug() << "link" << pair.src << "to" << pair.dst;
-        m_links_to_make.append(pair);
+    // answer every job that arrived in full, the launcher may send more later
+    QByteArray message;
+    while (FS::LinkProtocol::takeMessage(m_buffer, message)) {
+        auto job = FS::LinkProtocol::readJob(message);
+        socket.write(FS::LinkProtocol::message(runLinks(job)));
     }
-
-    runLink();
+    socket.flush();
 }
 
 FileLinkApp::~FileLinkApp()
@@ -48,21 +48,15 @@ class FileLinkApp : public QCoreApplication {
 
    private:
     void joinServer(QString server);
-    void readPathPairs();
-    void runLink();
-    void sendResults();
+    void readJobs();
+    FS::LinkProtocol::Result runLinks(const FS::LinkProtocol::Job& job);
 
     Status m_status = Status::Starting;
 
-    bool m_useHardLinks = false;
-
     QDateTime m_startTime;
     QLocalSocket socket;
-    QDataStream in;
-    quint32 blockSize;
-
-    QList<FS::LinkPair> m_links_to_make;
-    QList<FS::LinkResult> m_path_results;
+    // what arrived from the launcher and isn't a whole job yet
+    QByteArray m_buffer;
 
 #if defined Q_OS_WIN32
     // used on Windows to attach the standard IO streams
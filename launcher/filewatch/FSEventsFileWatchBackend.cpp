@@ -0,0 +1,124 @@
+#include "FSEventsFileWatchBackend.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+// how long the system collects events before telling about them, in seconds
+static constexpr CFTimeInterval latency = 0.2;
+
+FSEventsFileWatchBackend::FSEventsFileWatchBackend(QObject* parent) : FileWatchBackend(parent) {}
+
+FSEventsFileWatchBackend::~FSEventsFileWatchBackend()
+{
+    stop();
+}
+
+bool FSEventsFileWatchBackend::watch(const QDir& root, bool watchFiles)
+{
+    stop();
+    m_root = root.absolutePath();
+    // events come with the real paths, like /private/var for /var
+    m_canonicalRoot = QFileInfo(m_root).canonicalFilePath();
+    m_watchFiles = watchFiles;
+
+    auto path =
+        CFStringCreateWithCString(kCFAllocatorDefault, QFile::encodeName(m_canonicalRoot).constData(), kCFStringEncodingUTF8);
+    auto paths = CFArrayCreate(kCFAllocatorDefault, reinterpret_cast<const void**>(&path), 1, &kCFTypeArrayCallBacks);
+    FSEventStreamContext context = { 0, this, nullptr, nullptr, nullptr };
+    FSEventStreamCreateFlags flags = kFSEventStreamCreateFlagNoDefer | kFSEventStreamCreateFlagWatchRoot;
+    // only file events tell which file was written to
+    if (watchFiles)
+        flags |= kFSEventStreamCreateFlagFileEvents;
+    m_stream = FSEventStreamCreate(kCFAllocatorDefault, &FSEventsFileWatchBackend::callback, &context, paths,
+                                   kFSEventStreamEventIdSinceNow, latency, flags);
+    CFRelease(paths);
+    CFRelease(path);
+    if (!m_stream) {
+        qWarning() << "Couldn't create an FSEvents stream for" << m_root;
+        return false;
+    }
+
+    m_queue = dispatch_queue_create("org.prismlauncher.filewatch", DISPATCH_QUEUE_SERIAL);
+    FSEventStreamSetDispatchQueue(m_stream, m_queue);
+    if (!FSEventStreamStart(m_stream)) {
+        qWarning() << "Couldn't start the FSEvents stream for" << m_root;
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void FSEventsFileWatchBackend::stop()
+{
+    if (!m_stream)
+        return;
+    FSEventStreamStop(m_stream);
+    FSEventStreamInvalidate(m_stream);
+    // wait for a callback that might be running, nothing comes after it
+    dispatch_sync_f(m_queue, nullptr, [](void*) {});
+    FSEventStreamRelease(m_stream);
+    m_stream = nullptr;
+    dispatch_release(m_queue);
+    m_queue = nullptr;
+}
+
+void FSEventsFileWatchBackend::callback([[maybe_unused]] ConstFSEventStreamRef stream,
+                                        void* info,
+                                        size_t count,
+                                        void* paths,
+                                        const FSEventStreamEventFlags flags[],
+                                        [[maybe_unused]] const FSEventStreamEventId ids[])
+{
+    auto backend = static_cast<FSEventsFileWatchBackend*>(info);
+    auto eventPaths = static_cast<char**>(paths);
+    QStringList directories;
+    QStringList files;
+    for (size_t i = 0; i < count; i++) {
+        auto path = QFile::decodeName(eventPaths[i]);
+        if (path.endsWith('/'))
+            path.chop(1);
+        auto eventFlags = flags[i];
+        if (!(eventFlags & (kFSEventStreamEventFlagItemIsFile | kFSEventStreamEventFlagItemIsDir))) {
+            // not about an item, like every event without file events: the directory changed
+            directories.append(path);
+            continue;
+        }
+        if (eventFlags & kFSEventStreamEventFlagMustScanSubDirs)
+            directories.append(path);
+        if (eventFlags & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRemoved | kFSEventStreamEventFlagItemRenamed))
+            directories.append(QFileInfo(path).absolutePath());
+        if ((eventFlags & kFSEventStreamEventFlagItemIsFile) && (eventFlags & kFSEventStreamEventFlagItemModified))
+            files.append(path);
+    }
+    // still on the queue of the stream
+    QMetaObject::invokeMethod(backend, [backend, directories, files] { backend->changed(directories, files); }, Qt::QueuedConnection);
+}
+
+QString FSEventsFileWatchBackend::underRoot(const QString& path) const
+{
+    if (path == m_canonicalRoot)
+        return m_root;
+    if (path.startsWith(m_canonicalRoot + '/'))
+        return m_root + path.mid(m_canonicalRoot.size());
+    return QString();
+}
+
+void FSEventsFileWatchBackend::changed(const QStringList& directories, const QStringList& files)
+{
+    // what was queued before the stream stopped
+    if (!m_stream)
+        return;
+    for (auto& dir : directories) {
+        auto path = underRoot(dir);
+        if (!path.isEmpty())
+            emit directoryChanged(path);
+    }
+    if (!m_watchFiles)
+        return;
+    for (auto& file : files) {
+        auto path = underRoot(file);
+        if (!path.isEmpty())
+            emit fileChanged(path);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "FileWatchBackend.h"
+
+#include <CoreServices/CoreServices.h>
+#include <dispatch/dispatch.h>
+
+/**
+ * An FSEvents stream on the root, which covers the whole tree by itself.
+ *
+ * The system already batches what happens within the latency, the events come in on a queue of their own and are
+ * handed over to the GUI thread.
+ */
+class FSEventsFileWatchBackend : public FileWatchBackend {
+    Q_OBJECT
+   public:
+    explicit FSEventsFileWatchBackend(QObject* parent);
+    ~FSEventsFileWatchBackend() override;
+
+    bool watch(const QDir& root, bool watchFiles) override;
+    void stop() override;
+
+   private:
+    static void callback(ConstFSEventStreamRef stream,
+                         void* info,
+                         size_t count,
+                         void* paths,
+                         const FSEventStreamEventFlags flags[],
+                         const FSEventStreamEventId ids[]);
+    void changed(const QStringList& directories, const QStringList& files);
+    /// the path as it is under the root that was asked for, empty if it isn't under it
+    QString underRoot(const QString& path) const;
+
+   private:
+    QString m_root;
+    QString m_canonicalRoot;
+    bool m_watchFiles = false;
+    FSEventStreamRef m_stream = nullptr;
+    dispatch_queue_t m_queue = nullptr;
+};
@@ -0,0 +1,103 @@
+#include "FileChangeBus.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDir>
+
+FileChangeBus* FileChangeBus::instance()
+{
+    static auto* bus = new FileChangeBus;
+    return bus;
+}
+
+FileChangeBus::FileChangeBus()
+{
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &FileChangeBus::directoryChanged);
+}
+
+FileChangeSubscription* FileChangeBus::subscribe(const QStringList& paths, int quietMs, QObject* parent)
+{
+    auto subscription = new FileChangeSubscription(paths, quietMs, parent);
+    for (auto& path : subscription->paths()) {
+        auto& subscribers = m_subscribers[path];
+        if (subscribers.isEmpty()) {
+            if (m_watcher.addPath(path))
+                qDebug() << "Started watching " << path;
+            else
+                qDebug() << "Failed to start watching " << path;
+        }
+        subscribers.append(subscription);
+    }
+    return subscription;
+}
+
+void FileChangeBus::unsubscribe(FileChangeSubscription* subscription)
+{
+    for (auto& path : subscription->paths()) {
+        auto it = m_subscribers.find(path);
+        if (it == m_subscribers.end())
+            continue;
+        it->removeOne(subscription);
+        if (it->isEmpty()) {
+            m_subscribers.erase(it);
+            if (m_watcher.removePath(path))
+                qDebug() << "Stopped watching " << path;
+        }
+    }
+}
+
+void FileChangeBus::directoryChanged(const QString& path)
+{
+    for (auto subscription : m_subscribers.value(path))
+        subscription->add(path);
+}
+
+FileChangeSubscription::FileChangeSubscription(const QStringList& paths, int quietMs, QObject* parent)
+    // a folder that never stops changing is still told about now and then
+    : QObject(parent), m_maxWaitMs(std::max(quietMs * 8, 2000))
+{
+    for (auto& path : paths)
+        m_paths.append(QDir(path).absolutePath());
+    m_paths.removeDuplicates();
+    m_quietTimer.setSingleShot(true);
+    m_quietTimer.setInterval(quietMs);
+    connect(&m_quietTimer, &QTimer::timeout, this, &FileChangeSubscription::flush);
+}
+
+FileChangeSubscription::~FileChangeSubscription()
+{
+    FileChangeBus::instance()->unsubscribe(this);
+}
+
+void FileChangeSubscription::add(const QString& path)
+{
+    if (m_suspended > 0 || !m_ignoring.hasExpired())
+        return;
+    if (m_pending.isEmpty())
+        m_waiting.start();
+    m_pending.insert(path);
+    if (!m_quietTimer.isActive() || m_waiting.elapsed() < m_maxWaitMs)
+        m_quietTimer.start();
+}
+
+void FileChangeSubscription::flush()
+{
+    m_quietTimer.stop();
+    if (m_pending.isEmpty())
+        return;
+    auto paths = m_pending;
+    m_pending.clear();
+    emit changed(paths);
+}
+
+void FileChangeSubscription::suspend()
+{
+    m_suspended++;
+}
+
+void FileChangeSubscription::resume()
+{
+    if (m_suspended > 0 && --m_suspended == 0)
+        m_ignoring.setRemainingTime(m_quietTimer.interval() + 250);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class FileChangeSubscription;
+
+/**
+ * Directory watches shared by everything looking at the same folders, with what changed handed out in bursts.
+ *
+ * Every subscriber picks how long its folders have to stay quiet before it hears about them, and then gets all the paths
+ * that changed in the meantime at once. Copying 200 mods in is one refresh, not one for every file.
+ *
+ * Lives on the GUI thread.
+ */
+class FileChangeBus : public QObject {
+    Q_OBJECT
+   public:
+    static FileChangeBus* instance();
+
+    /// watch the directories until the subscription is deleted, it's deleted along with the parent too
+    FileChangeSubscription* subscribe(const QStringList& paths, int quietMs, QObject* parent);
+
+   private:
+    FileChangeBus();
+
+    friend class FileChangeSubscription;
+    void unsubscribe(FileChangeSubscription* subscription);
+    void directoryChanged(const QString& path);
+
+   private:
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QList<FileChangeSubscription*>> m_subscribers;
+};
+
+/** What one consumer watches, see FileChangeBus. */
+class FileChangeSubscription : public QObject {
+    Q_OBJECT
+   public:
+    ~FileChangeSubscription() override;
+
+    QStringList paths() const { return m_paths; }
+
+    /// tell about what changed right away instead of waiting for things to quiet down
+    void flush();
+
+    /// leave out what changes from now until a moment after resume(), for changes whoever subscribed makes itself
+    void suspend();
+    void resume();
+
+   signals:
+    /// the watched directories that had something added, removed or renamed in them since the last time
+    void changed(const QSet<QString>& paths);
+
+   private:
+    friend class FileChangeBus;
+    FileChangeSubscription(const QStringList& paths, int quietMs, QObject* parent);
+    void add(const QString& path);
+
+   private:
+    QStringList m_paths;
+    QSet<QString> m_pending;
+    QTimer m_quietTimer;
+    // how long the oldest pending change has waited
+    QElapsedTimer m_waiting;
+    int m_maxWaitMs;
+    int m_suspended = 0;
+    // the watcher tells about changes a bit after they're made, until then they're still ours
+    QDeadlineTimer m_ignoring;
+};
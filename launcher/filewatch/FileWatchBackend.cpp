@@ -0,0 +1,80 @@
+#include "FileWatchBackend.h"
+
+#include <QDebug>
+#include <QFileSystemWatcher>
+
+#if defined(Q_OS_LINUX)
+#include "InotifyFileWatchBackend.h"
+#elif defined(Q_OS_WIN)
+#include "WindowsFileWatchBackend.h"
+#elif defined(Q_OS_MACOS)
+#include "FSEventsFileWatchBackend.h"
+#endif
+
+FileWatchBackend* FileWatchBackend::create(QObject* parent)
+{
+#if defined(Q_OS_LINUX)
+    return new InotifyFileWatchBackend(parent);
+#elif defined(Q_OS_WIN)
+    return new WindowsFileWatchBackend(parent);
+#elif defined(Q_OS_MACOS)
+    return new FSEventsFileWatchBackend(parent);
+#else
+    return new QtFileWatchBackend(parent);
+#endif
+}
+
+QtFileWatchBackend::QtFileWatchBackend(QObject* parent) : FileWatchBackend(parent), m_watcher(new QFileSystemWatcher(this))
+{
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &FileWatchBackend::fileChanged);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &QtFileWatchBackend::directoryChange);
+}
+
+bool QtFileWatchBackend::watch(const QDir& root, bool watchFiles)
+{
+    stop();
+    m_watchFiles = watchFiles;
+    addRecursive(root);
+    return true;
+}
+
+void QtFileWatchBackend::stop()
+{
+    if (!m_watcher->files().isEmpty())
+        m_watcher->removePaths(m_watcher->files());
+    if (!m_watcher->directories().isEmpty())
+        m_watcher->removePaths(m_watcher->directories());
+    m_watched.clear();
+}
+
+void QtFileWatchBackend::add(const QString& path)
+{
+    if (m_watched.contains(path))
+        return;
+    m_watched.insert(path);
+    m_watcher->addPath(path);
+}
+
+void QtFileWatchBackend::addRecursive(const QDir& dir)
+{
+    add(dir.absolutePath());
+    for (const QString& directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        addRecursive(dir.absoluteFilePath(directory));
+    }
+    if (m_watchFiles) {
+        for (const QFileInfo& info : dir.entryInfoList(QDir::Files)) {
+            add(info.absoluteFilePath());
+        }
+    }
+}
+
+void QtFileWatchBackend::directoryChange(const QString& path)
+{
+    // what was created since needs watching too, what's gone isn't watched anymore
+    if (QDir(path).exists()) {
+        addRecursive(QDir(path));
+    } else {
+        m_watched.remove(path);
+    }
+    emit directoryChanged(path);
+}
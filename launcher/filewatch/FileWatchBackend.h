@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QDir>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QFileSystemWatcher;
+
+/**
+ * What tells a RecursiveFileSystemWatcher about changes under its root, the native APIs where there's one for that.
+ *
+ * Events come as they are, from the GUI thread, and may repeat. Making sense of a burst of them is up to the watcher.
+ */
+class FileWatchBackend : public QObject {
+    Q_OBJECT
+   public:
+    using QObject::QObject;
+
+    /// the best backend there is on this system
+    static FileWatchBackend* create(QObject* parent);
+
+    /// watch everything under the root, including what gets created later, false if that can't be done at all
+    virtual bool watch(const QDir& root, bool watchFiles) = 0;
+    virtual void stop() = 0;
+
+   signals:
+    /// something was added to, removed from or renamed in the directory, or it went away itself
+    void directoryChanged(const QString& path);
+    /// the file was written to, only when watching files
+    void fileChanged(const QString& path);
+};
+
+/** The fallback, a QFileSystemWatcher with every directory added to it. */
+class QtFileWatchBackend : public FileWatchBackend {
+    Q_OBJECT
+   public:
+    explicit QtFileWatchBackend(QObject* parent);
+
+    bool watch(const QDir& root, bool watchFiles) override;
+    void stop() override;
+
+   private:
+    void add(const QString& path);
+    void addRecursive(const QDir& dir);
+    void directoryChange(const QString& path);
+
+   private:
+    QFileSystemWatcher* m_watcher;
+    QSet<QString> m_watched;
+    bool m_watchFiles = false;
+};
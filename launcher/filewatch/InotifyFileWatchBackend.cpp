@@ -0,0 +1,136 @@
+#include "InotifyFileWatchBackend.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSocketNotifier>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+InotifyFileWatchBackend::InotifyFileWatchBackend(QObject* parent) : FileWatchBackend(parent) {}
+
+InotifyFileWatchBackend::~InotifyFileWatchBackend()
+{
+    stop();
+}
+
+bool InotifyFileWatchBackend::watch(const QDir& root, bool watchFiles)
+{
+    stop();
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        qWarning() << "Couldn't start watching" << root.absolutePath() << "with inotify:" << std::strerror(errno);
+        return false;
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    // activated is overloaded on 5.15, with a private signal tag that can't be named
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    connect(m_notifier, SIGNAL(activated(QSocketDescriptor)), this, SLOT(readEvents()));
+#else
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(readEvents()));
+#endif
+
+    m_mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+    if (watchFiles)
+        m_mask |= IN_CLOSE_WRITE | IN_MODIFY;
+    m_warnedAboutLimit = false;
+    addRecursive(root.absolutePath());
+    return true;
+}
+
+void InotifyFileWatchBackend::stop()
+{
+    if (m_fd < 0)
+        return;
+    delete m_notifier;
+    m_notifier = nullptr;
+    // the watches go with it
+    ::close(m_fd);
+    m_fd = -1;
+    m_paths.clear();
+    m_watches.clear();
+}
+
+void InotifyFileWatchBackend::addRecursive(const QString& path)
+{
+    QStringList pending{ path };
+    while (!pending.isEmpty()) {
+        auto dir = pending.takeLast();
+        if (!m_watches.contains(dir)) {
+            int wd = inotify_add_watch(m_fd, QFile::encodeName(dir).constData(), m_mask);
+            if (wd < 0) {
+                if (errno == ENOSPC && !m_warnedAboutLimit) {
+                    qWarning() << "Out of inotify watches, changes under" << dir
+                               << "won't be noticed. Raising fs.inotify.max_user_watches helps.";
+                    m_warnedAboutLimit = true;
+                }
+                continue;
+            }
+            // a directory moved within the tree keeps its watch, it's only known by its new path now
+            auto old = m_paths.value(wd);
+            if (!old.isEmpty() && old != dir)
+                m_watches.remove(old);
+            m_paths.insert(wd, dir);
+            m_watches.insert(dir, wd);
+        }
+        for (auto& subdirectory : QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks))
+            pending.append(dir + '/' + subdirectory);
+    }
+}
+
+void InotifyFileWatchBackend::readEvents()
+{
+    // plenty for a burst of events, the rest is there on the next read
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    QStringList changedDirectories;
+    QStringList changedFiles;
+    while (true) {
+        auto length = ::read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+        for (char* next = buffer; next < buffer + length;) {
+            auto event = reinterpret_cast<const struct inotify_event*>(next);
+            next += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // events were lost, everything might have changed
+                for (auto& dir : m_watches.keys())
+                    changedDirectories.append(dir);
+                continue;
+            }
+            auto dir = m_paths.value(event->wd);
+            if (dir.isEmpty())
+                continue;
+            if (event->mask & IN_IGNORED) {
+                m_paths.remove(event->wd);
+                m_watches.remove(dir);
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                changedDirectories.append(dir);
+                continue;
+            }
+
+            auto name = event->len ? QFile::decodeName(event->name) : QString();
+            auto path = dir + '/' + name;
+            if (event->mask & (IN_CLOSE_WRITE | IN_MODIFY)) {
+                if (!(event->mask & IN_ISDIR))
+                    changedFiles.append(path);
+                continue;
+            }
+            if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                addRecursive(path);
+            changedDirectories.append(dir);
+        }
+    }
+    changedDirectories.removeDuplicates();
+    changedFiles.removeDuplicates();
+    for (auto& dir : changedDirectories)
+        emit directoryChanged(dir);
+    for (auto& file : changedFiles)
+        emit fileChanged(file);
+}
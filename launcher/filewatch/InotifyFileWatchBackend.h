@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QHash>
+
+#include "FileWatchBackend.h"
+
+class QSocketNotifier;
+
+/**
+ * inotify, with one watch for every directory and the events of all of them read at once.
+ *
+ * fanotify could watch a whole file system with one mark, but only with CAP_SYS_ADMIN. So every directory still takes
+ * one of the max_user_watches, just not twice like it did with QFileSystemWatcher watching files as well: changes to
+ * files are told by the watch on their directory. Running out of watches leaves the rest of the tree unwatched with a
+ * warning instead of failing.
+ */
+class InotifyFileWatchBackend : public FileWatchBackend {
+    Q_OBJECT
+   public:
+    explicit InotifyFileWatchBackend(QObject* parent);
+    ~InotifyFileWatchBackend() override;
+
+    bool watch(const QDir& root, bool watchFiles) override;
+    void stop() override;
+
+   private slots:
+    void readEvents();
+
+   private:
+    void addRecursive(const QString& path);
+
+   private:
+    int m_fd = -1;
+    QSocketNotifier* m_notifier = nullptr;
+    quint32 m_mask = 0;
+    QHash<int, QString> m_paths;
+    QHash<QString, int> m_watches;
+    bool m_warnedAboutLimit = false;
+};
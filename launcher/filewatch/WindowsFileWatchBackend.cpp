@@ -0,0 +1,127 @@
+#include "WindowsFileWatchBackend.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QWinEventNotifier>
+
+// big enough for a burst of changes, and below the 64 KiB limit of watching network shares
+static constexpr int bufferSize = 63 * 1024;
+
+WindowsFileWatchBackend::WindowsFileWatchBackend(QObject* parent) : FileWatchBackend(parent)
+{
+    ZeroMemory(&m_overlapped, sizeof(m_overlapped));
+}
+
+WindowsFileWatchBackend::~WindowsFileWatchBackend()
+{
+    stop();
+}
+
+bool WindowsFileWatchBackend::watch(const QDir& root, bool watchFiles)
+{
+    stop();
+    m_root = root.absolutePath();
+    m_watchFiles = watchFiles;
+    m_directory = CreateFileW(reinterpret_cast<const wchar_t*>(QDir::toNativeSeparators(m_root).utf16()), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_directory == INVALID_HANDLE_VALUE) {
+        qWarning() << "Couldn't open" << m_root << "for watching, error" << GetLastError();
+        return false;
+    }
+
+    ZeroMemory(&m_overlapped, sizeof(m_overlapped));
+    m_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_notifier = new QWinEventNotifier(m_overlapped.hEvent, this);
+    connect(m_notifier, &QWinEventNotifier::activated, this, &WindowsFileWatchBackend::readFinished);
+    m_buffer.resize(bufferSize);
+
+    if (!startRead()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void WindowsFileWatchBackend::stop()
+{
+    if (m_directory == INVALID_HANDLE_VALUE)
+        return;
+    // may be stopping from its own signal
+    m_notifier->setEnabled(false);
+    m_notifier->deleteLater();
+    m_notifier = nullptr;
+    // the buffer has to stay around until the read is really gone
+    if (m_reading) {
+        CancelIoEx(m_directory, &m_overlapped);
+        DWORD ignored;
+        GetOverlappedResult(m_directory, &m_overlapped, &ignored, TRUE);
+        m_reading = false;
+    }
+    CloseHandle(m_directory);
+    m_directory = INVALID_HANDLE_VALUE;
+    CloseHandle(m_overlapped.hEvent);
+    ZeroMemory(&m_overlapped, sizeof(m_overlapped));
+}
+
+bool WindowsFileWatchBackend::startRead()
+{
+    DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+    if (m_watchFiles)
+        filter |= FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+    ResetEvent(m_overlapped.hEvent);
+    if (!ReadDirectoryChangesW(m_directory, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), TRUE, filter, nullptr,
+                               &m_overlapped, nullptr)) {
+        qWarning() << "Couldn't watch" << m_root << "for changes, error" << GetLastError();
+        return false;
+    }
+    m_reading = true;
+    return true;
+}
+
+void WindowsFileWatchBackend::readFinished()
+{
+    DWORD length = 0;
+    m_reading = false;
+    if (!GetOverlappedResult(m_directory, &m_overlapped, &length, FALSE)) {
+        // the root went away
+        qWarning() << "Stopped watching" << m_root << "for changes, error" << GetLastError();
+        stop();
+        emit directoryChanged(m_root);
+        return;
+    }
+
+    QStringList changedDirectories;
+    QStringList changedFiles;
+    if (length == 0) {
+        // more happened than fit in the buffer, what exactly is lost
+        changedDirectories.append(m_root);
+    }
+    for (DWORD offset = 0; length > 0;) {
+        auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(m_buffer.constData() + offset);
+        auto relative = QString::fromWCharArray(info->FileName, static_cast<int>(info->FileNameLength / sizeof(wchar_t)));
+        auto path = m_root + '/' + QDir::fromNativeSeparators(relative);
+        if (info->Action == FILE_ACTION_MODIFIED) {
+            // directories are modified along with their contents, the contents tell on their own
+            if (m_watchFiles && !QFileInfo(path).isDir())
+                changedFiles.append(path);
+        } else {
+            changedDirectories.append(QFileInfo(path).absolutePath());
+        }
+        if (info->NextEntryOffset == 0)
+            break;
+        offset += info->NextEntryOffset;
+    }
+
+    if (!startRead()) {
+        stop();
+        changedDirectories.append(m_root);
+    }
+
+    changedDirectories.removeDuplicates();
+    changedFiles.removeDuplicates();
+    for (auto& dir : changedDirectories)
+        emit directoryChanged(dir);
+    for (auto& file : changedFiles)
+        emit fileChanged(file);
+}
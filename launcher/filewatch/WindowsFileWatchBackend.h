@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+
+#include "FileWatchBackend.h"
+
+#include <windows.h>
+
+class QWinEventNotifier;
+
+/**
+ * ReadDirectoryChangesW on the root with the whole tree watched, one handle no matter how big it is and nothing polled.
+ *
+ * The reads overlap, the system keeps collecting changes between them and QWinEventNotifier tells when there are some.
+ */
+class WindowsFileWatchBackend : public FileWatchBackend {
+    Q_OBJECT
+   public:
+    explicit WindowsFileWatchBackend(QObject* parent);
+    ~WindowsFileWatchBackend() override;
+
+    bool watch(const QDir& root, bool watchFiles) override;
+    void stop() override;
+
+   private:
+    bool startRead();
+    void readFinished();
+
+   private:
+    QString m_root;
+    bool m_watchFiles = false;
+    HANDLE m_directory = INVALID_HANDLE_VALUE;
+    OVERLAPPED m_overlapped;
+    bool m_reading = false;
+    QWinEventNotifier* m_notifier = nullptr;
+    // DWORD aligned, as ReadDirectoryChangesW wants it
+    QByteArray m_buffer;
+};
@@ -43,7 +43,10 @@
 #include <QMimeData>
 #include <QSet>
 #include <QUrl>
+
+#include <algorithm>
 #include "icons/IconUtils.h"
+#include "icons/LazyIconEngine.h"
 
 #define MAX_SIZE 1024
 
@@ -74,13 +77,6 @@ IconList::IconList(const QStringList& builtinPaths, QString path, QObject* paren
     emit iconUpdated({});
 }
 
-void IconList::sortIconList()
-{
-    qDebug() << "Sorting icon list...";
-    std::sort(icons.begin(), icons.end(), [](const MMCIcon& a, const MMCIcon& b) { return a.m_key.localeAwareCompare(b.m_key) < 0; });
-    reindex();
-}
-
 void IconList::directoryChanged(const QString& path)
 {
     QDir new_dir(path);
@@ -139,8 +135,9 @@ void IconList::directoryChanged(const QString& path)
         icons[idx].remove(IconType::FileBased);
         if (icons[idx].type() == IconType::ToBeDeleted) {
             beginRemoveRows(QModelIndex(), idx, idx);
+            name_index.remove(key);
             icons.remove(idx);
-            reindex();
+            reindex(idx);
             endRemoveRows();
         } else {
             dataChanged(index(idx), index(idx));
@@ -149,6 +146,7 @@ void IconList::directoryChanged(const QString& path)
         emit iconUpdated(key);
     }
 
+    QStringList added;
     for (auto add : to_add) {
         qDebug() << "Adding " << add;
 
@@ -161,12 +159,12 @@ void IconList::directoryChanged(const QString& path)
             key = addfile.fileName();
 
         if (addIcon(key, QString(), addfile.filePath(), IconType::FileBased)) {
-            m_watcher->addPath(add);
+            added.append(add);
             emit iconUpdated(key);
         }
     }
-
-    sortIconList();
+    if (!added.isEmpty())
+        m_watcher->addPaths(added);
 }
 
 void IconList::fileChanged(const QString& path)
@@ -176,14 +174,16 @@ void IconList::fileChanged(const QString& path)
     if (!checkfile.exists())
         return;
     QString key = checkfile.completeBaseName();
+    if (!IconUtils::isIconSuffix(checkfile.suffix()))
+        key = checkfile.fileName();
     int idx = getIconIndex(key);
     if (idx == -1)
         return;
-    QIcon icon(path);
-    if (!icon.availableSizes().size())
+    if (!LazyIconEngine::canRead(path))
         return;
 
-    icons[idx].m_images[IconType::FileBased].icon = icon;
+    // nothing is read yet, the new engine just doesn't find what was painted from the old file
+    icons[idx].m_images[IconType::FileBased].icon = QIcon(new LazyIconEngine(path));
     dataChanged(index(idx), index(idx));
     emit iconUpdated(key);
 }
@@ -340,14 +340,15 @@ bool IconList::addThemeIcon(const QString& key)
         return true;
     }
     // add a new icon
-    beginInsertRows(QModelIndex(), icons.size(), icons.size());
+    auto row = insertPosition(key);
+    beginInsertRows(QModelIndex(), row, row);
     {
         MMCIcon mmc_icon;
         mmc_icon.m_name = key;
         mmc_icon.m_key = key;
         mmc_icon.replace(Builtin, key);
-        icons.push_back(mmc_icon);
-        name_index[key] = icons.size() - 1;
+        icons.insert(row, mmc_icon);
+        reindex(row);
     }
     endInsertRows();
     return true;
@@ -356,9 +357,10 @@ bool IconList::addThemeIcon(const QString& key)
 bool IconList::addIcon(const QString& key, const QString& name, const QString& path, const IconType type)
 {
     // replace the icon even? is the input valid?
-    QIcon icon(path);
-    if (icon.isNull())
+    if (!LazyIconEngine::canRead(path))
         return false;
+    // only read once it's painted
+    QIcon icon(new LazyIconEngine(path));
     auto iter = name_index.find(key);
     if (iter != name_index.end()) {
         auto& oldOne = icons[*iter];
@@ -367,14 +369,15 @@ bool IconList::addIcon(const QString& key, const QString& name, const QString& p
         return true;
     }
     // add a new icon
-    beginInsertRows(QModelIndex(), icons.size(), icons.size());
+    auto row = insertPosition(key);
+    beginInsertRows(QModelIndex(), row, row);
     {
         MMCIcon mmc_icon;
         mmc_icon.m_name = name;
         mmc_icon.m_key = key;
         mmc_icon.replace(type, icon, path);
-        icons.push_back(mmc_icon);
-        name_index[key] = icons.size() - 1;
+        icons.insert(row, mmc_icon);
+        reindex(row);
     }
     endInsertRows();
     return true;
@@ -387,14 +390,17 @@ void IconList::saveIcon(const QString& key, const QString& path, const char* for
     pixmap.save(path, format);
 }
 
-void IconList::reindex()
+void IconList::reindex(int from)
 {
-    name_index.clear();
-    int i = 0;
-    for (auto& iter : icons) {
-        name_index[iter.m_key] = i;
-        i++;
-    }
+    for (int i = from; i < icons.size(); i++)
+        name_index[icons[i].m_key] = i;
+}
+
+int IconList::insertPosition(const QString& key) const
+{
+    auto it = std::lower_bound(icons.begin(), icons.end(), key,
+                               [](const MMCIcon& icon, const QString& key) { return icon.m_key.localeAwareCompare(key) < 0; });
+    return static_cast<int>(it - icons.begin());
 }
 
 QIcon IconList::getIcon(const QString& key) const
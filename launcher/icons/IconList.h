@@ -89,8 +89,10 @@ class IconList : public QAbstractListModel {
     IconList(const IconList&) = delete;
     // hide assign op
     IconList& operator=(const IconList&) = delete;
-    void reindex();
-    void sortIconList();
+    /// point the keys of the icons from that row on at their rows again
+    void reindex(int from = 0);
+    /// where an icon with that key goes to keep the list sorted
+    int insertPosition(const QString& key) const;
 
    public slots:
     void directoryChanged(const QString& path);
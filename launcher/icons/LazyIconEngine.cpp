@@ -0,0 +1,87 @@
+#include "LazyIconEngine.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+
+#include "MTPixmapCache.h"
+
+LazyIconEngine::LazyIconEngine(QString path) : m_path(std::move(path)), m_modified(QFileInfo(m_path).lastModified().toMSecsSinceEpoch())
+{}
+
+bool LazyIconEngine::canRead(const QString& path)
+{
+    QImageReader reader(path);
+    return reader.canRead();
+}
+
+QSize LazyIconEngine::fileSize()
+{
+    if (!m_fileSize.isValid()) {
+        QImageReader reader(m_path);
+        m_fileSize = reader.size();
+        // some formats only know once they're read, it doesn't matter for scaling down
+        if (!m_fileSize.isValid())
+            m_fileSize = QSize(0, 0);
+    }
+    return m_fileSize;
+}
+
+QSize LazyIconEngine::actualSize(const QSize& size, [[maybe_unused]] QIcon::Mode mode, [[maybe_unused]] QIcon::State state)
+{
+    auto full = fileSize();
+    if (full.isEmpty() || (full.width() <= size.width() && full.height() <= size.height()))
+        return full.isEmpty() ? size : full;
+    return full.scaled(size, Qt::KeepAspectRatio);
+}
+
+QPixmap LazyIconEngine::pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state)
+{
+    auto target = actualSize(size, mode, state);
+    auto key = QString("icon:%1:%2:%3x%4:%5").arg(m_path).arg(m_modified).arg(target.width()).arg(target.height()).arg(mode);
+    QPixmap pixmap;
+    if (PixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    QImageReader reader(m_path);
+    // SVG renders straight at the size and JPEG decodes at a fraction of it, the rest gets scaled after
+    if (reader.supportsOption(QImageIOHandler::ScaledSize))
+        reader.setScaledSize(target);
+    auto image = reader.read();
+    if (image.isNull())
+        return {};
+    if (image.size() != target)
+        image = image.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    pixmap = QPixmap::fromImage(image);
+
+    if (mode != QIcon::Normal && qobject_cast<QApplication*>(QCoreApplication::instance())) {
+        QStyleOption option;
+        option.palette = QApplication::palette();
+        pixmap = QApplication::style()->generatedIconPixmap(mode, pixmap, &option);
+    }
+    PixmapCache::insert(PixmapCache::Category::Icons, key, pixmap);
+    return pixmap;
+}
+
+void LazyIconEngine::paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state)
+{
+    // as sharp as the screen it's painted on
+    auto ratio = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    auto image = pixmap(rect.size() * ratio, mode, state);
+    if (image.isNull())
+        return;
+    image.setDevicePixelRatio(ratio);
+    auto drawn = image.size() / ratio;
+    QRect target(QPoint(), drawn);
+    target.moveCenter(rect.center());
+    painter->drawPixmap(target, image);
+}
+
+QIconEngine* LazyIconEngine::clone() const
+{
+    return new LazyIconEngine(*this);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QIconEngine>
+#include <QString>
+
+/**
+ * An icon from a file that isn't read until it's painted, and then only at the size it's painted at.
+ *
+ * What's rasterized goes to the icons category of the PixmapCache, under the path, size and modification time of the
+ * file. A changed file gets a new engine, what was made from the old one ages out of the cache.
+ */
+class LazyIconEngine : public QIconEngine {
+   public:
+    explicit LazyIconEngine(QString path);
+
+    /// whether the file looks like an image, from its header alone
+    static bool canRead(const QString& path);
+
+    void paint(QPainter* painter, const QRect& rect, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap pixmap(const QSize& size, QIcon::Mode mode, QIcon::State state) override;
+    QSize actualSize(const QSize& size, QIcon::Mode mode, QIcon::State state) override;
+    QIconEngine* clone() const override;
+    QString key() const override { return "LazyIconEngine"; }
+
+   private:
+    /// the size of the image in the file, read once
+    QSize fileSize();
+
+   private:
+    QString m_path;
+    qint64 m_modified;
+    QSize m_fileSize;
+};
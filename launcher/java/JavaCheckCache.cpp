@@ -0,0 +1,204 @@
+#include "JavaCheckCache.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "Application.h"
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+
+// installations that weren't seen for this long are dropped on save
+static constexpr qint64 maxUnusedAge = 90 * 24 * 60 * 60;
+
+// where the binary really is, so links to the same installation share an entry
+static QFileInfo binaryInfo(const QString& javaPath)
+{
+    auto resolved = FS::ResolveExecutable(javaPath);
+    if (resolved.isEmpty())
+        return {};
+    QFileInfo info(resolved);
+    auto canonical = info.canonicalFilePath();
+    return canonical.isEmpty() ? QFileInfo() : QFileInfo(canonical);
+}
+
+JavaCheckCache::JavaCheckCache(QString path) : QObject(), m_cache_file(path)
+{
+    m_saveBatchingTimer.setSingleShot(true);
+    m_saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&m_saveBatchingTimer, &QTimer::timeout, this, &JavaCheckCache::saveNow);
+}
+
+JavaCheckCache::~JavaCheckCache()
+{
+    m_saveBatchingTimer.stop();
+    saveNow();
+}
+
+JavaCheckCache* JavaCheckCache::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->javaCheckCache().get() : nullptr;
+}
+
+std::optional<JavaCheckResult> JavaCheckCache::result(const QString& javaPath)
+{
+    auto info = binaryInfo(javaPath);
+    if (!info.exists())
+        return {};
+
+    QMutexLocker locker(&m_lock);
+    auto entry = m_entries.find(info.filePath());
+    if (entry == m_entries.end())
+        return {};
+    if (entry->size != info.size() || entry->lastModified != info.lastModified().toMSecsSinceEpoch()) {
+        // updated or replaced, has to be probed again
+        m_entries.erase(entry);
+        return {};
+    }
+    entry->lastUsed = QDateTime::currentSecsSinceEpoch();
+
+    JavaCheckResult result;
+    result.path = javaPath;
+    result.validity = JavaCheckResult::Validity::Valid;
+    result.javaVersion = entry->version;
+    result.javaVendor = entry->vendor;
+    result.realPlatform = entry->arch;
+    result.is_64bit = entry->is64bit;
+    result.mojangPlatform = entry->is64bit ? "64" : "32";
+    return result;
+}
+
+void JavaCheckCache::put(const QString& javaPath, const JavaCheckResult& result)
+{
+    if (result.validity != JavaCheckResult::Validity::Valid)
+        return;
+    auto info = binaryInfo(javaPath);
+    if (!info.exists())
+        return;
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto& entry = m_entries[info.filePath()];
+        entry.size = info.size();
+        entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+        entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+        entry.version = result.javaVersion.toString();
+        entry.vendor = result.javaVendor;
+        entry.arch = result.realPlatform;
+        entry.is64bit = result.is_64bit;
+    }
+    saveEventually();
+}
+
+void JavaCheckCache::load()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QFile file(m_cache_file);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    QJsonDocument json = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+    // Fail if the JSON is invalid.
+    if (parseError.error != QJsonParseError::NoError) {
+        qCritical() << QString("Failed to parse Java check cache: %1 at offset %2")
+                           .arg(parseError.errorString(), QString::number(parseError.offset))
+                           .toUtf8();
+        return;
+    }
+
+    // Make sure the root is an object.
+    if (!json.isObject()) {
+        qCritical() << "Java check cache root should be an object.";
+        return;
+    }
+
+    auto root = json.object();
+
+    // check file version first
+    auto version_val = Json::ensureString(root, "version");
+    if (version_val != "1")
+        return;
+
+    QMutexLocker locker(&m_lock);
+    for (auto element : Json::ensureArray(root, "javas")) {
+        auto element_obj = Json::ensureObject(element);
+        auto path = Json::ensureString(element_obj, "path");
+        if (path.isEmpty())
+            continue;
+
+        Entry entry;
+        entry.size = Json::ensureDouble(element_obj, "size");
+        entry.lastModified = Json::ensureDouble(element_obj, "last_modified");
+        entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+        entry.version = Json::ensureString(element_obj, "java_version");
+        entry.vendor = Json::ensureString(element_obj, "java_vendor");
+        entry.arch = Json::ensureString(element_obj, "arch");
+        entry.is64bit = Json::ensureBoolean(element_obj, QString("is_64bit"), false);
+        if (entry.version.isEmpty())
+            continue;
+        m_entries.insert(path, entry);
+    }
+}
+
+void JavaCheckCache::saveEventually()
+{
+    // the timer lives on our thread, checks don't necessarily
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // reset the save timer
+            m_saveBatchingTimer.stop();
+            m_saveBatchingTimer.start(30000);
+        },
+        Qt::AutoConnection);
+}
+
+void JavaCheckCache::saveNow()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "1");
+
+    QJsonArray entriesArr;
+    {
+        QMutexLocker locker(&m_lock);
+        auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+        for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+            if (iter->lastUsed < oldest) {
+                iter = m_entries.erase(iter);
+                continue;
+            }
+            QJsonObject entryObj;
+            Json::writeString(entryObj, "path", iter.key());
+            entryObj.insert("size", QJsonValue(double(iter->size)));
+            entryObj.insert("last_modified", QJsonValue(double(iter->lastModified)));
+            entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+            Json::writeString(entryObj, "java_version", iter->version);
+            Json::writeString(entryObj, "java_vendor", iter->vendor);
+            Json::writeString(entryObj, "arch", iter->arch);
+            entryObj.insert("is_64bit", iter->is64bit);
+            entriesArr.append(entryObj);
+            iter++;
+        }
+    }
+    toplevel.insert("javas", entriesArr);
+
+    try {
+        Json::write(toplevel, m_cache_file);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing Java check cache:" << e.what();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+#include "JavaChecker.h"
+
+/**
+ * Persistent cache of what probing the Java installations found out, shared by the Java list and the launch checks.
+ *
+ * Results are keyed by where the binary really is, and only trusted while its size and modification time stay the
+ * same, so only new or updated installations get probed again. Only plain probes are kept, whether some arguments or
+ * heap sizes work isn't a property of the installation.
+ *
+ * All the methods are thread safe.
+ */
+class JavaCheckCache : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the cache file
+    explicit JavaCheckCache(QString path = QString());
+    ~JavaCheckCache() override;
+
+    /// the cache of the running launcher, null when there's none like in tests
+    static JavaCheckCache* shared();
+
+    /// what probing the binary found out, if it was probed before and hasn't changed since
+    std::optional<JavaCheckResult> result(const QString& javaPath);
+    /// remember a valid probe result of the binary
+    void put(const QString& javaPath, const JavaCheckResult& result);
+
+    void load();
+    // (re)start a timer that calls saveNow later, safe to call from any thread
+    void saveEventually();
+
+   public slots:
+    void saveNow();
+
+   private:
+    struct Entry {
+        // what the binary looked like when it was probed
+        qint64 size = 0;
+        qint64 lastModified = 0;
+        // last time the entry was used, in seconds since epoch
+        qint64 lastUsed = 0;
+        QString version;
+        QString arch;
+        QString vendor;
+        bool is64bit = false;
+    };
+
+   private:
+    QMutex m_lock;
+    QHash<QString, Entry> m_entries;
+    QString m_cache_file;
+    QTimer m_saveBatchingTimer;
+};
@@ -36,19 +36,99 @@
 #include "JavaChecker.h"
 
 #include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QMap>
 #include <QProcess>
 
 #include "Application.h"
 #include "Commandline.h"
 #include "FileSystem.h"
+#include "JavaCheckCache.h"
 #include "JavaUtils.h"
 
 JavaChecker::JavaChecker(QObject* parent) : QObject(parent) {}
 
+bool JavaChecker::isPlainProbe() const
+{
+    return m_args.isEmpty() && m_minMem == 0 && m_maxMem == 0 && m_permGen == 64;
+}
+
+static bool is64bitArch(const QString& arch)
+{
+    return arch == "x86_64" || arch == "amd64" || arch == "aarch64" || arch == "arm64";
+}
+
+std::optional<JavaCheckResult> JavaChecker::readReleaseFile() const
+{
+    auto binary = FS::ResolveExecutable(m_path);
+    if (binary.isEmpty())
+        return {};
+    // <java home>/bin/java
+    QDir home = QFileInfo(QFileInfo(binary).canonicalFilePath()).dir();
+    if (!home.cdUp())
+        return {};
+    QFile release(home.absoluteFilePath("release"));
+    if (!release.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+
+    // KEY="value" lines, written when the runtime was built
+    QMap<QString, QString> values;
+    while (!release.atEnd()) {
+        auto line = QString::fromUtf8(release.readLine()).trimmed();
+        auto separator = line.indexOf('=');
+        if (separator <= 0)
+            continue;
+        auto value = line.mid(separator + 1).trimmed();
+        if (value.size() >= 2 && value.startsWith('"') && value.endsWith('"'))
+            value = value.mid(1, value.size() - 2);
+        values.insert(line.left(separator), value);
+    }
+
+    auto version = values.value("JAVA_VERSION");
+    auto arch = values.value("OS_ARCH");
+    auto vendor = values.value("IMPLEMENTOR");
+    if (version.isEmpty() || arch.isEmpty() || vendor.isEmpty())
+        return {};
+
+    JavaCheckResult result;
+    result.path = m_path;
+    result.id = m_id;
+    result.validity = JavaCheckResult::Validity::Valid;
+    result.is_64bit = is64bitArch(arch);
+    result.mojangPlatform = result.is_64bit ? "64" : "32";
+    result.realPlatform = arch;
+    result.javaVersion = version;
+    result.javaVendor = vendor;
+    return result;
+}
+
+void JavaChecker::finishLater(JavaCheckResult result)
+{
+    result.path = m_path;
+    result.id = m_id;
+    QMetaObject::invokeMethod(
+        this, [this, result] { emit checkFinished(result); }, Qt::QueuedConnection);
+}
+
 void JavaChecker::performCheck()
 {
+    if (auto cache = isPlainProbe() ? JavaCheckCache::shared() : nullptr) {
+        if (auto cached = cache->result(m_path)) {
+            qDebug() << "Java checker result for" << m_path << "is known already";
+            finishLater(*cached);
+            return;
+        }
+    }
+    if (m_useReleaseFile && isPlainProbe()) {
+        if (auto released = readReleaseFile()) {
+            qDebug() << "Java checker result for" << m_path << "read from its release file";
+            finishLater(*released);
+            return;
+        }
+    }
+
     QString checkerJar = JavaUtils::getJavaCheckPath();
 
     if (checkerJar.isEmpty()) {
@@ -166,7 +246,7 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
     auto os_arch = results["os.arch"];
     auto java_version = results["java.version"];
     auto java_vendor = results["java.vendor"];
-    bool is_64 = os_arch == "x86_64" || os_arch == "amd64" || os_arch == "aarch64" || os_arch == "arm64";
+    bool is_64 = is64bitArch(os_arch);
 
     result.validity = JavaCheckResult::Validity::Valid;
     result.is_64bit = is_64;
@@ -175,6 +255,8 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
     result.javaVersion = java_version;
     result.javaVendor = java_vendor;
     qDebug() << "Java checker succeeded.";
+    if (auto cache = isPlainProbe() ? JavaCheckCache::shared() : nullptr)
+        cache->put(m_path, result);
     emit checkFinished(result);
 }
 
@@ -2,6 +2,7 @@
 #include <QProcess>
 #include <QTimer>
 #include <memory>
+#include <optional>
 
 #include "QObjectPtr.h"
 
@@ -36,10 +37,20 @@ class JavaChecker : public QObject {
     int m_minMem = 0;
     int m_maxMem = 0;
     int m_permGen = 64;
+    // answer plain probes from the release file of the runtime if it has one, without starting it
+    bool m_useReleaseFile = false;
 
    signals:
     void checkFinished(JavaCheckResult result);
 
+   private:
+    /// only probing the installation itself, what it finds out can be cached
+    bool isPlainProbe() const;
+    /// what the release file next to the binary says, if it says enough
+    std::optional<JavaCheckResult> readReleaseFile() const;
+    /// report the result later, like a probe would
+    void finishLater(JavaCheckResult result);
+
    private:
     QProcessPtr process;
     QTimer killTimer;
@@ -16,6 +16,34 @@
 #include "JavaCheckerJob.h"
 
 #include <QDebug>
+#include <QThread>
+
+#include <algorithm>
+
+JavaCheckerJob::JavaCheckerJob(QString job_name, int probes_per_core)
+    : Task(), m_job_name(job_name), m_max_running(std::max(1, QThread::idealThreadCount() * probes_per_core))
+{}
+
+bool JavaCheckerJob::addJavaCheckerAction(JavaCheckerPtr base)
+{
+    javacheckers.append(base);
+    // if this is already running, the action needs to be started as soon as possible!
+    if (isRunning()) {
+        javaresults.append(JavaCheckResult());
+        setProgress(num_finished, javacheckers.size());
+        startMore();
+    }
+    return true;
+}
+
+void JavaCheckerJob::startMore()
+{
+    while (num_started < javacheckers.size() && num_started - num_finished < m_max_running) {
+        auto checker = javacheckers.at(num_started++);
+        connect(checker.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
+        checker->performCheck();
+    }
+}
 
 void JavaCheckerJob::partFinished(JavaCheckResult result)
 {
@@ -27,15 +55,19 @@ void JavaCheckerJob::partFinished(JavaCheckResult result)
 
     if (num_finished == javacheckers.size()) {
         emitSucceeded();
+        return;
     }
+    startMore();
 }
 
 void JavaCheckerJob::executeTask()
 {
-    qDebug() << m_job_name.toLocal8Bit() << " started.";
-    for (auto iter : javacheckers) {
+    qDebug() << m_job_name.toLocal8Bit() << "started, running" << m_max_running << "checks at once.";
+    for (int i = 0; i < javacheckers.size(); i++)
         javaresults.append(JavaCheckResult());
-        connect(iter.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-        iter->performCheck();
+    if (javacheckers.isEmpty()) {
+        emitSucceeded();
+        return;
     }
+    startMore();
 }
@@ -22,24 +22,18 @@
 class JavaCheckerJob;
 using JavaCheckerJobPtr = shared_qobject_ptr<JavaCheckerJob>;
 
-// FIXME: this just seems horribly redundant
+/**
+ * Runs a bunch of Java checks in parallel, a few per core at most.
+ *
+ * With the probes running side by side, checking a lot of installations takes about as long as the slowest one.
+ */
 class JavaCheckerJob : public Task {
     Q_OBJECT
    public:
-    explicit JavaCheckerJob(QString job_name) : Task(), m_job_name(job_name){};
+    explicit JavaCheckerJob(QString job_name, int probes_per_core = 1);
     virtual ~JavaCheckerJob(){};
 
-    bool addJavaCheckerAction(JavaCheckerPtr base)
-    {
-        javacheckers.append(base);
-        // if this is already running, the action needs to be started right away!
-        if (isRunning()) {
-            setProgress(num_finished, javacheckers.size());
-            connect(base.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-            base->performCheck();
-        }
-        return true;
-    }
+    bool addJavaCheckerAction(JavaCheckerPtr base);
     QList<JavaCheckResult> getResults() { return javaresults; }
 
    private slots:
@@ -48,9 +42,15 @@ class JavaCheckerJob : public Task {
    protected:
     virtual void executeTask() override;
 
+   private:
+    /// start checks until as many as allowed are running
+    void startMore();
+
    private:
     QString m_job_name;
     QList<JavaCheckerPtr> javacheckers;
     QList<JavaCheckResult> javaresults;
     int num_finished = 0;
+    int num_started = 0;
+    int m_max_running = 1;
 };
@@ -173,6 +173,8 @@ void JavaListLoadTask::executeTask()
         auto candidate_checker = new JavaChecker();
         candidate_checker->m_path = candidate;
         candidate_checker->m_id = id;
+        // most runtimes say what they are, no need to start them all
+        candidate_checker->m_useReleaseFile = true;
         m_job->addJavaCheckerAction(JavaCheckerPtr(candidate_checker));
 
         id++;
@@ -45,6 +45,7 @@
 #include "FileSystem.h"
 #include "java/JavaInstallList.h"
 #include "java/JavaUtils.h"
+#include "java/ManagedRuntimeTask.h"
 
 #define IBUS "@im=ibus"
 
@@ -337,6 +338,7 @@ QList<QString> JavaUtils::FindJavaPaths()
     }
 
     candidates.append(getMinecraftJavaBundle());
+    candidates.append(getManagedJavaBundle());
     candidates = addJavasFromEnv(candidates);
     candidates.removeDuplicates();
     return candidates;
@@ -363,6 +365,7 @@ QList<QString> JavaUtils::FindJavaPaths()
         javas.append(systemLibraryJVMDir.absolutePath() + "/" + java + "/Contents/Commands/java");
     }
     javas.append(getMinecraftJavaBundle());
+    javas.append(getManagedJavaBundle());
     javas = addJavasFromEnv(javas);
     javas.removeDuplicates();
     return javas;
@@ -415,6 +418,7 @@ QList<QString> JavaUtils::FindJavaPaths()
     scanJavaDirs(FS::PathCombine(home, ".sdkman/candidates/java"));
 
     javas.append(getMinecraftJavaBundle());
+    javas.append(getManagedJavaBundle());
     javas = addJavasFromEnv(javas);
     javas.removeDuplicates();
     return javas;
@@ -428,6 +432,7 @@ QList<QString> JavaUtils::FindJavaPaths()
     javas.append(this->GetDefaultJava()->path);
 
     javas.append(getMinecraftJavaBundle());
+    javas.append(getManagedJavaBundle());
     return addJavasFromEnv(javas);
 }
 #endif
@@ -440,13 +445,11 @@ QString JavaUtils::getJavaCheckPath()
 QStringList getMinecraftJavaBundle()
 {
     QString partialPath;
-    QString executable = "java";
     QStringList processpaths;
 #if defined(Q_OS_OSX)
     partialPath = FS::PathCombine(QDir::homePath(), "Library/Application Support");
 #elif defined(Q_OS_WIN32)
     partialPath = QProcessEnvironment::systemEnvironment().value("LOCALAPPDATA", "");
-    executable += "w.exe";
 
     // add the microsoft store version of the launcher to the search. the current path is:
     // C:\Users\USERNAME\AppData\Local\Packages\Microsoft.4297127D64EC6_8wekyb3d8bbwe\LocalCache\Local\runtime
@@ -459,6 +462,21 @@ QStringList getMinecraftJavaBundle()
 #endif
     auto minecraftDataPath = FS::PathCombine(partialPath, ".minecraft", "runtime");
     processpaths << minecraftDataPath;
+    return findJavasInRuntimeDirs(processpaths);
+}
+
+QStringList getManagedJavaBundle()
+{
+    return findJavasInRuntimeDirs({ ManagedRuntimeTask::runtimeRoot() });
+}
+
+QStringList findJavasInRuntimeDirs(QStringList processpaths)
+{
+#if defined(Q_OS_WIN32)
+    QString executable = "javaw.exe";
+#else
+    QString executable = "java";
+#endif
 
     QStringList javas;
     while (!processpaths.isEmpty()) {
@@ -27,6 +27,10 @@
 QString stripVariableEntries(QString name, QString target, QString remove);
 QProcessEnvironment CleanEnviroment();
 QStringList getMinecraftJavaBundle();
+/// the runtimes installed by ManagedRuntimeTask
+QStringList getManagedJavaBundle();
+/// the java binaries of the runtimes below `dirs`, each found in the first folder named bin
+QStringList findJavasInRuntimeDirs(QStringList dirs);
 
 class JavaUtils : public QObject {
     Q_OBJECT
@@ -0,0 +1,121 @@
+#include "JvmTuning.h"
+
+#include <QFile>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace JvmTuning {
+
+static const uint64_t mebibyte = 1024ull * 1024ull;
+
+static int roundUp(int mib, int step)
+{
+    return (mib + step - 1) / step * step;
+}
+
+// Oracle leaves Shenandoah out of its builds, the OpenJDK builds ship it
+static bool hasShenandoah(const QString& vendor)
+{
+    static const QStringList vendors = { "Red Hat", "Adoptium", "Eclipse", "Microsoft", "Azul", "Amazon", "BellSoft", "SAP" };
+    for (auto& known : vendors) {
+        if (vendor.contains(known, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
+
+Tuning tune(const Inputs& inputs)
+{
+    int wanted;
+    auto& last = inputs.previousSession;
+    if (last.isValid()) {
+        // the live set twice over leaves the collector room to work in
+        wanted = last.peakLive * 2;
+        if (last.underPressure)
+            wanted = std::max(wanted, last.peakCommitted + last.peakCommitted / 4);
+    } else if (inputs.modded) {
+        wanted = (inputs.forgeLike ? 3072 : 2048) + 12 * inputs.modCount;
+    } else {
+        wanted = 2048;
+    }
+    wanted = std::max(wanted, 1024);
+
+    // past 16 GiB the heap only makes the collections take longer
+    int cap = inputs.is64Bit ? 16384 : 1024;
+    if (inputs.totalRam > 0)
+        cap = std::min<int64_t>(cap, inputs.totalRam / mebibyte * 3 / 4);
+    if (inputs.availableRam > 0)
+        cap = std::min<int64_t>(cap, int64_t(inputs.availableRam / mebibyte) - 512);
+    cap = std::max(cap, 1024);
+
+    Tuning out;
+    out.maxHeap = std::min(roundUp(wanted, 256), cap);
+    out.minHeap = std::min(out.maxHeap, roundUp(out.maxHeap / 2, 128));
+
+    // the concurrent collectors keep pauses short on big heaps, below that G1 does as well with less overhead
+    bool large = out.maxHeap >= 6144;
+    if (large && inputs.is64Bit && inputs.javaMajor >= 21) {
+        out.gcArguments << "-XX:+UseZGC";
+        // the generational mode is the only one from 23 on, and the switch for it is deprecated there
+        if (inputs.javaMajor < 23)
+            out.gcArguments << "-XX:+ZGenerational";
+    } else if (large && inputs.is64Bit && inputs.javaMajor >= 17 && hasShenandoah(inputs.javaVendor)) {
+        out.gcArguments << "-XX:+UseShenandoahGC";
+    } else if (inputs.javaMajor >= 8) {
+        out.gcArguments << "-XX:+UseG1GC"
+                        << "-XX:MaxGCPauseMillis=50";
+    }
+    return out;
+}
+
+QStringList gcLogArguments(const QString& path, int javaMajor)
+{
+    // unified logging came with Java 9, the older logs are laid out differently by every collector
+    if (javaMajor < 9)
+        return {};
+    // the previous file is rotated away when the game starts, so the last session is in `path` until then
+    return { QString("-Xlog:gc:file=\"%1\":none:filecount=1,filesize=4M").arg(path) };
+}
+
+static int toMiB(const QString& value, const QString& unit)
+{
+    auto number = value.toLongLong();
+    if (unit == "K")
+        return int(number / 1024);
+    if (unit == "G")
+        return int(number * 1024);
+    return int(number);
+}
+
+GcLogSummary readGcLog(const QString& path)
+{
+    GcLogSummary out;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return out;
+
+    // "512M->128M(1024M)" from G1 and Shenandoah, "1024M(17%)->208M(3%)" from ZGC
+    static const QRegularExpression s_sizes(R"((\d+)([KMG])(?:\(\d+%\))?->(\d+)([KMG])(?:\((\d+)([KMG])\))?)");
+    static const QStringList s_pressure = { "Pause Full", "Allocation Stall", "Degenerated GC", "To-space exhausted",
+                                            "Evacuation Failure" };
+    while (!file.atEnd()) {
+        auto line = QString::fromUtf8(file.readLine());
+        for (auto& marker : s_pressure) {
+            if (line.contains(marker)) {
+                out.underPressure = true;
+                break;
+            }
+        }
+        auto match = s_sizes.match(line);
+        if (!match.hasMatch())
+            continue;
+        out.peakLive = std::max(out.peakLive, toMiB(match.captured(3), match.captured(4)));
+        out.peakCommitted = std::max(out.peakCommitted, toMiB(match.captured(1), match.captured(2)));
+        if (!match.captured(5).isEmpty())
+            out.peakCommitted = std::max(out.peakCommitted, toMiB(match.captured(5), match.captured(6)));
+    }
+    return out;
+}
+
+}  // namespace JvmTuning
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+
+/**
+ * Picks the heap size and the collector for an instance when the user leaves them to the launcher.
+ *
+ * The defaults are the same for every instance, too little for a pack with hundreds of mods and too much for vanilla.
+ * This starts from what the pack loads and what the system has to spare, and once a session has been logged, from
+ * how much of the heap the game actually kept alive in it.
+ */
+namespace JvmTuning {
+
+/// what the last session's collector log says about the heap, in MiB
+struct GcLogSummary {
+    /// the most the heap held right after a collection
+    int peakLive = 0;
+    /// the largest the heap grew to
+    int peakCommitted = 0;
+    /// whether the collector ran out of room at some point: full collections, allocation stalls and the like
+    bool underPressure = false;
+
+    bool isValid() const { return peakLive > 0; }
+};
+
+struct Inputs {
+    int javaMajor = 0;
+    QString javaVendor;
+    bool is64Bit = true;
+    /// whether a mod loader is installed, and whether it's one of the Forge ones that need more to begin with
+    bool modded = false;
+    bool forgeLike = false;
+    int modCount = 0;
+    /// in bytes, 0 when it isn't known
+    uint64_t totalRam = 0;
+    uint64_t availableRam = 0;
+    GcLogSummary previousSession;
+};
+
+struct Tuning {
+    /// in MiB
+    int minHeap = 0;
+    int maxHeap = 0;
+    QStringList gcArguments;
+};
+
+Tuning tune(const Inputs& inputs);
+
+/// the arguments making Java log its collections to `path` for the next launch to learn from, none where it can't
+QStringList gcLogArguments(const QString& path, int javaMajor);
+
+/// reads a log written with gcLogArguments(), an invalid summary when there's none
+GcLogSummary readGcLog(const QString& path);
+
+}  // namespace JvmTuning
@@ -0,0 +1,193 @@
+#include "ManagedRuntimeTask.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSysInfo>
+
+#include "Application.h"
+#include "BuildConfig.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "java/JavaUtils.h"
+#include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+
+// the key Mojang lists the runtimes for this system under, empty where it has none
+static QString mojangPlatform()
+{
+    auto arch = QSysInfo::currentCpuArchitecture();
+#if defined(Q_OS_WIN)
+    if (arch == "x86_64")
+        return "windows-x64";
+    if (arch == "arm64")
+        return "windows-arm64";
+    return arch == "i386" ? "windows-x86" : QString();
+#elif defined(Q_OS_MACOS)
+    if (arch == "arm64")
+        return "mac-os-arm64";
+    return arch == "x86_64" ? "mac-os" : QString();
+#elif defined(Q_OS_LINUX)
+    if (arch == "x86_64")
+        return "linux";
+    return arch == "i386" ? "linux-i386" : QString();
+#else
+    return {};
+#endif
+}
+
+ManagedRuntimeTask::ManagedRuntimeTask(QString component) : m_component(std::move(component)) {}
+
+QString ManagedRuntimeTask::runtimeRoot()
+{
+    return FS::PathCombine(APPLICATION->dataRoot(), "java", "managed");
+}
+
+bool ManagedRuntimeTask::isManaged(const QString& path)
+{
+    auto root = QDir(runtimeRoot()).canonicalPath();
+    auto canonical = QFileInfo(path).canonicalFilePath();
+    return !root.isEmpty() && canonical.startsWith(root + '/');
+}
+
+bool ManagedRuntimeTask::abort()
+{
+    if (m_job)
+        return m_job->abort();
+    emitAborted();
+    return true;
+}
+
+void ManagedRuntimeTask::startJob(NetJob::Ptr job, void (ManagedRuntimeTask::*next)())
+{
+    m_job = job;
+    connect(m_job.get(), &NetJob::succeeded, this, next);
+    connect(m_job.get(), &NetJob::failed, this, [this](QString reason) {
+        m_job.reset();
+        emitFailed(reason);
+    });
+    connect(m_job.get(), &NetJob::aborted, this, [this] {
+        m_job.reset();
+        emitAborted();
+    });
+    connect(m_job.get(), &NetJob::progress, this, &ManagedRuntimeTask::setProgress);
+    connect(m_job.get(), &NetJob::stepProgress, this, &ManagedRuntimeTask::propagateStepProgress);
+    m_job->start();
+}
+
+void ManagedRuntimeTask::executeTask()
+{
+    if (mojangPlatform().isEmpty()) {
+        emitFailed(tr("There are no Java runtimes from Mojang for this system."));
+        return;
+    }
+
+    setStatus(tr("Looking up Java runtimes..."));
+    auto job = makeShared<NetJob>(tr("Java runtime index"), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
+    job->addNetAction(Net::ApiDownload::makeByteArray(QUrl(BuildConfig.JAVA_RUNTIMES_URL), m_response));
+    startJob(job, &ManagedRuntimeTask::indexFinished);
+}
+
+void ManagedRuntimeTask::indexFinished()
+{
+    QUrl manifestUrl;
+    QByteArray manifestSha1;
+    try {
+        auto index = Json::requireObject(Json::requireDocument(*m_response, "Java runtime index"));
+        auto versions = Json::ensureArray(Json::ensureObject(index, mojangPlatform()), m_component);
+        if (versions.isEmpty()) {
+            emitFailed(tr("There's no %1 from Mojang for this system.").arg(m_component));
+            return;
+        }
+        auto manifest = Json::requireObject(Json::requireObject(versions.first()), "manifest");
+        manifestUrl = QUrl(Json::requireString(manifest, "url"));
+        manifestSha1 = QByteArray::fromHex(Json::requireString(manifest, "sha1").toLatin1());
+        auto version = Json::ensureString(Json::ensureObject(Json::requireObject(versions.first()), "version"), "name");
+        setStatus(tr("Downloading Java %1...").arg(version));
+    } catch (const Exception& e) {
+        emitFailed(tr("Couldn't read the Java runtime index: %1").arg(e.cause()));
+        return;
+    }
+
+    m_response = std::make_shared<QByteArray>();
+    auto job = makeShared<NetJob>(tr("Java runtime manifest"), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
+    auto dl = Net::ApiDownload::makeByteArray(manifestUrl, m_response);
+    dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, manifestSha1));
+    job->addNetAction(dl);
+    startJob(job, &ManagedRuntimeTask::manifestFinished);
+}
+
+void ManagedRuntimeTask::manifestFinished()
+{
+    m_staging = FS::PathCombine(runtimeRoot(), m_component + ".staging");
+    FS::deletePath(m_staging);
+
+    // all of it in one job, the store hands out the files it has already
+    auto job = makeShared<NetJob>(tr("Java runtime %1").arg(m_component), APPLICATION->network());
+    job->setPriority(Net::Priority::LaunchCritical);
+    try {
+        auto files = Json::requireObject(Json::requireObject(Json::requireDocument(*m_response, "Java runtime manifest")), "files");
+        for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+            auto file = Json::requireObject(it.value());
+            auto path = FS::PathCombine(m_staging, it.key());
+            auto type = Json::requireString(file, "type");
+            if (type == "directory") {
+                FS::ensureFolderPathExists(path);
+            } else if (type == "link") {
+                m_links.append({ path, Json::requireString(file, "target") });
+            } else if (type == "file") {
+                auto raw = Json::requireObject(Json::requireObject(file, "downloads"), "raw");
+                auto dl = Net::ApiDownload::makeFile(QUrl(Json::requireString(raw, "url")), path);
+                dl->addValidator(
+                    new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(Json::requireString(raw, "sha1").toLatin1())));
+                job->addNetAction(dl);
+                if (Json::ensureBoolean(file, QString("executable"), false))
+                    m_executables.append(path);
+            }
+        }
+    } catch (const Exception& e) {
+        emitFailed(tr("Couldn't read the Java runtime manifest: %1").arg(e.cause()));
+        return;
+    }
+    m_response.reset();
+    startJob(job, &ManagedRuntimeTask::filesFinished);
+}
+
+void ManagedRuntimeTask::filesFinished()
+{
+    m_job.reset();
+    for (auto& path : m_executables) {
+        QFile::setPermissions(path, QFile::permissions(path) | QFileDevice::ExeOwner | QFileDevice::ExeUser | QFileDevice::ExeGroup |
+                                        QFileDevice::ExeOther);
+    }
+#if !defined(Q_OS_WIN)
+    // only the unix runtimes have links, and Windows would make shortcuts of them
+    for (auto& link : m_links) {
+        QFile::remove(link.path);
+        if (!QFile::link(link.target, link.path))
+            qWarning() << "Couldn't link" << link.path << "to" << link.target;
+    }
+#endif
+
+    // swapped in whole, a runtime that is only half there is never picked up
+    auto target = FS::PathCombine(runtimeRoot(), m_component);
+    if (QFileInfo::exists(target) && !FS::deletePath(target)) {
+        emitFailed(tr("Couldn't remove the previous %1").arg(m_component));
+        return;
+    }
+    if (!QDir().rename(m_staging, target)) {
+        emitFailed(tr("Couldn't move %1 into place").arg(m_component));
+        return;
+    }
+
+    auto javas = findJavasInRuntimeDirs({ target });
+    if (javas.isEmpty()) {
+        emitFailed(tr("The downloaded runtime has no Java binary"));
+        return;
+    }
+    m_javaPath = javas.first();
+    emitSucceeded();
+}
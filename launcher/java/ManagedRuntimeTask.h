@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+#include "net/NetJob.h"
+#include "tasks/Task.h"
+
+/**
+ * Installs one of the Java runtimes Mojang publishes for the game, file by file.
+ *
+ * Mojang lists every file of a runtime with its SHA1, so they are all downloaded at once in a single job, checked and
+ * kept in the content store. Most files are the same between versions of a runtime, and those get linked out of the
+ * store rather than downloaded again. A runtime goes into its own folder under runtimeRoot() once it's complete, where
+ * the Java list finds it and the launch checks take it for what its release file says.
+ *
+ * Adoptium only publishes whole archives, those aren't handled here.
+ */
+class ManagedRuntimeTask : public Task {
+    Q_OBJECT
+   public:
+    /// `component` is one of Mojang's, like "java-runtime-gamma"
+    explicit ManagedRuntimeTask(QString component);
+
+    /// where the managed runtimes live, a folder per component
+    static QString runtimeRoot();
+    /// whether `path` is inside a managed runtime
+    static bool isManaged(const QString& path);
+
+    /// the java binary of the runtime, once it's installed
+    QString javaPath() const { return m_javaPath; }
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void indexFinished();
+    void manifestFinished();
+    void filesFinished();
+    void startJob(NetJob::Ptr job, void (ManagedRuntimeTask::*next)());
+
+   private:
+    struct Link {
+        QString path;
+        QString target;
+    };
+
+    QString m_component;
+    QString m_javaPath;
+    QString m_staging;
+    std::shared_ptr<QByteArray> m_response = std::make_shared<QByteArray>();
+    NetJob::Ptr m_job;
+    QStringList m_executables;
+    QList<Link> m_links;
+};
@@ -0,0 +1,107 @@
+#include "CensorFilter.h"
+
+#include <algorithm>
+#include <queue>
+
+CensorFilter::CensorFilter(const QMap<QString, QString>& filter)
+{
+    m_nodes.emplace_back();
+
+    // build the trie
+    for (auto iter = filter.constBegin(); iter != filter.constEnd(); iter++) {
+        const auto& key = iter.key();
+        if (key.isEmpty()) {
+            continue;
+        }
+        int node = 0;
+        for (auto c : key) {
+            auto found = m_nodes[node].next.find(c.unicode());
+            if (found != m_nodes[node].next.end()) {
+                node = found->second;
+            } else {
+                m_nodes.emplace_back();
+                int created = static_cast<int>(m_nodes.size()) - 1;
+                m_nodes[node].next.emplace(c.unicode(), created);
+                node = created;
+            }
+        }
+        m_nodes[node].pattern = static_cast<int>(m_replacements.size());
+        m_replacements.push_back({ static_cast<int>(key.size()), iter.value() });
+    }
+
+    // breadth first over the trie to compute the fail and output links, parents always come before their children
+    std::queue<int> queue;
+    for (auto& [c, child] : m_nodes[0].next) {
+        queue.push(child);
+    }
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (auto& [c, child] : m_nodes[node].next) {
+            int fail = m_nodes[node].fail;
+            while (fail != 0 && m_nodes[fail].next.find(c) == m_nodes[fail].next.end()) {
+                fail = m_nodes[fail].fail;
+            }
+            auto found = m_nodes[fail].next.find(c);
+            m_nodes[child].fail = (found != m_nodes[fail].next.end() && found->second != child) ? found->second : 0;
+            int childFail = m_nodes[child].fail;
+            m_nodes[child].output = m_nodes[childFail].pattern != -1 ? childFail : m_nodes[childFail].output;
+            queue.push(child);
+        }
+    }
+}
+
+QString CensorFilter::apply(const QString& in) const
+{
+    if (m_replacements.empty()) {
+        return in;
+    }
+
+    struct Match {
+        int start;
+        int pattern;
+    };
+    std::vector<Match> matches;
+
+    int node = 0;
+    for (int i = 0; i < in.size(); i++) {
+        auto c = in[i].unicode();
+        while (node != 0 && m_nodes[node].next.find(c) == m_nodes[node].next.end()) {
+            node = m_nodes[node].fail;
+        }
+        auto found = m_nodes[node].next.find(c);
+        node = found != m_nodes[node].next.end() ? found->second : 0;
+
+        for (int out = m_nodes[node].pattern != -1 ? node : m_nodes[node].output; out != -1; out = m_nodes[out].output) {
+            int pattern = m_nodes[out].pattern;
+            matches.push_back({ i - m_replacements[pattern].length + 1, pattern });
+        }
+    }
+
+    // the common case, nothing to censor
+    if (matches.empty()) {
+        return in;
+    }
+
+    std::sort(matches.begin(), matches.end(), [this](const Match& a, const Match& b) {
+        if (a.start != b.start)
+            return a.start < b.start;
+        return m_replacements[a.pattern].length > m_replacements[b.pattern].length;
+    });
+
+    QString out;
+    out.reserve(in.size());
+    int pos = 0;
+    for (const auto& match : matches) {
+        // overlaps with a secret that was already replaced
+        if (match.start < pos) {
+            continue;
+        }
+        const auto& replacement = m_replacements[match.pattern];
+        out.append(in.constData() + pos, match.start - pos);
+        out.append(replacement.value);
+        pos = match.start + replacement.length;
+    }
+    out.append(in.constData() + pos, in.size() - pos);
+    return out;
+}
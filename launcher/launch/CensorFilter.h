@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Replaces a set of secrets in text with their placeholders.
+ *
+ * The secrets are compiled into an Aho-Corasick automaton, so a line is scanned once no matter how many secrets there
+ * are. Where matches overlap, the leftmost one wins, and of the ones starting at the same position the longest.
+ */
+class CensorFilter {
+   public:
+    CensorFilter() = default;
+    /// maps each secret to its replacement, empty secrets are ignored
+    explicit CensorFilter(const QMap<QString, QString>& filter);
+
+    bool isEmpty() const { return m_replacements.empty(); }
+
+    /// censor a line, a line without secrets is returned as is, without any copy
+    QString apply(const QString& in) const;
+
+   private:
+    struct Node {
+        std::unordered_map<char16_t, int> next;
+        // longest node that is a proper suffix of this one
+        int fail = 0;
+        // pattern ending at this node, or -1
+        int pattern = -1;
+        // closest node on the fail chain that ends a pattern, or -1
+        int output = -1;
+    };
+
+    struct Replacement {
+        int length;
+        QString value;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Replacement> m_replacements;
+};
@@ -0,0 +1,107 @@
+#include "JvmMetrics.h"
+
+#include <QDebug>
+#include <QTcpSocket>
+#include <QUuid>
+
+namespace {
+// an hour, at a sample per second
+const int maxSamples = 3600;
+// a line is well under a hundred bytes, more without a newline is no game of ours
+const int maxLineLength = 1024;
+}  // namespace
+
+JvmMetrics::JvmMetrics(QObject* parent) : QObject(parent), m_token(QUuid::createUuid().toByteArray(QUuid::WithoutBraces))
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &JvmMetrics::acceptConnection);
+    if (!m_server.listen(QHostAddress::LocalHost))
+        qWarning() << "Couldn't listen for the metrics of the game:" << m_server.errorString();
+}
+
+QString JvmMetrics::launchScriptLines() const
+{
+    return QString("metricsPort %1\nmetricsToken %2\n").arg(m_server.serverPort()).arg(QString::fromLatin1(m_token));
+}
+
+std::optional<JvmMetrics::Sample> JvmMetrics::parseSample(const QByteArray& line)
+{
+    auto fields = line.trimmed().split(' ');
+    if (fields.size() != 9 || fields[0] != "sample")
+        return std::nullopt;
+
+    bool ok = true;
+    auto number = [&ok](const QByteArray& field) {
+        bool fieldOk = false;
+        auto value = field.toLongLong(&fieldOk);
+        ok = ok && fieldOk;
+        return value;
+    };
+    Sample sample;
+    sample.uptimeMs = number(fields[1]);
+    sample.heapUsed = number(fields[2]);
+    sample.heapCommitted = number(fields[3]);
+    sample.heapMax = number(fields[4]);
+    sample.gcCount = number(fields[5]);
+    sample.gcTimeMs = number(fields[6]);
+    bool cpuOk = false;
+    sample.cpuLoad = fields[7].toDouble(&cpuOk);
+    sample.threads = static_cast<int>(number(fields[8]));
+    if (!ok || !cpuOk)
+        return std::nullopt;
+    return sample;
+}
+
+void JvmMetrics::acceptConnection()
+{
+    while (auto socket = m_server.nextPendingConnection()) {
+        if (m_socket) {
+            socket->deleteLater();
+            continue;
+        }
+        m_socket = socket;
+        connect(socket, &QTcpSocket::readyRead, this, &JvmMetrics::readSamples);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+            socket->deleteLater();
+            if (m_socket == socket)
+                m_socket = nullptr;
+        });
+    }
+}
+
+void JvmMetrics::hangUp()
+{
+    auto socket = m_socket;
+    m_socket = nullptr;
+    socket->abort();
+    socket->deleteLater();
+}
+
+void JvmMetrics::readSamples()
+{
+    bool added = false;
+    while (m_socket && m_socket->canReadLine()) {
+        auto line = m_socket->readLine(maxLineLength);
+        if (!m_greeted) {
+            if (line.trimmed() != "hello " + m_token) {
+                // someone else on this machine, let the game have its turn
+                hangUp();
+                return;
+            }
+            m_greeted = true;
+            // nobody else gets to report, the game is here
+            m_server.close();
+            continue;
+        }
+        if (auto sample = parseSample(line)) {
+            m_samples.append(*sample);
+            added = true;
+        }
+    }
+    if (m_socket && !m_socket->canReadLine() && m_socket->bytesAvailable() > maxLineLength)
+        hangUp();
+
+    if (m_samples.size() > maxSamples)
+        m_samples.remove(0, m_samples.size() - maxSamples);
+    if (added)
+        emit samplesAdded();
+}
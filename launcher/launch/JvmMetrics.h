@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QTcpServer>
+#include <QVector>
+
+#include <optional>
+
+class QTcpSocket;
+
+/**
+ * What the running game reports of its JVM: heap, garbage collections, CPU load and threads.
+ *
+ * The launcher part of the game connects back to the port this listens on, on the loopback interface only, and
+ * sends a line per second, a few at a time. It proves it's the game it was started for with the token of the
+ * launch script, anything else is hung up on.
+ */
+class JvmMetrics : public QObject {
+    Q_OBJECT
+   public:
+    struct Sample {
+        qint64 uptimeMs = 0;
+        qint64 heapUsed = 0;
+        qint64 heapCommitted = 0;
+        /// -1 when the heap has no limit
+        qint64 heapMax = -1;
+        /// since the game started
+        qint64 gcCount = 0;
+        qint64 gcTimeMs = 0;
+        /// the share of the whole machine the game takes, 0 to 1, or -1 when the JVM doesn't know
+        double cpuLoad = -1;
+        int threads = 0;
+    };
+
+    explicit JvmMetrics(QObject* parent = nullptr);
+
+    bool isListening() const { return m_server.isListening(); }
+    /// the lines telling the launcher part of the game where to report to
+    QString launchScriptLines() const;
+
+    /// the last hour of them, the oldest first
+    const QVector<Sample>& samples() const { return m_samples; }
+
+    /// a `sample <uptime> <heap used> <heap committed> <heap max> <collections> <collection time> <cpu load> <threads>` line
+    static std::optional<Sample> parseSample(const QByteArray& line);
+
+   signals:
+    void samplesAdded();
+
+   private:
+    void acceptConnection();
+    void readSamples();
+    void hangUp();
+
+   private:
+    QTcpServer m_server;
+    QTcpSocket* m_socket = nullptr;
+    QByteArray m_token;
+    bool m_greeted = false;
+    QVector<Sample> m_samples;
+};
@@ -0,0 +1,117 @@
+#include "LaunchCoordinator.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include "Application.h"
+
+namespace {
+// long enough for a game to get through reading its jars before the next one starts
+constexpr qint64 s_staggerMs = 3000;
+}  // namespace
+
+LaunchCoordinator::LaunchCoordinator(QObject* parent) : QObject(parent)
+{
+    m_clock.start();
+}
+
+LaunchCoordinator* LaunchCoordinator::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->launchCoordinator() : nullptr;
+}
+
+Task::Ptr LaunchCoordinator::join(const QString& key, const std::function<Task::Ptr()>& make)
+{
+    auto it = m_work.find(key);
+    if (it == m_work.end()) {
+        auto task = make();
+        it = m_work.insert(key, { task, 0 });
+        // whoever comes after it's done does the work again, what it covers may have changed meanwhile
+        connect(task.get(), &Task::finished, this, [this, key, task = task.get()] {
+            auto work = m_work.find(key);
+            if (work != m_work.end() && work->task.get() == task)
+                m_work.erase(work);
+        });
+    }
+    it->waiting++;
+    return it->task;
+}
+
+void LaunchCoordinator::leave(const QString& key)
+{
+    auto it = m_work.find(key);
+    if (it == m_work.end() || --it->waiting > 0)
+        return;
+    auto task = it->task;
+    m_work.erase(it);
+    if (task->isRunning())
+        task->abort();
+}
+
+int LaunchCoordinator::startDelay()
+{
+    auto now = m_clock.elapsed();
+    auto start = std::max(now, m_nextStart);
+    m_nextStart = start + s_staggerMs;
+    return static_cast<int>(start - now);
+}
+
+SharedWork::SharedWork(std::function<QString()> key, std::function<Task::Ptr()> make, QObject* parent)
+    : Task(parent), m_makeKey(std::move(key)), m_make(std::move(make))
+{}
+
+void SharedWork::executeTask()
+{
+    auto coordinator = LaunchCoordinator::shared();
+    m_key = coordinator ? m_makeKey() : QString();
+    m_task = m_key.isEmpty() ? m_make() : coordinator->join(m_key, m_make);
+
+    connect(m_task.get(), &Task::succeeded, this, [this] {
+        detach();
+        emitSucceeded();
+    });
+    connect(m_task.get(), &Task::failed, this, [this](QString reason) {
+        detach();
+        emitFailed(reason);
+    });
+    connect(m_task.get(), &Task::aborted, this, [this] {
+        detach();
+        emitAborted();
+    });
+    connect(m_task.get(), &Task::progress, this, &SharedWork::setProgress);
+    connect(m_task.get(), &Task::stepProgress, this, &SharedWork::propagateStepProgress);
+    connect(m_task.get(), &Task::status, this, &SharedWork::setStatus);
+    connect(m_task.get(), &Task::details, this, &SharedWork::setDetails);
+
+    // another launch may have started it already
+    if (!m_task->isRunning())
+        m_task->start();
+}
+
+bool SharedWork::abort()
+{
+    if (!m_task)
+        return true;
+    auto task = m_task;
+    bool alone = m_key.isEmpty();
+    // shared work gets aborted once no launch waits for it anymore
+    detach();
+    if (alone && task->isRunning())
+        task->abort();
+    emitAborted();
+    return true;
+}
+
+void SharedWork::detach()
+{
+    if (!m_task)
+        return;
+    disconnect(m_task.get(), nullptr, this, nullptr);
+    auto coordinator = LaunchCoordinator::shared();
+    if (!m_key.isEmpty() && coordinator && m_task->isRunning())
+        coordinator->leave(m_key);
+    m_task.reset();
+    m_key.clear();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+#include <functional>
+
+#include "tasks/Task.h"
+
+/**
+ * What launches running at the same time have in common, done once for all of them.
+ *
+ * Instances of the same pack check the same libraries and assets. The first launch to get to a piece of work runs it
+ * under a key saying what it covers, the launches after it wait for that one, so eight instances started at once
+ * don't all hash and download the same files. The games themselves are started some time apart, so they don't all
+ * read their mods and worlds at the same moment.
+ *
+ * Lives on the GUI thread.
+ */
+class LaunchCoordinator : public QObject {
+    Q_OBJECT
+   public:
+    explicit LaunchCoordinator(QObject* parent = nullptr);
+
+    /// the coordinator of the running launcher, null when there's none like in tests
+    static LaunchCoordinator* shared();
+
+    /// the task doing the work under `key`, made with `make` unless a launch is already doing it
+    Task::Ptr join(const QString& key, const std::function<Task::Ptr()>& make);
+    /// a launch no longer waits for the work under `key`, it's aborted once no launch does
+    void leave(const QString& key);
+
+    /// how long to wait before starting a game, so it starts some time after the one started before
+    int startDelay();
+
+   private:
+    struct Work {
+        Task::Ptr task;
+        int waiting = 0;
+    };
+    QHash<QString, Work> m_work;
+
+    QElapsedTimer m_clock;
+    qint64 m_nextStart = 0;
+};
+
+/**
+ * A launch's part in work it may share with other launches.
+ *
+ * The key is only asked for once the task starts, what it covers is usually known only after the components got
+ * resolved. An empty key means there's nothing to share, the work is then done for this launch alone.
+ */
+class SharedWork : public Task {
+    Q_OBJECT
+   public:
+    SharedWork(std::function<QString()> key, std::function<Task::Ptr()> make, QObject* parent = nullptr);
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void detach();
+
+   private:
+    std::function<QString()> m_makeKey;
+    std::function<Task::Ptr()> m_make;
+    QString m_key;
+    Task::Ptr m_task;
+};
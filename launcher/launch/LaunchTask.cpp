@@ -43,6 +43,8 @@
 #include <QEventLoop>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <algorithm>
+#include "FileSystem.h"
 #include "MessageLevel.h"
 #include "java/JavaChecker.h"
 #include "tasks/Task.h"
@@ -59,16 +61,37 @@ shared_qobject_ptr<LaunchTask> LaunchTask::create(InstancePtr inst)
     return proc;
 }
 
-LaunchTask::LaunchTask(InstancePtr instance) : m_instance(instance) {}
+LaunchTask::LaunchTask(InstancePtr instance) : m_instance(instance)
+{
+    // before the pipeline, it's only used from there
+    if (m_instance->settings()->get("ConsoleSessionLogs").toBool())
+        m_sessionLog = std::make_unique<SessionLogWriter>(FS::PathCombine(m_instance->getLogFileRoot(), "logs", "launcher"));
+    if (m_instance->settings()->get("CollectJvmMetrics").toBool())
+        m_metrics = std::make_unique<JvmMetrics>();
+    m_logPipeline.reset(
+        new LogPipeline([this](QStringList& lines, QVector<MessageLevel::Enum>& levels) { processLogLines(lines, levels); }));
+    connect(m_logPipeline.get(), &LogPipeline::linesReady, this, &LaunchTask::onProcessedLogLines);
+}
+
+LaunchTask::~LaunchTask()
+{
+    // stop the worker before anything it uses goes away
+    m_logPipeline.reset();
+}
 
 void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step)
 {
-    m_steps.append(step);
+    m_steps.append({ step });
+}
+
+void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step, const QList<LaunchStep*>& after)
+{
+    m_steps.append({ step, false, after });
 }
 
 void LaunchTask::prependStep(shared_qobject_ptr<LaunchStep> step)
 {
-    m_steps.prepend(step);
+    m_steps.prepend({ step });
 }
 
 void LaunchTask::executeTask()
@@ -77,46 +100,94 @@ void LaunchTask::executeTask()
     if (!m_steps.size()) {
         state = LaunchTask::Finished;
         emitSucceeded();
+        return;
     }
     state = LaunchTask::Running;
-    onStepFinished();
+    startReadySteps();
 }
 
 void LaunchTask::onReadyForLaunch()
 {
+    m_waitingStep = qobject_cast<LaunchStep*>(sender());
     state = LaunchTask::Waiting;
     emit readyForLaunch();
 }
 
-void LaunchTask::onStepFinished()
+bool LaunchTask::isDone(LaunchStep* step) const
 {
-    // initial -> just start the first step
-    if (currentStep == -1) {
-        currentStep++;
-        m_steps[currentStep]->start();
-        return;
+    for (auto const& entry : m_steps) {
+        if (entry.step.get() == step)
+            return entry.done;
     }
+    // not one of ours, nothing to wait for
+    return true;
+}
 
-    auto step = m_steps[currentStep];
-    if (step->wasSuccessful()) {
-        // end?
-        if (currentStep == m_steps.size() - 1) {
-            finalizeSteps(true, QString());
-        } else {
-            currentStep++;
-            step = m_steps[currentStep];
-            step->start();
+void LaunchTask::startReadySteps()
+{
+    // steps that finish right away get here again from within start(), the flags tell what's left
+    for (int i = 0; i < m_steps.size() && isActive(); i++) {
+        auto& entry = m_steps[i];
+        if (entry.done)
+            continue;
+        if (entry.strict) {
+            // it waits for everything before it, and everything after it waits for it
+            bool ready = std::all_of(m_steps.constBegin(), m_steps.constBegin() + i, [](const StepEntry& other) { return other.done; });
+            if (ready && !entry.started) {
+                entry.started = true;
+                entry.step->start();
+            }
+            break;
         }
-    } else {
+        auto isReady = [this](LaunchStep* dep) { return isDone(dep); };
+        if (!entry.started && std::all_of(entry.after.constBegin(), entry.after.constEnd(), isReady)) {
+            entry.started = true;
+            entry.step->start();
+        }
+    }
+}
+
+void LaunchTask::onStepFinished()
+{
+    auto step = qobject_cast<LaunchStep*>(sender());
+    // already over, what's still running only finishes now
+    if (!step || state == LaunchTask::Failed || state == LaunchTask::Finished)
+        return;
+
+    if (!step->wasSuccessful()) {
         finalizeSteps(false, step->failReason());
+        return;
+    }
+
+    bool allDone = true;
+    for (auto& entry : m_steps) {
+        if (entry.step.get() == step)
+            entry.done = true;
+        allDone = allDone && entry.done;
     }
+    if (allDone) {
+        finalizeSteps(true, QString());
+        return;
+    }
+    startReadySteps();
 }
 
 void LaunchTask::finalizeSteps(bool successful, const QString& error)
 {
-    for (auto step = currentStep; step >= 0; step--) {
-        m_steps[step]->finalize();
+    state = successful ? LaunchTask::Finished : LaunchTask::Failed;
+    for (int i = m_steps.size() - 1; i >= 0; i--) {
+        auto& entry = m_steps[i];
+        if (!entry.started)
+            continue;
+        // the ones running alongside the one that failed are of no use anymore
+        if (!entry.done && entry.step->isRunning() && entry.step->canAbort())
+            entry.step->abort();
+        entry.step->finalize();
     }
+    // make sure everything the game printed is in the log before anyone looks at it
+    m_logPipeline->flush();
+    if (m_sessionLog)
+        m_sessionLog->flush();
     if (successful) {
         emitSucceeded();
     } else {
@@ -127,30 +198,26 @@ void LaunchTask::finalizeSteps(bool successful, const QString& error)
 void LaunchTask::onProgressReportingRequested()
 {
     state = LaunchTask::Waiting;
-    emit requestProgress(m_steps[currentStep].get());
+    if (auto step = qobject_cast<LaunchStep*>(sender()))
+        emit requestProgress(step);
 }
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_censorFilter = CensorFilter(filter);
 }
 
-QString LaunchTask::censorPrivateInfo(QString in)
+QString LaunchTask::censorPrivateInfo(QString in) const
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end()) {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_censorFilter.apply(in);
 }
 
 void LaunchTask::proceed()
 {
-    if (state != LaunchTask::Waiting) {
+    if (state != LaunchTask::Waiting || !m_waitingStep) {
         return;
     }
-    m_steps[currentStep]->proceed();
+    m_waitingStep->proceed();
 }
 
 bool LaunchTask::canAbort() const
@@ -164,8 +231,8 @@ bool LaunchTask::canAbort() const
             return true;
         case LaunchTask::Running:
         case LaunchTask::Waiting: {
-            auto step = m_steps[currentStep];
-            return step->canAbort();
+            return std::all_of(m_steps.constBegin(), m_steps.constEnd(),
+                               [](const StepEntry& entry) { return !entry.started || entry.done || entry.step->canAbort(); });
         }
     }
     return false;
@@ -185,14 +252,19 @@ bool LaunchTask::abort()
         }
         case LaunchTask::Running:
         case LaunchTask::Waiting: {
-            auto step = m_steps[currentStep];
-            if (!step->canAbort()) {
+            if (!canAbort()) {
                 return false;
             }
-            if (step->abort()) {
-                state = LaunchTask::Aborted;
-                return true;
+            bool aborted = false;
+            // a step that aborts finishes, which fails the launch, so the state has to be set first
+            state = LaunchTask::Aborted;
+            for (auto const& entry : m_steps) {
+                if (entry.started && !entry.done && entry.step->abort())
+                    aborted = true;
             }
+            if (!aborted)
+                state = LaunchTask::Running;
+            return aborted;
         }
         default:
             break;
@@ -204,42 +276,61 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
 {
     if (!m_logModel) {
         m_logModel.reset(new LogModel());
-        m_logModel->setMaxLines(m_instance->getConsoleMaxLines());
+        auto maxLines = m_instance->getConsoleMaxLines();
+        // past the default limit, a preallocated ring of UTF-16 lines gets way too big
+        if (maxLines > 100000) {
+            m_logModel->setCompressedStorage(FS::PathCombine(m_instance->getLogFileRoot(), "logs"));
+        }
+        m_logModel->setMaxLines(maxLines);
         m_logModel->setStopOnOverflow(m_instance->shouldStopOnConsoleOverflow());
         // FIXME: should this really be here?
-        m_logModel->setOverflowMessage(tr("Stopped watching the game log because the log length surpassed %1 lines.\n"
-                                          "You may have to fix your mods because the game is still logging to files and"
-                                          " likely wasting harddrive space at an alarming rate!")
-                                           .arg(m_logModel->getMaxLines()));
+        auto overflowMessage = tr("Stopped watching the game log because the log length surpassed %1 lines.\n"
+                                  "You may have to fix your mods because the game is still logging to files and"
+                                  " likely wasting harddrive space at an alarming rate!")
+                                   .arg(m_logModel->getMaxLines());
+        if (m_sessionLog && m_sessionLog->isOpen())
+            overflowMessage += "\n" + tr("The whole log is still saved to %1.").arg(m_sessionLog->path());
+        m_logModel->setOverflowMessage(overflowMessage);
     }
     return m_logModel;
 }
 
 void LaunchTask::onLogLines(const QStringList& lines, MessageLevel::Enum defaultLevel)
 {
-    for (auto& line : lines) {
-        onLogLine(line, defaultLevel);
-    }
+    m_logPipeline->push(lines, defaultLevel);
 }
 
 void LaunchTask::onLogLine(QString line, MessageLevel::Enum level)
 {
-    // if the launcher part set a log level, use it
-    auto innerLevel = MessageLevel::fromLine(line);
-    if (innerLevel != MessageLevel::Unknown) {
-        level = innerLevel;
+    m_logPipeline->push({ line }, level);
+}
+
+void LaunchTask::processLogLines(QStringList& lines, QVector<MessageLevel::Enum>& levels) const
+{
+    for (int i = 0; i < lines.size(); i++) {
+        // if the launcher part set a log level, use it
+        auto innerLevel = MessageLevel::fromLine(lines[i]);
+        if (innerLevel != MessageLevel::Unknown) {
+            levels[i] = innerLevel;
+        }
     }
 
-    // If the level is still undetermined, guess level
-    if (level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown) {
-        level = m_instance->guessLevel(line, level);
+    // guess the levels that are still undetermined in one go
+    m_instance->guessLevels(lines, levels);
+
+    for (auto& line : lines) {
+        // censor private user info
+        line = censorPrivateInfo(line);
     }
 
-    // censor private user info
-    line = censorPrivateInfo(line);
+    // all of it, even what the console stops showing
+    if (m_sessionLog)
+        m_sessionLog->append(lines);
+}
 
-    auto& model = *getLogModel();
-    model.append(level, line);
+void LaunchTask::onProcessedLogLines(const QStringList& lines, const QVector<MessageLevel::Enum>& levels)
+{
+    getLogModel()->append(lines, levels);
 }
 
 void LaunchTask::emitSucceeded()
@@ -39,10 +39,14 @@
 #include <QObjectPtr.h>
 #include <QProcess>
 #include "BaseInstance.h"
+#include "CensorFilter.h"
+#include "JvmMetrics.h"
 #include "LaunchStep.h"
 #include "LogModel.h"
+#include "LogPipeline.h"
 #include "LoggedProcess.h"
 #include "MessageLevel.h"
+#include "SessionLog.h"
 
 class LaunchTask : public Task {
     Q_OBJECT
@@ -55,9 +59,12 @@ class LaunchTask : public Task {
 
    public: /* methods */
     static shared_qobject_ptr<LaunchTask> create(InstancePtr inst);
-    virtual ~LaunchTask(){};
+    virtual ~LaunchTask();
 
+    /// the step starts once every step before it is done
     void appendStep(shared_qobject_ptr<LaunchStep> step);
+    /// the step starts once `after` and the steps appended without dependencies before it are done, alongside others
+    void appendStep(shared_qobject_ptr<LaunchStep> step, const QList<LaunchStep*>& after);
     void prependStep(shared_qobject_ptr<LaunchStep> step);
     void setCensorFilter(QMap<QString, QString> filter);
 
@@ -86,10 +93,13 @@ class LaunchTask : public Task {
 
     shared_qobject_ptr<LogModel> getLogModel();
 
+    /// what the game reports of its JVM, null when the instance doesn't collect it
+    JvmMetrics* metrics() const { return m_metrics.get(); }
+
    public:
     void substituteVariables(QStringList& args) const;
     void substituteVariables(QString& cmd) const;
-    QString censorPrivateInfo(QString in);
+    QString censorPrivateInfo(QString in) const;
 
    protected: /* methods */
     virtual void emitFailed(QString reason) override;
@@ -112,15 +122,37 @@ class LaunchTask : public Task {
     void onStepFinished();
     void onProgressReportingRequested();
 
+   private slots:
+    void onProcessedLogLines(const QStringList& lines, const QVector<MessageLevel::Enum>& levels);
+
    private: /*methods */
+    /// start every step that has nothing left to wait for
+    void startReadySteps();
+    bool isDone(LaunchStep* step) const;
+    bool isActive() const { return state == LaunchTask::Running || state == LaunchTask::Waiting; }
     void finalizeSteps(bool successful, const QString& error);
+    /// strip level prefixes, guess levels and censor, runs on the log pipeline thread
+    void processLogLines(QStringList& lines, QVector<MessageLevel::Enum>& levels) const;
 
    protected: /* data */
     InstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
-    QList<shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
-    int currentStep = -1;
+    std::unique_ptr<LogPipeline> m_logPipeline;
+    // the whole game output of this launch, on disk
+    std::unique_ptr<SessionLogWriter> m_sessionLog;
+    std::unique_ptr<JvmMetrics> m_metrics;
+    struct StepEntry {
+        shared_qobject_ptr<LaunchStep> step;
+        // waits for every step before it, not just for the ones in `after`
+        bool strict = true;
+        QList<LaunchStep*> after;
+        bool started = false;
+        bool done = false;
+    };
+    QList<StepEntry> m_steps;
+    // the step that asked to wait, proceed() is for it
+    LaunchStep* m_waitingStep = nullptr;
+    CensorFilter m_censorFilter;
     State state = NotStarted;
     qint64 m_pid = -1;
 };
@@ -19,6 +19,15 @@ QVariant LogModel::data(const QModelIndex& index, int role) const
         return QVariant();
 
     auto row = index.row();
+    if (m_store) {
+        if (role == Qt::DisplayRole || role == Qt::EditRole) {
+            return m_store->line(row);
+        }
+        if (role == LevelRole) {
+            return m_store->level(row);
+        }
+        return QVariant();
+    }
     auto realRow = (row + m_firstLine) % m_maxLines;
     if (role == Qt::DisplayRole || role == Qt::EditRole) {
         return m_content[realRow].line;
@@ -35,7 +44,6 @@ void LogModel::append(MessageLevel::Enum level, QString line)
     if (m_suspended) {
         return;
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
     // overflow
     if (m_numLines == m_maxLines) {
         if (m_stopOnOverflow) {
@@ -43,20 +51,162 @@ void LogModel::append(MessageLevel::Enum level, QString line)
             return;
         }
         beginRemoveRows(QModelIndex(), 0, 0);
-        m_firstLine = (m_firstLine + 1) % m_maxLines;
-        m_numLines--;
+        dropOldest(1);
         endRemoveRows();
     } else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow) {
         level = MessageLevel::Fatal;
         line = m_overflowMessage;
     }
     beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
+    push(level, line);
+    endInsertRows();
+}
+
+void LogModel::append(const QStringList& lines, const QVector<MessageLevel::Enum>& levels)
+{
+    Q_ASSERT(lines.size() == levels.size());
+    if (m_suspended || lines.isEmpty()) {
+        return;
+    }
+    int first = 0;
+    int count = lines.size();
+    if (m_stopOnOverflow) {
+        if (m_numLines == m_maxLines) {
+            // nothing more to do, the buffer is full
+            return;
+        }
+        count = qMin(count, m_maxLines - m_numLines);
+    } else if (count > m_maxLines) {
+        // only the tail of the batch fits in the buffer anyway
+        first = count - m_maxLines;
+        count = m_maxLines;
+    }
+    // overflow, make room by dropping the oldest lines
+    int overflow = m_numLines + count - m_maxLines;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        dropOldest(overflow);
+        endRemoveRows();
+    }
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for (int i = first; i < first + count; i++) {
+        if (m_stopOnOverflow && m_numLines == m_maxLines - 1) {
+            push(MessageLevel::Fatal, m_overflowMessage);
+        } else {
+            push(levels[i], lines[i]);
+        }
+    }
     endInsertRows();
 }
 
+void LogModel::dropOldest(int count)
+{
+    if (m_store) {
+        m_store->removeFirst(count);
+    } else {
+        m_firstLine = (m_firstLine + count) % m_maxLines;
+    }
+    m_numLines -= count;
+    m_removedLines += count;
+    m_searchIndex.dropBefore(m_removedLines);
+}
+
+void LogModel::push(MessageLevel::Enum level, const QString& line)
+{
+    m_searchIndex.add(m_removedLines + m_numLines, line);
+    if (m_store) {
+        m_store->append(level, line);
+    } else {
+        auto& item = m_content[(m_firstLine + m_numLines) % m_maxLines];
+        item.level = level;
+        item.line = line;
+    }
+    m_numLines++;
+}
+
+QString LogModel::lineAt(int row) const
+{
+    return m_store ? m_store->line(row) : m_content[(m_firstLine + row) % m_maxLines].line;
+}
+
+MessageLevel::Enum LogModel::levelAt(int row) const
+{
+    return m_store ? m_store->level(row) : m_content[(m_firstLine + row) % m_maxLines].level;
+}
+
+int LogModel::find(const QString& what, int fromRow, bool reverse, quint32 levelMask) const
+{
+    if (what.isEmpty() || m_numLines == 0) {
+        return -1;
+    }
+
+    // the rows that can possibly match, as inclusive ranges in increasing order
+    QVector<QPair<int, int>> ranges;
+    std::vector<quint32> blocks;
+    if (m_searchIndex.candidateBlocks(what, blocks)) {
+        for (auto block : blocks) {
+            qint64 first = qint64(block) * LogSearchIndex::blockLines - m_removedLines;
+            qint64 last = first + LogSearchIndex::blockLines - 1;
+            first = qMax<qint64>(first, 0);
+            last = qMin<qint64>(last, m_numLines - 1);
+            if (first <= last) {
+                ranges.append({ int(first), int(last) });
+            }
+        }
+    } else {
+        ranges.append({ 0, m_numLines - 1 });
+    }
+
+    auto matches = [&](int row) {
+        return (levelMask & (1u << levelAt(row))) && lineAt(row).contains(what, Qt::CaseInsensitive);
+    };
+    if (!reverse) {
+        // everything after the starting row, then wrap around
+        for (const auto& range : ranges) {
+            for (int row = qMax(range.first, fromRow + 1); row <= range.second; row++) {
+                if (matches(row))
+                    return row;
+            }
+        }
+        for (const auto& range : ranges) {
+            for (int row = range.first; row <= qMin(range.second, fromRow); row++) {
+                if (matches(row))
+                    return row;
+            }
+        }
+    } else {
+        // everything before the starting row, then wrap around
+        for (auto range = ranges.crbegin(); range != ranges.crend(); range++) {
+            for (int row = qMin(range->second, fromRow - 1); row >= range->first; row--) {
+                if (matches(row))
+                    return row;
+            }
+        }
+        for (auto range = ranges.crbegin(); range != ranges.crend(); range++) {
+            for (int row = range->second; row >= qMax(range->first, fromRow); row--) {
+                if (matches(row))
+                    return row;
+            }
+        }
+    }
+    return -1;
+}
+
+void LogModel::setCompressedStorage(const QString& spillDir)
+{
+    if (m_store) {
+        return;
+    }
+    auto store = std::make_unique<LogStore>(spillDir);
+    for (int i = 0; i < m_numLines; i++) {
+        const auto& item = m_content[(m_firstLine + i) % m_maxLines];
+        store->append(item.level, item.line);
+    }
+    m_store = std::move(store);
+    m_content = QVector<entry>();
+    m_firstLine = 0;
+}
+
 void LogModel::suspend(bool suspend)
 {
     m_suspended = suspend;
@@ -70,8 +220,13 @@ bool LogModel::suspended()
 void LogModel::clear()
 {
     beginResetModel();
+    if (m_store) {
+        m_store->clear();
+    }
+    m_searchIndex.clear();
     m_firstLine = 0;
     m_numLines = 0;
+    m_removedLines = 0;
     endResetModel();
 }
 
@@ -80,8 +235,8 @@ QString LogModel::toPlainText()
     QString out;
     out.reserve(m_numLines * 80);
     for (int i = 0; i < m_numLines; i++) {
-        QString& line = m_content[(m_firstLine + i) % m_maxLines].line;
-        out.append(line + '\n');
+        out.append(lineAt(i));
+        out.append('\n');
     }
     out.squeeze();
     return out;
@@ -93,6 +248,16 @@ void LogModel::setMaxLines(int maxLines)
     if (maxLines == m_maxLines) {
         return;
     }
+    // the compressed store grows as needed, only drop what doesn't fit anymore
+    if (m_store) {
+        if (m_numLines > maxLines) {
+            beginRemoveRows(QModelIndex(), 0, m_numLines - maxLines - 1);
+            dropOldest(m_numLines - maxLines);
+            endRemoveRows();
+        }
+        m_maxLines = maxLines;
+        return;
+    }
     // if it all still fits in the buffer, just resize it
     if (m_firstLine + m_numLines < m_maxLines) {
         m_maxLines = maxLines;
@@ -115,7 +280,9 @@ void LogModel::setMaxLines(int maxLines)
         for (int i = 0; i < maxLines; i++) {
             newContent[i] = m_content[(m_firstLine + lead + i) % m_maxLines];
         }
-        m_numLines = m_maxLines;
+        m_numLines = maxLines;
+        m_removedLines += lead;
+        m_searchIndex.dropBefore(m_removedLines);
         m_content.swap(newContent);
         endRemoveRows();
     }
@@ -2,6 +2,9 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <memory>
+#include "LogSearchIndex.h"
+#include "LogStore.h"
 #include "MessageLevel.h"
 
 class LogModel : public QAbstractListModel {
@@ -13,6 +16,8 @@ class LogModel : public QAbstractListModel {
     QVariant data(const QModelIndex& index, int role) const;
 
     void append(MessageLevel::Enum, QString line);
+    /// append a batch of lines, one level per line, with a single row insertion
+    void append(const QStringList& lines, const QVector<MessageLevel::Enum>& levels);
     void clear();
 
     void suspend(bool suspend);
@@ -20,24 +25,47 @@ class LogModel : public QAbstractListModel {
 
     QString toPlainText();
 
+    /**
+     * find the next row containing `what`, case insensitively, starting after `fromRow` and wrapping around
+     * only rows whose level bit is set in `levelMask` are considered
+     * returns -1 if there is no such row
+     */
+    int find(const QString& what, int fromRow, bool reverse, quint32 levelMask = AllLevels) const;
+
     int getMaxLines();
     void setMaxLines(int maxLines);
     void setStopOnOverflow(bool stop);
     void setOverflowMessage(const QString& overflowMessage);
 
+    /// keep the lines compressed instead of in a preallocated ring buffer, cold lines spill to files in `spillDir`
+    void setCompressedStorage(const QString& spillDir);
+
     void setLineWrap(bool state);
     bool wrapLines() const;
 
     enum Roles { LevelRole = Qt::UserRole };
 
+    static constexpr quint32 AllLevels = ~0u;
+
    private /* types */:
     struct entry {
         MessageLevel::Enum level;
         QString line;
     };
 
+   private: /* methods */
+    void dropOldest(int count);
+    void push(MessageLevel::Enum level, const QString& line);
+    QString lineAt(int row) const;
+    MessageLevel::Enum levelAt(int row) const;
+
    private: /* data */
     QVector<entry> m_content;
+    // when set, lines live in here instead of m_content
+    std::unique_ptr<LogStore> m_store;
+    LogSearchIndex m_searchIndex;
+    // lines dropped from the front since the last clear, row + m_removedLines is a stable line id
+    qint64 m_removedLines = 0;
     int m_maxLines = 1000;
     // first line in the circular buffer
     int m_firstLine = 0;
@@ -0,0 +1,98 @@
+#include "LogPipeline.h"
+
+LogPipeline::LogPipeline(Processor processor, QObject* parent) : QObject(parent), m_processor(std::move(processor))
+{
+    // ~60 deliveries per second is plenty for a log view
+    m_deliveryTimer.setInterval(16);
+    m_deliveryTimer.setSingleShot(true);
+    connect(&m_deliveryTimer, &QTimer::timeout, this, &LogPipeline::deliver);
+
+    m_worker.reset(QThread::create([this] { work(); }));
+    m_worker->setObjectName("LogPipeline");
+    m_worker->start();
+}
+
+LogPipeline::~LogPipeline()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_wake.wakeAll();
+    }
+    m_worker->wait();
+}
+
+void LogPipeline::push(const QStringList& lines, MessageLevel::Enum level)
+{
+    if (lines.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_input.enqueue({ lines, level });
+    m_wake.wakeOne();
+}
+
+void LogPipeline::work()
+{
+    QMutexLocker locker(&m_mutex);
+    while (true) {
+        while (m_input.isEmpty() && !m_quit) {
+            m_wake.wait(&m_mutex);
+        }
+        if (m_quit) {
+            break;
+        }
+
+        auto batch = m_input.dequeue();
+        m_processing = true;
+        locker.unlock();
+
+        QVector<MessageLevel::Enum> levels(batch.lines.size(), batch.level);
+        m_processor(batch.lines, levels);
+
+        locker.relock();
+        m_processing = false;
+        bool wasEmpty = m_outLines.isEmpty();
+        m_outLines.append(batch.lines);
+        m_outLevels.append(levels);
+        if (wasEmpty) {
+            // first lines since the last delivery, schedule the next one
+            QMetaObject::invokeMethod(
+                this,
+                [this] {
+                    if (!m_deliveryTimer.isActive())
+                        m_deliveryTimer.start();
+                },
+                Qt::QueuedConnection);
+        }
+        if (m_input.isEmpty()) {
+            m_idle.wakeAll();
+        }
+    }
+}
+
+void LogPipeline::deliver()
+{
+    QStringList lines;
+    QVector<MessageLevel::Enum> levels;
+    {
+        QMutexLocker locker(&m_mutex);
+        lines.swap(m_outLines);
+        levels.swap(m_outLevels);
+    }
+    if (!lines.isEmpty()) {
+        emit linesReady(lines, levels);
+    }
+}
+
+void LogPipeline::flush()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_input.isEmpty() || m_processing) {
+            m_idle.wait(&m_mutex);
+        }
+    }
+    m_deliveryTimer.stop();
+    deliver();
+}
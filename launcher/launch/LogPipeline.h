@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <functional>
+#include <memory>
+
+#include "MessageLevel.h"
+
+/**
+ * Moves log processing off the thread that produces the lines.
+ *
+ * Lines are pushed from the producer thread, handed to the processor on a dedicated worker thread, and the processed
+ * lines are coalesced and delivered back, on the thread the pipeline lives in, at most once per delivery interval.
+ * Batches keep their order and no line is ever dropped.
+ */
+class LogPipeline : public QObject {
+    Q_OBJECT
+   public:
+    /// runs on the worker thread, may modify the lines and their levels in place
+    using Processor = std::function<void(QStringList& lines, QVector<MessageLevel::Enum>& levels)>;
+
+    explicit LogPipeline(Processor processor, QObject* parent = nullptr);
+    virtual ~LogPipeline();
+
+    /// queue lines for processing, safe to call from any thread
+    void push(const QStringList& lines, MessageLevel::Enum level);
+
+    /// wait for everything that was pushed so far to be processed and deliver it right away
+    void flush();
+
+    void setDeliveryInterval(int msec) { m_deliveryTimer.setInterval(msec); }
+
+   signals:
+    /// processed lines, one level per line
+    void linesReady(const QStringList& lines, const QVector<MessageLevel::Enum>& levels);
+
+   private:
+    void work();
+    void deliver();
+
+   private:
+    struct Batch {
+        QStringList lines;
+        MessageLevel::Enum level;
+    };
+
+    Processor m_processor;
+    std::unique_ptr<QThread> m_worker;
+    QTimer m_deliveryTimer;
+
+    // everything below is protected by m_mutex
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_idle;
+    QQueue<Batch> m_input;
+    QStringList m_outLines;
+    QVector<MessageLevel::Enum> m_outLevels;
+    bool m_processing = false;
+    bool m_quit = false;
+};
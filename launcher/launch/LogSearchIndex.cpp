@@ -0,0 +1,86 @@
+#include "LogSearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+quint64 trigram(QChar a, QChar b, QChar c)
+{
+    return (quint64(a.toCaseFolded().unicode()) << 32) | (quint64(b.toCaseFolded().unicode()) << 16) |
+           quint64(c.toCaseFolded().unicode());
+}
+
+// trim the posting lists once this many blocks were dropped
+const quint32 trimInterval = 64;
+}  // namespace
+
+void LogSearchIndex::add(qint64 lineId, const QString& line)
+{
+    auto block = static_cast<quint32>(lineId / blockLines);
+    for (int i = 0; i + 2 < line.size(); i++) {
+        auto& blocks = m_postings[trigram(line[i], line[i + 1], line[i + 2])];
+        if (blocks.empty() || blocks.back() != block) {
+            blocks.push_back(block);
+        }
+    }
+}
+
+void LogSearchIndex::dropBefore(qint64 lineId)
+{
+    auto block = static_cast<quint32>(lineId / blockLines);
+    if (block <= m_firstBlock) {
+        return;
+    }
+    m_untrimmed += block - m_firstBlock;
+    m_firstBlock = block;
+    if (m_untrimmed < trimInterval) {
+        return;
+    }
+    m_untrimmed = 0;
+    for (auto iter = m_postings.begin(); iter != m_postings.end();) {
+        auto& blocks = iter.value();
+        blocks.erase(blocks.begin(), std::lower_bound(blocks.begin(), blocks.end(), m_firstBlock));
+        if (blocks.empty()) {
+            iter = m_postings.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+}
+
+void LogSearchIndex::clear()
+{
+    m_postings.clear();
+    m_firstBlock = 0;
+    m_untrimmed = 0;
+}
+
+bool LogSearchIndex::candidateBlocks(const QString& needle, std::vector<quint32>& blocks) const
+{
+    blocks.clear();
+    if (needle.size() < 3) {
+        return false;
+    }
+
+    // gather the posting lists, shortest first so the intersection shrinks as fast as possible
+    std::vector<const std::vector<quint32>*> lists;
+    for (int i = 0; i + 2 < needle.size(); i++) {
+        auto found = m_postings.constFind(trigram(needle[i], needle[i + 1], needle[i + 2]));
+        if (found == m_postings.constEnd()) {
+            // a trigram that appears nowhere, nothing can match
+            return true;
+        }
+        lists.push_back(&found.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](auto a, auto b) { return a->size() < b->size(); });
+
+    const auto& shortest = *lists.front();
+    blocks.assign(std::lower_bound(shortest.begin(), shortest.end(), m_firstBlock), shortest.end());
+    std::vector<quint32> intersection;
+    for (size_t i = 1; i < lists.size() && !blocks.empty(); i++) {
+        intersection.clear();
+        std::set_intersection(blocks.begin(), blocks.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection));
+        blocks.swap(intersection);
+    }
+    return true;
+}
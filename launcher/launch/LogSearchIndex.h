@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+#include <vector>
+
+/**
+ * Incremental trigram index over log lines.
+ *
+ * Lines are grouped in blocks of `blockLines` consecutive lines, and every case folded trigram maps to the blocks it
+ * appears in. A query only has to look at the blocks that have all the trigrams of the needle, which on a long log is
+ * usually a tiny fraction of them. Indexing blocks instead of single lines keeps the index small.
+ */
+class LogSearchIndex {
+   public:
+    static constexpr int blockLines = 1024;
+
+    /// index a line, ids must be consecutive
+    void add(qint64 lineId, const QString& line);
+    /// forget about lines older than `lineId`
+    void dropBefore(qint64 lineId);
+    void clear();
+
+    /**
+     * get the blocks that may contain `needle`, case insensitively, in increasing order
+     * returns false if the needle is too short to use the index, every block is a candidate then
+     */
+    bool candidateBlocks(const QString& needle, std::vector<quint32>& blocks) const;
+
+   private:
+    QHash<quint64, std::vector<quint32>> m_postings;
+    // first block that still has live lines
+    quint32 m_firstBlock = 0;
+    // blocks dropped since the posting lists were last trimmed
+    quint32 m_untrimmed = 0;
+};
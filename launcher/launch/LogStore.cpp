@@ -0,0 +1,161 @@
+#include "LogStore.h"
+
+#include <QDebug>
+#include <QDir>
+
+#include "FileSystem.h"
+
+namespace {
+// lines per chunk
+const int chunkLines = 4096;
+// sealed chunks kept in memory before the oldest ones go to the spill file
+const int maxHotChunks = 16;
+// decompressed chunks kept around for data()
+const int cachedChunks = 4;
+}  // namespace
+
+LogStore::LogStore(const QString& spillDir) : m_spillDir(spillDir)
+{
+    m_cache.setMaxCost(cachedChunks);
+}
+
+void LogStore::append(MessageLevel::Enum level, const QString& line)
+{
+    if (m_chunks.empty() || m_chunks.back().offsets.size() == chunkLines) {
+        if (!m_chunks.empty()) {
+            seal(m_chunks.back());
+        }
+        m_chunks.emplace_back();
+    }
+    auto& chunk = m_chunks.back();
+    chunk.offsets.append(chunk.data.size());
+    chunk.levels.append(static_cast<quint8>(level));
+    chunk.data.append(line.toUtf8());
+    m_numLines++;
+}
+
+void LogStore::seal(Chunk& chunk)
+{
+    chunk.data = qCompress(chunk.data);
+    chunk.sealed = true;
+    m_hotChunks++;
+    if (m_hotChunks <= maxHotChunks || m_spillFailed) {
+        return;
+    }
+    // the oldest chunk still in memory goes to disk
+    for (auto& cold : m_chunks) {
+        if (cold.sealed && cold.spillOffset == -1) {
+            spill(cold);
+            break;
+        }
+    }
+}
+
+void LogStore::spill(Chunk& chunk)
+{
+    if (!m_spillFile) {
+        if (m_spillDir.isEmpty() || !FS::ensureFolderPathExists(m_spillDir)) {
+            m_spillFailed = true;
+            return;
+        }
+        m_spillFile.reset(new QTemporaryFile(FS::PathCombine(m_spillDir, "prism-log-XXXXXX.tmp")));
+        if (!m_spillFile->open()) {
+            qWarning() << "Couldn't open log spill file in" << m_spillDir << ":" << m_spillFile->errorString();
+            m_spillFile.reset();
+            m_spillFailed = true;
+            return;
+        }
+    }
+    qint64 offset = m_spillFile->size();
+    if (!m_spillFile->seek(offset) || m_spillFile->write(chunk.data) != chunk.data.size()) {
+        qWarning() << "Couldn't write to log spill file" << m_spillFile->fileName() << ":" << m_spillFile->errorString();
+        m_spillFailed = true;
+        return;
+    }
+    chunk.spillOffset = offset;
+    chunk.spillSize = chunk.data.size();
+    chunk.data = QByteArray();
+    m_hotChunks--;
+}
+
+void LogStore::removeFirst(int count)
+{
+    if (count >= m_numLines) {
+        clear();
+        return;
+    }
+    m_skip += count;
+    m_numLines -= count;
+    while (m_skip >= chunkLines) {
+        auto& chunk = m_chunks.front();
+        if (chunk.sealed && chunk.spillOffset == -1) {
+            m_hotChunks--;
+        }
+        m_cache.remove(m_firstChunkId);
+        m_chunks.pop_front();
+        m_firstChunkId++;
+        m_skip -= chunkLines;
+    }
+}
+
+void LogStore::clear()
+{
+    m_chunks.clear();
+    m_cache.clear();
+    m_firstChunkId = 0;
+    m_skip = 0;
+    m_numLines = 0;
+    m_hotChunks = 0;
+    // the spill file is only good for garbage now
+    m_spillFile.reset();
+    m_spillFailed = false;
+}
+
+QByteArray LogStore::uncompressed(int chunkIndex) const
+{
+    const auto& chunk = m_chunks[chunkIndex];
+    if (!chunk.sealed) {
+        return chunk.data;
+    }
+    auto id = m_firstChunkId + chunkIndex;
+    if (auto cached = m_cache.object(id)) {
+        return *cached;
+    }
+    QByteArray compressed = chunk.data;
+    if (chunk.spillOffset != -1) {
+        if (!m_spillFile->seek(chunk.spillOffset)) {
+            qWarning() << "Couldn't read from log spill file" << m_spillFile->fileName() << ":" << m_spillFile->errorString();
+            return {};
+        }
+        compressed = m_spillFile->read(chunk.spillSize);
+    }
+    auto data = qUncompress(compressed);
+    m_cache.insert(id, new QByteArray(data));
+    return data;
+}
+
+QString LogStore::lineFromData(const Chunk& chunk, const QByteArray& data, int lineInChunk) const
+{
+    int start = chunk.offsets[lineInChunk];
+    int end = lineInChunk + 1 < chunk.offsets.size() ? chunk.offsets[lineInChunk + 1] : data.size();
+    if (end > data.size()) {
+        // the chunk couldn't be read back
+        return {};
+    }
+    return QString::fromUtf8(data.constData() + start, end - start);
+}
+
+QString LogStore::line(int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_numLines);
+    int absolute = index + m_skip;
+    int chunkIndex = absolute / chunkLines;
+    return lineFromData(m_chunks[chunkIndex], uncompressed(chunkIndex), absolute % chunkLines);
+}
+
+MessageLevel::Enum LogStore::level(int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_numLines);
+    int absolute = index + m_skip;
+    return static_cast<MessageLevel::Enum>(m_chunks[absolute / chunkLines].levels[absolute % chunkLines]);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCache>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include <deque>
+#include <memory>
+
+#include "MessageLevel.h"
+
+/**
+ * Compact append-only storage for log lines, used by LogModel for very long logs.
+ *
+ * Lines are stored as UTF-8 in chunks of a fixed number of lines. Full chunks are compressed, and once there are more
+ * than a handful of them in memory, the oldest ones are spilled to a temporary file in the given directory.
+ * Reading a line decompresses its chunk on demand, with a small LRU cache of decompressed chunks.
+ */
+class LogStore {
+   public:
+    /// `spillDir` is where cold chunks go, if empty or unusable everything stays in memory
+    explicit LogStore(const QString& spillDir);
+
+    int size() const { return m_numLines; }
+
+    void append(MessageLevel::Enum level, const QString& line);
+    /// drop the `count` oldest lines
+    void removeFirst(int count);
+    void clear();
+
+    QString line(int index) const;
+    MessageLevel::Enum level(int index) const;
+
+   private:
+    struct Chunk {
+        // raw UTF-8 for the open chunk, compressed for the sealed ones, empty when spilled
+        QByteArray data;
+        // start of each line in the uncompressed data
+        QVector<quint32> offsets;
+        QVector<quint8> levels;
+        bool sealed = false;
+        qint64 spillOffset = -1;
+        int spillSize = 0;
+    };
+
+    void seal(Chunk& chunk);
+    void spill(Chunk& chunk);
+    QByteArray uncompressed(int chunkIndex) const;
+    QString lineFromData(const Chunk& chunk, const QByteArray& data, int lineInChunk) const;
+
+   private:
+    std::deque<Chunk> m_chunks;
+    // id of the first chunk in m_chunks, ids are stable across removeFirst() and key the cache
+    qint64 m_firstChunkId = 0;
+    // how many lines of the first chunk are already removed
+    int m_skip = 0;
+    int m_numLines = 0;
+    // sealed chunks still held in memory
+    int m_hotChunks = 0;
+
+    QString m_spillDir;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    bool m_spillFailed = false;
+
+    mutable QCache<qint64, QByteArray> m_cache;
+};
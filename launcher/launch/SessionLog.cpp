@@ -0,0 +1,145 @@
+#include "SessionLog.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "GZip.h"
+
+namespace {
+// lines per gzip member, small enough that a member decompresses in no time
+const int memberLines = 4096;
+// or bytes, for games printing huge lines
+const int memberBytes = 1024 * 1024;
+}  // namespace
+
+QString SessionLogWriter::indexPath(const QString& path)
+{
+    return path + ".idx";
+}
+
+SessionLogWriter::SessionLogWriter(const QString& dir, int keep)
+{
+    if (!FS::ensureFolderPathExists(dir)) {
+        qWarning() << "Couldn't create the session log folder" << dir;
+        return;
+    }
+
+    // the timestamps sort them from the oldest
+    QDir logDir(dir);
+    auto old = logDir.entryList({ "session-*.log.gz" }, QDir::Files, QDir::Name);
+    for (int i = 0; i < old.size() - (keep - 1); i++) {
+        auto oldPath = logDir.absoluteFilePath(old[i]);
+        QFile::remove(oldPath);
+        QFile::remove(indexPath(oldPath));
+    }
+
+    auto name = QString("session-%1.log.gz").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss-zzz"));
+    m_file.setFileName(logDir.absoluteFilePath(name));
+    m_index.setFileName(indexPath(m_file.fileName()));
+    if (!m_file.open(QIODevice::WriteOnly) || !m_index.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Couldn't open the session log" << m_file.fileName() << ':' << m_file.errorString() << m_index.errorString();
+        m_file.close();
+        m_index.close();
+    }
+}
+
+SessionLogWriter::~SessionLogWriter()
+{
+    flush();
+}
+
+void SessionLogWriter::append(const QStringList& lines)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen())
+        return;
+    for (auto& line : lines) {
+        m_pending.append(line.toUtf8());
+        m_pending.append('\n');
+        m_pendingLines++;
+        if (m_pendingLines == memberLines || m_pending.size() >= memberBytes)
+            writeMember();
+    }
+}
+
+void SessionLogWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen() && m_pendingLines > 0)
+        writeMember();
+}
+
+void SessionLogWriter::writeMember()
+{
+    QByteArray compressed;
+    auto offset = m_file.pos();
+    if (!GZip::zip(m_pending, compressed) || m_file.write(compressed) != compressed.size() || !m_file.flush()) {
+        qWarning() << "Couldn't write the session log" << m_file.fileName() << ':' << m_file.errorString();
+        m_file.close();
+        m_index.close();
+        return;
+    }
+    // the index only ever tells of members that are there already
+    m_index.write(QString("%1 %2\n").arg(offset).arg(m_lines).toUtf8());
+    m_index.flush();
+
+    m_lines += m_pendingLines;
+    m_pending.clear();
+    m_pendingLines = 0;
+}
+
+SessionLogReader::SessionLogReader(const QString& path) : m_path(path)
+{
+    QFile index(SessionLogWriter::indexPath(path));
+    if (!index.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    m_size = QFileInfo(path).size();
+    while (!index.atEnd()) {
+        auto fields = index.readLine().trimmed().split(' ');
+        if (fields.size() != 2)
+            break;
+        Member entry{ fields[0].toLongLong(), fields[1].toLongLong() };
+        if (entry.offset >= m_size)
+            break;
+        m_members.append(entry);
+    }
+}
+
+QStringList SessionLogReader::member(int member) const
+{
+    QFile file(m_path);
+    auto offset = m_members[member].offset;
+    auto end = member + 1 < m_members.size() ? m_members[member + 1].offset : m_size;
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(offset))
+        return {};
+
+    QByteArray data;
+    if (!GZip::unzip(file.read(end - offset), data))
+        return {};
+    if (data.endsWith('\n'))
+        data.chop(1);
+    return QString::fromUtf8(data).split('\n');
+}
+
+QStringList SessionLogReader::tail(qint64 maxSize, qint64* firstLine) const
+{
+    QList<QStringList> members;
+    qint64 size = 0;
+    int i = m_members.size() - 1;
+    for (; i >= 0 && (members.isEmpty() || size < maxSize); i--) {
+        auto lines = member(i);
+        for (auto& line : lines)
+            size += line.size() + 1;
+        members.prepend(lines);
+    }
+    if (firstLine)
+        *firstLine = i + 1 < m_members.size() ? m_members[i + 1].firstLine : 0;
+
+    QStringList out;
+    for (auto& lines : members)
+        out += lines;
+    return out;
+}
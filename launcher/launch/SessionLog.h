@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Writes the whole game output of a launch to a compressed file, so it's still there when the console stopped
+ * watching or the launcher closed.
+ *
+ * The file is a series of gzip members, one every few thousand lines, so it reads as a single gzip file to anything
+ * else. Next to it, an index tells where each member starts and its first line, which is what lets SessionLogReader
+ * read any part of a log of any size without decompressing what comes before. Only the last few session logs of an
+ * instance are kept.
+ *
+ * Thread safe, the lines come from the log pipeline thread.
+ */
+class SessionLogWriter {
+   public:
+    /// start a new session log in `dir`, removing the oldest ones so at most `keep` are left
+    explicit SessionLogWriter(const QString& dir, int keep = 10);
+    ~SessionLogWriter();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    QString path() const { return m_file.fileName(); }
+
+    /// the lines, already censored
+    void append(const QStringList& lines);
+    /// write out the lines that don't make up a whole member yet
+    void flush();
+
+    /// where the index of the session log at `path` is
+    static QString indexPath(const QString& path);
+
+   private:
+    void writeMember();
+
+   private:
+    QMutex m_mutex;
+    QFile m_file;
+    QFile m_index;
+    QByteArray m_pending;
+    int m_pendingLines = 0;
+    qint64 m_lines = 0;
+};
+
+/**
+ * Reads a session log a member at a time, through its index.
+ */
+class SessionLogReader {
+   public:
+    explicit SessionLogReader(const QString& path);
+
+    /// whether it's a session log with its index, the rest of the reader needs that
+    bool isValid() const { return !m_members.isEmpty(); }
+
+    int memberCount() const { return m_members.size(); }
+    /// the line the member starts with, counting from zero
+    qint64 firstLine(int member) const { return m_members[member].firstLine; }
+
+    /// the lines of the member, empty if it can't be read
+    QStringList member(int member) const;
+    /// the last lines of the log, whole members of it up to about `maxSize` characters, starting at line `firstLine`
+    QStringList tail(qint64 maxSize, qint64* firstLine = nullptr) const;
+
+   private:
+    struct Member {
+        qint64 offset;
+        qint64 firstLine;
+    };
+
+    QString m_path;
+    qint64 m_size = 0;
+    QVector<Member> m_members;
+};
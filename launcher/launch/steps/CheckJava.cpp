@@ -40,6 +40,7 @@
 #include <QFileInfo>
 #include <QStandardPaths>
 #include "java/JavaUtils.h"
+#include "java/ManagedRuntimeTask.h"
 
 void CheckJava::executeTask()
 {
@@ -94,6 +95,8 @@ void CheckJava::executeTask()
         emit logLine(QString("Checking Java version..."), MessageLevel::Launcher);
         connect(m_JavaChecker.get(), &JavaChecker::checkFinished, this, &CheckJava::checkJavaFinished);
         m_JavaChecker->m_path = realJavaPath;
+        // the runtimes the launcher installs itself say what they are in their release file
+        m_JavaChecker->m_useReleaseFile = ManagedRuntimeTask::isManaged(realJavaPath);
         m_JavaChecker->performCheck();
         return;
     } else {
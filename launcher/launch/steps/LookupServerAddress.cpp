@@ -17,17 +17,14 @@
 
 #include <launch/LaunchTask.h>
 
-LookupServerAddress::LookupServerAddress(LaunchTask* parent) : LaunchStep(parent), m_dnsLookup(new QDnsLookup(this))
-{
-    connect(m_dnsLookup, &QDnsLookup::finished, this, &LookupServerAddress::on_dnsLookupFinished);
+#include "Application.h"
+#include "net/SrvCache.h"
 
-    m_dnsLookup->setType(QDnsLookup::SRV);
-}
+LookupServerAddress::LookupServerAddress(LaunchTask* parent) : LaunchStep(parent) {}
 
 void LookupServerAddress::setLookupAddress(const QString& lookupAddress)
 {
     m_lookupAddress = lookupAddress;
-    m_dnsLookup->setName(QString("_minecraft._tcp.%1").arg(lookupAddress));
 }
 
 void LookupServerAddress::setOutputAddressPtr(MinecraftServerTargetPtr output)
@@ -37,49 +34,38 @@ void LookupServerAddress::setOutputAddressPtr(MinecraftServerTargetPtr output)
 
 bool LookupServerAddress::abort()
 {
-    m_dnsLookup->abort();
     emitFailed("Aborted");
     return true;
 }
 
 void LookupServerAddress::executeTask()
 {
-    m_dnsLookup->lookup();
-}
-
-void LookupServerAddress::on_dnsLookupFinished()
-{
-    if (isFinished()) {
-        // Aborted
-        return;
-    }
-
-    if (m_dnsLookup->error() != QDnsLookup::NoError) {
-        emit logLine(QString("Failed to resolve server address (this is NOT an error!) %1: %2\n")
-                         .arg(m_dnsLookup->name(), m_dnsLookup->errorString()),
-                     MessageLevel::Launcher);
-        resolve(m_lookupAddress, 25565);  // Technically the task failed, however, we don't abort the launch
-                                          // and leave it up to minecraft to fail (or maybe not) when connecting
-        return;
-    }
+    auto name = QString("_minecraft._tcp.%1").arg(m_lookupAddress);
+    APPLICATION->srvCache()->resolve(name, this, [this, name](std::optional<SrvCache::Record> record, const QString& error) {
+        if (isFinished()) {
+            // Aborted
+            return;
+        }
 
-    const auto records = m_dnsLookup->serviceRecords();
-    if (records.empty()) {
-        emit logLine(QString("Failed to resolve server address %1: the DNS lookup succeeded, but no records were returned.\n")
-                         .arg(m_dnsLookup->name()),
-                     MessageLevel::Warning);
-        resolve(m_lookupAddress, 25565);  // Technically the task failed, however, we don't abort the launch
-                                          // and leave it up to minecraft to fail (or maybe not) when connecting
-        return;
-    }
+        if (!error.isEmpty()) {
+            emit logLine(QString("Failed to resolve server address (this is NOT an error!) %1: %2\n").arg(name, error),
+                         MessageLevel::Launcher);
+            resolve(m_lookupAddress, 25565);  // Technically the task failed, however, we don't abort the launch
+                                              // and leave it up to minecraft to fail (or maybe not) when connecting
+            return;
+        }
 
-    const auto& firstRecord = records.at(0);
-    quint16 port = firstRecord.port();
+        if (!record) {
+            // most servers don't have one
+            emit logLine(QString("%1 has no SRV record, using the default port\n").arg(name), MessageLevel::Launcher);
+            resolve(m_lookupAddress, 25565);
+            return;
+        }
 
-    emit logLine(
-        QString("Resolved server address %1 to %2 with port %3\n").arg(m_dnsLookup->name(), firstRecord.target(), QString::number(port)),
-        MessageLevel::Launcher);
-    resolve(firstRecord.target(), port);
+        emit logLine(QString("Resolved server address %1 to %2 with port %3\n").arg(name, record->target, QString::number(record->port)),
+                     MessageLevel::Launcher);
+        resolve(record->target, record->port);
+    });
 }
 
 void LookupServerAddress::resolve(const QString& address, quint16 port)
@@ -88,5 +74,4 @@ void LookupServerAddress::resolve(const QString& address, quint16 port)
     m_output->port = port;
 
     emitSucceeded();
-    m_dnsLookup->deleteLater();
 }
@@ -17,7 +17,6 @@
 
 #include <QObjectPtr.h>
 #include <launch/LaunchStep.h>
-#include <QDnsLookup>
 
 #include "minecraft/launch/MinecraftServerTarget.h"
 
@@ -34,13 +33,9 @@ class LookupServerAddress : public LaunchStep {
     void setLookupAddress(const QString& lookupAddress);
     void setOutputAddressPtr(MinecraftServerTargetPtr output);
 
-   private slots:
-    void on_dnsLookupFinished();
-
    private:
     void resolve(const QString& address, quint16 port);
 
-    QDnsLookup* m_dnsLookup;
     QString m_lookupAddress;
     MinecraftServerTargetPtr m_output;
 };
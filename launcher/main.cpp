@@ -63,6 +63,10 @@ int main(int argc, char* argv[])
     QGuiApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 #endif
 
+    // with a launcher already running on the same data, it does what was asked and there's no GUI to start
+    if (Application::forwardToRunningInstance(argc, argv))
+        return 0;
+
     // initialize Qt
     Application app(argc, argv);
 
@@ -15,6 +15,11 @@
 
 #include "BaseEntity.h"
 
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
 #include "Json.h"
 #include "net/ApiDownload.h"
 #include "net/HttpMetaCache.h"
@@ -68,24 +73,64 @@ QUrl Meta::BaseEntity::url() const
     }
 }
 
+// what the binary caches start with, and the version of their layout
+static constexpr quint32 s_binaryMagic = 0x4d455441;  // "META"
+static constexpr quint32 s_binaryFormat = 1;
+
 bool Meta::BaseEntity::loadLocalFile()
 {
     const QString fname = QDir("meta").absoluteFilePath(localFilename());
-    if (!QFile::exists(fname)) {
+    QFile file(fname);
+    if (!file.open(QIODevice::ReadOnly)) {
         return false;
     }
+    auto data = file.readAll();
+    file.close();
+
+    // the binary cache is only good for the exact file it was made from
+    const QString binaryName = fname + ".bin";
+    auto sha256 = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+    {
+        QFile binary(binaryName);
+        if (binary.open(QIODevice::ReadOnly)) {
+            QDataStream in(&binary);
+            in.setVersion(QDataStream::Qt_5_12);
+            quint32 magic = 0, format = 0;
+            QByteArray stamp;
+            in >> magic >> format >> stamp;
+            if (magic == s_binaryMagic && format == s_binaryFormat && stamp == sha256 && readBinary(in)) {
+                return true;
+            }
+        }
+    }
+
     // TODO: check if the file has the expected checksum
     try {
-        auto doc = Json::requireDocument(fname, fname);
+        auto doc = Json::requireDocument(data, fname);
         auto obj = Json::requireObject(doc, fname);
         parse(obj);
-        return true;
     } catch (const Exception& e) {
         qDebug() << QString("Unable to parse file %1: %2").arg(fname, e.cause());
         // just make sure it's gone and we never consider it again.
         QFile::remove(fname);
+        QFile::remove(binaryName);
         return false;
     }
+
+    QByteArray binaryData;
+    {
+        QDataStream out(&binaryData, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_12);
+        out << s_binaryMagic << s_binaryFormat << sha256;
+        if (!writeBinary(out)) {
+            return true;
+        }
+    }
+    QSaveFile binary(binaryName);
+    if (!binary.open(QIODevice::WriteOnly) || binary.write(binaryData) != binaryData.size() || !binary.commit()) {
+        qDebug() << "Couldn't write the binary cache of" << fname;
+    }
+    return true;
 }
 
 void Meta::BaseEntity::load(Net::Mode loadType)
@@ -101,6 +146,7 @@ void Meta::BaseEntity::load(Net::Mode loadType)
         return;
     }
     m_updateTask.reset(new NetJob(QObject::tr("Download of meta file %1").arg(localFilename()), APPLICATION->network()));
+    m_updateTask->setPriority(Net::Priority::LaunchCritical);
     auto url = this->url();
     auto entry = APPLICATION->metacache()->resolveEntry("meta", localFilename());
     entry->setStale(true);
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <QDataStream>
 #include <QJsonObject>
 #include <QObject>
 #include "QObjectPtr.h"
@@ -46,6 +47,13 @@ class BaseEntity {
    protected: /* methods */
     bool loadLocalFile();
 
+    /**
+     * The parsed entity in a compact binary form, kept next to the local file so it isn't parsed again until it changes.
+     * Entities that don't implement these always parse the JSON. readBinary must leave the entity alone when it fails.
+     */
+    virtual bool readBinary(QDataStream&) { return false; }
+    virtual bool writeBinary(QDataStream&) const { return false; }
+
    private:
     LoadStatus m_loadStatus = LoadStatus::NotLoaded;
     UpdateStatus m_updateStatus = UpdateStatus::NotDone;
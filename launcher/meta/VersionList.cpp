@@ -171,6 +171,75 @@ void VersionList::parse(const QJsonObject& obj)
     parseVersionList(obj, this);
 }
 
+static QDataStream& operator<<(QDataStream& out, const RequireSet& requirements)
+{
+    out << quint32(requirements.size());
+    for (auto& req : requirements) {
+        out << req.uid << req.equalsVersion << req.suggests;
+    }
+    return out;
+}
+
+static QDataStream& operator>>(QDataStream& in, RequireSet& requirements)
+{
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Require req;
+        in >> req.uid >> req.equalsVersion >> req.suggests;
+        requirements.insert(req);
+    }
+    return in;
+}
+
+bool VersionList::writeBinary(QDataStream& out) const
+{
+    out << m_uid << m_name << quint32(m_versions.size());
+    for (auto& version : m_versions) {
+        out << version->version() << version->type() << version->rawTime() << version->isRecommended() << version->isVolatile()
+            << version->requiredSet() << version->conflictSet();
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+bool VersionList::readBinary(QDataStream& in)
+{
+    QString uid, name;
+    quint32 count = 0;
+    in >> uid >> name >> count;
+    if (in.status() != QDataStream::Ok || uid != m_uid) {
+        return false;
+    }
+
+    // same as parsing the JSON would do
+    QVector<Version::Ptr> versions;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString id, type;
+        qint64 time = 0;
+        bool recommended = false, isVolatile = false;
+        RequireSet reqs, conflicts;
+        in >> id >> type >> time >> recommended >> isVolatile >> reqs >> conflicts;
+
+        auto version = std::make_shared<Version>(uid, id);
+        version->setTime(time);
+        version->setType(type);
+        version->setRecommended(recommended);
+        version->setVolatile(isVolatile);
+        version->setRequires(reqs, conflicts);
+        version->setProvidesRecommendations();
+        versions.append(version);
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    auto list = std::make_shared<VersionList>(uid);
+    list->setName(name);
+    list->setVersions(versions);
+    merge(list);
+    return true;
+}
+
 // FIXME: this is dumb, we have 'recommended' as part of the metadata already...
 static const Meta::Version::Ptr& getBetterVersion(const Meta::Version::Ptr& a, const Meta::Version::Ptr& b)
 {
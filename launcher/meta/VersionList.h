@@ -65,6 +65,10 @@ class VersionList : public BaseVersionList, public BaseEntity {
     void mergeFromIndex(const VersionList::Ptr& other);
     void parse(const QJsonObject& obj) override;
 
+   protected:
+    bool readBinary(QDataStream& in) override;
+    bool writeBinary(QDataStream& out) const override;
+
    signals:
     void nameChanged(const QString& name);
 
@@ -34,6 +34,7 @@
  */
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -41,39 +42,102 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
-#include <QVariant>
+#include <QLoggingCategory>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrentFilter>
+
+#include <filesystem>
 
 #include "AssetsUtils.h"
 #include "BuildConfig.h"
 #include "FileSystem.h"
+#include "Json.h"
+#include "StringUtils.h"
 #include "net/ApiDownload.h"
 #include "net/ChecksumValidator.h"
 #include "net/Download.h"
 
 #include "Application.h"
 
+namespace fs = std::filesystem;
+
+// the lines for each asset, too many to be on by default
+Q_LOGGING_CATEGORY(assetsLogC, "launcher.minecraft.assets")
+
 namespace {
+// what's left in a reconstructed folder to tell the next launch it's done
+const char* reconstructedStamp = ".reconstructed";
+
+// relative paths of every file under `dirPath`, in a single walk
 QSet<QString> collectPathsFromDir(QString dirPath)
 {
-    QFileInfo dirInfo(dirPath);
-
-    if (!dirInfo.exists()) {
+    QDir dir(dirPath);
+    if (!dir.exists()) {
         return {};
     }
 
     QSet<QString> out;
-
-    QDirIterator iter(dirPath, QDirIterator::Subdirectories);
+    QDirIterator iter(dirPath, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
     while (iter.hasNext()) {
-        QString value = iter.next();
-        QFileInfo info(value);
-        if (info.isFile()) {
-            out.insert(value);
-            qDebug() << value;
-        }
+        out.insert(dir.relativeFilePath(iter.next()));
     }
     return out;
 }
+
+// identifies the index and the objects a folder was reconstructed from
+QByteArray stampFor(const AssetsIndex& index, const QFileInfo& indexFile)
+{
+    return QString("%1 %2 %3 %4")
+        .arg(index.id)
+        .arg(indexFile.size())
+        .arg(indexFile.lastModified().toMSecsSinceEpoch())
+        .arg(index.objects.size())
+        .toUtf8();
+}
+
+QByteArray readStamp(const QString& targetPath)
+{
+    QFile stamp(FS::PathCombine(targetPath, reconstructedStamp));
+    if (!stamp.open(QIODevice::ReadOnly))
+        return {};
+    return stamp.readAll();
+}
+
+enum class PlaceMethod { Clone, Link, Copy };
+
+// objects are never written to, so sharing their data with the reconstructed copy is fine
+PlaceMethod placeMethodFor(const QString& objectDir, const QString& targetPath)
+{
+    auto source = FS::statFS(objectDir);
+    auto target = FS::statFS(targetPath);
+    if (source.rootPath != target.rootPath || source.fsType != target.fsType)
+        return PlaceMethod::Copy;
+    return FS::canCloneOnFS(source) ? PlaceMethod::Clone : PlaceMethod::Link;
+}
+
+bool placeObject(const QString& original, const QString& target, PlaceMethod& method)
+{
+    // not downloaded, which says nothing about what the filesystem can do
+    if (!QFileInfo::exists(original))
+        return false;
+
+    std::error_code ec;
+    if (method == PlaceMethod::Clone) {
+        if (FS::clone_file(original, target, ec))
+            return true;
+        QFile::remove(target);
+        method = PlaceMethod::Link;
+    }
+    if (method == PlaceMethod::Link) {
+        fs::create_hard_link(StringUtils::toStdString(original), StringUtils::toStdString(target), ec);
+        if (!ec)
+            return true;
+        // no point in trying the rest of them
+        method = PlaceMethod::Copy;
+    }
+    return QFile::copy(original, target);
+}
 }  // namespace
 
 namespace AssetsUtils {
@@ -111,58 +175,55 @@ bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsInd
     QByteArray jsonData = file.readAll();
     file.close();
 
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
-
-    // Fail if the JSON is invalid.
-    if (parseError.error != QJsonParseError::NoError) {
-        qCritical() << "Failed to parse assets index file:" << parseError.errorString() << "at offset "
-                    << QString::number(parseError.offset);
-        return false;
-    }
-
-    // Make sure the root is an object.
-    if (!jsonDoc.isObject()) {
-        qCritical() << "Invalid assets index JSON: Root should be an array.";
+    // big enough to not build a document of it first
+    Json::Reader reader(jsonData);
+    auto readFlag = [&reader]() {
+        if (reader.peek() == Json::Reader::Type::Boolean)
+            return reader.readBoolean();
+        reader.skipValue();
         return false;
-    }
-
-    QJsonObject root = jsonDoc.object();
-
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined()) {
-        index.isVirtual = isVirtual.toBool(false);
-    }
-
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined()) {
-        index.mapToResources = mapToResources.toBool(false);
-    }
-
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
-
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
-        // qDebug() << iter.key();
-
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
-
-        AssetObject object;
-
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin(); nested_iter != nested_objects.end(); ++nested_iter) {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
-
-            if (key == "hash") {
-                object.hash = value.toString();
-            } else if (key == "size") {
-                object.size = value.toDouble();
+    };
+
+    index.objects.clear();
+    if (reader.beginObject()) {
+        QString key;
+        while (reader.nextKey(key)) {
+            if (key == "virtual") {
+                index.isVirtual = readFlag();
+            } else if (key == "map_to_resources") {
+                index.mapToResources = readFlag();
+            } else if (key == "objects" && reader.peek() == Json::Reader::Type::Object) {
+                reader.beginObject();
+                AssetObject object;
+                while (reader.nextKey(object.name)) {
+                    object.hash.clear();
+                    object.size = 0;
+                    if (reader.peek() == Json::Reader::Type::Object) {
+                        reader.beginObject();
+                        QString field;
+                        while (reader.nextKey(field)) {
+                            if (field == "hash" && reader.peek() == Json::Reader::Type::String)
+                                object.hash = reader.readString();
+                            else if (field == "size" && reader.peek() == Json::Reader::Type::Number)
+                                object.size = static_cast<qint64>(reader.readNumber());
+                            else
+                                reader.skipValue();
+                        }
+                    } else {
+                        reader.skipValue();
+                    }
+                    index.objects.append(object);
+                }
+            } else {
+                reader.skipValue();
             }
         }
+    }
 
-        index.objects.insert(iter.key(), object);
+    // Fail if the JSON is invalid.
+    if (reader.hasError()) {
+        qCritical() << "Failed to parse assets index file:" << reader.errorString() << "at offset " << QString::number(reader.offset());
+        return false;
     }
 
     return true;
@@ -237,85 +298,104 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
     }
 
     if (!targetPath.isNull()) {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys()) {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
-
-            QString tlk = asset_object.hash.left(2);
+        QFileInfo indexInfo(indexPath);
+        auto stamp = stampFor(index, indexInfo);
+        if (readStamp(targetPath) == stamp) {
+            qDebug() << "Assets in" << targetPath << "are already reconstructed";
+            return true;
+        }
 
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
+        auto presentFiles = collectPathsFromDir(targetPath);
+        presentFiles.remove(reconstructedStamp);
+        auto method = placeMethodFor(objectDir.path(), targetPath);
+        QSet<QString> createdDirs;
+        int placed = 0;
+        bool complete = true;
+        for (const auto& asset_object : index.objects) {
+            // only the files that aren't there cost more than a lookup
+            if (presentFiles.remove(asset_object.name))
                 continue;
 
-            presentFiles.remove(target_path);
-
-            if (!target.exists()) {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
-
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+            QString target_path = FS::PathCombine(targetPath, asset_object.name);
+            QString original_path = FS::PathCombine(objectDir.path(), asset_object.getRelPath());
+            auto target_dir = QFileInfo(target_path).path();
+            if (!createdDirs.contains(target_dir)) {
+                FS::ensureFolderPathExists(target_dir);
+                createdDirs.insert(target_dir);
+            }
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
+            if (!placeObject(original_path, target_path, method)) {
+                complete = false;
+                continue;
             }
+            placed++;
         }
+        qDebug() << "Placed" << placed << "of" << index.objects.size() << "assets in" << targetPath;
 
         // TODO: Write last used time to virtualRoot/.lastused
         if (removeLeftovers) {
             for (auto& file : presentFiles) {
-                qDebug() << "Would remove" << file;
+                qCDebug(assetsLogC) << "Would remove" << file;
             }
         }
+
+        if (complete) {
+            QSaveFile stampFile(FS::PathCombine(targetPath, reconstructedStamp));
+            if (!stampFile.open(QIODevice::WriteOnly) || stampFile.write(stamp) != stamp.size() || !stampFile.commit())
+                qWarning() << "Couldn't write" << stampFile.fileName() << ", the assets will be checked again next launch";
+        }
     }
     return true;
 }
 
 }  // namespace AssetsUtils
 
-NetAction::Ptr AssetObject::getDownloadAction()
+bool AssetObject::isMissing() const
 {
     QFileInfo objectFile(getLocalPath());
-    if ((!objectFile.isFile()) || (objectFile.size() != size)) {
-        auto objectDL = Net::ApiDownload::makeFile(getUrl(), objectFile.filePath());
-        if (hash.size()) {
-            auto rawHash = QByteArray::fromHex(hash.toLatin1());
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
-        }
-        objectDL->setProgress(objectDL->getProgress(), size);
-        return objectDL;
+    return !objectFile.isFile() || objectFile.size() != size;
+}
+
+NetAction::Ptr AssetObject::getDownloadAction() const
+{
+    auto objectDL = Net::ApiDownload::makeFile(getUrl(), getLocalPath());
+    if (hash.size()) {
+        auto rawHash = QByteArray::fromHex(hash.toLatin1());
+        objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, rawHash));
     }
-    return nullptr;
+    objectDL->setProgress(objectDL->getProgress(), size);
+    return objectDL;
 }
 
-QString AssetObject::getLocalPath()
+QString AssetObject::getLocalPath() const
 {
     return "assets/objects/" + getRelPath();
 }
 
-QUrl AssetObject::getUrl()
+QUrl AssetObject::getUrl() const
 {
     return BuildConfig.RESOURCE_BASE + getRelPath();
 }
 
-QString AssetObject::getRelPath()
+QString AssetObject::getRelPath() const
 {
     return hash.left(2) + "/" + hash;
 }
 
-NetJob::Ptr AssetsIndex::getDownloadJob()
+QFuture<AssetObject> AssetsIndex::findMissingObjects() const
 {
+    // thousands of stat calls, a cold disk takes a while to answer them one by one
+    return QtConcurrent::filtered(objects, &AssetObject::isMissing);
+}
+
+NetJob::Ptr AssetsIndex::getDownloadJob(const QList<AssetObject>& missing) const
+{
+    if (missing.isEmpty())
+        return nullptr;
     auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto& object : objects.values()) {
-        auto dl = object.getDownloadAction();
-        if (dl) {
-            job->addNetAction(dl);
-        }
+    job->setPriority(Net::Priority::Bulk);
+    for (const auto& object : missing) {
+        job->addNetAction(object.getDownloadAction());
     }
-    if (job->size())
-        return job;
-    return nullptr;
+    return job;
 }
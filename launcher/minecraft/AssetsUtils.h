@@ -15,26 +15,35 @@
 
 #pragma once
 
-#include <QMap>
+#include <QFuture>
+#include <QList>
 #include <QString>
+#include <QVector>
 #include "net/NetAction.h"
 #include "net/NetJob.h"
 
 struct AssetObject {
-    QString getRelPath();
-    QUrl getUrl();
-    QString getLocalPath();
-    NetAction::Ptr getDownloadAction();
-
+    QString getRelPath() const;
+    QUrl getUrl() const;
+    QString getLocalPath() const;
+    /// not downloaded yet, or not completely
+    bool isMissing() const;
+    NetAction::Ptr getDownloadAction() const;
+
+    // where the game looks for it, relative to the assets root
+    QString name;
     QString hash;
-    qint64 size;
+    qint64 size = 0;
 };
 
 struct AssetsIndex {
-    NetJob::Ptr getDownloadJob();
+    /// the objects that need downloading, checked on the global thread pool
+    QFuture<AssetObject> findMissingObjects() const;
+    /// a job downloading `missing`, null if there's nothing to download
+    NetJob::Ptr getDownloadJob(const QList<AssetObject>& missing) const;
 
     QString id;
-    QMap<QString, AssetObject> objects;
+    QVector<AssetObject> objects;
     bool isVirtual = false;
     bool mapToResources = false;
 };
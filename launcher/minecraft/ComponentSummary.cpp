@@ -0,0 +1,67 @@
+#include "ComponentSummary.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+QMutex s_lock;
+QHash<QString, ComponentSummary::Ptr> s_summaries;
+}  // namespace
+
+ComponentSummary::Ptr ComponentSummary::of(const QString& path)
+{
+    QFileInfo info(path);
+    auto modified = info.lastModified();
+    auto size = info.exists() ? info.size() : -1;
+    {
+        QMutexLocker locker(&s_lock);
+        auto found = s_summaries.constFind(path);
+        if (found != s_summaries.constEnd() && (*found)->m_modified == modified && (*found)->m_size == size)
+            return *found;
+    }
+
+    auto summary = std::make_shared<ComponentSummary>();
+    summary->m_modified = modified;
+    summary->m_size = size;
+
+    QFile file(path);
+    if (file.open(QFile::ReadOnly)) {
+        // the component list itself reports what's wrong with the file when it's loaded, an empty summary is enough here
+        auto components = QJsonDocument::fromJson(file.readAll()).object().value("components").toArray();
+        for (auto item : components) {
+            auto obj = item.toObject();
+            auto uid = obj.value("uid").toString();
+            // like the component list, the first of duplicate entries wins
+            if (uid.isEmpty() || summary->m_entries.contains(uid))
+                continue;
+            summary->m_entries.insert(uid, { obj.value("version").toString(), !obj.value("disabled").toBool(false) });
+        }
+    }
+
+    QMutexLocker locker(&s_lock);
+    s_summaries.insert(path, summary);
+    return summary;
+}
+
+void ComponentSummary::forget(const QString& path)
+{
+    QMutexLocker locker(&s_lock);
+    s_summaries.remove(path);
+}
+
+QString ComponentSummary::version(const QString& uid) const
+{
+    auto found = m_entries.constFind(uid);
+    return found != m_entries.constEnd() ? found->version : QString();
+}
+
+bool ComponentSummary::isEnabled(const QString& uid) const
+{
+    auto found = m_entries.constFind(uid);
+    return found != m_entries.constEnd() && found->enabled;
+}
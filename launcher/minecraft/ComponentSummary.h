@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <memory>
+
+/**
+ * The components of an instance as its mmc-pack.json lists them, without building or resolving any of them.
+ *
+ * Showing the Minecraft version or the loaders of an instance used to load its whole component list, and the status bar
+ * even resolved it. The list itself is enough for those, so this reads only the uids, versions and whether they're
+ * disabled, and keeps them until the file changes.
+ */
+class ComponentSummary {
+   public:
+    using Ptr = std::shared_ptr<const ComponentSummary>;
+
+    /// the summary of the components file at `path`, read again only once the file has changed
+    static Ptr of(const QString& path);
+
+    /// drop what was read from `path`, for when it has just been written
+    static void forget(const QString& path);
+
+    /// the version the component is set to, or a null string if it isn't listed
+    QString version(const QString& uid) const;
+
+    bool isEnabled(const QString& uid) const;
+
+   private:
+    struct Entry {
+        QString version;
+        bool enabled = true;
+    };
+
+    QHash<QString, Entry> m_entries;
+    QDateTime m_modified;
+    qint64 m_size = -1;
+};
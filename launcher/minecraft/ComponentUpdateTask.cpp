@@ -202,6 +202,7 @@ void ComponentUpdateTask::loadComponents()
 #endif
         if (singleResult == LoadResult::LoadedLocal) {
             component->updateCachedData();
+            prefetchRequirements(component->m_cachedRequires);
         }
         result = composeLoadResult(result, singleResult);
         if (loadTask) {
@@ -313,6 +314,30 @@ static bool gatherRequirementsFromComponents(const ComponentContainer& input, Re
     return succeeded;
 }
 
+/// the version a requirement without an exact version is resolved to
+static QString pickVersion(const Meta::Require& req, const ComponentContainer& components)
+{
+    // ############################################################################################################
+    // HACK HACK HACK HACK FIXME: this is a placeholder for deciding what version to use. For now, it is hardcoded.
+    if (!req.suggests.isEmpty()) {
+        return req.suggests;
+    }
+    if (req.uid == "org.lwjgl") {
+        return "2.9.1";
+    } else if (req.uid == "org.lwjgl3") {
+        return "3.1.2";
+    } else if (req.uid == "net.fabricmc.intermediary" || req.uid == "org.quiltmc.hashed") {
+        auto minecraft =
+            std::find_if(components.begin(), components.end(), [](const ComponentPtr& cmp) { return cmp->getID() == "net.minecraft"; });
+        if (minecraft != components.end()) {
+            return (*minecraft)->getVersion();
+        }
+    }
+    return {};
+    // HACK HACK HACK HACK FIXME: this is a placeholder for deciding what version to use. For now, it is hardcoded.
+    // ############################################################################################################
+}
+
 /// Get list of uids that can be trivially removed because nothing is depending on them anymore (and they are installed as deps)
 static void getTrivialRemovals(const ComponentContainer& components, const RequireExSet& reqs, QStringList& toRemove)
 {
@@ -471,25 +496,7 @@ void ComponentUpdateTask::resolveDependencies(bool checkOnly)
             } else {
                 // version needs to be decided
                 qDebug() << "Adding" << add.uid << "at position" << add.indexOfFirstDependee;
-                // ############################################################################################################
-                // HACK HACK HACK HACK FIXME: this is a placeholder for deciding what version to use. For now, it is hardcoded.
-                if (!add.suggests.isEmpty()) {
-                    component->m_version = add.suggests;
-                } else {
-                    if (add.uid == "org.lwjgl") {
-                        component->m_version = "2.9.1";
-                    } else if (add.uid == "org.lwjgl3") {
-                        component->m_version = "3.1.2";
-                    } else if (add.uid == "net.fabricmc.intermediary" || add.uid == "org.quiltmc.hashed") {
-                        auto minecraft = std::find_if(components.begin(), components.end(),
-                                                      [](ComponentPtr& cmp) { return cmp->getID() == "net.minecraft"; });
-                        if (minecraft != components.end()) {
-                            component->m_version = (*minecraft)->getVersion();
-                        }
-                    }
-                }
-                // HACK HACK HACK HACK FIXME: this is a placeholder for deciding what version to use. For now, it is hardcoded.
-                // ############################################################################################################
+                component->m_version = pickVersion(add, components);
             }
             component->m_dependencyOnly = true;
             // FIXME: this should not work directly with the component list
@@ -516,6 +523,45 @@ void ComponentUpdateTask::resolveDependencies(bool checkOnly)
     }
 }
 
+void ComponentUpdateTask::prefetchRequirements(const Meta::RequireSet& requirements)
+{
+    // launching doesn't add anything
+    if (d->mode == Mode::Launch) {
+        return;
+    }
+    auto& components = d->m_list->d->components;
+    auto& componentIndex = d->m_list->d->componentIndex;
+    for (auto& req : requirements) {
+        QString version = req.equalsVersion;
+        auto existing = componentIndex.find(req.uid);
+        if (existing != componentIndex.end()) {
+            // loaded with the components, unless the resolution is going to change its version
+            auto& comp = *existing;
+            if (version.isEmpty() || comp->getVersion() == version || comp->isCustom() || !comp->m_dependencyOnly) {
+                continue;
+            }
+        } else if (version.isEmpty()) {
+            version = pickVersion(req, components);
+        }
+        if (version.isEmpty() || d->prefetched.contains(req.uid + '/' + version)) {
+            continue;
+        }
+        d->prefetched.insert(req.uid + '/' + version);
+
+        auto metaVersion = APPLICATION->metadataIndex()->get(req.uid, version);
+        if (!metaVersion->isLoaded()) {
+            metaVersion->load(d->netmode);
+        }
+        if (auto loadTask = metaVersion->getCurrentTask()) {
+            qDebug() << "Prefetching" << req.uid << version;
+            // failing is fine here, the next round of loading the components finds out about it
+            connect(loadTask.get(), &Task::succeeded, this, [this, metaVersion] { prefetchRequirements(metaVersion->requiredSet()); });
+        } else if (metaVersion->isLoaded()) {
+            prefetchRequirements(metaVersion->requiredSet());
+        }
+    }
+}
+
 void ComponentUpdateTask::remoteLoadSucceeded(size_t taskIndex)
 {
     auto& taskSlot = d->remoteLoadStatusList[taskIndex];
@@ -532,6 +578,7 @@ void ComponentUpdateTask::remoteLoadSucceeded(size_t taskIndex)
         auto component = d->m_list->getComponent(taskSlot.PackProfileIndex);
         component->m_loaded = true;
         component->updateCachedData();
+        prefetchRequirements(component->m_cachedRequires);
     }
     checkIfAllFinished();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "meta/JsonFormat.h"
 #include "net/Mode.h"
 #include "tasks/Task.h"
 
@@ -22,6 +23,8 @@ class ComponentUpdateTask : public Task {
    private:
     void loadComponents();
     void resolveDependencies(bool checkOnly);
+    /// start loading the versions the requirements will most likely be resolved to, and what those require in turn
+    void prefetchRequirements(const Meta::RequireSet& requirements);
 
     void remoteLoadSucceeded(size_t index);
     void remoteLoadFailed(size_t index, const QString& msg);
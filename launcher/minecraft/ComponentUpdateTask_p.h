@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QList>
+#include <QSet>
 #include <QString>
 #include <cstddef>
 #include "net/Mode.h"
@@ -20,6 +21,8 @@ struct ComponentUpdateTaskData {
     QList<RemoteLoadStatus> remoteLoadStatusList;
     bool remoteLoadSuccessful = true;
     size_t remoteTasksInProgress = 0;
+    // uid/version of what was already prefetched
+    QSet<QString> prefetched;
     ComponentUpdateTask::Mode mode;
     Net::Mode netmode;
 };
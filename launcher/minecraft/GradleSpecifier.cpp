@@ -0,0 +1,105 @@
+#include "GradleSpecifier.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+namespace {
+std::shared_ptr<const GradleSpecifier::Data> parse(const QString& value)
+{
+    /*
+    org.gradle.test.classifiers : service : 1.0 : jdk15 @ jar
+     0 "org.gradle.test.classifiers:service:1.0:jdk15@jar"
+     1 "org.gradle.test.classifiers"
+     2 "service"
+     3 "1.0"
+     4 "jdk15"
+     5 "jar"
+    */
+    static const QRegularExpression s_matcher(
+        QRegularExpression::anchoredPattern("([^:@]+):([^:@]+):([^:@]+)"
+                                            "(?::([^:@]+))?"
+                                            "(?:@([^:@]+))?"));
+    auto data = std::make_shared<GradleSpecifier::Data>();
+    QRegularExpressionMatch match = s_matcher.match(value);
+    data->valid = match.hasMatch();
+    if (!data->valid) {
+        data->invalidValue = value;
+        return data;
+    }
+    data->groupId = match.captured(1);
+    data->artifactId = match.captured(2);
+    data->version = match.captured(3);
+    data->classifier = match.captured(4);
+    if (match.lastCapturedIndex() >= 5) {
+        data->extension = match.captured(5);
+    }
+
+    data->artifactPrefix = data->groupId + ":" + data->artifactId;
+    data->serialized = data->artifactPrefix + ":" + data->version;
+    if (!data->classifier.isEmpty()) {
+        data->serialized += ":" + data->classifier;
+    }
+    if (data->extension.isExplicit()) {
+        data->serialized += "@" + data->extension;
+    }
+
+    data->fileName = data->artifactId + '-' + data->version;
+    if (!data->classifier.isEmpty()) {
+        data->fileName += "-" + data->classifier;
+    }
+    data->fileName += "." + data->extension;
+
+    data->directory = data->groupId;
+    data->directory.replace('.', '/');
+    data->directory += '/' + data->artifactId + '/' + data->version + '/';
+    data->path = data->directory + data->fileName;
+    return data;
+}
+
+// there are only so many libraries, the table never has to forget any
+std::shared_ptr<const GradleSpecifier::Data> intern(const QString& value)
+{
+    static QMutex s_mutex;
+    static QHash<QString, std::shared_ptr<const GradleSpecifier::Data>> s_table;
+
+    QMutexLocker locker(&s_mutex);
+    auto& data = s_table[value];
+    if (!data)
+        data = parse(value);
+    return data;
+}
+}  // namespace
+
+GradleSpecifier::GradleSpecifier()
+{
+    static const auto s_invalid = std::make_shared<const Data>();
+    m_data = s_invalid;
+}
+
+GradleSpecifier& GradleSpecifier::operator=(const QString& value)
+{
+    m_data = intern(value);
+    return *this;
+}
+
+void GradleSpecifier::setClassifier(const QString& classifier)
+{
+    if (classifier == m_data->classifier)
+        return;
+    if (!m_data->valid) {
+        auto data = std::make_shared<Data>(*m_data);
+        data->classifier = classifier;
+        m_data = data;
+        return;
+    }
+    QString value = m_data->artifactPrefix + ":" + m_data->version;
+    if (!classifier.isEmpty()) {
+        value += ":" + classifier;
+    }
+    if (m_data->extension.isExplicit()) {
+        value += "@" + m_data->extension;
+    }
+    m_data = intern(value);
+}
@@ -0,0 +1,71 @@
+#include "LaunchPlan.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Exception.h"
+#include "Json.h"
+
+static QStringList readList(const QJsonObject& root, const QString& key)
+{
+    QStringList list;
+    for (auto value : Json::ensureArray(root, key))
+        list.append(value.toString());
+    return list;
+}
+
+LaunchPlan::Ptr LaunchPlan::load(const QString& path, const QString& key)
+{
+    QFile file(path);
+    if (key.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return nullptr;
+
+    auto root = QJsonDocument::fromJson(file.readAll()).object();
+    // check file version first
+    if (Json::ensureString(root, "version") != "1" || Json::ensureString(root, "key") != key)
+        return nullptr;
+
+    auto plan = std::make_shared<LaunchPlan>();
+    plan->key = key;
+    plan->classPath = readList(root, "class_path");
+    plan->nativeJars = readList(root, "native_jars");
+    plan->mainClass = Json::ensureString(root, "main_class");
+    plan->appletClass = Json::ensureString(root, "applet_class");
+    plan->jvmArguments = readList(root, "jvm_arguments");
+    plan->minecraftArguments = Json::ensureString(root, "minecraft_arguments");
+    plan->minecraftVersion = Json::ensureString(root, "minecraft_version");
+    plan->minecraftVersionType = Json::ensureString(root, "minecraft_version_type");
+    plan->assetsId = Json::ensureString(root, "assets_id");
+    for (auto& trait : readList(root, "traits"))
+        plan->traits.insert(trait);
+    return plan;
+}
+
+void LaunchPlan::save(const QString& path) const
+{
+    if (key.isEmpty())
+        return;
+
+    QJsonObject root;
+    Json::writeString(root, "version", "1");
+    Json::writeString(root, "key", key);
+    Json::writeStringList(root, "class_path", classPath);
+    Json::writeStringList(root, "native_jars", nativeJars);
+    Json::writeString(root, "main_class", mainClass);
+    Json::writeString(root, "applet_class", appletClass);
+    Json::writeStringList(root, "jvm_arguments", jvmArguments);
+    Json::writeString(root, "minecraft_arguments", minecraftArguments);
+    Json::writeString(root, "minecraft_version", minecraftVersion);
+    Json::writeString(root, "minecraft_version_type", minecraftVersionType);
+    Json::writeString(root, "assets_id", assetsId);
+    Json::writeStringList(root, "traits", traits.values());
+
+    try {
+        Json::write(root, path);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing launch plan:" << e.what();
+    }
+}
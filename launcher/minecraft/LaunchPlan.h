@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+/**
+ * What launching an instance needs from its resolved components, saved next to the instance.
+ *
+ * Resolving the components into a launch profile, evaluating the library rules and building the class path takes a
+ * while and comes out the same every time the components don't change. The plan is saved with a key describing the
+ * components, their version files and the runtime context, and only rebuilt once that key changes.
+ */
+struct LaunchPlan {
+    using Ptr = std::shared_ptr<const LaunchPlan>;
+
+    /// describes everything the plan was built from, a plan with another key is outdated
+    QString key;
+
+    QStringList classPath;
+    QStringList nativeJars;
+    QString mainClass;
+    QString appletClass;
+    /// the JVM arguments the components add, agents included
+    QStringList jvmArguments;
+    /// the game arguments, with the ${...} tokens still in them
+    QString minecraftArguments;
+    QString minecraftVersion;
+    QString minecraftVersionType;
+    QString assetsId;
+    QSet<QString> traits;
+
+    /// the plan saved at path, if it's there and has that key
+    static Ptr load(const QString& path, const QString& key);
+    /// save the plan to path, failing to do so only means it's built again next time
+    void save(const QString& path) const;
+};
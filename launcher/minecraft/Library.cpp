@@ -197,12 +197,18 @@ QList<NetAction::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext
 
 bool Library::isActive(const RuntimeContext& runtimeContext) const
 {
+    // the rules and natives only look at the classifier of the context
+    const QString classifier = runtimeContext.getClassifier();
+    QMutexLocker locker(&m_activeLock);
+    if (!m_activeClassifier.isEmpty() && m_activeClassifier == classifier)
+        return m_active;
+
     bool result = true;
     if (m_rules.empty()) {
         result = true;
     } else {
         RuleAction ruleResult = Disallow;
-        for (auto rule : m_rules) {
+        for (auto& rule : m_rules) {
             RuleAction temp = rule->apply(this, runtimeContext);
             if (temp != Defer)
                 ruleResult = temp;
@@ -212,6 +218,9 @@ bool Library::isActive(const RuntimeContext& runtimeContext) const
     if (isNative()) {
         result = result && !getCompatibleNative(runtimeContext).isNull();
     }
+
+    m_activeClassifier = classifier;
+    m_active = result;
     return result;
 }
 
@@ -38,6 +38,7 @@
 #include <QDir>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QPair>
 #include <QString>
 #include <QStringList>
@@ -129,7 +130,12 @@ class Library {
     void setHint(const QString& hint) { m_hint = hint; }
 
     /// Set the load rules
-    void setRules(QList<std::shared_ptr<Rule>> rules) { m_rules = rules; }
+    void setRules(QList<std::shared_ptr<Rule>> rules)
+    {
+        m_rules = rules;
+        QMutexLocker locker(&m_activeLock);
+        m_activeClassifier.clear();
+    }
 
     /// Returns true if the library should be loaded (or extracted, in case of natives)
     bool isActive(const RuntimeContext& runtimeContext) const;
@@ -207,4 +213,9 @@ class Library {
 
     /// MOJANG: container with Mojang style download info
     MojangLibraryDownloadInfo::Ptr m_mojangDownloads;
+
+    /// what isActive() said last and for which classifier, profiles are applied many times for the same one
+    mutable QMutex m_activeLock;
+    mutable QString m_activeClassifier;
+    mutable bool m_active = false;
 };
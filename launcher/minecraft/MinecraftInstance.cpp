@@ -47,6 +47,7 @@
 #include "FileSystem.h"
 #include "MMCTime.h"
 #include "java/JavaVersion.h"
+#include "java/JvmTuning.h"
 #include "pathmatcher/MultiMatcher.h"
 #include "pathmatcher/RegexpMatcher.h"
 
@@ -62,6 +63,7 @@
 #include "minecraft/launch/ClaimAccount.h"
 #include "minecraft/launch/LauncherPartLaunch.h"
 #include "minecraft/launch/ModMinecraftJar.h"
+#include "minecraft/launch/PrewarmFiles.h"
 #include "minecraft/launch/ReconstructAssets.h"
 #include "minecraft/launch/ScanModFolders.h"
 #include "minecraft/launch/VerifyJavaInstall.h"
@@ -90,6 +92,10 @@
 #include "tools/BaseProfiler.h"
 
 #include <QActionGroup>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+
+#include <sys.h>
 
 #ifdef Q_OS_LINUX
 #include "MangoHud.h"
@@ -125,6 +131,7 @@ MinecraftInstance::MinecraftInstance(SettingsObjectPtr globalSettings, SettingsO
 
 void MinecraftInstance::saveNow()
 {
+    m_settings->saveNow();
     m_components->saveNow();
 }
 
@@ -165,6 +172,7 @@ void MinecraftInstance::loadSpecificSettings()
         m_settings->registerOverride(global_settings->getSetting("MinMemAlloc"), memorySetting);
         m_settings->registerOverride(global_settings->getSetting("MaxMemAlloc"), memorySetting);
         m_settings->registerOverride(global_settings->getSetting("PermGen"), memorySetting);
+        m_settings->registerOverride(global_settings->getSetting("AutoTuneMemory"), memorySetting);
 
         // Native library workarounds
         auto nativeLibraryWorkaroundsOverride = m_settings->registerSetting("OverrideNativeWorkarounds", false);
@@ -178,6 +186,8 @@ void MinecraftInstance::loadSpecificSettings()
         m_settings->registerOverride(global_settings->getSetting("EnableFeralGamemode"), performanceOverride);
         m_settings->registerOverride(global_settings->getSetting("EnableMangoHud"), performanceOverride);
         m_settings->registerOverride(global_settings->getSetting("UseDiscreteGpu"), performanceOverride);
+        m_settings->registerOverride(global_settings->getSetting("UseClassDataSharing"), performanceOverride);
+        m_settings->registerOverride(global_settings->getSetting("PrewarmLaunchFiles"), performanceOverride);
 
         // Miscellaneous
         auto miscellaneousOverride = m_settings->registerSetting("OverrideMiscellaneous", false);
@@ -399,26 +409,82 @@ QDir MinecraftInstance::versionsPath() const
     return QDir::current().absoluteFilePath("versions");
 }
 
-QStringList MinecraftInstance::getClassPath()
+LaunchPlan::Ptr MinecraftInstance::launchPlan() const
 {
-    QStringList jars, nativeJars;
+    if (!m_components)
+        return nullptr;
+
+    // everything going into the plan: the components, the runtime the rules are evaluated for and where the files are
+    QString key;
+    if (auto components = m_components->stateKey(); !components.isEmpty()) {
+        auto context = runtimeContext();
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(components.toUtf8());
+        hash.addData(context.javaArchitecture.toUtf8());
+        hash.addData(context.javaRealArchitecture.toUtf8());
+        hash.addData(context.system.toUtf8());
+        hash.addData(QDir::currentPath().toUtf8());
+        hash.addData(getLocalLibraryPath().toUtf8());
+        hash.addData(binRoot().toUtf8());
+        hash.addData(BuildConfig.printableVersionString().toUtf8());
+        key = hash.result().toHex();
+    }
+    if (!key.isEmpty() && m_launch_plan && m_launch_plan->key == key)
+        return m_launch_plan;
+
+    auto planFile = FS::PathCombine(instanceRoot(), ".launchplan.json");
+    if (auto saved = LaunchPlan::load(planFile, key)) {
+        m_launch_plan = saved;
+        return saved;
+    }
+
     auto profile = m_components->getProfile();
-    profile->getLibraryFiles(runtimeContext(), jars, nativeJars, getLocalLibraryPath(), binRoot());
-    return jars;
+    if (!profile)
+        return nullptr;
+    auto plan = std::make_shared<LaunchPlan>();
+    plan->key = key;
+    profile->getLibraryFiles(runtimeContext(), plan->classPath, plan->nativeJars, getLocalLibraryPath(), binRoot());
+    plan->mainClass = profile->getMainClass();
+    plan->appletClass = profile->getAppletClass();
+    plan->jvmArguments = profile->getAddnJvmArguments();
+    for (auto agent : profile->getAgents()) {
+        QStringList jar, temp1, temp2, temp3;
+        agent->library()->getApplicableFiles(runtimeContext(), jar, temp1, temp2, temp3, getLocalLibraryPath());
+        plan->jvmArguments.append("-javaagent:" + jar[0] + (agent->argument().isEmpty() ? "" : "=" + agent->argument()));
+    }
+    plan->minecraftArguments = profile->getMinecraftArguments();
+    for (auto tweaker : profile->getTweakers()) {
+        plan->minecraftArguments += " --tweakClass " + tweaker;
+    }
+    plan->minecraftVersion = profile->getMinecraftVersion();
+    plan->minecraftVersionType = profile->getMinecraftVersionType();
+    if (auto assets = profile->getMinecraftAssets())
+        plan->assetsId = assets->id;
+    plan->traits = profile->getTraits();
+
+    // a broken profile is resolved again, it may be fixed by then
+    if (profile->getProblemSeverity() != ProblemSeverity::Error)
+        plan->save(planFile);
+    m_launch_plan = plan;
+    return plan;
+}
+
+QStringList MinecraftInstance::getClassPath()
+{
+    auto plan = launchPlan();
+    return plan ? plan->classPath : QStringList();
 }
 
 QString MinecraftInstance::getMainClass() const
 {
-    auto profile = m_components->getProfile();
-    return profile->getMainClass();
+    auto plan = launchPlan();
+    return plan ? plan->mainClass : QString();
 }
 
 QStringList MinecraftInstance::getNativeJars()
 {
-    QStringList jars, nativeJars;
-    auto profile = m_components->getProfile();
-    profile->getLibraryFiles(runtimeContext(), jars, nativeJars, getLocalLibraryPath(), binRoot());
-    return nativeJars;
+    auto plan = launchPlan();
+    return plan ? plan->nativeJars : QStringList();
 }
 
 QStringList MinecraftInstance::extraArguments()
@@ -431,15 +497,8 @@ QStringList MinecraftInstance::extraArguments()
     if (!jarMods.isEmpty()) {
         list.append({ "-Dfml.ignoreInvalidMinecraftCertificates=true", "-Dfml.ignorePatchDiscrepancies=true" });
     }
-    auto addn = m_components->getProfile()->getAddnJvmArguments();
-    if (!addn.isEmpty()) {
-        list.append(addn);
-    }
-    auto agents = m_components->getProfile()->getAgents();
-    for (auto agent : agents) {
-        QStringList jar, temp1, temp2, temp3;
-        agent->library()->getApplicableFiles(runtimeContext(), jar, temp1, temp2, temp3, getLocalLibraryPath());
-        list.append("-javaagent:" + jar[0] + (agent->argument().isEmpty() ? "" : "=" + agent->argument()));
+    if (auto plan = launchPlan()) {
+        list.append(plan->jvmArguments);
     }
 
     {
@@ -499,18 +558,22 @@ QStringList MinecraftInstance::javaArguments()
         "minecraft.exe.heapdump");
 #endif
 
-    int min = settings()->get("MinMemAlloc").toInt();
-    int max = settings()->get("MaxMemAlloc").toInt();
-    if (min < max) {
-        args << QString("-Xms%1m").arg(min);
-        args << QString("-Xmx%1m").arg(max);
+    JavaVersion javaVersion = getJavaVersion();
+    if (settings()->get("AutoTuneMemory").toBool()) {
+        args << autoTunedArguments();
     } else {
-        args << QString("-Xms%1m").arg(max);
-        args << QString("-Xmx%1m").arg(min);
+        int min = settings()->get("MinMemAlloc").toInt();
+        int max = settings()->get("MaxMemAlloc").toInt();
+        if (min < max) {
+            args << QString("-Xms%1m").arg(min);
+            args << QString("-Xmx%1m").arg(max);
+        } else {
+            args << QString("-Xms%1m").arg(max);
+            args << QString("-Xmx%1m").arg(min);
+        }
     }
 
     // No PermGen in newer java.
-    JavaVersion javaVersion = getJavaVersion();
     if (javaVersion.requiresPermGen()) {
         auto permgen = settings()->get("PermGen").toInt();
         if (permgen != 64) {
@@ -528,6 +591,74 @@ QStringList MinecraftInstance::javaArguments()
     return args;
 }
 
+QStringList MinecraftInstance::autoTunedArguments()
+{
+    JvmTuning::Inputs inputs;
+    inputs.javaMajor = getJavaVersion().major();
+    inputs.javaVendor = settings()->get("JavaVendor").toString();
+    inputs.is64Bit = settings()->get("JavaArchitecture").toString() != "32";
+    if (auto loaders = m_components->getModLoaders(); loaders && *loaders) {
+        inputs.modded = true;
+        inputs.forgeLike = *loaders & (ModPlatform::NeoForge | ModPlatform::Forge | ModPlatform::Cauldron);
+        inputs.modCount = QDir(modsRoot()).entryList({ "*.jar", "*.zip" }, QDir::Files).size();
+    }
+    inputs.totalRam = Sys::getSystemRam();
+    inputs.availableRam = Sys::getAvailableRam();
+
+    auto gcLog = FS::PathCombine(gameRoot(), "logs", "gc.log");
+    inputs.previousSession = JvmTuning::readGcLog(gcLog);
+    auto tuning = JvmTuning::tune(inputs);
+
+    QStringList args;
+    args << QString("-Xms%1m").arg(tuning.minHeap);
+    args << QString("-Xmx%1m").arg(tuning.maxHeap);
+
+    // a second collector stops Java from starting at all, the one the user asked for stays
+    static const QRegularExpression s_collector(R"(-XX:\+Use\w+GC\b)");
+    if (!extraArguments().join(' ').contains(s_collector))
+        args << tuning.gcArguments;
+
+    // Java can't create the log's folder, and refuses to start when it can't open the log
+    auto gcLogArgs = JvmTuning::gcLogArguments(gcLog, inputs.javaMajor);
+    if (!gcLogArgs.isEmpty() && FS::ensureFolderPathExists(QFileInfo(gcLog).absolutePath()))
+        args << gcLogArgs;
+    return args;
+}
+
+QString MinecraftInstance::classDataSharingArgument(const QStringList& classPath)
+{
+    if (!settings()->get("UseClassDataSharing").toBool())
+        return {};
+    // dynamic archives came with Java 13
+    if (getJavaVersion().major() < 13)
+        return {};
+
+    // an archive is only good for the same classes, so the same class path, Java and mods
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(classPath.join('\n').toUtf8());
+    QFileInfo java(FS::ResolveExecutable(settings()->get("JavaPath").toString()));
+    hash.addData(QString("%1|%2|%3|%4\n")
+                     .arg(java.absoluteFilePath(), settings()->get("JavaVersion").toString())
+                     .arg(java.size())
+                     .arg(java.lastModified().toMSecsSinceEpoch())
+                     .toUtf8());
+    for (auto& mod : QDir(modsRoot()).entryInfoList(QDir::Files, QDir::Name)) {
+        hash.addData(QString("%1|%2|%3\n").arg(mod.fileName()).arg(mod.size()).arg(mod.lastModified().toMSecsSinceEpoch()).toUtf8());
+    }
+
+    QDir dir(FS::PathCombine(instanceRoot(), ".cds"));
+    auto name = QString::fromLatin1(hash.result().toHex()) + ".jsa";
+    if (dir.exists(name))
+        return "-XX:SharedArchiveFile=" + dir.absoluteFilePath(name);
+
+    // the old archives are of no use anymore
+    for (auto& old : dir.entryList({ "*.jsa" }, QDir::Files))
+        dir.remove(old);
+    if (!FS::ensureFolderPathExists(dir.absolutePath()))
+        return {};
+    return "-XX:ArchiveClassesAtExit=" + dir.absoluteFilePath(name);
+}
+
 QString MinecraftInstance::getLauncher()
 {
     // use legacy launcher if the traits are set
@@ -635,7 +766,7 @@ static QString replaceTokensIn(QString text, QMap<QString, QString> with)
 {
     // TODO: does this still work??
     QString result;
-    QRegularExpression token_regexp("\\$\\{(.+)\\}", QRegularExpression::InvertedGreedinessOption);
+    static const QRegularExpression token_regexp("\\$\\{(.+)\\}", QRegularExpression::InvertedGreedinessOption);
     QStringList list;
     QRegularExpressionMatchIterator i = token_regexp.globalMatch(text);
     int lastCapturedEnd = 0;
@@ -655,11 +786,10 @@ static QString replaceTokensIn(QString text, QMap<QString, QString> with)
 
 QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session, MinecraftServerTargetPtr serverToJoin) const
 {
-    auto profile = m_components->getProfile();
-    QString args_pattern = profile->getMinecraftArguments();
-    for (auto tweaker : profile->getTweakers()) {
-        args_pattern += " --tweakClass " + tweaker;
-    }
+    auto plan = launchPlan();
+    if (!plan)
+        return {};
+    QString args_pattern = plan->minecraftArguments;
 
     if (serverToJoin && !serverToJoin->address.isEmpty()) {
         args_pattern += " --server " + serverToJoin->address;
@@ -682,18 +812,17 @@ QStringList MinecraftInstance::processMinecraftArgs(AuthSessionPtr session, Mine
     }
 
     token_mapping["profile_name"] = name();
-    token_mapping["version_name"] = profile->getMinecraftVersion();
-    token_mapping["version_type"] = profile->getMinecraftVersionType();
+    token_mapping["version_name"] = plan->minecraftVersion;
+    token_mapping["version_type"] = plan->minecraftVersionType;
 
     QString absRootDir = QDir(gameRoot()).absolutePath();
     token_mapping["game_directory"] = absRootDir;
     QString absAssetsDir = QDir("assets/").absolutePath();
-    auto assets = profile->getMinecraftAssets();
-    token_mapping["game_assets"] = AssetsUtils::getAssetsDir(assets->id, resourcesDir()).absolutePath();
+    token_mapping["game_assets"] = AssetsUtils::getAssetsDir(plan->assetsId, resourcesDir()).absolutePath();
 
     // 1.7.3+ assets tokens
     token_mapping["assets_root"] = absAssetsDir;
-    token_mapping["assets_index_name"] = assets->id;
+    token_mapping["assets_index_name"] = plan->assetsId;
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
     QStringList parts = args_pattern.split(' ', Qt::SkipEmptyParts);
@@ -710,17 +839,15 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session, MinecraftS
 {
     QString launchScript;
 
-    if (!m_components)
-        return QString();
-    auto profile = m_components->getProfile();
-    if (!profile)
+    auto plan = launchPlan();
+    if (!plan)
         return QString();
 
-    auto mainClass = getMainClass();
+    auto mainClass = plan->mainClass;
     if (!mainClass.isEmpty()) {
         launchScript += "mainClass " + mainClass + "\n";
     }
-    auto appletClass = profile->getAppletClass();
+    auto appletClass = plan->appletClass;
     if (!appletClass.isEmpty()) {
         launchScript += "appletClass " + appletClass + "\n";
     }
@@ -767,7 +894,7 @@ QString MinecraftInstance::createLaunchScript(AuthSessionPtr session, MinecraftS
         launchScript += "sessionId " + session->session + "\n";
     }
 
-    for (auto trait : profile->getTraits()) {
+    for (auto trait : plan->traits) {
         launchScript += "traits " + trait + "\n";
     }
 
@@ -921,44 +1048,12 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString& line, MessageLevel::Enum level)
 {
-    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-    auto match = re.match(line);
-    if (match.hasMatch()) {
-        // New style logs from log4j
-        QString timestamp = match.captured("timestamp");
-        QString levelStr = match.captured("level");
-        if (levelStr == "INFO")
-            level = MessageLevel::Message;
-        if (levelStr == "WARN")
-            level = MessageLevel::Warning;
-        if (levelStr == "ERROR")
-            level = MessageLevel::Error;
-        if (levelStr == "FATAL")
-            level = MessageLevel::Fatal;
-        if (levelStr == "TRACE" || levelStr == "DEBUG")
-            level = MessageLevel::Debug;
-    } else {
-        // Old style forge logs
-        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") || line.contains("[FINER]") ||
-            line.contains("[FINEST]"))
-            level = MessageLevel::Message;
-        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-            level = MessageLevel::Error;
-        if (line.contains("[WARNING]"))
-            level = MessageLevel::Warning;
-        if (line.contains("[DEBUG]"))
-            level = MessageLevel::Debug;
-    }
-    if (line.contains("overwriting existing"))
-        return MessageLevel::Fatal;
-    // NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-    if (line.contains("Exception in thread") || line.contains(QRegularExpression("\\s+at " + javaSymbol)) ||
-        line.contains(QRegularExpression("Caused by: " + javaSymbol)) ||
-        line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")) ||
-        line.contains(QRegularExpression("... \\d+ more$")))
-        return MessageLevel::Error;
-    return level;
+    return m_log_classifier.classify(line, level);
+}
+
+void MinecraftInstance::guessLevels(const QStringList& lines, QVector<MessageLevel::Enum>& levels)
+{
+    m_log_classifier.classify(lines, levels);
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -983,12 +1078,8 @@ QString MinecraftInstance::getStatusbarDescription()
         traits.append(tr("broken"));
     }
 
+    // answered from the component file while the components aren't loaded, which is enough for this
     QString mcVersion = m_components->getComponentVersion("net.minecraft");
-    if (mcVersion.isEmpty()) {
-        // Load component info if needed
-        m_components->reload(Net::Mode::Offline);
-        mcVersion = m_components->getComponentVersion("net.minecraft");
-    }
 
     QString description;
     description.append(tr("Minecraft %1").arg(mcVersion));
@@ -1041,27 +1132,27 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         process->appendStep(makeShared<TextPrint>(pptr, "Minecraft folder is:\n" + gameRoot() + "\n\n", MessageLevel::Launcher));
     }
 
+    // the steps appended with what they wait for run alongside the others, the rest wait for everything before them
     // check java
-    {
-        process->appendStep(makeShared<CheckJava>(pptr));
-    }
+    auto checkJava = makeShared<CheckJava>(pptr);
+    process->appendStep(checkJava, {});
 
     // create the .minecraft folder and server-resource-packs (workaround for Minecraft bug MCL-3732)
-    {
-        process->appendStep(makeShared<CreateGameFolders>(pptr));
-    }
+    auto createFolders = makeShared<CreateGameFolders>(pptr);
+    process->appendStep(createFolders, {});
 
     if (!serverToJoin && settings()->get("JoinServerOnLaunch").toBool()) {
         QString fullAddress = settings()->get("JoinServerOnLaunchAddress").toString();
         serverToJoin.reset(new MinecraftServerTarget(MinecraftServerTarget::parse(fullAddress)));
     }
 
+    shared_qobject_ptr<LookupServerAddress> lookupServer;
     if (serverToJoin && serverToJoin->port == 25565) {
         // Resolve server address to join on launch
-        auto step = makeShared<LookupServerAddress>(pptr);
-        step->setLookupAddress(serverToJoin->address);
-        step->setOutputAddressPtr(serverToJoin);
-        process->appendStep(step);
+        lookupServer = makeShared<LookupServerAddress>(pptr);
+        lookupServer->setLookupAddress(serverToJoin->address);
+        lookupServer->setOutputAddressPtr(serverToJoin);
+        process->appendStep(lookupServer, {});
     }
 
     // run pre-launch command if that's needed
@@ -1072,38 +1163,51 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
     }
 
     // if we aren't in offline mode,.
+    shared_qobject_ptr<Update> update;
     if (session->status != AuthSession::PlayableOffline) {
+        QList<LaunchStep*> claimed;
         if (!session->demo) {
-            process->appendStep(makeShared<ClaimAccount>(pptr, session));
+            auto claim = makeShared<ClaimAccount>(pptr, session);
+            process->appendStep(claim, {});
+            claimed << claim.get();
         }
-        process->appendStep(makeShared<Update>(pptr, Net::Mode::Online));
+        update = makeShared<Update>(pptr, Net::Mode::Online);
+        process->appendStep(update, claimed);
     } else {
-        process->appendStep(makeShared<Update>(pptr, Net::Mode::Offline));
+        update = makeShared<Update>(pptr, Net::Mode::Offline);
+        process->appendStep(update, {});
+    }
+
+    // read what Java needs first ahead while the next steps run
+    if (settings()->get("PrewarmLaunchFiles").toBool()) {
+        process->appendStep(makeShared<PrewarmFiles>(pptr), { update.get() });
     }
 
     // if there are any jar mods
     {
-        process->appendStep(makeShared<ModMinecraftJar>(pptr));
+        process->appendStep(makeShared<ModMinecraftJar>(pptr), { update.get() });
     }
 
     // Scan mods folders for mods
-    {
-        process->appendStep(makeShared<ScanModFolders>(pptr));
-    }
+    auto scanMods = makeShared<ScanModFolders>(pptr);
+    process->appendStep(scanMods, { update.get(), createFolders.get() });
 
     // print some instance info here...
     {
-        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, serverToJoin));
+        QList<LaunchStep*> described = { checkJava.get(), scanMods.get() };
+        if (lookupServer)
+            described << lookupServer.get();
+        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, serverToJoin), described);
     }
 
-    // extract native jars if needed
+    // extract native jars if needed, which depends on the Java version
     {
-        process->appendStep(makeShared<ExtractNatives>(pptr));
+        process->appendStep(makeShared<ExtractNatives>(pptr), { update.get(), checkJava.get() });
     }
 
     // reconstruct assets if needed
     {
-        process->appendStep(makeShared<ReconstructAssets>(pptr));
+        process->appendStep(makeShared<ReconstructAssets>(pptr), { update.get() });
     }
 
     // verify that minimum Java requirements are met
@@ -37,8 +37,11 @@
 #pragma once
 #include <java/JavaVersion.h>
 #include <QDir>
+#include <QHash>
 #include <QProcess>
 #include "BaseInstance.h"
+#include "minecraft/LaunchPlan.h"
+#include "minecraft/MinecraftLogClassifier.h"
 #include "minecraft/launch/MinecraftServerTarget.h"
 #include "minecraft/mod/Mod.h"
 
@@ -118,6 +121,9 @@ class MinecraftInstance : public BaseInstance {
     std::shared_ptr<ShaderPackFolderModel> shaderPackList();
     std::shared_ptr<WorldList> worldList();
     std::shared_ptr<GameOptions> gameOptionsModel();
+    /// what the mod folder at `path` looked like when a launch last scanned it, empty if none did yet
+    QByteArray modFolderScan(const QString& path) const { return m_mod_folder_scans.value(path); }
+    void setModFolderScan(const QString& path, const QByteArray& snapshot) { m_mod_folder_scans.insert(path, snapshot); }
 
     //////  Launch stuff //////
     Task::Ptr createUpdateTask(Net::Mode mode) override;
@@ -128,6 +134,10 @@ class MinecraftInstance : public BaseInstance {
     QString createLaunchScript(AuthSessionPtr session, MinecraftServerTargetPtr serverToJoin);
     /// get arguments passed to java
     QStringList javaArguments();
+    /// the argument to use or record the class data sharing archive of a launch with `classPath`, empty when it's off
+    QString classDataSharingArgument(const QStringList& classPath);
+    /// heap and collector picked for this instance by JvmTuning, from the pack, the system and the last session
+    QStringList autoTunedArguments();
     QString getLauncher();
     bool shouldApplyOnlineFixes();
 
@@ -140,6 +150,7 @@ class MinecraftInstance : public BaseInstance {
 
     /// guess log level from a line of minecraft log
     MessageLevel::Enum guessLevel(const QString& line, MessageLevel::Enum level) override;
+    void guessLevels(const QStringList& lines, QVector<MessageLevel::Enum>& levels) override;
 
     IPathMatcher::Ptr getLogFileMatcher() override;
 
@@ -147,6 +158,9 @@ class MinecraftInstance : public BaseInstance {
 
     QString getStatusbarDescription() override;
 
+    /// what launching needs from the resolved components, rebuilt only when they change
+    LaunchPlan::Ptr launchPlan() const;
+
     // FIXME: remove
     virtual QStringList getClassPath();
     // FIXME: remove
@@ -172,6 +186,10 @@ class MinecraftInstance : public BaseInstance {
     mutable std::shared_ptr<TexturePackFolderModel> m_texture_pack_list;
     mutable std::shared_ptr<WorldList> m_world_list;
     mutable std::shared_ptr<GameOptions> m_game_options;
+    mutable LaunchPlan::Ptr m_launch_plan;
+    // by folder, only for this session since the mod lists start out empty
+    QHash<QString, QByteArray> m_mod_folder_scans;
+    MinecraftLogClassifier m_log_classifier;
 };
 
 using MinecraftInstancePtr = std::shared_ptr<MinecraftInstance>;
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MinecraftLogClassifier.h"
+
+namespace {
+// NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
+const QString javaSymbol = QStringLiteral("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*");
+}  // namespace
+
+MinecraftLogClassifier::MinecraftLogClassifier()
+    : m_log4j("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]")
+    , m_stackFrame("\\s+at " + javaSymbol)
+    , m_causedBy("Caused by: " + javaSymbol)
+    , m_throwable("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)")
+    , m_moreFrames("... \\d+ more$")
+{
+    m_log4j.optimize();
+    m_stackFrame.optimize();
+    m_causedBy.optimize();
+    m_throwable.optimize();
+    m_moreFrames.optimize();
+}
+
+MessageLevel::Enum MinecraftLogClassifier::classify(const QString& line, MessageLevel::Enum level) const
+{
+    // every level marker, old or new style, needs a bracket
+    if (line.contains(QLatin1Char('['))) {
+        QRegularExpressionMatch match;
+        // the log4j pattern always contains "] [" literally, don't bother the regex engine otherwise
+        if (line.contains(QLatin1String("] ["))) {
+            match = m_log4j.match(line);
+        }
+        if (match.hasMatch()) {
+            // New style logs from log4j
+            auto levelStr = match.captured("level");
+            if (levelStr == QLatin1String("INFO"))
+                level = MessageLevel::Message;
+            else if (levelStr == QLatin1String("WARN"))
+                level = MessageLevel::Warning;
+            else if (levelStr == QLatin1String("ERROR"))
+                level = MessageLevel::Error;
+            else if (levelStr == QLatin1String("FATAL"))
+                level = MessageLevel::Fatal;
+            else if (levelStr == QLatin1String("TRACE") || levelStr == QLatin1String("DEBUG"))
+                level = MessageLevel::Debug;
+        } else {
+            // Old style forge logs
+            if (line.contains(QLatin1String("[INFO]")) || line.contains(QLatin1String("[CONFIG]")) ||
+                line.contains(QLatin1String("[FINE]")) || line.contains(QLatin1String("[FINER]")) ||
+                line.contains(QLatin1String("[FINEST]")))
+                level = MessageLevel::Message;
+            if (line.contains(QLatin1String("[SEVERE]")) || line.contains(QLatin1String("[STDERR]")))
+                level = MessageLevel::Error;
+            if (line.contains(QLatin1String("[WARNING]")))
+                level = MessageLevel::Warning;
+            if (line.contains(QLatin1String("[DEBUG]")))
+                level = MessageLevel::Debug;
+        }
+    }
+    if (line.contains(QLatin1String("overwriting existing")))
+        return MessageLevel::Fatal;
+    if (isError(line))
+        return MessageLevel::Error;
+    return level;
+}
+
+bool MinecraftLogClassifier::isError(const QString& line) const
+{
+    if (line.contains(QLatin1String("Exception in thread")))
+        return true;
+    if (line.contains(QLatin1String("at ")) && m_stackFrame.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1String("Caused by: ")) && m_causedBy.match(line).hasMatch())
+        return true;
+    if ((line.contains(QLatin1String("Exception")) || line.contains(QLatin1String("Error")) ||
+         line.contains(QLatin1String("Throwable"))) &&
+        m_throwable.match(line).hasMatch())
+        return true;
+    if (line.endsWith(QLatin1String(" more")) && m_moreFrames.match(line).hasMatch())
+        return true;
+    return false;
+}
+
+void MinecraftLogClassifier::classify(const QStringList& lines, QVector<MessageLevel::Enum>& levels) const
+{
+    Q_ASSERT(lines.size() == levels.size());
+    for (int i = 0; i < lines.size(); i++) {
+        if (isUndetermined(levels[i])) {
+            levels[i] = classify(lines[i], levels[i]);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+#include "MessageLevel.h"
+
+/**
+ * Guesses the level of Minecraft log lines.
+ *
+ * All the patterns are compiled once on construction, and every regular expression is guarded by a cheap substring
+ * check so the vast majority of lines never touch the regex engine at all.
+ *
+ * classify() is const and does not touch any shared state, so a single classifier may be used from several threads.
+ */
+class MinecraftLogClassifier {
+   public:
+    MinecraftLogClassifier();
+
+    /// guess the level of a single line, `level` is the level to keep if nothing more specific is found
+    MessageLevel::Enum classify(const QString& line, MessageLevel::Enum level) const;
+
+    /**
+     * guess the levels of a batch of lines
+     * `levels` must have one entry per line and is updated in place.
+     * Only lines that are still undetermined (StdOut, StdErr or Unknown) are looked at.
+     */
+    void classify(const QStringList& lines, QVector<MessageLevel::Enum>& levels) const;
+
+    /// true if the level of a line with this level should be guessed
+    static bool isUndetermined(MessageLevel::Enum level)
+    {
+        return level == MessageLevel::StdErr || level == MessageLevel::StdOut || level == MessageLevel::Unknown;
+    }
+
+   private:
+    bool isError(const QString& line) const;
+
+   private:
+    // new style logs from log4j: "[12:34:56] [Thread/LEVEL]"
+    QRegularExpression m_log4j;
+    // stack traces
+    QRegularExpression m_stackFrame;
+    QRegularExpression m_causedBy;
+    QRegularExpression m_throwable;
+    QRegularExpression m_moreFrames;
+};
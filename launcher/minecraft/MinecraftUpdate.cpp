@@ -23,6 +23,7 @@
 
 #include <FileSystem.h>
 #include "BaseInstance.h"
+#include "launch/LaunchCoordinator.h"
 #include "minecraft/Library.h"
 #include "minecraft/PackProfile.h"
 
@@ -38,129 +39,60 @@ MinecraftUpdate::MinecraftUpdate(MinecraftInstance* inst, QObject* parent) : Tas
 
 void MinecraftUpdate::executeTask()
 {
-    m_tasks.clear();
+    m_graph = makeShared<TaskGraph>(nullptr, tr("Minecraft update"));
+
     // create folders
-    {
-        m_tasks.append(makeShared<FoldersTask>(m_inst));
-    }
+    auto folders = makeShared<FoldersTask>(m_inst);
+    addSubtask(folders, {});
 
-    // add metadata update task if necessary
+    // what comes next needs the components resolved, they're updated first if necessary
+    QList<Task::Ptr> resolved{ folders };
     {
         auto components = m_inst->getPackProfile();
         components->reload(Net::Mode::Online);
         auto task = components->getCurrentTask();
-        if (task) {
-            m_tasks.append(task);
+        if (task && !task->isFinished()) {
+            addSubtask(task, {});
+            resolved.append(task);
         }
     }
 
-    // libraries download
-    {
-        m_tasks.append(makeShared<LibrariesTask>(m_inst));
-    }
-
-    // FML libraries download and copy into the instance
-    {
-        m_tasks.append(makeShared<FMLLibrariesTask>(m_inst));
-    }
-
-    // assets update
-    {
-        m_tasks.append(makeShared<AssetUpdateTask>(m_inst));
-    }
+    // the libraries, the FML libraries and the assets don't need each other and are downloaded together,
+    // launches of the same pack at the same time check the libraries and the assets once
+    auto inst = m_inst;
+    addSubtask(makeShared<SharedWork>([inst] { return LibrariesTask::sharedKey(inst); },
+                                      [inst] { return makeShared<LibrariesTask>(inst); }),
+               resolved);
+    addSubtask(makeShared<FMLLibrariesTask>(m_inst), resolved);
+    addSubtask(makeShared<SharedWork>([inst] { return AssetUpdateTask::sharedKey(inst); },
+                                      [inst] { return makeShared<AssetUpdateTask>(inst); }),
+               resolved);
 
     if (!m_preFailure.isEmpty()) {
         emitFailed(m_preFailure);
         return;
     }
-    next();
+
+    connect(m_graph.get(), &Task::succeeded, this, &MinecraftUpdate::emitSucceeded);
+    connect(m_graph.get(), &Task::failed, this, &MinecraftUpdate::emitFailed);
+    connect(m_graph.get(), &Task::aborted, this, [this] { emitFailed(tr("Aborted by user.")); });
+    connect(m_graph.get(), &Task::progress, this, &MinecraftUpdate::setProgress);
+    connect(m_graph.get(), &Task::stepProgress, this, &MinecraftUpdate::propagateStepProgress);
+    m_graph->start();
 }
 
-void MinecraftUpdate::next()
+void MinecraftUpdate::addSubtask(Task::Ptr task, const QList<Task::Ptr>& dependencies)
 {
-    if (m_abort) {
-        emitFailed(tr("Aborted by user."));
-        return;
-    }
-    if (m_failed_out_of_order) {
-        emitFailed(m_fail_reason);
-        return;
-    }
-    m_currentTask++;
-    if (m_currentTask > 0) {
-        auto task = m_tasks[m_currentTask - 1];
-        disconnect(task.get(), &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
-        disconnect(task.get(), &Task::failed, this, &MinecraftUpdate::subtaskFailed);
-        disconnect(task.get(), &Task::aborted, this, &Task::abort);
-        disconnect(task.get(), &Task::progress, this, &MinecraftUpdate::progress);
-        disconnect(task.get(), &Task::stepProgress, this, &MinecraftUpdate::propagateStepProgress);
-        disconnect(task.get(), &Task::status, this, &MinecraftUpdate::setStatus);
-        disconnect(task.get(), &Task::details, this, &MinecraftUpdate::setDetails);
-    }
-    if (m_currentTask == m_tasks.size()) {
-        emitSucceeded();
-        return;
-    }
-    auto task = m_tasks[m_currentTask];
-    // if the task is already finished by the time we look at it, skip it
-    if (task->isFinished()) {
-        qCritical() << "MinecraftUpdate: Skipping finished subtask" << m_currentTask << ":" << task.get();
-        next();
-    }
-    connect(task.get(), &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
-    connect(task.get(), &Task::failed, this, &MinecraftUpdate::subtaskFailed);
-    connect(task.get(), &Task::aborted, this, &Task::abort);
-    connect(task.get(), &Task::progress, this, &MinecraftUpdate::progress);
-    connect(task.get(), &Task::stepProgress, this, &MinecraftUpdate::propagateStepProgress);
+    // what the running ones are doing says more than how many of them there are
     connect(task.get(), &Task::status, this, &MinecraftUpdate::setStatus);
     connect(task.get(), &Task::details, this, &MinecraftUpdate::setDetails);
-    // if the task is already running, do not start it again
-    if (!task->isRunning()) {
-        task->start();
-    }
-}
-
-void MinecraftUpdate::subtaskSucceeded()
-{
-    if (isFinished()) {
-        qCritical() << "MinecraftUpdate: Subtask" << sender() << "succeeded, but work was already done!";
-        return;
-    }
-    auto senderTask = QObject::sender();
-    auto currentTask = m_tasks[m_currentTask].get();
-    if (senderTask != currentTask) {
-        qDebug() << "MinecraftUpdate: Subtask" << sender() << "succeeded out of order.";
-        return;
-    }
-    next();
-}
-
-void MinecraftUpdate::subtaskFailed(QString error)
-{
-    if (isFinished()) {
-        qCritical() << "MinecraftUpdate: Subtask" << sender() << "failed, but work was already done!";
-        return;
-    }
-    auto senderTask = QObject::sender();
-    auto currentTask = m_tasks[m_currentTask].get();
-    if (senderTask != currentTask) {
-        qDebug() << "MinecraftUpdate: Subtask" << sender() << "failed out of order.";
-        m_failed_out_of_order = true;
-        m_fail_reason = error;
-        return;
-    }
-    emitFailed(error);
+    m_graph->addTask(task, dependencies);
 }
 
 bool MinecraftUpdate::abort()
 {
-    if (!m_abort) {
-        m_abort = true;
-        auto task = m_tasks[m_currentTask];
-        if (task->canAbort()) {
-            return task->abort();
-        }
-    }
+    if (m_graph && m_graph->isRunning())
+        return m_graph->abort();
     return true;
 }
 
@@ -23,12 +23,12 @@
 #include "minecraft/VersionFilterData.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
+#include "tasks/TaskGraph.h"
 
 class MinecraftVersion;
 class MinecraftInstance;
 
-// FIXME: This looks very similar to a SequentialTask. Maybe we can reduce code duplications? :^)
-
+/// brings the files of an instance up to date, with the downloads that don't need each other running together
 class MinecraftUpdate : public Task {
     Q_OBJECT
    public:
@@ -40,18 +40,12 @@ class MinecraftUpdate : public Task {
 
    private slots:
     bool abort() override;
-    void subtaskSucceeded();
-    void subtaskFailed(QString error);
 
    private:
-    void next();
+    void addSubtask(Task::Ptr task, const QList<Task::Ptr>& dependencies);
 
    private:
     MinecraftInstance* m_inst = nullptr;
-    QList<Task::Ptr> m_tasks;
+    TaskGraph::Ptr m_graph;
     QString m_preFailure;
-    int m_currentTask = -1;
-    bool m_abort = false;
-    bool m_failed_out_of_order = false;
-    QString m_fail_reason;
 };
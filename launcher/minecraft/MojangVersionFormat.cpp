@@ -54,9 +54,7 @@ static QJsonObject downloadInfoToJson(MojangDownloadInfo::Ptr info);
 namespace Bits {
 static void readString(const QJsonObject& root, const QString& key, QString& variable)
 {
-    if (root.contains(key)) {
-        variable = requireString(root.value(key));
-    }
+    requireIfPresent(root, key, variable);
 }
 
 static void readDownloadInfo(MojangDownloadInfo::Ptr out, const QJsonObject& obj)
@@ -183,8 +181,7 @@ void MojangVersionFormat::readVersionProperties(const QJsonObject& in, VersionFi
     out->releaseTime = timeFromS3Time(in.value("releaseTime").toString(""));
     out->updateTime = timeFromS3Time(in.value("time").toString(""));
 
-    if (in.contains("minimumLauncherVersion")) {
-        out->minimumLauncherVersion = requireInteger(in.value("minimumLauncherVersion"));
+    if (requireIfPresent(in, "minimumLauncherVersion", out->minimumLauncherVersion)) {
         if (out->minimumLauncherVersion > CURRENT_MINIMUM_LAUNCHER_VERSION) {
             out->addProblem(ProblemSeverity::Warning, QObject::tr("The 'minimumLauncherVersion' value of this version (%1) is higher than "
                                                                   "supported by %3 (%2). It might not work properly!")
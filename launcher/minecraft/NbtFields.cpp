@@ -0,0 +1,248 @@
+#include "NbtFields.h"
+
+#include <QSet>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace NbtFields {
+
+namespace {
+
+// the game refuses deeper nesting too
+constexpr int maxDepth = 512;
+
+class Reader {
+   public:
+    Reader(const QByteArray& data, const QStringList& paths) : m_pos(data.constData()), m_end(data.constData() + data.size())
+    {
+        for (auto& path : paths) {
+            auto utf8 = path.toUtf8();
+            m_wanted.insert(utf8, path);
+            // every compound on the way to it has to be read
+            for (int dot = utf8.indexOf('.'); dot != -1; dot = utf8.indexOf('.', dot + 1))
+                m_prefixes.insert(utf8.left(dot));
+        }
+    }
+
+    std::optional<QHash<QString, Field>> readRoot()
+    {
+        quint8 type;
+        QByteArray name;
+        if (!readBE(type) || Type(type) != Type::Compound || !readString(name) || !name.isEmpty())
+            return {};
+        if (!readCompound(QByteArray(), 0))
+            return {};
+        return m_found;
+    }
+
+   private:
+    bool done() const { return m_found.size() == m_wanted.size(); }
+
+    bool has(qint64 bytes) const { return bytes >= 0 && bytes <= m_end - m_pos; }
+
+    bool skip(qint64 bytes)
+    {
+        if (!has(bytes))
+            return false;
+        m_pos += bytes;
+        return true;
+    }
+
+    template <typename T>
+    bool readBE(T& out)
+    {
+        if (!has(sizeof(T)))
+            return false;
+        out = qFromBigEndian<T>(m_pos);
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool readString(QByteArray& out)
+    {
+        quint16 length;
+        if (!readBE(length) || !has(length))
+            return false;
+        out = QByteArray(m_pos, length);
+        m_pos += length;
+        return true;
+    }
+
+    bool readValue(Type type, QVariant& out, int depth)
+    {
+        switch (type) {
+            case Type::Byte: {
+                qint8 value;
+                if (!readBE(value))
+                    return false;
+                out = int(value);
+                return true;
+            }
+            case Type::Short: {
+                qint16 value;
+                if (!readBE(value))
+                    return false;
+                out = int(value);
+                return true;
+            }
+            case Type::Int: {
+                qint32 value;
+                if (!readBE(value))
+                    return false;
+                out = int(value);
+                return true;
+            }
+            case Type::Long: {
+                qint64 value;
+                if (!readBE(value))
+                    return false;
+                out = qlonglong(value);
+                return true;
+            }
+            case Type::Float: {
+                quint32 bits;
+                if (!readBE(bits))
+                    return false;
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                out = value;
+                return true;
+            }
+            case Type::Double: {
+                quint64 bits;
+                if (!readBE(bits))
+                    return false;
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                out = value;
+                return true;
+            }
+            case Type::String: {
+                // modified UTF-8, the same as UTF-8 for anything but NUL and characters outside the BMP
+                QByteArray value;
+                if (!readString(value))
+                    return false;
+                out = QString::fromUtf8(value);
+                return true;
+            }
+            default:
+                return skipPayload(type, depth);
+        }
+    }
+
+    bool skipPayload(Type type, int depth)
+    {
+        if (depth > maxDepth)
+            return false;
+        switch (type) {
+            case Type::Byte:
+                return skip(1);
+            case Type::Short:
+                return skip(2);
+            case Type::Int:
+            case Type::Float:
+                return skip(4);
+            case Type::Long:
+            case Type::Double:
+                return skip(8);
+            case Type::ByteArray:
+            case Type::IntArray:
+            case Type::LongArray: {
+                qint32 length;
+                if (!readBE(length) || length < 0)
+                    return false;
+                qint64 size = type == Type::ByteArray ? 1 : type == Type::IntArray ? 4 : 8;
+                return skip(size * length);
+            }
+            case Type::String: {
+                quint16 length;
+                return readBE(length) && skip(length);
+            }
+            case Type::List: {
+                quint8 elementType;
+                qint32 length;
+                if (!readBE(elementType) || !readBE(length) || length < 0)
+                    return false;
+                for (qint32 i = 0; i < length; i++) {
+                    if (!skipPayload(Type(elementType), depth + 1))
+                        return false;
+                }
+                return true;
+            }
+            case Type::Compound: {
+                while (true) {
+                    quint8 tagType;
+                    if (!readBE(tagType))
+                        return false;
+                    if (Type(tagType) == Type::End)
+                        return true;
+                    quint16 nameLength;
+                    if (!readBE(nameLength) || !skip(nameLength) || !skipPayload(Type(tagType), depth + 1))
+                        return false;
+                }
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool readCompound(const QByteArray& prefix, int depth)
+    {
+        if (depth > maxDepth)
+            return false;
+        while (!done()) {
+            quint8 tagType;
+            QByteArray name;
+            if (!readBE(tagType))
+                return false;
+            auto type = Type(tagType);
+            if (type == Type::End)
+                return true;
+            if (!readString(name))
+                return false;
+
+            auto path = prefix.isEmpty() ? name : prefix + '.' + name;
+            auto wanted = m_wanted.find(path);
+            if (wanted != m_wanted.end()) {
+                Field field;
+                field.type = type;
+                if (type == Type::Compound && m_prefixes.contains(path)) {
+                    m_found.insert(wanted.value(), field);
+                    if (!readCompound(path, depth + 1))
+                        return false;
+                    continue;
+                }
+                if (!readValue(type, field.value, depth + 1))
+                    return false;
+                m_found.insert(wanted.value(), field);
+                continue;
+            }
+            if (type == Type::Compound && m_prefixes.contains(path)) {
+                if (!readCompound(path, depth + 1))
+                    return false;
+                continue;
+            }
+            if (!skipPayload(type, depth + 1))
+                return false;
+        }
+        // everything was found, the rest doesn't matter
+        return true;
+    }
+
+   private:
+    const char* m_pos;
+    const char* m_end;
+    QHash<QByteArray, QString> m_wanted;
+    QSet<QByteArray> m_prefixes;
+    QHash<QString, Field> m_found;
+};
+
+}  // namespace
+
+std::optional<QHash<QString, Field>> read(const QByteArray& data, const QStringList& paths)
+{
+    return Reader(data, paths).readRoot();
+}
+
+}  // namespace NbtFields
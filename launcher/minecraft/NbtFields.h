@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <optional>
+
+/**
+ * Picks a few fields out of NBT data without building the tree of tags like nbt++ does.
+ *
+ * Fields are named by their path from the root compound, like "Data.LevelName". Compounds that no requested path goes
+ * into are skipped over, and reading stops as soon as every requested field was found. Use nbt++ for anything that
+ * has to be written back.
+ */
+namespace NbtFields {
+
+enum class Type : quint8 {
+    End = 0,
+    Byte = 1,
+    Short = 2,
+    Int = 3,
+    Long = 4,
+    Float = 5,
+    Double = 6,
+    ByteArray = 7,
+    String = 8,
+    List = 9,
+    Compound = 10,
+    IntArray = 11,
+    LongArray = 12,
+};
+
+struct Field {
+    Type type = Type::End;
+    // the value of numbers and strings, lists, arrays and compounds only have their type
+    QVariant value;
+};
+
+/// the requested fields found in the uncompressed NBT data, null if the data is broken
+std::optional<QHash<QString, Field>> read(const QByteArray& data, const QStringList& paths);
+
+}  // namespace NbtFields
@@ -45,9 +45,7 @@ using namespace Json;
 
 static void readString(const QJsonObject& root, const QString& key, QString& variable)
 {
-    if (root.contains(key)) {
-        variable = requireString(root.value(key));
-    }
+    requireIfPresent(root, key, variable);
 }
 
 LibraryPtr OneSixVersionFormat::libraryFromJson(ProblemContainer& problems, const QJsonObject& libObj, const QString& filename)
@@ -96,9 +94,7 @@ VersionFilePtr OneSixVersionFormat::versionFileFromJson(const QJsonDocument& doc
     }
 
     if (requireOrder) {
-        if (root.contains("order")) {
-            out->order = requireInteger(root.value("order"));
-        } else {
+        if (!requireIfPresent(root, "order", out->order)) {
             // FIXME: evaluate if we don't want to throw exceptions here instead
             qCritical() << filename << "doesn't contain an order field";
         }
@@ -251,9 +247,7 @@ VersionFilePtr OneSixVersionFormat::versionFileFromJson(const QJsonDocument& doc
     if (root.contains("conflicts")) {
         Meta::parseRequires(root, &out->conflicts);
     }
-    if (root.contains("volatile")) {
-        out->m_volatile = requireBoolean(root, "volatile");
-    }
+    requireIfPresent(root, "volatile", out->m_volatile, "'volatile'");
 
     /* removed features that shouldn't be used */
     if (root.contains("tweakers")) {
@@ -39,22 +39,27 @@
 
 #include <Version.h>
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QSaveFile>
 #include <QTimer>
 #include <QUuid>
 
+#include "Application.h"
 #include "Exception.h"
 #include "FileSystem.h"
 #include "Json.h"
+#include "net/HttpMetaCache.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/OneSixVersionFormat.h"
 #include "minecraft/ProfileUtils.h"
 
+#include "ComponentSummary.h"
 #include "ComponentUpdateTask.h"
 #include "PackProfile.h"
 #include "PackProfile_p.h"
@@ -276,6 +281,7 @@ void PackProfile::save_internal()
     qDebug() << "Component list save performed now for" << d->m_instance->name();
     auto filename = componentsFilePath();
     savePackProfile(filename, d->components);
+    ComponentSummary::forget(filename);
     d->dirty = false;
 }
 
@@ -930,16 +936,45 @@ bool PackProfile::installAgents_internal(QStringList filepaths)
     return true;
 }
 
+static bool sameContext(const RuntimeContext& a, const RuntimeContext& b)
+{
+    return a.javaArchitecture == b.javaArchitecture && a.javaRealArchitecture == b.javaRealArchitecture && a.javaPath == b.javaPath &&
+           a.system == b.system;
+}
+
 std::shared_ptr<LaunchProfile> PackProfile::getProfile() const
 {
     if (!d->m_profile) {
+        // libraries are picked by the context, it changing means nothing applied before holds
+        auto context = d->m_instance->runtimeContext();
+        if (!sameContext(context, d->m_appliedContext)) {
+            d->m_applied.clear();
+            d->m_appliedContext = context;
+        }
+        // a component applies the same as before when it's applied from the same file, so the profile after it is kept
+        std::size_t kept = 0;
+        while (kept < d->m_applied.size() && kept < static_cast<std::size_t>(d->components.size())) {
+            auto& applied = d->m_applied[kept];
+            auto& component = d->components[static_cast<int>(kept)];
+            if (applied.file != component->getVersionFile() || applied.enabled != component->isEnabled() ||
+                applied.severity != component->getProblemSeverity()) {
+                break;
+            }
+            kept++;
+        }
+        d->m_applied.erase(d->m_applied.begin() + kept, d->m_applied.end());
         try {
-            auto profile = std::make_shared<LaunchProfile>();
-            for (auto file : d->components) {
-                qDebug() << "Applying" << file->getID() << (file->getProblemSeverity() == ProblemSeverity::Error ? "ERROR" : "GOOD");
-                file->applyTo(profile.get());
+            // the lists in it are shared with the one kept until they're changed, so copying it is cheap
+            LaunchProfile profile = kept ? d->m_applied.back().profile : LaunchProfile();
+            for (auto i = static_cast<int>(kept); i < d->components.size(); i++) {
+                auto& component = d->components[i];
+                qDebug() << "Applying" << component->getID()
+                         << (component->getProblemSeverity() == ProblemSeverity::Error ? "ERROR" : "GOOD");
+                auto file = component->getVersionFile();
+                component->applyTo(&profile);
+                d->m_applied.push_back({ file, component->isEnabled(), component->getProblemSeverity(), profile });
             }
-            d->m_profile = profile;
+            d->m_profile = std::make_shared<LaunchProfile>(profile);
         } catch (const Exception& error) {
             qWarning() << "Couldn't apply profile patches because: " << error.cause();
         }
@@ -947,6 +982,32 @@ std::shared_ptr<LaunchProfile> PackProfile::getProfile() const
     return d->m_profile;
 }
 
+QString PackProfile::stateKey() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (auto component : d->components) {
+        // the version file as it is on disk, changing it in place changes its size or modification time
+        QString file;
+        if (component->isCustom()) {
+            file = patchFilePathForUid(component->m_uid);
+        } else {
+            auto entry = APPLICATION->metacache()->resolveEntry("meta", component->m_uid + '/' + component->m_version + ".json");
+            file = entry->getFullPath();
+        }
+        QFileInfo info(file);
+        if (!info.exists())
+            return {};
+
+        hash.addData(component->m_uid.toUtf8());
+        hash.addData(component->getVersion().toUtf8());
+        hash.addData(QByteArray(component->isEnabled() ? "1" : "0"));
+        hash.addData(file.toUtf8());
+        hash.addData(QByteArray::number(info.size()));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result().toHex();
+}
+
 bool PackProfile::setComponentVersion(const QString& uid, const QString& version, bool important)
 {
     auto iter = d->componentIndex.find(uid);
@@ -971,6 +1032,9 @@ bool PackProfile::setComponentVersion(const QString& uid, const QString& version
 
 QString PackProfile::getComponentVersion(const QString& uid) const
 {
+    // the list doesn't have to be loaded just to tell a version
+    if (!d->loaded)
+        return ComponentSummary::of(componentsFilePath())->version(uid);
     const auto iter = d->componentIndex.find(uid);
     if (iter != d->componentIndex.end()) {
         return (*iter)->getVersion();
@@ -995,10 +1059,17 @@ std::optional<ModPlatform::ModLoaderTypes> PackProfile::getModLoaders()
     bool has_any_loader = false;
 
     QMapIterator<QString, ModPlatform::ModLoaderType> i(modloaderMapping);
+    auto summary = d->loaded ? nullptr : ComponentSummary::of(componentsFilePath());
 
     while (i.hasNext()) {
         i.next();
-        if (auto c = getComponent(i.key()); c != nullptr && c->isEnabled()) {
+        bool enabled = false;
+        if (summary) {
+            enabled = summary->isEnabled(i.key());
+        } else if (auto c = getComponent(i.key()); c != nullptr) {
+            enabled = c->isEnabled();
+        }
+        if (enabled) {
             result |= i.value();
             has_any_loader = true;
         }
@@ -112,6 +112,9 @@ class PackProfile : public QAbstractListModel {
 
     std::shared_ptr<LaunchProfile> getProfile() const;
 
+    /// describes the components and the version files they are resolved from, empty if some file can't be found
+    QString stateKey() const;
+
     // NOTE: used ONLY by MinecraftInstance to provide legacy version mappings from instance config
     void setOldConfigVersion(const QString& uid, const QString& version);
 
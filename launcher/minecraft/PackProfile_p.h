@@ -5,17 +5,30 @@
 #include <QTimer>
 #include <map>
 #include "Component.h"
+#include "LaunchProfile.h"
+#include "RuntimeContext.h"
 
 class MinecraftInstance;
 using ComponentContainer = QList<ComponentPtr>;
 using ComponentIndex = QMap<QString, ComponentPtr>;
 
+// the profile as it was after applying a component, and what it was applied from
+struct AppliedComponent {
+    std::shared_ptr<VersionFile> file;
+    bool enabled = false;
+    ProblemSeverity severity = ProblemSeverity::None;
+    LaunchProfile profile;
+};
+
 struct PackProfileData {
     // the instance this belongs to
     MinecraftInstance* m_instance;
 
     // the launch profile (volatile, temporary thing created on demand)
     std::shared_ptr<LaunchProfile> m_profile;
+    // one for each of the components from the top, a component that changes is applied again from the one before it
+    std::vector<AppliedComponent> m_applied;
+    RuntimeContext m_appliedContext;
 
     // persistent list of components and related machinery
     ComponentContainer components;
@@ -0,0 +1,220 @@
+#include "PrepareInstancesTask.h"
+
+#include <QJsonArray>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/mod/ModFolderModel.h"
+#include "modplatform/flame/FlameCheckUpdate.h"
+#include "modplatform/modrinth/ModrinthCheckUpdate.h"
+#include "tasks/SequentialTask.h"
+
+namespace {
+const char* providerName(ModPlatform::ResourceProvider provider)
+{
+    switch (provider) {
+        case ModPlatform::ResourceProvider::MODRINTH:
+            return "modrinth";
+        case ModPlatform::ResourceProvider::FLAME:
+            return "curseforge";
+    }
+    return "";
+}
+
+// updates one instance, then looks for updates of its mods
+class PrepareInstance : public Task {
+    Q_OBJECT
+   public:
+    explicit PrepareInstance(InstancePtr instance) : m_inst(std::move(instance)) { setObjectName(m_inst->id()); }
+
+    bool canAbort() const override { return true; }
+
+   signals:
+    void report(const QJsonObject& line);
+
+   public slots:
+    bool abort() override
+    {
+        if (m_current && m_current->isRunning())
+            return m_current->abort();
+        emitAborted();
+        return true;
+    }
+
+   protected slots:
+    void executeTask() override
+    {
+        send({ { "event", "started" } });
+        connect(this, &Task::status, this, [this](const QString& status) {
+            if (status != m_status)
+                send({ { "event", "status" }, { "status", status } });
+            m_status = status;
+        });
+
+        m_current = m_inst->createUpdateTask(Net::Mode::Online);
+        if (!m_current) {
+            checkMods();
+            return;
+        }
+        connect(m_current.get(), &Task::succeeded, this, &PrepareInstance::checkMods);
+        connect(m_current.get(), &Task::failed, this, &PrepareInstance::emitFailed);
+        connect(m_current.get(), &Task::aborted, this, &PrepareInstance::emitAborted);
+        connect(m_current.get(), &Task::status, this, &PrepareInstance::setStatus);
+        connect(m_current.get(), &Task::progress, this, &PrepareInstance::updateProgress);
+        m_current->start();
+    }
+
+   private:
+    void send(QJsonObject line)
+    {
+        line.insert("instance", m_inst->id());
+        emit report(line);
+    }
+
+    void updateProgress(qint64 current, qint64 total)
+    {
+        setProgress(current, total);
+        // a line per percent is plenty for whoever reads them
+        int percent = total > 0 ? static_cast<int>(current * 100 / total) : 0;
+        if (percent == m_percent)
+            return;
+        m_percent = percent;
+        send({ { "event", "progress" }, { "current", current }, { "total", total } });
+    }
+
+    void checkMods()
+    {
+        auto minecraft = std::dynamic_pointer_cast<MinecraftInstance>(m_inst);
+        if (!minecraft) {
+            emitSucceeded();
+            return;
+        }
+        setStatus(tr("Looking for mod updates"));
+        m_mods = minecraft->loaderModList();
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(m_mods.get(), &ModFolderModel::updateFinished, this, [this, connection] {
+            disconnect(*connection);
+            modsLoaded();
+        });
+        // when it's already loading, it loads again afterwards and tells about that too
+        m_mods->update();
+    }
+
+    void modsLoaded()
+    {
+        if (!isRunning())
+            return;
+        int untracked = 0;
+        for (auto mod : m_mods->allMods()) {
+            if (!mod->metadata()) {
+                untracked++;
+                continue;
+            }
+            if (mod->metadata()->provider == ModPlatform::ResourceProvider::MODRINTH)
+                m_modrinth.append(mod);
+            else
+                m_flame.append(mod);
+        }
+
+        auto profile = std::static_pointer_cast<MinecraftInstance>(m_inst)->getPackProfile();
+        m_versions = { profile->getComponent("net.minecraft")->getVersion() };
+        auto loaders = profile->getSupportedModLoaders();
+
+        QList<shared_qobject_ptr<CheckUpdateTask>> checks;
+        if (!m_modrinth.isEmpty())
+            checks.append(makeShared<ModrinthCheckUpdate>(m_modrinth, m_versions, loaders, m_mods));
+        if (!m_flame.isEmpty())
+            checks.append(makeShared<FlameCheckUpdate>(m_flame, m_versions, loaders, m_mods));
+        if (checks.isEmpty()) {
+            modsChecked(checks, untracked, {});
+            return;
+        }
+
+        auto sequence = makeShared<SequentialTask>(nullptr, tr("Checking for mod updates"));
+        for (auto& check : checks)
+            sequence->addTask(check);
+        connect(sequence.get(), &Task::finished, this, [this, checks, untracked, done = sequence.get()] {
+            modsChecked(checks, untracked, done->wasSuccessful() ? QString() : done->failReason());
+        });
+        connect(sequence.get(), &Task::progress, this, &PrepareInstance::updateProgress);
+        m_current = sequence;
+        sequence->start();
+    }
+
+    // what the checks found is only told about, the instance itself is ready either way
+    void modsChecked(const QList<shared_qobject_ptr<CheckUpdateTask>>& checks, int untracked, const QString& error)
+    {
+        QJsonArray updates;
+        for (auto& check : checks) {
+            for (auto& mod : check->getUpdatable()) {
+                updates.append(QJsonObject{ { "name", mod.name },
+                                            { "version", mod.old_version },
+                                            { "new_version", mod.new_version },
+                                            { "provider", providerName(mod.provider) } });
+            }
+        }
+        QJsonObject line{ { "event", "mod_updates" }, { "updates", updates }, { "untracked", untracked } };
+        if (!error.isEmpty())
+            line.insert("error", error);
+        send(line);
+        emitSucceeded();
+    }
+
+   private:
+    InstancePtr m_inst;
+    Task::Ptr m_current;
+    QString m_status;
+    int m_percent = -1;
+
+    std::shared_ptr<ModFolderModel> m_mods;
+    // the checks keep references to these
+    QList<Mod*> m_modrinth;
+    QList<Mod*> m_flame;
+    std::list<Version> m_versions;
+};
+}  // namespace
+
+PrepareInstancesTask::PrepareInstancesTask(const QList<InstancePtr>& instances, int max_concurrent)
+    : ConcurrentTask(nullptr, tr("Preparing instances"), max_concurrent)
+{
+    for (auto& instance : instances)
+        addInstance(instance);
+}
+
+void PrepareInstancesTask::executeTask()
+{
+    emit report({ { "event", "begin" }, { "instances", static_cast<int>(totalSize()) } });
+    ConcurrentTask::executeTask();
+}
+
+void PrepareInstancesTask::startNext()
+{
+    if (m_queue.isEmpty() && m_doing.isEmpty() && isRunning()) {
+        emit report({ { "event", "done" }, { "succeeded", static_cast<int>(m_succeeded.size()) },
+                       { "failed", static_cast<int>(m_failed.size()) } });
+        if (!m_failed.isEmpty()) {
+            emitFailed(tr("%n instance(s) couldn't be prepared", "", static_cast<int>(m_failed.size())));
+            return;
+        }
+    }
+    ConcurrentTask::startNext();
+}
+
+void PrepareInstancesTask::addInstance(InstancePtr instance)
+{
+    auto task = makeShared<PrepareInstance>(instance);
+    connect(task.get(), &PrepareInstance::report, this, &PrepareInstancesTask::report);
+    // connected before this task connects to it, so these come ahead of the line about being done
+    auto id = instance->id();
+    connect(task.get(), &Task::succeeded, this,
+            [this, id] { emit report({ { "event", "finished" }, { "instance", id }, { "succeeded", true } }); });
+    connect(task.get(), &Task::failed, this, [this, id](const QString& reason) {
+        emit report({ { "event", "finished" }, { "instance", id }, { "succeeded", false }, { "reason", reason } });
+    });
+    connect(task.get(), &Task::aborted, this, [this, id] {
+        emit report({ { "event", "finished" }, { "instance", id }, { "succeeded", false }, { "reason", tr("Aborted") } });
+    });
+    addTask(task);
+}
+
+#include "PrepareInstancesTask.moc"
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QJsonObject>
+
+#include "BaseInstance.h"
+#include "tasks/ConcurrentTask.h"
+
+/** Brings many instances up to date at once, with nobody watching.
+ *
+ *  Every instance gets what MinecraftUpdate downloads, after which the mods that came from Modrinth or CurseForge are
+ *  checked for updates, which are only reported. A few instances run at the same time, they share the network access
+ *  manager with its connections per host and the metacache, and a file that several of them need is only downloaded
+ *  once. What happens is told through report(), one JSON object per event.
+ */
+class PrepareInstancesTask : public ConcurrentTask {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<PrepareInstancesTask>;
+
+    explicit PrepareInstancesTask(const QList<InstancePtr>& instances, int max_concurrent = 4);
+    ~PrepareInstancesTask() override = default;
+
+   signals:
+    /// something happened, `event` says what and `instance` to which one, if it's about one
+    void report(const QJsonObject& line);
+
+   protected slots:
+    void executeTask() override;
+    void startNext() override;
+
+   private:
+    void addInstance(InstancePtr instance);
+};
@@ -0,0 +1,265 @@
+#include "ServerPinger.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTcpSocket>
+
+#include "minecraft/launch/MinecraftServerTarget.h"
+#include "net/SrvCache.h"
+
+namespace {
+// how long an answer is good for
+constexpr qint64 cacheLifetime = 5 * 60 * 1000;
+// any version will do to ask for the status, -1 is what clients send for it
+constexpr int statusProtocol = -1;
+// a favicon is a few KiB, nothing a server answers is anywhere near this
+constexpr int maxPacketSize = 1 << 21;
+
+void writeVarInt(QByteArray& out, qint32 value)
+{
+    auto bits = static_cast<quint32>(value);
+    do {
+        char byte = bits & 0x7F;
+        bits >>= 7;
+        if (bits)
+            byte |= 0x80;
+        out.append(byte);
+    } while (bits);
+}
+
+std::optional<qint32> readVarInt(const QByteArray& data, int& pos)
+{
+    quint32 value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= data.size())
+            return std::nullopt;
+        auto byte = static_cast<quint8>(data[pos++]);
+        value |= quint32(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return static_cast<qint32>(value);
+    }
+    // longer than a VarInt can be, it's not a Minecraft server
+    return std::nullopt;
+}
+
+QByteArray packet(const QByteArray& body)
+{
+    QByteArray out;
+    writeVarInt(out, body.size());
+    return out + body;
+}
+
+QString descriptionText(const QJsonValue& value)
+{
+    if (value.isString())
+        return value.toString();
+    if (value.isArray()) {
+        QString out;
+        for (auto part : value.toArray())
+            out += descriptionText(part);
+        return out;
+    }
+    auto obj = value.toObject();
+    auto out = obj.value("text").toString();
+    for (auto part : obj.value("extra").toArray())
+        out += descriptionText(part);
+    return out;
+}
+}  // namespace
+
+ServerPinger::ServerPinger(SrvCache* srv, int max_concurrent, int per_second, std::chrono::milliseconds timeout, QObject* parent)
+    : QObject(parent), m_srv(srv), m_maxConcurrent(max_concurrent), m_timeout(timeout)
+{
+    m_rate.setInterval(1000 / std::max(per_second, 1));
+    connect(&m_rate, &QTimer::timeout, this, &ServerPinger::startQueued);
+}
+
+void ServerPinger::ping(const QString& address)
+{
+    auto trimmed = address.trimmed();
+    if (trimmed.isEmpty() || m_queue.contains(trimmed) || cached(trimmed))
+        return;
+    for (auto const& connection : m_connections) {
+        if (connection.address == trimmed)
+            return;
+    }
+
+    m_queue.enqueue(trimmed);
+    if (!m_rate.isActive()) {
+        m_rate.start();
+        startQueued();
+    }
+}
+
+std::optional<ServerStatus> ServerPinger::cached(const QString& address) const
+{
+    auto it = m_cache.constFind(address.trimmed());
+    if (it == m_cache.constEnd() || QDateTime::currentMSecsSinceEpoch() - it->checked > cacheLifetime)
+        return std::nullopt;
+    return *it;
+}
+
+void ServerPinger::startQueued()
+{
+    if (m_queue.isEmpty()) {
+        m_rate.stop();
+        return;
+    }
+    if (m_active >= m_maxConcurrent)
+        return;
+
+    auto address = m_queue.dequeue();
+    m_active++;
+    auto target = MinecraftServerTarget::parse(address);
+    if (!m_srv || target.port != 25565) {
+        connectTo(address, target.address, target.address, target.port);
+        return;
+    }
+    m_srv->resolve(QString("_minecraft._tcp.%1").arg(target.address), this,
+                   [this, address, target](std::optional<SrvCache::Record> record, const QString&) {
+                       if (record)
+                           connectTo(address, target.address, record->target, record->port);
+                       else
+                           connectTo(address, target.address, target.address, target.port);
+                   });
+}
+
+void ServerPinger::connectTo(const QString& address, const QString& host, const QString& target, quint16 port)
+{
+    auto socket = new QTcpSocket(this);
+    m_connections.insert(socket, { address, socket });
+
+    connect(socket, &QTcpSocket::connected, this, [this, socket, host, port] {
+        auto it = m_connections.find(socket);
+        if (it == m_connections.end())
+            return;
+        it->sent = QDateTime::currentMSecsSinceEpoch();
+        socket->write(handshakePacket(host, port));
+        // the status request, which is nothing but its id
+        socket->write(packet(QByteArray(1, 0x00)));
+    });
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket] { onReadyRead(socket); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket] { done(socket); });
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)  // QAbstractSocket::errorOccurred added in 5.15
+    connect(socket, &QTcpSocket::errorOccurred, this, [this, socket] { done(socket); });
+#else
+    connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this, [this, socket] { done(socket); });
+#endif
+    QTimer::singleShot(m_timeout, socket, [this, socket] { done(socket); });
+
+    socket->connectToHost(target, port);
+}
+
+void ServerPinger::onReadyRead(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end())
+        return;
+
+    it->buffer += socket->readAll();
+    while (auto body = takePacket(it->buffer)) {
+        int pos = 0;
+        auto id = readVarInt(*body, pos);
+        auto now = QDateTime::currentMSecsSinceEpoch();
+        if (!it->gotStatus && id == 0) {
+            auto length = readVarInt(*body, pos);
+            auto status = length ? parseStatus(body->mid(pos, *length)) : std::nullopt;
+            if (!status) {
+                done(socket);
+                return;
+            }
+            it->status = *status;
+            // in case it hangs up instead of answering the ping
+            it->status.ping = static_cast<int>(now - it->sent);
+            it->gotStatus = true;
+
+            QByteArray ping(1, 0x01);
+            for (int shift = 56; shift >= 0; shift -= 8)
+                ping.append(static_cast<char>((now >> shift) & 0xFF));
+            it->sent = now;
+            socket->write(packet(ping));
+        } else if (it->gotStatus && id == 1) {
+            it->status.ping = static_cast<int>(now - it->sent);
+            done(socket);
+            return;
+        }
+    }
+    if (it->buffer.size() > maxPacketSize)
+        done(socket);
+}
+
+void ServerPinger::done(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end())
+        return;
+    auto connection = *it;
+    m_connections.erase(it);
+
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    m_active--;
+
+    auto status = connection.gotStatus ? connection.status : ServerStatus();
+    status.online = connection.gotStatus;
+    status.checked = QDateTime::currentMSecsSinceEpoch();
+    m_cache.insert(connection.address, status);
+    emit finished(connection.address, status);
+
+    if (!m_queue.isEmpty() && !m_rate.isActive())
+        m_rate.start();
+}
+
+QByteArray ServerPinger::handshakePacket(const QString& host, quint16 port)
+{
+    QByteArray body(1, 0x00);
+    writeVarInt(body, statusProtocol);
+    auto hostBytes = host.toUtf8();
+    writeVarInt(body, hostBytes.size());
+    body += hostBytes;
+    body.append(static_cast<char>(port >> 8));
+    body.append(static_cast<char>(port & 0xFF));
+    // we're after the status
+    writeVarInt(body, 1);
+    return packet(body);
+}
+
+std::optional<QByteArray> ServerPinger::takePacket(QByteArray& buffer)
+{
+    int pos = 0;
+    auto length = readVarInt(buffer, pos);
+    if (!length || *length < 0 || buffer.size() - pos < *length)
+        return std::nullopt;
+    auto body = buffer.mid(pos, *length);
+    buffer.remove(0, pos + *length);
+    return body;
+}
+
+std::optional<ServerStatus> ServerPinger::parseStatus(const QByteArray& json)
+{
+    QJsonParseError error{};
+    auto doc = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject())
+        return std::nullopt;
+    auto root = doc.object();
+
+    ServerStatus status;
+    status.online = true;
+    status.version = root.value("version").toObject().value("name").toString();
+    auto players = root.value("players").toObject();
+    status.players = players.value("online").toInt();
+    status.maxPlayers = players.value("max").toInt();
+    // the formatting codes mean nothing outside of the game
+    static const QRegularExpression formatting(QString(QChar(0x00A7)) + '.');
+    status.motd = descriptionText(root.value("description")).remove(formatting).trimmed();
+
+    auto favicon = root.value("favicon").toString();
+    auto comma = favicon.indexOf(',');
+    if (favicon.startsWith("data:image/png;base64,") && comma > 0)
+        status.favicon = QByteArray::fromBase64(favicon.mid(comma + 1).toLatin1());
+    return status;
+}
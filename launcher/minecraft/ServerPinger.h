@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QTimer>
+
+#include <chrono>
+#include <optional>
+
+class QTcpSocket;
+class SrvCache;
+
+/** What a server answered to a Server List Ping. */
+struct ServerStatus {
+    bool online = false;
+    QString motd;
+    QString version;
+    int players = 0;
+    int maxPlayers = 0;
+    // in ms, -1 if it didn't answer
+    int ping = -1;
+    // PNG
+    QByteArray favicon;
+    // when it was pinged, in ms since epoch
+    qint64 checked = 0;
+};
+Q_DECLARE_METATYPE(ServerStatus)
+
+/**
+ * Pings Minecraft servers for their status, any number of them at once, all from the thread it lives in.
+ *
+ * Every ping is a non-blocking socket driven by the event loop, so a list of a hundred servers doesn't need a hundred
+ * threads, nor wait on them one after the other. At most `max_concurrent` are connected at a time, only so many are
+ * started per second, and one that doesn't answer within the timeout counts as offline.
+ *
+ * The answers are kept for a few minutes, so opening the servers of an instance again shows them right away without
+ * asking again. Addresses without a port are looked up through the SRV cache first, like the game does.
+ */
+class ServerPinger : public QObject {
+    Q_OBJECT
+   public:
+    explicit ServerPinger(SrvCache* srv = nullptr,
+                          int max_concurrent = 16,
+                          int per_second = 32,
+                          std::chrono::milliseconds timeout = std::chrono::seconds(5),
+                          QObject* parent = nullptr);
+
+    /// ping `address` as written in servers.dat, unless it was pinged lately, finished() says how it went
+    void ping(const QString& address);
+    /// what the last ping of `address` found, if it was lately
+    std::optional<ServerStatus> cached(const QString& address) const;
+
+    /// the packets of the protocol, public for the tests
+    static QByteArray handshakePacket(const QString& host, quint16 port);
+    /// parse one packet off the front of `buffer`, removing it, nullopt until it's all there
+    static std::optional<QByteArray> takePacket(QByteArray& buffer);
+    static std::optional<ServerStatus> parseStatus(const QByteArray& json);
+
+   signals:
+    void finished(const QString& address, const ServerStatus& status);
+
+   private:
+    struct Connection {
+        QString address;
+        QTcpSocket* socket = nullptr;
+        QByteArray buffer;
+        ServerStatus status;
+        bool gotStatus = false;
+        qint64 sent = 0;
+    };
+
+    void startQueued();
+    void connectTo(const QString& address, const QString& host, const QString& target, quint16 port);
+    void onReadyRead(QTcpSocket* socket);
+    void done(QTcpSocket* socket);
+
+   private:
+    SrvCache* m_srv;
+    int m_maxConcurrent;
+    std::chrono::milliseconds m_timeout;
+    QTimer m_rate;
+    QQueue<QString> m_queue;
+    // counting the ones still resolving
+    int m_active = 0;
+    QHash<QTcpSocket*, Connection> m_connections;
+    QHash<QString, ServerStatus> m_cache;
+};
@@ -0,0 +1,149 @@
+#include "VersionPrefetcher.h"
+
+#include "Application.h"
+#include "meta/Index.h"
+#include "minecraft/LaunchProfile.h"
+#include "minecraft/VersionFile.h"
+#include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+#include "net/HttpMetaCache.h"
+
+namespace {
+// how long a selection has to stay before it's fetched
+constexpr int s_settleMs = 750;
+}  // namespace
+
+VersionPrefetcher::VersionPrefetcher(QObject* parent) : QObject(parent)
+{
+    m_settle.setSingleShot(true);
+    m_settle.setInterval(s_settleMs);
+    connect(&m_settle, &QTimer::timeout, this, &VersionPrefetcher::start);
+}
+
+VersionPrefetcher::~VersionPrefetcher()
+{
+    // the instance being created likely waits for these, the job lets itself go once it's done
+    if (m_job && m_job->isRunning()) {
+        auto job = m_job;
+        connect(job.get(), &Task::finished, job.get(), [job]() mutable { job.reset(); });
+    }
+}
+
+bool VersionPrefetcher::isEnabled()
+{
+    return APPLICATION->settings()->get("PrefetchNewInstances").toBool();
+}
+
+void VersionPrefetcher::prefetch(const QString& minecraftVersion, const QString& loaderUid, const QString& loaderVersion)
+{
+    if (minecraftVersion == m_minecraftVersion && loaderUid == m_loaderUid && loaderVersion == m_loaderVersion)
+        return;
+    m_minecraftVersion = minecraftVersion;
+    m_loaderUid = loaderUid;
+    m_loaderVersion = loaderVersion;
+    m_settle.start();
+}
+
+void VersionPrefetcher::start()
+{
+    m_generation++;
+    m_versions.clear();
+    if (m_job) {
+        m_job->abort();
+        m_job.reset();
+    }
+    if (m_minecraftVersion.isEmpty())
+        return;
+
+    m_loading = 1;
+    request("net.minecraft", m_minecraftVersion);
+    if (!m_loaderUid.isEmpty() && !m_loaderVersion.isEmpty())
+        request(m_loaderUid, m_loaderVersion);
+    if (--m_loading == 0)
+        download();
+}
+
+void VersionPrefetcher::request(const QString& uid, const QString& version)
+{
+    for (auto& known : m_versions) {
+        if (known->uid() == uid)
+            return;
+    }
+    auto meta = APPLICATION->metadataIndex()->get(uid, version);
+    m_versions.append(meta);
+    m_loading++;
+
+    if (!meta->isLoaded())
+        meta->load(Net::Mode::Online);
+    Task::Ptr task;
+    if (!meta->isLoaded())
+        task = meta->getCurrentTask();
+    if (!task) {
+        resolved(meta);
+        return;
+    }
+    connect(task.get(), &Task::finished, this, [this, meta, generation = m_generation] {
+        if (generation == m_generation)
+            resolved(meta);
+    });
+}
+
+void VersionPrefetcher::resolved(const Meta::Version::Ptr& version)
+{
+    // the components the instance gets for it too, like the LWJGL the game version suggests
+    if (version->isLoaded()) {
+        for (auto& require : version->requiredSet()) {
+            auto wanted = require.equalsVersion.isEmpty() ? require.suggests : require.equalsVersion;
+            if (!wanted.isEmpty())
+                request(require.uid, wanted);
+        }
+    }
+    if (--m_loading == 0)
+        download();
+}
+
+void VersionPrefetcher::download()
+{
+    RuntimeContext context;
+    context.updateFromInstanceSettings(APPLICATION->settings());
+    LaunchProfile profile;
+    for (auto& version : m_versions) {
+        if (version->isLoaded())
+            version->data()->applyTo(&profile, context);
+    }
+
+    auto job = makeShared<NetJob>(tr("Prefetch of Minecraft %1").arg(m_minecraftVersion), APPLICATION->network());
+    job->setPriority(Net::Priority::Background);
+    auto metacache = APPLICATION->metacache();
+
+    QList<LibraryPtr> pool;
+    pool.append(profile.getLibraries());
+    pool.append(profile.getNativeLibraries());
+    pool.append(profile.getMavenFiles());
+    pool.append(profile.getMainJar());
+    for (auto& lib : pool) {
+        if (!lib || lib->isLocal())
+            continue;
+        // only the ones missing from the cache, revalidating what's there is left to the update
+        QStringList failed;
+        for (auto& dl : lib->getDownloads(context, metacache.get(), failed, {}))
+            job->addNetAction(dl);
+    }
+
+    auto assets = profile.getMinecraftAssets();
+    if (assets && !assets->url.isEmpty()) {
+        auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
+        if (entry->isStale()) {
+            auto dl = Net::ApiDownload::makeCached(QUrl(assets->url), entry);
+            if (!assets->sha1.isEmpty())
+                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(assets->sha1.toLatin1())));
+            job->addNetAction(dl);
+        }
+    }
+
+    if (job->size() == 0)
+        return;
+    qDebug() << "Prefetching" << job->size() << "files of Minecraft" << m_minecraftVersion;
+    m_job = job;
+    job->start();
+}
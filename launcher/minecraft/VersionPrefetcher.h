@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "meta/Version.h"
+#include "net/NetJob.h"
+
+/**
+ * Gets the files of a game version before there's an instance of it, when the user opts in.
+ *
+ * Picking a version for a new instance used to fetch nothing, its metadata, libraries and asset index were all
+ * downloaded once the instance was made, or at its first launch. While a version is selected, this loads the metadata
+ * of it and of what it requires, like LWJGL or the intermediary mappings of Fabric, and downloads the libraries, the
+ * game jar and the asset index on the background class of the bandwidth scheduler. Creating the instance then updates
+ * it as usual, which finds these in the cache or waits for the ones still downloading instead of fetching them again.
+ *
+ * The selection settles for a moment before anything is fetched, scrolling through the list doesn't start a download
+ * for every version on the way. A download that's still running when this is gone keeps going.
+ */
+class VersionPrefetcher : public QObject {
+    Q_OBJECT
+   public:
+    explicit VersionPrefetcher(QObject* parent = nullptr);
+    ~VersionPrefetcher() override;
+
+    /// whether the user wants new instances prefetched
+    static bool isEnabled();
+
+    /// fetch what this version of the game needs, with the loader when there's one, dropping the version before
+    void prefetch(const QString& minecraftVersion, const QString& loaderUid = {}, const QString& loaderVersion = {});
+
+   private:
+    void start();
+    void request(const QString& uid, const QString& version);
+    void resolved(const Meta::Version::Ptr& version);
+    void download();
+
+   private:
+    QTimer m_settle;
+    QString m_minecraftVersion;
+    QString m_loaderUid;
+    QString m_loaderVersion;
+
+    // a selection made while the metadata of the one before loads drops that
+    int m_generation = 0;
+    // the metadata files still loading, plus one while they're requested
+    int m_loading = 0;
+    QList<Meta::Version::Ptr> m_versions;
+    NetJob::Ptr m_job;
+};
@@ -45,15 +45,15 @@
 #include <MMCZip.h>
 #include <io/stream_reader.h>
 #include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
 #include <tag_primitive.h>
 #include <tag_string.h>
 #include <sstream>
 #include "GZip.h"
+#include "minecraft/NbtFields.h"
 
 #include <QCoreApplication>
 
+#include <atomic>
 #include <optional>
 
 #include "FileSystem.h"
@@ -124,13 +124,9 @@ QString GameType::toLogString() const
     return "Undefined";
 }
 
-std::unique_ptr<nbt::tag_compound> parseLevelDat(QByteArray data)
+std::unique_ptr<nbt::tag_compound> parseLevelDat(const QByteArray& data)
 {
-    QByteArray output;
-    if (!GZip::unzip(data, output)) {
-        return nullptr;
-    }
-    std::istringstream foo(std::string(output.constData(), output.size()));
+    std::istringstream foo(std::string(data.constData(), data.size()));
     try {
         auto pair = nbt::io::read_compound(foo);
 
@@ -164,6 +160,7 @@ QString getLevelDatFromFS(const QFileInfo& file)
     return worldDir.absoluteFilePath("level.dat");
 }
 
+/// the decompressed level.dat of the world, empty if it can't be read
 QByteArray getLevelDatDataFromFS(const QFileInfo& file)
 {
     auto fullFilePath = getLevelDatFromFS(file);
@@ -174,7 +171,11 @@ QByteArray getLevelDatDataFromFS(const QFileInfo& file)
     if (!f.open(QIODevice::ReadOnly)) {
         return QByteArray();
     }
-    return f.readAll();
+    QByteArray data;
+    if (!GZip::unzip(f, data)) {
+        return QByteArray();
+    }
+    return data;
 }
 
 bool putLevelDatDataToFS(const QFileInfo& file, QByteArray& data)
@@ -187,18 +188,14 @@ bool putLevelDatDataToFS(const QFileInfo& file, QByteArray& data)
     if (!f.open(QIODevice::WriteOnly)) {
         return false;
     }
-    QByteArray compressed;
-    if (!GZip::zip(data, compressed)) {
-        return false;
-    }
-    if (f.write(compressed) != compressed.size()) {
+    if (!GZip::zip(data, f)) {
         f.cancelWriting();
         return false;
     }
     return f.commit();
 }
 
-int64_t calculateWorldSize(const QFileInfo& file)
+int64_t World::calculateSize(const QFileInfo& file)
 {
     if (file.isFile() && file.suffix() == "zip") {
         return file.size();
@@ -206,8 +203,8 @@ int64_t calculateWorldSize(const QFileInfo& file)
         QDirIterator it(file.absoluteFilePath(), QDir::Files, QDirIterator::Subdirectories);
         int64_t total = 0;
         while (it.hasNext()) {
-            total += it.fileInfo().size();
             it.next();
+            total += it.fileInfo().size();
         }
         return total;
     }
@@ -219,11 +216,44 @@ World::World(const QFileInfo& file)
     repath(file);
 }
 
-void World::repath(const QFileInfo& file)
+World::World(const QFileInfo& file, bool calculateSize)
+{
+    repath(file, calculateSize);
+}
+
+World::World(const QFileInfo& file, const WorldSummary& summary)
+{
+    m_containerFile = file;
+    m_folderName = file.fileName();
+    QFileInfo assumedIconPath(file.absoluteFilePath() + "/icon.png");
+    if (assumedIconPath.exists()) {
+        m_iconFile = assumedIconPath.absoluteFilePath();
+    }
+    levelDatTime = summary.lastPlayed;
+    m_actualName = summary.name;
+    m_lastPlayed = summary.lastPlayed;
+    m_gameType = GameType(summary.gameType);
+    m_randomSeed = summary.seed;
+    m_size = summary.size;
+    is_valid = true;
+}
+
+WorldSummary World::summary() const
+{
+    WorldSummary summary;
+    summary.name = m_actualName;
+    summary.lastPlayed = m_lastPlayed;
+    summary.gameType = m_gameType.original;
+    summary.seed = m_randomSeed;
+    summary.size = m_size;
+    return summary;
+}
+
+void World::repath(const QFileInfo& file, bool calculateSize)
 {
     m_containerFile = file;
     m_folderName = file.fileName();
-    m_size = calculateWorldSize(file);
+    m_size = calculateSize ? World::calculateSize(file) : -1;
     if (file.isFile() && file.suffix() == "zip") {
         m_iconFile = QString();
         readFromZip(file);
@@ -255,45 +285,43 @@ void World::readFromFS(const QFileInfo& file)
         is_valid = false;
         return;
     }
-    loadFromLevelDat(bytes);
+    // the fallback for when level.dat doesn't say when the world was last played
     levelDatTime = file.lastModified();
+    loadFromLevelDat(bytes);
 }
 
 void World::readFromZip(const QFileInfo& file)
 {
-    QuaZip zip(file.absoluteFilePath());
-    is_valid = zip.open(QuaZip::mdUnzip);
+    MMCZip::ZipIndex zip(file.absoluteFilePath());
+    is_valid = zip.isValid();
     if (!is_valid) {
         return;
     }
-    auto location = MMCZip::findFolderOfFileInZip(&zip, "level.dat");
+    auto location = zip.findFolderOfFile("level.dat");
     is_valid = !location.isEmpty();
     if (!is_valid) {
         return;
     }
     m_containerOffsetPath = location;
-    QuaZipFile zippedFile(&zip);
     // read the install profile
-    is_valid = zip.setCurrentFile(location + "level.dat");
+    auto levelDat = zip.read(location + "level.dat");
+    is_valid = levelDat.has_value();
     if (!is_valid) {
         return;
     }
-    is_valid = zippedFile.open(QIODevice::ReadOnly);
-    QuaZipFileInfo64 levelDatInfo;
-    zippedFile.getFileInfo(&levelDatInfo);
-    auto modTime = levelDatInfo.getNTFSmTime();
-    if (!modTime.isValid()) {
-        modTime = levelDatInfo.dateTime;
-    }
-    levelDatTime = modTime;
+    levelDatTime = zip.lastModified(location + "level.dat");
+    QByteArray data;
+    is_valid = GZip::unzip(*levelDat, data);
     if (!is_valid) {
         return;
     }
-    loadFromLevelDat(zippedFile.readAll());
-    zippedFile.close();
+    loadFromLevelDat(data);
 }
 
-bool World::install(const QString& to, const QString& name)
+bool World::install(const QString& to,
+                    const QString& name,
+                    const std::function<void(qint64 done, qint64 total)>& progress,
+                    const CancellationToken& cancel)
 {
     auto finalPath = FS::PathCombine(to, FS::DirNameFromString(m_actualName, to));
     if (!FS::ensureFolderPathExists(finalPath)) {
@@ -305,15 +333,29 @@ bool World::install(const QString& to, const QString& name)
         if (!zip.open(QuaZip::mdUnzip)) {
             return false;
         }
-        ok = !MMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath);
+        ok = MMCZip::extractSubDir(&zip, m_containerOffsetPath, finalPath, progress, {}, cancel).has_value();
     } else if (m_containerFile.isDir()) {
         QString from = m_containerFile.filePath();
-        ok = FS::copy(from, finalPath)();
+        FS::copy copy(from, finalPath);
+        // a clone shares the data until either is changed, unlike a link, so the copy stays a copy of its own
+        copy.method(FS::canClone(from, finalPath) ? FS::copy::Method::Clone : FS::copy::Method::Copy).cancellation(cancel);
+        std::atomic<qint64> total{ 0 };
+        if (progress) {
+            copy.countBytes(true);
+            QObject::connect(&copy, &FS::copy::scanned, [&total](qsizetype, qint64 bytes) { total = bytes; });
+            QObject::connect(&copy, &FS::copy::fileCopied, [&](const QString&) { progress(copy.bytesCopied(), total); });
+        }
+        ok = copy();
+    }
+    if (!ok) {
+        // half a world would show up as a broken one
+        FS::deletePath(finalPath);
+        return false;
     }
 
     if (ok && !name.isEmpty() && m_actualName != name) {
         QFileInfo finalPathInfo(finalPath);
-        World newWorld(finalPathInfo);
+        World newWorld(finalPathInfo, false);
         if (newWorld.isValid()) {
             newWorld.rename(name);
         }
@@ -357,122 +399,51 @@ bool World::rename(const QString& newName)
     return true;
 }
 
-namespace {
-
-optional<QString> read_string(nbt::value& parent, const char* name)
+void World::loadFromLevelDat(const QByteArray& uncompressed)
 {
-    try {
-        auto& namedValue = parent.at(name);
-        if (namedValue.get_type() != nbt::tag_type::String) {
-            return nullopt;
-        }
-        auto& tag_str = namedValue.as<nbt::tag_string>();
-        return QString::fromStdString(tag_str.get());
-    } catch ([[maybe_unused]] const std::out_of_range& e) {
-        // fallback for old world formats
-        qWarning() << "String NBT tag" << name << "could not be found.";
-        return nullopt;
-    } catch ([[maybe_unused]] const std::bad_cast& e) {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to string.";
-        return nullopt;
-    }
-}
-
-optional<int64_t> read_long(nbt::value& parent, const char* name)
-{
-    try {
-        auto& namedValue = parent.at(name);
-        if (namedValue.get_type() != nbt::tag_type::Long) {
-            return nullopt;
-        }
-        auto& tag_str = namedValue.as<nbt::tag_long>();
-        return tag_str.get();
-    } catch ([[maybe_unused]] const std::out_of_range& e) {
-        // fallback for old world formats
-        qWarning() << "Long NBT tag" << name << "could not be found.";
-        return nullopt;
-    } catch ([[maybe_unused]] const std::bad_cast& e) {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to long.";
-        return nullopt;
-    }
-}
-
-optional<int> read_int(nbt::value& parent, const char* name)
-{
-    try {
-        auto& namedValue = parent.at(name);
-        if (namedValue.get_type() != nbt::tag_type::Int) {
-            return nullopt;
-        }
-        auto& tag_str = namedValue.as<nbt::tag_int>();
-        return tag_str.get();
-    } catch ([[maybe_unused]] const std::out_of_range& e) {
-        // fallback for old world formats
-        qWarning() << "Int NBT tag" << name << "could not be found.";
-        return nullopt;
-    } catch ([[maybe_unused]] const std::bad_cast& e) {
-        // type mismatch
-        qWarning() << "NBT tag" << name << "could not be converted to int.";
-        return nullopt;
-    }
-}
-
-GameType read_gametype(nbt::value& parent, const char* name)
-{
-    return GameType(read_int(parent, name));
-}
-
-}  // namespace
-
-void World::loadFromLevelDat(QByteArray data)
-{
-    auto levelData = parseLevelDat(data);
-    if (!levelData) {
+    // listing worlds only needs a few fields, the rest of level.dat can be huge with mods
+    auto fields = NbtFields::read(uncompressed, { "Data", "Data.LevelName", "Data.LastPlayed", "Data.GameType", "Data.RandomSeed",
+                                                  "Data.WorldGenSettings.seed" });
+    if (!fields) {
+        qWarning() << "Unable to read NBT tags from" << m_folderName;
         is_valid = false;
         return;
     }
 
-    nbt::value* valPtr = nullptr;
-    try {
-        valPtr = &levelData->at("Data");
-    } catch (const std::out_of_range& e) {
-        qWarning() << "Unable to read NBT tags from " << m_folderName << ":" << e.what();
-        is_valid = false;
+    is_valid = fields->value("Data").type == NbtFields::Type::Compound;
+    if (!is_valid) {
+        qWarning() << "No world data in the level.dat of" << m_folderName;
         return;
     }
-    nbt::value& val = *valPtr;
 
-    is_valid = val.get_type() == nbt::tag_type::Compound;
-    if (!is_valid)
-        return;
+    // fields missing or of another type are from old world formats
+    auto field = [&fields](const QString& path, NbtFields::Type type) -> optional<QVariant> {
+        auto found = fields->find(path);
+        if (found == fields->end() || found->type != type)
+            return nullopt;
+        return found->value;
+    };
 
-    auto name = read_string(val, "LevelName");
-    m_actualName = name ? *name : m_folderName;
+    auto name = field("Data.LevelName", NbtFields::Type::String);
+    m_actualName = name ? name->toString() : m_folderName;
 
-    auto timestamp = read_long(val, "LastPlayed");
-    m_lastPlayed = timestamp ? QDateTime::fromMSecsSinceEpoch(*timestamp) : levelDatTime;
+    auto timestamp = field("Data.LastPlayed", NbtFields::Type::Long);
+    m_lastPlayed = timestamp ? QDateTime::fromMSecsSinceEpoch(timestamp->toLongLong()) : levelDatTime;
 
-    m_gameType = read_gametype(val, "GameType");
+    auto gameType = field("Data.GameType", NbtFields::Type::Int);
+    m_gameType = GameType(gameType ? optional<int>(gameType->toInt()) : nullopt);
 
-    optional<int64_t> randomSeed;
-    try {
-        auto& WorldGen_val = val.at("WorldGenSettings");
-        randomSeed = read_long(WorldGen_val, "seed");
-    } catch (const std::out_of_range&) {
-    }
+    auto randomSeed = field("Data.WorldGenSettings.seed", NbtFields::Type::Long);
     if (!randomSeed) {
-        randomSeed = read_long(val, "RandomSeed");
+        randomSeed = field("Data.RandomSeed", NbtFields::Type::Long);
     }
-    m_randomSeed = randomSeed ? *randomSeed : 0;
+    m_randomSeed = randomSeed ? randomSeed->toLongLong() : 0;
 
     qDebug() << "World Name:" << m_actualName;
     qDebug() << "Last Played:" << m_lastPlayed.toString();
     if (randomSeed) {
-        qDebug() << "Seed:" << *randomSeed;
+        qDebug() << "Seed:" << m_randomSeed;
     }
-    qDebug() << "Size:" << m_size;
     qDebug() << "GameType:" << m_gameType.toLogString();
 }
 
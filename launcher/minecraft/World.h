@@ -16,8 +16,11 @@
 #pragma once
 #include <QDateTime>
 #include <QFileInfo>
+#include <functional>
 #include <optional>
 
+#include "tasks/CancellationToken.h"
+
 struct GameType {
     GameType() = default;
     GameType(std::optional<int> original);
@@ -29,17 +32,33 @@ struct GameType {
     std::optional<int> original;
 };
 
+/// what the world list keeps of level.dat, enough to show a world without reading it again
+struct WorldSummary {
+    QString name;
+    QDateTime lastPlayed;
+    std::optional<int> gameType;
+    int64_t seed = 0;
+    // size of the whole world on disk, -1 while unknown
+    int64_t size = -1;
+};
+
 class World {
    public:
     World(const QFileInfo& file);
+    /// read the world without adding up the size of its files, bytes() is -1 until it's set
+    World(const QFileInfo& file, bool calculateSize);
+    /// a world folder as summarized earlier, level.dat isn't read
+    World(const QFileInfo& file, const WorldSummary& summary);
     QString folderName() const { return m_folderName; }
     QString name() const { return m_actualName; }
     QString iconFile() const { return m_iconFile; }
     int64_t bytes() const { return m_size; }
+    void setBytes(int64_t size) { m_size = size; }
     QDateTime lastPlayed() const { return m_lastPlayed; }
     GameType gameType() const { return m_gameType; }
     int64_t seed() const { return m_randomSeed; }
     bool isValid() const { return is_valid; }
+    WorldSummary summary() const;
     bool isOnFS() const { return m_containerFile.isDir(); }
     QFileInfo container() const { return m_containerFile; }
     // delete all the files of this world
@@ -47,12 +66,17 @@ class World {
     // replace this world with a copy of the other
     bool replace(World& with);
     // change the world's filesystem path (used by world lists for *MAGIC* purposes)
-    void repath(const QFileInfo& file);
+    void repath(const QFileInfo& file, bool calculateSize = true);
     // remove the icon file, if any
     bool resetIcon();
 
     bool rename(const QString& to);
-    bool install(const QString& to, const QString& name = QString());
+    // copy the world into the saves folder `to`, as `name` if there's one. progress gets the bytes done and the total,
+    // from the threads doing the work, and cancelling stops it between files, leaving nothing behind
+    bool install(const QString& to,
+                 const QString& name = QString(),
+                 const std::function<void(qint64 done, qint64 total)>& progress = {},
+                 const CancellationToken& cancel = {});
 
     // WEAK compare operator - used for replacing worlds
     bool operator==(const World& other) const;
@@ -72,10 +96,14 @@ class World {
 
     QString canonicalFilePath() const { return m_containerFile.canonicalFilePath(); }
 
+    /// the size of a world folder or zip on disk, -1 if it's neither, slow for big worlds
+    static int64_t calculateSize(const QFileInfo& file);
+
    private:
     void readFromZip(const QFileInfo& file);
     void readFromFS(const QFileInfo& file);
-    void loadFromLevelDat(QByteArray data);
+    // with the decompressed contents of level.dat
+    void loadFromLevelDat(const QByteArray& uncompressed);
 
    protected:
     QFileInfo m_containerFile;
@@ -85,7 +113,7 @@ class World {
     QString m_iconFile;
     QDateTime levelDatTime;
     QDateTime m_lastPlayed;
-    int64_t m_size;
+    int64_t m_size = -1;
     int64_t m_randomSeed = 0;
     GameType m_gameType;
     bool is_valid = false;
@@ -0,0 +1,53 @@
+#include "WorldInstallTask.h"
+
+#include "tasks/Executor.h"
+
+WorldInstallTask::WorldInstallTask(const QFileInfo& source, QString saves, QString name)
+    : m_world(source, false), m_saves(std::move(saves)), m_name(std::move(name))
+{
+    setAbortable(true);
+}
+
+void WorldInstallTask::executeTask()
+{
+    setStatus(tr("Installing world %1...").arg(m_name.isEmpty() ? m_world.name() : m_name));
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, [this] {
+        if (cancellationToken().isCancelled()) {
+            emitAborted();
+        } else if (!m_watcher.result()) {
+            emitFailed(tr("Could not install the world %1.").arg(m_world.name()));
+        } else {
+            emitSucceeded();
+        }
+    });
+    auto cancel = cancellationToken();
+    m_watcher.setFuture(Executor::instance()->run(Executor::Priority::Bulk, [this, cancel] {
+        return m_world.install(m_saves, m_name, [this](qint64 done, qint64 total) { reportProgress(done, total); }, cancel);
+    }));
+}
+
+bool WorldInstallTask::abort()
+{
+    if (!m_watcher.isRunning()) {
+        return Task::abort();
+    }
+    // the workers stop between files, it's aborted once they're out
+    cancellationToken().cancel();
+    return true;
+}
+
+void WorldInstallTask::reportProgress(qint64 done, qint64 total)
+{
+    m_done = done;
+    m_total = total;
+    if (m_progressQueued.exchange(true)) {
+        return;
+    }
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            m_progressQueued = false;
+            setProgress(m_done, m_total);
+        },
+        Qt::QueuedConnection);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QString>
+
+#include <atomic>
+
+#include "minecraft/World.h"
+#include "tasks/Task.h"
+
+/** Installs a world from an archive or copies one from a folder with World::install, off the GUI thread. */
+class WorldInstallTask : public Task {
+    Q_OBJECT
+   public:
+    /// put the world at `source` into the saves folder `saves`, named `name` if that's given
+    WorldInstallTask(const QFileInfo& source, QString saves, QString name = {});
+
+    bool abort() override;
+
+   protected:
+    void executeTask() override;
+
+   private:
+    void reportProgress(qint64 done, qint64 total);
+
+   private:
+    World m_world;
+    QString m_saves;
+    QString m_name;
+    QFutureWatcher<bool> m_watcher;
+
+    // the latest progress from the workers, handed to the task's thread one at a time
+    std::atomic<qint64> m_done{ 0 };
+    std::atomic<qint64> m_total{ 0 };
+    std::atomic<bool> m_progressQueued{ false };
+};
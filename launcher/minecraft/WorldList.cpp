@@ -37,22 +37,31 @@
 
 #include <FileSystem.h>
 #include <QDebug>
-#include <QFileSystemWatcher>
 #include <QMimeData>
 #include <QString>
 #include <QUrl>
 #include <QUuid>
 #include <Qt>
 #include "Application.h"
-
-WorldList::WorldList(const QString& dir, BaseInstance* instance) : QAbstractListModel(), m_instance(instance), m_dir(dir)
+#include "DiskUsage.h"
+#include "MMCZip.h"
+#include "filewatch/FileChangeBus.h"
+#include "minecraft/WorldInstallTask.h"
+#include "minecraft/WorldSnapshotTask.h"
+
+WorldList::WorldList(const QString& dir, BaseInstance* instance)
+    : QAbstractListModel()
+    , m_instance(instance)
+    , m_dir(dir)
+    , m_summaries(instance ? FS::PathCombine(instance->instanceRoot(), ".worlds.json") : QString())
 {
+    m_summaries.load();
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
-    m_watcher = new QFileSystemWatcher(this);
     is_watching = false;
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &WorldList::directoryChanged);
+    if (auto usage = DiskUsage::shared())
+        connect(usage, &DiskUsage::sizeChanged, this, &WorldList::sizeChanged);
 }
 
 void WorldList::startWatching()
@@ -61,12 +70,12 @@ void WorldList::startWatching()
         return;
     }
     update();
-    is_watching = m_watcher->addPath(m_dir.absolutePath());
-    if (is_watching) {
-        qDebug() << "Started watching " << m_dir.absolutePath();
-    } else {
-        qDebug() << "Failed to start watching " << m_dir.absolutePath();
-    }
+    // worlds being copied in are one reload, not one for every file
+    m_watch = FileChangeBus::instance()->subscribe({ m_dir.absolutePath() }, 250, this);
+    connect(m_watch, &FileChangeSubscription::changed, this, &WorldList::directoriesChanged);
+    is_watching = true;
+    if (auto usage = DiskUsage::shared())
+        usage->watch(m_dir.absolutePath());
 }
 
 void WorldList::stopWatching()
@@ -74,12 +83,11 @@ void WorldList::stopWatching()
     if (!is_watching) {
         return;
     }
-    is_watching = !m_watcher->removePath(m_dir.absolutePath());
-    if (!is_watching) {
-        qDebug() << "Stopped watching " << m_dir.absolutePath();
-    } else {
-        qDebug() << "Failed to stop watching " << m_dir.absolutePath();
-    }
+    delete m_watch;
+    m_watch = nullptr;
+    is_watching = false;
+    if (auto usage = DiskUsage::shared())
+        usage->unwatch(m_dir.absolutePath());
 }
 
 bool WorldList::update()
@@ -90,24 +98,57 @@ bool WorldList::update()
     QList<World> newWorlds;
     m_dir.refresh();
     auto folderContents = m_dir.entryInfoList();
+    auto usage = DiskUsage::shared();
     // if there are any untracked files...
     for (QFileInfo entry : folderContents) {
         if (!entry.isDir())
             continue;
 
-        World w(entry);
+        if (auto summary = m_summaries.get(entry)) {
+            newWorlds.append(World(entry, *summary));
+            continue;
+        }
+        World w(entry, false);
         if (w.isValid()) {
+            // played since, what was added up before doesn't hold anymore
+            if (usage)
+                usage->invalidate(entry.absoluteFilePath());
+            m_summaries.put(entry, w.summary());
             newWorlds.append(w);
         }
     }
+    // the sizes nobody knows yet are added up in the background and show up as they're done
+    for (auto& world : newWorlds) {
+        if (world.bytes() >= 0 || !usage)
+            continue;
+        auto bytes = usage->size(world.container().absoluteFilePath());
+        if (bytes >= 0) {
+            world.setBytes(bytes);
+            m_summaries.putSize(world.folderName(), bytes);
+        }
+    }
     beginResetModel();
     worlds.swap(newWorlds);
     endResetModel();
     return true;
 }
 
-void WorldList::directoryChanged(QString path)
+void WorldList::sizeChanged(const QString& path, qint64 bytes)
 {
+    for (int row = 0; row < worlds.size(); row++) {
+        auto& world = worlds[row];
+        if (QDir::cleanPath(world.container().absoluteFilePath()) != path)
+            continue;
+        world.setBytes(bytes);
+        m_summaries.putSize(world.folderName(), bytes);
+        emit dataChanged(index(row, SizeColumn), index(row, SizeColumn), { Qt::DisplayRole, Qt::UserRole, SizeRole });
+        break;
+    }
+}
+
+void WorldList::directoriesChanged([[maybe_unused]] const QSet<QString>& paths)
+{
+    // there's only the one folder, what's in it is told apart by the summaries
     update();
 }
 
@@ -161,6 +202,32 @@ bool WorldList::resetIcon(int row)
     return false;
 }
 
+static QString snapshotStoreOf(const QString& instDir)
+{
+    return FS::PathCombine(instDir, ".world-snapshots");
+}
+
+Task::Ptr WorldList::snapshotWorld(int index)
+{
+    if (index >= worlds.size() || index < 0 || !worlds[index].isOnFS())
+        return nullptr;
+    return makeShared<WorldSnapshotTask>(snapshotStoreOf(instDirPath()), worlds[index].container().absoluteFilePath());
+}
+
+QList<WorldSnapshots::Snapshot> WorldList::snapshots(int index) const
+{
+    if (index >= worlds.size() || index < 0)
+        return {};
+    return WorldSnapshots(snapshotStoreOf(instDirPath())).list(worlds[index].folderName());
+}
+
+Task::Ptr WorldList::restoreSnapshot(const WorldSnapshots::Snapshot& snapshot)
+{
+    if (snapshot.id.isEmpty())
+        return nullptr;
+    return makeShared<WorldSnapshotTask>(snapshotStoreOf(instDirPath()), m_dir.absoluteFilePath(snapshot.world), snapshot.id);
+}
+
 int WorldList::columnCount(const QModelIndex& parent) const
 {
     return parent.isValid() ? 0 : 5;
@@ -193,6 +260,9 @@ QVariant WorldList::data(const QModelIndex& index, int role) const
                     return world.lastPlayed();
 
                 case SizeColumn:
+                    // still being added up
+                    if (world.bytes() < 0)
+                        return QVariant();
                     return locale.formattedDataSize(world.bytes());
 
                 case InfoColumn:
@@ -374,14 +444,33 @@ Qt::DropActions WorldList::supportedDropActions() const
     return Qt::CopyAction | Qt::MoveAction;
 }
 
-void WorldList::installWorld(QFileInfo filename)
+Task::Ptr WorldList::installWorld(QFileInfo filename, const QString& name)
 {
     qDebug() << "installing: " << filename.absoluteFilePath();
-    World w(filename);
+    World w(filename, false);
     if (!w.isValid()) {
-        return;
+        return nullptr;
     }
-    w.install(m_dir.absolutePath());
+    return makeShared<WorldInstallTask>(filename, m_dir.absolutePath(), name);
+}
+
+Task::Ptr WorldList::copyWorld(int index, const QString& name)
+{
+    if (index >= worlds.size() || index < 0)
+        return nullptr;
+    return makeShared<WorldInstallTask>(worlds[index].container(), m_dir.absolutePath(), name);
+}
+
+Task::Ptr WorldList::exportWorld(int index, const QString& zipPath)
+{
+    if (index >= worlds.size() || index < 0 || !worlds[index].isOnFS())
+        return nullptr;
+    auto folder = worlds[index].container().absoluteFilePath();
+    QFileInfoList files;
+    if (!MMCZip::collectFileListRecursively(folder, nullptr, &files, nullptr))
+        return nullptr;
+    // compressed by the thread pool, one entry per thread
+    return makeShared<MMCZip::ExportToZipTask>(zipPath, folder, files, worlds[index].folderName() + '/');
 }
 
 bool WorldList::dropMimeData(const QMimeData* data,
@@ -397,9 +486,6 @@ bool WorldList::dropMimeData(const QMimeData* data,
         return false;
     // files dropped from outside?
     if (data->hasUrls()) {
-        bool was_watching = is_watching;
-        if (was_watching)
-            stopWatching();
         auto urls = data->urls();
         for (auto url : urls) {
             // only local files may be dropped...
@@ -410,11 +496,26 @@ bool WorldList::dropMimeData(const QMimeData* data,
             QFileInfo worldInfo(filename);
 
             if (!m_dir.entryInfoList().contains(worldInfo)) {
-                installWorld(worldInfo);
+                auto task = installWorld(worldInfo);
+                if (!task)
+                    continue;
+                m_droppedInstalls.append(task);
+                // let go of the task once it's done emitting, not while it is
+                connect(
+                    task.get(), &Task::finished, this,
+                    [this, task = task.get()] {
+                        for (int i = 0; i < m_droppedInstalls.size(); i++) {
+                            if (m_droppedInstalls[i].get() == task) {
+                                m_droppedInstalls.removeAt(i);
+                                break;
+                            }
+                        }
+                        update();
+                    },
+                    Qt::QueuedConnection);
+                task->start();
             }
         }
-        if (was_watching)
-            startWatching();
         return true;
     }
     return false;
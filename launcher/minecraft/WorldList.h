@@ -19,11 +19,16 @@
 #include <QDir>
 #include <QList>
 #include <QMimeData>
+#include <QSet>
 #include <QString>
+
 #include "BaseInstance.h"
 #include "minecraft/World.h"
+#include "minecraft/WorldSnapshots.h"
+#include "minecraft/WorldSummaryCache.h"
+#include "tasks/Task.h"
 
-class QFileSystemWatcher;
+class FileChangeSubscription;
 
 class WorldList : public QAbstractListModel {
     Q_OBJECT
@@ -47,8 +52,14 @@ class WorldList : public QAbstractListModel {
     /// Reloads the mod list and returns true if the list changed.
     virtual bool update();
 
-    /// Install a world from location
-    void installWorld(QFileInfo filename);
+    /// Install a world from location, named `name` if that's given. Null if there's no world there.
+    Task::Ptr installWorld(QFileInfo filename, const QString& name = QString());
+
+    /// Copy the world at the given index next to it, as `name`
+    Task::Ptr copyWorld(int index, const QString& name);
+
+    /// Zip the world at the given index into `zipPath`, as the folder it's in
+    Task::Ptr exportWorld(int index, const QString& zipPath);
 
     /// Deletes the mod at the given index.
     virtual bool deleteWorld(int index);
@@ -59,6 +70,13 @@ class WorldList : public QAbstractListModel {
     /// Deletes all the selected mods
     virtual bool deleteWorlds(int first, int last);
 
+    /// Snapshot the world at the given index, only what changed since its last snapshot gets stored. Null if it can't be.
+    Task::Ptr snapshotWorld(int index);
+    /// The snapshots of the world at the given index, oldest first
+    QList<WorldSnapshots::Snapshot> snapshots(int index) const;
+    /// Put the world the snapshot was taken of back as it was then
+    Task::Ptr restoreSnapshot(const WorldSnapshots::Snapshot& snapshot);
+
     /// flags, mostly to support drag&drop
     virtual Qt::ItemFlags flags(const QModelIndex& index) const;
     /// get data for drag action
@@ -85,15 +103,20 @@ class WorldList : public QAbstractListModel {
     const QList<World>& allWorlds() const { return worlds; }
 
    private slots:
-    void directoryChanged(QString path);
+    void directoriesChanged(const QSet<QString>& paths);
+    void sizeChanged(const QString& path, qint64 bytes);
 
    signals:
     void changed();
 
    protected:
     BaseInstance* m_instance;
-    QFileSystemWatcher* m_watcher;
+    FileChangeSubscription* m_watch = nullptr;
     bool is_watching;
+    // the installs of worlds dropped on the list, which run without anyone waiting on them
+    QList<Task::Ptr> m_droppedInstalls;
     QDir m_dir;
     QList<World> worlds;
+    // what level.dat said last time, so only the worlds played since get read again
+    WorldSummaryCache m_summaries;
 };
@@ -0,0 +1,61 @@
+#include "WorldSnapshotTask.h"
+
+#include <QFileInfo>
+#include <QMutex>
+
+#include "FileSystem.h"
+#include "minecraft/WorldSnapshots.h"
+#include "tasks/Executor.h"
+
+// the store isn't thread safe, and two snapshots of the same world at once make no sense anyway
+static QMutex s_store_mutex;
+
+WorldSnapshotTask::WorldSnapshotTask(QString store, QString world_dir) : m_store(std::move(store)), m_worldDir(std::move(world_dir)) {}
+
+WorldSnapshotTask::WorldSnapshotTask(QString store, QString world_dir, QString id)
+    : m_store(std::move(store)), m_worldDir(std::move(world_dir)), m_id(std::move(id)), m_restore(true)
+{}
+
+void WorldSnapshotTask::executeTask()
+{
+    setStatus(m_restore ? tr("Restoring world snapshot...") : tr("Taking world snapshot..."));
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, [this] {
+        auto result = m_watcher.result();
+        if (!result.error.isEmpty()) {
+            emitFailed(result.error);
+            return;
+        }
+        m_id = result.id;
+        emitSucceeded();
+    });
+    m_watcher.setFuture(Executor::instance()->run(Executor::Priority::Bulk, [this] { return run(); }));
+}
+
+WorldSnapshotTask::Result WorldSnapshotTask::run()
+{
+    QMutexLocker lock(&s_store_mutex);
+    WorldSnapshots snapshots(m_store);
+    QString error;
+    if (!m_restore) {
+        auto id = snapshots.take(m_worldDir, error);
+        return { id, id.isEmpty() ? error : QString() };
+    }
+
+    // put it together next to the world, so the world is only replaced once that worked
+    auto restoring = m_worldDir + ".restoring";
+    auto replaced = m_worldDir + ".replaced";
+    FS::deletePath(restoring);
+    if (!snapshots.restore(m_id, restoring, error))
+        return { {}, error };
+    if (QFileInfo::exists(m_worldDir) && !FS::move(m_worldDir, replaced)) {
+        FS::deletePath(restoring);
+        return { {}, tr("Could not move the world out of the way.") };
+    }
+    if (!FS::move(restoring, m_worldDir)) {
+        FS::move(replaced, m_worldDir);
+        FS::deletePath(restoring);
+        return { {}, tr("Could not put the restored world in place.") };
+    }
+    FS::deletePath(replaced);
+    return { m_id, {} };
+}
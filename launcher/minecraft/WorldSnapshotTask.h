@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QString>
+
+#include "tasks/Task.h"
+
+/** Takes or restores a snapshot of a world with WorldSnapshots, off the GUI thread. */
+class WorldSnapshotTask : public Task {
+    Q_OBJECT
+   public:
+    /// snapshot the world in `world_dir` into the store at `store`
+    WorldSnapshotTask(QString store, QString world_dir);
+    /// replace the world in `world_dir` with snapshot `id` from the store at `store`
+    WorldSnapshotTask(QString store, QString world_dir, QString id);
+
+    /// the snapshot taken, once it succeeded
+    [[nodiscard]] QString snapshotId() const { return m_id; }
+
+   protected:
+    void executeTask() override;
+
+   private:
+    struct Result {
+        QString id;
+        QString error;
+    };
+
+    Result run();
+
+   private:
+    QString m_store;
+    QString m_worldDir;
+    QString m_id;
+    bool m_restore = false;
+    QFutureWatcher<Result> m_watcher;
+};
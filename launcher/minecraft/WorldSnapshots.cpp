@@ -0,0 +1,343 @@
+#include "WorldSnapshots.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <optional>
+
+#include "FileSystem.h"
+
+namespace {
+constexpr int sectorSize = 4096;
+// a SHA-1 and where the sector is in the pack
+constexpr int sectorRecordSize = 20 + 8;
+constexpr quint32 manifestMagic = 0x574e5350;  // WSNP
+constexpr quint32 manifestVersion = 1;
+
+bool isRegion(const QFileInfo& info)
+{
+    // chunks, entities and points of interest all come in regions
+    auto suffix = info.suffix();
+    return suffix == "mca" || suffix == "mcr";
+}
+
+QByteArray hashFile(QFile& file)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    return hash.addData(&file) ? hash.result() : QByteArray();
+}
+
+QByteArray hashFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return hashFile(file);
+}
+}  // namespace
+
+WorldSnapshots::WorldSnapshots(QString root) : m_root(std::move(root)) {}
+
+QString WorldSnapshots::take(const QString& world_dir, QString& error)
+{
+    QDir world(world_dir);
+    if (!world.exists()) {
+        error = QObject::tr("The world folder %1 doesn't exist.").arg(world_dir);
+        return {};
+    }
+    if (!loadSectorIndex(error))
+        return {};
+
+    // what didn't change since the last snapshot of the world is taken as it was
+    QHash<QString, Entry> previous;
+    auto earlier = list(world.dirName());
+    Manifest last;
+    if (!earlier.isEmpty() && readManifest(manifestPath(earlier.last().id), last)) {
+        for (auto const& entry : last.entries)
+            previous.insert(entry.path, entry);
+    }
+
+    Manifest manifest;
+    manifest.info.world = world.dirName();
+    manifest.info.created = QDateTime::currentDateTimeUtc();
+    manifest.info.id = QString("%1-%2").arg(world.dirName()).arg(manifest.info.created.toMSecsSinceEpoch());
+
+    QDirIterator it(world.absolutePath(), QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto file = it.next();
+        auto info = it.fileInfo();
+        auto path = world.relativeFilePath(file);
+        // held by the game while it runs, there's nothing in it
+        if (path == "session.lock")
+            continue;
+
+        Entry entry;
+        entry.path = path;
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        entry.region = isRegion(info);
+
+        auto old = previous.constFind(path);
+        if (old != previous.constEnd() && old->size == entry.size && old->modified == entry.modified && old->region == entry.region) {
+            entry = *old;
+        } else if (!(entry.region ? storeRegion(file, entry, error) : storeWhole(file, entry, error))) {
+            return {};
+        }
+        manifest.info.size += entry.size;
+        manifest.entries.append(entry);
+    }
+
+    if (!writeManifest(manifestPath(manifest.info.id), manifest)) {
+        error = QObject::tr("Could not write the snapshot manifest.");
+        return {};
+    }
+    return manifest.info.id;
+}
+
+bool WorldSnapshots::restore(const QString& id, const QString& target_dir, QString& error)
+{
+    Manifest manifest;
+    if (!readManifest(manifestPath(id), manifest)) {
+        error = QObject::tr("The snapshot %1 is missing or damaged.").arg(id);
+        return false;
+    }
+    if (QFileInfo::exists(target_dir)) {
+        error = QObject::tr("%1 already exists.").arg(target_dir);
+        return false;
+    }
+    QDir target(target_dir);
+    if (!target.mkpath(".")) {
+        error = QObject::tr("Could not create %1.").arg(target_dir);
+        return false;
+    }
+
+    QFile pack(FS::PathCombine(m_root, "sectors.pack"));
+    std::optional<bool> cloneable;
+    auto fail = [&](const QString& why) {
+        error = why;
+        FS::deletePath(target_dir);
+        return false;
+    };
+
+    for (auto const& entry : manifest.entries) {
+        auto dest = target.absoluteFilePath(entry.path);
+        if (!FS::ensureFilePathExists(dest))
+            return fail(QObject::tr("Could not create the folder of %1.").arg(entry.path));
+
+        if (!entry.region) {
+            auto object = objectPath(entry.hash);
+            if (!QFileInfo::exists(object))
+                return fail(QObject::tr("The stored copy of %1 is missing.").arg(entry.path));
+            if (!cloneable)
+                cloneable = FS::canClone(object, target_dir);
+            std::error_code ec;
+            bool placed = *cloneable && FS::clone_file(object, dest, ec);
+            if (!placed) {
+                QFile::remove(dest);
+                placed = QFile::copy(object, dest);
+            }
+            if (!placed)
+                return fail(QObject::tr("Could not restore %1.").arg(entry.path));
+        } else {
+            if (!pack.isOpen() && !pack.open(QIODevice::ReadOnly))
+                return fail(QObject::tr("Could not open the stored region sectors."));
+            QFile out(dest);
+            if (!out.open(QIODevice::WriteOnly))
+                return fail(QObject::tr("Could not restore %1.").arg(entry.path));
+            for (int i = 0; i < entry.sectors.size(); i++) {
+                auto length = i == entry.sectors.size() - 1 ? entry.size - qint64(sectorSize) * i : qint64(sectorSize);
+                if (!pack.seek(entry.sectors[i]))
+                    return fail(QObject::tr("The stored sectors of %1 are damaged.").arg(entry.path));
+                auto data = pack.read(length);
+                if (data.size() != length || out.write(data) != length)
+                    return fail(QObject::tr("The stored sectors of %1 are damaged.").arg(entry.path));
+            }
+        }
+
+        // the next snapshot of the world doesn't have to read them again
+        QFile restored(dest);
+        if (restored.open(QIODevice::ReadWrite))
+            restored.setFileTime(QDateTime::fromMSecsSinceEpoch(entry.modified), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+QList<WorldSnapshots::Snapshot> WorldSnapshots::list(const QString& world) const
+{
+    QList<Snapshot> out;
+    QDir manifests(FS::PathCombine(m_root, "manifests"));
+    for (auto const& file : manifests.entryInfoList({ "*.snapshot" }, QDir::Files)) {
+        Manifest manifest;
+        if (!readManifest(file.absoluteFilePath(), manifest, true))
+            continue;
+        if (world.isEmpty() || manifest.info.world == world)
+            out.append(manifest.info);
+    }
+    std::sort(out.begin(), out.end(), [](const Snapshot& a, const Snapshot& b) { return a.created < b.created; });
+    return out;
+}
+
+bool WorldSnapshots::storeWhole(const QString& file, Entry& entry, QString& error)
+{
+    entry.hash = hashFile(file);
+    if (entry.hash.isEmpty()) {
+        error = QObject::tr("Could not read %1.").arg(file);
+        return false;
+    }
+    if (QFileInfo::exists(objectPath(entry.hash)))
+        return true;
+
+    // hash what ends up in the store, in case the file changed since
+    auto tmp = FS::PathCombine(m_root, "objects", "incoming");
+    QFile::remove(tmp);
+    std::error_code ec;
+    if (!FS::ensureFilePathExists(tmp) || (!FS::clone_file(file, tmp, ec) && !QFile::copy(file, tmp))) {
+        error = QObject::tr("Could not store %1.").arg(file);
+        return false;
+    }
+    entry.hash = hashFile(tmp);
+    auto object = objectPath(entry.hash);
+    if (QFileInfo::exists(object) || (FS::ensureFilePathExists(object) && QFile::rename(tmp, object))) {
+        QFile::remove(tmp);
+        return true;
+    }
+    QFile::remove(tmp);
+    error = QObject::tr("Could not store %1.").arg(file);
+    return false;
+}
+
+bool WorldSnapshots::storeRegion(const QString& file, Entry& entry, QString& error)
+{
+    QFile in(file);
+    QFile pack(FS::PathCombine(m_root, "sectors.pack"));
+    QFile index(FS::PathCombine(m_root, "sectors.idx"));
+    if (!in.open(QIODevice::ReadOnly) || !pack.open(QIODevice::Append) || !index.open(QIODevice::Append)) {
+        error = QObject::tr("Could not store %1.").arg(file);
+        return false;
+    }
+
+    entry.sectors.clear();
+    QDataStream records(&index);
+    while (!in.atEnd()) {
+        auto sector = in.read(sectorSize);
+        if (sector.isEmpty())
+            break;
+        auto hash = QCryptographicHash::hash(sector, QCryptographicHash::Sha1);
+        auto known = m_sectors.constFind(hash);
+        if (known != m_sectors.constEnd()) {
+            entry.sectors.append(*known);
+            continue;
+        }
+
+        qint64 offset = pack.size();
+        if (pack.write(sector) != sector.size()) {
+            error = QObject::tr("Could not store %1.").arg(file);
+            return false;
+        }
+        records.writeRawData(hash.constData(), hash.size());
+        records << offset;
+        m_sectors.insert(hash, offset);
+        entry.sectors.append(offset);
+    }
+    // what was read, the last sector is only as long as what's left of it
+    entry.size = in.pos();
+    return pack.flush() && index.flush();
+}
+
+bool WorldSnapshots::loadSectorIndex(QString& error)
+{
+    if (m_sectorsLoaded)
+        return true;
+    if (!QDir().mkpath(m_root)) {
+        error = QObject::tr("Could not create the snapshot store at %1.").arg(m_root);
+        return false;
+    }
+
+    QFile index(FS::PathCombine(m_root, "sectors.idx"));
+    auto packSize = QFileInfo(FS::PathCombine(m_root, "sectors.pack")).size();
+    if (index.open(QIODevice::ReadOnly)) {
+        QDataStream records(&index);
+        // a record cut short by a crash is ignored, as is one whose sector didn't make it into the pack
+        while (index.bytesAvailable() >= sectorRecordSize) {
+            QByteArray hash(20, Qt::Uninitialized);
+            qint64 offset;
+            records.readRawData(hash.data(), hash.size());
+            records >> offset;
+            if (offset < packSize)
+                m_sectors.insert(hash, offset);
+        }
+    }
+    m_sectorsLoaded = true;
+    return true;
+}
+
+QString WorldSnapshots::objectPath(const QByteArray& hash) const
+{
+    auto hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(m_root, "objects", hex.left(2), hex);
+}
+
+QString WorldSnapshots::manifestPath(const QString& id) const
+{
+    return FS::PathCombine(m_root, "manifests", id + ".snapshot");
+}
+
+bool WorldSnapshots::readManifest(const QString& path, Manifest& manifest, bool header_only)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic, version;
+    qint64 created;
+    quint32 count;
+    in >> magic >> version;
+    if (magic != manifestMagic || version != manifestVersion)
+        return false;
+    in >> manifest.info.id >> manifest.info.world >> created >> manifest.info.size >> count;
+    manifest.info.created = QDateTime::fromMSecsSinceEpoch(created, Qt::UTC);
+    if (header_only)
+        return in.status() == QDataStream::Ok;
+
+    manifest.entries.clear();
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Entry entry;
+        in >> entry.path >> entry.size >> entry.modified >> entry.region;
+        if (entry.region)
+            in >> entry.sectors;
+        else
+            in >> entry.hash;
+        manifest.entries.append(entry);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool WorldSnapshots::writeManifest(const QString& path, const Manifest& manifest)
+{
+    if (!FS::ensureFilePathExists(path))
+        return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << manifestMagic << manifestVersion << manifest.info.id << manifest.info.world << manifest.info.created.toMSecsSinceEpoch()
+        << manifest.info.size << quint32(manifest.entries.size());
+    for (auto const& entry : manifest.entries) {
+        out << entry.path << entry.size << entry.modified << entry.region;
+        if (entry.region)
+            out << entry.sectors;
+        else
+            out << entry.hash;
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+/**
+ * Snapshots of worlds, kept in a store where every piece of content is there only once.
+ *
+ * Copying or zipping a save of a few GB for every backup was slow, and took that much space again each time. Here a
+ * snapshot is a manifest of the world's files. Region files are split into their 4 KiB sectors, and only sectors the
+ * store doesn't have yet get written, so snapshotting a world that was played for a bit costs the chunks that changed.
+ * Everything else is stored whole by its SHA-1. Files with the same size and modification time as in the last
+ * snapshot of the world aren't even read.
+ *
+ * Restoring clones whole files out of the store where the filesystem can, and copies them otherwise. Region files
+ * are put together from their sectors.
+ *
+ * Not thread safe, and the world shouldn't be played while it's being snapshotted.
+ */
+class WorldSnapshots {
+   public:
+    struct Snapshot {
+        // name of the manifest
+        QString id;
+        // folder name of the world
+        QString world;
+        QDateTime created;
+        // of the world when it was taken
+        qint64 size = 0;
+    };
+
+    // supply path to the store
+    explicit WorldSnapshots(QString root);
+
+    /// snapshot the world in `world_dir`, returns the id of the snapshot, or an empty string and why in `error`
+    QString take(const QString& world_dir, QString& error);
+    /// put the world back as it was in snapshot `id` at `target_dir`, which must not exist yet
+    bool restore(const QString& id, const QString& target_dir, QString& error);
+    /// the snapshots of `world`, or of every world, oldest first
+    QList<Snapshot> list(const QString& world = QString()) const;
+
+   private:
+    struct Entry {
+        QString path;
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool region = false;
+        // SHA-1 of whole files
+        QByteArray hash;
+        // where the sectors of region files are in the pack
+        QList<qint64> sectors;
+    };
+    struct Manifest {
+        Snapshot info;
+        QList<Entry> entries;
+    };
+
+    bool storeWhole(const QString& file, Entry& entry, QString& error);
+    bool storeRegion(const QString& file, Entry& entry, QString& error);
+    bool loadSectorIndex(QString& error);
+
+    QString objectPath(const QByteArray& hash) const;
+    QString manifestPath(const QString& id) const;
+    static bool readManifest(const QString& path, Manifest& manifest, bool header_only = false);
+    static bool writeManifest(const QString& path, const Manifest& manifest);
+
+   private:
+    QString m_root;
+    // where each sector is in the pack, by its SHA-1
+    QHash<QByteArray, qint64> m_sectors;
+    bool m_sectorsLoaded = false;
+};
@@ -0,0 +1,178 @@
+#include "WorldSummaryCache.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Exception.h"
+#include "Json.h"
+
+// entries that weren't used for this long are dropped on save, the world is most likely gone
+static constexpr qint64 maxUnusedAge = 90 * 24 * 60 * 60;
+
+static QFileInfo levelDatOf(const QFileInfo& worldFolder)
+{
+    return QFileInfo(QDir(worldFolder.absoluteFilePath()).filePath("level.dat"));
+}
+
+WorldSummaryCache::WorldSummaryCache(QString path) : QObject(), m_cache_file(path)
+{
+    m_saveBatchingTimer.setSingleShot(true);
+    m_saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&m_saveBatchingTimer, &QTimer::timeout, this, &WorldSummaryCache::saveNow);
+}
+
+WorldSummaryCache::~WorldSummaryCache()
+{
+    if (m_saveBatchingTimer.isActive()) {
+        m_saveBatchingTimer.stop();
+        saveNow();
+    }
+}
+
+std::optional<WorldSummary> WorldSummaryCache::get(const QFileInfo& worldFolder)
+{
+    auto entry = m_entries.find(worldFolder.fileName());
+    if (entry == m_entries.end()) {
+        return {};
+    }
+    auto levelDat = levelDatOf(worldFolder);
+    if (!levelDat.exists() || entry->levelDatSize != levelDat.size() ||
+        entry->levelDatModified != levelDat.lastModified().toMSecsSinceEpoch()) {
+        // the world was played or replaced, it needs reading again
+        m_entries.erase(entry);
+        return {};
+    }
+    entry->lastUsed = QDateTime::currentSecsSinceEpoch();
+    return entry->summary;
+}
+
+void WorldSummaryCache::put(const QFileInfo& worldFolder, const WorldSummary& summary)
+{
+    auto levelDat = levelDatOf(worldFolder);
+    if (!levelDat.exists()) {
+        return;
+    }
+
+    auto& entry = m_entries[worldFolder.fileName()];
+    entry.levelDatSize = levelDat.size();
+    entry.levelDatModified = levelDat.lastModified().toMSecsSinceEpoch();
+    entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+    entry.summary = summary;
+    saveEventually();
+}
+
+void WorldSummaryCache::putSize(const QString& folderName, int64_t size)
+{
+    auto entry = m_entries.find(folderName);
+    if (entry == m_entries.end() || entry->summary.size == size) {
+        return;
+    }
+    entry->summary.size = size;
+    saveEventually();
+}
+
+void WorldSummaryCache::load()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QFile file(m_cache_file);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    QJsonDocument json = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+    // Fail if the JSON is invalid.
+    if (parseError.error != QJsonParseError::NoError) {
+        qCritical() << QString("Failed to parse WorldSummaryCache file: %1 at offset %2")
+                           .arg(parseError.errorString(), QString::number(parseError.offset))
+                           .toUtf8();
+        return;
+    }
+
+    // Make sure the root is an object.
+    if (!json.isObject()) {
+        qCritical() << "WorldSummaryCache root should be an object.";
+        return;
+    }
+
+    auto root = json.object();
+
+    // check file version first
+    auto version_val = Json::ensureString(root, "version");
+    if (version_val != "1")
+        return;
+
+    auto array = Json::ensureArray(root, "entries");
+    for (auto element : array) {
+        auto element_obj = Json::ensureObject(element);
+        auto folder = Json::ensureString(element_obj, "folder");
+        if (folder.isEmpty())
+            continue;
+
+        Entry entry;
+        entry.levelDatSize = Json::ensureDouble(element_obj, "level_dat_size");
+        entry.levelDatModified = Json::ensureDouble(element_obj, "level_dat_modified");
+        entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+        entry.summary.name = Json::ensureString(element_obj, "name");
+        entry.summary.lastPlayed = QDateTime::fromMSecsSinceEpoch(qint64(Json::ensureDouble(element_obj, "last_played")));
+        if (element_obj.contains("game_type"))
+            entry.summary.gameType = Json::ensureInteger(element_obj, "game_type");
+        // kept as a string, doubles can't hold every seed
+        entry.summary.seed = Json::ensureString(element_obj, "seed").toLongLong();
+        entry.summary.size = Json::ensureDouble(element_obj, "size", -1);
+        m_entries.insert(folder, entry);
+    }
+}
+
+void WorldSummaryCache::saveEventually()
+{
+    // reset the save timer
+    m_saveBatchingTimer.stop();
+    m_saveBatchingTimer.start(30000);
+}
+
+void WorldSummaryCache::saveNow()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "1");
+
+    QJsonArray entriesArr;
+    auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+    for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+        if (iter->lastUsed < oldest) {
+            iter = m_entries.erase(iter);
+            continue;
+        }
+        QJsonObject entryObj;
+        Json::writeString(entryObj, "folder", iter.key());
+        entryObj.insert("level_dat_size", QJsonValue(double(iter->levelDatSize)));
+        entryObj.insert("level_dat_modified", QJsonValue(double(iter->levelDatModified)));
+        entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+        Json::writeString(entryObj, "name", iter->summary.name);
+        entryObj.insert("last_played", QJsonValue(double(iter->summary.lastPlayed.toMSecsSinceEpoch())));
+        if (iter->summary.gameType)
+            entryObj.insert("game_type", *iter->summary.gameType);
+        Json::writeString(entryObj, "seed", QString::number(iter->summary.seed));
+        entryObj.insert("size", QJsonValue(double(iter->summary.size)));
+        entriesArr.append(entryObj);
+        iter++;
+    }
+    toplevel.insert("entries", entriesArr);
+
+    try {
+        Json::write(toplevel, m_cache_file);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing world summary cache:" << e.what();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+#include "minecraft/World.h"
+
+/**
+ * Persistent cache of what the level.dat of the worlds in an instance said, kept by its world list.
+ *
+ * Entries are keyed by the world folder and only trusted while the size and modification time of its level.dat still
+ * match. The game writes level.dat whenever it saves the world, so an entry also keeps the size of the world folder
+ * and that gets calculated again only after the world was played.
+ *
+ * Not thread safe, it lives on the GUI thread with the world list.
+ */
+class WorldSummaryCache : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the cache file
+    explicit WorldSummaryCache(QString path = QString());
+    ~WorldSummaryCache() override;
+
+    /// what the world in that folder was summarized as, if its level.dat didn't change since
+    std::optional<WorldSummary> get(const QFileInfo& worldFolder);
+    /// remember the summary of the world in that folder, as its level.dat is now
+    void put(const QFileInfo& worldFolder, const WorldSummary& summary);
+    /// remember the size of a world already summarized
+    void putSize(const QString& folderName, int64_t size);
+
+    void load();
+    // (re)start a timer that calls saveNow later
+    void saveEventually();
+
+   public slots:
+    void saveNow();
+
+   private:
+    struct Entry {
+        qint64 levelDatSize = 0;
+        qint64 levelDatModified = 0;
+        // last time the entry was used, in seconds since epoch
+        qint64 lastUsed = 0;
+        WorldSummary summary;
+    };
+
+   private:
+    QHash<QString, Entry> m_entries;
+    QString m_cache_file;
+    QTimer m_saveBatchingTimer;
+};
@@ -52,10 +52,14 @@
 #include <FileSystem.h>
 #include <QSaveFile>
 
+#include <algorithm>
 #include <chrono>
 
 enum AccountListVersion { MojangMSA = 3 };
 
+// a refresh changes an account in a few steps, and a lab full of accounts refreshes them one after the other
+const static int SAVE_DELAY_MS = 2000;
+
 AccountList::AccountList(QObject* parent) : QAbstractListModel(parent)
 {
     m_refreshTimer = new QTimer(this);
@@ -64,9 +68,17 @@ AccountList::AccountList(QObject* parent) : QAbstractListModel(parent)
     m_nextTimer = new QTimer(this);
     m_nextTimer->setSingleShot(true);
     connect(m_nextTimer, &QTimer::timeout, this, &AccountList::tryNext);
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &AccountList::saveList);
 }
 
-AccountList::~AccountList() noexcept {}
+AccountList::~AccountList() noexcept
+{
+    if (m_saveTimer->isActive())
+        saveList();
+}
 
 int AccountList::findAccountByProfileId(const QString& profileId) const
 {
@@ -135,6 +147,7 @@ void AccountList::addAccount(const MinecraftAccountPtr account)
             }
             // disconnect notifications for changes in the account being replaced
             existingAccountPtr->disconnect(this);
+            m_savedAccounts.remove(existingAccountPtr->internalId());
             emit dataChanged(index(existingAccount), index(existingAccount, columnCount(QModelIndex()) - 1));
             onListChanged();
             return;
@@ -162,6 +175,7 @@ void AccountList::removeAccount(QModelIndex index)
             onDefaultAccountChanged();
         }
         account->disconnect(this);
+        m_savedAccounts.remove(account->internalId());
 
         beginRemoveRows(QModelIndex(), row, row);
         m_accounts.removeAt(index.row());
@@ -215,6 +229,10 @@ void AccountList::setDefaultAccount(MinecraftAccountPtr newAccount)
 
 void AccountList::accountChanged()
 {
+    if (auto account = qobject_cast<MinecraftAccount*>(sender()))
+        m_savedAccounts.remove(account->internalId());
+    else
+        m_savedAccounts.clear();
     // the list changed. there is no doubt.
     onListChanged();
 }
@@ -242,21 +260,25 @@ void AccountList::accountActivityChanged(bool active)
 
 void AccountList::onListChanged()
 {
-    if (m_autosave)
-        // TODO: Alert the user if this fails.
-        saveList();
+    scheduleSave();
 
     emit listChanged();
 }
 
 void AccountList::onDefaultAccountChanged()
 {
-    if (m_autosave)
-        saveList();
+    scheduleSave();
 
     emit defaultAccountChanged();
 }
 
+void AccountList::scheduleSave()
+{
+    if (m_autosave)
+        // TODO: Alert the user if this fails.
+        m_saveTimer->start();
+}
+
 int AccountList::count() const
 {
     return m_accounts.count();
@@ -507,6 +529,7 @@ bool AccountList::loadV3(QJsonObject& root)
 
 bool AccountList::saveList()
 {
+    m_saveTimer->stop();
     if (m_listFilePath.isEmpty()) {
         qCritical() << "Can't save Mojang account list. No file path given and no default set.";
         return false;
@@ -523,19 +546,18 @@ bool AccountList::saveList()
         badDir.removeRecursively();
     }
 
-    qDebug() << "Writing account list to" << m_listFilePath;
-
-    qDebug() << "Building JSON data structure.";
     // Build the JSON document to write to the list file.
     QJsonObject root;
 
     root.insert("formatVersion", AccountListVersion::MojangMSA);
 
     // Build a list of accounts.
-    qDebug() << "Building account array.";
     QJsonArray accounts;
     for (MinecraftAccountPtr account : m_accounts) {
-        QJsonObject accountObj = account->saveToJson();
+        auto saved = m_savedAccounts.find(account->internalId());
+        if (saved == m_savedAccounts.end())
+            saved = m_savedAccounts.insert(account->internalId(), account->saveToJson());
+        QJsonObject accountObj = *saved;
         if (m_defaultAccount == account) {
             accountObj["active"] = true;
         }
@@ -546,10 +568,12 @@ bool AccountList::saveList()
     root.insert("accounts", accounts);
 
     // Create a JSON document object to convert our JSON to bytes.
-    QJsonDocument doc(root);
+    auto data = QJsonDocument(root).toJson();
+    if (data == m_savedList && QFileInfo::exists(m_listFilePath))
+        return true;
 
     // Now that we're done building the JSON object, we can write it to the file.
-    qDebug() << "Writing account list to file.";
+    qDebug() << "Writing account list to" << m_listFilePath;
     QSaveFile file(m_listFilePath);
 
     // Try to open the file and fail if we can't.
@@ -560,10 +584,11 @@ bool AccountList::saveList()
     }
 
     // Write the JSON to the file.
-    file.write(doc.toJson());
+    file.write(data);
     file.setPermissions(QFile::ReadOwner | QFile::WriteOwner | QFile::ReadUser | QFile::WriteUser);
     if (file.commit()) {
         qDebug() << "Saved account list to" << m_listFilePath;
+        m_savedList = data;
         return true;
     } else {
         qDebug() << "Failed to save accounts to" << m_listFilePath;
@@ -618,10 +643,32 @@ void AccountList::requestRefresh(QString accountId)
     m_refreshQueue.push_front(accountId);
     qDebug() << "AccountList: Pushed account with internal ID " << accountId << " to the front of the queue";
     if (!isActive()) {
+        // no need to keep it waiting for the pause between background refreshes
+        m_nextTimer->stop();
         tryNext();
     }
 }
 
+void AccountList::prewarm(MinecraftAccountPtr account)
+{
+    if (!account || account->accountType() != AccountType::MSA || account->isActive() || account->isInUse()) {
+        return;
+    }
+    // the launch refreshes these first, and the others once their token is close to expiring
+    auto state = account->accountState();
+    if (state != AccountState::Unchecked && state != AccountState::Errored && !account->shouldRefresh()) {
+        return;
+    }
+    auto now = QDateTime::currentDateTimeUtc();
+    auto last = m_prewarmed.value(account->internalId());
+    if (last.isValid() && last.secsTo(now) < 5 * 60) {
+        return;
+    }
+    m_prewarmed[account->internalId()] = now;
+    qDebug() << "RefreshSchedule: Prewarming account" << account->accountDisplayString();
+    requestRefresh(account->internalId());
+}
+
 void AccountList::queueRefresh(QString accountId)
 {
     if (m_refreshQueue.indexOf(accountId) != -1) {
@@ -652,8 +699,23 @@ void AccountList::tryNext()
         }
         qDebug() << "RefreshSchedule: Account with with internal ID " << accountId << " not found.";
     }
-    // if we get here, no account needed refreshing. Schedule refresh in an hour.
-    m_refreshTimer->start(1000 * 3600);
+    // if we get here, no account needed refreshing
+    scheduleFill();
+}
+
+void AccountList::scheduleFill()
+{
+    // look again at least hourly, a timer set for many hours can be missed by a computer that slept
+    qint64 wait = 1000 * 3600;
+    auto now = QDateTime::currentDateTimeUtc();
+    for (int i = 0; i < count(); i++) {
+        // the ones already due were just tried, they're tried again in an hour like before
+        auto due = at(i)->refreshDue();
+        if (due.isValid() && due > now) {
+            wait = std::min(wait, std::max<qint64>(1000 * 60, now.msecsTo(due)));
+        }
+    }
+    m_refreshTimer->start(static_cast<int>(wait));
 }
 
 void AccountList::authSucceeded()
@@ -38,6 +38,9 @@
 #include "MinecraftAccount.h"
 
 #include <QAbstractListModel>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonObject>
 #include <QObject>
 #include <QSharedPointer>
 #include <QVariant>
@@ -85,6 +88,8 @@ class AccountList : public QAbstractListModel {
     void requestRefresh(QString accountId);
     // queuing a refresh will let it go to the back of the queue (unless it's somewhere inside the queue already)
     void queueRefresh(QString accountId);
+    // the account is likely to be used for a launch soon, refresh it now if the launch would have to wait for that
+    void prewarm(MinecraftAccountPtr account);
 
     /*!
      * Sets the path to load/save the list file from/to.
@@ -136,6 +141,8 @@ class AccountList : public QAbstractListModel {
 
    private slots:
     void tryNext();
+    // fill the queue again when the first account is due, or in an hour
+    void scheduleFill();
 
     void authSucceeded();
     void authFailed(QString reason);
@@ -145,6 +152,8 @@ class AccountList : public QAbstractListModel {
     QTimer* m_refreshTimer;
     QTimer* m_nextTimer;
     shared_qobject_ptr<AccountTask> m_currentTask;
+    // when accounts were last prewarmed, by internal ID, so failing ones aren't tried on every click
+    QHash<QString, QDateTime> m_prewarmed;
 
     /*!
      * Called whenever the list changes.
@@ -158,6 +167,9 @@ class AccountList : public QAbstractListModel {
      */
     void onDefaultAccountChanged();
 
+    /// save the list once the changes stop coming, if autosave is on
+    void scheduleSave();
+
     QList<MinecraftAccountPtr> m_accounts;
 
     MinecraftAccountPtr m_defaultAccount;
@@ -165,6 +177,13 @@ class AccountList : public QAbstractListModel {
     //! Path to the account list file. Empty string if there isn't one.
     QString m_listFilePath;
 
+    // changes are saved together, a bit after they stop coming
+    QTimer* m_saveTimer;
+    // what each account was saved as, by internal ID, so only the accounts that changed are serialized again
+    QHash<QString, QJsonObject> m_savedAccounts;
+    // what's in the file, a refresh that changed nothing doesn't write it again
+    QByteArray m_savedList;
+
     /*!
      * If true, the account list will automatically save to the account list path when it changes.
      * Ignored if m_listFilePath is blank.
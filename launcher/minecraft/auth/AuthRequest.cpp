@@ -151,6 +151,12 @@ void AuthRequest::setup(const QNetworkRequest& req, QNetworkAccessManager::Opera
     if (!verb.isEmpty()) {
         request_.setRawHeader(Katabasis::HTTP_HTTP_HEADER, verb);
     }
+    // steps running at the same time share one connection to the hosts that support it
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    request_.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#else
+    request_.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
 
     status_ = Requesting;
     error_ = QNetworkReply::NoError;
@@ -37,8 +37,8 @@
 
 #include "MinecraftAccount.h"
 
-#include <QColor>
 #include <QCryptographicHash>
+#include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -48,8 +48,7 @@
 
 #include <QDebug>
 
-#include <QPainter>
-
+#include "SkinUtils.h"
 #include "flows/MSA.h"
 #include "flows/Offline.h"
 #include "minecraft/auth/AccountData.h"
@@ -104,20 +103,12 @@ AccountState MinecraftAccount::accountState() const
 
 QPixmap MinecraftAccount::getFace() const
 {
-    QPixmap skinTexture;
-    if (!skinTexture.loadFromData(data.minecraftProfile.skin.data, "PNG")) {
-        return QPixmap();
+    auto& skin = data.minecraftProfile.skin.data;
+    if (m_face.isNull() || m_face_skin != skin) {
+        m_face = SkinUtils::renderFace(skin);
+        m_face_skin = skin;
     }
-    QPixmap skin = QPixmap(8, 8);
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    skin.fill(QColorConstants::Transparent);
-#else
-    skin.fill(QColor(0, 0, 0, 0));
-#endif
-    QPainter painter(&skin);
-    painter.drawPixmap(0, 0, skinTexture.copy(8, 8, 8, 8));
-    painter.drawPixmap(0, 0, skinTexture.copy(40, 8, 8, 8));
-    return skin.scaled(64, 64, Qt::KeepAspectRatio);
+    return m_face;
 }
 
 shared_qobject_ptr<AccountTask> MinecraftAccount::loginMSA()
@@ -173,6 +164,33 @@ void MinecraftAccount::authSucceeded()
     m_currentTask.reset();
     emit changed();
     emit activityChanged(false);
+    fetchSkin();
+}
+
+void MinecraftAccount::fetchSkin()
+{
+    auto url = data.minecraftProfile.skin.url;
+    if (url.isEmpty() || m_skinJob)
+        return;
+    // logging in already read what's cached, a skin at its texture hash can't have changed since
+    if (SkinUtils::isCachedForGood(url) && !data.minecraftProfile.skin.data.isEmpty())
+        return;
+
+    m_skinJob = SkinUtils::makeFetchJob(url);
+    connect(m_skinJob.get(), &Task::finished, this, [this, url] {
+        m_skinJob.reset();
+        if (data.minecraftProfile.skin.url != url)
+            return;
+        QFile file(SkinUtils::cachePath(url));
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        auto skin = file.readAll();
+        if (skin.isEmpty() || skin == data.minecraftProfile.skin.data)
+            return;
+        data.minecraftProfile.skin.data = skin;
+        emit changed();
+    });
+    m_skinJob->start();
 }
 
 void MinecraftAccount::authFailed(QString reason)
@@ -228,28 +246,30 @@ bool MinecraftAccount::shouldRefresh() const
     if (isInUse()) {
         return false;
     }
+    auto due = refreshDue();
+    return due.isValid() && due <= QDateTime::currentDateTimeUtc();
+}
+
+QDateTime MinecraftAccount::refreshDue() const
+{
     switch (data.validity_) {
         case Katabasis::Validity::Certain: {
             break;
         }
         case Katabasis::Validity::None: {
-            return false;
+            return {};
         }
         case Katabasis::Validity::Assumed: {
-            return true;
+            return QDateTime::currentDateTimeUtc();
         }
     }
-    auto now = QDateTime::currentDateTimeUtc();
     auto issuedTimestamp = data.yggdrasilToken.issueInstant;
     auto expiresTimestamp = data.yggdrasilToken.notAfter;
 
     if (!expiresTimestamp.isValid()) {
         expiresTimestamp = issuedTimestamp.addSecs(24 * 3600);
     }
-    if (now.secsTo(expiresTimestamp) < (12 * 3600)) {
-        return true;
-    }
-    return false;
+    return expiresTimestamp.addSecs(-12 * 3600);
 }
 
 void MinecraftAccount::fillSession(AuthSessionPtr session)
@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QJsonObject>
 #include <QList>
 #include <QMap>
@@ -52,6 +53,7 @@
 
 class Task;
 class AccountTask;
+class NetJob;
 class MinecraftAccount;
 
 using MinecraftAccountPtr = shared_qobject_ptr<MinecraftAccount>;
@@ -147,6 +149,8 @@ class MinecraftAccount : public QObject, public Usable {
     AccountData* accountData() { return &data; }
 
     bool shouldRefresh() const;
+    //! When the account should be refreshed next, invalid if it can't be
+    QDateTime refreshDue() const;
 
     void fillSession(AuthSessionPtr session);
 
@@ -168,6 +172,13 @@ class MinecraftAccount : public QObject, public Usable {
     // current task we are executing here
     shared_qobject_ptr<AccountTask> m_currentTask;
 
+    // the skin being brought up to date after a login
+    shared_qobject_ptr<NetJob> m_skinJob;
+
+    // the face rendered from the skin it was rendered from, lists ask for it on every repaint
+    mutable QPixmap m_face;
+    mutable QByteArray m_face_skin;
+
    protected: /* methods */
     void incrementUses() override;
     void decrementUses() override;
@@ -175,4 +186,7 @@ class MinecraftAccount : public QObject, public Usable {
    private slots:
     void authSucceeded();
     void authFailed(QString reason);
+
+   private:
+    void fetchSkin();
 };
@@ -2,12 +2,15 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QSslConfiguration>
 
 #include "AuthFlow.h"
 #include "katabasis/Globals.h"
 
 #include <Application.h>
 
+#include <algorithm>
+
 AuthFlow::AuthFlow(AccountData* data, QObject* parent) : AccountTask(data, parent) {}
 
 void AuthFlow::succeed()
@@ -18,37 +21,66 @@ void AuthFlow::succeed()
 
 void AuthFlow::executeTask()
 {
-    if (m_currentStep) {
+    if (!m_running.isEmpty()) {
         return;
     }
     changeState(AccountTaskState::STATE_WORKING, tr("Initializing"));
-    nextStep();
+    auto ssl = QSslConfiguration::defaultConfiguration();
+    ssl.setAllowedNextProtocols({ QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1 });
+    for (auto& host : m_hosts) {
+        APPLICATION->network()->connectToHostEncrypted(host, 443, ssl);
+    }
+    startReady();
+}
+
+AuthStep::Ptr AuthFlow::addStep(AuthStep::Ptr step, const QList<AuthStep::Ptr>& needs)
+{
+    PendingStep pending{ step, {} };
+    for (auto& need : needs)
+        pending.needs.append(need.get());
+    m_pending.append(pending);
+    return step;
 }
 
-void AuthFlow::nextStep()
+void AuthFlow::startReady()
 {
-    if (m_steps.size() == 0) {
+    if (m_pending.isEmpty() && m_running.isEmpty()) {
         // we got to the end without an incident... assume this is all.
-        m_currentStep.reset();
         succeed();
         return;
     }
-    m_currentStep = m_steps.front();
-    qDebug() << "AuthFlow:" << m_currentStep->describe();
-    m_steps.pop_front();
-    connect(m_currentStep.get(), &AuthStep::finished, this, &AuthFlow::stepFinished);
-    connect(m_currentStep.get(), &AuthStep::showVerificationUriAndCode, this, &AuthFlow::showVerificationUriAndCode);
-    connect(m_currentStep.get(), &AuthStep::hideVerificationUriAndCode, this, &AuthFlow::hideVerificationUriAndCode);
 
-    m_currentStep->perform();
+    QList<AuthStep::Ptr> ready;
+    for (auto iter = m_pending.begin(); iter != m_pending.end();) {
+        auto& needs = iter->needs;
+        if (std::all_of(needs.begin(), needs.end(), [this](AuthStep* need) { return m_done.contains(need); })) {
+            ready.append(iter->step);
+            m_running.append(iter->step);
+            iter = m_pending.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+
+    for (auto& step : ready) {
+        // a step can finish right away, and take the whole flow with it
+        if (isFinished())
+            return;
+        qDebug() << "AuthFlow:" << step->describe();
+        connect(step.get(), &AuthStep::finished, this,
+                [this, raw = step.get()](AccountTaskState resultingState, QString message) { stepFinished(raw, resultingState, message); });
+        connect(step.get(), &AuthStep::showVerificationUriAndCode, this, &AuthFlow::showVerificationUriAndCode);
+        connect(step.get(), &AuthStep::hideVerificationUriAndCode, this, &AuthFlow::hideVerificationUriAndCode);
+        step->perform();
+    }
 }
 
 QString AuthFlow::getStateMessage() const
 {
     switch (m_taskState) {
         case AccountTaskState::STATE_WORKING: {
-            if (m_currentStep) {
-                return m_currentStep->describe();
+            if (!m_running.isEmpty()) {
+                return m_running.last()->describe();
             } else {
                 return tr("Working...");
             }
@@ -59,9 +91,34 @@ QString AuthFlow::getStateMessage() const
     }
 }
 
-void AuthFlow::stepFinished(AccountTaskState resultingState, QString message)
+void AuthFlow::stepFinished(AuthStep* step, AccountTaskState resultingState, QString message)
 {
-    if (changeState(resultingState, message)) {
-        nextStep();
+    auto isStep = [step](const AuthStep::Ptr& running) { return running.get() == step; };
+    m_running.erase(std::remove_if(m_running.begin(), m_running.end(), isStep), m_running.end());
+    m_done.insert(step);
+    // another step already ended the flow
+    if (isFinished())
+        return;
+
+    if (resultingState == AccountTaskState::STATE_SUCCEEDED) {
+        // the step found that what comes after it isn't needed, like the skin of an account without a profile
+        QSet<AuthStep*> skipped{ step };
+        for (auto iter = m_pending.begin(); iter != m_pending.end();) {
+            auto& needs = iter->needs;
+            if (std::any_of(needs.begin(), needs.end(), [&skipped](AuthStep* need) { return skipped.contains(need); })) {
+                skipped.insert(iter->step.get());
+                iter = m_pending.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+        if (m_pending.isEmpty() && m_running.isEmpty()) {
+            m_data->validity_ = Katabasis::Validity::Certain;
+            changeState(resultingState, message);
+            return;
+        }
+    } else if (!changeState(resultingState, message)) {
+        return;
     }
+    startReady();
 }
@@ -5,6 +5,7 @@
 #include <QNetworkReply>
 #include <QObject>
 #include <QSet>
+#include <QStringList>
 #include <QVector>
 
 #include <katabasis/DeviceFlow.h>
@@ -28,14 +29,28 @@ class AuthFlow : public AccountTask {
    signals:
     void activityChanged(Katabasis::Activity activity);
 
-   private slots:
-    void stepFinished(AccountTaskState resultingState, QString message);
-
    protected:
+    /// run `step` once all of `needs` are done, steps that need the same ones run at the same time
+    AuthStep::Ptr addStep(AuthStep::Ptr step, const QList<AuthStep::Ptr>& needs = {});
+
     void succeed();
-    void nextStep();
 
    protected:
-    QList<AuthStep::Ptr> m_steps;
-    AuthStep::Ptr m_currentStep;
+    // where the steps connect to, the connections are opened when the flow starts so later steps don't wait for them
+    QStringList m_hosts;
+
+   private:
+    // start every step that has what it needs
+    void startReady();
+    void stepFinished(AuthStep* step, AccountTaskState resultingState, QString message);
+
+   private:
+    struct PendingStep {
+        AuthStep::Ptr step;
+        QList<AuthStep*> needs;
+    };
+    // in the order they were added
+    QList<PendingStep> m_pending;
+    QList<AuthStep::Ptr> m_running;
+    QSet<AuthStep*> m_done;
 };
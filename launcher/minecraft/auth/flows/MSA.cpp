@@ -9,28 +9,37 @@
 #include "minecraft/auth/steps/XboxProfileStep.h"
 #include "minecraft/auth/steps/XboxUserStep.h"
 
+// what the steps after the Microsoft login talk to
+static const QStringList hosts{ "user.auth.xboxlive.com", "xsts.auth.xboxlive.com", "api.minecraftservices.com",
+                                "profile.xboxlive.com" };
+
+// the steps only wait for the ones whose tokens they use, both authorizations only need the Xbox user token
 MSASilent::MSASilent(AccountData* data, QObject* parent) : AuthFlow(data, parent)
 {
-    m_steps.append(makeShared<MSAStep>(m_data, MSAStep::Action::Refresh));
-    m_steps.append(makeShared<XboxUserStep>(m_data));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"));
-    m_steps.append(makeShared<LauncherLoginStep>(m_data));
-    m_steps.append(makeShared<XboxProfileStep>(m_data));
-    m_steps.append(makeShared<EntitlementsStep>(m_data));
-    m_steps.append(makeShared<MinecraftProfileStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    m_hosts = hosts;
+    auto msa = addStep(makeShared<MSAStep>(m_data, MSAStep::Action::Refresh));
+    auto user = addStep(makeShared<XboxUserStep>(m_data), { msa });
+    auto xbox = addStep(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"), { user });
+    auto mojang = addStep(
+        makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"), { user });
+    auto login = addStep(makeShared<LauncherLoginStep>(m_data), { mojang });
+    addStep(makeShared<XboxProfileStep>(m_data), { xbox });
+    addStep(makeShared<EntitlementsStep>(m_data), { login });
+    auto profile = addStep(makeShared<MinecraftProfileStep>(m_data), { login });
+    addStep(makeShared<GetSkinStep>(m_data), { profile });
 }
 
 MSAInteractive::MSAInteractive(AccountData* data, QObject* parent) : AuthFlow(data, parent)
 {
-    m_steps.append(makeShared<MSAStep>(m_data, MSAStep::Action::Login));
-    m_steps.append(makeShared<XboxUserStep>(m_data));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"));
-    m_steps.append(makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"));
-    m_steps.append(makeShared<LauncherLoginStep>(m_data));
-    m_steps.append(makeShared<XboxProfileStep>(m_data));
-    m_steps.append(makeShared<EntitlementsStep>(m_data));
-    m_steps.append(makeShared<MinecraftProfileStep>(m_data));
-    m_steps.append(makeShared<GetSkinStep>(m_data));
+    m_hosts = hosts;
+    auto msa = addStep(makeShared<MSAStep>(m_data, MSAStep::Action::Login));
+    auto user = addStep(makeShared<XboxUserStep>(m_data), { msa });
+    auto xbox = addStep(makeShared<XboxAuthorizationStep>(m_data, &m_data->xboxApiToken, "http://xboxlive.com", "Xbox"), { user });
+    auto mojang = addStep(
+        makeShared<XboxAuthorizationStep>(m_data, &m_data->mojangservicesToken, "rp://api.minecraftservices.com/", "Mojang"), { user });
+    auto login = addStep(makeShared<LauncherLoginStep>(m_data), { mojang });
+    addStep(makeShared<XboxProfileStep>(m_data), { xbox });
+    addStep(makeShared<EntitlementsStep>(m_data), { login });
+    auto profile = addStep(makeShared<MinecraftProfileStep>(m_data), { login });
+    addStep(makeShared<GetSkinStep>(m_data), { profile });
 }
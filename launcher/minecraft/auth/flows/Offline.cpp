@@ -4,10 +4,10 @@
 
 OfflineRefresh::OfflineRefresh(AccountData* data, QObject* parent) : AuthFlow(data, parent)
 {
-    m_steps.append(makeShared<OfflineStep>(m_data));
+    addStep(makeShared<OfflineStep>(m_data));
 }
 
 OfflineLogin::OfflineLogin(AccountData* data, QObject* parent) : AuthFlow(data, parent)
 {
-    m_steps.append(makeShared<OfflineStep>(m_data));
+    addStep(makeShared<OfflineStep>(m_data));
 }
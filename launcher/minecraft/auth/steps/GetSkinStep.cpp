@@ -1,10 +1,9 @@
 
 #include "GetSkinStep.h"
 
-#include <QNetworkRequest>
+#include <QFile>
 
-#include "minecraft/auth/AuthRequest.h"
-#include "minecraft/auth/Parsers.h"
+#include "SkinUtils.h"
 
 GetSkinStep::GetSkinStep(AccountData* data) : AuthStep(data) {}
 
@@ -17,25 +16,17 @@ QString GetSkinStep::describe()
 
 void GetSkinStep::perform()
 {
-    auto url = QUrl(m_data->minecraftProfile.skin.url);
-    QNetworkRequest request = QNetworkRequest(url);
-    AuthRequest* requestor = new AuthRequest(this);
-    connect(requestor, &AuthRequest::finished, this, &GetSkinStep::onRequestDone);
-    requestor->get(request);
+    // the download doesn't hold up the login, the account brings the cached skin up to date once it's done
+    auto url = m_data->minecraftProfile.skin.url;
+    if (!url.isEmpty()) {
+        QFile file(SkinUtils::cachePath(url));
+        if (file.open(QIODevice::ReadOnly))
+            m_data->minecraftProfile.skin.data = file.readAll();
+    }
+    emit finished(AccountTaskState::STATE_SUCCEEDED, tr("Got skin"));
 }
 
 void GetSkinStep::rehydrate()
 {
     // NOOP, for now.
 }
-
-void GetSkinStep::onRequestDone(QNetworkReply::NetworkError error, QByteArray data, QList<QNetworkReply::RawHeaderPair> headers)
-{
-    auto requestor = qobject_cast<AuthRequest*>(QObject::sender());
-    requestor->deleteLater();
-
-    if (error == QNetworkReply::NoError) {
-        m_data->minecraftProfile.skin.data = data;
-    }
-    emit finished(AccountTaskState::STATE_SUCCEEDED, tr("Got skin"));
-}
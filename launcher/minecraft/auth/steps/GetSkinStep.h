@@ -15,7 +15,4 @@ class GetSkinStep : public AuthStep {
     void rehydrate() override;
 
     QString describe() override;
-
-   private slots:
-    void onRequestDone(QNetworkReply::NetworkError, QByteArray, QList<QNetworkReply::RawHeaderPair>);
 };
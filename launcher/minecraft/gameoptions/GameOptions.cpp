@@ -1,64 +1,57 @@
 #include "GameOptions.h"
 #include <QDebug>
+#include <QFileInfo>
+#include <QFutureWatcher>
 #include <QSaveFile>
 #include "FileSystem.h"
+#include "tasks/Executor.h"
 
-namespace {
-bool load(const QString& path, std::vector<GameOptionItem>& contents, int& version)
+#include <algorithm>
+
+GameOptions::GameOptions(const QString& path) : path(path) {}
+
+GameOptions::Parsed GameOptions::parse(const QString& path)
 {
-    contents.clear();
+    Parsed parsed;
     QFile file(path);
     if (!file.open(QFile::ReadOnly)) {
         qWarning() << "Failed to read options file.";
-        return false;
+        return parsed;
     }
-    version = 0;
-    while (!file.atEnd()) {
-        auto line = file.readLine();
-        if (line.endsWith('\n')) {
-            line.chop(1);
-        }
-        auto separatorIndex = line.indexOf(':');
+    QFileInfo info(path);
+    parsed.modified = info.lastModified();
+    parsed.size = info.size();
+
+    auto data = file.readAll();
+    parsed.trailingNewline = data.isEmpty() || data.endsWith('\n');
+    if (!data.isEmpty())
+        parsed.lines = data.split('\n');
+    if (!data.isEmpty() && parsed.trailingNewline)
+        parsed.lines.removeLast();
+
+    qint64 offset = 0;
+    for (int i = 0; i < parsed.lines.size(); i++) {
+        parsed.offsets.append(offset);
+        auto& line = parsed.lines[i];
+        offset += line.size() + 1;
+        auto content = line;
+        if (content.endsWith('\r'))
+            content.chop(1);
+        auto separatorIndex = content.indexOf(':');
         if (separatorIndex == -1) {
             continue;
         }
-        auto key = QString::fromUtf8(line.data(), separatorIndex);
-        auto value = QString::fromUtf8(line.data() + separatorIndex + 1, line.size() - 1 - separatorIndex);
-        qDebug() << "!!" << key << "!!";
+        auto key = QString::fromUtf8(content.data(), separatorIndex);
+        auto value = QString::fromUtf8(content.data() + separatorIndex + 1, content.size() - 1 - separatorIndex);
         if (key == "version") {
-            version = value.toInt();
+            parsed.version = value.toInt();
             continue;
         }
-        contents.emplace_back(GameOptionItem{ key, value });
-    }
-    qDebug() << "Loaded" << path << "with version:" << version;
-    return true;
-}
-bool save(const QString& path, std::vector<GameOptionItem>& mapping, int version)
-{
-    QSaveFile out(path);
-    if (!out.open(QIODevice::WriteOnly)) {
-        return false;
+        parsed.contents.emplace_back(GameOptionItem{ key, value, i });
     }
-    if (version != 0) {
-        QString versionLine = QString("version:%1\n").arg(version);
-        out.write(versionLine.toUtf8());
-    }
-    auto iter = mapping.begin();
-    while (iter != mapping.end()) {
-        out.write(iter->key.toUtf8());
-        out.write(":");
-        out.write(iter->value.toUtf8());
-        out.write("\n");
-        iter++;
-    }
-    return out.commit();
-}
-}  // namespace
-
-GameOptions::GameOptions(const QString& path) : path(path)
-{
-    reload();
+    qDebug() << "Loaded" << path << "with version:" << parsed.version;
+    parsed.ok = true;
+    return parsed;
 }
 
 QVariant GameOptions::headerData(int section, Qt::Orientation orientation, int role) const
@@ -99,6 +92,30 @@ QVariant GameOptions::data(const QModelIndex& index, int role) const
     }
 }
 
+bool GameOptions::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || index.column() != 1 || role != Qt::EditRole)
+        return false;
+    int row = index.row();
+    if (row < 0 || row >= int(contents.size()))
+        return false;
+    auto newValue = value.toString();
+    if (contents[row].value == newValue)
+        return true;
+    contents[row].value = newValue;
+    dirty.insert(row);
+    emit dataChanged(index, index);
+    return true;
+}
+
+Qt::ItemFlags GameOptions::flags(const QModelIndex& index) const
+{
+    auto flags = QAbstractListModel::flags(index);
+    if (index.isValid() && index.column() == 1)
+        flags |= Qt::ItemIsEditable;
+    return flags;
+}
+
 int GameOptions::rowCount(const QModelIndex&) const
 {
     return static_cast<int>(contents.size());
@@ -114,15 +131,129 @@ bool GameOptions::isLoaded() const
     return loaded;
 }
 
-bool GameOptions::reload()
+bool GameOptions::isUpToDate() const
+{
+    QFileInfo info(path);
+    return loaded && info.exists() && info.lastModified() == modified && info.size() == size;
+}
+
+void GameOptions::apply(Parsed parsed)
 {
     beginResetModel();
-    loaded = load(path, contents, version);
+    contents = std::move(parsed.contents);
+    lines = std::move(parsed.lines);
+    offsets = std::move(parsed.offsets);
+    trailingNewline = parsed.trailingNewline;
+    version = parsed.version;
+    modified = parsed.modified;
+    size = parsed.size;
+    dirty.clear();
+    loaded = parsed.ok;
     endResetModel();
+    emit reloaded(loaded);
+}
+
+bool GameOptions::reload()
+{
+    if (isUpToDate() && dirty.empty())
+        return true;
+    apply(parse(path));
     return loaded;
 }
 
+void GameOptions::reloadAsync()
+{
+    if (isUpToDate() && dirty.empty()) {
+        emit reloaded(true);
+        return;
+    }
+    if (reloading)
+        return;
+    reloading = true;
+    auto watcher = new QFutureWatcher<Parsed>(this);
+    connect(watcher, &QFutureWatcher<Parsed>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        reloading = false;
+        apply(watcher->result());
+    });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Interactive, [path = path] { return parse(path); }));
+}
+
 bool GameOptions::save()
 {
-    return ::save(path, contents, version);
+    if (dirty.empty())
+        return true;
+    if (!loaded)
+        return false;
+
+    if (!isUpToDate()) {
+        // the game wrote it meanwhile, the edits go on top of what it wrote
+        std::vector<GameOptionItem> edits;
+        for (auto row : dirty)
+            edits.push_back(contents[row]);
+        auto fresh = parse(path);
+        if (!fresh.ok)
+            return false;
+        apply(std::move(fresh));
+        for (auto& edit : edits) {
+            auto it = std::find_if(contents.begin(), contents.end(), [&edit](const GameOptionItem& item) { return item.key == edit.key; });
+            if (it == contents.end()) {
+                beginInsertRows(QModelIndex(), int(contents.size()), int(contents.size()));
+                contents.push_back(GameOptionItem{ edit.key, edit.value, -1 });
+                endInsertRows();
+                it = contents.end() - 1;
+            }
+            it->value = edit.value;
+            dirty.insert(int(it - contents.begin()));
+        }
+    }
+
+    // only the edited lines change, an edit that keeps the length of its line can be written over it
+    bool inPlace = true;
+    QList<int> patched;
+    for (auto row : dirty) {
+        auto& item = contents[row];
+        auto line = item.key.toUtf8() + ':' + item.value.toUtf8();
+        if (item.line >= 0) {
+            if (lines[item.line].endsWith('\r'))
+                line += '\r';
+            inPlace = inPlace && line.size() == lines[item.line].size();
+            lines[item.line] = line;
+        } else {
+            inPlace = false;
+            item.line = lines.size();
+            lines.append(line);
+        }
+        patched.append(item.line);
+    }
+
+    bool written = false;
+    if (inPlace) {
+        QFile file(path);
+        written = file.open(QIODevice::ReadWrite);
+        for (auto line : patched)
+            written = written && file.seek(offsets[line]) && file.write(lines[line]) == lines[line].size();
+    }
+    if (!written) {
+        QSaveFile out(path);
+        if (!out.open(QIODevice::WriteOnly))
+            return false;
+        out.write(lines.join('\n'));
+        if (trailingNewline && !lines.isEmpty())
+            out.write("\n");
+        if (!out.commit())
+            return false;
+        offsets.clear();
+        qint64 offset = 0;
+        for (auto& line : lines) {
+            offsets.append(offset);
+            offset += line.size() + 1;
+        }
+    }
+
+    QFileInfo info(path);
+    modified = info.lastModified();
+    size = info.size();
+    dirty.clear();
+    return true;
 }
@@ -1,32 +1,80 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QByteArrayList>
+#include <QDateTime>
 #include <QString>
 #include <map>
+#include <set>
 
 struct GameOptionItem {
     QString key;
     QString value;
+    // where in the file it is
+    int line = -1;
 };
 
+/**
+ * The options.txt of an instance, as it was when it was last read.
+ *
+ * Modded games put thousands of keybinds in there, so it's only parsed again when the file changed since, and the
+ * lines of the options that were edited are all that's written back.
+ */
 class GameOptions : public QAbstractListModel {
     Q_OBJECT
    public:
+    /// what's read out of an options file, parsing doesn't touch the model so it can be done on another thread
+    struct Parsed {
+        bool ok = false;
+        std::vector<GameOptionItem> contents;
+        /// the lines as they are in the file, without the newline
+        QByteArrayList lines;
+        QList<qint64> offsets;
+        bool trailingNewline = true;
+        int version = 0;
+        QDateTime modified;
+        qint64 size = -1;
+    };
+
     explicit GameOptions(const QString& path);
     virtual ~GameOptions() = default;
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent) const override;
     QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
     bool isLoaded() const;
+    /// whether what's loaded is what's in the file now
+    bool isUpToDate() const;
+    /// parse the file again if it changed since it was last read, dropping the edits that weren't saved
     bool reload();
+    /// the same, parsing on another thread, reloaded() is emitted once it's done
+    void reloadAsync();
+    /// write back the lines of the options that were edited
     bool save();
 
+    static Parsed parse(const QString& path);
+
+   signals:
+    void reloaded(bool ok);
+
+   private:
+    void apply(Parsed parsed);
+
    private:
     std::vector<GameOptionItem> contents;
     bool loaded = false;
     QString path;
     int version = 0;
+    QByteArrayList lines;
+    QList<qint64> offsets;
+    bool trailingNewline = true;
+    QDateTime modified;
+    qint64 size = -1;
+    // rows edited since the last save
+    std::set<int> dirty;
+    bool reloading = false;
 };
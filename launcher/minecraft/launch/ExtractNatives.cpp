@@ -20,8 +20,16 @@
 #include <quazip/quazip.h>
 #include <quazip/quazipdir.h>
 #include <QDir>
+#include <QDirIterator>
+#include <QHash>
+#include <QTemporaryDir>
+#include <filesystem>
+#include <mutex>
 #include "FileSystem.h"
 #include "MMCZip.h"
+#include "StringUtils.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "tasks/Executor.h"
 
 #ifdef major
 #undef major
@@ -67,6 +75,82 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
     return true;
 }
 
+/// held while extracting under `key`, so launches at the same time extract each jar once and the others find it done
+static std::shared_ptr<std::mutex> extractionLock(const QString& key)
+{
+    static std::mutex guard;
+    static QHash<QString, std::weak_ptr<std::mutex>> locks;
+    std::lock_guard<std::mutex> lock(guard);
+    auto mutex = locks.value(key).lock();
+    if (!mutex) {
+        for (auto it = locks.begin(); it != locks.end();)
+            it = it->expired() ? locks.erase(it) : std::next(it);
+        mutex = std::make_shared<std::mutex>();
+        locks.insert(key, mutex);
+    }
+    return mutex;
+}
+
+/**
+ * Where the natives of a jar end up extracted, shared between launches and instances.
+ * Keyed by the jar's contents, so a changed jar gets extracted again. Returns an empty string if that didn't work out.
+ */
+static QString cachedNatives(QString source, bool applyJnilibHack)
+{
+    // the hash cache knows it unless the jar changed, then it's read once
+    auto key = Hashing::cachedHash(source, "sha1").toLower();
+    if (key.isEmpty()) {
+        return {};
+    }
+    if (applyJnilibHack) {
+        key += "-jnilib";
+    }
+    QDir cacheRoot("cache/natives");
+    auto cacheDir = cacheRoot.absoluteFilePath(key);
+    auto mutex = extractionLock(key);
+    std::lock_guard<std::mutex> extracting(*mutex);
+    if (QFileInfo(cacheDir).isDir()) {
+        return cacheDir;
+    }
+
+    // extract right next to it and move it in place at once, so a launch at the same time never sees it half done
+    if (!cacheRoot.mkpath(".")) {
+        return {};
+    }
+    QTemporaryDir staging(cacheDir + "-XXXXXX");
+    if (!staging.isValid() || !unzipNatives(source, staging.path(), applyJnilibHack)) {
+        return {};
+    }
+    if (QDir().rename(staging.path(), cacheDir)) {
+        staging.setAutoRemove(false);
+    } else if (!QFileInfo(cacheDir).isDir()) {
+        return {};
+    }
+    // else another launcher got there first
+    return cacheDir;
+}
+
+static bool linkNatives(QString cacheDir, QString targetFolder)
+{
+    QDir cache(cacheDir);
+    QDirIterator it(cacheDir, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        auto file = it.next();
+        auto target = FS::PathCombine(targetFolder, cache.relativeFilePath(file));
+        if (!FS::ensureFilePathExists(target)) {
+            return false;
+        }
+        // what comes later wins, like it does when extracting
+        QFile::remove(target);
+        std::error_code err;
+        std::filesystem::create_hard_link(StringUtils::toStdString(file), StringUtils::toStdString(target), err);
+        if (err && !QFile::copy(file, target)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
@@ -81,14 +165,29 @@ void ExtractNatives::executeTask()
     auto outputPath = minecraftInstance->getNativePath();
     auto javaVersion = minecraftInstance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
-    for (const auto& source : toExtract) {
-        if (!unzipNatives(source, outputPath, jniHackEnabled)) {
-            const char* reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
-            emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
-            emitFailed(tr(reason).arg(source, outputPath));
+
+    connect(&m_extraction, &QFutureWatcher<QString>::finished, this, [this, outputPath] {
+        auto source = m_extraction.result();
+        if (source.isEmpty()) {
+            emitSucceeded();
+            return;
         }
-    }
-    emitSucceeded();
+        const char* reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
+        emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
+        emitFailed(tr(reason).arg(source, outputPath));
+    });
+    m_extraction.setFuture(Executor::instance()->run(Executor::Priority::Interactive, [toExtract, outputPath, jniHackEnabled] {
+        for (const auto& source : toExtract) {
+            auto cacheDir = cachedNatives(source, jniHackEnabled);
+            if (!cacheDir.isEmpty() && linkNatives(cacheDir, outputPath)) {
+                continue;
+            }
+            if (!unzipNatives(source, outputPath, jniHackEnabled)) {
+                return source;
+            }
+        }
+        return QString();
+    }));
 }
 
 void ExtractNatives::finalize()
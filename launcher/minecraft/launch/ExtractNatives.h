@@ -16,6 +16,7 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QFutureWatcher>
 #include <memory>
 #include "minecraft/auth/AuthSession.h"
 
@@ -29,4 +30,8 @@ class ExtractNatives : public LaunchStep {
     void executeTask() override;
     bool canAbort() const override { return false; }
     void finalize() override;
+
+   private:
+    // done on the thread pool, the jar that couldn't be extracted when it fails
+    QFutureWatcher<QString> m_extraction;
 };
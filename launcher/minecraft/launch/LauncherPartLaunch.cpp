@@ -41,6 +41,7 @@
 #include "Application.h"
 #include "Commandline.h"
 #include "FileSystem.h"
+#include "launch/LaunchCoordinator.h"
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
 
@@ -94,6 +95,25 @@ bool fitsInLocal8bit(const QString& string)
 
 void LauncherPartLaunch::executeTask()
 {
+    // games started at the same moment all read their jars, mods and worlds at once, they're started a bit apart
+    auto coordinator = LaunchCoordinator::shared();
+    auto delay = coordinator ? coordinator->startDelay() : 0;
+    if (delay <= 0) {
+        startProcess();
+        return;
+    }
+    emit logLine(tr("Starting in %1 s, after the game launched just before.\n").arg((delay + 999) / 1000), MessageLevel::Launcher);
+    m_startDelay.setSingleShot(true);
+    m_startDelay.setInterval(delay);
+    connect(&m_startDelay, &QTimer::timeout, this, &LauncherPartLaunch::startProcess, Qt::UniqueConnection);
+    m_startDelay.start();
+}
+
+void LauncherPartLaunch::startProcess()
+{
+    // gamemode, MangoHud and the libraries of the system, unless the launch comes right as the launcher starts it's known
+    APPLICATION->awaitSystemProbe();
+
     QString jarPath = APPLICATION->getJarPath("NewLaunch.jar");
     if (jarPath.isEmpty()) {
         const char* reason = QT_TR_NOOP("Launcher library could not be found. Please check your installation.");
@@ -117,6 +137,9 @@ void LauncherPartLaunch::executeTask()
     }
 
     m_launchScript = minecraftInstance->createLaunchScript(m_session, m_serverToJoin);
+    auto metrics = m_parent->metrics();
+    if (metrics && metrics->isListening())
+        m_launchScript += metrics->launchScriptLines();
     QStringList args = minecraftInstance->javaArguments();
     QString allArgs = args.join(", ");
     emit logLine("Java Arguments:\n[" + m_parent->censorPrivateInfo(allArgs) + "]\n\n", MessageLevel::Launcher);
@@ -145,6 +168,15 @@ void LauncherPartLaunch::executeTask()
     args << "-Djava.library.path=" + natPath;
 #endif
 
+    auto classDataSharing = minecraftInstance->classDataSharingArgument(classPath);
+    if (!classDataSharing.isEmpty()) {
+        bool recording = classDataSharing.startsWith("-XX:ArchiveClassesAtExit");
+        emit logLine(recording ? "Recording the class data sharing archive for the next launches.\n\n"
+                               : "Using the class data sharing archive.\n\n",
+                     MessageLevel::Launcher);
+        args << classDataSharing;
+    }
+
     args << "-cp";
 #ifdef Q_OS_WIN
     QStringList processed;
@@ -256,6 +288,11 @@ void LauncherPartLaunch::proceed()
 
 bool LauncherPartLaunch::abort()
 {
+    if (m_startDelay.isActive()) {
+        m_startDelay.stop();
+        emitAborted();
+        return true;
+    }
     if (mayProceed) {
         mayProceed = false;
         QString launchString("abort\n");
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <LoggedProcess.h>
+#include <QTimer>
 #include <launch/LaunchStep.h>
 #include <minecraft/auth/AuthSession.h>
 
@@ -39,6 +40,9 @@ class LauncherPartLaunch : public LaunchStep {
    private slots:
     void on_state(LoggedProcess::State state);
 
+   private:
+    void startProcess();
+
    private:
     LoggedProcess m_process;
     QString m_command;
@@ -47,4 +51,6 @@ class LauncherPartLaunch : public LaunchStep {
     MinecraftServerTargetPtr m_serverToJoin;
 
     bool mayProceed = false;
+    // waiting for the games launched just before to get going
+    QTimer m_startDelay;
 };
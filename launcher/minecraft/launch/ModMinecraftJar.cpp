@@ -34,11 +34,82 @@
  */
 
 #include "ModMinecraftJar.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QTemporaryFile>
+#include <filesystem>
 #include "FileSystem.h"
 #include "MMCZip.h"
+#include "StringUtils.h"
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
+#include "modplatform/helpers/HashUtils.h"
+
+// bump this when the way modded jars are put together changes
+static const QByteArray s_jarFormat = "1";
+
+/**
+ * What the modded jar is made of: the base jar and the enabled jar mods, in order.
+ * Empty if that can't be told from the files alone.
+ */
+static QString moddedJarKey(const QString& sourceJarPath, const QList<Mod*>& jarMods)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(s_jarFormat);
+    auto addFile = [&key](const QString& path) {
+        auto hash = Hashing::cachedHash(path, "sha1");
+        key.addData(hash.toLatin1());
+        return !hash.isEmpty();
+    };
+    if (!addFile(sourceJarPath)) {
+        return {};
+    }
+    for (auto mod : jarMods) {
+        if (!mod->enabled()) {
+            continue;
+        }
+        // folders would have to be hashed file by file, they're rare enough to be built every time
+        if (mod->type() != ResourceType::ZIPFILE && mod->type() != ResourceType::SINGLEFILE) {
+            return {};
+        }
+        // single files go in under their name
+        key.addData(mod->fileinfo().fileName().toUtf8() + '\0');
+        if (!addFile(mod->fileinfo().absoluteFilePath())) {
+            return {};
+        }
+    }
+    return QString::fromLatin1(key.result().toHex());
+}
+
+static bool buildCachedJar(const QString& sourceJarPath, const QString& cachedJarPath, const QList<Mod*>& jarMods)
+{
+    if (!FS::ensureFilePathExists(cachedJarPath)) {
+        return false;
+    }
+    // built under a name of its own and moved in place at once, so a launch at the same time never sees it half done
+    QTemporaryFile staging(cachedJarPath + "-XXXXXX");
+    if (!staging.open()) {
+        return false;
+    }
+    staging.close();
+    if (!MMCZip::createModdedJar(sourceJarPath, staging.fileName(), jarMods)) {
+        return false;
+    }
+    if (QFile::rename(staging.fileName(), cachedJarPath)) {
+        staging.setAutoRemove(false);
+        return true;
+    }
+    // someone else got there first
+    return QFileInfo::exists(cachedJarPath);
+}
+
+static bool placeJar(const QString& cachedJarPath, const QString& finalJarPath)
+{
+    std::error_code err;
+    std::filesystem::create_hard_link(StringUtils::toStdString(cachedJarPath), StringUtils::toStdString(finalJarPath), err);
+    return !err || QFile::copy(cachedJarPath, finalJarPath);
+}
 
 void ModMinecraftJar::executeTask()
 {
@@ -51,11 +122,13 @@ void ModMinecraftJar::executeTask()
     // nuke obsolete stripped jar(s) if needed
     if (!FS::ensureFolderPathExists(m_inst->binRoot())) {
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
     if (!removeJar()) {
         emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
+        return;
     }
 
     // create temporary modded jar, if needed
@@ -67,6 +140,17 @@ void ModMinecraftJar::executeTask()
         QStringList jars, temp1, temp2, temp3, temp4;
         mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
         auto sourceJarPath = jars[0];
+
+        // the same jar mods on the same base jar make the same jar, it only has to be built once
+        if (auto key = moddedJarKey(sourceJarPath, jarMods); !key.isEmpty()) {
+            auto cachedJarPath = QDir("cache/jars").absoluteFilePath(key + ".jar");
+            if ((QFileInfo::exists(cachedJarPath) || buildCachedJar(sourceJarPath, cachedJarPath, jarMods)) &&
+                placeJar(cachedJarPath, finalJarPath)) {
+                emitSucceeded();
+                return;
+            }
+            qWarning() << "Couldn't use the cached modded jar" << cachedJarPath << ", building it in place";
+        }
         if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
             emitFailed(tr("Failed to create the custom Minecraft jar file."));
             return;
@@ -0,0 +1,40 @@
+#include "PrewarmFiles.h"
+
+#include <QDir>
+
+#include "FileSystem.h"
+#include "launch/LaunchTask.h"
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "tasks/Executor.h"
+
+void PrewarmFiles::executeTask()
+{
+    auto instance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    if (!instance) {
+        emitSucceeded();
+        return;
+    }
+
+    QStringList files = instance->getClassPath();
+    for (auto& mod : QDir(instance->modsRoot()).entryInfoList({ "*.jar", "*.zip" }, QDir::Files))
+        files.append(mod.absoluteFilePath());
+    if (auto profile = instance->getPackProfile()->getProfile()) {
+        if (auto assets = profile->getMinecraftAssets())
+            files.append(FS::PathCombine(QDir("assets/indexes").absolutePath(), assets->id + ".json"));
+    }
+
+    // a few jobs at a time, where the files are only hinted about they're done in no time anyway
+    const int jobs = qBound(1, Executor::instance()->maxThreadCount() / 2, 4);
+    for (int job = 0; job < jobs; job++) {
+        QStringList part;
+        for (int i = job; i < files.size(); i += jobs)
+            part.append(files[i]);
+        Executor::instance()->run(Executor::Priority::Background, [part] {
+            for (auto& file : part)
+                FS::readAhead(file);
+        });
+    }
+
+    emitSucceeded();
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <launch/LaunchStep.h>
+
+/**
+ * Gets the files the game reads first into the page cache while the other steps run.
+ *
+ * On spinning disks and network homes the JVM spends its first seconds waiting for hundreds of jars. Here the class
+ * path, the mods and the asset index are read ahead on the executor, and the step is done as soon as that's started:
+ * whatever was cached by the time Java starts no longer has to come from the disk.
+ */
+class PrewarmFiles : public LaunchStep {
+    Q_OBJECT
+   public:
+    explicit PrewarmFiles(LaunchTask* parent) : LaunchStep(parent) {}
+    ~PrewarmFiles() override = default;
+
+    void executeTask() override;
+    bool canAbort() const override { return false; }
+};
@@ -34,34 +34,58 @@
  */
 
 #include "ScanModFolders.h"
+
+#include <QCryptographicHash>
+
 #include "FileSystem.h"
 #include "MMCZip.h"
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/mod/ModFolderModel.h"
 
+namespace {
+// names, sizes and modification times, which is all a scan would notice
+QByteArray folderSnapshot(const QDir& dir)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System, QDir::Name);
+    for (auto const& entry : entries) {
+        hash.addData(entry.fileName().toUtf8());
+        hash.addData(QByteArray::number(entry.size()));
+        hash.addData(QByteArray::number(entry.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result();
+}
+}  // namespace
+
 void ScanModFolders::executeTask()
 {
     auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
 
-    auto loaders = m_inst->loaderModList();
-    connect(loaders.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::modsDone);
-    if (!loaders->update()) {
-        m_modsDone = true;
-    }
+    scan(m_inst->loaderModList().get(), m_modsDone, &ScanModFolders::modsDone);
+    scan(m_inst->coreModList().get(), m_coreModsDone, &ScanModFolders::coreModsDone);
+    scan(m_inst->nilModList().get(), m_nilModsDone, &ScanModFolders::nilModsDone);
+    checkDone();
+}
 
-    auto cores = m_inst->coreModList();
-    connect(cores.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::coreModsDone);
-    if (!cores->update()) {
-        m_coreModsDone = true;
+void ScanModFolders::scan(ModFolderModel* model, bool& done, void (ScanModFolders::*finished)())
+{
+    auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    auto path = model->dir().absolutePath();
+    auto snapshot = folderSnapshot(model->dir());
+    auto last = m_inst->modFolderScan(path);
+    m_snapshots.insert(path, snapshot);
+    if (snapshot == last) {
+        done = true;
+        return;
     }
 
-    auto nils = m_inst->nilModList();
-    connect(nils.get(), &ModFolderModel::updateFinished, this, &ScanModFolders::nilModsDone);
-    if (!nils->update()) {
-        m_nilModsDone = true;
+    connect(model, &ModFolderModel::updateFinished, this, finished);
+    // the list is already loaded from the last scan, so only what changed since needs looking at
+    bool started = last.isEmpty() ? model->update() : model->rescan();
+    if (!started) {
+        done = true;
     }
-    checkDone();
 }
 
 void ScanModFolders::modsDone()
@@ -82,9 +106,27 @@ void ScanModFolders::nilModsDone()
     checkDone();
 }
 
+void ScanModFolders::reportProblems(ModFolderModel* model)
+{
+    // out of what the model already has indexed, the mods still being parsed show up on the mods page later on
+    for (int row = 0; row < model->size(); row++) {
+        auto problems = model->conflicts(row);
+        auto missing = model->missingDependencies(row);
+        if (!missing.isEmpty())
+            problems.append(tr("It needs %1, which isn't there or isn't enabled.").arg(missing.join(", ")));
+        auto name = model->at(row)->fileinfo().fileName();
+        for (auto& problem : problems)
+            emit logLine(QString("%1: %2").arg(name, problem), MessageLevel::Warning);
+    }
+}
+
 void ScanModFolders::checkDone()
 {
     if (m_modsDone && m_coreModsDone && m_nilModsDone) {
+        auto m_inst = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+        for (auto it = m_snapshots.constBegin(); it != m_snapshots.constEnd(); ++it)
+            m_inst->setModFolderScan(it.key(), it.value());
+        reportProblems(m_inst->loaderModList().get());
         emitSucceeded();
     }
 }
@@ -16,8 +16,11 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QHash>
 #include <memory>
 
+class ModFolderModel;
+
 class ScanModFolders : public LaunchStep {
     Q_OBJECT
    public:
@@ -32,10 +35,16 @@ class ScanModFolders : public LaunchStep {
     void nilModsDone();
 
    private:
+    /// scan `model` unless its folder is as the last launch left it, `done` is set once it's been looked at
+    void scan(ModFolderModel* model, bool& done, void (ScanModFolders::*finished)());
     void checkDone();
+    /// log the clashes and missing dependencies of the enabled mods
+    void reportProblems(ModFolderModel* model);
 
    private:  // DATA
     bool m_modsDone = false;
     bool m_nilModsDone = false;
     bool m_coreModsDone = false;
+    // taken before scanning, so changes made meanwhile are seen by the next launch
+    QHash<QString, QByteArray> m_snapshots;
 };
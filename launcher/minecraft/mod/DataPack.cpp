@@ -90,20 +90,11 @@ std::pair<int, bool> DataPack::compare(const Resource& other, SortType type) con
     return { 0, false };
 }
 
-bool DataPack::applyFilter(QRegularExpression filter) const
+auto DataPack::filterFields() const -> QStringList
 {
-    if (filter.match(description()).hasMatch())
-        return true;
-
-    if (filter.match(QString::number(packFormat())).hasMatch())
-        return true;
-
-    if (filter.match(compatibleVersions().first.toString()).hasMatch())
-        return true;
-    if (filter.match(compatibleVersions().second.toString()).hasMatch())
-        return true;
-
-    return Resource::applyFilter(filter);
+    auto versions = compatibleVersions();
+    return QStringList{ description(), QString::number(packFormat()), versions.first.toString(), versions.second.toString() } +
+           Resource::filterFields();
 }
 
 bool DataPack::valid() const
@@ -57,7 +57,7 @@ class DataPack : public Resource {
     bool valid() const override;
 
     [[nodiscard]] auto compare(Resource const& other, SortType type) const -> std::pair<int, bool> override;
-    [[nodiscard]] bool applyFilter(QRegularExpression filter) const override;
+    [[nodiscard]] auto filterFields() const -> QStringList override;
 
    protected:
     mutable QMutex m_data_lock;
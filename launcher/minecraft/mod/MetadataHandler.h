@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "modplatform/packwiz/Packwiz.h"
+#include "modplatform/packwiz/PackwizIndexCache.h"
 
 // launcher/minecraft/mod/Mod.h
 class Mod;
@@ -32,6 +33,8 @@ class Metadata {
    public:
     using ModStruct = Packwiz::V1::Mod;
     using ModSide = Packwiz::V1::Side;
+    // for changing many mods of the same folder at once
+    using Batch = Packwiz::IndexBatch;
 
     static auto create(QDir& index_dir, ModPlatform::IndexedPack& mod_pack, ModPlatform::IndexedVersion& mod_version) -> ModStruct
     {
@@ -52,4 +55,6 @@ class Metadata {
     static auto get(QDir& index_dir, QString mod_slug) -> ModStruct { return Packwiz::V1::getIndexForMod(index_dir, mod_slug); }
 
     static auto get(QDir& index_dir, QVariant& mod_id) -> ModStruct { return Packwiz::V1::getIndexForMod(index_dir, mod_id); }
+
+    static auto getAll(QDir& index_dir) -> QList<ModStruct> { return Packwiz::IndexCache(index_dir).mods(); }
 };
@@ -43,8 +43,10 @@
 
 #include "MTPixmapCache.h"
 #include "MetadataHandler.h"
+#include "StringUtils.h"
 #include "Version.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModIconCache.h"
 #include "minecraft/mod/tasks/LocalModParseTask.h"
 
 static ModPlatform::ProviderCapabilities ProviderCaps;
@@ -69,12 +71,24 @@ void Mod::setMetadata(std::shared_ptr<Metadata::ModStruct>&& metadata)
     if (status() == ModStatus::NoMetadata)
         setStatus(ModStatus::Installed);
 
+    if (metadata) {
+        metadata->mode = StringUtils::intern(metadata->mode);
+        metadata->hash_format = StringUtils::intern(metadata->hash_format);
+    }
     m_local_details.metadata = metadata;
 }
 
 void Mod::setDetails(const ModDetails& details)
 {
     m_local_details = details;
+    m_sort_version.reset();
+}
+
+const Version& Mod::sortVersion() const
+{
+    if (!m_sort_version)
+        m_sort_version = Version(version());
+    return *m_sort_version;
 }
 
 std::pair<int, bool> Mod::compare(const Resource& other, SortType type) const
@@ -94,8 +108,8 @@ std::pair<int, bool> Mod::compare(const Resource& other, SortType type) const
             break;
         }
         case SortType::VERSION: {
-            auto this_ver = Version(version());
-            auto other_ver = Version(cast_other->version());
+            auto const& this_ver = sortVersion();
+            auto const& other_ver = cast_other->sortVersion();
             if (this_ver > other_ver)
                 return { 1, type == SortType::VERSION };
             if (this_ver < other_ver)
@@ -113,18 +127,9 @@ std::pair<int, bool> Mod::compare(const Resource& other, SortType type) const
     return { 0, false };
 }
 
-bool Mod::applyFilter(QRegularExpression filter) const
+auto Mod::filterFields() const -> QStringList
 {
-    if (filter.match(description()).hasMatch())
-        return true;
-
-    for (auto& author : authors()) {
-        if (filter.match(author).hasMatch()) {
-            return true;
-        }
-    }
-
-    return Resource::applyFilter(filter);
+    return QStringList{ description() } + authors() + Resource::filterFields();
 }
 
 auto Mod::destroy(QDir& index_dir, bool preserve_metadata, bool attempt_trash) -> bool
@@ -218,6 +223,8 @@ void Mod::finishResolvingWithDetails(ModDetails&& details)
         details.status = m_local_details.status;
 
     m_local_details = std::move(details);
+    m_local_details.intern();
+    m_sort_version.reset();
     if (metadata)
         setMetadata(std::move(metadata));
     if (!iconPath().isEmpty()) {
@@ -246,41 +253,62 @@ void Mod::setIcon(QImage new_image) const
 {
     QMutexLocker locker(&m_data_lock);
 
-    Q_ASSERT(!new_image.isNull());
+    m_pack_image_cache_key.was_read_attempt = true;
+    if (new_image.isNull()) {
+        // there's nothing to load, don't try again
+        m_pack_image_cache_key.was_ever_used = false;
+        return;
+    }
 
     if (m_pack_image_cache_key.key.isValid())
         PixmapCache::remove(m_pack_image_cache_key.key);
 
     // scale the image to avoid flooding the pixmapcache
-    auto pixmap =
-        QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
+    auto pixmap = QPixmap::fromImage(ModIconCache::thumbnail(new_image));
 
-    m_pack_image_cache_key.key = PixmapCache::insert(pixmap);
-    m_pack_image_cache_key.was_ever_used = true;
-    m_pack_image_cache_key.was_read_attempt = true;
+    m_pack_image_cache_key.key = PixmapCache::insert(PixmapCache::Category::Mods, pixmap);
+    m_pack_image_cache_key.was_ever_used = m_pack_image_cache_key.key.isValid();
+
+    // This can happen if the pixmap is too big to fit in the cache :c
+    if (!m_pack_image_cache_key.was_ever_used)
+        qWarning() << "Could not insert a image cache entry! Ignoring it.";
 }
 
-QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
+QPixmap Mod::loadedIcon(QSize size, Qt::AspectRatioMode mode) const
 {
     QPixmap cached_image;
-    if (PixmapCache::find(m_pack_image_cache_key.key, &cached_image)) {
-        if (size.isNull())
-            return cached_image;
-        return cached_image.scaled(size, mode, Qt::SmoothTransformation);
-    }
-
-    // No valid image we can get
-    if ((!m_pack_image_cache_key.was_ever_used && m_pack_image_cache_key.was_read_attempt) || iconPath().isEmpty())
+    if (!PixmapCache::find(m_pack_image_cache_key.key, &cached_image))
         return {};
+    if (size.isNull())
+        return cached_image;
+    return cached_image.scaled(size, mode, Qt::SmoothTransformation);
+}
+
+bool Mod::shouldLoadIcon() const
+{
+    if (iconPath().isEmpty())
+        return false;
+
+    QPixmap cached_image;
+    if (PixmapCache::find(m_pack_image_cache_key.key, &cached_image))
+        return false;
+
+    // it got evicted from the cache, or an attempt to load it has not been made
+    return m_pack_image_cache_key.was_ever_used || !m_pack_image_cache_key.was_read_attempt;
+}
+
+QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
+{
+    auto cached_image = loadedIcon(size, mode);
+    if (!cached_image.isNull() || !shouldLoadIcon())
+        return cached_image;
 
     if (m_pack_image_cache_key.was_ever_used) {
         qDebug() << "Mod" << name() << "Had it's icon evicted form the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        PixmapCache::markCacheMissByEviciton(PixmapCache::Category::Mods);
     }
-    // Image got evicted from the cache or an attempt to load it has not been made. load it and retry.
-    m_pack_image_cache_key.was_read_attempt = true;
     ModUtils::loadIconFile(*this);
-    return icon(size);
+    return loadedIcon(size, mode);
 }
 
 bool Mod::valid() const
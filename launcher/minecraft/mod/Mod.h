@@ -41,12 +41,13 @@
 #include <QList>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 #include <optional>
 
+#include "MTPixmapCache.h"
 #include "ModDetails.h"
 #include "Resource.h"
+#include "Version.h"
 
 class Mod : public Resource {
     Q_OBJECT
@@ -73,8 +74,12 @@ class Mod : public Resource {
 
     /** Get the intneral path to the mod's icon file*/
     QString iconPath() const { return m_local_details.icon_file; }
-    /** Gets the icon of the mod, converted to a QPixmap for drawing, and scaled to size. */
+    /** Gets the icon of the mod, converted to a QPixmap for drawing, and scaled to size. Reads it from the file if needed. */
     [[nodiscard]] QPixmap icon(QSize size, Qt::AspectRatioMode mode = Qt::AspectRatioMode::IgnoreAspectRatio) const;
+    /** Like icon(), but a null pixmap when the icon isn't loaded yet. */
+    [[nodiscard]] QPixmap loadedIcon(QSize size, Qt::AspectRatioMode mode = Qt::AspectRatioMode::IgnoreAspectRatio) const;
+    /** Whether there's an icon to read from the file, with ModUtils::loadIconThumbnail() and setIcon(). */
+    [[nodiscard]] bool shouldLoadIcon() const;
     /** Thread-safe. */
     void setIcon(QImage new_image) const;
 
@@ -89,7 +94,7 @@ class Mod : public Resource {
     bool valid() const override;
 
     [[nodiscard]] auto compare(Resource const& other, SortType type) const -> std::pair<int, bool> override;
-    [[nodiscard]] bool applyFilter(QRegularExpression filter) const override;
+    [[nodiscard]] auto filterFields() const -> QStringList override;
 
     // Delete all the files of this mod
     auto destroy(QDir& index_dir, bool preserve_metadata = false, bool attempt_trash = true) -> bool;
@@ -98,13 +103,18 @@ class Mod : public Resource {
 
     void finishResolvingWithDetails(ModDetails&& details);
 
+   protected:
+    // the version as sorted by, parsed on the first sort that needs it
+    const Version& sortVersion() const;
+
    protected:
     ModDetails m_local_details;
+    mutable std::optional<Version> m_sort_version;
 
     mutable QMutex m_data_lock;
 
     struct {
-        QPixmapCache::Key key;
+        PixmapCache::Key key;
         bool was_ever_used = false;
         bool was_read_attempt = false;
     } mutable m_pack_image_cache_key;
@@ -41,6 +41,7 @@
 #include <QStringList>
 #include <QUrl>
 
+#include "StringUtils.h"
 #include "minecraft/mod/MetadataHandler.h"
 
 enum class ModStatus {
@@ -118,6 +119,15 @@ struct ModLicense {
     bool isEmpty() { return this->name.isEmpty() && this->id.isEmpty() && this->url.isEmpty() && this->description.isEmpty(); }
 };
 
+/** A mod jar bundled inside another one, the way loaders let mods ship their libraries. */
+struct BundledMod {
+    /* Where it is, inside the outer jar and any jar in between, separated by '!' */
+    QString path = {};
+    QString mod_id = {};
+    QString name = {};
+    QString version = {};
+};
+
 struct ModDetails {
     /* Mod ID as defined in the ModLoader-specific metadata */
     QString mod_id = {};
@@ -149,6 +159,15 @@ struct ModDetails {
     /* Path of mod logo */
     QString icon_file = {};
 
+    /* The mods inside it, nested ones included */
+    QList<BundledMod> bundled = {};
+
+    /* Other IDs it stands in for */
+    QStringList provides = {};
+
+    /* IDs of the mods it can't do without, the loader and the game included */
+    QStringList dependencies = {};
+
     /* Installation status of the mod */
     ModStatus status = ModStatus::Unknown;
 
@@ -169,6 +188,9 @@ struct ModDetails {
         , issue_tracker(other.issue_tracker)
         , licenses(other.licenses)
         , icon_file(other.icon_file)
+        , bundled(other.bundled)
+        , provides(other.provides)
+        , dependencies(other.dependencies)
         , status(other.status)
     {}
 
@@ -184,6 +206,9 @@ struct ModDetails {
         this->issue_tracker = other.issue_tracker;
         this->licenses = other.licenses;
         this->icon_file = other.icon_file;
+        this->bundled = other.bundled;
+        this->provides = other.provides;
+        this->dependencies = other.dependencies;
         this->status = other.status;
 
         return *this;
@@ -201,8 +226,25 @@ struct ModDetails {
         this->issue_tracker = other.issue_tracker;
         this->licenses = other.licenses;
         this->icon_file = other.icon_file;
+        this->bundled = other.bundled;
+        this->provides = other.provides;
+        this->dependencies = other.dependencies;
         this->status = other.status;
 
         return *this;
     }
+
+    /** Share the values many mods have in common with the other details that have them, rather than a copy each. */
+    void intern()
+    {
+        mcversion = StringUtils::intern(mcversion);
+        authors = StringUtils::intern(authors);
+        icon_file = StringUtils::intern(icon_file);
+        for (auto& license : licenses) {
+            license.name = StringUtils::intern(license.name);
+            license.id = StringUtils::intern(license.id);
+            license.url = StringUtils::intern(license.url);
+            license.description = StringUtils::intern(license.description);
+        }
+    }
 };
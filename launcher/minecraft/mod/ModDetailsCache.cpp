@@ -0,0 +1,334 @@
+#include "ModDetailsCache.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Application.h"
+#include "Exception.h"
+#include "Json.h"
+#include "modplatform/helpers/HashCache.h"
+
+// entries that weren't used for this long are dropped on save
+static constexpr qint64 maxUnusedAge = 90 * 24 * 60 * 60;
+
+namespace {
+QJsonObject toJson(const ModDetails& details)
+{
+    QJsonArray licenses;
+    for (const auto& license : details.licenses) {
+        QJsonObject obj;
+        Json::writeString(obj, "name", license.name);
+        Json::writeString(obj, "id", license.id);
+        Json::writeString(obj, "url", license.url);
+        Json::writeString(obj, "description", license.description);
+        licenses.append(obj);
+    }
+
+    QJsonObject obj;
+    Json::writeString(obj, "mod_id", details.mod_id);
+    Json::writeString(obj, "name", details.name);
+    Json::writeString(obj, "version", details.version);
+    Json::writeString(obj, "mcversion", details.mcversion);
+    Json::writeString(obj, "homeurl", details.homeurl);
+    Json::writeString(obj, "description", details.description);
+    Json::writeStringList(obj, "authors", details.authors);
+    Json::writeString(obj, "issue_tracker", details.issue_tracker);
+    obj.insert("licenses", licenses);
+    Json::writeString(obj, "icon_file", details.icon_file);
+    Json::writeStringList(obj, "provides", details.provides);
+    Json::writeStringList(obj, "dependencies", details.dependencies);
+    if (!details.bundled.isEmpty()) {
+        QJsonArray bundled;
+        for (const auto& mod : details.bundled) {
+            QJsonObject bundledObj;
+            Json::writeString(bundledObj, "path", mod.path);
+            Json::writeString(bundledObj, "mod_id", mod.mod_id);
+            Json::writeString(bundledObj, "name", mod.name);
+            Json::writeString(bundledObj, "version", mod.version);
+            bundled.append(bundledObj);
+        }
+        obj.insert("bundled", bundled);
+    }
+    return obj;
+}
+
+ModDetails fromJson(const QJsonObject& obj)
+{
+    ModDetails details;
+    details.mod_id = Json::ensureString(obj, "mod_id");
+    details.name = Json::ensureString(obj, "name");
+    details.version = Json::ensureString(obj, "version");
+    details.mcversion = Json::ensureString(obj, "mcversion");
+    details.homeurl = Json::ensureString(obj, "homeurl");
+    details.description = Json::ensureString(obj, "description");
+    for (auto author : Json::ensureArray(obj, "authors"))
+        details.authors.append(author.toString());
+    details.issue_tracker = Json::ensureString(obj, "issue_tracker");
+    for (auto element : Json::ensureArray(obj, "licenses")) {
+        auto license = Json::ensureObject(element);
+        details.licenses.append(ModLicense(Json::ensureString(license, "name"), Json::ensureString(license, "id"),
+                                           Json::ensureString(license, "url"), Json::ensureString(license, "description")));
+    }
+    details.icon_file = Json::ensureString(obj, "icon_file");
+    for (auto provided : Json::ensureArray(obj, "provides"))
+        details.provides.append(provided.toString());
+    for (auto dependency : Json::ensureArray(obj, "dependencies"))
+        details.dependencies.append(dependency.toString());
+    for (auto bundled : Json::ensureArray(obj, "bundled")) {
+        auto bundledObj = Json::ensureObject(bundled);
+        details.bundled.append({ Json::ensureString(bundledObj, "path"), Json::ensureString(bundledObj, "mod_id"),
+                                 Json::ensureString(bundledObj, "name"), Json::ensureString(bundledObj, "version") });
+    }
+    return details;
+}
+}  // namespace
+
+ModDetailsCache::ModDetailsCache(QString path) : QObject(), m_cache_file(path)
+{
+    m_saveBatchingTimer.setSingleShot(true);
+    m_saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&m_saveBatchingTimer, &QTimer::timeout, this, &ModDetailsCache::saveNow);
+}
+
+ModDetailsCache::~ModDetailsCache()
+{
+    m_saveBatchingTimer.stop();
+    saveNow();
+}
+
+ModDetailsCache* ModDetailsCache::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->modDetailsCache().get() : nullptr;
+}
+
+ModDetailsCache::Entry* ModDetailsCache::find(QHash<QString, Entry>& entries, const QString& key, const QFileInfo& info)
+{
+    auto entry = entries.find(key);
+    if (entry == entries.end()) {
+        return nullptr;
+    }
+    if (entry->size != info.size() || entry->lastModified != info.lastModified().toMSecsSinceEpoch()) {
+        // the file changed, it needs parsing again
+        entries.erase(entry);
+        return nullptr;
+    }
+    entry->lastUsed = QDateTime::currentSecsSinceEpoch();
+    return &*entry;
+}
+
+std::optional<ModDetails> ModDetailsCache::get(const QString& filePath)
+{
+    QFileInfo info(filePath);
+    auto key = Hashing::HashCache::fileKey(filePath);
+    if (key.isEmpty()) {
+        return {};
+    }
+
+    QMutexLocker locker(&m_lock);
+    if (auto entry = find(m_entries, key, info))
+        return entry->details;
+    return {};
+}
+
+void ModDetailsCache::put(const QString& filePath, const ModDetails& details)
+{
+    QFileInfo info(filePath);
+    auto key = Hashing::HashCache::fileKey(filePath);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto& entry = m_entries[key];
+        entry.path = info.absoluteFilePath();
+        entry.size = info.size();
+        entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+        entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+        entry.details = details;
+        entry.details.intern();
+    }
+    saveEventually();
+}
+
+std::optional<PackDetails> ModDetailsCache::getPack(const QString& kind, const QString& filePath)
+{
+    QFileInfo info(filePath);
+    auto key = Hashing::HashCache::fileKey(filePath);
+    if (key.isEmpty()) {
+        return {};
+    }
+
+    QMutexLocker locker(&m_lock);
+    if (auto entry = find(m_packs, kind + ':' + key, info))
+        return entry->pack;
+    return {};
+}
+
+void ModDetailsCache::putPack(const QString& kind, const QString& filePath, const PackDetails& details)
+{
+    QFileInfo info(filePath);
+    auto key = Hashing::HashCache::fileKey(filePath);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto& entry = m_packs[kind + ':' + key];
+        entry.path = info.absoluteFilePath();
+        entry.size = info.size();
+        entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+        entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+        entry.pack = details;
+    }
+    saveEventually();
+}
+
+void ModDetailsCache::load()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QFile file(m_cache_file);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    QJsonDocument json = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+    // Fail if the JSON is invalid.
+    if (parseError.error != QJsonParseError::NoError) {
+        qCritical() << QString("Failed to parse ModDetailsCache file: %1 at offset %2")
+                           .arg(parseError.errorString(), QString::number(parseError.offset))
+                           .toUtf8();
+        return;
+    }
+
+    // Make sure the root is an object.
+    if (!json.isObject()) {
+        qCritical() << "ModDetailsCache root should be an object.";
+        return;
+    }
+
+    auto root = json.object();
+
+    // check file version first, new parsers may find more in the same files
+    auto version_val = Json::ensureString(root, "version");
+    if (version_val != "3")
+        return;
+
+    QMutexLocker locker(&m_lock);
+    auto array = Json::ensureArray(root, "entries");
+    for (auto element : array) {
+        auto element_obj = Json::ensureObject(element);
+        auto key = Json::ensureString(element_obj, "key");
+        if (key.isEmpty())
+            continue;
+
+        Entry entry;
+        entry.path = Json::ensureString(element_obj, "path");
+        entry.size = Json::ensureDouble(element_obj, "size");
+        entry.lastModified = Json::ensureDouble(element_obj, "last_modified");
+        entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+        entry.details = fromJson(Json::ensureObject(element_obj, "details"));
+        entry.details.intern();
+        m_entries.insert(key, entry);
+    }
+    for (auto element : Json::ensureArray(root, "packs")) {
+        auto element_obj = Json::ensureObject(element);
+        auto key = Json::ensureString(element_obj, "key");
+        if (key.isEmpty())
+            continue;
+
+        Entry entry;
+        entry.path = Json::ensureString(element_obj, "path");
+        entry.size = Json::ensureDouble(element_obj, "size");
+        entry.lastModified = Json::ensureDouble(element_obj, "last_modified");
+        entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+        entry.pack.format = Json::ensureInteger(element_obj, "format");
+        entry.pack.description = Json::ensureString(element_obj, "description");
+        m_packs.insert(key, entry);
+    }
+}
+
+void ModDetailsCache::saveEventually()
+{
+    // the timer lives on our thread, parse tasks don't
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // reset the save timer
+            m_saveBatchingTimer.stop();
+            m_saveBatchingTimer.start(30000);
+        },
+        Qt::AutoConnection);
+}
+
+void ModDetailsCache::saveNow()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "3");
+
+    QJsonArray entriesArr;
+    {
+        QMutexLocker locker(&m_lock);
+        auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+        for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+            if (iter->lastUsed < oldest) {
+                iter = m_entries.erase(iter);
+                continue;
+            }
+            QJsonObject entryObj;
+            Json::writeString(entryObj, "key", iter.key());
+            Json::writeString(entryObj, "path", iter->path);
+            entryObj.insert("size", QJsonValue(double(iter->size)));
+            entryObj.insert("last_modified", QJsonValue(double(iter->lastModified)));
+            entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+            entryObj.insert("details", toJson(iter->details));
+            entriesArr.append(entryObj);
+            iter++;
+        }
+    }
+    toplevel.insert("entries", entriesArr);
+
+    QJsonArray packsArr;
+    {
+        QMutexLocker locker(&m_lock);
+        auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+        for (auto iter = m_packs.begin(); iter != m_packs.end();) {
+            if (iter->lastUsed < oldest) {
+                iter = m_packs.erase(iter);
+                continue;
+            }
+            QJsonObject entryObj;
+            Json::writeString(entryObj, "key", iter.key());
+            Json::writeString(entryObj, "path", iter->path);
+            entryObj.insert("size", QJsonValue(double(iter->size)));
+            entryObj.insert("last_modified", QJsonValue(double(iter->lastModified)));
+            entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+            entryObj.insert("format", iter->pack.format);
+            Json::writeString(entryObj, "description", iter->pack.description);
+            packsArr.append(entryObj);
+            iter++;
+        }
+    }
+    toplevel.insert("packs", packsArr);
+
+    try {
+        Json::write(toplevel, m_cache_file);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing mod details cache:" << e.what();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+#include "minecraft/mod/ModDetails.h"
+
+/** What parsing a resource, texture, data or shader pack found. */
+struct PackDetails {
+    int format = 0;
+    QString description;
+};
+
+/**
+ * Persistent cache of what parsing a mod file found, shared by every instance.
+ *
+ * What the packs said about themselves is kept here too, by the kind of pack they were parsed as.
+ *
+ * Entries are keyed like the hash cache, by the identity of the file, and only trusted while its size and modification
+ * time still match. A jar that changed misses on its own, so the folder watcher seeing it just gets it parsed again.
+ * The install status and the metadata don't come from the file, they aren't cached.
+ *
+ * All the methods are thread safe.
+ */
+class ModDetailsCache : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the cache file
+    explicit ModDetailsCache(QString path = QString());
+    ~ModDetailsCache() override;
+
+    /// the cache of the running launcher, null when there's none like in tests
+    static ModDetailsCache* shared();
+
+    /// the details parsed from the file as it is now, if known
+    std::optional<ModDetails> get(const QString& filePath);
+    /// remember what got parsed from the file as it is now
+    void put(const QString& filePath, const ModDetails& details);
+
+    /// the details of the pack file as it is now, parsed as a `kind` of pack, if known
+    std::optional<PackDetails> getPack(const QString& kind, const QString& filePath);
+    /// remember what got parsed from the pack file as it is now
+    void putPack(const QString& kind, const QString& filePath, const PackDetails& details);
+
+    void load();
+    // (re)start a timer that calls saveNow later, safe to call from any thread
+    void saveEventually();
+
+   public slots:
+    void saveNow();
+
+   private:
+    struct Entry {
+        QString path;
+        qint64 size = 0;
+        qint64 lastModified = 0;
+        // last time the entry was used, in seconds since epoch
+        qint64 lastUsed = 0;
+        ModDetails details;
+        PackDetails pack;
+    };
+
+    // the entry for the file as it is now, with m_lock held
+    Entry* find(QHash<QString, Entry>& entries, const QString& key, const QFileInfo& info);
+
+   private:
+    QMutex m_lock;
+    QHash<QString, Entry> m_entries;
+    // by kind and file
+    QHash<QString, Entry> m_packs;
+    QString m_cache_file;
+    QTimer m_saveBatchingTimer;
+};
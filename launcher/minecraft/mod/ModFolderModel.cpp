@@ -44,9 +44,11 @@
 #include <QMimeData>
 #include <QString>
 #include <QStyle>
+#include <QFutureWatcher>
 #include <QThreadPool>
 #include <QUrl>
 #include <QUuid>
+#include <QtConcurrentRun>
 #include <algorithm>
 
 #include "Application.h"
@@ -58,6 +60,7 @@
 #include "modplatform/ModIndex.h"
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
+#include "modplatform/helpers/HashUtils.h"
 
 ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool is_indexed, bool create_dir)
     : ResourceFolderModel(QDir(dir), instance, nullptr, create_dir), m_is_indexed(is_indexed)
@@ -68,6 +71,21 @@ ModFolderModel::ModFolderModel(const QString& dir, BaseInstance* instance, bool
     m_column_resize_modes = { QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Stretch,
                               QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive };
     m_columnsHideable = { false, true, false, true, true, true };
+
+    // a parsed mod comes with a dataChanged of its row, so only that row goes in the index again
+    connect(this, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex& top_left, const QModelIndex& bottom_right) { indexRows(top_left.row(), bottom_right.row()); });
+    connect(this, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex&, int first, int last) { indexRows(first, last); });
+    connect(this, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex&, int first, int last) {
+        for (int row = first; row <= last; row++)
+            unindex(m_resources[row]->internal_id());
+    });
+    connect(this, &QAbstractItemModel::modelReset, this, [this] {
+        m_providers.clear();
+        m_provided_ids.clear();
+        m_by_file_name.clear();
+        indexRows(0, size() - 1);
+    });
 }
 
 QVariant ModFolderModel::data(const QModelIndex& index, int role) const
@@ -111,6 +129,12 @@ QVariant ModFolderModel::data(const QModelIndex& index, int role) const
 
         case Qt::ToolTipRole:
             if (column == NAME_COLUMN) {
+                auto clashes = conflicts(row);
+                auto missing = missingDependencies(row);
+                if (!missing.isEmpty())
+                    clashes.append(tr("It needs %1, which isn't there or isn't enabled.").arg(missing.join(", ")));
+                if (!clashes.isEmpty())
+                    return m_resources[row]->internal_id() + "\n" + tr("Warning: %1").arg(clashes.join("\n"));
                 if (at(row)->isSymLinkUnder(instDirPath())) {
                     return m_resources[row]->internal_id() +
                            tr("\nWarning: This resource is symbolically linked from elsewhere. Editing it will also change the original."
@@ -124,10 +148,15 @@ QVariant ModFolderModel::data(const QModelIndex& index, int role) const
             }
             return m_resources[row]->internal_id();
         case Qt::DecorationRole: {
-            if (column == NAME_COLUMN && (at(row)->isSymLinkUnder(instDirPath()) || at(row)->isMoreThanOneHardLink()))
+            if (column == NAME_COLUMN &&
+                (at(row)->isSymLinkUnder(instDirPath()) || at(row)->isMoreThanOneHardLink() || !conflicts(row).isEmpty() ||
+                 !missingDependencies(row).isEmpty()))
                 return APPLICATION->getThemedIcon("status-yellow");
             if (column == ImageColumn) {
-                return at(row)->icon({ 32, 32 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding);
+                // only the rows on screen get asked for, so that's the ones that get their icon read
+                if (at(row)->shouldLoadIcon())
+                    const_cast<ModFolderModel*>(this)->loadIcon(row);
+                return at(row)->loadedIcon({ 32, 32 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding);
             }
             return {};
         }
@@ -198,6 +227,19 @@ Task* ModFolderModel::createUpdateTask()
     return task;
 }
 
+Task* ModFolderModel::createRescanTask()
+{
+    // which metadata goes with a file can only be told by reading all of it
+    if (m_is_indexed)
+        return nullptr;
+
+    return new ResourceFolderRescanTask(m_dir, snapshot(), [](QFileInfo const& entry) {
+        auto mod = makeShared<Mod>(entry);
+        mod->setStatus(ModStatus::NoMetadata);
+        return mod;
+    });
+}
+
 Task* ModFolderModel::createParseTask(Resource& resource)
 {
     return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo());
@@ -221,38 +263,39 @@ bool ModFolderModel::uninstallMod(const QString& filename, bool preserve_metadat
 
 bool ModFolderModel::deleteMods(const QModelIndexList& indexes)
 {
-    if (indexes.isEmpty())
+    auto rows = selectedRows(indexes);
+    if (rows.isEmpty())
         return true;
 
-    for (auto i : indexes) {
-        if (i.column() != 0) {
-            continue;
-        }
-        auto m = at(i.row());
-        auto index_dir = indexDir();
-        m->destroy(index_dir);
+    suspendWatching();
+    auto index_dir = indexDir();
+    QList<int> removed;
+    for (auto row : rows) {
+        if (at(row)->destroy(index_dir))
+            removed.append(row);
     }
+    removeResourceRows(removed);
+    resumeWatching();
 
-    update();
-
-    return true;
+    return removed.size() == rows.size();
 }
 
 bool ModFolderModel::deleteModsMetadata(const QModelIndexList& indexes)
 {
-    if (indexes.isEmpty())
+    auto rows = selectedRows(indexes);
+    if (rows.isEmpty())
         return true;
 
-    for (auto i : indexes) {
-        if (i.column() != 0) {
-            continue;
-        }
-        auto m = at(i.row());
-        auto index_dir = indexDir();
+    suspendWatching();
+    auto index_dir = indexDir();
+    for (auto row : rows) {
+        auto m = at(row);
         m->destroyMetadata(index_dir);
+        if (m->status() == ModStatus::Installed)
+            m->setStatus(ModStatus::NoMetadata);
     }
-
-    update();
+    emit dataChanged(index(rows.first(), 0), index(rows.last(), columnCount(QModelIndex()) - 1));
+    resumeWatching();
 
     return true;
 }
@@ -317,6 +360,169 @@ void ModFolderModel::onUpdateSucceeded()
     applyUpdates(current_set, new_set, new_mods);
 }
 
+namespace {
+// what the loaders and the game provide themselves
+const QSet<QString> s_platformIds = { "minecraft", "java", "fabricloader", "fabric-loader", "quilt_loader", "forge", "neoforge" };
+
+QString fileNameKey(QString resource_id)
+{
+    if (resource_id.endsWith(".disabled"))
+        resource_id.chop(9);
+    return resource_id;
+}
+}  // namespace
+
+void ModFolderModel::unindex(const QString& resource_id)
+{
+    for (auto& id : m_provided_ids.take(resource_id)) {
+        auto it = m_providers.find(id);
+        if (it == m_providers.end())
+            continue;
+        it->remove(resource_id);
+        if (it->isEmpty())
+            m_providers.erase(it);
+    }
+    auto it = m_by_file_name.find(fileNameKey(resource_id));
+    if (it != m_by_file_name.end()) {
+        it->remove(resource_id);
+        if (it->isEmpty())
+            m_by_file_name.erase(it);
+    }
+}
+
+void ModFolderModel::indexRows(int first, int last)
+{
+    for (int row = std::max(first, 0); row <= last && row < size(); row++) {
+        const Mod* mod = at(row);
+        auto resource_id = mod->internal_id();
+        unindex(resource_id);
+        m_by_file_name[fileNameKey(resource_id)].insert(resource_id);
+        if (!mod->enabled())
+            continue;
+
+        QStringList ids;
+        auto provide = [&](const QString& mod_id, const QString& version, bool bundled) {
+            if (mod_id.isEmpty())
+                return;
+            auto id = mod_id.toLower();
+            auto& providers = m_providers[id];
+            auto it = providers.find(resource_id);
+            // the mod itself wins over a copy of it inside its jar
+            if (it != providers.end() && (bundled || !it->bundled))
+                return;
+            providers.insert(resource_id, { version, bundled });
+            if (!ids.contains(id))
+                ids.append(id);
+        };
+        auto& details = mod->details();
+        provide(details.mod_id, details.version, false);
+        for (auto& id : details.provides)
+            provide(id, details.version, false);
+        for (auto& bundled : details.bundled)
+            provide(bundled.mod_id, bundled.version, true);
+        if (!ids.isEmpty())
+            m_provided_ids.insert(resource_id, ids);
+    }
+}
+
+bool ModFolderModel::setResourceEnabled(const QModelIndexList& indexes, EnableAction action)
+{
+    QStringList old_ids;
+    for (auto& index : indexes) {
+        if (index.isValid() && index.row() < size())
+            old_ids.append(m_resources[index.row()]->internal_id());
+    }
+    bool succeeded = ResourceFolderModel::setResourceEnabled(indexes, action);
+    // the renamed files went in under their new names with the dataChanged, the old names are left over
+    for (auto& id : old_ids) {
+        if (!m_resources_index.contains(id))
+            unindex(id);
+    }
+    return succeeded;
+}
+
+QStringList ModFolderModel::conflicts(int row) const
+{
+    if (row < 0 || row >= size())
+        return {};
+    const Mod* mod = at(row);
+    auto resource_id = mod->internal_id();
+
+    QStringList result;
+    for (auto& other : m_by_file_name.value(fileNameKey(resource_id))) {
+        if (other != resource_id)
+            result.append(tr("It is also there as %1.").arg(other));
+    }
+    if (!mod->enabled())
+        return result;
+
+    for (auto& id : m_provided_ids.value(resource_id)) {
+        auto providers_it = m_providers.constFind(id);
+        if (providers_it == m_providers.constEnd())
+            continue;
+        auto& providers = *providers_it;
+        auto own = providers.value(resource_id);
+        for (auto it = providers.constBegin(); it != providers.constEnd(); ++it) {
+            if (it.key() == resource_id)
+                continue;
+            if (!own.bundled && !it->bundled)
+                result.append(tr("%1 has the same mod ID, %2.").arg(it.key(), id));
+            // the loaders pick one of the bundled copies, which may not be what the others were built against
+            else if (own.bundled && !own.version.isEmpty() && !it->version.isEmpty() && own.version != it->version)
+                result.append(tr("It bundles %1 %2, while %3 has %1 %4.").arg(id, own.version, it.key(), it->version));
+        }
+    }
+    result.removeDuplicates();
+    return result;
+}
+
+QStringList ModFolderModel::missingDependencies(int row) const
+{
+    if (row < 0 || row >= size())
+        return {};
+    const Mod* mod = at(row);
+    if (!mod->enabled())
+        return {};
+
+    QStringList result;
+    for (auto& dependency : mod->details().dependencies) {
+        auto id = dependency.toLower();
+        if (!s_platformIds.contains(id) && !m_providers.contains(id))
+            result.append(dependency);
+    }
+    result.removeDuplicates();
+    return result;
+}
+
+void ModFolderModel::loadIcon(int row)
+{
+    const Mod* mod = at(row);
+    if (m_loading_icons.contains(mod)) {
+        return;
+    }
+    m_loading_icons.insert(mod);
+
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, mod] {
+        watcher->deleteLater();
+        m_loading_icons.remove(mod);
+
+        // it may have been removed or replaced meanwhile
+        auto row_it = std::find_if(m_resources.constBegin(), m_resources.constEnd(), [mod](auto const& res) { return res.get() == mod; });
+        if (row_it == m_resources.constEnd())
+            return;
+
+        mod->setIcon(watcher->result());
+        auto row = static_cast<int>(row_it - m_resources.constBegin());
+        emit dataChanged(index(row, ImageColumn), index(row, ImageColumn));
+    });
+
+    watcher->setFuture(QtConcurrent::run(Hashing::hashingPool(),
+                                         [path = mod->fileinfo().filePath(), type = mod->type(), icon_path = mod->iconPath()] {
+                                             return ModUtils::loadIconThumbnail(path, type, icon_path);
+                                         }));
+}
+
 void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
 {
     auto iter = m_active_parse_tasks.constFind(ticket);
@@ -73,6 +73,7 @@ class ModFolderModel : public ResourceFolderModel {
     int columnCount(const QModelIndex& parent) const override;
 
     [[nodiscard]] Task* createUpdateTask() override;
+    [[nodiscard]] Task* createRescanTask() override;
     [[nodiscard]] Task* createParseTask(Resource&) override;
 
     bool installMod(QString file_path) { return ResourceFolderModel::installResource(file_path); }
@@ -93,13 +94,42 @@ class ModFolderModel : public ResourceFolderModel {
     auto selectedMods(QModelIndexList& indexes) -> QList<Mod*>;
     auto allMods() -> QList<Mod*>;
 
+    /// what the mod in that row clashes with: another copy of the file, enabled or not, and for an enabled mod another one
+    /// with the same id or the same mod bundled at another version
+    [[nodiscard]] QStringList conflicts(int row) const;
+    /// the mods the enabled mod in that row depends on that no enabled mod provides
+    [[nodiscard]] QStringList missingDependencies(int row) const;
+
+    bool setResourceEnabled(const QModelIndexList& indexes, EnableAction action) override;
+
     RESOURCE_HELPERS(Mod)
 
    private slots:
     void onUpdateSucceeded() override;
     void onParseSucceeded(int ticket, QString resource_id) override;
 
+   protected:
+    /** Reads the icon of the mod in that row in the background, and shows it once it's there. */
+    void loadIcon(int row);
+
+    /** Puts what the mods in these rows provide in the index, in place of what they provided before. */
+    void indexRows(int first, int last);
+    void unindex(const QString& resource_id);
+
    protected:
     bool m_is_indexed;
     bool m_first_folder_load = true;
+    QSet<const Mod*> m_loading_icons;
+
+    struct Provider {
+        QString version;
+        // inside the jar rather than the mod itself
+        bool bundled;
+    };
+    // lower case mod id to the enabled mods providing it, by internal id, kept up as the mods get parsed and changed
+    QHash<QString, QHash<QString, Provider>> m_providers;
+    // the ids each mod went in under
+    QHash<QString, QStringList> m_provided_ids;
+    // file name without .disabled to the mods with that name, enabled or not
+    QHash<QString, QSet<QString>> m_by_file_name;
 };
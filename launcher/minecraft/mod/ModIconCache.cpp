@@ -0,0 +1,51 @@
+#include "ModIconCache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSaveFile>
+
+#include "Application.h"
+#include "FileSystem.h"
+
+ModIconCache::ModIconCache(QString root) : m_root(std::move(root)) {}
+
+ModIconCache* ModIconCache::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->modIconCache().get() : nullptr;
+}
+
+QImage ModIconCache::thumbnail(const QImage& image)
+{
+    if (image.isNull() || (image.width() <= iconSize && image.height() <= iconSize))
+        return image;
+    return image.scaled({ iconSize, iconSize }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+}
+
+QString ModIconCache::pathFor(const QString& hash) const
+{
+    // spread them out a bit, big packs have a lot of mods
+    return FS::PathCombine(m_root, hash.left(2), hash + ".png");
+}
+
+QImage ModIconCache::get(const QString& hash) const
+{
+    if (hash.isEmpty())
+        return {};
+    return QImage(pathFor(hash), "PNG");
+}
+
+void ModIconCache::put(const QString& hash, const QImage& thumbnail)
+{
+    if (hash.isEmpty() || thumbnail.isNull())
+        return;
+
+    auto path = pathFor(hash);
+    if (!FS::ensureFilePathExists(path))
+        return;
+
+    // other instances may be writing the same one, they'd write the same thing
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || !thumbnail.save(&file, "PNG") || !file.commit())
+        qWarning() << "Couldn't save mod icon thumbnail" << path << ":" << file.errorString();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+
+/**
+ * Thumbnails of mod icons on disk, shared by every instance.
+ *
+ * Mod icons are usually way bigger than the rows showing them, so they are scaled down once and kept as small PNGs
+ * under the SHA1 of the jar they came from. Opening a mods page again then reads those instead of the jars, and the
+ * same jar in another instance gets the same thumbnail.
+ *
+ * All the methods are thread safe.
+ */
+class ModIconCache {
+   public:
+    /// size thumbnails are scaled to, the biggest anything shows mod icons at
+    static constexpr int iconSize = 64;
+
+    explicit ModIconCache(QString root);
+
+    /// the cache of the running launcher, null when there's none like in tests
+    static auto shared() -> ModIconCache*;
+
+    /// `image` scaled down to a thumbnail
+    static auto thumbnail(const QImage& image) -> QImage;
+
+    /// the thumbnail of the jar with this hash, a null image if there's none
+    auto get(const QString& hash) const -> QImage;
+    /// remember the thumbnail of the jar with this hash
+    void put(const QString& hash, const QImage& thumbnail);
+
+   private:
+    auto pathFor(const QString& hash) const -> QString;
+
+   private:
+    QString m_root;
+};
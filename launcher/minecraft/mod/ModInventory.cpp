@@ -0,0 +1,282 @@
+#include "ModInventory.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "InstanceList.h"
+#include "minecraft/mod/Mod.h"
+#include "minecraft/mod/ModDetailsCache.h"
+#include "minecraft/mod/tasks/LocalModParseTask.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "tasks/Executor.h"
+
+namespace {
+// a burst of changes, like an update replacing many mods, gets an instance indexed once
+constexpr int s_settleMs = 1000;
+
+const QStringList s_modSuffixes = { "jar", "zip", "litemod" };
+
+bool isModFile(const QFileInfo& file)
+{
+    auto name = file.fileName();
+    if (name.endsWith(".disabled", Qt::CaseInsensitive))
+        name.chop(9);
+    return s_modSuffixes.contains(QFileInfo(name).suffix(), Qt::CaseInsensitive);
+}
+}  // namespace
+
+ModInventory::ModInventory(QObject* parent) : QObject(parent)
+{
+    m_settle.setSingleShot(true);
+    m_settle.setInterval(s_settleMs);
+    connect(&m_settle, &QTimer::timeout, this, &ModInventory::rescanPending);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString& path) {
+        auto instanceId = m_instanceByRoot.value(path);
+        if (instanceId.isEmpty())
+            return;
+        m_pending.insert(instanceId);
+        m_settle.start();
+    });
+}
+
+ModInventory* ModInventory::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->modInventory().get() : nullptr;
+}
+
+void ModInventory::start()
+{
+    if (m_started)
+        return;
+    m_started = true;
+    auto instances = APPLICATION->instances().get();
+    connect(instances, &InstanceList::instancesChanged, this, &ModInventory::sync);
+    connect(instances, &QAbstractItemModel::rowsInserted, this, &ModInventory::sync);
+    connect(instances, &QAbstractItemModel::rowsRemoved, this, &ModInventory::sync);
+    connect(instances, &QAbstractItemModel::modelReset, this, &ModInventory::sync);
+    sync();
+}
+
+int ModInventory::modCount() const
+{
+    int count = 0;
+    for (auto& entries : m_entries)
+        count += entries.size();
+    return count;
+}
+
+QList<ModInventory::Entry> ModInventory::withModId(const QString& modId, const QString& version) const
+{
+    QList<Entry> result;
+    for (auto& instanceId : m_byModId.value(modId.toLower())) {
+        for (auto& entry : m_entries.value(instanceId)) {
+            if (entry.modId.compare(modId, Qt::CaseInsensitive) == 0 && (version.isEmpty() || entry.version == version))
+                result.append(entry);
+        }
+    }
+    return result;
+}
+
+QList<ModInventory::Entry> ModInventory::withHash(const QString& hash) const
+{
+    auto key = hash.toLower();
+    QList<Entry> result;
+    for (auto& instanceId : m_byHash.value(key)) {
+        for (auto& entry : m_entries.value(instanceId)) {
+            if (entry.sha1 == key || entry.sha512 == key)
+                result.append(entry);
+        }
+    }
+    return result;
+}
+
+QList<ModInventory::Entry> ModInventory::find(const QString& text) const
+{
+    auto query = text.trimmed();
+    if (query.isEmpty())
+        return {};
+    auto key = query.toLower();
+    if (m_byHash.contains(key))
+        return withHash(key);
+    if (m_byModId.contains(key))
+        return withModId(key);
+
+    QList<Entry> result;
+    for (auto& entries : m_entries) {
+        for (auto& entry : entries) {
+            if (entry.name.contains(query, Qt::CaseInsensitive) || entry.modId.contains(query, Qt::CaseInsensitive) ||
+                entry.fileName.contains(query, Qt::CaseInsensitive))
+                result.append(entry);
+        }
+    }
+    return result;
+}
+
+QList<ModInventory::Entry> ModInventory::all() const
+{
+    QList<Entry> result;
+    result.reserve(modCount());
+    for (auto& entries : m_entries)
+        result.append(entries);
+    return result;
+}
+
+void ModInventory::update(const QString& instanceId, QList<Entry> entries)
+{
+    removeKeys(instanceId);
+    addKeys(entries);
+    m_entries.insert(instanceId, std::move(entries));
+    emit changed();
+}
+
+void ModInventory::remove(const QString& instanceId)
+{
+    if (!m_entries.contains(instanceId))
+        return;
+    removeKeys(instanceId);
+    m_entries.remove(instanceId);
+    emit changed();
+}
+
+void ModInventory::addKeys(const QList<Entry>& entries)
+{
+    for (auto& entry : entries) {
+        if (!entry.modId.isEmpty())
+            m_byModId[entry.modId.toLower()].insert(entry.instanceId);
+        if (!entry.sha1.isEmpty())
+            m_byHash[entry.sha1].insert(entry.instanceId);
+        if (!entry.sha512.isEmpty())
+            m_byHash[entry.sha512].insert(entry.instanceId);
+    }
+}
+
+void ModInventory::removeKeys(const QString& instanceId)
+{
+    auto drop = [&instanceId](QHash<QString, QSet<QString>>& index, const QString& key) {
+        auto it = index.find(key);
+        if (it == index.end())
+            return;
+        it->remove(instanceId);
+        if (it->isEmpty())
+            index.erase(it);
+    };
+    for (auto& entry : m_entries.value(instanceId)) {
+        drop(m_byModId, entry.modId.toLower());
+        drop(m_byHash, entry.sha1);
+        drop(m_byHash, entry.sha512);
+    }
+}
+
+QList<ModInventory::Entry> ModInventory::scan(const QString& instanceId, const QString& modsRoot)
+{
+    QList<Entry> entries;
+    auto cache = ModDetailsCache::shared();
+    auto files = QDir(modsRoot).entryInfoList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDir::Name);
+    for (auto& file : files) {
+        if (!isModFile(file))
+            continue;
+        Mod mod{ file };
+        ModDetails details;
+        if (auto cached = cache ? cache->get(file.filePath()) : std::nullopt) {
+            details = *cached;
+        } else if (ModUtils::process(mod, ModUtils::ProcessingLevel::Full)) {
+            details = mod.details();
+            // the mods page of the instance gets it from there too
+            if (cache)
+                cache->put(file.filePath(), details);
+        }
+
+        Entry entry;
+        entry.instanceId = instanceId;
+        entry.fileName = file.fileName();
+        entry.path = file.filePath();
+        entry.enabled = mod.enabled();
+        entry.modId = details.mod_id;
+        entry.name = details.name;
+        entry.version = details.version;
+        // both come out of the same read when neither is cached
+        entry.sha512 = Hashing::cachedHash(file.filePath(), "sha512").toLower();
+        entry.sha1 = Hashing::cachedHash(file.filePath(), "sha1").toLower();
+        entries.append(entry);
+    }
+    return entries;
+}
+
+void ModInventory::sync()
+{
+    QSet<QString> seen;
+    auto instances = APPLICATION->instances();
+    for (int i = 0; i < instances->count(); i++) {
+        auto instance = instances->at(i);
+        auto id = instance->id();
+        auto root = QDir::cleanPath(instance->modsRoot());
+        seen.insert(id);
+        if (m_roots.value(id) == root && (m_entries.contains(id) || m_scans.contains(id)))
+            continue;
+
+        auto old = m_roots.value(id);
+        if (!old.isEmpty()) {
+            m_watcher.removePath(old);
+            m_instanceByRoot.remove(old);
+        }
+        m_roots.insert(id, root);
+        m_instanceByRoot.insert(root, id);
+        // an instance without mods yet gets its folder watched once it's indexed again
+        if (QFileInfo(root).isDir())
+            m_watcher.addPath(root);
+        rescan(id);
+    }
+
+    for (auto& id : m_roots.keys()) {
+        if (seen.contains(id))
+            continue;
+        auto root = m_roots.take(id);
+        m_watcher.removePath(root);
+        m_instanceByRoot.remove(root);
+        m_pending.remove(id);
+        remove(id);
+    }
+}
+
+void ModInventory::rescanPending()
+{
+    auto pending = m_pending;
+    m_pending.clear();
+    for (auto& id : pending)
+        rescan(id);
+}
+
+void ModInventory::rescan(const QString& instanceId)
+{
+    if (m_scans.contains(instanceId)) {
+        m_changed.insert(instanceId);
+        return;
+    }
+    auto root = m_roots.value(instanceId);
+    auto watcher = new QFutureWatcher<Scan>(this);
+    m_scans.insert(instanceId, watcher);
+    connect(watcher, &QFutureWatcher<Scan>::finished, this, [this, instanceId, watcher] { scanFinished(instanceId, watcher); });
+    watcher->setFuture(
+        Executor::instance()->run(Executor::Priority::Background, [instanceId, root] { return scan(instanceId, root); }));
+}
+
+void ModInventory::scanFinished(const QString& instanceId, QFutureWatcher<Scan>* watcher)
+{
+    m_scans.remove(instanceId);
+    watcher->deleteLater();
+    // gone while it was indexed
+    if (!m_roots.contains(instanceId)) {
+        m_changed.remove(instanceId);
+        return;
+    }
+
+    auto root = m_roots.value(instanceId);
+    if (!m_watcher.directories().contains(root) && QFileInfo(root).isDir())
+        m_watcher.addPath(root);
+    update(instanceId, watcher->result());
+    if (m_changed.remove(instanceId))
+        rescan(instanceId);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+/**
+ * The mods of every instance, to tell which ones have a mod or a file without opening each of them.
+ *
+ * An instance is indexed on the thread pool from the mod details and hash caches, so only the jars that changed since
+ * anything last looked at them are read. The mods folders are watched, a change gets just that instance indexed again.
+ * Nothing is indexed before start(), there's no point in reading all the mods if no one asks about them.
+ *
+ * Lives on the GUI thread.
+ */
+class ModInventory : public QObject {
+    Q_OBJECT
+   public:
+    struct Entry {
+        QString instanceId;
+        QString fileName;
+        QString path;
+        bool enabled = true;
+        QString modId;
+        QString name;
+        QString version;
+        // lower case hex
+        QString sha1;
+        QString sha512;
+    };
+
+    explicit ModInventory(QObject* parent = nullptr);
+
+    /// the inventory of the running launcher, null when there's none like in tests
+    static ModInventory* shared();
+
+    /// index every instance and keep up with them, does nothing the second time
+    void start();
+    /// whether every instance known at the last change is indexed
+    [[nodiscard]] bool isReady() const { return m_scans.isEmpty() && m_pending.isEmpty(); }
+    [[nodiscard]] int instanceCount() const { return m_entries.size(); }
+    [[nodiscard]] int modCount() const;
+
+    /// the mods with this id, of this version if it's not empty
+    [[nodiscard]] QList<Entry> withModId(const QString& modId, const QString& version = {}) const;
+    /// the files with this SHA1 or SHA512
+    [[nodiscard]] QList<Entry> withHash(const QString& hash) const;
+    /// an id or a hash when it's one, otherwise the mods whose name, id or file name contain `text`
+    [[nodiscard]] QList<Entry> find(const QString& text) const;
+    /// the mods of every instance
+    [[nodiscard]] QList<Entry> all() const;
+
+    /// replace what's known about the instance
+    void update(const QString& instanceId, QList<Entry> entries);
+    void remove(const QString& instanceId);
+
+    /// read the mods in the folder, on any thread
+    static QList<Entry> scan(const QString& instanceId, const QString& modsRoot);
+
+   signals:
+    /// what's indexed changed, or it got ready
+    void changed();
+
+   private:
+    using Scan = QList<Entry>;
+
+    /// follow the list of instances, indexing the new ones and dropping the gone ones
+    void sync();
+    void rescan(const QString& instanceId);
+    void rescanPending();
+    void scanFinished(const QString& instanceId, QFutureWatcher<Scan>* watcher);
+    void addKeys(const QList<Entry>& entries);
+    void removeKeys(const QString& instanceId);
+
+   private:
+    bool m_started = false;
+    QHash<QString, QList<Entry>> m_entries;
+    // lower case mod id and hash to the instances with them
+    QHash<QString, QSet<QString>> m_byModId;
+    QHash<QString, QSet<QString>> m_byHash;
+
+    // mods folder of each instance, and back
+    QHash<QString, QString> m_roots;
+    QHash<QString, QString> m_instanceByRoot;
+    QFileSystemWatcher m_watcher;
+    QHash<QString, QFutureWatcher<Scan>*> m_scans;
+    // instances that changed while being indexed, or waiting for the folder to settle
+    QSet<QString> m_changed;
+    QSet<QString> m_pending;
+    QTimer m_settle;
+};
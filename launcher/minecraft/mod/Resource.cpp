@@ -3,6 +3,8 @@
 #include <QFileInfo>
 #include <QRegularExpression>
 
+#include <algorithm>
+
 #include "FileSystem.h"
 
 Resource::Resource(QObject* parent) : QObject(parent) {}
@@ -56,11 +58,18 @@ void Resource::parseFile()
 
 static void removeThePrefix(QString& string)
 {
-    QRegularExpression regex(QStringLiteral("^(?:the|teh) +"), QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression regex(QStringLiteral("^(?:the|teh) +"), QRegularExpression::CaseInsensitiveOption);
     string.remove(regex);
     string = string.trimmed();
 }
 
+auto Resource::sortName() const -> QString
+{
+    auto sort_name = name();
+    removeThePrefix(sort_name);
+    return sort_name;
+}
+
 std::pair<int, bool> Resource::compare(const Resource& other, SortType type) const
 {
     switch (type) {
@@ -72,13 +81,7 @@ std::pair<int, bool> Resource::compare(const Resource& other, SortType type) con
                 return { -1, type == SortType::ENABLED };
             break;
         case SortType::NAME: {
-            QString this_name{ name() };
-            QString other_name{ other.name() };
-
-            removeThePrefix(this_name);
-            removeThePrefix(other_name);
-
-            auto compare_result = QString::compare(this_name, other_name, Qt::CaseInsensitive);
+            auto compare_result = QString::compare(sortName(), other.sortName(), Qt::CaseInsensitive);
             if (compare_result != 0)
                 return { compare_result, type == SortType::NAME };
             break;
@@ -96,7 +99,8 @@ std::pair<int, bool> Resource::compare(const Resource& other, SortType type) con
 
 bool Resource::applyFilter(QRegularExpression filter) const
 {
-    return filter.match(name()).hasMatch();
+    auto fields = filterFields();
+    return std::any_of(fields.cbegin(), fields.cend(), [&filter](const QString& field) { return filter.match(field).hasMatch(); });
 }
 
 bool Resource::enable(EnableAction action)
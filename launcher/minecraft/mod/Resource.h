@@ -47,6 +47,8 @@ class Resource : public QObject {
     [[nodiscard]] bool enabled() const { return m_enabled; }
 
     [[nodiscard]] virtual auto name() const -> QString { return m_name; }
+    /** The name as sorted by, without a leading "The". */
+    [[nodiscard]] auto sortName() const -> QString;
     [[nodiscard]] virtual bool valid() const { return m_type != ResourceType::UNKNOWN; }
 
     /** Compares two Resources, for sorting purposes, considering a ascending order, returning:
@@ -61,7 +63,9 @@ class Resource : public QObject {
     /** Returns whether the given filter should filter out 'this' (false),
      *  or if such filter includes the Resource (true).
      */
-    [[nodiscard]] virtual bool applyFilter(QRegularExpression filter) const;
+    [[nodiscard]] bool applyFilter(QRegularExpression filter) const;
+    /** What filters are matched against, each on its own. No fields at all hides the resource from every filter. */
+    [[nodiscard]] virtual auto filterFields() const -> QStringList { return { name() }; }
 
     /** Changes the enabled property, according to 'action'.
      *
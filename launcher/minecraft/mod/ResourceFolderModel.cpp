@@ -12,18 +12,26 @@
 #include <QThreadPool>
 #include <QUrl>
 
+#include <algorithm>
+
 #include "Application.h"
 #include "FileSystem.h"
 
 #include "QVariantUtils.h"
 #include "minecraft/mod/tasks/BasicFolderLoadTask.h"
+#include "minecraft/mod/tasks/ResourceFolderRescanTask.h"
+#include "minecraft/mod/tasks/ResourceParseScheduler.h"
 
 #include "settings/Setting.h"
+#include "tasks/Executor.h"
 #include "tasks/Task.h"
 #include "ui/dialogs/CustomMessageBox.h"
 
+// renames of one job of setResourceEnabled(), each is quick on its own
+static const int renamesPerJob = 16;
+
 ResourceFolderModel::ResourceFolderModel(QDir dir, BaseInstance* instance, QObject* parent, bool create_dir)
-    : QAbstractListModel(parent), m_dir(dir), m_instance(instance), m_watcher(this)
+    : QAbstractListModel(parent), m_dir(dir), m_instance(instance)
 {
     if (create_dir) {
         FS::ensureFolderPathExists(m_dir.absolutePath());
@@ -32,16 +40,16 @@ ResourceFolderModel::ResourceFolderModel(QDir dir, BaseInstance* instance, QObje
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 
-    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ResourceFolderModel::directoryChanged);
-    connect(&m_helper_thread_task, &ConcurrentTask::finished, this, [this] { m_helper_thread_task.clear(); });
 #ifndef LAUNCHER_TEST
     // in tests the application macro doesn't work
-    m_helper_thread_task.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    ResourceParseScheduler::instance()->setMaxPerDevice(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
 #endif
 }
 
 ResourceFolderModel::~ResourceFolderModel()
 {
+    // the parse tasks point at our resources
+    ResourceParseScheduler::instance()->cancel(this);
     while (!QThreadPool::globalInstance()->waitForDone(100))
         QCoreApplication::processEvents();
 }
@@ -51,13 +59,9 @@ bool ResourceFolderModel::startWatching(const QStringList& paths)
     if (m_is_watching)
         return false;
 
-    auto couldnt_be_watched = m_watcher.addPaths(paths);
-    for (auto path : paths) {
-        if (couldnt_be_watched.contains(path))
-            qDebug() << "Failed to start watching " << path;
-        else
-            qDebug() << "Started watching " << path;
-    }
+    // a burst of changes, like a bunch of mods being copied in, is one refresh
+    m_watch = FileChangeBus::instance()->subscribe(paths, 250, this);
+    connect(m_watch, &FileChangeSubscription::changed, this, &ResourceFolderModel::directoriesChanged);
 
     update();
 
@@ -70,13 +74,9 @@ bool ResourceFolderModel::stopWatching(const QStringList& paths)
     if (!m_is_watching)
         return false;
 
-    auto couldnt_be_stopped = m_watcher.removePaths(paths);
-    for (auto path : paths) {
-        if (couldnt_be_stopped.contains(path))
-            qDebug() << "Failed to stop watching " << path;
-        else
-            qDebug() << "Stopped watching " << path;
-    }
+    Q_UNUSED(paths);
+    delete m_watch;
+    m_watch = nullptr;
 
     m_is_watching = !m_is_watching;
     return !m_is_watching;
@@ -129,7 +129,7 @@ bool ResourceFolderModel::installResource(QString original_path)
             resource.setFile(new_path_file_info);
 
             if (!m_is_watching)
-                return update();
+                return rescan();
 
             return true;
         }
@@ -148,7 +148,7 @@ bool ResourceFolderModel::installResource(QString original_path)
             resource.setFile(newpathInfo);
 
             if (!m_is_watching)
-                return update();
+                return rescan();
 
             return true;
         }
@@ -164,7 +164,7 @@ bool ResourceFolderModel::uninstallResource(QString file_name)
         if (resource->fileinfo().fileName() == file_name) {
             auto res = resource->destroy(false);
 
-            update();
+            rescan();
 
             return res;
         }
@@ -174,57 +174,119 @@ bool ResourceFolderModel::uninstallResource(QString file_name)
 
 bool ResourceFolderModel::deleteResources(const QModelIndexList& indexes)
 {
-    if (indexes.isEmpty())
+    auto rows = selectedRows(indexes);
+    if (rows.isEmpty())
         return true;
 
-    for (auto i : indexes) {
-        if (i.column() != 0) {
-            continue;
-        }
-
-        auto& resource = m_resources.at(i.row());
-
-        resource->destroy();
+    // the trash of some platforms is only safe from one thread
+    suspendWatching();
+    QList<int> removed;
+    for (auto row : rows) {
+        if (m_resources.at(row)->destroy())
+            removed.append(row);
     }
+    removeResourceRows(removed);
+    resumeWatching();
 
-    update();
-
-    return true;
+    return removed.size() == rows.size();
 }
 
 bool ResourceFolderModel::setResourceEnabled(const QModelIndexList& indexes, EnableAction action)
 {
-    if (indexes.isEmpty())
+    auto rows = selectedRows(indexes);
+    if (rows.isEmpty())
         return true;
 
+    QStringList old_ids;
+    for (auto row : rows)
+        old_ids.append(m_resources.at(row)->internal_id());
+
+    // every rename is of another file, those can go at once
+    suspendWatching();
+    QList<QFuture<bool>> renaming;
+    for (int start = 0; start < rows.size(); start += renamesPerJob) {
+        QList<Resource*> resources;
+        for (int i = start; i < std::min<int>(start + renamesPerJob, rows.size()); i++)
+            resources.append(m_resources.at(rows[i]).get());
+        renaming.append(Executor::instance()->run(Executor::Priority::Interactive, [resources, action] {
+            bool all = true;
+            for (auto* resource : resources)
+                all &= resource->enable(action);
+            return all;
+        }));
+    }
     bool succeeded = true;
-    for (auto const& idx : indexes) {
-        if (!validateIndex(idx) || idx.column() != 0)
-            continue;
-
-        int row = idx.row();
-
-        auto& resource = m_resources[row];
+    for (auto& future : renaming) {
+        Executor::instance()->waitFor(future);
+        succeeded &= future.result();
+    }
 
-        // Preserve the row, but change its ID
-        auto old_id = resource->internal_id();
-        if (!resource->enable(action)) {
-            succeeded = false;
+    // Preserve the rows, but change their IDs
+    for (int i = 0; i < rows.size(); i++) {
+        auto new_id = m_resources.at(rows[i])->internal_id();
+        if (new_id == old_ids[i])
             continue;
-        }
-
-        auto new_id = resource->internal_id();
         if (m_resources_index.contains(new_id)) {
             // FIXME: https://github.com/PolyMC/PolyMC/issues/550
         }
+        m_resources_index.remove(old_ids[i]);
+        m_resources_index[new_id] = rows[i];
+    }
+    emit dataChanged(index(rows.first(), 0), index(rows.last(), columnCount(QModelIndex()) - 1));
+    resumeWatching();
 
-        m_resources_index.remove(old_id);
-        m_resources_index[new_id] = row;
+    return succeeded;
+}
 
-        emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+QList<int> ResourceFolderModel::selectedRows(const QModelIndexList& indexes) const
+{
+    QList<int> rows;
+    for (auto const& idx : indexes) {
+        if (validateIndex(idx) && idx.column() == 0)
+            rows.append(idx.row());
     }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
 
-    return succeeded;
+void ResourceFolderModel::removeResourceRows(QList<int> rows)
+{
+    if (rows.isEmpty())
+        return;
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+
+    // one removal for every run of rows next to each other, from the last one
+    for (int i = 0; i < rows.size();) {
+        int last = rows[i];
+        int first = last;
+        while (++i < rows.size() && rows[i] == first - 1)
+            first--;
+
+        for (int row = first; row <= last; row++) {
+            if (m_resources.at(row)->isResolving())
+                cancelResolution(m_resources.at(row)->resolutionTicket());
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        m_resources.erase(m_resources.begin() + first, m_resources.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    m_resources_index.clear();
+    for (int row = 0; row < m_resources.size(); row++)
+        m_resources_index[m_resources.at(row)->internal_id()] = row;
+}
+
+void ResourceFolderModel::suspendWatching()
+{
+    if (m_watch)
+        m_watch->suspend();
+}
+
+void ResourceFolderModel::resumeWatching()
+{
+    if (m_watch)
+        m_watch->resume();
 }
 
 static QMutex s_update_task_mutex;
@@ -246,13 +308,48 @@ bool ResourceFolderModel::update()
     connect(m_current_update_task.get(), &Task::succeeded, this, &ResourceFolderModel::onUpdateSucceeded,
             Qt::ConnectionType::QueuedConnection);
     connect(m_current_update_task.get(), &Task::failed, this, &ResourceFolderModel::onUpdateFailed, Qt::ConnectionType::QueuedConnection);
+    startUpdateTask();
+
+    return true;
+}
+
+bool ResourceFolderModel::rescan()
+{
+    {
+        QMutexLocker lock(&s_update_task_mutex);
+
+        if (m_current_update_task) {
+            m_scheduled_rescan = true;
+            return false;
+        }
+
+        m_current_update_task.reset(createRescanTask());
+        if (m_current_update_task) {
+            connect(m_current_update_task.get(), &Task::succeeded, this, &ResourceFolderModel::onRescanSucceeded,
+                    Qt::ConnectionType::QueuedConnection);
+            startUpdateTask();
+            return true;
+        }
+    }
+
+    // no way of telling what changed here
+    return update();
+}
+
+void ResourceFolderModel::startUpdateTask()
+{
     connect(
         m_current_update_task.get(), &Task::finished, this,
         [=] {
             m_current_update_task.reset();
             if (m_scheduled_update) {
+                // that sees any change a rescan would
                 m_scheduled_update = false;
+                m_scheduled_rescan = false;
                 update();
+            } else if (m_scheduled_rescan) {
+                m_scheduled_rescan = false;
+                rescan();
             } else {
                 emit updateFinished();
             }
@@ -260,8 +357,76 @@ bool ResourceFolderModel::update()
         Qt::ConnectionType::QueuedConnection);
 
     QThreadPool::globalInstance()->start(m_current_update_task.get());
+}
 
-    return true;
+Task* ResourceFolderModel::createRescanTask()
+{
+    return new ResourceFolderRescanTask(m_dir, snapshot(), [](QFileInfo const& entry) { return makeShared<Resource>(entry); });
+}
+
+QHash<QString, ResourceFolderRescanTask::Snapshot> ResourceFolderModel::snapshot() const
+{
+    QHash<QString, ResourceFolderRescanTask::Snapshot> known;
+    known.reserve(m_resources.size());
+    for (auto const& resource : m_resources)
+        known.insert(resource->internal_id(), { resource->fileinfo().size(), resource->dateTimeChanged() });
+    return known;
+}
+
+void ResourceFolderModel::onRescanSucceeded()
+{
+    auto result = static_cast<ResourceFolderRescanTask*>(m_current_update_task.get())->result();
+
+    for (auto it = result->changed.constBegin(); it != result->changed.constEnd(); ++it) {
+        auto row_it = m_resources_index.constFind(it.key());
+        if (row_it == m_resources_index.constEnd()) {
+            result->added.insert(it.key(), it.value());
+            continue;
+        }
+        auto row = row_it.value();
+
+        if (m_resources.at(row)->isResolving())
+            cancelResolution(m_resources.at(row)->resolutionTicket());
+
+        m_resources[row] = it.value();
+        resolveResource(m_resources.at(row).get());
+        emit dataChanged(index(row, 0), index(row, columnCount(QModelIndex()) - 1));
+    }
+
+    QList<int> removed_rows;
+    for (auto const& removed : result->removed) {
+        auto row_it = m_resources_index.constFind(removed);
+        if (row_it != m_resources_index.constEnd())
+            removed_rows.append(row_it.value());
+    }
+    std::sort(removed_rows.begin(), removed_rows.end(), std::greater<int>());
+
+    for (auto row : removed_rows) {
+        if (m_resources.at(row)->isResolving())
+            cancelResolution(m_resources.at(row)->resolutionTicket());
+
+        beginRemoveRows(QModelIndex(), row, row);
+        m_resources.removeAt(row);
+        endRemoveRows();
+    }
+
+    if (!result->added.isEmpty()) {
+        beginInsertRows(QModelIndex(), static_cast<int>(m_resources.size()),
+                        static_cast<int>(m_resources.size() + result->added.size() - 1));
+        for (auto const& added : result->added) {
+            m_resources.append(added);
+            resolveResource(m_resources.last().get());
+        }
+        endInsertRows();
+    }
+
+    if (removed_rows.isEmpty() && result->added.isEmpty())
+        return;
+
+    m_resources_index.clear();
+    int idx = 0;
+    for (auto const& resource : qAsConst(m_resources))
+        m_resources_index[resource->internal_id()] = idx++;
 }
 
 void ResourceFolderModel::resolveResource(Resource* res)
@@ -286,11 +451,41 @@ void ResourceFolderModel::resolveResource(Resource* res)
     connect(
         task.get(), &Task::finished, this, [=] { m_active_parse_tasks.remove(ticket); }, Qt::ConnectionType::QueuedConnection);
 
-    m_helper_thread_task.addTask(task);
+    // a task still waiting on the same file never runs, so it won't tell us it finished either
+    if (auto replaced = ResourceParseScheduler::instance()->schedule(this, res->fileinfo().absoluteFilePath(), task)) {
+        for (auto it = m_active_parse_tasks.begin(); it != m_active_parse_tasks.end(); ++it) {
+            if (*it == replaced) {
+                m_active_parse_tasks.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+void ResourceFolderModel::cancelResolution(int ticket)
+{
+    auto it = m_active_parse_tasks.find(ticket);
+    if (it == m_active_parse_tasks.end())
+        return;
 
-    if (!m_helper_thread_task.isRunning()) {
-        QThreadPool::globalInstance()->start(&m_helper_thread_task);
+    if (ResourceParseScheduler::instance()->unschedule(it->get()))
+        m_active_parse_tasks.erase(it);
+    else
+        (*it)->abort();
+}
+
+void ResourceFolderModel::prioritizeResolution(const QList<int>& rows)
+{
+    QStringList paths;
+    for (auto row : rows) {
+        if (row < 0 || row >= m_resources.size())
+            continue;
+        auto const& resource = m_resources.at(row);
+        if (resource->isResolving())
+            paths.append(resource->fileinfo().absoluteFilePath());
     }
+    if (!paths.isEmpty())
+        ResourceParseScheduler::instance()->prioritize(this, paths);
 }
 
 void ResourceFolderModel::onUpdateSucceeded()
@@ -333,9 +528,16 @@ bool ResourceFolderModel::hasPendingParseTasks() const
     return !m_active_parse_tasks.isEmpty();
 }
 
-void ResourceFolderModel::directoryChanged(QString path)
+void ResourceFolderModel::directoriesChanged(const QSet<QString>& paths)
 {
-    update();
+    // the files in our folder changed, anything else we watch may change what they are
+    for (auto& path : paths) {
+        if (QDir(path) != m_dir) {
+            update();
+            return;
+        }
+    }
+    rescan();
 }
 
 Qt::DropActions ResourceFolderModel::supportedDropActions() const
@@ -578,6 +780,51 @@ SortType ResourceFolderModel::columnToSortKey(size_t column) const
 }
 
 /* Standard Proxy Model for createFilterProxyModel */
+ResourceFolderModel::ProxyModel::ProxyModel(QObject* parent) : QSortFilterProxyModel(parent)
+{
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+}
+
+void ResourceFolderModel::ProxyModel::setSourceModel(QAbstractItemModel* source_model)
+{
+    for (auto const& connection : m_source_connections)
+        disconnect(connection);
+    m_source_connections.clear();
+    m_rows.clear();
+
+    // before the base class connects, so the keys are gone by the time it sorts and filters again
+    if (source_model) {
+        auto invalidate = [this] { m_rows.clear(); };
+        m_source_connections = {
+            connect(source_model, &QAbstractItemModel::dataChanged, this,
+                    [this](const QModelIndex& top_left, const QModelIndex& bottom_right) {
+                        for (int row = top_left.row(); row <= bottom_right.row() && row < static_cast<int>(m_rows.size()); row++)
+                            m_rows[row] = {};
+                    }),
+            connect(source_model, &QAbstractItemModel::rowsInserted, this, invalidate),
+            connect(source_model, &QAbstractItemModel::rowsRemoved, this, invalidate),
+            connect(source_model, &QAbstractItemModel::rowsMoved, this, invalidate),
+            connect(source_model, &QAbstractItemModel::layoutChanged, this, invalidate),
+            connect(source_model, &QAbstractItemModel::modelReset, this, invalidate),
+        };
+    }
+    QSortFilterProxyModel::setSourceModel(source_model);
+}
+
+auto ResourceFolderModel::ProxyModel::rowKeys(const ResourceFolderModel& model, int source_row) const -> RowKeys&
+{
+    if (m_rows.size() != static_cast<size_t>(model.size())) {
+        m_rows.clear();
+        m_rows.resize(model.size());
+    }
+    return m_rows[source_row];
+}
+
+static bool isLiteral(const QString& pattern)
+{
+    return QRegularExpression::escape(pattern) == pattern;
+}
+
 [[nodiscard]] bool ResourceFolderModel::ProxyModel::filterAcceptsRow(int source_row,
                                                                      [[maybe_unused]] const QModelIndex& source_parent) const
 {
@@ -585,9 +832,28 @@ SortType ResourceFolderModel::columnToSortKey(size_t column) const
     if (!model)
         return true;
 
-    const auto& resource = model->at(source_row);
+    auto filter = filterRegularExpression();
+    auto options = filter.patternOptions() | QRegularExpression::MultilineOption;
+    if (filter.pattern() != m_filter.pattern() || options != m_filter.patternOptions()) {
+        // typing on only ever hides more rows
+        bool narrows = options == m_filter.patternOptions() && filter.pattern().startsWith(m_filter.pattern()) &&
+                       isLiteral(m_filter.pattern()) && isLiteral(filter.pattern());
+        if (!narrows) {
+            for (auto& row : m_rows)
+                row.rejected = false;
+        }
+        m_filter = QRegularExpression(filter.pattern(), options);
+    }
 
-    return resource.applyFilter(filterRegularExpression());
+    auto& keys = rowKeys(*model, source_row);
+    if (keys.rejected)
+        return false;
+    if (!keys.filter_text) {
+        auto fields = model->at(source_row).filterFields();
+        keys.filter_text = fields.isEmpty() ? QString() : fields.join('\n');
+    }
+    keys.rejected = keys.filter_text->isNull() || !m_filter.match(*keys.filter_text).hasMatch();
+    return !keys.rejected;
 }
 
 [[nodiscard]] bool ResourceFolderModel::ProxyModel::lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const
@@ -604,6 +870,29 @@ SortType ResourceFolderModel::columnToSortKey(size_t column) const
     auto const& resource_left = model->at(source_left.row());
     auto const& resource_right = model->at(source_right.row());
 
+    // what every resource sorts the same way by comes from the keys, the rest from the resources themselves
+    if (column_sort_key == SortType::NAME || column_sort_key == SortType::DATE) {
+        auto& left = rowKeys(*model, source_left.row());
+        auto& right = rowKeys(*model, source_right.row());
+        int compare_result = 0;
+        if (column_sort_key == SortType::NAME) {
+            if (!left.name)
+                left.name = m_collator.sortKey(resource_left.sortName());
+            if (!right.name)
+                right.name = m_collator.sortKey(resource_right.sortName());
+            compare_result = left.name->compare(*right.name);
+        } else {
+            if (!left.date)
+                left.date = resource_left.dateTimeChanged().toMSecsSinceEpoch();
+            if (!right.date)
+                right.date = resource_right.dateTimeChanged().toMSecsSinceEpoch();
+            compare_result = *left.date < *right.date ? -1 : *left.date > *right.date ? 1 : 0;
+        }
+        if (compare_result == 0)
+            return QSortFilterProxyModel::lessThan(source_left, source_right);
+        return compare_result < 0;
+    }
+
     auto compare_result = resource_left.compare(resource_right, column_sort_key);
     if (compare_result.first == 0)
         return QSortFilterProxyModel::lessThan(source_left, source_right);
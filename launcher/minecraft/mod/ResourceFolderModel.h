@@ -2,19 +2,24 @@
 
 #include <QAbstractListModel>
 #include <QAction>
+#include <QCollator>
 #include <QDir>
-#include <QFileSystemWatcher>
 #include <QHeaderView>
 #include <QMutex>
 #include <QSet>
 #include <QSortFilterProxyModel>
 #include <QTreeView>
 
+#include <optional>
+#include <vector>
+
 #include "Resource.h"
 
 #include "BaseInstance.h"
 
-#include "tasks/ConcurrentTask.h"
+#include "filewatch/FileChangeBus.h"
+
+#include "minecraft/mod/tasks/ResourceFolderRescanTask.h"
 #include "tasks/Task.h"
 
 class QSortFilterProxyModel;
@@ -74,9 +79,16 @@ class ResourceFolderModel : public QAbstractListModel {
 
     /** Creates a new update task and start it. Returns false if no update was done, like when an update is already underway. */
     virtual bool update();
+    /** Like update(), but only makes new resources for the files that changed since the last one.
+     *
+     *  Falls back to a full update when createRescanTask() has no way of doing so.
+     */
+    bool rescan();
 
     /** Creates a new parse task, if needed, for 'res' and start it.*/
     virtual void resolveResource(Resource* res);
+    /** Has the resources in these rows that are still waiting to be parsed go first, like the ones on screen. */
+    void prioritizeResolution(const QList<int>& rows);
 
     [[nodiscard]] qsizetype size() const { return m_resources.size(); }
     [[nodiscard]] bool empty() const { return size() == 0; }
@@ -132,11 +144,33 @@ class ResourceFolderModel : public QAbstractListModel {
 
     class ProxyModel : public QSortFilterProxyModel {
        public:
-        explicit ProxyModel(QObject* parent = nullptr) : QSortFilterProxyModel(parent) {}
+        explicit ProxyModel(QObject* parent = nullptr);
+
+        void setSourceModel(QAbstractItemModel* source_model) override;
 
        protected:
         [[nodiscard]] bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
         [[nodiscard]] bool lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const override;
+
+       private:
+        // what a row sorts and filters by, computed the first time it's needed after the row changed
+        struct RowKeys {
+            std::optional<QCollatorSortKey> name;
+            std::optional<qint64> date;
+            // the filter fields joined by line breaks, null when no filter shows the row
+            std::optional<QString> filter_text;
+            // whether the last filter rejected it, a longer literal filter starting the same rejects it too
+            bool rejected = false;
+        };
+        RowKeys& rowKeys(const ResourceFolderModel& model, int source_row) const;
+
+       private:
+        QCollator m_collator;
+        // by source row
+        mutable std::vector<RowKeys> m_rows;
+        // the last filter, with ^ and $ matching at the line breaks of the filter texts
+        mutable QRegularExpression m_filter;
+        QList<QMetaObject::Connection> m_source_connections;
     };
 
     QString instDirPath() const;
@@ -161,6 +195,14 @@ class ResourceFolderModel : public QAbstractListModel {
      */
     [[nodiscard]] virtual Task* createParseTask(Resource&) { return nullptr; }
 
+    /** This creates a new task to be executed by rescan(), or returns nullptr if only a full update will do.
+     *
+     *  The task should make the same kind of resources the one from createUpdateTask() would, for the files that don't
+     *  match the given snapshot().
+     */
+    [[nodiscard]] virtual Task* createRescanTask();
+    [[nodiscard]] QHash<QString, ResourceFolderRescanTask::Snapshot> snapshot() const;
+
     /** Standard implementation of the model update logic.
      *
      *  It uses set operations to find differences between the current state and the updated state,
@@ -171,8 +213,21 @@ class ResourceFolderModel : public QAbstractListModel {
     template <typename T>
     void applyUpdates(QSet<QString>& current_set, QSet<QString>& new_set, QMap<QString, T>& new_resources);
 
+    /** Stops the parse task with the given ticket, dropping it if it hasn't started yet. */
+    void cancelResolution(int ticket);
+    /** Runs m_current_update_task, and whatever got scheduled while it did. */
+    void startUpdateTask();
+
+    /** The rows of the first column of `indexes`, once each and in order, for acting on a selection at once. */
+    [[nodiscard]] QList<int> selectedRows(const QModelIndexList& indexes) const;
+    /** Drops the rows of resources that are gone from disk, with a single removal per run of adjacent rows. */
+    void removeResourceRows(QList<int> rows);
+    /** Keeps what the model does to its own files from coming back as a rescan, until resumeWatching(). */
+    void suspendWatching();
+    void resumeWatching();
+
    protected slots:
-    void directoryChanged(QString);
+    void directoriesChanged(const QSet<QString>& paths);
 
     /** Called when the update task is successful.
      *
@@ -182,6 +237,7 @@ class ResourceFolderModel : public QAbstractListModel {
      */
     virtual void onUpdateSucceeded();
     virtual void onUpdateFailed() {}
+    void onRescanSucceeded();
 
     /** Called when the parse task with the given ticket is successful.
      *
@@ -206,18 +262,18 @@ class ResourceFolderModel : public QAbstractListModel {
 
     QDir m_dir;
     BaseInstance* m_instance;
-    QFileSystemWatcher m_watcher;
+    FileChangeSubscription* m_watch = nullptr;
     bool m_is_watching = false;
 
     Task::Ptr m_current_update_task = nullptr;
     bool m_scheduled_update = false;
+    bool m_scheduled_rescan = false;
 
     QList<Resource::Ptr> m_resources;
 
     // Represents the relationship between a resource's internal ID and it's row position on the model.
     QMap<QString, int> m_resources_index;
 
-    ConcurrentTask m_helper_thread_task;
     QMap<int, Task::Ptr> m_active_parse_tasks;
     std::atomic<int> m_next_resolution_ticket = 0;
 };
@@ -278,11 +334,7 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
             // If the resource is resolving, but something about it changed, we don't want to
             // continue the resolving.
             if (current_resource->isResolving()) {
-                auto ticket = current_resource->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
+                cancelResolution(current_resource->resolutionTicket());
             }
 
             m_resources[row].reset(new_resource);
@@ -309,11 +361,7 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
             Q_ASSERT(removed_set.contains(removed_it->get()->internal_id()));
 
             if ((*removed_it)->isResolving()) {
-                auto ticket = (*removed_it)->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
+                cancelResolution((*removed_it)->resolutionTicket());
             }
 
             beginRemoveRows(QModelIndex(), removed_index, removed_index);
@@ -47,13 +47,13 @@ void ResourcePack::setImage(QImage new_image) const
     Q_ASSERT(!new_image.isNull());
 
     if (m_pack_image_cache_key.key.isValid())
-        PixmapCache::instance().remove(m_pack_image_cache_key.key);
+        PixmapCache::remove(m_pack_image_cache_key.key);
 
     // scale the image to avoid flooding the pixmapcache
     auto pixmap =
         QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
 
-    m_pack_image_cache_key.key = PixmapCache::instance().insert(pixmap);
+    m_pack_image_cache_key.key = PixmapCache::insert(PixmapCache::Category::Packs, pixmap);
     m_pack_image_cache_key.was_ever_used = true;
 
     // This can happen if the pixmap is too big to fit in the cache :c
@@ -66,7 +66,7 @@ void ResourcePack::setImage(QImage new_image) const
 QPixmap ResourcePack::image(QSize size, Qt::AspectRatioMode mode) const
 {
     QPixmap cached_image;
-    if (PixmapCache::instance().find(m_pack_image_cache_key.key, &cached_image)) {
+    if (PixmapCache::find(m_pack_image_cache_key.key, &cached_image)) {
         if (size.isNull())
             return cached_image;
         return cached_image.scaled(size, mode, Qt::SmoothTransformation);
@@ -74,10 +74,17 @@ QPixmap ResourcePack::image(QSize size, Qt::AspectRatioMode mode) const
 
     // No valid image we can get
     if (!m_pack_image_cache_key.was_ever_used) {
-        return {};
+        // the parse task leaves the image to the first time it's shown
+        if (m_pack_image_cache_key.tried)
+            return {};
+        m_pack_image_cache_key.tried = true;
+        ResourcePackUtils::processPackPNG(*this);
+        if (!m_pack_image_cache_key.was_ever_used)
+            return {};
+        return image(size, mode);
     } else {
         qDebug() << "Resource Pack" << name() << "Had it's image evicted from the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        PixmapCache::markCacheMissByEviciton(PixmapCache::Category::Packs);
     }
 
     // Imaged got evicted from the cache. Re-process it and retry.
@@ -119,20 +126,11 @@ std::pair<int, bool> ResourcePack::compare(const Resource& other, SortType type)
     return { 0, false };
 }
 
-bool ResourcePack::applyFilter(QRegularExpression filter) const
+auto ResourcePack::filterFields() const -> QStringList
 {
-    if (filter.match(description()).hasMatch())
-        return true;
-
-    if (filter.match(QString::number(packFormat())).hasMatch())
-        return true;
-
-    if (filter.match(compatibleVersions().first.toString()).hasMatch())
-        return true;
-    if (filter.match(compatibleVersions().second.toString()).hasMatch())
-        return true;
-
-    return Resource::applyFilter(filter);
+    auto versions = compatibleVersions();
+    return QStringList{ description(), QString::number(packFormat()), versions.first.toString(), versions.second.toString() } +
+           Resource::filterFields();
 }
 
 bool ResourcePack::valid() const
@@ -1,11 +1,11 @@
 #pragma once
 
+#include "MTPixmapCache.h"
 #include "Resource.h"
 
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 class Version;
 
@@ -45,7 +45,7 @@ class ResourcePack : public Resource {
     bool valid() const override;
 
     [[nodiscard]] auto compare(Resource const& other, SortType type) const -> std::pair<int, bool> override;
-    [[nodiscard]] bool applyFilter(QRegularExpression filter) const override;
+    [[nodiscard]] auto filterFields() const -> QStringList override;
 
    protected:
     mutable QMutex m_data_lock;
@@ -59,13 +59,15 @@ class ResourcePack : public Resource {
      */
     QString m_description;
 
-    /** The resource pack's image file cache key, for access in the QPixmapCache global instance.
+    /** The resource pack's image file cache key, for access in the PixmapCache global instance.
      *
      *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
      *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
+     *  The 'tried' state tells whether the image was ever looked for, since it's only read once it's needed.
      */
     struct {
-        QPixmapCache::Key key;
+        PixmapCache::Key key;
         bool was_ever_used = false;
+        bool tried = false;
     } mutable m_pack_image_cache_key;
 };
@@ -183,6 +183,11 @@ Task* ResourcePackFolderModel::createUpdateTask()
     return new BasicFolderLoadTask(m_dir, [](QFileInfo const& entry) { return makeShared<ResourcePack>(entry); });
 }
 
+Task* ResourcePackFolderModel::createRescanTask()
+{
+    return new ResourceFolderRescanTask(m_dir, snapshot(), [](QFileInfo const& entry) { return makeShared<ResourcePack>(entry); });
+}
+
 Task* ResourcePackFolderModel::createParseTask(Resource& resource)
 {
     return new LocalResourcePackParseTask(m_next_resolution_ticket, static_cast<ResourcePack&>(resource));
@@ -19,6 +19,7 @@ class ResourcePackFolderModel : public ResourceFolderModel {
     [[nodiscard]] int columnCount(const QModelIndex& parent) const override;
 
     [[nodiscard]] Task* createUpdateTask() override;
+    [[nodiscard]] Task* createRescanTask() override;
     [[nodiscard]] Task* createParseTask(Resource&) override;
 
     RESOURCE_HELPERS(ResourcePack)
@@ -36,7 +36,9 @@ bool ShaderPack::valid() const
     return m_pack_format != ShaderPackFormat::INVALID;
 }
 
-bool ShaderPack::applyFilter(QRegularExpression filter) const
+auto ShaderPack::filterFields() const -> QStringList
 {
-    return valid() && Resource::applyFilter(filter);
+    if (!valid())
+        return {};
+    return Resource::filterFields();
 }
@@ -54,7 +54,7 @@ class ShaderPack : public Resource {
     void setPackFormat(ShaderPackFormat new_format);
 
     bool valid() const override;
-    [[nodiscard]] bool applyFilter(QRegularExpression filter) const override;
+    [[nodiscard]] auto filterFields() const -> QStringList override;
 
    protected:
     mutable QMutex m_data_lock;
@@ -18,6 +18,11 @@ class ShaderPackFolderModel : public ResourceFolderModel {
         return new BasicFolderLoadTask(m_dir, [](QFileInfo const& entry) { return makeShared<ShaderPack>(entry); });
     }
 
+    [[nodiscard]] Task* createRescanTask() override
+    {
+        return new ResourceFolderRescanTask(m_dir, snapshot(), [](QFileInfo const& entry) { return makeShared<ShaderPack>(entry); });
+    }
+
     [[nodiscard]] Task* createParseTask(Resource& resource) override
     {
         return new LocalShaderPackParseTask(m_next_resolution_ticket, static_cast<ShaderPack&>(resource));
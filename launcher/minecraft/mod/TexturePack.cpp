@@ -47,7 +47,7 @@ void TexturePack::setImage(QImage new_image) const
     auto pixmap =
         QPixmap::fromImage(new_image.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation));
 
-    m_pack_image_cache_key.key = PixmapCache::insert(pixmap);
+    m_pack_image_cache_key.key = PixmapCache::insert(PixmapCache::Category::Packs, pixmap);
     m_pack_image_cache_key.was_ever_used = true;
 }
 
@@ -62,10 +62,17 @@ QPixmap TexturePack::image(QSize size, Qt::AspectRatioMode mode) const
 
     // No valid image we can get
     if (!m_pack_image_cache_key.was_ever_used) {
-        return {};
+        // the parse task leaves the image to the first time it's shown
+        if (m_pack_image_cache_key.tried)
+            return {};
+        m_pack_image_cache_key.tried = true;
+        TexturePackUtils::processPackPNG(*this);
+        if (!m_pack_image_cache_key.was_ever_used)
+            return {};
+        return image(size, mode);
     } else {
         qDebug() << "Texture Pack" << name() << "Had it's image evicted from the cache. reloading...";
-        PixmapCache::markCacheMissByEviciton();
+        PixmapCache::markCacheMissByEviciton(PixmapCache::Category::Packs);
     }
 
     // Imaged got evicted from the cache. Re-process it and retry.
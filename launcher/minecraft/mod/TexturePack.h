@@ -19,12 +19,12 @@
 
 #pragma once
 
+#include "MTPixmapCache.h"
 #include "Resource.h"
 
 #include <QImage>
 #include <QMutex>
 #include <QPixmap>
-#include <QPixmapCache>
 
 class Version;
 
@@ -57,13 +57,15 @@ class TexturePack : public Resource {
      */
     QString m_description;
 
-    /** The texture pack's image file cache key, for access in the QPixmapCache global instance.
+    /** The texture pack's image file cache key, for access in the PixmapCache global instance.
      *
      *  The 'was_ever_used' state simply identifies whether the key was never inserted on the cache (true),
      *  so as to tell whether a cache entry is inexistent or if it was just evicted from the cache.
+     *  The 'tried' state tells whether the image was ever looked for, since it's only read once it's needed.
      */
     struct {
-        QPixmapCache::Key key;
+        PixmapCache::Key key;
         bool was_ever_used = false;
+        bool tried = false;
     } mutable m_pack_image_cache_key;
 };
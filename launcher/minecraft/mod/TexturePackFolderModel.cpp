@@ -56,6 +56,11 @@ Task* TexturePackFolderModel::createUpdateTask()
     return new BasicFolderLoadTask(m_dir, [](QFileInfo const& entry) { return makeShared<TexturePack>(entry); });
 }
 
+Task* TexturePackFolderModel::createRescanTask()
+{
+    return new ResourceFolderRescanTask(m_dir, snapshot(), [](QFileInfo const& entry) { return makeShared<TexturePack>(entry); });
+}
+
 Task* TexturePackFolderModel::createParseTask(Resource& resource)
 {
     return new LocalTexturePackParseTask(m_next_resolution_ticket, static_cast<TexturePack&>(resource));
@@ -57,6 +57,7 @@ class TexturePackFolderModel : public ResourceFolderModel {
 
     explicit TexturePackFolderModel(const QString& dir, BaseInstance* instance);
     [[nodiscard]] Task* createUpdateTask() override;
+    [[nodiscard]] Task* createRescanTask() override;
     [[nodiscard]] Task* createParseTask(Resource&) override;
 
     RESOURCE_HELPERS(TexturePack)
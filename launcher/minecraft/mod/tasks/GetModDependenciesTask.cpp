@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <algorithm>
 #include <memory>
+#include "Application.h"
 #include "Json.h"
 #include "QObjectPtr.h"
 #include "minecraft/mod/MetadataHandler.h"
@@ -34,6 +35,19 @@
 #include "ui/pages/modplatform/flame/FlameResourceModels.h"
 #include "ui/pages/modplatform/modrinth/ModrinthResourceModels.h"
 
+namespace {
+// what the APIs answered this session, the same libraries are needed by many mods
+// project info by provider and project
+QHash<QString, QByteArray> s_projectInfo;
+// dependency versions by provider, dependency, loaders and game version
+QHash<QString, QJsonDocument> s_dependencyVersions;
+
+QString projectKey(ModPlatform::ResourceProvider providerName, const QVariant& addonId)
+{
+    return QString("%1:%2").arg(QString::number(int(providerName)), addonId.toString());
+}
+}  // namespace
+
 static Version mcVersion(BaseInstance* inst)
 {
     return static_cast<MinecraftInstance*>(inst)->getPackProfile()->getComponent("net.minecraft")->getVersion();
@@ -48,7 +62,7 @@ GetModDependenciesTask::GetModDependenciesTask(QObject* parent,
                                                BaseInstance* instance,
                                                ModFolderModel* folder,
                                                QList<std::shared_ptr<PackDependency>> selected)
-    : SequentialTask(parent, tr("Get dependencies"))
+    : ConcurrentTask(parent, tr("Get dependencies"), APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt())
     , m_selected(selected)
     , m_flame_provider{ ModPlatform::ResourceProvider::FLAME, std::make_shared<ResourceDownload::FlameModModel>(*instance),
                         std::make_shared<FlameAPI>() }
@@ -63,6 +77,24 @@ GetModDependenciesTask::GetModDependenciesTask(QObject* parent,
     prepare();
 }
 
+void GetModDependenciesTask::startNext()
+{
+    // like a sequential task, the list isn't complete without all of them
+    if (m_failed.size() > 0) {
+        emitFailed(tr("One of the tasks failed!"));
+        qWarning() << m_failed.constBegin()->get()->failReason();
+        return;
+    }
+
+    ConcurrentTask::startNext();
+}
+
+QString GetModDependenciesTask::versionKey(const ModPlatform::Dependency& dep, ModPlatform::ResourceProvider providerName) const
+{
+    return QString("%1:%2:%3:%4")
+        .arg(projectKey(providerName, dep.addonId), dep.version, QString::number(int(m_loaderType)), m_version.toString());
+}
+
 void GetModDependenciesTask::prepare()
 {
     for (auto sel : m_selected) {
@@ -135,31 +167,45 @@ QList<ModPlatform::Dependency> GetModDependenciesTask::getDependenciesForVersion
 Task::Ptr GetModDependenciesTask::getProjectInfoTask(std::shared_ptr<PackDependency> pDep)
 {
     auto provider = pDep->pack->provider == m_flame_provider.name ? m_flame_provider : m_modrinth_provider;
+    auto key = projectKey(provider.name, pDep->pack->addonId);
+    if (auto cached = s_projectInfo.constFind(key); cached != s_projectInfo.constEnd()) {
+        projectInfoLoaded(provider, pDep, *cached);
+        return nullptr;
+    }
+
     auto responseInfo = std::make_shared<QByteArray>();
     auto info = provider.api->getProject(pDep->pack->addonId.toString(), responseInfo);
-    QObject::connect(info.get(), &NetJob::succeeded, [this, responseInfo, provider, pDep] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*responseInfo, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            removePack(pDep->pack->addonId);
-            qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qDebug() << *responseInfo;
-            return;
-        }
-        try {
-            auto obj = provider.name == ModPlatform::ResourceProvider::FLAME ? Json::requireObject(Json::requireObject(doc), "data")
-                                                                             : Json::requireObject(doc);
-            provider.mod->loadIndexedPack(*pDep->pack, obj);
-        } catch (const JSONValidationError& e) {
-            removePack(pDep->pack->addonId);
-            qDebug() << doc;
-            qWarning() << "Error while reading mod info: " << e.cause();
-        }
+    QObject::connect(info.get(), &NetJob::succeeded, [this, responseInfo, provider, pDep, key] {
+        if (projectInfoLoaded(provider, pDep, *responseInfo))
+            s_projectInfo.insert(key, *responseInfo);
     });
     return info;
 }
 
+bool GetModDependenciesTask::projectInfoLoaded(const Provider& provider, std::shared_ptr<PackDependency> pDep, const QByteArray& response)
+{
+    QJsonParseError parse_error{};
+    QJsonDocument doc = QJsonDocument::fromJson(response, &parse_error);
+    if (parse_error.error != QJsonParseError::NoError) {
+        removePack(pDep->pack->addonId);
+        qWarning() << "Error while parsing JSON response for mod info at " << parse_error.offset
+                   << " reason: " << parse_error.errorString();
+        qDebug() << response;
+        return false;
+    }
+    try {
+        auto obj = provider.name == ModPlatform::ResourceProvider::FLAME ? Json::requireObject(Json::requireObject(doc), "data")
+                                                                         : Json::requireObject(doc);
+        provider.mod->loadIndexedPack(*pDep->pack, obj);
+    } catch (const JSONValidationError& e) {
+        removePack(pDep->pack->addonId);
+        qDebug() << doc;
+        qWarning() << "Error while reading mod info: " << e.cause();
+        return false;
+    }
+    return true;
+}
+
 Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Dependency& dep,
                                                         const ModPlatform::ResourceProvider providerName,
                                                         int level)
@@ -177,69 +223,87 @@ Task::Ptr GetModDependenciesTask::prepareDependencyTask(const ModPlatform::Depen
         this, QString("DependencyInfo: %1").arg(dep.addonId.toString().isEmpty() ? dep.version : dep.addonId.toString()));
 
     if (!dep.addonId.toString().isEmpty()) {
-        tasks->addTask(getProjectInfoTask(pDep));
+        if (auto info = getProjectInfoTask(pDep))
+            tasks->addTask(info);
+    }
+
+    auto key = versionKey(dep, providerName);
+    if (auto cached = s_dependencyVersions.constFind(key); cached != s_dependencyVersions.constEnd()) {
+        dependencyVersionLoaded(dep, provider, pDep, level, *cached);
+        return tasks;
     }
 
     ResourceAPI::DependencySearchArgs args = { dep, m_version, m_loaderType };
     ResourceAPI::DependencySearchCallbacks callbacks;
 
-    callbacks.on_succeed = [dep, provider, pDep, level, this](auto& doc, [[maybe_unused]] auto& pack) {
-        try {
-            QJsonArray arr;
-            if (dep.version.length() != 0 && doc.isObject()) {
-                arr.append(doc.object());
-            } else {
-                arr = doc.isObject() ? Json::ensureArray(doc.object(), "data") : doc.array();
-            }
-            pDep->version = provider.mod->loadDependencyVersions(dep, arr);
-            if (!pDep->version.addonId.isValid()) {
-                if (m_loaderType & ModPlatform::Quilt) {  // falback for quilt
-                    auto overide = ModPlatform::getOverrideDeps();
-                    auto over = std::find_if(overide.cbegin(), overide.cend(),
-                                             [dep, provider](auto o) { return o.provider == provider.name && dep.addonId == o.quilt; });
-                    if (over != overide.cend()) {
-                        removePack(dep.addonId);
-                        addTask(prepareDependencyTask({ over->fabric, dep.type }, provider.name, level));
-                        return;
-                    }
+    callbacks.on_succeed = [dep, provider, pDep, level, key, this](auto& doc, [[maybe_unused]] auto& pack) {
+        s_dependencyVersions.insert(key, doc);
+        dependencyVersionLoaded(dep, provider, pDep, level, doc);
+    };
+
+    auto version = provider.api->getDependencyVersion(std::move(args), std::move(callbacks));
+    tasks->addTask(version);
+    return tasks;
+}
+
+void GetModDependenciesTask::dependencyVersionLoaded(const ModPlatform::Dependency& dep,
+                                                     const Provider& provider,
+                                                     std::shared_ptr<PackDependency> pDep,
+                                                     int level,
+                                                     const QJsonDocument& doc)
+{
+    try {
+        QJsonArray arr;
+        if (dep.version.length() != 0 && doc.isObject()) {
+            arr.append(doc.object());
+        } else {
+            arr = doc.isObject() ? Json::ensureArray(doc.object(), "data") : doc.array();
+        }
+        pDep->version = provider.mod->loadDependencyVersions(dep, arr);
+        if (!pDep->version.addonId.isValid()) {
+            if (m_loaderType & ModPlatform::Quilt) {  // falback for quilt
+                auto overide = ModPlatform::getOverrideDeps();
+                auto over = std::find_if(overide.cbegin(), overide.cend(),
+                                         [dep, provider](auto o) { return o.provider == provider.name && dep.addonId == o.quilt; });
+                if (over != overide.cend()) {
+                    removePack(dep.addonId);
+                    addTask(prepareDependencyTask({ over->fabric, dep.type }, provider.name, level));
+                    return;
                 }
-                removePack(dep.addonId);
-                qWarning() << "Error while reading mod version empty ";
-                qDebug() << doc;
-                return;
             }
-            pDep->version.is_currently_selected = true;
-            pDep->pack->versions = { pDep->version };
-            pDep->pack->versionsLoaded = true;
-
-        } catch (const JSONValidationError& e) {
             removePack(dep.addonId);
+            qWarning() << "Error while reading mod version empty ";
             qDebug() << doc;
-            qWarning() << "Error while reading mod version: " << e.cause();
             return;
         }
-        if (level == 0) {
-            removePack(dep.addonId);
-            qWarning() << "Dependency cycle exceeded";
-            return;
-        }
-        if (dep.addonId.toString().isEmpty() && !pDep->version.addonId.toString().isEmpty()) {
-            pDep->pack->addonId = pDep->version.addonId;
-            auto dep_ = getOverride({ pDep->version.addonId, pDep->dependency.type }, provider.name);
-            if (dep_.addonId != pDep->version.addonId) {
-                removePack(pDep->version.addonId);
-                addTask(prepareDependencyTask(dep_, provider.name, level));
-            } else
-                addTask(getProjectInfoTask(pDep));
-        }
-        for (auto dep_ : getDependenciesForVersion(pDep->version, provider.name)) {
-            addTask(prepareDependencyTask(dep_, provider.name, level - 1));
-        }
-    };
+        pDep->version.is_currently_selected = true;
+        pDep->pack->versions = { pDep->version };
+        pDep->pack->versionsLoaded = true;
 
-    auto version = provider.api->getDependencyVersion(std::move(args), std::move(callbacks));
-    tasks->addTask(version);
-    return tasks;
+    } catch (const JSONValidationError& e) {
+        removePack(dep.addonId);
+        qDebug() << doc;
+        qWarning() << "Error while reading mod version: " << e.cause();
+        return;
+    }
+    if (level == 0) {
+        removePack(dep.addonId);
+        qWarning() << "Dependency cycle exceeded";
+        return;
+    }
+    if (dep.addonId.toString().isEmpty() && !pDep->version.addonId.toString().isEmpty()) {
+        pDep->pack->addonId = pDep->version.addonId;
+        auto dep_ = getOverride({ pDep->version.addonId, pDep->dependency.type }, provider.name);
+        if (dep_.addonId != pDep->version.addonId) {
+            removePack(pDep->version.addonId);
+            addTask(prepareDependencyTask(dep_, provider.name, level));
+        } else if (auto info = getProjectInfoTask(pDep)) {
+            addTask(info);
+        }
+    }
+    for (auto dep_ : getDependenciesForVersion(pDep->version, provider.name)) {
+        addTask(prepareDependencyTask(dep_, provider.name, level - 1));
+    }
 }
 
 void GetModDependenciesTask::removePack(const QVariant& addonId)
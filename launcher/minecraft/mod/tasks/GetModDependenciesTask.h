@@ -29,11 +29,17 @@
 #include "minecraft/mod/ModFolderModel.h"
 #include "modplatform/ModIndex.h"
 #include "modplatform/ResourceAPI.h"
-#include "tasks/SequentialTask.h"
+#include "tasks/ConcurrentTask.h"
 #include "tasks/Task.h"
 #include "ui/pages/modplatform/ModModel.h"
 
-class GetModDependenciesTask : public SequentialTask {
+/**
+ * Finds the dependencies missing for the selected versions, and theirs, down to a fixed depth.
+ *
+ * All the lookups known so far run in parallel, so a level of the tree is asked for at once. What the APIs answer is
+ * kept for the whole session, so shared libraries are only looked up once however many mods need them.
+ */
+class GetModDependenciesTask : public ConcurrentTask {
     Q_OBJECT
    public:
     using Ptr = shared_qobject_ptr<GetModDependenciesTask>;
@@ -73,6 +79,17 @@ class GetModDependenciesTask : public SequentialTask {
     ModPlatform::Dependency getOverride(const ModPlatform::Dependency&, ModPlatform::ResourceProvider providerName);
     void removePack(const QVariant& addonId);
 
+    void startNext() override;
+
+   private:
+    bool projectInfoLoaded(const Provider& provider, std::shared_ptr<PackDependency> pDep, const QByteArray& response);
+    void dependencyVersionLoaded(const ModPlatform::Dependency& dep,
+                                 const Provider& provider,
+                                 std::shared_ptr<PackDependency> pDep,
+                                 int level,
+                                 const QJsonDocument& doc);
+    QString versionKey(const ModPlatform::Dependency& dep, ModPlatform::ResourceProvider providerName) const;
+
    private:
     QList<std::shared_ptr<PackDependency>> m_pack_dependencies;
     QList<std::shared_ptr<Metadata::ModStruct>> m_mods;
@@ -23,10 +23,8 @@
 
 #include "FileSystem.h"
 #include "Json.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include <QCryptographicHash>
 
@@ -85,51 +83,36 @@ bool processFolder(DataPack& pack, ProcessingLevel level)
 }
 
 bool processZIP(DataPack& pack, ProcessingLevel level)
+{
+    return processZIP(pack, MMCZip::ZipIndex(pack.fileinfo().filePath()), level);
+}
+
+bool processZIP(DataPack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
     auto mcmeta_invalid = [&pack]() {
         qWarning() << "Data pack at" << pack.fileinfo().filePath() << "does not have a valid pack.mcmeta";
         return false;  // the mcmeta is not optional
     };
 
-    if (zip.setCurrentFile("pack.mcmeta")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return mcmeta_invalid();
-        }
+    auto mcmeta = zip.read("pack.mcmeta");
+    if (!mcmeta)
+        return mcmeta_invalid();  // no pack.mcmeta, or it can't be read
+    if (!DataPackUtils::processMCMeta(pack, std::move(*mcmeta)))
+        return mcmeta_invalid();  // mcmeta invalid
 
-        auto data = file.readAll();
-
-        bool mcmeta_result = DataPackUtils::processMCMeta(pack, std::move(data));
-
-        file.close();
-        if (!mcmeta_result) {
-            return mcmeta_invalid();  // mcmeta invalid
-        }
-    } else {
-        return mcmeta_invalid();  // could not set pack.mcmeta as current file.
-    }
-
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/data")) {
+    if (!zip.hasRootFolder("data")) {
         return false;  // data dir does not exists at zip root
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
-    zip.close();
-
     return true;
 }
 
@@ -155,6 +138,14 @@ bool validate(QFileInfo file)
     return DataPackUtils::process(dp, ProcessingLevel::BasicInfoOnly) && dp.valid();
 }
 
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
+{
+    DataPack dp{ file };
+    if (dp.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(dp, zip, ProcessingLevel::BasicInfoOnly) && dp.valid();
+}
+
 }  // namespace DataPackUtils
 
 LocalDataPackParseTask::LocalDataPackParseTask(int token, DataPack& dp) : Task(nullptr, false), m_token(token), m_data_pack(dp) {}
@@ -167,8 +158,16 @@ bool LocalDataPackParseTask::abort()
 
 void LocalDataPackParseTask::executeTask()
 {
-    if (!DataPackUtils::process(m_data_pack))
+    auto cache = m_data_pack.type() == ResourceType::ZIPFILE ? ModDetailsCache::shared() : nullptr;
+    auto path = m_data_pack.fileinfo().absoluteFilePath();
+    if (auto cached = cache ? cache->getPack("datapack", path) : std::nullopt) {
+        m_data_pack.setPackFormat(cached->format);
+        m_data_pack.setDescription(cached->description);
+    } else if (!DataPackUtils::process(m_data_pack)) {
         return;
+    } else if (cache && !m_aborted) {
+        cache->putPack("datapack", path, { m_data_pack.packFormat(), m_data_pack.description() });
+    }
 
     if (m_aborted)
         emitAborted();
@@ -28,6 +28,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace DataPackUtils {
 
 enum class ProcessingLevel { Full, BasicInfoOnly };
@@ -35,12 +39,15 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(DataPack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(DataPack& pack, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(DataPack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(DataPack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processMCMeta(DataPack& pack, QByteArray&& raw_data);
 
 /** Checks whether a file is valid as a data pack or not. */
 bool validate(QFileInfo file);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
 
 }  // namespace DataPackUtils
 
@@ -1,8 +1,6 @@
 #include "LocalModParseTask.h"
 
 #include <qdcss.h>
-#include <quazip/quazip.h>
-#include <quazip/quazipfile.h>
 #include <toml++/toml.h>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -12,7 +10,11 @@
 
 #include "FileSystem.h"
 #include "Json.h"
+#include "MMCZip.h"
 #include "minecraft/mod/ModDetails.h"
+#include "minecraft/mod/ModDetailsCache.h"
+#include "minecraft/mod/ModIconCache.h"
+#include "modplatform/helpers/HashUtils.h"
 #include "settings/INIFile.h"
 
 namespace ModUtils {
@@ -196,6 +198,19 @@ ModDetails ReadMCModTOML(QByteArray contents)
     }
     details.icon_file = logoFile;
 
+    // [[dependencies.modid]], older versions tell whether they're needed with mandatory, newer ones with type
+    if (auto dependencies = tomlData["dependencies"][details.mod_id.toStdString()].as_array()) {
+        for (auto& dependency : *dependencies) {
+            auto table = dependency.as_table();
+            if (!table)
+                continue;
+            auto id = (*table)["modId"].value_or(std::string());
+            bool required = (*table)["mandatory"].value_or(false) || (*table)["type"].value_or(std::string()) == "required";
+            if (required && !id.empty())
+                details.dependencies.append(QString::fromStdString(id));
+        }
+    }
+
     return details;
 }
 
@@ -283,6 +298,11 @@ ModDetails ReadFabricModInfo(QByteArray contents)
                 details.icon_file = icon.toString();
             }
         }
+
+        for (auto id : object.value("depends").toObject().keys())
+            details.dependencies.append(id);
+        for (auto provided : object.value("provides").toArray())
+            details.provides.append(provided.toString());
     }
     return details;
 }
@@ -370,6 +390,19 @@ ModDetails ReadQuiltModInfo(QByteArray contents)
                 details.icon_file = icon.toString();
             }
         }
+
+        // either ids or objects with one, the optional ones don't count
+        auto idOf = [](const QJsonValue& value) {
+            return value.isObject() ? value.toObject().value("id").toString() : value.toString();
+        };
+        for (auto dependency : modInfo.value("depends").toArray()) {
+            if (!dependency.toObject().value("optional").toBool())
+                details.dependencies.append(idOf(dependency));
+        }
+        for (auto provided : modInfo.value("provides").toArray())
+            details.provides.append(idOf(provided));
+        details.dependencies.removeAll({});
+        details.provides.removeAll({});
     }
     return details;
 }
@@ -459,113 +492,82 @@ bool process(Mod& mod, ProcessingLevel level)
     }
 }
 
-bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
+bool processZIP(Mod& mod, ProcessingLevel level)
+{
+    return processZIP(mod, MMCZip::ZipIndex(mod.fileinfo().filePath()), level);
+}
+
+// what the metadata at the root of the archive says
+static bool processZIPMetadata(Mod& mod, const MMCZip::ZipIndex& zip)
 {
     ModDetails details;
 
-    QuaZip zip(mod.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;
 
-    QuaZipFile file(&zip);
+    // the first of these that's there tells what the mod is
+    using Reader = ModDetails (*)(QByteArray);
+    static const std::pair<const char*, Reader> s_readers[] = {
+        { "mcmod.info", ReadMCModInfo },
+        { "quilt.mod.json", ReadQuiltModInfo },
+        { "fabric.mod.json", ReadFabricModInfo },
+        { "forgeversion.properties", ReadForgeInfo },
+    };
 
-    if (zip.setCurrentFile("META-INF/mods.toml")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    if (zip.contains("META-INF/mods.toml")) {
+        auto toml = zip.read("META-INF/mods.toml");
+        if (!toml)
             return false;
-        }
 
-        details = ReadMCModTOML(file.readAll());
-        file.close();
+        details = ReadMCModTOML(*toml);
 
         // to replace ${file.jarVersion} with the actual version, as needed
-        if (details.version == "${file.jarVersion}") {
-            if (zip.setCurrentFile("META-INF/MANIFEST.MF")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    zip.close();
-                    return false;
-                }
-
-                // quick and dirty line-by-line parser
-                auto manifestLines = file.readAll().split('\n');
-                QString manifestVersion = "";
-                for (auto& line : manifestLines) {
-                    if (QString(line).startsWith("Implementation-Version: ")) {
-                        manifestVersion = QString(line).remove("Implementation-Version: ");
-                        break;
-                    }
-                }
+        if (details.version == "${file.jarVersion}" && zip.contains("META-INF/MANIFEST.MF")) {
+            auto manifest = zip.read("META-INF/MANIFEST.MF");
+            if (!manifest)
+                return false;
 
-                // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
-                // also keep with forge's behavior of setting the version to "NONE" if none is found
-                if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
-                    manifestVersion = "NONE";
+            // quick and dirty line-by-line parser
+            auto manifestLines = manifest->split('\n');
+            QString manifestVersion = "";
+            for (auto& line : manifestLines) {
+                if (QString(line).startsWith("Implementation-Version: ")) {
+                    manifestVersion = QString(line).remove("Implementation-Version: ");
+                    break;
                 }
-
-                details.version = manifestVersion;
-
-                file.close();
             }
-        }
 
-        zip.close();
-        mod.setDetails(details);
+            // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
+            // also keep with forge's behavior of setting the version to "NONE" if none is found
+            if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
+                manifestVersion = "NONE";
+            }
 
-        return true;
-    } else if (zip.setCurrentFile("mcmod.info")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
+            details.version = manifestVersion;
         }
 
-        details = ReadMCModInfo(file.readAll());
-        file.close();
-        zip.close();
-
         mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("quilt.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
 
-        details = ReadQuiltModInfo(file.readAll());
-        file.close();
-        zip.close();
-
-        mod.setDetails(details);
         return true;
-    } else if (zip.setCurrentFile("fabric.mod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
-
-        details = ReadFabricModInfo(file.readAll());
-        file.close();
-        zip.close();
+    }
 
-        mod.setDetails(details);
-        return true;
-    } else if (zip.setCurrentFile("forgeversion.properties")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
+    for (auto [name, reader] : s_readers) {
+        if (!zip.contains(name))
+            continue;
+        auto data = zip.read(name);
+        if (!data)
             return false;
-        }
-
-        details = ReadForgeInfo(file.readAll());
-        file.close();
-        zip.close();
 
-        mod.setDetails(details);
+        mod.setDetails(reader(*data));
         return true;
-    } else if (zip.setCurrentFile("META-INF/nil/mappings.json")) {
+    }
+
+    if (zip.contains("META-INF/nil/mappings.json")) {
         // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
         // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
 
         QString foundNilMeta;
-        for (auto& fname : zip.getFileNameList()) {
+        for (auto& fname : zip.names()) {
             // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
             if (fname.endsWith(".nilmod.css") && fname != "nilloader.nilmod.css") {
                 foundNilMeta = fname;
@@ -573,25 +575,95 @@ bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
             }
         }
 
-        if (zip.setCurrentFile(foundNilMeta)) {
-            if (!file.open(QIODevice::ReadOnly)) {
-                zip.close();
+        if (zip.contains(foundNilMeta)) {
+            auto data = zip.read(foundNilMeta);
+            if (!data)
                 return false;
-            }
 
-            details = ReadNilModInfo(file.readAll(), foundNilMeta);
-            file.close();
-            zip.close();
+            details = ReadNilModInfo(*data, foundNilMeta);
 
             mod.setDetails(details);
             return true;
         }
     }
 
-    zip.close();
     return false;  // no valid mod found in archive
 }
 
+// loaders don't look deeper than that either
+static constexpr int s_maxBundleDepth = 3;
+
+// a library bundled without mod metadata can still tell what it is through its maven coordinates
+static bool readMavenInfo(const MMCZip::ZipIndex& zip, BundledMod& bundled)
+{
+    for (auto& name : zip.names()) {
+        if (!name.startsWith("META-INF/maven/") || !name.endsWith("/pom.properties"))
+            continue;
+        auto data = zip.read(name);
+        if (!data)
+            continue;
+        QString group, artifact;
+        for (auto& line : data->split('\n')) {
+            auto text = QString::fromUtf8(line).trimmed();
+            if (text.startsWith("groupId="))
+                group = text.mid(8);
+            else if (text.startsWith("artifactId="))
+                artifact = text.mid(11);
+            else if (text.startsWith("version="))
+                bundled.version = text.mid(8);
+        }
+        if (artifact.isEmpty())
+            continue;
+        bundled.mod_id = group.isEmpty() ? artifact : group + ":" + artifact;
+        bundled.name = artifact;
+        return true;
+    }
+    return false;
+}
+
+// the jars Fabric and Quilt (META-INF/jars) and Forge's JarJar (META-INF/jarjar) bundle, read in place in the outer file
+static void readBundled(const MMCZip::ZipIndex& zip, const QString& prefix, int depth, QList<BundledMod>& bundled)
+{
+    for (auto& name : zip.names()) {
+        if (!name.endsWith(".jar", Qt::CaseInsensitive) || !(name.startsWith("META-INF/jars/") || name.startsWith("META-INF/jarjar/")))
+            continue;
+        MMCZip::ZipIndex inner(zip, name);
+        if (!inner.isValid())
+            continue;
+
+        BundledMod entry;
+        entry.path = prefix + name;
+        Mod mod;
+        if (processZIPMetadata(mod, inner)) {
+            entry.mod_id = mod.details().mod_id;
+            entry.name = mod.details().name;
+            entry.version = mod.details().version;
+        } else if (!readMavenInfo(inner, entry)) {
+            entry.name = name.mid(name.lastIndexOf('/') + 1);
+        }
+        bundled.append(entry);
+
+        if (depth + 1 < s_maxBundleDepth)
+            readBundled(inner, entry.path + '!', depth + 1, bundled);
+    }
+}
+
+bool processZIP(Mod& mod, const MMCZip::ZipIndex& zip, ProcessingLevel level)
+{
+    if (!zip.isValid() || !processZIPMetadata(mod, zip))
+        return false;
+    if (level == ProcessingLevel::Full) {
+        QList<BundledMod> bundled;
+        readBundled(zip, {}, 0, bundled);
+        if (!bundled.isEmpty()) {
+            auto details = mod.details();
+            details.bundled = bundled;
+            mod.setDetails(details);
+        }
+    }
+    return true;
+}
+
 bool processFolder(Mod& mod, [[maybe_unused]] ProcessingLevel level)
 {
     ModDetails details;
@@ -615,29 +687,12 @@ bool processFolder(Mod& mod, [[maybe_unused]] ProcessingLevel level)
 
 bool processLitemod(Mod& mod, [[maybe_unused]] ProcessingLevel level)
 {
-    ModDetails details;
+    auto data = MMCZip::ZipIndex(mod.fileinfo().filePath()).read("litemod.json");
+    if (!data)
+        return false;  // no valid litemod.json found in archive
 
-    QuaZip zip(mod.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
-        return false;
-
-    QuaZipFile file(&zip);
-
-    if (zip.setCurrentFile("litemod.json")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            zip.close();
-            return false;
-        }
-
-        details = ReadLiteModInfo(file.readAll());
-        file.close();
-
-        mod.setDetails(details);
-        return true;
-    }
-    zip.close();
-
-    return false;  // no valid litemod.json found in archive
+    mod.setDetails(ReadLiteModInfo(*data));
+    return true;
 }
 
 /** Checks whether a file is valid as a mod or not. */
@@ -647,83 +702,78 @@ bool validate(QFileInfo file)
     return ModUtils::process(mod, ProcessingLevel::BasicInfoOnly) && mod.valid();
 }
 
-bool processIconPNG(const Mod& mod, QByteArray&& raw_data)
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
 {
-    auto img = QImage::fromData(raw_data);
-    if (!img.isNull()) {
-        mod.setIcon(img);
-    } else {
-        qWarning() << "Failed to parse mod logo:" << mod.iconPath() << "from" << mod.name();
-        return false;
-    }
-    return true;
+    Mod mod{ file };
+    if (mod.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(mod, zip, ProcessingLevel::BasicInfoOnly) && mod.valid();
 }
 
-bool loadIconFile(const Mod& mod)
+QImage readIconImage(const QString& file_path, ResourceType type, const QString& icon_path)
 {
-    if (mod.iconPath().isEmpty()) {
-        qWarning() << "No Iconfile set, be sure to parse the mod first";
-        return false;
-    }
-
-    auto png_invalid = [&mod]() {
-        qWarning() << "Mod at" << mod.fileinfo().filePath() << "does not have a valid icon";
-        return false;
-    };
-
-    switch (mod.type()) {
+    QByteArray data;
+    switch (type) {
         case ResourceType::FOLDER: {
-            QFileInfo icon_info(FS::PathCombine(mod.fileinfo().filePath(), mod.iconPath()));
-            if (icon_info.exists() && icon_info.isFile()) {
-                QFile icon(icon_info.filePath());
-                if (!icon.open(QIODevice::ReadOnly))
-                    return false;
-                auto data = icon.readAll();
-
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data));
-
-                icon.close();
-
-                if (!icon_result) {
-                    return png_invalid();  // icon invalid
-                }
-            }
-            return false;
+            QFile icon(FS::PathCombine(file_path, icon_path));
+            if (!icon.open(QIODevice::ReadOnly))
+                return {};
+            data = icon.readAll();
+            break;
         }
         case ResourceType::ZIPFILE: {
-            QuaZip zip(mod.fileinfo().filePath());
-            if (!zip.open(QuaZip::mdUnzip))
-                return false;
+            auto icon = MMCZip::ZipIndex(file_path).read(icon_path);
+            if (!icon) {
+                qWarning() << "Mod at" << file_path << "does not have a valid icon";
+                return {};
+            }
+            data = std::move(*icon);
+            break;
+        }
+        case ResourceType::LITEMOD:
+            return {};  // can lightmods even have icons?
+        default:
+            qWarning() << "Invalid type for mod, can not load icon.";
+            return {};
+    }
 
-            QuaZipFile file(&zip);
+    auto image = QImage::fromData(data);
+    if (image.isNull())
+        qWarning() << "Failed to parse mod logo:" << icon_path << "from" << file_path;
+    return image;
+}
 
-            if (zip.setCurrentFile(mod.iconPath())) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Failed to open file in zip.";
-                    zip.close();
-                    return png_invalid();
-                }
+QImage loadIconThumbnail(const QString& file_path, ResourceType type, const QString& icon_path)
+{
+    if (icon_path.isEmpty())
+        return {};
 
-                auto data = file.readAll();
+    auto cache = ModIconCache::shared();
+    // a folder has no hash to go by
+    QString hash;
+    if (cache && type == ResourceType::ZIPFILE) {
+        hash = Hashing::cachedHash(file_path, "sha1");
+        auto cached = cache->get(hash);
+        if (!cached.isNull())
+            return cached;
+    }
 
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data));
+    auto thumbnail = ModIconCache::thumbnail(readIconImage(file_path, type, icon_path));
+    if (cache)
+        cache->put(hash, thumbnail);
+    return thumbnail;
+}
 
-                file.close();
-                if (!icon_result) {
-                    return png_invalid();  // icon png invalid
-                }
-            } else {
-                return png_invalid();  // could not set icon as current file.
-            }
-            return false;
-        }
-        case ResourceType::LITEMOD: {
-            return false;  // can lightmods even have icons?
-        }
-        default:
-            qWarning() << "Invalid type for mod, can not load icon.";
-            return false;
+bool loadIconFile(const Mod& mod)
+{
+    if (mod.iconPath().isEmpty()) {
+        qWarning() << "No Iconfile set, be sure to parse the mod first";
+        return false;
     }
+
+    auto icon = loadIconThumbnail(mod.fileinfo().filePath(), mod.type(), mod.iconPath());
+    mod.setIcon(icon);
+    return !icon.isNull();
 }
 
 }  // namespace ModUtils
@@ -740,10 +790,20 @@ bool LocalModParseTask::abort()
 
 void LocalModParseTask::executeTask()
 {
-    Mod mod{ m_modFile };
-    ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
+    auto cache = ModDetailsCache::shared();
+    // what's inside a folder can change without the folder itself looking any different
+    bool cacheable = cache && m_type != ResourceType::FOLDER;
+    if (auto cached = cacheable ? cache->get(m_modFile.filePath()) : std::nullopt) {
+        m_result->details = *cached;
+    } else {
+        Mod mod{ m_modFile };
+        bool parsed = ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
 
-    m_result->details = mod.details();
+        m_result->details = mod.details();
+        // a failure may well be a jar that's still being written, try again next time
+        if (parsed && cacheable && !m_aborted)
+            cache->put(m_modFile.filePath(), m_result->details);
+    }
 
     if (m_aborted)
         emit finished();
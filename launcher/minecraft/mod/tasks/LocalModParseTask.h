@@ -8,6 +8,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace ModUtils {
 
 ModDetails ReadFabricModInfo(QByteArray contents);
@@ -20,13 +24,20 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(Mod& mod, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 bool processLitemod(Mod& mod, ProcessingLevel level = ProcessingLevel::Full);
 
 /** Checks whether a file is valid as a mod or not. */
 bool validate(QFileInfo file);
-
-bool processIconPNG(const Mod& mod, QByteArray&& raw_data);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
+
+/** Reads the icon image out of a mod, at full size. */
+QImage readIconImage(const QString& file_path, ResourceType type, const QString& icon_path);
+/** Gets the thumbnail of a mod's icon, from the icon cache if it's there. Safe to call from any thread. */
+QImage loadIconThumbnail(const QString& file_path, ResourceType type, const QString& icon_path);
+/** Loads the icon of the mod into it, reading it right away. */
 bool loadIconFile(const Mod& mod);
 }  // namespace ModUtils
 
@@ -20,10 +20,8 @@
 
 #include "FileSystem.h"
 #include "Json.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include <QCryptographicHash>
 
@@ -105,46 +103,33 @@ bool processFolder(ResourcePack& pack, ProcessingLevel level)
 }
 
 bool processZIP(ResourcePack& pack, ProcessingLevel level)
+{
+    return processZIP(pack, MMCZip::ZipIndex(pack.fileinfo().filePath()), level);
+}
+
+bool processZIP(ResourcePack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
     auto mcmeta_invalid = [&pack]() {
         qWarning() << "Resource pack at" << pack.fileinfo().filePath() << "does not have a valid pack.mcmeta";
         return false;  // the mcmeta is not optional
     };
 
-    if (zip.setCurrentFile("pack.mcmeta")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return mcmeta_invalid();
-        }
-
-        auto data = file.readAll();
-
-        bool mcmeta_result = ResourcePackUtils::processMCMeta(pack, std::move(data));
-
-        file.close();
-        if (!mcmeta_result) {
-            return mcmeta_invalid();  // mcmeta invalid
-        }
-    } else {
-        return mcmeta_invalid();  // could not set pack.mcmeta as current file.
-    }
+    auto mcmeta = zip.read("pack.mcmeta");
+    if (!mcmeta)
+        return mcmeta_invalid();  // no pack.mcmeta, or it can't be read
+    if (!ResourcePackUtils::processMCMeta(pack, std::move(*mcmeta)))
+        return mcmeta_invalid();  // mcmeta invalid
 
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/assets")) {
+    if (!zip.hasRootFolder("assets")) {
         return false;  // assets dir does not exists at zip root
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
@@ -153,28 +138,12 @@ bool processZIP(ResourcePack& pack, ProcessingLevel level)
         return true;  // the png is optional
     };
 
-    if (zip.setCurrentFile("pack.png")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return png_invalid();
-        }
-
-        auto data = file.readAll();
-
-        bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
-
-        file.close();
-        zip.close();
-        if (!pack_png_result) {
-            return png_invalid();  // pack.png invalid
-        }
-    } else {
-        zip.close();
-        return png_invalid();  // could not set pack.mcmeta as current file.
-    }
+    auto png = zip.read("pack.png");
+    if (!png)
+        return png_invalid();  // no pack.png, or it can't be read
+    if (!ResourcePackUtils::processPackPNG(pack, std::move(*png)))
+        return png_invalid();  // pack.png invalid
 
-    zip.close();
     return true;
 }
 
@@ -235,29 +204,11 @@ bool processPackPNG(const ResourcePack& pack)
             return false;  // not processed correctly; https://github.com/PrismLauncher/PrismLauncher/issues/1740
         }
         case ResourceType::ZIPFILE: {
-            QuaZip zip(pack.fileinfo().filePath());
-            if (!zip.open(QuaZip::mdUnzip))
-                return false;  // can't open zip file
-
-            QuaZipFile file(&zip);
-            if (zip.setCurrentFile("pack.png")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Failed to open file in zip.";
-                    zip.close();
-                    return png_invalid();
-                }
-
-                auto data = file.readAll();
-
-                bool pack_png_result = ResourcePackUtils::processPackPNG(pack, std::move(data));
-
-                file.close();
-                if (!pack_png_result) {
-                    return png_invalid();  // pack.png invalid
-                }
-            } else {
-                return png_invalid();  // could not set pack.mcmeta as current file.
-            }
+            auto png = MMCZip::ZipIndex(pack.fileinfo().filePath()).read("pack.png");
+            if (!png)
+                return png_invalid();  // no pack.png, or it can't be read
+            if (!ResourcePackUtils::processPackPNG(pack, std::move(*png)))
+                return png_invalid();  // pack.png invalid
             return false;  // not processed correctly; https://github.com/PrismLauncher/PrismLauncher/issues/1740
         }
         default:
@@ -272,6 +223,14 @@ bool validate(QFileInfo file)
     return ResourcePackUtils::process(rp, ProcessingLevel::BasicInfoOnly) && rp.valid();
 }
 
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
+{
+    ResourcePack rp{ file };
+    if (rp.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(rp, zip, ProcessingLevel::BasicInfoOnly) && rp.valid();
+}
+
 }  // namespace ResourcePackUtils
 
 LocalResourcePackParseTask::LocalResourcePackParseTask(int token, ResourcePack& rp)
@@ -286,8 +245,17 @@ bool LocalResourcePackParseTask::abort()
 
 void LocalResourcePackParseTask::executeTask()
 {
-    if (!ResourcePackUtils::process(m_resource_pack))
+    // the pack.png is only read once the pack is shown
+    auto cache = m_resource_pack.type() == ResourceType::ZIPFILE ? ModDetailsCache::shared() : nullptr;
+    auto path = m_resource_pack.fileinfo().absoluteFilePath();
+    if (auto cached = cache ? cache->getPack("resourcepack", path) : std::nullopt) {
+        m_resource_pack.setPackFormat(cached->format);
+        m_resource_pack.setDescription(cached->description);
+    } else if (!ResourcePackUtils::process(m_resource_pack, ProcessingLevel::BasicInfoOnly)) {
         return;
+    } else if (cache && !m_aborted) {
+        cache->putPack("resourcepack", path, { m_resource_pack.packFormat(), m_resource_pack.description() });
+    }
 
     if (m_aborted)
         emitAborted();
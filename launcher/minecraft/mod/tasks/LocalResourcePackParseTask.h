@@ -25,6 +25,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace ResourcePackUtils {
 
 enum class ProcessingLevel { Full, BasicInfoOnly };
@@ -32,6 +36,7 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(ResourcePack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(ResourcePack& pack, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(ResourcePack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(ResourcePack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processMCMeta(ResourcePack& pack, QByteArray&& raw_data);
@@ -42,6 +47,8 @@ bool processPackPNG(const ResourcePack& pack);
 
 /** Checks whether a file is valid as a resource pack or not. */
 bool validate(QFileInfo file);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
 }  // namespace ResourcePackUtils
 
 class LocalResourcePackParseTask : public Task {
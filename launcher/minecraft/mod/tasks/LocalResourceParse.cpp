@@ -20,9 +20,13 @@
  */
 
 #include <QObject>
+#include <QSet>
 
 #include "LocalResourceParse.h"
 
+#include "MMCZip.h"
+#include "tasks/Executor.h"
+
 #include "LocalDataPackParseTask.h"
 #include "LocalModParseTask.h"
 #include "LocalResourcePackParseTask.h"
@@ -39,26 +43,54 @@ static const QMap<PackedResourceType, QString> s_packed_type_names = { { PackedR
                                                                        { PackedResourceType::UNKNOWN, QObject::tr("unknown") } };
 
 namespace ResourceUtils {
+
+namespace {
+// what the entries of an archive say it may be, the parsers have the final word
+struct Signatures {
+    bool mod = false;
+    bool mcmeta = false;
+    bool packTxt = false;
+    bool levelDat = false;
+};
+
+Signatures readSignatures(const MMCZip::ZipIndex& zip)
+{
+    static const QSet<QString> s_mod_files = { "META-INF/mods.toml",      "mcmod.info",  "quilt.mod.json", "fabric.mod.json",
+                                               "forgeversion.properties", "litemod.json", "META-INF/nil/mappings.json" };
+    Signatures found;
+    for (auto const& name : zip.names()) {
+        found.mod |= s_mod_files.contains(name);
+        found.mcmeta |= name == "pack.mcmeta";
+        found.packTxt |= name == "pack.txt";
+        found.levelDat |= name.endsWith("/level.dat");
+    }
+    return found;
+}
+}  // namespace
+
 PackedResourceType identify(QFileInfo file)
 {
     if (file.exists() && file.isFile()) {
-        if (ModUtils::validate(file)) {
+        // every kind is checked against the same index, and only if its entries are there
+        MMCZip::ZipIndex zip(file.absoluteFilePath());
+        auto found = zip.isValid() ? readSignatures(zip) : Signatures{};
+        if (found.mod && ModUtils::validate(file, zip)) {
             // mods can contain resource and data packs so they must be tested first
             qDebug() << file.fileName() << "is a mod";
             return PackedResourceType::Mod;
-        } else if (ResourcePackUtils::validate(file)) {
+        } else if (found.mcmeta && zip.hasRootFolder("assets") && ResourcePackUtils::validate(file, zip)) {
             qDebug() << file.fileName() << "is a resource pack";
             return PackedResourceType::ResourcePack;
-        } else if (TexturePackUtils::validate(file)) {
+        } else if (found.packTxt && TexturePackUtils::validate(file, zip)) {
             qDebug() << file.fileName() << "is a pre 1.6 texture pack";
             return PackedResourceType::TexturePack;
-        } else if (DataPackUtils::validate(file)) {
+        } else if (found.mcmeta && zip.hasRootFolder("data") && DataPackUtils::validate(file, zip)) {
             qDebug() << file.fileName() << "is a data pack";
             return PackedResourceType::DataPack;
-        } else if (WorldSaveUtils::validate(file)) {
+        } else if (found.levelDat && WorldSaveUtils::validate(file, zip)) {
             qDebug() << file.fileName() << "is a world save";
             return PackedResourceType::WorldSave;
-        } else if (ShaderPackUtils::validate(file)) {
+        } else if (zip.hasRootFolder("shaders") && ShaderPackUtils::validate(file, zip)) {
             qDebug() << file.fileName() << "is a shader pack";
             return PackedResourceType::ShaderPack;
         } else {
@@ -70,6 +102,20 @@ PackedResourceType identify(QFileInfo file)
     return PackedResourceType::UNKNOWN;
 }
 
+QList<PackedResourceType> identify(const QList<QFileInfo>& files)
+{
+    QList<QFuture<PackedResourceType>> identifying;
+    for (auto const& file : files)
+        identifying.append(Executor::instance()->run(Executor::Priority::Interactive, [file] { return identify(file); }));
+
+    QList<PackedResourceType> types;
+    for (auto& future : identifying) {
+        Executor::instance()->waitFor(future);
+        types.append(future.result());
+    }
+    return types;
+}
+
 QString getPackedTypeName(PackedResourceType type)
 {
     return s_packed_type_names.constFind(type).value();
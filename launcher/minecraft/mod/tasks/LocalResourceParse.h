@@ -33,5 +33,7 @@ static const std::set<PackedResourceType> ValidResourceTypes = { PackedResourceT
                                                                  PackedResourceType::TexturePack, PackedResourceType::ShaderPack,
                                                                  PackedResourceType::WorldSave,   PackedResourceType::Mod };
 PackedResourceType identify(QFileInfo file);
+/// identify all of `files` at once, in parallel, the types come in the same order
+QList<PackedResourceType> identify(const QList<QFileInfo>& files);
 QString getPackedTypeName(PackedResourceType type);
 }  // namespace ResourceUtils
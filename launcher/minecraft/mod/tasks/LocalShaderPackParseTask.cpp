@@ -22,10 +22,8 @@
 #include "LocalShaderPackParseTask.h"
 
 #include "FileSystem.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 namespace ShaderPackUtils {
 
@@ -60,28 +58,26 @@ bool processFolder(ShaderPack& pack, ProcessingLevel level)
 }
 
 bool processZIP(ShaderPack& pack, ProcessingLevel level)
+{
+    return processZIP(pack, MMCZip::ZipIndex(pack.fileinfo().filePath()), level);
+}
+
+bool processZIP(ShaderPack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;  // can't open zip file
 
-    QuaZipFile file(&zip);
-
-    QuaZipDir zipDir(&zip);
-    if (!zipDir.exists("/shaders")) {
+    if (!zip.hasRootFolder("shaders")) {
         return false;  // assets dir does not exists at zip root
     }
     pack.setPackFormat(ShaderPackFormat::VALID);
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
-    zip.close();
-
     return true;
 }
 
@@ -91,6 +87,14 @@ bool validate(QFileInfo file)
     return ShaderPackUtils::process(sp, ProcessingLevel::BasicInfoOnly) && sp.valid();
 }
 
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
+{
+    ShaderPack sp{ file };
+    if (sp.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(sp, zip, ProcessingLevel::BasicInfoOnly) && sp.valid();
+}
+
 }  // namespace ShaderPackUtils
 
 LocalShaderPackParseTask::LocalShaderPackParseTask(int token, ShaderPack& sp) : Task(nullptr, false), m_token(token), m_shader_pack(sp) {}
@@ -103,8 +107,15 @@ bool LocalShaderPackParseTask::abort()
 
 void LocalShaderPackParseTask::executeTask()
 {
-    if (!ShaderPackUtils::process(m_shader_pack))
+    auto cache = m_shader_pack.type() == ResourceType::ZIPFILE ? ModDetailsCache::shared() : nullptr;
+    auto path = m_shader_pack.fileinfo().absoluteFilePath();
+    if (cache && cache->getPack("shaderpack", path)) {
+        m_shader_pack.setPackFormat(ShaderPackFormat::VALID);
+    } else if (!ShaderPackUtils::process(m_shader_pack)) {
         return;
+    } else if (cache && !m_aborted) {
+        cache->putPack("shaderpack", path, {});
+    }
 
     if (m_aborted)
         emitAborted();
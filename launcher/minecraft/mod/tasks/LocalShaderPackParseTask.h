@@ -28,6 +28,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace ShaderPackUtils {
 
 enum class ProcessingLevel { Full, BasicInfoOnly };
@@ -35,10 +39,13 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(ShaderPack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(ShaderPack& pack, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(ShaderPack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(ShaderPack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 /** Checks whether a file is valid as a shader pack or not. */
 bool validate(QFileInfo file);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
 }  // namespace ShaderPackUtils
 
 class LocalShaderPackParseTask : public Task {
@@ -20,9 +20,8 @@
 #include "LocalTexturePackParseTask.h"
 
 #include "FileSystem.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
+#include "minecraft/mod/ModDetailsCache.h"
 
 #include <QCryptographicHash>
 
@@ -88,57 +87,32 @@ bool processFolder(TexturePack& pack, ProcessingLevel level)
 }
 
 bool processZIP(TexturePack& pack, ProcessingLevel level)
+{
+    return processZIP(pack, MMCZip::ZipIndex(pack.fileinfo().filePath()), level);
+}
+
+bool processZIP(TexturePack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level)
 {
     Q_ASSERT(pack.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(pack.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;
 
-    QuaZipFile file(&zip);
-
-    if (zip.setCurrentFile("pack.txt")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
-            return false;
-        }
-
-        auto data = file.readAll();
-
-        bool packTXT_result = TexturePackUtils::processPackTXT(pack, std::move(data));
-
-        file.close();
-        if (!packTXT_result) {
+    if (zip.contains("pack.txt")) {
+        auto txt = zip.read("pack.txt");
+        if (!txt || !TexturePackUtils::processPackTXT(pack, std::move(*txt)))
             return false;
-        }
     }
 
-    if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
+    if (level == ProcessingLevel::BasicInfoOnly)
         return true;
-    }
 
-    if (zip.setCurrentFile("pack.png")) {
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file in zip.";
-            zip.close();
+    if (zip.contains("pack.png")) {
+        auto png = zip.read("pack.png");
+        if (!png || !TexturePackUtils::processPackPNG(pack, std::move(*png)))
             return false;
-        }
-
-        auto data = file.readAll();
-
-        bool packPNG_result = TexturePackUtils::processPackPNG(pack, std::move(data));
-
-        file.close();
-        zip.close();
-        if (!packPNG_result) {
-            return false;
-        }
     }
 
-    zip.close();
-
     return true;
 }
 
@@ -189,31 +163,11 @@ bool processPackPNG(const TexturePack& pack)
             return false;
         }
         case ResourceType::ZIPFILE: {
-            QuaZip zip(pack.fileinfo().filePath());
-            if (!zip.open(QuaZip::mdUnzip))
-                return false;  // can't open zip file
-
-            QuaZipFile file(&zip);
-            if (zip.setCurrentFile("pack.png")) {
-                if (!file.open(QIODevice::ReadOnly)) {
-                    qCritical() << "Failed to open file in zip.";
-                    zip.close();
-                    return png_invalid();
-                }
-
-                auto data = file.readAll();
-
-                bool pack_png_result = TexturePackUtils::processPackPNG(pack, std::move(data));
-
-                file.close();
-                if (!pack_png_result) {
-                    zip.close();
-                    return png_invalid();  // pack.png invalid
-                }
-            } else {
-                zip.close();
-                return png_invalid();  // could not set pack.mcmeta as current file.
-            }
+            auto png = MMCZip::ZipIndex(pack.fileinfo().filePath()).read("pack.png");
+            if (!png)
+                return png_invalid();  // no pack.png, or it can't be read
+            if (!TexturePackUtils::processPackPNG(pack, std::move(*png)))
+                return png_invalid();  // pack.png invalid
             return false;
         }
         default:
@@ -228,6 +182,14 @@ bool validate(QFileInfo file)
     return TexturePackUtils::process(rp, ProcessingLevel::BasicInfoOnly) && rp.valid();
 }
 
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
+{
+    TexturePack rp{ file };
+    if (rp.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(rp, zip, ProcessingLevel::BasicInfoOnly) && rp.valid();
+}
+
 }  // namespace TexturePackUtils
 
 LocalTexturePackParseTask::LocalTexturePackParseTask(int token, TexturePack& rp) : Task(nullptr, false), m_token(token), m_texture_pack(rp)
@@ -241,8 +203,16 @@ bool LocalTexturePackParseTask::abort()
 
 void LocalTexturePackParseTask::executeTask()
 {
-    if (!TexturePackUtils::process(m_texture_pack))
+    // the pack.png is only read once the pack is shown
+    auto cache = m_texture_pack.type() == ResourceType::ZIPFILE ? ModDetailsCache::shared() : nullptr;
+    auto path = m_texture_pack.fileinfo().absoluteFilePath();
+    if (auto cached = cache ? cache->getPack("texturepack", path) : std::nullopt) {
+        m_texture_pack.setDescription(cached->description);
+    } else if (!TexturePackUtils::process(m_texture_pack, ProcessingLevel::BasicInfoOnly)) {
         return;
+    } else if (cache && !m_aborted) {
+        cache->putPack("texturepack", path, { 0, m_texture_pack.description() });
+    }
 
     if (m_aborted)
         emitAborted();
@@ -26,6 +26,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace TexturePackUtils {
 
 enum class ProcessingLevel { Full, BasicInfoOnly };
@@ -33,6 +37,7 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(TexturePack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(TexturePack& pack, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(TexturePack& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(TexturePack& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processPackTXT(TexturePack& pack, QByteArray&& raw_data);
@@ -43,6 +48,8 @@ bool processPackPNG(const TexturePack& pack);
 
 /** Checks whether a file is valid as a texture pack or not. */
 bool validate(QFileInfo file);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
 }  // namespace TexturePackUtils
 
 class LocalTexturePackParseTask : public Task {
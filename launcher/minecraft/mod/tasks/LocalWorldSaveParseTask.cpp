@@ -23,10 +23,7 @@
 #include "LocalWorldSaveParseTask.h"
 
 #include "FileSystem.h"
-
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
+#include "MMCZip.h"
 
 #include <QDir>
 #include <QFileInfo>
@@ -105,39 +102,36 @@ bool processFolder(WorldSave& save, ProcessingLevel level)
 ///             QString <name of folder containing level.dat>,
 ///             bool <saves folder found>
 ///         )
-static std::tuple<bool, QString, bool> contains_level_dat(QuaZip& zip)
+static std::tuple<bool, QString, bool> contains_level_dat(const MMCZip::ZipIndex& zip)
 {
-    bool saves = false;
-    QuaZipDir zipDir(&zip);
-    if (zipDir.exists("/saves")) {
-        saves = true;
-        zipDir.cd("/saves");
-    }
+    bool saves = zip.hasRootFolder("saves");
+    QString prefix = saves ? "saves/" : "";
 
-    for (auto const& entry : zipDir.entryList()) {
-        zipDir.cd(entry);
-        if (zipDir.exists("level.dat")) {
-            return std::make_tuple(true, entry, saves);
-        }
-        zipDir.cd("..");
+    QString found;
+    for (auto const& name : zip.names()) {
+        if (!name.startsWith(prefix) || !name.endsWith("/level.dat"))
+            continue;
+        auto folder = name.mid(prefix.size(), name.size() - prefix.size() - 10);
+        if (!folder.isEmpty() && !folder.contains('/') && (found.isEmpty() || folder < found))
+            found = folder;
     }
-    return std::make_tuple(false, "", saves);
+    return std::make_tuple(!found.isEmpty(), found, saves);
 }
 
 bool processZIP(WorldSave& save, ProcessingLevel level)
+{
+    return processZIP(save, MMCZip::ZipIndex(save.fileinfo().filePath()), level);
+}
+
+bool processZIP(WorldSave& save, const MMCZip::ZipIndex& zip, ProcessingLevel level)
 {
     Q_ASSERT(save.type() == ResourceType::ZIPFILE);
 
-    QuaZip zip(save.fileinfo().filePath());
-    if (!zip.open(QuaZip::mdUnzip))
+    if (!zip.isValid())
         return false;  // can't open zip file
 
     auto [found, save_dir_name, found_saves_dir] = contains_level_dat(zip);
 
-    if (save_dir_name.endsWith("/")) {
-        save_dir_name.chop(1);
-    }
-
     if (!found) {
         return false;
     }
@@ -151,14 +145,11 @@ bool processZIP(WorldSave& save, ProcessingLevel level)
     }
 
     if (level == ProcessingLevel::BasicInfoOnly) {
-        zip.close();
         return true;  // only need basic info already checked
     }
 
     // reserved for more intensive processing
 
-    zip.close();
-
     return true;
 }
 
@@ -168,6 +159,14 @@ bool validate(QFileInfo file)
     return WorldSaveUtils::process(sp, ProcessingLevel::BasicInfoOnly) && sp.valid();
 }
 
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip)
+{
+    WorldSave sp{ file };
+    if (sp.type() != ResourceType::ZIPFILE)
+        return validate(file);
+    return processZIP(sp, zip, ProcessingLevel::BasicInfoOnly) && sp.valid();
+}
+
 }  // namespace WorldSaveUtils
 
 LocalWorldSaveParseTask::LocalWorldSaveParseTask(int token, WorldSave& save) : Task(nullptr, false), m_token(token), m_save(save) {}
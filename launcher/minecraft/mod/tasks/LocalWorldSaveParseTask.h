@@ -28,6 +28,10 @@
 
 #include "tasks/Task.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace WorldSaveUtils {
 
 enum class ProcessingLevel { Full, BasicInfoOnly };
@@ -35,9 +39,12 @@ enum class ProcessingLevel { Full, BasicInfoOnly };
 bool process(WorldSave& save, ProcessingLevel level = ProcessingLevel::Full);
 
 bool processZIP(WorldSave& pack, ProcessingLevel level = ProcessingLevel::Full);
+bool processZIP(WorldSave& pack, const MMCZip::ZipIndex& zip, ProcessingLevel level = ProcessingLevel::Full);
 bool processFolder(WorldSave& pack, ProcessingLevel level = ProcessingLevel::Full);
 
 bool validate(QFileInfo file);
+/** The same, with the file already indexed, for checking it against several kinds. */
+bool validate(QFileInfo file, const MMCZip::ZipIndex& zip);
 
 }  // namespace WorldSaveUtils
 
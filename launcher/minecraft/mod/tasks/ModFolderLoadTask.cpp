@@ -117,10 +117,7 @@ void ModFolderLoadTask::executeTask()
 
 void ModFolderLoadTask::getFromMetadata()
 {
-    m_index_dir.refresh();
-    for (auto entry : m_index_dir.entryList(QDir::Files)) {
-        auto metadata = Metadata::get(m_index_dir, entry);
-
+    for (auto metadata : Metadata::getAll(m_index_dir)) {
         if (!metadata.isValid()) {
             continue;
         }
@@ -0,0 +1,46 @@
+#include "ResourceFolderRescanTask.h"
+
+#include <QThread>
+
+ResourceFolderRescanTask::ResourceFolderRescanTask(QDir dir,
+                                                   QHash<QString, Snapshot> known,
+                                                   std::function<Resource::Ptr(QFileInfo const&)> create_function)
+    : Task(nullptr, false)
+    , m_dir(dir)
+    , m_known(std::move(known))
+    , m_result(new Result)
+    , m_create_func(std::move(create_function))
+    , m_thread_to_spawn_into(thread())
+{}
+
+void ResourceFolderRescanTask::executeTask()
+{
+    if (thread() != m_thread_to_spawn_into)
+        connect(this, &Task::finished, this->thread(), &QThread::quit);
+
+    auto gone = m_known;
+
+    m_dir.refresh();
+    for (auto entry : m_dir.entryInfoList()) {
+        if (m_aborted)
+            break;
+
+        auto known = m_known.constFind(entry.fileName());
+        bool is_known = known != m_known.constEnd();
+        if (is_known) {
+            gone.remove(entry.fileName());
+            if (known->size == entry.size() && known->modified == entry.lastModified())
+                continue;
+        }
+
+        auto resource = m_create_func(entry);
+        resource->moveToThread(m_thread_to_spawn_into);
+        (is_known ? m_result->changed : m_result->added).insert(resource->internal_id(), resource);
+    }
+    m_result->removed = gone.keys();
+
+    if (m_aborted)
+        emit finished();
+    else
+        emitSucceeded();
+}
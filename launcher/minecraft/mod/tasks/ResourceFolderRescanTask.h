@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+
+#include <functional>
+#include <memory>
+
+#include "minecraft/mod/Resource.h"
+
+#include "tasks/Task.h"
+
+/** Finds what changed in a folder since its files were last looked at.
+ *
+ *  Only stats the files. New resources are made just for the files that appeared or changed since the snapshot, so
+ *  the model can keep the ones it has, along with everything already parsed about them.
+ */
+class ResourceFolderRescanTask : public Task {
+    Q_OBJECT
+   public:
+    /** What a file looked like when its resource was made. */
+    struct Snapshot {
+        qint64 size = 0;
+        QDateTime modified;
+    };
+    struct Result {
+        QMap<QString, Resource::Ptr> added;
+        QMap<QString, Resource::Ptr> changed;
+        QStringList removed;
+    };
+    using ResultPtr = std::shared_ptr<Result>;
+
+    [[nodiscard]] ResultPtr result() const { return m_result; }
+
+   public:
+    /** `known` maps the file names the model has resources for to their snapshots. */
+    ResourceFolderRescanTask(QDir dir, QHash<QString, Snapshot> known, std::function<Resource::Ptr(QFileInfo const&)> create_function);
+
+    [[nodiscard]] bool canAbort() const override { return true; }
+    bool abort() override
+    {
+        m_aborted.store(true);
+        return true;
+    }
+
+    void executeTask() override;
+
+   private:
+    QDir m_dir;
+    QHash<QString, Snapshot> m_known;
+    ResultPtr m_result;
+
+    std::atomic<bool> m_aborted = false;
+
+    std::function<Resource::Ptr(QFileInfo const&)> m_create_func;
+
+    /** This is the thread in which we should put new resource objects */
+    QThread* m_thread_to_spawn_into;
+};
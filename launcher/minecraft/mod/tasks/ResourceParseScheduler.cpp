@@ -0,0 +1,148 @@
+#include "ResourceParseScheduler.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStorageInfo>
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+#include "PerfCounters.h"
+
+ResourceParseScheduler* ResourceParseScheduler::instance()
+{
+    static auto* scheduler = new ResourceParseScheduler;
+    return scheduler;
+}
+
+ResourceParseScheduler::ResourceParseScheduler(int max_per_device, QObject* parent)
+    : QObject(parent), m_max_per_device(std::max(1, max_per_device))
+{
+    // parsing is mostly waiting on the disk, more threads than cores doesn't help
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+ResourceParseScheduler::~ResourceParseScheduler()
+{
+    {
+        QMutexLocker locker(&m_lock);
+        m_queue.clear();
+    }
+    m_pool.waitForDone();
+}
+
+void ResourceParseScheduler::setMaxPerDevice(int max_per_device)
+{
+    QMutexLocker locker(&m_lock);
+    m_max_per_device = std::max(1, max_per_device);
+    dispatch();
+}
+
+QString ResourceParseScheduler::deviceOf(const QString& path)
+{
+    auto dir = QFileInfo(path).absolutePath();
+    auto it = m_devices.constFind(dir);
+    if (it != m_devices.constEnd())
+        return *it;
+    auto device = QStorageInfo(dir).rootPath();
+    m_devices.insert(dir, device);
+    return device;
+}
+
+Task::Ptr ResourceParseScheduler::schedule(QObject* owner, const QString& path, Task::Ptr task)
+{
+    QMutexLocker locker(&m_lock);
+    Task::Ptr replaced;
+    auto same_file = std::find_if(m_queue.begin(), m_queue.end(), [&](const Job& job) { return job.owner == owner && job.path == path; });
+    if (same_file != m_queue.end()) {
+        // it'd parse what's about to be parsed again anyway
+        replaced = same_file->task;
+        same_file->task = std::move(task);
+    } else {
+        m_queue.append({ owner, path, deviceOf(path), std::move(task) });
+    }
+    dispatch();
+    return replaced;
+}
+
+void ResourceParseScheduler::prioritize(QObject* owner, const QStringList& paths)
+{
+    QMutexLocker locker(&m_lock);
+    QList<Job> front;
+    for (const auto& path : paths) {
+        auto it = std::find_if(m_queue.begin(), m_queue.end(), [&](const Job& job) { return job.owner == owner && job.path == path; });
+        if (it != m_queue.end()) {
+            front.append(*it);
+            m_queue.erase(it);
+        }
+    }
+    m_queue = front + m_queue;
+}
+
+bool ResourceParseScheduler::unschedule(Task* task)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = std::find_if(m_queue.begin(), m_queue.end(), [&](const Job& job) { return job.task.get() == task; });
+    if (it == m_queue.end())
+        return false;
+    m_queue.erase(it);
+    return true;
+}
+
+void ResourceParseScheduler::cancel(QObject* owner)
+{
+    QMutexLocker locker(&m_lock);
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [&](const Job& job) { return job.owner == owner; }), m_queue.end());
+
+    auto owned = [&](const Job& job) { return job.owner == owner; };
+    for (auto& job : m_running) {
+        if (owned(job))
+            job.task->abort();
+    }
+    // the tasks may well hold on to resources of the owner
+    while (std::any_of(m_running.begin(), m_running.end(), owned))
+        m_job_finished.wait(&m_lock);
+}
+
+int ResourceParseScheduler::pendingCount(QObject* owner)
+{
+    QMutexLocker locker(&m_lock);
+    auto owned = [&](const Job& job) { return job.owner == owner; };
+    auto waiting = std::count_if(m_queue.begin(), m_queue.end(), owned);
+    return static_cast<int>(waiting + std::count_if(m_running.begin(), m_running.end(), owned));
+}
+
+void ResourceParseScheduler::dispatch()
+{
+    for (auto it = m_queue.begin(); it != m_queue.end() && m_running.size() < m_pool.maxThreadCount();) {
+        auto& running_here = m_running_per_device[it->device];
+        if (running_here >= m_max_per_device) {
+            // something on a less busy device may be able to go
+            ++it;
+            continue;
+        }
+        running_here++;
+        auto job = *it;
+        it = m_queue.erase(it);
+        m_running.append(job);
+        QtConcurrent::run(&m_pool, [this, job] { run(job); });
+    }
+}
+
+void ResourceParseScheduler::run(Job job)
+{
+    // the parse tasks do all their work right in here
+    QElapsedTimer timer;
+    timer.start();
+    job.task->start();
+    PerfCounters::addDuration(QString("parse.") + job.task->metaObject()->className(), timer.elapsed());
+
+    QMutexLocker locker(&m_lock);
+    m_running_per_device[job.device]--;
+    auto it = std::find_if(m_running.begin(), m_running.end(), [&](const Job& other) { return other.task == job.task; });
+    if (it != m_running.end())
+        m_running.erase(it);
+    m_job_finished.wakeAll();
+    dispatch();
+}
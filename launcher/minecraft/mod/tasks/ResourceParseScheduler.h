@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "tasks/Task.h"
+
+/**
+ * Runs the parse tasks of every resource folder model on a thread pool of its own.
+ *
+ * Opening a big mods folder queues hundreds of archive reads, which used to go through the global pool along with
+ * instance copies, extraction and exports. Here they wait in a queue instead, with no more than a few of them reading
+ * from the same storage device at once, and the files the user is looking at can be moved to the front of it.
+ *
+ * A task is queued for the file it parses and the model it reports to. Queuing another one for the same file replaces
+ * the one still waiting, and cancel() drops everything of a model that's going away.
+ *
+ * Queued tasks are started on a worker thread and should do their work in executeTask(), like the Local*ParseTasks do,
+ * so listen to them with queued connections.
+ */
+class ResourceParseScheduler : public QObject {
+    Q_OBJECT
+   public:
+    static ResourceParseScheduler* instance();
+
+    explicit ResourceParseScheduler(int max_per_device = 2, QObject* parent = nullptr);
+    ~ResourceParseScheduler() override;
+
+    void setMaxPerDevice(int max_per_device);
+
+    /// queue `task` parsing `path` for `owner`, returns the task still waiting for the same file it replaced, if any
+    auto schedule(QObject* owner, const QString& path, Task::Ptr task) -> Task::Ptr;
+    /// move the waiting tasks of `owner` for these files to the front, in that order
+    void prioritize(QObject* owner, const QStringList& paths);
+    /// drop `task` if it's still waiting, returns whether it was
+    auto unschedule(Task* task) -> bool;
+    /// drop what `owner` has waiting, abort what it has running and wait for that to stop
+    void cancel(QObject* owner);
+
+    [[nodiscard]] auto pendingCount(QObject* owner) -> int;
+    [[nodiscard]] int activeThreadCount() const { return m_pool.activeThreadCount(); }
+
+   private:
+    struct Job {
+        QObject* owner = nullptr;
+        QString path;
+        QString device;
+        Task::Ptr task;
+    };
+
+    // start as many queued jobs as the limits allow, with m_lock held
+    void dispatch();
+    void run(Job job);
+    auto deviceOf(const QString& path) -> QString;
+
+   private:
+    QThreadPool m_pool;
+    int m_max_per_device;
+
+    QMutex m_lock;
+    QWaitCondition m_job_finished;
+    QList<Job> m_queue;
+    QList<Job> m_running;
+    QHash<QString, int> m_running_per_device;
+    // storage device of each folder we queued a file from, asking the system is slow
+    QHash<QString, QString> m_devices;
+};
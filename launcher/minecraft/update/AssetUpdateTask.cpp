@@ -12,10 +12,20 @@
 AssetUpdateTask::AssetUpdateTask(MinecraftInstance* inst)
 {
     m_inst = inst;
+    connect(&m_missingWatcher, &QFutureWatcher<AssetObject>::finished, this, &AssetUpdateTask::assetsChecked);
 }
 
 AssetUpdateTask::~AssetUpdateTask() {}
 
+QString AssetUpdateTask::sharedKey(MinecraftInstance* inst)
+{
+    auto profile = inst->getPackProfile()->getProfile();
+    auto assets = profile ? profile->getMinecraftAssets() : nullptr;
+    if (!assets)
+        return {};
+    return QString("assets/%1/%2").arg(assets->id, assets->sha1);
+}
+
 void AssetUpdateTask::executeTask()
 {
     setStatus(tr("Updating assets index..."));
@@ -25,6 +35,7 @@ void AssetUpdateTask::executeTask()
     QUrl indexUrl = assets->url;
     QString localPath = assets->id + ".json";
     auto job = makeShared<NetJob>(tr("Asset index for %1").arg(m_inst->name()), APPLICATION->network());
+    job->setPriority(Net::Priority::LaunchCritical);
 
     auto metacache = APPLICATION->metacache();
     auto entry = metacache->resolveEntry("asset_indexes", localPath);
@@ -55,7 +66,6 @@ bool AssetUpdateTask::canAbort() const
 
 void AssetUpdateTask::assetIndexFinished()
 {
-    AssetsIndex index;
     qDebug() << m_inst->name() << ": Finished asset index download";
 
     auto components = m_inst->getPackProfile();
@@ -63,15 +73,29 @@ void AssetUpdateTask::assetIndexFinished()
     auto assets = profile->getMinecraftAssets();
 
     QString asset_fname = "assets/indexes/" + assets->id + ".json";
+    m_index = AssetsIndex();
     // FIXME: this looks like a job for a generic validator based on json schema?
-    if (!AssetsUtils::loadAssetsIndexJson(assets->id, asset_fname, index)) {
+    if (!AssetsUtils::loadAssetsIndexJson(assets->id, asset_fname, m_index)) {
         auto metacache = APPLICATION->metacache();
         auto entry = metacache->resolveEntry("asset_indexes", assets->id + ".json");
         metacache->evictEntry(entry);
         emitFailed(tr("Failed to read the assets index!"));
+        return;
+    }
+
+    setStatus(tr("Checking the assets files..."));
+    downloadJob.reset();
+    m_missingWatcher.setFuture(m_index.findMissingObjects());
+}
+
+void AssetUpdateTask::assetsChecked()
+{
+    if (m_missingWatcher.isCanceled()) {
+        emitFailed(tr("Aborted"));
+        return;
     }
 
-    auto job = index.getDownloadJob();
+    auto job = m_index.getDownloadJob(m_missingWatcher.future().results());
     if (job) {
         setStatus(tr("Getting the assets files from Mojang..."));
         downloadJob = job;
@@ -101,6 +125,8 @@ bool AssetUpdateTask::abort()
 {
     if (downloadJob) {
         return downloadJob->abort();
+    } else if (m_missingWatcher.isRunning()) {
+        m_missingWatcher.cancel();
     } else {
         qWarning() << "Prematurely aborted AssetUpdateTask";
     }
@@ -1,4 +1,7 @@
 #pragma once
+#include <QFutureWatcher>
+
+#include "minecraft/AssetsUtils.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
 class MinecraftInstance;
@@ -13,8 +16,12 @@ class AssetUpdateTask : public Task {
 
     bool canAbort() const override;
 
+    /// the asset index of the instance, launches with the same key can share one check of the assets
+    static QString sharedKey(MinecraftInstance* inst);
+
    private slots:
     void assetIndexFinished();
+    void assetsChecked();
     void assetIndexFailed(QString reason);
     void assetsFailed(QString reason);
 
@@ -24,4 +31,6 @@ class AssetUpdateTask : public Task {
    private:
     MinecraftInstance* m_inst;
     NetJob::Ptr downloadJob;
+    AssetsIndex m_index;
+    QFutureWatcher<AssetObject> m_missingWatcher;
 };
@@ -8,11 +8,33 @@
 #include "Application.h"
 #include "BuildConfig.h"
 
+#include "modplatform/helpers/HashUtils.h"
 #include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+#include "net/ContentStore.h"
+#include "tasks/Executor.h"
+
+namespace {
+Net::ContentStore::Key keyFor(const FMLlib& lib)
+{
+    return Net::ContentStore::keyFor(QCryptographicHash::Sha1, QByteArray::fromHex(lib.checksum.toLatin1()));
+}
+
+bool matches(const QString& path, const FMLlib& lib)
+{
+    if (path.isEmpty() || !QFileInfo::exists(path))
+        return false;
+    // nothing to check it against
+    if (lib.checksum.isEmpty())
+        return true;
+    return Hashing::cachedHash(path, "sha1").compare(lib.checksum, Qt::CaseInsensitive) == 0;
+}
+}  // namespace
 
 FMLLibrariesTask::FMLLibrariesTask(MinecraftInstance* inst)
 {
     m_inst = inst;
+    connect(&m_verifyWatcher, &QFutureWatcher<QList<Lib>>::finished, this, &FMLLibrariesTask::verified);
 }
 void FMLLibrariesTask::executeTask()
 {
@@ -42,12 +64,54 @@ void FMLLibrariesTask::executeTask()
         return;
     }
 
-    // now check the lib folder inside the instance for files.
+    // the caches can only be asked here, the files are checked on other threads
+    auto metacache = APPLICATION->metacache();
+    auto store = Net::ContentStore::shared();
+    QList<Lib> libs;
     for (auto& lib : libList) {
-        QFileInfo libInfo(FS::PathCombine(inst->libDir(), lib.filename));
-        if (libInfo.exists())
-            continue;
-        fmlLibsToProcess.append(lib);
+        Lib entry{ lib, FS::PathCombine(inst->libDir(), lib.filename), metacache->resolveEntry("fmllibs", lib.filename)->getFullPath() };
+        auto key = keyFor(lib);
+        if (store && key.isValid())
+            entry.stored = store->pathFor(key);
+        libs.append(entry);
+    }
+    m_verifyWatcher.setFuture(Executor::instance()->run(
+        Executor::Priority::Interactive, [libs, token = m_cancel] { return verify(libs, token); }, m_cancel));
+}
+
+QList<FMLLibrariesTask::Lib> FMLLibrariesTask::verify(QList<Lib> libs, CancellationToken token)
+{
+    QList<QFuture<Lib>> checks;
+    for (auto& lib : libs) {
+        checks.append(Executor::instance()->run(
+            Executor::Priority::Interactive,
+            [lib]() mutable {
+                lib.inPlace = matches(lib.target, lib.lib);
+                // a stored copy that got edited through a link is dropped when it's taken, the metacache can still have it
+                lib.available = !lib.inPlace && (matches(lib.stored, lib.lib) || matches(lib.cached, lib.lib));
+                return lib;
+            },
+            token));
+    }
+    QList<Lib> result;
+    for (auto& check : checks) {
+        Executor::instance()->waitFor(check);
+        if (check.isCanceled())
+            return {};
+        result.append(check.result());
+    }
+    return result;
+}
+
+void FMLLibrariesTask::verified()
+{
+    if (m_cancel.isCancelled() || m_verifyWatcher.isCanceled()) {
+        emitFailed(tr("Aborted"));
+        return;
+    }
+    for (auto& lib : m_verifyWatcher.result()) {
+        if (!lib.inPlace)
+            fmlLibsToProcess.append(lib);
     }
 
     // if everything is in place, there's nothing to do here...
@@ -56,15 +120,31 @@ void FMLLibrariesTask::executeTask()
         return;
     }
 
+    QList<FMLlib> missing;
+    for (auto& lib : fmlLibsToProcess) {
+        if (!lib.available)
+            missing.append(lib.lib);
+    }
+    if (missing.isEmpty()) {
+        fmllibsFinished();
+        return;
+    }
+
     // download missing libs to our place
     setStatus(tr("Downloading FML libraries..."));
     NetJob::Ptr dljob{ new NetJob("FML libraries", APPLICATION->network()) };
+    dljob->setPriority(Net::Priority::LaunchCritical);
     auto metacache = APPLICATION->metacache();
     Net::Download::Options options = Net::Download::Option::MakeEternal;
-    for (auto& lib : fmlLibsToProcess) {
+    for (auto& lib : missing) {
         auto entry = metacache->resolveEntry("fmllibs", lib.filename);
+        // what's there didn't match, an eternal entry wouldn't be fetched again otherwise
+        entry->setStale(true);
         QString urlString = BuildConfig.FMLLIBS_BASE_URL + lib.filename;
-        dljob->addNetAction(Net::ApiDownload::makeCached(QUrl(urlString), entry, options));
+        auto dl = Net::ApiDownload::makeCached(QUrl(urlString), entry, options);
+        if (!lib.checksum.isEmpty())
+            dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(lib.checksum.toLatin1())));
+        dljob->addNetAction(dl);
     }
 
     connect(dljob.get(), &NetJob::succeeded, this, &FMLLibrariesTask::fmllibsFinished);
@@ -81,24 +161,33 @@ bool FMLLibrariesTask::canAbort() const
     return true;
 }
 
+bool FMLLibrariesTask::place(const Lib& lib)
+{
+    auto store = Net::ContentStore::shared();
+    auto key = keyFor(lib.lib);
+    if (store && key.isValid()) {
+        if (QFileInfo::exists(lib.cached))
+            store->add(key, lib.cached);
+        if (store->materialize(key, lib.target))
+            return true;
+    }
+    auto source = QFileInfo::exists(lib.cached) ? lib.cached : lib.stored;
+    if (!FS::ensureFilePathExists(lib.target))
+        return false;
+    QFile::remove(lib.target);
+    return QFile::copy(source, lib.target);
+}
+
 void FMLLibrariesTask::fmllibsFinished()
 {
     downloadJob.reset();
     if (!fmlLibsToProcess.isEmpty()) {
-        setStatus(tr("Copying FML libraries into the instance..."));
-        MinecraftInstance* inst = (MinecraftInstance*)m_inst;
-        auto metacache = APPLICATION->metacache();
+        setStatus(tr("Linking FML libraries into the instance..."));
         int index = 0;
         for (auto& lib : fmlLibsToProcess) {
             progress(index, fmlLibsToProcess.size());
-            auto entry = metacache->resolveEntry("fmllibs", lib.filename);
-            auto path = FS::PathCombine(inst->libDir(), lib.filename);
-            if (!FS::ensureFilePathExists(path)) {
-                emitFailed(tr("Failed creating FML library folder inside the instance."));
-                return;
-            }
-            if (!QFile::copy(entry->getFullPath(), FS::PathCombine(inst->libDir(), lib.filename))) {
-                emitFailed(tr("Failed copying Forge/FML library: %1.").arg(lib.filename));
+            if (!place(lib)) {
+                emitFailed(tr("Failed copying Forge/FML library: %1.").arg(lib.lib.filename));
                 return;
             }
             index++;
@@ -116,6 +205,11 @@ void FMLLibrariesTask::fmllibsFailed(QString reason)
 
 bool FMLLibrariesTask::abort()
 {
+    m_cancel.cancel();
+    if (m_verifyWatcher.isRunning()) {
+        // verified() fails the task once the checks stop
+        return true;
+    }
     if (downloadJob) {
         return downloadJob->abort();
     } else {
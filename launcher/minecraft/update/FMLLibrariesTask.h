@@ -1,10 +1,19 @@
 #pragma once
+#include <QFutureWatcher>
+
 #include "minecraft/VersionFilterData.h"
 #include "net/NetJob.h"
+#include "tasks/CancellationToken.h"
 #include "tasks/Task.h"
 
 class MinecraftInstance;
 
+/**
+ * Puts the libraries legacy FML downloads itself at start into the lib folder of the instance.
+ *
+ * They are kept once in the content store, linked or cloned into every instance that needs them, and the copies that
+ * are already there are checked against their SHA1 in parallel, off the GUI thread.
+ */
 class FMLLibrariesTask : public Task {
     Q_OBJECT
    public:
@@ -22,8 +31,27 @@ class FMLLibrariesTask : public Task {
    public slots:
     bool abort() override;
 
+   private:
+    struct Lib {
+        FMLlib lib;
+        // in the instance, in the metacache and in the content store
+        QString target;
+        QString cached;
+        QString stored;
+        // the copy in the instance is fine
+        bool inPlace = false;
+        // a good copy is in the metacache or the store, so it doesn't need to be downloaded
+        bool available = false;
+    };
+
+    static QList<Lib> verify(QList<Lib> libs, CancellationToken token);
+    void verified();
+    bool place(const Lib& lib);
+
    private:
     MinecraftInstance* m_inst;
     NetJob::Ptr downloadJob;
-    QList<FMLlib> fmlLibsToProcess;
+    QList<Lib> fmlLibsToProcess;
+    QFutureWatcher<QList<Lib>> m_verifyWatcher;
+    CancellationToken m_cancel;
 };
@@ -1,15 +1,86 @@
 #include "LibrariesTask.h"
 
+#include <QCryptographicHash>
+#include <QtConcurrentMap>
+
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 
 #include "Application.h"
+#include "net/HttpMetaCache.h"
+
+/// a library with what checking its files found, filled in on a worker thread
+struct LibrariesTask::LibraryCheck {
+    LibraryPtr lib;
+    QString localPath;
+    bool jarMod = false;
+    QList<NetAction::Ptr> downloads;
+    QStringList failedLocalFiles;
+};
+
+struct LibrariesTask::CheckLibrary {
+    using result_type = LibraryCheck;
+
+    RuntimeContext runtimeContext;
+    HttpMetaCache* metacache;
+    QThread* target;
+
+    LibraryCheck operator()(LibraryCheck check) const
+    {
+        check.downloads = check.lib->getDownloads(runtimeContext, metacache, check.failedLocalFiles, check.localPath);
+        // the job runs them on the thread of the task
+        for (auto& dl : check.downloads)
+            dl->moveToThread(target);
+        return check;
+    }
+};
+
+namespace {
+QList<LibraryPtr> artifactPool(const LaunchProfile* profile)
+{
+    QList<LibraryPtr> pool;
+    pool.append(profile->getLibraries());
+    pool.append(profile->getNativeLibraries());
+    pool.append(profile->getMavenFiles());
+    for (auto agent : profile->getAgents()) {
+        pool.append(agent->library());
+    }
+    pool.append(profile->getMainJar());
+    return pool;
+}
+}  // namespace
+
+QString LibrariesTask::sharedKey(MinecraftInstance* inst)
+{
+    auto profile = inst->getPackProfile()->getProfile();
+    if (!profile)
+        return {};
+    auto context = inst->runtimeContext();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(context.getClassifier().toUtf8());
+    auto add = [&](const QList<LibraryPtr>& pool, const QString& localPath, bool jarMod) {
+        for (auto& lib : pool) {
+            if (!lib)
+                return false;
+            // the local ones and the jar mods are where the instance keeps them
+            auto where = jarMod || lib->isLocal() ? localPath : QString();
+            auto line = QString("%1|%2|%3|%4\n").arg(lib->rawName().serialize(), lib->hint(), lib->storageSuffix(context), where);
+            hash.addData(line.toUtf8());
+        }
+        return true;
+    };
+    if (!add(artifactPool(profile.get()), inst->getLocalLibraryPath(), false) || !add(profile->getJarMods(), inst->jarModsDir(), true))
+        return {};
+    return "libraries/" + QString::fromLatin1(hash.result().toHex());
+}
 
 LibrariesTask::LibrariesTask(MinecraftInstance* inst)
 {
     m_inst = inst;
 }
 
+LibrariesTask::~LibrariesTask() = default;
+
 void LibrariesTask::executeTask()
 {
     setStatus(tr("Downloading required library files..."));
@@ -20,38 +91,50 @@ void LibrariesTask::executeTask()
     auto components = inst->getPackProfile();
     auto profile = components->getProfile();
 
-    NetJob::Ptr job{ new NetJob(tr("Libraries for instance %1").arg(inst->name()), APPLICATION->network()) };
-    downloadJob.reset(job);
+    auto libArtifactPool = artifactPool(profile.get());
 
-    auto metacache = APPLICATION->metacache();
-
-    auto processArtifactPool = [&](const QList<LibraryPtr>& pool, QStringList& errors, const QString& localPath) {
+    QList<LibraryCheck> checks;
+    auto addChecks = [&](const QList<LibraryPtr>& pool, const QString& localPath, bool jarMod) {
         for (auto lib : pool) {
             if (!lib) {
                 emitFailed(tr("Null jar is specified in the metadata, aborting."));
                 return false;
             }
-            auto dls = lib->getDownloads(inst->runtimeContext(), metacache.get(), errors, localPath);
-            for (auto dl : dls) {
-                downloadJob->addNetAction(dl);
-            }
+            checks.append({ lib, localPath, jarMod, {}, {} });
         }
         return true;
     };
+    if (!addChecks(libArtifactPool, inst->getLocalLibraryPath(), false) || !addChecks(profile->getJarMods(), inst->jarModsDir(), true))
+        return;
 
-    QStringList failedLocalLibraries;
-    QList<LibraryPtr> libArtifactPool;
-    libArtifactPool.append(profile->getLibraries());
-    libArtifactPool.append(profile->getNativeLibraries());
-    libArtifactPool.append(profile->getMavenFiles());
-    for (auto agent : profile->getAgents()) {
-        libArtifactPool.append(agent->library());
-    }
-    libArtifactPool.append(profile->getMainJar());
-    processArtifactPool(libArtifactPool, failedLocalLibraries, inst->getLocalLibraryPath());
+    // checking means a metacache lookup and a stat for every file, or hashing the ones that changed, done in parallel
+    m_checkWatcher.reset(new QFutureWatcher<LibraryCheck>());
+    connect(m_checkWatcher.get(), &QFutureWatcher<LibraryCheck>::finished, this, [this] {
+        auto watcher = m_checkWatcher.release();
+        watcher->deleteLater();
+        if (watcher->isCanceled()) {
+            emitFailed(tr("Aborted"));
+            return;
+        }
+        startDownloads(watcher->future().results());
+    });
+    CheckLibrary checkLibrary{ inst->runtimeContext(), APPLICATION->metacache().get(), thread() };
+    m_checkWatcher->setFuture(QtConcurrent::mapped(checks, checkLibrary));
+}
 
+void LibrariesTask::startDownloads(const QList<LibraryCheck>& checks)
+{
+    NetJob::Ptr job{ new NetJob(tr("Libraries for instance %1").arg(m_inst->name()), APPLICATION->network()) };
+    job->setPriority(Net::Priority::LaunchCritical);
+    downloadJob.reset(job);
+
+    QStringList failedLocalLibraries;
     QStringList failedLocalJarMods;
-    processArtifactPool(profile->getJarMods(), failedLocalJarMods, inst->jarModsDir());
+    for (auto& check : checks) {
+        for (auto& dl : check.downloads)
+            downloadJob->addNetAction(dl);
+        (check.jarMod ? failedLocalJarMods : failedLocalLibraries).append(check.failedLocalFiles);
+    }
 
     if (!failedLocalJarMods.empty() || !failedLocalLibraries.empty()) {
         downloadJob.reset();
@@ -83,6 +166,10 @@ void LibrariesTask::jarlibFailed(QString reason)
 
 bool LibrariesTask::abort()
 {
+    if (m_checkWatcher) {
+        m_checkWatcher->cancel();
+        return true;
+    }
     if (downloadJob) {
         return downloadJob->abort();
     } else {
@@ -1,4 +1,8 @@
 #pragma once
+#include <QFutureWatcher>
+
+#include <memory>
+
 #include "net/NetJob.h"
 #include "tasks/Task.h"
 class MinecraftInstance;
@@ -7,19 +11,30 @@ class LibrariesTask : public Task {
     Q_OBJECT
    public:
     LibrariesTask(MinecraftInstance* inst);
-    virtual ~LibrariesTask(){};
+    virtual ~LibrariesTask();
 
     void executeTask() override;
 
     bool canAbort() const override;
 
+    /// what the libraries of the instance come down to, launches with the same key can share one check of them
+    static QString sharedKey(MinecraftInstance* inst);
+
    private slots:
     void jarlibFailed(QString reason);
 
    public slots:
     bool abort() override;
 
+   private:
+    struct LibraryCheck;
+    struct CheckLibrary;
+
+    void startDownloads(const QList<LibraryCheck>& checks);
+
    private:
     MinecraftInstance* m_inst;
     NetJob::Ptr downloadJob;
+    // the library files being checked before downloading what's missing
+    std::unique_ptr<QFutureWatcher<LibraryCheck>> m_checkWatcher;
 };
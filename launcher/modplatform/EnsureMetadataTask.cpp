@@ -2,12 +2,12 @@
 
 #include <MurmurHash2.h>
 #include <QDebug>
+#include <QFutureWatcher>
 
 #include "Application.h"
 #include "Json.h"
 
 #include "minecraft/mod/Mod.h"
-#include "minecraft/mod/tasks/LocalModUpdateTask.h"
 
 #include "modplatform/flame/FlameAPI.h"
 #include "modplatform/flame/FlameModIndex.h"
@@ -15,11 +15,27 @@
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "modplatform/modrinth/ModrinthPackIndex.h"
 
+#include "tasks/Executor.h"
+
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
 static ModrinthAPI modrinth_api;
 static FlameAPI flame_api;
 
+namespace {
+struct KnownFile {
+    ModPlatform::IndexedPack pack;
+    ModPlatform::IndexedVersion version;
+};
+// what the providers said about the files hashed so far, instances sharing mods only ask about each of them once
+QHash<QString, KnownFile> s_known;
+
+QString knownKey(ModPlatform::ResourceProvider provider, const QString& hash)
+{
+    return QString("%1:%2").arg(ProviderCaps.name(provider), hash);
+}
+}  // namespace
+
 EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::ResourceProvider prov)
     : Task(nullptr), m_index_dir(dir), m_provider(prov), m_hashing_task(nullptr), m_current_task(nullptr)
 {
@@ -34,7 +50,9 @@ EnsureMetadataTask::EnsureMetadataTask(Mod* mod, QDir dir, ModPlatform::Resource
 EnsureMetadataTask::EnsureMetadataTask(QList<Mod*>& mods, QDir dir, ModPlatform::ResourceProvider prov)
     : Task(nullptr), m_index_dir(dir), m_provider(prov), m_current_task(nullptr)
 {
-    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt()));
+    auto max_hashers = APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt();
+    m_hashing_task.reset(new ConcurrentTask(this, "MakeHashesTask", max_hashers));
+    m_hashing_task->setAdaptiveConcurrency(1, 2 * max_hashers);
     for (auto* mod : mods) {
         auto hash_task = createNewHash(mod);
         if (!hash_task)
@@ -107,6 +125,17 @@ void EnsureMetadataTask::executeTask()
         }
     }
 
+    // files already looked up, for this instance or another one, don't need the network at all
+    for (auto& hash : m_mods.keys()) {
+        auto known = s_known.constFind(knownKey(m_provider, hash));
+        if (known != s_known.constEnd())
+            queueWrite(known->pack, known->version, m_mods.value(hash));
+    }
+    if (m_mods.isEmpty()) {
+        finish();
+        return;
+    }
+
     Task::Ptr version_task;
 
     switch (m_provider) {
@@ -118,15 +147,7 @@ void EnsureMetadataTask::executeTask()
             break;
     }
 
-    auto invalidade_leftover = [this] {
-        for (auto mod = m_mods.constBegin(); mod != m_mods.constEnd(); mod++)
-            emitFail(mod.value(), mod.key(), RemoveFromList::No);
-        m_mods.clear();
-
-        emitSucceeded();
-    };
-
-    connect(version_task.get(), &Task::finished, this, [this, invalidade_leftover] {
+    connect(version_task.get(), &Task::finished, this, [this] {
         Task::Ptr project_task;
 
         switch (m_provider) {
@@ -139,12 +160,12 @@ void EnsureMetadataTask::executeTask()
         }
 
         if (!project_task) {
-            invalidade_leftover();
+            finish();
             return;
         }
 
         connect(project_task.get(), &Task::finished, this, [=] {
-            invalidade_leftover();
+            finish();
             project_task->deleteLater();
             if (m_current_task)
                 m_current_task.reset();
@@ -210,6 +231,77 @@ void EnsureMetadataTask::emitFail(Mod* m, QString key, RemoveFromList remove)
     }
 }
 
+void EnsureMetadataTask::queueWrite(const ModPlatform::IndexedPack& pack, const ModPlatform::IndexedVersion& ver, Mod* mod)
+{
+    auto hash = getExistingHash(mod);
+    s_known.insert(knownKey(m_provider, hash), { pack, ver });
+    m_mods.remove(hash);
+
+    PendingWrite write{ mod, pack, ver };
+    // Prevent file name mismatch
+    write.version.fileName = mod->fileinfo().fileName();
+    if (write.version.fileName.endsWith(".disabled"))
+        write.version.fileName.chop(9);
+    m_pending_writes.append(write);
+}
+
+void EnsureMetadataTask::finish()
+{
+    for (auto mod = m_mods.constBegin(); mod != m_mods.constEnd(); mod++)
+        emitFail(mod.value(), mod.key(), RemoveFromList::No);
+    m_mods.clear();
+
+    if (m_pending_writes.isEmpty()) {
+        emitSucceeded();
+        return;
+    }
+
+    // the index files are all written at once off the GUI thread
+    setStatus(tr("Writing metadata..."));
+    auto writes = std::move(m_pending_writes);
+    m_pending_writes.clear();
+    auto write = [writes, index_dir = m_index_dir]() mutable {
+        // the index is read once and only the files that change are written
+        Metadata::Batch index(index_dir);
+        for (auto& pending : writes) {
+            auto old_metadata = index.get(pending.pack.addonId);
+            if (old_metadata.isValid() && pending.pack.slug.isEmpty())
+                pending.pack.slug = old_metadata.slug;
+
+            auto pw_mod = Metadata::create(index_dir, pending.pack, pending.version);
+            if (pw_mod.isValid())
+                index.update(pw_mod);
+            else
+                qCritical() << "Tried to update an invalid mod!";
+        }
+        index.commit();
+
+        QList<Metadata::ModStruct> written;
+        for (auto& pending : writes)
+            written.append(index.get(pending.pack.slug));
+        return written;
+    };
+    auto watcher = new QFutureWatcher<QList<Metadata::ModStruct>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, writes] {
+        watcher->deleteLater();
+        if (!isRunning())
+            return;
+        auto written = watcher->result();
+        for (int i = 0; i < writes.size(); i++) {
+            auto* mod = writes[i].mod;
+            if (!written[i].isValid()) {
+                qCritical() << "Failed to generate metadata at last step!";
+                emitFail(mod, {}, RemoveFromList::No);
+                continue;
+            }
+            mod->setMetadata(written[i]);
+            emitReady(mod, {}, RemoveFromList::No);
+        }
+        emitSucceeded();
+    });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Background, write));
+}
+
 // Modrinth
 
 Task::Ptr EnsureMetadataTask::modrinthVersionsTask()
@@ -489,72 +581,10 @@ Task::Ptr EnsureMetadataTask::flameProjectsTask()
 
 void EnsureMetadataTask::modrinthCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
 {
-    // Prevent file name mismatch
-    ver.fileName = mod->fileinfo().fileName();
-    if (ver.fileName.endsWith(".disabled"))
-        ver.fileName.chop(9);
-
-    QDir tmp_index_dir(m_index_dir);
-
-    {
-        LocalModUpdateTask update_metadata(m_index_dir, pack, ver);
-        QEventLoop loop;
-
-        QObject::connect(&update_metadata, &Task::finished, &loop, &QEventLoop::quit);
-
-        update_metadata.start();
-
-        if (!update_metadata.isFinished())
-            loop.exec();
-    }
-
-    auto metadata = Metadata::get(tmp_index_dir, pack.slug);
-    if (!metadata.isValid()) {
-        qCritical() << "Failed to generate metadata at last step!";
-        emitFail(mod);
-        return;
-    }
-
-    mod->setMetadata(metadata);
-
-    emitReady(mod);
+    queueWrite(pack, ver, mod);
 }
 
 void EnsureMetadataTask::flameCallback(ModPlatform::IndexedPack& pack, ModPlatform::IndexedVersion& ver, Mod* mod)
 {
-    try {
-        // Prevent file name mismatch
-        ver.fileName = mod->fileinfo().fileName();
-        if (ver.fileName.endsWith(".disabled"))
-            ver.fileName.chop(9);
-
-        QDir tmp_index_dir(m_index_dir);
-
-        {
-            LocalModUpdateTask update_metadata(m_index_dir, pack, ver);
-            QEventLoop loop;
-
-            QObject::connect(&update_metadata, &Task::finished, &loop, &QEventLoop::quit);
-
-            update_metadata.start();
-
-            if (!update_metadata.isFinished())
-                loop.exec();
-        }
-
-        auto metadata = Metadata::get(tmp_index_dir, pack.slug);
-        if (!metadata.isValid()) {
-            qCritical() << "Failed to generate metadata at last step!";
-            emitFail(mod);
-            return;
-        }
-
-        mod->setMetadata(metadata);
-
-        emitReady(mod);
-    } catch (Json::JsonException& e) {
-        qDebug() << e.cause();
-
-        emitFail(mod);
-    }
+    queueWrite(pack, ver, mod);
 }
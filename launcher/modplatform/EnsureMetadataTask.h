@@ -36,6 +36,10 @@ class EnsureMetadataTask : public Task {
 
     // Helpers
     enum class RemoveFromList { Yes, No };
+    // takes the mod out of those still looked for, its metadata is written with the others in the end
+    void queueWrite(const ModPlatform::IndexedPack& pack, const ModPlatform::IndexedVersion& ver, Mod*);
+    // writes what was queued, then tells about it and about the mods nothing was found for
+    void finish();
     void emitReady(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
     void emitFail(Mod*, QString key = {}, RemoveFromList = RemoveFromList::Yes);
 
@@ -57,6 +61,13 @@ class EnsureMetadataTask : public Task {
     ModPlatform::ResourceProvider m_provider;
 
     QHash<QString, ModPlatform::IndexedVersion> m_temp_versions;
+
+    struct PendingWrite {
+        Mod* mod;
+        ModPlatform::IndexedPack pack;
+        ModPlatform::IndexedVersion version;
+    };
+    QList<PendingWrite> m_pending_writes;
     ConcurrentTask::Ptr m_hashing_task;
     Task::Ptr m_current_task;
 };
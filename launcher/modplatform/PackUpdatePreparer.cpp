@@ -0,0 +1,324 @@
+#include "PackUpdatePreparer.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Application.h"
+#include "BuildConfig.h"
+#include "Exception.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "Json.h"
+#include "MMCZip.h"
+#include "modplatform/flame/FileResolvingTask.h"
+#include "modplatform/flame/PackManifest.h"
+#include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
+#include "net/ContentStore.h"
+#include "net/NetJob.h"
+#include "settings/SettingsObject.h"
+
+PackUpdatePreparer::PackUpdatePreparer(QString path, QObject* parent) : QObject(parent), m_path(std::move(path))
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(std::chrono::hours(6));
+    connect(&m_timer, &QTimer::timeout, this, &PackUpdatePreparer::checkAll);
+    // the first check of a launch is left to the refresh coordinator, which knows when the last one was
+    m_timer.start();
+    load();
+}
+
+MetaEntryPtr PackUpdatePreparer::archiveEntry(const QUrl& url)
+{
+    return APPLICATION->metacache()->resolveEntry("general", url.host() + '/' + url.path());
+}
+
+void PackUpdatePreparer::checkAll()
+{
+    m_timer.start();
+    if (!APPLICATION->settings()->get("PreparePackUpdates").toBool())
+        return;
+
+    auto instances = APPLICATION->instances();
+    for (int i = 0; i < instances->count(); i++) {
+        auto instance = instances->at(i);
+        auto type = instance->getManagedPackType();
+        if (type != "modrinth" && type != "flame")
+            continue;
+        if (!instance->getManagedPackID().isEmpty() && !m_queue.contains(instance->id()))
+            m_queue.enqueue(instance->id());
+    }
+
+    // what was prepared for instances that are gone or got the update is of no use anymore
+    bool changed = false;
+    for (auto it = m_prepared.begin(); it != m_prepared.end();) {
+        auto instance = instances->getInstanceById(it.key());
+        if (!instance || instance->getManagedPackVersionID() == it->versionId) {
+            it = m_prepared.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+    if (changed)
+        save();
+
+    if (!m_current)
+        next();
+}
+
+std::optional<PackUpdatePreparer::Prepared> PackUpdatePreparer::preparedFor(const BaseInstance* instance) const
+{
+    auto it = m_prepared.constFind(instance->id());
+    if (it == m_prepared.constEnd() || it->versionId == instance->getManagedPackVersionID())
+        return {};
+    return *it;
+}
+
+bool PackUpdatePreparer::isArchivePrepared(const QUrl& url) const
+{
+    for (auto& prepared : m_prepared) {
+        if (prepared.archiveUrl == url)
+            return QFileInfo::exists(archiveEntry(url)->getFullPath());
+    }
+    return false;
+}
+
+void PackUpdatePreparer::next()
+{
+    m_current.reset();
+    m_scratch.reset();
+    while (!m_queue.isEmpty()) {
+        auto instance = APPLICATION->instances()->getInstanceById(m_queue.dequeue());
+        if (!instance)
+            continue;
+        if (instance->getManagedPackType() == "modrinth")
+            checkModrinth(instance);
+        else
+            checkFlame(instance);
+        return;
+    }
+}
+
+void PackUpdatePreparer::finish(const QString& instance_id, std::optional<Prepared> target)
+{
+    if (target) {
+        qDebug() << "Prepared version" << target->versionName << "of" << instance_id;
+        m_prepared.insert(instance_id, *target);
+        save();
+        emit prepared(instance_id);
+    }
+    // not from within the signals of the task that just ended
+    QTimer::singleShot(0, this, &PackUpdatePreparer::next);
+}
+
+void PackUpdatePreparer::checkModrinth(InstancePtr instance)
+{
+    auto response = std::make_shared<QByteArray>();
+    auto job = makeShared<NetJob>(QString("Modrinth::PrepareUpdate(%1)").arg(instance->getManagedPackName()), APPLICATION->network());
+    job->setPriority(Net::Priority::Bulk);
+    job->addNetAction(Net::ApiDownload::makeByteArray(
+        QString("%1/project/%2/version").arg(BuildConfig.MODRINTH_PROD_URL, instance->getManagedPackID()), response));
+
+    connect(job.get(), &NetJob::failed, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::aborted, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::succeeded, this, [this, instance, response] {
+        // the newest version comes first
+        auto versions = QJsonDocument::fromJson(*response).array();
+        if (versions.isEmpty())
+            return finish(instance->id(), {});
+        auto version = versions.first().toObject();
+        Prepared target{ version.value("id").toString(), version.value("version_number").toString(), {} };
+        auto known = m_prepared.constFind(instance->id());
+        if (target.versionId.isEmpty() || target.versionId == instance->getManagedPackVersionID() ||
+            (known != m_prepared.constEnd() && known->versionId == target.versionId))
+            return finish(instance->id(), {});
+
+        auto files = version.value("files").toArray();
+        if (files.isEmpty())
+            return finish(instance->id(), {});
+        auto file = files.first().toObject();
+        for (auto candidate : files) {
+            if (candidate.toObject().value("primary").toBool())
+                file = candidate.toObject();
+        }
+        target.archiveUrl = QUrl(file.value("url").toString());
+        auto hashes = file.value("hashes").toObject();
+        if (hashes.contains("sha512"))
+            prepareArchive(instance, target, QCryptographicHash::Sha512, QByteArray::fromHex(hashes.value("sha512").toString().toLatin1()));
+        else
+            prepareArchive(instance, target, QCryptographicHash::Sha1, QByteArray::fromHex(hashes.value("sha1").toString().toLatin1()));
+    });
+    m_current = job;
+    job->start();
+}
+
+void PackUpdatePreparer::checkFlame(InstancePtr instance)
+{
+    auto response = std::make_shared<QByteArray>();
+    auto job = makeShared<NetJob>(QString("Flame::PrepareUpdate(%1)").arg(instance->getManagedPackName()), APPLICATION->network());
+    job->setPriority(Net::Priority::Bulk);
+    auto url = QString("%1/mods/%2/files").arg(BuildConfig.FLAME_BASE_URL, instance->getManagedPackID());
+    job->addNetAction(Net::ApiDownload::makeByteArray(url, response));
+
+    connect(job.get(), &NetJob::failed, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::aborted, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::succeeded, this, [this, instance, response] {
+        // file ids only grow, the newest file has the largest
+        QJsonObject version;
+        for (auto file : QJsonDocument::fromJson(*response).object().value("data").toArray()) {
+            if (file.toObject().value("id").toDouble() > version.value("id").toDouble())
+                version = file.toObject();
+        }
+        Prepared target{ QString::number(qint64(version.value("id").toDouble())), version.value("displayName").toString(),
+                         QUrl(version.value("downloadUrl").toString()) };
+        auto known = m_prepared.constFind(instance->id());
+        if (version.isEmpty() || target.archiveUrl.isEmpty() || target.versionId == instance->getManagedPackVersionID() ||
+            (known != m_prepared.constEnd() && known->versionId == target.versionId))
+            return finish(instance->id(), {});
+
+        QByteArray sha1;
+        for (auto hash : version.value("hashes").toArray()) {
+            if (hash.toObject().value("algo").toInt() == 1)
+                sha1 = QByteArray::fromHex(hash.toObject().value("value").toString().toLatin1());
+        }
+        prepareArchive(instance, target, QCryptographicHash::Sha1, sha1);
+    });
+    m_current = job;
+    job->start();
+}
+
+void PackUpdatePreparer::prepareArchive(InstancePtr instance, Prepared target, QCryptographicHash::Algorithm algorithm, QByteArray hash)
+{
+    auto entry = archiveEntry(target.archiveUrl);
+    auto job = makeShared<NetJob>(QString("PrepareUpdate::Archive(%1)").arg(instance->getManagedPackName()), APPLICATION->network());
+    job->setPriority(Net::Priority::Bulk);
+    auto dl = Net::ApiDownload::makeCached(target.archiveUrl, entry);
+    if (!hash.isEmpty())
+        dl->addValidator(new Net::ChecksumValidator(algorithm, hash));
+    job->addNetAction(dl);
+
+    connect(job.get(), &NetJob::failed, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::aborted, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::succeeded, this, [this, instance, target, entry] {
+        m_scratch = std::make_unique<QTemporaryDir>();
+        auto modrinth = instance->getManagedPackType() == "modrinth";
+        auto index_path = FS::PathCombine(m_scratch->path(), "index.json");
+        if (!MMCZip::extractFile(entry->getFullPath(), modrinth ? "modrinth.index.json" : "manifest.json", index_path))
+            return finish(instance->id(), {});
+
+        if (modrinth) {
+            QList<PrefetchFile> files;
+            auto index = QJsonDocument::fromJson(FS::read(index_path)).object();
+            for (auto fileRaw : index.value("files").toArray()) {
+                auto file = fileRaw.toObject();
+                if (file.value("env").toObject().value("client").toString() == "unsupported")
+                    continue;
+                auto downloads = file.value("downloads").toArray();
+                if (downloads.isEmpty())
+                    continue;
+                // the same hash the pack creation checks the file with, the store keys it by that
+                auto hashes = file.value("hashes").toObject();
+                PrefetchFile prefetch{ QUrl(downloads.first().toString()), QCryptographicHash::Sha1,
+                                       QByteArray::fromHex(hashes.value("sha1").toString().toLatin1()) };
+                if (prefetch.hash.isEmpty()) {
+                    prefetch.algorithm = QCryptographicHash::Sha512;
+                    prefetch.hash = QByteArray::fromHex(hashes.value("sha512").toString().toLatin1());
+                }
+                files.append(prefetch);
+            }
+            return prefetchFiles(instance, target, files);
+        }
+
+        Flame::Manifest manifest;
+        try {
+            Flame::loadManifest(manifest, index_path);
+        } catch (const Exception& e) {
+            qWarning() << "Couldn't read the manifest of" << target.versionName << "of" << instance->name() << ":" << e.cause();
+            return finish(instance->id(), {});
+        }
+        auto resolver = makeShared<Flame::FileResolvingTask>(APPLICATION->network(), manifest);
+        connect(resolver.get(), &Task::finished, this, [this, instance, target, resolver = resolver.get()] {
+            QList<PrefetchFile> files;
+            if (resolver->wasSuccessful()) {
+                for (auto& file : resolver->getResults().files) {
+                    if (!file.url.isEmpty() && !file.hash.isEmpty())
+                        files.append({ file.url, QCryptographicHash::Sha1, QByteArray::fromHex(file.hash.toLatin1()) });
+                }
+            }
+            prefetchFiles(instance, target, files);
+        });
+        m_current = resolver;
+        resolver->start();
+    });
+    m_current = job;
+    job->start();
+}
+
+void PackUpdatePreparer::prefetchFiles(InstancePtr instance, Prepared target, QList<PrefetchFile> files)
+{
+    auto store = Net::ContentStore::shared();
+    auto job = makeShared<NetJob>(QString("PrepareUpdate::Files(%1)").arg(instance->getManagedPackName()), APPLICATION->network());
+    job->setPriority(Net::Priority::Bulk);
+    int count = 0;
+    for (auto& file : files) {
+        auto key = Net::ContentStore::keyFor(file.algorithm, file.hash);
+        if (!store || !key.isValid() || QFileInfo::exists(store->pathFor(key)))
+            continue;
+        // the downloads add what passed its checksum to the store, the copies here go away with the scratch folder
+        auto dl = Net::ApiDownload::makeFile(file.url, FS::PathCombine(m_scratch->path(), QString::number(count++)));
+        dl->addValidator(new Net::ChecksumValidator(file.algorithm, file.hash));
+        job->addNetAction(dl);
+    }
+    if (count == 0)
+        return finish(instance->id(), target);
+
+    qDebug() << "Preparing" << count << "files of version" << target.versionName << "of" << instance->name();
+    connect(job.get(), &NetJob::succeeded, this, [this, id = instance->id(), target] { finish(id, target); });
+    connect(job.get(), &NetJob::failed, this, [this, id = instance->id()] { finish(id, {}); });
+    connect(job.get(), &NetJob::aborted, this, [this, id = instance->id()] { finish(id, {}); });
+    m_current = job;
+    job->start();
+}
+
+void PackUpdatePreparer::load()
+{
+    if (m_path.isNull())
+        return;
+
+    try {
+        auto root = Json::requireObject(Json::requireDocument(m_path, "Prepared updates"));
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+            auto obj = it.value().toObject();
+            m_prepared.insert(it.key(), { Json::ensureString(obj, "versionId"), Json::ensureString(obj, "versionName"),
+                                          QUrl(Json::ensureString(obj, "archiveUrl")) });
+        }
+    } catch ([[maybe_unused]] const Exception& e) {
+        // there's none until something was prepared
+        m_prepared.clear();
+    }
+}
+
+void PackUpdatePreparer::save()
+{
+    if (m_path.isNull())
+        return;
+
+    QJsonObject root;
+    for (auto it = m_prepared.constBegin(); it != m_prepared.constEnd(); ++it) {
+        QJsonObject obj;
+        obj.insert("versionId", it->versionId);
+        obj.insert("versionName", it->versionName);
+        obj.insert("archiveUrl", it->archiveUrl.toString());
+        root.insert(it.key(), obj);
+    }
+
+    try {
+        Json::write(root, m_path);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write the prepared updates:" << e.cause();
+    }
+}
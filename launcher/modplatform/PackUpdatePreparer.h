@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QCryptographicHash>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUrl>
+
+#include <memory>
+#include <optional>
+
+#include "BaseInstance.h"
+#include "net/HttpMetaCache.h"
+#include "tasks/Task.h"
+
+/**
+ * Gets the new versions of the managed modpacks ready before anyone asks for them, when the user opts in.
+ *
+ * Updating a big pack meant downloading its archive and every changed mod while the user waited. Every few hours this
+ * looks for a new version of each Modrinth and CurseForge pack, downloads its archive where the import looks for it
+ * and every file it lists into the content store, all on the bulk class of the bandwidth scheduler so it only gets
+ * what the rest of the launcher leaves. The update itself then runs as usual, but its archive is already there and
+ * its files are linked or cloned from the store instead of downloaded.
+ *
+ * Packs are prepared one after the other. Files the platforms don't give a hash for can't be stored, those are still
+ * downloaded by the update.
+ */
+class PackUpdatePreparer : public QObject {
+    Q_OBJECT
+   public:
+    struct Prepared {
+        QString versionId;
+        QString versionName;
+        QUrl archiveUrl;
+    };
+
+    // supply path to the file keeping what was prepared
+    explicit PackUpdatePreparer(QString path = QString(), QObject* parent = nullptr);
+
+    /// look for new versions of every managed pack and prepare them, then again every few hours
+    void checkAll();
+
+    /// the update prepared for the instance, if it's still newer than what the instance has
+    std::optional<Prepared> preparedFor(const BaseInstance* instance) const;
+    /// whether the pack archive at `url` was downloaded and verified ahead
+    bool isArchivePrepared(const QUrl& url) const;
+
+    /// where a downloaded pack archive is kept, the import takes it from there
+    static MetaEntryPtr archiveEntry(const QUrl& url);
+
+   signals:
+    void prepared(QString instance_id);
+
+   private:
+    struct PrefetchFile {
+        QUrl url;
+        QCryptographicHash::Algorithm algorithm;
+        QByteArray hash;
+    };
+
+    void next();
+    void checkModrinth(InstancePtr instance);
+    void checkFlame(InstancePtr instance);
+    void prepareArchive(InstancePtr instance, Prepared target, QCryptographicHash::Algorithm algorithm, QByteArray hash);
+    void prefetchFiles(InstancePtr instance, Prepared target, QList<PrefetchFile> files);
+    void finish(const QString& instance_id, std::optional<Prepared> target);
+
+    void load();
+    void save();
+
+   private:
+    QString m_path;
+    QHash<QString, Prepared> m_prepared;
+    QQueue<QString> m_queue;
+    Task::Ptr m_current;
+    std::unique_ptr<QTemporaryDir> m_scratch;
+    QTimer m_timer;
+};
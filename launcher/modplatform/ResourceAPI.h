@@ -78,6 +78,8 @@ class ResourceAPI {
         std::function<void(QJsonDocument&)> on_succeed;
         std::function<void(QString const& reason, int network_error_code)> on_fail;
         std::function<void()> on_abort;
+        // asked before the response is parsed, an answer nobody waits for anymore is dropped right there
+        std::function<bool()> is_wanted;
     };
 
     struct VersionSearchArgs {
@@ -36,7 +36,6 @@
 
 #include "ATLPackInstallTask.h"
 
-#include <QtConcurrent>
 #include <algorithm>
 
 #include <quazip/quazip.h>
@@ -54,6 +53,7 @@
 #include "modplatform/atlauncher/ATLPackManifest.h"
 #include "net/ChecksumValidator.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 
 #include "net/ApiDownload.h"
 
@@ -630,6 +630,7 @@ void PackInstallTask::installConfigs()
     qDebug() << "PackInstallTask::installConfigs: " << QThread::currentThreadId();
     setStatus(tr("Downloading configs..."));
     jobPtr.reset(new NetJob(tr("Config download"), APPLICATION->network()));
+    jobPtr->setPriority(Net::Priority::Bulk);
 
     auto path = QString("Configs/%1/%2.zip").arg(m_pack_safe_name).arg(m_version_name);
     auto url = QString(BuildConfig.ATL_DOWNLOAD_SERVER_URL + "packs/%1/versions/%2/Configs.zip").arg(m_pack_safe_name).arg(m_version_name);
@@ -681,16 +682,31 @@ void PackInstallTask::extractConfigs()
         return;
     }
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath,
-                                        extractDir.absolutePath() + "/minecraft");
-#else
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/minecraft");
-#endif
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, [&]() { downloadMods(); });
-    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [&]() { emitAborted(); });
+    // the mods are downloaded meanwhile, what they put in place waits for the configs
+    auto cancel = cancellationToken();
+    auto target = extractDir.absolutePath() + "/minecraft";
+    m_extractFuture = Executor::instance()->run(
+        Executor::Priority::Bulk, [archivePath, target, cancel] { return MMCZip::extractDir(archivePath, target, cancel); }, cancel);
+    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onConfigsExtracted);
+    connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, [this] {
+        if (isRunning())
+            emitAborted();
+    });
     m_extractFutureWatcher.setFuture(m_extractFuture);
+    downloadMods();
+}
+
+void PackInstallTask::onConfigsExtracted()
+{
+    qDebug() << "PackInstallTask::onConfigsExtracted: " << QThread::currentThreadId();
+    if (!isRunning() || m_extractFuture.isCanceled())
+        return;
+    m_configsExtracted = true;
+    for (auto& job : m_pendingModJobs)
+        queueModJob(std::move(job));
+    m_pendingModJobs.clear();
+    if (m_modsDownloaded)
+        waitForModJobs();
 }
 
 void PackInstallTask::downloadMods()
@@ -720,6 +736,7 @@ void PackInstallTask::downloadMods()
 
     jarmods.clear();
     jobPtr.reset(new NetJob(tr("Mod download"), APPLICATION->network()));
+    jobPtr->setPriority(Net::Priority::Bulk);
 
     QList<VersionMod> blocked_mods;
     for (const auto& mod : m_version.mods) {
@@ -754,24 +771,24 @@ void PackInstallTask::downloadMods()
         if (mod.type == ModType::Extract || mod.type == ModType::TexturePackExtract || mod.type == ModType::ResourcePackExtract) {
             auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
             entry->setStale(true);
-            modsToExtract.insert(entry->getFullPath(), mod);
 
             auto dl = Net::ApiDownload::makeCached(url, entry);
             if (!mod.md5.isEmpty()) {
                 auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
                 dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
             }
+            connect(dl.get(), &Task::succeeded, this, [this, path = entry->getFullPath(), mod] { queueExtractMod(path, mod); });
             jobPtr->addNetAction(dl);
         } else if (mod.type == ModType::Decomp) {
             auto entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", cacheName);
             entry->setStale(true);
-            modsToDecomp.insert(entry->getFullPath(), mod);
 
             auto dl = Net::ApiDownload::makeCached(url, entry);
             if (!mod.md5.isEmpty()) {
                 auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
                 dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
             }
+            connect(dl.get(), &Task::succeeded, this, [this, path = entry->getFullPath(), mod] { queueDecompMod(path, mod); });
             jobPtr->addNetAction(dl);
         } else {
             auto relpath = getDirForModType(mod.type, mod.type_raw);
@@ -808,7 +825,7 @@ void PackInstallTask::downloadMods()
 
             // Download after Forge handling, to avoid downloading Forge twice.
             qDebug() << "Will download" << url << "to" << path;
-            modsToCopy[entry->getFullPath()] = path;
+            connect(dl.get(), &Task::succeeded, this, [this, from = entry->getFullPath(), path] { queueCopyMod(from, path); });
         }
     }
     if (!blocked_mods.isEmpty()) {
@@ -819,6 +836,7 @@ void PackInstallTask::downloadMods()
             blocked_mod.name = mod.file;
             blocked_mod.websiteUrl = mod.url;
             blocked_mod.hash = mod.md5;
+            blocked_mod.size = mod.filesize > 0 ? mod.filesize : -1;
             blocked_mod.matched = false;
             blocked_mod.localPath = "";
 
@@ -847,9 +865,9 @@ void PackInstallTask::downloadMods()
                     continue;
                 auto mod = *modIter;
                 if (mod.type == ModType::Extract || mod.type == ModType::TexturePackExtract || mod.type == ModType::ResourcePackExtract) {
-                    modsToExtract.insert(blocked.localPath, mod);
+                    queueExtractMod(blocked.localPath, mod);
                 } else if (mod.type == ModType::Decomp) {
-                    modsToDecomp.insert(blocked.localPath, mod);
+                    queueDecompMod(blocked.localPath, mod);
                 } else {
                     auto relpath = getDirForModType(mod.type, mod.type_raw);
                     if (relpath == Q_NULLPTR)
@@ -873,7 +891,7 @@ void PackInstallTask::downloadMods()
                         jarmods.push_back(path);
                     }
 
-                    modsToCopy[blocked.localPath] = path;
+                    queueCopyMod(blocked.localPath, path);
                 }
             }
         } else {
@@ -902,25 +920,43 @@ void PackInstallTask::onModsDownloaded()
     qDebug() << "PackInstallTask::onModsDownloaded: " << QThread::currentThreadId();
     jobPtr.reset();
 
-    if (!modsToExtract.empty() || !modsToDecomp.empty() || !modsToCopy.empty()) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        m_modExtractFuture =
-            QtConcurrent::run(QThreadPool::globalInstance(), &PackInstallTask::extractMods, this, modsToExtract, modsToDecomp, modsToCopy);
-#else
-        m_modExtractFuture =
-            QtConcurrent::run(QThreadPool::globalInstance(), this, &PackInstallTask::extractMods, modsToExtract, modsToDecomp, modsToCopy);
-#endif
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
-        connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::emitAborted);
-        m_modExtractFutureWatcher.setFuture(m_modExtractFuture);
-    } else {
+    m_modsDownloaded = true;
+    if (m_version.noConfigs || m_configsExtracted)
+        waitForModJobs();
+    // or when the configs are extracted, with the mods that waited for them
+}
+
+void PackInstallTask::waitForModJobs()
+{
+    if (m_modJobs.isEmpty()) {
         install();
+        return;
     }
+
+    // most of the mods are in place already, the rest is done by whichever threads are free
+    setStatus(tr("Extracting mods..."));
+    m_modExtractFuture = Executor::instance()->run(
+        Executor::Priority::Bulk,
+        [jobs = m_modJobs] {
+            bool ok = true;
+            for (auto& job : jobs) {
+                Executor::instance()->waitFor(job);
+                ok = ok && !job.isCanceled() && job.result();
+            }
+            return ok;
+        },
+        cancellationToken());
+    m_modJobs.clear();
+    connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onModsExtracted);
+    connect(&m_modExtractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::emitAborted);
+    m_modExtractFutureWatcher.setFuture(m_modExtractFuture);
 }
 
 void PackInstallTask::onModsExtracted()
 {
     qDebug() << "PackInstallTask::onModsExtracted: " << QThread::currentThreadId();
+    if (!isRunning())
+        return;
     if (m_modExtractFuture.result()) {
         install();
     } else {
@@ -928,61 +964,66 @@ void PackInstallTask::onModsExtracted()
     }
 }
 
-bool PackInstallTask::extractMods(const QMap<QString, VersionMod>& toExtract,
-                                  const QMap<QString, VersionMod>& toDecomp,
-                                  const QMap<QString, QString>& toCopy)
+void PackInstallTask::queueModJob(std::function<bool()> job)
 {
-    qDebug() << "PackInstallTask::extractMods: " << QThread::currentThreadId();
+    // the mods overwrite what came with the configs, so they wait for those
+    if (!m_version.noConfigs && !m_configsExtracted) {
+        m_pendingModJobs.append(std::move(job));
+        return;
+    }
+    m_modJobs.append(Executor::instance()->run(Executor::Priority::Bulk, std::move(job), cancellationToken()));
+}
 
-    setStatus(tr("Extracting mods..."));
-    for (auto iter = toExtract.begin(); iter != toExtract.end(); iter++) {
-        auto& modPath = iter.key();
-        auto& mod = iter.value();
-
-        QString extractToDir;
-        if (mod.type == ModType::Extract) {
-            extractToDir = getDirForModType(mod.extractTo, mod.extractTo_raw);
-        } else if (mod.type == ModType::TexturePackExtract) {
-            extractToDir = FS::PathCombine("texturepacks", "extracted");
-        } else if (mod.type == ModType::ResourcePackExtract) {
-            extractToDir = FS::PathCombine("resourcepacks", "extracted");
-        }
+void PackInstallTask::queueExtractMod(const QString& modPath, const VersionMod& mod)
+{
+    QString extractToDir;
+    if (mod.type == ModType::Extract) {
+        extractToDir = getDirForModType(mod.extractTo, mod.extractTo_raw);
+    } else if (mod.type == ModType::TexturePackExtract) {
+        extractToDir = FS::PathCombine("texturepacks", "extracted");
+    } else if (mod.type == ModType::ResourcePackExtract) {
+        extractToDir = FS::PathCombine("resourcepacks", "extracted");
+    }
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
+    QDir extractDir(m_stagingPath);
+    auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir);
 
-        QString folderToExtract = "";
-        if (mod.type == ModType::Extract) {
-            folderToExtract = mod.extractFolder;
-            folderToExtract.remove(QRegularExpression("^/"));
-        }
+    QString folderToExtract = "";
+    if (mod.type == ModType::Extract) {
+        folderToExtract = mod.extractFolder;
+        folderToExtract.remove(QRegularExpression("^/"));
+    }
 
-        qDebug() << "Extracting " + mod.file + " to " + extractToDir;
+    queueModJob([modPath, folderToExtract, extractToPath, file = mod.file, extractToDir] {
+        qDebug() << "Extracting " + file + " to " + extractToDir;
         if (!MMCZip::extractDir(modPath, folderToExtract, extractToPath)) {
-            // assume error
+            qWarning() << "Failed to extract" << file;
             return false;
         }
-    }
+        return true;
+    });
+}
 
-    for (auto iter = toDecomp.begin(); iter != toDecomp.end(); iter++) {
-        auto& modPath = iter.key();
-        auto& mod = iter.value();
-        auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
+void PackInstallTask::queueDecompMod(const QString& modPath, const VersionMod& mod)
+{
+    auto extractToDir = getDirForModType(mod.decompType, mod.decompType_raw);
 
-        QDir extractDir(m_stagingPath);
-        auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
+    QDir extractDir(m_stagingPath);
+    auto extractToPath = FS::PathCombine(extractDir.absolutePath(), "minecraft", extractToDir, mod.decompFile);
 
-        qDebug() << "Extracting " + mod.decompFile + " to " + extractToDir;
-        if (!MMCZip::extractFile(modPath, mod.decompFile, extractToPath)) {
-            qWarning() << "Failed to extract" << mod.decompFile;
+    queueModJob([modPath, extractToPath, file = mod.decompFile, extractToDir] {
+        qDebug() << "Extracting " + file + " to " + extractToDir;
+        if (!MMCZip::extractFile(modPath, file, extractToPath)) {
+            qWarning() << "Failed to extract" << file;
             return false;
         }
-    }
-
-    for (auto iter = toCopy.begin(); iter != toCopy.end(); iter++) {
-        auto& from = iter.key();
-        auto& to = iter.value();
+        return true;
+    });
+}
 
+void PackInstallTask::queueCopyMod(const QString& from, const QString& to)
+{
+    queueModJob([from, to] {
         // If the file already exists, assume the mod is the correct copy - and remove
         // the copy from the Configs.zip
         QFileInfo fileInfo(to);
@@ -998,8 +1039,8 @@ bool PackInstallTask::extractMods(const QMap<QString, VersionMod>& toExtract,
             qWarning() << "Failed to copy" << from << "to" << to;
             return false;
         }
-    }
-    return true;
+        return true;
+    });
 }
 
 void PackInstallTask::install()
@@ -46,6 +46,7 @@
 #include "net/NetJob.h"
 #include "settings/INISettingsObject.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -99,6 +100,7 @@ class PackInstallTask : public InstanceTask {
     void onDownloadFailed(QString reason);
     void onDownloadAborted();
 
+    void onConfigsExtracted();
     void onModsDownloaded();
     void onModsExtracted();
 
@@ -114,9 +116,12 @@ class PackInstallTask : public InstanceTask {
     void installConfigs();
     void extractConfigs();
     void downloadMods();
-    bool extractMods(const QMap<QString, VersionMod>& toExtract,
-                     const QMap<QString, VersionMod>& toDecomp,
-                     const QMap<QString, QString>& toCopy);
+    // each mod is put in place as soon as it's there, on whichever thread is free
+    void queueModJob(std::function<bool()> job);
+    void queueExtractMod(const QString& modPath, const VersionMod& mod);
+    void queueDecompMod(const QString& modPath, const VersionMod& mod);
+    void queueCopyMod(const QString& from, const QString& to);
+    void waitForModJobs();
     void install();
 
    private:
@@ -133,9 +138,11 @@ class PackInstallTask : public InstanceTask {
     QString m_version_name;
     PackVersion m_version;
 
-    QMap<QString, VersionMod> modsToExtract;
-    QMap<QString, VersionMod> modsToDecomp;
-    QMap<QString, QString> modsToCopy;
+    // what waits for the configs to be extracted, and what's running
+    QList<std::function<bool()>> m_pendingModJobs;
+    QList<QFuture<bool>> m_modJobs;
+    bool m_configsExtracted = false;
+    bool m_modsDownloaded = false;
 
     QString archivePath;
     QStringList jarmods;
@@ -1,13 +1,20 @@
 #include "FileResolvingTask.h"
 
+#include <QSet>
+
+#include <algorithm>
+
+#include "FlameFileCache.h"
 #include "Json.h"
 #include "modplatform/ModIndex.h"
-#include "net/ApiDownload.h"
 #include "net/ApiUpload.h"
 #include "net/Upload.h"
 
 #include "modplatform/modrinth/ModrinthPackIndex.h"
 
+// IDs sent in a single bulk request, big packs take a few of them
+static constexpr int s_batchSize = 500;
+
 Flame::FileResolvingTask::FileResolvingTask(const shared_qobject_ptr<QNetworkAccessManager>& network, Flame::Manifest& toProcess)
     : m_network(network), m_toProcess(toProcess)
 {}
@@ -19,198 +26,254 @@ bool Flame::FileResolvingTask::abort()
         aborted &= m_dljob->abort();
     if (m_checkJob)
         aborted &= m_checkJob->abort();
+    if (m_slugJob)
+        aborted &= m_slugJob->abort();
     return aborted ? Task::abort() : false;
 }
 
-void Flame::FileResolvingTask::executeTask()
+void Flame::FileResolvingTask::startJob(const NetJob::Ptr& job, const std::function<void()>& next)
 {
-    if (m_toProcess.files.isEmpty()) {  // no file to resolve so leave it empty and emit success immediately
-        emitSucceeded();
-        return;
-    }
-    setStatus(tr("Resolving mod IDs..."));
-    setProgress(0, 3);
-    m_dljob.reset(new NetJob("Mod id resolver", m_network));
-    result.reset(new QByteArray());
-    // build json data to send
-    QJsonObject object;
-
-    object["fileIds"] = QJsonArray::fromVariantList(
-        std::accumulate(m_toProcess.files.begin(), m_toProcess.files.end(), QVariantList(), [](QVariantList& l, const File& s) {
-            l.push_back(s.fileId);
-            return l;
-        }));
-    QByteArray data = Json::toText(object);
-    auto dl = Net::ApiUpload::makeByteArray(QUrl("https://api.curseforge.com/v1/mods/files"), result, data);
-    m_dljob->addNetAction(dl);
-
     auto step_progress = std::make_shared<TaskStepProgress>();
-    connect(m_dljob.get(), &NetJob::finished, this, [this, step_progress]() {
+    connect(job.get(), &NetJob::succeeded, this, [this, step_progress, next]() {
         step_progress->state = TaskStepState::Succeeded;
         stepProgress(*step_progress);
-        netJobFinished();
+        next();
     });
-    connect(m_dljob.get(), &NetJob::failed, this, [this, step_progress](QString reason) {
+    connect(job.get(), &NetJob::failed, this, [this, step_progress](QString reason) {
         step_progress->state = TaskStepState::Failed;
         stepProgress(*step_progress);
         emitFailed(reason);
     });
-    connect(m_dljob.get(), &NetJob::stepProgress, this, &FileResolvingTask::propagateStepProgress);
-    connect(m_dljob.get(), &NetJob::progress, this, [this, step_progress](qint64 current, qint64 total) {
-        qDebug() << "Resolve slug progress" << current << total;
+    connect(job.get(), &NetJob::stepProgress, this, &FileResolvingTask::propagateStepProgress);
+    connect(job.get(), &NetJob::progress, this, [this, step_progress](qint64 current, qint64 total) {
         step_progress->update(current, total);
         stepProgress(*step_progress);
     });
-    connect(m_dljob.get(), &NetJob::status, this, [this, step_progress](QString status) {
+    connect(job.get(), &NetJob::status, this, [this, step_progress](QString status) {
         step_progress->status = status;
         stepProgress(*step_progress);
     });
 
-    m_dljob->start();
+    job->start();
+}
+
+void Flame::FileResolvingTask::applyFile(File& out, const QJsonObject& file)
+{
+    try {
+        out.parseFromObject(file);
+    } catch ([[maybe_unused]] const JSONValidationError& e) {
+        qDebug() << "Blocked mod on curseforge" << out.fileName;
+        m_blocked.append(&out);
+    }
+}
+
+void Flame::FileResolvingTask::executeTask()
+{
+    if (m_toProcess.files.isEmpty()) {  // no file to resolve so leave it empty and emit success immediately
+        emitSucceeded();
+        return;
+    }
+    setStatus(tr("Resolving mod IDs..."));
+    setProgress(0, 3);
+    m_blocked.clear();
+    m_results.clear();
+
+    QList<int> unknown;
+    auto cache = FileCache::shared();
+    for (auto& file : m_toProcess.files) {
+        if (auto cached = cache ? cache->file(file.projectId, file.fileId) : std::nullopt) {
+            applyFile(file, *cached);
+        } else {
+            unknown.append(file.fileId);
+        }
+    }
+    qDebug() << "Resolving" << unknown.size() << "of" << m_toProcess.files.size() << "files on CurseForge, the rest was known already";
+    if (unknown.isEmpty()) {
+        netJobFinished();
+        return;
+    }
+
+    m_dljob.reset(new NetJob("Mod id resolver", m_network));
+    for (int i = 0; i < unknown.size(); i += s_batchSize) {
+        // build json data to send
+        QJsonArray ids;
+        for (auto id : unknown.mid(i, s_batchSize))
+            ids.append(id);
+        QJsonObject object;
+        object["fileIds"] = ids;
+        auto result = std::make_shared<QByteArray>();
+        m_results.append(result);
+        auto url = QUrl("https://api.curseforge.com/v1/mods/files");
+        m_dljob->addNetAction(Net::ApiUpload::makeByteArray(url, result, Json::toText(object)));
+    }
+    startJob(m_dljob, [this] { netJobFinished(); });
 }
 
 void Flame::FileResolvingTask::netJobFinished()
 {
     setProgress(1, 3);
-    // job to check modrinth for blocked projects
-    m_checkJob.reset(new NetJob("Modrinth check", m_network));
-    blockedProjects = QMap<File*, std::shared_ptr<QByteArray>>();
+    auto cache = FileCache::shared();
 
-    QJsonDocument doc;
-    QJsonArray array;
+    for (auto& result : m_results) {
+        QJsonArray array;
+        try {
+            auto doc = Json::requireDocument(*result);
+            array = Json::requireArray(doc.object()["data"]);
+        } catch (Json::JsonException& e) {
+            qCritical() << "Non-JSON data returned from the CF API";
+            qCritical() << e.cause();
 
-    try {
-        doc = Json::requireDocument(*result);
-        array = Json::requireArray(doc.object()["data"]);
-    } catch (Json::JsonException& e) {
-        qCritical() << "Non-JSON data returned from the CF API";
-        qCritical() << e.cause();
+            emitFailed(tr("Invalid data returned from the API."));
 
-        emitFailed(tr("Invalid data returned from the API."));
+            return;
+        }
 
-        return;
+        for (QJsonValueRef value : array) {
+            auto file = Json::requireObject(value);
+            auto fileid = Json::requireInteger(file, "id");
+            auto out = m_toProcess.files.find(fileid);
+            if (out == m_toProcess.files.end())
+                continue;
+            if (cache)
+                cache->putFile(file);
+            applyFile(*out, file);
+        }
     }
+    m_results.clear();
 
-    for (QJsonValueRef file : array) {
-        auto fileid = Json::requireInteger(Json::requireObject(file)["id"]);
-        auto& out = m_toProcess.files[fileid];
-        try {
-            out.parseFromObject(Json::requireObject(file));
-        } catch ([[maybe_unused]] const JSONValidationError& e) {
-            qDebug() << "Blocked mod on curseforge" << out.fileName;
-            auto hash = out.hash;
-            if (!hash.isEmpty()) {
-                auto url = QString("https://api.modrinth.com/v2/version_file/%1?algorithm=sha1").arg(hash);
-                auto output = std::make_shared<QByteArray>();
-                auto dl = Net::ApiDownload::makeByteArray(QUrl(url), output);
-                QObject::connect(dl.get(), &Net::ApiDownload::succeeded, [&out]() { out.resolved = true; });
-
-                m_checkJob->addNetAction(dl);
-                blockedProjects.insert(&out, output);
-            }
+    // check modrinth for the blocked projects it has as well
+    m_checkedHashes.clear();
+    for (auto* out : m_blocked) {
+        if (out->hash.isEmpty() || m_checkedHashes.contains(out->hash))
+            continue;
+        if (auto cached = cache ? cache->modrinthVersion(out->hash) : std::nullopt) {
+            applyModrinthVersion(*out, *cached);
+        } else {
+            m_checkedHashes.append(out->hash);
         }
     }
-    auto step_progress = std::make_shared<TaskStepProgress>();
-    connect(m_checkJob.get(), &NetJob::finished, this, [this, step_progress]() {
-        step_progress->state = TaskStepState::Succeeded;
-        stepProgress(*step_progress);
+    if (m_checkedHashes.isEmpty()) {
         modrinthCheckFinished();
-    });
-    connect(m_checkJob.get(), &NetJob::failed, this, [this, step_progress](QString reason) {
-        step_progress->state = TaskStepState::Failed;
-        stepProgress(*step_progress);
-        emitFailed(reason);
-    });
-    connect(m_checkJob.get(), &NetJob::stepProgress, this, &FileResolvingTask::propagateStepProgress);
-    connect(m_checkJob.get(), &NetJob::progress, this, [this, step_progress](qint64 current, qint64 total) {
-        qDebug() << "Resolve slug progress" << current << total;
-        step_progress->update(current, total);
-        stepProgress(*step_progress);
-    });
-    connect(m_checkJob.get(), &NetJob::status, this, [this, step_progress](QString status) {
-        step_progress->status = status;
-        stepProgress(*step_progress);
-    });
+        return;
+    }
 
-    m_checkJob->start();
+    m_checkJob.reset(new NetJob("Modrinth check", m_network));
+    QJsonObject object;
+    Json::writeStringList(object, "hashes", m_checkedHashes);
+    Json::writeString(object, "algorithm", "sha1");
+    auto result = std::make_shared<QByteArray>();
+    m_results.append(result);
+    auto url = QUrl("https://api.modrinth.com/v2/version_files");
+    m_checkJob->addNetAction(Net::ApiUpload::makeByteArray(url, result, Json::toText(object)));
+    startJob(m_checkJob, [this] { modrinthCheckFinished(); });
+}
+
+void Flame::FileResolvingTask::applyModrinthVersion(File& out, QJsonObject version)
+{
+    if (version.isEmpty())
+        return;
+
+    ModPlatform::IndexedVersion file;
+    try {
+        file = Modrinth::loadIndexedPackVersion(version);
+    } catch (Json::JsonException& e) {
+        qWarning() << "Invalid version from Modrinth for" << out.fileName << e.cause();
+        return;
+    }
+
+    // If there's more than one mod loader for this version, we can't know for sure
+    // which file is relative to each loader, so it's best to not use any one and
+    // let the user download it manually.
+    if (!file.loaders || hasSingleModLoaderSelected(file.loaders)) {
+        out.url = file.downloadUrl;
+        out.resolved = true;
+        qDebug() << "Found alternative on modrinth " << out.fileName;
+    }
 }
 
 void Flame::FileResolvingTask::modrinthCheckFinished()
 {
     setProgress(2, 3);
-    qDebug() << "Finished with blocked mods : " << blockedProjects.size();
+    auto cache = FileCache::shared();
 
-    for (auto it = blockedProjects.keyBegin(); it != blockedProjects.keyEnd(); it++) {
-        auto& out = *it;
-        auto bytes = blockedProjects[out];
-        if (!out->resolved) {
-            continue;
+    if (!m_checkedHashes.isEmpty()) {
+        // hashes Modrinth doesn't know are left out
+        auto versions = QJsonDocument::fromJson(*m_results.first()).object();
+        for (auto& hash : m_checkedHashes) {
+            auto version = versions.value(hash).toObject();
+            if (cache)
+                cache->putModrinthVersion(hash, version);
+            for (auto* out : m_blocked) {
+                if (out->hash == hash)
+                    applyModrinthVersion(*out, version);
+            }
         }
+        m_results.clear();
+        m_checkedHashes.clear();
+    }
 
-        QJsonDocument doc = QJsonDocument::fromJson(*bytes);
-        auto obj = doc.object();
-        auto file = Modrinth::loadIndexedPackVersion(obj);
+    // filter out projects found on modrinth
+    m_blocked.erase(std::remove_if(m_blocked.begin(), m_blocked.end(), [](File* f) { return f->resolved; }), m_blocked.end());
+    qDebug() << "Finished with blocked mods : " << m_blocked.size();
 
-        // If there's more than one mod loader for this version, we can't know for sure
-        // which file is relative to each loader, so it's best to not use any one and
-        // let the user download it manually.
-        if (!file.loaders || hasSingleModLoaderSelected(file.loaders)) {
-            out->url = file.downloadUrl;
-            qDebug() << "Found alternative on modrinth " << out->fileName;
-        } else {
-            out->resolved = false;
+    // blocked mods found, we need the slug for displaying, ask for all the unknown ones at once
+    QSet<int> projects;
+    m_slugProjects.clear();
+    for (auto* mod : m_blocked) {
+        auto base = cache ? cache->websiteUrl(mod->projectId) : QString();
+        if (!base.isEmpty()) {
+            mod->websiteUrl = QString("%1/download/%2").arg(base, QString::number(mod->fileId));
+        } else if (!projects.contains(mod->projectId)) {
+            projects.insert(mod->projectId);
+            m_slugProjects.append(mod->projectId);
         }
     }
-    // copy to an output list and filter out projects found on modrinth
-    auto block = std::make_shared<QList<File*>>();
-    auto it = blockedProjects.keys();
-    std::copy_if(it.begin(), it.end(), std::back_inserter(*block), [](File* f) { return !f->resolved; });
-    // Display not found mods early
-    if (!block->empty()) {
-        // blocked mods found, we need the slug for displaying.... we need another job :D !
-        m_slugJob.reset(new NetJob("Slug Job", m_network));
-        int index = 0;
-        for (auto mod : *block) {
-            auto projectId = mod->projectId;
-            auto output = std::make_shared<QByteArray>();
-            auto url = QString("https://api.curseforge.com/v1/mods/%1").arg(projectId);
-            auto dl = Net::ApiDownload::makeByteArray(url, output);
-            qDebug() << "Fetching url slug for file:" << mod->fileName;
-            QObject::connect(dl.get(), &Net::ApiDownload::succeeded, [block, index, output]() {
-                auto mod = block->at(index);  // use the shared_ptr so it is captured and only freed when we are done
-                auto json = QJsonDocument::fromJson(*output);
-                auto base =
-                    Json::requireString(Json::requireObject(Json::requireObject(Json::requireObject(json), "data"), "links"), "websiteUrl");
-                auto link = QString("%1/download/%2").arg(base, QString::number(mod->fileId));
-                mod->websiteUrl = link;
-            });
-            m_slugJob->addNetAction(dl);
-            index++;
-        }
-        auto step_progress = std::make_shared<TaskStepProgress>();
-        connect(m_slugJob.get(), &NetJob::succeeded, this, [this, step_progress]() {
-            step_progress->state = TaskStepState::Succeeded;
-            stepProgress(*step_progress);
-            emitSucceeded();
-        });
-        connect(m_slugJob.get(), &NetJob::failed, this, [this, step_progress](QString reason) {
-            step_progress->state = TaskStepState::Failed;
-            stepProgress(*step_progress);
-            emitFailed(reason);
-        });
-        connect(m_slugJob.get(), &NetJob::stepProgress, this, &FileResolvingTask::propagateStepProgress);
-        connect(m_slugJob.get(), &NetJob::progress, this, [this, step_progress](qint64 current, qint64 total) {
-            qDebug() << "Resolve slug progress" << current << total;
-            step_progress->update(current, total);
-            stepProgress(*step_progress);
-        });
-        connect(m_slugJob.get(), &NetJob::status, this, [this, step_progress](QString status) {
-            step_progress->status = status;
-            stepProgress(*step_progress);
-        });
-
-        m_slugJob->start();
-    } else {
+    if (m_slugProjects.isEmpty()) {
         emitSucceeded();
+        return;
+    }
+
+    m_slugJob.reset(new NetJob("Slug Job", m_network));
+    for (int i = 0; i < m_slugProjects.size(); i += s_batchSize) {
+        QJsonArray ids;
+        for (auto id : m_slugProjects.mid(i, s_batchSize))
+            ids.append(id);
+        QJsonObject object;
+        object["modIds"] = ids;
+        auto result = std::make_shared<QByteArray>();
+        m_results.append(result);
+        m_slugJob->addNetAction(Net::ApiUpload::makeByteArray(QUrl("https://api.curseforge.com/v1/mods"), result, Json::toText(object)));
+    }
+    startJob(m_slugJob, [this] { slugJobFinished(); });
+}
+
+void Flame::FileResolvingTask::slugJobFinished()
+{
+    auto cache = FileCache::shared();
+
+    QHash<int, QString> websites;
+    for (auto& result : m_results) {
+        try {
+            auto doc = Json::requireDocument(*result);
+            for (auto value : Json::requireArray(Json::requireObject(doc), "data")) {
+                auto project = Json::requireObject(value);
+                auto base = Json::ensureString(Json::ensureObject(project, "links"), "websiteUrl");
+                auto id = Json::requireInteger(project, "id");
+                websites.insert(id, base);
+                if (cache)
+                    cache->putWebsiteUrl(id, base);
+            }
+        } catch (Json::JsonException& e) {
+            // only used for showing where to get the file, not worth failing over
+            qWarning() << "Couldn't get the website of blocked projects:" << e.cause();
+        }
+    }
+    m_results.clear();
+
+    for (auto* mod : m_blocked) {
+        auto base = websites.value(mod->projectId);
+        if (!base.isEmpty())
+            mod->websiteUrl = QString("%1/download/%2").arg(base, QString::number(mod->fileId));
     }
+    emitSucceeded();
 }
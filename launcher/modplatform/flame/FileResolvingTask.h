@@ -1,10 +1,19 @@
 #pragma once
 
+#include <functional>
+
 #include "PackManifest.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
 
 namespace Flame {
+/**
+ * Resolves the files of a pack manifest into something that can be downloaded.
+ *
+ * What the API said about a file is kept in the Flame::FileCache, so only the files that aren't known yet are asked
+ * about, in as few bulk requests as possible. Files that can't be downloaded from CurseForge are looked up on Modrinth
+ * and, failing that, get the link to their page on CurseForge.
+ */
 class FileResolvingTask : public Task {
     Q_OBJECT
    public:
@@ -22,16 +31,30 @@ class FileResolvingTask : public Task {
    protected slots:
     void netJobFinished();
 
+   private:
+    void modrinthCheckFinished();
+    void slugJobFinished();
+
+    /// take in a file object from the API, remembering the blocked ones
+    void applyFile(File& out, const QJsonObject& file);
+    /// use the version of a blocked file Modrinth has, if it has one we can use
+    void applyModrinthVersion(File& out, QJsonObject version);
+    /// start one of the lookups, calling next once it's done
+    void startJob(const NetJob::Ptr& job, const std::function<void()>& next);
+
    private: /* data */
     shared_qobject_ptr<QNetworkAccessManager> m_network;
     Flame::Manifest m_toProcess;
-    std::shared_ptr<QByteArray> result;
+    QList<std::shared_ptr<QByteArray>> m_results;
     NetJob::Ptr m_dljob;
     NetJob::Ptr m_checkJob;
     NetJob::Ptr m_slugJob;
 
-    void modrinthCheckFinished();
-
-    QMap<File*, std::shared_ptr<QByteArray>> blockedProjects;
+    // files that can't be downloaded from CurseForge
+    QList<File*> m_blocked;
+    // the hashes asked about on Modrinth
+    QStringList m_checkedHashes;
+    // the projects asked about for their website
+    QList<int> m_slugProjects;
 };
 }  // namespace Flame
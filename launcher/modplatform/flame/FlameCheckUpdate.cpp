@@ -1,8 +1,11 @@
 #include "FlameCheckUpdate.h"
 #include "FlameAPI.h"
+#include "FlameFileCache.h"
 #include "FlameModIndex.h"
 
 #include <MurmurHash2.h>
+#include <QDateTime>
+#include <QHash>
 #include <memory>
 
 #include "Json.h"
@@ -16,6 +19,40 @@
 
 static FlameAPI api;
 
+namespace {
+// how long an answer from CurseForge is trusted, checking again right after doesn't ask for every mod again
+constexpr qint64 s_answerTtl = 15 * 60;
+
+struct LatestVersion {
+    // when CurseForge was asked, in seconds since epoch
+    qint64 fetched = 0;
+    ModPlatform::IndexedVersion version;
+};
+// keyed by what was asked for and the project
+QHash<QString, LatestVersion> s_latestVersions;
+// the changelog of a file doesn't change, keyed by project and file
+QHash<QString, QString> s_changelogs;
+
+QString requestKey(const QString& project, const std::list<Version>& mcVersions, std::optional<ModPlatform::ModLoaderTypes> loaders)
+{
+    QStringList parts{ project, QString::number(loaders ? int(*loaders) : -1) };
+    for (auto& ver : mcVersions)
+        parts.append(ver.toString());
+    return parts.join(',');
+}
+
+QString changelog(const ModPlatform::IndexedVersion& version)
+{
+    auto key = version.addonId.toString() + ':' + version.fileId.toString();
+    if (auto cached = s_changelogs.constFind(key); cached != s_changelogs.constEnd())
+        return *cached;
+    auto text = api.getModFileChangelog(version.addonId.toInt(), version.fileId.toInt());
+    if (!text.isEmpty())
+        s_changelogs.insert(key, text);
+    return text;
+}
+}  // namespace
+
 bool FlameCheckUpdate::abort()
 {
     m_was_aborted = true;
@@ -72,6 +109,16 @@ ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId)
 {
     ModPlatform::IndexedVersion ver;
 
+    // installed files are usually known from installing them
+    auto cache = Flame::FileCache::shared();
+    if (auto cached = cache ? cache->file(addonId, fileId) : std::nullopt) {
+        try {
+            return FlameMod::loadIndexedPackVersion(*cached);
+        } catch (Json::JsonException& e) {
+            qWarning() << e.cause();
+        }
+    }
+
     QEventLoop loop;
 
     auto get_file_info_job = new NetJob("Flame::GetFileInfoJob", APPLICATION->network());
@@ -81,7 +128,7 @@ ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId)
     auto dl = Net::ApiDownload::makeByteArray(url, response);
     get_file_info_job->addNetAction(dl);
 
-    QObject::connect(get_file_info_job, &NetJob::succeeded, [response, &ver]() {
+    QObject::connect(get_file_info_job, &NetJob::succeeded, [response, &ver, cache]() {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -95,6 +142,8 @@ ModPlatform::IndexedVersion getFileInfo(int addonId, int fileId)
             auto doc_obj = Json::requireObject(doc);
             auto data_obj = Json::requireObject(doc_obj, "data");
             ver = FlameMod::loadIndexedPackVersion(data_obj);
+            if (cache)
+                cache->putFile(data_obj);
         } catch (Json::JsonException& e) {
             qWarning() << e.cause();
             qDebug() << doc;
@@ -131,12 +180,23 @@ void FlameCheckUpdate::executeTask()
         setStatus(tr("Getting API response from CurseForge for '%1'...").arg(mod->name()));
         setProgress(i++, m_mods.size());
 
-        auto latest_ver = api.getLatestVersion({ { mod->metadata()->project_id.toString() }, m_game_versions, m_loaders });
-
-        // Check if we were aborted while getting the latest version
-        if (m_was_aborted) {
-            aborted();
-            return;
+        auto project = mod->metadata()->project_id.toString();
+        auto key = requestKey(project, m_game_versions, m_loaders);
+        ModPlatform::IndexedVersion latest_ver;
+        if (auto cached = s_latestVersions.constFind(key);
+            cached != s_latestVersions.constEnd() && cached->fetched >= QDateTime::currentSecsSinceEpoch() - s_answerTtl) {
+            latest_ver = cached->version;
+        } else {
+            latest_ver = api.getLatestVersion({ { project }, m_game_versions, m_loaders });
+
+            // Check if we were aborted while getting the latest version
+            if (m_was_aborted) {
+                aborted();
+                return;
+            }
+            // no version may as well be a failed request, that's asked again
+            if (latest_ver.addonId.isValid())
+                s_latestVersions.insert(key, { QDateTime::currentSecsSinceEpoch(), latest_ver });
         }
 
         setStatus(tr("Parsing the API response from CurseForge for '%1'...").arg(mod->name()));
@@ -148,8 +208,14 @@ void FlameCheckUpdate::executeTask()
         }
 
         if (latest_ver.downloadUrl.isEmpty() && latest_ver.fileId != mod->metadata()->file_id) {
-            auto pack = getProjectInfo(latest_ver);
-            auto recover_url = QString("%1/download/%2").arg(pack.websiteUrl, latest_ver.fileId.toString());
+            auto cache = Flame::FileCache::shared();
+            auto website = cache ? cache->websiteUrl(latest_ver.addonId.toInt()) : QString();
+            if (website.isEmpty()) {
+                website = getProjectInfo(latest_ver).websiteUrl;
+                if (cache)
+                    cache->putWebsiteUrl(latest_ver.addonId.toInt(), website);
+            }
+            auto recover_url = QString("%1/download/%2").arg(website, latest_ver.fileId.toString());
             emit checkFailed(mod, tr("Mod has a new update available, but is not downloadable using CurseForge."), recover_url);
 
             continue;
@@ -174,7 +240,7 @@ void FlameCheckUpdate::executeTask()
 
             auto download_task = makeShared<ResourceDownloadTask>(pack, latest_ver, m_mods_folder);
             m_updatable.emplace_back(pack->name, mod->metadata()->hash, old_version, latest_ver.version, latest_ver.version_type,
-                                     api.getModFileChangelog(latest_ver.addonId.toInt(), latest_ver.fileId.toInt()),
+                                     changelog(latest_ver),
                                      ModPlatform::ResourceProvider::FLAME, download_task);
         }
         m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, latest_ver));
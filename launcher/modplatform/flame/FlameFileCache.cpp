@@ -0,0 +1,225 @@
+#include "FlameFileCache.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "Application.h"
+#include "Exception.h"
+#include "Json.h"
+
+namespace Flame {
+
+// entries that weren't used for this long are dropped on save
+static constexpr qint64 maxUnusedAge = 90 * 24 * 60 * 60;
+// what can change on the CurseForge or Modrinth side is asked again after this long
+static constexpr qint64 maxVolatileAge = 24 * 60 * 60;
+
+static QString fileKey(int projectId, int fileId)
+{
+    return QString("%1:%2").arg(projectId).arg(fileId);
+}
+
+FileCache::FileCache(QString path) : QObject(), m_cache_file(path)
+{
+    m_saveBatchingTimer.setSingleShot(true);
+    m_saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&m_saveBatchingTimer, &QTimer::timeout, this, &FileCache::saveNow);
+}
+
+FileCache::~FileCache()
+{
+    m_saveBatchingTimer.stop();
+    saveNow();
+}
+
+FileCache* FileCache::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->flameFileCache().get() : nullptr;
+}
+
+std::optional<QJsonObject> FileCache::get(QHash<QString, Entry>& entries, const QString& key)
+{
+    QMutexLocker locker(&m_lock);
+    auto entry = entries.find(key);
+    if (entry == entries.end()) {
+        return {};
+    }
+    auto now = QDateTime::currentSecsSinceEpoch();
+    if (entry->isVolatile && entry->fetched < now - maxVolatileAge) {
+        entries.erase(entry);
+        return {};
+    }
+    entry->lastUsed = now;
+    return entry->data;
+}
+
+void FileCache::put(QHash<QString, Entry>& entries, const QString& key, const QJsonObject& data, bool isVolatile)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        auto& entry = entries[key];
+        entry.fetched = QDateTime::currentSecsSinceEpoch();
+        entry.lastUsed = entry.fetched;
+        entry.isVolatile = isVolatile;
+        entry.data = data;
+    }
+    saveEventually();
+}
+
+std::optional<QJsonObject> FileCache::file(int projectId, int fileId)
+{
+    return get(m_files, fileKey(projectId, fileId));
+}
+
+void FileCache::putFile(const QJsonObject& file)
+{
+    auto projectId = Json::ensureInteger(file, "modId");
+    auto fileId = Json::ensureInteger(file, "id");
+    if (projectId == 0 || fileId == 0)
+        return;
+    // blocked files have no download URL, they may not be blocked anymore
+    put(m_files, fileKey(projectId, fileId), file, Json::ensureString(file, "downloadUrl").isEmpty());
+}
+
+QString FileCache::websiteUrl(int projectId)
+{
+    auto project = get(m_projects, QString::number(projectId));
+    return project ? Json::ensureString(*project, "websiteUrl") : QString();
+}
+
+void FileCache::putWebsiteUrl(int projectId, const QString& url)
+{
+    if (url.isEmpty())
+        return;
+    QJsonObject project;
+    Json::writeString(project, "websiteUrl", url);
+    put(m_projects, QString::number(projectId), project, false);
+}
+
+std::optional<QJsonObject> FileCache::modrinthVersion(const QString& sha1)
+{
+    return get(m_modrinth, sha1);
+}
+
+void FileCache::putModrinthVersion(const QString& sha1, const QJsonObject& version)
+{
+    if (sha1.isEmpty())
+        return;
+    put(m_modrinth, sha1, version, true);
+}
+
+void FileCache::load()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QFile file(m_cache_file);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    QJsonDocument json = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+    // Fail if the JSON is invalid.
+    if (parseError.error != QJsonParseError::NoError) {
+        qCritical() << QString("Failed to parse Flame file cache: %1 at offset %2")
+                           .arg(parseError.errorString(), QString::number(parseError.offset))
+                           .toUtf8();
+        return;
+    }
+
+    // Make sure the root is an object.
+    if (!json.isObject()) {
+        qCritical() << "Flame file cache root should be an object.";
+        return;
+    }
+
+    auto root = json.object();
+
+    // check file version first
+    auto version_val = Json::ensureString(root, "version");
+    if (version_val != "1")
+        return;
+
+    QMutexLocker locker(&m_lock);
+    auto loadEntries = [&root](const QString& name, QHash<QString, Entry>& entries) {
+        for (auto element : Json::ensureArray(root, name)) {
+            auto element_obj = Json::ensureObject(element);
+            auto key = Json::ensureString(element_obj, "key");
+            if (key.isEmpty())
+                continue;
+
+            Entry entry;
+            entry.fetched = Json::ensureDouble(element_obj, "fetched");
+            entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+            entry.isVolatile = Json::ensureBoolean(element_obj, QString("volatile"), false);
+            entry.data = Json::ensureObject(element_obj, "data");
+            entries.insert(key, entry);
+        }
+    };
+    loadEntries("files", m_files);
+    loadEntries("projects", m_projects);
+    loadEntries("modrinth", m_modrinth);
+}
+
+void FileCache::saveEventually()
+{
+    // the timer lives on our thread, resolvers don't necessarily
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // reset the save timer
+            m_saveBatchingTimer.stop();
+            m_saveBatchingTimer.start(30000);
+        },
+        Qt::AutoConnection);
+}
+
+void FileCache::saveNow()
+{
+    if (m_cache_file.isNull())
+        return;
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "1");
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+        auto saveEntries = [&toplevel, oldest](const QString& name, QHash<QString, Entry>& entries) {
+            QJsonArray entriesArr;
+            for (auto iter = entries.begin(); iter != entries.end();) {
+                if (iter->lastUsed < oldest) {
+                    iter = entries.erase(iter);
+                    continue;
+                }
+                QJsonObject entryObj;
+                Json::writeString(entryObj, "key", iter.key());
+                entryObj.insert("fetched", QJsonValue(double(iter->fetched)));
+                entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+                entryObj.insert("volatile", iter->isVolatile);
+                entryObj.insert("data", iter->data);
+                entriesArr.append(entryObj);
+                iter++;
+            }
+            toplevel.insert(name, entriesArr);
+        };
+        saveEntries("files", m_files);
+        saveEntries("projects", m_projects);
+        saveEntries("modrinth", m_modrinth);
+    }
+
+    try {
+        Json::write(toplevel, m_cache_file);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing Flame file cache:" << e.what();
+    }
+}
+
+}  // namespace Flame
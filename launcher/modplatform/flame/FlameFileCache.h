@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <optional>
+
+namespace Flame {
+
+/**
+ * Persistent cache of what the CurseForge API said about pack files, shared by every instance and pack install.
+ *
+ * Holds the file metadata as the API returned it, keyed by project and file ID, the website of the projects and what
+ * Modrinth has for the files. A file ID always points to the same file, so that metadata stays good. Whether a file
+ * may be downloaded from CurseForge, and whether Modrinth has it, can change, so blocked files and Modrinth lookups
+ * are only trusted for a day.
+ *
+ * All the methods are thread safe.
+ */
+class FileCache : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the cache file
+    explicit FileCache(QString path = QString());
+    ~FileCache() override;
+
+    /// the cache of the running launcher, null when there's none like in tests
+    static FileCache* shared();
+
+    /// the file object from the API, if known and still good
+    std::optional<QJsonObject> file(int projectId, int fileId);
+    /// remember a file object from the API, it knows its own IDs
+    void putFile(const QJsonObject& file);
+
+    /// the website of the project, empty if unknown
+    QString websiteUrl(int projectId);
+    void putWebsiteUrl(int projectId, const QString& url);
+
+    /// the Modrinth version with the file of that SHA-1, if looked up recently, an empty object if Modrinth has none
+    std::optional<QJsonObject> modrinthVersion(const QString& sha1);
+    void putModrinthVersion(const QString& sha1, const QJsonObject& version);
+
+    void load();
+    // (re)start a timer that calls saveNow later, safe to call from any thread
+    void saveEventually();
+
+   public slots:
+    void saveNow();
+
+   private:
+    struct Entry {
+        // when the API was asked, in seconds since epoch
+        qint64 fetched = 0;
+        // last time the entry was used, in seconds since epoch
+        qint64 lastUsed = 0;
+        // only trusted for a while
+        bool isVolatile = false;
+        QJsonObject data;
+    };
+
+    std::optional<QJsonObject> get(QHash<QString, Entry>& entries, const QString& key);
+    void put(QHash<QString, Entry>& entries, const QString& key, const QJsonObject& data, bool isVolatile);
+
+   private:
+    QMutex m_lock;
+    QHash<QString, Entry> m_files;
+    QHash<QString, Entry> m_projects;
+    QHash<QString, Entry> m_modrinth;
+    QString m_cache_file;
+    QTimer m_saveBatchingTimer;
+};
+
+}  // namespace Flame
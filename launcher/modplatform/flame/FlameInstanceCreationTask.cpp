@@ -62,6 +62,7 @@
 #include "minecraft/World.h"
 #include "minecraft/mod/tasks/LocalResourceParse.h"
 #include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
 #include "ui/pages/modplatform/OptionalModDialog.h"
 
 static const FlameAPI api;
@@ -139,39 +140,25 @@ bool FlameCreationTask::updateInstance()
         auto& files = m_pack.files;
 
         // Remove repeated files, we don't need to download them!
-        auto files_iterator = files.begin();
-        while (files_iterator != files.end()) {
-            auto const& file = files_iterator;
-
-            auto old_file = old_files.find(file.key());
-            if (old_file != old_files.end()) {
-                // We found a match, but is it a different version?
-                if (old_file->fileId == file->fileId) {
-                    qDebug() << "Removed file at" << file->targetFolder << "with id" << file->fileId << "from list of downloads";
-
-                    old_files.remove(file.key());
-                    files_iterator = files.erase(files_iterator);
-
-                    if (files_iterator != files.begin())
-                        files_iterator--;
-                }
+        for (auto files_iterator = files.begin(); files_iterator != files.end();) {
+            auto old_file = old_files.find(files_iterator.key());
+            // We found a match, but is it a different version?
+            if (old_file != old_files.end() && old_file->fileId == files_iterator->fileId) {
+                qDebug() << "Removed file at" << files_iterator->targetFolder << "with id" << files_iterator->fileId
+                         << "from list of downloads";
+                old_files.erase(old_file);
+                files_iterator = files.erase(files_iterator);
+            } else {
+                ++files_iterator;
             }
-
-            files_iterator++;
         }
 
         QDir old_minecraft_dir(inst->gameRoot());
 
-        // We will remove all the previous overrides, to prevent duplicate files!
-        // TODO: Currently 'overrides' will always override the stuff on update. How do we preserve unchanged overrides?
+        // The overrides are compared with the new ones once those are staged, only the changed ones are replaced.
         // FIXME: We may want to do something about disabled mods.
-        auto old_overrides = Override::readOverrides("overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
-                continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
-        }
+        m_old_game_root = inst->gameRoot();
+        m_old_overrides = Override::readOverrides("overrides", old_index_folder);
 
         // Remove remaining old files (we need to do an API request to know which ids are which files...)
         QStringList fileIds;
@@ -313,38 +300,15 @@ bool FlameCreationTask::createInstance()
 
     QString parent_folder(FS::PathCombine(m_stagingPath, "flame"));
 
+    QString index_path(FS::PathCombine(m_stagingPath, "manifest.json"));
     try {
-        QString index_path(FS::PathCombine(m_stagingPath, "manifest.json"));
         if (!m_pack.is_loaded)
             Flame::loadManifest(m_pack, index_path);
-
-        // Keep index file in case we need it some other time (like when changing versions)
-        QString new_index_place(FS::PathCombine(parent_folder, "manifest.json"));
-        FS::ensureFilePathExists(new_index_place);
-        QFile::rename(index_path, new_index_place);
-
     } catch (const JSONValidationError& e) {
         setError(tr("Could not understand pack manifest:\n") + e.cause());
         return false;
     }
 
-    if (!m_pack.overrides.isEmpty()) {
-        QString overridePath = FS::PathCombine(m_stagingPath, m_pack.overrides);
-        if (QFile::exists(overridePath)) {
-            // Create a list of overrides in "overrides.txt" inside flame/
-            Override::createOverrides("overrides", parent_folder, overridePath);
-
-            QString mcPath = FS::PathCombine(m_stagingPath, "minecraft");
-            if (!QFile::rename(overridePath, mcPath)) {
-                setError(tr("Could not rename the overrides folder:\n") + m_pack.overrides);
-                return false;
-            }
-        } else {
-            logWarning(
-                tr("The specified overrides folder (%1) is missing. Maybe the modpack was already used before?").arg(m_pack.overrides));
-        }
-    }
-
     QString loaderType;
     QString loaderUid;
     QString loaderVersion;
@@ -407,23 +371,6 @@ bool FlameCreationTask::createInstance()
         }
     }
 
-    QString jarmodsPath = FS::PathCombine(m_stagingPath, "minecraft", "jarmods");
-    QFileInfo jarmodsInfo(jarmodsPath);
-    if (jarmodsInfo.isDir()) {
-        // install all the jar mods
-        qDebug() << "Found jarmods:";
-        QDir jarmodsDir(jarmodsPath);
-        QStringList jarMods;
-        for (const auto& info : jarmodsDir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files)) {
-            qDebug() << info.fileName();
-            jarMods.push_back(info.absoluteFilePath());
-        }
-        auto profile = instance.getPackProfile();
-        profile->installJarMods(jarMods);
-        // nuke the original files
-        FS::deletePath(jarmodsPath);
-    }
-
     // Don't add managed info to packs without an ID (most likely imported from ZIP)
     if (!m_managed_id.isEmpty())
         instance.setManagedPack("flame", m_managed_id, m_pack.name, m_managed_version_id, m_pack.version);
@@ -444,7 +391,16 @@ bool FlameCreationTask::createInstance()
 
     loop.exec();
 
-    bool did_succeed = getError().isEmpty();
+    // the mods are downloaded while the rest of the pack gets extracted
+    bool did_succeed = getError().isEmpty() && !m_abort && waitForExtraction();
+    if (did_succeed) {
+        // Keep index file in case we need it some other time (like when changing versions)
+        QString new_index_place(FS::PathCombine(parent_folder, "manifest.json"));
+        FS::ensureFilePathExists(new_index_place);
+        QFile::rename(index_path, new_index_place);
+
+        did_succeed = applyOverrides(instance, parent_folder);
+    }
 
     // Update information of the already installed instance, if any.
     if (m_instance && did_succeed) {
@@ -457,6 +413,49 @@ bool FlameCreationTask::createInstance()
     return did_succeed;
 }
 
+bool FlameCreationTask::applyOverrides(MinecraftInstance& instance, const QString& parent_folder)
+{
+    QString mcPath = FS::PathCombine(m_stagingPath, "minecraft");
+    if (!m_pack.overrides.isEmpty()) {
+        QString overridePath = FS::PathCombine(m_stagingPath, m_pack.overrides);
+        if (QFile::exists(overridePath)) {
+            // Create a list of overrides in "overrides.txt" inside flame/
+            Override::createOverrides("overrides", parent_folder, overridePath);
+
+            // the downloaded mods are there already, and win over the overrides like they always did
+            if (!mergeFolder(overridePath, mcPath)) {
+                setError(tr("Could not rename the overrides folder:\n") + m_pack.overrides);
+                return false;
+            }
+        } else {
+            logWarning(
+                tr("The specified overrides folder (%1) is missing. Maybe the modpack was already used before?").arg(m_pack.overrides));
+        }
+    }
+
+    // When updating, only what changed goes over to the instance
+    if (m_instance)
+        diffOverrides(mcPath, Override::readOverrides("overrides", parent_folder));
+
+    QString jarmodsPath = FS::PathCombine(mcPath, "jarmods");
+    QFileInfo jarmodsInfo(jarmodsPath);
+    if (jarmodsInfo.isDir()) {
+        // install all the jar mods
+        qDebug() << "Found jarmods:";
+        QDir jarmodsDir(jarmodsPath);
+        QStringList jarMods;
+        for (const auto& info : jarmodsDir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files)) {
+            qDebug() << info.fileName();
+            jarMods.push_back(info.absoluteFilePath());
+        }
+        auto profile = instance.getPackProfile();
+        profile->installJarMods(jarMods);
+        // nuke the original files
+        FS::deletePath(jarmodsPath);
+    }
+    return true;
+}
+
 void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
 {
     auto results = m_mod_id_resolver->getResults();
@@ -474,6 +473,7 @@ void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
             blocked_mod.name = result.fileName;
             blocked_mod.websiteUrl = result.websiteUrl;
             blocked_mod.hash = result.hash;
+            blocked_mod.size = result.size;
             blocked_mod.matched = false;
             blocked_mod.localPath = "";
             blocked_mod.targetFolder = result.targetFolder;
@@ -510,6 +510,7 @@ void FlameCreationTask::idResolverSucceeded(QEventLoop& loop)
 void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
 {
     m_files_job.reset(new NetJob(tr("Mod Download Flame"), APPLICATION->network()));
+    m_files_job->setPriority(Net::Priority::Bulk);
     auto results = m_mod_id_resolver->getResults().files;
 
     QStringList optionalFiles;
@@ -549,7 +550,10 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
             case Flame::File::Type::Mod: {
                 if (!result.url.isEmpty()) {
                     qDebug() << "Will download" << result.url << "to" << path;
-                    auto dl = Net::ApiDownload::makeFile(result.url, path);
+                    auto dl = Net::ApiDownload::makeFile(result.url, path,
+                                                         Net::Download::Option::Segmented | Net::Download::Option::Resumable);
+                    if (!result.hash.isEmpty())
+                        dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray::fromHex(result.hash.toLatin1())));
                     m_files_job->addNetAction(dl);
                 }
                 break;
@@ -620,9 +624,16 @@ void FlameCreationTask::copyBlockedMods(QList<BlockedMod> const& blocked_mods)
 void FlameCreationTask::validateZIPResources()
 {
     qDebug() << "Validating whether resources stored as .zip are in the right place";
-    for (auto [fileName, targetFolder] : m_ZIP_resources) {
+    // they're all identified at once, each on its own thread
+    QList<QFileInfo> localFiles;
+    for (auto [fileName, targetFolder] : m_ZIP_resources)
+        localFiles.append(QFileInfo(FS::PathCombine(m_stagingPath, "minecraft", targetFolder, fileName)));
+    auto types = ResourceUtils::identify(localFiles);
+
+    for (int i = 0; i < m_ZIP_resources.size(); i++) {
+        auto [fileName, targetFolder] = m_ZIP_resources[i];
         qDebug() << "Checking" << fileName << "...";
-        auto localPath = FS::PathCombine(m_stagingPath, "minecraft", targetFolder, fileName);
+        auto localPath = localFiles[i].filePath();
 
         /// @brief check the target and move the the file
         /// @return path where file can now be found
@@ -651,8 +662,7 @@ void FlameCreationTask::validateZIPResources()
             }
         };
 
-        QFileInfo localFileInfo(localPath);
-        auto type = ResourceUtils::identify(localFileInfo);
+        auto type = types[i];
 
         QString worldPath;
 
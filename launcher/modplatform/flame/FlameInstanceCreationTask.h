@@ -70,6 +70,10 @@ class FlameCreationTask final : public InstanceCreationTask {
     bool updateInstance() override;
     bool createInstance() override;
 
+   private:
+    // move the overrides into place, once the pack is extracted and the mods are downloaded
+    bool applyOverrides(MinecraftInstance& instance, const QString& parent_folder);
+
    private slots:
     void idResolverSucceeded(QEventLoop&);
     void setupDownloadJob(QEventLoop&);
@@ -36,6 +36,7 @@
 #include "modplatform/ModIndex.h"
 #include "modplatform/flame/FlameModIndex.h"
 #include "modplatform/helpers/HashUtils.h"
+#include "tasks/ConcurrentTask.h"
 #include "tasks/Task.h"
 
 const QString FlamePackExportTask::TEMPLATE = "<li><a href=\"{url}\">{name}{authors}</a></li>\n";
@@ -68,8 +69,11 @@ void FlamePackExportTask::executeTask()
 
 bool FlamePackExportTask::abort()
 {
-    if (task) {
-        task->abort();
+    if (task || zipTask) {
+        if (task)
+            task->abort();
+        if (zipTask)
+            zipTask->abort();
         emitAborted();
         return true;
     }
@@ -90,21 +94,44 @@ void FlamePackExportTask::collectFiles()
     pendingHashes.clear();
     resolvedFiles.clear();
 
+    // everything else goes into the zip while these are looked up
+    QStringList deferred;
+    for (const QFileInfo& file : files) {
+        const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
+        if (std::any_of(FILE_EXTENSIONS.begin(), FILE_EXTENSIONS.end(), [&relative](const QString& extension) {
+                return relative.endsWith('.' + extension) || relative.endsWith('.' + extension + ".disabled");
+            }))
+            deferred << relative;
+    }
+    startZip(deferred);
+
     if (mcInstance != nullptr) {
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(mcInstance->loaderModList().get(), &ModFolderModel::updateFinished, this, [this, connection] {
+            disconnect(*connection);
+            collectHashes();
+        });
         mcInstance->loaderModList()->update();
-        connect(mcInstance->loaderModList().get(), &ModFolderModel::updateFinished, this, &FlamePackExportTask::collectHashes);
     } else
         collectHashes();
 }
 
 void FlamePackExportTask::collectHashes()
 {
+    if (!isRunning())
+        return;
     setAbortable(true);
     setStatus(tr("Finding file hashes..."));
     setProgress(1, 5);
-    auto allMods = mcInstance->loaderModList()->allMods();
-    ConcurrentTask::Ptr hashingTask(
-        new ConcurrentTask(this, "MakeHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt()));
+    QHash<QString, Mod*> mods;
+    if (mcInstance != nullptr) {
+        for (auto mod : mcInstance->loaderModList()->allMods())
+            mods.insert(mod->fileinfo().absoluteFilePath(), mod);
+    }
+    // the hashes come from the hash cache when the files were hashed before, they're computed in parallel otherwise
+    auto maxHashers = APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt();
+    ConcurrentTask::Ptr hashingTask(new ConcurrentTask(this, "MakeHashesTask", maxHashers));
+    hashingTask->setAdaptiveConcurrency(1, 2 * maxHashers);
     task.reset(hashingTask);
     for (const QFileInfo& file : files) {
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
@@ -122,15 +149,13 @@ void FlamePackExportTask::collectHashes()
                     pendingHashes.insert(hash, { relative, file.absoluteFilePath(), relative.endsWith(".zip") });
                 }
             });
-            connect(hashTask.get(), &Task::failed, this, &FlamePackExportTask::emitFailed);
+            connect(hashTask.get(), &Task::failed, this, &FlamePackExportTask::fail);
             hashingTask->addTask(hashTask);
             continue;
         }
 
-        if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
-            modIter != allMods.end()) {
-            const Mod* mod = *modIter;
-            if (!mod || mod->type() == ResourceType::FOLDER) {
+        if (const Mod* mod = mods.value(file.absoluteFilePath())) {
+            if (mod->type() == ResourceType::FOLDER) {
                 continue;
             }
             if (mod->metadata() && mod->metadata()->provider == ModPlatform::ResourceProvider::FLAME) {
@@ -146,7 +171,7 @@ void FlamePackExportTask::collectHashes()
                     pendingHashes.insert(hash, { mod->name(), mod->fileinfo().absoluteFilePath(), mod->enabled(), true });
                 }
             });
-            connect(hashTask.get(), &Task::failed, this, &FlamePackExportTask::emitFailed);
+            connect(hashTask.get(), &Task::failed, this, &FlamePackExportTask::fail);
             hashingTask->addTask(hashTask);
         }
     }
@@ -160,7 +185,7 @@ void FlamePackExportTask::collectHashes()
     connect(hashingTask.get(), &Task::failed, this, [this, progressStep](QString reason) {
         progressStep->state = TaskStepState::Failed;
         stepProgress(*progressStep);
-        emitFailed(reason);
+        fail(reason);
     });
     connect(hashingTask.get(), &Task::stepProgress, this, &FlamePackExportTask::propagateStepProgress);
 
@@ -177,11 +202,15 @@ void FlamePackExportTask::collectHashes()
 
 void FlamePackExportTask::makeApiRequest()
 {
+    if (!isRunning())
+        return;
     if (pendingHashes.isEmpty()) {
-        buildZip();
+        finishZip();
         return;
     }
 
+    // all of them in one request
+
     setStatus(tr("Finding versions for hashes..."));
     setProgress(2, 5);
     auto response = std::make_shared<QByteArray>();
@@ -201,7 +230,7 @@ void FlamePackExportTask::makeApiRequest()
                        << " reason: " << parseError.errorString();
             qWarning() << *response;
 
-            failed(parseError.errorString());
+            fail(parseError.errorString());
             return;
         }
 
@@ -245,12 +274,14 @@ void FlamePackExportTask::makeApiRequest()
         pendingHashes.clear();
     });
     connect(task.get(), &Task::finished, this, &FlamePackExportTask::getProjectsInfo);
-    connect(task.get(), &NetJob::failed, this, &FlamePackExportTask::emitFailed);
+    connect(task.get(), &NetJob::failed, this, &FlamePackExportTask::fail);
     task->start();
 }
 
 void FlamePackExportTask::getProjectsInfo()
 {
+    if (!isRunning())
+        return;
     setStatus(tr("Finding project info from CurseForge..."));
     setProgress(3, 5);
     QStringList addonIds;
@@ -264,7 +295,7 @@ void FlamePackExportTask::getProjectsInfo()
     Task::Ptr projTask;
 
     if (addonIds.isEmpty()) {
-        buildZip();
+        finishZip();
         return;
     } else if (addonIds.size() == 1) {
         projTask = api.getProject(*addonIds.begin(), response);
@@ -279,7 +310,7 @@ void FlamePackExportTask::getProjectsInfo()
             qWarning() << "Error while parsing JSON response from CurseForge projects task at " << parseError.offset
                        << " reason: " << parseError.errorString();
             qWarning() << *response;
-            failed(parseError.errorString());
+            fail(parseError.errorString());
             return;
         }
 
@@ -321,25 +352,16 @@ void FlamePackExportTask::getProjectsInfo()
             qDebug() << e.cause();
             qDebug() << doc;
         }
-        buildZip();
+        finishZip();
     });
     task.reset(projTask);
     task->start();
 }
 
-void FlamePackExportTask::buildZip()
+void FlamePackExportTask::startZip(const QStringList& deferred)
 {
-    setStatus(tr("Adding files..."));
-    setProgress(4, 5);
-
-    auto zipTask = makeShared<MMCZip::ExportToZipTask>(output, gameRoot, files, "overrides/", true);
-    zipTask->addExtraFile("manifest.json", generateIndex());
-    zipTask->addExtraFile("modlist.html", generateHTML());
-
-    QStringList exclude;
-    std::transform(resolvedFiles.keyBegin(), resolvedFiles.keyEnd(), std::back_insert_iterator(exclude),
-                   [this](QString file) { return gameRoot.relativeFilePath(file); });
-    zipTask->setExcludeFiles(exclude);
+    zipTask = makeShared<MMCZip::ExportToZipTask>(output, gameRoot, files, "overrides/", true);
+    zipTask->setDeferredFiles(deferred);
 
     auto progressStep = std::make_shared<TaskStepProgress>();
     connect(zipTask.get(), &Task::finished, this, [this, progressStep] {
@@ -348,11 +370,14 @@ void FlamePackExportTask::buildZip()
     });
 
     connect(zipTask.get(), &Task::succeeded, this, &FlamePackExportTask::emitSucceeded);
-    connect(zipTask.get(), &Task::aborted, this, &FlamePackExportTask::emitAborted);
+    connect(zipTask.get(), &Task::aborted, this, [this] {
+        if (isRunning())
+            emitAborted();
+    });
     connect(zipTask.get(), &Task::failed, this, [this, progressStep](QString reason) {
         progressStep->state = TaskStepState::Failed;
         stepProgress(*progressStep);
-        emitFailed(reason);
+        fail(reason);
     });
     connect(zipTask.get(), &Task::stepProgress, this, &FlamePackExportTask::propagateStepProgress);
 
@@ -364,10 +389,33 @@ void FlamePackExportTask::buildZip()
         progressStep->status = status;
         stepProgress(*progressStep);
     });
-    task.reset(zipTask);
     zipTask->start();
 }
 
+// now that it's known what's downloaded instead, the zip gets the rest and the manifest
+void FlamePackExportTask::finishZip()
+{
+    setStatus(tr("Adding files..."));
+    setProgress(4, 5);
+    task = nullptr;
+
+    QStringList exclude;
+    std::transform(resolvedFiles.keyBegin(), resolvedFiles.keyEnd(), std::back_insert_iterator(exclude),
+                   [this](QString file) { return gameRoot.relativeFilePath(file); });
+    zipTask->resolveDeferred(exclude, { { "manifest.json", generateIndex() }, { "modlist.html", generateHTML() } });
+}
+
+void FlamePackExportTask::fail(const QString& reason)
+{
+    if (!isRunning())
+        return;
+    if (task)
+        task->abort();
+    if (zipTask)
+        zipTask->abort();
+    emitFailed(reason);
+}
+
 QByteArray FlamePackExportTask::generateIndex()
 {
     QJsonObject obj;
@@ -75,12 +75,15 @@ class FlamePackExportTask : public Task {
     QMap<QString, HashInfo> pendingHashes{};
     QMap<QString, ResolvedFile> resolvedFiles{};
     Task::Ptr task;
+    shared_qobject_ptr<MMCZip::ExportToZipTask> zipTask;
 
     void collectFiles();
     void collectHashes();
     void makeApiRequest();
     void getProjectsInfo();
-    void buildZip();
+    void startZip(const QStringList& deferred);
+    void finishZip();
+    void fail(const QString& reason);
 
     QByteArray generateIndex();
     QByteArray generateHTML();
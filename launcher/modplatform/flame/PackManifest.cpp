@@ -89,6 +89,7 @@ bool Flame::File::parseFromObject(const QJsonObject& obj, bool throw_on_blocked)
             hash = value;
         }
     }
+    size = static_cast<qint64>(Json::ensureDouble(obj, "fileLength", -1));
 
     // may throw, if the project is blocked
     QString rawUrl = Json::ensureString(obj, "downloadUrl");
@@ -51,6 +51,8 @@ struct File {
     // NOTE: the opposite to 'optional'
     bool required = true;
     QString hash;
+    // in bytes, -1 when unknown
+    qint64 size = -1;
     // NOTE: only set on blocked files ! Empty otherwise.
     QString websiteUrl;
 
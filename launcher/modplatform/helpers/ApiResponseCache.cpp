@@ -0,0 +1,162 @@
+#include "ApiResponseCache.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QNetworkReply>
+
+#include "Application.h"
+#include "net/ApiDownload.h"
+
+// answers are this fresh at most, new projects and versions show up soon enough
+static constexpr qint64 s_maxAgeMs = 5 * 60 * 1000;
+// a few hundred pages of search results and project infos
+static constexpr int s_maxEntries = 256;
+
+ApiResponseCache& ApiResponseCache::instance()
+{
+    static ApiResponseCache s_instance;
+    return s_instance;
+}
+
+Task::Ptr ApiResponseCache::get(const QString& name, const QUrl& url, std::shared_ptr<QByteArray> response)
+{
+    return makeShared<ApiResponseTask>(name, url, response);
+}
+
+void ApiResponseCache::prefetch(const QUrl& url)
+{
+    if (fresh(url) || m_requests.contains(url))
+        return;
+    start(url)->prefetched = true;
+}
+
+void ApiResponseCache::clear()
+{
+    m_entries.clear();
+}
+
+const ApiResponseCache::Entry* ApiResponseCache::fresh(const QUrl& url)
+{
+    auto entry = m_entries.find(url);
+    if (entry == m_entries.end())
+        return nullptr;
+    if (entry->fetched < QDateTime::currentMSecsSinceEpoch() - s_maxAgeMs) {
+        m_entries.erase(entry);
+        return nullptr;
+    }
+    return &entry.value();
+}
+
+void ApiResponseCache::attach(ApiResponseTask* task)
+{
+    if (auto entry = fresh(task->url())) {
+        // still answered later, like a request would be
+        QMetaObject::invokeMethod(
+            task, [task, data = entry->data] { task->answer(data); }, Qt::QueuedConnection);
+        return;
+    }
+    auto request = m_requests.value(task->url());
+    if (!request)
+        request = start(task->url());
+    request->waiting.append(task);
+}
+
+void ApiResponseCache::detach(ApiResponseTask* task)
+{
+    auto request = m_requests.value(task->url());
+    if (!request)
+        return;
+    request->waiting.removeAll(task);
+    request->waiting.removeAll(nullptr);
+    if (request->waiting.isEmpty() && !request->prefetched) {
+        m_requests.remove(task->url());
+        request->job->abort();
+    }
+}
+
+std::shared_ptr<ApiResponseCache::Request> ApiResponseCache::start(const QUrl& url)
+{
+    auto request = std::make_shared<Request>();
+    request->response = std::make_shared<QByteArray>();
+    request->job.reset(new NetJob(QString("API request: %1").arg(url.path()), APPLICATION->network()));
+    request->job->setPriority(Net::Priority::Interactive);
+    request->job->addNetAction(Net::ApiDownload::makeByteArray(url, request->response));
+    m_requests.insert(url, request);
+
+    auto job = request->job.get();
+    QObject::connect(job, &NetJob::succeeded, [this, url] { finished(url, true, {}, -1); });
+    QObject::connect(job, &NetJob::failed, [this, url, job](QString reason) {
+        int network_error_code = -1;
+        if (auto failed = job->getFailedActions(); !failed.isEmpty() && failed.first() && failed.first()->m_reply)
+            network_error_code = failed.first()->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        finished(url, false, reason, network_error_code);
+    });
+
+    request->job->start();
+    return request;
+}
+
+void ApiResponseCache::finished(const QUrl& url, bool succeeded, const QString& reason, int network_error_code)
+{
+    auto request = m_requests.take(url);
+    if (!request)
+        return;
+
+    if (succeeded) {
+        if (m_entries.size() >= s_maxEntries) {
+            // make room, the oldest answers are the least likely to be asked for again
+            auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+                                           [](const Entry& a, const Entry& b) { return a.fetched < b.fetched; });
+            m_entries.erase(oldest);
+        }
+        m_entries.insert(url, { *request->response, QDateTime::currentMSecsSinceEpoch() });
+    }
+
+    for (auto& task : request->waiting) {
+        if (!task)
+            continue;
+        if (succeeded)
+            task->answer(*request->response);
+        else
+            task->fail(reason, network_error_code);
+    }
+}
+
+ApiResponseTask::ApiResponseTask(const QString& name, const QUrl& url, std::shared_ptr<QByteArray> response)
+    : Task(), m_url(url), m_response(response)
+{
+    setObjectName(name);
+}
+
+void ApiResponseTask::executeTask()
+{
+    setStatus(tr("Requesting %1").arg(m_url.host()));
+    ApiResponseCache::instance().attach(this);
+}
+
+bool ApiResponseTask::abort()
+{
+    if (!isRunning())
+        return Task::abort();
+    ApiResponseCache::instance().detach(this);
+    emitAborted();
+    return true;
+}
+
+void ApiResponseTask::answer(const QByteArray& data)
+{
+    // aborted while the answer was on its way
+    if (!isRunning())
+        return;
+    *m_response = data;
+    emitSucceeded();
+}
+
+void ApiResponseTask::fail(const QString& reason, int network_error_code)
+{
+    if (!isRunning())
+        return;
+    m_network_error_code = network_error_code;
+    emitFailed(reason);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QUrl>
+
+#include <memory>
+
+#include "net/NetJob.h"
+#include "tasks/Task.h"
+
+class ApiResponseTask;
+
+/**
+ * Short lived, in memory cache of what the resource APIs answered, shared by all of them.
+ *
+ * Asking for a URL that was answered a moment ago gets that answer back without a request, and asking for one that
+ * is still being requested waits for that request instead of sending another one. Browsing back and forth between
+ * searches, tabs and pages doesn't hit the APIs again.
+ *
+ * Not thread safe, it lives on the GUI thread with the models using it.
+ */
+class ApiResponseCache {
+   public:
+    static ApiResponseCache& instance();
+
+    /// a task filling response with what the URL answers
+    Task::Ptr get(const QString& name, const QUrl& url, std::shared_ptr<QByteArray> response);
+    /// request the URL in the background, so asking for it later is answered right away
+    void prefetch(const QUrl& url);
+
+    void clear();
+
+   private:
+    friend class ApiResponseTask;
+
+    struct Entry {
+        QByteArray data;
+        // when the answer came, in msecs since epoch
+        qint64 fetched = 0;
+    };
+    struct Request {
+        NetJob::Ptr job;
+        std::shared_ptr<QByteArray> response;
+        QList<QPointer<ApiResponseTask>> waiting;
+        // prefetches keep going without anyone waiting
+        bool prefetched = false;
+    };
+
+    /// answer the task right away if possible, otherwise make it wait for the request
+    void attach(ApiResponseTask* task);
+    /// the task doesn't want the answer anymore
+    void detach(ApiResponseTask* task);
+
+    std::shared_ptr<Request> start(const QUrl& url);
+    void finished(const QUrl& url, bool succeeded, const QString& reason, int network_error_code);
+    const Entry* fresh(const QUrl& url);
+
+   private:
+    QHash<QUrl, Entry> m_entries;
+    QHash<QUrl, std::shared_ptr<Request>> m_requests;
+};
+
+/** What ApiResponseCache::get() returns, fails with the network error code of the request like a NetJob would. */
+class ApiResponseTask : public Task {
+    Q_OBJECT
+   public:
+    ApiResponseTask(const QString& name, const QUrl& url, std::shared_ptr<QByteArray> response);
+
+    bool canAbort() const override { return true; }
+    bool abort() override;
+
+    const QUrl& url() const { return m_url; }
+    /// the HTTP status of the failed request, -1 if there was none
+    int networkErrorCode() const { return m_network_error_code; }
+
+   protected:
+    void executeTask() override;
+
+   private:
+    friend class ApiResponseCache;
+
+    void answer(const QByteArray& data);
+    void fail(const QString& reason, int network_error_code);
+
+   private:
+    QUrl m_url;
+    std::shared_ptr<QByteArray> m_response;
+    int m_network_error_code = -1;
+};
@@ -16,185 +16,288 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "ExportToModList.h"
+#include <QBuffer>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include <algorithm>
+
 namespace ExportToModList {
-QString toHTML(QList<Mod*> mods, OptionalData extraData)
+
+Row rowOf(const Mod* mod)
 {
-    QStringList lines;
-    for (auto mod : mods) {
-        auto meta = mod->metadata();
-        auto modName = mod->name().toHtmlEscaped();
-        if (extraData & Url) {
-            auto url = mod->metaurl().toHtmlEscaped();
-            if (!url.isEmpty())
-                modName = QString("<a href=\"%1\">%2</a>").arg(url, modName);
-        }
-        auto line = modName;
-        if (extraData & Version) {
-            auto ver = mod->version();
-            if (ver.isEmpty() && meta != nullptr)
-                ver = meta->version().toString();
-            if (!ver.isEmpty())
-                line += QString(" [%1]").arg(ver.toHtmlEscaped());
-        }
-        if (extraData & Authors && !mod->authors().isEmpty())
-            line += " by " + mod->authors().join(", ").toHtmlEscaped();
-        lines.append(QString("<li>%1</li>").arg(line));
+    Row row;
+    row.name = mod->name();
+    row.url = mod->metaurl();
+    row.version = mod->version();
+    auto meta = mod->metadata();
+    if (row.version.isEmpty() && meta != nullptr)
+        row.version = meta->version().toString();
+    row.authors = mod->authors();
+    return row;
+}
+
+QList<Row> rowsOf(const QList<ModInventory::Entry>& entries, const std::function<QString(const QString& instanceId)>& instanceName)
+{
+    QList<Row> rows;
+    rows.reserve(entries.size());
+    for (auto& entry : entries) {
+        Row row;
+        row.instance = instanceName(entry.instanceId);
+        row.name = entry.name.isEmpty() ? entry.modId : entry.name;
+        row.version = entry.version;
+        rows.append(row);
     }
-    return QString("<html><body><ul>\n\t%1\n</ul></body></html>").arg(lines.join("\n\t"));
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        int order = QString::localeAwareCompare(a.instance, b.instance);
+        return order != 0 ? order < 0 : QString::localeAwareCompare(a.name, b.name) < 0;
+    });
+    return rows;
 }
 
-QString toMarkdown(QList<Mod*> mods, OptionalData extraData)
+LineTemplate::LineTemplate(const QString& lineTemplate)
 {
-    QStringList lines;
-    for (auto mod : mods) {
-        auto meta = mod->metadata();
-        auto modName = mod->name();
-        if (extraData & Url) {
-            auto url = mod->metaurl();
-            if (!url.isEmpty())
-                modName = QString("[%1](%2)").arg(modName, url);
-        }
-        auto line = modName;
-        if (extraData & Version) {
-            auto ver = mod->version();
-            if (ver.isEmpty() && meta != nullptr)
-                ver = meta->version().toString();
-            if (!ver.isEmpty())
-                line += QString(" [%1]").arg(ver);
+    static const QList<std::pair<QString, Field>> fields = {
+        { "{name}", Field::Name },       { "{url}", Field::Url },           { "{version}", Field::Version },
+        { "{authors}", Field::Authors }, { "{instance}", Field::Instance },
+    };
+    QString text;
+    for (int i = 0; i < lineTemplate.size();) {
+        auto rest = QStringView(lineTemplate).mid(i);
+        auto field = std::find_if(fields.begin(), fields.end(), [rest](const auto& known) { return rest.startsWith(known.first); });
+        if (field == fields.end()) {
+            text.append(lineTemplate[i]);
+            i++;
+            continue;
         }
-        if (extraData & Authors && !mod->authors().isEmpty())
-            line += " by " + mod->authors().join(", ");
-        lines << "- " + line;
+        if (!text.isEmpty())
+            m_tokens.append({ Field::Text, text });
+        text.clear();
+        m_tokens.append({ field->second, {} });
+        i += field->first.size();
     }
-    return lines.join("\n");
+    if (!text.isEmpty())
+        m_tokens.append({ Field::Text, text });
 }
 
-QString toPlainTXT(QList<Mod*> mods, OptionalData extraData)
+void LineTemplate::write(QTextStream& out, const Row& row) const
 {
-    QStringList lines;
-    for (auto mod : mods) {
-        auto meta = mod->metadata();
-        auto modName = mod->name();
-
-        auto line = modName;
-        if (extraData & Url) {
-            auto url = mod->metaurl();
-            if (!url.isEmpty())
-                line += QString(" (%1)").arg(url);
-        }
-        if (extraData & Version) {
-            auto ver = mod->version();
-            if (ver.isEmpty() && meta != nullptr)
-                ver = meta->version().toString();
-            if (!ver.isEmpty())
-                line += QString(" [%1]").arg(ver);
+    for (auto& token : m_tokens) {
+        switch (token.field) {
+            case Field::Text:
+                out << token.text;
+                break;
+            case Field::Name:
+                out << row.name;
+                break;
+            case Field::Url:
+                out << row.url;
+                break;
+            case Field::Version:
+                out << row.version;
+                break;
+            case Field::Authors:
+                out << row.authors.join(", ");
+                break;
+            case Field::Instance:
+                out << row.instance;
+                break;
         }
-        if (extraData & Authors && !mod->authors().isEmpty())
-            line += " by " + mod->authors().join(", ");
-        lines << line;
     }
-    return lines.join("\n");
 }
 
-QString toJSON(QList<Mod*> mods, OptionalData extraData)
+static void writeHTML(QTextStream& out, const QList<Row>& rows, OptionalData extraData)
 {
-    QJsonArray lines;
-    for (auto mod : mods) {
-        auto meta = mod->metadata();
-        auto modName = mod->name();
-        QJsonObject line;
-        line["name"] = modName;
-        if (extraData & Url) {
-            auto url = mod->metaurl();
-            if (!url.isEmpty())
-                line["url"] = url;
-        }
-        if (extraData & Version) {
-            auto ver = mod->version();
-            if (ver.isEmpty() && meta != nullptr)
-                ver = meta->version().toString();
-            if (!ver.isEmpty())
-                line["version"] = ver;
-        }
-        if (extraData & Authors && !mod->authors().isEmpty())
-            line["authors"] = QJsonArray::fromStringList(mod->authors());
-        lines << line;
+    out << "<html><body><ul>\n\t";
+    bool first = true;
+    for (auto& row : rows) {
+        if (!first)
+            out << "\n\t";
+        first = false;
+        out << "<li>";
+        auto modName = row.name.toHtmlEscaped();
+        if (extraData & Url && !row.url.isEmpty())
+            out << "<a href=\"" << row.url.toHtmlEscaped() << "\">" << modName << "</a>";
+        else
+            out << modName;
+        if (extraData & Version && !row.version.isEmpty())
+            out << " [" << row.version.toHtmlEscaped() << "]";
+        if (extraData & Authors && !row.authors.isEmpty())
+            out << " by " << row.authors.join(", ").toHtmlEscaped();
+        if (extraData & Instance && !row.instance.isEmpty())
+            out << " in " << row.instance.toHtmlEscaped();
+        out << "</li>";
     }
-    QJsonDocument doc;
-    doc.setArray(lines);
-    return doc.toJson();
+    out << "\n</ul></body></html>";
 }
 
-QString toCSV(QList<Mod*> mods, OptionalData extraData)
+static void writeMarkdown(QTextStream& out, const QList<Row>& rows, OptionalData extraData)
 {
-    QStringList lines;
-    for (auto mod : mods) {
-        QStringList data;
-        auto meta = mod->metadata();
-        auto modName = mod->name();
+    bool first = true;
+    for (auto& row : rows) {
+        if (!first)
+            out << "\n";
+        first = false;
+        out << "- ";
+        if (extraData & Url && !row.url.isEmpty())
+            out << "[" << row.name << "](" << row.url << ")";
+        else
+            out << row.name;
+        if (extraData & Version && !row.version.isEmpty())
+            out << " [" << row.version << "]";
+        if (extraData & Authors && !row.authors.isEmpty())
+            out << " by " << row.authors.join(", ");
+        if (extraData & Instance && !row.instance.isEmpty())
+            out << " in " << row.instance;
+    }
+}
 
-        data << modName;
+static void writePlainTXT(QTextStream& out, const QList<Row>& rows, OptionalData extraData)
+{
+    bool first = true;
+    for (auto& row : rows) {
+        if (!first)
+            out << "\n";
+        first = false;
+        out << row.name;
+        if (extraData & Url && !row.url.isEmpty())
+            out << " (" << row.url << ")";
+        if (extraData & Version && !row.version.isEmpty())
+            out << " [" << row.version << "]";
+        if (extraData & Authors && !row.authors.isEmpty())
+            out << " by " << row.authors.join(", ");
+        if (extraData & Instance && !row.instance.isEmpty())
+            out << " in " << row.instance;
+    }
+}
+
+static void writeCSV(QTextStream& out, const QList<Row>& rows, OptionalData extraData)
+{
+    bool first = true;
+    for (auto& row : rows) {
+        if (!first)
+            out << "\n";
+        first = false;
+        out << row.name;
         if (extraData & Url)
-            data << mod->metaurl();
-        if (extraData & Version) {
-            auto ver = mod->version();
-            if (ver.isEmpty() && meta != nullptr)
-                ver = meta->version().toString();
-            data << ver;
-        }
+            out << "," << row.url;
+        if (extraData & Version)
+            out << "," << row.version;
         if (extraData & Authors) {
-            QString authors;
-            if (mod->authors().length() == 1)
-                authors = mod->authors().back();
-            else if (mod->authors().length() > 1)
-                authors = QString("\"%1\"").arg(mod->authors().join(","));
-            data << authors;
+            out << ",";
+            if (row.authors.length() == 1)
+                out << row.authors.back();
+            else if (row.authors.length() > 1)
+                out << "\"" << row.authors.join(",") << "\"";
         }
-        lines << data.join(",");
+        if (extraData & Instance)
+            out << "," << row.instance;
     }
-    return lines.join("\n");
 }
 
-QString exportToModList(QList<Mod*> mods, Formats format, OptionalData extraData)
+// laid out like QJsonDocument lays out the whole array, one object at a time
+static bool writeJSON(QIODevice* out, const QList<Row>& rows, OptionalData extraData)
 {
+    bool ok = out->write("[\n") == 2;
+    for (int i = 0; i < rows.size() && ok; i++) {
+        auto& row = rows[i];
+        QJsonObject line;
+        line["name"] = row.name;
+        if (extraData & Url && !row.url.isEmpty())
+            line["url"] = row.url;
+        if (extraData & Version && !row.version.isEmpty())
+            line["version"] = row.version;
+        if (extraData & Authors && !row.authors.isEmpty())
+            line["authors"] = QJsonArray::fromStringList(row.authors);
+        if (extraData & Instance && !row.instance.isEmpty())
+            line["instance"] = row.instance;
+        auto object = QJsonDocument(line).toJson(QJsonDocument::Indented);
+        object.chop(1);
+        object.replace("\n", "\n    ");
+        object.prepend("    ");
+        object.append(i + 1 < rows.size() ? ",\n" : "\n");
+        ok = out->write(object) == object.size();
+    }
+    return ok && out->write("]\n") == 2;
+}
+
+static bool finish(QTextStream& out)
+{
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+bool exportToModList(QIODevice* out, const QList<Row>& rows, Formats format, OptionalData extraData)
+{
+    if (format == JSON)
+        return writeJSON(out, rows, extraData);
+
+    QTextStream stream(out);
+#if QT_VERSION <= QT_VERSION_CHECK(6, 0, 0)
+    stream.setCodec("UTF-8");
+#endif
     switch (format) {
         case HTML:
-            return toHTML(mods, extraData);
+            writeHTML(stream, rows, extraData);
+            break;
         case MARKDOWN:
-            return toMarkdown(mods, extraData);
+            writeMarkdown(stream, rows, extraData);
+            break;
         case PLAINTXT:
-            return toPlainTXT(mods, extraData);
-        case JSON:
-            return toJSON(mods, extraData);
+            writePlainTXT(stream, rows, extraData);
+            break;
         case CSV:
-            return toCSV(mods, extraData);
-        default: {
-            return QString("unknown format:%1").arg(format);
-        }
+            writeCSV(stream, rows, extraData);
+            break;
+        default:
+            stream << QString("unknown format:%1").arg(format);
+            break;
     }
+    return finish(stream);
 }
 
-QString exportToModList(QList<Mod*> mods, QString lineTemplate)
+bool exportToModList(QIODevice* out, const QList<Row>& rows, const QString& lineTemplate)
 {
-    QStringList lines;
-    for (auto mod : mods) {
-        auto meta = mod->metadata();
-        auto modName = mod->name();
-        auto url = mod->metaurl();
-        auto ver = mod->version();
-        if (ver.isEmpty() && meta != nullptr)
-            ver = meta->version().toString();
-        auto authors = mod->authors().join(", ");
-        lines << QString(lineTemplate)
-                     .replace("{name}", modName)
-                     .replace("{url}", url)
-                     .replace("{version}", ver)
-                     .replace("{authors}", authors);
+    LineTemplate line(lineTemplate);
+    QTextStream stream(out);
+#if QT_VERSION <= QT_VERSION_CHECK(6, 0, 0)
+    stream.setCodec("UTF-8");
+#endif
+    bool first = true;
+    for (auto& row : rows) {
+        if (!first)
+            stream << "\n";
+        first = false;
+        line.write(stream, row);
     }
-    return lines.join("\n");
+    return finish(stream);
+}
+
+static QList<Row> rowsOf(const QList<Mod*>& mods)
+{
+    QList<Row> rows;
+    rows.reserve(mods.size());
+    for (auto mod : mods)
+        rows.append(rowOf(mod));
+    return rows;
+}
+
+QString exportToModList(QList<Mod*> mods, Formats format, OptionalData extraData)
+{
+    QByteArray text;
+    QBuffer buffer(&text);
+    buffer.open(QIODevice::WriteOnly);
+    exportToModList(&buffer, rowsOf(mods), format, extraData);
+    return QString::fromUtf8(text);
+}
+
+QString exportToModList(QList<Mod*> mods, QString lineTemplate)
+{
+    QByteArray text;
+    QBuffer buffer(&text);
+    buffer.open(QIODevice::WriteOnly);
+    exportToModList(&buffer, rowsOf(mods), lineTemplate);
+    return QString::fromUtf8(text);
 }
-}  // namespace ExportToModList
\ No newline at end of file
+}  // namespace ExportToModList
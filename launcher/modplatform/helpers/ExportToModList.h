@@ -16,9 +16,16 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #pragma once
+#include <QIODevice>
 #include <QList>
 #include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include <functional>
+
 #include "minecraft/mod/Mod.h"
+#include "minecraft/mod/ModInventory.h"
 
 namespace ExportToModList {
 
@@ -27,7 +34,40 @@ enum OptionalData {
     Authors = 1 << 0,
     Url = 1 << 1,
     Version = 1 << 2,
+    Instance = 1 << 3,
 };
+
+/// what the list says about one mod, read from it once whatever the format
+struct Row {
+    QString instance;
+    QString name;
+    QString url;
+    QString version;
+    QStringList authors;
+};
+Row rowOf(const Mod* mod);
+/// mods of any number of instances from the inventory, like all() of it, by instance name. The inventory has no urls or authors.
+QList<Row> rowsOf(const QList<ModInventory::Entry>& entries, const std::function<QString(const QString& instanceId)>& instanceName);
+
+/// a custom line, split into its text and fields once instead of searching it for every mod
+class LineTemplate {
+   public:
+    explicit LineTemplate(const QString& lineTemplate);
+    void write(QTextStream& out, const Row& row) const;
+
+   private:
+    enum class Field { Text, Name, Url, Version, Authors, Instance };
+    struct Token {
+        Field field;
+        QString text;
+    };
+    QList<Token> m_tokens;
+};
+
+/// write the list to the device as it's made, false when the device didn't take it
+bool exportToModList(QIODevice* out, const QList<Row>& rows, Formats format, OptionalData extraData);
+bool exportToModList(QIODevice* out, const QList<Row>& rows, const QString& lineTemplate);
+
 QString exportToModList(QList<Mod*> mods, Formats format, OptionalData extraData);
 QString exportToModList(QList<Mod*> mods, QString lineTemplate);
 }  // namespace ExportToModList
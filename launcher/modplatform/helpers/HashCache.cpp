@@ -0,0 +1,233 @@
+#include "HashCache.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "Exception.h"
+#include "Json.h"
+#include "PerfCounters.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace Hashing {
+
+// entries that weren't used for this long are dropped on save
+static constexpr qint64 maxUnusedAge = 90 * 24 * 60 * 60;
+
+HashCache::HashCache(QString path) : QObject(), m_index_file(path)
+{
+    m_saveBatchingTimer.setSingleShot(true);
+    m_saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&m_saveBatchingTimer, &QTimer::timeout, this, &HashCache::saveNow);
+}
+
+HashCache::~HashCache()
+{
+    m_saveBatchingTimer.stop();
+    saveNow();
+}
+
+QString HashCache::fileKey(const QString& filePath)
+{
+#ifdef Q_OS_UNIX
+    struct stat info;
+    if (::stat(QFile::encodeName(filePath).constData(), &info) == 0) {
+        return QString("%1:%2").arg(quint64(info.st_dev)).arg(quint64(info.st_ino));
+    }
+    return {};
+#else
+    return QFileInfo(filePath).canonicalFilePath();
+#endif
+}
+
+QString HashCache::get(const QString& filePath, const QString& type)
+{
+    auto hash = lookup(filePath, type);
+    static auto& hits = PerfCounters::counter("hashcache.hits");
+    static auto& misses = PerfCounters::counter("hashcache.misses");
+    (hash.isEmpty() ? misses : hits)++;
+    return hash;
+}
+
+QString HashCache::lookup(const QString& filePath, const QString& type)
+{
+    QFileInfo info(filePath);
+    auto key = fileKey(filePath);
+    if (key.isEmpty()) {
+        return {};
+    }
+
+    QMutexLocker locker(&m_lock);
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end()) {
+        return {};
+    }
+    if (entry->size != info.size() || entry->lastModified != info.lastModified().toMSecsSinceEpoch()) {
+        // the file changed, everything we know about it is wrong now
+        m_entries.erase(entry);
+        return {};
+    }
+    auto hash = entry->hashes.value(type);
+    if (!hash.isEmpty()) {
+        entry->lastUsed = QDateTime::currentSecsSinceEpoch();
+    }
+    return hash;
+}
+
+void HashCache::put(const QString& filePath, const QString& type, const QString& hash)
+{
+    put(filePath, QMap<QString, QString>{ { type, hash } });
+}
+
+void HashCache::put(const QString& filePath, const QMap<QString, QString>& hashes)
+{
+    if (std::all_of(hashes.begin(), hashes.end(), [](const QString& hash) { return hash.isEmpty(); })) {
+        return;
+    }
+    QFileInfo info(filePath);
+    auto key = fileKey(filePath);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto& entry = m_entries[key];
+        auto size = info.size();
+        auto lastModified = info.lastModified().toMSecsSinceEpoch();
+        if (entry.size != size || entry.lastModified != lastModified) {
+            entry.hashes.clear();
+            entry.size = size;
+            entry.lastModified = lastModified;
+        }
+        entry.path = info.absoluteFilePath();
+        entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+        for (auto iter = hashes.constBegin(); iter != hashes.constEnd(); iter++) {
+            if (!iter.value().isEmpty()) {
+                entry.hashes[iter.key()] = iter.value();
+            }
+        }
+    }
+    saveEventually();
+}
+
+void HashCache::load()
+{
+    if (m_index_file.isNull())
+        return;
+
+    QFile index(m_index_file);
+    if (!index.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    QJsonDocument json = QJsonDocument::fromJson(index.readAll(), &parseError);
+
+    // Fail if the JSON is invalid.
+    if (parseError.error != QJsonParseError::NoError) {
+        qCritical() << QString("Failed to parse HashCache file: %1 at offset %2")
+                           .arg(parseError.errorString(), QString::number(parseError.offset))
+                           .toUtf8();
+        return;
+    }
+
+    // Make sure the root is an object.
+    if (!json.isObject()) {
+        qCritical() << "HashCache root should be an object.";
+        return;
+    }
+
+    auto root = json.object();
+
+    // check file version first
+    auto version_val = Json::ensureString(root, "version");
+    if (version_val != "1")
+        return;
+
+    QMutexLocker locker(&m_lock);
+    auto array = Json::ensureArray(root, "entries");
+    for (auto element : array) {
+        auto element_obj = Json::ensureObject(element);
+        auto key = Json::ensureString(element_obj, "key");
+        if (key.isEmpty())
+            continue;
+
+        Entry entry;
+        entry.path = Json::ensureString(element_obj, "path");
+        entry.size = Json::ensureDouble(element_obj, "size");
+        entry.lastModified = Json::ensureDouble(element_obj, "last_modified");
+        entry.lastUsed = Json::ensureDouble(element_obj, "last_used");
+        auto hashes = Json::ensureObject(element_obj, "hashes");
+        for (auto iter = hashes.constBegin(); iter != hashes.constEnd(); iter++) {
+            entry.hashes.insert(iter.key(), iter.value().toString());
+        }
+        m_entries.insert(key, entry);
+    }
+}
+
+void HashCache::saveEventually()
+{
+    // the timer lives on our thread, hashers don't necessarily
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // reset the save timer
+            m_saveBatchingTimer.stop();
+            m_saveBatchingTimer.start(30000);
+        },
+        Qt::AutoConnection);
+}
+
+void HashCache::saveNow()
+{
+    if (m_index_file.isNull())
+        return;
+
+    QJsonObject toplevel;
+    Json::writeString(toplevel, "version", "1");
+
+    QJsonArray entriesArr;
+    {
+        QMutexLocker locker(&m_lock);
+        auto oldest = QDateTime::currentSecsSinceEpoch() - maxUnusedAge;
+        for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+            if (iter->lastUsed < oldest) {
+                iter = m_entries.erase(iter);
+                continue;
+            }
+            QJsonObject hashes;
+            for (auto hash = iter->hashes.constBegin(); hash != iter->hashes.constEnd(); hash++) {
+                hashes.insert(hash.key(), hash.value());
+            }
+
+            QJsonObject entryObj;
+            Json::writeString(entryObj, "key", iter.key());
+            Json::writeString(entryObj, "path", iter->path);
+            entryObj.insert("size", QJsonValue(double(iter->size)));
+            entryObj.insert("last_modified", QJsonValue(double(iter->lastModified)));
+            entryObj.insert("last_used", QJsonValue(double(iter->lastUsed)));
+            entryObj.insert("hashes", hashes);
+            entriesArr.append(entryObj);
+            iter++;
+        }
+    }
+    toplevel.insert("entries", entriesArr);
+
+    try {
+        Json::write(toplevel, m_index_file);
+    } catch (const Exception& e) {
+        qWarning() << "Error writing hash cache:" << e.what();
+    }
+}
+
+}  // namespace Hashing
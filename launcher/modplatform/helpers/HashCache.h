@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+namespace Hashing {
+
+/**
+ * Persistent cache of file hashes, shared by every instance.
+ *
+ * Entries are keyed by the identity of the file (device and inode where the platform has them, the canonical path
+ * otherwise), so hard linked copies of a file share their hashes. An entry is only trusted while the size and the
+ * modification time of the file still match.
+ *
+ * All the methods are thread safe.
+ */
+class HashCache : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the cache index file
+    explicit HashCache(QString path = QString());
+    ~HashCache() override;
+
+    /// get the cached hash of the given type, empty if unknown or the file changed
+    QString get(const QString& filePath, const QString& type);
+    /// remember the hash of the given type for the file as it is now
+    void put(const QString& filePath, const QString& type, const QString& hash);
+    /// remember several hashes of the file at once
+    void put(const QString& filePath, const QMap<QString, QString>& hashes);
+
+    void load();
+    // (re)start a timer that calls saveNow later, safe to call from any thread
+    void saveEventually();
+
+    /// device and inode of the file where the platform has them, its canonical path otherwise, empty if it's gone
+    static QString fileKey(const QString& filePath);
+
+   public slots:
+    void saveNow();
+
+   private:
+    QString lookup(const QString& filePath, const QString& type);
+
+   private:
+    struct Entry {
+        QString path;
+        qint64 size = 0;
+        qint64 lastModified = 0;
+        // last time the entry was used, in seconds since epoch
+        qint64 lastUsed = 0;
+        QMap<QString, QString> hashes;
+    };
+
+   private:
+    QMutex m_lock;
+    QHash<QString, Entry> m_entries;
+    QString m_index_file;
+    QTimer m_saveBatchingTimer;
+};
+
+}  // namespace Hashing
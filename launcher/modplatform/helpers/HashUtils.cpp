@@ -1,10 +1,18 @@
 #include "HashUtils.h"
 
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QFile>
+#include <QThread>
+#include <QtConcurrentRun>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "Application.h"
 #include "FileSystem.h"
-#include "StringUtils.h"
+#include "modplatform/helpers/HashCache.h"
 
 #include <MurmurHash2.h>
 
@@ -48,75 +56,177 @@ Hasher::Ptr createBlockedModHasher(QString file_path, ModPlatform::ResourceProvi
     return hasher;
 }
 
-void ModrinthHasher::executeTask()
+namespace {
+// size of the chunks every digest is fed with
+const qint64 chunkSize = 4 * MiB;
+
+// what an update check against any of the providers may ask for
+const QStringList updateCheckTypes = { "sha512", "sha1", "murmur2" };
+}  // namespace
+
+FileHashes hashFile(const QString& path, const QStringList& types, const HashProgress& progress)
 {
-    QFile file(m_path);
+    FileHashes result{ path, {} };
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        qCritical() << QString("Failed to open JAR file in %1").arg(path);
+        qCritical() << QString("Reason: ") << file.errorString();
+        return result;
+    }
 
-        emitFailed("Failed to open file for hashing.");
-        return;
+    std::vector<std::pair<QString, std::unique_ptr<QCryptographicHash>>> digests;
+    bool murmur = false;
+    for (const auto& type : types) {
+        if (type == "murmur2") {
+            murmur = true;
+        } else if (type == "sha512") {
+            digests.emplace_back(type, std::make_unique<QCryptographicHash>(QCryptographicHash::Sha512));
+        } else if (type == "sha1") {
+            digests.emplace_back(type, std::make_unique<QCryptographicHash>(QCryptographicHash::Sha1));
+        } else if (type == "md5") {
+            digests.emplace_back(type, std::make_unique<QCryptographicHash>(QCryptographicHash::Md5));
+        } else {
+            qWarning() << "[Hashing]" << "Unknown hash type" << type;
+        }
     }
 
-    auto hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
-    m_hash = ProviderCaps.hash(ModPlatform::ResourceProvider::MODRINTH, &file, hash_type);
+    auto size = file.size();
+    // murmur2 needs the filtered size before it can start, so it takes a second pass
+    auto total = murmur ? 2 * size : size;
+    qint64 done = 0;
+    uint32_t murmurSize = 0;
 
-    file.close();
+    auto* mapped = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr;
+    QByteArray buffer;
+    if (!mapped) {
+        // can't be mapped (out of address space for example), stream it instead
+        buffer.resize(static_cast<int>(std::min(chunkSize, size)));
+    }
+    // calls handle with every chunk of the file in order, false if reading failed or we were stopped
+    auto forEachChunk = [&](const std::function<void(const char*, qint64)>& handle) {
+        if (!mapped && !file.seek(0)) {
+            return false;
+        }
+        for (qint64 offset = 0; offset < size; offset += chunkSize) {
+            auto len = std::min(chunkSize, size - offset);
+            const char* data = mapped ? mapped + offset : buffer.constData();
+            if (!mapped && file.read(buffer.data(), len) != len) {
+                qCritical() << "Failed to read JAR to create hash!" << file.errorString();
+                return false;
+            }
+            handle(data, len);
+            done += len;
+            if (progress && !progress(done, total)) {
+                return false;
+            }
+        }
+        return true;
+    };
 
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-        emit resultsReady(m_hash);
+    auto firstPass = forEachChunk([&](const char* data, qint64 len) {
+        auto chunk = QByteArray::fromRawData(data, static_cast<int>(len));
+        for (auto& digest : digests) {
+            digest.second->addData(chunk);
+        }
+        if (murmur) {
+            // CF-specific, whitespace doesn't count
+            murmurSize += MurmurHash2_CountNonWhitespace(data, static_cast<std::size_t>(len));
+        }
+    });
+    if (!firstPass) {
+        return result;
+    }
+
+    if (murmur) {
+        MurmurHash2_Incremental murmurHash(murmurSize);
+        std::vector<char> stripped(static_cast<std::size_t>(std::min(chunkSize, size)));
+        auto secondPass = forEachChunk([&](const char* data, qint64 len) {
+            murmurHash.feed(stripped.data(), MurmurHash2_StripWhitespace(data, static_cast<std::size_t>(len), stripped.data()));
+        });
+        if (!secondPass) {
+            return result;
+        }
+        result.hashes["murmur2"] = QString::number(murmurHash.finish());
     }
+
+    for (auto& digest : digests) {
+        result.hashes[digest.first] = digest.second->result().toHex();
+    }
+    return result;
 }
 
-void FlameHasher::executeTask()
+QString cachedHash(const QString& path, const QString& type, const HashProgress& progress)
 {
-    // CF-specific
-    auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
-
-    std::ifstream file_stream(StringUtils::toStdString(m_path).c_str(), std::ifstream::binary);
-    // TODO: This is very heavy work, but apparently QtConcurrent can't use move semantics, so we can't boop this to another thread.
-    // How do we make this non-blocking then?
-    m_hash = QString::number(MurmurHash2(std::move(file_stream), 4 * MiB, should_filter_out));
+    auto cache = APPLICATION->hashCache();
+    auto hash = cache->get(path, type);
+    if (!hash.isEmpty()) {
+        return hash;
+    }
 
-    if (m_hash.isEmpty()) {
-        emitFailed("Empty hash!");
-    } else {
-        emitSucceeded();
-        emit resultsReady(m_hash);
+    auto types = updateCheckTypes;
+    if (!types.contains(type)) {
+        types.append(type);
     }
+    auto record = hashFile(path, types, progress);
+    cache->put(path, record.hashes);
+    return record.hashes.value(type);
 }
 
-BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider) : Hasher(file_path), provider(provider)
+QThreadPool* hashingPool()
 {
-    setObjectName(QString("BlockedModHasher: %1").arg(file_path));
-    hash_type = ProviderCaps.hashType(provider).first();
+    static QThreadPool* pool = [] {
+        auto* p = new QThreadPool;
+        // hashing is mostly bound by the disk once the jar isn't cached, more readers than cores doesn't help
+        p->setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+        return p;
+    }();
+    return pool;
 }
 
-void BlockedModHasher::executeTask()
+Hasher::Hasher(QString file_path) : m_path(std::move(file_path))
 {
-    QFile file(m_path);
+    setAbortable(true);
+    connect(&m_futureWatcher, &QFutureWatcher<QString>::finished, this, &Hasher::hashFinished);
+}
 
-    try {
-        file.open(QFile::ReadOnly);
-    } catch (FS::FileSystemException& e) {
-        qCritical() << QString("Failed to open JAR file in %1").arg(m_path);
-        qCritical() << QString("Reason: ") << e.cause();
+Hasher::~Hasher()
+{
+    m_aborted = true;
+    m_future.waitForFinished();
+}
 
-        emitFailed("Failed to open file for hashing.");
-        return;
+bool Hasher::abort()
+{
+    if (!m_future.isRunning()) {
+        // nothing is going on, but we can say we aborted
+        return Task::abort();
     }
+    // hashFinished will tell everyone once the current chunk is done
+    m_aborted = true;
+    return true;
+}
 
-    m_hash = ProviderCaps.hash(provider, &file, hash_type);
+void Hasher::hashWith(const QString& type)
+{
+    m_aborted = false;
+    m_future = QtConcurrent::run(hashingPool(), [this, type] {
+        return cachedHash(m_path, type, [this](qint64 done, qint64 total) {
+            QMetaObject::invokeMethod(this, [this, done, total] { setProgress(done, total); }, Qt::QueuedConnection);
+            return !m_aborted;
+        });
+    });
+    m_futureWatcher.setFuture(m_future);
+}
 
-    file.close();
+void Hasher::hashFinished()
+{
+    if (m_aborted) {
+        emitAborted();
+        return;
+    }
 
+    m_hash = m_future.result();
     if (m_hash.isEmpty()) {
         emitFailed("Empty hash!");
     } else {
@@ -125,6 +235,27 @@ void BlockedModHasher::executeTask()
     }
 }
 
+void ModrinthHasher::executeTask()
+{
+    hashWith(ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first());
+}
+
+void FlameHasher::executeTask()
+{
+    hashWith("murmur2");
+}
+
+BlockedModHasher::BlockedModHasher(QString file_path, ModPlatform::ResourceProvider provider) : Hasher(file_path), provider(provider)
+{
+    setObjectName(QString("BlockedModHasher: %1").arg(file_path));
+    hash_type = ProviderCaps.hashType(provider).first();
+}
+
+void BlockedModHasher::executeTask()
+{
+    hashWith(hash_type);
+}
+
 QStringList BlockedModHasher::getHashTypes()
 {
     return ProviderCaps.hashType(provider);
@@ -1,21 +1,59 @@
 #pragma once
 
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMap>
 #include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
 
 #include "modplatform/ModIndex.h"
 #include "tasks/Task.h"
 
 namespace Hashing {
 
+/// every digest of a single file, the result of one read over it
+struct FileHashes {
+    QString path;
+    // hash type ("sha512", "sha1", "md5" or "murmur2") to its value
+    QMap<QString, QString> hashes;
+};
+
+/// called after every chunk with the bytes processed so far and the total, return false to stop hashing
+using HashProgress = std::function<bool(qint64 done, qint64 total)>;
+
+/**
+ * Compute all the requested digests in a single pass over the file.
+ *
+ * The file is memory mapped when possible and every digest is fed from the same chunks. Unknown types are ignored,
+ * and the map is empty if the file couldn't be read or `progress` stopped it.
+ */
+FileHashes hashFile(const QString& path, const QStringList& types, const HashProgress& progress = {});
+
+/**
+ * Get the hash of the given type, from the hash cache if possible.
+ *
+ * On a miss, every other digest the providers may ask for later is computed in the same read and cached as one
+ * record, so checking a mod against all the providers only reads its file once.
+ */
+QString cachedHash(const QString& path, const QString& type, const HashProgress& progress = {});
+
+/// the pool every Hasher runs on, kept apart from the global one so hashing a big pack doesn't starve everything else
+QThreadPool* hashingPool();
+
 class Hasher : public Task {
     Q_OBJECT
    public:
     using Ptr = shared_qobject_ptr<Hasher>;
 
-    Hasher(QString file_path) : m_path(std::move(file_path)) {}
+    Hasher(QString file_path);
+    ~Hasher() override;
 
-    /* We can't really abort this task, but we can say we aborted and finish our thing quickly :) */
-    bool abort() override { return true; }
+    /* Stops hashing after the current chunk */
+    bool abort() override;
 
     void executeTask() override = 0;
 
@@ -25,9 +63,21 @@ class Hasher : public Task {
    signals:
     void resultsReady(QString hash);
 
+   protected:
+    // compute m_hash on the hashing pool and finish the task
+    void hashWith(const QString& type);
+
+   private:
+    void hashFinished();
+
    protected:
     QString m_hash;
     QString m_path;
+
+   private:
+    QFuture<QString> m_future;
+    QFutureWatcher<QString> m_futureWatcher;
+    std::atomic_bool m_aborted{ false };
 };
 
 class FlameHasher : public Hasher {
@@ -0,0 +1,207 @@
+#include "ModpackCatalog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QJsonArray>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "tasks/Executor.h"
+
+ModpackCatalog& ModpackCatalog::forProvider(const QString& provider)
+{
+    static std::map<QString, std::unique_ptr<ModpackCatalog>> s_catalogs;
+    auto& catalog = s_catalogs[provider];
+    if (!catalog)
+        catalog = std::make_unique<ModpackCatalog>(QDir("cache/catalogs").absoluteFilePath(provider + ".json"));
+    return *catalog;
+}
+
+ModpackCatalog::ModpackCatalog(QString path) : m_path(std::move(path))
+{
+    load();
+}
+
+QStringList ModpackCatalog::words(const QString& text)
+{
+    static const QRegularExpression s_separators(R"([^\p{L}\p{N}]+)");
+    return text.toLower().split(s_separators, Qt::SkipEmptyParts);
+}
+
+static QStringList indexedWords(const ModpackCatalog::Entry& entry)
+{
+    QStringList all = ModpackCatalog::words(entry.name) + ModpackCatalog::words(entry.description);
+    for (auto& author : entry.authors)
+        all += ModpackCatalog::words(author);
+    for (auto& tag : entry.tags)
+        all += ModpackCatalog::words(tag);
+    return all;
+}
+
+void ModpackCatalog::index(const Entry& entry)
+{
+    for (auto& word : indexedWords(entry))
+        m_index[word].insert(entry.id);
+}
+
+void ModpackCatalog::unindex(const Entry& entry)
+{
+    for (auto& word : indexedWords(entry)) {
+        auto it = m_index.find(word);
+        if (it == m_index.end())
+            continue;
+        it->remove(entry.id);
+        if (it->isEmpty())
+            m_index.erase(it);
+    }
+}
+
+void ModpackCatalog::update(const QList<Entry>& entries)
+{
+    for (auto& entry : entries) {
+        if (entry.id.isEmpty())
+            continue;
+        auto old = m_entries.find(entry.id);
+        if (old != m_entries.end())
+            unindex(*old);
+        m_entries.insert(entry.id, entry);
+        index(entry);
+    }
+    if (!entries.isEmpty())
+        m_dirty = true;
+}
+
+void ModpackCatalog::replace(const QList<Entry>& entries)
+{
+    m_entries.clear();
+    m_index.clear();
+    m_dirty = true;
+    update(entries);
+}
+
+QSet<QString> ModpackCatalog::matching(const QString& term) const
+{
+    auto trimmed = term.trimmed();
+    if (trimmed.startsWith('#')) {
+        auto id = trimmed.mid(1);
+        if (m_entries.contains(id))
+            return { id };
+        return {};
+    }
+
+    auto wanted = words(trimmed);
+    if (wanted.isEmpty()) {
+        QSet<QString> all;
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+            all.insert(it.key());
+        return all;
+    }
+
+    QSet<QString> found;
+    bool first = true;
+    for (auto& word : wanted) {
+        QSet<QString> withWord;
+        for (auto it = m_index.lowerBound(word); it != m_index.constEnd() && it.key().startsWith(word); ++it)
+            withWord.unite(it.value());
+        if (first)
+            found = withWord;
+        else
+            found.intersect(withWord);
+        first = false;
+        if (found.isEmpty())
+            break;
+    }
+    return found;
+}
+
+QList<QJsonObject> ModpackCatalog::search(const QString& term) const
+{
+    QList<const Entry*> found;
+    for (auto& id : matching(term))
+        found.append(&m_entries.find(id).value());
+    std::sort(found.begin(), found.end(), [](const Entry* a, const Entry* b) {
+        if (a->downloads != b->downloads)
+            return a->downloads > b->downloads;
+        return a->name < b->name;
+    });
+
+    QList<QJsonObject> out;
+    out.reserve(found.size());
+    for (auto entry : found)
+        out.append(entry->raw);
+    return out;
+}
+
+static QStringList toStringList(const QJsonArray& array)
+{
+    QStringList out;
+    for (auto value : array)
+        out.append(value.toString());
+    return out;
+}
+
+void ModpackCatalog::load()
+{
+    if (m_path.isNull())
+        return;
+
+    try {
+        auto root = Json::requireObject(Json::requireDocument(m_path, "Modpack catalog"));
+        QList<Entry> entries;
+        for (auto packRaw : Json::ensureArray(root, "packs")) {
+            auto packObj = packRaw.toObject();
+            Entry entry;
+            entry.id = Json::ensureString(packObj, "id");
+            entry.name = Json::ensureString(packObj, "name");
+            entry.authors = toStringList(Json::ensureArray(packObj, "authors"));
+            entry.tags = toStringList(Json::ensureArray(packObj, "tags"));
+            entry.description = Json::ensureString(packObj, "description");
+            entry.downloads = static_cast<qint64>(Json::ensureDouble(packObj, "downloads"));
+            entry.raw = Json::ensureObject(packObj, "raw");
+            entries.append(entry);
+        }
+        update(entries);
+    } catch ([[maybe_unused]] const Exception& e) {
+        // there's none until the platform has been browsed
+        m_entries.clear();
+        m_index.clear();
+    }
+    m_dirty = false;
+}
+
+void ModpackCatalog::save()
+{
+    if (m_path.isNull() || !m_dirty)
+        return;
+    m_dirty = false;
+
+    QJsonArray packs;
+    for (auto& entry : m_entries) {
+        QJsonObject packObj;
+        packObj.insert("id", entry.id);
+        packObj.insert("name", entry.name);
+        packObj.insert("authors", QJsonArray::fromStringList(entry.authors));
+        packObj.insert("tags", QJsonArray::fromStringList(entry.tags));
+        packObj.insert("description", entry.description);
+        packObj.insert("downloads", double(entry.downloads));
+        packObj.insert("raw", entry.raw);
+        packs.append(packObj);
+    }
+    QJsonObject root;
+    root.insert("formatVersion", 1);
+    root.insert("packs", packs);
+
+    Executor::instance()->run(Executor::Priority::Background, [path = m_path, data = Json::toText(root)] {
+        try {
+            FS::write(path, data);
+        } catch (const Exception& e) {
+            qWarning() << "Failed to write the modpack catalog:" << e.cause();
+        }
+    });
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/**
+ * What the launcher knows of the modpacks of a platform, kept on disk and searchable without the platform.
+ *
+ * The modpack pages fill it with what the platform answers: the whole list where the platform hands it out in one go,
+ * the pages that were browsed where it's searched page by page. Every pack keeps the JSON it came as, so the pages can
+ * load it like an answer of the platform, and an index of the words of its name, authors, tags and description, so
+ * searching it takes no longer than looking those up.
+ *
+ * Not thread safe, it lives on the GUI thread with the models using it.
+ */
+class ModpackCatalog {
+   public:
+    struct Entry {
+        QString id;
+        QString name;
+        QStringList authors;
+        QStringList tags;
+        QString description;
+        qint64 downloads = 0;
+        /// the pack as the platform described it
+        QJsonObject raw;
+    };
+
+    /// the catalog of `provider`, loaded the first time it's asked for
+    static ModpackCatalog& forProvider(const QString& provider);
+
+    // supply path to the file keeping the catalog, none keeps it in memory
+    explicit ModpackCatalog(QString path = QString());
+
+    /// add the entries or bring them up to date, by their id
+    void update(const QList<Entry>& entries);
+    /// make the entries the whole catalog, for platforms listing all of their packs at once
+    void replace(const QList<Entry>& entries);
+
+    /// the packs with words starting with every word of `term`, the most downloaded first; `#<id>` is the pack with that id
+    QList<QJsonObject> search(const QString& term) const;
+    /// the ids search() would find
+    QSet<QString> matching(const QString& term) const;
+
+    [[nodiscard]] int size() const { return m_entries.size(); }
+    [[nodiscard]] bool isEmpty() const { return m_entries.isEmpty(); }
+
+    /// write the catalog out if it changed, in the background
+    void save();
+
+    static QStringList words(const QString& text);
+
+   private:
+    void load();
+    void index(const Entry& entry);
+    void unindex(const Entry& entry);
+
+   private:
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+    // ids by word, ordered so the words starting with a prefix come one after the other
+    QMap<QString, QSet<QString>> m_index;
+    bool m_dirty = false;
+};
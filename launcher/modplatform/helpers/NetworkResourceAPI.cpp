@@ -5,12 +5,12 @@
 #include "NetworkResourceAPI.h"
 #include <memory>
 
-#include "Application.h"
-#include "net/NetJob.h"
-
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/ApiResponseCache.h"
+#include "modplatform/helpers/ResponseParser.h"
 
-#include "net/ApiDownload.h"
+// the page size of the search URLs
+static constexpr int s_searchPageSize = 25;
 
 Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&& callbacks) const
 {
@@ -23,11 +23,12 @@ Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&
     auto search_url = search_url_optional.value();
 
     auto response = std::make_shared<QByteArray>();
-    auto netJob = makeShared<NetJob>(QString("%1::Search").arg(debugName()), APPLICATION->network());
+    auto netJob = ApiResponseCache::instance().get(QString("%1::Search").arg(debugName()), QUrl(search_url), response);
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(search_url), response));
+    QObject::connect(netJob.get(), &Task::succeeded, [this, response, callbacks, args] {
+        if (callbacks.is_wanted && !callbacks.is_wanted())
+            return;
 
-    QObject::connect(netJob.get(), &NetJob::succeeded, [this, response, callbacks] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -40,17 +41,21 @@ Task::Ptr NetworkResourceAPI::searchProjects(SearchArgs&& args, SearchCallbacks&
             return;
         }
 
+        // a full page, people mostly scroll on to the next one
+        auto hits = doc.isArray() ? doc.array() : doc.object().value(doc.object().contains("hits") ? "hits" : "data").toArray();
+        if (hits.size() >= s_searchPageSize) {
+            auto next = args;
+            next.offset += s_searchPageSize;
+            if (auto next_url = getSearchURL(next); next_url.has_value())
+                ApiResponseCache::instance().prefetch(QUrl(next_url.value()));
+        }
+
         callbacks.on_succeed(doc);
     });
 
-    QObject::connect(netJob.get(), &NetJob::failed, [&netJob, callbacks](QString reason) {
-        int network_error_code = -1;
-        if (auto* failed_action = netJob->getFailedActions().at(0); failed_action && failed_action->m_reply)
-            network_error_code = failed_action->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-
-        callbacks.on_fail(reason, network_error_code);
-    });
-    QObject::connect(netJob.get(), &NetJob::aborted, [callbacks] { callbacks.on_abort(); });
+    auto* task = static_cast<ApiResponseTask*>(netJob.get());
+    QObject::connect(task, &Task::failed, [task, callbacks](QString reason) { callbacks.on_fail(reason, task->networkErrorCode()); });
+    QObject::connect(task, &Task::aborted, [callbacks] { callbacks.on_abort(); });
 
     return netJob;
 }
@@ -60,7 +65,7 @@ Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfo
     auto response = std::make_shared<QByteArray>();
     auto job = getProject(args.pack.addonId.toString(), response);
 
-    QObject::connect(job.get(), &NetJob::succeeded, [response, callbacks, args] {
+    QObject::connect(job.get(), &Task::succeeded, [response, callbacks, args] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
@@ -72,8 +77,8 @@ Task::Ptr NetworkResourceAPI::getProjectInfo(ProjectInfoArgs&& args, ProjectInfo
 
         callbacks.on_succeed(doc, args.pack);
     });
-    QObject::connect(job.get(), &NetJob::failed, [callbacks](QString reason) { callbacks.on_fail(reason); });
-    QObject::connect(job.get(), &NetJob::aborted, [callbacks] { callbacks.on_abort(); });
+    QObject::connect(job.get(), &Task::failed, [callbacks](QString reason) { callbacks.on_fail(reason); });
+    QObject::connect(job.get(), &Task::aborted, [callbacks] { callbacks.on_abort(); });
     return job;
 }
 
@@ -85,22 +90,14 @@ Task::Ptr NetworkResourceAPI::getProjectVersions(VersionSearchArgs&& args, Versi
 
     auto versions_url = versions_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::Versions").arg(args.pack.name), APPLICATION->network());
     auto response = std::make_shared<QByteArray>();
+    auto netJob = ApiResponseCache::instance().get(QString("%1::Versions").arg(args.pack.name), QUrl(versions_url), response);
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(versions_url, response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [response, callbacks, args] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response for getting versions at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
-            return;
-        }
-
-        callbacks.on_succeed(doc, args.pack);
+    // version lists can be huge, they are parsed off the GUI thread and the callbacks get them a bit later
+    QObject::connect(netJob.get(), &Task::succeeded, [response, callbacks, args] {
+        ResponseParser::parse(
+            nullptr, *response, [callbacks, args](QJsonDocument& doc) { callbacks.on_succeed(doc, args.pack); },
+            [](const QString& reason) { qWarning() << "Error while parsing JSON response for getting versions:" << reason; });
     });
 
     return netJob;
@@ -114,11 +111,7 @@ Task::Ptr NetworkResourceAPI::getProject(QString addonId, std::shared_ptr<QByteA
 
     auto project_url = project_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::GetProject").arg(addonId), APPLICATION->network());
-
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(project_url), response));
-
-    return netJob;
+    return ApiResponseCache::instance().get(QString("%1::GetProject").arg(addonId), QUrl(project_url), response);
 }
 
 Task::Ptr NetworkResourceAPI::getDependencyVersion(DependencySearchArgs&& args, DependencySearchCallbacks&& callbacks) const
@@ -129,12 +122,11 @@ Task::Ptr NetworkResourceAPI::getDependencyVersion(DependencySearchArgs&& args,
 
     auto versions_url = versions_url_optional.value();
 
-    auto netJob = makeShared<NetJob>(QString("%1::Dependency").arg(args.dependency.addonId.toString()), APPLICATION->network());
     auto response = std::make_shared<QByteArray>();
+    auto netJob = ApiResponseCache::instance().get(QString("%1::Dependency").arg(args.dependency.addonId.toString()), QUrl(versions_url),
+                                                   response);
 
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(versions_url, response));
-
-    QObject::connect(netJob.get(), &NetJob::succeeded, [=] {
+    QObject::connect(netJob.get(), &Task::succeeded, [=] {
         QJsonParseError parse_error{};
         QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
         if (parse_error.error != QJsonParseError::NoError) {
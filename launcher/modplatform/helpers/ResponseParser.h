@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QJsonDocument>
+#include <QObject>
+
+#include <functional>
+#include <optional>
+
+#include "Exception.h"
+#include "tasks/Executor.h"
+
+/**
+ * Reads what the platform APIs answer off the GUI thread.
+ *
+ * Version lists of popular projects have thousands of entries, and turning them into packs and versions took the GUI
+ * thread for a good moment. Here the payload is parsed and built into plain values on the executor, and only those
+ * are handed back to the thread that asked, where the models take them as they are.
+ *
+ * The building runs on another thread, so it must only use the document and copies of what it needs, never a model.
+ * It may throw JSONValidationError like the Json:: helpers do, which ends up in `fail`.
+ */
+namespace ResponseParser {
+
+template <typename T>
+struct Result {
+    std::optional<T> value;
+    QString error;
+};
+
+/// parse `data` and build a T out of it, then call `done` or `fail` on this thread, unless `context` is gone by then
+template <typename T>
+void parse(QObject* context,
+           const QByteArray& data,
+           std::function<T(QJsonDocument&)> build,
+           std::function<void(T&)> done,
+           std::function<void(const QString&)> fail = {})
+{
+    auto future = Executor::instance()->run(Executor::Priority::Interactive, [data, build = std::move(build)]() -> Result<T> {
+        QJsonParseError parse_error{};
+        auto doc = QJsonDocument::fromJson(data, &parse_error);
+        if (parse_error.error != QJsonParseError::NoError)
+            return { std::nullopt, QString("%1 at %2").arg(parse_error.errorString()).arg(parse_error.offset) };
+        try {
+            return { build(doc), {} };
+        } catch (const Exception& e) {
+            return { std::nullopt, e.cause() };
+        }
+    });
+
+    auto watcher = new QFutureWatcher<Result<T>>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, done = std::move(done), fail = std::move(fail)] {
+        watcher->deleteLater();
+        auto result = watcher->result();
+        if (result.value)
+            done(*result.value);
+        else if (fail)
+            fail(result.error);
+    });
+    watcher->setFuture(future);
+}
+
+/// just the document, for callbacks that want it as it is
+inline void parse(QObject* context,
+                  const QByteArray& data,
+                  std::function<void(QJsonDocument&)> done,
+                  std::function<void(const QString&)> fail = {})
+{
+    parse<QJsonDocument>(context, data, [](QJsonDocument& doc) { return doc; }, std::move(done), std::move(fail));
+}
+
+}  // namespace ResponseParser
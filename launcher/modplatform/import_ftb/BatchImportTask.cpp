@@ -0,0 +1,36 @@
+#include "BatchImportTask.h"
+
+#include <QFileInfo>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "icons/IconList.h"
+#include "modplatform/import_ftb/PackInstallTask.h"
+
+namespace FTBImportAPP {
+
+BatchImportTask::BatchImportTask(const ModpackList& packs, const QString& group)
+    : ConcurrentTask(nullptr, tr("Importing FTB App instances"))
+{
+    // copies are limited by the disks more than by the cores
+    setAdaptiveConcurrency(1, 4);
+    for (auto& pack : packs) {
+        auto task = new PackInstallTask(pack);
+        InstanceName name(pack.name, pack.version);
+        task->setName(name);
+        task->setGroup(group);
+
+        auto iconPath = FS::PathCombine(pack.path, "folder.jpg");
+        if (QFileInfo(iconPath).isFile()) {
+            auto iconName = QString("ftb_%1_%2.jpg").arg(pack.name, QString::number(pack.id));
+            APPLICATION->icons()->installIcon(iconPath, iconName);
+            task->setIcon(iconName.mid(0, iconName.lastIndexOf('.')));
+        } else {
+            task->setIcon("default");
+        }
+        addTask(Task::Ptr(APPLICATION->instances()->wrapInstanceTask(task)));
+    }
+}
+
+}  // namespace FTBImportAPP
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "modplatform/import_ftb/PackHelpers.h"
+#include "tasks/ConcurrentTask.h"
+
+namespace FTBImportAPP {
+
+/** Imports many FTB App instances at once, each into an instance of its own in `group`.
+ *
+ *  A few of them are copied at the same time, with what never changes in place linked or cloned where the disk allows.
+ */
+class BatchImportTask : public ConcurrentTask {
+    Q_OBJECT
+   public:
+    explicit BatchImportTask(const ModpackList& packs, const QString& group = {});
+    ~BatchImportTask() override = default;
+};
+
+}  // namespace FTBImportAPP
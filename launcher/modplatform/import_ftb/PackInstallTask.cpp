@@ -18,15 +18,15 @@
 
 #include "PackInstallTask.h"
 
-#include <QtConcurrent>
-
 #include "BaseInstance.h"
 #include "FileSystem.h"
+#include "InstanceCopyTask.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 #include "modplatform/ResourceAPI.h"
 #include "modplatform/import_ftb/PackHelpers.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 
 namespace FTBImportAPP {
 
@@ -36,10 +36,10 @@ void PackInstallTask::executeTask()
     setAbortable(false);
     progress(1, 2);
 
-    m_copyFuture = QtConcurrent::run(QThreadPool::globalInstance(), [this] {
-        FS::copy folderCopy(m_pack.path, FS::PathCombine(m_stagingPath, ".minecraft"));
-        folderCopy.followSymlinks(true);
-        return folderCopy();
+    // the FTB App folder is the game folder, what's in it is nobody else's to write to but the app's
+    m_copyFuture = Executor::instance()->run(Executor::Priority::Bulk, [this] {
+        return InstanceCopyTask::copyFastest(m_pack.path, FS::PathCombine(m_stagingPath, ".minecraft"), "", nullptr, true,
+                                             cancellationToken());
     });
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::finished, this, &PackInstallTask::copySettings);
     connect(&m_copyFutureWatcher, &QFutureWatcher<bool>::canceled, this, &PackInstallTask::emitAborted);
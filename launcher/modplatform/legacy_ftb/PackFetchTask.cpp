@@ -36,28 +36,42 @@
 #include "PackFetchTask.h"
 #include "PrivatePackManager.h"
 
-#include <QDomDocument>
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
 #include "Application.h"
 #include "BuildConfig.h"
 
 #include "net/ApiDownload.h"
+#include "tasks/Executor.h"
 
 namespace LegacyFTB {
 
 void PackFetchTask::fetch()
 {
-    publicPacks.clear();
-    thirdPartyPacks.clear();
+    auto metacache = APPLICATION->metacache();
+    m_publicEntry = metacache->resolveEntry("FTBPacks", "legacy/modpacks.xml");
+    m_thirdPartyEntry = metacache->resolveEntry("FTBPacks", "legacy/thirdparty.xml");
+    m_shownPublic.reset();
+    m_shownThirdParty.reset();
+
+    // the page fills up from the last download, whatever comes in meanwhile replaces it if it's any different
+    m_hasCached = !m_publicEntry->isStale() && !m_thirdPartyEntry->isStale();
+    if (m_hasCached)
+        parseCached(false);
 
     jobPtr.reset(new NetJob("LegacyFTB::ModpackFetch", m_network));
 
     QUrl publicPacksUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/modpacks.xml");
     qDebug() << "Downloading public version info from" << publicPacksUrl.toString();
-    jobPtr->addNetAction(Net::ApiDownload::makeByteArray(publicPacksUrl, publicModpacksXmlFileData));
+    m_publicEntry->setStale(true);
+    jobPtr->addNetAction(Net::ApiDownload::makeCached(publicPacksUrl, m_publicEntry));
 
     QUrl thirdPartyUrl = QUrl(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/thirdparty.xml");
     qDebug() << "Downloading thirdparty version info from" << thirdPartyUrl.toString();
-    jobPtr->addNetAction(Net::Download::makeByteArray(thirdPartyUrl, thirdPartyModpacksXmlFileData));
+    m_thirdPartyEntry->setStale(true);
+    jobPtr->addNetAction(Net::Download::makeCached(thirdPartyUrl, m_thirdPartyEntry));
 
     QObject::connect(jobPtr.get(), &NetJob::succeeded, this, &PackFetchTask::fileDownloadFinished);
     QObject::connect(jobPtr.get(), &NetJob::failed, this, &PackFetchTask::fileDownloadFailed);
@@ -77,7 +91,9 @@ void PackFetchTask::fetchPrivate(const QStringList& toFetch)
 
         QObject::connect(job, &NetJob::succeeded, this, [this, job, data, packCode] {
             ModpackList packs;
-            parseAndAddPacks(*data, PackType::Private, packs);
+            QBuffer buffer(data.get());
+            buffer.open(QIODevice::ReadOnly);
+            parsePacks(&buffer, PackType::Private, packs);
             foreach (Modpack currentPack, packs) {
                 currentPack.packCode = packCode;
                 emit privateFileDownloadFinished(currentPack);
@@ -106,64 +122,91 @@ void PackFetchTask::fetchPrivate(const QStringList& toFetch)
     }
 }
 
-void PackFetchTask::fileDownloadFinished()
+PackFetchTask::Version PackFetchTask::versionOf(const MetaEntryPtr& entry)
 {
-    jobPtr.reset();
-
-    QStringList failedLists;
-
-    if (!parseAndAddPacks(*publicModpacksXmlFileData, PackType::Public, publicPacks)) {
-        failedLists.append(tr("Public Packs"));
-    }
-
-    if (!parseAndAddPacks(*thirdPartyModpacksXmlFileData, PackType::ThirdParty, thirdPartyPacks)) {
-        failedLists.append(tr("Third Party Packs"));
-    }
+    return { entry->getETag(), QFileInfo(entry->getFullPath()).lastModified() };
+}
 
-    if (failedLists.size() > 0) {
-        emit failed(tr("Failed to download some pack lists: %1").arg(failedLists.join("\n- ")));
-    } else {
-        emit finished(publicPacks, thirdPartyPacks);
-    }
+void PackFetchTask::parseCached(bool final)
+{
+    auto generation = ++m_generation;
+    auto publicVersion = versionOf(m_publicEntry);
+    auto thirdPartyVersion = versionOf(m_thirdPartyEntry);
+    auto watcher = new QFutureWatcher<Lists>(this);
+    connect(watcher, &QFutureWatcher<Lists>::finished, this, [this, watcher, generation, final, publicVersion, thirdPartyVersion] {
+        watcher->deleteLater();
+        if (generation != m_generation)
+            return;
+        auto lists = watcher->result();
+        if (!lists.failed.isEmpty()) {
+            // a broken cache is replaced by the download anyway
+            if (!final) {
+                m_hasCached = false;
+                return;
+            }
+            emit failed(tr("Failed to download some pack lists: %1").arg(lists.failed.join("\n- ")));
+            return;
+        }
+        m_shownPublic = publicVersion;
+        m_shownThirdParty = thirdPartyVersion;
+        emit finished(lists.publicPacks, lists.thirdPartyPacks);
+    });
+    auto publicPath = m_publicEntry->getFullPath();
+    auto thirdPartyPath = m_thirdPartyEntry->getFullPath();
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Interactive,
+                                                 [publicPath, thirdPartyPath] { return parseLists(publicPath, thirdPartyPath); }));
 }
 
-bool PackFetchTask::parseAndAddPacks(QByteArray& data, PackType packType, ModpackList& list)
+PackFetchTask::Lists PackFetchTask::parseLists(const QString& publicPath, const QString& thirdPartyPath)
 {
-    QDomDocument doc;
+    Lists lists;
+    auto parseFile = [&lists](const QString& path, PackType type, ModpackList& list, const QString& name) {
+        QFile file(path);
+        QString error;
+        if (!file.open(QIODevice::ReadOnly) || !parsePacks(&file, type, list, &error)) {
+            qWarning() << "Failed to read" << path << error;
+            lists.failed.append(name);
+        }
+    };
+    parseFile(publicPath, PackType::Public, lists.publicPacks, tr("Public Packs"));
+    parseFile(thirdPartyPath, PackType::ThirdParty, lists.thirdPartyPacks, tr("Third Party Packs"));
+    return lists;
+}
 
-    QString errorMsg = "Unknown error.";
-    int errorLine = -1;
-    int errorCol = -1;
+void PackFetchTask::fileDownloadFinished()
+{
+    jobPtr.reset();
 
-    if (!doc.setContent(data, false, &errorMsg, &errorLine, &errorCol)) {
-        auto fullErrMsg = QString("Failed to fetch modpack data: %1 %2:%3!").arg(errorMsg).arg(errorLine).arg(errorCol);
-        qWarning() << fullErrMsg;
-        data.clear();
-        return false;
-    }
+    // revalidated, what's shown is what there is
+    if (m_shownPublic == versionOf(m_publicEntry) && m_shownThirdParty == versionOf(m_thirdPartyEntry))
+        return;
+    parseCached(true);
+}
 
-    QDomNodeList nodes = doc.elementsByTagName("modpack");
-    for (int i = 0; i < nodes.length(); i++) {
-        QDomElement element = nodes.at(i).toElement();
+bool PackFetchTask::parsePacks(QIODevice* input, PackType packType, ModpackList& list, QString* error)
+{
+    QXmlStreamReader xml(input);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("modpack"))
+            continue;
+        auto attributes = xml.attributes();
+        auto attribute = [&attributes](const char* name) { return attributes.value(QLatin1String(name)).toString(); };
 
         Modpack modpack;
-        modpack.name = element.attribute("name");
-        modpack.currentVersion = element.attribute("version");
-        modpack.mcVersion = element.attribute("mcVersion");
-        modpack.description = element.attribute("description");
-        modpack.mods = element.attribute("mods");
-        modpack.logo = element.attribute("logo");
-        modpack.oldVersions = element.attribute("oldVersions").split(";");
+        modpack.name = attribute("name");
+        modpack.currentVersion = attribute("version");
+        modpack.mcVersion = attribute("mcVersion");
+        modpack.description = attribute("description");
+        modpack.mods = attribute("mods");
+        modpack.logo = attribute("logo");
+        modpack.oldVersions = attribute("oldVersions").split(";");
         modpack.broken = false;
         modpack.bugged = false;
 
         // remove empty if the xml is bugged
-        for (QString curr : modpack.oldVersions) {
-            if (curr.isNull() || curr.isEmpty()) {
-                modpack.oldVersions.removeAll(curr);
-                modpack.bugged = true;
-                qWarning() << "Removed some empty versions from" << modpack.name;
-            }
+        if (modpack.oldVersions.removeAll(QString()) > 0) {
+            modpack.bugged = true;
+            qWarning() << "Removed some empty versions from" << modpack.name;
         }
 
         if (modpack.oldVersions.size() < 1) {
@@ -176,22 +219,33 @@ bool PackFetchTask::parseAndAddPacks(QByteArray& data, PackType packType, Modpac
             }
         }
 
-        modpack.author = element.attribute("author");
+        modpack.author = attribute("author");
 
-        modpack.dir = element.attribute("dir");
-        modpack.file = element.attribute("url");
+        modpack.dir = attribute("dir");
+        modpack.file = attribute("url");
 
         modpack.type = packType;
 
         list.append(modpack);
     }
 
+    if (xml.hasError()) {
+        auto fullErrMsg =
+            QString("Failed to fetch modpack data: %1 %2:%3!").arg(xml.errorString()).arg(xml.lineNumber()).arg(xml.columnNumber());
+        qWarning() << fullErrMsg;
+        if (error)
+            *error = fullErrMsg;
+        return false;
+    }
     return true;
 }
 
 void PackFetchTask::fileDownloadFailed(QString reason)
 {
     qWarning() << "Fetching FTBPacks failed:" << reason;
+    // the lists from the last time are still good to go
+    if (m_hasCached)
+        return;
     emit failed(reason);
 }
 
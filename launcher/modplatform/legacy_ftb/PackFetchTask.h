@@ -1,10 +1,14 @@
 #pragma once
 
 #include <QByteArray>
+#include <QDateTime>
+#include <QFutureWatcher>
 #include <QObject>
 #include <QTemporaryDir>
 #include <memory>
+#include <optional>
 #include "PackHelpers.h"
+#include "net/HttpMetaCache.h"
 #include "net/NetJob.h"
 
 namespace LegacyFTB {
@@ -16,19 +20,44 @@ class PackFetchTask : public QObject {
     PackFetchTask(shared_qobject_ptr<QNetworkAccessManager> network) : QObject(nullptr), m_network(network){};
     virtual ~PackFetchTask() = default;
 
+    /// the lists as they were last downloaded come first when there's any, then the new ones if they changed since
     void fetch();
     void fetchPrivate(const QStringList& toFetch);
 
+    /// read the packs out of an FTB pack list, on any thread
+    static bool parsePacks(QIODevice* input, PackType packType, ModpackList& list, QString* error = nullptr);
+
+   private:
+    struct Lists {
+        ModpackList publicPacks;
+        ModpackList thirdPartyPacks;
+        QStringList failed;
+    };
+    /// what changes when a list got downloaded again, rather than revalidated
+    struct Version {
+        QString etag;
+        QDateTime modified;
+        bool operator==(const Version& other) const { return etag == other.etag && modified == other.modified; }
+    };
+
+    static Lists parseLists(const QString& publicPath, const QString& thirdPartyPath);
+    static Version versionOf(const MetaEntryPtr& entry);
+    /// parse the downloaded lists on the thread pool, failing if `final` and they can't be read
+    void parseCached(bool final);
+
    private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
     NetJob::Ptr jobPtr;
 
-    std::shared_ptr<QByteArray> publicModpacksXmlFileData = std::make_shared<QByteArray>();
-    std::shared_ptr<QByteArray> thirdPartyModpacksXmlFileData = std::make_shared<QByteArray>();
-
-    bool parseAndAddPacks(QByteArray& data, PackType packType, ModpackList& list);
-    ModpackList publicPacks;
-    ModpackList thirdPartyPacks;
+    MetaEntryPtr m_publicEntry;
+    MetaEntryPtr m_thirdPartyEntry;
+    // what was shown already
+    std::optional<Version> m_shownPublic;
+    std::optional<Version> m_shownThirdParty;
+    // only the lists parsed last get shown
+    int m_generation = 0;
+    // the lists were downloaded before, a download failing now doesn't leave the page empty
+    bool m_hasCached = false;
 
    protected slots:
     void fileDownloadFinished();
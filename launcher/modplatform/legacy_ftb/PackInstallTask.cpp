@@ -35,8 +35,6 @@
 
 #include "PackInstallTask.h"
 
-#include <QtConcurrent>
-
 #include "BaseInstance.h"
 #include "FileSystem.h"
 #include "MMCZip.h"
@@ -44,6 +42,7 @@
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
 #include "settings/INISettingsObject.h"
+#include "tasks/Executor.h"
 
 #include "Application.h"
 #include "BuildConfig.h"
@@ -75,6 +74,7 @@ void PackInstallTask::downloadPack()
     entry->setStale(true);
     archivePath = entry->getFullPath();
     netJobContainer.reset(new NetJob("Download FTB Pack", m_network));
+    netJobContainer->setPriority(Net::Priority::Bulk);
     QString url;
     if (m_pack.type == PackType::Private) {
         url = QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "privatepacks/%1").arg(path);
@@ -108,13 +108,10 @@ void PackInstallTask::unzip()
         return;
     }
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    m_extractFuture = QtConcurrent::run(QThreadPool::globalInstance(), QOverload<QString, QString>::of(MMCZip::extractDir), archivePath,
-                                        extractDir.absolutePath() + "/unzip");
-#else
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractDir, archivePath, extractDir.absolutePath() + "/unzip");
-#endif
+    auto cancel = cancellationToken();
+    auto target = extractDir.absolutePath() + "/unzip";
+    m_extractFuture = Executor::instance()->run(
+        Executor::Priority::Bulk, [archivePath, target, cancel] { return MMCZip::extractDir(archivePath, target, cancel); }, cancel);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &PackInstallTask::onUnzipFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &PackInstallTask::onUnzipCanceled);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -2,6 +2,9 @@
 #include "ModrinthAPI.h"
 #include "ModrinthPackIndex.h"
 
+#include <QDateTime>
+#include <QHash>
+
 #include "Json.h"
 
 #include "ResourceDownloadTask.h"
@@ -15,6 +18,28 @@
 static ModrinthAPI api;
 static ModPlatform::ProviderCapabilities ProviderCaps;
 
+namespace {
+// how long an answer from Modrinth is trusted, checking again right after only needs the mods hashed
+constexpr qint64 s_answerTtl = 15 * 60;
+
+struct LatestVersion {
+    // when Modrinth was asked, in seconds since epoch
+    qint64 fetched = 0;
+    // empty if there was no valid version
+    QJsonObject version;
+};
+// keyed by what was asked for and the hash
+QHash<QString, LatestVersion> s_latestVersions;
+
+QString requestKey(const QString& hash_type, const std::list<Version>& mcVersions, std::optional<ModPlatform::ModLoaderTypes> loaders)
+{
+    QStringList parts{ hash_type, QString::number(loaders ? int(*loaders) : -1) };
+    for (auto& ver : mcVersions)
+        parts.append(ver.toString());
+    return parts.join(',') + ':';
+}
+}  // namespace
+
 bool ModrinthCheckUpdate::abort()
 {
     if (m_net_job)
@@ -38,7 +63,9 @@ void ModrinthCheckUpdate::executeTask()
     QStringList hashes;
     auto best_hash_type = ProviderCaps.hashType(ModPlatform::ResourceProvider::MODRINTH).first();
 
-    ConcurrentTask hashing_task(this, "MakeModrinthHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+    auto max_hashers = APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt();
+    ConcurrentTask hashing_task(this, "MakeModrinthHashesTask", max_hashers);
+    hashing_task.setAdaptiveConcurrency(1, 2 * max_hashers);
     for (auto* mod : m_mods) {
         if (!mod->enabled()) {
             emit checkFailed(mod, tr("Disabled mods won't be updated, to prevent mod duplication issues!"));
@@ -69,117 +96,151 @@ void ModrinthCheckUpdate::executeTask()
     hashing_task.start();
     loop.exec();
 
-    auto response = std::make_shared<QByteArray>();
-    auto job = api.latestVersions(hashes, best_hash_type, m_game_versions, m_loaders, response);
+    // what Modrinth answered recently for the same hashes is still good
+    QJsonObject answers;
+    QStringList unknown;
+    auto request = requestKey(best_hash_type, m_game_versions, m_loaders);
+    auto now = QDateTime::currentSecsSinceEpoch();
+    for (auto& hash : hashes) {
+        auto cached = s_latestVersions.constFind(request + hash);
+        if (cached != s_latestVersions.constEnd() && cached->fetched >= now - s_answerTtl) {
+            answers.insert(hash, cached->version);
+        } else {
+            unknown.append(hash);
+        }
+    }
+    qDebug() << "Asking Modrinth about" << unknown.size() << "of" << hashes.size() << "mods, the rest was checked recently";
+
+    if (!unknown.isEmpty()) {
+        auto response = std::make_shared<QByteArray>();
+        auto job = api.latestVersions(unknown, best_hash_type, m_game_versions, m_loaders, response);
+
+        QEventLoop lock;
+
+        connect(job.get(), &Task::succeeded, this, [this, response, &answers, &unknown, &request] {
+            QJsonParseError parse_error{};
+            QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
+            if (parse_error.error != QJsonParseError::NoError) {
+                qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
+                           << " reason: " << parse_error.errorString();
+                qWarning() << *response;
+
+                failed(parse_error.errorString());
+                return;
+            }
+
+            // hashes without a valid version are left out, that's an answer as well
+            auto fetched = QDateTime::currentSecsSinceEpoch();
+            auto versions = doc.object();
+            for (auto& hash : unknown) {
+                auto version = versions.value(hash).toObject();
+                s_latestVersions.insert(request + hash, { fetched, version });
+                answers.insert(hash, version);
+            }
+        });
+
+        connect(job.get(), &Task::finished, &lock, &QEventLoop::quit);
+
+        setStatus(tr("Waiting for the API response from Modrinth..."));
+        setProgress(1, 3);
 
-    QEventLoop lock;
+        m_net_job = qSharedPointerObjectCast<NetJob, Task>(job);
+        job->start();
 
-    connect(job.get(), &Task::succeeded, this, [this, response, &mappings, best_hash_type, job] {
-        QJsonParseError parse_error{};
-        QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-        if (parse_error.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from ModrinthCheckUpdate at " << parse_error.offset
-                       << " reason: " << parse_error.errorString();
-            qWarning() << *response;
+        lock.exec();
 
-            failed(parse_error.errorString());
+        if (!job->wasSuccessful()) {
+            emitSucceeded();
             return;
         }
+    }
 
-        setStatus(tr("Parsing the API response from Modrinth..."));
-        setProgress(2, 3);
+    setStatus(tr("Parsing the API response from Modrinth..."));
+    setProgress(2, 3);
 
-        try {
-            for (auto hash : mappings.keys()) {
-                auto project_obj = doc[hash].toObject();
+    try {
+        for (auto hash : mappings.keys()) {
+            // not even asked about, the request failed
+            if (!answers.contains(hash))
+                continue;
+            auto project_obj = answers[hash].toObject();
 
-                // If the returned project is empty, but we have Modrinth metadata,
-                // it means this specific version is not available
-                if (project_obj.isEmpty()) {
-                    qDebug() << "Mod " << mappings.find(hash).value()->name() << " got an empty response.";
-                    qDebug() << "Hash: " << hash;
+            // If the returned project is empty, but we have Modrinth metadata,
+            // it means this specific version is not available
+            if (project_obj.isEmpty()) {
+                qDebug() << "Mod " << mappings.find(hash).value()->name() << " got an empty response.";
+                qDebug() << "Hash: " << hash;
 
-                    emit checkFailed(
-                        mappings.find(hash).value(),
-                        tr("No valid version found for this mod. It's probably unavailable for the current game version / mod loader."));
+                emit checkFailed(
+                    mappings.find(hash).value(),
+                    tr("No valid version found for this mod. It's probably unavailable for the current game version / mod loader."));
 
-                    continue;
-                }
+                continue;
+            }
 
-                // Sometimes a version may have multiple files, one with "forge" and one with "fabric",
-                // so we may want to filter it
-                QString loader_filter;
-                if (m_loaders.has_value()) {
-                    static auto flags = { ModPlatform::ModLoaderType::NeoForge, ModPlatform::ModLoaderType::Forge,
-                                          ModPlatform::ModLoaderType::Fabric, ModPlatform::ModLoaderType::Quilt };
-                    for (auto flag : flags) {
-                        if (m_loaders.value().testFlag(flag)) {
-                            loader_filter = ModPlatform::getModLoaderString(flag);
-                            break;
-                        }
+            // Sometimes a version may have multiple files, one with "forge" and one with "fabric",
+            // so we may want to filter it
+            QString loader_filter;
+            if (m_loaders.has_value()) {
+                static auto flags = { ModPlatform::ModLoaderType::NeoForge, ModPlatform::ModLoaderType::Forge,
+                                      ModPlatform::ModLoaderType::Fabric, ModPlatform::ModLoaderType::Quilt };
+                for (auto flag : flags) {
+                    if (m_loaders.value().testFlag(flag)) {
+                        loader_filter = ModPlatform::getModLoaderString(flag);
+                        break;
                     }
                 }
+            }
 
-                // Currently, we rely on a couple heuristics to determine whether an update is actually available or not:
-                // - The file needs to be preferred: It is either the primary file, or the one found via (explicit) usage of the
-                // loader_filter
-                // - The version reported by the JAR is different from the version reported by the indexed version (it's usually the case)
-                // Such is the pain of having arbitrary files for a given version .-.
-
-                auto project_ver = Modrinth::loadIndexedPackVersion(project_obj, best_hash_type, loader_filter);
-                if (project_ver.downloadUrl.isEmpty()) {
-                    qCritical() << "Modrinth mod without download url!";
-                    qCritical() << project_ver.fileName;
+            // Currently, we rely on a couple heuristics to determine whether an update is actually available or not:
+            // - The file needs to be preferred: It is either the primary file, or the one found via (explicit) usage of the
+            // loader_filter
+            // - The version reported by the JAR is different from the version reported by the indexed version (it's usually the case)
+            // Such is the pain of having arbitrary files for a given version .-.
 
-                    emit checkFailed(mappings.find(hash).value(), tr("Mod has an empty download URL"));
+            auto project_ver = Modrinth::loadIndexedPackVersion(project_obj, best_hash_type, loader_filter);
+            if (project_ver.downloadUrl.isEmpty()) {
+                qCritical() << "Modrinth mod without download url!";
+                qCritical() << project_ver.fileName;
 
-                    continue;
-                }
+                emit checkFailed(mappings.find(hash).value(), tr("Mod has an empty download URL"));
 
-                auto mod_iter = mappings.find(hash);
-                if (mod_iter == mappings.end()) {
-                    qCritical() << "Failed to remap mod from Modrinth!";
-                    continue;
-                }
-                auto mod = *mod_iter;
-
-                auto key = project_ver.hash;
-
-                // Fake pack with the necessary info to pass to the download task :)
-                auto pack = std::make_shared<ModPlatform::IndexedPack>();
-                pack->name = mod->name();
-                pack->slug = mod->metadata()->slug;
-                pack->addonId = mod->metadata()->project_id;
-                pack->websiteUrl = mod->homeurl();
-                for (auto& author : mod->authors())
-                    pack->authors.append({ author });
-                pack->description = mod->description();
-                pack->provider = ModPlatform::ResourceProvider::MODRINTH;
-                if ((key != hash && project_ver.is_preferred) || (mod->status() == ModStatus::NotInstalled)) {
-                    if (mod->version() == project_ver.version_number)
-                        continue;
-
-                    auto download_task = makeShared<ResourceDownloadTask>(pack, project_ver, m_mods_folder);
-
-                    m_updatable.emplace_back(pack->name, hash, mod->version(), project_ver.version_number, project_ver.version_type,
-                                             project_ver.changelog, ModPlatform::ResourceProvider::MODRINTH, download_task);
-                }
-                m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, project_ver));
+                continue;
             }
-        } catch (Json::JsonException& e) {
-            failed(e.cause() + " : " + e.what());
-        }
-    });
 
-    connect(job.get(), &Task::finished, &lock, &QEventLoop::quit);
-
-    setStatus(tr("Waiting for the API response from Modrinth..."));
-    setProgress(1, 3);
+            auto mod_iter = mappings.find(hash);
+            if (mod_iter == mappings.end()) {
+                qCritical() << "Failed to remap mod from Modrinth!";
+                continue;
+            }
+            auto mod = *mod_iter;
+
+            auto key = project_ver.hash;
+
+            // Fake pack with the necessary info to pass to the download task :)
+            auto pack = std::make_shared<ModPlatform::IndexedPack>();
+            pack->name = mod->name();
+            pack->slug = mod->metadata()->slug;
+            pack->addonId = mod->metadata()->project_id;
+            pack->websiteUrl = mod->homeurl();
+            for (auto& author : mod->authors())
+                pack->authors.append({ author });
+            pack->description = mod->description();
+            pack->provider = ModPlatform::ResourceProvider::MODRINTH;
+            if ((key != hash && project_ver.is_preferred) || (mod->status() == ModStatus::NotInstalled)) {
+                if (mod->version() == project_ver.version_number)
+                    continue;
 
-    m_net_job = qSharedPointerObjectCast<NetJob, Task>(job);
-    job->start();
+                auto download_task = makeShared<ResourceDownloadTask>(pack, project_ver, m_mods_folder);
 
-    lock.exec();
+                m_updatable.emplace_back(pack->name, hash, mod->version(), project_ver.version_number, project_ver.version_type,
+                                         project_ver.changelog, ModPlatform::ResourceProvider::MODRINTH, download_task);
+            }
+            m_deps.append(std::make_shared<GetModDependenciesTask::PackDependency>(pack, project_ver));
+        }
+    } catch (Json::JsonException& e) {
+        failed(e.cause() + " : " + e.what());
+    }
 
     emitSucceeded();
 }
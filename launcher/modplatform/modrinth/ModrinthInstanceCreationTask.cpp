@@ -20,6 +20,7 @@
 #include "ui/pages/modplatform/OptionalModDialog.h"
 
 #include <QAbstractButton>
+#include <QHash>
 #include <vector>
 
 bool ModrinthCreationTask::abort()
@@ -81,60 +82,38 @@ bool ModrinthCreationTask::updateInstance()
         std::vector<Modrinth::File> old_files;
         parseManifest(old_index_path, old_files, false, false);
 
-        // Let's remove all duplicated, identical resources!
-        auto files_iterator = m_files.begin();
-    begin:
-        while (files_iterator != m_files.end()) {
-            auto const& file = *files_iterator;
-
-            auto old_files_iterator = old_files.begin();
-            while (old_files_iterator != old_files.end()) {
-                auto const& old_file = *old_files_iterator;
-
-                if (old_file.hash == file.hash) {
-                    qDebug() << "Removed file at" << file.path << "from list of downloads";
-                    files_iterator = m_files.erase(files_iterator);
-                    old_files_iterator = old_files.erase(old_files_iterator);
-                    goto begin;  // Sorry :c
-                }
-
-                old_files_iterator++;
+        // The files that are still there as they were are neither downloaded again nor removed
+        QHash<QString, QByteArray> old_hashes;
+        for (auto const& old_file : old_files)
+            old_hashes.insert(old_file.path, old_file.hash);
+        std::vector<Modrinth::File> changed_files;
+        for (auto const& file : m_files) {
+            auto old_hash = old_hashes.find(file.path);
+            if (old_hash != old_hashes.end() && *old_hash == file.hash) {
+                qDebug() << "Removed file at" << file.path << "from list of downloads";
+                old_hashes.erase(old_hash);
+                continue;
             }
-
-            files_iterator++;
+            changed_files.push_back(file);
         }
+        m_files = std::move(changed_files);
 
         QDir old_minecraft_dir(inst->gameRoot());
 
         // Some files were removed from the old version, and some will be downloaded in an updated version,
         // so we're fine removing them!
-        if (!old_files.empty()) {
-            for (auto const& file : old_files) {
-                if (file.path.isEmpty())
-                    continue;
-                qDebug() << "Scheduling" << file.path << "for removal";
-                m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(file.path));
-            }
-        }
-
-        // We will remove all the previous overrides, to prevent duplicate files!
-        // TODO: Currently 'overrides' will always override the stuff on update. How do we preserve unchanged overrides?
-        // FIXME: We may want to do something about disabled mods.
-        auto old_overrides = Override::readOverrides("overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
+        for (auto it = old_hashes.constBegin(); it != old_hashes.constEnd(); ++it) {
+            if (it.key().isEmpty())
                 continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
+            qDebug() << "Scheduling" << it.key() << "for removal";
+            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(it.key()));
         }
 
-        auto old_client_overrides = Override::readOverrides("client-overrides", old_index_folder);
-        for (const auto& entry : old_overrides) {
-            if (entry.isEmpty())
-                continue;
-            qDebug() << "Scheduling" << entry << "for removal";
-            m_files_to_remove.append(old_minecraft_dir.absoluteFilePath(entry));
-        }
+        // The overrides are compared with the new ones once those are staged, only the changed ones are replaced.
+        // FIXME: We may want to do something about disabled mods.
+        m_old_game_root = inst->gameRoot();
+        m_old_overrides = Override::readOverrides("overrides", old_index_folder);
+        m_old_overrides += Override::readOverrides("client-overrides", old_index_folder);
     } else {
         // We don't have an old index file, so we may duplicate stuff!
         auto dialog = CustomMessageBox::selectable(m_parent, tr("No index file."),
@@ -168,38 +147,6 @@ bool ModrinthCreationTask::createInstance()
     if (m_files.empty() && !parseManifest(index_path, m_files, true, true))
         return false;
 
-    // Keep index file in case we need it some other time (like when changing versions)
-    QString new_index_place(FS::PathCombine(parent_folder, "modrinth.index.json"));
-    FS::ensureFilePathExists(new_index_place);
-    QFile::rename(index_path, new_index_place);
-
-    auto mcPath = FS::PathCombine(m_stagingPath, ".minecraft");
-
-    auto override_path = FS::PathCombine(m_stagingPath, "overrides");
-    if (QFile::exists(override_path)) {
-        // Create a list of overrides in "overrides.txt" inside mrpack/
-        Override::createOverrides("overrides", parent_folder, override_path);
-
-        // Apply the overrides
-        if (!QFile::rename(override_path, mcPath)) {
-            setError(tr("Could not rename the overrides folder:\n") + "overrides");
-            return false;
-        }
-    }
-
-    // Do client overrides
-    auto client_override_path = FS::PathCombine(m_stagingPath, "client-overrides");
-    if (QFile::exists(client_override_path)) {
-        // Create a list of overrides in "client-overrides.txt" inside mrpack/
-        Override::createOverrides("client-overrides", parent_folder, client_override_path);
-
-        // Apply the overrides
-        if (!FS::overrideFolder(mcPath, client_override_path)) {
-            setError(tr("Could not rename the client overrides folder:\n") + "client overrides");
-            return false;
-        }
-    }
-
     QString configPath = FS::PathCombine(m_stagingPath, "instance.cfg");
     auto instanceSettings = std::make_shared<INISettingsObject>(configPath);
     MinecraftInstance instance(m_globalSettings, instanceSettings, m_stagingPath);
@@ -230,6 +177,7 @@ bool ModrinthCreationTask::createInstance()
     instance.saveNow();
 
     m_files_job.reset(new NetJob(tr("Mod Download Modrinth"), APPLICATION->network()));
+    m_files_job->setPriority(Net::Priority::Bulk);
 
     auto root_modpack_path = FS::PathCombine(m_stagingPath, ".minecraft");
     auto root_modpack_url = QUrl::fromLocalFile(root_modpack_path);
@@ -244,7 +192,8 @@ bool ModrinthCreationTask::createInstance()
         }
 
         qDebug() << "Will try to download" << file.downloads.front() << "to" << file_path;
-        auto dl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path);
+        auto dl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path,
+                                             Net::Download::Option::Segmented | Net::Download::Option::Resumable);
         dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
         m_files_job->addNetAction(dl);
 
@@ -253,7 +202,8 @@ bool ModrinthCreationTask::createInstance()
             // MultipleOptionsTask's , once those exist :)
             auto param = dl.toWeakRef();
             connect(dl.get(), &NetAction::failed, [this, &file, file_path, param] {
-                auto ndl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path);
+                auto ndl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path,
+                                                      Net::Download::Option::Segmented | Net::Download::Option::Resumable);
                 ndl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
                 m_files_job->addNetAction(ndl);
                 if (auto shared = param.lock())
@@ -281,6 +231,16 @@ bool ModrinthCreationTask::createInstance()
 
     loop.exec();
 
+    // the files are downloaded while the rest of the pack gets extracted
+    ended_well = ended_well && waitForExtraction() && applyOverrides(index_path, parent_folder);
+
+    // When updating, only what changed goes over to the instance
+    if (m_instance && ended_well) {
+        auto new_overrides = Override::readOverrides("overrides", parent_folder);
+        new_overrides += Override::readOverrides("client-overrides", parent_folder);
+        diffOverrides(FS::PathCombine(m_stagingPath, ".minecraft"), new_overrides);
+    }
+
     // Update information of the already installed instance, if any.
     if (m_instance && ended_well) {
         setAbortable(false);
@@ -300,6 +260,43 @@ bool ModrinthCreationTask::createInstance()
     return ended_well;
 }
 
+bool ModrinthCreationTask::applyOverrides(const QString& index_path, const QString& parent_folder)
+{
+    // Keep index file in case we need it some other time (like when changing versions)
+    QString new_index_place(FS::PathCombine(parent_folder, "modrinth.index.json"));
+    FS::ensureFilePathExists(new_index_place);
+    QFile::rename(index_path, new_index_place);
+
+    auto mcPath = FS::PathCombine(m_stagingPath, ".minecraft");
+
+    // The downloaded files are there already and win over both kinds of overrides, like they always did.
+    // Client overrides go in first, so they win over the common ones.
+    auto client_override_path = FS::PathCombine(m_stagingPath, "client-overrides");
+    if (QFile::exists(client_override_path)) {
+        // Create a list of overrides in "client-overrides.txt" inside mrpack/
+        Override::createOverrides("client-overrides", parent_folder, client_override_path);
+
+        // Apply the overrides
+        if (!mergeFolder(client_override_path, mcPath)) {
+            setError(tr("Could not rename the client overrides folder:\n") + "client overrides");
+            return false;
+        }
+    }
+
+    auto override_path = FS::PathCombine(m_stagingPath, "overrides");
+    if (QFile::exists(override_path)) {
+        // Create a list of overrides in "overrides.txt" inside mrpack/
+        Override::createOverrides("overrides", parent_folder, override_path);
+
+        // Apply the overrides
+        if (!mergeFolder(override_path, mcPath)) {
+            setError(tr("Could not rename the overrides folder:\n") + "overrides");
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ModrinthCreationTask::parseManifest(const QString& index_path,
                                          std::vector<Modrinth::File>& files,
                                          bool set_internal_data,
@@ -35,6 +35,8 @@ class ModrinthCreationTask final : public InstanceCreationTask {
 
    private:
     bool parseManifest(const QString&, std::vector<Modrinth::File>&, bool set_internal_data = true, bool show_optional_dialog = true);
+    // move the index and the overrides into place, once the pack is extracted and the files are downloaded
+    bool applyOverrides(const QString& index_path, const QString& parent_folder);
 
    private:
     QWidget* m_parent = nullptr;
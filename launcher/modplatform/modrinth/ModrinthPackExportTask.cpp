@@ -18,15 +18,17 @@
 
 #include "ModrinthPackExportTask.h"
 
-#include <QCryptographicHash>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QtConcurrentRun>
+#include "Application.h"
 #include "Json.h"
 #include "MMCZip.h"
 #include "minecraft/PackProfile.h"
 #include "minecraft/mod/MetadataHandler.h"
 #include "minecraft/mod/ModFolderModel.h"
+#include "modplatform/helpers/HashUtils.h"
+#include "tasks/ConcurrentTask.h"
 
 const QStringList ModrinthPackExportTask::PREFIXES({ "mods/", "coremods/", "resourcepacks/", "texturepacks/", "shaderpacks/" });
 const QStringList ModrinthPackExportTask::FILE_EXTENSIONS({ "jar", "litemod", "zip" });
@@ -58,14 +60,27 @@ void ModrinthPackExportTask::executeTask()
 
 bool ModrinthPackExportTask::abort()
 {
-    if (task) {
-        task->abort();
+    if (task || zipTask) {
+        if (task)
+            task->abort();
+        if (zipTask)
+            zipTask->abort();
         emitAborted();
         return true;
     }
     return false;
 }
 
+// only what's in these folders with these extensions can be downloaded instead of being in the pack
+bool ModrinthPackExportTask::mayBeOnModrinth(const QString& relative)
+{
+    if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
+        return false;
+    return std::any_of(FILE_EXTENSIONS.begin(), FILE_EXTENSIONS.end(), [&relative](const QString& extension) {
+        return relative.endsWith('.' + extension) || relative.endsWith('.' + extension + ".disabled");
+    });
+}
+
 void ModrinthPackExportTask::collectFiles()
 {
     setAbortable(false);
@@ -80,85 +95,98 @@ void ModrinthPackExportTask::collectFiles()
     pendingHashes.clear();
     resolvedFiles.clear();
 
+    // everything else goes into the zip while these are looked up
+    QStringList deferred;
+    for (const QFileInfo& file : files) {
+        const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
+        if (mayBeOnModrinth(relative))
+            deferred << relative;
+    }
+    startZip(deferred);
+
     if (mcInstance) {
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(mcInstance->loaderModList().get(), &ModFolderModel::updateFinished, this, [this, connection] {
+            disconnect(*connection);
+            collectHashes();
+        });
         mcInstance->loaderModList()->update();
-        connect(mcInstance->loaderModList().get(), &ModFolderModel::updateFinished, this, &ModrinthPackExportTask::collectHashes);
     } else
         collectHashes();
 }
 
 void ModrinthPackExportTask::collectHashes()
 {
+    if (!isRunning())
+        return;
     setStatus(tr("Finding file hashes..."));
-    for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
-
-        const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
-        // require sensible file types
-        if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
-            continue;
-        if (!std::any_of(FILE_EXTENSIONS.begin(), FILE_EXTENSIONS.end(), [&relative](const QString& extension) {
-                return relative.endsWith('.' + extension) || relative.endsWith('.' + extension + ".disabled");
-            }))
-            continue;
 
-        QCryptographicHash sha512(QCryptographicHash::Algorithm::Sha512);
+    QHash<QString, Mod*> mods;
+    if (mcInstance) {
+        for (auto mod : mcInstance->loaderModList()->allMods())
+            mods.insert(mod->fileinfo().absoluteFilePath(), mod);
+    }
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
+    // the hashes come from the hash cache when the files were hashed before, they're computed in parallel otherwise
+    auto maxHashers = APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt();
+    ConcurrentTask::Ptr hashingTask(new ConcurrentTask(this, "MakeHashesTask", maxHashers));
+    hashingTask->setAdaptiveConcurrency(1, 2 * maxHashers);
+    task.reset(hashingTask);
+    for (const QFileInfo& file : files) {
+        const QString path = file.absoluteFilePath();
+        const QString relative = gameRoot.relativeFilePath(path);
+        if (!mayBeOnModrinth(relative))
             continue;
-        }
 
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
-            continue;
-        }
-        sha512.addData(data);
-
-        auto allMods = mcInstance->loaderModList()->allMods();
-        if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
-            modIter != allMods.end()) {
-            const Mod* mod = *modIter;
-            if (mod->metadata() != nullptr) {
-                QUrl& url = mod->metadata()->url;
-                // ensure the url is permitted on modrinth.com
-                if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
-                    qDebug() << "Resolving" << relative << "from index";
-
-                    QCryptographicHash sha1(QCryptographicHash::Algorithm::Sha1);
-                    sha1.addData(data);
-
-                    ResolvedFile resolvedFile{ sha1.result().toHex(), sha512.result().toHex(), url.toEncoded(), openFile.size(),
-                                               mod->metadata()->side };
-                    resolvedFiles[relative] = resolvedFile;
-
-                    // nice! we've managed to resolve based on local metadata!
-                    // no need to enqueue it
-                    continue;
-                }
+        // with a download url in its metadata, the file doesn't have to be looked up
+        QUrl url;
+        Metadata::ModSide side = Metadata::ModSide::UniversalSide;
+        if (auto mod = mods.value(path); mod && mod->metadata()) {
+            // ensure the url is permitted on modrinth.com
+            if (BuildConfig.MODRINTH_MRPACK_HOSTS.contains(mod->metadata()->url.host())) {
+                url = mod->metadata()->url;
+                side = mod->metadata()->side;
             }
         }
 
-        qDebug() << "Enqueueing" << relative << "for Modrinth query";
-        pendingHashes[relative] = sha512.result().toHex();
+        auto hashTask = Hashing::createModrinthHasher(path);
+        connect(hashTask.get(), &Hashing::Hasher::resultsReady, this, [this, path, relative, url, side](QString sha512) {
+            if (!isRunning())
+                return;
+            if (url.isEmpty()) {
+                qDebug() << "Enqueueing" << relative << "for Modrinth query";
+                pendingHashes[relative] = sha512;
+                return;
+            }
+            qDebug() << "Resolving" << relative << "from index";
+            // hashed along with the sha512, so it's in the cache
+            auto sha1 = Hashing::cachedHash(path, "sha1");
+            resolvedFiles[relative] = ResolvedFile{ sha1, sha512, url.toEncoded(), QFileInfo(path).size(), side };
+        });
+        connect(hashTask.get(), &Task::failed, this, &ModrinthPackExportTask::fail);
+        hashingTask->addTask(hashTask);
     }
 
+    connect(hashingTask.get(), &Task::succeeded, this, &ModrinthPackExportTask::makeApiRequest);
+    connect(hashingTask.get(), &Task::failed, this, &ModrinthPackExportTask::fail);
+    connect(hashingTask.get(), &Task::progress, this, &ModrinthPackExportTask::setProgress);
     setAbortable(true);
-    makeApiRequest();
+    hashingTask->start();
 }
 
 void ModrinthPackExportTask::makeApiRequest()
 {
+    if (!isRunning())
+        return;
     if (pendingHashes.isEmpty())
-        buildZip();
+        finishZip();
     else {
+        // all of them in one request
         setStatus(tr("Finding versions for hashes..."));
         auto response = std::make_shared<QByteArray>();
         task = api.currentVersions(pendingHashes.values(), "sha512", response);
         connect(task.get(), &NetJob::succeeded, [this, response]() { parseApiResponse(response); });
-        connect(task.get(), &NetJob::failed, this, &ModrinthPackExportTask::emitFailed);
+        connect(task.get(), &NetJob::failed, this, &ModrinthPackExportTask::fail);
         task->start();
     }
 }
@@ -189,21 +217,17 @@ void ModrinthPackExportTask::parseApiResponse(const std::shared_ptr<QByteArray>
             }
         }
     } catch (const Json::JsonException& e) {
-        emitFailed(tr("Failed to parse versions response: %1").arg(e.what()));
+        fail(tr("Failed to parse versions response: %1").arg(e.what()));
         return;
     }
     pendingHashes.clear();
-    buildZip();
+    finishZip();
 }
 
-void ModrinthPackExportTask::buildZip()
+void ModrinthPackExportTask::startZip(const QStringList& deferred)
 {
-    setStatus(tr("Adding files..."));
-
-    auto zipTask = makeShared<MMCZip::ExportToZipTask>(output, gameRoot, files, "overrides/", true);
-    zipTask->addExtraFile("modrinth.index.json", generateIndex());
-
-    zipTask->setExcludeFiles(resolvedFiles.keys());
+    zipTask = makeShared<MMCZip::ExportToZipTask>(output, gameRoot, files, "overrides/", true);
+    zipTask->setDeferredFiles(deferred);
 
     auto progressStep = std::make_shared<TaskStepProgress>();
     connect(zipTask.get(), &Task::finished, this, [this, progressStep] {
@@ -212,11 +236,14 @@ void ModrinthPackExportTask::buildZip()
     });
 
     connect(zipTask.get(), &Task::succeeded, this, &ModrinthPackExportTask::emitSucceeded);
-    connect(zipTask.get(), &Task::aborted, this, &ModrinthPackExportTask::emitAborted);
+    connect(zipTask.get(), &Task::aborted, this, [this] {
+        if (isRunning())
+            emitAborted();
+    });
     connect(zipTask.get(), &Task::failed, this, [this, progressStep](QString reason) {
         progressStep->state = TaskStepState::Failed;
         stepProgress(*progressStep);
-        emitFailed(reason);
+        fail(reason);
     });
     connect(zipTask.get(), &Task::stepProgress, this, &ModrinthPackExportTask::propagateStepProgress);
 
@@ -228,10 +255,28 @@ void ModrinthPackExportTask::buildZip()
         progressStep->status = status;
         stepProgress(*progressStep);
     });
-    task.reset(zipTask);
     zipTask->start();
 }
 
+// now that it's known what's downloaded instead, the zip gets the rest and the index
+void ModrinthPackExportTask::finishZip()
+{
+    setStatus(tr("Adding files..."));
+    task = nullptr;
+    zipTask->resolveDeferred(resolvedFiles.keys(), { { "modrinth.index.json", generateIndex() } });
+}
+
+void ModrinthPackExportTask::fail(const QString& reason)
+{
+    if (!isRunning())
+        return;
+    if (task)
+        task->abort();
+    if (zipTask)
+        zipTask->abort();
+    emitFailed(reason);
+}
+
 QByteArray ModrinthPackExportTask::generateIndex()
 {
     QJsonObject out;
@@ -64,12 +64,17 @@ class ModrinthPackExportTask : public Task {
     QMap<QString, QString> pendingHashes;
     QMap<QString, ResolvedFile> resolvedFiles;
     Task::Ptr task;
+    shared_qobject_ptr<MMCZip::ExportToZipTask> zipTask;
+
+    static bool mayBeOnModrinth(const QString& relative);
 
     void collectFiles();
     void collectHashes();
     void makeApiRequest();
     void parseApiResponse(std::shared_ptr<QByteArray> response);
-    void buildZip();
+    void startZip(const QStringList& deferred);
+    void finishZip();
+    void fail(const QString& reason);
 
     QByteArray generateIndex();
 };
@@ -21,6 +21,8 @@
 #include <QDebug>
 #include <QDir>
 #include <QObject>
+#include <QSaveFile>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -29,9 +31,14 @@
 
 #include "minecraft/mod/Mod.h"
 #include "modplatform/ModIndex.h"
+#include "modplatform/packwiz/PackwizIndexCache.h"
 
 #include <toml++/toml.h>
 
+#ifdef Q_OS_WIN32
+#include <windows.h>
+#endif
+
 namespace Packwiz {
 
 auto getRealIndexName(QDir& index_dir, QString normalized_fname, bool should_find_match) -> QString
@@ -91,6 +98,45 @@ auto intEntry(toml::table table, QString entry_name) -> int
     return node.value_or(0);
 }
 
+// The TOML for the mod, or nothing if it misses what its provider needs to find updates
+static auto serialize(V1::Mod mod) -> std::optional<QByteArray>
+{
+    toml::table update;
+    switch (mod.provider) {
+        case (ModPlatform::ResourceProvider::FLAME):
+            if (mod.file_id.toInt() == 0 || mod.project_id.toInt() == 0)
+                return {};
+            update = toml::table{
+                { "file-id", mod.file_id.toInt() },
+                { "project-id", mod.project_id.toInt() },
+            };
+            break;
+        case (ModPlatform::ResourceProvider::MODRINTH):
+            if (mod.mod_id().toString().isEmpty() || mod.version().toString().isEmpty())
+                return {};
+            update = toml::table{
+                { "mod-id", mod.mod_id().toString().toStdString() },
+                { "version", mod.version().toString().toStdString() },
+            };
+            break;
+    }
+
+    auto tbl = toml::table{ { "name", mod.name.toStdString() },
+                            { "filename", mod.filename.toStdString() },
+                            { "side", V1::sideToString(mod.side).toStdString() },
+                            { "download",
+                              toml::table{
+                                  { "mode", mod.mode.toStdString() },
+                                  { "url", mod.url.toString().toStdString() },
+                                  { "hash-format", mod.hash_format.toStdString() },
+                                  { "hash", mod.hash.toStdString() },
+                              } },
+                            { "update", toml::table{ { ProviderCaps.name(mod.provider), update } } } };
+    std::stringstream ss;
+    ss << tbl;
+    return QByteArray::fromStdString(ss.str());
+}
+
 auto V1::createModFormat([[maybe_unused]] QDir& index_dir, ModPlatform::IndexedPack& mod_pack, ModPlatform::IndexedVersion& mod_version)
     -> Mod
 {
@@ -157,28 +203,10 @@ void V1::updateModIndex(QDir& index_dir, Mod& mod)
         FS::ensureFilePathExists(index_file.fileName());
     }
 
-    toml::table update;
-    switch (mod.provider) {
-        case (ModPlatform::ResourceProvider::FLAME):
-            if (mod.file_id.toInt() == 0 || mod.project_id.toInt() == 0) {
-                qCritical() << QString("Did not write file %1 because missing information!").arg(normalized_fname);
-                return;
-            }
-            update = toml::table{
-                { "file-id", mod.file_id.toInt() },
-                { "project-id", mod.project_id.toInt() },
-            };
-            break;
-        case (ModPlatform::ResourceProvider::MODRINTH):
-            if (mod.mod_id().toString().isEmpty() || mod.version().toString().isEmpty()) {
-                qCritical() << QString("Did not write file %1 because missing information!").arg(normalized_fname);
-                return;
-            }
-            update = toml::table{
-                { "mod-id", mod.mod_id().toString().toStdString() },
-                { "version", mod.version().toString().toStdString() },
-            };
-            break;
+    auto contents = serialize(mod);
+    if (!contents) {
+        qCritical() << QString("Did not write file %1 because missing information!").arg(normalized_fname);
+        return;
     }
 
     if (!index_file.open(QIODevice::ReadWrite)) {
@@ -186,25 +214,7 @@ void V1::updateModIndex(QDir& index_dir, Mod& mod)
         return;
     }
 
-    // Put TOML data into the file
-    QTextStream in_stream(&index_file);
-    {
-        auto tbl = toml::table{ { "name", mod.name.toStdString() },
-                                { "filename", mod.filename.toStdString() },
-                                { "side", sideToString(mod.side).toStdString() },
-                                { "download",
-                                  toml::table{
-                                      { "mode", mod.mode.toStdString() },
-                                      { "url", mod.url.toString().toStdString() },
-                                      { "hash-format", mod.hash_format.toStdString() },
-                                      { "hash", mod.hash.toStdString() },
-                                  } },
-                                { "update", toml::table{ { ProviderCaps.name(mod.provider), update } } } };
-        std::stringstream ss;
-        ss << tbl;
-        in_stream << QString::fromStdString(ss.str());
-    }
-
+    index_file.write(*contents);
     index_file.flush();
     index_file.close();
 }
@@ -354,4 +364,93 @@ auto V1::stringToSide(QString side) -> Side
     return Side::UniversalSide;
 }
 
+IndexBatch::IndexBatch(QDir index_dir) : m_index_dir(std::move(index_dir))
+{
+    m_mods = IndexCache(m_index_dir).modsByFile();
+    for (auto it = m_mods.constBegin(); it != m_mods.constEnd(); ++it)
+        m_names.insert(it.key().toCaseFolded(), it.key());
+}
+
+auto IndexBatch::get(const QString& slug) const -> V1::Mod
+{
+    auto mod = m_mods.value(m_names.value(indexFileName(slug).toCaseFolded()));
+    if (!mod.isValid())
+        return {};
+    mod.slug = slug;
+    return mod;
+}
+
+auto IndexBatch::get(const QVariant& mod_id) const -> V1::Mod
+{
+    for (auto const& mod : m_mods) {
+        if (mod.isValid() && mod.project_id == mod_id)
+            return mod;
+    }
+    return {};
+}
+
+void IndexBatch::update(const V1::Mod& mod)
+{
+    if (!mod.isValid()) {
+        qCritical() << QString("Tried to update metadata of an invalid mod!");
+        return;
+    }
+
+    auto normalized_fname = indexFileName(mod.slug);
+    auto folded = normalized_fname.toCaseFolded();
+    auto real_fname = m_names.value(folded);
+
+    if (real_fname == normalized_fname && serialize(m_mods.value(real_fname)) == serialize(mod))
+        return;
+
+    if (!real_fname.isEmpty() && real_fname != normalized_fname) {
+        m_mods.remove(real_fname);
+        m_changed.remove(real_fname);
+        m_replaced.insert(real_fname);
+    }
+
+    auto stored = mod;
+    stored.slug = normalized_fname;
+    m_mods.insert(normalized_fname, stored);
+    m_names.insert(folded, normalized_fname);
+    m_changed.insert(normalized_fname);
+}
+
+int IndexBatch::commit()
+{
+    if (m_changed.isEmpty() && m_replaced.isEmpty())
+        return 0;
+
+    if (!FS::ensureFolderPathExists(m_index_dir.path())) {
+        qCritical() << QString("Unable to create index folder %1!").arg(m_index_dir.path());
+        return 0;
+    }
+#ifdef Q_OS_WIN32
+    SetFileAttributesW(m_index_dir.path().toStdWString().c_str(), FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED);
+#endif
+
+    for (auto const& file_name : m_replaced)
+        QFile::remove(m_index_dir.absoluteFilePath(file_name));
+
+    int written = 0;
+    for (auto const& file_name : m_changed) {
+        auto contents = serialize(m_mods.value(file_name));
+        if (!contents) {
+            qCritical() << QString("Did not write file %1 because missing information!").arg(file_name);
+            continue;
+        }
+
+        QSaveFile index_file(m_index_dir.absoluteFilePath(file_name));
+        if (!index_file.open(QIODevice::WriteOnly) || index_file.write(*contents) != contents->size() || !index_file.commit()) {
+            qCritical() << QString("Could not write file %1!").arg(file_name);
+            continue;
+        }
+        written++;
+    }
+
+    m_changed.clear();
+    m_replaced.clear();
+    return written;
+}
+
 }  // namespace Packwiz
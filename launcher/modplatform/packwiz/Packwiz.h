@@ -20,12 +20,13 @@
 
 #include "modplatform/ModIndex.h"
 
+#include <QDir>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QUrl>
 #include <QVariant>
 
-class QDir;
-
 // Mod from launcher/minecraft/mod/Mod.h
 class Mod;
 
@@ -98,4 +99,36 @@ class V1 {
     static auto stringToSide(QString side) -> Side;
 };
 
+/* Changes to many mods of the same index folder at once.
+ *
+ * Going through V1 for every mod lists the folder each time to match file names case insensitively, and finding a
+ * mod by its id parses every file. This reads the whole index once through its cache, matches names with a case
+ * folded map, applies the changes in memory and only writes the files whose contents change, on commit().
+ * */
+class IndexBatch {
+   public:
+    explicit IndexBatch(QDir index_dir);
+
+    /* Gets the metadata of a mod by its slug, with the changes so far. */
+    auto get(const QString& slug) const -> V1::Mod;
+    /* Gets the metadata of a mod by its project id, with the changes so far. */
+    auto get(const QVariant& mod_id) const -> V1::Mod;
+
+    /* Creates or replaces the metadata of the mod, in memory until commit(). */
+    void update(const V1::Mod& mod);
+
+    /* Writes the files that changed, and returns how many of them were written. */
+    int commit();
+
+   private:
+    QDir m_index_dir;
+    // file name -> what it holds
+    QHash<QString, V1::Mod> m_mods;
+    // case folded file name -> file name
+    QHash<QString, QString> m_names;
+    QSet<QString> m_changed;
+    // files replaced by one with the same name in another case
+    QSet<QString> m_replaced;
+};
+
 }  // namespace Packwiz
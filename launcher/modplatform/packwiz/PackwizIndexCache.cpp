@@ -0,0 +1,127 @@
+#include "PackwizIndexCache.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#ifdef Q_OS_WIN32
+#include <windows.h>
+#endif
+
+namespace Packwiz {
+
+static const quint32 s_magic = 0x50574943;  // "PWIC"
+static const quint32 s_version = 1;
+
+static void writeMod(QDataStream& out, const V1::Mod& mod)
+{
+    out << mod.slug << mod.name << mod.filename << static_cast<qint32>(mod.side);
+    out << mod.mode << mod.url << mod.hash_format << mod.hash;
+    out << static_cast<qint32>(mod.provider) << mod.file_id << mod.project_id;
+}
+
+static void readMod(QDataStream& in, V1::Mod& mod)
+{
+    qint32 side, provider;
+    in >> mod.slug >> mod.name >> mod.filename >> side;
+    in >> mod.mode >> mod.url >> mod.hash_format >> mod.hash;
+    in >> provider >> mod.file_id >> mod.project_id;
+    mod.side = static_cast<V1::Side>(side);
+    mod.provider = static_cast<ModPlatform::ResourceProvider>(provider);
+}
+
+IndexCache::IndexCache(QDir index_dir) : m_index_dir(std::move(index_dir)), m_path(m_index_dir.absolutePath() + ".cache") {}
+
+auto IndexCache::mods() -> QList<V1::Mod>
+{
+    return modsByFile().values();
+}
+
+auto IndexCache::modsByFile() -> QHash<QString, V1::Mod>
+{
+    auto cached = load();
+    QHash<QString, Entry> entries;
+    bool changed = false;
+
+    m_index_dir.refresh();
+    for (auto const& info : m_index_dir.entryInfoList(QDir::Files)) {
+        auto file_name = info.fileName();
+        auto modified = info.lastModified().toMSecsSinceEpoch();
+
+        auto it = cached.constFind(file_name);
+        if (it != cached.constEnd() && it->size == info.size() && it->modified == modified) {
+            entries.insert(file_name, *it);
+            continue;
+        }
+
+        changed = true;
+        entries.insert(file_name, { info.size(), modified, V1::getIndexForMod(m_index_dir, file_name) });
+    }
+
+    if (changed || entries.size() != cached.size())
+        save(entries);
+
+    QHash<QString, V1::Mod> mods;
+    mods.reserve(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        mods.insert(it.key(), it->mod);
+    return mods;
+}
+
+auto IndexCache::load() const -> QHash<QString, Entry>
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QDataStream in(file.readAll());
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic, version, count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != s_magic || version != s_version)
+        return {};
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString file_name;
+        Entry entry;
+        in >> file_name >> entry.size >> entry.modified;
+        readMod(in, entry.mod);
+        entries.insert(file_name, entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring damaged metadata cache" << m_path;
+        return {};
+    }
+    return entries;
+}
+
+void IndexCache::save(const QHash<QString, Entry>& entries) const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    out << s_magic << s_version << static_cast<quint32>(entries.size());
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        out << it.key() << it->size << it->modified;
+        writeMod(out, it->mod);
+    }
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Couldn't write metadata cache" << m_path << ":" << file.errorString();
+        return;
+    }
+
+#ifdef Q_OS_WIN32
+    // keep it out of the mods list, like the index itself
+    SetFileAttributesW(m_path.toStdWString().c_str(), FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED);
+#endif
+}
+
+}  // namespace Packwiz
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "modplatform/packwiz/Packwiz.h"
+
+namespace Packwiz {
+
+/* Binary copy of every metadata file in an index folder, kept next to it.
+ *
+ * Loading an indexed mods folder needs all of its metadata, and parsing hundreds of TOML files on every reload adds up.
+ * This keeps what they held along with their size and modification time, so only the ones that changed since the last
+ * time get parsed again.
+ * */
+class IndexCache {
+   public:
+    explicit IndexCache(QDir index_dir);
+
+    /* Gets the metadata of every file in the index, including the ones that aren't valid.
+     * Updates the cache file if any of them changed.
+     * */
+    auto mods() -> QList<V1::Mod>;
+    /* The same, by the name of their file. */
+    auto modsByFile() -> QHash<QString, V1::Mod>;
+
+    [[nodiscard]] auto path() const -> QString { return m_path; }
+
+   private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        V1::Mod mod;
+    };
+
+    auto load() const -> QHash<QString, Entry>;
+    void save(const QHash<QString, Entry>& entries) const;
+
+   private:
+    QDir m_index_dir;
+    QString m_path;
+};
+
+}  // namespace Packwiz
@@ -15,11 +15,10 @@
 
 #include "SingleZipPackInstallTask.h"
 
-#include <QtConcurrent>
-
 #include "FileSystem.h"
 #include "MMCZip.h"
 #include "TechnicPackProcessor.h"
+#include "tasks/Executor.h"
 
 #include "Application.h"
 
@@ -47,6 +46,7 @@ void Technic::SingleZipPackInstallTask::executeTask()
     auto entry = APPLICATION->metacache()->resolveEntry("general", path);
     entry->setStale(true);
     m_filesNetJob.reset(new NetJob(tr("Modpack download"), APPLICATION->network()));
+    m_filesNetJob->setPriority(Net::Priority::Bulk);
     m_filesNetJob->addNetAction(Net::ApiDownload::makeCached(m_sourceUrl, entry));
     m_archivePath = entry->getFullPath();
     auto job = m_filesNetJob.get();
@@ -65,14 +65,36 @@ void Technic::SingleZipPackInstallTask::downloadSucceeded()
     QDir extractDir(FS::PathCombine(m_stagingPath, ".minecraft"));
     qDebug() << "Attempting to create instance from" << m_archivePath;
 
+    // what the pack is comes out of the central directory, so an unusable one fails before extracting anything
+    m_processed = false;
+    {
+        MMCZip::ZipIndex index(m_archivePath);
+        if (index.isValid()) {
+            auto packProcessor = makeShared<Technic::TechnicPackProcessor>();
+            std::optional<QString> failure;
+            connect(packProcessor.get(), &Technic::TechnicPackProcessor::failed, this, [&failure](QString reason) { failure = reason; });
+            m_processed = packProcessor->runFromArchive(m_globalSettings, name(), m_instIcon, m_stagingPath, index, m_minecraftVersion);
+            if (failure) {
+                emitFailed(*failure);
+                return;
+            }
+        }
+    }
+
     // open the zip and find relevant files in it
     m_packZip.reset(new QuaZip(m_archivePath));
     if (!m_packZip->open(QuaZip::mdUnzip)) {
         emitFailed(tr("Unable to open supplied modpack zip file."));
         return;
     }
-    m_extractFuture =
-        QtConcurrent::run(QThreadPool::globalInstance(), MMCZip::extractSubDir, m_packZip.get(), QString(""), extractDir.absolutePath());
+    auto cancel = cancellationToken();
+    auto extract = [this, target = extractDir.absolutePath(), cancel] {
+        // the download was the first half
+        return MMCZip::extractSubDir(
+            m_packZip.get(), QString(""), target, [this](qint64 done, qint64 total) { setProgress(total / 2 + done / 2, total); }, {},
+            cancel);
+    };
+    m_extractFuture = Executor::instance()->run(Executor::Priority::Bulk, extract, cancel);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SingleZipPackInstallTask::extractFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SingleZipPackInstallTask::extractAborted);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -124,6 +146,10 @@ void Technic::SingleZipPackInstallTask::extractFinished()
         }
     }
 
+    if (m_processed) {
+        emitSucceeded();
+        return;
+    }
     auto packProcessor = makeShared<Technic::TechnicPackProcessor>();
     connect(packProcessor.get(), &Technic::TechnicPackProcessor::succeeded, this, &Technic::SingleZipPackInstallTask::emitSucceeded);
     connect(packProcessor.get(), &Technic::TechnicPackProcessor::failed, this, &Technic::SingleZipPackInstallTask::emitFailed);
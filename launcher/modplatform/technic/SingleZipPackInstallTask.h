@@ -57,6 +57,8 @@ class SingleZipPackInstallTask : public InstanceTask {
     std::unique_ptr<QuaZip> m_packZip;
     QFuture<std::optional<QStringList>> m_extractFuture;
     QFutureWatcher<std::optional<QStringList>> m_extractFutureWatcher;
+    // the instance got set up out of the archive already, there's only the extraction left to wait for
+    bool m_processed = false;
 };
 
 }  // namespace Technic
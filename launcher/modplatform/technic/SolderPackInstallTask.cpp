@@ -38,12 +38,32 @@
 #include <FileSystem.h>
 #include <Json.h>
 #include <MMCZip.h>
-#include <QtConcurrentRun>
 
 #include "SolderPackManifest.h"
 #include "TechnicPackProcessor.h"
 #include "net/ApiDownload.h"
 #include "net/ChecksumValidator.h"
+#include "tasks/Executor.h"
+
+namespace {
+// the paths in the archive, the way MMCZip::extractSubDir hands them to its filter
+std::optional<QSet<QString>> listEntries(const QString& path)
+{
+    QuaZip zip(path);
+    if (!zip.open(QuaZip::mdUnzip)) {
+        qWarning() << "Failed to open" << path;
+        return std::nullopt;
+    }
+    QSet<QString> entries;
+    for (auto name : zip.getFileNameList()) {
+        name = QDir::fromNativeSeparators(name);
+        if (name.startsWith('/'))
+            name = name.mid(1);
+        entries.insert(name);
+    }
+    return entries;
+}
+}  // namespace
 
 Technic::SolderPackInstallTask::SolderPackInstallTask(shared_qobject_ptr<QNetworkAccessManager> network,
                                                       const QUrl& solderUrl,
@@ -107,22 +127,27 @@ void Technic::SolderPackInstallTask::fileListSucceeded()
         m_minecraftVersion = build.minecraft;
 
     m_filesNetJob.reset(new NetJob(tr("Downloading modpack"), m_network));
+    m_filesNetJob->setPriority(Net::Priority::Bulk);
+    FS::ensureFolderPathExists(FS::PathCombine(m_stagingPath, ".minecraft"));
 
     int i = 0;
     for (const auto& mod : build.mods) {
         auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
 
-        auto dl = Net::ApiDownload::makeFile(mod.url, path);
+        auto dl = Net::ApiDownload::makeFile(mod.url, path, Net::Download::Option::Segmented | Net::Download::Option::Resumable);
         if (!mod.md5.isEmpty()) {
             auto rawMd5 = QByteArray::fromHex(mod.md5.toLatin1());
             dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Md5, rawMd5));
         }
+        connect(dl.get(), &Task::succeeded, this, [this, i] { listMod(i); });
         m_filesNetJob->addNetAction(dl);
 
         i++;
     }
 
     m_modCount = build.mods.size();
+    m_entries.resize(m_modCount);
+    m_unowned = m_modCount;
 
     connect(m_filesNetJob.get(), &NetJob::succeeded, this, &Technic::SolderPackInstallTask::downloadSucceeded);
     connect(m_filesNetJob.get(), &NetJob::progress, this, &Technic::SolderPackInstallTask::downloadProgressChanged);
@@ -138,20 +163,77 @@ void Technic::SolderPackInstallTask::downloadSucceeded()
 
     setStatus(tr("Extracting modpack"));
     m_filesNetJob.reset();
-    m_extractFuture = QtConcurrent::run([this]() {
-        int i = 0;
-        QString extractDir = FS::PathCombine(m_stagingPath, ".minecraft");
-        FS::ensureFolderPathExists(extractDir);
-
-        while (m_modCount > i) {
-            auto path = FS::PathCombine(m_outputDir.path(), QString("%1").arg(i));
-            if (!MMCZip::extractDir(path, extractDir)) {
+    m_downloaded = true;
+    if (m_unowned == 0)
+        waitForExtraction();
+}
+
+void Technic::SolderPackInstallTask::listMod(int index)
+{
+    auto path = FS::PathCombine(m_outputDir.path(), QString::number(index));
+    auto watcher = new QFutureWatcher<std::optional<QSet<QString>>>(this);
+    connect(watcher, &QFutureWatcher<std::optional<QSet<QString>>>::finished, this, [this, watcher, index] {
+        watcher->deleteLater();
+        if (!watcher->isCanceled())
+            modListed(index, watcher->result());
+    });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Bulk, [path] { return listEntries(path); }, cancellationToken()));
+}
+
+void Technic::SolderPackInstallTask::modListed(int index, const std::optional<QSet<QString>>& entries)
+{
+    if (!isRunning())
+        return;
+    if (!entries) {
+        emitFailed(tr("Failed to extract modpack"));
+        return;
+    }
+    m_entries[index] = entries;
+
+    // a zip overwrites the ones before it, so each path belongs to the last one that has it and a zip can be extracted
+    // once all the zips after it are known
+    auto cancel = cancellationToken();
+    auto target = FS::PathCombine(m_stagingPath, ".minecraft");
+    while (m_unowned > 0 && m_entries[m_unowned - 1]) {
+        m_unowned--;
+        QSet<QString> owned;
+        for (auto& entry : *m_entries[m_unowned]) {
+            if (!m_owned.contains(entry))
+                owned.insert(entry);
+        }
+        m_owned.unite(owned);
+        m_entries[m_unowned].reset();
+
+        auto path = FS::PathCombine(m_outputDir.path(), QString::number(m_unowned));
+        auto extract = [path, target, owned, cancel] {
+            QuaZip zip(path);
+            if (!zip.open(QuaZip::mdUnzip)) {
+                qWarning() << "Failed to open" << path;
                 return false;
             }
-            i++;
-        }
-        return true;
-    });
+            auto isOverwritten = [&owned](const QString& name) { return !owned.contains(name); };
+            return MMCZip::extractSubDir(&zip, "", target, {}, isOverwritten, cancel).has_value();
+        };
+        m_extractJobs.append(Executor::instance()->run(Executor::Priority::Bulk, extract, cancel));
+    }
+    if (m_downloaded && m_unowned == 0)
+        waitForExtraction();
+}
+
+void Technic::SolderPackInstallTask::waitForExtraction()
+{
+    m_extractFuture = Executor::instance()->run(
+        Executor::Priority::Bulk,
+        [jobs = m_extractJobs] {
+            bool ok = true;
+            for (auto& job : jobs) {
+                Executor::instance()->waitFor(job);
+                ok = ok && !job.isCanceled() && job.result();
+            }
+            return ok;
+        },
+        cancellationToken());
+    m_extractJobs.clear();
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::finished, this, &Technic::SolderPackInstallTask::extractFinished);
     connect(&m_extractFutureWatcher, &QFutureWatcher<QStringList>::canceled, this, &Technic::SolderPackInstallTask::extractAborted);
     m_extractFutureWatcher.setFuture(m_extractFuture);
@@ -178,6 +260,8 @@ void Technic::SolderPackInstallTask::downloadAborted()
 
 void Technic::SolderPackInstallTask::extractFinished()
 {
+    if (!isRunning())
+        return;
     if (!m_extractFuture.result()) {
         emitFailed(tr("Failed to extract modpack"));
         return;
@@ -39,8 +39,10 @@
 #include <net/NetJob.h>
 #include <tasks/Task.h>
 
+#include <QSet>
 #include <QUrl>
 #include <memory>
+#include <optional>
 
 namespace Technic {
 class SolderPackInstallTask : public InstanceTask {
@@ -68,6 +70,12 @@ class SolderPackInstallTask : public InstanceTask {
     void extractFinished();
     void extractAborted();
 
+   private:
+    // a downloaded zip is listed, then extracted once every zip after it in the manifest is listed too
+    void listMod(int index);
+    void modListed(int index, const std::optional<QSet<QString>>& entries);
+    void waitForExtraction();
+
    private:
     bool m_abortable = false;
 
@@ -81,6 +89,14 @@ class SolderPackInstallTask : public InstanceTask {
     std::shared_ptr<QByteArray> m_response = std::make_shared<QByteArray>();
     QTemporaryDir m_outputDir;
     int m_modCount;
+    bool m_downloaded = false;
+
+    // what's in the zips that can't be extracted yet, and the paths that a later zip has already
+    QVector<std::optional<QSet<QString>>> m_entries;
+    QSet<QString> m_owned;
+    // the zips from this one on are being extracted
+    int m_unowned = 0;
+    QList<QFuture<bool>> m_extractJobs;
     QFuture<bool> m_extractFuture;
     QFutureWatcher<bool> m_extractFutureWatcher;
 };
@@ -15,17 +15,24 @@
 
 #include "TechnicPackProcessor.h"
 
+#include <Application.h>
 #include <FileSystem.h>
 #include <Json.h>
+#include <MMCZip.h>
+#include <meta/Index.h>
+#include <meta/Version.h>
+#include <minecraft/Component.h>
 #include <minecraft/MinecraftInstance.h>
 #include <minecraft/PackProfile.h>
-#include <quazip/quazip.h>
-#include <quazip/quazipdir.h>
-#include <quazip/quazipfile.h>
 #include <settings/INISettingsObject.h>
 
 #include <memory>
 
+namespace {
+// modpack.jar is a few megabytes at most, but a pack could put anything in there
+constexpr qint64 s_maxModpackJarSize = 256 * 1024 * 1024;
+}  // namespace
+
 void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
                                         const QString& instName,
                                         const QString& instIcon,
@@ -34,6 +41,64 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
                                         [[maybe_unused]] const bool isSolder)
 {
     QString minecraftPath = FS::PathCombine(stagingPath, ".minecraft");
+    QString modpackJar = FS::PathCombine(minecraftPath, "bin", "modpack.jar");
+    QString versionJson = FS::PathCombine(minecraftPath, "bin", "version.json");
+    if (QFile::exists(modpackJar)) {
+        MMCZip::ZipIndex jar(modpackJar);
+        if (!jar.isValid()) {
+            emit failed(tr("Unable to open \"bin/modpack.jar\" file!"));
+            return;
+        }
+        process(globalSettings, instName, instIcon, stagingPath, minecraftVersion, &jar, modpackJar, std::nullopt, false);
+    } else if (QFile::exists(versionJson)) {
+        QFile file(versionJson);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit failed(tr("Unable to open \"version.json\"!"));
+            return;
+        }
+        process(globalSettings, instName, instIcon, stagingPath, minecraftVersion, nullptr, {}, file.readAll(), false);
+    } else {
+        // This is the "Vanilla" modpack, excluded by the search code
+        emit failed(tr("Unable to find a \"version.json\"!"));
+    }
+}
+
+bool Technic::TechnicPackProcessor::runFromArchive(SettingsObjectPtr globalSettings,
+                                                   const QString& instName,
+                                                   const QString& instIcon,
+                                                   const QString& stagingPath,
+                                                   const MMCZip::ZipIndex& pack,
+                                                   const QString& minecraftVersion)
+{
+    if (pack.contains("bin/modpack.jar")) {
+        MMCZip::ZipIndex jar(pack, "bin/modpack.jar", s_maxModpackJarSize);
+        // a jar mod gets installed from its file, that has to be extracted first
+        if (!jar.isValid() || !jar.contains("version.json"))
+            return false;
+        process(globalSettings, instName, instIcon, stagingPath, minecraftVersion, &jar, {}, std::nullopt, true);
+        return true;
+    }
+    if (pack.contains("bin/version.json")) {
+        auto data = pack.read("bin/version.json");
+        if (!data)
+            return false;
+        process(globalSettings, instName, instIcon, stagingPath, minecraftVersion, nullptr, {}, *data, true);
+        return true;
+    }
+    emit failed(tr("Unable to find a \"version.json\"!"));
+    return true;
+}
+
+void Technic::TechnicPackProcessor::process(SettingsObjectPtr globalSettings,
+                                            const QString& instName,
+                                            const QString& instIcon,
+                                            const QString& stagingPath,
+                                            const QString& minecraftVersion,
+                                            const MMCZip::ZipIndex* modpackJar,
+                                            const QString& modpackJarPath,
+                                            std::optional<QByteArray> versionJson,
+                                            bool prefetch)
+{
     QString configPath = FS::PathCombine(stagingPath, "instance.cfg");
     auto instanceSettings = std::make_shared<INISettingsObject>(configPath);
     MinecraftInstance instance(globalSettings, instanceSettings, stagingPath);
@@ -48,61 +113,46 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
     components->buildingFromScratch();
 
     QByteArray data;
-
-    QString modpackJar = FS::PathCombine(minecraftPath, "bin", "modpack.jar");
-    QString versionJson = FS::PathCombine(minecraftPath, "bin", "version.json");
     QString fmlMinecraftVersion;
-    if (QFile::exists(modpackJar)) {
-        QuaZip zipFile(modpackJar);
-        if (!zipFile.open(QuaZip::mdUnzip)) {
-            emit failed(tr("Unable to open \"bin/modpack.jar\" file!"));
-            return;
-        }
-        QuaZipDir zipFileRoot(&zipFile, "/");
-        if (zipFileRoot.exists("/version.json")) {
-            if (zipFileRoot.exists("/fmlversion.properties")) {
-                zipFile.setCurrentFile("fmlversion.properties");
-                QuaZipFile file(&zipFile);
-                if (!file.open(QIODevice::ReadOnly)) {
+    if (modpackJar) {
+        if (modpackJar->contains("version.json")) {
+            if (modpackJar->contains("fmlversion.properties")) {
+                auto fmlVersionData = modpackJar->read("fmlversion.properties");
+                if (!fmlVersionData) {
                     emit failed(tr("Unable to open \"fmlversion.properties\"!"));
                     return;
                 }
-                QByteArray fmlVersionData = file.readAll();
-                file.close();
                 INIFile iniFile;
-                iniFile.loadFile(fmlVersionData);
+                iniFile.loadFile(*fmlVersionData);
                 // If not present, this evaluates to a null string
                 fmlMinecraftVersion = iniFile["fmlbuild.mcversion"].toString();
             }
-            zipFile.setCurrentFile("version.json", QuaZip::csSensitive);
-            QuaZipFile file(&zipFile);
-            if (!file.open(QIODevice::ReadOnly)) {
+            auto versionData = modpackJar->read("version.json");
+            if (!versionData) {
                 emit failed(tr("Unable to open \"version.json\"!"));
                 return;
             }
-            data = file.readAll();
-            file.close();
+            data = *versionData;
         } else {
-            if (minecraftVersion.isEmpty())
+            if (minecraftVersion.isEmpty()) {
                 emit failed(tr("Could not find \"version.json\" inside \"bin/modpack.jar\", but Minecraft version is unknown"));
+                return;
+            }
             components->setComponentVersion("net.minecraft", minecraftVersion, true);
-            components->installJarMods({ modpackJar });
+            components->installJarMods({ modpackJarPath });
 
             // Forge for 1.4.7 and for 1.5.2 require extra libraries.
             // Figure out the forge version and add it as a component
             // (the code still comes from the jar mod installed above)
-            if (zipFileRoot.exists("/forgeversion.properties")) {
-                zipFile.setCurrentFile("forgeversion.properties", QuaZip::csSensitive);
-                QuaZipFile file(&zipFile);
-                if (!file.open(QIODevice::ReadOnly)) {
+            if (modpackJar->contains("forgeversion.properties")) {
+                auto forgeVersionData = modpackJar->read("forgeversion.properties");
+                if (!forgeVersionData) {
                     // Really shouldn't happen, but error handling shall not be forgotten
                     emit failed(tr("Unable to open \"forgeversion.properties\""));
                     return;
                 }
-                QByteArray forgeVersionData = file.readAll();
-                file.close();
                 INIFile iniFile;
-                iniFile.loadFile(forgeVersionData);
+                iniFile.loadFile(*forgeVersionData);
                 QString major, minor, revision, build;
                 major = iniFile["forge.major.number"].toString();
                 minor = iniFile["forge.minor.number"].toString();
@@ -121,18 +171,8 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
             emit succeeded();
             return;
         }
-    } else if (QFile::exists(versionJson)) {
-        QFile file(versionJson);
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit failed(tr("Unable to open \"version.json\"!"));
-            return;
-        }
-        data = file.readAll();
-        file.close();
     } else {
-        // This is the "Vanilla" modpack, excluded by the search code
-        emit failed(tr("Unable to find a \"version.json\"!"));
-        return;
+        data = versionJson.value_or(QByteArray());
     }
 
     try {
@@ -183,5 +223,14 @@ void Technic::TechnicPackProcessor::run(SettingsObjectPtr globalSettings,
     }
 
     components->saveNow();
+
+    // what the first launch needs resolved comes in while the pack is still being extracted
+    if (prefetch) {
+        for (size_t i = 0; i < static_cast<size_t>(components->rowCount()); i++) {
+            auto component = components->getComponent(i);
+            if (component && !component->getVersion().isEmpty())
+                APPLICATION->metadataIndex()->get(component->getID(), component->getVersion())->load(Net::Mode::Online);
+        }
+    }
     emit succeeded();
 }
@@ -16,8 +16,13 @@
 #pragma once
 
 #include <QString>
+#include <optional>
 #include "settings/SettingsObject.h"
 
+namespace MMCZip {
+class ZipIndex;
+}
+
 namespace Technic {
 // not exporting it, only used in SingleZipPackInstallTask, InstanceImportTask and SolderPackInstallTask
 class TechnicPackProcessor : public QObject {
@@ -34,5 +39,29 @@ class TechnicPackProcessor : public QObject {
              const QString& stagingPath,
              const QString& minecraftVersion = QString(),
              bool isSolder = false);
+
+    /**
+     * The same, out of the pack archive before it's extracted, its root being what ends up in .minecraft.
+     * Only the entries it needs are read, and the metadata of the components starts downloading while the rest is
+     * extracted. Returns false without doing anything when the pack needs to be extracted first, for a jar mod pack.
+     */
+    bool runFromArchive(SettingsObjectPtr globalSettings,
+                        const QString& instName,
+                        const QString& instIcon,
+                        const QString& stagingPath,
+                        const MMCZip::ZipIndex& pack,
+                        const QString& minecraftVersion = QString());
+
+   private:
+    /// set up the instance from what's in modpack.jar, if there's one, or version.json
+    void process(SettingsObjectPtr globalSettings,
+                 const QString& instName,
+                 const QString& instIcon,
+                 const QString& stagingPath,
+                 const QString& minecraftVersion,
+                 const MMCZip::ZipIndex* modpackJar,
+                 const QString& modpackJarPath,
+                 std::optional<QByteArray> versionJson,
+                 bool prefetch);
 };
 }  // namespace Technic
@@ -53,7 +53,7 @@ auto ApiDownload::makeFile(QUrl url, QString path, Options options) -> Download:
     dl->m_url = url;
     dl->setObjectName(QString("FILE:") + url.toString());
     dl->m_options = options;
-    dl->m_sink.reset(new FileSink(path));
+    dl->setFileSink(path);
     return dl;
 }
 
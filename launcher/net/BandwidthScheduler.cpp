@@ -0,0 +1,91 @@
+#include "BandwidthScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Net {
+
+namespace {
+// requests a job may keep running while a class before its own is downloading, by class
+const std::array<int, 4> s_in_flight_behind = { 0, 4, 2, 1 };
+// the bucket holds this long of the limit, reads beyond it have to wait
+const double s_burst_seconds = 0.25;
+// less than this isn't worth waking a reply up for
+const qint64 s_min_read = 16 * 1024;
+}  // namespace
+
+BandwidthScheduler& BandwidthScheduler::shared()
+{
+    static BandwidthScheduler s_shared;
+    return s_shared;
+}
+
+void BandwidthScheduler::setLimit(qint64 bytes_per_second)
+{
+    m_limit = std::max<qint64>(bytes_per_second, 0);
+    m_tokens = m_limit * s_burst_seconds;
+    m_refilled = std::chrono::steady_clock::now();
+}
+
+void BandwidthScheduler::started(Priority priority)
+{
+    m_active[static_cast<int>(priority)]++;
+}
+
+void BandwidthScheduler::stopped(Priority priority)
+{
+    auto& active = m_active[static_cast<int>(priority)];
+    active = std::max(active - 1, 0);
+    if (active == 0 && priority != Priority::Bulk)
+        emit capacityFreed();
+}
+
+bool BandwidthScheduler::higherActive(Priority priority) const
+{
+    for (int i = 0; i < static_cast<int>(priority); i++) {
+        if (m_active[i] > 0)
+            return true;
+    }
+    return false;
+}
+
+bool BandwidthScheduler::mayStart(Priority priority, int in_flight) const
+{
+    return !higherActive(priority) || in_flight < s_in_flight_behind[static_cast<int>(priority)];
+}
+
+void BandwidthScheduler::refill()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - m_refilled;
+    m_refilled = now;
+    m_tokens = std::min(m_tokens + elapsed.count() * m_limit, m_limit * s_burst_seconds);
+}
+
+qint64 BandwidthScheduler::allowance(Priority priority)
+{
+    if (m_limit == 0)
+        return std::numeric_limits<qint64>::max();
+    refill();
+    auto floor = higherActive(priority) ? m_limit * s_burst_seconds / 2 : 0;
+    auto allowed = static_cast<qint64>(m_tokens - floor);
+    return allowed >= std::min(s_min_read, m_limit / 4) ? allowed : 0;
+}
+
+void BandwidthScheduler::consume(qint64 bytes)
+{
+    if (m_limit != 0)
+        m_tokens -= bytes;
+}
+
+std::chrono::milliseconds BandwidthScheduler::retryIn(Priority priority)
+{
+    if (m_limit == 0)
+        return std::chrono::milliseconds(0);
+    refill();
+    auto floor = higherActive(priority) ? m_limit * s_burst_seconds / 2 : 0;
+    auto missing = floor + std::min(s_min_read, m_limit / 4) - m_tokens;
+    return std::chrono::milliseconds(std::max<qint64>(10, static_cast<qint64>(missing * 1000 / m_limit) + 1));
+}
+
+}  // namespace Net
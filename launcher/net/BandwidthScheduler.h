@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+
+#include <array>
+#include <chrono>
+
+namespace Net {
+
+/// what a request is for, the first ones go first when several jobs download at once
+enum class Priority { Interactive, LaunchCritical, Background, Bulk };
+
+/**
+ * Shares the connection between every request of the launcher, whichever job it's part of.
+ *
+ * Jobs used to compete on their own, so an instance downloading its assets left the icons of the mod browser waiting
+ * behind it. While requests of a class are running, jobs of the classes after it only start a few of theirs, and go
+ * back to their whole limit once they're done.
+ *
+ * With a limit on the total bandwidth, replies are read off a token bucket shared by all of them. A class only takes
+ * from the lower half of the bucket when no class before it is downloading, so those get what they need first and the
+ * rest use what's left. Replies that wait stop being read, which slows their connection down rather than buffering.
+ *
+ * Everything here runs on the GUI thread, like the requests.
+ */
+class BandwidthScheduler : public QObject {
+    Q_OBJECT
+   public:
+    static BandwidthScheduler& shared();
+
+    /// at most `bytes_per_second` in total, 0 for no limit
+    void setLimit(qint64 bytes_per_second);
+    qint64 limit() const { return m_limit; }
+
+    /// a request of `priority` got on or off the network
+    void started(Priority priority);
+    void stopped(Priority priority);
+
+    /// whether a job of `priority` with `in_flight` requests running may start another one
+    bool mayStart(Priority priority, int in_flight) const;
+
+    /// how much a reply of `priority` may read right now
+    qint64 allowance(Priority priority);
+    /// `bytes` were read
+    void consume(qint64 bytes);
+    /// when a reply of `priority` that got no allowance should ask again
+    std::chrono::milliseconds retryIn(Priority priority);
+
+   signals:
+    /// a class finished its requests, so the jobs after it may start more
+    void capacityFreed();
+
+   private:
+    bool higherActive(Priority priority) const;
+    void refill();
+
+   private:
+    std::array<int, 4> m_active{};
+    qint64 m_limit = 0;
+    double m_tokens = 0;
+    std::chrono::steady_clock::time_point m_refilled;
+};
+
+}  // namespace Net
@@ -61,6 +61,33 @@ class ByteArraySink : public Sink {
         return Task::State::Failed;
     };
 
+    auto headersReceived(QNetworkReply& reply) -> Task::State override
+    {
+        // the whole response goes in one allocation when the server says how big it is
+        auto size = reply.header(QNetworkRequest::ContentLengthHeader);
+        if (m_output && size.isValid() && size.toLongLong() > m_output->capacity())
+            m_output->reserve(size.toLongLong());
+        return Task::State::Running;
+    }
+
+    auto beginDirectWrite(qint64 size) -> char* override
+    {
+        if (!m_output)
+            return nullptr;
+        m_direct_start = m_output->size();
+        m_output->resize(m_direct_start + size);
+        return m_output->data() + m_direct_start;
+    }
+
+    auto endDirectWrite(qint64 size) -> Task::State override
+    {
+        m_output->resize(m_direct_start + size);
+        auto data = QByteArray::fromRawData(m_output->constData() + m_direct_start, size);
+        if (writeAllValidators(data))
+            return Task::State::Running;
+        return Task::State::Failed;
+    }
+
     auto write(QByteArray& data) -> Task::State override
     {
         if (m_output)
@@ -93,5 +120,7 @@ class ByteArraySink : public Sink {
 
    private:
     std::shared_ptr<QByteArray> m_output;
+    // where the data of the current direct write starts in m_output
+    qsizetype m_direct_start = 0;
 };
 }  // namespace Net
@@ -44,7 +44,7 @@ namespace Net {
 class ChecksumValidator : public Validator {
    public:
     ChecksumValidator(QCryptographicHash::Algorithm algorithm, QByteArray expected = QByteArray())
-        : m_checksum(algorithm), m_expected(expected){};
+        : m_algorithm(algorithm), m_checksum(algorithm), m_expected(expected){};
     virtual ~ChecksumValidator() = default;
 
    public:
@@ -74,8 +74,11 @@ class ChecksumValidator : public Validator {
     auto hash() -> QByteArray { return m_checksum.result(); }
 
     void setExpected(QByteArray expected) { m_expected = expected; }
+    auto expected() const -> QByteArray { return m_expected; }
+    auto algorithm() const -> QCryptographicHash::Algorithm { return m_algorithm; }
 
    private:
+    QCryptographicHash::Algorithm m_algorithm;
     QCryptographicHash m_checksum;
     QByteArray m_expected;
 };
@@ -0,0 +1,155 @@
+#include "ContentStore.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <filesystem>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "StringUtils.h"
+
+#include "modplatform/helpers/HashUtils.h"
+#include "net/ChecksumValidator.h"
+#include "net/Logging.h"
+
+namespace fs = std::filesystem;
+
+namespace Net {
+
+ContentStore::ContentStore(QString root) : m_root(std::move(root))
+{
+    QDir().mkpath(m_root);
+}
+
+ContentStore* ContentStore::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->contentStore().get() : nullptr;
+}
+
+ContentStore::Key ContentStore::keyFor(QCryptographicHash::Algorithm algorithm, const QByteArray& raw_hash)
+{
+    if (raw_hash.isEmpty())
+        return {};
+    switch (algorithm) {
+        case QCryptographicHash::Sha1:
+            return { "sha1", QString::fromLatin1(raw_hash.toHex()) };
+        case QCryptographicHash::Sha512:
+            return { "sha512", QString::fromLatin1(raw_hash.toHex()) };
+        default:
+            // the hash cache can't check anything else
+            return {};
+    }
+}
+
+ContentStore::Key ContentStore::keyFor(const std::vector<std::shared_ptr<Validator>>& validators)
+{
+    Key key;
+    for (auto& validator : validators) {
+        auto checksum = dynamic_cast<ChecksumValidator*>(validator.get());
+        if (!checksum)
+            continue;
+        auto candidate = keyFor(checksum->algorithm(), checksum->expected());
+        if (candidate.isValid() && (!key.isValid() || candidate.type == "sha512"))
+            key = candidate;
+    }
+    return key;
+}
+
+QString ContentStore::pathFor(const Key& key) const
+{
+    auto hash = key.hash.toLower();
+    return FS::PathCombine(m_root, key.type, hash.left(2), hash);
+}
+
+bool ContentStore::materialize(const Key& key, const QString& path)
+{
+    if (!key.isValid() || isContentAddressed(key, path))
+        return false;
+    auto stored = pathFor(key);
+    if (!QFileInfo::exists(stored))
+        return false;
+
+    if (Hashing::cachedHash(stored, key.type).compare(key.hash, Qt::CaseInsensitive) != 0) {
+        qCWarning(taskNetLogC) << "Dropping" << stored << "from the content store, it doesn't match its hash anymore";
+        QFile::remove(stored);
+        return false;
+    }
+
+    if (!place(stored, path, QFileInfo(path).absolutePath()))
+        return false;
+    qCDebug(taskNetLogC) << "Took" << path << "from the content store";
+    return true;
+}
+
+void ContentStore::add(const Key& key, const QString& path)
+{
+    if (!key.isValid() || isContentAddressed(key, path))
+        return;
+    auto stored = pathFor(key);
+    if (QFileInfo::exists(stored))
+        return;
+    if (!place(path, stored, QFileInfo(path).absolutePath()))
+        qCWarning(taskNetLogC) << "Could not add" << path << "to the content store";
+}
+
+bool ContentStore::isContentAddressed(const Key& key, const QString& path)
+{
+    // asset objects are named after their hash, they're already shared
+    return QFileInfo(path).fileName().compare(key.hash, Qt::CaseInsensitive) == 0;
+}
+
+ContentStore::Method ContentStore::methodFor(const QString& dir)
+{
+    auto it = m_methods.constFind(dir);
+    if (it != m_methods.constEnd())
+        return *it;
+
+    auto store = FS::statFS(m_root);
+    auto other = FS::statFS(dir);
+    auto method = Method::Copy;
+    if (store.rootPath == other.rootPath && store.fsType == other.fsType)
+        method = FS::canCloneOnFS(store) ? Method::Clone : Method::Link;
+    m_methods.insert(dir, method);
+    return method;
+}
+
+bool ContentStore::place(const QString& from, const QString& to, const QString& dir)
+{
+    if (!FS::ensureFilePathExists(to))
+        return false;
+    // links and clones can't replace a file, so make it next to it and move it in place
+    auto tmp = to + ".store";
+    QFile::remove(tmp);
+
+    auto method = methodFor(dir);
+    std::error_code ec;
+    bool placed = false;
+    if (method == Method::Clone) {
+        placed = FS::clone_file(from, tmp, ec);
+        if (!placed) {
+            QFile::remove(tmp);
+            method = Method::Link;
+        }
+    }
+    if (!placed && method == Method::Link) {
+        fs::create_hard_link(StringUtils::toStdString(from), StringUtils::toStdString(tmp), ec);
+        placed = !ec;
+        if (!placed)
+            method = Method::Copy;
+    }
+    if (!placed)
+        placed = QFile::copy(from, tmp);
+    // don't try what just failed again for this folder
+    m_methods.insert(dir, method);
+
+    if (!placed || !FS::move(tmp, to)) {
+        QFile::remove(tmp);
+        return false;
+    }
+    return true;
+}
+}  // namespace Net
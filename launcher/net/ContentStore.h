@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+#include "Validator.h"
+
+namespace Net {
+/**
+ * Downloaded files, stored once under the digest of their contents and shared by every instance.
+ *
+ * Downloads that know the SHA1 or SHA512 of the file look here before asking the network, and every file that passed
+ * its checksum gets added. Files are placed by a clone where the filesystem can do copy-on-write, by a hard link where
+ * they are on the same device, or copied otherwise. A stored file is checked against its digest (through the hash
+ * cache, so that's usually free) before it's handed out, in case a hard linked copy got edited in place.
+ */
+class ContentStore {
+   public:
+    /// what a file is stored under, an empty hash for those that can't be stored
+    struct Key {
+        QString type;
+        // hex digest
+        QString hash;
+
+        [[nodiscard]] bool isValid() const { return !hash.isEmpty(); }
+    };
+
+    explicit ContentStore(QString root);
+
+    /// the store of the running launcher, null when there's none like in tests
+    static auto shared() -> ContentStore*;
+
+    /// the key of a download with these validators, taken from a checksum with an expected value
+    static auto keyFor(const std::vector<std::shared_ptr<Validator>>& validators) -> Key;
+    static auto keyFor(QCryptographicHash::Algorithm algorithm, const QByteArray& raw_hash) -> Key;
+
+    /// put the stored copy of `key` at `path`, false if there's none
+    auto materialize(const Key& key, const QString& path) -> bool;
+    /// remember the file at `path`, which has to match `key`
+    void add(const Key& key, const QString& path);
+
+    [[nodiscard]] auto pathFor(const Key& key) const -> QString;
+
+   private:
+    enum class Method { Clone, Link, Copy };
+
+    // clone, link or copy `from` to `to`, replacing whatever is there, `dir` being the side outside of the store
+    auto place(const QString& from, const QString& to, const QString& dir) -> bool;
+    auto methodFor(const QString& dir) -> Method;
+    static auto isContentAddressed(const Key& key, const QString& path) -> bool;
+
+   private:
+    QString m_root;
+    // what works between the store and each folder outside of it, checking the filesystem is slow
+    QHash<QString, Method> m_methods;
+};
+}  // namespace Net
@@ -46,6 +46,12 @@
 #include "ByteArraySink.h"
 #include "ChecksumValidator.h"
 #include "MetaCacheSink.h"
+#include "SegmentedFileSink.h"
+
+#if defined(LAUNCHER_APPLICATION)
+#include "Application.h"
+#include "net/DownloadJournal.h"
+#endif
 
 #include "net/NetAction.h"
 
@@ -81,10 +87,55 @@ auto Download::makeFile(QUrl url, QString path, Options options) -> Download::Pt
     dl->m_url = url;
     dl->setObjectName(QString("FILE:") + url.toString());
     dl->m_options = options;
-    dl->m_sink.reset(new FileSink(path));
+    dl->setFileSink(path);
     return dl;
 }
 
+void Download::setFileSink(QString path)
+{
+    bool resumable = m_options.testFlag(Option::Resumable);
+    // what an earlier attempt left is continued as a single stream, the segments are gone by now
+    bool resuming = false;
+#if defined(LAUNCHER_APPLICATION)
+    auto journal = DownloadJournal::shared();
+    resuming = resumable && journal && journal->has(m_url.toString());
+#endif
+    if (!m_options.testFlag(Option::Segmented) || resuming) {
+        auto sink = new FileSink(path, resumable);
+        if (resumable)
+            sink->journalAs(m_url.toString());
+        m_sink.reset(sink);
+        return;
+    }
+
+    qint64 threshold = 32;
+    int segments = 4;
+#if defined(LAUNCHER_APPLICATION)
+    threshold = APPLICATION->settings()->get("SegmentedDownloadThreshold").toLongLong();
+    segments = APPLICATION->settings()->get("SegmentedDownloadSegments").toInt();
+#endif
+    auto sink = new SegmentedFileSink(path, this, threshold * 1024 * 1024, segments);
+    if (resumable)
+        sink->journalAs(m_url.toString());
+    m_sink.reset(sink);
+}
+
+auto Download::canSpawn() const -> bool
+{
+    return isSignalConnected(QMetaMethod::fromSignal(&NetAction::spawned));
+}
+
+void Download::spawn(std::unique_ptr<Sink> sink)
+{
+    auto dl = makeShared<Download>();
+    dl->m_url = m_url;
+    dl->setObjectName(objectName());
+    dl->m_options = m_options;
+    dl->m_headerProxies = m_headerProxies;
+    dl->m_sink = std::move(sink);
+    emit spawned(dl);
+}
+
 QNetworkReply* Download::getReply(QNetworkRequest& request)
 {
     return m_network->get(request);
@@ -57,7 +57,15 @@ class Download : public NetRequest {
     static auto makeByteArray(QUrl url, std::shared_ptr<QByteArray> output, Options options = Option::NoOptions) -> Download::Ptr;
     static auto makeFile(QUrl url, QString path, Options options = Option::NoOptions) -> Download::Ptr;
 
+    // whether something would run the requests this one spawns
+    auto canSpawn() const -> bool;
+    // run another request for the same URL with the given sink next to this one
+    void spawn(std::unique_ptr<Sink> sink);
+
    protected:
     virtual QNetworkReply* getReply(QNetworkRequest&) override;
+    auto canRetry() const -> bool override { return true; }
+    // the sink for a download into `path`, as m_options ask for
+    void setFileSink(QString path);
 };
 }  // namespace Net
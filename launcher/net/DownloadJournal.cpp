@@ -0,0 +1,243 @@
+#include "DownloadJournal.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "Application.h"
+#include "FileSystem.h"
+
+#include "net/Logging.h"
+
+namespace Net {
+
+namespace {
+enum class JournalOp : quint8 { Put = 1, Remove = 2 };
+
+// the journal can outlive the Qt version that wrote it
+const int journalStreamVersion = QDataStream::Qt_5_12;
+
+// journal records accumulated beyond the live entries before the journal gets compacted
+const qint64 compactionSlack = 256;
+
+// part files nobody came back for in that long are thrown away
+const qint64 maxAge = qint64(14) * 24 * 60 * 60 * 1000;
+
+QString metaPath(const QString& part_path)
+{
+    return part_path + ".meta";
+}
+
+void removePartFiles(const QString& part_path)
+{
+    QFile::remove(part_path);
+    QFile::remove(metaPath(part_path));
+}
+
+// move the part file and what's known about it, replacing whatever is at `to`
+bool movePartFiles(const QString& from, const QString& to)
+{
+    removePartFiles(to);
+    if (!FS::move(from, to))
+        return false;
+    if (QFile::exists(metaPath(from)) && !FS::move(metaPath(from), metaPath(to))) {
+        // it can't be resumed without it
+        QFile::remove(to);
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+DownloadJournal::DownloadJournal(QString root) : m_root(std::move(root)), m_journal(FS::PathCombine(m_root, "journal"))
+{
+    QDir().mkpath(m_root);
+    load();
+}
+
+DownloadJournal::~DownloadJournal()
+{
+    QMutexLocker locker(&m_lock);
+    m_journal.flush();
+}
+
+DownloadJournal* DownloadJournal::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->downloadJournal() : nullptr;
+}
+
+void DownloadJournal::load()
+{
+    QMutexLocker locker(&m_lock);
+    m_journal.load([this](const QByteArray& record) {
+        QDataStream stream(record);
+        stream.setVersion(journalStreamVersion);
+        quint8 op;
+        QString url;
+        stream >> op >> url;
+        if (stream.status() != QDataStream::Ok)
+            return;
+        if (op == static_cast<quint8>(JournalOp::Remove)) {
+            m_entries.remove(url);
+            return;
+        }
+        if (op != static_cast<quint8>(JournalOp::Put))
+            return;
+        Entry entry;
+        stream >> entry.part_path >> entry.size >> entry.touched;
+        if (stream.status() == QDataStream::Ok)
+            m_entries.insert(url, entry);
+    });
+
+    // what went away since, or was left for too long
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    bool dropped = false;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!QFile::exists(it->part_path) || now - it->touched > maxAge) {
+            removePartFiles(it->part_path);
+            it = m_entries.erase(it);
+            dropped = true;
+        } else {
+            ++it;
+        }
+    }
+    if (!m_entries.isEmpty())
+        qCDebug(taskNetLogC) << m_entries.size() << "interrupted downloads can be resumed";
+
+    if (!dropped && m_journal.recordCount() <= 2 * m_entries.size() + compactionSlack)
+        return;
+    QList<QByteArray> records;
+    records.reserve(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        QByteArray record;
+        QDataStream stream(&record, QIODevice::WriteOnly);
+        stream.setVersion(journalStreamVersion);
+        stream << static_cast<quint8>(JournalOp::Put) << it.key() << it->part_path << it->size << it->touched;
+        records.append(record);
+    }
+    if (!m_journal.compact(records))
+        qCWarning(taskNetLogC) << "Could not compact the download journal" << m_journal.path();
+}
+
+void DownloadJournal::put(const QString& url, const Entry& entry)
+{
+    m_entries.insert(url, entry);
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(journalStreamVersion);
+    stream << static_cast<quint8>(JournalOp::Put) << url << entry.part_path << entry.size << entry.touched;
+    m_journal.append(record);
+    // it's worth nothing if it's not there after a crash
+    m_journal.flush();
+}
+
+void DownloadJournal::remove(const QString& url)
+{
+    if (!m_entries.remove(url))
+        return;
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(journalStreamVersion);
+    stream << static_cast<quint8>(JournalOp::Remove) << url;
+    m_journal.append(record);
+    m_journal.flush();
+}
+
+QString DownloadJournal::parkedPath(const QString& url) const
+{
+    auto hash = QCryptographicHash::hash(url.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return FS::PathCombine(m_root, QString::fromLatin1(hash) + ".part");
+}
+
+void DownloadJournal::started(const QString& url, const QString& part_path, qint64 size)
+{
+    QMutexLocker locker(&m_lock);
+    m_active.insert(url);
+    put(url, { QFileInfo(part_path).absoluteFilePath(), size, QDateTime::currentMSecsSinceEpoch() });
+}
+
+void DownloadJournal::progressed(const QString& url, qint64 size)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_entries.constFind(url);
+    if (it == m_entries.constEnd() || it->size == size)
+        return;
+    put(url, { it->part_path, size, QDateTime::currentMSecsSinceEpoch() });
+}
+
+void DownloadJournal::released(const QString& url)
+{
+    QMutexLocker locker(&m_lock);
+    m_active.remove(url);
+}
+
+void DownloadJournal::finished(const QString& url)
+{
+    QMutexLocker locker(&m_lock);
+    m_active.remove(url);
+    auto it = m_entries.constFind(url);
+    if (it == m_entries.constEnd())
+        return;
+    removePartFiles(it->part_path);
+    remove(url);
+}
+
+bool DownloadJournal::has(const QString& url)
+{
+    QMutexLocker locker(&m_lock);
+    return m_entries.contains(url) && !m_active.contains(url);
+}
+
+bool DownloadJournal::adopt(const QString& url, const QString& part_path)
+{
+    QMutexLocker locker(&m_lock);
+    auto it = m_entries.constFind(url);
+    if (it == m_entries.constEnd() || m_active.contains(url))
+        return false;
+    auto entry = *it;
+    auto to = QFileInfo(part_path).absoluteFilePath();
+    if (entry.part_path != to && !movePartFiles(entry.part_path, to)) {
+        qCWarning(taskNetLogC) << "Could not move" << entry.part_path << "to" << to << ", downloading" << url << "from the start";
+        removePartFiles(entry.part_path);
+        remove(url);
+        return false;
+    }
+    // past that the file has room for the rest, but nothing in it
+    if (entry.size >= 0 && QFileInfo(to).size() > entry.size && !QFile::resize(to, entry.size)) {
+        removePartFiles(to);
+        remove(url);
+        return false;
+    }
+    qCDebug(taskNetLogC) << "Continuing" << url << "from" << entry.part_path;
+    put(url, { to, entry.size, QDateTime::currentMSecsSinceEpoch() });
+    return true;
+}
+
+void DownloadJournal::rescue(const QString& dir)
+{
+    QMutexLocker locker(&m_lock);
+    auto prefix = QDir(dir).absolutePath() + '/';
+    QList<QString> urls;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (it->part_path.startsWith(prefix))
+            urls.append(it.key());
+    }
+    for (auto& url : urls) {
+        auto entry = m_entries.value(url);
+        auto to = parkedPath(url);
+        // one that's still open keeps writing into it where it's moved to, where that can be done
+        if (!movePartFiles(entry.part_path, to)) {
+            // it goes away with the folder
+            remove(url);
+            continue;
+        }
+        entry.part_path = to;
+        put(url, entry);
+    }
+}
+}  // namespace Net
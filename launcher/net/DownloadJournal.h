@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include "net/MetaCacheJournal.h"
+
+namespace Net {
+/**
+ * Where the unfinished part of every resumable download is, so it can pick up where it stopped after a restart.
+ *
+ * Downloads are known by their URL. A part file is recorded when a download starts writing it and forgotten once the
+ * download is done with it, along with how much of it is good for parts that aren't written front to back. Whatever
+ * was in the response besides the data, like the ETag that If-Range needs, is already next to the part file.
+ *
+ * A part file that's in a folder about to go away, like the staging folder of a failed install, gets parked in the
+ * journal's own folder first. The next download of the same URL moves it back to where it wants it, even if that's a
+ * different place than last time.
+ *
+ * Thread safe.
+ */
+class DownloadJournal {
+   public:
+    explicit DownloadJournal(QString root);
+    ~DownloadJournal();
+
+    /// the journal of the running launcher, null when there's none like in tests
+    static auto shared() -> DownloadJournal*;
+
+    /// `url` writes into `part_path`, of which the first `size` bytes are good, or all of it when negative
+    void started(const QString& url, const QString& part_path, qint64 size = -1);
+    /// the first `size` bytes of the part file of `url` are written
+    void progressed(const QString& url, qint64 size);
+    /// nothing writes into the part file anymore, a later download of `url` can continue it
+    void released(const QString& url);
+    /// `url` doesn't need its part file anymore, it's removed if it's still there
+    void finished(const QString& url);
+
+    /// whether there's a part file of `url` to continue
+    auto has(const QString& url) -> bool;
+    /// move what there is of `url` to `part_path`, false if there's nothing
+    auto adopt(const QString& url, const QString& part_path) -> bool;
+    /// park the part files in `dir` before it's deleted
+    void rescue(const QString& dir);
+
+   private:
+    struct Entry {
+        QString part_path;
+        qint64 size = -1;
+        // when it was last written, ms since epoch
+        qint64 touched = 0;
+    };
+
+    void load();
+    void put(const QString& url, const Entry& entry);
+    void remove(const QString& url);
+    auto parkedPath(const QString& url) const -> QString;
+
+   private:
+    QString m_root;
+    QMutex m_lock;
+    MetaCacheJournal m_journal;
+    QHash<QString, Entry> m_entries;
+    // downloads of this run writing into their part file
+    QSet<QString> m_active;
+};
+}  // namespace Net
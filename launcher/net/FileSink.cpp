@@ -35,12 +35,52 @@
 
 #include "FileSink.h"
 
+#include <QFile>
+#include <QSaveFile>
+
 #include "FileSystem.h"
 
 #include "net/Logging.h"
+#include "net/NetUtils.h"
+
+#if defined(LAUNCHER_APPLICATION)
+#include "net/ContentStore.h"
+#include "net/DownloadJournal.h"
+#endif
 
 namespace Net {
 
+namespace {
+// what's already in a part file gets read back this much at a time
+const qint64 replayChunkSize = 1024 * 1024;
+
+QString metaPath(const QString& part_path)
+{
+    return part_path + ".meta";
+}
+
+// the If-Range value that identifies the version of the file in the part file
+QByteArray readResumeToken(const QString& part_path)
+{
+    QFile meta(metaPath(part_path));
+    if (!meta.open(QIODevice::ReadOnly))
+        return {};
+    return meta.readAll().trimmed();
+}
+
+void writeResumeToken(const QString& part_path, QNetworkReply& reply)
+{
+    auto token = resumeToken(reply);
+    if (token.isEmpty()) {
+        QFile::remove(metaPath(part_path));
+        return;
+    }
+    QSaveFile meta(metaPath(part_path));
+    if (!meta.open(QIODevice::WriteOnly) || meta.write(token) != token.size() || !meta.commit())
+        qCWarning(taskNetLogC) << "Could not write" << meta.fileName() << ", the download can't be resumed";
+}
+}  // namespace
+
 Task::State FileSink::init(QNetworkRequest& request)
 {
     auto result = initCache(request);
@@ -48,6 +88,12 @@ Task::State FileSink::init(QNetworkRequest& request)
         return result;
     }
 
+#if defined(LAUNCHER_APPLICATION)
+    auto store = ContentStore::shared();
+    if (m_use_content_store && store && store->materialize(ContentStore::keyFor(validators), m_filename))
+        return Task::State::Succeeded;
+#endif
+
     // create a new save file and open it for writing
     if (!FS::ensureFilePathExists(m_filename)) {
         qCCritical(taskNetLogC) << "Could not create folder for " + m_filename;
@@ -55,10 +101,14 @@ Task::State FileSink::init(QNetworkRequest& request)
     }
 
     wroteAnyData = false;
-    m_output_file.reset(new QSaveFile(m_filename));
-    if (!m_output_file->open(QIODevice::WriteOnly)) {
-        qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
-        return Task::State::Failed;
+    m_discard = false;
+    m_resume_from = 0;
+    if (!m_resumable || !openPart(request)) {
+        m_output_file.reset(new QSaveFile(m_filename));
+        if (!m_output_file->open(QIODevice::WriteOnly)) {
+            qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
+            return Task::State::Failed;
+        }
     }
 
     if (initAllValidators(request))
@@ -66,11 +116,119 @@ Task::State FileSink::init(QNetworkRequest& request)
     return Task::State::Failed;
 }
 
+bool FileSink::openPart(QNetworkRequest& request)
+{
+    m_part_path.clear();
+    auto part_path = m_filename + ".part";
+    if (!m_part_lock)
+        m_part_lock = std::make_unique<QLockFile>(part_path + ".lock");
+    // another download of the same file owns the part file, stay out of its way
+    if (!m_part_lock->isLocked() && !m_part_lock->tryLock(0))
+        return false;
+
+#if defined(LAUNCHER_APPLICATION)
+    auto journal = m_journal_url.isEmpty() ? nullptr : DownloadJournal::shared();
+    // an earlier run may have left it somewhere else, like the staging folder of an install that failed
+    if (journal && !QFile::exists(part_path))
+        journal->adopt(m_journal_url, part_path);
+#endif
+
+    auto file = std::make_unique<QFile>(part_path);
+    auto token = readResumeToken(part_path);
+    auto size = file->size();
+    bool resume = !token.isEmpty() && size > 0;
+    if (!file->open(resume ? QIODevice::ReadWrite : QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(taskNetLogC) << "Could not open" << part_path << "for writing:" << file->errorString();
+        m_part_lock->unlock();
+        return false;
+    }
+
+    if (resume) {
+        m_resume_from = size;
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(size) + "-");
+        request.setRawHeader("If-Range", token);
+        // ranges of a compressed response wouldn't line up with what we have
+        request.setRawHeader("Accept-Encoding", "identity");
+    } else {
+        QFile::remove(metaPath(part_path));
+    }
+#if defined(LAUNCHER_APPLICATION)
+    if (journal)
+        journal->started(m_journal_url, part_path);
+#endif
+
+    m_part_path = part_path;
+    m_output_file = std::move(file);
+    return true;
+}
+
+Task::State FileSink::headersReceived(QNetworkReply& reply)
+{
+    bool is_http = false;
+    auto status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(&is_http);
+    // only keep the body if it is the file, redirects and error pages have one too
+    m_discard = is_http && (status < 200 || status >= 300);
+
+    if (m_part_path.isEmpty())
+        return Task::State::Running;
+
+    if (m_resume_from > 0 && is_http && status == 206) {
+        qint64 first, last, total;
+        if (!parseContentRange(reply.rawHeader("Content-Range"), first, last, total) || first != m_resume_from) {
+            qCWarning(taskNetLogC) << "Server sent the wrong range of" << m_filename << ", starting over next time";
+            removePart();
+            return Task::State::Failed;
+        }
+        if (!replayPart()) {
+            qCWarning(taskNetLogC) << "Could not read back" << m_part_path << ", starting over next time";
+            removePart();
+            return Task::State::Failed;
+        }
+        qCDebug(taskNetLogC) << "Resuming" << m_filename << "after" << m_resume_from << "bytes";
+        wroteAnyData = true;
+    } else if (!m_discard && m_resume_from > 0) {
+        // the file changed or the server doesn't do ranges, what we have is useless
+        if (!m_output_file->seek(0) || !m_output_file->resize(0)) {
+            qCCritical(taskNetLogC) << "Could not truncate" << m_part_path;
+            return Task::State::Failed;
+        }
+        m_resume_from = 0;
+    }
+
+    if (!m_discard) {
+        writeResumeToken(m_part_path, reply);
+    } else if (status == 416) {
+        // what we have doesn't fit the file anymore
+        QFile::remove(metaPath(m_part_path));
+    }
+    return Task::State::Running;
+}
+
+bool FileSink::replayPart()
+{
+    if (!m_output_file->seek(0))
+        return false;
+    qint64 done = 0;
+    while (done < m_resume_from) {
+        auto chunk = m_output_file->read(qMin(replayChunkSize, m_resume_from - done));
+        if (chunk.isEmpty() || !writeAllValidators(chunk))
+            return false;
+        done += chunk.size();
+    }
+    return m_output_file->seek(m_resume_from);
+}
+
 Task::State FileSink::write(QByteArray& data)
 {
+    if (m_discard)
+        return Task::State::Running;
+
     if (!writeAllValidators(data) || m_output_file->write(data) != data.size()) {
         qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
-        m_output_file->cancelWriting();
+        if (m_part_path.isEmpty())
+            static_cast<QSaveFile*>(m_output_file.get())->cancelWriting();
+        else
+            removePart();
         m_output_file.reset();
         wroteAnyData = false;
         return Task::State::Failed;
@@ -82,7 +240,19 @@ Task::State FileSink::write(QByteArray& data)
 
 Task::State FileSink::abort()
 {
-    m_output_file->cancelWriting();
+    if (m_output_file) {
+        if (m_part_path.isEmpty()) {
+            static_cast<QSaveFile*>(m_output_file.get())->cancelWriting();
+        } else {
+            m_output_file->close();
+            // keep the part file around for the next attempt, unless it can't resume it
+            bool keep = !readResumeToken(m_part_path).isEmpty();
+            if (!keep)
+                QFile::remove(m_part_path);
+            m_part_lock->unlock();
+            journalPart(keep);
+        }
+    }
     failAllValidators();
     return Task::State::Failed;
 }
@@ -95,7 +265,7 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     int statusCode = statusCodeV.toInt(&validStatus);
     if (validStatus) {
         // this leaves out 304 Not Modified
-        gotFile = statusCode == 200 || statusCode == 203;
+        gotFile = statusCode == 200 || statusCode == 203 || (statusCode == 206 && m_resume_from > 0);
     }
 
     // if we wrote any data to the save file, we try to commit the data to the real file.
@@ -103,15 +273,25 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     if (gotFile || wroteAnyData) {
         // ask validators for data consistency
         // we only do this for actual downloads, not 'your data is still the same' cache hits
-        if (!finalizeAllValidators(reply))
+        if (!finalizeAllValidators(reply)) {
+            // whatever is in the part file, it's not what we want
+            if (!m_part_path.isEmpty())
+                removePart();
             return Task::State::Failed;
+        }
 
         // nothing went wrong...
-        if (!m_output_file->commit()) {
+        if (!commitPart()) {
             qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename;
-            m_output_file->cancelWriting();
             return Task::State::Failed;
         }
+#if defined(LAUNCHER_APPLICATION)
+        auto store = ContentStore::shared();
+        if (m_use_content_store && store)
+            store->add(ContentStore::keyFor(validators), m_filename);
+#endif
+    } else if (!m_part_path.isEmpty()) {
+        removePart();
     }
 
     // then get rid of the save file
@@ -120,6 +300,49 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     return finalizeCache(reply);
 }
 
+bool FileSink::commitPart()
+{
+    if (m_part_path.isEmpty()) {
+        auto file = static_cast<QSaveFile*>(m_output_file.get());
+        if (file->commit())
+            return true;
+        file->cancelWriting();
+        return false;
+    }
+
+    m_output_file->close();
+    bool moved = FS::move(m_part_path, m_filename);
+    if (!moved)
+        QFile::remove(m_part_path);
+    QFile::remove(metaPath(m_part_path));
+    m_part_lock->unlock();
+    journalPart(false);
+    return moved;
+}
+
+void FileSink::removePart()
+{
+    if (m_output_file)
+        m_output_file->close();
+    QFile::remove(m_part_path);
+    QFile::remove(metaPath(m_part_path));
+    m_part_lock->unlock();
+    journalPart(false);
+}
+
+void FileSink::journalPart([[maybe_unused]] bool keep)
+{
+#if defined(LAUNCHER_APPLICATION)
+    auto journal = m_journal_url.isEmpty() ? nullptr : DownloadJournal::shared();
+    if (!journal)
+        return;
+    if (keep)
+        journal->released(m_journal_url);
+    else
+        journal->finished(m_journal_url);
+#endif
+}
+
 Task::State FileSink::initCache(QNetworkRequest&)
 {
     return Task::State::Running;
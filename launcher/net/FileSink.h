@@ -35,31 +35,68 @@
 
 #pragma once
 
-#include <QSaveFile>
+#include <QFileDevice>
+#include <QLockFile>
 
 #include "Sink.h"
 
 namespace Net {
+/**
+ * Writes the response into a file, which only gets replaced once the whole download went through.
+ *
+ * A resumable sink writes into `<file>.part` and keeps it when the download fails halfway, along with the ETag or
+ * Last-Modified date the server sent for it in `<file>.part.meta`. The next attempt then only asks for the rest with a
+ * Range request, and If-Range makes the server send the whole file instead if it changed in the meantime. Once it's
+ * journaled under its URL the part file is found again after a restart, wherever the last attempt left it.
+ */
 class FileSink : public Sink {
    public:
-    FileSink(QString filename) : m_filename(filename){};
+    FileSink(QString filename, bool resumable = false) : m_filename(filename), m_resumable(resumable){};
     virtual ~FileSink() = default;
 
    public:
     auto init(QNetworkRequest& request) -> Task::State override;
+    auto headersReceived(QNetworkReply& reply) -> Task::State override;
     auto write(QByteArray& data) -> Task::State override;
     auto abort() -> Task::State override;
     auto finalize(QNetworkReply& reply) -> Task::State override;
 
     auto hasLocalData() -> bool override;
+    auto target() const -> QString override { return m_filename; }
+
+    /// record the part file in the download journal under `url`, only does something for resumable sinks
+    void journalAs(const QString& url) { m_journal_url = url; }
 
    protected:
     virtual auto initCache(QNetworkRequest&) -> Task::State;
     virtual auto finalizeCache(QNetworkReply& reply) -> Task::State;
 
+   private:
+    auto openPart(QNetworkRequest& request) -> bool;
+    auto commitPart() -> bool;
+    void removePart();
+    // tell the journal whether the part file is worth continuing
+    void journalPart(bool keep);
+    // feed what's already in the part file to the validators, as if it just got downloaded
+    auto replayPart() -> bool;
+
    protected:
     QString m_filename;
     bool wroteAnyData = false;
-    std::unique_ptr<QSaveFile> m_output_file;
+    // a QSaveFile, or the part file of resumable sinks
+    std::unique_ptr<QFileDevice> m_output_file;
+    // look the file up in the content store and add it there once downloaded, if its checksum is known
+    bool m_use_content_store = true;
+
+   private:
+    bool m_resumable;
+    // empty unless we own <file>.part
+    QString m_part_path;
+    std::unique_ptr<QLockFile> m_part_lock;
+    QString m_journal_url;
+    // where the part file we asked the server to continue ends
+    qint64 m_resume_from = 0;
+    // the response isn't the file, like a redirect or an error page
+    bool m_discard = false;
 };
 }  // namespace Net
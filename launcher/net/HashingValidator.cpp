@@ -0,0 +1,59 @@
+#include "HashingValidator.h"
+
+#include <MurmurHash2.h>
+
+namespace Net {
+
+namespace {
+// the most whitespace free bytes kept for the murmur2, beyond that it's left to whoever needs it
+constexpr qint64 s_maxStripped = 256 * 1024 * 1024;
+}  // namespace
+
+bool HashingValidator::init(QNetworkRequest&)
+{
+    m_sha1.reset();
+    m_sha512.reset();
+    m_stripped.clear();
+    m_tooBig = false;
+    m_hashes.clear();
+    return true;
+}
+
+bool HashingValidator::write(QByteArray& data)
+{
+    m_sha1.addData(data);
+    m_sha512.addData(data);
+    if (m_tooBig)
+        return true;
+    if (m_stripped.size() + data.size() > s_maxStripped) {
+        m_tooBig = true;
+        m_stripped = QByteArray();
+        return true;
+    }
+    auto offset = m_stripped.size();
+    m_stripped.resize(offset + data.size());
+    auto kept = MurmurHash2_StripWhitespace(data.constData(), static_cast<std::size_t>(data.size()), m_stripped.data() + offset);
+    m_stripped.resize(offset + static_cast<int>(kept));
+    return true;
+}
+
+bool HashingValidator::abort()
+{
+    m_stripped = QByteArray();
+    return true;
+}
+
+bool HashingValidator::validate(QNetworkReply&)
+{
+    m_hashes.insert("sha1", QString::fromLatin1(m_sha1.result().toHex()));
+    m_hashes.insert("sha512", QString::fromLatin1(m_sha512.result().toHex()));
+    if (!m_tooBig) {
+        MurmurHash2_Incremental murmur(static_cast<uint32_t>(m_stripped.size()));
+        murmur.feed(m_stripped.constData(), static_cast<std::size_t>(m_stripped.size()));
+        m_hashes.insert("murmur2", QString::number(murmur.finish()));
+    }
+    m_stripped = QByteArray();
+    return true;
+}
+
+}  // namespace Net
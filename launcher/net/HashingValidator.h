@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Validator.h"
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QMap>
+#include <QString>
+
+namespace Net {
+/**
+ * Computes every digest the mod providers identify a file by, from the bytes as they're downloaded.
+ *
+ * A mod that was just downloaded used to be read back from the disk as soon as anything asked for its hashes, the
+ * update checks and the metadata do that right away. Fed with the download, the SHA1, SHA512 and CurseForge murmur2
+ * are known once it's done and can go into the hash cache with the file. It checks nothing, pair it with a
+ * ChecksumValidator for that.
+ *
+ * The murmur2 needs the length of the file without its whitespace before it starts, so the stripped bytes are kept
+ * until the end, files too big for that are left without one.
+ */
+class HashingValidator : public Validator {
+   public:
+    HashingValidator() = default;
+    ~HashingValidator() override = default;
+
+    bool init(QNetworkRequest&) override;
+    bool write(QByteArray& data) override;
+    bool abort() override;
+    bool validate(QNetworkReply&) override;
+
+    /// hash type ("sha1", "sha512" or "murmur2") to its value, in the form the hash cache keeps, empty until validated
+    [[nodiscard]] QMap<QString, QString> hashes() const { return m_hashes; }
+
+   private:
+    QCryptographicHash m_sha1{ QCryptographicHash::Sha1 };
+    QCryptographicHash m_sha512{ QCryptographicHash::Sha512 };
+    QByteArray m_stripped;
+    bool m_tooBig = false;
+    QMap<QString, QString> m_hashes;
+};
+}  // namespace Net
@@ -36,8 +36,10 @@
 #include "HttpMetaCache.h"
 #include "FileSystem.h"
 #include "Json.h"
+#include "PerfCounters.h"
 
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
@@ -46,13 +48,41 @@
 
 #include "net/Logging.h"
 
+namespace {
+enum class JournalOp : quint8 { Put = 1, Remove = 2 };
+
+// the journal can outlive the Qt version that wrote it
+const int journalStreamVersion = QDataStream::Qt_5_12;
+
+// journal records accumulated beyond the live entries before the journal gets compacted
+const qint64 compactionSlack = 1000;
+
+// md5 of the file, read in chunks so big files never end up in memory whole. Empty if it can't be read
+QString fileMD5(const QString& path)
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly))
+        return {};
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    QByteArray buffer(1024 * 1024, Qt::Uninitialized);
+    qint64 read;
+    while ((read = input.read(buffer.data(), buffer.size())) > 0)
+        hash.addData(QByteArray::fromRawData(buffer.constData(), static_cast<int>(read)));
+    if (read < 0)
+        return {};
+    return hash.result().toHex();
+}
+}  // namespace
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
     return FS::PathCombine(m_basePath, m_relativePath);
 }
 
-HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
+HttpMetaCache::HttpMetaCache(QString path)
+    : QObject(), m_index_file(path), m_journal(path.isNull() ? QString() : path + ".journal")
 {
     saveBatchingTimer.setSingleShot(true);
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
@@ -66,61 +96,93 @@ HttpMetaCache::~HttpMetaCache()
     SaveNow();
 }
 
+auto HttpMetaCache::getShard(const QString& base) const -> EntryMapPtr
+{
+    QReadLocker locker(&m_bases_lock);
+    return m_entries.value(base);
+}
+
+auto HttpMetaCache::allShards() const -> QList<EntryMapPtr>
+{
+    QReadLocker locker(&m_bases_lock);
+    return m_entries.values();
+}
+
 auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
+    auto shard = getShard(base);
     // no base. no base path. can't store
-    if (!m_entries.contains(base)) {
+    if (!shard) {
         // TODO: log problem
         return {};
     }
 
-    EntryMap& map = m_entries[base];
-    if (map.entry_list.contains(resource_path)) {
-        return map.entry_list[resource_path];
-    }
+    QReadLocker locker(&shard->lock);
+    return shard->entry_list.value(resource_path);
+}
 
-    return {};
+void HttpMetaCache::disownEntry(EntryMap& shard, const MetaEntryPtr& entry)
+{
+    {
+        QWriteLocker locker(&shard.lock);
+        auto iter = shard.entry_list.find(entry->m_relativePath);
+        if (iter == shard.entry_list.end() || iter.value() != entry)
+            return;
+        shard.entry_list.erase(iter);
+    }
+    journalRemove(entry->m_baseId, entry->m_relativePath);
 }
 
 auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
 {
+    auto shard = getShard(base);
     auto entry = getEntry(base, resource_path);
     // it's not present? generate a default stale entry
-    if (!entry) {
+    if (!shard || !entry) {
         return staleEntry(base, resource_path);
     }
 
-    auto& selected_base = m_entries[base];
-    QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
+    // no lock held from here on, checking the file can take a while
+    QString real_path = FS::PathCombine(shard->base_path, resource_path);
     QFileInfo finfo(real_path);
 
     // is the file really there? if not -> stale
     if (!finfo.isFile() || !finfo.isReadable()) {
         // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        disownEntry(*shard, entry);
         return staleEntry(base, resource_path);
     }
 
     if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
         // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+        disownEntry(*shard, entry);
         return staleEntry(base, resource_path);
     }
 
     // if the file changed, check md5sum
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
     if (file_last_changed != entry->m_local_changed_timestamp) {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
-        if (entry->m_md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
+        // a different size can't have the same contents, no need to read anything
+        if (entry->m_file_size != -1 && entry->m_file_size != finfo.size()) {
+            disownEntry(*shard, entry);
+            return staleEntry(base, resource_path);
+        }
+
+        QString md5sum = fileMD5(real_path);
+        if (md5sum.isEmpty() || entry->m_md5sum != md5sum) {
+            disownEntry(*shard, entry);
             return staleEntry(base, resource_path);
         }
 
         // md5sums matched... keep entry and save the new state to file
-        entry->m_local_changed_timestamp = file_last_changed;
-        SaveEventually();
+        QByteArray record;
+        {
+            QWriteLocker locker(&shard->lock);
+            entry->m_local_changed_timestamp = file_last_changed;
+            entry->m_file_size = finfo.size();
+            record = putRecord(entry);
+        }
+        journalAppend(record);
     }
 
     // Get rid of old entries, to prevent cache problems
@@ -128,18 +190,20 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
     if (entry->isExpired(current_time - (file_last_changed / 1000))) {
         qCWarning(taskNetLogC) << "[HttpMetaCache]"
                                << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
+        disownEntry(*shard, entry);
         return staleEntry(base, resource_path);
     }
 
     // entry passed all the checks we cared about.
-    entry->m_basePath = getBasePath(base);
+    static auto& hits = PerfCounters::counter("metacache.hits");
+    hits++;
     return entry;
 }
 
 auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
 {
-    if (!m_entries.contains(stale_entry->m_baseId)) {
+    auto shard = getShard(stale_entry->m_baseId);
+    if (!shard) {
         qCCritical(taskHttpMetaCacheLogC) << "Cannot add entry with unknown base: " << stale_entry->m_baseId.toLocal8Bit();
         return false;
     }
@@ -149,8 +213,14 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
         return false;
     }
 
-    m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
-    SaveEventually();
+    stale_entry->m_basePath = shard->base_path;
+    stale_entry->m_file_size = QFileInfo(stale_entry->getFullPath()).size();
+    auto record = putRecord(stale_entry);
+    {
+        QWriteLocker locker(&shard->lock);
+        shard->entry_list[stale_entry->m_relativePath] = stale_entry;
+    }
+    journalAppend(record);
 
     return true;
 }
@@ -161,16 +231,30 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->m_stale = true;
-    SaveEventually();
+    // only forget about it on disk if it's what the cache has, a newer entry may have replaced it already
+    auto shard = getShard(entry->m_baseId);
+    if (!shard)
+        return true;
+    bool current;
+    {
+        QReadLocker locker(&shard->lock);
+        current = shard->entry_list.value(entry->m_relativePath) == entry;
+    }
+    if (current)
+        journalRemove(entry->m_baseId, entry->m_relativePath);
     return true;
 }
 
 void HttpMetaCache::evictAll()
 {
-    for (QString& base : m_entries.keys()) {
-        EntryMap& map = m_entries[base];
-        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
-        for (MetaEntryPtr entry : map.entry_list) {
+    for (const auto& shard : allShards()) {
+        QList<MetaEntryPtr> entries;
+        {
+            QReadLocker locker(&shard->lock);
+            entries = shard->entry_list.values();
+        }
+        qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << shard->base_path;
+        for (MetaEntryPtr entry : entries) {
             if (!evictEntry(entry))
                 qCWarning(taskHttpMetaCacheLogC) << "Unexpected missing cache entry" << entry->m_basePath;
         }
@@ -179,6 +263,8 @@ void HttpMetaCache::evictAll()
 
 auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntryPtr
 {
+    static auto& misses = PerfCounters::counter("metacache.misses");
+    misses++;
     auto foo = new MetaEntry();
     foo->m_baseId = base;
     foo->m_basePath = getBasePath(base);
@@ -190,30 +276,121 @@ auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntry
 
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
+    QWriteLocker locker(&m_bases_lock);
     // TODO: report error
     if (m_entries.contains(base))
         return;
 
     // TODO: check if the base path is valid
-    EntryMap foo;
-    foo.base_path = base_root;
-    m_entries[base] = foo;
+    auto foo = std::make_shared<EntryMap>();
+    foo->base_path = base_root;
+    m_entries.insert(base, foo);
 }
 
 auto HttpMetaCache::getBasePath(QString base) -> QString
 {
-    if (m_entries.contains(base)) {
-        return m_entries[base].base_path;
+    if (auto shard = getShard(base)) {
+        return shard->base_path;
     }
 
     return {};
 }
 
+auto HttpMetaCache::putRecord(const MetaEntryPtr& entry) -> QByteArray
+{
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(journalStreamVersion);
+    stream << static_cast<quint8>(JournalOp::Put) << entry->m_baseId << entry->m_relativePath << entry->m_md5sum << entry->m_etag
+           << entry->m_local_changed_timestamp << entry->m_remote_changed_timestamp << entry->m_is_eternal << entry->m_current_age
+           << entry->m_max_age << entry->m_file_size;
+    return record;
+}
+
+void HttpMetaCache::journalAppend(const QByteArray& record)
+{
+    // nowhere to save to
+    if (m_index_file.isNull())
+        return;
+    {
+        QMutexLocker locker(&m_journal_lock);
+        m_journal.append(record);
+    }
+    SaveEventually();
+}
+
+void HttpMetaCache::journalRemove(const QString& base, const QString& resource_path)
+{
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream.setVersion(journalStreamVersion);
+    stream << static_cast<quint8>(JournalOp::Remove) << base << resource_path;
+    journalAppend(record);
+}
+
+void HttpMetaCache::applyRecord(const QByteArray& record)
+{
+    QDataStream stream(record);
+    stream.setVersion(journalStreamVersion);
+
+    quint8 op;
+    QString base;
+    QString path;
+    stream >> op >> base >> path;
+    if (stream.status() != QDataStream::Ok)
+        return;
+    auto shard = getShard(base);
+    if (!shard)
+        return;
+
+    if (op == static_cast<quint8>(JournalOp::Remove)) {
+        QWriteLocker locker(&shard->lock);
+        shard->entry_list.remove(path);
+        return;
+    }
+    if (op != static_cast<quint8>(JournalOp::Put))
+        return;
+
+    auto foo = new MetaEntry();
+    foo->m_baseId = base;
+    foo->m_basePath = shard->base_path;
+    foo->m_relativePath = path;
+    stream >> foo->m_md5sum >> foo->m_etag >> foo->m_local_changed_timestamp >> foo->m_remote_changed_timestamp >> foo->m_is_eternal >>
+        foo->m_current_age >> foo->m_max_age;
+    // fields added later, missing from older records
+    if (!stream.atEnd())
+        stream >> foo->m_file_size;
+    if (stream.status() != QDataStream::Ok) {
+        delete foo;
+        return;
+    }
+
+    // presumed innocent until closer examination
+    foo->m_stale = false;
+
+    QWriteLocker locker(&shard->lock);
+    shard->entry_list[path] = MetaEntryPtr(foo);
+}
+
 void HttpMetaCache::Load()
 {
     if (m_index_file.isNull())
         return;
 
+    {
+        QMutexLocker locker(&m_journal_lock);
+        if (m_journal.load([this](const QByteArray& record) { applyRecord(record); }))
+            return;
+
+        // no journal yet, start one from what older versions left behind
+        m_needs_compaction = true;
+    }
+    LoadLegacyIndex();
+    SaveEventually();
+}
+
+void HttpMetaCache::LoadLegacyIndex()
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
         return;
@@ -247,13 +424,13 @@ void HttpMetaCache::Load()
     for (auto element : array) {
         auto element_obj = Json::ensureObject(element);
         auto base = Json::ensureString(element_obj, "base");
-        if (!m_entries.contains(base))
+        auto shard = getShard(base);
+        if (!shard)
             continue;
 
-        auto& entrymap = m_entries[base];
-
         auto foo = new MetaEntry();
         foo->m_baseId = base;
+        foo->m_basePath = shard->base_path;
         foo->m_relativePath = Json::ensureString(element_obj, "path");
         foo->m_md5sum = Json::ensureString(element_obj, "md5sum");
         foo->m_etag = Json::ensureString(element_obj, "etag");
@@ -269,15 +446,22 @@ void HttpMetaCache::Load()
         // presumed innocent until closer examination
         foo->m_stale = false;
 
-        entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+        QWriteLocker locker(&shard->lock);
+        shard->entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
     }
 }
 
 void HttpMetaCache::SaveEventually()
 {
-    // reset the save timer
-    saveBatchingTimer.stop();
-    saveBatchingTimer.start(30000);
+    // the timer lives on our thread, whoever changed the cache doesn't necessarily
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // reset the save timer
+            saveBatchingTimer.stop();
+            saveBatchingTimer.start(30000);
+        },
+        Qt::AutoConnection);
 }
 
 void HttpMetaCache::SaveNow()
@@ -285,41 +469,41 @@ void HttpMetaCache::SaveNow()
     if (m_index_file.isNull())
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
+    QMutexLocker journalLocker(&m_journal_lock);
+
+    auto shards = allShards();
+    qint64 entries = 0;
+    for (const auto& shard : shards) {
+        QReadLocker locker(&shard->lock);
+        entries += shard->entry_list.size();
+    }
 
-    QJsonObject toplevel;
-    Json::writeString(toplevel, "version", "1");
+    if (!m_needs_compaction && m_journal.recordCount() <= 2 * entries + compactionSlack) {
+        // the usual case, just the changes since the last save
+        m_journal.flush();
+        return;
+    }
 
-    QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
+    qCDebug(taskHttpMetaCacheLogC) << "Compacting metacache journal with" << m_journal.recordCount() << "records into" << entries
+                                   << "entries";
+
+    // anything changed while we're at it waits for the journal lock, and ends up after the compacted records
+    QList<QByteArray> records;
+    for (const auto& shard : shards) {
+        QReadLocker locker(&shard->lock);
+        for (const auto& entry : shard->entry_list) {
             // do not save stale entries. they are dead.
-            if (entry->m_stale) {
+            if (entry->m_stale)
                 continue;
-            }
-
-            QJsonObject entryObj;
-            Json::writeString(entryObj, "base", entry->m_baseId);
-            Json::writeString(entryObj, "path", entry->m_relativePath);
-            Json::writeString(entryObj, "md5sum", entry->m_md5sum);
-            Json::writeString(entryObj, "etag", entry->m_etag);
-            entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->m_local_changed_timestamp)));
-            if (!entry->m_remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp", QJsonValue(entry->m_remote_changed_timestamp));
-            if (entry->isEternal()) {
-                entryObj.insert("eternal", true);
-            } else {
-                entryObj.insert("current_age", QJsonValue(double(entry->m_current_age)));
-                entryObj.insert("max_age", QJsonValue(double(entry->m_max_age)));
-            }
-            entriesArr.append(entryObj);
+
+            records.append(putRecord(entry));
         }
     }
-    toplevel.insert("entries", entriesArr);
+    if (!m_journal.compact(records))
+        return;
+    m_needs_compaction = false;
 
-    try {
-        Json::write(toplevel, m_index_file);
-    } catch (const Exception& e) {
-        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
-    }
+    // everything is in the journal now
+    if (QFile::exists(m_index_file) && !QFile::remove(m_index_file))
+        qCWarning(taskHttpMetaCacheLogC) << "Couldn't remove the old metacache index" << m_index_file;
 }
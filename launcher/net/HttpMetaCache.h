@@ -35,11 +35,15 @@
 
 #pragma once
 
-#include <QMap>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
 #include <QString>
 #include <QTimer>
 #include <memory>
 
+#include "net/MetaCacheJournal.h"
+
 class HttpMetaCache;
 
 class MetaEntry {
@@ -84,6 +88,8 @@ class MetaEntry {
     QString m_etag;
 
     qint64 m_local_changed_timestamp = 0;
+    // size of the file when the entry was last updated, -1 if unknown
+    qint64 m_file_size = -1;
     QString m_remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 m_current_age = 0;
     qint64 m_max_age = 0;
@@ -94,6 +100,13 @@ class MetaEntry {
 
 using MetaEntryPtr = std::shared_ptr<MetaEntry>;
 
+/**
+ * Cache of the metadata of downloaded files, persisted in a journal.
+ *
+ * Every base is its own shard with its own lock, so lookups on different bases never contend and lookups on the same
+ * one only contend with writers. All the methods are safe to call from any thread; the entries they return aren't,
+ * so a MetaEntry being filled in by one download shouldn't be touched by another thread.
+ */
 class HttpMetaCache : public QObject {
     Q_OBJECT
    public:
@@ -117,7 +130,7 @@ class HttpMetaCache : public QObject {
 
     void addBase(QString base, QString base_root);
 
-    // (re)start a timer that calls SaveNow later.
+    // (re)start a timer that calls SaveNow later, safe to call from any thread
     void SaveEventually();
     void Load();
 
@@ -127,15 +140,40 @@ class HttpMetaCache : public QObject {
     void SaveNow();
 
    private:
-    // create a new stale entry, given the parameters
-    auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
-
     struct EntryMap {
+        // never changes once the base is added
         QString base_path;
-        QMap<QString, MetaEntryPtr> entry_list;
+        QHash<QString, MetaEntryPtr> entry_list;
+        // guards entry_list
+        QReadWriteLock lock;
     };
+    using EntryMapPtr = std::shared_ptr<EntryMap>;
+
+    // create a new stale entry, given the parameters
+    auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
+
+    auto getShard(const QString& base) const -> EntryMapPtr;
+    auto allShards() const -> QList<EntryMapPtr>;
+    // remove the entry from its shard, unless something replaced it in the meantime
+    void disownEntry(EntryMap& shard, const MetaEntryPtr& entry);
+
+    // record changes in the journal, never while holding a shard lock
+    static auto putRecord(const MetaEntryPtr& entry) -> QByteArray;
+    void journalAppend(const QByteArray& record);
+    void journalRemove(const QString& base, const QString& resource_path);
+    void applyRecord(const QByteArray& record);
+    // the JSON index older versions used, only read to migrate to the journal
+    void LoadLegacyIndex();
+
+    // bases are only added at startup, but lookups may already be going on by then
+    QHash<QString, EntryMapPtr> m_entries;
+    mutable QReadWriteLock m_bases_lock;
 
-    QMap<QString, EntryMap> m_entries;
     QString m_index_file;
+    // guards the journal and m_needs_compaction, taken before any shard lock
+    QMutex m_journal_lock;
+    MetaCacheJournal m_journal;
+    // rewrite the journal from scratch on the next save
+    bool m_needs_compaction = false;
     QTimer saveBatchingTimer;
 };
@@ -0,0 +1,138 @@
+#include "MetaCacheJournal.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include "net/Logging.h"
+
+namespace {
+const char magic[4] = { 'P', 'L', 'M', 'J' };
+const quint32 version = 1;
+const int headerSize = sizeof(magic) + sizeof(version);
+// size and checksum
+const int frameHeaderSize = 2 * sizeof(quint32);
+
+// FNV-1a, only there to spot torn and garbled records
+quint32 checksum(const char* data, qint64 size)
+{
+    quint32 hash = 2166136261u;
+    for (qint64 i = 0; i < size; i++) {
+        hash ^= static_cast<quint8>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+QByteArray header()
+{
+    QByteArray out(magic, sizeof(magic));
+    char versionBytes[sizeof(version)];
+    qToLittleEndian(version, versionBytes);
+    out.append(versionBytes, sizeof(versionBytes));
+    return out;
+}
+}  // namespace
+
+MetaCacheJournal::MetaCacheJournal(QString path) : m_path(std::move(path)) {}
+
+void MetaCacheJournal::frame(QByteArray& out, const QByteArray& record)
+{
+    char frameHeader[frameHeaderSize];
+    qToLittleEndian(static_cast<quint32>(record.size()), frameHeader);
+    qToLittleEndian(checksum(record.constData(), record.size()), frameHeader + sizeof(quint32));
+    out.append(frameHeader, frameHeaderSize);
+    out.append(record);
+}
+
+bool MetaCacheJournal::load(const std::function<void(const QByteArray& record)>& apply)
+{
+    m_records = 0;
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    auto size = file.size();
+    QByteArray contents;
+    auto* data = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr;
+    if (!data) {
+        contents = file.readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+
+    if (size < headerSize || QByteArray::fromRawData(data, headerSize) != header()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Ignoring metacache journal with an unknown format:" << m_path;
+        return false;
+    }
+
+    qint64 offset = headerSize;
+    while (offset + frameHeaderSize <= size) {
+        auto recordSize = qFromLittleEndian<quint32>(data + offset);
+        auto recordChecksum = qFromLittleEndian<quint32>(data + offset + sizeof(quint32));
+        auto recordStart = offset + frameHeaderSize;
+        if (recordStart + recordSize > size || checksum(data + recordStart, recordSize) != recordChecksum)
+            break;
+
+        apply(QByteArray::fromRawData(data + recordStart, recordSize));
+        m_records++;
+        offset = recordStart + recordSize;
+    }
+
+    if (offset != size) {
+        qCWarning(taskHttpMetaCacheLogC) << "Dropping" << size - offset << "bytes of damaged records at the end of" << m_path;
+        // closing unmaps it too
+        file.close();
+        // so new records don't end up behind the garbage
+        if (!QFile::resize(m_path, offset))
+            return false;
+    }
+    return true;
+}
+
+void MetaCacheJournal::append(const QByteArray& record)
+{
+    frame(m_pending, record);
+    m_pendingRecords++;
+}
+
+bool MetaCacheJournal::flush()
+{
+    if (!m_pendingRecords)
+        return true;
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Couldn't open metacache journal" << m_path << ":" << file.errorString();
+        return false;
+    }
+    bool fresh = file.size() == 0;
+    if ((fresh && file.write(header()) != headerSize) || file.write(m_pending) != m_pending.size()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Couldn't write metacache journal" << m_path << ":" << file.errorString();
+        return false;
+    }
+
+    m_records += m_pendingRecords;
+    m_pendingRecords = 0;
+    m_pending.clear();
+    return true;
+}
+
+bool MetaCacheJournal::compact(const QList<QByteArray>& records)
+{
+    QByteArray out = header();
+    for (const auto& record : records)
+        frame(out, record);
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        qCWarning(taskHttpMetaCacheLogC) << "Couldn't compact metacache journal" << m_path << ":" << file.errorString();
+        return false;
+    }
+
+    m_records = records.size();
+    m_pendingRecords = 0;
+    m_pending.clear();
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+/**
+ * Append-only journal of opaque records, the on-disk form of the HttpMetaCache.
+ *
+ * Every change is one record appended at the end, so saving costs as much as the changes since the last save. Replaying
+ * the journal gives back the state, and compact() rewrites it with just the records of that state once it piles up
+ * too much garbage.
+ *
+ * Records are framed with their size and a checksum. A torn record at the end, from a crash during a write, is
+ * dropped on load.
+ */
+class MetaCacheJournal {
+   public:
+    explicit MetaCacheJournal(QString path);
+
+    /// replay every record in order, returns false if there's no usable journal
+    bool load(const std::function<void(const QByteArray& record)>& apply);
+
+    /// queue a record for the next flush
+    void append(const QByteArray& record);
+    /// write the queued records out
+    bool flush();
+    /// replace the whole journal with `records`, dropping the queued ones
+    bool compact(const QList<QByteArray>& records);
+
+    /// records in the journal, including the queued ones
+    [[nodiscard]] qint64 recordCount() const { return m_records + m_pendingRecords; }
+    [[nodiscard]] bool hasPending() const { return m_pendingRecords > 0; }
+    [[nodiscard]] QString path() const { return m_path; }
+
+   private:
+    static void frame(QByteArray& out, const QByteArray& record);
+
+   private:
+    QString m_path;
+    QByteArray m_pending;
+    qint64 m_pendingRecords = 0;
+    qint64 m_records = 0;
+};
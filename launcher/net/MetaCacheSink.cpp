@@ -49,8 +49,10 @@ namespace Net {
 #define MAX_TIME_TO_EXPIRE 1 * 7 * 24 * 60 * 60
 
 MetaCacheSink::MetaCacheSink(MetaEntryPtr entry, ChecksumValidator* md5sum, bool is_eternal)
-    : Net::FileSink(entry->getFullPath()), m_entry(entry), m_md5Node(md5sum), m_is_eternal(is_eternal)
+    : Net::FileSink(entry->getFullPath(), true), m_entry(entry), m_md5Node(md5sum), m_is_eternal(is_eternal)
 {
+    // libraries and assets already live in one place shared by all instances
+    m_use_content_store = false;
     addValidator(md5sum);
 }
 
@@ -0,0 +1,55 @@
+#include "Mirrors.h"
+
+#include <QCoreApplication>
+#include <QStringList>
+
+#if defined(LAUNCHER_APPLICATION)
+#include "Application.h"
+#endif
+
+namespace Net {
+
+namespace {
+// each of these has the same files under the same paths
+const QList<QStringList> s_known_mirrors = {
+    { "https://piston-data.mojang.com/", "https://launcher.mojang.com/" },
+    { "https://maven.minecraftforge.net/", "https://files.minecraftforge.net/maven/" },
+    { "https://repo1.maven.org/maven2/", "https://repo.maven.apache.org/maven2/" },
+};
+
+QList<QStringList> mirrorGroups()
+{
+    auto groups = s_known_mirrors;
+#if defined(LAUNCHER_APPLICATION)
+    if (auto app = qobject_cast<Application*>(QCoreApplication::instance()); app && app->settings()) {
+        for (auto const& line : app->settings()->get("DownloadMirrors").toString().split('\n')) {
+            auto group = line.split(' ', Qt::SkipEmptyParts);
+            if (group.size() > 1)
+                groups.prepend(group);
+        }
+    }
+#endif
+    return groups;
+}
+}  // namespace
+
+QList<QUrl> withMirrors(const QUrl& url)
+{
+    QList<QUrl> urls{ url };
+    auto str = url.toString();
+    for (auto const& group : mirrorGroups()) {
+        for (auto const& base : group) {
+            if (!str.startsWith(base))
+                continue;
+            auto path = str.mid(base.size());
+            for (auto const& other : group) {
+                if (other != base)
+                    urls.append(QUrl(other + path));
+            }
+            return urls;
+        }
+    }
+    return urls;
+}
+
+}  // namespace Net
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QList>
+#include <QUrl>
+
+namespace Net {
+
+/**
+ * Other bases that serve the same files as some of the places we download from.
+ *
+ * A request that fails against one of them tries the next one on its retries rather than the same one again. Besides
+ * the few known ones, the "DownloadMirrors" setting can hold more, one group of bases serving the same paths per line.
+ */
+/// `url` on the mirrors of its base, `url` itself first, or just `url` when its base has none
+QList<QUrl> withMirrors(const QUrl& url);
+
+}  // namespace Net
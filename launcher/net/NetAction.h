@@ -42,6 +42,7 @@
 #include "QObjectPtr.h"
 #include "tasks/Task.h"
 
+#include "BandwidthScheduler.h"
 #include "HeaderProxy.h"
 
 class NetAction : public Task {
@@ -58,9 +59,16 @@ class NetAction : public Task {
 
     void setNetwork(shared_qobject_ptr<QNetworkAccessManager> network) { m_network = network; }
 
+    Net::Priority priority() const { return m_priority; }
+    void setPriority(Net::Priority priority) { m_priority = priority; }
+
     void addHeaderProxy(Net::HeaderProxy* proxy) { m_headerProxies.push_back(std::shared_ptr<Net::HeaderProxy>(proxy)); }
     virtual void init() = 0;
 
+   signals:
+    // another request this one needs, for whatever runs it to run as well
+    void spawned(NetAction::Ptr action);
+
    protected slots:
     virtual void downloadProgress(qint64 bytesReceived, qint64 bytesTotal) = 0;
     virtual void downloadError(QNetworkReply::NetworkError error) = 0;
@@ -97,4 +105,6 @@ class NetAction : public Task {
     /// source URL
     QUrl m_url;
     std::vector<std::shared_ptr<Net::HeaderProxy>> m_headerProxies;
+
+    Net::Priority m_priority = Net::Priority::Background;
 };
@@ -36,38 +36,85 @@
  */
 
 #include "NetJob.h"
+#include "net/NetUtils.h"
 #if defined(LAUNCHER_APPLICATION)
 #include "Application.h"
 #endif
 
+// how many times the per host limit the whole job may have in flight, HTTP/2 hosts can take all of it on their one connection
+static const int hostsInFlight = 4;
+
 NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network) : ConcurrentTask(nullptr, job_name), m_network(network)
 {
 #if defined(LAUNCHER_APPLICATION)
-    setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt());
+    m_per_host_max = APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt();
 #endif
+    setMaxConcurrent(m_per_host_max * hostsInFlight);
+    // the per host limit still holds, this only moves the one of the whole job
+    setAdaptiveConcurrency(2, 2 * m_per_host_max * hostsInFlight);
+    // the requests of another job were holding this one back
+    connect(&Net::BandwidthScheduler::shared(), &Net::BandwidthScheduler::capacityFreed, this, [this] {
+        if (isRunning())
+            QMetaObject::invokeMethod(this, &NetJob::startNext, Qt::QueuedConnection);
+    });
+}
+
+void NetJob::setPerHostLimit(int max)
+{
+    m_per_host_max = max;
+    setMaxConcurrent(m_per_host_max * hostsInFlight);
+    setAdaptiveConcurrency(2, 2 * m_per_host_max * hostsInFlight);
+}
+
+void NetJob::setPriority(Net::Priority priority)
+{
+    m_priority = priority;
+    for (auto& task : m_queue) {
+        if (auto action = dynamic_cast<NetAction*>(task.get()))
+            action->setPriority(priority);
+    }
 }
 
 auto NetJob::addNetAction(NetAction::Ptr action) -> bool
 {
     action->setNetwork(m_network);
+    action->setPriority(m_priority);
+    connect(action.get(), &NetAction::spawned, this, [this](NetAction::Ptr spawned) {
+        addNetAction(spawned);
+        // don't wait for something to finish before starting it
+        if (isRunning())
+            QMetaObject::invokeMethod(this, &NetJob::startNext, Qt::QueuedConnection);
+    });
 
     addTask(action);
 
     return true;
 }
 
-void NetJob::startNext()
+auto NetJob::dequeueNext() -> Task::Ptr
 {
-    if (m_queue.isEmpty() && m_doing.isEmpty()) {
-        // We're finished, check for failures and retry if we can (up to 3 times)
-        if (!m_failed.isEmpty() && m_try < 3) {
-            m_try += 1;
-            while (!m_failed.isEmpty())
-                m_queue.enqueue(m_failed.take(*m_failed.keyBegin()));
-        }
+    if (!Net::BandwidthScheduler::shared().mayStart(m_priority, m_doing.size()))
+        return nullptr;
+
+    QHash<QString, int> in_flight;
+    for (auto& task : m_doing) {
+        if (auto action = dynamic_cast<NetAction*>(task.get()))
+            in_flight[action->url().host()]++;
     }
 
-    ConcurrentTask::startNext();
+    for (auto iter = m_queue.begin(); iter != m_queue.end(); iter++) {
+        auto action = dynamic_cast<NetAction*>(iter->get());
+        if (action) {
+            auto host = action->url().host();
+            // HTTP/2 streams share one connection, let them use the whole job's limit
+            if (!Net::isHttp2Host(host) && in_flight.value(host) >= m_per_host_max)
+                continue;
+        }
+        auto next = *iter;
+        m_queue.erase(iter);
+        return next;
+    }
+    return nullptr;
 }
 
 auto NetJob::size() const -> int
@@ -133,7 +180,7 @@ auto NetJob::getFailedFiles() -> QList<QString>
 
 void NetJob::updateState()
 {
-    emit progress(m_done.count(), totalSize());
+    setProgress(m_done.count(), totalSize());
     setStatus(tr("Executing %1 task(s) (%2 out of %3 are done)")
                   .arg(QString::number(m_doing.count()), QString::number(m_done.count()), QString::number(totalSize())));
 }
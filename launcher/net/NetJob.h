@@ -55,13 +55,18 @@ class NetJob : public ConcurrentTask {
     explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network);
     ~NetJob() override = default;
 
-    void startNext() override;
-
     auto size() const -> int;
 
     auto canAbort() const -> bool override;
     auto addNetAction(NetAction::Ptr action) -> bool;
 
+    /// the class of the requests of this job, those added before included
+    void setPriority(Net::Priority priority);
+    Net::Priority priority() const { return m_priority; }
+
+    /// how many requests may go to one host at a time, the concurrent downloads setting by default
+    void setPerHostLimit(int max);
+
     auto getFailedActions() -> QList<NetAction*>;
     auto getFailedFiles() -> QList<QString>;
 
@@ -71,9 +76,13 @@ class NetJob : public ConcurrentTask {
 
    protected:
     void updateState() override;
+    // start requests out of order when their host is busy, so one slow host can't take every slot
+    auto dequeueNext() -> Task::Ptr override;
 
    private:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
-    int m_try = 1;
+    // requests in flight to a single HTTP/1 host, one connection each
+    int m_per_host_max = 6;
+    Net::Priority m_priority = Net::Priority::Background;
 };
@@ -41,20 +41,100 @@
 
 #include <QDateTime>
 #include <QFileInfo>
+#include <QMutex>
+#include <QPointer>
+#include <QRandomGenerator>
 #include <memory>
 
 #if defined(LAUNCHER_APPLICATION)
 #include "Application.h"
+#include "net/ContentStore.h"
+#include "net/PeerCache.h"
 #endif
 #include "BuildConfig.h"
 
+#include "net/BandwidthScheduler.h"
+#include "net/Mirrors.h"
 #include "net/NetAction.h"
+#include "net/NetUtils.h"
+#include "net/UpstreamCache.h"
 
 #include "MMCTime.h"
+#include "PerfCounters.h"
 #include "StringUtils.h"
+#include "Trace.h"
 
 namespace Net {
 
+namespace {
+const qsizetype readBufferSize = 256 * 1024;
+// tries of a request, across its mirrors
+const int maxAttempts = 4;
+// the longest a server asking us to come back later is waited for
+const int maxRetryAfterMs = 60 * 1000;
+// a peer on the LAN that doesn't answer in this long likely went away
+const int peerTransferTimeoutMs = 3000;
+
+// response chunks get read into these, so downloads don't allocate a new buffer for every chunk
+class ReadBufferPool {
+   public:
+    QByteArray take()
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_free.isEmpty())
+            return QByteArray(readBufferSize, Qt::Uninitialized);
+        return m_free.takeLast();
+    }
+    void give(QByteArray buffer)
+    {
+        QMutexLocker locker(&m_lock);
+        // one per thread reading at the same time is all we ever need
+        if (m_free.size() < 8)
+            m_free.append(std::move(buffer));
+    }
+
+   private:
+    QMutex m_lock;
+    QList<QByteArray> m_free;
+};
+
+ReadBufferPool& readBuffers()
+{
+    static ReadBufferPool pool;
+    return pool;
+}
+
+// the requests writing into a file right now, by its path, so instances updated together download what they share once
+class WritingRequests {
+   public:
+    // `request` writes `target` from now on, unless another one already does, which is returned then
+    NetRequest* claim(const QString& target, NetRequest* request)
+    {
+        QMutexLocker locker(&m_lock);
+        auto& owner = m_owners[target];
+        if (!owner)
+            owner = request;
+        return owner;
+    }
+    void release(const QString& target, NetRequest* request)
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_owners.value(target) == request)
+            m_owners.remove(target);
+    }
+
+   private:
+    QMutex m_lock;
+    QHash<QString, NetRequest*> m_owners;
+};
+
+WritingRequests& writingRequests()
+{
+    static WritingRequests requests;
+    return requests;
+}
+}  // namespace
+
 void NetRequest::addValidator(Validator* v)
 {
     m_sink->addValidator(v);
@@ -65,6 +145,27 @@ void NetRequest::executeTask()
     init();
 
     setStatus(tr("Requesting %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
+    if (m_mirrors.isEmpty()) {
+        m_mirrors = withMirrors(m_url);
+        // the cache may not have it, only requests that can go to the origin afterwards try it
+        if (canRetry()) {
+            if (auto cached = UpstreamCache::shared().rewrite(m_url)) {
+                m_cache_url = *cached;
+                m_url = m_cache_url;
+                m_through_cache = true;
+            }
+        }
+#if defined(LAUNCHER_APPLICATION)
+        // what a peer sends has to match the same checksum, so only downloads that know theirs ask them
+        auto peers = PeerCache::shared();
+        if (peers && canRetry() && !(m_options & Option::Segmented))
+            m_peer_urls = peers->urlsFor(ContentStore::keyFor(m_sink->getValidators()));
+        if (!m_peer_urls.isEmpty()) {
+            m_url = m_peer_urls.takeFirst();
+            m_from_peer = true;
+        }
+#endif
+    }
 
     if (getState() == Task::State::AbortedByUser) {
         qCWarning(logCat) << getUid().toString() << "Attempt to start an aborted Request:" << m_url.toString();
@@ -72,6 +173,24 @@ void NetRequest::executeTask()
         return;
     }
 
+    // a redirect comes back here with the file already claimed
+    if (auto target = m_sink->target(); !target.isEmpty() && m_claimed_target.isEmpty()) {
+        if (auto owner = writingRequests().claim(target, this); owner != this) {
+            waitFor(owner);
+            return;
+        }
+        m_claimed_target = target;
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        *connection = connect(
+            this, &Task::finished, this,
+            [this, connection] {
+                disconnect(*connection);
+                writingRequests().release(m_claimed_target, this);
+                m_claimed_target.clear();
+            },
+            Qt::DirectConnection);
+    }
+
     QNetworkRequest request(m_url);
     m_state = m_sink->init(request);
     switch (m_state) {
@@ -105,16 +224,33 @@ void NetRequest::executeTask()
     // TODO remove duplication
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-    request.setTransferTimeout();
+    request.setTransferTimeout(m_from_peer ? peerTransferTimeoutMs : QNetworkRequest::DefaultTransferTimeoutConstant);
+    // servers that support it get all our requests multiplexed on one connection
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#else
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
 #endif
 
     m_last_progress_time = m_clock.now();
     m_last_progress_bytes = 0;
+    m_headers_received = false;
 
     QNetworkReply* rep = getReply(request);
     if (rep == nullptr)  // it failed
         return;
     m_reply.reset(rep);
+    auto& scheduler = BandwidthScheduler::shared();
+    if (!m_on_network) {
+        scheduler.started(m_priority);
+        m_on_network = true;
+    }
+    // a reply that isn't read then slows its connection down instead of buffering everything
+    if (scheduler.limit() > 0)
+        rep->setReadBufferSize(2 * readBufferSize);
+    // the time to the first byte, a redirect starts over
+    tracePhase("waiting for response", { { "url", m_url.toString() } });
+    if (Trace::isEnabled())
+        connect(rep, &QNetworkReply::encrypted, this, [this] { Trace::instant("net", "encrypted", this); });
     connect(rep, &QNetworkReply::downloadProgress, this, &NetRequest::downloadProgress);
     connect(rep, &QNetworkReply::finished, this, &NetRequest::downloadFinished);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)  // QNetworkReply::errorOccurred added in 5.15
@@ -126,6 +262,32 @@ void NetRequest::executeTask()
     connect(rep, &QNetworkReply::readyRead, this, &NetRequest::downloadReadyRead);
 }
 
+void NetRequest::waitFor(NetRequest* other)
+{
+    qCDebug(logCat) << getUid().toString() << "Waiting for" << other->getUid().toString() << "to download" << m_url.toString();
+    setStatus(tr("Waiting for %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
+    tracePhase("waiting for the same download");
+    QPointer<NetRequest> guard(other);
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    // once it's finished it doesn't own the file anymore, so this either finds it in place or downloads it itself
+    *connection = connect(
+        other, &Task::finished, this,
+        [this, guard, connection] {
+            disconnect(*connection);
+            if (getState() != State::Running)
+                return;
+            if (guard && guard->wasSuccessful()) {
+                qCDebug(logCat) << getUid().toString() << "Downloaded by" << guard->getUid().toString() << m_url.toString();
+                m_state = State::Succeeded;
+                emit succeeded();
+                emit finished();
+                return;
+            }
+            executeTask();
+        },
+        Qt::QueuedConnection);
+}
+
 void NetRequest::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
     auto now = m_clock.now();
@@ -241,6 +403,13 @@ auto NetRequest::handleRedirect() -> bool
 
 void NetRequest::downloadFinished()
 {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    if (m_reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool())
+#else
+    if (m_reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool())
+#endif
+        rememberHttp2Host(m_reply->url().host());
+
     // handle HTTP redirection first
     if (handleRedirect()) {
         qCDebug(logCat) << getUid().toString() << "Request redirected:" << m_url.toString();
@@ -258,6 +427,8 @@ void NetRequest::downloadFinished()
         return;
     } else if (m_state == State::Failed) {
         qCDebug(logCat) << getUid().toString() << "Request failed in previous step:" << m_url.toString();
+        if (scheduleRetry())
+            return;
         m_sink->abort();
         m_reply.reset();
         emit failed("");
@@ -272,24 +443,34 @@ void NetRequest::downloadFinished()
         return;
     }
 
+    // bodyless responses never got to downloadReadyRead
+    if (!m_headers_received && !receiveHeaders()) {
+        if (scheduleRetry())
+            return;
+        m_sink->abort();
+        m_reply.reset();
+        emit failed("");
+        emit finished();
+        return;
+    }
+
     // make sure we got all the remaining data, if any
-    auto data = m_reply->readAll();
-    if (data.size()) {
-        qCDebug(logCat) << getUid().toString() << "Writing extra" << data.size() << "bytes";
-        m_state = m_sink->write(data);
-        if (m_state != State::Succeeded) {
-            qCDebug(logCat) << getUid().toString() << "Request failed to write:" << m_url.toString();
-            m_sink->abort();
-            emit failed("");
-            emit finished();
+    if (!readBody()) {
+        qCDebug(logCat) << getUid().toString() << "Request failed to write:" << m_url.toString();
+        if (scheduleRetry())
             return;
-        }
+        m_sink->abort();
+        emit failed("");
+        emit finished();
+        return;
     }
 
     // otherwise, finalize the whole graph
     m_state = m_sink->finalize(*m_reply.get());
     if (m_state != State::Succeeded) {
         qCDebug(logCat) << getUid().toString() << "Request failed to finalize:" << m_url.toString();
+        if (scheduleRetry())
+            return;
         m_sink->abort();
         m_reply.reset();
         emit failed("");
@@ -298,29 +479,143 @@ void NetRequest::downloadFinished()
     }
 
     m_reply.reset();
+    if (m_through_cache && !m_from_peer)
+        UpstreamCache::shared().reportSuccess(m_cache_url);
     qCDebug(logCat) << getUid().toString() << "Request succeeded:" << m_url.toString();
     emit succeeded();
     emit finished();
 }
 
+auto NetRequest::scheduleRetry() -> bool
+{
+    if (m_from_peer && m_state != State::AbortedByUser) {
+        // peers only have what they downloaded themselves, on to the next one or the origin right away
+        qCDebug(logCat) << getUid().toString() << "Peer didn't give us" << m_url.toString();
+        m_sink->abort();
+        m_reply.reset();
+        m_from_peer = !m_peer_urls.isEmpty();
+        m_url = m_from_peer ? m_peer_urls.takeFirst() : m_through_cache ? m_cache_url : m_mirrors.first();
+        m_retry_timer.start(0);
+        return true;
+    }
+    if (m_through_cache && m_state != State::AbortedByUser) {
+        // a cache that answered doesn't have it or can't get it, one that didn't is likely down
+        auto status = m_reply ? m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0;
+        if (status == 0 || status >= 500)
+            UpstreamCache::shared().reportFailure(m_cache_url);
+        qCDebug(logCat) << getUid().toString() << "Download cache didn't give us" << m_url.toString() << ", going to the origin";
+        m_sink->abort();
+        m_reply.reset();
+        m_through_cache = false;
+        m_url = m_mirrors.first();
+        m_retry_timer.start(0);
+        return true;
+    }
+    if (!canRetry() || m_state == State::AbortedByUser || m_attempt + 1 >= maxAttempts)
+        return false;
+
+    auto status = m_reply ? m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() : 0;
+    // the server meant it, only another one may answer otherwise
+    bool transient = status == 0 || status == 408 || status == 429 || status >= 500;
+    if (!transient && m_mirrors.size() < 2)
+        return false;
+
+    // spread the retries out, so a server that's struggling doesn't get all of them back at once
+    int delay = m_backoff();
+    delay = delay / 2 + QRandomGenerator::global()->bounded(delay / 2 + 1);
+    if (m_reply && (status == 429 || status == 503)) {
+        bool ok = false;
+        auto after = m_reply->rawHeader("Retry-After").trimmed().toInt(&ok);
+        if (ok && after > 0)
+            delay = qMax(delay, qMin(after * 1000, maxRetryAfterMs));
+    }
+
+    m_attempt++;
+    m_url = m_mirrors[m_attempt % m_mirrors.size()];
+    qCWarning(logCat) << getUid().toString() << "Retrying" << m_url.toString() << "in" << delay << "ms, attempt" << m_attempt + 1 << "of"
+                      << maxAttempts;
+    m_sink->abort();
+    m_reply.reset();
+    setStatus(tr("Retrying %1").arg(StringUtils::truncateUrlHumanFriendly(m_url, 80)));
+    m_retry_timer.start(delay);
+    return true;
+}
+
 void NetRequest::downloadReadyRead()
 {
     if (m_state == State::Running) {
-        auto data = m_reply->readAll();
-        m_state = m_sink->write(data);
-        if (m_state == State::Failed) {
+        if (!m_headers_received && !receiveHeaders())
+            return;
+        auto& scheduler = BandwidthScheduler::shared();
+        if (!readBody(scheduler.allowance(m_priority))) {
             qCCritical(logCat) << getUid().toString() << "Failed to process response chunk";
+        } else if (m_reply->bytesAvailable() > 0 && !m_pace_timer.isActive()) {
+            m_pace_timer.start(scheduler.retryIn(m_priority));
         }
-        // qDebug() << "Request" << m_url.toString() << "gained" << data.size() << "bytes";
     } else {
         qCCritical(logCat) << getUid().toString() << "Cannot write download data! illegal status " << m_status;
     }
 }
 
+auto NetRequest::readBody(qint64 limit) -> bool
+{
+    QByteArray buffer;
+    qint64 received = 0;
+    while (m_state == State::Running) {
+        auto available = qMin(m_reply->bytesAvailable(), limit - received);
+        if (available <= 0)
+            break;
+
+        if (auto* target = m_sink->beginDirectWrite(available)) {
+            auto read = m_reply->read(target, available);
+            m_state = m_sink->endDirectWrite(qMax<qint64>(read, 0));
+            if (read <= 0)
+                break;
+            received += read;
+            continue;
+        }
+
+        if (buffer.isNull())
+            buffer = readBuffers().take();
+        auto read = m_reply->read(buffer.data(), qMin<qint64>(available, buffer.size()));
+        if (read <= 0)
+            break;
+        received += read;
+        auto chunk = QByteArray::fromRawData(buffer.constData(), read);
+        m_state = m_sink->write(chunk);
+    }
+    if (!buffer.isNull())
+        readBuffers().give(std::move(buffer));
+    if (received > 0) {
+        PerfCounters::add("net.bytes." + m_reply->url().host(), received);
+        BandwidthScheduler::shared().consume(received);
+    }
+    return m_state != State::Failed;
+}
+
+auto NetRequest::receiveHeaders() -> bool
+{
+    m_headers_received = true;
+    tracePhase("receiving", { { "status", m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() } });
+    m_state = m_sink->headersReceived(*m_reply);
+    if (m_state == State::Failed) {
+        qCCritical(logCat) << getUid().toString() << "Failed to process response headers";
+        return false;
+    }
+    return true;
+}
+
 auto NetRequest::abort() -> bool
 {
+    // running without a reply, it's waiting for another request or for its next try
+    bool waiting = isRunning() && !m_reply;
+    m_retry_timer.stop();
+    m_pace_timer.stop();
     m_state = State::AbortedByUser;
-    if (m_reply) {
+    if (waiting) {
+        emit aborted();
+        emit finished();
+    } else if (m_reply) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)  // QNetworkReply::errorOccurred added in 5.15
         disconnect(m_reply.get(), &QNetworkReply::errorOccurred, nullptr, nullptr);
 #else
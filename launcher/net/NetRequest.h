@@ -39,8 +39,11 @@
 #pragma once
 
 #include <qloggingcategory.h>
+#include <QTimer>
 #include <chrono>
+#include <limits>
 
+#include "ExponentialSeries.h"
 #include "NetAction.h"
 #include "Sink.h"
 #include "Validator.h"
@@ -52,11 +55,25 @@ namespace Net {
 class NetRequest : public NetAction {
     Q_OBJECT
    protected:
-    explicit NetRequest() : NetAction() {}
+    explicit NetRequest() : NetAction()
+    {
+        m_retry_timer.setSingleShot(true);
+        connect(&m_retry_timer, &QTimer::timeout, this, &NetRequest::executeTask);
+        m_pace_timer.setSingleShot(true);
+        connect(&m_pace_timer, &QTimer::timeout, this, [this] {
+            if (m_reply && m_state == State::Running)
+                downloadReadyRead();
+        });
+        connect(this, &Task::finished, this, [this] {
+            if (m_on_network)
+                BandwidthScheduler::shared().stopped(m_priority);
+            m_on_network = false;
+        });
+    }
 
    public:
     using Ptr = shared_qobject_ptr<class NetRequest>;
-    enum class Option { NoOptions = 0, AcceptLocalFiles = 1, MakeEternal = 2 };
+    enum class Option { NoOptions = 0, AcceptLocalFiles = 1, MakeEternal = 2, Resumable = 4, Segmented = 8 };
     Q_DECLARE_FLAGS(Options, Option)
 
    public:
@@ -69,8 +86,20 @@ class NetRequest : public NetAction {
     auto abort() -> bool override;
     auto canAbort() const -> bool override { return true; }
 
+   protected:
+    // whether sending the request again is harmless, so a failed one may be
+    virtual auto canRetry() const -> bool { return false; }
+
    private:
+    // try again a moment later, on the next mirror if there's one, rather than failing; false if it won't
+    auto scheduleRetry() -> bool;
+    // finish like `other` once it's done, it's downloading the same file right now
+    void waitFor(NetRequest* other);
     auto handleRedirect() -> bool;
+    // hand the status and headers to the sink, false if it doesn't want the reply
+    auto receiveHeaders() -> bool;
+    // hand what the reply has buffered to the sink, up to `limit`, false if it failed
+    auto readBody(qint64 limit = std::numeric_limits<qint64>::max()) -> bool;
     virtual QNetworkReply* getReply(QNetworkRequest&) = 0;
 
    protected slots:
@@ -93,6 +122,26 @@ class NetRequest : public NetAction {
     std::chrono::steady_clock m_clock;
     std::chrono::time_point<std::chrono::steady_clock> m_last_progress_time;
     qint64 m_last_progress_bytes;
+    // whether the sink saw the headers of the current reply yet
+    bool m_headers_received = false;
+    // the file of the sink, while this is the request writing it
+    QString m_claimed_target;
+
+    // the URL and its mirrors, tried in turn
+    QList<QUrl> m_mirrors;
+    // the peers on the LAN left to ask first
+    QList<QUrl> m_peer_urls;
+    bool m_from_peer = false;
+    // the URL on the site's download cache, tried after the peers and before the origin
+    QUrl m_cache_url;
+    bool m_through_cache = false;
+    int m_attempt = 0;
+    ExponentialSeries m_backoff{ 500, 8000 };
+    QTimer m_retry_timer;
+    // reads what's left of a reply once the bandwidth limit allows it
+    QTimer m_pace_timer;
+    // whether the scheduler counts this one as downloading
+    bool m_on_network = false;
 };
 }  // namespace Net
 
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <QMutex>
 #include <QNetworkReply>
 #include <QSet>
 
@@ -40,4 +41,59 @@ inline bool isApplicationError(QNetworkReply::NetworkError x)
                                                         QNetworkReply::UnknownContentError };
     return errors.contains(x);
 }
+
+namespace detail {
+inline QMutex& http2HostsLock()
+{
+    static QMutex lock;
+    return lock;
+}
+inline QSet<QString>& http2Hosts()
+{
+    static QSet<QString> hosts;
+    return hosts;
+}
+}  // namespace detail
+
+// remember that the host answered over HTTP/2, so its requests can share a single connection
+inline void rememberHttp2Host(const QString& host)
+{
+    QMutexLocker locker(&detail::http2HostsLock());
+    detail::http2Hosts().insert(host);
+}
+
+inline bool isHttp2Host(const QString& host)
+{
+    QMutexLocker locker(&detail::http2HostsLock());
+    return detail::http2Hosts().contains(host);
+}
+
+// parse "Content-Range: bytes <first>-<last>/<total>", the total is -1 when the server doesn't know it
+inline bool parseContentRange(const QByteArray& header, qint64& first, qint64& last, qint64& total)
+{
+    if (!header.startsWith("bytes "))
+        return false;
+    auto dash = header.indexOf('-');
+    auto slash = header.indexOf('/');
+    if (dash < 0 || slash < dash)
+        return false;
+    bool first_ok = false, last_ok = false, total_ok = false;
+    first = header.mid(6, dash - 6).trimmed().toLongLong(&first_ok);
+    last = header.mid(dash + 1, slash - dash - 1).trimmed().toLongLong(&last_ok);
+    auto total_str = header.mid(slash + 1).trimmed();
+    total = total_str == "*" ? -1 : total_str.toLongLong(&total_ok);
+    return first_ok && last_ok && (total_ok || total == -1) && first <= last;
+}
+
+// the If-Range value that identifies the version of the file being sent, empty if a range of it can't be asked for later
+inline QByteArray resumeToken(const QNetworkReply& reply)
+{
+    auto encoding = reply.rawHeader("Content-Encoding");
+    // what gets written is decoded, ranges are counted in the encoded data
+    if (!encoding.isEmpty() && encoding != "identity")
+        return {};
+    auto etag = reply.rawHeader("ETag");
+    // weak ETags aren't allowed in If-Range
+    return !etag.isEmpty() && !etag.startsWith("W/") ? etag : reply.rawHeader("Last-Modified");
+}
 }  // namespace Net
@@ -47,15 +47,25 @@
 #include <QJsonObject>
 #include <QUrlQuery>
 
+#include <algorithm>
+#include <limits>
+
 #include "net/Logging.h"
 
-std::array<PasteUpload::PasteTypeInfo, 4> PasteUpload::PasteTypes = { { { "0x0.st", "https://0x0.st", "" },
-                                                                        { "hastebin", "https://hst.sh", "/documents" },
-                                                                        { "paste.gg", "https://paste.gg", "/api/v1/pastes" },
-                                                                        { "mclo.gs", "https://api.mclo.gs", "/1/log" } } };
+std::array<PasteUpload::PasteTypeInfo, 4> PasteUpload::PasteTypes = { {
+    { "0x0.st", "https://0x0.st", "", 512 * 1024 * 1024, 0 },
+    { "hastebin", "https://hst.sh", "/documents", 400000, 0 },
+    { "paste.gg", "https://paste.gg", "/api/v1/pastes", 0, 0 },
+    { "mclo.gs", "https://api.mclo.gs", "/1/log", 10 * 1024 * 1024, 25000 },
+} };
 
 PasteUpload::PasteUpload(QWidget* window, QString text, QString baseUrl, PasteType pasteType)
-    : m_window(window), m_baseUrl(baseUrl), m_pasteType(pasteType), m_text(text.toUtf8())
+    : m_window(window)
+    , m_baseUrl(baseUrl)
+    , m_pasteType(pasteType)
+    , m_fullText(text.toUtf8())
+    , m_maxBytes(PasteTypes.at(pasteType).maxBytes)
+    , m_maxLines(PasteTypes.at(pasteType).maxLines)
 {
     if (m_baseUrl == "")
         m_baseUrl = PasteTypes.at(pasteType).defaultBase;
@@ -69,8 +79,81 @@ PasteUpload::PasteUpload(QWidget* window, QString text, QString baseUrl, PasteTy
 
 PasteUpload::~PasteUpload() {}
 
+QByteArray PasteUpload::trimToLimit(const QByteArray& text, qsizetype maxBytes, int maxLines)
+{
+    bool tooLong = maxBytes > 0 && text.size() > maxBytes;
+    bool tooManyLines = maxLines > 0 && text.count('\n') > maxLines;
+    if (!tooLong && !tooManyLines)
+        return text;
+
+    // the start says what was launched and with what, the end how it went wrong; room is kept for the note between them
+    qsizetype byteBudget = maxBytes > 0 ? maxBytes - 64 : text.size();
+    int lineBudget = maxLines > 0 ? maxLines - 1 : std::numeric_limits<int>::max();
+
+    qsizetype head = 0;
+    int headLines = 0;
+    while (headLines < lineBudget / 4) {
+        auto newline = text.indexOf('\n', head);
+        if (newline == -1 || newline + 1 > byteBudget / 4)
+            break;
+        head = newline + 1;
+        headLines++;
+    }
+
+    qsizetype tail = text.size();
+    int tailLines = 0;
+    while (tail > head && headLines + tailLines < lineBudget) {
+        // the newline at tail - 1 ends the previous line, the one before it starts the line
+        qsizetype start = tail < 2 ? 0 : text.lastIndexOf('\n', tail - 2) + 1;
+        start = std::max(start, head);
+        if (text.size() - start > byteBudget - head)
+            break;
+        tail = start;
+        tailLines++;
+    }
+
+    // a last line longer than all the room there is, it's cut instead
+    if (tail == text.size())
+        return text.right(byteBudget);
+
+    auto left = text.mid(head, tail - head).count('\n');
+    return text.left(head) + QString("[%1 lines left out to fit the paste service]\n").arg(left).toUtf8() + text.mid(tail);
+}
+
 void PasteUpload::executeTask()
 {
+    // mclo.gs tells what it takes, anything past that it cuts off the end, where the crash is
+    if (m_pasteType == Mclogs) {
+        requestLimits();
+        return;
+    }
+    upload();
+}
+
+void PasteUpload::requestLimits()
+{
+    QNetworkRequest request{ QUrl(m_baseUrl + "/1/limits") };
+    request.setHeader(QNetworkRequest::UserAgentHeader, APPLICATION->getUserAgentUncached().toUtf8());
+    auto rep = APPLICATION->network()->get(request);
+    m_reply = std::shared_ptr<QNetworkReply>(rep, [](QNetworkReply* reply) { reply->deleteLater(); });
+    setStatus(tr("Asking %1 for its limits").arg(m_baseUrl));
+
+    connect(rep, &QNetworkReply::finished, this, [this] {
+        if (m_reply->error() == QNetworkReply::NoError) {
+            auto limits = QJsonDocument::fromJson(m_reply->readAll()).object();
+            m_maxBytes = qsizetype(limits.value("maxLength").toDouble(m_maxBytes));
+            m_maxLines = limits.value("maxLines").toInt(m_maxLines);
+        } else {
+            qCWarning(taskUploadLogC) << getUid().toString() << "Couldn't get the limits of" << m_baseUrl << ":" << m_reply->errorString();
+        }
+        upload();
+    });
+}
+
+void PasteUpload::upload()
+{
+    m_text = trimToLimit(m_fullText, m_maxBytes, m_maxLines);
+
     QNetworkRequest request{ QUrl(m_uploadUrl) };
     QNetworkReply* rep{};
 
@@ -97,10 +180,9 @@ void PasteUpload::executeTask()
             break;
         }
         case Mclogs: {
-            QUrlQuery postData;
-            postData.addQueryItem("content", m_text);
+            // encoded straight from the bytes, going through QUrlQuery copies the whole log twice more
             request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-            rep = APPLICATION->network()->post(request, postData.toString().toUtf8());
+            rep = APPLICATION->network()->post(request, "content=" + QUrl::toPercentEncoding(m_text));
             break;
         }
         case PasteGG: {
@@ -136,13 +218,16 @@ void PasteUpload::executeTask()
     connect(rep, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error), this, &PasteUpload::downloadError);
 #endif
 
-    m_reply = std::shared_ptr<QNetworkReply>(rep);
+    m_reply = std::shared_ptr<QNetworkReply>(rep, [](QNetworkReply* reply) { reply->deleteLater(); });
 
     setStatus(tr("Uploading to %1").arg(m_uploadUrl));
 }
 
 void PasteUpload::downloadError(QNetworkReply::NetworkError error)
 {
+    // handled once it's finished, by trying again with less
+    if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 413)
+        return;
     // error happened during download.
     qCCritical(taskUploadLogC) << getUid().toString() << "Network error: " << error;
     emitFailed(m_reply->errorString());
@@ -153,6 +238,14 @@ void PasteUpload::downloadFinished()
     QByteArray data = m_reply->readAll();
     int statusCode = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
+    // the server has a smaller limit than the one known for it
+    if (statusCode == 413 && m_text.size() > 64 * 1024) {
+        qCWarning(taskUploadLogC) << getUid().toString() << m_uploadUrl << "refused" << m_text.size() << "bytes, trying with half";
+        m_maxBytes = m_text.size() / 2;
+        upload();
+        return;
+    }
+
     if (m_reply->error() != QNetworkReply::NetworkError::NoError) {
         emitFailed(tr("Network error: %1").arg(m_reply->errorString()));
         m_reply.reset();
@@ -63,6 +63,9 @@ class PasteUpload : public Task {
         const QString name;
         const QString defaultBase;
         const QString endpointPath;
+        // what the service takes by default, 0 where there's no known limit
+        const qsizetype maxBytes;
+        const int maxLines;
     };
 
     static std::array<PasteTypeInfo, 4> PasteTypes;
@@ -72,16 +75,26 @@ class PasteUpload : public Task {
 
     QString pasteLink() { return m_pasteLink; }
 
+    /// `text` cut down to `maxBytes` and `maxLines` by leaving out lines in the middle, where a log has the least to say
+    static QByteArray trimToLimit(const QByteArray& text, qsizetype maxBytes, int maxLines);
+
    protected:
     virtual void executeTask();
 
+   private:
+    void requestLimits();
+    void upload();
+
    private:
     QWidget* m_window;
     QString m_pasteLink;
     QString m_baseUrl;
     QString m_uploadUrl;
     PasteType m_pasteType;
+    QByteArray m_fullText;
     QByteArray m_text;
+    qsizetype m_maxBytes;
+    int m_maxLines;
     std::shared_ptr<QNetworkReply> m_reply;
    public slots:
     void downloadError(QNetworkReply::NetworkError);
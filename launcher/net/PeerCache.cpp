@@ -0,0 +1,211 @@
+#include "PeerCache.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkDatagram>
+#include <QNetworkInterface>
+#include <QRegularExpression>
+#include <QTcpSocket>
+
+#include <algorithm>
+
+#include "Application.h"
+#include "net/Logging.h"
+
+namespace Net {
+
+namespace {
+// organization-local scope, it doesn't leave the site
+const QHostAddress multicastGroup("239.255.42.99");
+const quint16 multicastPort = 45299;
+const int announceIntervalMs = 30 * 1000;
+// peers that weren't heard from in this long are gone
+const qint64 peerExpirySecs = 90;
+// how many peers a download asks before going to the origin
+const int maxPeersPerRequest = 3;
+const int maxServing = 16;
+const qint64 chunkSize = 256 * 1024;
+}  // namespace
+
+PeerCache::PeerCache(ContentStore* store, QObject* parent) : QObject(parent), m_store(store)
+{
+    m_announce_timer.setInterval(announceIntervalMs);
+    connect(&m_announce_timer, &QTimer::timeout, this, &PeerCache::announce);
+    connect(&m_udp, &QUdpSocket::readyRead, this, &PeerCache::readAnnouncements);
+    connect(&m_server, &QTcpServer::newConnection, this, &PeerCache::acceptConnection);
+}
+
+PeerCache* PeerCache::shared()
+{
+    auto app = qobject_cast<Application*>(QCoreApplication::instance());
+    return app ? app->peerCache() : nullptr;
+}
+
+bool PeerCache::start()
+{
+    if (!m_server.listen(QHostAddress::AnyIPv4)) {
+        qCWarning(taskNetLogC) << "Could not serve the content store to the LAN:" << m_server.errorString();
+        return false;
+    }
+    if (!m_udp.bind(QHostAddress::AnyIPv4, multicastPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint) ||
+        !m_udp.joinMulticastGroup(multicastGroup)) {
+        qCWarning(taskNetLogC) << "Could not join the LAN cache group:" << m_udp.errorString();
+        m_server.close();
+        return false;
+    }
+    qCInfo(taskNetLogC) << "Sharing the content store on the LAN, port" << m_server.serverPort();
+    announce();
+    m_announce_timer.start();
+    return true;
+}
+
+QByteArray PeerCache::announcement(const QUuid& id, quint16 port)
+{
+    return "PRISM-PEER-CACHE 1 " + id.toByteArray(QUuid::WithoutBraces) + ' ' + QByteArray::number(port);
+}
+
+std::optional<std::pair<QUuid, quint16>> PeerCache::parseAnnouncement(const QByteArray& datagram)
+{
+    auto parts = datagram.trimmed().split(' ');
+    if (parts.size() != 4 || parts[0] != "PRISM-PEER-CACHE" || parts[1] != "1")
+        return std::nullopt;
+    auto id = QUuid::fromString(QString::fromLatin1(parts[2]));
+    bool ok = false;
+    auto port = parts[3].toUShort(&ok);
+    if (id.isNull() || !ok || port == 0)
+        return std::nullopt;
+    return std::make_pair(id, port);
+}
+
+std::optional<ContentStore::Key> PeerCache::parseRequest(const QByteArray& request_line)
+{
+    static const QRegularExpression s_request(R"(^GET /objects/(sha1|sha512)/([0-9a-f]+) HTTP/1\.[01]$)");
+    auto match = s_request.match(QString::fromLatin1(request_line.trimmed()));
+    if (!match.hasMatch())
+        return std::nullopt;
+    ContentStore::Key key{ match.captured(1), match.captured(2) };
+    // nothing but a whole digest, so it can't point anywhere else in the store
+    if (key.hash.size() != (key.type == "sha1" ? 40 : 128))
+        return std::nullopt;
+    return key;
+}
+
+void PeerCache::announce()
+{
+    m_udp.writeDatagram(announcement(m_id, m_server.serverPort()), multicastGroup, multicastPort);
+}
+
+void PeerCache::readAnnouncements()
+{
+    while (m_udp.hasPendingDatagrams()) {
+        auto datagram = m_udp.receiveDatagram(512);
+        auto parsed = parseAnnouncement(datagram.data());
+        if (!parsed || parsed->first == m_id)
+            continue;
+        auto address = datagram.senderAddress();
+        auto key = address.toString() + ':' + QString::number(parsed->second);
+        auto& peer = m_peers[key];
+        bool isNew = peer.port == 0;
+        peer = { address, parsed->second, QDateTime::currentSecsSinceEpoch() };
+        if (isNew) {
+            qCDebug(taskNetLogC) << "Found a LAN cache peer at" << key;
+            // let it know about us right away rather than on the next round
+            announce();
+        }
+    }
+}
+
+QList<QUrl> PeerCache::urlsFor(const ContentStore::Key& key) const
+{
+    if (!key.isValid())
+        return {};
+    auto oldest = QDateTime::currentSecsSinceEpoch() - peerExpirySecs;
+    QList<Peer> peers;
+    for (auto const& peer : m_peers) {
+        if (peer.lastSeen >= oldest)
+            peers.append(peer);
+    }
+    std::sort(peers.begin(), peers.end(), [](const Peer& a, const Peer& b) { return a.lastSeen > b.lastSeen; });
+
+    QList<QUrl> urls;
+    for (auto const& peer : peers.mid(0, maxPeersPerRequest)) {
+        QUrl url;
+        url.setScheme("http");
+        url.setHost(peer.address.toString());
+        url.setPort(peer.port);
+        url.setPath(QString("/objects/%1/%2").arg(key.type, key.hash.toLower()));
+        urls.append(url);
+    }
+    return urls;
+}
+
+void PeerCache::acceptConnection()
+{
+    while (auto socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        if (m_serving >= maxServing) {
+            respond(socket, "503 Service Unavailable");
+            continue;
+        }
+        m_serving++;
+        connect(socket, &QObject::destroyed, this, [this] { m_serving--; });
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] { handleRequest(socket); });
+        // a peer that never finishes asking doesn't keep the slot
+        QTimer::singleShot(10 * 1000, socket, [socket] {
+            if (socket->property("file").isNull())
+                socket->abort();
+        });
+    }
+}
+
+void PeerCache::respond(QTcpSocket* socket, const QByteArray& status)
+{
+    socket->write("HTTP/1.1 " + status + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    socket->disconnectFromHost();
+}
+
+void PeerCache::handleRequest(QTcpSocket* socket)
+{
+    if (!socket->property("file").isNull())
+        return;  // the response is on its way already
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > 4096)
+            socket->abort();
+        return;
+    }
+
+    auto key = parseRequest(socket->readLine());
+    if (!key) {
+        respond(socket, "400 Bad Request");
+        return;
+    }
+    auto path = m_store->pathFor(*key);
+    auto file = new QFile(path, socket);
+    if (!file->open(QIODevice::ReadOnly)) {
+        respond(socket, "404 Not Found");
+        return;
+    }
+    socket->setProperty("file", path);
+    qCDebug(taskNetLogC) << "Serving" << key->hash << "to" << socket->peerAddress().toString();
+
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " + QByteArray::number(file->size()) +
+                  "\r\nConnection: close\r\n\r\n");
+    // what's left of the file goes out a chunk at a time, as the socket takes it
+    auto sendMore = [socket, file] {
+        while (socket->bytesToWrite() < chunkSize && !file->atEnd()) {
+            auto chunk = file->read(chunkSize);
+            if (chunk.isEmpty()) {
+                socket->abort();
+                return;
+            }
+            socket->write(chunk);
+        }
+        if (file->atEnd() && socket->bytesToWrite() == 0)
+            socket->disconnectFromHost();
+    };
+    connect(socket, &QTcpSocket::bytesWritten, socket, sendMore);
+    sendMore();
+}
+
+}  // namespace Net
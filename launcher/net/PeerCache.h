@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QTcpServer>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QUrl>
+#include <QUuid>
+
+#include <optional>
+
+#include "net/ContentStore.h"
+
+class QTcpSocket;
+
+namespace Net {
+/**
+ * Shares the content store with the other launchers on the LAN that have it turned on too.
+ *
+ * Labs and LAN parties set up the same instances on every machine, and each of them downloaded the same assets,
+ * libraries and mods again. With the "LanPeerCache" setting on, the launcher announces itself on a multicast group
+ * and serves what's in its store by hash over plain HTTP, and a download that knows the checksum of its file asks
+ * the peers it heard from before the origin. What a peer sends goes through the checksum of the download like
+ * anything else, so a peer can't hand out anything but the file asked for.
+ */
+class PeerCache : public QObject {
+    Q_OBJECT
+   public:
+    struct Peer {
+        QHostAddress address;
+        quint16 port = 0;
+        qint64 lastSeen = 0;
+    };
+
+    explicit PeerCache(ContentStore* store, QObject* parent = nullptr);
+
+    /// the cache of the running launcher, null when there's none or it's turned off
+    static auto shared() -> PeerCache*;
+
+    /// start announcing and serving the store
+    auto start() -> bool;
+
+    /// where the peers heard from lately may have `key`, the most recently heard from first
+    [[nodiscard]] auto urlsFor(const ContentStore::Key& key) const -> QList<QUrl>;
+
+    static auto announcement(const QUuid& id, quint16 port) -> QByteArray;
+    /// the id and port of an announcement, if it's one
+    static auto parseAnnouncement(const QByteArray& datagram) -> std::optional<std::pair<QUuid, quint16>>;
+    /// the object the request line of an HTTP request asks for, if it's one we may serve
+    static auto parseRequest(const QByteArray& request_line) -> std::optional<ContentStore::Key>;
+
+   private:
+    void announce();
+    void readAnnouncements();
+    void acceptConnection();
+    void handleRequest(QTcpSocket* socket);
+    static void respond(QTcpSocket* socket, const QByteArray& status);
+
+   private:
+    ContentStore* m_store;
+    QUuid m_id = QUuid::createUuid();
+    QUdpSocket m_udp;
+    QTcpServer m_server;
+    QTimer m_announce_timer;
+    // by address and port
+    QHash<QString, Peer> m_peers;
+    int m_serving = 0;
+};
+}  // namespace Net
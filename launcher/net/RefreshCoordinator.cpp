@@ -0,0 +1,86 @@
+#include "RefreshCoordinator.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonObject>
+#include <QTimer>
+
+#include "Exception.h"
+#include "Json.h"
+
+RefreshCoordinator::RefreshCoordinator(QString path, std::chrono::milliseconds stagger) : m_path(std::move(path)), m_stagger(stagger)
+{
+    load();
+}
+
+void RefreshCoordinator::add(const QString& name, std::chrono::seconds min_interval, std::function<void()> refresh)
+{
+    auto last = m_last_refresh.value(name, 0);
+    auto now = QDateTime::currentSecsSinceEpoch();
+    if (last <= now && now - last < min_interval.count()) {
+        qDebug() << "Not refreshing" << name << "yet, it was refreshed" << now - last << "seconds ago";
+        return;
+    }
+
+    if (!m_started) {
+        m_pending.append({ name, min_interval, std::move(refresh) });
+        return;
+    }
+    schedule(name, std::move(refresh));
+}
+
+void RefreshCoordinator::start()
+{
+    if (m_started)
+        return;
+    m_started = true;
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+    for (auto& refresh : pending)
+        schedule(refresh.name, std::move(refresh.refresh));
+}
+
+void RefreshCoordinator::schedule(const QString& name, std::function<void()> refresh)
+{
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    auto slot = std::max(now, m_next_slot);
+    m_next_slot = slot + m_stagger.count();
+
+    QTimer::singleShot(slot - now, this, [this, name, refresh = std::move(refresh)] {
+        qDebug() << "Refreshing" << name;
+        m_last_refresh.insert(name, QDateTime::currentSecsSinceEpoch());
+        save();
+        refresh();
+    });
+}
+
+void RefreshCoordinator::load()
+{
+    if (m_path.isNull())
+        return;
+
+    try {
+        auto root = Json::requireObject(Json::requireDocument(m_path, "Refresh times"));
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it)
+            m_last_refresh.insert(it.key(), static_cast<qint64>(it.value().toDouble()));
+    } catch ([[maybe_unused]] const Exception& e) {
+        // there's none the first time
+        m_last_refresh.clear();
+    }
+}
+
+void RefreshCoordinator::save()
+{
+    if (m_path.isNull())
+        return;
+
+    QJsonObject root;
+    for (auto it = m_last_refresh.constBegin(); it != m_last_refresh.constEnd(); ++it)
+        root.insert(it.key(), QJsonValue(double(it.value())));
+
+    try {
+        Json::write(root, m_path);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write refresh times:" << e.cause();
+    }
+}
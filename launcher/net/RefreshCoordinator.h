@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <chrono>
+#include <functional>
+
+/**
+ * Refreshes what the launcher keeps from the network once it's up, a moment apart from each other.
+ *
+ * The news, the translation index and the like used to be requested right at startup, every time the launcher opened.
+ * Here every endpoint has a minimum interval between its refreshes that holds across launches, so opening the
+ * launcher often doesn't ask for the same things again. Refreshes should go through the HttpMetaCache, so what they
+ * ask for is revalidated rather than downloaded again, and whoever owns the content shows the cached one meanwhile.
+ *
+ * A refresh counts from the moment it starts, one that fails waits for its interval like any other.
+ */
+class RefreshCoordinator : public QObject {
+    Q_OBJECT
+   public:
+    // supply path to the file keeping when the endpoints were last refreshed
+    explicit RefreshCoordinator(QString path = QString(), std::chrono::milliseconds stagger = std::chrono::seconds(2));
+
+    /// refresh `name` with `refresh` if it's due, at most once per `min_interval`; it's queued until start()
+    void add(const QString& name, std::chrono::seconds min_interval, std::function<void()> refresh);
+
+    /// start the refreshes that are due, and those added later right away, a stagger apart
+    void start();
+
+   private:
+    void schedule(const QString& name, std::function<void()> refresh);
+    void load();
+    void save();
+
+   private:
+    struct Pending {
+        QString name;
+        std::chrono::seconds min_interval;
+        std::function<void()> refresh;
+    };
+
+    QString m_path;
+    std::chrono::milliseconds m_stagger;
+    // last refresh by endpoint, in seconds since epoch
+    QHash<QString, qint64> m_last_refresh;
+    QList<Pending> m_pending;
+    bool m_started = false;
+    // when the next refresh may start, in ms since epoch
+    qint64 m_next_slot = 0;
+};
@@ -0,0 +1,320 @@
+#include "SegmentedFileSink.h"
+
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "FileSystem.h"
+
+#include "net/Download.h"
+#include "net/Logging.h"
+#include "net/NetUtils.h"
+
+#if defined(LAUNCHER_APPLICATION)
+#include "net/ContentStore.h"
+#include "net/DownloadJournal.h"
+#endif
+
+namespace Net {
+
+// the finished file gets read back this much at a time for the validators
+static const qint64 validateChunkSize = 1024 * 1024;
+// how much more has to be there before the journal hears about it
+static const qint64 journalInterval = 4 * 1024 * 1024;
+
+SegmentedFile::SegmentedFile(QString filename) : m_filename(std::move(filename)), m_file(m_filename + ".part") {}
+
+SegmentedFile::~SegmentedFile()
+{
+    if (m_committed || !m_file.isOpen())
+        return;
+    // the room for what's missing would look like data to the next attempt
+    auto keep = m_resumable && !m_broken ? prefix() : 0;
+    if (keep > 0 && m_file.flush() && m_file.resize(keep)) {
+        m_file.close();
+#if defined(LAUNCHER_APPLICATION)
+        if (auto journal = m_journal_url.isEmpty() ? nullptr : DownloadJournal::shared())
+            journal->progressed(m_journal_url, keep);
+#endif
+        journalPart(true);
+        return;
+    }
+    m_file.close();
+    m_file.remove();
+    QFile::remove(m_file.fileName() + ".meta");
+    journalPart(false);
+}
+
+void SegmentedFile::journalPart([[maybe_unused]] bool keep)
+{
+#if defined(LAUNCHER_APPLICATION)
+    auto journal = m_journal_url.isEmpty() ? nullptr : DownloadJournal::shared();
+    if (!journal)
+        return;
+    if (keep)
+        journal->released(m_journal_url);
+    else
+        journal->finished(m_journal_url);
+#endif
+}
+
+bool SegmentedFile::prepare(qint64 size)
+{
+    if (m_broken)
+        return false;
+    if (!m_file.isOpen()) {
+        if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            qCCritical(taskNetLogC) << "Could not open" << m_file.fileName() << "for writing:" << m_file.errorString();
+            return false;
+        }
+        QFile::remove(m_file.fileName() + ".meta");
+#if defined(LAUNCHER_APPLICATION)
+        if (auto journal = m_journal_url.isEmpty() ? nullptr : DownloadJournal::shared())
+            journal->started(m_journal_url, m_file.fileName(), 0);
+#endif
+    }
+    if (size >= 0 && m_file.size() != size && !m_file.resize(size)) {
+        qCCritical(taskNetLogC) << "Could not make room for" << size << "bytes in" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool SegmentedFile::write(qint64 offset, const QByteArray& data)
+{
+    if (m_broken || !m_file.isOpen() || !m_file.seek(offset) || m_file.write(data) != data.size()) {
+        qCCritical(taskNetLogC) << "Failed writing into" << m_file.fileName();
+        return false;
+    }
+    return true;
+}
+
+void SegmentedFile::setResumeToken(const QByteArray& token)
+{
+    m_resumable = false;
+    if (m_journal_url.isEmpty() || token.isEmpty())
+        return;
+    QSaveFile meta(m_file.fileName() + ".meta");
+    if (!meta.open(QIODevice::WriteOnly) || meta.write(token) != token.size() || !meta.commit()) {
+        qCWarning(taskNetLogC) << "Could not write" << meta.fileName() << ", the download can't be resumed";
+        return;
+    }
+    m_resumable = true;
+}
+
+void SegmentedFile::progress(int index, qint64 offset, qint64 length, qint64 written)
+{
+    if (index >= m_ranges.size())
+        m_ranges.resize(index + 1);
+    m_ranges[index] = { offset, length, written };
+    if (!m_resumable)
+        return;
+
+    auto done = prefix();
+    if (done - m_journaled < journalInterval)
+        return;
+    // it has to be in the file before the journal says so
+    if (!m_file.flush())
+        return;
+#if defined(LAUNCHER_APPLICATION)
+    if (auto journal = DownloadJournal::shared())
+        journal->progressed(m_journal_url, done);
+#endif
+    m_journaled = done;
+}
+
+qint64 SegmentedFile::prefix() const
+{
+    qint64 done = 0;
+    for (auto& range : m_ranges) {
+        if (range.offset != done)
+            break;
+        done += range.written;
+        if (range.length < 0 || range.written < range.length)
+            break;
+    }
+    return done;
+}
+
+Task::State SegmentedFile::segmentDone(int index, QNetworkReply& reply)
+{
+    m_done.insert(index);
+    if (m_done.size() < m_segments)
+        return Task::State::Succeeded;
+
+    if (!validate(reply)) {
+        m_broken = true;
+        m_file.close();
+        m_file.remove();
+        QFile::remove(m_file.fileName() + ".meta");
+        journalPart(false);
+        return Task::State::Failed;
+    }
+
+    m_file.close();
+    QFile::remove(m_file.fileName() + ".meta");
+    if (!FS::move(m_file.fileName(), m_filename)) {
+        qCCritical(taskNetLogC) << "Failed to commit changes to" << m_filename;
+        m_file.remove();
+        journalPart(false);
+        return Task::State::Failed;
+    }
+    m_committed = true;
+    journalPart(false);
+#if defined(LAUNCHER_APPLICATION)
+    if (auto store = ContentStore::shared())
+        store->add(ContentStore::keyFor(m_validators), m_filename);
+#endif
+    return Task::State::Succeeded;
+}
+
+bool SegmentedFile::validate(QNetworkReply& reply)
+{
+    if (m_validators.empty())
+        return true;
+
+    QNetworkRequest request(reply.url());
+    for (auto& validator : m_validators) {
+        if (!validator->init(request))
+            return false;
+    }
+
+    if (!m_file.seek(0))
+        return false;
+    while (!m_file.atEnd()) {
+        auto chunk = m_file.read(validateChunkSize);
+        if (chunk.isEmpty())
+            return false;
+        for (auto& validator : m_validators) {
+            if (!validator->write(chunk))
+                return false;
+        }
+    }
+
+    for (auto& validator : m_validators) {
+        if (!validator->validate(reply))
+            return false;
+    }
+    return true;
+}
+
+SegmentedFileSink::SegmentedFileSink(QString filename, Download* owner, qint64 threshold, int segments)
+    : m_file(std::make_shared<SegmentedFile>(std::move(filename))), m_owner(owner), m_threshold(threshold), m_split_into(segments)
+{}
+
+SegmentedFileSink::SegmentedFileSink(std::shared_ptr<SegmentedFile> file, int index, qint64 offset, qint64 length)
+    : m_file(std::move(file)), m_index(index), m_offset(offset), m_length(length)
+{}
+
+Task::State SegmentedFileSink::init(QNetworkRequest& request)
+{
+    if (m_index == 0) {
+        if (!FS::ensureFilePathExists(m_file->filename())) {
+            qCCritical(taskNetLogC) << "Could not create folder for " + m_file->filename();
+            return Task::State::Failed;
+        }
+        m_file->setValidators(validators);
+#if defined(LAUNCHER_APPLICATION)
+        auto store = ContentStore::shared();
+        if (store && m_file->segments() == 1 && store->materialize(ContentStore::keyFor(validators), m_file->filename()))
+            return Task::State::Succeeded;
+#endif
+        // a range is only worth asking for if something can fetch the rest, once it's split that's our segment
+        if (m_file->segments() == 1)
+            m_length = m_owner && m_owner->canSpawn() && m_threshold > 0 ? m_threshold : -1;
+    }
+
+    m_written = 0;
+    m_discard = false;
+    if (m_length > 0) {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(m_offset) + "-" + QByteArray::number(m_offset + m_length - 1));
+        // ranges of a compressed response wouldn't line up between segments
+        request.setRawHeader("Accept-Encoding", "identity");
+    }
+    return Task::State::Running;
+}
+
+Task::State SegmentedFileSink::headersReceived(QNetworkReply& reply)
+{
+    bool is_http = false;
+    auto status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(&is_http);
+    m_discard = is_http && (status < 200 || status >= 300);
+    if (m_discard)
+        return Task::State::Running;
+
+    if (is_http && status == 206) {
+        qint64 first, last, total;
+        if (!parseContentRange(reply.rawHeader("Content-Range"), first, last, total) || first != m_offset || total < 0) {
+            qCWarning(taskNetLogC) << "Unusable range" << reply.rawHeader("Content-Range") << "for" << m_file->filename();
+            return Task::State::Failed;
+        }
+        if (!m_file->prepare(total))
+            return Task::State::Failed;
+        m_length = last - first + 1;
+        if (m_index == 0)
+            m_file->setResumeToken(resumeToken(reply));
+        if (m_index == 0 && m_owner && m_file->segments() == 1 && total > last + 1)
+            split(last + 1, total);
+        return Task::State::Running;
+    }
+
+    // the server sent the whole file, only fine if nothing else is writing into it
+    if (m_index != 0 || m_file->segments() > 1) {
+        qCWarning(taskNetLogC) << "Server stopped answering range requests for" << m_file->filename();
+        return Task::State::Failed;
+    }
+    m_length = -1;
+    auto size = reply.header(QNetworkRequest::ContentLengthHeader);
+    if (!m_file->prepare(size.isValid() ? size.toLongLong() : -1))
+        return Task::State::Failed;
+    m_file->setResumeToken(resumeToken(reply));
+    return Task::State::Running;
+}
+
+void SegmentedFileSink::split(qint64 from, qint64 total)
+{
+    auto count = std::max(1, m_split_into - 1);
+    auto length = (total - from + count - 1) / count;
+    qCDebug(taskNetLogC) << "Downloading the remaining" << total - from << "bytes of" << m_file->filename() << "in" << count << "segments";
+    for (; from < total; from += length) {
+        auto size = std::min(length, total - from);
+        auto index = m_file->addSegment();
+        m_owner->spawn(std::make_unique<SegmentedFileSink>(m_file, index, from, size));
+    }
+}
+
+Task::State SegmentedFileSink::write(QByteArray& data)
+{
+    if (m_discard)
+        return Task::State::Running;
+    if (m_length >= 0 && m_written + data.size() > m_length) {
+        qCWarning(taskNetLogC) << "Server sent more than the range asked for of" << m_file->filename();
+        return Task::State::Failed;
+    }
+    if (!m_file->write(m_offset + m_written, data))
+        return Task::State::Failed;
+    m_written += data.size();
+    m_file->progress(m_index, m_offset, m_length, m_written);
+    return Task::State::Running;
+}
+
+Task::State SegmentedFileSink::abort()
+{
+    // the part file is shared, it goes away with the last segment
+    return Task::State::Failed;
+}
+
+Task::State SegmentedFileSink::finalize(QNetworkReply& reply)
+{
+    if (m_length >= 0 && m_written != m_length) {
+        qCWarning(taskNetLogC) << "Got" << m_written << "of" << m_length << "bytes at" << m_offset << "of" << m_file->filename();
+        return Task::State::Failed;
+    }
+    return m_file->segmentDone(m_index, reply);
+}
+
+bool SegmentedFileSink::hasLocalData()
+{
+    QFileInfo info(m_file->filename());
+    return info.exists() && info.size() != 0;
+}
+}  // namespace Net
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QFile>
+#include <QSet>
+#include <QVector>
+
+#include <memory>
+
+#include "Sink.h"
+
+namespace Net {
+class Download;
+
+/**
+ * A file being downloaded by several range requests at once, shared by the sinks of all of them.
+ *
+ * Every segment writes at its own offset into `<file>.part`, which has room for the whole file from the start. Once
+ * the last one is done the validators see the whole file, in order, and it's moved in place.
+ *
+ * A journaled file keeps what it got from the start without a gap when it fails, and records that as it goes so a
+ * crash doesn't lose it either. The next attempt continues it as a single stream.
+ */
+class SegmentedFile {
+   public:
+    explicit SegmentedFile(QString filename);
+    ~SegmentedFile();
+
+    [[nodiscard]] QString filename() const { return m_filename; }
+
+    /// open the part file with room for `size` bytes, or whatever gets written when that's negative
+    auto prepare(qint64 size) -> bool;
+    auto write(qint64 offset, const QByteArray& data) -> bool;
+
+    /// record the part file in the download journal under `url`
+    void journalAs(const QString& url) { m_journal_url = url; }
+    /// the If-Range value of the file, what lets a later attempt continue it
+    void setResumeToken(const QByteArray& token);
+    /// segment `index` got `written` bytes of its `length` at `offset`, negative when it's the rest of the file
+    void progress(int index, qint64 offset, qint64 length, qint64 written);
+
+    /// one more segment to wait for, returns its index
+    auto addSegment() -> int { return m_segments++; }
+    [[nodiscard]] int segments() const { return m_segments; }
+    /// the segment got all its data, the last one validates and commits the file
+    auto segmentDone(int index, QNetworkReply& reply) -> Task::State;
+
+    void setValidators(std::vector<std::shared_ptr<Validator>> validators) { m_validators = std::move(validators); }
+
+   private:
+    auto validate(QNetworkReply& reply) -> bool;
+    // how much of the file is there from the start without a gap
+    [[nodiscard]] auto prefix() const -> qint64;
+    // forget about the part file, `keep` says whether it's worth continuing
+    void journalPart(bool keep);
+
+   private:
+    struct Range {
+        qint64 offset = -1;
+        qint64 length = -1;
+        qint64 written = 0;
+    };
+
+    QString m_filename;
+    QFile m_file;
+    QString m_journal_url;
+    bool m_resumable = false;
+    // the segments by index, which is also the order of their offsets
+    QVector<Range> m_ranges;
+    // the prefix the journal knows about
+    qint64 m_journaled = 0;
+    int m_segments = 1;
+    QSet<int> m_done;
+    bool m_committed = false;
+    // validation failed, no point in writing more
+    bool m_broken = false;
+    std::vector<std::shared_ptr<Validator>> m_validators;
+};
+
+/**
+ * Sink of one range of a segmented download.
+ *
+ * The first segment asks for the first `threshold` bytes. If the server answers with a range of a bigger file, the
+ * rest is split into more segments that run in the same NetJob. A server that doesn't do ranges just sends the whole
+ * file to the first one.
+ */
+class SegmentedFileSink : public Sink {
+   public:
+    SegmentedFileSink(QString filename, Download* owner, qint64 threshold, int segments);
+    SegmentedFileSink(std::shared_ptr<SegmentedFile> file, int index, qint64 offset, qint64 length);
+    ~SegmentedFileSink() override = default;
+
+   public:
+    auto init(QNetworkRequest& request) -> Task::State override;
+    auto headersReceived(QNetworkReply& reply) -> Task::State override;
+    auto write(QByteArray& data) -> Task::State override;
+    auto abort() -> Task::State override;
+    auto finalize(QNetworkReply& reply) -> Task::State override;
+
+    auto hasLocalData() -> bool override;
+
+    void journalAs(const QString& url) { m_file->journalAs(url); }
+
+   private:
+    void split(qint64 from, qint64 total);
+
+   private:
+    std::shared_ptr<SegmentedFile> m_file;
+    // where the other segments go, only set for the first one
+    Download* m_owner = nullptr;
+    qint64 m_threshold = 0;
+    int m_split_into = 1;
+
+    int m_index = 0;
+    qint64 m_offset = 0;
+    // -1 when it's the whole file
+    qint64 m_length = -1;
+    qint64 m_written = 0;
+    // the response isn't the file, like a redirect
+    bool m_discard = false;
+};
+}  // namespace Net
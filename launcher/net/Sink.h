@@ -47,11 +47,20 @@ class Sink {
 
    public:
     virtual auto init(QNetworkRequest& request) -> Task::State = 0;
+    // the status and headers of the response are in, called before the first write
+    virtual auto headersReceived(QNetworkReply&) -> Task::State { return Task::State::Running; }
+    // `data` usually points into a recycled read buffer, it's only valid until this returns
     virtual auto write(QByteArray& data) -> Task::State = 0;
+    // optionally, room for the next `size` bytes of the response where they'll end up anyway, so they skip write()
+    // the caller reads into it and reports how much it got with endDirectWrite()
+    virtual auto beginDirectWrite(qint64) -> char* { return nullptr; }
+    virtual auto endDirectWrite(qint64) -> Task::State { return Task::State::Failed; }
     virtual auto abort() -> Task::State = 0;
     virtual auto finalize(QNetworkReply& reply) -> Task::State = 0;
 
     virtual auto hasLocalData() -> bool = 0;
+    // the file this writes into, if it's one, requests with the same one don't run at the same time
+    virtual auto target() const -> QString { return {}; }
 
     void addValidator(Validator* validator)
     {
@@ -59,6 +68,7 @@ class Sink {
             validators.push_back(std::shared_ptr<Validator>(validator));
         }
     }
+    [[nodiscard]] auto getValidators() const -> const std::vector<std::shared_ptr<Validator>>& { return validators; }
 
    protected:
     bool initAllValidators(QNetworkRequest& request)
@@ -0,0 +1,127 @@
+#include "SrvCache.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDnsLookup>
+#include <QJsonObject>
+
+#include <algorithm>
+
+#include "Exception.h"
+#include "Json.h"
+
+namespace {
+// how long a record past its TTL may still be answered with
+constexpr qint64 maxStale = 7 * 24 * 60 * 60;
+// how long a name without a record is remembered, DNS doesn't tell us
+constexpr qint64 negativeTtl = 10 * 60;
+}  // namespace
+
+SrvCache::SrvCache(QString path) : m_path(std::move(path))
+{
+    load();
+}
+
+void SrvCache::resolve(const QString& name, QObject* context, Callback done)
+{
+    auto now = QDateTime::currentSecsSinceEpoch();
+    auto it = m_entries.constFind(name);
+    if (it != m_entries.constEnd() && now - it->expires < maxStale) {
+        if (it->target.isEmpty())
+            done(std::nullopt, {});
+        else
+            done(Record{ it->target, it->port }, {});
+        if (now >= it->expires && !m_waiting.contains(name)) {
+            qDebug() << "Revalidating SRV record" << name;
+            m_waiting.insert(name, {});
+            lookup(name);
+        }
+        return;
+    }
+
+    auto waiting = m_waiting.find(name);
+    if (waiting != m_waiting.end()) {
+        waiting->append({ context, std::move(done) });
+        return;
+    }
+    m_waiting.insert(name, { { context, std::move(done) } });
+    lookup(name);
+}
+
+void SrvCache::lookup(const QString& name)
+{
+    auto dns = new QDnsLookup(QDnsLookup::SRV, name, this);
+    connect(dns, &QDnsLookup::finished, this, [this, dns, name] {
+        dns->deleteLater();
+        auto waiting = m_waiting.take(name);
+        auto now = QDateTime::currentSecsSinceEpoch();
+
+        auto records = dns->serviceRecords();
+        std::optional<Record> record;
+        QString error;
+        if (dns->error() == QDnsLookup::NoError && !records.isEmpty()) {
+            // Qt already sorts them by priority and weight
+            auto const& first = records.first();
+            record = Record{ first.target(), first.port() };
+            m_entries.insert(name, { first.target(), first.port(), now + first.timeToLive() });
+            save();
+        } else if (dns->error() == QDnsLookup::NoError || dns->error() == QDnsLookup::NotFoundError) {
+            m_entries.insert(name, { {}, 0, now + negativeTtl });
+            save();
+        } else {
+            // keep whatever we had, an old answer beats none when DNS is acting up
+            error = dns->errorString();
+            auto it = m_entries.constFind(name);
+            if (it != m_entries.constEnd() && now - it->expires < maxStale && !it->target.isEmpty())
+                record = Record{ it->target, it->port };
+        }
+
+        for (auto const& waiter : waiting) {
+            if (waiter.context)
+                waiter.done(record, record ? QString() : error);
+        }
+    });
+    dns->lookup();
+}
+
+void SrvCache::load()
+{
+    if (m_path.isNull())
+        return;
+
+    try {
+        auto root = Json::requireObject(Json::requireDocument(m_path, "SRV records"));
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+            auto obj = Json::requireObject(it.value());
+            m_entries.insert(it.key(), { Json::ensureString(obj, "target"), static_cast<quint16>(Json::ensureInteger(obj, "port")),
+                                         static_cast<qint64>(Json::ensureDouble(obj, "expires")) });
+        }
+    } catch ([[maybe_unused]] const Exception& e) {
+        // there's none the first time
+        m_entries.clear();
+    }
+}
+
+void SrvCache::save()
+{
+    if (m_path.isNull())
+        return;
+
+    auto now = QDateTime::currentSecsSinceEpoch();
+    QJsonObject root;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (now - it->expires >= maxStale)
+            continue;
+        QJsonObject obj;
+        obj.insert("target", it->target);
+        obj.insert("port", int(it->port));
+        obj.insert("expires", double(it->expires));
+        root.insert(it.key(), obj);
+    }
+
+    try {
+        Json::write(root, m_path);
+    } catch (const Exception& e) {
+        qWarning() << "Failed to write SRV records:" << e.cause();
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <functional>
+#include <optional>
+
+/**
+ * Resolves SRV records for the whole launcher, keeping them across sessions for as long as their TTL says.
+ *
+ * Joining a server on launch asked DNS for its `_minecraft._tcp` record every time, which took a noticeable moment
+ * and failed outright when DNS was flaky. A record past its TTL is still answered with right away, and looked up again
+ * in the background for the next time, unless it's been expired for longer than a week. Names without a record are
+ * remembered for a while too, since most servers don't have one.
+ */
+class SrvCache : public QObject {
+    Q_OBJECT
+   public:
+    struct Record {
+        QString target;
+        quint16 port = 0;
+    };
+    /// the record, or nothing if the name has none or it couldn't be looked up, in which case the error says why
+    using Callback = std::function<void(std::optional<Record> record, const QString& error)>;
+
+    // supply path to the file keeping the records
+    explicit SrvCache(QString path = QString());
+
+    /// resolve the SRV record `name`, calling `done` with it unless `context` is gone by then
+    void resolve(const QString& name, QObject* context, Callback done);
+
+   private:
+    struct Entry {
+        // empty when the name has no record
+        QString target;
+        quint16 port = 0;
+        // in seconds since epoch
+        qint64 expires = 0;
+    };
+    struct Waiting {
+        QPointer<QObject> context;
+        Callback done;
+    };
+
+    void lookup(const QString& name);
+    void load();
+    void save();
+
+   private:
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+    // lookups in flight, with who waits on each
+    QHash<QString, QList<Waiting>> m_waiting;
+};
@@ -0,0 +1,143 @@
+#include "UpstreamCache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+
+#include <algorithm>
+
+#if defined(LAUNCHER_APPLICATION)
+#include "Application.h"
+#endif
+
+namespace Net {
+
+namespace {
+// failures in a row until a cache is considered down
+const int failuresUntilDown = 3;
+// the wait doubles up to this many times
+const int maxBackoffSteps = 5;
+
+QString asBase(QString base)
+{
+    if (!base.endsWith('/'))
+        base += '/';
+    return base;
+}
+}  // namespace
+
+UpstreamCache::UpstreamCache(std::chrono::milliseconds cooldown) : m_cooldown(cooldown) {}
+
+UpstreamCache& UpstreamCache::shared()
+{
+    static UpstreamCache s_shared;
+#if defined(LAUNCHER_APPLICATION)
+    if (auto app = qobject_cast<Application*>(QCoreApplication::instance()); app && app->settings())
+        s_shared.setRules(app->settings()->get("DownloadCacheRules").toString());
+#endif
+    return s_shared;
+}
+
+void UpstreamCache::setRules(const QString& text)
+{
+    QMutexLocker locker(&m_lock);
+    if (text == m_text)
+        return;
+    m_text = text;
+    m_rules.clear();
+    m_any_host.clear();
+    m_health.clear();
+
+    for (auto const& line : text.split('\n')) {
+        auto parts = line.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() != 2) {
+            if (!parts.isEmpty())
+                qWarning() << "Ignoring download cache rule" << line;
+            continue;
+        }
+        if (parts[0] == "*") {
+            m_any_host = asBase(parts[1]);
+            continue;
+        }
+        QUrl from(parts[0]);
+        if (!from.isValid() || from.host().isEmpty()) {
+            qWarning() << "Ignoring download cache rule" << line;
+            continue;
+        }
+        m_rules[from.host()].append({ asBase(parts[0]), asBase(parts[1]) });
+    }
+    for (auto& rules : m_rules)
+        std::sort(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) { return a.from.size() > b.from.size(); });
+}
+
+std::optional<QUrl> UpstreamCache::rewrite(const QUrl& url)
+{
+    QMutexLocker locker(&m_lock);
+    auto str = url.toString();
+    QString to;
+    QString path;
+    for (auto const& rule : m_rules.value(url.host())) {
+        if (str.startsWith(rule.from)) {
+            to = rule.to;
+            path = str.mid(rule.from.size());
+            break;
+        }
+    }
+    if (to.isEmpty() && !m_any_host.isEmpty() && (url.scheme() == "https" || url.scheme() == "http")) {
+        to = m_any_host;
+        // "//host/path?query"
+        path = url.toString(QUrl::RemoveScheme | QUrl::RemoveUserInfo).mid(2);
+    }
+    if (to.isEmpty())
+        return std::nullopt;
+
+    auto it = m_health.find(to);
+    if (it != m_health.end() && it->failures >= failuresUntilDown) {
+        auto now = std::chrono::steady_clock::now();
+        if (now < it->down_until)
+            return std::nullopt;
+        // this one checks whether it's back, the others keep going to the origin meanwhile
+        it->down_until = now + m_cooldown;
+    }
+    return QUrl(to + path);
+}
+
+QString UpstreamCache::cacheBaseOf(const QUrl& cached) const
+{
+    auto str = cached.toString();
+    if (!m_any_host.isEmpty() && str.startsWith(m_any_host))
+        return m_any_host;
+    for (auto const& rules : m_rules) {
+        for (auto const& rule : rules) {
+            if (str.startsWith(rule.to))
+                return rule.to;
+        }
+    }
+    return {};
+}
+
+void UpstreamCache::reportSuccess(const QUrl& cached)
+{
+    QMutexLocker locker(&m_lock);
+    if (auto base = cacheBaseOf(cached); !base.isEmpty())
+        m_health.remove(base);
+}
+
+void UpstreamCache::reportFailure(const QUrl& cached)
+{
+    QMutexLocker locker(&m_lock);
+    auto base = cacheBaseOf(cached);
+    if (base.isEmpty())
+        return;
+    auto& health = m_health[base];
+    health.failures++;
+    if (health.failures < failuresUntilDown)
+        return;
+    auto steps = std::min(health.failures - failuresUntilDown, maxBackoffSteps);
+    auto wait = m_cooldown * (1 << steps);
+    health.down_until = std::chrono::steady_clock::now() + wait;
+    qWarning() << "Download cache" << base << "is down, going to the origin for" << wait.count() << "ms";
+}
+
+}  // namespace Net
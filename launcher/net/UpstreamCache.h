@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+
+#include <chrono>
+#include <optional>
+
+namespace Net {
+
+/**
+ * Site-local pull-through caches that downloads go through before the origin.
+ *
+ * The "DownloadCacheRules" setting holds one rule per line, an origin base and the base of the cache that serves it,
+ * separated by a space. A rule for `*` sends every host through a cache that takes the origin host as its first path
+ * segment, like most pull-through proxies do. The rules are compiled once per version of the setting.
+ *
+ * A cache that fails a few requests in a row is left alone for a while, and those go to the origin directly. Once that
+ * while is over the next request checks on it, and every failure after that doubles the wait. A request the cache
+ * doesn't answer goes on to the origin, so a cache going down only ever costs a try.
+ *
+ * Only the URL that's requested changes, the metacache keeps entries by their origin so they stay valid without it.
+ */
+class UpstreamCache {
+   public:
+    explicit UpstreamCache(std::chrono::milliseconds cooldown = std::chrono::seconds(30));
+
+    /// the one downloads use, with the rules from the settings
+    static UpstreamCache& shared();
+
+    /// replace the rules, does nothing when they're the same text as the last ones
+    void setRules(const QString& text);
+
+    /// `url` on the cache of its rule, or nothing if it has none or that cache is down for now
+    std::optional<QUrl> rewrite(const QUrl& url);
+
+    /// how a request that went to `cached` fared, a failure being the cache not answering rather than a 404
+    void reportSuccess(const QUrl& cached);
+    void reportFailure(const QUrl& cached);
+
+   private:
+    struct Rule {
+        QString from;
+        QString to;
+    };
+    struct Health {
+        int failures = 0;
+        std::chrono::steady_clock::time_point down_until;
+    };
+
+    // the base of the cache `cached` went to
+    QString cacheBaseOf(const QUrl& cached) const;
+
+   private:
+    std::chrono::milliseconds m_cooldown;
+    QMutex m_lock;
+    QString m_text;
+    // by origin host, the longest base first
+    QHash<QString, QList<Rule>> m_rules;
+    QString m_any_host;
+    QHash<QString, Health> m_health;
+};
+
+}  // namespace Net
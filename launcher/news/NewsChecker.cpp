@@ -39,11 +39,38 @@
 #include <QDomDocument>
 
 #include <QDebug>
+#include <QFileInfo>
 
-NewsChecker::NewsChecker(shared_qobject_ptr<QNetworkAccessManager> network, const QString& feedUrl)
+#include "FileSystem.h"
+
+NewsChecker::NewsChecker(shared_qobject_ptr<QNetworkAccessManager> network, const QString& feedUrl, shared_qobject_ptr<HttpMetaCache> cache)
 {
     m_network = network;
     m_feedUrl = feedUrl;
+    m_cache = cache;
+}
+
+bool NewsChecker::loadCachedNews()
+{
+    if (!m_cache)
+        return false;
+    auto entry = m_cache->getEntry("general", "news.xml");
+    if (!entry || !QFileInfo::exists(entry->getFullPath()))
+        return false;
+
+    QString errorMsg;
+    try {
+        if (!readFeed(FS::read(entry->getFullPath()), errorMsg)) {
+            qWarning() << "Couldn't read the cached news:" << errorMsg;
+            return false;
+        }
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't read the cached news:" << e.cause();
+        return false;
+    }
+    qDebug() << "Loaded the cached news.";
+    emit newsLoaded();
+    return true;
 }
 
 void NewsChecker::reloadNews()
@@ -57,7 +84,14 @@ void NewsChecker::reloadNews()
     qDebug() << "Reloading news.";
 
     NetJob::Ptr job{ new NetJob("News RSS Feed", m_network) };
-    job->addNetAction(Net::Download::makeByteArray(m_feedUrl, newsData));
+    if (m_cache) {
+        // revalidated, so a feed that didn't change isn't downloaded again
+        m_cacheEntry = m_cache->resolveEntry("general", "news.xml");
+        m_cacheEntry->setStale(true);
+        job->addNetAction(Net::Download::makeCached(m_feedUrl, m_cacheEntry));
+    } else {
+        job->addNetAction(Net::Download::makeByteArray(m_feedUrl, newsData));
+    }
     QObject::connect(job.get(), &NetJob::succeeded, this, &NewsChecker::rssDownloadFinished);
     QObject::connect(job.get(), &NetJob::failed, this, &NewsChecker::rssDownloadFailed);
     m_newsNetJob.reset(job);
@@ -70,21 +104,44 @@ void NewsChecker::rssDownloadFinished()
     qDebug() << "Finished loading RSS feed.";
 
     m_newsNetJob.reset();
+    QByteArray data;
+    if (m_cacheEntry) {
+        auto entry = std::move(m_cacheEntry);
+        m_cacheEntry.reset();
+        try {
+            data = FS::read(entry->getFullPath());
+        } catch (const Exception& e) {
+            fail(e.cause());
+            return;
+        }
+    } else {
+        data = std::move(*newsData);
+        newsData->clear();
+    }
+
+    QString errorMsg;
+    if (!readFeed(data, errorMsg)) {
+        fail(errorMsg);
+        return;
+    }
+
+    succeed();
+}
+
+bool NewsChecker::readFeed(const QByteArray& data, QString& errorMsg)
+{
     QDomDocument doc;
     {
         // Stuff to store error info in.
-        QString errorMsg = "Unknown error.";
+        QString parseErrorMsg = "Unknown error.";
         int errorLine = -1;
         int errorCol = -1;
 
         // Parse the XML.
-        if (!doc.setContent(*newsData, false, &errorMsg, &errorLine, &errorCol)) {
-            QString fullErrorMsg = QString("Error parsing RSS feed XML. %1 at %2:%3.").arg(errorMsg).arg(errorLine).arg(errorCol);
-            fail(fullErrorMsg);
-            newsData->clear();
-            return;
+        if (!doc.setContent(data, false, &parseErrorMsg, &errorLine, &errorCol)) {
+            errorMsg = QString("Error parsing RSS feed XML. %1 at %2:%3.").arg(parseErrorMsg).arg(errorLine).arg(errorCol);
+            return false;
         }
-        newsData->clear();
     }
 
     // If the parsing succeeded, read it.
@@ -94,16 +151,15 @@ void NewsChecker::rssDownloadFinished()
         QDomElement element = items.at(i).toElement();
         NewsEntryPtr entry;
         entry.reset(new NewsEntry());
-        QString errorMsg = "An unknown error occurred.";
-        if (NewsEntry::fromXmlElement(element, entry.get(), &errorMsg)) {
+        QString entryErrorMsg = "An unknown error occurred.";
+        if (NewsEntry::fromXmlElement(element, entry.get(), &entryErrorMsg)) {
             qDebug() << "Loaded news entry" << entry->title;
             m_newsEntries.append(entry);
         } else {
-            qWarning() << "Failed to load news entry at index" << i << ":" << errorMsg;
+            qWarning() << "Failed to load news entry at index" << i << ":" << entryErrorMsg;
         }
     }
-
-    succeed();
+    return true;
 }
 
 void NewsChecker::rssDownloadFailed(QString reason)
@@ -19,6 +19,7 @@
 #include <QObject>
 #include <QString>
 
+#include <net/HttpMetaCache.h>
 #include <net/NetJob.h>
 
 #include "NewsEntry.h"
@@ -28,8 +29,11 @@ class NewsChecker : public QObject {
    public:
     /*!
      * Constructs a news reader to read from the given RSS feed URL.
+     * With a cache, the feed is kept there and only downloaded again when it changed.
      */
-    NewsChecker(shared_qobject_ptr<QNetworkAccessManager> network, const QString& feedUrl);
+    NewsChecker(shared_qobject_ptr<QNetworkAccessManager> network,
+                const QString& feedUrl,
+                shared_qobject_ptr<HttpMetaCache> cache = {});
 
     /*!
      * Returns the error message for the last time the news was loaded.
@@ -56,6 +60,12 @@ class NewsChecker : public QObject {
      */
     void Q_SLOT reloadNews();
 
+    /*!
+     * Loads the news from the feed kept in the cache, if there's one.
+     * Returns true if there was.
+     */
+    bool loadCachedNews();
+
    signals:
     /*!
      * Signal fired after the news has finished loading.
@@ -93,6 +103,11 @@ class NewsChecker : public QObject {
     QString m_lastLoadError;
 
     shared_qobject_ptr<QNetworkAccessManager> m_network;
+    shared_qobject_ptr<HttpMetaCache> m_cache;
+    MetaEntryPtr m_cacheEntry;
+
+    //! Reads the entries of the feed, returns false with the reason in `errorMsg` if it can't.
+    bool readFeed(const QByteArray& data, QString& errorMsg);
 
    protected slots:
     /// Emits newsLoaded() and sets m_lastLoadError to empty string.
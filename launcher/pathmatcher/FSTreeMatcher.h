@@ -11,5 +11,14 @@ class FSTreeMatcher : public IPathMatcher {
 
     bool matches(const QString& string) const override { return m_fsTree.covers(string); }
 
+    std::optional<bool> matchesSubtree(const QString& dir) const override
+    {
+        if (m_fsTree.covers(dir))
+            return true;
+        if (m_fsTree.exists(dir))
+            return std::nullopt;
+        return false;
+    }
+
     SeparatorPrefixTree<'/'>& m_fsTree;
 };
@@ -1,6 +1,7 @@
 #pragma once
 #include <QString>
 #include <memory>
+#include <optional>
 
 class IPathMatcher {
    public:
@@ -9,4 +10,8 @@ class IPathMatcher {
    public:
     virtual ~IPathMatcher() {}
     virtual bool matches(const QString& string) const = 0;
+
+    /// whether every path below the directory `dir` matches (true) or none does (false), or nothing if it depends on the path.
+    /// Walkers ask this once per directory and skip asking about what is below when it's decided.
+    virtual std::optional<bool> matchesSubtree([[maybe_unused]] const QString& dir) const { return std::nullopt; }
 };
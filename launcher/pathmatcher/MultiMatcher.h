@@ -1,19 +1,56 @@
+#pragma once
+
 #include <SeparatorPrefixTree.h>
+#include <QList>
 #include <QRegularExpression>
+#include <QSet>
+#include <QStringList>
 #include "IPathMatcher.h"
+#include "RegexpMatcher.h"
+#include "SimplePrefixMatcher.h"
 
+/**
+ * Matches what any of the added matchers matches.
+ *
+ * Copies and exports ask this for every file of an instance, so the added rules aren't asked one after the other:
+ * prefixes go into one tree and exact paths into a set, and regular expressions with the same options become a single
+ * alternation. Only other kinds of matchers are still asked in turn.
+ */
 class MultiMatcher : public IPathMatcher {
    public:
     virtual ~MultiMatcher(){};
     MultiMatcher() {}
     MultiMatcher& add(Ptr add)
     {
+        if (auto prefix = std::dynamic_pointer_cast<SimplePrefixMatcher>(add)) {
+            if (prefix->m_isPrefix) {
+                m_prefixes.insert(prefix->m_prefix.chopped(1));
+                m_hasPrefixes = true;
+            } else {
+                m_exact.insert(prefix->m_prefix);
+            }
+            return *this;
+        }
+        if (auto regexp = std::dynamic_pointer_cast<RegexpMatcher>(add); regexp && mergeRegexp(*regexp))
+            return *this;
         m_matchers.append(add);
         return *this;
     }
 
     virtual bool matches(const QString& string) const override
     {
+        if (m_exact.contains(string))
+            return true;
+        if (m_hasPrefixes) {
+            // the rule itself is a directory, so only what is below it matches
+            auto cover = m_prefixes.cover(string);
+            if (!cover.isNull() && cover.size() < string.size())
+                return true;
+        }
+        for (auto& alternation : m_alternations) {
+            if (alternation.matches(string))
+                return true;
+        }
         for (auto iter : m_matchers) {
             if (iter->matches(string)) {
                 return true;
@@ -22,5 +59,76 @@ class MultiMatcher : public IPathMatcher {
         return false;
     }
 
+    std::optional<bool> matchesSubtree(const QString& dir) const override
+    {
+        if (m_hasPrefixes && !m_prefixes.cover(dir).isNull())
+            return true;
+
+        bool undecided = !m_alternations.isEmpty() || (m_hasPrefixes && m_prefixes.exists(dir));
+        auto below = dir + '/';
+        for (auto& exact : m_exact) {
+            if (exact.startsWith(below)) {
+                undecided = true;
+                break;
+            }
+        }
+        for (auto iter : m_matchers) {
+            auto decided = iter->matchesSubtree(dir);
+            if (!decided)
+                undecided = true;
+            else if (*decided)
+                return true;
+        }
+        if (undecided)
+            return std::nullopt;
+        return false;
+    }
+
+   private:
+    struct Alternation {
+        QRegularExpression regexp;
+        QStringList patterns;
+        bool onlyFilenamePart;
+
+        bool matches(const QString& string) const
+        {
+            if (onlyFilenamePart) {
+                auto slash = string.lastIndexOf('/');
+                if (slash != -1)
+                    return regexp.match(string.mid(slash + 1)).hasMatch();
+            }
+            return regexp.match(string).hasMatch();
+        }
+    };
+
+    bool mergeRegexp(const RegexpMatcher& matcher)
+    {
+        // groups and back references are numbered or named across the whole alternation, those can't share it
+        static const QRegularExpression s_unmergeable(R"(\\[1-9gk]|\(\?(P|<[^=!]|'|\||R|[0-9+-]))");
+        auto pattern = matcher.m_regexp.pattern();
+        if (!matcher.m_regexp.isValid() || pattern.contains(s_unmergeable))
+            return false;
+
+        auto options = matcher.m_regexp.patternOptions();
+        auto branch = "(?:" + pattern + ")";
+        for (auto& alternation : m_alternations) {
+            if (alternation.onlyFilenamePart != matcher.m_onlyFilenamePart || alternation.regexp.patternOptions() != options)
+                continue;
+            alternation.patterns.append(branch);
+            alternation.regexp.setPattern(alternation.patterns.join('|'));
+            alternation.regexp.optimize();
+            return true;
+        }
+        Alternation alternation{ QRegularExpression(branch, options), { branch }, matcher.m_onlyFilenamePart };
+        alternation.regexp.optimize();
+        m_alternations.append(alternation);
+        return true;
+    }
+
+   private:
+    SeparatorPrefixTree<'/'> m_prefixes;
+    bool m_hasPrefixes = false;
+    QSet<QString> m_exact;
+    QList<Alternation> m_alternations;
     QList<Ptr> m_matchers;
 };
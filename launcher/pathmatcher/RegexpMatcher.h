@@ -1,3 +1,5 @@
+#pragma once
+
 #include <QRegularExpression>
 #include "IPathMatcher.h"
 
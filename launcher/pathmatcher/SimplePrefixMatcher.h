@@ -2,6 +2,8 @@
 //
 // SPDX-License-Identifier: GPL-3.0-only
 
+#pragma once
+
 #include <QRegularExpression>
 #include "IPathMatcher.h"
 
@@ -20,6 +22,16 @@ class SimplePrefixMatcher : public IPathMatcher {
             return string.startsWith(m_prefix);
         return string == m_prefix;
     }
+
+    std::optional<bool> matchesSubtree(const QString& dir) const override
+    {
+        auto below = dir + '/';
+        if (m_isPrefix && below.startsWith(m_prefix))
+            return true;
+        if (m_prefix.startsWith(below))
+            return std::nullopt;
+        return false;
+    }
     QString m_prefix;
     bool m_isPrefix = false;
 };
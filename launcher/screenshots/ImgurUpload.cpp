@@ -37,11 +37,16 @@
 #include "ImgurUpload.h"
 #include "BuildConfig.h"
 #include "net/StaticHeaderProxy.h"
+#include "tasks/Executor.h"
 
+#include <QBuffer>
 #include <QDebug>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QHttpMultiPart>
 #include <QHttpPart>
+#include <QImageReader>
+#include <QImageWriter>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkRequest>
@@ -56,19 +61,74 @@ void ImgurUpload::init()
     addHeaderProxy(api_headers);
 }
 
-QNetworkReply* ImgurUpload::getReply(QNetworkRequest& request)
+QByteArray ImgurUpload::prepare(const QString& path, Preparation preparation)
+{
+    QImageReader reader(path);
+    auto size = reader.size();
+    bool downscale = preparation.maxSize > 0 && size.isValid() && std::max(size.width(), size.height()) > preparation.maxSize;
+    if (!downscale && !preparation.recompress)
+        return {};
+
+    auto image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Couldn't read" << path << "to prepare it for upload:" << reader.errorString();
+        return {};
+    }
+    if (downscale)
+        image = image.scaled(preparation.maxSize, preparation.maxSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+    QByteArray out;
+    QBuffer buffer(&out);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, "png");
+    // for PNG that's the compression level, the image stays the same
+    writer.setQuality(0);
+    if (!writer.write(image))
+        return {};
+    if (!downscale && out.size() >= QFileInfo(path).size())
+        return {};
+    return out;
+}
+
+void ImgurUpload::executeTask()
 {
-    auto file = new QFile(m_fileInfo.absoluteFilePath());
+    if (m_prepared || (m_preparation.maxSize <= 0 && !m_preparation.recompress)) {
+        NetRequest::executeTask();
+        return;
+    }
 
-    if (!file->open(QFile::ReadOnly)) {
+    setStatus(tr("Preparing %1").arg(m_fileInfo.fileName()));
+    auto watcher = new QFutureWatcher<QByteArray>(this);
+    connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        m_prepared = true;
+        m_data = watcher->result();
+        if (isRunning())
+            NetRequest::executeTask();
+    });
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Interactive,
+                                                 [path = m_fileInfo.absoluteFilePath(), preparation = m_preparation] {
+                                                     return prepare(path, preparation);
+                                                 }));
+}
+
+QNetworkReply* ImgurUpload::getReply(QNetworkRequest& request)
+{
+    QHttpMultiPart* multipart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
+    QIODevice* body;
+    if (!m_data.isEmpty()) {
+        body = new QBuffer(&m_data, multipart);
+    } else {
+        body = new QFile(m_fileInfo.absoluteFilePath(), multipart);
+    }
+    if (!body->open(QIODevice::ReadOnly)) {
+        delete multipart;
         emitFailed();
         return nullptr;
     }
 
-    QHttpMultiPart* multipart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
-    file->setParent(multipart);
     QHttpPart filePart;
-    filePart.setBodyDevice(file);
+    filePart.setBodyDevice(body);
     filePart.setHeader(QNetworkRequest::ContentTypeHeader, "image/png");
     filePart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"image\"");
     multipart->append(filePart);
@@ -80,6 +140,13 @@ QNetworkReply* ImgurUpload::getReply(QNetworkRequest& request)
     namePart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"name\"");
     namePart.setBody(m_fileInfo.baseName().toUtf8());
     multipart->append(namePart);
+    // anonymous albums go by their delete hash
+    if (m_album && !m_album->deleteHash.isEmpty()) {
+        QHttpPart albumPart;
+        albumPart.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"album\"");
+        albumPart.setBody(m_album->deleteHash.toUtf8());
+        multipart->append(albumPart);
+    }
 
     return m_network->post(request, multipart);
 };
@@ -121,9 +188,9 @@ auto ImgurUpload::Sink::finalize(QNetworkReply&) -> Task::State
     return Task::State::Succeeded;
 }
 
-Net::NetRequest::Ptr ImgurUpload::make(ScreenShot::Ptr m_shot)
+Net::NetRequest::Ptr ImgurUpload::make(ScreenShot::Ptr m_shot, std::shared_ptr<ImgurAlbumCreation::Result> album, Preparation preparation)
 {
-    auto up = makeShared<ImgurUpload>(m_shot->m_file);
+    auto up = makeShared<ImgurUpload>(m_shot->m_file, album, preparation);
     up->m_url = std::move(BuildConfig.IMGUR_BASE_URL + "upload.json");
     up->m_sink.reset(new Sink(m_shot));
     return up;
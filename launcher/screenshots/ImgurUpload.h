@@ -36,6 +36,7 @@
 #pragma once
 
 #include <QFileInfo>
+#include "ImgurAlbumCreation.h"
 #include "Screenshot.h"
 #include "net/NetRequest.h"
 
@@ -57,14 +58,36 @@ class ImgurUpload : public Net::NetRequest {
         ScreenShot::Ptr m_shot;
         QByteArray m_output;
     };
-    ImgurUpload(QFileInfo info) : m_fileInfo(info) {}
+    /// what's done to a screenshot before it's sent, on a worker thread
+    struct Preparation {
+        /// the longest side it's scaled down to, 0 to keep its size
+        int maxSize = 0;
+        /// whether it's compressed again as tightly as PNG goes, it's kept like it is when that isn't smaller
+        bool recompress = false;
+    };
+
+    ImgurUpload(QFileInfo info, std::shared_ptr<ImgurAlbumCreation::Result> album, Preparation preparation)
+        : m_fileInfo(info), m_album(album), m_preparation(preparation)
+    {}
     virtual ~ImgurUpload() = default;
 
-    static NetRequest::Ptr make(ScreenShot::Ptr m_shot);
+    /// the screenshot goes into `album` as soon as it's up, when that was created already
+    static NetRequest::Ptr make(ScreenShot::Ptr m_shot,
+                                std::shared_ptr<ImgurAlbumCreation::Result> album = {},
+                                Preparation preparation = {});
 
     void init() override;
 
+    /// the image as it's sent, empty when the file is sent like it is
+    static QByteArray prepare(const QString& path, Preparation preparation);
+
+    void executeTask() override;
+
    private:
     virtual QNetworkReply* getReply(QNetworkRequest&) override;
     const QFileInfo m_fileInfo;
+    std::shared_ptr<ImgurAlbumCreation::Result> m_album;
+    const Preparation m_preparation;
+    bool m_prepared = false;
+    QByteArray m_data;
 };
@@ -0,0 +1,376 @@
+#include "ScreenshotList.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QHash>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QMimeData>
+#include <QUrl>
+
+#include <algorithm>
+
+#include "Exception.h"
+#include "FileSystem.h"
+#include "Json.h"
+#include "filewatch/FileChangeBus.h"
+#include "tasks/Executor.h"
+
+// how many rows the view gets at a time, a few screens full
+static constexpr int pageSize = 500;
+
+ScreenshotList::ScreenshotList(QString folder, QString indexFile, QObject* parent)
+    : QAbstractListModel(parent), m_folder(std::move(folder)), m_indexFile(std::move(indexFile))
+{
+    connect(&m_scan, &QFutureWatcher<Entries>::finished, this, &ScreenshotList::scanned);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::VeryCoarseTimer);
+    m_saveTimer.setInterval(10000);
+    connect(&m_saveTimer, &QTimer::timeout, this, &ScreenshotList::saveIndex);
+}
+
+ScreenshotList::~ScreenshotList()
+{
+    // a scan still running only uses copies, it finishes on its own
+    m_scan.disconnect(this);
+    if (m_saveTimer.isActive())
+        saveIndex();
+}
+
+void ScreenshotList::load()
+{
+    if (m_loaded)
+        return;
+    m_loaded = true;
+    loadIndex();
+    m_watch = FileChangeBus::instance()->subscribe({ m_folder }, 250, this);
+    connect(m_watch, &FileChangeSubscription::changed, this, &ScreenshotList::update);
+    update();
+}
+
+void ScreenshotList::update()
+{
+    if (m_scan.isRunning()) {
+        m_scanAgain = true;
+        return;
+    }
+    m_scan.setFuture(Executor::instance()->run(Executor::Priority::Background,
+                                               [folder = m_folder, known = m_entries] { return scan(folder, known); }));
+}
+
+bool ScreenshotList::before(const QString& a, const QString& b)
+{
+    int order = QString::compare(a, b, Qt::CaseInsensitive);
+    return order != 0 ? order < 0 : a < b;
+}
+
+ScreenshotList::Entries ScreenshotList::scan(const QString& folder, const Entries& known)
+{
+    QHash<QString, int> knownAt;
+    knownAt.reserve(known.size());
+    for (int i = 0; i < known.size(); i++)
+        knownAt.insert(known[i].name, i);
+
+    Entries entries;
+    entries.reserve(known.size());
+    QDirIterator it(folder, { "*.png" }, QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        Entry entry;
+        entry.name = info.fileName();
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        auto at = knownAt.constFind(entry.name);
+        if (at != knownAt.constEnd() && known[*at].size == entry.size && known[*at].modified == entry.modified) {
+            entry.dimensions = known[*at].dimensions;
+        } else {
+            // only reads the header
+            entry.dimensions = QImageReader(info.absoluteFilePath()).size();
+        }
+        entries.append(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return before(a.name, b.name); });
+    return entries;
+}
+
+void ScreenshotList::scanned()
+{
+    apply(m_scan.result());
+    if (m_scanAgain) {
+        m_scanAgain = false;
+        update();
+    }
+}
+
+void ScreenshotList::apply(const Entries& current)
+{
+    if (m_entries.isEmpty()) {
+        if (current.isEmpty())
+            return;
+        beginResetModel();
+        m_entries = current;
+        m_fetched = std::min(pageSize, int(m_entries.size()));
+        endResetModel();
+        m_saveTimer.start();
+        return;
+    }
+
+    // both are sorted, so walking them side by side finds what was added, removed and changed
+    bool changed = false;
+    int i = 0;
+    int j = 0;
+    while (i < m_entries.size() || j < current.size()) {
+        if (j == current.size() || (i < m_entries.size() && before(m_entries[i].name, current[j].name))) {
+            int count = 1;
+            while (i + count < m_entries.size() && (j == current.size() || before(m_entries[i + count].name, current[j].name)))
+                count++;
+            removeEntries(i, count);
+            changed = true;
+            continue;
+        }
+        if (i == m_entries.size() || before(current[j].name, m_entries[i].name)) {
+            int count = 1;
+            while (j + count < current.size() && (i == m_entries.size() || before(current[j + count].name, m_entries[i].name)))
+                count++;
+            insertEntries(i, current.mid(j, count));
+            i += count;
+            j += count;
+            changed = true;
+            continue;
+        }
+        auto& entry = m_entries[i];
+        if (entry.size != current[j].size || entry.modified != current[j].modified) {
+            entry = current[j];
+            emit fileChanged(FS::PathCombine(m_folder, entry.name));
+            if (i < m_fetched)
+                emit dataChanged(index(i), index(i));
+            changed = true;
+        }
+        i++;
+        j++;
+    }
+    if (changed)
+        m_saveTimer.start();
+}
+
+void ScreenshotList::insertEntries(int at, const Entries& entries)
+{
+    // past what the view has, they're fetched along with the rest, unless the view has everything
+    bool shown = at < m_fetched || m_fetched == m_entries.size();
+    if (shown)
+        beginInsertRows(QModelIndex(), at, at + entries.size() - 1);
+    m_entries = m_entries.mid(0, at) + entries + m_entries.mid(at);
+    if (shown) {
+        m_fetched += entries.size();
+        endInsertRows();
+    }
+}
+
+void ScreenshotList::removeEntries(int at, int count)
+{
+    for (int i = at; i < at + count; i++)
+        emit fileChanged(FS::PathCombine(m_folder, m_entries[i].name));
+    int shown = std::min(at + count, m_fetched) - at;
+    if (shown > 0)
+        beginRemoveRows(QModelIndex(), at, at + shown - 1);
+    m_entries.remove(at, count);
+    if (shown > 0) {
+        m_fetched -= shown;
+        endRemoveRows();
+    }
+}
+
+QString ScreenshotList::filePath(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() >= m_fetched)
+        return {};
+    return FS::PathCombine(m_folder, m_entries[index.row()].name);
+}
+
+QFileInfo ScreenshotList::fileInfo(const QModelIndex& index) const
+{
+    return QFileInfo(filePath(index));
+}
+
+QModelIndex ScreenshotList::indexOf(const QString& path) const
+{
+    QFileInfo info(path);
+    if (QDir(info.absolutePath()) != QDir(m_folder))
+        return {};
+    auto name = info.fileName();
+    auto end = m_entries.begin() + m_fetched;
+    auto it =
+        std::lower_bound(m_entries.begin(), end, name, [](const Entry& entry, const QString& name) { return before(entry.name, name); });
+    if (it == end || it->name != name)
+        return {};
+    return index(it - m_entries.begin());
+}
+
+int ScreenshotList::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_fetched;
+}
+
+QVariant ScreenshotList::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_fetched)
+        return {};
+    auto& entry = m_entries[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole: {
+            auto name = entry.name;
+            if (name.endsWith(".png", Qt::CaseInsensitive))
+                name.chop(4);
+            return name;
+        }
+        case Qt::ToolTipRole: {
+            auto size = QLocale().formattedDataSize(entry.size);
+            if (!entry.dimensions.isValid())
+                return size;
+            return tr("%1 x %2, %3").arg(entry.dimensions.width()).arg(entry.dimensions.height()).arg(size);
+        }
+        case FilePathRole:
+            return FS::PathCombine(m_folder, entry.name);
+        case SizeRole:
+            return entry.size;
+        case ModifiedRole:
+            return QDateTime::fromMSecsSinceEpoch(entry.modified);
+        case DimensionsRole:
+            return entry.dimensions;
+        default:
+            return {};
+    }
+}
+
+bool ScreenshotList::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid() || index.row() >= m_fetched)
+        return false;
+    auto name = value.toString() + ".png";
+    auto entry = m_entries[index.row()];
+    if (name == entry.name)
+        return true;
+    if (value.toString().isEmpty() || name.contains('/') || name.contains('\\'))
+        return false;
+    if (!QFile::rename(FS::PathCombine(m_folder, entry.name), FS::PathCombine(m_folder, name)))
+        return false;
+
+    // moved to where the new name goes, the scan after the rename then finds nothing to do
+    removeEntries(index.row(), 1);
+    entry.name = name;
+    auto at = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                               [](const Entry& other, const QString& name) { return before(other.name, name); });
+    insertEntries(at - m_entries.begin(), { entry });
+    m_saveTimer.start();
+    return true;
+}
+
+Qt::ItemFlags ScreenshotList::flags(const QModelIndex& index) const
+{
+    auto flags = QAbstractListModel::flags(index);
+    if (index.isValid())
+        flags |= Qt::ItemIsEditable | Qt::ItemIsDragEnabled;
+    return flags;
+}
+
+QStringList ScreenshotList::mimeTypes() const
+{
+    return { "text/uri-list" };
+}
+
+QMimeData* ScreenshotList::mimeData(const QModelIndexList& indexes) const
+{
+    QList<QUrl> urls;
+    for (auto& index : indexes) {
+        auto path = filePath(index);
+        if (!path.isEmpty())
+            urls.append(QUrl::fromLocalFile(path));
+    }
+    auto data = new QMimeData();
+    data->setUrls(urls);
+    return data;
+}
+
+bool ScreenshotList::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_fetched < m_entries.size();
+}
+
+void ScreenshotList::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid())
+        return;
+    int more = std::min(pageSize, int(m_entries.size()) - m_fetched);
+    if (more <= 0)
+        return;
+    beginInsertRows(QModelIndex(), m_fetched, m_fetched + more - 1);
+    m_fetched += more;
+    endInsertRows();
+}
+
+void ScreenshotList::loadIndex()
+{
+    QFile file(m_indexFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError parseError;
+    auto json = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !json.isObject()) {
+        qWarning() << "Ignoring the screenshot index" << m_indexFile << "it can't be read:" << parseError.errorString();
+        return;
+    }
+    auto root = json.object();
+    if (Json::ensureString(root, "version") != "1")
+        return;
+
+    Entries entries;
+    for (auto element : Json::ensureArray(root, "screenshots")) {
+        auto obj = Json::ensureObject(element);
+        Entry entry;
+        entry.name = Json::ensureString(obj, "name");
+        if (entry.name.isEmpty())
+            continue;
+        entry.size = Json::ensureDouble(obj, "size");
+        entry.modified = Json::ensureDouble(obj, "modified");
+        entry.dimensions = QSize(Json::ensureInteger(obj, "width", -1), Json::ensureInteger(obj, "height", -1));
+        entries.append(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return before(a.name, b.name); });
+    apply(entries);
+    // nothing new to write back
+    m_saveTimer.stop();
+}
+
+void ScreenshotList::saveIndex()
+{
+    m_saveTimer.stop();
+    QJsonArray screenshots;
+    for (auto& entry : m_entries) {
+        QJsonObject obj;
+        obj.insert("name", entry.name);
+        obj.insert("size", double(entry.size));
+        obj.insert("modified", double(entry.modified));
+        if (entry.dimensions.isValid()) {
+            obj.insert("width", entry.dimensions.width());
+            obj.insert("height", entry.dimensions.height());
+        }
+        screenshots.append(obj);
+    }
+    QJsonObject root;
+    root.insert("version", "1");
+    root.insert("screenshots", screenshots);
+    try {
+        Json::write(root, m_indexFile);
+    } catch (const Exception& e) {
+        qWarning() << "Couldn't write the screenshot index:" << e.what();
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSize>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class FileChangeSubscription;
+
+/**
+ * The screenshots in a folder, from an index kept next to the thumbnails instead of asking the folder every time.
+ *
+ * The index holds the name, size, modification time and dimensions of every screenshot, so the list is there as soon as
+ * it's loaded. The folder is listed again off the GUI thread when it's loaded and whenever it changes, and only what's
+ * different from the index turns into rows being inserted, removed or changed. Dimensions are read only for new and
+ * changed files. Rows are handed to the view a page at a time through fetchMore, by name like the game names them.
+ *
+ * Lives on the GUI thread.
+ */
+class ScreenshotList : public QAbstractListModel {
+    Q_OBJECT
+   public:
+    enum Roles { FilePathRole = Qt::UserRole + 1, SizeRole, ModifiedRole, DimensionsRole };
+
+    ScreenshotList(QString folder, QString indexFile, QObject* parent = nullptr);
+    ~ScreenshotList() override;
+
+    /// read the index and start keeping up with the folder, nothing happens before the first call
+    void load();
+    /// list the folder again, the changes come in when that's done
+    void update();
+
+    QString folder() const { return m_folder; }
+    QString filePath(const QModelIndex& index) const;
+    QFileInfo fileInfo(const QModelIndex& index) const;
+    /// the row of the screenshot at that path, invalid if it's not one or not fetched yet
+    QModelIndex indexOf(const QString& path) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    /// renames the file, the name is given without the extension
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QStringList mimeTypes() const override;
+    QMimeData* mimeData(const QModelIndexList& indexes) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+   signals:
+    /// the screenshot at that path changed or went away, what was made of it is no good anymore
+    void fileChanged(const QString& path);
+
+   private:
+    struct Entry {
+        QString name;
+        qint64 size = 0;
+        qint64 modified = 0;
+        QSize dimensions;
+    };
+    using Entries = QVector<Entry>;
+
+    static bool before(const QString& a, const QString& b);
+    static Entries scan(const QString& folder, const Entries& known);
+    void scanned();
+    void apply(const Entries& current);
+    void insertEntries(int at, const Entries& entries);
+    void removeEntries(int at, int count);
+
+    void loadIndex();
+    void saveIndex();
+
+   private:
+    QString m_folder;
+    QString m_indexFile;
+    bool m_loaded = false;
+    Entries m_entries;
+    // how many of the entries the view has been given
+    int m_fetched = 0;
+
+    FileChangeSubscription* m_watch = nullptr;
+    QFutureWatcher<Entries> m_scan;
+    // the folder changed while it was being listed
+    bool m_scanAgain = false;
+    QTimer m_saveTimer;
+};
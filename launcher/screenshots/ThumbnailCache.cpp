@@ -0,0 +1,96 @@
+#include "ThumbnailCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QImageReader>
+#include <QPainter>
+#include <QSaveFile>
+#include <QUrl>
+
+#include "FileSystem.h"
+
+ThumbnailCache::ThumbnailCache(QString directory) : m_directory(std::move(directory)) {}
+
+static QString fileUri(const QFileInfo& file)
+{
+    return QUrl::fromLocalFile(file.absoluteFilePath()).toString(QUrl::FullyEncoded);
+}
+
+QString ThumbnailCache::thumbnailPath(const QFileInfo& file) const
+{
+    auto hash = QCryptographicHash::hash(fileUri(file).toUtf8(), QCryptographicHash::Md5).toHex();
+    return FS::PathCombine(m_directory, QString::fromLatin1(hash) + ".png");
+}
+
+QImage ThumbnailCache::find(const QFileInfo& file) const
+{
+    QImageReader reader(thumbnailPath(file), "png");
+    if (!reader.canRead())
+        return {};
+    // the text chunks come before the pixels, nothing gets decoded for a stale one
+    if (reader.text("Thumb::URI") != fileUri(file) ||
+        reader.text("Thumb::MTime") != QString::number(file.lastModified().toSecsSinceEpoch()) ||
+        reader.text("Thumb::Size") != QString::number(file.size()))
+        return {};
+    return reader.read();
+}
+
+bool ThumbnailCache::store(const QFileInfo& file, const QImage& thumbnail) const
+{
+    if (!FS::ensureFolderPathExists(m_directory))
+        return false;
+    QImage image = thumbnail;
+    image.setText("Thumb::URI", fileUri(file));
+    image.setText("Thumb::MTime", QString::number(file.lastModified().toSecsSinceEpoch()));
+    image.setText("Thumb::Size", QString::number(file.size()));
+    image.setText("Software", "PrismLauncher");
+
+    // no half written thumbnails for another page to read
+    QSaveFile out(thumbnailPath(file));
+    if (!out.open(QIODevice::WriteOnly))
+        return false;
+    if (!image.save(&out, "png"))
+        return false;
+    return out.commit();
+}
+
+void ThumbnailCache::remove(const QFileInfo& file) const
+{
+    QFile::remove(thumbnailPath(file));
+}
+
+QImage ThumbnailCache::make(const QString& path, int size)
+{
+    QImageReader reader(path);
+    auto full = reader.size();
+    if (full.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize)) {
+        // JPEG and a few others decode straight to a fraction of the size, twice what's needed keeps it sharp
+        auto scaled = full.scaled(size * 2, size * 2, Qt::KeepAspectRatio);
+        if (scaled.width() < full.width())
+            reader.setScaledSize(scaled);
+    }
+    QImage image = reader.read();
+    if (image.isNull())
+        return {};
+
+    QImage small;
+    // a fast pass down to twice the size first, then a smooth one
+    if (image.width() > image.height()) {
+        if (image.width() > size * 2)
+            image = image.scaledToWidth(size * 2);
+        small = image.scaledToWidth(size, Qt::SmoothTransformation);
+    } else {
+        if (image.height() > size * 2)
+            image = image.scaledToHeight(size * 2);
+        small = image.scaledToHeight(size, Qt::SmoothTransformation);
+    }
+    QPoint offset((size - small.width()) / 2, (size - small.height()) / 2);
+    QImage square(QSize(size, size), QImage::Format_ARGB32);
+    square.fill(Qt::transparent);
+
+    QPainter painter(&square);
+    painter.drawImage(offset, small);
+    painter.end();
+    return square;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QImage>
+#include <QString>
+
+/**
+ * Thumbnails of screenshots kept on disk between runs, laid out like the XDG thumbnail spec does it.
+ *
+ * A thumbnail is a PNG named after the MD5 of the file URI, with the URI, modification time and size of the file in its
+ * text chunks. It's only trusted while those still match, so a screenshot that was replaced gets a new one.
+ *
+ * Stateless apart from the folder, any thread can use it.
+ */
+class ThumbnailCache {
+   public:
+    explicit ThumbnailCache(QString directory);
+
+    /// the thumbnail made of the file as it is now, a null image if there's none
+    QImage find(const QFileInfo& file) const;
+    bool store(const QFileInfo& file, const QImage& thumbnail) const;
+    void remove(const QFileInfo& file) const;
+
+    /// a size × size thumbnail of the image, decoded at a reduced resolution where the format can do that
+    static QImage make(const QString& path, int size);
+
+   private:
+    QString thumbnailPath(const QFileInfo& file) const;
+
+   private:
+    QString m_directory;
+};
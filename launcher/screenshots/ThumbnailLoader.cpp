@@ -0,0 +1,83 @@
+#include "ThumbnailLoader.h"
+
+#include <QDebug>
+#include <QThread>
+
+#include <algorithm>
+
+#include "tasks/Executor.h"
+
+ThumbnailLoader::ThumbnailLoader(QString cacheDirectory, int size, QObject* parent)
+    : QObject(parent), m_cache(std::move(cacheDirectory)), m_size(size), m_maxRunning(std::clamp(QThread::idealThreadCount() / 2, 1, 4))
+{}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+    // what's running only uses copies, it finishes on its own
+    m_pending.clear();
+    for (auto watcher : m_running)
+        watcher->disconnect(this);
+}
+
+void ThumbnailLoader::request(const QStringList& paths)
+{
+    m_pending.clear();
+    for (auto& path : paths) {
+        if (!m_running.contains(path) && !m_pending.contains(path))
+            m_pending.append(path);
+    }
+    startNext();
+}
+
+void ThumbnailLoader::invalidate(const QString& path)
+{
+    m_pending.removeAll(path);
+    // one being made now might be of the old file, it's made again
+    if (auto watcher = m_running.take(path)) {
+        watcher->disconnect(this);
+        watcher->deleteLater();
+    }
+    m_cache.remove(QFileInfo(path));
+    startNext();
+}
+
+ThumbnailLoader::Result ThumbnailLoader::load(const ThumbnailCache& cache, const QString& path, int size)
+{
+    QFileInfo info(path);
+    auto thumbnail = cache.find(info);
+    if (!thumbnail.isNull())
+        return { path, thumbnail };
+    thumbnail = ThumbnailCache::make(path, size);
+    if (thumbnail.isNull()) {
+        qDebug() << "Error loading screenshot: " + path + ". Perhaps too large?";
+        return { path, thumbnail };
+    }
+    if (!cache.store(info, thumbnail))
+        qDebug() << "Couldn't keep the thumbnail of" << path;
+    return { path, thumbnail };
+}
+
+void ThumbnailLoader::startNext()
+{
+    while (m_running.size() < m_maxRunning && !m_pending.isEmpty()) {
+        auto path = m_pending.takeFirst();
+        auto watcher = new QFutureWatcher<Result>(this);
+        connect(watcher, &QFutureWatcher<Result>::finished, this, [this, watcher] { finished(watcher); });
+        // what's on screen shouldn't wait for copies and imports
+        watcher->setFuture(Executor::instance()->run(Executor::Priority::Interactive,
+                                                     [cache = m_cache, path, size = m_size] { return load(cache, path, size); }));
+        m_running.insert(path, watcher);
+    }
+}
+
+void ThumbnailLoader::finished(QFutureWatcher<Result>* watcher)
+{
+    auto result = watcher->result();
+    watcher->deleteLater();
+    m_running.remove(result.path);
+    if (result.thumbnail.isNull())
+        emit failed(result.path);
+    else
+        emit ready(result.path, result.thumbnail);
+    startNext();
+}
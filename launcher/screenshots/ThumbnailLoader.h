@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QStringList>
+
+#include "ThumbnailCache.h"
+
+/**
+ * Makes thumbnails for what is on screen, from the ThumbnailCache when it has them.
+ *
+ * Only a few are made at a time, in the order they were asked for. Asking again replaces what hasn't started yet, so
+ * scrolling past a thousand screenshots doesn't leave a thousand thumbnails to be made.
+ *
+ * Lives on the GUI thread.
+ */
+class ThumbnailLoader : public QObject {
+    Q_OBJECT
+   public:
+    ThumbnailLoader(QString cacheDirectory, int size, QObject* parent = nullptr);
+    ~ThumbnailLoader() override;
+
+    /// make thumbnails of these, first ones first, instead of whatever was asked for before and isn't being made already
+    void request(const QStringList& paths);
+    /// the file changed or went away, its thumbnail is no good anymore
+    void invalidate(const QString& path);
+
+   signals:
+    void ready(const QString& path, const QImage& thumbnail);
+    void failed(const QString& path);
+
+   private:
+    struct Result {
+        QString path;
+        QImage thumbnail;
+    };
+    static Result load(const ThumbnailCache& cache, const QString& path, int size);
+    void startNext();
+    void finished(QFutureWatcher<Result>* watcher);
+
+   private:
+    ThumbnailCache m_cache;
+    int m_size;
+    int m_maxRunning;
+    QStringList m_pending;
+    QHash<QString, QFutureWatcher<Result>*> m_running;
+};
@@ -37,8 +37,11 @@
 #include "settings/INIFile.h"
 #include <FileSystem.h>
 
+#include <QBuffer>
 #include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QSaveFile>
 #include <QStringList>
 #include <QTemporaryFile>
@@ -46,16 +49,473 @@
 
 #include <QSettings>
 
-INIFile::INIFile() {}
+#include <algorithm>
 
-bool INIFile::saveFile(QString fileName)
+namespace {
+
+// QSettings reads and writes INI files as UTF-8 since Qt 6, before that as Latin-1 with everything else escaped
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+const bool s_utf8 = true;
+#else
+const bool s_utf8 = false;
+#endif
+
+#ifdef Q_OS_WIN
+const char* const s_eol = "\r\n";
+#else
+const char* const s_eol = "\n";
+#endif
+
+const char s_hexDigits[] = "0123456789ABCDEF";
+
+QString decode(const char* begin, const char* end)
+{
+    auto size = static_cast<int>(end - begin);
+    return s_utf8 ? QString::fromUtf8(begin, size) : QString::fromLatin1(begin, size);
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+char escapedChar(char c)
+{
+    switch (c) {
+        case 'a':
+            return '\a';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'v':
+            return '\v';
+        case '"':
+        case '?':
+        case '\'':
+        case '\\':
+            return c;
+        default:
+            return 0;
+    }
+}
+
+void chopTrailingSpaces(QString& str, int limit)
+{
+    auto size = str.size();
+    while (size > limit && (str.at(size - 1) == ' ' || str.at(size - 1) == '\t'))
+        size--;
+    str.truncate(size);
+}
+
+/// the typed value QSettings makes of a string, false if it's one only QSettings can decode
+bool stringToVariant(const QString& str, QVariant& out)
+{
+    if (str.startsWith('@')) {
+        if (str.endsWith(')')) {
+            if (str.startsWith("@ByteArray(")) {
+                out = str.mid(11, str.size() - 12).toLatin1();
+                return true;
+            }
+            if (str.startsWith("@String(")) {
+                out = str.mid(8, str.size() - 9);
+                return true;
+            }
+            if (str == "@Invalid()") {
+                out = QVariant();
+                return true;
+            }
+            if (str.startsWith("@Variant(") || str.startsWith("@DateTime(") || str.startsWith("@Rect(") || str.startsWith("@Size(") ||
+                str.startsWith("@Point("))
+                return false;
+        }
+        if (str.startsWith("@@")) {
+            out = str.mid(1);
+            return true;
+        }
+    }
+    out = str;
+    return true;
+}
+
+bool listToVariant(const QStringList& list, QVariant& out)
+{
+    bool plain = std::none_of(list.begin(), list.end(), [](const QString& item) { return item.startsWith('@') && !item.startsWith("@@"); });
+    if (plain) {
+        QStringList strings;
+        strings.reserve(list.size());
+        for (auto const& item : list)
+            strings.append(item.startsWith('@') ? item.mid(1) : item);
+        out = strings;
+        return true;
+    }
+
+    QVariantList variants;
+    variants.reserve(list.size());
+    for (auto const& item : list) {
+        QVariant variant;
+        if (!stringToVariant(item, variant))
+            return false;
+        variants.append(variant);
+    }
+    out = variants;
+    return true;
+}
+
+/// unescapes a value the way QSettings does: backslash escapes, quoted parts, and commas separating list items
+bool parseValue(const char* begin, const char* end, QVariant& out)
+{
+    auto p = begin;
+    auto skipSpaces = [&p, end] {
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+    };
+    skipSpaces();
+
+    // the usual case, nothing to unescape
+    auto last = end;
+    while (last > p && (last[-1] == ' ' || last[-1] == '\t'))
+        last--;
+    if (std::none_of(p, last, [](char c) { return c == '\\' || c == '"' || c == ','; }))
+        return stringToVariant(decode(p, last), out);
+
+    QString current;
+    QStringList list;
+    bool isList = false;
+    bool inQuotes = false;
+    bool quoted = false;
+    int chopLimit = 0;
+
+    while (p < end) {
+        char c = *p;
+        if (c == '\\') {
+            if (++p >= end)
+                break;
+            c = *p++;
+            if (auto escaped = escapedChar(c)) {
+                current += QLatin1Char(escaped);
+            } else if (c == 'x' && p < end && hexValue(*p) >= 0) {
+                ushort value = 0;
+                for (; p < end && hexValue(*p) >= 0; p++)
+                    value = (value << 4) + hexValue(*p);
+                current += QChar(value);
+            } else if (c >= '0' && c <= '7') {
+                ushort value = c - '0';
+                for (; p < end && *p >= '0' && *p <= '7'; p++)
+                    value = (value << 3) + (*p - '0');
+                current += QChar(value);
+            } else if ((c == '\n' || c == '\r') && p < end && (*p == '\n' || *p == '\r') && *p != c) {
+                // an escaped line break
+                p++;
+            }
+            // anything else that's escaped is dropped
+            chopLimit = current.size();
+        } else if (c == '"') {
+            p++;
+            quoted = true;
+            inQuotes = !inQuotes;
+            if (!inQuotes) {
+                skipSpaces();
+                chopLimit = current.size();
+            }
+        } else if (c == ',' && !inQuotes) {
+            if (!quoted)
+                chopTrailingSpaces(current, chopLimit);
+            isList = true;
+            list.append(current);
+            current.clear();
+            quoted = false;
+            p++;
+            skipSpaces();
+            chopLimit = 0;
+        } else {
+            auto run = p + 1;
+            while (run < end && *run != '\\' && *run != '"' && *run != ',')
+                run++;
+            current += decode(p, run);
+            p = run;
+        }
+    }
+    if (!quoted)
+        chopTrailingSpaces(current, chopLimit);
+
+    if (!isList)
+        return stringToVariant(current, out);
+    list.append(current);
+    return listToVariant(list, out);
+}
+
+/// keys QSettings would have to unescape are left to it
+bool parseKey(const char* begin, const char* end, QString& out)
+{
+    while (begin < end && isSpace(*begin))
+        begin++;
+    while (end > begin && isSpace(end[-1]))
+        end--;
+    if (begin == end || std::any_of(begin, end, [](char c) { return c == '%' || c == '\\' || (c & 0x80); }))
+        return false;
+    out = QString::fromLatin1(begin, static_cast<int>(end - begin));
+    return true;
+}
+
+/**
+ * Reads what QSettings writes in one pass over the raw bytes, without a round trip through QSettings and the file system.
+ * Returns false for anything it doesn't understand, malformed files included, so QSettings can have a look instead.
+ */
+bool parseIni(const QByteArray& data, QMap<QString, QVariant>& values)
+{
+    auto p = data.constData();
+    auto end = p + data.size();
+    if (data.startsWith("\xef\xbb\xbf"))
+        p += 3;
+
+    QString section;
+    while (p < end) {
+        while (p < end && isSpace(*p))
+            p++;
+        if (p == end)
+            break;
+
+        // a line can go on after an escaped line break, or inside quotes
+        auto lineStart = p;
+        const char* equals = nullptr;
+        bool inQuotes = false;
+        bool comment = false;
+        while (p < end) {
+            char c = *p;
+            if (c == '=') {
+                if (!inQuotes && !equals)
+                    equals = p;
+            } else if (c == '\n' || c == '\r') {
+                if (!inQuotes)
+                    break;
+            } else if (c == '\\') {
+                if (p + 1 < end) {
+                    char escaped = *++p;
+                    if (p + 1 < end && ((escaped == '\n' && p[1] == '\r') || (escaped == '\r' && p[1] == '\n')))
+                        p++;
+                }
+            } else if (c == '"') {
+                inQuotes = !inQuotes;
+            } else if (c == ';' && !inQuotes) {
+                comment = true;
+                break;
+            }
+            p++;
+        }
+        auto lineEnd = p;
+        if (comment) {
+            while (p < end && *p != '\n' && *p != '\r')
+                p++;
+        }
+        if (lineEnd == lineStart)
+            continue;
+
+        if (*lineStart == '[') {
+            auto close = std::find(lineStart, lineEnd, ']');
+            if (close == lineEnd || !std::all_of(close + 1, lineEnd, isSpace))
+                return false;
+            QString name;
+            if (!parseKey(lineStart + 1, close, name))
+                return false;
+            if (name.compare("general", Qt::CaseInsensitive) == 0)
+                section.clear();
+            else
+                section = name + '/';
+            continue;
+        }
+
+        QString key;
+        QVariant value;
+        if (!equals || !parseKey(lineStart, equals, key) || !parseValue(equals + 1, lineEnd, value))
+            return false;
+        values.insert(section + key, value);
+    }
+    return true;
+}
+
+/// the string QSettings writes for a value, false if it's one only QSettings can encode
+bool variantToString(const QVariant& value, QString& out)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    auto type = value.typeId();
+#else
+    auto type = static_cast<int>(value.type());
+#endif
+    switch (type) {
+        case QMetaType::UnknownType:
+            out = "@Invalid()";
+            return true;
+        case QMetaType::QByteArray:
+            out = "@ByteArray(" + QString::fromLatin1(value.toByteArray()) + ')';
+            return true;
+        case QMetaType::QString:
+        case QMetaType::Bool:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+            out = value.toString();
+            if (out.contains(QChar::Null))
+                out = "@String(" + out + ')';
+            else if (out.startsWith('@'))
+                out.prepend('@');
+            return true;
+        default:
+            return false;
+    }
+}
+
+void escapeString(const QString& str, QByteArray& out)
+{
+    bool needsQuotes = false;
+    bool escapeNextIfDigit = false;
+    bool raw = s_utf8 && !(str.startsWith("@ByteArray(") || str.startsWith("@Variant("));
+    auto start = out.size();
+
+    for (auto qc : str) {
+        auto c = qc.unicode();
+        if (c == ';' || c == ',' || c == '=')
+            needsQuotes = true;
+        if (escapeNextIfDigit && c < 0x80 && hexValue(static_cast<char>(c)) >= 0) {
+            out += "\\x" + QByteArray::number(c, 16);
+            continue;
+        }
+        escapeNextIfDigit = false;
+
+        switch (c) {
+            case '\0':
+                out += "\\0";
+                escapeNextIfDigit = true;
+                break;
+            case '\a':
+                out += "\\a";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            case '\v':
+                out += "\\v";
+                break;
+            case '"':
+            case '\\':
+                out += '\\';
+                out += static_cast<char>(c);
+                break;
+            default:
+                if (c <= 0x1F || (c >= 0x7F && !raw)) {
+                    out += "\\x" + QByteArray::number(c, 16);
+                    escapeNextIfDigit = true;
+                } else if (c >= 0x80) {
+                    out += QString(qc).toUtf8();
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+
+    if (needsQuotes || (start < out.size() && (out.at(start) == ' ' || out.at(out.size() - 1) == ' '))) {
+        out.insert(start, '"');
+        out += '"';
+    }
+}
+
+bool escapeValue(const QVariant& value, QByteArray& out)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    auto type = value.typeId();
+#else
+    auto type = static_cast<int>(value.type());
+#endif
+    if (type == QMetaType::QStringList || (type == QMetaType::QVariantList && value.toList().size() != 1)) {
+        auto list = value.toList();
+        // an empty list has to look different from a list of one empty string
+        if (list.isEmpty()) {
+            out += "@Invalid()";
+            return true;
+        }
+        for (int i = 0; i < list.size(); i++) {
+            QString item;
+            if (!variantToString(list.at(i), item))
+                return false;
+            if (i != 0)
+                out += ", ";
+            escapeString(item, out);
+        }
+        return true;
+    }
+
+    QString str;
+    if (!variantToString(type == QMetaType::QVariantList ? value.toList().constFirst() : value, str))
+        return false;
+    escapeString(str, out);
+    return true;
+}
+
+/// writes what QSettings would, false if there's anything only it can write
+bool serializeIni(const QMap<QString, QVariant>& values, QByteArray& out)
+{
+    out += "[General]";
+    out += s_eol;
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        auto const& key = it.key();
+        if (key.isEmpty())
+            return false;
+        for (auto qc : key) {
+            auto c = qc.unicode();
+            if (c == '/' || c >= 0x80)
+                return false;
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.') {
+                out += static_cast<char>(c);
+            } else {
+                out += '%';
+                out += s_hexDigits[c / 16];
+                out += s_hexDigits[c % 16];
+            }
+        }
+        out += '=';
+        if (!escapeValue(it.value(), out))
+            return false;
+        out += s_eol;
+    }
+    return true;
+}
+
+bool saveWithQSettings(const QMap<QString, QVariant>& values, const QString& fileName)
 {
-    if (!contains("ConfigVersion"))
-        insert("ConfigVersion", "1.2");
     QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
     _settings_obj.setFallbacksEnabled(false);
 
-    for (Iterator iter = begin(); iter != end(); iter++)
+    for (auto iter = values.begin(); iter != values.end(); iter++)
         _settings_obj.setValue(iter.key(), iter.value());
 
     _settings_obj.sync();
@@ -73,6 +533,48 @@ bool INIFile::saveFile(QString fileName)
     return true;
 }
 
+}  // namespace
+
+INIFile::INIFile() {}
+
+bool INIFile::saveFile(QString fileName)
+{
+    if (!contains("ConfigVersion"))
+        insert("ConfigVersion", "1.2");
+
+    QFileInfo info(fileName);
+    bool known = fileName == m_savedPath && info.size() == m_savedSize && info.lastModified() == m_savedModified;
+    if (known && m_saved == *this)
+        return true;
+
+    QByteArray data;
+    // QSettings merges with what's in the file already, which matters if it's been changed by someone else
+    if ((info.exists() && !known) || !serializeIni(*this, data)) {
+        if (!saveWithQSettings(*this, fileName))
+            return false;
+        markSaved(fileName);
+        return true;
+    }
+
+    QDir().mkpath(info.absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCritical() << "Couldn't write" << fileName << ":" << file.errorString();
+        return false;
+    }
+    markSaved(fileName);
+    return true;
+}
+
+void INIFile::markSaved(const QString& fileName)
+{
+    QFileInfo info(fileName);
+    m_savedPath = fileName;
+    m_savedSize = info.size();
+    m_savedModified = info.lastModified();
+    m_saved = *this;
+}
+
 QString unescape(QString orig)
 {
     QString out;
@@ -151,44 +653,76 @@ bool parseOldFileFormat(QIODevice& device, QSettings::SettingsMap& map)
 
 bool INIFile::loadFile(QString fileName)
 {
-    QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
-    _settings_obj.setFallbacksEnabled(false);
-
-    if (auto status = _settings_obj.status(); status != QSettings::Status::NoError) {
-        if (status == QSettings::Status::AccessError)
-            qCritical() << "An access error occurred (e.g. trying to write to a read-only file).";
-        if (status == QSettings::Status::FormatError)
-            qCritical() << "A format error occurred (e.g. loading a malformed INI file).";
-        return false;
+    bool wasEmpty = isEmpty();
+    QSettings::SettingsMap values;
+    QByteArray data;
+    QFile file(fileName);
+    bool opened = file.open(QIODevice::ReadOnly);
+    if (opened) {
+        data = file.readAll();
+        file.close();
     }
-    if (!_settings_obj.value("ConfigVersion").isValid()) {
-        QFile file(fileName);
-        if (!file.open(QIODevice::ReadOnly))
+
+    if (!parseIni(data, values)) {
+        values.clear();
+        QSettings _settings_obj{ fileName, QSettings::Format::IniFormat };
+        _settings_obj.setFallbacksEnabled(false);
+
+        if (auto status = _settings_obj.status(); status != QSettings::Status::NoError) {
+            if (status == QSettings::Status::AccessError)
+                qCritical() << "An access error occurred (e.g. trying to write to a read-only file).";
+            if (status == QSettings::Status::FormatError)
+                qCritical() << "A format error occurred (e.g. loading a malformed INI file).";
             return false;
+        }
+        for (auto&& key : _settings_obj.allKeys())
+            values.insert(key, _settings_obj.value(key));
+    }
+
+    if (!values.contains("ConfigVersion") && !opened)
+        return false;
+    loadValues(values, data);
+
+    // it holds what's in the file, unless it had been converted or had something in it already
+    if (wasEmpty && values.value("ConfigVersion").toString() == "1.2")
+        markSaved(fileName);
+    return true;
+}
+
+void INIFile::loadValues(const QMap<QString, QVariant>& values, const QByteArray& data)
+{
+    if (!values.contains("ConfigVersion")) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
         QSettings::SettingsMap map;
-        parseOldFileFormat(file, map);
-        file.close();
+        parseOldFileFormat(buffer, map);
         for (auto&& key : map.keys())
             insert(key, map.value(key));
         insert("ConfigVersion", "1.2");
-    } else if (_settings_obj.value("ConfigVersion").toString() == "1.1") {
-        for (auto&& key : _settings_obj.allKeys()) {
-            if (auto valueStr = _settings_obj.value(key).toString();
+    } else if (values.value("ConfigVersion").toString() == "1.1") {
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+            if (auto valueStr = it.value().toString();
                 (valueStr.contains(QChar(';')) || valueStr.contains(QChar('=')) || valueStr.contains(QChar(','))) &&
                 valueStr.endsWith("\"") && valueStr.startsWith("\"")) {
-                insert(key, unquote(valueStr));
+                insert(it.key(), unquote(valueStr));
             } else
-                insert(key, _settings_obj.value(key));
+                insert(it.key(), it.value());
         }
         insert("ConfigVersion", "1.2");
     } else
-        for (auto&& key : _settings_obj.allKeys())
-            insert(key, _settings_obj.value(key));
-    return true;
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+            insert(it.key(), it.value());
 }
 
 bool INIFile::loadFile(QByteArray data)
 {
+    QSettings::SettingsMap values;
+    if (parseIni(data, values)) {
+        loadValues(values, data);
+        return true;
+    }
+
     QTemporaryFile file;
     if (!file.open())
         return false;
@@ -36,7 +36,9 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QIODevice>
+#include <QMap>
 #include <QString>
 #include <QVariant>
 
@@ -50,8 +52,20 @@ class INIFile : public QMap<QString, QVariant> {
 
     bool loadFile(QString fileName);
     bool loadFile(QByteArray data);
+    /// writes the file, unless it still holds exactly what was last read from or written to it
     bool saveFile(QString fileName);
 
     QVariant get(QString key, QVariant def) const;
     void set(QString key, QVariant val);
+
+   private:
+    void loadValues(const QMap<QString, QVariant>& values, const QByteArray& data);
+    void markSaved(const QString& fileName);
+
+   private:
+    // what the file at m_savedPath held, and when, as far as this knows
+    QString m_savedPath;
+    QDateTime m_savedModified;
+    qint64 m_savedSize = -1;
+    QMap<QString, QVariant> m_saved;
 };
@@ -17,7 +17,9 @@
 #include "Setting.h"
 
 #include <QDebug>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 
 INISettingsObject::INISettingsObject(QStringList paths, QObject* parent) : SettingsObject(parent)
 {
@@ -44,6 +46,36 @@ INISettingsObject::INISettingsObject(QString path, QObject* parent) : SettingsOb
     m_ini.loadFile(path);
 }
 
+INISettingsObject::INISettingsObject(QString path, INIFile ini, Contents contents, QObject* parent)
+    : SettingsObject(parent), m_ini(std::move(ini)), m_filePath(std::move(path)), m_complete(contents == Contents::Complete)
+{}
+
+INISettingsObject::~INISettingsObject()
+{
+    saveNow();
+}
+
+void INISettingsObject::complete(INIFile ini)
+{
+    if (m_complete)
+        return;
+    m_ini = std::move(ini);
+    m_complete = true;
+}
+
+void INISettingsObject::ensureComplete()
+{
+    if (m_complete)
+        return;
+    m_complete = true;
+
+    INIFile ini;
+    if (ini.loadFile(m_filePath))
+        m_ini = std::move(ini);
+    else
+        qWarning() << "Couldn't read" << m_filePath << ", going on with what was known of it";
+}
+
 void INISettingsObject::setFilePath(const QString& filePath)
 {
     m_filePath = filePath;
@@ -51,11 +83,13 @@ void INISettingsObject::setFilePath(const QString& filePath)
 
 bool INISettingsObject::reload()
 {
+    m_complete = true;
     return m_ini.loadFile(m_filePath) && SettingsObject::reload();
 }
 
 void INISettingsObject::suspendSave()
 {
+    ensureComplete();
     m_suspendSave = true;
 }
 
@@ -63,13 +97,15 @@ void INISettingsObject::resumeSave()
 {
     m_suspendSave = false;
     if (m_doSave) {
-        m_ini.saveFile(m_filePath);
+        m_doSave = false;
+        saveEventually();
     }
 }
 
 void INISettingsObject::changeSetting(const Setting& setting, QVariant value)
 {
     if (contains(setting.id())) {
+        ensureComplete();
         // valid value -> set the main config, remove all the sysnonyms
         if (value.isValid()) {
             auto list = setting.configKeys();
@@ -91,14 +127,25 @@ void INISettingsObject::doSave()
     if (m_suspendSave) {
         m_doSave = true;
     } else {
-        m_ini.saveFile(m_filePath);
+        saveEventually();
+    }
+}
+
+void INISettingsObject::writeChanges(bool deferred)
+{
+    // don't bring back a folder that was deleted while the changes were held back
+    if (deferred && !QFileInfo(m_filePath).absoluteDir().exists()) {
+        qDebug() << "Dropping changes to" << m_filePath << ", it's gone";
+        return;
     }
+    m_ini.saveFile(m_filePath);
 }
 
 void INISettingsObject::resetSetting(const Setting& setting)
 {
     // if we have the setting, remove all the synonyms. ALL OF THEM
     if (contains(setting.id())) {
+        ensureComplete();
         for (auto iter : setting.configKeys())
             m_ini.remove(iter);
         doSave();
@@ -113,6 +160,11 @@ QVariant INISettingsObject::retrieveValue(const Setting& setting)
             if (m_ini.contains(iter))
                 return m_ini[iter];
         }
+        // partial contents only know they don't have it
+        if (!m_complete) {
+            ensureComplete();
+            return retrieveValue(setting);
+        }
     }
     return QVariant();
 }
@@ -32,6 +32,16 @@ class INISettingsObject : public SettingsObject {
 
     explicit INISettingsObject(QString path, QObject* parent = nullptr);
 
+    enum class Contents { Complete, Partial };
+
+    /**
+     * Use the contents of the INI file at 'path' that were already read into 'ini', so it can be done elsewhere.
+     * 'Partial' contents only hold some of the values, the file gets read when any other one is needed or one gets changed.
+     */
+    INISettingsObject(QString path, INIFile ini, Contents contents = Contents::Complete, QObject* parent = nullptr);
+
+    virtual ~INISettingsObject();
+
     /*!
      * \brief Gets the path to the INI file.
      * \return The path to the INI file.
@@ -46,6 +56,9 @@ class INISettingsObject : public SettingsObject {
 
     bool reload() override;
 
+    /// replace partial contents with the whole file, read elsewhere
+    void complete(INIFile ini);
+
     void suspendSave() override;
     void resumeSave() override;
 
@@ -56,8 +69,11 @@ class INISettingsObject : public SettingsObject {
    protected:
     virtual QVariant retrieveValue(const Setting& setting) override;
     void doSave();
+    void writeChanges(bool deferred) override;
+    void ensureComplete();
 
    protected:
     INIFile m_ini;
     QString m_filePath;
+    bool m_complete = true;
 };
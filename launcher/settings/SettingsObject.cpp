@@ -19,12 +19,23 @@
 #include "settings/OverrideSetting.h"
 #include "settings/Setting.h"
 
+#include <QSet>
 #include <QVariant>
 
-SettingsObject::SettingsObject(QObject* parent) : QObject(parent) {}
+// the settings objects holding back changes, all of them live on the main thread
+static QSet<SettingsObject*> s_pendingSaves;
+
+SettingsObject::SettingsObject(QObject* parent) : QObject(parent)
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_saveTimer, &QTimer::timeout, this, &SettingsObject::saveNow);
+}
 
 SettingsObject::~SettingsObject()
 {
+    // subclasses have to save themselves, they are gone already
+    s_pendingSaves.remove(this);
     m_settings.clear();
 }
 
@@ -116,6 +127,36 @@ bool SettingsObject::reload()
     return true;
 }
 
+void SettingsObject::setSaveDelay(int delay)
+{
+    m_saveDelay = delay;
+    if (m_saveDelay <= 0)
+        saveNow();
+}
+
+void SettingsObject::saveEventually()
+{
+    if (m_saveDelay <= 0) {
+        writeChanges(false);
+        return;
+    }
+    s_pendingSaves.insert(this);
+    m_saveTimer.start(m_saveDelay);
+}
+
+void SettingsObject::saveNow()
+{
+    m_saveTimer.stop();
+    if (s_pendingSaves.remove(this))
+        writeChanges(true);
+}
+
+void SettingsObject::saveAllNow()
+{
+    for (auto settings : s_pendingSaves.values())
+        settings->saveNow();
+}
+
 void SettingsObject::connectSignals(const Setting& setting)
 {
     connect(&setting, &Setting::SettingChanged, this, &SettingsObject::changeSetting);
@@ -20,6 +20,7 @@
 #include <QMap>
 #include <QObject>
 #include <QStringList>
+#include <QTimer>
 #include <QVariant>
 #include <memory>
 
@@ -141,6 +142,23 @@ class SettingsObject : public QObject {
 
     virtual void suspendSave() = 0;
     virtual void resumeSave() = 0;
+
+    /*!
+     * \brief Sets how long changes are held in memory before they are written out.
+     * Every change restarts the wait, so a burst of them is written once. 0, the default, writes each change right away.
+     * \param delay The time to wait after the last change, in milliseconds.
+     */
+    void setSaveDelay(int delay);
+
+    /*!
+     * \brief Writes out changes that are still held back, if there are any.
+     */
+    void saveNow();
+
+    /*!
+     * \brief Writes out the changes every settings object is still holding back, for when the application quits.
+     */
+    static void saveAllNow();
    signals:
     /*!
      * \brief Signal emitted when one of this SettingsObject object's settings changes.
@@ -193,10 +211,23 @@ class SettingsObject : public QObject {
      */
     virtual QVariant retrieveValue(const Setting& setting) = 0;
 
+    /*!
+     * \brief Writes the changes out now, or after the save delay if there is one.
+     */
+    void saveEventually();
+
+    /*!
+     * \brief Writes the settings to where they are stored.
+     * \param deferred True if the changes were held back, and the storage may have gone away in the meantime.
+     */
+    virtual void writeChanges(bool deferred) = 0;
+
     friend class Setting;
 
    private:
     QMap<QString, std::shared_ptr<Setting>> m_settings;
+    QTimer m_saveTimer;
+    int m_saveDelay = 0;
 
    protected:
     bool m_suspendSave = false;
@@ -0,0 +1,67 @@
+#include "AdaptiveConcurrency.h"
+
+#include <algorithm>
+
+// tasks this much slower than in the fastest window mean they're queueing somewhere
+static const double slowLatency = 1.5;
+static const double throughputGain = 1.05;
+static const double throughputDrop = 0.9;
+
+AdaptiveConcurrency::AdaptiveConcurrency(int min_limit, int max_limit, int initial_limit)
+    : m_min(std::max(1, min_limit)), m_max(std::max(m_min, max_limit)), m_limit(std::clamp(initial_limit, m_min, m_max))
+{}
+
+void AdaptiveConcurrency::restart(qint64 now_ms)
+{
+    m_window_start = now_ms;
+    m_window_tasks = 0;
+    m_window_failures = 0;
+    m_window_work = 0;
+    m_window_latency = 0;
+}
+
+void AdaptiveConcurrency::addWork(qint64 amount)
+{
+    if (amount > 0)
+        m_window_work += amount;
+}
+
+int AdaptiveConcurrency::taskFinished(qint64 now_ms, qint64 latency_ms, bool failed)
+{
+    m_window_tasks++;
+    m_window_latency += std::max<qint64>(0, latency_ms);
+    if (failed)
+        m_window_failures++;
+
+    if (m_window_tasks >= m_limit)
+        evaluate(now_ms);
+    return m_limit;
+}
+
+void AdaptiveConcurrency::evaluate(qint64 now_ms)
+{
+    auto elapsed = std::max<qint64>(1, now_ms - m_window_start);
+    bool counted_work = m_window_work > 0;
+    double throughput = (counted_work ? m_window_work : m_window_tasks) * 1000.0 / elapsed;
+    double latency = double(m_window_latency) / m_window_tasks;
+
+    // throughputs in different units can't be compared
+    if (counted_work != m_last_counted_work)
+        m_last_throughput = 0;
+
+    bool fast = m_best_latency < 0 || latency <= m_best_latency * slowLatency;
+    bool gained = m_last_throughput <= 0 || throughput > m_last_throughput * throughputGain;
+    bool dropped = m_last_throughput > 0 && throughput < m_last_throughput * throughputDrop;
+
+    if (m_window_failures > 0 || (dropped && !fast)) {
+        m_limit = std::max(m_min, std::min(m_limit - 1, m_limit * 3 / 4));
+    } else if (fast || gained) {
+        m_limit = std::min(m_max, m_limit + 1);
+    }
+
+    if (m_best_latency < 0 || latency < m_best_latency)
+        m_best_latency = latency;
+    m_last_throughput = throughput;
+    m_last_counted_work = counted_work;
+    restart(now_ms);
+}
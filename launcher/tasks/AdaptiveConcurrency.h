@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * AIMD controller for the number of subtasks a ConcurrentTask keeps in flight.
+ *
+ * The limit is re-evaluated once per window, a window being as many finished tasks as the limit allowed when it began.
+ * The limit grows by one while tasks stay about as fast as the fastest window seen, or while the extra task still bought
+ * more throughput. It's cut by a quarter when a task failed, or when throughput dropped while tasks got slower, which is
+ * what a congested link or a seeking disk looks like.
+ *
+ * Throughput is measured in the work reported through addWork() (bytes for downloads and hashes), or in finished tasks
+ * when none gets reported.
+ */
+class AdaptiveConcurrency {
+   public:
+    AdaptiveConcurrency(int min_limit, int max_limit, int initial_limit);
+
+    [[nodiscard]] int limit() const { return m_limit; }
+    [[nodiscard]] int minLimit() const { return m_min; }
+    [[nodiscard]] int maxLimit() const { return m_max; }
+
+    /// start a fresh window at `now_ms`, keeping the current limit
+    void restart(qint64 now_ms);
+    /// the running tasks got `amount` more work done
+    void addWork(qint64 amount);
+    /// a task finished at `now_ms` after running for `latency_ms`, returns the limit to use from now on
+    int taskFinished(qint64 now_ms, qint64 latency_ms, bool failed);
+
+   private:
+    void evaluate(qint64 now_ms);
+
+   private:
+    int m_min;
+    int m_max;
+    int m_limit;
+
+    qint64 m_window_start = 0;
+    int m_window_tasks = 0;
+    int m_window_failures = 0;
+    qint64 m_window_work = 0;
+    qint64 m_window_latency = 0;
+
+    double m_last_throughput = 0;
+    bool m_last_counted_work = false;
+    // average task latency of the fastest window so far
+    double m_best_latency = -1;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/**
+ * Tells work running somewhere else that it should stop, for it to check on between its steps.
+ *
+ * Copies share the same state, so the one that asks and the one doing the work each keep their own.
+ */
+class CancellationToken {
+   public:
+    CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { *m_cancelled = true; }
+    [[nodiscard]] bool isCancelled() const { return *m_cancelled; }
+
+   private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
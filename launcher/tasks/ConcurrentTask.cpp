@@ -63,8 +63,19 @@ void ConcurrentTask::addTask(Task::Ptr task)
     m_queue.append(task);
 }
 
+void ConcurrentTask::setAdaptiveConcurrency(int min_concurrent, int max_concurrent)
+{
+    m_adaptive = std::make_unique<AdaptiveConcurrency>(min_concurrent, max_concurrent, m_total_max_size);
+    m_total_max_size = m_adaptive->limit();
+}
+
 void ConcurrentTask::executeTask()
 {
+    if (m_adaptive) {
+        m_clock.start();
+        m_adaptive->restart(m_clock.elapsed());
+    }
+
     // Start one task, startNext handles starting the up to the m_total_max_size
     // while tracking the number currently being done
     QMetaObject::invokeMethod(this, &ConcurrentTask::startNext, Qt::QueuedConnection);
@@ -74,9 +85,11 @@ bool ConcurrentTask::abort()
 {
     m_queue.clear();
     m_aborted = true;
+    cancellationToken().cancel();
 
     if (m_doing.isEmpty()) {
         // Don't call emitAborted() here, we want to bypass the 'is the task running' check
+        flushProgress();
         emit aborted();
         emit finished();
 
@@ -107,6 +120,7 @@ void ConcurrentTask::clear()
     m_done.clear();
     m_failed.clear();
     m_queue.clear();
+    m_started_at.clear();
 
     m_aborted = false;
 
@@ -127,7 +141,9 @@ void ConcurrentTask::startNext()
     if (m_queue.isEmpty())
         return;
 
-    Task::Ptr next = m_queue.dequeue();
+    Task::Ptr next = dequeueNext();
+    if (!next)
+        return;
 
     connect(next.get(), &Task::succeeded, this, [this, next]() { subTaskSucceeded(next); });
     connect(next.get(), &Task::failed, this, [this, next](QString msg) { subTaskFailed(next, msg); });
@@ -140,6 +156,8 @@ void ConcurrentTask::startNext()
     connect(next.get(), &Task::progress, this, [this, next](qint64 current, qint64 total) { subTaskProgress(next, current, total); });
 
     m_doing.insert(next.get(), next);
+    if (m_adaptive)
+        m_started_at.insert(next.get(), m_clock.elapsed());
     qsizetype num_starts = qMin(m_queue.size(), m_total_max_size - m_doing.size());
     auto task_progress = std::make_shared<TaskStepProgress>(next->getUid());
     m_task_progress.insert(next->getUid(), task_progress);
@@ -162,12 +180,13 @@ void ConcurrentTask::subTaskSucceeded(Task::Ptr task)
     m_succeeded.insert(task.get(), task);
 
     m_doing.remove(task.get());
+    adaptConcurrency(task.get(), false);
     auto task_progress = m_task_progress.value(task->getUid());
     task_progress->state = TaskStepState::Succeeded;
 
     disconnect(task.get(), 0, this, 0);
 
-    emit stepProgress(*task_progress);
+    propagateStepProgress(*task_progress);
     updateState();
     updateStepProgress(*task_progress, Operation::REMOVED);
     startNext();
@@ -179,13 +198,14 @@ void ConcurrentTask::subTaskFailed(Task::Ptr task, [[maybe_unused]] const QStrin
     m_failed.insert(task.get(), task);
 
     m_doing.remove(task.get());
+    adaptConcurrency(task.get(), true);
 
     auto task_progress = m_task_progress.value(task->getUid());
     task_progress->state = TaskStepState::Failed;
 
     disconnect(task.get(), 0, this, 0);
 
-    emit stepProgress(*task_progress);
+    propagateStepProgress(*task_progress);
     updateState();
     updateStepProgress(*task_progress, Operation::REMOVED);
     startNext();
@@ -197,7 +217,7 @@ void ConcurrentTask::subTaskStatus(Task::Ptr task, const QString& msg)
     task_progress->status = msg;
     task_progress->state = TaskStepState::Running;
 
-    emit stepProgress(*task_progress);
+    propagateStepProgress(*task_progress);
 
     if (totalSize() == 1) {
         setStatus(msg);
@@ -210,7 +230,7 @@ void ConcurrentTask::subTaskDetails(Task::Ptr task, const QString& msg)
     task_progress->details = msg;
     task_progress->state = TaskStepState::Running;
 
-    emit stepProgress(*task_progress);
+    propagateStepProgress(*task_progress);
 
     if (totalSize() == 1) {
         setDetails(msg);
@@ -222,8 +242,10 @@ void ConcurrentTask::subTaskProgress(Task::Ptr task, qint64 current, qint64 tota
     auto task_progress = m_task_progress.value(task->getUid());
 
     task_progress->update(current, total);
+    if (m_adaptive && task_progress->total == task_progress->old_total)
+        m_adaptive->addWork(task_progress->current - task_progress->old_current);
 
-    emit stepProgress(*task_progress);
+    propagateStepProgress(*task_progress);
     updateStepProgress(*task_progress, Operation::CHANGED);
     updateState();
 
@@ -239,7 +261,7 @@ void ConcurrentTask::subTaskStepProgress(Task::Ptr task, TaskStepProgress const&
     if (!m_task_progress.contains(task_progress.uid)) {
         m_task_progress.insert(task_progress.uid, std::make_shared<TaskStepProgress>(task_progress));
         op = Operation::ADDED;
-        emit stepProgress(task_progress);
+        propagateStepProgress(task_progress);
         updateStepProgress(task_progress, op);
     } else {
         auto tp = m_task_progress.value(task_progress.uid);
@@ -253,11 +275,24 @@ void ConcurrentTask::subTaskStepProgress(Task::Ptr task, TaskStepProgress const&
         tp->details = task_progress.details;
 
         op = Operation::CHANGED;
-        emit stepProgress(*tp.get());
+        propagateStepProgress(*tp.get());
         updateStepProgress(*tp.get(), op);
     }
 }
 
+void ConcurrentTask::adaptConcurrency(Task* task, bool failed)
+{
+    if (!m_adaptive || !m_started_at.contains(task))
+        return;
+
+    auto now = m_clock.elapsed();
+    auto limit = m_adaptive->taskFinished(now, now - m_started_at.take(task), failed);
+    if (limit != m_total_max_size) {
+        qDebug() << m_name << "now runs up to" << limit << "tasks at once, was" << m_total_max_size;
+        m_total_max_size = limit;
+    }
+}
+
 void ConcurrentTask::updateStepProgress(TaskStepProgress const& changed_progress, Operation op)
 {
     switch (op) {
@@ -35,12 +35,14 @@
  */
 #pragma once
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QQueue>
 #include <QSet>
 #include <QUuid>
 #include <memory>
 
+#include "tasks/AdaptiveConcurrency.h"
 #include "tasks/Task.h"
 
 class ConcurrentTask : public Task {
@@ -53,6 +55,9 @@ class ConcurrentTask : public Task {
 
     // safe to call before starting the task
     void setMaxConcurrent(int max_concurrent) { m_total_max_size = max_concurrent; }
+    // let the number of tasks in flight follow the observed throughput and latency, starting from the current one
+    // safe to call before starting the task
+    void setAdaptiveConcurrency(int min_concurrent, int max_concurrent);
 
     bool canAbort() const override { return true; }
 
@@ -75,7 +80,7 @@ class ConcurrentTask : public Task {
     virtual void startNext();
 
     void subTaskSucceeded(Task::Ptr);
-    void subTaskFailed(Task::Ptr, const QString& msg);
+    virtual void subTaskFailed(Task::Ptr, const QString& msg);
     void subTaskStatus(Task::Ptr task, const QString& msg);
     void subTaskDetails(Task::Ptr task, const QString& msg);
     void subTaskProgress(Task::Ptr task, qint64 current, qint64 total);
@@ -90,6 +95,12 @@ class ConcurrentTask : public Task {
 
     virtual void updateState();
 
+    // take the next task to start out of the queue, or null if none of them can start right now
+    virtual auto dequeueNext() -> Task::Ptr { return m_queue.dequeue(); }
+
+    // feed a finished task to the adaptive controller, if there's one
+    void adaptConcurrency(Task* task, bool failed);
+
    protected:
     QString m_name;
     QString m_step_status;
@@ -105,6 +116,11 @@ class ConcurrentTask : public Task {
 
     int m_total_max_size;
 
+    std::unique_ptr<AdaptiveConcurrency> m_adaptive;
+    QElapsedTimer m_clock;
+    // when each running task started, per m_clock
+    QHash<Task*, qint64> m_started_at;
+
     qint64 m_stepProgress = 0;
     qint64 m_stepTotalProgress = 100;
 
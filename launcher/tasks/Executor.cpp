@@ -0,0 +1,91 @@
+#include "Executor.h"
+
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+// whether the current thread is one of the workers of an executor
+static thread_local Executor* s_current = nullptr;
+
+Executor* Executor::instance()
+{
+    static auto* executor = new Executor;
+    return executor;
+}
+
+Executor::Executor(int max_threads) : m_max_threads(std::max(2, max_threads)), m_max_deferred(m_max_threads - 1)
+{
+    m_pool.setMaxThreadCount(m_max_threads);
+}
+
+Executor::~Executor()
+{
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto& queue : m_queues)
+            queue.clear();
+    }
+    m_pool.waitForDone();
+}
+
+void Executor::post(Priority priority, std::function<void()> work)
+{
+    QMutexLocker locker(&m_lock);
+    m_queues[static_cast<int>(priority)].enqueue({ priority, std::move(work) });
+    if (m_workers < m_max_threads) {
+        m_workers++;
+        QtConcurrent::run(&m_pool, [this] { this->work(); });
+    }
+}
+
+bool Executor::takeNext(Job& job, bool ignore_limits)
+{
+    for (auto& queue : m_queues) {
+        if (queue.isEmpty())
+            continue;
+        bool deferred = queue.head().priority != Priority::Interactive;
+        // what's less urgent comes after this anyway
+        if (deferred && !ignore_limits && m_running_deferred >= m_max_deferred)
+            return false;
+        job = queue.dequeue();
+        return true;
+    }
+    return false;
+}
+
+bool Executor::runQueued()
+{
+    if (s_current != this)
+        return false;
+
+    Job job;
+    {
+        QMutexLocker locker(&m_lock);
+        // the thread is already counted for the job that's waiting
+        if (!takeNext(job, true))
+            return false;
+    }
+    job.work();
+    return true;
+}
+
+void Executor::work()
+{
+    s_current = this;
+    QMutexLocker locker(&m_lock);
+    Job job;
+    while (takeNext(job, false)) {
+        bool deferred = job.priority != Priority::Interactive;
+        if (deferred)
+            m_running_deferred++;
+        locker.unlock();
+        job.work();
+        job = {};
+        locker.relock();
+        if (deferred)
+            m_running_deferred--;
+    }
+    m_workers--;
+    s_current = nullptr;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QThreadPool>
+
+#include <array>
+#include <functional>
+#include <type_traits>
+
+#include "tasks/CancellationToken.h"
+
+/**
+ * Runs the heavy work of the launcher on threads of its own, the most urgent first.
+ *
+ * Copies, imports, exports and extraction used to go through the global pool in the order they came, so a thumbnail
+ * could wait behind a whole modpack. Here every job has a priority: interactive ones are what the user is looking at
+ * right now, background ones are for later and bulk ones move lots of data. Background and bulk jobs never take the
+ * last thread alone, so interactive ones can always start.
+ *
+ * A job that's cancelled before it starts doesn't run, and the ones that do run should check their token between
+ * their steps. A job waiting for another one with waitFor() runs what's queued meanwhile instead of blocking a thread.
+ */
+class Executor {
+   public:
+    enum class Priority { Interactive, Background, Bulk };
+
+    static Executor* instance();
+
+    explicit Executor(int max_threads = QThread::idealThreadCount());
+    ~Executor();
+
+    /// run `work` on a thread of the executor, the future is cancelled if `token` is before it starts
+    template <typename F>
+    auto run(Priority priority, F&& work, CancellationToken token = {}) -> QFuture<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        QFutureInterface<Result> promise;
+        promise.reportStarted();
+        post(priority, [promise, token, work = std::forward<F>(work)]() mutable {
+            if (token.isCancelled())
+                promise.cancel();
+            if (!promise.isCanceled()) {
+                if constexpr (std::is_void_v<Result>)
+                    work();
+                else
+                    promise.reportResult(work());
+            }
+            promise.reportFinished();
+        });
+        return promise.future();
+    }
+
+    /// wait for `future`, running queued jobs meanwhile when called on one of the threads of the executor
+    template <typename T>
+    void waitFor(const QFuture<T>& future)
+    {
+        while (!future.isFinished()) {
+            if (!runQueued()) {
+                future.waitForFinished();
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] int maxThreadCount() const { return m_max_threads; }
+    [[nodiscard]] int activeThreadCount() const { return m_pool.activeThreadCount(); }
+
+   private:
+    struct Job {
+        Priority priority = Priority::Interactive;
+        std::function<void()> work;
+    };
+
+    void post(Priority priority, std::function<void()> work);
+    // the most urgent job allowed to start, with m_lock held
+    bool takeNext(Job& job, bool ignore_limits);
+    // run one queued job right here, if this is one of our threads and there's one
+    bool runQueued();
+    void work();
+
+   private:
+    QThreadPool m_pool;
+    int m_max_threads;
+    // how many threads background and bulk jobs may have at once
+    int m_max_deferred;
+
+    QMutex m_lock;
+    std::array<QQueue<Job>, 3> m_queues;
+    int m_workers = 0;
+    int m_running_deferred = 0;
+};
@@ -36,24 +36,65 @@
 
 #include <QDebug>
 
-MultipleOptionsTask::MultipleOptionsTask(QObject* parent, const QString& task_name) : SequentialTask(parent, task_name) {}
+MultipleOptionsTask::MultipleOptionsTask(QObject* parent, const QString& task_name) : SequentialTask(parent, task_name)
+{
+    m_hedge_timer.setSingleShot(true);
+    connect(&m_hedge_timer, &QTimer::timeout, this, &MultipleOptionsTask::startNext);
+}
+
+void MultipleOptionsTask::setHedging(std::chrono::milliseconds delay, int max_concurrent)
+{
+    m_hedged = true;
+    m_hedge_timer.setInterval(delay);
+    setMaxConcurrent(max_concurrent);
+}
 
 void MultipleOptionsTask::startNext()
 {
+    if (m_aborted || !isRunning())
+        return;
+
     if (m_done.size() != m_failed.size()) {
+        abortOthers();
         emitSucceeded();
         return;
     }
 
     if (m_queue.isEmpty()) {
+        // the options still racing may yet succeed
+        if (!m_doing.isEmpty())
+            return;
         emitFailed(tr("All attempts have failed!"));
         qWarning() << "All attempts have failed!";
         return;
     }
 
+    if (m_hedged) {
+        if (m_doing.size() >= m_total_max_size)
+            return;
+        // the last one started gets its head start, one that failed makes way right away
+        if (m_hedge_timer.isActive() && m_doing.contains(m_last_started))
+            return;
+        m_last_started = m_queue.head().get();
+        if (m_hedge_timer.interval() > 0)
+            m_hedge_timer.start();
+    }
+
     ConcurrentTask::startNext();
 }
 
+void MultipleOptionsTask::abortOthers()
+{
+    m_hedge_timer.stop();
+    m_queue.clear();
+    for (auto& task : m_doing) {
+        // they're done as far as this is concerned, what they do while aborting doesn't matter
+        disconnect(task.get(), nullptr, this, nullptr);
+        task->abort();
+    }
+    m_doing.clear();
+}
+
 void MultipleOptionsTask::updateState()
 {
     setProgress(m_done.count(), totalSize());
@@ -34,6 +34,10 @@
  */
 #pragma once
 
+#include <QTimer>
+
+#include <chrono>
+
 #include "SequentialTask.h"
 
 /* This task type will attempt to do run each of it's subtasks in sequence,
@@ -45,7 +49,21 @@ class MultipleOptionsTask : public SequentialTask {
     explicit MultipleOptionsTask(QObject* parent = nullptr, const QString& task_name = "");
     ~MultipleOptionsTask() override = default;
 
+    /* Race the options instead of waiting for each to fail: the next one starts once the last one has run for `delay`
+     * without finishing, up to `max_concurrent` at a time, and the first to succeed aborts the others.
+     * A delay of 0 starts them all at once. Safe to call before starting the task.
+     * */
+    void setHedging(std::chrono::milliseconds delay, int max_concurrent = 2);
+
    private slots:
     void startNext() override;
     void updateState() override;
+
+   private:
+    void abortOthers();
+
+   private:
+    bool m_hedged = false;
+    QTimer m_hedge_timer;
+    Task* m_last_started = nullptr;
 };
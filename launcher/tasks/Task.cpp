@@ -37,13 +37,27 @@
 #include "Task.h"
 
 #include <QDebug>
+#include <QThread>
+
+#include <memory>
+
+#include "Trace.h"
 
 Q_LOGGING_CATEGORY(taskLogC, "launcher.task")
 
-Task::Task(QObject* parent, bool show_debug) : QObject(parent), m_show_debug(show_debug)
+// how long the listeners of a task go without hearing about its progress at least, so that they hear about it 20 times a second at most
+static constexpr int publishInterval = 1000 / 20;
+
+Task::Task(QObject* parent, bool show_debug) : QObject(parent), m_show_debug(show_debug), m_publishTimer(this)
 {
     m_uid = QUuid::createUuid();
     setAutoDelete(false);
+
+    m_publishTimer.setSingleShot(true);
+    connect(&m_publishTimer, &QTimer::timeout, this, [this] {
+        m_lastPublish.start();
+        flushProgress();
+    });
 }
 
 void Task::setStatus(const QString& new_status)
@@ -67,9 +81,53 @@ void Task::setProgress(qint64 current, qint64 total)
     if ((m_progress != current) || (m_progressTotal != total)) {
         m_progress = current;
         m_progressTotal = total;
+        m_progressChanged = true;
 
-        emit progress(m_progress, m_progressTotal);
+        schedulePublish();
+    }
+}
+
+void Task::schedulePublish()
+{
+    // the publish that's on its way takes along whatever changes until it runs
+    if (m_publishQueued.exchange(true))
+        return;
+    if (QThread::currentThread() == thread())
+        publishProgress();
+    else
+        QMetaObject::invokeMethod(this, &Task::publishProgress, Qt::QueuedConnection);
+}
+
+void Task::publishProgress()
+{
+    if (!m_publishQueued)
+        return;
+    if (m_lastPublish.isValid() && m_lastPublish.elapsed() < publishInterval) {
+        if (!m_publishTimer.isActive())
+            m_publishTimer.start(publishInterval - static_cast<int>(m_lastPublish.elapsed()));
+        return;
+    }
+    m_lastPublish.start();
+    flushProgress();
+}
+
+void Task::flushProgress()
+{
+    // whatever changes from here on gets published again
+    m_publishQueued = false;
+
+    // the steps and the timer belong to the thread of the task, and nothing is held back for other threads
+    if (QThread::currentThread() == thread()) {
+        m_publishTimer.stop();
+        auto steps = std::move(m_pendingSteps);
+        m_pendingSteps.clear();
+        m_pendingStepIndex.clear();
+        for (auto& step : steps)
+            emit stepProgress(step);
     }
+
+    if (m_progressChanged.exchange(false))
+        emit progress(m_progress, m_progressTotal);
 }
 
 void Task::start()
@@ -103,6 +161,10 @@ void Task::start()
     }
     // NOTE: only fall through to here in end states
     m_state = State::Running;
+    // what was cancelled the last time shouldn't stop this one
+    m_cancellation = CancellationToken();
+    if (Trace::isEnabled())
+        traceStarted();
     emit started();
     executeTask();
 }
@@ -114,6 +176,8 @@ void Task::emitFailed(QString reason)
         qCCritical(taskLogC) << "Task" << describe() << "failed while not running!!!!: " << reason;
         return;
     }
+    flushProgress();
+    m_cancellation.cancel();
     m_state = State::Failed;
     m_failReason = reason;
     qCCritical(taskLogC) << "Task" << describe() << "failed: " << reason;
@@ -128,6 +192,8 @@ void Task::emitAborted()
         qCCritical(taskLogC) << "Task" << describe() << "aborted while not running!!!!";
         return;
     }
+    flushProgress();
+    m_cancellation.cancel();
     m_state = State::AbortedByUser;
     m_failReason = "Aborted.";
     if (m_show_debug)
@@ -143,6 +209,7 @@ void Task::emitSucceeded()
         qCCritical(taskLogC) << "Task" << describe() << "succeeded while not running!!!!";
         return;
     }
+    flushProgress();
     m_state = State::Succeeded;
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "succeeded";
@@ -152,7 +219,54 @@ void Task::emitSucceeded()
 
 void Task::propagateStepProgress(TaskStepProgress const& task_progress)
 {
-    emit stepProgress(task_progress);
+    if (QThread::currentThread() != thread()) {
+        emit stepProgress(task_progress);
+        return;
+    }
+
+    // only the latest of a step is worth telling about
+    auto index = m_pendingStepIndex.find(task_progress.uid);
+    if (index != m_pendingStepIndex.end()) {
+        m_pendingSteps[*index] = task_progress;
+    } else {
+        m_pendingStepIndex.insert(task_progress.uid, m_pendingSteps.size());
+        m_pendingSteps.append(task_progress);
+    }
+    schedulePublish();
+}
+
+void Task::traceStarted()
+{
+    m_traceName = objectName().isEmpty() ? metaObject()->className() : QString("%1 %2").arg(metaObject()->className(), objectName());
+    Trace::asyncBegin("task", m_traceName, this, { { "uid", m_uid.toString(QUuid::WithoutBraces) } });
+
+    // some tasks finish without going through emitSucceeded and the others
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(
+        this, &Task::finished, this,
+        [this, connection] {
+            disconnect(*connection);
+            tracePhase({});
+            static const char* states[] = { "inactive", "running", "succeeded", "failed", "aborted" };
+            QJsonObject args{ { "state", states[static_cast<int>(m_state)] } };
+            if (!m_failReason.isEmpty())
+                args.insert("reason", m_failReason);
+            Trace::asyncEnd("task", m_traceName, this, args);
+            m_traceName.clear();
+        },
+        Qt::DirectConnection);
+}
+
+void Task::tracePhase(const QString& name, const QJsonObject& args)
+{
+    if (!m_tracePhase.isEmpty()) {
+        Trace::asyncEnd("task", m_tracePhase, this);
+        m_tracePhase.clear();
+    }
+    if (name.isEmpty() || !Trace::isEnabled() || m_traceName.isEmpty())
+        return;
+    m_tracePhase = name;
+    Trace::asyncBegin("task", m_tracePhase, this, args);
 }
 
 QString Task::describe()
@@ -36,11 +36,18 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
 #include <QLoggingCategory>
 #include <QRunnable>
+#include <QTimer>
 #include <QUuid>
 
+#include <atomic>
+
 #include "QObjectPtr.h"
+#include "tasks/CancellationToken.h"
 
 Q_DECLARE_LOGGING_CATEGORY(taskLogC)
 
@@ -121,11 +128,18 @@ class Task : public QObject, public QRunnable {
 
     QUuid getUid() { return m_uid; }
 
+    /// cancelled once the task is aborted, for the work it runs elsewhere to stop early
+    CancellationToken cancellationToken() const { return m_cancellation; }
+
    protected:
     void logWarning(const QString& line);
 
+    /// start recording the next part of the task in the trace, ending the one before, if the trace is on
+    void tracePhase(const QString& name, const QJsonObject& args = {});
+
    private:
     QString describe();
+    void traceStarted();
 
    signals:
     void started();
@@ -149,8 +163,10 @@ class Task : public QObject, public QRunnable {
     virtual void start();
     virtual bool abort()
     {
-        if (canAbort())
+        if (canAbort()) {
+            m_cancellation.cancel();
             emitAborted();
+        }
         return canAbort();
     }
 
@@ -175,14 +191,25 @@ class Task : public QObject, public QRunnable {
     void setDetails(const QString& details);
     void setProgress(qint64 current, qint64 total);
 
+   protected:
+    /** Tells about the progress that's still held back right away, like before the task finishes.
+     *  Progress reaches the listeners a limited number of times a second, with the latest values.
+     */
+    void flushProgress();
+
+   private:
+    void schedulePublish();
+    void publishProgress();
+
    protected:
     State m_state = State::Inactive;
     QStringList m_Warnings;
     QString m_failReason = "";
     QString m_status;
     QString m_details;
-    int m_progress = 0;
-    int m_progressTotal = 100;
+    // may be set from any thread, they're told about on the thread of the task
+    std::atomic<qint64> m_progress = 0;
+    std::atomic<qint64> m_progressTotal = 100;
 
     // TODO: Nuke in favor of QLoggingCategory
     bool m_show_debug = true;
@@ -191,4 +218,17 @@ class Task : public QObject, public QRunnable {
     // Change using setAbortStatus
     bool m_can_abort = false;
     QUuid m_uid;
+    CancellationToken m_cancellation;
+
+    std::atomic<bool> m_progressChanged = false;
+    std::atomic<bool> m_publishQueued = false;
+    QElapsedTimer m_lastPublish;
+    QTimer m_publishTimer;
+    // the latest of each step since the last publish, in the order they first changed
+    QList<TaskStepProgress> m_pendingSteps;
+    QHash<QUuid, int> m_pendingStepIndex;
+
+    // what the task and its current part are called in the trace
+    QString m_traceName;
+    QString m_tracePhase;
 };
@@ -0,0 +1,113 @@
+#include "TaskGraph.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+TaskGraph::TaskGraph(QObject* parent, QString task_name, int max_concurrent) : ConcurrentTask(parent, task_name, max_concurrent) {}
+
+void TaskGraph::addTask(Task::Ptr task, const QList<Task::Ptr>& dependencies, int retries)
+{
+    Node node;
+    node.retries = std::max(0, retries);
+    for (auto& dependency : dependencies)
+        node.dependencies.append(dependency.get());
+    m_nodes.insert(task.get(), node);
+    ConcurrentTask::addTask(task);
+}
+
+bool TaskGraph::isReady(Task* task) const
+{
+    auto node = m_nodes.constFind(task);
+    if (node == m_nodes.constEnd())
+        return true;
+    return std::all_of(node->dependencies.begin(), node->dependencies.end(), [this](Task* dependency) {
+        return m_succeeded.contains(dependency);
+    });
+}
+
+auto TaskGraph::dequeueNext() -> Task::Ptr
+{
+    auto ready = std::find_if(m_queue.begin(), m_queue.end(), [this](const Task::Ptr& task) { return isReady(task.get()); });
+    if (ready == m_queue.end())
+        return nullptr;
+    auto next = *ready;
+    m_queue.erase(ready);
+    return next;
+}
+
+bool TaskGraph::dropUnreachable()
+{
+    auto unreachable = [this](Task* task) {
+        auto node = m_nodes.constFind(task);
+        if (node == m_nodes.constEnd())
+            return false;
+        return std::any_of(node->dependencies.begin(), node->dependencies.end(),
+                           [this](Task* dependency) { return m_failed.contains(dependency); });
+    };
+
+    bool dropped = false;
+    // leaving one out leaves out what depends on it in turn
+    for (bool again = true; again;) {
+        again = false;
+        for (auto it = m_queue.begin(); it != m_queue.end();) {
+            if (!unreachable(it->get())) {
+                ++it;
+                continue;
+            }
+            m_done.insert(it->get(), *it);
+            m_failed.insert(it->get(), *it);
+            it = m_queue.erase(it);
+            dropped = again = true;
+        }
+    }
+    return dropped;
+}
+
+void TaskGraph::startNext()
+{
+    if (m_aborted || !isRunning())
+        return;
+
+    if (dropUnreachable())
+        updateState();
+
+    if (m_doing.isEmpty() && !m_queue.isEmpty() &&
+        std::none_of(m_queue.begin(), m_queue.end(), [this](const Task::Ptr& task) { return isReady(task.get()); })) {
+        qWarning() << m_name << "has" << m_queue.size() << "tasks waiting for each other or for tasks that aren't part of it";
+        emitFailed(tr("Some of the tasks can never start."));
+        return;
+    }
+
+    if (m_queue.isEmpty() && m_doing.isEmpty() && !m_failed.isEmpty()) {
+        emitFailed(m_failure.isEmpty() ? tr("One of the tasks failed!") : m_failure);
+        return;
+    }
+
+    ConcurrentTask::startNext();
+}
+
+void TaskGraph::subTaskFailed(Task::Ptr task, const QString& msg)
+{
+    auto node = m_nodes.find(task.get());
+    bool retry = !m_aborted && node != m_nodes.end() && node->retries > 0 && task->getState() != State::AbortedByUser;
+    if (!retry) {
+        if (m_failure.isEmpty())
+            m_failure = msg;
+        ConcurrentTask::subTaskFailed(task, msg);
+        return;
+    }
+
+    node->retries--;
+    qWarning() << m_name << "is trying a failed task again," << node->retries << "more tries left:" << msg;
+    disconnect(task.get(), 0, this, 0);
+    m_doing.remove(task.get());
+    adaptConcurrency(task.get(), true);
+    // it gets a step of its own again when it starts
+    if (auto task_progress = m_task_progress.take(task->getUid()))
+        updateStepProgress(*task_progress, Operation::REMOVED);
+    m_queue.prepend(task);
+
+    updateState();
+    startNext();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+
+#include "tasks/ConcurrentTask.h"
+
+/** A concurrent task whose tasks wait for the ones they depend on.
+ *
+ *  Everything whose dependencies all succeeded runs at once, up to the concurrency limit, so stages that don't
+ *  need each other overlap instead of going one after the other like in a SequentialTask. A task that fails is
+ *  tried again as many times as it was added with. When it still fails, what depends on it is left out, the rest
+ *  keeps going and the graph fails once nothing else can run. Tasks that can never start, because they depend on
+ *  each other or on a task that isn't part of the graph, fail it too.
+ */
+class TaskGraph : public ConcurrentTask {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<TaskGraph>;
+
+    explicit TaskGraph(QObject* parent = nullptr, QString task_name = "", int max_concurrent = 6);
+    ~TaskGraph() override = default;
+
+    /// add `task`, to start once all of `dependencies` succeeded, trying it again up to `retries` times when it fails
+    void addTask(Task::Ptr task, const QList<Task::Ptr>& dependencies = {}, int retries = 0);
+
+   protected slots:
+    void startNext() override;
+    void subTaskFailed(Task::Ptr task, const QString& msg) override;
+
+   protected:
+    auto dequeueNext() -> Task::Ptr override;
+
+   private:
+    struct Node {
+        QList<Task*> dependencies;
+        int retries = 0;
+    };
+
+    [[nodiscard]] bool isReady(Task* task) const;
+    // leave out what depends on a task that failed for good, returns whether there was any
+    bool dropUnreachable();
+
+   private:
+    QHash<Task*, Node> m_nodes;
+    // why the first task that failed for good did
+    QString m_failure;
+};
@@ -0,0 +1,37 @@
+#include "AsyncProfiler.h"
+
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include "ProfileRecorder.h"
+#include "settings/SettingsObject.h"
+
+void AsyncProfilerFactory::registerSettings(SettingsObjectPtr settings)
+{
+    settings->registerSetting("AsyncProfilerPath", QStandardPaths::findExecutable("asprof"));
+    globalSettings = settings;
+}
+
+BaseExternalTool* AsyncProfilerFactory::createTool(InstancePtr instance, QObject* parent)
+{
+    return new RecordingProfiler(globalSettings, instance, ProfileRecorder::Backend::AsyncProfiler, parent);
+}
+
+bool AsyncProfilerFactory::check(QString* error)
+{
+    return check(globalSettings->get("AsyncProfilerPath").toString(), error);
+}
+
+bool AsyncProfilerFactory::check(const QString& path, QString* error)
+{
+    if (path.isEmpty()) {
+        *error = QObject::tr("Empty path");
+        return false;
+    }
+    QFileInfo finfo(path);
+    if (!finfo.isExecutable() || !finfo.fileName().startsWith("asprof")) {
+        *error = QObject::tr("Invalid path to asprof");
+        return false;
+    }
+    return true;
+}
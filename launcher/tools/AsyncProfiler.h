@@ -0,0 +1,12 @@
+#pragma once
+
+#include "BaseProfiler.h"
+
+class AsyncProfilerFactory : public BaseProfilerFactory {
+   public:
+    QString name() const override { return "async-profiler"; }
+    void registerSettings(SettingsObjectPtr settings) override;
+    BaseExternalTool* createTool(InstancePtr instance, QObject* parent = 0) override;
+    bool check(QString* error) override;
+    bool check(const QString& path, QString* error) override;
+};
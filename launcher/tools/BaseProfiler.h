@@ -25,6 +25,8 @@ class BaseProfiler : public BaseExternalTool {
 
    signals:
     void readyToLaunch(const QString& message);
+    /// the profiler needs nothing from the user, the launch goes on right away
+    void recordingStarted(const QString& message);
     void abortLaunch(const QString& message);
 };
 
@@ -0,0 +1,25 @@
+#include "FlightRecorder.h"
+
+#include "ProfileRecorder.h"
+#include "settings/SettingsObject.h"
+
+void FlightRecorderFactory::registerSettings(SettingsObjectPtr settings)
+{
+    globalSettings = settings;
+}
+
+BaseExternalTool* FlightRecorderFactory::createTool(InstancePtr instance, QObject* parent)
+{
+    return new RecordingProfiler(globalSettings, instance, ProfileRecorder::Backend::FlightRecorder, parent);
+}
+
+bool FlightRecorderFactory::check(QString* error)
+{
+    return check(QString(), error);
+}
+
+bool FlightRecorderFactory::check([[maybe_unused]] const QString& path, [[maybe_unused]] QString* error)
+{
+    // it comes with the JDK the instance runs on, that's only known at launch
+    return true;
+}
@@ -0,0 +1,199 @@
+#include "ProfileRecorder.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QStandardPaths>
+
+#include "BaseInstance.h"
+#include "FileSystem.h"
+#include "launch/LaunchTask.h"
+#include "settings/SettingsObject.h"
+#include "tasks/Executor.h"
+
+namespace {
+// what the flight recording is called in the game, to stop it again
+const QString recordingName = "launcher-profile";
+}  // namespace
+
+ProfileRecorder::ProfileRecorder(Backend backend, QString tool, qint64 pid, QString outputDir, QObject* parent)
+    : QObject(parent), m_backend(backend), m_tool(std::move(tool)), m_pid(pid), m_outputDir(std::move(outputDir))
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &ProfileRecorder::stop);
+}
+
+QString ProfileRecorder::jdkTool(const QString& javaPath, const QString& name)
+{
+    auto java = QFileInfo(javaPath).isAbsolute() ? javaPath : QStandardPaths::findExecutable(javaPath);
+    if (java.isEmpty())
+        return {};
+    // /usr/bin/java and the like are links into the JDK
+    QDir bin = QFileInfo(QFileInfo(java).canonicalFilePath()).absoluteDir();
+#ifdef Q_OS_WIN32
+    auto tool = bin.filePath(name + ".exe");
+#else
+    auto tool = bin.filePath(name);
+#endif
+    return QFileInfo(tool).isExecutable() ? tool : QString();
+}
+
+void ProfileRecorder::run(const QString& program, const QStringList& args, std::function<void(const QByteArray& output)> done)
+{
+    auto process = new QProcess(this);
+    process->setProgram(program);
+    process->setArguments(args);
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, process, done](int exitCode, QProcess::ExitStatus status) {
+                process->deleteLater();
+                if (status != QProcess::NormalExit || exitCode != 0) {
+                    auto output = QString::fromLocal8Bit(process->readAllStandardError() + process->readAllStandardOutput()).trimmed();
+                    emit failed(tr("%1 failed: %2").arg(QFileInfo(process->program()).fileName(), output));
+                    return;
+                }
+                done(process->readAllStandardOutput());
+            });
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart)
+            return;
+        process->deleteLater();
+        emit failed(tr("Couldn't run %1: %2").arg(process->program(), process->errorString()));
+    });
+    process->start();
+}
+
+void ProfileRecorder::start(int seconds)
+{
+    if (!FS::ensureFolderPathExists(m_outputDir)) {
+        emit failed(tr("Couldn't create the folder %1").arg(m_outputDir));
+        return;
+    }
+    auto stamp = QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss");
+    auto pid = QString::number(m_pid);
+    auto started = [this, seconds](const QByteArray&) {
+        m_recording = true;
+        emit this->started();
+        m_timer.start(seconds * 1000);
+    };
+
+    if (m_backend == Backend::FlightRecorder) {
+        m_recordingPath = FS::PathCombine(m_outputDir, stamp + ".jfr");
+        // written when the game quits before the recording is stopped
+        run(m_tool, { pid, "JFR.start", "name=" + recordingName, "settings=profile", "dumponexit=true", "filename=" + m_recordingPath },
+            started);
+    } else {
+        m_recordingPath = FS::PathCombine(m_outputDir, stamp + ".collapsed.txt");
+        run(m_tool, { "start", pid }, started);
+    }
+}
+
+void ProfileRecorder::stop()
+{
+    if (!m_recording)
+        return;
+    m_recording = false;
+    m_timer.stop();
+
+    auto pid = QString::number(m_pid);
+    if (m_backend == Backend::FlightRecorder) {
+        run(m_tool, { pid, "JFR.stop", "name=" + recordingName }, [this](const QByteArray&) {
+            // jfr comes with jcmd
+            QFileInfo jcmd(m_tool);
+            auto jfr = jcmd.dir().filePath(jcmd.fileName().replace("jcmd", "jfr"));
+            run(jfr, { "print", "--json", "--events", "jdk.ExecutionSample,jdk.GarbageCollection", m_recordingPath },
+                [this](const QByteArray& output) { summarize(output); });
+        });
+    } else {
+        run(m_tool, { "stop", "-o", "collapsed", "-f", m_recordingPath, pid }, [this](const QByteArray&) {
+            QFile file(m_recordingPath);
+            if (!file.open(QIODevice::ReadOnly)) {
+                emit failed(tr("Couldn't read the recording %1: %2").arg(m_recordingPath, file.errorString()));
+                return;
+            }
+            summarize(file.readAll());
+        });
+    }
+}
+
+void ProfileRecorder::summarize(const QByteArray& data)
+{
+    auto watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        auto summary = watcher->result();
+        if (summary.isEmpty()) {
+            emit failed(tr("Couldn't read the recording %1").arg(m_recordingPath));
+            return;
+        }
+        QFile file(m_recordingPath + ".summary.txt");
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text))
+            file.write(summary.toUtf8() + '\n');
+        emit finished(summary);
+    });
+    // a flight recording prints to a lot of JSON
+    watcher->setFuture(Executor::instance()->run(Executor::Priority::Background, [backend = m_backend, data] {
+        if (backend == Backend::AsyncProfiler)
+            return ProfileSummary::fromCollapsedStacks(data).toText();
+        auto summary = ProfileSummary::fromFlightRecording(data);
+        return summary ? summary->toText() : QString();
+    }));
+}
+
+RecordingProfiler::RecordingProfiler(SettingsObjectPtr settings, InstancePtr instance, ProfileRecorder::Backend backend, QObject* parent)
+    : BaseProfiler(settings, instance, parent), m_backend(backend)
+{}
+
+QString RecordingProfiler::profilesDir(const BaseInstance* instance)
+{
+    return FS::PathCombine(instance->instanceRoot(), "profiles");
+}
+
+QString RecordingProfiler::toolFor(ProfileRecorder::Backend backend, BaseInstance* instance, SettingsObjectPtr settings)
+{
+    if (backend == ProfileRecorder::Backend::FlightRecorder)
+        return ProfileRecorder::jdkTool(instance->settings()->get("JavaPath").toString(), "jcmd");
+    auto asprof = settings->get("AsyncProfilerPath").toString();
+    return QFileInfo(asprof).isExecutable() ? asprof : QString();
+}
+
+void RecordingProfiler::beginProfilingImpl(shared_qobject_ptr<LaunchTask> process)
+{
+    auto tool = toolFor(m_backend, m_instance.get(), globalSettings);
+    if (tool.isEmpty()) {
+        emit abortLaunch(m_backend == ProfileRecorder::Backend::FlightRecorder
+                             ? tr("JDK Flight Recorder needs the instance to run on a JDK, there's no jcmd next to its Java.")
+                             : tr("async-profiler isn't set up in the external tools settings."));
+        return;
+    }
+
+    auto seconds = globalSettings->get("ProfileRecordingSeconds").toInt();
+    QPointer<LaunchTask> launch(process.get());
+    auto recording = std::make_shared<bool>(false);
+    auto recorder = new ProfileRecorder(m_backend, tool, process->pid(), profilesDir(m_instance.get()), this);
+    connect(recorder, &ProfileRecorder::started, this, [this, seconds, recording] {
+        *recording = true;
+        emit recordingStarted(tr("Recording a profile of the game for %1 seconds.").arg(seconds));
+    });
+    connect(recorder, &ProfileRecorder::finished, this, [recorder, launch](const QString& summary) {
+        if (launch)
+            launch->onLogLines((tr("Profile recorded to %1").arg(recorder->recordingPath()) + '\n' + summary).split('\n'));
+    });
+    connect(recorder, &ProfileRecorder::failed, this, [this, launch, recording](const QString& error) {
+        if (!*recording)
+            emit abortLaunch(error);
+        else if (launch)
+            launch->onLogLine(error, MessageLevel::Error);
+    });
+    m_recorder = recorder;
+    recorder->start(seconds);
+}
+
+void RecordingProfiler::abortProfilingImpl()
+{
+    if (m_recorder)
+        m_recorder->stop();
+    emit abortLaunch(tr("Profiler aborted"));
+}
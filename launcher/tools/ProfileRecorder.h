@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <functional>
+
+#include "BaseProfiler.h"
+#include "ProfileSummary.h"
+
+/**
+ * Records what a running game spends its time on for a while, with JDK Flight Recorder or async-profiler, and sums it up.
+ *
+ * Both attach to the game by its pid, so no agent has to be installed in the instance and a game that's already
+ * running can be recorded too. The recording stays in the profiles folder of the instance, for the tools that know
+ * how to open it, with the summary next to it.
+ */
+class ProfileRecorder : public QObject {
+    Q_OBJECT
+   public:
+    enum class Backend { FlightRecorder, AsyncProfiler };
+
+    /// `tool` is jcmd for the flight recorder, asprof for async-profiler
+    ProfileRecorder(Backend backend, QString tool, qint64 pid, QString outputDir, QObject* parent = nullptr);
+
+    /// record for `seconds`, then stop and sum it up
+    void start(int seconds);
+    /// stop recording right away, still summing up what was recorded
+    void stop();
+
+    QString recordingPath() const { return m_recordingPath; }
+
+    /// the JDK tool called `name` next to the java binary at `javaPath`, empty if there's none
+    static QString jdkTool(const QString& javaPath, const QString& name);
+
+   signals:
+    void started();
+    /// the recording is written and `summary` sums it up
+    void finished(const QString& summary);
+    void failed(const QString& error);
+
+   private:
+    void run(const QString& program, const QStringList& args, std::function<void(const QByteArray& output)> done);
+    void summarize(const QByteArray& data);
+
+   private:
+    Backend m_backend;
+    QString m_tool;
+    qint64 m_pid;
+    QString m_outputDir;
+    QString m_recordingPath;
+    QTimer m_timer;
+    bool m_recording = false;
+};
+
+/**
+ * The profilers recording the game as it launches, for as long as the ProfileRecordingSeconds setting says.
+ */
+class RecordingProfiler : public BaseProfiler {
+    Q_OBJECT
+   public:
+    RecordingProfiler(SettingsObjectPtr settings, InstancePtr instance, ProfileRecorder::Backend backend, QObject* parent = nullptr);
+
+    /// where the recordings of `instance` go
+    static QString profilesDir(const BaseInstance* instance);
+    /// the tool recording with `backend` for `instance`, empty if it's missing
+    static QString toolFor(ProfileRecorder::Backend backend, BaseInstance* instance, SettingsObjectPtr settings);
+
+   protected:
+    void beginProfilingImpl(shared_qobject_ptr<LaunchTask> process) override;
+    void abortProfilingImpl() override;
+
+   private:
+    ProfileRecorder::Backend m_backend;
+    ProfileRecorder* m_recorder = nullptr;
+};
@@ -0,0 +1,115 @@
+#include "ProfileSummary.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace {
+QList<ProfileSummary::HotMethod> topMethods(const QHash<QString, qint64>& samples, int top)
+{
+    QList<ProfileSummary::HotMethod> methods;
+    methods.reserve(samples.size());
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it)
+        methods.append({ it.key(), it.value() });
+    std::sort(methods.begin(), methods.end(), [](const ProfileSummary::HotMethod& a, const ProfileSummary::HotMethod& b) {
+        if (a.samples != b.samples)
+            return a.samples > b.samples;
+        return a.name < b.name;
+    });
+    if (methods.size() > top)
+        methods.erase(methods.begin() + top, methods.end());
+    return methods;
+}
+
+// durations come as ISO 8601 strings, like PT0.0123S
+double toMilliseconds(const QJsonValue& value)
+{
+    if (value.isDouble())
+        return value.toDouble() / 1000000.0;
+    static const QRegularExpression s_duration(R"(^PT(?:(\d+)H)?(?:(\d+)M)?(?:([\d.]+)S)?$)");
+    auto match = s_duration.match(value.toString());
+    if (!match.hasMatch())
+        return 0;
+    return match.captured(1).toDouble() * 3600000 + match.captured(2).toDouble() * 60000 + match.captured(3).toDouble() * 1000;
+}
+}  // namespace
+
+ProfileSummary ProfileSummary::fromCollapsedStacks(const QByteArray& stacks, int top)
+{
+    // async-profiler marks the kind of a frame with a suffix, like _[j] for compiled java code
+    static const QRegularExpression s_frameKind(R"(_\[.\]$)");
+
+    ProfileSummary summary;
+    QHash<QString, qint64> samples;
+    for (auto& line : stacks.split('\n')) {
+        auto countAt = line.lastIndexOf(' ');
+        if (countAt <= 0)
+            continue;
+        bool ok = false;
+        auto count = line.mid(countAt + 1).trimmed().toLongLong(&ok);
+        if (!ok)
+            continue;
+        auto stack = line.left(countAt);
+        auto frame = QString::fromUtf8(stack.mid(stack.lastIndexOf(';') + 1));
+        frame.remove(s_frameKind);
+        samples[frame] += count;
+        summary.samples += count;
+    }
+    summary.hotMethods = topMethods(samples, top);
+    return summary;
+}
+
+std::optional<ProfileSummary> ProfileSummary::fromFlightRecording(const QByteArray& json, int top)
+{
+    QJsonParseError error;
+    auto doc = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError)
+        return {};
+
+    ProfileSummary summary;
+    summary.hasGcPauses = true;
+    QHash<QString, qint64> samples;
+    for (auto eventRaw : doc.object().value("recording").toObject().value("events").toArray()) {
+        auto event = eventRaw.toObject();
+        auto type = event.value("type").toString();
+        auto values = event.value("values").toObject();
+        if (type == "jdk.ExecutionSample") {
+            auto frames = values.value("stackTrace").toObject().value("frames").toArray();
+            if (frames.isEmpty())
+                continue;
+            auto method = frames.first().toObject().value("method").toObject();
+            auto className = method.value("type").toObject().value("name").toString().replace('/', '.');
+            samples[className + '.' + method.value("name").toString()]++;
+            summary.samples++;
+        } else if (type == "jdk.GarbageCollection") {
+            summary.gcPauses++;
+            summary.gcPauseTotalMs += toMilliseconds(values.value("sumOfPauses"));
+            summary.gcPauseLongestMs = std::max(summary.gcPauseLongestMs, toMilliseconds(values.value("longestPause")));
+        }
+    }
+    summary.hotMethods = topMethods(samples, top);
+    return summary;
+}
+
+QString ProfileSummary::toText() const
+{
+    QStringList lines;
+    lines.append(QObject::tr("Hottest methods, out of %1 samples:").arg(samples));
+    for (auto& method : hotMethods) {
+        auto share = samples > 0 ? 100.0 * method.samples / samples : 0;
+        lines.append(QString("  %1%  %2").arg(share, 5, 'f', 1).arg(method.name));
+    }
+    if (hasGcPauses) {
+        lines.append(QObject::tr("Garbage collections: %1, pausing the game %2 ms in total, %3 ms at the longest")
+                         .arg(gcPauses)
+                         .arg(gcPauseTotalMs, 0, 'f', 1)
+                         .arg(gcPauseLongestMs, 0, 'f', 1));
+    }
+    return lines.join('\n');
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+/**
+ * What a profile recording of the game found: the methods it was most often caught running and the pauses of the
+ * garbage collector, enough to tell what makes a modpack slow without opening the recording in another tool.
+ */
+struct ProfileSummary {
+    struct HotMethod {
+        QString name;
+        qint64 samples;
+    };
+
+    qint64 samples = 0;
+    /// the methods on top of the most samples, the most first
+    QList<HotMethod> hotMethods;
+
+    /// only flight recordings know about them
+    bool hasGcPauses = false;
+    int gcPauses = 0;
+    double gcPauseTotalMs = 0;
+    double gcPauseLongestMs = 0;
+
+    /// from the collapsed stacks async-profiler writes, one `frame;frame;...;frame count` per line
+    static ProfileSummary fromCollapsedStacks(const QByteArray& stacks, int top = 20);
+    /// from what `jfr print --json` shows of the execution samples and garbage collections of a flight recording
+    static std::optional<ProfileSummary> fromFlightRecording(const QByteArray& json, int top = 20);
+
+    QString toText() const;
+};
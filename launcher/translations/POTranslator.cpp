@@ -1,6 +1,10 @@
 #include "POTranslator.h"
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
 #include "FileSystem.h"
 
 struct POEntry {
@@ -10,13 +14,85 @@ struct POEntry {
 
 struct POTranslatorPrivate {
     QString filename;
+    QString cacheFilename;
     QHash<QByteArray, POEntry> mapping;
     QHash<QByteArray, POEntry> mapping_disambiguatrion;
     bool loaded = false;
 
     void reload();
+    bool loadCache(const QFileInfo& source);
+    void saveCache(const QFileInfo& source);
 };
 
+namespace {
+const quint32 s_cacheMagic = 0x504f5443;  // "POTC"
+const quint32 s_cacheVersion = 1;
+
+void writeMapping(QDataStream& out, const QHash<QByteArray, POEntry>& mapping)
+{
+    out << static_cast<quint32>(mapping.size());
+    for (auto it = mapping.constBegin(); it != mapping.constEnd(); ++it)
+        out << it.key() << it->text << it->fuzzy;
+}
+
+bool readMapping(QDataStream& in, QHash<QByteArray, POEntry>& mapping)
+{
+    quint32 size;
+    in >> size;
+    mapping.reserve(size);
+    for (quint32 i = 0; i < size && in.status() == QDataStream::Ok; i++) {
+        QByteArray key;
+        POEntry entry;
+        in >> key >> entry.text >> entry.fuzzy;
+        mapping.insert(key, entry);
+    }
+    return in.status() == QDataStream::Ok;
+}
+}  // namespace
+
+// the cache is mapped rather than read, and only kept when it was made from the file as it is now
+bool POTranslatorPrivate::loadCache(const QFileInfo& source)
+{
+    QFile file(cacheFilename);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+        return false;
+    auto data = file.map(0, file.size());
+    if (!data)
+        return false;
+
+    auto bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(file.size()));
+    QDataStream in(bytes);
+    quint32 magic, version;
+    qint64 size, modified;
+    in >> magic >> version >> size >> modified;
+    if (magic != s_cacheMagic || version != s_cacheVersion || size != source.size() ||
+        modified != source.lastModified().toMSecsSinceEpoch())
+        return false;
+
+    QHash<QByteArray, POEntry> newMapping;
+    QHash<QByteArray, POEntry> newMapping_disambiguation;
+    if (!readMapping(in, newMapping) || !readMapping(in, newMapping_disambiguation))
+        return false;
+    mapping = std::move(newMapping);
+    mapping_disambiguatrion = std::move(newMapping_disambiguation);
+    return true;
+}
+
+void POTranslatorPrivate::saveCache(const QFileInfo& source)
+{
+    if (!FS::ensureFilePathExists(cacheFilename))
+        return;
+    QSaveFile file(cacheFilename);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out << s_cacheMagic << s_cacheVersion << static_cast<qint64>(source.size()) << source.lastModified().toMSecsSinceEpoch();
+    writeMapping(out, mapping);
+    writeMapping(out, mapping_disambiguatrion);
+    if (!file.commit())
+        qDebug() << "Failed to write PO cache:" << cacheFilename;
+}
+
 class ParserArray : public QByteArray {
    public:
     ParserArray(const QByteArray& in) : QByteArray(in) {}
@@ -131,6 +207,12 @@ class ParserArray : public QByteArray {
 
 void POTranslatorPrivate::reload()
 {
+    QFileInfo info(filename);
+    if (!cacheFilename.isEmpty() && info.isFile() && loadCache(info)) {
+        loaded = true;
+        return;
+    }
+
     QFile file(filename);
     if (!file.open(QFile::OpenMode::enum_type::ReadOnly | QFile::OpenMode::enum_type::Text)) {
         qDebug() << "Failed to open PO file:" << filename;
@@ -261,12 +343,15 @@ void POTranslatorPrivate::reload()
     mapping = std::move(newMapping);
     mapping_disambiguatrion = std::move(newMapping_disambiguation);
     loaded = true;
+    if (!cacheFilename.isEmpty())
+        saveCache(info);
 }
 
-POTranslator::POTranslator(const QString& filename, QObject* parent) : QTranslator(parent)
+POTranslator::POTranslator(const QString& filename, const QString& cacheFilename, QObject* parent) : QTranslator(parent)
 {
     d = new POTranslatorPrivate;
     d->filename = filename;
+    d->cacheFilename = cacheFilename;
     d->reload();
 }
 
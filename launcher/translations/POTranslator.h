@@ -7,7 +7,8 @@ struct POTranslatorPrivate;
 class POTranslator : public QTranslator {
     Q_OBJECT
    public:
-    explicit POTranslator(const QString& filename, QObject* parent = nullptr);
+    /// `cacheFilename` keeps the parsed file, so it's only parsed again once it changes
+    explicit POTranslator(const QString& filename, const QString& cacheFilename = {}, QObject* parent = nullptr);
     virtual ~POTranslator();
     QString translate(const char* context, const char* sourceText, const char* disambiguation, int n) const override;
     bool isEmpty() const override;
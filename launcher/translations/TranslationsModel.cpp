@@ -37,6 +37,7 @@
 #include "TranslationsModel.h"
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QLibraryInfo>
@@ -494,7 +495,8 @@ bool TranslationsModel::selectLanguage(QString key)
 
     if (langPtr->localFileType == FileType::PO) {
         qDebug() << "Loading Application Language File for" << langCode.toLocal8Bit().constData() << "...";
-        auto poTranslator = new POTranslator(FS::PathCombine(d->m_dir.path(), langCode + ".po"));
+        auto poTranslator = new POTranslator(FS::PathCombine(d->m_dir.path(), langCode + ".po"),
+                                             FS::PathCombine("cache", "translations", langCode + ".po.cache"));
         if (!poTranslator->isEmpty()) {
             if (!QCoreApplication::installTranslator(poTranslator)) {
                 delete poTranslator;
@@ -586,6 +588,15 @@ void TranslationsModel::downloadTranslation(QString key)
         return;
     }
 
+    // the index tells what the file hashes to, when the one we have already does there's nothing to download
+    QFile local(d->m_dir.absoluteFilePath("mmc_" + key + ".qm"));
+    if (local.open(QIODevice::ReadOnly) &&
+        QCryptographicHash::hash(local.readAll(), QCryptographicHash::Sha1).toHex() == lang->file_sha1.toLatin1().toLower()) {
+        qDebug() << "Translation for" << key << "is up to date";
+        return;
+    }
+    local.close();
+
     d->m_downloadingTranslation = key;
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("translations", "mmc_" + key + ".qm");
     entry->setStale(true);
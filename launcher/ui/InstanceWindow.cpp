@@ -40,10 +40,13 @@
 #include <qlayoutitem.h>
 #include <QCloseEvent>
 #include <QHBoxLayout>
+#include <QInputDialog>
 #include <QMessageBox>
+#include <QPointer>
 #include <QPushButton>
 #include <QScrollBar>
 
+#include "tools/ProfileRecorder.h"
 #include "ui/widgets/PageContainer.h"
 
 #include "InstancePageProvider.h"
@@ -101,6 +104,12 @@ InstanceWindow::InstanceWindow(InstancePtr instance, QWidget* parent) : QMainWin
         horizontalLayout->addWidget(m_killButton);
         connect(m_killButton, &QPushButton::clicked, this, [this] { APPLICATION->kill(m_instance); });
 
+        m_recordButton = new QPushButton(this);
+        m_recordButton->setText(tr("&Record Profile"));
+        m_recordButton->setToolTip(tr("Record what the running game spends its time on"));
+        horizontalLayout->addWidget(m_recordButton);
+        connect(m_recordButton, &QPushButton::clicked, this, &InstanceWindow::recordProfile);
+
         updateButtons();
 
         m_closeButton = new QPushButton(this);
@@ -155,6 +164,7 @@ void InstanceWindow::updateButtons()
 {
     m_launchButton->setEnabled(m_instance->canLaunch());
     m_killButton->setEnabled(m_instance->isRunning());
+    m_recordButton->setEnabled(m_instance->isRunning() && m_proc && !m_recorder);
 
     QMenu* launchMenu = m_launchButton->menu();
     if (launchMenu)
@@ -165,6 +175,72 @@ void InstanceWindow::updateButtons()
     m_launchButton->setMenu(launchMenu);
 }
 
+void InstanceWindow::recordProfile()
+{
+    if (!m_proc || m_recorder)
+        return;
+
+    QStringList names;
+    QList<ProfileRecorder::Backend> backends;
+    QStringList tools;
+    for (auto backend : { ProfileRecorder::Backend::FlightRecorder, ProfileRecorder::Backend::AsyncProfiler }) {
+        auto tool = RecordingProfiler::toolFor(backend, m_instance.get(), APPLICATION->settings());
+        if (tool.isEmpty())
+            continue;
+        names.append(backend == ProfileRecorder::Backend::FlightRecorder ? tr("JDK Flight Recorder") : tr("async-profiler"));
+        backends.append(backend);
+        tools.append(tool);
+    }
+    if (tools.isEmpty()) {
+        QMessageBox::warning(this, tr("Record Profile"),
+                             tr("Recording needs the instance to run on a JDK, or async-profiler to be set up in the external tools "
+                                "settings."));
+        return;
+    }
+
+    bool ok = true;
+    int choice = 0;
+    if (names.size() > 1) {
+        auto name = QInputDialog::getItem(this, tr("Record Profile"), tr("Record with:"), names, 0, false, &ok);
+        choice = names.indexOf(name);
+    }
+    if (!ok || choice < 0)
+        return;
+    auto seconds = QInputDialog::getInt(this, tr("Record Profile"), tr("Record for how many seconds?"),
+                                        APPLICATION->settings()->get("ProfileRecordingSeconds").toInt(), 5, 3600, 5, &ok);
+    if (!ok || !m_proc)
+        return;
+
+    QPointer<LaunchTask> launch(m_proc.get());
+    auto outputDir = RecordingProfiler::profilesDir(m_instance.get());
+    auto recorder = new ProfileRecorder(backends[choice], tools[choice], m_proc->pid(), outputDir, this);
+    auto done = [this, recorder] {
+        recorder->deleteLater();
+        m_recorder = nullptr;
+        updateButtons();
+    };
+    connect(recorder, &ProfileRecorder::started, this, [launch, seconds] {
+        if (launch)
+            launch->onLogLine(tr("Recording a profile of the game for %1 seconds.").arg(seconds), MessageLevel::Launcher);
+    });
+    connect(recorder, &ProfileRecorder::finished, this, [this, recorder, launch, done](const QString& summary) {
+        auto message = tr("Profile recorded to %1").arg(recorder->recordingPath());
+        if (launch)
+            launch->onLogLines((message + '\n' + summary).split('\n'));
+        auto box = new QMessageBox(QMessageBox::Information, tr("Profile Recorded"), message + "\n\n" + summary, QMessageBox::Ok, this);
+        box->setAttribute(Qt::WA_DeleteOnClose);
+        box->open();
+        done();
+    });
+    connect(recorder, &ProfileRecorder::failed, this, [this, done](const QString& error) {
+        QMessageBox::warning(this, tr("Record Profile"), tr("Couldn't record a profile: %1").arg(error));
+        done();
+    });
+    m_recorder = recorder;
+    recorder->start(seconds);
+    updateButtons();
+}
+
 void InstanceWindow::instanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc)
 {
     m_proc = proc;
@@ -48,6 +48,7 @@
 #include "QObjectPtr.h"
 
 class QPushButton;
+class ProfileRecorder;
 class PageContainer;
 class InstanceWindow : public QMainWindow, public BasePageContainer {
     Q_OBJECT
@@ -81,6 +82,8 @@ class InstanceWindow : public QMainWindow, public BasePageContainer {
 
    private:
     void updateButtons();
+    /// record a profile of the running game, for as long as the user says
+    void recordProfile();
 
    private:
     shared_qobject_ptr<LaunchTask> m_proc;
@@ -90,4 +93,7 @@ class InstanceWindow : public QMainWindow, public BasePageContainer {
     QPushButton* m_closeButton = nullptr;
     QToolButton* m_launchButton = nullptr;
     QPushButton* m_killButton = nullptr;
+    QPushButton* m_recordButton = nullptr;
+    // the recording going on, one at a time
+    ProfileRecorder* m_recorder = nullptr;
 };
@@ -64,6 +64,7 @@
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
+#include <QPointer>
 #include <QProgressDialog>
 #include <QShortcut>
 #include <QStatusBar>
@@ -86,6 +87,7 @@
 #include <minecraft/auth/AccountList.h>
 #include <net/ApiDownload.h>
 #include <net/NetJob.h>
+#include <net/RefreshCoordinator.h>
 #include <news/NewsChecker.h>
 #include <tools/BaseProfiler.h>
 #include <updater/ExternalUpdater.h>
@@ -101,6 +103,8 @@
 #include "ui/dialogs/ImportResourceDialog.h"
 #include "ui/dialogs/NewInstanceDialog.h"
 #include "ui/dialogs/NewsDialog.h"
+#include "ui/dialogs/ModInventoryDialog.h"
+#include "ui/dialogs/PerfStatsDialog.h"
 #include "ui/dialogs/ProgressDialog.h"
 #include "ui/instanceview/InstanceDelegate.h"
 #include "ui/instanceview/InstanceProxyModel.h"
@@ -258,6 +262,14 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
         // FIXME: This is kinda weird. and bad. We need some kind of managed shutdown.
         auto q = new QShortcut(QKeySequence::Quit, this);
         connect(q, &QShortcut::activated, APPLICATION, &Application::quit);
+
+        // not in any menu, it's for finding out where the time goes
+        auto perfStats = new QShortcut(QKeySequence(tr("Ctrl+Alt+Shift+P")), this);
+        connect(perfStats, &QShortcut::activated, this, [this] {
+            auto dialog = new PerfStatsDialog(this);
+            dialog->setAttribute(Qt::WA_DeleteOnClose);
+            dialog->show();
+        });
     }
 
     // Konami Code
@@ -268,7 +280,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
 
     // Add the news label to the news toolbar.
     {
-        m_newsChecker.reset(new NewsChecker(APPLICATION->network(), BuildConfig.NEWS_RSS_URL));
+        m_newsChecker.reset(new NewsChecker(APPLICATION->network(), BuildConfig.NEWS_RSS_URL, APPLICATION->metacache()));
         newsLabel = new QToolButton();
         newsLabel->setIcon(APPLICATION->getThemedIcon("news"));
         newsLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
@@ -371,9 +383,14 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
     // TODO: refresh accounts here?
     // auto accounts = APPLICATION->accounts();
 
-    // load the news
+    // load the news, the cached feed shows right away and is refreshed once the launcher is up
     {
-        m_newsChecker->reloadNews();
+        bool cached = m_newsChecker->loadCachedNews();
+        auto interval = cached ? std::chrono::hours(1) : std::chrono::hours(0);
+        APPLICATION->refreshCoordinator()->add("news", interval, [checker = QPointer<NewsChecker>(m_newsChecker.get())] {
+            if (checker)
+                checker->reloadNews();
+        });
         updateNewsLabel();
     }
 
@@ -394,6 +411,13 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
     connect(ui->actionUndoTrashInstance, &QAction::triggered, this, &MainWindow::undoTrashInstance);
 
     setSelectedInstanceById(APPLICATION->settings()->get("SelectedInstance").toString());
+    if (!m_selectedInstance && APPLICATION->instances()->isLoading()) {
+        // the last selected instance may just not be loaded yet
+        connect(APPLICATION->instances().get(), &InstanceList::rowsInserted, this, [this] {
+            if (!m_selectedInstance)
+                setSelectedInstanceById(APPLICATION->settings()->get("SelectedInstance").toString());
+        });
+    }
 
     // removing this looks stupid
     view->setFocus();
@@ -761,7 +785,7 @@ bool MainWindow::eventFilter(QObject* obj, QEvent* ev)
 
 void MainWindow::updateNewsLabel()
 {
-    if (m_newsChecker->isLoadingNews()) {
+    if (m_newsChecker->isLoadingNews() && m_newsChecker->getNewsEntries().isEmpty()) {
         newsLabel->setText(tr("Loading news..."));
         newsLabel->setEnabled(false);
         ui->actionMoreNews->setVisible(false);
@@ -918,13 +942,26 @@ void MainWindow::on_actionAddInstance_triggered()
 
 void MainWindow::processURLs(QList<QUrl> urls)
 {
-    // NOTE: This loop only processes one dropped file!
+    // the dropped files are identified all at once, each on a thread of its own
+    QStringList droppedNames;
+    QList<QFileInfo> droppedFiles;
     for (auto& url : urls) {
-        qDebug() << "Processing" << url;
-
         // The isLocalFile() check below doesn't work as intended without an explicit scheme.
         if (url.scheme().isEmpty())
             url.setScheme("file");
+        if (url.isLocalFile()) {
+            droppedNames.append(QDir::toNativeSeparators(url.toLocalFile()));
+            droppedFiles.append(QFileInfo(droppedNames.last()));
+        }
+    }
+    QHash<QString, PackedResourceType> droppedTypes;
+    auto identified = ResourceUtils::identify(droppedFiles);
+    for (int i = 0; i < droppedNames.size(); i++)
+        droppedTypes.insert(droppedNames[i], identified[i]);
+
+    // NOTE: This loop only processes one dropped file!
+    for (auto& url : urls) {
+        qDebug() << "Processing" << url;
 
         ModPlatform::IndexedVersion version;
         QMap<QString, QString> extra_info;
@@ -995,6 +1032,7 @@ void MainWindow::processURLs(QList<QUrl> urls)
             auto entry = APPLICATION->metacache()->resolveEntry("general", path);
             entry->setStale(true);
             auto dl_job = unique_qobject_ptr<NetJob>(new NetJob(tr("Modpack download"), APPLICATION->network()));
+            dl_job->setPriority(Net::Priority::Bulk);
             dl_job->addNetAction(Net::ApiDownload::makeCached(dl_url, entry));
             auto archivePath = entry->getFullPath();
 
@@ -1021,7 +1059,7 @@ void MainWindow::processURLs(QList<QUrl> urls)
         auto localFileName = QDir::toNativeSeparators(local_url.toLocalFile());
         QFileInfo localFileInfo(localFileName);
 
-        auto type = ResourceUtils::identify(localFileInfo);
+        auto type = droppedTypes.contains(localFileName) ? droppedTypes.value(localFileName) : ResourceUtils::identify(localFileInfo);
 
         if (ResourceUtils::ValidResourceTypes.count(type) == 0) {  // probably instance/modpack
             addInstance(localFileName, extra_info);
@@ -1055,7 +1093,11 @@ void MainWindow::processURLs(QList<QUrl> urls)
                 minecraftInst->shaderPackList()->installResource(localFileName);
                 break;
             case PackedResourceType::WorldSave:
-                minecraftInst->worldList()->installWorld(localFileInfo);
+                if (auto task = minecraftInst->worldList()->installWorld(localFileInfo)) {
+                    ProgressDialog progress(this);
+                    progress.setSkipButton(true, tr("Abort"));
+                    progress.execWithTask(task.get());
+                }
                 break;
             case PackedResourceType::UNKNOWN:
             default:
@@ -1287,6 +1329,13 @@ void MainWindow::on_actionClearMetadata_triggered()
     APPLICATION->metacache()->SaveNow();
 }
 
+void MainWindow::on_actionModInventory_triggered()
+{
+    auto dialog = new ModInventoryDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
 #ifdef Q_OS_MAC
 void MainWindow::on_actionAddToPATH_triggered()
 {
@@ -1676,6 +1725,12 @@ void MainWindow::instanceChanged(const QModelIndex& current, [[maybe_unused]] co
 
         APPLICATION->settings()->set("SelectedInstance", m_selectedInstance->id());
 
+        // it's probably launched next, its account shouldn't have to log in first then
+        auto accounts = APPLICATION->accounts();
+        auto instanceAccountId = m_selectedInstance->settings()->get("InstanceAccountId").toString();
+        auto accountIndex = instanceAccountId.isEmpty() ? -1 : accounts->findAccountByProfileId(instanceAccountId);
+        accounts->prewarm(accountIndex != -1 ? accounts->at(accountIndex) : accounts->defaultAccount());
+
         connect(m_selectedInstance.get(), &BaseInstance::runningStatusChanged, this, &MainWindow::refreshCurrentInstance);
         connect(m_selectedInstance.get(), &BaseInstance::profilerChanged, this, &MainWindow::refreshCurrentInstance);
     } else {
@@ -134,6 +134,8 @@ class MainWindow : public QMainWindow {
 
     void on_actionClearMetadata_triggered();
 
+    void on_actionModInventory_triggered();
+
 #ifdef Q_OS_MAC
     void on_actionAddToPATH_triggered();
 #endif
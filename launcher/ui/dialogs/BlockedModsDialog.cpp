@@ -27,6 +27,7 @@
 #include "ui_BlockedModsDialog.h"
 
 #include "Application.h"
+#include "modplatform/helpers/HashCache.h"
 #include "modplatform/helpers/HashUtils.h"
 
 #include <QDebug>
@@ -44,8 +45,9 @@
 BlockedModsDialog::BlockedModsDialog(QWidget* parent, const QString& title, const QString& text, QList<BlockedMod>& mods, QString hash_type)
     : QDialog(parent), ui(new Ui::BlockedModsDialog), m_mods(mods), m_hash_type(hash_type)
 {
-    m_hashing_task = shared_qobject_ptr<ConcurrentTask>(
-        new ConcurrentTask(this, "MakeHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt()));
+    auto max_hashers = APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt();
+    m_hashing_task = shared_qobject_ptr<ConcurrentTask>(new ConcurrentTask(this, "MakeHashesTask", max_hashers));
+    m_hashing_task->setAdaptiveConcurrency(1, 2 * max_hashers);
     connect(m_hashing_task.get(), &Task::finished, this, &BlockedModsDialog::hashTaskFinished);
 
     ui->setupUi(this);
@@ -225,12 +227,20 @@ void BlockedModsDialog::scanPaths()
 /// @param path the directory to scan
 void BlockedModsDialog::scanPath(QString path, bool start_task)
 {
-    QDir scan_dir(path);
     QDirIterator scan_it(path, QDir::Filter::Files | QDir::Filter::Hidden, QDirIterator::NoIteratorFlags);
     while (scan_it.hasNext()) {
         QString file = scan_it.next();
+        const QFileInfo info = scan_it.fileInfo();
 
-        if (!checkValidPath(file)) {
+        // the watcher tells about the whole directory, most of which is what we looked at last time
+        SeenFile seen{ info.size(), info.lastModified() };
+        auto known = m_seen_files.constFind(file);
+        if (known != m_seen_files.constEnd() && known->size == seen.size && known->modified == seen.modified) {
+            continue;
+        }
+        m_seen_files.insert(file, seen);
+
+        if (!checkValidPath(info)) {
             continue;
         }
 
@@ -255,6 +265,13 @@ void BlockedModsDialog::addHashTask(QString path)
 /// @param path the path to the local file being hashed
 void BlockedModsDialog::buildHashTask(QString path)
 {
+    // hashed before, by us or anything else, and not changed since
+    auto cached = APPLICATION->hashCache()->get(path, m_hash_type);
+    if (!cached.isEmpty()) {
+        checkMatchHash(cached, path);
+        return;
+    }
+
     auto hash_task = Hashing::createBlockedModHasher(path, ModPlatform::ResourceProvider::FLAME, m_hash_type);
 
     qDebug() << "[Blocked Mods Dialog] Creating Hash task for path: " << path;
@@ -295,12 +312,13 @@ void BlockedModsDialog::checkMatchHash(QString hash, QString path)
     }
 }
 
-/// @brief Check if the name of the file at path matches the name of a blocked mod we are searching for
-/// @param path the path to check
-/// @return boolean: did the path match the name of a blocked mod?
-bool BlockedModsDialog::checkValidPath(QString path)
+/// @brief Check if the name of the file matches the name of a blocked mod we are searching for,
+///        and its size the size of that mod when it's known
+/// @param file the file to check
+/// @return boolean: is the file worth hashing?
+bool BlockedModsDialog::checkValidPath(const QFileInfo& file)
 {
-    const QFileInfo file = QFileInfo(path);
+    const QString path = file.filePath();
     const QString filename = file.fileName();
 
     auto compare = [](QString fsFilename, QString metadataFilename) {
@@ -333,6 +351,8 @@ bool BlockedModsDialog::checkValidPath(QString path)
         return fsName.compare(metaName) == 0;
     };
 
+    auto sizeMatches = [&file](const BlockedMod& mod) { return mod.size < 0 || mod.size == file.size(); };
+
     for (auto& mod : m_mods) {
         if (compare(filename, mod.name)) {
             // if the mod is not yet matched and doesn't have a hash then
@@ -342,10 +362,13 @@ bool BlockedModsDialog::checkValidPath(QString path)
                 mod.localPath = path;
                 return false;
             }
+            if (!sizeMatches(mod)) {
+                continue;
+            }
             qDebug() << "[Blocked Mods Dialog] Name match found:" << mod.name << "| From path:" << path;
             return true;
         }
-        if (laxCompare(filename, mod.name)) {
+        if (laxCompare(filename, mod.name) && sizeMatches(mod)) {
             qDebug() << "[Blocked Mods Dialog] Lax name match found:" << mod.name << "| From path:" << path;
             return true;
         }
@@ -376,6 +399,8 @@ void BlockedModsDialog::validateMatchedMods()
         }
     }
     if (changed) {
+        // a file we skipped may be what the vanished one was, looking at it again is cheap with the hash cache
+        m_seen_files.clear();
         update();
     }
 }
@@ -418,8 +443,8 @@ QDebug operator<<(QDebug debug, const BlockedMod& m)
 {
     QDebugStateSaver saver(debug);
 
-    debug.nospace() << "{ name: " << m.name << ", websiteUrl: " << m.websiteUrl << ", hash: " << m.hash << ", matched: " << m.matched
-                    << ", localPath: " << m.localPath << "}";
+    debug.nospace() << "{ name: " << m.name << ", websiteUrl: " << m.websiteUrl << ", hash: " << m.hash << ", size: " << m.size
+                    << ", matched: " << m.matched << ", localPath: " << m.localPath << "}";
 
     return debug;
 }
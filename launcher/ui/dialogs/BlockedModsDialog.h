@@ -25,7 +25,10 @@
 
 #pragma once
 
+#include <QDateTime>
 #include <QDialog>
+#include <QFileInfo>
+#include <QHash>
 #include <QList>
 #include <QString>
 
@@ -42,6 +45,8 @@ struct BlockedMod {
     bool matched;
     QString localPath;
     QString targetFolder;
+    // in bytes, -1 when the platform didn't tell
+    qint64 size = -1;
 };
 
 QT_BEGIN_NAMESPACE
@@ -72,6 +77,12 @@ class BlockedModsDialog : public QDialog {
     shared_qobject_ptr<ConcurrentTask> m_hashing_task;
     QSet<QString> m_pending_hash_paths;
     bool m_rehash_pending;
+    // size and modification time of the files already looked at, so a rescan only looks at what changed
+    struct SeenFile {
+        qint64 size;
+        QDateTime modified;
+    };
+    QHash<QString, SeenFile> m_seen_files;
     QPushButton* m_openMissingButton;
     QString m_hash_type;
 
@@ -90,7 +101,7 @@ class BlockedModsDialog : public QDialog {
     void runHashTask();
     void hashTaskFinished();
 
-    bool checkValidPath(QString path);
+    bool checkValidPath(const QFileInfo& file);
     bool allModsMatched();
 };
 
@@ -57,6 +57,7 @@
 #include <functional>
 #include "Application.h"
 #include "SeparatorPrefixTree.h"
+#include "StringUtils.h"
 
 ExportInstanceDialog::ExportInstanceDialog(InstancePtr instance, QWidget* parent)
     : QDialog(parent), ui(new Ui::ExportInstanceDialog), m_instance(instance)
@@ -70,6 +71,10 @@ ExportInstanceDialog::ExportInstanceDialog(InstancePtr instance, QWidget* parent
     auto prefix = QDir(instance->instanceRoot()).relativeFilePath(instance->gameRoot());
     proxyModel->ignoreFilesWithPath().insert({ FS::PathCombine(prefix, "logs"), FS::PathCombine(prefix, "crash-reports") });
     proxyModel->ignoreFilesWithName().append({ ".DS_Store", "thumbs.db", "Thumbs.db" });
+    // rebuilt from the components on the first launch anyway
+    proxyModel->ignoreFilesWithPath().insert(".launchplan.json");
+    // read from the worlds again when missing
+    proxyModel->ignoreFilesWithPath().insert(".worlds.json");
     proxyModel->ignoreFilesWithPath().insert(
         { FS::PathCombine(prefix, ".cache"), FS::PathCombine(prefix, ".fabric"), FS::PathCombine(prefix, ".quilt") });
     loadPackIgnore();
@@ -85,6 +90,12 @@ ExportInstanceDialog::ExportInstanceDialog(InstancePtr instance, QWidget* parent
     auto headerView = ui->treeView->header();
     headerView->setSectionResizeMode(QHeaderView::ResizeToContents);
     headerView->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // the whole selection is only summed up off the GUI thread, large worlds take a moment
+    connect(proxyModel, &FileIgnoreProxy::sizeEstimated, this, [this](qint64 bytes) {
+        ui->sizeEstimate->setText(tr("Selected files: %1").arg(StringUtils::humanReadableFileSize(bytes)));
+    });
+    proxyModel->estimateSize();
 }
 
 ExportInstanceDialog::~ExportInstanceDialog()
@@ -137,6 +148,7 @@ void ExportInstanceDialog::doExport()
     }
 
     SaveIcon(m_instance);
+    m_instance->saveNow();
 
     auto files = QFileInfoList();
     if (!MMCZip::collectFileListRecursively(m_instance->instanceRoot(), nullptr, &files,
@@ -32,6 +32,7 @@
 #include "FastFileIconProvider.h"
 #include "FileSystem.h"
 #include "MMCZip.h"
+#include "StringUtils.h"
 #include "modplatform/modrinth/ModrinthPackExportTask.h"
 
 ExportPackDialog::ExportPackDialog(InstancePtr instance, QWidget* parent, ModPlatform::ResourceProvider provider)
@@ -96,6 +97,12 @@ ExportPackDialog::ExportPackDialog(InstancePtr instance, QWidget* parent, ModPla
     QHeaderView* headerView = ui->files->header();
     headerView->setSectionResizeMode(QHeaderView::ResizeToContents);
     headerView->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // the whole selection is only summed up off the GUI thread, large worlds take a moment
+    connect(proxy, &FileIgnoreProxy::sizeEstimated, this, [this](qint64 bytes) {
+        ui->sizeEstimate->setText(tr("Selected files: %1").arg(StringUtils::humanReadableFileSize(bytes)));
+    });
+    proxy->estimateSize();
 }
 
 ExportPackDialog::~ExportPackDialog()
@@ -0,0 +1,147 @@
+#include "ModInventoryDialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSaveFile>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "Application.h"
+#include "FileSystem.h"
+#include "InstanceList.h"
+#include "minecraft/mod/ModInventory.h"
+#include "modplatform/helpers/ExportToModList.h"
+
+namespace {
+enum Column { InstanceColumn, NameColumn, VersionColumn, FileColumn, HashColumn };
+}
+
+ModInventoryDialog::ModInventoryDialog(QWidget* parent)
+    : QDialog(parent), m_search(new QLineEdit(this)), m_status(new QLabel(this)), m_tree(new QTreeWidget(this)), m_refresh(this)
+{
+    setWindowTitle(tr("Find mods in all instances"));
+    resize(800, 500);
+
+    m_search->setPlaceholderText(tr("Mod ID, name, file name, SHA1 or SHA512"));
+    m_search->setClearButtonEnabled(true);
+
+    m_tree->setHeaderLabels({ tr("Instance"), tr("Mod"), tr("Version"), tr("File"), tr("SHA1") });
+    m_tree->setRootIsDecorated(false);
+    m_tree->setSortingEnabled(true);
+    m_tree->sortByColumn(InstanceColumn, Qt::AscendingOrder);
+    m_tree->header()->setSectionResizeMode(FileColumn, QHeaderView::Stretch);
+    m_tree->setToolTip(tr("Double click a mod to open the mods of its instance."));
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    auto copy = buttons->addButton(tr("Copy"), QDialogButtonBox::ActionRole);
+    connect(copy, &QPushButton::clicked, this, [this] {
+        QStringList lines;
+        for (int i = 0; i < m_tree->topLevelItemCount(); i++) {
+            auto item = m_tree->topLevelItem(i);
+            QStringList columns;
+            for (int column = 0; column < m_tree->columnCount(); column++)
+                columns.append(item->text(column));
+            lines.append(columns.join('\t'));
+        }
+        QApplication::clipboard()->setText(lines.join('\n'));
+    });
+    auto exportButton = buttons->addButton(tr("Export"), QDialogButtonBox::ActionRole);
+    exportButton->setToolTip(tr("Write the mods found to a file, or the mods of every instance when nothing is searched for."));
+    connect(exportButton, &QPushButton::clicked, this, &ModInventoryDialog::exportList);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(m_search);
+    layout->addWidget(m_status);
+    layout->addWidget(m_tree);
+    layout->addWidget(buttons);
+
+    m_refresh.setSingleShot(true);
+    m_refresh.setInterval(250);
+    connect(&m_refresh, &QTimer::timeout, this, &ModInventoryDialog::refresh);
+    connect(m_search, &QLineEdit::textChanged, this, &ModInventoryDialog::refresh);
+    connect(m_tree, &QTreeWidget::itemDoubleClicked, this, &ModInventoryDialog::openInstance);
+
+    auto inventory = APPLICATION->modInventory();
+    connect(inventory.get(), &ModInventory::changed, this, [this] {
+        if (!m_refresh.isActive())
+            m_refresh.start();
+    });
+    inventory->start();
+    refresh();
+}
+
+void ModInventoryDialog::refresh()
+{
+    auto inventory = APPLICATION->modInventory();
+    auto count = tr("%n mod(s)", "", inventory->modCount());
+    if (inventory->isReady())
+        m_status->setText(tr("%1 in %n instance(s).", "", inventory->instanceCount()).arg(count));
+    else
+        m_status->setText(tr("Looking through the instances, %1 so far...").arg(count));
+
+    auto instances = APPLICATION->instances();
+    m_tree->setSortingEnabled(false);
+    m_tree->clear();
+    for (auto& entry : inventory->find(m_search->text())) {
+        auto instance = instances->getInstanceById(entry.instanceId);
+        auto instanceName = instance ? instance->name() : entry.instanceId;
+        auto modName = entry.name.isEmpty() ? entry.modId : entry.name;
+        auto item = new QTreeWidgetItem(m_tree, { instanceName, modName, entry.version, entry.fileName, entry.sha1 });
+        item->setData(InstanceColumn, Qt::UserRole, entry.instanceId);
+        item->setToolTip(NameColumn, entry.modId);
+        item->setToolTip(HashColumn, tr("SHA512: %1").arg(entry.sha512));
+        if (!entry.enabled) {
+            for (int column = 0; column < m_tree->columnCount(); column++)
+                item->setForeground(column, palette().brush(QPalette::Disabled, QPalette::Text));
+        }
+    }
+    m_tree->setSortingEnabled(true);
+}
+
+void ModInventoryDialog::exportList()
+{
+    auto output = QFileDialog::getSaveFileName(this, tr("Export Mods"), FS::PathCombine(QDir::homePath(), "mods.csv"),
+                                               tr("CSV (*.csv);;JSON (*.json);;Markdown (*.md);;HTML (*.html);;Plain text (*.txt)"));
+    if (output.isEmpty())
+        return;
+
+    auto suffix = QFileInfo(output).suffix().toLower();
+    auto format = ExportToModList::CSV;
+    if (suffix == "json")
+        format = ExportToModList::JSON;
+    else if (suffix == "md")
+        format = ExportToModList::MARKDOWN;
+    else if (suffix == "html" || suffix == "htm")
+        format = ExportToModList::HTML;
+    else if (suffix == "txt")
+        format = ExportToModList::PLAINTXT;
+
+    auto inventory = APPLICATION->modInventory();
+    auto entries = m_search->text().trimmed().isEmpty() ? inventory->all() : inventory->find(m_search->text());
+    auto instances = APPLICATION->instances();
+    auto rows = ExportToModList::rowsOf(entries, [&instances](const QString& instanceId) {
+        auto instance = instances->getInstanceById(instanceId);
+        return instance ? instance->name() : instanceId;
+    });
+
+    // written as it's made, the whole list is never in memory as text
+    QSaveFile file(output);
+    auto extraData = static_cast<ExportToModList::OptionalData>(ExportToModList::Version | ExportToModList::Instance);
+    if (!file.open(QIODevice::WriteOnly) || !ExportToModList::exportToModList(&file, rows, format, extraData) || !file.commit())
+        QMessageBox::warning(this, tr("Export Mods"), tr("Couldn't write %1: %2").arg(output, file.errorString()));
+}
+
+void ModInventoryDialog::openInstance(QTreeWidgetItem* item)
+{
+    auto instance = APPLICATION->instances()->getInstanceById(item->data(InstanceColumn, Qt::UserRole).toString());
+    if (instance)
+        APPLICATION->showInstanceWindow(instance, "mods");
+}
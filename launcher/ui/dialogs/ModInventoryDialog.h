@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QDialog>
+#include <QTimer>
+
+class QLabel;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/** Finds a mod, by its id, name, file or hash, in every instance at once. */
+class ModInventoryDialog final : public QDialog {
+    Q_OBJECT
+
+   public:
+    explicit ModInventoryDialog(QWidget* parent = nullptr);
+
+   private slots:
+    void refresh();
+    void openInstance(QTreeWidgetItem* item);
+    /// write what's found, or every mod when nothing is searched for, to a file the user picks
+    void exportList();
+
+   private:
+    QLineEdit* m_search;
+    QLabel* m_status;
+    QTreeWidget* m_tree;
+    // the inventory changes once per instance while it's indexed, the results don't need to follow every time
+    QTimer m_refresh;
+};
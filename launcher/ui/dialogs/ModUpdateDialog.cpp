@@ -8,7 +8,7 @@
 #include "modplatform/flame/FlameAPI.h"
 #include "ui_ReviewMessageBox.h"
 
-#include "Markdown.h"
+#include "MarkdownRenderer.h"
 
 #include "tasks/ConcurrentTask.h"
 
@@ -89,13 +89,26 @@ void ModUpdateDialog::checkCandidates()
     auto versions = mcVersions(m_instance);
     auto loaders = mcLoaders(m_instance);
 
-    SequentialTask check_task(m_parent, tr("Checking for updates"));
+    // both providers are asked at once, and what each of them found is added as soon as it's done
+    ConcurrentTask check_task(m_parent, tr("Checking for updates"), 2);
+
+    QList<std::shared_ptr<GetModDependenciesTask::PackDependency>> selectedVers;
+    auto addUpdates = [this, &selectedVers](CheckUpdateTask* task) {
+        for (auto& updatable : task->getUpdatable()) {
+            qDebug() << QString("Mod %1 has an update available!").arg(updatable.name);
+
+            appendMod(updatable);
+            m_tasks.insert(updatable.name, updatable.download);
+        }
+        selectedVers.append(task->getDependencies());
+    };
 
     if (!m_modrinth_to_update.empty()) {
         m_modrinth_check_task.reset(new ModrinthCheckUpdate(m_modrinth_to_update, versions, loaders, m_mod_model));
         connect(m_modrinth_check_task.get(), &CheckUpdateTask::checkFailed, this, [this](Mod* mod, QString reason, QUrl recover_url) {
             m_failed_check_update.append({ mod, reason, recover_url });
         });
+        connect(m_modrinth_check_task.get(), &Task::succeeded, this, [this, addUpdates] { addUpdates(m_modrinth_check_task.get()); });
         check_task.addTask(m_modrinth_check_task);
     }
 
@@ -104,6 +117,7 @@ void ModUpdateDialog::checkCandidates()
         connect(m_flame_check_task.get(), &CheckUpdateTask::checkFailed, this, [this](Mod* mod, QString reason, QUrl recover_url) {
             m_failed_check_update.append({ mod, reason, recover_url });
         });
+        connect(m_flame_check_task.get(), &Task::succeeded, this, [this, addUpdates] { addUpdates(m_flame_check_task.get()); });
         check_task.addTask(m_flame_check_task);
     }
 
@@ -130,32 +144,6 @@ void ModUpdateDialog::checkCandidates()
         return;
     }
 
-    QList<std::shared_ptr<GetModDependenciesTask::PackDependency>> selectedVers;
-
-    // Add found updates for Modrinth
-    if (m_modrinth_check_task) {
-        auto modrinth_updates = m_modrinth_check_task->getUpdatable();
-        for (auto& updatable : modrinth_updates) {
-            qDebug() << QString("Mod %1 has an update available!").arg(updatable.name);
-
-            appendMod(updatable);
-            m_tasks.insert(updatable.name, updatable.download);
-        }
-        selectedVers.append(m_modrinth_check_task->getDependencies());
-    }
-
-    // Add found updated for Flame
-    if (m_flame_check_task) {
-        auto flame_updates = m_flame_check_task->getUpdatable();
-        for (auto& updatable : flame_updates) {
-            qDebug() << QString("Mod %1 has an update available!").arg(updatable.name);
-
-            appendMod(updatable);
-            m_tasks.insert(updatable.name, updatable.download);
-        }
-        selectedVers.append(m_flame_check_task->getDependencies());
-    }
-
     // Report failed update checking
     if (!m_failed_check_update.empty()) {
         QString text;
@@ -445,17 +433,17 @@ void ModUpdateDialog::appendMod(CheckUpdateTask::UpdatableMod const& info, QStri
     auto changelog = new QTreeWidgetItem(changelog_item);
     auto changelog_area = new QTextBrowser();
 
-    QString text = info.changelog;
     switch (info.provider) {
         case ModPlatform::ResourceProvider::MODRINTH: {
-            text = markdownToHTML(info.changelog.toUtf8());
+            // long changelogs are rendered off the GUI thread, the area fills in once they are
+            renderMarkdown(changelog_area, info.changelog, [changelog_area](const QString& html) { changelog_area->setHtml(html); });
             break;
         }
         default:
+            changelog_area->setHtml(info.changelog);
             break;
     }
 
-    changelog_area->setHtml(text);
     changelog_area->setOpenExternalLinks(true);
     changelog_area->setLineWrapMode(QTextBrowser::LineWrapMode::WidgetWidth);
     changelog_area->setVerticalScrollBarPolicy(Qt::ScrollBarPolicy::ScrollBarAsNeeded);
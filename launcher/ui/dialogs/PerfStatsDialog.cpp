@@ -0,0 +1,67 @@
+#include "PerfStatsDialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "PerfCounters.h"
+
+PerfStatsDialog::PerfStatsDialog(QWidget* parent) : QDialog(parent), m_tree(new QTreeWidget(this)), m_timer(this)
+{
+    setWindowTitle(tr("Performance counters"));
+    resize(600, 500);
+
+    m_tree->setHeaderLabels({ tr("Counter"), tr("Value"), tr("Per second") });
+    m_tree->setRootIsDecorated(false);
+    m_tree->setSortingEnabled(true);
+    m_tree->sortByColumn(0, Qt::AscendingOrder);
+    m_tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    auto copy = buttons->addButton(tr("Copy"), QDialogButtonBox::ActionRole);
+    connect(copy, &QPushButton::clicked, this, [] { QApplication::clipboard()->setText(PerfCounters::dump()); });
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(m_tree);
+    layout->addWidget(buttons);
+
+    connect(&m_timer, &QTimer::timeout, this, &PerfStatsDialog::refresh);
+    m_timer.start(1000);
+    refresh();
+}
+
+void PerfStatsDialog::refresh()
+{
+    auto values = PerfCounters::snapshot();
+    auto seconds = m_sinceLast.isValid() ? m_sinceLast.restart() / 1000.0 : 0.0;
+    if (!m_sinceLast.isValid())
+        m_sinceLast.start();
+
+    QMap<QString, QTreeWidgetItem*> items;
+    for (int i = 0; i < m_tree->topLevelItemCount(); i++) {
+        auto item = m_tree->topLevelItem(i);
+        items.insert(item->text(0), item);
+    }
+
+    // don't let the rows jump around while they change
+    m_tree->setSortingEnabled(false);
+    for (auto it = values.constBegin(); it != values.constEnd(); it++) {
+        auto item = items.value(it.key());
+        if (!item) {
+            item = new QTreeWidgetItem(m_tree, { it.key() });
+            item->setTextAlignment(1, Qt::AlignRight);
+            item->setTextAlignment(2, Qt::AlignRight);
+        }
+        item->setText(1, QString::number(it.value()));
+        auto last = m_last.find(it.key());
+        if (seconds > 0 && last != m_last.end())
+            item->setText(2, QString::number((it.value() - *last) / seconds, 'f', 1));
+    }
+    m_tree->setSortingEnabled(true);
+    m_last = values;
+}
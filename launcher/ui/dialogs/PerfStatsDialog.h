@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QTimer>
+
+class QTreeWidget;
+
+/** Shows the performance counters as they change, with how fast each of them goes up. */
+class PerfStatsDialog final : public QDialog {
+    Q_OBJECT
+
+   public:
+    explicit PerfStatsDialog(QWidget* parent = nullptr);
+
+   private slots:
+    void refresh();
+
+   private:
+    QTreeWidget* m_tree;
+    QTimer m_timer;
+    QElapsedTimer m_sinceLast;
+    QMap<QString, qint64> m_last;
+};
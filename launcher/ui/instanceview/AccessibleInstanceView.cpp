@@ -434,6 +434,9 @@ QAccessibleInterface* AccessibleInstanceView::child(int logicalIndex) const
     if (!view()->model())
         return 0;
 
+    if (m_cacheStale)
+        rekeyCache();
+
     auto id = childToId.constFind(logicalIndex);
     if (id != childToId.constEnd())
         return QAccessible::accessibleInterface(id.value());
@@ -475,54 +478,17 @@ void AccessibleInstanceView::modelChange(QAccessibleTableModelChangeEvent* event
             for (QAccessible::Id id : childToId)
                 QAccessible::deleteAccessibleInterface(id);
             childToId.clear();
+            m_cacheStale = false;
             break;
 
-        // rows are inserted: move every row after that
+        // the cells hold persistent indexes that follow their rows, so only the keys need fixing, and that can wait
+        // until someone asks for a cell instead of happening for every one of a bulk change's events
         case QAccessibleTableModelChangeEvent::RowsInserted:
-        case QAccessibleTableModelChangeEvent::ColumnsInserted: {
-            ChildCache newCache;
-            ChildCache::ConstIterator iter = childToId.constBegin();
-
-            while (iter != childToId.constEnd()) {
-                QAccessible::Id id = iter.value();
-                QAccessibleInterface* iface = QAccessible::accessibleInterface(id);
-                Q_ASSERT(iface);
-                if (indexOfChild(iface) >= 0) {
-                    newCache.insert(indexOfChild(iface), id);
-                } else {
-                    // ### This should really not happen,
-                    // but it might if the view has a root index set.
-                    // This needs to be fixed.
-                    QAccessible::deleteAccessibleInterface(id);
-                }
-                ++iter;
-            }
-            childToId = newCache;
-            break;
-        }
-
+        case QAccessibleTableModelChangeEvent::ColumnsInserted:
         case QAccessibleTableModelChangeEvent::ColumnsRemoved:
-        case QAccessibleTableModelChangeEvent::RowsRemoved: {
-            ChildCache newCache;
-            ChildCache::ConstIterator iter = childToId.constBegin();
-            while (iter != childToId.constEnd()) {
-                QAccessible::Id id = iter.value();
-                QAccessibleInterface* iface = QAccessible::accessibleInterface(id);
-                Q_ASSERT(iface);
-                if (iface->role() == QAccessible::Cell || iface->role() == QAccessible::ListItem) {
-                    Q_ASSERT(iface->tableCellInterface());
-                    AccessibleInstanceViewItem* cell = static_cast<AccessibleInstanceViewItem*>(iface->tableCellInterface());
-                    // Since it is a QPersistentModelIndex, we only need to check if it is valid
-                    if (cell->m_index.isValid())
-                        newCache.insert(indexOfChild(cell), id);
-                    else
-                        QAccessible::deleteAccessibleInterface(id);
-                }
-                ++iter;
-            }
-            childToId = newCache;
+        case QAccessibleTableModelChangeEvent::RowsRemoved:
+            m_cacheStale = true;
             break;
-        }
 
         case QAccessibleTableModelChangeEvent::DataChanged:
             // nothing to do in this case
@@ -530,6 +496,24 @@ void AccessibleInstanceView::modelChange(QAccessibleTableModelChangeEvent* event
     }
 }
 
+void AccessibleInstanceView::rekeyCache() const
+{
+    m_cacheStale = false;
+    ChildCache newCache;
+    newCache.reserve(childToId.size());
+    for (QAccessible::Id id : childToId) {
+        QAccessibleInterface* iface = QAccessible::accessibleInterface(id);
+        Q_ASSERT(iface && iface->tableCellInterface());
+        auto cell = static_cast<AccessibleInstanceViewItem*>(iface->tableCellInterface());
+        // Since it is a QPersistentModelIndex, we only need to check if it is valid
+        if (cell->m_index.isValid())
+            newCache.insert(logicalIndex(cell->m_index), id);
+        else
+            QAccessible::deleteAccessibleInterface(id);
+    }
+    childToId = newCache;
+}
+
 // TABLE CELL
 
 AccessibleInstanceViewItem::AccessibleInstanceViewItem(QAbstractItemView* view_, const QModelIndex& index_) : view(view_), m_index(index_)
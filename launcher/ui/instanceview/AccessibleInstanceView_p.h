@@ -61,11 +61,15 @@ class AccessibleInstanceView : public QAccessibleTableInterface, public QAccessi
     // maybe vector
     using ChildCache = QHash<int, QAccessible::Id>;
     mutable ChildCache childToId;
+    // rows were inserted or removed since the cache was keyed, so every key after them may be off
+    mutable bool m_cacheStale = false;
 
     virtual ~AccessibleInstanceView();
 
    private:
     inline int logicalIndex(const QModelIndex& index) const;
+    /// key the cached cells by where their rows are now, and release the ones whose rows are gone
+    void rekeyCache() const;
 };
 
 class AccessibleInstanceViewItem : public QAccessibleInterface, public QAccessibleTableCellInterface, public QAccessibleActionInterface {
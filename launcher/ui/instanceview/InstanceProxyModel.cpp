@@ -28,6 +28,44 @@ InstanceProxyModel::InstanceProxyModel(QObject* parent) : QSortFilterProxyModel(
     m_naturalSort.setCaseSensitivity(Qt::CaseSensitivity::CaseInsensitive);
     // FIXME: use loaded translation as source of locale instead, hook this up to translation changes
     m_naturalSort.setLocale(QLocale::system());
+
+    m_sortByLastLaunch = APPLICATION->settings()->get("InstSortMode").toString() == "LastLaunch";
+    connect(APPLICATION->settings().get(), &SettingsObject::SettingChanged, this, [this](const Setting& setting, QVariant value) {
+        if (setting.id() == "InstSortMode")
+            m_sortByLastLaunch = value.toString() == "LastLaunch";
+    });
+}
+
+void InstanceProxyModel::setSourceModel(QAbstractItemModel* model)
+{
+    if (sourceModel())
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    m_sortKeys.clear();
+    // before the proxy itself hears of the changes, so it sorts by the new keys
+    if (model) {
+        connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+            forgetRows(topLeft.parent(), topLeft.row(), bottomRight.row());
+        });
+        connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &InstanceProxyModel::forgetRows);
+        connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this] { m_sortKeys.clear(); });
+        connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, [this] { m_sortKeys.clear(); });
+    }
+    QSortFilterProxyModel::setSourceModel(model);
+}
+
+void InstanceProxyModel::forgetRows(const QModelIndex& parent, int first, int last)
+{
+    for (int row = first; row <= last; row++)
+        m_sortKeys.remove(static_cast<const BaseInstance*>(sourceModel()->index(row, 0, parent).internalPointer()));
+}
+
+InstanceProxyModel::SortKeys InstanceProxyModel::sortKeys(const QModelIndex& index) const
+{
+    auto instance = static_cast<const BaseInstance*>(index.internalPointer());
+    auto it = m_sortKeys.find(instance);
+    if (it == m_sortKeys.end())
+        it = m_sortKeys.insert(instance, { index.data(InstanceViewRoles::GroupRole).toString(), instance->name(), instance->lastLaunch() });
+    return *it;
 }
 
 QVariant InstanceProxyModel::data(const QModelIndex& index, int role) const
@@ -41,8 +79,8 @@ QVariant InstanceProxyModel::data(const QModelIndex& index, int role) const
 
 bool InstanceProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
 {
-    const QString leftCategory = left.data(InstanceViewRoles::GroupRole).toString();
-    const QString rightCategory = right.data(InstanceViewRoles::GroupRole).toString();
+    const QString leftCategory = sortKeys(left).group;
+    const QString rightCategory = sortKeys(right).group;
     if (leftCategory == rightCategory) {
         return subSortLessThan(left, right);
     } else {
@@ -57,12 +95,11 @@ bool InstanceProxyModel::lessThan(const QModelIndex& left, const QModelIndex& ri
 
 bool InstanceProxyModel::subSortLessThan(const QModelIndex& left, const QModelIndex& right) const
 {
-    BaseInstance* pdataLeft = static_cast<BaseInstance*>(left.internalPointer());
-    BaseInstance* pdataRight = static_cast<BaseInstance*>(right.internalPointer());
-    QString sortMode = APPLICATION->settings()->get("InstSortMode").toString();
-    if (sortMode == "LastLaunch") {
-        return pdataLeft->lastLaunch() > pdataRight->lastLaunch();
+    auto leftKeys = sortKeys(left);
+    auto rightKeys = sortKeys(right);
+    if (m_sortByLastLaunch) {
+        return leftKeys.lastLaunch > rightKeys.lastLaunch;
     } else {
-        return m_naturalSort.compare(pdataLeft->name(), pdataRight->name()) < 0;
+        return m_naturalSort.compare(leftKeys.name, rightKeys.name) < 0;
     }
 }
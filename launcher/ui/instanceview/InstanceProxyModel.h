@@ -16,19 +16,37 @@
 #pragma once
 
 #include <QCollator>
+#include <QHash>
 #include <QSortFilterProxyModel>
 
+class BaseInstance;
+
 class InstanceProxyModel : public QSortFilterProxyModel {
     Q_OBJECT
 
    public:
     InstanceProxyModel(QObject* parent = 0);
 
+    void setSourceModel(QAbstractItemModel* model) override;
+
    protected:
     QVariant data(const QModelIndex& index, int role) const override;
     bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
     bool subSortLessThan(const QModelIndex& left, const QModelIndex& right) const;
 
+   private:
+    /// what instances are sorted by, read out of their settings once rather than on every comparison
+    struct SortKeys {
+        QString group;
+        QString name;
+        qint64 lastLaunch = 0;
+    };
+    /// a copy, the cache may grow while the other side of a comparison is looked up
+    SortKeys sortKeys(const QModelIndex& index) const;
+    void forgetRows(const QModelIndex& parent, int first, int last);
+
    private:
     QCollator m_naturalSort;
+    bool m_sortByLastLaunch = false;
+    mutable QHash<const BaseInstance*, SortKeys> m_sortKeys;
 };
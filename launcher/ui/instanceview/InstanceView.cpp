@@ -40,15 +40,21 @@
 #include <QCache>
 #include <QDrag>
 #include <QFont>
+#include <QFutureWatcher>
+#include <QImageReader>
 #include <QListView>
 #include <QMimeData>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPaintEvent>
 #include <QPersistentModelIndex>
+#include <QScreen>
 #include <QScrollBar>
 #include <QtMath>
+#include <algorithm>
 
 #include "VisualGroup.h"
+#include "tasks/Executor.h"
 #include "ui/themes/ThemeManager.h"
 
 #include <Application.h>
@@ -72,6 +78,8 @@ InstanceView::InstanceView(QWidget* parent) : QAbstractItemView(parent)
     setAcceptDrops(true);
     setAutoScroll(true);
     setPaintCat(APPLICATION->settings()->get("TheCat").toBool());
+    // in KiB, plenty for a screen full of items
+    m_paintCache.setMaxCost(32 * 1024);
 }
 
 InstanceView::~InstanceView()
@@ -87,11 +95,58 @@ void InstanceView::setModel(QAbstractItemModel* model)
     connect(model, &QAbstractItemModel::rowsRemoved, this, &InstanceView::rowsRemoved);
 }
 
-void InstanceView::dataChanged([[maybe_unused]] const QModelIndex& topLeft,
-                               [[maybe_unused]] const QModelIndex& bottomRight,
-                               [[maybe_unused]] const QVector<int>& roles)
+void InstanceView::dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
 {
-    scheduleDelayedItemsLayout();
+    // only the name and the group move things around, anything else just needs painting again
+    bool moves = roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(InstanceViewRoles::GroupRole);
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        auto index = model()->index(row, 0);
+        auto key = itemKey(index);
+        m_paintCache.remove(key);
+        if (!moves) {
+            viewport()->update(m_itemRects.value(row).translated(-offset()));
+            continue;
+        }
+        m_itemSizes.remove(key);
+        m_dirtyGroups.insert(index.data(InstanceViewRoles::GroupRole).toString());
+        if (auto group = m_itemGroups.value(row))
+            m_dirtyGroups.insert(group->text);
+    }
+    if (moves)
+        scheduleDelayedItemsLayout();
+    queueAccessibleDataChanged(topLeft.row(), bottomRight.row());
+}
+
+void InstanceView::queueAccessibleDataChanged(int first, int last)
+{
+#ifndef QT_NO_ACCESSIBILITY
+    if (!QAccessible::isActive())
+        return;
+    if (m_accessibleFirstChanged >= 0) {
+        m_accessibleFirstChanged = std::min(m_accessibleFirstChanged, first);
+        m_accessibleLastChanged = std::max(m_accessibleLastChanged, last);
+        return;
+    }
+    m_accessibleFirstChanged = first;
+    m_accessibleLastChanged = last;
+    QMetaObject::invokeMethod(
+        this,
+        [this] {
+            // rows may have gone away since
+            int last = std::min(m_accessibleLastChanged, model() ? model()->rowCount() - 1 : -1);
+            int first = m_accessibleFirstChanged;
+            m_accessibleFirstChanged = m_accessibleLastChanged = -1;
+            if (first > last || !QAccessible::isActive())
+                return;
+            QAccessibleTableModelChangeEvent event(this, QAccessibleTableModelChangeEvent::DataChanged);
+            event.setFirstRow(first);
+            event.setLastRow(last);
+            event.setFirstColumn(0);
+            event.setLastColumn(0);
+            QAccessible::updateAccessibility(&event);
+        },
+        Qt::QueuedConnection);
+#endif /* !QT_NO_ACCESSIBILITY */
 }
 void InstanceView::rowsInserted([[maybe_unused]] const QModelIndex& parent, [[maybe_unused]] int start, [[maybe_unused]] int end)
 {
@@ -172,32 +227,59 @@ void InstanceView::updateScrollbar()
 
 void InstanceView::updateGeometries()
 {
-    geometryCache.clear();
-
-    QMap<LocaleString, VisualGroup*> cats;
+    // one pass over the model for the items of every group
+    QMap<LocaleString, QList<QModelIndex>> groupItems;
+    const int rowCount = model()->rowCount();
+    for (int i = 0; i < rowCount; ++i) {
+        const QModelIndex index = model()->index(i, 0);
+        groupItems[index.data(InstanceViewRoles::GroupRole).toString()].append(index);
+    }
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        const QString groupName = model()->index(i, 0).data(InstanceViewRoles::GroupRole).toString();
-        if (!cats.contains(groupName)) {
-            VisualGroup* old = this->category(groupName);
-            if (old) {
-                auto cat = new VisualGroup(old);
-                cats.insert(groupName, cat);
-                cat->update();
-            } else {
-                auto cat = new VisualGroup(groupName, this);
-                if (fVisibility) {
-                    cat->collapsed = fVisibility(groupName);
-                }
-                cats.insert(groupName, cat);
-                cat->update();
+    QList<VisualGroup*> cats;
+    for (auto it = groupItems.cbegin(); it != groupItems.cend(); ++it) {
+        const QString& groupName = it.key();
+        VisualGroup* old = this->category(groupName);
+        VisualGroup* cat;
+        if (old) {
+            cat = new VisualGroup(old);
+            // a group nothing happened to keeps its layout
+            if (!m_dirtyGroups.contains(groupName) && cat->sameLayout(old, *it))
+                cat->copyLayout(old);
+            else
+                cat->update(*it);
+        } else {
+            cat = new VisualGroup(groupName, this);
+            if (fVisibility) {
+                cat->collapsed = fVisibility(groupName);
             }
+            cat->update(*it);
         }
+        cats.append(cat);
     }
 
     qDeleteAll(m_groups);
-    m_groups = cats.values();
+    m_groups = cats;
+    m_dirtyGroups.clear();
     updateScrollbar();
+
+    m_itemRects = QVector<QRect>(rowCount);
+    m_itemGroups = QVector<VisualGroup*>(rowCount, nullptr);
+    for (auto cat : m_groups) {
+        const int bodyTop = cat->verticalPosition() + cat->headerHeight() + 5;
+        for (auto& row : cat->rows) {
+            for (int x = 0; x < row.size(); x++) {
+                const QModelIndex& index = row.items[x];
+                m_itemGroups[index.row()] = cat;
+                if (cat->collapsed)
+                    continue;
+                QRect out;
+                out.setTop(bodyTop + row.top);
+                out.setLeft(m_spacing + x * (itemWidth() + m_spacing));
+                out.setSize(itemSize(index));
+                m_itemRects[index.row()] = out;
+            }
+        }
+    }
     viewport()->update();
 }
 
@@ -213,6 +295,8 @@ bool InstanceView::isIndexHidden(const QModelIndex& index) const
 
 VisualGroup* InstanceView::category(const QModelIndex& index) const
 {
+    if (auto group = m_itemGroups.value(index.row()))
+        return group;
     return category(index.data(InstanceViewRoles::GroupRole).toString());
 }
 
@@ -226,12 +310,21 @@ VisualGroup* InstanceView::category(const QString& cat) const
     return nullptr;
 }
 
+int InstanceView::groupIndexAt(int y) const
+{
+    // the groups are laid out from the top down
+    auto it = std::upper_bound(m_groups.begin(), m_groups.end(), y,
+                               [](int y, const VisualGroup* group) { return y < group->verticalPosition(); });
+    return int(it - m_groups.begin()) - 1;
+}
+
 VisualGroup* InstanceView::categoryAt(const QPoint& pos, VisualGroup::HitResults& result) const
 {
-    for (auto group : m_groups) {
-        result = group->hitScan(pos);
+    int i = groupIndexAt(pos.y());
+    if (i >= 0) {
+        result = m_groups[i]->hitScan(pos);
         if (result != VisualGroup::NoHit) {
-            return group;
+            return m_groups[i];
         }
     }
     result = VisualGroup::NoHit;
@@ -265,6 +358,40 @@ int InstanceView::itemWidth() const
     return m_itemWidth;
 }
 
+QSize InstanceView::itemSize(const QModelIndex& index) const
+{
+    auto key = itemKey(index);
+    auto it = m_itemSizes.constFind(key);
+    if (it != m_itemSizes.constEnd())
+        return *it;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QStyleOptionViewItem option;
+    initViewItemOption(&option);
+#else
+    QStyleOptionViewItem option = viewOptions();
+#endif
+    // laying the text out is what makes this expensive
+    auto size = itemDelegate()->sizeHint(option, index);
+    if (!key.isEmpty())
+        m_itemSizes.insert(key, size);
+    return size;
+}
+
+QString InstanceView::itemKey(const QModelIndex& index)
+{
+    return index.data(InstanceList::InstanceIDRole).toString();
+}
+
+void InstanceView::invalidateItems()
+{
+    m_itemSizes.clear();
+    m_paintCache.clear();
+    for (auto group : m_groups)
+        m_dirtyGroups.insert(group->text);
+    scheduleDelayedItemsLayout();
+}
+
 void InstanceView::mousePressEvent(QMouseEvent* event)
 {
     executeDelayedItemsLayout();
@@ -445,29 +572,87 @@ void InstanceView::mouseDoubleClickEvent(QMouseEvent* event)
 void InstanceView::setPaintCat(bool visible)
 {
     m_catVisible = visible;
-    if (visible)
-        m_catPixmap.load(APPLICATION->themeManager()->getCatPack());
-    else
-        m_catPixmap = QPixmap();
+    m_catImage = QImage();
+    m_catPixmap = QPixmap();
+    m_catPixmapBounds = QSize();
+    auto generation = ++m_catGeneration;
+    if (!visible) {
+        viewport()->update();
+        return;
+    }
+
+    // big cats take a while to decode, this one shows up once it's ready
+    auto path = APPLICATION->themeManager()->getCatPack();
+    QSize bounds;
+    if (auto screen = QGuiApplication::primaryScreen())
+        bounds = screen->size() * screen->devicePixelRatio();
+    auto future = Executor::instance()->run(Executor::Priority::Interactive, [path, bounds] {
+        QImageReader reader(path);
+        auto size = reader.size();
+        if (bounds.isValid() && size.isValid() && (size.width() > bounds.width() || size.height() > bounds.height()))
+            reader.setScaledSize(size.scaled(bounds, Qt::KeepAspectRatio));
+        return reader.read();
+    });
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation] {
+        watcher->deleteLater();
+        if (generation != m_catGeneration)
+            return;
+        m_catImage = watcher->result();
+        viewport()->update();
+    });
+    watcher->setFuture(future);
 }
 
-void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
+void InstanceView::paintItem(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    auto key = itemKey(index);
+    // a running progress overlay changes on every paint
+    auto progressMaximum = index.data(InstanceViewRoles::ProgressMaximumRole).toInt();
+    bool inProgress = progressMaximum != 0 && index.data(InstanceViewRoles::ProgressValueRole).toInt() != progressMaximum;
+    if (key.isEmpty() || inProgress) {
+        itemDelegate()->paint(painter, option, index);
+        return;
+    }
+
+    const int state = static_cast<int>(option.state);
+    const qreal ratio = viewport()->devicePixelRatioF();
+    auto cached = m_paintCache.object(key);
+    if (cached && cached->state == state && cached->pixmap.size() == option.rect.size() * ratio) {
+        painter->drawPixmap(option.rect.topLeft(), cached->pixmap);
+        return;
+    }
+
+    QPixmap pixmap(option.rect.size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter itemPainter(&pixmap);
+        QStyleOptionViewItem itemOption = option;
+        itemOption.rect = QRect(QPoint(), option.rect.size());
+        itemDelegate()->paint(&itemPainter, itemOption, index);
+    }
+    painter->drawPixmap(option.rect.topLeft(), pixmap);
+    auto cost = qMax(1, pixmap.width() * pixmap.height() * 4 / 1024);
+    m_paintCache.insert(key, new PaintedItem{ state, pixmap }, cost);
+}
+
+void InstanceView::paintEvent(QPaintEvent* event)
 {
     executeDelayedItemsLayout();
 
     QPainter painter(this->viewport());
 
-    if (m_catVisible) {
-        int widWidth = this->viewport()->width();
-        int widHeight = this->viewport()->height();
-        if (m_catPixmap.width() < widWidth)
-            widWidth = m_catPixmap.width();
-        if (m_catPixmap.height() < widHeight)
-            widHeight = m_catPixmap.height();
-        auto pixmap = m_catPixmap.scaled(widWidth, widHeight, Qt::KeepAspectRatio);
-        QRect rectOfPixmap = pixmap.rect();
+    if (m_catVisible && !m_catImage.isNull()) {
+        // only scaled again when the viewport changes size
+        auto bounds = this->viewport()->size().boundedTo(m_catImage.size());
+        if (bounds != m_catPixmapBounds) {
+            m_catPixmap = QPixmap::fromImage(m_catImage.scaled(bounds, Qt::KeepAspectRatio));
+            m_catPixmapBounds = bounds;
+        }
+        QRect rectOfPixmap = m_catPixmap.rect();
         rectOfPixmap.moveBottomRight(this->viewport()->rect().bottomRight());
-        painter.drawPixmap(rectOfPixmap.topLeft(), pixmap);
+        painter.drawPixmap(rectOfPixmap.topLeft(), m_catPixmap);
     }
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -510,10 +695,14 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
         return;
     }
 
+    // only what's in the part that needs painting
+    const QRect area = event->rect().translated(offset());
     int wpWidth = viewport()->width();
     option.rect.setWidth(wpWidth);
-    for (int i = 0; i < m_groups.size(); ++i) {
+    for (int i = qMax(0, groupIndexAt(area.top())); i < m_groups.size(); ++i) {
         VisualGroup* category = m_groups.at(i);
+        if (category->verticalPosition() > area.bottom())
+            break;
         int y = category->verticalPosition();
         y -= verticalOffset();
         QRect backup = option.rect;
@@ -527,12 +716,11 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
         option.rect = backup;
     }
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        const QModelIndex index = model()->index(i, 0);
-        if (isIndexHidden(index)) {
-            continue;
-        }
+    // every item starts from the same state, or the cached paintings wouldn't match up
+    const QStyle::State baseState = option.state & ~QStyle::State_HasFocus;
+    for (auto& index : indexesIn(area)) {
         Qt::ItemFlags flags = index.flags();
+        option.state = baseState;
         option.rect = visualRect(index);
         option.features |= QStyleOptionViewItem::WrapText;
         if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index)) {
@@ -544,7 +732,7 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
         if (!(flags & Qt::ItemIsEnabled)) {
             option.state &= ~QStyle::State_Enabled;
         }
-        itemDelegate()->paint(&painter, option, index);
+        paintItem(&painter, option, index);
     }
 
     /*
@@ -579,6 +767,20 @@ void InstanceView::paintEvent([[maybe_unused]] QPaintEvent* event)
 #endif
 }
 
+void InstanceView::changeEvent(QEvent* event)
+{
+    switch (event->type()) {
+        case QEvent::FontChange:
+        case QEvent::StyleChange:
+        case QEvent::PaletteChange:
+            invalidateItems();
+            break;
+        default:
+            break;
+    }
+    QAbstractItemView::changeEvent(event);
+}
+
 void InstanceView::resizeEvent([[maybe_unused]] QResizeEvent* event)
 {
     int newItemsPerRow = calculateItemsPerRow();
@@ -706,59 +908,52 @@ QRect InstanceView::geometryRect(const QModelIndex& index) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    if (!index.isValid() || isIndexHidden(index) || index.column() > 0) {
+    if (!index.isValid() || index.column() > 0) {
         return QRect();
     }
-
-    int row = index.row();
-    if (geometryCache.contains(row)) {
-        return *geometryCache[row];
-    }
-
-    const VisualGroup* cat = category(index);
-    QPair<int, int> pos = cat->positionOf(index);
-    int x = pos.first;
-    // int y = pos.second;
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    QStyleOptionViewItem option;
-    initViewItemOption(&option);
-#else
-    QStyleOptionViewItem option = viewOptions();
-#endif
-
-    QRect out;
-    out.setTop(cat->verticalPosition() + cat->headerHeight() + 5 + cat->rowTopOf(index));
-    out.setLeft(m_spacing + x * (itemWidth() + m_spacing));
-    out.setSize(itemDelegate()->sizeHint(option, index));
-    geometryCache.insert(row, new QRect(out));
-    return out;
+    // null for the items of collapsed groups
+    return m_itemRects.value(index.row());
 }
 
 QModelIndex InstanceView::indexAt(const QPoint& point) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        QModelIndex index = model()->index(i, 0);
-        if (visualRect(index).contains(point)) {
-            return index;
+    auto pos = point + offset();
+    int i = groupIndexAt(pos.y());
+    if (i < 0)
+        return QModelIndex();
+    return m_groups[i]->itemAt(pos);
+}
+
+QModelIndexList InstanceView::indexesIn(const QRect& rect) const
+{
+    QModelIndexList indexes;
+    for (int i = qMax(0, groupIndexAt(rect.top())); i < m_groups.size(); i++) {
+        auto group = m_groups[i];
+        if (group->verticalPosition() > rect.bottom())
+            break;
+        if (group->collapsed)
+            continue;
+        const int bodyTop = group->verticalPosition() + group->headerHeight() + 5;
+        auto range = group->rowsBetween(rect.top() - bodyTop, rect.bottom() - bodyTop);
+        for (int row = range.first; row < range.second; row++) {
+            for (auto& index : group->rows[row].items) {
+                if (m_itemRects.value(index.row()).intersects(rect))
+                    indexes.append(index);
+            }
         }
     }
-    return QModelIndex();
+    return indexes;
 }
 
 void InstanceView::setSelection(const QRect& rect, const QItemSelectionModel::SelectionFlags commands)
 {
     executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i) {
-        QModelIndex index = model()->index(i, 0);
-        QRect itemRect = visualRect(index);
-        if (itemRect.intersects(rect)) {
-            selectionModel()->select(index, commands);
-            update(itemRect.translated(-offset()));
-        }
+    for (auto& index : indexesIn(rect.translated(offset()))) {
+        selectionModel()->select(index, commands);
+        update(visualRect(index).translated(-offset()));
     }
 }
 
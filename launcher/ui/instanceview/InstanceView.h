@@ -36,9 +36,12 @@
 #pragma once
 
 #include <QCache>
+#include <QHash>
+#include <QImage>
 #include <QLineEdit>
 #include <QListView>
 #include <QScrollBar>
+#include <QSet>
 #include <functional>
 #include "VisualGroup.h"
 
@@ -102,6 +105,7 @@ class InstanceView : public QAbstractItemView {
     void mouseDoubleClickEvent(QMouseEvent* event) override;
     void paintEvent(QPaintEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
 
     void dragEnterEvent(QDragEnterEvent* event) override;
     void dragMoveEvent(QDragMoveEvent* event) override;
@@ -127,9 +131,25 @@ class InstanceView : public QAbstractItemView {
     int m_itemWidth = 100;
     int m_currentItemsPerRow = -1;
     int m_currentCursorColumn = -1;
-    mutable QCache<int, QRect> geometryCache;
+    // where every item is, by model row, null for the hidden ones
+    QVector<QRect> m_itemRects;
+    QVector<VisualGroup*> m_itemGroups;
+    // sizes the delegate gave, by item, they only change when the item does
+    mutable QHash<QString, QSize> m_itemSizes;
+    // groups with items that changed since the last layout, the others keep theirs
+    QSet<QString> m_dirtyGroups;
+    // what the delegate painted, by item, with the state it was painted in
+    struct PaintedItem {
+        int state;
+        QPixmap pixmap;
+    };
+    mutable QCache<QString, PaintedItem> m_paintCache;
     bool m_catVisible = false;
+    // the cat, decoded off the GUI thread no larger than the screen, then as it was last scaled for the viewport
+    QImage m_catImage;
     QPixmap m_catPixmap;
+    QSize m_catPixmapBounds;
+    quint64 m_catGeneration = 0;
 
     // point where the currently active mouse action started in geometry coordinates
     QPoint m_pressedPosition;
@@ -139,15 +159,33 @@ class InstanceView : public QAbstractItemView {
     QItemSelectionModel::SelectionFlag m_ctrlDragSelectionFlag;
     QPoint m_lastDragPosition;
 
+    // the rows changed since accessibility was last told, -1 when nothing did
+    int m_accessibleFirstChanged = -1;
+    int m_accessibleLastChanged = -1;
+
     VisualGroup* category(const QModelIndex& index) const;
     VisualGroup* category(const QString& cat) const;
     VisualGroup* categoryAt(const QPoint& pos, VisualGroup::HitResults& result) const;
+    /// the group that is at that height or the last one above it, in geometry coordinates
+    int groupIndexAt(int y) const;
 
     int itemsPerRow() const { return m_currentItemsPerRow; };
     int contentWidth() const;
 
    private: /* methods */
     int itemWidth() const;
+    /// how big the delegate makes the item
+    QSize itemSize(const QModelIndex& index) const;
+    /// what the caches know the item by
+    static QString itemKey(const QModelIndex& index);
+    /// the items overlapping the rectangle, in geometry coordinates
+    QModelIndexList indexesIn(const QRect& rect) const;
+    /// paint through the delegate, or what it painted last time the item looked the same
+    void paintItem(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const;
+    /// forget what's known about how the items look, like when the font or style changed
+    void invalidateItems();
+    /// tell accessibility the rows changed, in one event for everything that changes before the event loop comes around
+    void queueAccessibleDataChanged(int first, int last);
     int calculateItemsPerRow() const;
     int verticalScrollToValue(const QModelIndex& index, const QRect& rect, QListView::ScrollHint hint) const;
     QPixmap renderToPixmap(const QModelIndexList& indices, QRect* r) const;
@@ -41,6 +41,7 @@
 #include <QModelIndex>
 #include <QPainter>
 #include <QtMath>
+#include <algorithm>
 #include <utility>
 
 #include "InstanceView.h"
@@ -49,10 +50,12 @@ VisualGroup::VisualGroup(QString text, InstanceView* view) : view(view), text(st
 
 VisualGroup::VisualGroup(const VisualGroup* other) : view(other->view), text(other->text), collapsed(other->collapsed) {}
 
-void VisualGroup::update()
+void VisualGroup::update(const QList<QModelIndex>& temp_items)
 {
-    auto temp_items = items();
     auto itemsPerRow = view->itemsPerRow();
+    layoutItemsPerRow = itemsPerRow;
+    positions.clear();
+    keys.clear();
 
     int numRows = qMax(1, qCeil((qreal)temp_items.size() / (qreal)itemsPerRow));
     rows = QVector<VisualRow>(numRows);
@@ -70,17 +73,13 @@ void VisualGroup::update()
             positionInRow = 0;
             maxRowHeight = 0;
         }
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        QStyleOptionViewItem viewItemOption;
-        view->initViewItemOption(&viewItemOption);
-#else
-        QStyleOptionViewItem viewItemOption = view->viewOptions();
-#endif
-
-        auto itemHeight = view->itemDelegate()->sizeHint(viewItemOption, item).height();
+        // measured once and kept by the view until the item changes
+        auto itemHeight = view->itemSize(item).height();
         if (itemHeight > maxRowHeight) {
             maxRowHeight = itemHeight;
         }
+        positions.insert(item.row(), qMakePair(positionInRow, currentRow));
+        keys.append(InstanceView::itemKey(item));
         rows[currentRow].items.append(item);
         positionInRow++;
     }
@@ -88,21 +87,72 @@ void VisualGroup::update()
     rows[currentRow].top = offsetFromTop;
 }
 
-QPair<int, int> VisualGroup::positionOf(const QModelIndex& index) const
+bool VisualGroup::sameLayout(const VisualGroup* other, const QList<QModelIndex>& items) const
 {
-    int y = 0;
-    for (auto& row : rows) {
-        for (auto x = 0; x < row.items.size(); x++) {
-            if (row.items[x] == index) {
-                return qMakePair(x, y);
-            }
+    if (other->layoutItemsPerRow != view->itemsPerRow() || other->keys.size() != items.size())
+        return false;
+    // the same rows could have other items in them after sorting
+    int i = 0;
+    for (auto& row : other->rows) {
+        for (auto& item : row.items) {
+            if (items[i] != item || other->keys[i] != InstanceView::itemKey(items[i]))
+                return false;
+            i++;
         }
-        y++;
     }
+    return true;
+}
+
+void VisualGroup::copyLayout(const VisualGroup* other)
+{
+    rows = other->rows;
+    positions = other->positions;
+    keys = other->keys;
+    layoutItemsPerRow = other->layoutItemsPerRow;
+}
+
+QPair<int, int> VisualGroup::positionOf(const QModelIndex& index) const
+{
+    auto it = positions.constFind(index.row());
+    if (it != positions.constEnd())
+        return *it;
     qWarning() << "Item" << index.row() << index.data(Qt::DisplayRole).toString() << "not found in visual group" << text;
     return qMakePair(0, 0);
 }
 
+QPair<int, int> VisualGroup::rowsBetween(int top, int bottom) const
+{
+    // rows are in order and don't overlap, so both ends can be searched for
+    auto first = std::lower_bound(rows.begin(), rows.end(), top, [](const VisualRow& row, int y) { return row.top + row.height < y; });
+    auto last = std::upper_bound(first, rows.end(), bottom, [](int y, const VisualRow& row) { return y < row.top; });
+    return qMakePair(int(first - rows.begin()), int(last - rows.begin()));
+}
+
+QModelIndex VisualGroup::itemAt(const QPoint& pos) const
+{
+    if (collapsed)
+        return {};
+    int y = pos.y() - (verticalPosition() + headerHeight() + 5);
+    auto range = rowsBetween(y, y);
+    if (range.first >= range.second)
+        return {};
+    auto& row = rows[range.first];
+    if (y < row.top || y >= row.top + row.height)
+        return {};
+    int step = view->itemWidth() + view->spacing();
+    int x = pos.x() - view->spacing();
+    if (x < 0 || x % step >= view->itemWidth())
+        return {};
+    int column = x / step;
+    if (column >= row.size())
+        return {};
+    auto index = row.items[column];
+    // items in a row can be shorter than it
+    if (y - row.top >= view->itemSize(index).height())
+        return {};
+    return index;
+}
+
 int VisualGroup::rowTopOf(const QModelIndex& index) const
 {
     auto position = positionOf(index);
@@ -238,11 +288,7 @@ int VisualGroup::verticalPosition() const
 QList<QModelIndex> VisualGroup::items() const
 {
     QList<QModelIndex> indices;
-    for (int i = 0; i < view->model()->rowCount(); ++i) {
-        const QModelIndex index = view->model()->index(i, 0);
-        if (index.data(InstanceViewRoles::GroupRole).toString() == text) {
-            indices.append(index);
-        }
-    }
+    for (auto& row : rows)
+        indices.append(row.items);
     return indices;
 }
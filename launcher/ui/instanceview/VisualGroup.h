@@ -35,14 +35,16 @@
 
 #pragma once
 
+#include <QHash>
+#include <QModelIndex>
 #include <QRect>
 #include <QString>
+#include <QStringList>
 #include <QStyleOption>
 #include <QVector>
 
 class InstanceView;
 class QPainter;
-class QModelIndex;
 
 struct VisualRow {
     QList<QModelIndex> items;
@@ -64,10 +66,20 @@ struct VisualGroup {
     QVector<VisualRow> rows;
     int firstItemIndex = 0;
     int m_verticalPosition = 0;
+    // model row -> (column, row) inside the group
+    QHash<int, QPair<int, int>> positions;
+    // what the view knows the items by, in the order they were flowed
+    QStringList keys;
+    // how many items fit in a row when they were flowed
+    int layoutItemsPerRow = -1;
 
     /* logic */
-    /// update the internal list of items and flow them into the rows.
-    void update();
+    /// take over the items of the group and flow them into the rows.
+    void update(const QList<QModelIndex>& items);
+    /// whether the layout of another group can be kept, it has the same items flowed the same way
+    bool sameLayout(const VisualGroup* other, const QList<QModelIndex>& items) const;
+    /// take the rows of another group as they are
+    void copyLayout(const VisualGroup* other);
 
     /// draw the header at y-position.
     void drawHeader(QPainter* painter, const QStyleOptionViewItem& option) const;
@@ -105,6 +117,11 @@ struct VisualGroup {
     /// shoot! BANG! what did we hit?
     HitResults hitScan(const QPoint& pos) const;
 
+    /// the rows that overlap the vertical range, relative to the top of the group's body, as [first, last)
+    QPair<int, int> rowsBetween(int top, int bottom) const;
+    /// the item at a position in geometry coordinates, if there's one
+    QModelIndex itemAt(const QPoint& pos) const;
+
     QList<QModelIndex> items() const;
 };
 
@@ -70,6 +70,8 @@ void ExternalToolsPage::loadSettings()
     auto s = APPLICATION->settings();
     ui->jprofilerPathEdit->setText(s->get("JProfilerPath").toString());
     ui->jvisualvmPathEdit->setText(s->get("JVisualVMPath").toString());
+    ui->asyncProfilerPathEdit->setText(s->get("AsyncProfilerPath").toString());
+    ui->recordingDurationSpinBox->setValue(s->get("ProfileRecordingSeconds").toInt());
     ui->mceditPathEdit->setText(s->get("MCEditPath").toString());
 
     // Editors
@@ -81,6 +83,8 @@ void ExternalToolsPage::applySettings()
 
     s->set("JProfilerPath", ui->jprofilerPathEdit->text());
     s->set("JVisualVMPath", ui->jvisualvmPathEdit->text());
+    s->set("AsyncProfilerPath", ui->asyncProfilerPathEdit->text());
+    s->set("ProfileRecordingSeconds", ui->recordingDurationSpinBox->value());
     s->set("MCEditPath", ui->mceditPathEdit->text());
 
     // Editors
@@ -152,6 +156,35 @@ void ExternalToolsPage::on_jvisualvmCheckBtn_clicked()
     }
 }
 
+void ExternalToolsPage::on_asyncProfilerPathBtn_clicked()
+{
+    QString raw_dir = ui->asyncProfilerPathEdit->text();
+    QString error;
+    do {
+        raw_dir = QFileDialog::getOpenFileName(this, tr("asprof Executable"), raw_dir);
+        if (raw_dir.isEmpty()) {
+            break;
+        }
+        QString cooked_dir = FS::NormalizePath(raw_dir);
+        if (!APPLICATION->profilers()["async-profiler"]->check(cooked_dir, &error)) {
+            QMessageBox::critical(this, tr("Error"), tr("Error while checking async-profiler install:\n%1").arg(error));
+            continue;
+        } else {
+            ui->asyncProfilerPathEdit->setText(cooked_dir);
+            break;
+        }
+    } while (1);
+}
+void ExternalToolsPage::on_asyncProfilerCheckBtn_clicked()
+{
+    QString error;
+    if (!APPLICATION->profilers()["async-profiler"]->check(ui->asyncProfilerPathEdit->text(), &error)) {
+        QMessageBox::critical(this, tr("Error"), tr("Error while checking async-profiler install:\n%1").arg(error));
+    } else {
+        QMessageBox::information(this, tr("OK"), tr("async-profiler setup seems to be OK"));
+    }
+}
+
 void ExternalToolsPage::on_mceditPathBtn_clicked()
 {
     QString raw_dir = ui->mceditPathEdit->text();
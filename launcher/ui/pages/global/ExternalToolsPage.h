@@ -77,6 +77,8 @@ class ExternalToolsPage : public QWidget, public BasePage {
     void on_jprofilerCheckBtn_clicked();
     void on_jvisualvmPathBtn_clicked();
     void on_jvisualvmCheckBtn_clicked();
+    void on_asyncProfilerPathBtn_clicked();
+    void on_asyncProfilerCheckBtn_clicked();
     void on_mceditPathBtn_clicked();
     void on_mceditCheckBtn_clicked();
     void on_jsonEditorBrowseBtn_clicked();
@@ -40,13 +40,16 @@
 
 #include <QDir>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QTabBar>
 
+#include "ui/dialogs/ProgressDialog.h"
 #include "ui/dialogs/VersionSelectDialog.h"
 
 #include "java/JavaInstallList.h"
 #include "java/JavaUtils.h"
+#include "java/ManagedRuntimeTask.h"
 
 #include <FileSystem.h>
 #include <sys.h>
@@ -57,6 +60,8 @@ JavaPage::JavaPage(QWidget* parent) : QWidget(parent), ui(new Ui::JavaPage)
 {
     ui->setupUi(this);
     ui->tabWidget->tabBar()->hide();
+    connect(ui->autoTuneMemoryCheckBox, &QAbstractButton::toggled, ui->minMemSpinBox, &QWidget::setDisabled);
+    connect(ui->autoTuneMemoryCheckBox, &QAbstractButton::toggled, ui->maxMemSpinBox, &QWidget::setDisabled);
 
     loadSettings();
     updateThresholds();
@@ -88,6 +93,7 @@ void JavaPage::applySettings()
         s->set("MaxMemAlloc", min);
     }
     s->set("PermGen", ui->permGenSpinBox->value());
+    s->set("AutoTuneMemory", ui->autoTuneMemoryCheckBox->isChecked());
 
     // Java Settings
     s->set("JavaPath", ui->javaPathTextBox->text());
@@ -110,6 +116,7 @@ void JavaPage::loadSettings()
         ui->maxMemSpinBox->setValue(min);
     }
     ui->permGenSpinBox->setValue(s->get("PermGen").toInt());
+    ui->autoTuneMemoryCheckBox->setChecked(s->get("AutoTuneMemory").toBool());
 
     // Java Settings
     ui->javaPathTextBox->setText(s->get("JavaPath").toString());
@@ -137,6 +144,28 @@ void JavaPage::on_javaDetectBtn_clicked()
     }
 }
 
+void JavaPage::on_javaDownloadBtn_clicked()
+{
+    const QList<QPair<QString, QString>> runtimes = {
+        { "java-runtime-delta", tr("Java 21") },
+        { "java-runtime-gamma", tr("Java 17") },
+        { "jre-legacy", tr("Java 8") },
+    };
+    QStringList names;
+    for (auto& runtime : runtimes)
+        names.append(runtime.second);
+
+    bool ok = false;
+    auto name = QInputDialog::getItem(this, tr("Download Java"), tr("Select the Java runtime to download:"), names, 0, false, &ok);
+    if (!ok)
+        return;
+
+    auto task = makeShared<ManagedRuntimeTask>(runtimes.at(names.indexOf(name)).first);
+    ProgressDialog progress(this);
+    if (progress.execWithTask(task.get()) == QDialog::Accepted && task->wasSuccessful())
+        ui->javaPathTextBox->setText(task->javaPath());
+}
+
 void JavaPage::on_javaBrowseBtn_clicked()
 {
     QString raw_path = QFileDialog::getOpenFileName(this, tr("Find Java executable"));
@@ -70,6 +70,7 @@ class JavaPage : public QWidget, public BasePage {
 
    private slots:
     void on_javaDetectBtn_clicked();
+    void on_javaDownloadBtn_clicked();
     void on_javaTestBtn_clicked();
     void on_javaBrowseBtn_clicked();
     void on_maxMemSpinBox_valueChanged(int i);
@@ -48,6 +48,7 @@
 #include "Application.h"
 #include "BuildConfig.h"
 #include "DesktopServices.h"
+#include "modplatform/PackUpdatePreparer.h"
 #include "settings/SettingsObject.h"
 #include "ui/themes/ITheme.h"
 #include "updater/ExternalUpdater.h"
@@ -191,6 +192,9 @@ void LauncherPage::applySettings()
 
     s->set("NumberOfConcurrentTasks", ui->numberOfConcurrentTasksSpinBox->value());
     s->set("NumberOfConcurrentDownloads", ui->numberOfConcurrentDownloadsSpinBox->value());
+    s->set("NumberOfConcurrentUploads", ui->numberOfConcurrentUploadsSpinBox->value());
+    s->set("ScreenshotUploadMaxSize", ui->screenshotUploadMaxSizeSpinBox->value());
+    s->set("ScreenshotUploadRecompress", ui->screenshotUploadRecompressCheckBox->isChecked());
 
     // Console settings
     s->set("ShowConsole", ui->showConsoleCheck->isChecked());
@@ -201,6 +205,8 @@ void LauncherPage::applySettings()
     s->set("ConsoleFontSize", ui->fontSizeBox->value());
     s->set("ConsoleMaxLines", ui->lineLimitSpinBox->value());
     s->set("ConsoleOverflowStop", ui->checkStopLogging->checkState() != Qt::Unchecked);
+    s->set("ConsoleSessionLogs", ui->sessionLogsCheck->isChecked());
+    s->set("CollectJvmMetrics", ui->jvmMetricsCheck->isChecked());
 
     // Folders
     // TODO: Offer to move instances to new instance folder.
@@ -224,6 +230,11 @@ void LauncherPage::applySettings()
     // Mods
     s->set("ModMetadataDisabled", ui->metadataDisableBtn->isChecked());
     s->set("ModDependenciesDisabled", ui->dependenciesDisableBtn->isChecked());
+    bool preparing = s->get("PreparePackUpdates").toBool();
+    s->set("PreparePackUpdates", ui->preparePackUpdatesCheckBox->isChecked());
+    if (!preparing && ui->preparePackUpdatesCheckBox->isChecked())
+        APPLICATION->packUpdatePreparer()->checkAll();
+    s->set("PrefetchNewInstances", ui->prefetchNewInstancesCheckBox->isChecked());
 }
 void LauncherPage::loadSettings()
 {
@@ -242,6 +253,9 @@ void LauncherPage::loadSettings()
 
     ui->numberOfConcurrentTasksSpinBox->setValue(s->get("NumberOfConcurrentTasks").toInt());
     ui->numberOfConcurrentDownloadsSpinBox->setValue(s->get("NumberOfConcurrentDownloads").toInt());
+    ui->numberOfConcurrentUploadsSpinBox->setValue(s->get("NumberOfConcurrentUploads").toInt());
+    ui->screenshotUploadMaxSizeSpinBox->setValue(s->get("ScreenshotUploadMaxSize").toInt());
+    ui->screenshotUploadRecompressCheckBox->setChecked(s->get("ScreenshotUploadRecompress").toBool());
 
     // Console settings
     ui->showConsoleCheck->setChecked(s->get("ShowConsole").toBool());
@@ -260,6 +274,8 @@ void LauncherPage::loadSettings()
     refreshFontPreview();
     ui->lineLimitSpinBox->setValue(s->get("ConsoleMaxLines").toInt());
     ui->checkStopLogging->setChecked(s->get("ConsoleOverflowStop").toBool());
+    ui->sessionLogsCheck->setChecked(s->get("ConsoleSessionLogs").toBool());
+    ui->jvmMetricsCheck->setChecked(s->get("CollectJvmMetrics").toBool());
 
     // Folders
     ui->instDirTextBox->setText(s->get("InstanceDir").toString());
@@ -280,6 +296,8 @@ void LauncherPage::loadSettings()
     ui->metadataDisableBtn->setChecked(s->get("ModMetadataDisabled").toBool());
     ui->metadataWarningLabel->setHidden(!ui->metadataDisableBtn->isChecked());
     ui->dependenciesDisableBtn->setChecked(s->get("ModDependenciesDisabled").toBool());
+    ui->preparePackUpdatesCheckBox->setChecked(s->get("PreparePackUpdates").toBool());
+    ui->prefetchNewInstancesCheckBox->setChecked(s->get("PrefetchNewInstances").toBool());
 }
 
 void LauncherPage::refreshFontPreview()
@@ -109,6 +109,8 @@ void MinecraftPage::applySettings()
     s->set("EnableFeralGamemode", ui->enableFeralGamemodeCheck->isChecked());
     s->set("EnableMangoHud", ui->enableMangoHud->isChecked());
     s->set("UseDiscreteGpu", ui->useDiscreteGpuCheck->isChecked());
+    s->set("UseClassDataSharing", ui->useClassDataSharingCheck->isChecked());
+    s->set("PrewarmLaunchFiles", ui->prewarmLaunchFilesCheck->isChecked());
 
     // Game time
     s->set("ShowGameTime", ui->showGameTime->isChecked());
@@ -151,6 +153,8 @@ void MinecraftPage::loadSettings()
     ui->enableFeralGamemodeCheck->setChecked(s->get("EnableFeralGamemode").toBool());
     ui->enableMangoHud->setChecked(s->get("EnableMangoHud").toBool());
     ui->useDiscreteGpuCheck->setChecked(s->get("UseDiscreteGpu").toBool());
+    ui->useClassDataSharingCheck->setChecked(s->get("UseClassDataSharing").toBool());
+    ui->prewarmLaunchFilesCheck->setChecked(s->get("PrewarmLaunchFiles").toBool());
 
 #if !defined(Q_OS_LINUX)
     ui->perfomanceGroupBox->setVisible(false);
@@ -45,6 +45,7 @@
 #include <QHeaderView>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QScrollBar>
 #include <algorithm>
 
 ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared_ptr<ResourceFolderModel> model, QWidget* parent)
@@ -88,6 +89,9 @@ ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared
     };
     connect(selection_model, &QItemSelectionModel::selectionChanged, this, updateExtra);
     connect(model.get(), &ResourceFolderModel::updateFinished, this, updateExtra);
+    // get what's on screen parsed first
+    connect(model.get(), &ResourceFolderModel::updateFinished, this, &ExternalResourcesPage::prioritizeVisibleItems);
+    connect(ui->treeView->verticalScrollBar(), &QScrollBar::valueChanged, this, &ExternalResourcesPage::prioritizeVisibleItems);
 
     connect(ui->filterEdit, &QLineEdit::textChanged, this, &ExternalResourcesPage::filterTextChanged);
 
@@ -119,6 +123,21 @@ void ExternalResourcesPage::ShowContextMenu(const QPoint& pos)
     delete menu;
 }
 
+void ExternalResourcesPage::prioritizeVisibleItems()
+{
+    auto viewport = ui->treeView->viewport()->rect();
+    auto top = ui->treeView->indexAt(viewport.topLeft());
+    if (!top.isValid())
+        return;
+    auto bottom = ui->treeView->indexAt(viewport.bottomLeft());
+    int last = bottom.isValid() ? bottom.row() : m_filterModel->rowCount() - 1;
+
+    QList<int> rows;
+    for (int row = top.row(); row <= last; row++)
+        rows.append(m_filterModel->mapToSource(m_filterModel->index(row, 0)).row());
+    m_model->prioritizeResolution(rows);
+}
+
 void ExternalResourcesPage::ShowHeaderContextMenu(const QPoint& pos)
 {
     auto menu = m_model->createHeaderContextMenu(ui->treeView);
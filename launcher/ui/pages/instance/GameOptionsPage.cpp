@@ -60,12 +60,13 @@ GameOptionsPage::~GameOptionsPage()
 
 void GameOptionsPage::openedImpl()
 {
-    // m_model->observe();
+    // only parsed again when the game wrote it since
+    m_model->reloadAsync();
 }
 
 void GameOptionsPage::closedImpl()
 {
-    // m_model->unobserve();
+    m_model->save();
 }
 
 void GameOptionsPage::retranslate()
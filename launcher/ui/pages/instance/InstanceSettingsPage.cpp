@@ -70,6 +70,8 @@ InstanceSettingsPage::InstanceSettingsPage(BaseInstance* inst, QWidget* parent)
 
     connect(ui->useNativeGLFWCheck, &QAbstractButton::toggled, this, &InstanceSettingsPage::onUseNativeGLFWChanged);
     connect(ui->useNativeOpenALCheck, &QAbstractButton::toggled, this, &InstanceSettingsPage::onUseNativeOpenALChanged);
+    connect(ui->autoTuneMemoryCheckBox, &QAbstractButton::toggled, ui->minMemSpinBox, &QWidget::setDisabled);
+    connect(ui->autoTuneMemoryCheckBox, &QAbstractButton::toggled, ui->maxMemSpinBox, &QWidget::setDisabled);
 
     loadSettings();
 
@@ -160,10 +162,12 @@ void InstanceSettingsPage::applySettings()
             m_settings->set("MaxMemAlloc", min);
         }
         m_settings->set("PermGen", ui->permGenSpinBox->value());
+        m_settings->set("AutoTuneMemory", ui->autoTuneMemoryCheckBox->isChecked());
     } else {
         m_settings->reset("MinMemAlloc");
         m_settings->reset("MaxMemAlloc");
         m_settings->reset("PermGen");
+        m_settings->reset("AutoTuneMemory");
     }
 
     // Java Install Settings
@@ -232,10 +236,14 @@ void InstanceSettingsPage::applySettings()
         m_settings->set("EnableFeralGamemode", ui->enableFeralGamemodeCheck->isChecked());
         m_settings->set("EnableMangoHud", ui->enableMangoHud->isChecked());
         m_settings->set("UseDiscreteGpu", ui->useDiscreteGpuCheck->isChecked());
+        m_settings->set("UseClassDataSharing", ui->useClassDataSharingCheck->isChecked());
+        m_settings->set("PrewarmLaunchFiles", ui->prewarmLaunchFilesCheck->isChecked());
     } else {
         m_settings->reset("EnableFeralGamemode");
         m_settings->reset("EnableMangoHud");
         m_settings->reset("UseDiscreteGpu");
+        m_settings->reset("UseClassDataSharing");
+        m_settings->reset("PrewarmLaunchFiles");
     }
 
     // Game time
@@ -308,6 +316,7 @@ void InstanceSettingsPage::loadSettings()
         ui->maxMemSpinBox->setValue(min);
     }
     ui->permGenSpinBox->setValue(m_settings->get("PermGen").toInt());
+    ui->autoTuneMemoryCheckBox->setChecked(m_settings->get("AutoTuneMemory").toBool());
     bool permGenVisible = m_settings->get("PermGenVisible").toBool();
     ui->permGenSpinBox->setVisible(permGenVisible);
     ui->labelPermGen->setVisible(permGenVisible);
@@ -354,6 +363,8 @@ void InstanceSettingsPage::loadSettings()
     ui->enableFeralGamemodeCheck->setChecked(m_settings->get("EnableFeralGamemode").toBool());
     ui->enableMangoHud->setChecked(m_settings->get("EnableMangoHud").toBool());
     ui->useDiscreteGpuCheck->setChecked(m_settings->get("UseDiscreteGpu").toBool());
+    ui->useClassDataSharingCheck->setChecked(m_settings->get("UseClassDataSharing").toBool());
+    ui->prewarmLaunchFilesCheck->setChecked(m_settings->get("PrewarmLaunchFiles").toBool());
 
 #if !defined(Q_OS_LINUX)
     ui->settingsTabs->setTabVisible(ui->settingsTabs->indexOf(ui->performancePage), false);
@@ -292,17 +292,31 @@ void LogPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    ui->text->findNext(ui->searchBar->text(), reverse);
+    findNext(reverse);
 }
 
 void LogPage::findNextActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), false);
+    findNext(false);
 }
 
 void LogPage::findPreviousActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), true);
+    findNext(true);
+}
+
+void LogPage::findNext(bool reverse)
+{
+    auto what = ui->searchBar->text();
+    if (!m_model) {
+        ui->text->findNext(what, reverse);
+        return;
+    }
+    // the model has an index, much faster than searching the document
+    auto row = m_model->find(what, ui->text->currentRow(), reverse);
+    if (row != -1) {
+        ui->text->selectMatch(row, what);
+    }
 }
 
 void LogPage::findActivated()
@@ -82,6 +82,7 @@ class LogPage : public QWidget, public BasePage {
     void modelStateToUI();
     void UIToModelState();
     void setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial);
+    void findNext(bool reverse);
 
    private:
     Ui::LogPage* ui;
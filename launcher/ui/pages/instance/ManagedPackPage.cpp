@@ -19,7 +19,8 @@
 #include "InstanceList.h"
 #include "InstanceTask.h"
 #include "Json.h"
-#include "Markdown.h"
+#include "MarkdownRenderer.h"
+#include "modplatform/PackUpdatePreparer.h"
 
 #include "modplatform/modrinth/ModrinthPackManifest.h"
 
@@ -241,6 +242,7 @@ void ModrinthManagedPackPage::parseManagedPack()
         m_fetch_job->abort();
 
     m_fetch_job.reset(new NetJob(QString("Modrinth::PackVersions(%1)").arg(m_inst->getManagedPackName()), APPLICATION->network()));
+    m_fetch_job->setPriority(Net::Priority::Interactive);
     auto response = std::make_shared<QByteArray>();
 
     QString id = m_inst->getManagedPackID();
@@ -276,6 +278,7 @@ void ModrinthManagedPackPage::parseManagedPack()
         ui->versionsComboBox->clear();
         ui->versionsComboBox->blockSignals(false);
 
+        auto prepared = APPLICATION->packUpdatePreparer()->preparedFor(m_inst);
         for (auto version : m_pack.versions) {
             QString name = version.version;
 
@@ -286,6 +289,8 @@ void ModrinthManagedPackPage::parseManagedPack()
             // e.g. HexMC's 4.4.0 has versionId 4.0.0 in the modpack index..............
             if (version.version == m_inst->getManagedPackVersionName())
                 name = tr("%1 (Current)").arg(name);
+            else if (prepared && prepared->versionId == version.id)
+                name = tr("%1 (Prepared)").arg(name);
 
             ui->versionsComboBox->addItem(name, QVariant(version.id));
         }
@@ -316,7 +321,12 @@ void ModrinthManagedPackPage::suggestVersion()
     }
     auto version = m_pack.versions.at(index);
 
-    ui->changelogTextBrowser->setHtml(markdownToHTML(version.changelog.toUtf8()));
+    // a long changelog is rendered off the GUI thread
+    renderMarkdown(this, version.changelog, [this, id = version.id](const QString& html) {
+        auto current = ui->versionsComboBox->currentIndex();
+        if (current >= 0 && current < m_pack.versions.length() && m_pack.versions.at(current).id == id)
+            ui->changelogTextBrowser->setHtml(html);
+    });
 
     ManagedPackPage::suggestVersion();
 }
@@ -414,6 +424,7 @@ void FlameManagedPackPage::parseManagedPack()
         m_fetch_job->abort();
 
     m_fetch_job.reset(new NetJob(QString("Flame::PackVersions(%1)").arg(m_inst->getManagedPackName()), APPLICATION->network()));
+    m_fetch_job->setPriority(Net::Priority::Interactive);
     auto response = std::make_shared<QByteArray>();
 
     QString id = m_inst->getManagedPackID();
@@ -450,11 +461,14 @@ void FlameManagedPackPage::parseManagedPack()
         ui->versionsComboBox->clear();
         ui->versionsComboBox->blockSignals(false);
 
+        auto prepared = APPLICATION->packUpdatePreparer()->preparedFor(m_inst);
         for (auto version : m_pack.versions) {
             QString name = version.version;
 
             if (version.fileId == m_inst->getManagedPackVersionID().toInt())
                 name = tr("%1 (Current)").arg(name);
+            else if (prepared && prepared->versionId == QString::number(version.fileId))
+                name = tr("%1 (Prepared)").arg(name);
 
             ui->versionsComboBox->addItem(name, QVariant(version.fileId));
         }
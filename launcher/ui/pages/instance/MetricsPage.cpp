@@ -0,0 +1,99 @@
+#include "MetricsPage.h"
+
+#include <QLabel>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "ui/widgets/MetricsGraph.h"
+
+namespace {
+const double mebibyte = 1024.0 * 1024.0;
+}  // namespace
+
+MetricsPage::MetricsPage(InstancePtr instance, QWidget* parent) : QWidget(parent), m_instance(std::move(instance))
+{
+    auto layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    m_status = new QLabel(this);
+    m_status->setWordWrap(true);
+    layout->addWidget(m_status);
+
+    m_heap = new MetricsGraph(tr("Heap"), this);
+    m_heap->setFormatter([](double value) { return tr("%1 MiB").arg(value, 0, 'f', 0); });
+    m_gc = new MetricsGraph(tr("Garbage collection"), this);
+    m_gc->setFormatter([](double value) { return tr("%1%").arg(value, 0, 'f', 1); });
+    m_cpu = new MetricsGraph(tr("CPU"), this);
+    m_cpu->setFormatter([](double value) { return tr("%1%").arg(value, 0, 'f', 0); });
+    m_threads = new MetricsGraph(tr("Threads"), this);
+    for (auto graph : { m_heap, m_gc, m_cpu, m_threads })
+        layout->addWidget(graph);
+
+    connect(m_instance.get(), &BaseInstance::launchTaskChanged, this, [this](shared_qobject_ptr<LaunchTask> task) {
+        // what the last launch reported stays until the next one
+        if (task && task->metrics())
+            setLaunchTask(task);
+    });
+    setLaunchTask(m_instance->getLaunchTask());
+}
+
+bool MetricsPage::shouldDisplay() const
+{
+    return m_instance->settings()->get("CollectJvmMetrics").toBool() || (m_task && !m_task->metrics()->samples().isEmpty());
+}
+
+void MetricsPage::setLaunchTask(shared_qobject_ptr<LaunchTask> task)
+{
+    if (m_task)
+        disconnect(m_task->metrics(), nullptr, this, nullptr);
+    m_task = task && task->metrics() ? task : nullptr;
+    if (m_task)
+        connect(m_task->metrics(), &JvmMetrics::samplesAdded, this, &MetricsPage::updateGraphs);
+    updateGraphs();
+}
+
+void MetricsPage::updateGraphs()
+{
+    const QVector<JvmMetrics::Sample> none;
+    auto& samples = m_task ? m_task->metrics()->samples() : none;
+    if (samples.isEmpty()) {
+        if (!m_instance->settings()->get("CollectJvmMetrics").toBool())
+            m_status->setText(tr("Collecting the metrics of the game is turned off in the console settings of the launcher."));
+        else if (m_task)
+            m_status->setText(tr("Waiting for the game to report its metrics..."));
+        else
+            m_status->setText(tr("The metrics of the game show up here once it runs."));
+    } else {
+        auto& last = samples.last();
+        m_status->setText(tr("%1 garbage collections, pausing the game %2 s in total, in %3 s of play.")
+                              .arg(last.gcCount)
+                              .arg(last.gcTimeMs / 1000.0, 0, 'f', 1)
+                              .arg(last.uptimeMs / 1000));
+    }
+
+    MetricsGraph::Series used{ tr("Used"), QColor(0x3d, 0x8e, 0xd8), {} };
+    MetricsGraph::Series committed{ tr("Reserved"), QColor(0x8a, 0x8a, 0x8a), {} };
+    MetricsGraph::Series gc{ tr("Time spent"), QColor(0xd8, 0x6b, 0x3d), {} };
+    MetricsGraph::Series cpu{ tr("Game"), QColor(0x4c, 0xb0, 0x50), {} };
+    MetricsGraph::Series threads{ tr("Threads"), QColor(0x9c, 0x5c, 0xc8), {} };
+    bool knowsCpu = false;
+    for (int i = 0; i < samples.size(); i++) {
+        auto& sample = samples[i];
+        used.values.append(sample.heapUsed / mebibyte);
+        committed.values.append(sample.heapCommitted / mebibyte);
+        // the share of the time since the sample before that went into collecting
+        double share = 0;
+        if (i > 0 && sample.uptimeMs > samples[i - 1].uptimeMs)
+            share = 100.0 * (sample.gcTimeMs - samples[i - 1].gcTimeMs) / (sample.uptimeMs - samples[i - 1].uptimeMs);
+        gc.values.append(share);
+        knowsCpu = knowsCpu || sample.cpuLoad >= 0;
+        cpu.values.append(std::max(sample.cpuLoad, 0.0) * 100);
+        threads.values.append(sample.threads);
+    }
+
+    auto heapMax = samples.isEmpty() ? -1 : samples.last().heapMax;
+    m_heap->setSeries({ used, committed }, heapMax > 0 ? heapMax / mebibyte : 0);
+    m_gc->setSeries({ gc });
+    m_cpu->setSeries(knowsCpu ? QVector<MetricsGraph::Series>{ cpu } : QVector<MetricsGraph::Series>{}, 100);
+    m_threads->setSeries({ threads });
+}
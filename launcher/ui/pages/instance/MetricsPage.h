@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QWidget>
+
+#include "Application.h"
+#include "BaseInstance.h"
+#include "launch/LaunchTask.h"
+#include "ui/pages/BasePage.h"
+
+class QLabel;
+class MetricsGraph;
+
+/**
+ * Plots what the running game reports of its JVM, to size its memory and spot leaks without any other tool.
+ */
+class MetricsPage : public QWidget, public BasePage {
+    Q_OBJECT
+   public:
+    explicit MetricsPage(InstancePtr instance, QWidget* parent = nullptr);
+
+    QString displayName() const override { return tr("Metrics"); }
+    QIcon icon() const override { return APPLICATION->getThemedIcon("java"); }
+    QString id() const override { return "metrics"; }
+    bool shouldDisplay() const override;
+
+   private:
+    void setLaunchTask(shared_qobject_ptr<LaunchTask> task);
+    void updateGraphs();
+
+   private:
+    InstancePtr m_instance;
+    shared_qobject_ptr<LaunchTask> m_task;
+    QLabel* m_status;
+    MetricsGraph* m_heap;
+    MetricsGraph* m_gc;
+    MetricsGraph* m_cpu;
+    MetricsGraph* m_threads;
+};
@@ -45,6 +45,7 @@
 #include <GZip.h>
 #include <QShortcut>
 #include "RecursiveFileSystemWatcher.h"
+#include "launch/SessionLog.h"
 
 OtherLogsPage::OtherLogsPage(QString path, IPathMatcher::Ptr fileFilter, QWidget* parent)
     : QWidget(parent), ui(new Ui::OtherLogsPage), m_path(path), m_fileFilter(fileFilter), m_watcher(new RecursiveFileSystemWatcher(this))
@@ -154,6 +155,15 @@ void OtherLogsPage::on_btnReload_clicked()
                             "for large files.")
                              .arg(file.fileName()));
         };
+        // session logs are read through their index, and only their end is shown when they're too big
+        if (SessionLogReader sessionLog(file.fileName()); sessionLog.isValid()) {
+            qint64 firstLine = 0;
+            auto lines = sessionLog.tail(50000000ll, &firstLine);
+            if (firstLine > 0)
+                lines.prepend(tr("(The first %1 lines of this log are left out, it's too big to show whole.)").arg(firstLine));
+            setPlainText(lines.join('\n'));
+            return;
+        }
         if (file.size() > (1024ll * 1024ll * 12ll)) {
             showTooBig();
             return;
@@ -161,7 +171,7 @@ void OtherLogsPage::on_btnReload_clicked()
         QString content;
         if (file.fileName().endsWith(".gz")) {
             QByteArray temp;
-            if (!GZip::unzip(file.readAll(), temp)) {
+            if (!GZip::unzip(file, temp)) {
                 setPlainText(tr("The file (%1) is not readable.").arg(file.fileName()));
                 return;
             }
@@ -40,9 +40,9 @@
 #include "ui_ScreenshotsPage.h"
 
 #include <QClipboard>
+#include <QCryptographicHash>
 #include <QEvent>
-#include <QFileIconProvider>
-#include <QFileSystemModel>
+#include <QIdentityProxyModel>
 #include <QKeyEvent>
 #include <QLineEdit>
 #include <QMap>
@@ -50,9 +50,12 @@
 #include <QModelIndex>
 #include <QMutableListIterator>
 #include <QPainter>
-#include <QRegularExpression>
 #include <QSet>
+#include <QScrollBar>
 #include <QStyledItemDelegate>
+#include <QTimer>
+
+#include <algorithm>
 
 #include <Application.h>
 
@@ -62,158 +65,82 @@
 #include "net/NetJob.h"
 #include "screenshots/ImgurAlbumCreation.h"
 #include "screenshots/ImgurUpload.h"
+#include "screenshots/ScreenshotList.h"
+#include "screenshots/ThumbnailLoader.h"
 #include "tasks/SequentialTask.h"
 
 #include <DesktopServices.h>
 #include <FileSystem.h>
-#include "RWStorage.h"
-
-using SharedIconCache = RWStorage<QString, QIcon>;
-using SharedIconCachePtr = std::shared_ptr<SharedIconCache>;
-
-class ThumbnailingResult : public QObject {
-    Q_OBJECT
-   public slots:
-    inline void emitResultsReady(const QString& path) { emit resultsReady(path); }
-    inline void emitResultsFailed(const QString& path) { emit resultsFailed(path); }
-   signals:
-    void resultsReady(const QString& path);
-    void resultsFailed(const QString& path);
-};
-
-class ThumbnailRunnable : public QRunnable {
-   public:
-    ThumbnailRunnable(QString path, SharedIconCachePtr cache)
-    {
-        m_path = path;
-        m_cache = cache;
-    }
-    void run()
-    {
-        QFileInfo info(m_path);
-        if (info.isDir())
-            return;
-        if ((info.suffix().compare("png", Qt::CaseInsensitive) != 0))
-            return;
-        if (!m_cache->stale(m_path))
-            return;
-        QImage image(m_path);
-        if (image.isNull()) {
-            m_resultEmitter.emitResultsFailed(m_path);
-            qDebug() << "Error loading screenshot: " + m_path + ". Perhaps too large?";
-            return;
-        }
-        QImage small;
-        if (image.width() > image.height())
-            small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
-        else
-            small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-        QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-        QImage square(QSize(256, 256), QImage::Format_ARGB32);
-        square.fill(Qt::transparent);
-
-        QPainter painter(&square);
-        painter.drawImage(offset, small);
-        painter.end();
-
-        QIcon icon(QPixmap::fromImage(square));
-        m_cache->add(m_path, icon);
-        m_resultEmitter.emitResultsReady(m_path);
-    }
-    QString m_path;
-    SharedIconCachePtr m_cache;
-    ThumbnailingResult m_resultEmitter;
-};
+#include "MTPixmapCache.h"
 
 // this is about as elegant and well written as a bag of bricks with scribbles done by insane
 // asylum patients.
 class FilterModel : public QIdentityProxyModel {
     Q_OBJECT
    public:
-    explicit FilterModel(QObject* parent = 0) : QIdentityProxyModel(parent)
+    explicit FilterModel(QObject* parent = 0)
+        : QIdentityProxyModel(parent), m_thumbnails(QDir("cache/thumbnails").absolutePath(), 256)
     {
-        m_thumbnailingPool.setMaxThreadCount(4);
-        m_thumbnailCache = std::make_shared<SharedIconCache>();
-        m_thumbnailCache->add("placeholder", APPLICATION->getThemedIcon("screenshot-placeholder"));
-        connect(&watcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
-    }
-    virtual ~FilterModel()
-    {
-        m_thumbnailingPool.clear();
-        if (!m_thumbnailingPool.waitForDone(500))
-            qDebug() << "Thumbnail pool took longer than 500ms to finish";
+        m_placeholder = APPLICATION->getThemedIcon("screenshot-placeholder");
+        connect(&m_thumbnails, &ThumbnailLoader::ready, this, &FilterModel::thumbnailReady);
+        connect(&m_thumbnails, &ThumbnailLoader::failed, this, &FilterModel::thumbnailFailed);
     }
+    virtual ~FilterModel() = default;
     virtual QVariant data(const QModelIndex& proxyIndex, int role = Qt::DisplayRole) const
     {
         auto model = sourceModel();
         if (!model)
             return QVariant();
-        if (role == Qt::DisplayRole || role == Qt::EditRole) {
-            QVariant result = sourceModel()->data(mapToSource(proxyIndex), role);
-            return result.toString().remove(QRegularExpression("\\.png$"));
-        }
         if (role == Qt::DecorationRole) {
-            QVariant result = sourceModel()->data(mapToSource(proxyIndex), QFileSystemModel::FilePathRole);
-            QString filePath = result.toString();
-            QIcon temp;
-            if (!watched.contains(filePath)) {
-                ((QFileSystemWatcher&)watcher).addPath(filePath);
-                ((QSet<QString>&)watched).insert(filePath);
-            }
-            if (m_thumbnailCache->get(filePath, temp)) {
-                return temp;
-            }
-            if (!m_failed.contains(filePath)) {
-                ((FilterModel*)this)->thumbnailImage(filePath);
+            // thumbnails are only made for what's on screen, see setVisible
+            QVariant result = sourceModel()->data(mapToSource(proxyIndex), ScreenshotList::FilePathRole);
+            QPixmap thumbnail;
+            if (PixmapCache::find(result.toString(), &thumbnail)) {
+                return QIcon(thumbnail);
             }
-            return (m_thumbnailCache->get("placeholder"));
+            return m_placeholder;
         }
         return sourceModel()->data(mapToSource(proxyIndex), role);
     }
-    virtual bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole)
+    /// the screenshots on screen, nearest first, the ones without a thumbnail get one
+    void setVisible(const QStringList& paths)
     {
-        auto model = sourceModel();
-        if (!model)
-            return false;
-        if (role != Qt::EditRole)
-            return false;
-        // FIXME: this is a workaround for a bug in QFileSystemModel, where it doesn't
-        // sort after renames
-        {
-            ((QFileSystemModel*)model)->setNameFilterDisables(true);
-            ((QFileSystemModel*)model)->setNameFilterDisables(false);
+        m_visible = paths;
+        QStringList missing;
+        for (auto& path : paths) {
+            if (!m_failed.contains(path) && !PixmapCache::find(path, nullptr))
+                missing.append(path);
         }
-        return model->setData(mapToSource(index), value.toString() + ".png", role);
+        m_thumbnails.request(missing);
     }
-
-   private:
-    void thumbnailImage(QString path)
+    /// the screenshot changed or went away, its thumbnail gets made again if it's still on screen
+    void fileChanged(const QString& filepath)
     {
-        auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
-        connect(&(runnable->m_resultEmitter), SIGNAL(resultsReady(QString)), SLOT(thumbnailReady(QString)));
-        connect(&(runnable->m_resultEmitter), SIGNAL(resultsFailed(QString)), SLOT(thumbnailFailed(QString)));
-        ((QThreadPool&)m_thumbnailingPool).start(runnable);
+        PixmapCache::remove(filepath);
+        m_failed.remove(filepath);
+        m_thumbnails.invalidate(filepath);
+        if (QFile::exists(filepath) && m_visible.contains(filepath))
+            setVisible(m_visible);
     }
-   private slots:
-    void thumbnailReady(QString path) { emit layoutChanged(); }
-    void thumbnailFailed(QString path) { m_failed.insert(path); }
-    void fileChanged(QString filepath)
+
+   private:
+    void thumbnailReady(const QString& path, const QImage& thumbnail)
     {
-        m_thumbnailCache->setStale(filepath);
-        // reinsert the path...
-        watcher.removePath(filepath);
-        if (QFile::exists(filepath)) {
-            watcher.addPath(filepath);
-            thumbnailImage(filepath);
+        if (!PixmapCache::insert(PixmapCache::Category::Screenshots, path, QPixmap::fromImage(thumbnail))) {
+            m_failed.insert(path);
+            return;
         }
+        auto index = mapFromSource(static_cast<ScreenshotList*>(sourceModel())->indexOf(path));
+        if (index.isValid())
+            emit dataChanged(index, index, { Qt::DecorationRole });
     }
+    void thumbnailFailed(const QString& path) { m_failed.insert(path); }
 
    private:
-    SharedIconCachePtr m_thumbnailCache;
-    QThreadPool m_thumbnailingPool;
+    QIcon m_placeholder;
+    ThumbnailLoader m_thumbnails;
+    QStringList m_visible;
     QSet<QString> m_failed;
-    QSet<QString> watched;
-    QFileSystemWatcher watcher;
 };
 
 class CenteredEditingDelegate : public QStyledItemDelegate {
@@ -235,13 +162,12 @@ class CenteredEditingDelegate : public QStyledItemDelegate {
 
 ScreenshotsPage::ScreenshotsPage(QString path, QWidget* parent) : QMainWindow(parent), ui(new Ui::ScreenshotsPage)
 {
-    m_model.reset(new QFileSystemModel());
+    // kept with the thumbnails, one for every screenshot folder
+    auto folderHash = QCryptographicHash::hash(QDir(path).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    m_model.reset(new ScreenshotList(path, QDir("cache/screenshots").absoluteFilePath(folderHash + ".json")));
     m_filterModel.reset(new FilterModel());
     m_filterModel->setSourceModel(m_model.get());
-    m_model->setFilter(QDir::Files);
-    m_model->setReadOnly(false);
-    m_model->setNameFilters({ "*.png" });
-    m_model->setNameFilterDisables(false);
+    connect(m_model.get(), &ScreenshotList::fileChanged, m_filterModel.get(), &FilterModel::fileChanged);
     m_folder = path;
     m_valid = FS::ensureFolderPathExists(m_folder);
 
@@ -251,7 +177,8 @@ ScreenshotsPage::ScreenshotsPage(QString path, QWidget* parent) : QMainWindow(pa
     ui->listView->setIconSize(QSize(128, 128));
     ui->listView->setGridSize(QSize(192, 160));
     ui->listView->setSpacing(9);
-    // ui->listView->setUniformItemSizes(true);
+    // every item is the size of the grid, the view doesn't need to ask each of them
+    ui->listView->setUniformItemSizes(true);
     ui->listView->setLayoutMode(QListView::Batched);
     ui->listView->setViewMode(QListView::IconMode);
     ui->listView->setResizeMode(QListView::Adjust);
@@ -261,12 +188,25 @@ ScreenshotsPage::ScreenshotsPage(QString path, QWidget* parent) : QMainWindow(pa
     ui->listView->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(ui->listView, &QListView::customContextMenuRequested, this, &ScreenshotsPage::ShowContextMenu);
     connect(ui->listView, SIGNAL(activated(QModelIndex)), SLOT(onItemActivated(QModelIndex)));
+
+    m_visibleTimer = new QTimer(this);
+    m_visibleTimer->setSingleShot(true);
+    m_visibleTimer->setInterval(50);
+    connect(m_visibleTimer, &QTimer::timeout, this, &ScreenshotsPage::updateVisibleThumbnails);
+    auto schedule = [this] { m_visibleTimer->start(); };
+    connect(ui->listView->verticalScrollBar(), &QScrollBar::valueChanged, this, schedule);
+    connect(m_filterModel.get(), &QAbstractItemModel::modelReset, this, schedule);
+    connect(m_filterModel.get(), &QAbstractItemModel::rowsInserted, this, schedule);
+    connect(m_filterModel.get(), &QAbstractItemModel::rowsRemoved, this, schedule);
+    connect(m_filterModel.get(), &QAbstractItemModel::layoutChanged, this, schedule);
 }
 
 bool ScreenshotsPage::eventFilter(QObject* obj, QEvent* evt)
 {
     if (obj != ui->listView)
         return QWidget::eventFilter(obj, evt);
+    if (evt->type() == QEvent::Resize)
+        m_visibleTimer->start();
     if (evt->type() != QEvent::KeyPress) {
         return QWidget::eventFilter(obj, evt);
     }
@@ -290,6 +230,34 @@ bool ScreenshotsPage::eventFilter(QObject* obj, QEvent* evt)
     return QWidget::eventFilter(obj, evt);
 }
 
+void ScreenshotsPage::updateVisibleThumbnails()
+{
+    auto model = ui->listView->model();
+    if (!model || !isVisible())
+        return;
+    auto root = ui->listView->rootIndex();
+    auto viewport = ui->listView->viewport()->rect();
+    // a screen above and below gets ready too, so scrolling a bit doesn't show placeholders
+    auto margin = viewport.height();
+    QList<QPair<int, QString>> near;
+    for (int row = 0; row < model->rowCount(root); row++) {
+        auto index = model->index(row, 0, root);
+        auto rect = ui->listView->visualRect(index);
+        int distance = 0;
+        if (rect.bottom() < viewport.top())
+            distance = viewport.top() - rect.bottom();
+        else if (rect.top() > viewport.bottom())
+            distance = rect.top() - viewport.bottom();
+        if (distance <= margin)
+            near.append({ distance, index.data(ScreenshotList::FilePathRole).toString() });
+    }
+    std::stable_sort(near.begin(), near.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    QStringList paths;
+    for (auto& item : near)
+        paths.append(item.second);
+    m_filterModel->setVisible(paths);
+}
+
 void ScreenshotsPage::retranslate()
 {
     ui->retranslateUi(this);
@@ -381,8 +349,11 @@ void ScreenshotsPage::on_actionUpload_triggered()
     if (response != QMessageBox::Yes)
         return;
 
-    QList<ScreenShot::Ptr> uploaded;
     auto job = NetJob::Ptr(new NetJob("Screenshot Upload", APPLICATION->network()));
+    job->setPriority(Net::Priority::Interactive);
+    job->setPerHostLimit(APPLICATION->settings()->get("NumberOfConcurrentUploads").toInt());
+    ImgurUpload::Preparation preparation{ APPLICATION->settings()->get("ScreenshotUploadMaxSize").toInt(),
+                                          APPLICATION->settings()->get("ScreenshotUploadRecompress").toBool() };
 
     ProgressDialog dialog(this);
     dialog.setSkipButton(true, tr("Abort"));
@@ -391,7 +362,7 @@ void ScreenshotsPage::on_actionUpload_triggered()
         auto item = selection.at(0);
         auto info = m_model->fileInfo(item);
         auto screenshot = std::make_shared<ScreenShot>(info);
-        job->addNetAction(ImgurUpload::make(screenshot));
+        job->addNetAction(ImgurUpload::make(screenshot, {}, preparation));
 
         connect(job.get(), &Task::failed, [this](QString reason) {
             CustomMessageBox::selectable(this, tr("Failed to upload screenshots!"), reason, QMessageBox::Critical)->show();
@@ -420,19 +391,19 @@ void ScreenshotsPage::on_actionUpload_triggered()
         return;
     }
 
+    // the album comes first, so the screenshots go into it as each of them is done
+    SequentialTask task;
+    auto albumTask = NetJob::Ptr(new NetJob("Imgur Album Creation", APPLICATION->network()));
+    albumTask->setPriority(Net::Priority::Interactive);
+    auto imgurResult = std::make_shared<ImgurAlbumCreation::Result>();
+    albumTask->addNetAction(ImgurAlbumCreation::make(imgurResult));
     for (auto item : selection) {
         auto info = m_model->fileInfo(item);
         auto screenshot = std::make_shared<ScreenShot>(info);
-        uploaded.push_back(screenshot);
-        job->addNetAction(ImgurUpload::make(screenshot));
+        job->addNetAction(ImgurUpload::make(screenshot, imgurResult, preparation));
     }
-    SequentialTask task;
-    auto albumTask = NetJob::Ptr(new NetJob("Imgur Album Creation", APPLICATION->network()));
-    auto imgurResult = std::make_shared<ImgurAlbumCreation::Result>();
-    auto imgurAlbum = ImgurAlbumCreation::make(imgurResult, uploaded);
-    albumTask->addNetAction(imgurAlbum);
-    task.addTask(job);
     task.addTask(albumTask);
+    task.addTask(job);
 
     connect(&task, &Task::failed, [this](QString reason) {
         CustomMessageBox::selectable(this, tr("Failed to upload screenshots!"), reason, QMessageBox::Critical)->show();
@@ -522,8 +493,9 @@ void ScreenshotsPage::on_actionDelete_triggered()
         if (FS::trash(m_model->filePath(item)))
             continue;
 
-        m_model->remove(item);
+        QFile::remove(m_model->filePath(item));
     }
+    m_model->update();
 }
 
 void ScreenshotsPage::on_actionRename_triggered()
@@ -541,17 +513,15 @@ void ScreenshotsPage::openedImpl()
         m_valid = FS::ensureFolderPathExists(m_folder);
     }
     if (m_valid) {
-        QString path = QDir(m_folder).absolutePath();
-        auto idx = m_model->setRootPath(path);
-        if (idx.isValid()) {
+        // the index is shown right away, what changed in the folder since comes in after
+        m_model->load();
+        if (ui->listView->model() != m_filterModel.get()) {
             ui->listView->setModel(m_filterModel.get());
             connect(ui->listView->selectionModel(), &QItemSelectionModel::selectionChanged, this,
                     &ScreenshotsPage::onCurrentSelectionChanged);
-            onCurrentSelectionChanged(ui->listView->selectionModel()->selection());  // set initial button enable states
-            ui->listView->setRootIndex(m_filterModel->mapFromSource(idx));
-        } else {
-            ui->listView->setModel(nullptr);
         }
+        onCurrentSelectionChanged(ui->listView->selectionModel()->selection());  // set initial button enable states
+        m_visibleTimer->start();
     }
 
     auto const setting_name = QString("WideBarVisibility_%1").arg(id());
@@ -565,6 +535,9 @@ void ScreenshotsPage::openedImpl()
 
 void ScreenshotsPage::closedImpl()
 {
+    // nothing's on screen anymore
+    m_visibleTimer->stop();
+    m_filterModel->setVisible({});
     m_wide_bar_setting->set(ui->toolBar->getVisibilityState());
 }
 
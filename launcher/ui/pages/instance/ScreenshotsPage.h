@@ -42,9 +42,9 @@
 
 #include "settings/Setting.h"
 
-class QFileSystemModel;
-class QIdentityProxyModel;
 class QItemSelection;
+class QTimer;
+class FilterModel;
 namespace Ui {
 class ScreenshotsPage;
 }
@@ -86,11 +86,14 @@ class ScreenshotsPage : public QMainWindow, public BasePage {
     void onItemActivated(QModelIndex);
     void onCurrentSelectionChanged(const QItemSelection& selected);
     void ShowContextMenu(const QPoint& pos);
+    /// tell the model what's on screen, after the view stopped moving for a moment
+    void updateVisibleThumbnails();
 
    private:
     Ui::ScreenshotsPage* ui;
-    std::shared_ptr<QFileSystemModel> m_model;
-    std::shared_ptr<QIdentityProxyModel> m_filterModel;
+    std::shared_ptr<ScreenshotList> m_model;
+    std::shared_ptr<FilterModel> m_filterModel;
+    QTimer* m_visibleTimer;
     QString m_folder;
     bool m_valid = false;
     bool m_uploadActive = false;
@@ -42,6 +42,7 @@
 #include <FileSystem.h>
 #include <io/stream_reader.h>
 #include <minecraft/MinecraftInstance.h>
+#include <minecraft/ServerPinger.h>
 #include <tag_compound.h>
 #include <tag_list.h>
 #include <tag_primitive.h>
@@ -52,7 +53,7 @@
 #include <QMenu>
 #include <QTimer>
 
-static const int COLUMN_COUNT = 2;  // 3 , TBD: latency and other nice things.
+static const int COLUMN_COUNT = 3;
 
 struct Server {
     // Types
@@ -115,6 +116,30 @@ struct Server {
     int m_ping = 0;
     int m_currentPlayers = 0;
     int m_maxPlayers = 0;
+    QString m_version;
+    // decoded once it's pinged, instead of on every paint
+    QIcon m_favicon;
+
+    void setStatus(const ServerStatus& status)
+    {
+        m_checked = true;
+        m_up = status.online;
+        m_motd = status.motd;
+        m_ping = status.ping;
+        m_currentPlayers = status.players;
+        m_maxPlayers = status.maxPlayers;
+        m_version = status.version;
+        QPixmap px;
+        if (status.favicon.size() && px.loadFromData(status.favicon, "PNG"))
+            m_favicon = QIcon(px);
+    }
+
+    void clearStatus()
+    {
+        auto icon = m_icon;
+        *this = Server(m_name, m_address);
+        m_icon = icon;
+    }
 };
 
 static std::unique_ptr<nbt::tag_compound> parseServersDat(const QString& filename)
@@ -167,6 +192,11 @@ class ServersModel : public QAbstractListModel {
         m_saveTimer.setSingleShot(true);
         m_saveTimer.setInterval(5000);
         connect(&m_saveTimer, &QTimer::timeout, this, &ServersModel::save_internal);
+        // not on every key typed into the address
+        m_pingTimer.setSingleShot(true);
+        m_pingTimer.setInterval(1000);
+        connect(&m_pingTimer, &QTimer::timeout, this, &ServersModel::pingAll);
+        connect(APPLICATION->serverPinger(), &ServerPinger::finished, this, &ServersModel::pinged);
     }
     virtual ~ServersModel(){};
 
@@ -320,6 +350,8 @@ class ServersModel : public QAbstractListModel {
             case 0:
                 switch (role) {
                     case Qt::DecorationRole: {
+                        if (!m_servers[row].m_favicon.isNull())
+                            return m_servers[row].m_favicon;
                         auto& bytes = m_servers[row].m_icon;
                         if (bytes.size()) {
                             QPixmap px;
@@ -332,6 +364,8 @@ class ServersModel : public QAbstractListModel {
                         return m_servers[row].m_name;
                     case ServerPtrRole:
                         return QVariant::fromValue<void*>((void*)&m_servers[row]);
+                    case Qt::ToolTipRole:
+                        return statusTooltip(m_servers[row]);
                     default:
                         return QVariant();
                 }
@@ -344,8 +378,16 @@ class ServersModel : public QAbstractListModel {
                 }
             case 2:
                 switch (role) {
-                    case Qt::DisplayRole:
-                        return m_servers[row].m_ping;
+                    case Qt::DisplayRole: {
+                        auto& server = m_servers[row];
+                        if (!server.m_checked)
+                            return QVariant();
+                        if (!server.m_up)
+                            return tr("Offline");
+                        return tr("%1 ms").arg(server.m_ping);
+                    }
+                    case Qt::ToolTipRole:
+                        return statusTooltip(m_servers[row]);
                     default:
                         return QVariant();
                 }
@@ -389,8 +431,10 @@ class ServersModel : public QAbstractListModel {
             return;
         }
         server->m_address = address;
+        server->clearStatus();
         emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
         scheduleSave();
+        m_pingTimer.start();
     }
 
     void setAcceptsTextures(int row, Server::AcceptsTextures textures)
@@ -424,6 +468,7 @@ class ServersModel : public QAbstractListModel {
         m_servers.swap(servers);
         m_loaded = true;
         endResetModel();
+        pingAll();
     }
 
     void saveNow()
@@ -441,6 +486,31 @@ class ServersModel : public QAbstractListModel {
     }
     void fileChanged(const QString& path) { qDebug() << "Changed:" << path; }
 
+    void pingAll()
+    {
+        auto pinger = APPLICATION->serverPinger();
+        for (int row = 0; row < m_servers.size(); row++) {
+            auto& server = m_servers[row];
+            if (auto status = pinger->cached(server.m_address)) {
+                server.setStatus(*status);
+                emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+            } else {
+                pinger->ping(server.m_address);
+            }
+        }
+    }
+
+    void pinged(const QString& address, const ServerStatus& status)
+    {
+        for (int row = 0; row < m_servers.size(); row++) {
+            auto& server = m_servers[row];
+            if (server.m_address.trimmed() != address)
+                continue;
+            server.setStatus(status);
+            emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+        }
+    }
+
    private slots:
     void save_internal()
     {
@@ -505,6 +575,21 @@ class ServersModel : public QAbstractListModel {
         }
     }
 
+    static QVariant statusTooltip(const Server& server)
+    {
+        if (!server.m_checked)
+            return QVariant();
+        if (!server.m_up)
+            return tr("The server didn't answer.");
+        QStringList lines;
+        if (!server.m_motd.isEmpty())
+            lines << server.m_motd;
+        lines << tr("%1/%2 players").arg(server.m_currentPlayers).arg(server.m_maxPlayers);
+        if (!server.m_version.isEmpty())
+            lines << server.m_version;
+        return lines.join('\n');
+    }
+
     QString serversPath()
     {
         QFileInfo foo(FS::PathCombine(m_path, "servers.dat"));
@@ -520,6 +605,7 @@ class ServersModel : public QAbstractListModel {
     QList<Server> m_servers;
     QFileSystemWatcher* m_watcher = nullptr;
     QTimer m_saveTimer;
+    QTimer m_pingTimer;
 };
 
 ServersPage::ServersPage(InstancePtr inst, QWidget* parent) : QMainWindow(parent), ui(new Ui::ServersPage)
@@ -37,11 +37,14 @@
 
 #include "WorldListPage.h"
 #include "minecraft/WorldList.h"
+#include "tasks/SequentialTask.h"
 #include "ui/dialogs/CustomMessageBox.h"
+#include "ui/dialogs/ProgressDialog.h"
 #include "ui_WorldListPage.h"
 
 #include <QClipboard>
 #include <QEvent>
+#include <QFileDialog>
 #include <QInputDialog>
 #include <QKeyEvent>
 #include <QMenu>
@@ -335,6 +338,7 @@ void WorldListPage::worldChanged([[maybe_unused]] const QModelIndex& current, [[
     ui->actionMCEdit->setEnabled(enable);
     ui->actionRemove->setEnabled(enable);
     ui->actionCopy->setEnabled(enable);
+    ui->actionExport->setEnabled(enable);
     ui->actionRename->setEnabled(enable);
     ui->actionDatapacks->setEnabled(enable);
     bool hasIcon = !index.data(WorldList::IconFileRole).isNull();
@@ -345,13 +349,18 @@ void WorldListPage::on_actionAdd_triggered()
 {
     auto list = GuiUtil::BrowseForFiles(displayName(), tr("Select a Minecraft world zip"), tr("Minecraft World Zip File (*.zip)"),
                                         QString(), this->parentWidget());
-    if (!list.empty()) {
-        m_worlds->stopWatching();
-        for (auto filename : list) {
-            m_worlds->installWorld(QFileInfo(filename));
-        }
-        m_worlds->startWatching();
+    if (list.empty())
+        return;
+
+    auto installs = makeShared<SequentialTask>(this, tr("Add worlds"));
+    for (auto filename : list) {
+        if (auto task = m_worlds->installWorld(QFileInfo(filename)))
+            installs->addTask(task);
     }
+    ProgressDialog progress(this);
+    progress.setSkipButton(true, tr("Abort"));
+    progress.execWithTask(installs.get());
+    m_worlds->update();
 }
 
 bool WorldListPage::isWorldSafe(QModelIndex)
@@ -387,9 +396,47 @@ void WorldListPage::on_actionCopy_triggered()
     QString name =
         QInputDialog::getText(this, tr("World name"), tr("Enter a new name for the copy."), QLineEdit::Normal, world->name(), &ok);
 
-    if (ok && name.length() > 0) {
-        world->install(m_worlds->dir().absolutePath(), name);
+    if (!ok || name.isEmpty())
+        return;
+
+    auto task = m_worlds->copyWorld(index.row(), name);
+    if (!task)
+        return;
+    ProgressDialog progress(this);
+    progress.setSkipButton(true, tr("Abort"));
+    progress.execWithTask(task.get());
+    m_worlds->update();
+}
+
+void WorldListPage::on_actionExport_triggered()
+{
+    QModelIndex index = getSelectedWorld();
+    if (!index.isValid()) {
+        return;
+    }
+
+    if (!worldSafetyNagQuestion(tr("Export World")))
+        return;
+
+    auto world = m_worlds->allWorlds().at(index.row());
+    QString output = QFileDialog::getSaveFileName(this, tr("Export %1").arg(world.name()),
+                                                  FS::PathCombine(QDir::homePath(), world.folderName() + ".zip"),
+                                                  tr("Minecraft World Zip File (*.zip)"), nullptr);
+    if (output.isEmpty())
+        return;
+    if (!output.endsWith(".zip"))
+        output.append(".zip");
+
+    auto task = m_worlds->exportWorld(index.row(), output);
+    if (!task) {
+        CustomMessageBox::selectable(this, tr("Export World"), tr("Couldn't read the files of \"%1\".").arg(world.name()),
+                                     QMessageBox::Warning)
+            ->show();
+        return;
     }
+    ProgressDialog progress(this);
+    progress.setSkipButton(true, tr("Abort"));
+    progress.execWithTask(task.get());
 }
 
 void WorldListPage::on_actionRename_triggered()
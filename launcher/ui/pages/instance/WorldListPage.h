@@ -94,6 +94,7 @@ class WorldListPage : public QMainWindow, public BasePage {
     void on_actionRemove_triggered();
     void on_actionAdd_triggered();
     void on_actionCopy_triggered();
+    void on_actionExport_triggered();
     void on_actionRename_triggered();
     void on_actionRefresh_triggered();
     void on_actionView_Folder_triggered();
@@ -207,6 +207,12 @@ void CustomPage::suggestCurrent()
                                  new VanillaCreationTask(m_selectedVersion, m_selectedLoader, m_selectedLoaderVersion));
     }
     dialog->setSuggestedIcon("default");
+
+    if (VersionPrefetcher::isEnabled()) {
+        auto loaderVersion = ui->loaderVersionList->selectedVersion() ? m_selectedLoaderVersion : nullptr;
+        m_prefetcher.prefetch(m_selectedVersion->descriptor(), loaderVersion ? m_selectedLoader : QString(),
+                              loaderVersion ? loaderVersion->descriptor() : QString());
+    }
 }
 
 void CustomPage::setSelectedVersion(BaseVersion::Ptr version)
@@ -38,6 +38,7 @@
 #include <QWidget>
 
 #include <Application.h>
+#include "minecraft/VersionPrefetcher.h"
 #include "tasks/Task.h"
 #include "ui/pages/BasePage.h"
 
@@ -87,4 +88,5 @@ class CustomPage : public QWidget, public BasePage {
     BaseVersion::Ptr m_selectedVersion;
     BaseVersion::Ptr m_selectedLoaderVersion;
     QString m_selectedLoader;
+    VersionPrefetcher m_prefetcher;
 };
@@ -4,11 +4,10 @@
 
 #include "ResourceModel.h"
 
-#include <QCryptographicHash>
+#include <QFutureWatcher>
 #include <QIcon>
 #include <QList>
 #include <QMessageBox>
-#include <QPixmapCache>
 #include <QUrl>
 #include <algorithm>
 #include <memory>
@@ -16,9 +15,9 @@
 #include "Application.h"
 #include "BuildConfig.h"
 #include "Json.h"
+#include "RemoteImageLoader.h"
 
-#include "net/ApiDownload.h"
-#include "net/NetJob.h"
+#include "tasks/Executor.h"
 
 #include "modplatform/ModIndex.h"
 
@@ -34,11 +33,28 @@ ResourceModel::ResourceModel(ResourceAPI* api) : QAbstractListModel(), m_api(api
 #ifndef LAUNCHER_TEST
     m_current_info_job.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentDownloads").toInt());
 #endif
+    if (auto loader = RemoteImageLoader::shared())
+        connect(loader, &RemoteImageLoader::loaded, this, &ResourceModel::iconLoaded);
 }
 
 ResourceModel::~ResourceModel()
 {
     s_running_models.find(this).value() = false;
+    waitForReaders();
+}
+
+void ResourceModel::waitForReaders()
+{
+    for (auto& reader : m_readers)
+        reader.waitForFinished();
+    m_readers.clear();
+}
+
+void ResourceModel::trackReader(QFuture<void> reader)
+{
+    m_readers.erase(std::remove_if(m_readers.begin(), m_readers.end(), [](const QFuture<void>& f) { return f.isFinished(); }),
+                    m_readers.end());
+    m_readers.append(reader);
 }
 
 auto ResourceModel::data(const QModelIndex& index, int role) const -> QVariant
@@ -60,8 +76,7 @@ auto ResourceModel::data(const QModelIndex& index, int role) const -> QVariant
             return pack->description;
         }
         case Qt::DecorationRole: {
-            if (auto icon_or_none = const_cast<ResourceModel*>(this)->getIcon(const_cast<QModelIndex&>(index), pack->logoUrl);
-                icon_or_none.has_value())
+            if (auto icon_or_none = getIcon(pack->logoUrl); icon_or_none.has_value())
                 return icon_or_none.value();
 
             return APPLICATION->getThemedIcon("screenshot-placeholder");
@@ -167,17 +182,9 @@ void ResourceModel::search()
 
     // Use defaults if no callbacks are set
     if (!callbacks.on_succeed)
-        callbacks.on_succeed = [this](auto& doc) {
-            if (!s_running_models.constFind(this).value())
-                return;
-            searchRequestSucceeded(doc);
-        };
+        callbacks.on_succeed = [this](auto& doc) { searchRequestSucceeded(doc); };
     if (!callbacks.on_fail)
-        callbacks.on_fail = [this](QString reason, int network_error_code) {
-            if (!s_running_models.constFind(this).value())
-                return;
-            searchRequestFailed(reason, network_error_code);
-        };
+        callbacks.on_fail = [this](QString reason, int network_error_code) { searchRequestFailed(reason, network_error_code); };
     if (!callbacks.on_abort)
         callbacks.on_abort = [this] {
             if (!s_running_models.constFind(this).value())
@@ -185,6 +192,19 @@ void ResourceModel::search()
             searchRequestAborted();
         };
 
+    // a slow answer to a search that was replaced since isn't even parsed, the abort is still needed for the reset though
+    auto generation = m_search_generation;
+    auto is_wanted = [this, generation] { return s_running_models.constFind(this).value() && generation == m_search_generation; };
+    callbacks.is_wanted = is_wanted;
+    callbacks.on_succeed = [is_wanted, on_succeed = std::move(callbacks.on_succeed)](QJsonDocument& doc) {
+        if (is_wanted())
+            on_succeed(doc);
+    };
+    callbacks.on_fail = [is_wanted, on_fail = std::move(callbacks.on_fail)](QString const& reason, int network_error_code) {
+        if (is_wanted())
+            on_fail(reason, network_error_code);
+    };
+
     if (auto job = m_api->searchProjects(std::move(args), std::move(callbacks)); job)
         runSearchJob(job);
 }
@@ -238,6 +258,10 @@ void ResourceModel::loadEntry(QModelIndex& entry)
 
 void ResourceModel::refresh()
 {
+    // the results that are still being read belong to the old search
+    m_search_generation++;
+    m_reading_search = false;
+
     bool reset_requested = false;
 
     if (hasActiveInfoJob()) {
@@ -300,48 +324,24 @@ std::optional<ResourceAPI::SortingMethod> ResourceModel::getCurrentSortingMethod
     return sort;
 }
 
-std::optional<QIcon> ResourceModel::getIcon(QModelIndex& index, const QUrl& url)
+std::optional<QIcon> ResourceModel::getIcon(const QUrl& url) const
 {
-    QPixmap pixmap;
-    if (QPixmapCache::find(url.toString(), &pixmap))
-        return { pixmap };
-
-    if (!m_current_icon_job)
-        m_current_icon_job.reset(new NetJob("IconJob", APPLICATION->network()));
-
-    if (m_currently_running_icon_actions.contains(url))
+    auto loader = RemoteImageLoader::shared();
+    if (!loader)
         return {};
-    if (m_failed_icon_actions.contains(url))
-        return {};
-
-    auto cache_entry = APPLICATION->metacache()->resolveEntry(
-        metaEntryBase(),
-        QString("logos/%1").arg(QString(QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Algorithm::Sha1).toHex())));
-    auto icon_fetch_action = Net::ApiDownload::makeCached(url, cache_entry);
-
-    auto full_file_path = cache_entry->getFullPath();
-    connect(icon_fetch_action.get(), &NetAction::succeeded, this, [=] {
-        auto icon = QIcon(full_file_path);
-        QPixmapCache::insert(url.toString(), icon.pixmap(icon.actualSize({ 64, 64 })));
-
-        m_currently_running_icon_actions.remove(url);
-
-        emit dataChanged(index, index, { Qt::DecorationRole });
-    });
-    connect(icon_fetch_action.get(), &NetAction::failed, this, [=] {
-        m_currently_running_icon_actions.remove(url);
-        m_failed_icon_actions.insert(url);
-    });
-
-    m_currently_running_icon_actions.insert(url);
-
-    m_current_icon_job->addNetAction(icon_fetch_action);
-    if (!m_current_icon_job->isRunning())
-        QMetaObject::invokeMethod(m_current_icon_job.get(), &NetJob::start);
-
+    if (auto pixmap = loader->get(url, metaEntryBase()))
+        return QIcon(*pixmap);
     return {};
 }
 
+void ResourceModel::iconLoaded(const QUrl& url)
+{
+    for (int row = 0; row < m_packs.size(); row++) {
+        if (m_packs[row]->logoUrl == url)
+            emit dataChanged(index(row), index(row), { Qt::DecorationRole });
+    }
+}
+
 // No 'forgor to implement' shall pass here :blobfox_knife:
 #define NEED_FOR_CALLBACK_ASSERT(name) \
     Q_ASSERT_X(0 != 0, #name, "You NEED to re-implement this if you intend on using the default callbacks.")
@@ -368,31 +368,65 @@ void ResourceModel::loadIndexedPackVersions(ModPlatform::IndexedPack&, QJsonArra
 
 void ResourceModel::searchRequestSucceeded(QJsonDocument& doc)
 {
-    QList<ModPlatform::IndexedPack::Ptr> newList;
-    auto packs = documentToArray(doc);
+    // reading a page of results takes a while, so it's done on another thread and only the rows are added here
+    auto generation = m_search_generation;
+    m_reading_search = true;
 
-    for (auto packRaw : packs) {
-        auto packObj = packRaw.toObject();
-
-        ModPlatform::IndexedPack::Ptr pack = std::make_shared<ModPlatform::IndexedPack>();
+    using Page = std::pair<QList<ModPlatform::IndexedPack::Ptr>, int>;
+    auto future = Executor::instance()->run(Executor::Priority::Interactive, [this, doc]() mutable {
+        Page page;
         try {
-            loadIndexedPack(*pack, packObj);
-            if (auto sel = std::find_if(m_selected.begin(), m_selected.end(),
-                                        [&pack](const DownloadTaskPtr i) {
-                                            const auto ipack = i->getPack();
-                                            return ipack->provider == pack->provider && ipack->addonId == pack->addonId;
-                                        });
-                sel != m_selected.end()) {
-                newList.append(sel->get()->getPack());
-            } else
-                newList.append(pack);
+            auto packs = documentToArray(doc);
+            page.second = packs.size();
+            for (auto packRaw : packs) {
+                auto packObj = packRaw.toObject();
+
+                ModPlatform::IndexedPack::Ptr pack = std::make_shared<ModPlatform::IndexedPack>();
+                try {
+                    loadIndexedPack(*pack, packObj);
+                    page.first.append(pack);
+                } catch (const JSONValidationError& e) {
+                    qWarning() << "Error while loading resource from " << debugName() << ": " << e.cause();
+                }
+            }
         } catch (const JSONValidationError& e) {
-            qWarning() << "Error while loading resource from " << debugName() << ": " << e.cause();
-            continue;
+            qWarning() << "Error while reading the search results from " << debugName() << ": " << e.cause();
         }
+        return page;
+    });
+    trackReader(future);
+
+    auto watcher = new QFutureWatcher<Page>(this);
+    connect(watcher, &QFutureWatcher<Page>::finished, this, [this, watcher, generation] {
+        watcher->deleteLater();
+        if (watcher->isCanceled())
+            return;
+        auto page = watcher->result();
+        searchPageRead(generation, page.first, page.second);
+    });
+    watcher->setFuture(future);
+}
+
+void ResourceModel::searchPageRead(quint64 generation, const QList<ModPlatform::IndexedPack::Ptr>& packs, int hits)
+{
+    if (generation != m_search_generation)
+        return;
+    m_reading_search = false;
+
+    QList<ModPlatform::IndexedPack::Ptr> newList;
+    for (auto pack : packs) {
+        if (auto sel = std::find_if(m_selected.begin(), m_selected.end(),
+                                    [&pack](const DownloadTaskPtr i) {
+                                        const auto ipack = i->getPack();
+                                        return ipack->provider == pack->provider && ipack->addonId == pack->addonId;
+                                    });
+            sel != m_selected.end()) {
+            newList.append(sel->get()->getPack());
+        } else
+            newList.append(pack);
     }
 
-    if (packs.size() < 25) {
+    if (hits < 25) {
         m_search_state = SearchState::Finished;
     } else {
         m_next_search_offset += 25;
@@ -466,23 +500,40 @@ void ResourceModel::versionRequestSucceeded(QJsonDocument& doc, ModPlatform::Ind
     if (pack.addonId != current_pack->addonId)
         return;
 
-    try {
-        auto arr = doc.isObject() ? Json::ensureArray(doc.object(), "data") : doc.array();
-        loadIndexedPackVersions(*current_pack, arr);
-    } catch (const JSONValidationError& e) {
-        qDebug() << doc;
-        qWarning() << "Error while reading " << debugName() << " resource version: " << e.cause();
-    }
+    // popular projects have thousands of versions, they are read into a copy of the pack on another thread
+    auto read = std::make_shared<ModPlatform::IndexedPack>(*current_pack);
+    auto future = Executor::instance()->run(Executor::Priority::Interactive, [this, doc, read] {
+        try {
+            auto arr = doc.isObject() ? Json::ensureArray(doc.object(), "data") : doc.array();
+            loadIndexedPackVersions(*read, arr);
+        } catch (const JSONValidationError& e) {
+            qDebug() << doc;
+            qWarning() << "Error while reading " << debugName() << " resource version: " << e.cause();
+        }
+    });
+    trackReader(future);
 
-    // Cache info :^)
-    QVariant new_pack;
-    new_pack.setValue(current_pack);
-    if (!setData(index, new_pack, Qt::UserRole)) {
-        qWarning() << "Failed to cache resource versions!";
-        return;
-    }
+    auto watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, read, index] {
+        watcher->deleteLater();
+        auto current_pack = data(index, Qt::UserRole).value<ModPlatform::IndexedPack::Ptr>();
+        if (!current_pack || read->addonId != current_pack->addonId)
+            return;
+        // the extra info may have been loaded meanwhile, so only the versions are taken
+        current_pack->versions = read->versions;
+        current_pack->versionsLoaded = read->versionsLoaded;
+
+        // Cache info :^)
+        QVariant new_pack;
+        new_pack.setValue(current_pack);
+        if (!setData(index, new_pack, Qt::UserRole)) {
+            qWarning() << "Failed to cache resource versions!";
+            return;
+        }
 
-    emit versionListUpdated();
+        emit versionListUpdated();
+    });
+    watcher->setFuture(future);
 }
 
 void ResourceModel::infoRequestSucceeded(QJsonDocument& doc, ModPlatform::IndexedPack& pack, const QModelIndex& index)
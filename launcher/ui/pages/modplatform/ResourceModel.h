@@ -7,6 +7,7 @@
 #include <optional>
 
 #include <QAbstractListModel>
+#include <QFuture>
 
 #include "QObjectPtr.h"
 
@@ -49,12 +50,20 @@ class ResourceModel : public QAbstractListModel {
     [[nodiscard]] inline int columnCount(const QModelIndex& parent) const override { return parent.isValid() ? 0 : 1; }
     [[nodiscard]] inline auto flags(const QModelIndex& index) const -> Qt::ItemFlags override { return QAbstractListModel::flags(index); }
 
-    [[nodiscard]] bool hasActiveSearchJob() const { return m_current_search_job && m_current_search_job->isRunning(); }
+    [[nodiscard]] bool hasActiveSearchJob() const
+    {
+        return (m_current_search_job && m_current_search_job->isRunning()) || m_reading_search;
+    }
     [[nodiscard]] bool hasActiveInfoJob() const { return m_current_info_job.isRunning(); }
     [[nodiscard]] Task::Ptr activeSearchJob() { return hasActiveSearchJob() ? m_current_search_job : nullptr; }
 
     [[nodiscard]] auto getSortingMethods() const { return m_api->getSortingMethods(); }
 
+    /** Waits for the search results and version lists that are being read on another thread, which calls into the model.
+     *  Has to be called before deleting it, while the model is still whole.
+     */
+    void waitForReaders();
+
    public slots:
     void fetchMore(const QModelIndex& parent) override;
     // NOTE: Can't use [[nodiscard]] here because of https://bugreports.qt.io/browse/QTBUG-58628 on Qt 5.12
@@ -83,8 +92,8 @@ class ResourceModel : public QAbstractListModel {
     /** Schedule a refresh, clearing the current state. */
     void refresh();
 
-    /** Gets the icon at the URL for the given index. If it's not fetched yet, fetch it and update when fisinhed. */
-    std::optional<QIcon> getIcon(QModelIndex&, const QUrl&);
+    /** Gets the icon at the URL. If it's not loaded yet, it's loaded and the rows showing it are updated when it's there. */
+    std::optional<QIcon> getIcon(const QUrl&) const;
 
     void addPack(ModPlatform::IndexedPack::Ptr pack,
                  ModPlatform::IndexedVersion& version,
@@ -101,12 +110,18 @@ class ResourceModel : public QAbstractListModel {
     void runSearchJob(Task::Ptr);
     void runInfoJob(Task::Ptr);
 
+    /** Updates the rows whose icon is at the URL. */
+    void iconLoaded(const QUrl&);
+
     [[nodiscard]] auto getCurrentSortingMethodByIndex() const -> std::optional<ResourceAPI::SortingMethod>;
 
     /** Converts a JSON document to a common array format.
      *
      *  This is needed so that different providers, with different JSON structures, can be parsed
      *  uniformally. You NEED to re-implement this if you intend on using the default callbacks.
+     *
+     *  For search results, this and loadIndexedPack are called on another thread, so they must not touch the model.
+     *  The same goes for loadIndexedPackVersions, which gets a copy of the pack.
      */
     [[nodiscard]] virtual auto documentToArray(QJsonDocument&) const -> QJsonArray;
 
@@ -132,13 +147,14 @@ class ResourceModel : public QAbstractListModel {
 
     // Job for searching for new entries
     shared_qobject_ptr<Task> m_current_search_job;
+    // bumped on every refresh, whatever answers an older search is dropped
+    quint64 m_search_generation = 0;
+    // search results and version lists are read off the GUI thread
+    QList<QFuture<void>> m_readers;
+    bool m_reading_search = false;
     // Job for fetching versions and extra info on existing entries
     ConcurrentTask m_current_info_job;
 
-    shared_qobject_ptr<NetJob> m_current_icon_job;
-    QSet<QUrl> m_currently_running_icon_actions;
-    QSet<QUrl> m_failed_icon_actions;
-
     QList<ModPlatform::IndexedPack::Ptr> m_packs;
     QList<DownloadTaskPtr> m_selected;
 
@@ -149,10 +165,13 @@ class ResourceModel : public QAbstractListModel {
    private:
     /* Default search request callbacks */
     void searchRequestSucceeded(QJsonDocument&);
+    void searchPageRead(quint64 generation, const QList<ModPlatform::IndexedPack::Ptr>& packs, int hits);
     void searchRequestForOneSucceeded(QJsonDocument&);
     void searchRequestFailed(QString reason, int network_error_code);
     void searchRequestAborted();
 
+    void trackReader(QFuture<void> reader);
+
     void versionRequestSucceeded(QJsonDocument&, ModPlatform::IndexedPack&, const QModelIndex&);
 
     void infoRequestSucceeded(QJsonDocument&, ModPlatform::IndexedPack&, const QModelIndex&);
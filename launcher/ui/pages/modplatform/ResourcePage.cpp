@@ -43,7 +43,7 @@
 #include <QDesktopServices>
 #include <QKeyEvent>
 
-#include "Markdown.h"
+#include "MarkdownRenderer.h"
 
 #include "ui/dialogs/ResourceDownloadDialog.h"
 #include "ui/pages/modplatform/ResourceModel.h"
@@ -81,8 +81,10 @@ ResourcePage::ResourcePage(ResourceDownloadDialog* parent, BaseInstance& base_in
 ResourcePage::~ResourcePage()
 {
     delete m_ui;
-    if (m_model)
+    if (m_model) {
+        m_model->waitForReaders();
         delete m_model;
+    }
 }
 
 void ResourcePage::retranslate()
@@ -229,9 +231,25 @@ void ResourcePage::updateUi()
 
     text += "<hr>";
 
-    m_ui->packDescription->setHtml(
-        text + (current_pack->extraData.body.isEmpty() ? current_pack->description : markdownToHTML(current_pack->extraData.body)));
-    m_ui->packDescription->flush();
+    if (current_pack->extraData.body.isEmpty()) {
+        m_ui->packDescription->setHtml(text + current_pack->description);
+        m_ui->packDescription->flush();
+        return;
+    }
+
+    // a long body is rendered off the GUI thread, what's above it is shown meanwhile
+    auto shown = std::make_shared<bool>(false);
+    renderMarkdown(this, current_pack->extraData.body, [this, text, current_pack, shown](const QString& html) {
+        *shown = true;
+        if (getCurrentPack() != current_pack)
+            return;
+        m_ui->packDescription->setHtml(text + html);
+        m_ui->packDescription->flush();
+    });
+    if (!*shown) {
+        m_ui->packDescription->setHtml(text);
+        m_ui->packDescription->flush();
+    }
 }
 
 void ResourcePage::updateSelectionButton()
@@ -22,6 +22,7 @@
 #include <modplatform/atlauncher/ATLPackIndex.h>
 
 #include "StringUtils.h"
+#include "modplatform/helpers/ModpackCatalog.h"
 
 namespace Atl {
 
@@ -59,6 +60,7 @@ FilterModel::Sorting FilterModel::getCurrentSorting()
 void FilterModel::setSearchTerm(const QString term)
 {
     searchTerm = term.trimmed();
+    catalogMatches = searchTerm.isEmpty() ? QSet<QString>() : ModpackCatalog::forProvider("atlauncher").matching(searchTerm);
     invalidate();
 }
 
@@ -71,7 +73,7 @@ bool FilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParen
     ATLauncher::IndexedPack pack = sourceModel()->data(index, Qt::UserRole).value<ATLauncher::IndexedPack>();
     if (searchTerm.startsWith("#"))
         return QString::number(pack.id) == searchTerm.mid(1);
-    return pack.name.contains(searchTerm, Qt::CaseInsensitive);
+    return pack.name.contains(searchTerm, Qt::CaseInsensitive) || catalogMatches.contains(QString::number(pack.id));
 }
 
 bool FilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <QSet>
 #include <QtCore/QSortFilterProxyModel>
 
 namespace Atl {
@@ -43,6 +44,8 @@ class FilterModel : public QSortFilterProxyModel {
     QMap<QString, Sorting> sortings;
     Sorting currentSorting;
     QString searchTerm;
+    // the ids of the packs the catalog finds for the term, in their descriptions too
+    QSet<QString> catalogMatches;
 };
 
 }  // namespace Atl
@@ -20,6 +20,10 @@
 #include <BuildConfig.h>
 #include <Json.h>
 
+#include <QFile>
+
+#include "modplatform/helpers/ModpackCatalog.h"
+#include "modplatform/helpers/ResponseParser.h"
 #include "net/ApiDownload.h"
 #include "ui/widgets/ProjectItem.h"
 
@@ -27,7 +31,10 @@ namespace Atl {
 
 ListModel::ListModel(QObject* parent) : QAbstractListModel(parent) {}
 
-ListModel::~ListModel() {}
+ListModel::~ListModel()
+{
+    ModpackCatalog::forProvider("atlauncher").save();
+}
 
 int ListModel::rowCount(const QModelIndex& parent) const
 {
@@ -93,15 +100,41 @@ QVariant ListModel::data(const QModelIndex& index, int role) const
     return {};
 }
 
+static bool isListed(const ATLauncher::IndexedPack& pack)
+{
+    // ignore packs without a published version
+    if (pack.versions.length() == 0)
+        return false;
+    // only display public packs (for now)
+    if (pack.type != ATLauncher::PackType::Public)
+        return false;
+    // ignore "system" packs (Vanilla, Vanilla with Forge, etc)
+    return !pack.system;
+}
+
 void ListModel::request()
 {
+    // what was listed last time shows right away, and is all there is without the network
     beginResetModel();
     modpacks.clear();
+    for (auto packObj : ModpackCatalog::forProvider("atlauncher").search({})) {
+        ATLauncher::IndexedPack pack;
+        try {
+            ATLauncher::loadIndexedPack(pack, packObj);
+        } catch (const JSONValidationError&) {
+            continue;
+        }
+        if (isListed(pack))
+            modpacks.append(pack);
+    }
     endResetModel();
 
     auto netJob = makeShared<NetJob>("Atl::Request", APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     auto url = QString(BuildConfig.ATL_DOWNLOAD_SERVER_URL + "launcher/json/packsnew.json");
-    netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(url), response));
+    // the list is revalidated by its ETag, it changes far less often than it's looked at
+    m_listEntry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", "packsnew.json");
+    netJob->addNetAction(Net::ApiDownload::makeCached(QUrl(url), m_listEntry));
     jobPtr = netJob;
     jobPtr->start();
 
@@ -111,48 +144,52 @@ void ListModel::request()
 
 void ListModel::requestFinished()
 {
-    jobPtr.reset();
-
-    QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-    if (parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from ATL at " << parse_error.offset << " reason: " << parse_error.errorString();
-        qWarning() << *response;
+    QFile file(m_listEntry->getFullPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Couldn't read the pack list from ATLauncher:" << file.errorString();
+        jobPtr.reset();
         return;
     }
 
-    QList<ATLauncher::IndexedPack> newList;
+    // the whole pack list is read off the GUI thread
+    struct List {
+        QList<ATLauncher::IndexedPack> packs;
+        QList<ModpackCatalog::Entry> catalog;
+    };
+    auto read = [](QJsonDocument& doc) {
+        List list;
 
-    auto packs = doc.array();
-    for (auto packRaw : packs) {
-        auto packObj = packRaw.toObject();
+        auto packs = doc.array();
+        for (auto packRaw : packs) {
+            auto packObj = packRaw.toObject();
 
-        ATLauncher::IndexedPack pack;
-
-        try {
+            ATLauncher::IndexedPack pack;
             ATLauncher::loadIndexedPack(pack, packObj);
-        } catch (const JSONValidationError& e) {
-            qDebug() << QString::fromUtf8(*response);
-            qWarning() << "Error while reading pack manifest from ATLauncher: " << e.cause();
-            return;
-        }
+            if (!isListed(pack))
+                continue;
 
-        // ignore packs without a published version
-        if (pack.versions.length() == 0)
-            continue;
-        // only display public packs (for now)
-        if (pack.type != ATLauncher::PackType::Public)
-            continue;
-        // ignore "system" packs (Vanilla, Vanilla with Forge, etc)
-        if (pack.system)
-            continue;
-
-        newList.append(pack);
-    }
-
-    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
-    modpacks.append(newList);
-    endInsertRows();
+            list.packs.append(pack);
+            // the popularity is all ATLauncher tells of the downloads, it orders them the same way
+            list.catalog.append({ QString::number(pack.id), pack.name, {}, {}, pack.description, pack.position, packObj });
+        }
+        return list;
+    };
+    auto done = [this, job = jobPtr](List& list) {
+        if (jobPtr != job)
+            return;
+        jobPtr.reset();
+
+        ModpackCatalog::forProvider("atlauncher").replace(list.catalog);
+        beginResetModel();
+        modpacks = list.packs;
+        endResetModel();
+    };
+    auto fail = [this, job = jobPtr](const QString& reason) {
+        if (jobPtr == job)
+            jobPtr.reset();
+        qWarning() << "Error while reading the pack list from ATLauncher:" << reason;
+    };
+    ResponseParser::parse<List>(this, file.readAll(), read, done, fail);
 }
 
 void ListModel::requestFailed(QString reason)
@@ -195,6 +232,7 @@ void ListModel::requestLogo(QString file, QString url)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("ATLauncherPacks", QString("logos/%1").arg(file));
     auto job = new NetJob(QString("ATLauncher Icon Download %1").arg(file), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::ApiDownload::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
@@ -156,6 +156,7 @@ Qt::ItemFlags AtlOptionalModListModel::flags(const QModelIndex& index) const
 void AtlOptionalModListModel::useShareCode(const QString& code)
 {
     m_jobPtr.reset(new NetJob("Atl::Request", APPLICATION->network()));
+    m_jobPtr->setPriority(Net::Priority::Interactive);
     auto url = QString(BuildConfig.ATL_API_BASE_URL + "share-codes/" + code);
     m_jobPtr->addNetAction(Net::ApiDownload::makeByteArray(QUrl(url), m_response));
 
@@ -3,6 +3,8 @@
 #include "Application.h"
 #include "modplatform/ResourceAPI.h"
 #include "modplatform/flame/FlameAPI.h"
+#include "modplatform/helpers/ModpackCatalog.h"
+#include "modplatform/helpers/ResponseParser.h"
 #include "ui/widgets/ProjectItem.h"
 
 #include "net/ApiDownload.h"
@@ -15,7 +17,21 @@ namespace Flame {
 
 ListModel::ListModel(QObject* parent) : QAbstractListModel(parent) {}
 
-ListModel::~ListModel() {}
+ListModel::~ListModel()
+{
+    ModpackCatalog::forProvider("flame").save();
+}
+
+static ModpackCatalog::Entry catalogEntry(const IndexedPack& pack, const QJsonObject& packObj)
+{
+    ModpackCatalog::Entry entry{ QString::number(pack.addonId), pack.name, {}, {}, pack.description, 0, packObj };
+    for (auto& author : pack.authors)
+        entry.authors.append(author.name);
+    for (auto category : packObj.value("categories").toArray())
+        entry.tags.append(category.toObject().value("name").toString());
+    entry.downloads = static_cast<qint64>(packObj.value("downloadCount").toDouble());
+    return entry;
+}
 
 int ListModel::rowCount(const QModelIndex& parent) const
 {
@@ -110,6 +126,7 @@ void ListModel::requestLogo(QString logo, QString url)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FlamePacks", QString("logos/%1").arg(logo));
     auto job = new NetJob(QString("Flame Icon Download %1").arg(logo), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::ApiDownload::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
@@ -179,6 +196,7 @@ void ListModel::performPaginatedSearch()
         }
     }
     auto netJob = makeShared<NetJob>("Flame::Search", APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     auto searchUrl = QString(
                          "https://api.curseforge.com/v1/mods/search?"
                          "gameId=432&"
@@ -225,43 +243,54 @@ void Flame::ListModel::searchRequestFinished()
     if (hasActiveSearchJob())
         return;
 
-    QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-    if (parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from CurseForge at " << parse_error.offset
-                   << " reason: " << parse_error.errorString();
-        qWarning() << *response;
-        return;
-    }
-
-    QList<Flame::IndexedPack> newList;
-    auto packs = Json::ensureArray(doc.object(), "data");
-    for (auto packRaw : packs) {
-        auto packObj = packRaw.toObject();
-
-        Flame::IndexedPack pack;
-        try {
-            Flame::loadIndexedPack(pack, packObj);
-            newList.append(pack);
-        } catch (const JSONValidationError& e) {
-            qWarning() << "Error while loading pack from CurseForge: " << e.cause();
-            continue;
+    // the page is read off the GUI thread, what comes back after another search started is dropped
+    struct Page {
+        QList<Flame::IndexedPack> packs;
+        int hits = 0;
+        QList<ModpackCatalog::Entry> catalog;
+    };
+    auto read = [](QJsonDocument& doc) {
+        Page page;
+        auto packs = Json::ensureArray(doc.object(), "data");
+        page.hits = packs.size();
+        for (auto packRaw : packs) {
+            auto packObj = packRaw.toObject();
+
+            Flame::IndexedPack pack;
+            try {
+                Flame::loadIndexedPack(pack, packObj);
+                page.packs.append(pack);
+                page.catalog.append(catalogEntry(pack, packObj));
+            } catch (const JSONValidationError& e) {
+                qWarning() << "Error while loading pack from CurseForge: " << e.cause();
+                continue;
+            }
+        }
+        return page;
+    };
+    auto done = [this, job = jobPtr](Page& page) {
+        if (jobPtr != job)
+            return;
+        ModpackCatalog::forProvider("flame").update(page.catalog);
+        auto& newList = page.packs;
+        if (page.hits < 25) {
+            searchState = Finished;
+        } else {
+            nextSearchOffset += 25;
+            searchState = CanPossiblyFetchMore;
         }
-    }
-    if (packs.size() < 25) {
-        searchState = Finished;
-    } else {
-        nextSearchOffset += 25;
-        searchState = CanPossiblyFetchMore;
-    }
 
-    // When you have a Qt build with assertions turned on, proceeding here will abort the application
-    if (newList.size() == 0)
-        return;
+        // When you have a Qt build with assertions turned on, proceeding here will abort the application
+        if (newList.size() == 0)
+            return;
 
-    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
-    modpacks.append(newList);
-    endInsertRows();
+        beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
+        modpacks.append(newList);
+        endInsertRows();
+    };
+    ResponseParser::parse<Page>(this, *response, read, done, [](const QString& reason) {
+        qWarning() << "Error while parsing JSON response from CurseForge:" << reason;
+    });
 }
 
 void Flame::ListModel::searchRequestForOneSucceeded(QJsonDocument& doc)
@@ -277,6 +306,7 @@ void Flame::ListModel::searchRequestForOneSucceeded(QJsonDocument& doc)
         qWarning() << "Error while loading pack from CurseForge: " << e.cause();
         return;
     }
+    ModpackCatalog::forProvider("flame").update({ catalogEntry(pack, packObj) });
 
     beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + 1);
     modpacks.append({ pack });
@@ -296,7 +326,31 @@ void Flame::ListModel::searchRequestFailed(QString reason)
         performPaginatedSearch();
     } else {
         searchState = Finished;
+        if (nextSearchOffset == 0)
+            searchCatalog();
+    }
+}
+
+bool Flame::ListModel::searchCatalog()
+{
+    // CurseForge can't be reached, what was browsed before is searched instead, most downloaded first
+    QList<Flame::IndexedPack> found;
+    for (auto packObj : ModpackCatalog::forProvider("flame").search(currentSearchTerm)) {
+        Flame::IndexedPack pack;
+        try {
+            Flame::loadIndexedPack(pack, packObj);
+            found.append(pack);
+        } catch (const JSONValidationError&) {
+            continue;
+        }
     }
+    if (found.isEmpty())
+        return false;
+
+    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + found.size() - 1);
+    modpacks.append(found);
+    endInsertRows();
+    return true;
 }
 
 }  // namespace Flame
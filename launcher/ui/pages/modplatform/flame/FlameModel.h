@@ -1,7 +1,5 @@
 #pragma once
 
-#include <RWStorage.h>
-
 #include <QAbstractListModel>
 #include <QIcon>
 #include <QList>
@@ -55,6 +53,8 @@ class ListModel : public QAbstractListModel {
 
    private:
     void requestLogo(QString file, QString url);
+    /// fill the list from the catalog, false if it knows of nothing matching
+    bool searchCatalog();
 
    private:
     QList<IndexedPack> modpacks;
@@ -23,8 +23,11 @@
 #include <QWidget>
 #include "FileSystem.h"
 #include "ListModel.h"
+#include "modplatform/import_ftb/BatchImportTask.h"
 #include "modplatform/import_ftb/PackInstallTask.h"
+#include "ui/dialogs/CustomMessageBox.h"
 #include "ui/dialogs/NewInstanceDialog.h"
+#include "ui/dialogs/ProgressDialog.h"
 
 namespace FTBImportAPP {
 
@@ -55,6 +58,7 @@ ImportFTBPage::ImportFTBPage(NewInstanceDialog* dialog, QWidget* parent) : QWidg
     connect(ui->sortByBox, &QComboBox::currentTextChanged, this, &ImportFTBPage::onSortingSelectionChanged);
 
     connect(ui->searchEdit, &QLineEdit::textChanged, this, &ImportFTBPage::triggerSearch);
+    connect(ui->importAllButton, &QPushButton::clicked, this, &ImportFTBPage::importAll);
 
     ui->modpackList->setItemDelegate(new ProjectItemDelegate(this));
     ui->modpackList->selectionModel()->reset();
@@ -126,4 +130,26 @@ void ImportFTBPage::triggerSearch()
     currentModel->setSearchTerm(ui->searchEdit->text());
 }
 
+void ImportFTBPage::importAll()
+{
+    const auto& packs = listModel->packs();
+    if (packs.isEmpty())
+        return;
+    auto response = CustomMessageBox::selectable(this, tr("Import all FTB App instances?"),
+                                                 tr("This imports all %n instance(s) of the FTB App at once.", "", packs.size()),
+                                                 QMessageBox::Question, QMessageBox::Yes | QMessageBox::No, QMessageBox::No)
+                        ->exec();
+    if (response != QMessageBox::Yes)
+        return;
+
+    auto task = makeShared<BatchImportTask>(packs, dialog->instGroup());
+    connect(task.get(), &Task::failed, this, [this](const QString& reason) {
+        CustomMessageBox::selectable(this, tr("Error"), reason, QMessageBox::Warning)->show();
+    });
+    ProgressDialog progress(this);
+    progress.execWithTask(task.get());
+    // there's nothing left to create here
+    dialog->reject();
+}
+
 }  // namespace FTBImportAPP
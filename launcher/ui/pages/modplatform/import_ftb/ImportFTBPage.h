@@ -56,6 +56,7 @@ class ImportFTBPage : public QWidget, public BasePage {
     void onSortingSelectionChanged(QString data);
     void onPublicPackSelectionChanged(QModelIndex first, QModelIndex second);
     void triggerSearch();
+    void importAll();
 
    private:
     bool initialized = false;
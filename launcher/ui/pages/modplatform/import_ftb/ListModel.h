@@ -55,6 +55,7 @@ class ListModel : public QAbstractListModel {
     virtual ~ListModel() = default;
 
     int rowCount(const QModelIndex& parent) const { return modpacks.size(); }
+    const ModpackList& packs() const { return modpacks; }
     int columnCount(const QModelIndex& parent) const { return 1; }
     QVariant data(const QModelIndex& index, int role) const;
 
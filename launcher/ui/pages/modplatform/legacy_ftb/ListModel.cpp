@@ -46,8 +46,6 @@
 #include <QLabel>
 #include <QtMath>
 
-#include <RWStorage.h>
-
 #include <BuildConfig.h>
 
 namespace LegacyFTB {
@@ -264,6 +262,7 @@ void ListModel::requestLogo(QString file)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("FTBPacks", QString("logos/%1").arg(file));
     NetJob* job = new NetJob(QString("FTB Icon Download for %1").arg(file), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::ApiDownload::makeCached(QUrl(QString(BuildConfig.LEGACY_FTB_CDN_BASE_URL + "static/%1").arg(file)), entry));
 
     auto fullPath = entry->getFullPath();
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <RWStorage.h>
 #include <modplatform/legacy_ftb/PackHelpers.h>
 
 #include <QAbstractListModel>
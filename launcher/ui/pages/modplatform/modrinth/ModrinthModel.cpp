@@ -38,6 +38,8 @@
 
 #include "BuildConfig.h"
 #include "Json.h"
+#include "modplatform/helpers/ModpackCatalog.h"
+#include "modplatform/helpers/ResponseParser.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "net/NetJob.h"
 #include "ui/widgets/ProjectItem.h"
@@ -50,6 +52,22 @@ namespace Modrinth {
 
 ModpackListModel::ModpackListModel(ModrinthPage* parent) : QAbstractListModel(parent), m_parent(parent) {}
 
+ModpackListModel::~ModpackListModel()
+{
+    ModpackCatalog::forProvider("modrinth").save();
+}
+
+static ModpackCatalog::Entry catalogEntry(const Modrinth::Modpack& pack, const QJsonObject& packObj)
+{
+    ModpackCatalog::Entry entry{ pack.id, pack.name, {}, {}, pack.description, 0, packObj };
+    if (!std::get<0>(pack.author).isEmpty())
+        entry.authors.append(std::get<0>(pack.author));
+    for (auto category : packObj.value("categories").toArray())
+        entry.tags.append(category.toString());
+    entry.downloads = static_cast<qint64>(packObj.value("downloads").toDouble());
+    return entry;
+}
+
 auto ModpackListModel::debugName() const -> QString
 {
     return m_parent->debugName();
@@ -149,6 +167,7 @@ void ModpackListModel::performPaginatedSearch()
         }
     }  // TODO: Move to standalone API
     auto netJob = makeShared<NetJob>("Modrinth::SearchModpack", APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     auto searchAllUrl = QString(BuildConfig.MODRINTH_PROD_URL +
                                 "/search?"
                                 "offset=%1&"
@@ -163,18 +182,41 @@ void ModpackListModel::performPaginatedSearch()
 
     netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(searchAllUrl), m_all_response));
 
+    // the page is read off the GUI thread, what comes back after another search started is dropped
     QObject::connect(netJob.get(), &NetJob::succeeded, this, [this] {
-        QJsonParseError parse_error_all{};
-
-        QJsonDocument doc_all = QJsonDocument::fromJson(*m_all_response, &parse_error_all);
-        if (parse_error_all.error != QJsonParseError::NoError) {
-            qWarning() << "Error while parsing JSON response from " << debugName() << " at " << parse_error_all.offset
-                       << " reason: " << parse_error_all.errorString();
-            qWarning() << *m_all_response;
-            return;
-        }
-
-        searchRequestFinished(doc_all);
+        struct Page {
+            QList<Modrinth::Modpack> packs;
+            int hits = 0;
+            QList<ModpackCatalog::Entry> catalog;
+        };
+        auto read = [name = debugName()](QJsonDocument& doc_all) {
+            Page page;
+            auto packs_all = doc_all.object().value("hits").toArray();
+            page.hits = packs_all.size();
+            for (auto packRaw : packs_all) {
+                auto packObj = packRaw.toObject();
+
+                Modrinth::Modpack pack;
+                try {
+                    Modrinth::loadIndexedPack(pack, packObj);
+                    page.packs.append(pack);
+                    page.catalog.append(catalogEntry(pack, packObj));
+                } catch (const JSONValidationError& e) {
+                    qWarning() << "Error while loading mod from " << name << ": " << e.cause();
+                    continue;
+                }
+            }
+            return page;
+        };
+        auto done = [this, job = jobPtr](Page& page) {
+            if (jobPtr != job)
+                return;
+            ModpackCatalog::forProvider("modrinth").update(page.catalog);
+            searchRequestFinished(page.packs, page.hits);
+        };
+        ResponseParser::parse<Page>(this, *m_all_response, read, done, [this](const QString& reason) {
+            qWarning() << "Error while parsing JSON response from " << debugName() << ":" << reason;
+        });
     });
     QObject::connect(netJob.get(), &NetJob::failed, this, &ModpackListModel::searchRequestFailed);
 
@@ -250,6 +292,7 @@ void ModpackListModel::requestLogo(QString logo, QString url)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry(m_parent->metaEntryBase(), QString("logos/%1").arg(logo));
     auto job = new NetJob(QString("%1 Icon Download %2").arg(m_parent->debugName()).arg(logo), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::ApiDownload::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
@@ -289,27 +332,11 @@ void ModpackListModel::logoFailed(QString logo)
     m_loadingLogos.removeAll(logo);
 }
 
-void ModpackListModel::searchRequestFinished(QJsonDocument& doc_all)
+void ModpackListModel::searchRequestFinished(const QList<Modrinth::Modpack>& newList, int hits)
 {
     jobPtr.reset();
 
-    QList<Modrinth::Modpack> newList;
-
-    auto packs_all = doc_all.object().value("hits").toArray();
-    for (auto packRaw : packs_all) {
-        auto packObj = packRaw.toObject();
-
-        Modrinth::Modpack pack;
-        try {
-            Modrinth::loadIndexedPack(pack, packObj);
-            newList.append(pack);
-        } catch (const JSONValidationError& e) {
-            qWarning() << "Error while loading mod from " << m_parent->debugName() << ": " << e.cause();
-            continue;
-        }
-    }
-
-    if (packs_all.size() < m_modpacks_per_page) {
+    if (hits < m_modpacks_per_page) {
         searchState = Finished;
     } else {
         nextSearchOffset += m_modpacks_per_page;
@@ -339,6 +366,9 @@ void ModpackListModel::searchRequestForOneSucceeded(QJsonDocument& doc)
         qWarning() << "Error while loading mod from " << m_parent->debugName() << ": " << e.cause();
         return;
     }
+    // a project isn't laid out like a search hit, the catalog keeps it as one
+    packObj.insert("project_id", pack.id);
+    ModpackCatalog::forProvider("modrinth").update({ catalogEntry(pack, packObj) });
 
     beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + 1);
     modpacks.append({ pack });
@@ -349,8 +379,9 @@ void ModpackListModel::searchRequestFailed(QString reason)
 {
     auto failed_action = dynamic_cast<NetJob*>(jobPtr.get())->getFailedActions().at(0);
     if (!failed_action->m_reply) {
-        // Network error
-        QMessageBox::critical(nullptr, tr("Error"), tr("A network error occurred. Could not load modpacks."));
+        // Network error, what was browsed before is searched instead
+        if (searchState == ResetRequested || nextSearchOffset != 0 || !searchCatalog())
+            QMessageBox::critical(nullptr, tr("Error"), tr("A network error occurred. Could not load modpacks."));
     } else if (failed_action->m_reply && failed_action->m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 409) {
         // 409 Gone, notify user to update
         QMessageBox::critical(nullptr, tr("Error"),
@@ -373,6 +404,27 @@ void ModpackListModel::searchRequestFailed(QString reason)
     }
 }
 
+bool ModpackListModel::searchCatalog()
+{
+    QList<Modrinth::Modpack> found;
+    for (auto packObj : ModpackCatalog::forProvider("modrinth").search(currentSearchTerm)) {
+        Modrinth::Modpack pack;
+        try {
+            Modrinth::loadIndexedPack(pack, packObj);
+            found.append(pack);
+        } catch (const JSONValidationError&) {
+            continue;
+        }
+    }
+    if (found.isEmpty())
+        return false;
+
+    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + found.size() - 1);
+    modpacks.append(found);
+    endInsertRows();
+    return true;
+}
+
 }  // namespace Modrinth
 
 /******** Helpers ********/
@@ -54,7 +54,7 @@ class ModpackListModel : public QAbstractListModel {
 
    public:
     ModpackListModel(ModrinthPage* parent);
-    ~ModpackListModel() override = default;
+    ~ModpackListModel() override;
 
     inline auto rowCount(const QModelIndex& parent) const -> int override { return parent.isValid() ? 0 : modpacks.size(); };
     inline auto columnCount(const QModelIndex& parent) const -> int override { return parent.isValid() ? 0 : 1; };
@@ -84,7 +84,7 @@ class ModpackListModel : public QAbstractListModel {
     };
 
    public slots:
-    void searchRequestFinished(QJsonDocument& doc_all);
+    void searchRequestFinished(const QList<Modrinth::Modpack>& newList, int hits);
     void searchRequestFailed(QString reason);
     void searchRequestForOneSucceeded(QJsonDocument&);
 
@@ -97,6 +97,8 @@ class ModpackListModel : public QAbstractListModel {
 
    protected:
     void requestLogo(QString file, QString url);
+    /// fill the list from the catalog, false if it knows of nothing matching
+    bool searchCatalog();
 
     inline auto getMineVersions() const -> std::list<Version>;
 
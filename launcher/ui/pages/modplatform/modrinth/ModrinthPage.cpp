@@ -42,7 +42,7 @@
 #include "BuildConfig.h"
 #include "InstanceImportTask.h"
 #include "Json.h"
-#include "Markdown.h"
+#include "MarkdownRenderer.h"
 
 #include "ui/widgets/ProjectItem.h"
 
@@ -142,6 +142,7 @@ void ModrinthPage::onSelectionChanged(QModelIndex curr, [[maybe_unused]] QModelI
         qDebug() << "Loading modrinth modpack information";
 
         auto netJob = new NetJob(QString("Modrinth::PackInformation(%1)").arg(current.name), APPLICATION->network());
+        netJob->setPriority(Net::Priority::Interactive);
         auto response = std::make_shared<QByteArray>();
 
         QString id = current.id;
@@ -190,6 +191,7 @@ void ModrinthPage::onSelectionChanged(QModelIndex curr, [[maybe_unused]] QModelI
         qDebug() << "Loading modrinth modpack versions";
 
         auto netJob = new NetJob(QString("Modrinth::PackVersions(%1)").arg(current.name), APPLICATION->network());
+        netJob->setPriority(Net::Priority::Interactive);
         auto response = std::make_shared<QByteArray>();
 
         QString id = current.id;
@@ -291,10 +293,19 @@ void ModrinthPage::updateUI()
 
     text += "<hr>";
 
-    text += markdownToHTML(current.extra.body.toUtf8());
-
-    ui->packDescription->setHtml(text + current.description);
-    ui->packDescription->flush();
+    // a long body is rendered off the GUI thread, what's above it is shown meanwhile
+    auto shown = std::make_shared<bool>(false);
+    renderMarkdown(this, current.extra.body, [this, text, id = current.id, shown](const QString& html) {
+        *shown = true;
+        if (current.id != id)
+            return;
+        ui->packDescription->setHtml(text + html + current.description);
+        ui->packDescription->flush();
+    });
+    if (!*shown) {
+        ui->packDescription->setHtml(text);
+        ui->packDescription->flush();
+    }
 }
 
 void ModrinthPage::suggestCurrent()
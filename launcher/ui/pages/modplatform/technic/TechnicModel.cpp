@@ -37,6 +37,7 @@
 #include "Application.h"
 #include "BuildConfig.h"
 #include "Json.h"
+#include "modplatform/helpers/ResponseParser.h"
 
 #include "net/ApiDownload.h"
 #include "ui/widgets/ProjectItem.h"
@@ -136,6 +137,7 @@ void Technic::ListModel::performSearch()
         return;
 
     auto netJob = makeShared<NetJob>("Technic::Search", APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     QString searchUrl = "";
     if (currentSearchTerm.isEmpty()) {
         searchUrl = QString("%1trending?build=%2").arg(BuildConfig.TECHNIC_API_BASE_URL, BuildConfig.TECHNIC_API_BUILD);
@@ -163,22 +165,12 @@ void Technic::ListModel::performSearch()
 
 void Technic::ListModel::searchRequestFinished()
 {
-    jobPtr.reset();
-
-    QJsonParseError parse_error;
-    QJsonDocument doc = QJsonDocument::fromJson(*response, &parse_error);
-    if (parse_error.error != QJsonParseError::NoError) {
-        qWarning() << "Error while parsing JSON response from Technic at " << parse_error.offset
-                   << " reason: " << parse_error.errorString();
-        qWarning() << *response;
-        return;
-    }
-
-    QList<Modpack> newList;
-    try {
+    // the results are read off the GUI thread, what comes back after another search started is dropped
+    auto read = [mode = searchMode](QJsonDocument& doc) {
+        QList<Modpack> newList;
         auto root = Json::requireObject(doc);
 
-        switch (searchMode) {
+        switch (mode) {
             case List: {
                 auto objs = Json::requireArray(root, "modpacks");
                 for (auto technicPack : objs) {
@@ -228,19 +220,28 @@ void Technic::ListModel::searchRequestFinished()
                 break;
             }
         }
-    } catch (const JSONValidationError& err) {
-        qCritical() << "Couldn't parse technic search results:" << err.cause();
-        return;
-    }
-    searchState = Finished;
-
-    // When you have a Qt build with assertions turned on, proceeding here will abort the application
-    if (newList.size() == 0)
-        return;
+        return newList;
+    };
+    auto done = [this, job = jobPtr](QList<Modpack>& newList) {
+        if (jobPtr != job)
+            return;
+        jobPtr.reset();
+        searchState = Finished;
 
-    beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
-    modpacks.append(newList);
-    endInsertRows();
+        // When you have a Qt build with assertions turned on, proceeding here will abort the application
+        if (newList.size() == 0)
+            return;
+
+        beginInsertRows(QModelIndex(), modpacks.size(), modpacks.size() + newList.size() - 1);
+        modpacks.append(newList);
+        endInsertRows();
+    };
+    auto fail = [this, job = jobPtr](const QString& reason) {
+        if (jobPtr == job)
+            jobPtr.reset();
+        qCritical() << "Couldn't parse technic search results:" << reason;
+    };
+    ResponseParser::parse<QList<Modpack>>(this, *response, read, done, fail);
 }
 
 void Technic::ListModel::getLogo(const QString& logo, const QString& logoUrl, Technic::LogoCallback callback)
@@ -292,6 +293,7 @@ void Technic::ListModel::requestLogo(QString logo, QString url)
 
     MetaEntryPtr entry = APPLICATION->metacache()->resolveEntry("TechnicPacks", QString("logos/%1").arg(logo));
     auto job = new NetJob(QString("Technic Icon Download %1").arg(logo), APPLICATION->network());
+    job->setPriority(Net::Priority::Interactive);
     job->addNetAction(Net::ApiDownload::makeCached(QUrl(url), entry));
 
     auto fullPath = entry->getFullPath();
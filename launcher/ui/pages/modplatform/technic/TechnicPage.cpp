@@ -158,6 +158,7 @@ void TechnicPage::suggestCurrent()
     }
 
     auto netJob = makeShared<NetJob>(QString("Technic::PackMeta(%1)").arg(current.name), APPLICATION->network());
+    netJob->setPriority(Net::Priority::Interactive);
     QString slug = current.slug;
     netJob->addNetAction(Net::ApiDownload::makeByteArray(
         QString("%1modpack/%2?build=%3").arg(BuildConfig.TECHNIC_API_BASE_URL, slug, BuildConfig.TECHNIC_API_BUILD), response));
@@ -254,6 +255,7 @@ void TechnicPage::metadataLoaded()
         ui->versionSelectionBox->addItem(current.currentVersion);
 
         auto netJob = makeShared<NetJob>(QString("Technic::SolderMeta(%1)").arg(current.name), APPLICATION->network());
+        netJob->setPriority(Net::Priority::Interactive);
         auto url = QString("%1/modpack/%2").arg(current.url, current.slug);
         netJob->addNetAction(Net::ApiDownload::makeByteArray(QUrl(url), response));
 
@@ -196,13 +196,7 @@ CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest
         auto qssFilePath = FS::PathCombine(path, m_qssFilePath);
         QFileInfo info(qssFilePath);
         if (info.isFile()) {
-            try {
-                // TODO: validate qss?
-                m_styleSheet = QString::fromUtf8(FS::read(qssFilePath));
-            } catch (const Exception& e) {
-                themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << qssFilePath;
-                return;
-            }
+            m_styleSheetPath = qssFilePath;
         } else {
             themeDebugLog() << "No theme qss present.";
         }
@@ -222,13 +216,8 @@ CustomTheme::CustomTheme(ITheme* baseTheme, QFileInfo& fileInfo, bool isManifest
         }
 
         m_palette = baseTheme->colorScheme();
-        try {
-            // TODO: validate qss?
-            m_styleSheet = QString::fromUtf8(FS::read(path));
-        } catch (const Exception& e) {
-            themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << path;
-            m_styleSheet = baseTheme->appStyleSheet();
-        }
+        m_styleSheetPath = path;
+        m_fallbackTheme = baseTheme;
     }
 }
 
@@ -268,6 +257,17 @@ bool CustomTheme::hasStyleSheet()
 
 QString CustomTheme::appStyleSheet()
 {
+    if (!m_styleSheetLoaded && !m_styleSheetPath.isEmpty()) {
+        m_styleSheetLoaded = true;
+        try {
+            // TODO: validate qss?
+            m_styleSheet = QString::fromUtf8(FS::read(m_styleSheetPath));
+        } catch (const Exception& e) {
+            themeWarningLog() << "Couldn't load qss:" << e.cause() << "from" << m_styleSheetPath;
+            if (m_fallbackTheme)
+                m_styleSheet = m_fallbackTheme->appStyleSheet();
+        }
+    }
     return m_styleSheet;
 }
 
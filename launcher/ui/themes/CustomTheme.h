@@ -58,6 +58,10 @@ class CustomTheme : public ITheme {
     QColor m_fadeColor;
     double m_fadeAmount;
     QString m_styleSheet;
+    // the stylesheet is only read once the theme is applied, themes that are just listed don't need it
+    QString m_styleSheetPath;
+    ITheme* m_fallbackTheme = nullptr;
+    bool m_styleSheetLoaded = false;
     QString m_name;
     QString m_id;
     QString m_widgets;
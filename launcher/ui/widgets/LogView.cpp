@@ -94,6 +94,7 @@ void LogView::repopulate()
 {
     auto doc = document();
     doc->clear();
+    m_removedRows = 0;
     if (!m_model) {
         return;
     }
@@ -117,6 +118,10 @@ void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int la
 
 void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 {
+    // one edit block per batch of rows, so the document layout is only updated once
+    auto workCursor = textCursor();
+    workCursor.beginEditBlock();
+    workCursor.movePosition(QTextCursor::End);
     for (int i = first; i <= last; i++) {
         auto idx = m_model->index(i, 0, parent);
         auto text = m_model->data(idx, Qt::DisplayRole).toString();
@@ -133,11 +138,10 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
         if (bg.isValid()) {
             format.setBackground(bg.value<QColor>());
         }
-        auto workCursor = textCursor();
-        workCursor.movePosition(QTextCursor::End);
         workCursor.insertText(text, format);
         workCursor.insertBlock();
     }
+    workCursor.endEditBlock();
     if (m_scroll && !m_scrolling) {
         m_scrolling = true;
         QMetaObject::invokeMethod(this, "scrollToBottom", Qt::QueuedConnection);
@@ -146,10 +150,9 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 
 void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
 {
-    // TODO: some day... maybe
+    // TODO: some day... maybe actually remove them from the document
     Q_UNUSED(parent)
-    Q_UNUSED(first)
-    Q_UNUSED(last)
+    m_removedRows += last - first + 1;
 }
 
 void LogView::scrollToBottom()
@@ -158,6 +161,26 @@ void LogView::scrollToBottom()
     verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
 }
 
+int LogView::currentRow() const
+{
+    return qMax(textCursor().blockNumber() - m_removedRows, -1);
+}
+
+void LogView::selectMatch(int row, const QString& what)
+{
+    auto block = document()->findBlockByNumber(row + m_removedRows);
+    if (!block.isValid()) {
+        return;
+    }
+    auto cursor = document()->find(what, block.position());
+    if (cursor.isNull() || cursor.block() != block) {
+        // shouldn't happen, select the whole row then
+        cursor = QTextCursor(block);
+        cursor.movePosition(QTextCursor::EndOfBlock, QTextCursor::KeepAnchor);
+    }
+    setTextCursor(cursor);
+}
+
 void LogView::findNext(const QString& what, bool reverse)
 {
     find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
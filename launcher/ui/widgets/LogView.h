@@ -13,6 +13,11 @@ class LogView : public QPlainTextEdit {
     virtual void setModel(QAbstractItemModel* model);
     QAbstractItemModel* model() const;
 
+    /// the model row the text cursor is in, -1 if it's in text that is not in the model anymore
+    int currentRow() const;
+    /// move the cursor to the first occurrence of `what` in the given model row
+    void selectMatch(int row, const QString& what);
+
    public slots:
     void setWordWrap(bool wrapping);
     void findNext(const QString& what, bool reverse);
@@ -32,4 +37,6 @@ class LogView : public QPlainTextEdit {
     QTextCharFormat* m_defaultFormat = nullptr;
     bool m_scroll = false;
     bool m_scrolling = false;
+    // rows removed from the front of the model that are still in the document
+    int m_removedRows = 0;
 };
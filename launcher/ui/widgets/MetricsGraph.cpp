@@ -0,0 +1,94 @@
+#include "MetricsGraph.h"
+
+#include <QPainter>
+#include <QPainterPath>
+
+#include <algorithm>
+
+MetricsGraph::MetricsGraph(const QString& title, QWidget* parent)
+    : QWidget(parent), m_title(title), m_formatter([](double value) { return QString::number(value, 'f', 0); })
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void MetricsGraph::setSeries(QVector<Series> series, double maximum)
+{
+    m_series = std::move(series);
+    m_maximum = maximum;
+    update();
+}
+
+QSize MetricsGraph::sizeHint() const
+{
+    return QSize(400, 140);
+}
+
+QSize MetricsGraph::minimumSizeHint() const
+{
+    return QSize(200, fontMetrics().height() * 5);
+}
+
+void MetricsGraph::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    auto text = palette().color(QPalette::WindowText);
+    auto metrics = fontMetrics();
+    int lineHeight = metrics.height();
+
+    // the title and the last value of each series on top
+    int x = 0;
+    painter.setPen(text);
+    painter.drawText(QPoint(x, metrics.ascent()), m_title);
+    x += metrics.horizontalAdvance(m_title) + lineHeight;
+    double highest = m_maximum;
+    for (auto& series : m_series) {
+        auto label = series.name;
+        if (!series.values.isEmpty())
+            label += ": " + m_formatter(series.values.last());
+        painter.fillRect(QRect(x, (lineHeight - 8) / 2, 8, 8), series.color);
+        x += 12;
+        painter.drawText(QPoint(x, metrics.ascent()), label);
+        x += metrics.horizontalAdvance(label) + lineHeight;
+        if (m_maximum <= 0)
+            for (auto value : series.values)
+                highest = std::max(highest, value);
+    }
+    if (highest <= 0)
+        highest = 1;
+
+    auto topLabel = m_formatter(highest);
+    int axisWidth = std::max(metrics.horizontalAdvance(topLabel), metrics.horizontalAdvance(m_formatter(0))) + 4;
+    QRectF plot(axisWidth, lineHeight + 4, width() - axisWidth - 1, height() - lineHeight - 5);
+    if (plot.width() <= 0 || plot.height() <= 0)
+        return;
+
+    auto grid = text;
+    grid.setAlpha(60);
+    painter.setPen(grid);
+    painter.drawRect(plot);
+    painter.drawLine(QPointF(plot.left(), plot.center().y()), QPointF(plot.right(), plot.center().y()));
+    painter.setPen(text);
+    painter.drawText(QRectF(0, plot.top(), axisWidth - 4, lineHeight), Qt::AlignRight | Qt::AlignTop, topLabel);
+    painter.drawText(QRectF(0, plot.bottom() - lineHeight, axisWidth - 4, lineHeight), Qt::AlignRight | Qt::AlignBottom,
+                     m_formatter(0));
+
+    for (auto& series : m_series) {
+        if (series.values.size() < 2)
+            continue;
+        // the newest on the right edge, one pixel per sample at most
+        auto count = std::min<int>(series.values.size(), static_cast<int>(plot.width()));
+        auto step = plot.width() / std::max(count - 1, 1);
+        QPainterPath path;
+        for (int i = 0; i < count; i++) {
+            auto value = std::clamp(series.values[series.values.size() - count + i], 0.0, highest);
+            QPointF point(plot.left() + i * step, plot.bottom() - value / highest * plot.height());
+            if (i == 0)
+                path.moveTo(point);
+            else
+                path.lineTo(point);
+        }
+        painter.setPen(QPen(series.color, 1.5));
+        painter.drawPath(path);
+    }
+}
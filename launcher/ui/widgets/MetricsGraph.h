@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QColor>
+#include <QVector>
+#include <QWidget>
+
+#include <functional>
+
+/**
+ * A small line graph of a few series over the same samples, with their last values in the legend.
+ *
+ * Just enough to watch the metrics of a running game, without pulling in a chart library.
+ */
+class MetricsGraph : public QWidget {
+    Q_OBJECT
+   public:
+    struct Series {
+        QString name;
+        QColor color;
+        QVector<double> values;
+    };
+
+    explicit MetricsGraph(const QString& title, QWidget* parent = nullptr);
+
+    /// `maximum` is the top of the graph, 0 to fit the highest value
+    void setSeries(QVector<Series> series, double maximum = 0);
+    /// how values read in the legend and on the axis
+    void setFormatter(std::function<QString(double)> formatter) { m_formatter = std::move(formatter); }
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+   protected:
+    void paintEvent(QPaintEvent* event) override;
+
+   private:
+    QString m_title;
+    QVector<Series> m_series;
+    double m_maximum = 0;
+    std::function<QString(double)> m_formatter;
+};
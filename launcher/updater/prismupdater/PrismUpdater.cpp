@@ -25,6 +25,7 @@
 #include "ui/dialogs/ProgressDialog.h"
 
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 
 #include <QDebug>
@@ -74,13 +75,16 @@ namespace fs = ghc::filesystem;
 
 #include "DesktopServices.h"
 
+#include "updater/prismupdater/UpdateManifest.h"
 #include "updater/prismupdater/UpdaterDialogs.h"
 
 #include "FileSystem.h"
 #include "Json.h"
 #include "StringUtils.h"
 
+#include "net/ChecksumValidator.h"
 #include "net/Download.h"
+#include "net/NetJob.h"
 #include "net/RawHeaderProxy.h"
 
 #include "MMCZip.h"
@@ -623,6 +627,37 @@ void PrismUpdaterApp::run()
     exit(0);
 }
 
+namespace {
+// renaming is instant and the backup, the install and the unpacked release usually share a file system,
+// copying is only for when they don't
+bool moveEntry(const QString& from, const QString& to)
+{
+    FS::ensureFilePathExists(to);
+    if (!QFileInfo::exists(to) && QDir().rename(from, to))
+        return true;
+    return FS::copy(from, to).overwrite(true)() && FS::deletePath(from);
+}
+
+// what the globs of a manifest match in `dir`, listed before any of it is moved away
+QStringList matchEntries(const QString& dir, const QStringList& globs, const std::function<void(const QString&)>& missing)
+{
+    QStringList entries;
+    for (auto glob : globs) {
+        QDirIterator iter(dir, QStringList({ glob }), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        if (!iter.hasNext() && !glob.isEmpty()) {
+            if (auto file_info = QFileInfo(FS::PathCombine(dir, glob)); file_info.exists())
+                entries.append(file_info.absoluteFilePath());
+            else
+                missing(FS::PathCombine(dir, glob));
+        } else {
+            while (iter.hasNext())
+                entries.append(iter.next());
+        }
+    }
+    return entries;
+}
+}  // namespace
+
 void PrismUpdaterApp::moveAndFinishUpdate(QDir target)
 {
     logUpdate("Finishing update process");
@@ -660,7 +695,10 @@ void PrismUpdaterApp::moveAndFinishUpdate(QDir target)
 
     bool error = false;
 
-    QProgressDialog progress(tr("Installing from %1").arg(m_rootPath), "", 0, file_list.length());
+    auto entries = matchEntries(m_rootPath, file_list,
+                                [this](const QString& path) { logUpdate(tr("File doesn't exist, ignoring: %1").arg(path)); });
+
+    QProgressDialog progress(tr("Installing from %1").arg(m_rootPath), "", 0, entries.length());
     progress.setCancelButton(nullptr);
     progress.setMinimumWidth(400);
     progress.adjustSize();
@@ -669,42 +707,25 @@ void PrismUpdaterApp::moveAndFinishUpdate(QDir target)
 
     logUpdate(tr("Installing from %1").arg(m_rootPath));
 
-    auto copy = [this, app_dir, target](QString to_install_file) {
+    // what's running right now is moved too, the system keeps it around as long as it's open
+    int i = 0;
+    for (auto& to_install_file : entries) {
+        progress.setValue(i++);
+        QCoreApplication::processEvents();
         auto rel_path = app_dir.relativeFilePath(to_install_file);
         auto install_path = FS::PathCombine(target.absolutePath(), rel_path);
         logUpdate(tr("Installing %1 from %2").arg(install_path).arg(to_install_file));
-        FS::ensureFilePathExists(install_path);
-        auto result = FS::copy(to_install_file, install_path).overwrite(true)();
-        if (!result) {
-            logUpdate(tr("Failed copy %1 to %2").arg(to_install_file).arg(install_path));
-            return true;
-        }
-        return false;
-    };
-
-    int i = 0;
-    for (auto glob : file_list) {
-        QDirIterator iter(m_rootPath, QStringList({ glob }), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-        progress.setValue(i);
-        QCoreApplication::processEvents();
-        if (!iter.hasNext() && !glob.isEmpty()) {
-            if (auto file_info = QFileInfo(FS::PathCombine(m_rootPath, glob)); file_info.exists()) {
-                error |= copy(file_info.absoluteFilePath());
-            } else {
-                logUpdate(tr("File doesn't exist, ignoring: %1").arg(FS::PathCombine(m_rootPath, glob)));
-            }
-        } else {
-            while (iter.hasNext()) {
-                error |= copy(iter.next());
-            }
+        if (!moveEntry(to_install_file, install_path)) {
+            logUpdate(tr("Failed to move %1 to %2").arg(to_install_file).arg(install_path));
+            error = true;
         }
-        i++;
     }
     progress.setValue(i);
     QCoreApplication::processEvents();
 
     if (error) {
         logUpdate(tr("There were errors installing the update."));
+        restoreBackup(target);
         auto fail_marker = FS::PathCombine(m_dataPath, ".prism_launcher_update.fail");
         FS::copy(m_updateLogPath, fail_marker).overwrite(true)();
     } else {
@@ -880,6 +901,13 @@ void PrismUpdaterApp::performUpdate(const GitHubRelease& release)
     }
 
     qDebug() << "will install" << selected_asset;
+    auto asset_name = selected_asset.name.toLower();
+    if (m_isPortable || asset_name.endsWith(".zip") || asset_name.endsWith(".tar.gz")) {
+        // an archive replaces the install, what the install already has doesn't have to be downloaded again
+        if (auto prepared = prepareFromManifest(release, selected_asset))
+            return performInstall(QFileInfo(), prepared);
+    }
+
     auto file = downloadAsset(selected_asset);
 
     if (!file.exists()) {
@@ -889,6 +917,114 @@ void PrismUpdaterApp::performUpdate(const GitHubRelease& release)
     performInstall(file);
 }
 
+/// put together what the archive would unpack to, from the install and only the files that changed, when the release
+/// says what's in the archive. Nothing when it doesn't or when downloading the archive is the cheaper way.
+std::optional<QDir> PrismUpdaterApp::prepareFromManifest(const GitHubRelease& release, const GitHubReleaseAsset& archive)
+{
+    auto findAsset = [&release](const QString& name) -> std::optional<GitHubReleaseAsset> {
+        for (auto& asset : release.assets) {
+            if (asset.name == name)
+                return asset;
+        }
+        return std::nullopt;
+    };
+
+    auto manifest_asset = findAsset(UpdateManifest::assetName(archive.name));
+    if (!manifest_asset) {
+        qDebug() << "No manifest for" << archive.name << "the whole archive will be downloaded";
+        return std::nullopt;
+    }
+
+    UpdateManifest manifest;
+    try {
+        auto manifest_file = downloadAsset(*manifest_asset);
+        manifest = UpdateManifest::parse(FS::read(manifest_file.absoluteFilePath()));
+    } catch (const Exception& e) {
+        logUpdate(tr("Failed to read the update manifest %1: %2").arg(manifest_asset->name, e.cause()));
+        return std::nullopt;
+    }
+
+    auto root = QDir(m_rootPath);
+    auto changed = manifest.changedFiles(root);
+    logUpdate(tr("%1 of the %2 files in %3 differ from this install").arg(changed.size()).arg(manifest.files.size()).arg(archive.name));
+
+    auto staging_path = FS::PathCombine(m_dataPath, "prism_launcher_update_files");
+    FS::deletePath(staging_path);
+    FS::ensureFolderPathExists(staging_path);
+    auto staging = QDir(staging_path);
+    auto isStaged = [&staging](const UpdateManifest::File& file) {
+        return sha256File(staging.absoluteFilePath(file.path)) == file.sha256;
+    };
+
+    // a delta from the installed release has everything that changed in one download
+    if (auto delta = manifest.deltaFrom(Version(m_prismVersion)); delta && !changed.isEmpty()) {
+        auto delta_asset = findAsset(delta->asset);
+        if (delta_asset && delta_asset->size < archive.size) {
+            logUpdate(tr("Downloading the changes since %1 from %2").arg(delta->from, delta_asset->name));
+            auto delta_file = downloadAsset(*delta_asset);
+            if (!delta_file.exists() || !MMCZip::extractDir(delta_file.absoluteFilePath(), staging.absolutePath()))
+                logUpdate(tr("Failed to extract %1").arg(delta_file.absoluteFilePath()));
+        }
+    }
+
+    // what the delta didn't have, or all of it when there's none, comes one file at a time
+    QList<UpdateManifest::File> missing;
+    qint64 missing_size = 0;
+    for (auto& file : changed) {
+        if (isStaged(file))
+            continue;
+        if (file.url.isEmpty()) {
+            logUpdate(tr("%1 can't be downloaded on its own").arg(file.path));
+            return std::nullopt;
+        }
+        missing.append(file);
+        missing_size += qMax<qint64>(file.size, 0);
+    }
+    if (!missing.isEmpty()) {
+        if (missing_size >= archive.size) {
+            logUpdate(tr("The changed files are as big as the archive"));
+            return std::nullopt;
+        }
+        logUpdate(tr("Downloading %1 changed files").arg(missing.size()));
+        auto job = makeShared<NetJob>(tr("Update files"), m_network);
+        for (auto& file : missing) {
+            auto download = Net::Download::makeFile(QUrl(file.url), staging.absoluteFilePath(file.path));
+            download->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha256, QByteArray::fromHex(file.sha256)));
+            job->addNetAction(download);
+        }
+        auto progress_dialog = ProgressDialog();
+        progress_dialog.adjustSize();
+        progress_dialog.execWithTask(job.get());
+        if (!job->wasSuccessful()) {
+            logUpdate(tr("Failed to download the changed files: %1").arg(job->failReason()));
+            return std::nullopt;
+        }
+    }
+
+    // the same tree the archive unpacks to, where the new updater is started from
+    auto release_path = FS::PathCombine(m_dataPath, "prism_launcher_update_release");
+    FS::deletePath(release_path);
+    auto release_dir = QDir(release_path);
+    QSet<QString> changed_paths;
+    for (auto& file : changed)
+        changed_paths.insert(file.path);
+    for (auto& file : manifest.files) {
+        auto from = changed_paths.contains(file.path) ? staging.absoluteFilePath(file.path) : root.absoluteFilePath(file.path);
+        auto to = release_dir.absoluteFilePath(file.path);
+        FS::ensureFilePathExists(to);
+        if (!FS::copy(from, to).overwrite(true)()) {
+            logUpdate(tr("Failed to copy %1 to %2").arg(from, to));
+            return std::nullopt;
+        }
+        // zips don't keep whether a file is executable, the installed one knows
+        if (auto installed = root.absoluteFilePath(file.path); changed_paths.contains(file.path) && QFileInfo::exists(installed))
+            QFile::setPermissions(to, QFile::permissions(installed));
+    }
+    FS::deletePath(staging_path);
+    logUpdate(tr("Put together %1 in %2 from this install and the changed files").arg(archive.name, release_path));
+    return release_dir;
+}
+
 QFileInfo PrismUpdaterApp::downloadAsset(const GitHubReleaseAsset& asset)
 {
     auto temp_dir = QDir::tempPath();
@@ -896,7 +1032,7 @@ QFileInfo PrismUpdaterApp::downloadAsset(const GitHubReleaseAsset& asset)
     auto out_file_path = FS::PathCombine(temp_dir, file_url.fileName());
 
     qDebug() << "downloading" << file_url << "to" << out_file_path;
-    auto download = Net::Download::makeFile(file_url, out_file_path);
+    auto download = Net::Download::makeFile(file_url, out_file_path, Net::Download::Option::Resumable);
     download->setNetwork(m_network);
     auto progress_dialog = ProgressDialog();
     progress_dialog.adjustSize();
@@ -978,7 +1114,7 @@ bool write_lock_file(const QString& path, QDateTime timestamp, QString from, QSt
     return true;
 }
 
-void PrismUpdaterApp::performInstall(QFileInfo file)
+void PrismUpdaterApp::performInstall(QFileInfo file, std::optional<QDir> prepared)
 {
     qDebug() << "starting install";
     auto update_lock_path = FS::PathCombine(m_dataPath, ".prism_launcher_update.lock");
@@ -1026,10 +1162,13 @@ void PrismUpdaterApp::performInstall(QFileInfo file)
     FS::write(changelog_path, m_install_release.body.toUtf8());
 
     logUpdate(tr("Updating from %1 to %2").arg(m_prismVersion).arg(m_install_release.tag_name));
-    if (m_isPortable || file.suffix().toLower() == "zip") {
+    if (prepared || m_isPortable || file.suffix().toLower() == "zip") {
         write_lock_file(update_lock_path, QDateTime::currentDateTime(), m_prismVersion, m_install_release.tag_name, m_rootPath, m_dataPath);
         logUpdate(tr("Updating portable install at %1").arg(m_rootPath));
-        unpackAndInstall(file);
+        if (prepared)
+            installFrom(*prepared);
+        else
+            unpackAndInstall(file);
     } else {
         logUpdate(tr("Running installer file at %1").arg(file.absoluteFilePath()));
         QProcess proc = QProcess();
@@ -1046,36 +1185,40 @@ void PrismUpdaterApp::performInstall(QFileInfo file)
 }
 
 void PrismUpdaterApp::unpackAndInstall(QFileInfo archive)
+{
+    if (auto loc = unpackArchive(archive))
+        return installFrom(loc.value());
+    return exit(1);  // unpack failure
+}
+
+void PrismUpdaterApp::installFrom(QDir release_dir)
 {
     logUpdate(tr("Backing up install"));
     backupAppDir();
 
-    if (auto loc = unpackArchive(archive)) {
-        auto marker_file_path = loc.value().absoluteFilePath(".prism_launcher_updater_unpack.marker");
-        FS::write(marker_file_path, m_rootPath.toUtf8());
+    auto marker_file_path = release_dir.absoluteFilePath(".prism_launcher_updater_unpack.marker");
+    FS::write(marker_file_path, m_rootPath.toUtf8());
 
-        QProcess proc = QProcess();
+    QProcess proc = QProcess();
 
-        auto exe_name = QStringLiteral("%1_updater").arg(BuildConfig.LAUNCHER_APP_BINARY_NAME);
+    auto exe_name = QStringLiteral("%1_updater").arg(BuildConfig.LAUNCHER_APP_BINARY_NAME);
 #if defined Q_OS_WIN32
-        exe_name.append(".exe");
+    exe_name.append(".exe");
 
-        auto env = QProcessEnvironment::systemEnvironment();
-        env.insert("__COMPAT_LAYER", "RUNASINVOKER");
-        proc.setProcessEnvironment(env);
+    auto env = QProcessEnvironment::systemEnvironment();
+    env.insert("__COMPAT_LAYER", "RUNASINVOKER");
+    proc.setProcessEnvironment(env);
 #else
-        exe_name.prepend("bin/");
+    exe_name.prepend("bin/");
 #endif
 
-        auto new_updater_path = loc.value().absoluteFilePath(exe_name);
-        logUpdate(tr("Starting new updater at '%1'").arg(new_updater_path));
-        if (!proc.startDetached(new_updater_path, { "-d", m_dataPath }, loc.value().absolutePath())) {
-            logUpdate(tr("Failed to launch '%1' %2").arg(new_updater_path).arg(proc.errorString()));
-            return exit(10);
-        }
-        return exit();  // up to the new updater now
+    auto new_updater_path = release_dir.absoluteFilePath(exe_name);
+    logUpdate(tr("Starting new updater at '%1'").arg(new_updater_path));
+    if (!proc.startDetached(new_updater_path, { "-d", m_dataPath }, release_dir.absolutePath())) {
+        logUpdate(tr("Failed to launch '%1' %2").arg(new_updater_path).arg(proc.errorString()));
+        return exit(10);
     }
-    return exit(1);  // unpack failure
+    return exit();  // up to the new updater now
 }
 
 void PrismUpdaterApp::backupAppDir()
@@ -1132,7 +1275,10 @@ void PrismUpdaterApp::backupAppDir()
     auto backup_marker_path = FS::PathCombine(m_dataPath, ".prism_launcher_update_backup_path.txt");
     FS::write(backup_marker_path, backup_dir.toUtf8());
 
-    QProgressDialog progress(tr("Backing up install at %1").arg(m_rootPath), "", 0, file_list.length());
+    auto entries = matchEntries(app_dir.absolutePath(), file_list,
+                                [this](const QString& path) { logUpdate(tr("File doesn't exist, ignoring: %1").arg(path)); });
+
+    QProgressDialog progress(tr("Backing up install at %1").arg(m_rootPath), "", 0, entries.length());
     progress.setCancelButton(nullptr);
     progress.setMinimumWidth(400);
     progress.adjustSize();
@@ -1141,42 +1287,45 @@ void PrismUpdaterApp::backupAppDir()
 
     logUpdate(tr("Backing up install at %1").arg(m_rootPath));
 
-    auto copy = [this, app_dir, backup_dir](QString to_bak_file) {
+    // only what the update replaces is in the list, caches and the like stay where they are
+    int i = 0;
+    for (auto& to_bak_file : entries) {
+        progress.setValue(i++);
+        QCoreApplication::processEvents();
         auto rel_path = app_dir.relativeFilePath(to_bak_file);
         auto bak_path = FS::PathCombine(backup_dir, rel_path);
-        logUpdate(tr("Backing up and then removing %1").arg(to_bak_file));
-        FS::ensureFilePathExists(bak_path);
-        auto result = FS::copy(to_bak_file, bak_path).overwrite(true)();
-        if (!result) {
+        logUpdate(tr("Moving %1 to the backup").arg(to_bak_file));
+        if (!moveEntry(to_bak_file, bak_path))
             logUpdate(tr("Failed to backup %1 to %2").arg(to_bak_file).arg(bak_path));
-        } else {
-            if (!FS::deletePath(to_bak_file))
-                logUpdate(tr("Failed to remove %1").arg(to_bak_file));
-        }
-    };
-
-    int i = 0;
-    for (auto glob : file_list) {
-        QDirIterator iter(app_dir.absolutePath(), QStringList({ glob }), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-        progress.setValue(i);
-        QCoreApplication::processEvents();
-        if (!iter.hasNext() && !glob.isEmpty()) {
-            if (auto file_info = QFileInfo(FS::PathCombine(app_dir.absolutePath(), glob)); file_info.exists()) {
-                copy(file_info.absoluteFilePath());
-            } else {
-                logUpdate(tr("File doesn't exist, ignoring: %1").arg(FS::PathCombine(app_dir.absolutePath(), glob)));
-            }
-        } else {
-            while (iter.hasNext()) {
-                copy(iter.next());
-            }
-        }
-        i++;
     }
     progress.setValue(i);
     QCoreApplication::processEvents();
 }
 
+/// put what backupAppDir() moved away back into `target`, over whatever the failed update left there
+void PrismUpdaterApp::restoreBackup(QDir target)
+{
+    auto backup_marker_path = FS::PathCombine(m_dataPath, ".prism_launcher_update_backup_path.txt");
+    QString backup_path;
+    try {
+        backup_path = QString::fromUtf8(FS::read(backup_marker_path)).trimmed();
+    } catch (FS::FileSystemException&) {
+    }
+    if (backup_path.isEmpty() || !QFileInfo(backup_path).isDir()) {
+        logUpdate(tr("No backup to restore"));
+        return;
+    }
+
+    logUpdate(tr("Restoring the backup at %1").arg(backup_path));
+    auto backup_dir = QDir(backup_path);
+    for (auto& entry : backup_dir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs | QDir::Hidden)) {
+        auto restore_path = target.absoluteFilePath(entry.fileName());
+        FS::deletePath(restore_path);
+        if (!moveEntry(entry.absoluteFilePath(), restore_path))
+            logUpdate(tr("Failed to restore %1 to %2").arg(entry.absoluteFilePath()).arg(restore_path));
+    }
+}
+
 std::optional<QDir> PrismUpdaterApp::unpackArchive(QFileInfo archive)
 {
     auto temp_extract_path = FS::PathCombine(m_dataPath, "prism_launcher_update_release");
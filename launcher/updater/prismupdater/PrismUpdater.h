@@ -78,9 +78,12 @@ class PrismUpdaterApp : public QApplication {
     QList<GitHubReleaseAsset> validReleaseArtifacts(const GitHubRelease& release);
     GitHubReleaseAsset selectAsset(const QList<GitHubReleaseAsset>& assets);
     void performUpdate(const GitHubRelease& release);
-    void performInstall(QFileInfo file);
+    std::optional<QDir> prepareFromManifest(const GitHubRelease& release, const GitHubReleaseAsset& archive);
+    void performInstall(QFileInfo file, std::optional<QDir> prepared = std::nullopt);
     void unpackAndInstall(QFileInfo file);
+    void installFrom(QDir release_dir);
     void backupAppDir();
+    void restoreBackup(QDir target);
     std::optional<QDir> unpackArchive(QFileInfo file);
 
     QFileInfo downloadAsset(const GitHubReleaseAsset& asset);
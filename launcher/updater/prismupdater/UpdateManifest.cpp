@@ -0,0 +1,77 @@
+#include "UpdateManifest.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+
+#include "Json.h"
+
+namespace {
+// the manifest comes from the network, it doesn't get to write outside of the install
+bool isSafePath(const QString& path)
+{
+    if (path.isEmpty() || QDir::isAbsolutePath(path) || path.contains('\\'))
+        return false;
+    return !path.split('/').contains("..");
+}
+}  // namespace
+
+UpdateManifest UpdateManifest::parse(const QByteArray& data)
+{
+    auto obj = Json::requireObject(Json::requireDocument(data, "Update manifest"), "Update manifest");
+
+    UpdateManifest manifest;
+    for (auto value : Json::requireArray(obj, "files")) {
+        auto file_obj = Json::requireObject(value);
+        File file;
+        file.path = Json::requireString(file_obj, "path");
+        if (!isSafePath(file.path))
+            throw Json::JsonException(QString("Invalid path in the update manifest: %1").arg(file.path));
+        file.sha256 = Json::requireString(file_obj, "sha256").toLower().toLatin1();
+        file.size = static_cast<qint64>(Json::ensureDouble(file_obj, "size", -1));
+        file.url = Json::ensureString(file_obj, "url");
+        manifest.files.append(file);
+    }
+    for (auto value : Json::ensureArray(obj, "deltas")) {
+        auto delta_obj = Json::requireObject(value);
+        Delta delta;
+        delta.from = Json::requireString(delta_obj, "from");
+        delta.asset = Json::requireString(delta_obj, "asset");
+        delta.size = static_cast<qint64>(Json::ensureDouble(delta_obj, "size", -1));
+        manifest.deltas.append(delta);
+    }
+    return manifest;
+}
+
+QList<UpdateManifest::File> UpdateManifest::changedFiles(const QDir& root) const
+{
+    QList<File> changed;
+    for (auto& file : files) {
+        auto local_path = root.absoluteFilePath(file.path);
+        QFileInfo local(local_path);
+        // the size is much cheaper to get than the hash, and usually tells already
+        if (!local.isFile() || (file.size >= 0 && local.size() != file.size) || sha256File(local_path) != file.sha256)
+            changed.append(file);
+    }
+    return changed;
+}
+
+std::optional<UpdateManifest::Delta> UpdateManifest::deltaFrom(const Version& version) const
+{
+    for (auto& delta : deltas) {
+        if (Version(delta.from) == version)
+            return delta;
+    }
+    return std::nullopt;
+}
+
+QByteArray sha256File(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file))
+        return {};
+    return hash.result().toHex();
+}
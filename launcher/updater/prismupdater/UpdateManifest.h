@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QList>
+#include <QString>
+
+#include <optional>
+
+#include "Version.h"
+
+/**
+ * What a release archive holds, file by file, published next to the archive as "<archive>.manifest.json".
+ *
+ * With it the updater only has to fetch what differs from the install it updates: the files that changed come either
+ * from a delta, a zip published with the release that holds what changed since an earlier one, or one by one from
+ * where the manifest says they are. Everything else is taken from the current install once its hash matches.
+ */
+struct UpdateManifest {
+    struct File {
+        /// relative to the root of the install, with forward slashes
+        QString path;
+        /// hex
+        QByteArray sha256;
+        qint64 size = -1;
+        /// where the file alone can be downloaded, empty if it can't be
+        QString url;
+    };
+    struct Delta {
+        /// tag of the release this updates from
+        QString from;
+        /// name of the release asset
+        QString asset;
+        qint64 size = -1;
+    };
+
+    QList<File> files;
+    QList<Delta> deltas;
+
+    /// @throw Json::JsonException
+    static UpdateManifest parse(const QByteArray& data);
+
+    static QString assetName(const QString& archive_name) { return archive_name + ".manifest.json"; }
+
+    /// the files `root` doesn't have the way this release has them
+    QList<File> changedFiles(const QDir& root) const;
+    /// the delta that updates from `version`, if there is one
+    std::optional<Delta> deltaFrom(const Version& version) const;
+};
+
+/// sha256 of the file at `path` in hex, empty if it can't be read
+QByteArray sha256File(const QString& path);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QMap>
 #include <QNetworkRequest>
 #include <QObject>
@@ -8,10 +9,15 @@
 #include <QTimer>
 
 class QNetworkAccessManager;
+class QNetworkReply;
 
 namespace Katabasis {
 
 /// Poll an authorization server for token
+///
+/// The interval is kept between the starts of the requests, so the time each one takes doesn't add up over a long
+/// wait, and there's never more than one in flight. The requests go through the manager it's given, which keeps its
+/// connection to the server open between them. Only the end of the polling is reported.
 class PollServer : public QObject {
     Q_OBJECT
 
@@ -40,12 +46,19 @@ class PollServer : public QObject {
     void onReplyFinished();
 
    protected:
+    /// start the next poll once the interval since the last one is over
+    void scheduleNext();
+
     QNetworkAccessManager* manager_;
     const QNetworkRequest request_;
     const QByteArray payload_;
     const int expiresIn_;
     QTimer expirationTimer;
     QTimer pollTimer;
+    // seconds between the starts of two requests
+    int interval_ = 5;
+    QElapsedTimer sinceRequest_;
+    QNetworkReply* reply_ = nullptr;
 };
 
 }  // namespace Katabasis
@@ -27,42 +27,61 @@ PollServer::PollServer(QNetworkAccessManager* manager,
     expirationTimer.setTimerType(Qt::VeryCoarseTimer);
     expirationTimer.setInterval(expiresIn * 1000);
     expirationTimer.setSingleShot(true);
-    connect(&expirationTimer, SIGNAL(timeout()), this, SLOT(onExpiration()));
+    connect(&expirationTimer, &QTimer::timeout, this, &PollServer::onExpiration);
     expirationTimer.start();
 
-    pollTimer.setTimerType(Qt::VeryCoarseTimer);
-    pollTimer.setInterval(5 * 1000);
+    // a coarse timer may fire a little early, which the server answers with slow_down
+    pollTimer.setTimerType(Qt::PreciseTimer);
     pollTimer.setSingleShot(true);
-    connect(&pollTimer, SIGNAL(timeout()), this, SLOT(onPollTimeout()));
+    connect(&pollTimer, &QTimer::timeout, this, &PollServer::onPollTimeout);
 }
 
 int PollServer::interval() const
 {
-    return pollTimer.interval() / 1000;
+    return interval_;
 }
 
 void PollServer::setInterval(int interval)
 {
-    pollTimer.setInterval(interval * 1000);
+    interval_ = interval;
 }
 
 void PollServer::startPolling()
 {
     if (expirationTimer.isActive()) {
-        pollTimer.start();
+        scheduleNext();
     }
 }
 
+void PollServer::scheduleNext()
+{
+    qint64 wait = interval_ * 1000LL;
+    if (sinceRequest_.isValid()) {
+        wait -= sinceRequest_.elapsed();
+    }
+    pollTimer.start(static_cast<int>(qMax<qint64>(0, wait)));
+}
+
 void PollServer::onPollTimeout()
 {
+    if (reply_) {
+        return;
+    }
     qDebug() << "PollServer::onPollTimeout: retrying";
-    QNetworkReply* reply = manager_->post(request_, payload_);
-    connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+    sinceRequest_.start();
+    reply_ = manager_->post(request_, payload_);
+    connect(reply_, &QNetworkReply::finished, this, &PollServer::onReplyFinished);
 }
 
 void PollServer::onExpiration()
 {
     pollTimer.stop();
+    if (reply_) {
+        reply_->disconnect(this);
+        reply_->abort();
+        reply_->deleteLater();
+        reply_ = nullptr;
+    }
     emit serverClosed(false);
 }
 
@@ -74,6 +93,8 @@ void PollServer::onReplyFinished()
         qDebug() << "PollServer::onReplyFinished: reply is null";
         return;
     }
+    reply_ = nullptr;
+    reply->deleteLater();
 
     QByteArray replyData = reply->readAll();
     QMap<QString, QString> params = toVerificationParams(parseJsonResponse(replyData));
@@ -83,36 +104,35 @@ void PollServer::onReplyFinished()
     // qDebug() << "PollServer::onReplyFinished: replyData\n";
     // qDebug() << QString( replyData );
 
-    if (reply->error() == QNetworkReply::TimeoutError) {
+    QString error = params.value("error");
+    if (reply->error() == QNetworkReply::TimeoutError || (reply->error() != QNetworkReply::NoError && params.isEmpty())) {
         // rfc8628#section-3.2
         // "On encountering a connection timeout, clients MUST unilaterally
         // reduce their polling frequency before retrying.  The use of an
         // exponential backoff algorithm to achieve this, such as doubling the
         // polling interval on each such connection timeout, is RECOMMENDED."
+        // The same goes for the connection failing without the server answering, that isn't the end of the flow.
+        qDebug() << "PollServer::onReplyFinished: no answer, backing off:" << reply->errorString();
         setInterval(interval() * 2);
-        pollTimer.start();
+        scheduleNext();
+    } else if (error == "slow_down") {
+        // rfc8628#section-3.2
+        // "A variant of 'authorization_pending', the authorization request is
+        // still pending and polling should continue, but the interval MUST
+        // be increased by 5 seconds for this and all subsequent requests."
+        setInterval(interval() + 5);
+        scheduleNext();
+    } else if (error == "authorization_pending") {
+        // keep trying - rfc8628#section-3.2
+        // "The authorization request is still pending as the end user hasn't
+        // yet completed the user-interaction steps (Section 3.3)."
+        scheduleNext();
     } else {
-        QString error = params.value("error");
-        if (error == "slow_down") {
-            // rfc8628#section-3.2
-            // "A variant of 'authorization_pending', the authorization request is
-            // still pending and polling should continue, but the interval MUST
-            // be increased by 5 seconds for this and all subsequent requests."
-            setInterval(interval() + 5);
-            pollTimer.start();
-        } else if (error == "authorization_pending") {
-            // keep trying - rfc8628#section-3.2
-            // "The authorization request is still pending as the end user hasn't
-            // yet completed the user-interaction steps (Section 3.3)."
-            pollTimer.start();
-        } else {
-            expirationTimer.stop();
-            emit serverClosed(true);
-            // let O2 handle the other cases
-            emit verificationReceived(params);
-        }
+        expirationTimer.stop();
+        emit serverClosed(true);
+        // let O2 handle the other cases
+        emit verificationReceived(params);
     }
-    reply->deleteLater();
 }
 
 }  // namespace Katabasis
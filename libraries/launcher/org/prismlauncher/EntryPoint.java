@@ -58,6 +58,7 @@ import org.prismlauncher.exception.ParseException;
 import org.prismlauncher.launcher.Launcher;
 import org.prismlauncher.launcher.impl.StandardLauncher;
 import org.prismlauncher.legacy.LegacyProxy;
+import org.prismlauncher.utils.MetricsReporter;
 import org.prismlauncher.utils.Parameters;
 import org.prismlauncher.utils.logging.Log;
 
@@ -106,6 +107,7 @@ public final class EntryPoint {
         }
 
         setProperties(params);
+        MetricsReporter.start(params);
 
         String launcherType = params.getString("launcher");
 
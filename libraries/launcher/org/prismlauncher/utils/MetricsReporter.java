@@ -0,0 +1,125 @@
+package org.prismlauncher.utils;
+
+import org.prismlauncher.utils.logging.Log;
+
+import java.io.BufferedWriter;
+import java.io.IOException;
+import java.io.OutputStreamWriter;
+import java.io.Writer;
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryUsage;
+import java.lang.management.OperatingSystemMXBean;
+import java.lang.reflect.Method;
+import java.net.InetAddress;
+import java.net.Socket;
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Reports heap usage, garbage collections, CPU load and thread count of the game
+ * to the launcher, over the local socket it listens on.
+ * <p>
+ * Samples are taken once a second and sent a few at a time, so the game barely
+ * notices.
+ */
+public final class MetricsReporter implements Runnable {
+    private static final long SAMPLE_INTERVAL = 1000;
+    private static final int SAMPLES_PER_BATCH = 5;
+
+    private final int port;
+    private final String token;
+    // com.sun.management has the process CPU load, but not every JVM has it
+    private final Method processCpuLoad;
+
+    private MetricsReporter(int port, String token) {
+        this.port = port;
+        this.token = token;
+
+        Method method = null;
+
+        try {
+            Class<?> bean = Class.forName("com.sun.management.OperatingSystemMXBean");
+
+            if (bean.isInstance(ManagementFactory.getOperatingSystemMXBean()))
+                method = bean.getMethod("getProcessCpuLoad");
+        } catch (Throwable ignored) {
+        }
+
+        processCpuLoad = method;
+    }
+
+    /**
+     * Starts reporting if the launcher asked for it with <code>metricsPort</code>.
+     */
+    public static void start(Parameters params) {
+        String port = params.getString("metricsPort", null);
+
+        if (port == null)
+            return;
+
+        try {
+            Thread thread = new Thread(new MetricsReporter(Integer.parseInt(port), params.getString("metricsToken", "")),
+                    "Launcher metrics reporter");
+            thread.setDaemon(true);
+            thread.setPriority(Thread.MIN_PRIORITY);
+            thread.start();
+        } catch (NumberFormatException e) {
+            Log.warning("Invalid metrics port: " + port);
+        }
+    }
+
+    @Override
+    public void run() {
+        try (Socket socket = new Socket(InetAddress.getLoopbackAddress(), port);
+                Writer writer = new BufferedWriter(new OutputStreamWriter(socket.getOutputStream(), StandardCharsets.UTF_8))) {
+            writer.write("hello " + token + "\n");
+            writer.flush();
+
+            int pending = 0;
+
+            while (true) {
+                writer.write(sample());
+
+                if (++pending == SAMPLES_PER_BATCH) {
+                    writer.flush();
+                    pending = 0;
+                }
+
+                Thread.sleep(SAMPLE_INTERVAL);
+            }
+        } catch (IOException e) {
+            // the launcher went away, nobody's listening any more
+            Log.debug("Stopped reporting metrics: " + e);
+        } catch (InterruptedException ignored) {
+        }
+    }
+
+    private String sample() {
+        MemoryUsage heap = ManagementFactory.getMemoryMXBean().getHeapMemoryUsage();
+
+        long collections = 0;
+        long collectionTime = 0;
+
+        for (GarbageCollectorMXBean collector : ManagementFactory.getGarbageCollectorMXBeans()) {
+            collections += Math.max(collector.getCollectionCount(), 0);
+            collectionTime += Math.max(collector.getCollectionTime(), 0);
+        }
+
+        return "sample " + ManagementFactory.getRuntimeMXBean().getUptime() + ' ' + heap.getUsed() + ' ' + heap.getCommitted() + ' '
+                + heap.getMax() + ' ' + collections + ' ' + collectionTime + ' ' + cpuLoad() + ' '
+                + ManagementFactory.getThreadMXBean().getThreadCount() + '\n';
+    }
+
+    private double cpuLoad() {
+        OperatingSystemMXBean os = ManagementFactory.getOperatingSystemMXBean();
+
+        if (processCpuLoad == null)
+            return -1;
+
+        try {
+            return ((Number) processCpuLoad.invoke(os)).doubleValue();
+        } catch (Throwable e) {
+            return -1;
+        }
+    }
+}
@@ -68,6 +68,69 @@ uint32_t MurmurHash2(std::ifstream&& file_stream, std::size_t buffer_size, std::
     return info.h;
 }
 
+uint32_t MurmurHash2(const char* data, std::size_t size, std::function<bool(char)> filter_out)
+{
+    MurmurHash2_Incremental hash(MurmurHash2_FilteredSize(data, size, filter_out));
+    hash.feed(data, size, filter_out);
+    return hash.finish();
+}
+
+uint32_t MurmurHash2_FilteredSize(const char* data, std::size_t size, const std::function<bool(char)>& filter_out)
+{
+    uint32_t filtered_size = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        if (!filter_out(data[i]))
+            filtered_size += 1;
+    }
+    return filtered_size;
+}
+
+// This forces a seed of 1.
+MurmurHash2_Incremental::MurmurHash2_Incremental(uint32_t size) : m_info{ (uint32_t)1 ^ size, size } {}
+
+void MurmurHash2_Incremental::feed(const char* data, std::size_t size, const std::function<bool(char)>& filter_out)
+{
+    for (std::size_t i = 0; i < size; i++) {
+        char c = data[i];
+
+        if (filter_out(c))
+            continue;
+
+        m_pending[m_index] = c;
+        m_index = (m_index + 1) % 4;
+
+        // Mix 4 bytes at a time into the hash
+        if (m_index == 0)
+            FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&m_pending), m_info);
+    }
+}
+
+void MurmurHash2_Incremental::feed(const char* data, std::size_t size)
+{
+    std::size_t i = 0;
+
+    // Top up what was left over from the previous piece
+    while (m_index != 0 && i < size) {
+        m_pending[m_index] = data[i++];
+        m_index = (m_index + 1) % 4;
+        if (m_index == 0)
+            FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&m_pending), m_info);
+    }
+
+    for (; i + 4 <= size; i += 4)
+        FourBytes_MurmurHash2(reinterpret_cast<const unsigned char*>(data + i), m_info);
+
+    while (i < size)
+        m_pending[m_index++] = data[i++];
+}
+
+uint32_t MurmurHash2_Incremental::finish()
+{
+    // Do one last bit shuffle in the hash
+    FourBytes_MurmurHash2(reinterpret_cast<unsigned char*>(&m_pending), m_info);
+    return m_info.h;
+}
+
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
 {
     if (prev.len >= 4) {
@@ -23,6 +23,12 @@ uint32_t MurmurHash2(
     std::size_t buffer_size = 4 * MiB,
     std::function<bool(char)> filter_out = [](char) { return false; });
 
+// Same as above, over data that's already in memory, so a single pass over the file is enough
+uint32_t MurmurHash2(const char* data, std::size_t size, std::function<bool(char)> filter_out = [](char) { return false; });
+
+// Number of bytes of the buffer that filter_out keeps, needed upfront to seed an incremental hash
+uint32_t MurmurHash2_FilteredSize(const char* data, std::size_t size, const std::function<bool(char)>& filter_out);
+
 struct IncrementalHashInfo {
     uint32_t h;
     uint32_t len;
@@ -30,4 +36,28 @@ struct IncrementalHashInfo {
 
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev);
 
+// Hash data that comes in pieces, fed in order, out of `size` bytes in total after filtering
+class MurmurHash2_Incremental {
+   public:
+    explicit MurmurHash2_Incremental(uint32_t size);
+
+    void feed(const char* data, std::size_t size, const std::function<bool(char)>& filter_out);
+    // feed data that's already filtered
+    void feed(const char* data, std::size_t size);
+    uint32_t finish();
+
+   private:
+    IncrementalHashInfo m_info;
+    char m_pending[4];
+    int m_index = 0;
+};
+
+// CurseForge fingerprints skip whitespace, that is bytes 9, 10, 13 and 32. These two do it with SIMD where the CPU
+// has it (AVX2 or SSE2 on x86, NEON on ARM64), and fall back to plain loops elsewhere.
+
+// Number of bytes in the buffer that aren't whitespace
+uint32_t MurmurHash2_CountNonWhitespace(const char* data, std::size_t size);
+// Copy every byte that isn't whitespace to out, which must be at least as big as the input. Returns how many were copied
+std::size_t MurmurHash2_StripWhitespace(const char* data, std::size_t size, char* out);
+
 //-----------------------------------------------------------------------------
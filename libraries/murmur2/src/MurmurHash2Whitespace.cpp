@@ -0,0 +1,246 @@
+//-----------------------------------------------------------------------------
+// Whitespace filtering for CurseForge fingerprints.
+// Placed in the public domain, like the rest of this library. The author hereby
+// disclaims copyright to this source code.
+
+#include "MurmurHash2.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define MURMUR2_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 is picked at runtime, so builds still run on older CPUs
+#define MURMUR2_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MURMUR2_NEON
+#include <arm_neon.h>
+#endif
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
+inline bool is_whitespace(char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+inline int popcount(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    int count = 0;
+    for (; mask; mask &= mask - 1)
+        count++;
+    return count;
+#endif
+}
+
+inline int lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    for (; !(mask & 1); mask >>= 1)
+        bit++;
+    return bit;
+#endif
+}
+
+std::size_t count_whitespace_scalar(const char* data, std::size_t size)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < size; i++)
+        count += is_whitespace(data[i]);
+    return count;
+}
+
+// Branchless, every byte is written and the output only advances past the ones we keep
+std::size_t strip_whitespace_scalar(const char* data, std::size_t size, char* out)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        out[kept] = data[i];
+        kept += !is_whitespace(data[i]);
+    }
+    return kept;
+}
+
+#ifdef MURMUR2_SSE2
+
+// Copy a block given the mask of its whitespace bytes, run by run since there are usually only one or two of them
+std::size_t strip_whitespace_masked(const char* data, int size, uint32_t mask, char* out)
+{
+    std::size_t kept = 0;
+    int start = 0;
+    for (; mask; mask &= mask - 1) {
+        int end = lowest_bit(mask);
+        std::memcpy(out + kept, data + start, end - start);
+        kept += end - start;
+        start = end + 1;
+    }
+    std::memcpy(out + kept, data + start, size - start);
+    return kept + size - start;
+}
+
+inline __m128i whitespace_sse2(__m128i v)
+{
+    auto tab = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(9)), _mm_cmpeq_epi8(v, _mm_set1_epi8(10)));
+    auto cr_space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(13)), _mm_cmpeq_epi8(v, _mm_set1_epi8(32)));
+    return _mm_or_si128(tab, cr_space);
+}
+
+std::size_t count_whitespace_sse2(const char* data, std::size_t size)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        count += popcount(static_cast<uint32_t>(_mm_movemask_epi8(whitespace_sse2(v))));
+    }
+    return count + count_whitespace_scalar(data + i, size - i);
+}
+
+std::size_t strip_whitespace_sse2(const char* data, std::size_t size, char* out)
+{
+    std::size_t kept = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(whitespace_sse2(v)));
+        if (mask == 0) {
+            // The common case in a compressed jar, nothing to drop
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + kept), v);
+            kept += 16;
+        } else {
+            kept += strip_whitespace_masked(data + i, 16, mask, out + kept);
+        }
+    }
+    return kept + strip_whitespace_scalar(data + i, size - i, out + kept);
+}
+
+#endif
+
+#ifdef MURMUR2_AVX2
+
+__attribute__((target("avx2"))) inline __m256i whitespace_avx2(__m256i v)
+{
+    auto tab = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(9)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(10)));
+    auto cr_space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(13)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(32)));
+    return _mm256_or_si256(tab, cr_space);
+}
+
+__attribute__((target("avx2"))) std::size_t count_whitespace_avx2(const char* data, std::size_t size)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        count += popcount(static_cast<uint32_t>(_mm256_movemask_epi8(whitespace_avx2(v))));
+    }
+    return count + count_whitespace_sse2(data + i, size - i);
+}
+
+__attribute__((target("avx2"))) std::size_t strip_whitespace_avx2(const char* data, std::size_t size, char* out)
+{
+    std::size_t kept = 0;
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(whitespace_avx2(v)));
+        if (mask == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + kept), v);
+            kept += 32;
+        } else {
+            kept += strip_whitespace_masked(data + i, 32, mask, out + kept);
+        }
+    }
+    return kept + strip_whitespace_sse2(data + i, size - i, out + kept);
+}
+
+bool has_avx2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif
+
+#ifdef MURMUR2_NEON
+
+inline uint8x16_t whitespace_neon(uint8x16_t v)
+{
+    auto tab = vorrq_u8(vceqq_u8(v, vdupq_n_u8(9)), vceqq_u8(v, vdupq_n_u8(10)));
+    auto cr_space = vorrq_u8(vceqq_u8(v, vdupq_n_u8(13)), vceqq_u8(v, vdupq_n_u8(32)));
+    return vorrq_u8(tab, cr_space);
+}
+
+std::size_t count_whitespace_neon(const char* data, std::size_t size)
+{
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        // Matches are 0xFF, turn them into ones and add them up
+        count += vaddvq_u8(vshrq_n_u8(whitespace_neon(v), 7));
+    }
+    return count + count_whitespace_scalar(data + i, size - i);
+}
+
+std::size_t strip_whitespace_neon(const char* data, std::size_t size, char* out)
+{
+    std::size_t kept = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        if (vmaxvq_u8(whitespace_neon(v)) == 0) {
+            vst1q_u8(reinterpret_cast<uint8_t*>(out + kept), v);
+            kept += 16;
+        } else {
+            kept += strip_whitespace_scalar(data + i, 16, out + kept);
+        }
+    }
+    return kept + strip_whitespace_scalar(data + i, size - i, out + kept);
+}
+
+#endif
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+
+uint32_t MurmurHash2_CountNonWhitespace(const char* data, std::size_t size)
+{
+#if defined(MURMUR2_AVX2)
+    if (has_avx2())
+        return static_cast<uint32_t>(size - count_whitespace_avx2(data, size));
+#endif
+#if defined(MURMUR2_SSE2)
+    return static_cast<uint32_t>(size - count_whitespace_sse2(data, size));
+#elif defined(MURMUR2_NEON)
+    return static_cast<uint32_t>(size - count_whitespace_neon(data, size));
+#else
+    return static_cast<uint32_t>(size - count_whitespace_scalar(data, size));
+#endif
+}
+
+std::size_t MurmurHash2_StripWhitespace(const char* data, std::size_t size, char* out)
+{
+#if defined(MURMUR2_AVX2)
+    if (has_avx2())
+        return strip_whitespace_avx2(data, size, out);
+#endif
+#if defined(MURMUR2_SSE2)
+    return strip_whitespace_sse2(data, size, out);
+#elif defined(MURMUR2_NEON)
+    return strip_whitespace_neon(data, size, out);
+#else
+    return strip_whitespace_scalar(data, size, out);
+#endif
+}
@@ -42,4 +42,7 @@ struct DistributionInfo {
 DistributionInfo getDistributionInfo();
 
 uint64_t getSystemRam();
+
+// memory that can be used without swapping the rest out, 0 where it isn't known
+uint64_t getAvailableRam();
 }  // namespace Sys
@@ -37,6 +37,7 @@ Sys::KernelInfo Sys::getKernelInfo()
     return out;
 }
 
+#include <mach/mach.h>
 #include <sys/sysctl.h>
 
 uint64_t Sys::getSystemRam()
@@ -50,6 +51,16 @@ uint64_t Sys::getSystemRam()
     }
 }
 
+uint64_t Sys::getAvailableRam()
+{
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if (host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)&stats, &count) != KERN_SUCCESS)
+        return 0;
+    // what's cached for files that are gone is dropped as readily as free memory
+    return (uint64_t(stats.free_count) + stats.inactive_count + stats.purgeable_count) * vm_page_size;
+}
+
 Sys::DistributionInfo Sys::getDistributionInfo()
 {
     DistributionInfo result;
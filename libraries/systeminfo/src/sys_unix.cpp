@@ -73,6 +73,27 @@ uint64_t Sys::getSystemRam()
     return 0;  // nothing found
 }
 
+uint64_t Sys::getAvailableRam()
+{
+#ifdef Q_OS_LINUX
+    // the kernel's estimate counts the caches it would drop, MemFree doesn't
+    std::string token;
+    std::ifstream file("/proc/meminfo");
+    while (file >> token) {
+        if (token == "MemAvailable:") {
+            uint64_t mem;
+            if (file >> mem) {
+                return mem * 1024ull;
+            } else {
+                return 0;
+            }
+        }
+        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#endif
+    return 0;
+}
+
 Sys::DistributionInfo Sys::getDistributionInfo()
 {
     DistributionInfo systemd_info = read_os_release();
@@ -0,0 +1,93 @@
+#include <QTest>
+
+#include <tasks/AdaptiveConcurrency.h>
+
+class AdaptiveConcurrencyTest : public QObject {
+    Q_OBJECT
+
+    /* Run `windows` windows of tasks moving `size` units each over a link of `capacity` units per second, shared by
+     * every task in flight. Returns the limit at the end. */
+    int simulate(AdaptiveConcurrency& controller, int windows, qint64 size, double capacity, bool fail = false)
+    {
+        qint64 now = 0;
+        controller.restart(now);
+        for (int window = 0; window < windows; window++) {
+            int limit = controller.limit();
+            // with the link saturated, every task gets 1/limit of it
+            auto latency = qint64(size * limit * 1000 / capacity);
+            for (int task = 0; task < limit; task++) {
+                now += qint64(size * 1000 / capacity);
+                controller.addWork(size);
+                controller.taskFinished(now, latency, fail);
+            }
+        }
+        return controller.limit();
+    }
+
+   private slots:
+    void test_limitsAreClamped()
+    {
+        AdaptiveConcurrency controller(0, -5, 10);
+        QCOMPARE(controller.minLimit(), 1);
+        QCOMPARE(controller.maxLimit(), 1);
+        QCOMPARE(controller.limit(), 1);
+
+        AdaptiveConcurrency inRange(2, 8, 100);
+        QCOMPARE(inRange.limit(), 8);
+    }
+
+    void test_growsWhileTasksStayFast()
+    {
+        AdaptiveConcurrency controller(1, 16, 2);
+        qint64 now = 0;
+        controller.restart(now);
+        // an unsaturated link: tasks take the same time however many run
+        for (int i = 0; i < 200; i++) {
+            now += 10;
+            controller.addWork(1000);
+            controller.taskFinished(now, 50, false);
+        }
+        QCOMPARE(controller.limit(), 16);
+    }
+
+    void test_stopsGrowingOnceSaturated()
+    {
+        AdaptiveConcurrency controller(1, 64, 4);
+        auto limit = simulate(controller, 50, 1 << 20, 10 << 20);
+        // more tasks only make each of them slower, so it stops around where they got noticeably slower
+        QVERIFY(limit >= 4);
+        QVERIFY(limit <= 7);
+    }
+
+    void test_backsOffOnFailures()
+    {
+        AdaptiveConcurrency controller(2, 64, 32);
+        auto limit = simulate(controller, 20, 1000, 1e6, true);
+        QCOMPARE(limit, 2);
+    }
+
+    void test_backsOffOnCongestion()
+    {
+        AdaptiveConcurrency controller(1, 64, 4);
+        auto before = simulate(controller, 20, 1 << 20, 10 << 20);
+        // the link gets a lot slower, tasks take longer and throughput drops
+        auto after = simulate(controller, 3, 1 << 20, 1 << 20);
+        QVERIFY(after < before);
+    }
+
+    void test_countsTasksWithoutWork()
+    {
+        AdaptiveConcurrency controller(1, 4, 1);
+        qint64 now = 0;
+        controller.restart(now);
+        for (int i = 0; i < 20; i++) {
+            now += 10;
+            controller.taskFinished(now, 10, false);
+        }
+        QCOMPARE(controller.limit(), 4);
+    }
+};
+
+QTEST_GUILESS_MAIN(AdaptiveConcurrencyTest)
+
+#include "AdaptiveConcurrency_test.moc"
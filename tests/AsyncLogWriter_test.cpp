@@ -0,0 +1,58 @@
+#include <QBuffer>
+#include <QTest>
+
+#include <thread>
+#include <vector>
+
+#include <AsyncLogWriter.h>
+
+class AsyncLogWriterTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_flush()
+    {
+        auto buffer = new QBuffer;
+        buffer->open(QIODevice::WriteOnly);
+        AsyncLogWriter writer{ std::unique_ptr<QIODevice>(buffer) };
+        writer.write("first\n");
+        writer.write("second\n");
+        writer.flush();
+        QCOMPARE(buffer->data(), QByteArray("first\nsecond\n"));
+    }
+
+    void test_manyThreads()
+    {
+        auto buffer = new QBuffer;
+        buffer->open(QIODevice::WriteOnly);
+        {
+            // a small buffer, so the threads have to wait for room
+            AsyncLogWriter writer{ std::unique_ptr<QIODevice>(buffer), nullptr, 16 };
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&writer, t] {
+                    for (int i = 0; i < 1000; i++)
+                        writer.write(QString("%1 %2\n").arg(t).arg(i));
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+
+            // every line is there, in the order each thread wrote them
+            writer.flush();
+            auto lines = QString::fromUtf8(buffer->data()).split('\n', Qt::SkipEmptyParts);
+            QCOMPARE(lines.size(), 4000);
+            int next[4] = { 0, 0, 0, 0 };
+            for (auto& line : lines) {
+                auto parts = line.split(' ');
+                auto t = parts[0].toInt();
+                QCOMPARE(parts[1].toInt(), next[t]);
+                next[t]++;
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(AsyncLogWriterTest)
+
+#include "AsyncLogWriter_test.moc"
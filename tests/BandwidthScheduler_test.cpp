@@ -0,0 +1,52 @@
+#include <QTest>
+
+#include <net/BandwidthScheduler.h>
+
+using Net::Priority;
+
+class BandwidthSchedulerTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_mayStart()
+    {
+        Net::BandwidthScheduler scheduler;
+        QVERIFY(scheduler.mayStart(Priority::Bulk, 100));
+
+        scheduler.started(Priority::Interactive);
+        QVERIFY(scheduler.mayStart(Priority::Interactive, 100));
+        QVERIFY(scheduler.mayStart(Priority::Bulk, 0));
+        QVERIFY(!scheduler.mayStart(Priority::Bulk, 1));
+        QVERIFY(scheduler.mayStart(Priority::Background, 1));
+        QVERIFY(!scheduler.mayStart(Priority::Background, 2));
+
+        int freed = 0;
+        connect(&scheduler, &Net::BandwidthScheduler::capacityFreed, this, [&freed] { freed++; });
+        scheduler.stopped(Priority::Interactive);
+        QCOMPARE(freed, 1);
+        QVERIFY(scheduler.mayStart(Priority::Bulk, 100));
+    }
+
+    void test_allowance()
+    {
+        Net::BandwidthScheduler scheduler;
+        QVERIFY(scheduler.allowance(Priority::Bulk) > 1024 * 1024 * 1024);
+
+        // 1 MiB/s keeps a quarter of a second
+        scheduler.setLimit(1024 * 1024);
+        auto whole = scheduler.allowance(Priority::Bulk);
+        QVERIFY(whole >= 256 * 1024 - 1);
+
+        // the lower half of the bucket is for the requests that come first
+        scheduler.started(Priority::Interactive);
+        QVERIFY(scheduler.allowance(Priority::Bulk) < whole);
+        scheduler.consume(200 * 1024);
+        QCOMPARE(scheduler.allowance(Priority::Bulk), qint64(0));
+        QVERIFY(scheduler.allowance(Priority::Interactive) > 0);
+        QVERIFY(scheduler.retryIn(Priority::Bulk).count() > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(BandwidthSchedulerTest)
+
+#include "BandwidthScheduler_test.moc"
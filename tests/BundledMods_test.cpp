@@ -0,0 +1,103 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+#include <minecraft/mod/Mod.h>
+#include <minecraft/mod/tasks/LocalModParseTask.h>
+
+class BundledModsTest : public QObject {
+    Q_OBJECT
+
+    struct File {
+        QString name;
+        QByteArray data;
+        // stored as they are, or deflated
+        bool stored = false;
+    };
+
+    static QByteArray makeJar(const QString& path, const QList<File>& files)
+    {
+        QuaZip zip(path);
+        if (!zip.open(QuaZip::mdCreate))
+            return {};
+        for (auto& file : files) {
+            QuaZipFile entry(&zip);
+            if (!entry.open(QIODevice::WriteOnly, QuaZipNewInfo(file.name), nullptr, 0, file.stored ? 0 : Z_DEFLATED))
+                return {};
+            entry.write(file.data);
+            entry.close();
+        }
+        zip.close();
+        return FS::read(path);
+    }
+
+    static QByteArray fabricMod(const QString& id, const QString& version)
+    {
+        return QString(R"({ "schemaVersion": 1, "id": "%1", "version": "%2" })").arg(id, version).toUtf8();
+    }
+
+   private slots:
+    void test_readsBundledJars()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto deep = makeJar(dir.filePath("deep.jar"), { { "fabric.mod.json", fabricMod("deepmod", "0.1") } });
+        auto inner = makeJar(dir.filePath("inner.jar"),
+                             { { "fabric.mod.json", fabricMod("innermod", "2.0") }, { "META-INF/jars/deep.jar", deep, true } });
+        auto library = makeJar(dir.filePath("library.jar"),
+                               { { "META-INF/maven/org.example/library/pom.properties",
+                                   "groupId=org.example\nartifactId=library\nversion=1.5\n" } });
+        auto outer = dir.filePath("outer.jar");
+        QVERIFY(!makeJar(outer, { { "fabric.mod.json", fabricMod("outermod", "1.0") },
+                                  { "META-INF/jars/inner.jar", inner, true },
+                                  { "META-INF/jarjar/library.jar", library } })
+                     .isEmpty());
+
+        // the stored one is read in place, the deflated one inflated first
+        MMCZip::ZipIndex zip(outer);
+        MMCZip::ZipIndex stored(zip, "META-INF/jars/inner.jar");
+        QVERIFY(stored.isValid());
+        QVERIFY(stored.contains("fabric.mod.json"));
+        QVERIFY(MMCZip::ZipIndex(zip, "META-INF/jarjar/library.jar").isValid());
+        QVERIFY(!MMCZip::ZipIndex(zip, "fabric.mod.json").isValid());
+
+        Mod mod{ QFileInfo(outer) };
+        QVERIFY(ModUtils::processZIP(mod, zip));
+        QCOMPARE(mod.details().mod_id, QString("outermod"));
+        auto& bundled = mod.details().bundled;
+        QCOMPARE(bundled.size(), 3);
+        QCOMPARE(bundled[0].path, QString("META-INF/jars/inner.jar"));
+        QCOMPARE(bundled[0].mod_id, QString("innermod"));
+        QCOMPARE(bundled[1].path, QString("META-INF/jars/inner.jar!META-INF/jars/deep.jar"));
+        QCOMPARE(bundled[1].version, QString("0.1"));
+        QCOMPARE(bundled[2].mod_id, QString("org.example:library"));
+        QCOMPARE(bundled[2].version, QString("1.5"));
+
+        // only a full parse looks inside
+        Mod basic{ QFileInfo(outer) };
+        QVERIFY(ModUtils::processZIP(basic, zip, ModUtils::ProcessingLevel::BasicInfoOnly));
+        QVERIFY(basic.details().bundled.isEmpty());
+    }
+
+    void test_readsDependencies()
+    {
+        auto fabric = ModUtils::ReadFabricModInfo(R"({ "schemaVersion": 1, "id": "a", "version": "1",
+            "depends": { "fabricloader": "*", "b": ">=2" }, "provides": [ "a_api" ] })");
+        QVERIFY(fabric.dependencies.contains("b"));
+        QVERIFY(fabric.dependencies.contains("fabricloader"));
+        QCOMPARE(fabric.provides, QStringList{ "a_api" });
+
+        auto quilt = ModUtils::ReadQuiltModInfo(R"({ "schema_version": 1, "quilt_loader": { "id": "q", "version": "1",
+            "depends": [ "c", { "id": "d" }, { "id": "e", "optional": true } ], "provides": [ { "id": "q_api" } ] } })");
+        QCOMPARE(quilt.dependencies, (QStringList{ "c", "d" }));
+        QCOMPARE(quilt.provides, QStringList{ "q_api" });
+    }
+};
+
+QTEST_GUILESS_MAIN(BundledModsTest)
+
+#include "BundledMods_test.moc"
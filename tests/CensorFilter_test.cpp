@@ -0,0 +1,57 @@
+#include <QTest>
+
+#include <launch/CensorFilter.h>
+
+class CensorFilterTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_apply_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<QString>("expected");
+
+        QTest::newRow("no secrets") << "Setting user: Steve"
+                                    << "Setting user: Steve";
+        QTest::newRow("single") << "--accessToken abcdef0123"
+                                << "--accessToken <ACCESS TOKEN>";
+        QTest::newRow("several") << "--uuid 1234-5678 --accessToken abcdef0123"
+                                 << "--uuid <PROFILE ID> --accessToken <ACCESS TOKEN>";
+        QTest::newRow("repeated") << "abcdef0123abcdef0123"
+                                  << "<ACCESS TOKEN><ACCESS TOKEN>";
+        QTest::newRow("longest wins") << "token abcdef0123456"
+                                      << "token <LONG TOKEN>";
+        QTest::newRow("empty") << ""
+                               << "";
+    }
+
+    void test_apply()
+    {
+        QFETCH(QString, line);
+        QFETCH(QString, expected);
+
+        QMap<QString, QString> secrets;
+        secrets["abcdef0123"] = "<ACCESS TOKEN>";
+        secrets["abcdef0123456"] = "<LONG TOKEN>";
+        secrets["1234-5678"] = "<PROFILE ID>";
+        secrets[""] = "<IGNORED>";
+        CensorFilter filter(secrets);
+
+        QCOMPARE(filter.apply(line), expected);
+    }
+
+    void test_noCopy()
+    {
+        QMap<QString, QString> secrets;
+        secrets["abcdef0123"] = "<ACCESS TOKEN>";
+        CensorFilter filter(secrets);
+
+        QString line = "nothing to see here";
+        auto censored = filter.apply(line);
+        QCOMPARE(censored.constData(), line.constData());
+    }
+};
+
+QTEST_GUILESS_MAIN(CensorFilterTest)
+
+#include "CensorFilter_test.moc"
@@ -0,0 +1,54 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/ComponentSummary.h>
+
+class ComponentSummaryTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_read()
+    {
+        QTemporaryDir tmp;
+        auto path = FS::PathCombine(tmp.path(), "mmc-pack.json");
+        FS::write(path, R"({
+            "formatVersion": 1,
+            "components": [
+                { "uid": "net.minecraft", "version": "1.20.1", "important": true },
+                { "uid": "net.fabricmc.fabric-loader", "version": "0.15.0", "disabled": true },
+                { "uid": "net.minecraftforge", "version": "47.2.0" },
+                { "uid": "net.minecraftforge", "version": "1.0" }
+            ]
+        })");
+
+        auto summary = ComponentSummary::of(path);
+        QCOMPARE(summary->version("net.minecraft"), "1.20.1");
+        QCOMPARE(summary->version("net.minecraftforge"), "47.2.0");
+        QVERIFY(summary->version("org.quiltmc.quilt-loader").isNull());
+        QVERIFY(summary->isEnabled("net.minecraftforge"));
+        QVERIFY(!summary->isEnabled("net.fabricmc.fabric-loader"));
+        QVERIFY(!summary->isEnabled("org.quiltmc.quilt-loader"));
+
+        // nothing changed, nothing read again
+        QCOMPARE(ComponentSummary::of(path), summary);
+
+        FS::write(path, R"({ "formatVersion": 1, "components": [ { "uid": "net.minecraft", "version": "1.21" } ] })");
+        ComponentSummary::forget(path);
+        QCOMPARE(ComponentSummary::of(path)->version("net.minecraft"), "1.21");
+    }
+
+    void test_broken()
+    {
+        QTemporaryDir tmp;
+        auto path = FS::PathCombine(tmp.path(), "mmc-pack.json");
+        QVERIFY(ComponentSummary::of(path)->version("net.minecraft").isNull());
+
+        FS::write(path, "{ not json");
+        QVERIFY(ComponentSummary::of(path)->version("net.minecraft").isNull());
+    }
+};
+
+QTEST_GUILESS_MAIN(ComponentSummaryTest)
+
+#include "ComponentSummary_test.moc"
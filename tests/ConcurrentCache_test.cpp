@@ -0,0 +1,127 @@
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <ConcurrentCache.h>
+#include <PerfCounters.h>
+
+#include <thread>
+#include <vector>
+
+class ConcurrentCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_addAndFind()
+    {
+        ConcurrentCache<QString, int> cache;
+        QVERIFY(!cache.find("a"));
+        cache.add("a", 1);
+        QCOMPARE(cache.get("a"), 1);
+        cache.add("a", 2);
+        QCOMPARE(cache.get("a"), 2);
+        QCOMPARE(cache.stats().entries, qint64(1));
+
+        QVERIFY(cache.stale("b"));
+        QVERIFY(!cache.stale("a"));
+        cache.setStale("a");
+        QVERIFY(cache.stale("a"));
+        QVERIFY(cache.has("a"));
+        cache.add("a", 3);
+        QVERIFY(!cache.stale("a"));
+
+        cache.remove("a");
+        QVERIFY(!cache.has("a"));
+        QCOMPARE(cache.stats().bytes, qint64(0));
+    }
+
+    void test_evictsLeastRecentlyUsed()
+    {
+        // 16 shards of one entry each
+        ConcurrentCache<int, int> cache({ 16, 0, {} });
+        for (int i = 0; i < 1000; i++)
+            cache.add(i, i);
+        auto stats = cache.stats();
+        QVERIFY(stats.entries <= 16);
+        QCOMPARE(stats.evictions, qint64(1000) - stats.entries);
+        QVERIFY(cache.has(999));
+    }
+
+    void test_boundsBytes()
+    {
+        ConcurrentCache<int, QByteArray> cache({ 0, 16 * 1024, {} });
+        for (int i = 0; i < 100; i++)
+            cache.add(i, QByteArray(512, 'x'));
+        QVERIFY(cache.stats().bytes <= 16 * 1024);
+        QVERIFY(cache.has(99));
+    }
+
+    void test_expires()
+    {
+        ConcurrentCache<QString, int> cache({ 0, 0, std::chrono::milliseconds(20) });
+        cache.add("a", 1);
+        QVERIFY(cache.has("a"));
+        QThread::msleep(40);
+        QVERIFY(!cache.has("a"));
+        QCOMPARE(cache.stats().entries, qint64(0));
+    }
+
+    void test_countsHits()
+    {
+        {
+            ConcurrentCache<QString, int> cache(ConcurrentCache<QString, int>::Limits{}, "test.cache");
+            cache.add("a", 1);
+            cache.find("a");
+            cache.find("b");
+            auto values = PerfCounters::snapshot();
+            QCOMPARE(values.value("test.cache.hits"), qint64(1));
+            QCOMPARE(values.value("test.cache.misses"), qint64(1));
+            QCOMPARE(values.value("test.cache.entries"), qint64(1));
+        }
+        // what a cache held is gone with it
+        QCOMPARE(PerfCounters::snapshot().value("test.cache.entries"), qint64(0));
+    }
+
+    void test_persists()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = dir.filePath("cache.dat");
+        {
+            ConcurrentCache<QString, QByteArray> cache;
+            cache.add("a", "one");
+            cache.add("b", "two");
+            cache.setStale("b");
+            QVERIFY(cache.save(path));
+        }
+        ConcurrentCache<QString, QByteArray> cache;
+        QVERIFY(cache.load(path));
+        QCOMPARE(cache.get("a"), QByteArray("one"));
+        QCOMPARE(cache.get("b"), QByteArray("two"));
+        QVERIFY(cache.stale("b"));
+        QVERIFY(!cache.load(dir.filePath("missing.dat")));
+    }
+
+    void test_threads()
+    {
+        ConcurrentCache<int, int> cache({ 256, 0, {} });
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([&cache, t] {
+                for (int i = 0; i < 10000; i++) {
+                    cache.add((i * 8 + t) % 1024, i);
+                    cache.find(i % 1024);
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        auto stats = cache.stats();
+        QVERIFY(stats.entries <= 256);
+        QCOMPARE(stats.hits + stats.misses, qint64(80000));
+    }
+};
+
+QTEST_GUILESS_MAIN(ConcurrentCacheTest)
+
+#include "ConcurrentCache_test.moc"
@@ -0,0 +1,89 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/ChecksumValidator.h>
+#include <net/ContentStore.h>
+
+class ContentStoreTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray readAll(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), data.size());
+    }
+
+   private slots:
+    void test_keyFromValidators()
+    {
+        auto data = QByteArray("some jar");
+        auto sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        auto sha512 = QCryptographicHash::hash(data, QCryptographicHash::Sha512);
+
+        std::vector<std::shared_ptr<Net::Validator>> validators;
+        QVERIFY(!Net::ContentStore::keyFor(validators).isValid());
+
+        // nothing to look up without an expected value, or with a digest the hash cache doesn't know
+        validators.push_back(std::make_shared<Net::ChecksumValidator>(QCryptographicHash::Sha1));
+        auto md5 = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+        validators.push_back(std::make_shared<Net::ChecksumValidator>(QCryptographicHash::Md5, md5));
+        QVERIFY(!Net::ContentStore::keyFor(validators).isValid());
+
+        validators.push_back(std::make_shared<Net::ChecksumValidator>(QCryptographicHash::Sha1, sha1));
+        auto key = Net::ContentStore::keyFor(validators);
+        QCOMPARE(key.type, QString("sha1"));
+        QCOMPARE(key.hash, QString::fromLatin1(sha1.toHex()));
+
+        validators.push_back(std::make_shared<Net::ChecksumValidator>(QCryptographicHash::Sha512, sha512));
+        key = Net::ContentStore::keyFor(validators);
+        QCOMPARE(key.type, QString("sha512"));
+        QCOMPARE(key.hash, QString::fromLatin1(sha512.toHex()));
+    }
+
+    void test_add()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        Net::ContentStore store(dir.filePath("store"));
+
+        auto data = QByteArray("some jar");
+        auto key = Net::ContentStore::keyFor(QCryptographicHash::Sha1, QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+        QVERIFY(store.pathFor(key).startsWith(QDir(dir.filePath("store")).absoluteFilePath("sha1/" + key.hash.left(2))));
+
+        auto downloaded = dir.filePath("instance/mods/some.jar");
+        QVERIFY(QDir().mkpath(dir.filePath("instance/mods")));
+        writeFile(downloaded, data);
+
+        store.add(key, downloaded);
+        QCOMPARE(readAll(store.pathFor(key)), data);
+        QVERIFY(!QFile::exists(store.pathFor(key) + ".store"));
+        // the download itself stays where it is
+        QCOMPARE(readAll(downloaded), data);
+
+        // what's stored already isn't replaced
+        auto other = dir.filePath("other.jar");
+        writeFile(other, "something else");
+        store.add(key, other);
+        QCOMPARE(readAll(store.pathFor(key)), data);
+
+        // nor is anything stored without a key
+        store.add({}, other);
+        QCOMPARE(QDir(dir.filePath("store")).entryList(QDir::NoDotAndDotDot | QDir::AllEntries), QStringList{ "sha1" });
+    }
+};
+
+QTEST_GUILESS_MAIN(ContentStoreTest)
+
+#include "ContentStore_test.moc"
@@ -0,0 +1,75 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <DiskUsage.h>
+
+class DiskUsageTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, int size)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(QByteArray(size, 'x')), qint64(size));
+    }
+
+   private slots:
+    void test_size()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QVERIFY(QDir(dir.path()).mkpath("world/region"));
+        QVERIFY(QDir(dir.path()).mkpath("world/DIM-1/region"));
+        writeFile(dir.filePath("world/level.dat"), 100);
+        writeFile(dir.filePath("world/region/r.0.0.mca"), 4096);
+        writeFile(dir.filePath("world/DIM-1/region/r.0.0.mca"), 8192);
+        auto world = QDir::cleanPath(dir.filePath("world"));
+
+        DiskUsage usage;
+        QSignalSpy spy(&usage, &DiskUsage::sizeChanged);
+        QCOMPARE(usage.size(world), qint64(-1));
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.first().at(0).toString(), world);
+        QCOMPARE(spy.first().at(1).toLongLong(), qint64(100 + 4096 + 8192));
+
+        // what's under it is known now too
+        QCOMPARE(usage.size(world), qint64(100 + 4096 + 8192));
+        QCOMPARE(usage.size(dir.filePath("world/region")), qint64(4096));
+    }
+
+    void test_invalidate()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QVERIFY(QDir(dir.path()).mkpath("world/region"));
+        writeFile(dir.filePath("world/region/r.0.0.mca"), 4096);
+        auto world = QDir::cleanPath(dir.filePath("world"));
+
+        DiskUsage usage;
+        QSignalSpy spy(&usage, &DiskUsage::sizeChanged);
+        usage.size(world);
+        QVERIFY(spy.wait());
+
+        // grown in place, only the region folder has to be listed again
+        writeFile(dir.filePath("world/region/r.0.0.mca"), 10000);
+        spy.clear();
+        usage.invalidate(dir.filePath("world/region"));
+        QCOMPARE(usage.size(world), qint64(-1));
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.last().at(1).toLongLong(), qint64(10000));
+        QCOMPARE(usage.size(world), qint64(10000));
+
+        // gone entirely
+        QVERIFY(QDir(dir.filePath("world/region")).removeRecursively());
+        usage.invalidate(world);
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.last().at(1).toLongLong(), qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(DiskUsageTest)
+
+#include "DiskUsage_test.moc"
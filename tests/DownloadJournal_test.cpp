@@ -0,0 +1,103 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/DownloadJournal.h>
+
+class DownloadJournalTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), data.size());
+    }
+
+    static QByteArray readFile(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+   private slots:
+    void test_adoptAfterRestart()
+    {
+        QTemporaryDir dir;
+        auto url = QStringLiteral("https://example.com/pack/mod.jar");
+        auto first = dir.filePath("staging/one/mods/mod.jar.part");
+        writeFile(first, "0123456789room");
+        writeFile(first + ".meta", "\"etag\"");
+        {
+            Net::DownloadJournal journal(dir.filePath("downloads"));
+            journal.started(url, first, 0);
+            journal.progressed(url, 10);
+            // gone without being released, like after a crash
+        }
+
+        Net::DownloadJournal journal(dir.filePath("downloads"));
+        QVERIFY(journal.has(url));
+        QVERIFY(!journal.has("https://example.com/other.jar"));
+
+        auto second = dir.filePath("staging/two/mods/mod.jar.part");
+        QVERIFY(journal.adopt(url, second));
+        QVERIFY(!QFile::exists(first));
+        QCOMPARE(readFile(second), QByteArray("0123456789"));
+        QCOMPARE(readFile(second + ".meta"), QByteArray("\"etag\""));
+
+        journal.started(url, second);
+        QVERIFY(!journal.adopt(url, first));
+        journal.finished(url);
+        QVERIFY(!journal.has(url));
+        QVERIFY(!QFile::exists(second));
+        QVERIFY(!QFile::exists(second + ".meta"));
+    }
+
+    void test_rescueBeforeDelete()
+    {
+        QTemporaryDir dir;
+        auto url = QStringLiteral("https://example.com/pack/big.zip");
+        auto staging = dir.filePath("staging");
+        auto part = QDir(staging).filePath("big.zip.part");
+        writeFile(part, "partial");
+        writeFile(part + ".meta", "\"etag\"");
+
+        Net::DownloadJournal journal(dir.filePath("downloads"));
+        journal.started(url, part);
+        journal.released(url);
+        journal.rescue(staging);
+        QVERIFY(QDir(staging).removeRecursively());
+
+        auto target = dir.filePath("instance/big.zip.part");
+        QVERIFY(journal.adopt(url, target));
+        QCOMPARE(readFile(target), QByteArray("partial"));
+        QCOMPARE(readFile(target + ".meta"), QByteArray("\"etag\""));
+    }
+
+    void test_missingPartsAreDropped()
+    {
+        QTemporaryDir dir;
+        auto url = QStringLiteral("https://example.com/gone.jar");
+        auto part = dir.filePath("gone.jar.part");
+        writeFile(part, "data");
+        {
+            Net::DownloadJournal journal(dir.filePath("downloads"));
+            journal.started(url, part);
+            journal.released(url);
+        }
+        QVERIFY(QFile::remove(part));
+
+        Net::DownloadJournal journal(dir.filePath("downloads"));
+        QVERIFY(!journal.has(url));
+        QVERIFY(!journal.adopt(url, part));
+    }
+};
+
+QTEST_GUILESS_MAIN(DownloadJournalTest)
+
+#include "DownloadJournal_test.moc"
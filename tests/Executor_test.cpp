@@ -0,0 +1,70 @@
+#include <QSemaphore>
+#include <QTest>
+
+#include <tasks/Executor.h>
+
+#include <atomic>
+
+class ExecutorTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_result()
+    {
+        Executor executor(2);
+        auto future = executor.run(Executor::Priority::Background, [] { return 42; });
+        future.waitForFinished();
+        QCOMPARE(future.result(), 42);
+    }
+
+    void test_cancelledBeforeStart()
+    {
+        Executor executor(2);
+        CancellationToken token;
+        token.cancel();
+
+        std::atomic<bool> ran = false;
+        auto future = executor.run(Executor::Priority::Bulk, [&ran] { ran = true; }, token);
+        future.waitForFinished();
+
+        QVERIFY(future.isCanceled());
+        QVERIFY(!ran);
+    }
+
+    void test_interactiveNotBehindBulk()
+    {
+        Executor executor(2);
+        QSemaphore release;
+
+        QList<QFuture<void>> bulk;
+        for (int i = 0; i < 4; i++)
+            bulk.append(executor.run(Executor::Priority::Bulk, [&release] { release.acquire(); }));
+
+        // the bulk jobs only get one of the two threads
+        auto interactive = executor.run(Executor::Priority::Interactive, [] { return true; });
+        QVERIFY(QTest::qWaitFor([&] { return interactive.isFinished(); }, 1000));
+        QVERIFY(interactive.result());
+
+        release.release(4);
+        for (auto& future : bulk)
+            future.waitForFinished();
+    }
+
+    void test_waitForRunsQueued()
+    {
+        Executor executor(2);
+
+        // the inner job can't get a thread of its own while the outer one holds the only bulk one
+        auto outer = executor.run(Executor::Priority::Bulk, [&executor] {
+            auto inner = executor.run(Executor::Priority::Bulk, [] { return 7; });
+            executor.waitFor(inner);
+            return inner.result() * 6;
+        });
+        QVERIFY(QTest::qWaitFor([&] { return outer.isFinished(); }, 1000));
+        QCOMPARE(outer.result(), 42);
+    }
+};
+
+QTEST_GUILESS_MAIN(ExecutorTest)
+
+#include "Executor_test.moc"
@@ -0,0 +1,83 @@
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include <modplatform/helpers/ExportToModList.h>
+
+class ExportToModListTest : public QObject {
+    Q_OBJECT
+
+    static QList<ExportToModList::Row> rows(int count)
+    {
+        QList<ExportToModList::Row> rows;
+        for (int i = 0; i < count; i++)
+            rows.append({ QString("Instance %1").arg(i % 7), QString("Mod %1").arg(i), QString("https://example.com/%1").arg(i),
+                          QString("1.%1").arg(i), i % 2 ? QStringList{ "Someone" } : QStringList{ "Someone", "Someone Else" } });
+        return rows;
+    }
+
+    static QString write(const QList<ExportToModList::Row>& rows, ExportToModList::Formats format, ExportToModList::OptionalData extraData)
+    {
+        QByteArray text;
+        QBuffer buffer(&text);
+        buffer.open(QIODevice::WriteOnly);
+        if (!ExportToModList::exportToModList(&buffer, rows, format, extraData))
+            return {};
+        return QString::fromUtf8(text);
+    }
+
+   private slots:
+    void test_jsonLikeDocument()
+    {
+        auto all = static_cast<ExportToModList::OptionalData>(ExportToModList::Authors | ExportToModList::Url | ExportToModList::Version |
+                                                              ExportToModList::Instance);
+        for (int count : { 0, 1, 5 }) {
+            QJsonArray expected;
+            for (auto& row : rows(count)) {
+                QJsonObject line;
+                line["name"] = row.name;
+                line["url"] = row.url;
+                line["version"] = row.version;
+                line["authors"] = QJsonArray::fromStringList(row.authors);
+                line["instance"] = row.instance;
+                expected.append(line);
+            }
+            QCOMPARE(write(rows(count), ExportToModList::JSON, all), QString::fromUtf8(QJsonDocument(expected).toJson()));
+        }
+    }
+
+    void test_template()
+    {
+        QList<ExportToModList::Row> list = { { "Pack", "{url} mod", "https://example.com", "2.0", { "A", "B" } } };
+        QByteArray text;
+        QBuffer buffer(&text);
+        buffer.open(QIODevice::WriteOnly);
+        QVERIFY(ExportToModList::exportToModList(&buffer, list, "{name} {version} {{authors}} {instance} {unknown}"));
+        // what a field is replaced with stays as it is
+        QCOMPARE(QString::fromUtf8(text), QString("{url} mod 2.0 {A, B} Pack {unknown}"));
+    }
+
+    void test_csv()
+    {
+        auto extraData = static_cast<ExportToModList::OptionalData>(ExportToModList::Authors | ExportToModList::Version);
+        QCOMPARE(write(rows(2), ExportToModList::CSV, extraData), QString("Mod 0,1.0,\"Someone,Someone Else\"\nMod 1,1.1,Someone"));
+    }
+
+    void benchmark_customTemplate()
+    {
+        auto list = rows(20000);
+        QBENCHMARK
+        {
+            QByteArray text;
+            QBuffer buffer(&text);
+            buffer.open(QIODevice::WriteOnly);
+            ExportToModList::exportToModList(&buffer, list, "[{name}]({url}) [{version}] by {authors} in {instance}");
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ExportToModListTest)
+
+#include "ExportToModList_test.moc"
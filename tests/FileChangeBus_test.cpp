@@ -0,0 +1,64 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <filewatch/FileChangeBus.h>
+
+class FileChangeBusTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.write("x") == 1);
+    }
+
+   private slots:
+    void initTestCase() { qRegisterMetaType<QSet<QString>>(); }
+
+    void test_burst()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = QDir(dir.path()).absolutePath();
+
+        QObject owner;
+        auto subscription = FileChangeBus::instance()->subscribe({ path }, 250, &owner);
+        QSignalSpy spy(subscription, &FileChangeSubscription::changed);
+
+        for (int i = 0; i < 100; i++)
+            writeFile(dir.filePath(QString("%1.jar").arg(i)));
+        QVERIFY(spy.wait());
+        QTest::qWait(500);
+
+        QCOMPARE(spy.count(), 1);
+        auto paths = spy.first().at(0).value<QSet<QString>>();
+        QCOMPARE(paths, QSet<QString>{ path });
+    }
+
+    void test_sharedWatch()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = QDir(dir.path()).absolutePath();
+
+        QObject owner;
+        auto fast = FileChangeBus::instance()->subscribe({ path }, 50, &owner);
+        auto slow = FileChangeBus::instance()->subscribe({ path }, 250, &owner);
+        QSignalSpy fastSpy(fast, &FileChangeSubscription::changed);
+        QSignalSpy slowSpy(slow, &FileChangeSubscription::changed);
+
+        // one of them going away doesn't stop the watch for the other
+        delete fast;
+        writeFile(dir.filePath("a.jar"));
+        QVERIFY(slowSpy.wait());
+        QCOMPARE(fastSpy.count(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(FileChangeBusTest)
+
+#include "FileChangeBus_test.moc"
@@ -0,0 +1,206 @@
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkReply>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/ChecksumValidator.h>
+#include <modplatform/helpers/HashUtils.h>
+#include <net/FileSink.h>
+#include <net/HashingValidator.h>
+
+/* A finished reply with the given status and headers, sinks never read the body from it. */
+class FakeReply : public QNetworkReply {
+   public:
+    FakeReply(int status, const QList<QPair<QByteArray, QByteArray>>& headers)
+    {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, status);
+        for (auto& header : headers)
+            setRawHeader(header.first, header.second);
+        open(QIODevice::ReadOnly);
+    }
+    void abort() override {}
+
+   protected:
+    qint64 readData(char*, qint64) override { return -1; }
+};
+
+class FileSinkTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray contents()
+    {
+        QByteArray data;
+        for (int i = 0; i < 100000; i++)
+            data.append(char(i * 7));
+        return data;
+    }
+
+    static QByteArray sha1(const QByteArray& data) { return QCryptographicHash::hash(data, QCryptographicHash::Sha1); }
+
+    // download the first half of the file, then fail
+    static void interrupt(const QString& path, const QByteArray& data)
+    {
+        Net::FileSink sink(path, true);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        QVERIFY(!request.hasRawHeader("Range"));
+
+        FakeReply reply(200, { { "ETag", "\"v1\"" } });
+        QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+        auto half = data.left(data.size() / 2);
+        QCOMPARE(sink.write(half), Task::State::Running);
+        sink.abort();
+    }
+
+   private slots:
+    void test_resumesWithRange()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        interrupt(path, data);
+        QVERIFY(!QFile::exists(path));
+        QCOMPARE(QFileInfo(path + ".part").size(), qint64(data.size() / 2));
+
+        Net::FileSink sink(path, true);
+        auto validator = new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1(data));
+        sink.addValidator(validator);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        QCOMPARE(request.rawHeader("Range"), "bytes=" + QByteArray::number(data.size() / 2) + "-");
+        QCOMPARE(request.rawHeader("If-Range"), QByteArray("\"v1\""));
+
+        auto range = QString("bytes %1-%2/%3").arg(data.size() / 2).arg(data.size() - 1).arg(data.size()).toLatin1();
+        FakeReply reply(206, { { "ETag", "\"v1\"" }, { "Content-Range", range } });
+        QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+        auto rest = data.mid(data.size() / 2);
+        QCOMPARE(sink.write(rest), Task::State::Running);
+        QCOMPARE(sink.finalize(reply), Task::State::Succeeded);
+
+        // the checksum covers the part we already had too
+        QCOMPARE(validator->hash(), sha1(data));
+        QFile result(path);
+        QVERIFY(result.open(QIODevice::ReadOnly));
+        QCOMPARE(result.readAll(), data);
+        QVERIFY(!QFile::exists(path + ".part"));
+        QVERIFY(!QFile::exists(path + ".part.meta"));
+    }
+
+    void test_hashesWhileDownloading()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("mod.jar");
+        auto data = contents();
+        interrupt(path, data);
+
+        Net::FileSink sink(path, true);
+        auto validator = new Net::HashingValidator;
+        sink.addValidator(validator);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        auto range = QString("bytes %1-%2/%3").arg(data.size() / 2).arg(data.size() - 1).arg(data.size()).toLatin1();
+        FakeReply reply(206, { { "ETag", "\"v1\"" }, { "Content-Range", range } });
+        QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+        // in pieces that don't line up with the four bytes murmur2 works on
+        for (int offset = data.size() / 2; offset < data.size(); offset += 4097) {
+            auto chunk = data.mid(offset, 4097);
+            QCOMPARE(sink.write(chunk), Task::State::Running);
+        }
+        QCOMPARE(sink.finalize(reply), Task::State::Succeeded);
+
+        auto hashes = validator->hashes();
+        QCOMPARE(hashes, Hashing::hashFile(path, { "sha1", "sha512", "murmur2" }).hashes);
+    }
+
+    void test_restartsWhenFileChanged()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        interrupt(path, data);
+
+        Net::FileSink sink(path, true);
+        auto changed = data;
+        changed[0] = char(changed[0] + 1);
+        auto validator = new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1(changed));
+        sink.addValidator(validator);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        QVERIFY(request.hasRawHeader("Range"));
+
+        // If-Range didn't match, so the whole new file comes back
+        FakeReply reply(200, { { "ETag", "\"v2\"" } });
+        QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+        QCOMPARE(sink.write(changed), Task::State::Running);
+        QCOMPARE(sink.finalize(reply), Task::State::Succeeded);
+
+        QFile result(path);
+        QVERIFY(result.open(QIODevice::ReadOnly));
+        QCOMPARE(result.readAll(), changed);
+    }
+
+    void test_wrongRangeFails()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        interrupt(path, data);
+
+        Net::FileSink sink(path, true);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        FakeReply reply(206, { { "ETag", "\"v1\"" }, { "Content-Range", "bytes 0-99/100000" } });
+        QCOMPARE(sink.headersReceived(reply), Task::State::Failed);
+        sink.abort();
+        // the next attempt starts over
+        QVERIFY(!QFile::exists(path + ".part"));
+    }
+
+    void test_noValidatorNoResume()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        {
+            Net::FileSink sink(path, true);
+            QNetworkRequest request;
+            QCOMPARE(sink.init(request), Task::State::Running);
+            FakeReply reply(200, { { "ETag", "W/\"weak\"" } });
+            QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+            QByteArray data("some data");
+            QCOMPARE(sink.write(data), Task::State::Running);
+            sink.abort();
+        }
+        QVERIFY(!QFile::exists(path + ".part"));
+
+        Net::FileSink sink(path, true);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        QVERIFY(!request.hasRawHeader("Range"));
+        sink.abort();
+    }
+
+    void test_errorBodyIsDiscarded()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        interrupt(path, data);
+
+        Net::FileSink sink(path, true);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+        FakeReply reply(503, {});
+        QCOMPARE(sink.headersReceived(reply), Task::State::Running);
+        QByteArray page("<html>try again later</html>");
+        QCOMPARE(sink.write(page), Task::State::Running);
+        sink.abort();
+        // still good to resume
+        QCOMPARE(QFileInfo(path + ".part").size(), qint64(data.size() / 2));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileSinkTest)
+
+#include "FileSink_test.moc"
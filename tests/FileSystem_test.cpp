@@ -27,7 +27,9 @@ namespace fs = std::filesystem;
 namespace fs = ghc::filesystem;
 #endif
 
+#include <pathmatcher/MultiMatcher.h>
 #include <pathmatcher/RegexpMatcher.h>
+#include <pathmatcher/SimplePrefixMatcher.h>
 
 class LinkTask : public Task {
     Q_OBJECT
@@ -225,6 +227,97 @@ class FileSystemTest : public QObject {
         f();
     }
 
+    void test_linkProtocol()
+    {
+        FS::LinkProtocol::Job job;
+        job.id = 7;
+        job.useHardLinks = true;
+        for (int i = 0; i < 3000; i++)
+            job.links.append({ QString("src/file%1").arg(i), QString("dst/file%1").arg(i) });
+
+        FS::LinkProtocol::Result result;
+        result.id = 7;
+        result.errValues = { 0, 5, 0 };
+        result.errMessages.insert(1, "Access is denied.");
+
+        // arriving in pieces, the job is only there once all of it is
+        auto stream = FS::LinkProtocol::message(job) + FS::LinkProtocol::message(result);
+        QByteArray buffer;
+        QByteArray message;
+        buffer.append(stream.left(1000));
+        QVERIFY(!FS::LinkProtocol::takeMessage(buffer, message));
+        buffer.append(stream.mid(1000));
+
+        QVERIFY(FS::LinkProtocol::takeMessage(buffer, message));
+        auto readJob = FS::LinkProtocol::readJob(message);
+        QCOMPARE(readJob.id, quint32(7));
+        QVERIFY(readJob.useHardLinks);
+        QCOMPARE(readJob.links.size(), 3000);
+        QCOMPARE(readJob.links[2999].src, QString("src/file2999"));
+        QCOMPARE(readJob.links[2999].dst, QString("dst/file2999"));
+
+        QVERIFY(FS::LinkProtocol::takeMessage(buffer, message));
+        auto readResult = FS::LinkProtocol::readResult(message);
+        QCOMPARE(readResult.id, quint32(7));
+        QCOMPARE(readResult.errValues, result.errValues);
+        QCOMPARE(readResult.errMessages, result.errMessages);
+
+        QVERIFY(buffer.isEmpty());
+        QVERIFY(!FS::LinkProtocol::takeMessage(buffer, message));
+    }
+
+    void test_copy_many()
+    {
+        QTemporaryDir sourceDir;
+        QTemporaryDir targetDir;
+        // enough files to be copied in parallel
+        for (int i = 0; i < 500; i++) {
+            auto path = FS::PathCombine(sourceDir.path(), QString("dir%1").arg(i % 7), QString("file%1.txt").arg(i));
+            FS::write(path, QByteArray::number(i));
+        }
+
+        FS::copy c(sourceDir.path(), targetDir.path());
+        QVERIFY(c());
+        QCOMPARE(c.totalCopied(), qsizetype(500));
+        QCOMPARE(c.totalFailed(), qsizetype(0));
+        for (int i = 0; i < 500; i += 37) {
+            auto path = FS::PathCombine(targetDir.path(), QString("dir%1").arg(i % 7), QString("file%1.txt").arg(i));
+            QCOMPARE(FS::read(path), QByteArray::number(i));
+        }
+    }
+
+    void test_copy_methods()
+    {
+        // the same filesystem for both, so linking and moving work
+        QTemporaryDir sourceDir("./tmp");
+        QTemporaryDir linkDir("./tmp");
+        QTemporaryDir moveDir("./tmp");
+        qint64 bytes = 0;
+        for (int i = 0; i < 100; i++) {
+            auto data = QByteArray::number(i);
+            FS::write(FS::PathCombine(sourceDir.path(), QString("dir%1").arg(i % 3), QString("file%1.txt").arg(i)), data);
+            bytes += data.size();
+        }
+
+        FS::copy link(sourceDir.path(), linkDir.path());
+        link.method(FS::copy::Method::HardLink).countBytes(true);
+        qint64 scannedBytes = 0;
+        connect(&link, &FS::copy::scanned, [&scannedBytes](qsizetype, qint64 total) { scannedBytes = total; });
+        QVERIFY(link());
+        QCOMPARE(scannedBytes, bytes);
+        QCOMPARE(link.bytesCopied(), bytes);
+        auto linked = FS::PathCombine(linkDir.path(), "dir1", "file1.txt");
+        QVERIFY(fs::equivalent(StringUtils::toStdString(linked),
+                               StringUtils::toStdString(FS::PathCombine(sourceDir.path(), "dir1", "file1.txt"))));
+
+        FS::copy move(sourceDir.path(), moveDir.path());
+        move.method(FS::copy::Method::Move);
+        QVERIFY(move());
+        QCOMPARE(move.totalCopied(), qsizetype(100));
+        QCOMPARE(FS::read(FS::PathCombine(moveDir.path(), "dir2", "file5.txt")), QByteArray("5"));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(sourceDir.path(), "dir2", "file5.txt")));
+    }
+
     void test_copy_with_blacklist()
     {
         QString folder = QFINDTESTDATA("testdata/FileSystem/test_folder");
@@ -292,6 +385,33 @@ class FileSystemTest : public QObject {
         f();
     }
 
+    void test_copy_with_prefixes()
+    {
+        QString folder = QFINDTESTDATA("testdata/FileSystem/test_folder");
+        MultiMatcher matcher;
+        matcher.add(std::make_shared<SimplePrefixMatcher>("assets/"));
+        matcher.add(std::make_shared<SimplePrefixMatcher>(".secret_folder/.secret_file.txt"));
+        matcher.add(std::make_shared<RegexpMatcher>("[.]nfo$"));
+
+        QTemporaryDir tempDir;
+        QDir target_dir(FS::PathCombine(tempDir.path(), "test_folder"));
+        FS::copy c(folder, target_dir.path());
+        c.matcher(&matcher);
+        QVERIFY(c());
+        QCOMPARE(target_dir.entryList(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot), QStringList({ "pack.mcmeta" }));
+
+        QTemporaryDir whitelistDir;
+        target_dir.setPath(FS::PathCombine(whitelistDir.path(), "test_folder"));
+        FS::copy w(folder, target_dir.path());
+        w.matcher(&matcher);
+        w.whitelist(true);
+        QVERIFY(w());
+        QVERIFY(QFileInfo::exists(target_dir.filePath("assets/minecraft/textures/blah.txt")));
+        QVERIFY(QFileInfo::exists(target_dir.filePath(".secret_folder/.secret_file.txt")));
+        QVERIFY(QFileInfo::exists(target_dir.filePath("pack.nfo")));
+        QVERIFY(!QFileInfo::exists(target_dir.filePath("pack.mcmeta")));
+    }
+
     void test_copy_with_dot_hidden()
     {
         QString folder = QFINDTESTDATA("testdata/FileSystem/test_folder");
@@ -353,6 +473,28 @@ class FileSystemTest : public QObject {
         }
     }
 
+    void test_overrideFolder()
+    {
+        QTemporaryDir tempDir;
+        auto instance = FS::PathCombine(tempDir.path(), "instance");
+        auto staged = FS::PathCombine(tempDir.path(), "staged");
+        FS::write(FS::PathCombine(instance, "mods", "kept.jar"), "kept");
+        FS::write(FS::PathCombine(instance, "config", "a.cfg"), "old");
+        FS::write(FS::PathCombine(staged, "config", "a.cfg"), "new");
+        FS::write(FS::PathCombine(staged, "mods", "added.jar"), "added");
+        FS::write(FS::PathCombine(staged, "resourcepacks", "pack.zip"), "pack");
+
+        QVERIFY(FS::overrideFolder(instance, staged));
+
+        QCOMPARE(FS::read(FS::PathCombine(instance, "mods", "kept.jar")), QByteArray("kept"));
+        QCOMPARE(FS::read(FS::PathCombine(instance, "config", "a.cfg")), QByteArray("new"));
+        QCOMPARE(FS::read(FS::PathCombine(instance, "mods", "added.jar")), QByteArray("added"));
+        QCOMPARE(FS::read(FS::PathCombine(instance, "resourcepacks", "pack.zip")), QByteArray("pack"));
+        // moved, not copied
+        QVERIFY(!QFile::exists(FS::PathCombine(staged, "config", "a.cfg")));
+        QVERIFY(!QFile::exists(FS::PathCombine(staged, "resourcepacks")));
+    }
+
     void test_getDesktop() { QCOMPARE(FS::getDesktopDir(), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation)); }
 
     void test_link()
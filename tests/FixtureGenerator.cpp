@@ -0,0 +1,34 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "SyntheticInstance.h"
+
+// writes synthetic instances to look at or to point a launcher at, the tests generate their own
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes deterministic synthetic instances for scale and performance testing.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "The folder to write the instances to.");
+    parser.addOption({ "instances", "How many instances to write, of the small scale when more than one.", "count", "1" });
+    parser.addOption({ "small", "Write small instances even if there's only one." });
+    parser.addOption({ "seed", "The seed of the first instance.", "seed", "1" });
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    auto output = parser.positionalArguments().first();
+    auto count = parser.value("instances").toInt();
+    auto scale = count > 1 || parser.isSet("small") ? SyntheticInstance::Scale::small() : SyntheticInstance::Scale();
+    scale.seed = parser.value("seed").toUInt();
+
+    auto written = count == 1 ? SyntheticInstance::generate(output, scale) : SyntheticInstance::generateInstances(output, count, scale);
+    if (!written) {
+        qCritical() << "Couldn't write the instances to" << output;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <modplatform/flame/FlameFileCache.h>
+
+class FlameFileCacheTest : public QObject {
+    Q_OBJECT
+
+    static QJsonObject file(int projectId, int fileId, const QString& url)
+    {
+        QJsonObject file;
+        file["id"] = fileId;
+        file["modId"] = projectId;
+        file["fileName"] = QString("example-%1.jar").arg(fileId);
+        file["downloadUrl"] = url;
+        return file;
+    }
+
+   private slots:
+    void test_keyedByProjectAndFile()
+    {
+        Flame::FileCache cache;
+        QVERIFY(!cache.file(1, 2));
+
+        cache.putFile(file(1, 2, "https://edge.forgecdn.net/files/2/example-2.jar"));
+        auto cached = cache.file(1, 2);
+        QVERIFY(cached);
+        QCOMPARE(cached->value("fileName").toString(), QString("example-2.jar"));
+
+        // the same file ID under another project isn't the same file
+        QVERIFY(!cache.file(3, 2));
+
+        // no IDs, nothing to key it by
+        cache.putFile(QJsonObject());
+        QVERIFY(!cache.file(0, 0));
+    }
+
+    void test_modrinthMisses()
+    {
+        Flame::FileCache cache;
+        QVERIFY(!cache.modrinthVersion("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+
+        // Modrinth not having it is worth remembering as well
+        cache.putModrinthVersion("da39a3ee5e6b4b0d3255bfef95601890afd80709", QJsonObject());
+        auto cached = cache.modrinthVersion("da39a3ee5e6b4b0d3255bfef95601890afd80709");
+        QVERIFY(cached);
+        QVERIFY(cached->isEmpty());
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto cache_file = dir.filePath("flamefilecache.json");
+
+        {
+            Flame::FileCache cache(cache_file);
+            cache.putFile(file(1, 2, "https://edge.forgecdn.net/files/2/example-2.jar"));
+            // blocked
+            cache.putFile(file(1, 3, ""));
+            cache.putWebsiteUrl(1, "https://www.curseforge.com/minecraft/mc-mods/example");
+            cache.saveNow();
+        }
+
+        Flame::FileCache cache(cache_file);
+        cache.load();
+        QVERIFY(cache.file(1, 2));
+        auto blocked = cache.file(1, 3);
+        QVERIFY(blocked);
+        QVERIFY(blocked->value("downloadUrl").toString().isEmpty());
+        QCOMPARE(cache.websiteUrl(1), QString("https://www.curseforge.com/minecraft/mc-mods/example"));
+        QVERIFY(cache.websiteUrl(2).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(FlameFileCacheTest)
+
+#include "FlameFileCache_test.moc"
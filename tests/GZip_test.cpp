@@ -1,3 +1,4 @@
+#include <QBuffer>
 #include <QTest>
 
 #include <GZip.h>
@@ -45,6 +46,50 @@ class GZipTest : public QObject {
             fib(prev, cur);
         } while (cur < size);
     }
+
+    void test_Streaming()
+    {
+        QByteArray text;
+        for (int i = 0; i < 100000; i++)
+            text.append(QByteArray::number(i)).append('\n');
+
+        // written in odd pieces, read back in other ones
+        QByteArray compressed;
+        QBuffer target(&compressed);
+        target.open(QIODevice::WriteOnly);
+        GZipWriter writer(&target);
+        QVERIFY(writer.open(QIODevice::WriteOnly));
+        for (int offset = 0; offset < text.size(); offset += 1000)
+            QCOMPARE(writer.write(text.mid(offset, 1000)), qMin(1000, text.size() - offset));
+        QVERIFY(writer.finish());
+
+        QByteArray decompressed;
+        QVERIFY(GZip::unzip(compressed, decompressed));
+        QCOMPARE(decompressed, text);
+
+        QBuffer source(&compressed);
+        source.open(QIODevice::ReadOnly);
+        GZipReader reader(&source);
+        QVERIFY(reader.open(QIODevice::ReadOnly));
+        QCOMPARE(reader.expectedSize(), text.size());
+        QByteArray pieces;
+        char buffer[777];
+        qint64 read;
+        while ((read = reader.read(buffer, sizeof(buffer))) > 0)
+            pieces.append(buffer, static_cast<int>(read));
+        QVERIFY(reader.finished());
+        QCOMPARE(pieces, text);
+    }
+
+    void test_Truncated()
+    {
+        QByteArray compressed;
+        QVERIFY(GZip::zip(QByteArray(100000, 'x'), compressed));
+        compressed.chop(10);
+        QByteArray decompressed;
+        QVERIFY(!GZip::unzip(compressed, decompressed));
+        QVERIFY(!GZip::unzip(QByteArray("not gzip at all"), decompressed));
+    }
 };
 
 QTEST_GUILESS_MAIN(GZipTest)
@@ -0,0 +1,103 @@
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/gameoptions/GameOptions.h>
+
+class GameOptionsTest : public QObject {
+    Q_OBJECT
+
+    static void write(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(data);
+    }
+
+    static QByteArray read(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll();
+    }
+
+   private slots:
+    void test_parse()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("options.txt");
+        write(path, "version:3465\nfov:0.0\nnot an option\nkey_key.jump:key.keyboard.space\r\nlang:en_us");
+
+        auto parsed = GameOptions::parse(path);
+        QVERIFY(parsed.ok);
+        QCOMPARE(parsed.version, 3465);
+        QCOMPARE(parsed.contents.size(), size_t(3));
+        QCOMPARE(parsed.contents[1].key, QString("key_key.jump"));
+        QCOMPARE(parsed.contents[1].value, QString("key.keyboard.space"));
+        QCOMPARE(parsed.contents[1].line, 3);
+        QVERIFY(!parsed.trailingNewline);
+        QVERIFY(!GameOptions::parse(dir.filePath("missing.txt")).ok);
+    }
+
+    void test_editInPlace()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("options.txt");
+        write(path, "version:3465\nfov:0.0\n# kept\nlang:en_us\r\n");
+
+        GameOptions options(path);
+        QVERIFY(options.reload());
+        QVERIFY(options.isUpToDate());
+        QVERIFY(options.setData(options.index(1, 1), "de_de"));
+        QVERIFY(options.save());
+        QCOMPARE(read(path), QByteArray("version:3465\nfov:0.0\n# kept\nlang:de_de\r\n"));
+
+        // longer than the line it replaces
+        QVERIFY(options.setData(options.index(0, 1), "0.75"));
+        QVERIFY(options.save());
+        QCOMPARE(read(path), QByteArray("version:3465\nfov:0.75\n# kept\nlang:de_de\r\n"));
+        QVERIFY(options.isUpToDate());
+    }
+
+    void test_mergeWithGameWrites()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("options.txt");
+        write(path, "fov:0.0\nlang:en_us\n");
+
+        GameOptions options(path);
+        QVERIFY(options.reload());
+        QVERIFY(options.setData(options.index(1, 1), "fr_fr"));
+
+        // the game rewrote it meanwhile
+        write(path, "fov:0.5\ngamma:1.0\nlang:en_us\n");
+        QVERIFY(!options.isUpToDate());
+        QVERIFY(options.save());
+        QCOMPARE(read(path), QByteArray("fov:0.5\ngamma:1.0\nlang:fr_fr\n"));
+        QCOMPARE(options.rowCount(), 3);
+    }
+
+    void test_reloadAsync()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("options.txt");
+        write(path, "fov:0.0\nlang:en_us\n");
+
+        GameOptions options(path);
+        QSignalSpy reloaded(&options, &GameOptions::reloaded);
+        options.reloadAsync();
+        QTRY_COMPARE(reloaded.count(), 1);
+        QCOMPARE(reloaded.first().first().toBool(), true);
+        QCOMPARE(options.rowCount(), 2);
+
+        // nothing changed, nothing to parse
+        options.reloadAsync();
+        QCOMPARE(reloaded.count(), 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(GameOptionsTest)
+
+#include "GameOptions_test.moc"
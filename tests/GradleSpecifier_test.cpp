@@ -46,6 +46,27 @@ class GradleSpecifierTest : public QObject {
 
         QCOMPARE(converted, expected);
     }
+    void test_Shared()
+    {
+        GradleSpecifier a("org.lwjgl:lwjgl:3.3.1");
+        GradleSpecifier b(QString("org.lwjgl:lwjgl:3.3.1"));
+        QVERIFY(a == b);
+        // the same string, the same path
+        QVERIFY(a.toPath().constData() == b.toPath().constData());
+        QCOMPARE(a.toPath("custom.jar"), QString("org/lwjgl/lwjgl/3.3.1/custom.jar"));
+
+        b.setClassifier("natives-linux");
+        QCOMPARE(b.serialize(), QString("org.lwjgl:lwjgl:3.3.1:natives-linux"));
+        QCOMPARE(b.toPath(), QString("org/lwjgl/lwjgl/3.3.1/lwjgl-3.3.1-natives-linux.jar"));
+        QCOMPARE(a.classifier(), QString());
+        QVERIFY(a.matchName(GradleSpecifier("org.lwjgl:lwjgl:3.2.2")));
+        QVERIFY(!a.matchName(b));
+
+        GradleSpecifier none;
+        QVERIFY(!none.valid());
+        QCOMPARE(none.serialize(), QString());
+    }
+
     void test_Negative_data()
     {
         QTest::addColumn<QString>("input");
@@ -0,0 +1,100 @@
+#include <QCryptographicHash>
+#include <QTemporaryFile>
+#include <QTest>
+
+#include <modplatform/helpers/HashUtils.h>
+
+#include <MurmurHash2.h>
+
+class HashUtilsTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray sampleData()
+    {
+        QByteArray data;
+        // a few chunks worth, with plenty of the whitespace murmur2 skips
+        for (int i = 0; data.size() < 9 * 1024 * 1024; i++) {
+            data.append(QByteArray::number(i * 2654435761u));
+            data.append(i % 3 ? " \t" : "\r\n");
+        }
+        return data;
+    }
+
+    static bool isCurseForgeWhitespace(char c) { return c == 9 || c == 10 || c == 13 || c == 32; }
+
+   private slots:
+    void test_allDigestsInOnePass()
+    {
+        auto data = sampleData();
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        QCOMPARE(file.write(data), qint64(data.size()));
+        file.flush();
+
+        auto record = Hashing::hashFile(file.fileName(), { "sha512", "sha1", "md5", "murmur2" });
+        QCOMPARE(record.path, file.fileName());
+        QCOMPARE(record.hashes.size(), 4);
+        QCOMPARE(record.hashes["sha512"], QString(QCryptographicHash::hash(data, QCryptographicHash::Sha512).toHex()));
+        QCOMPARE(record.hashes["sha1"], QString(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex()));
+        QCOMPARE(record.hashes["md5"], QString(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex()));
+
+        std::ifstream stream(file.fileName().toStdString(), std::ifstream::binary);
+        QCOMPARE(record.hashes["murmur2"], QString::number(MurmurHash2(std::move(stream), 4 * MiB, isCurseForgeWhitespace)));
+    }
+
+    void test_onlyRequestedDigests()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write("some mod");
+        file.flush();
+
+        auto record = Hashing::hashFile(file.fileName(), { "sha1", "whirlpool" });
+        QCOMPARE(record.hashes.keys(), QStringList{ "sha1" });
+    }
+
+    void test_emptyFile()
+    {
+        QTemporaryFile file;
+        QVERIFY(file.open());
+
+        auto record = Hashing::hashFile(file.fileName(), { "md5" });
+        QCOMPARE(record.hashes["md5"], QString("d41d8cd98f00b204e9800998ecf8427e"));
+    }
+
+    void test_progressAndStop()
+    {
+        auto data = sampleData();
+        QTemporaryFile file;
+        QVERIFY(file.open());
+        file.write(data);
+        file.flush();
+
+        qint64 lastDone = 0;
+        qint64 lastTotal = 0;
+        auto record = Hashing::hashFile(file.fileName(), { "sha1", "murmur2" }, [&](qint64 done, qint64 total) {
+            lastDone = done;
+            lastTotal = total;
+            return true;
+        });
+        QCOMPARE(record.hashes.size(), 2);
+        // murmur2 takes two passes
+        QCOMPARE(lastTotal, 2 * qint64(data.size()));
+        QCOMPARE(lastDone, lastTotal);
+
+        int calls = 0;
+        record = Hashing::hashFile(file.fileName(), { "sha1", "murmur2" }, [&](qint64, qint64) { return ++calls < 2; });
+        QCOMPARE(calls, 2);
+        QVERIFY(record.hashes.isEmpty());
+    }
+
+    void test_missingFile()
+    {
+        auto record = Hashing::hashFile("/this/file/does/not/exist.jar", { "sha1", "murmur2" });
+        QVERIFY(record.hashes.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(HashUtilsTest)
+
+#include "HashUtils_test.moc"
@@ -0,0 +1,127 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <net/HttpMetaCache.h>
+
+#include <memory>
+#include <vector>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& contents)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+    }
+
+    static MetaEntryPtr addEntry(HttpMetaCache& cache, const QString& base, const QString& path, const QString& md5)
+    {
+        auto entry = cache.resolveEntry(base, path);
+        entry->setMD5Sum(md5);
+        entry->setETag("\"" + md5 + "\"");
+        entry->makeEternal(true);
+        entry->setLocalChangedTimestamp(QFileInfo(entry->getFullPath()).lastModified().toUTC().toMSecsSinceEpoch());
+        entry->setStale(false);
+        cache.updateEntry(entry);
+        return entry;
+    }
+
+   private slots:
+    void test_persistsThroughJournal()
+    {
+        QTemporaryDir dir;
+        QDir(dir.path()).mkdir("libraries");
+        writeFile(dir.filePath("libraries/a.jar"), "first");
+        writeFile(dir.filePath("libraries/b.jar"), "second");
+        auto index = dir.filePath("metacache");
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("libraries", dir.filePath("libraries"));
+            cache.Load();
+            addEntry(cache, "libraries", "a.jar", "8b04d5e3775d298e78455efc5ca404d5");
+            auto b = addEntry(cache, "libraries", "b.jar", "a9f0e61a137d86aa9db53465e0801612");
+            QVERIFY(cache.evictEntry(b));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("libraries", dir.filePath("libraries"));
+        cache.Load();
+        auto a = cache.getEntry("libraries", "a.jar");
+        QVERIFY(a);
+        QVERIFY(!a->isStale());
+        QCOMPARE(a->getMD5Sum(), QString("8b04d5e3775d298e78455efc5ca404d5"));
+        QCOMPARE(a->getFullPath(), dir.filePath("libraries/a.jar"));
+        QVERIFY(!cache.getEntry("libraries", "b.jar"));
+    }
+
+    void test_changedSizeIsStale()
+    {
+        QTemporaryDir dir;
+        writeFile(dir.filePath("a.jar"), "first");
+
+        HttpMetaCache cache;
+        cache.addBase("general", dir.path());
+        addEntry(cache, "general", "a.jar", "8b04d5e3775d298e78455efc5ca404d5");
+        QVERIFY(!cache.resolveEntry("general", "a.jar")->isStale());
+
+        writeFile(dir.filePath("a.jar"), "something else entirely");
+        // make sure the change shows in the timestamp, however coarse the file system's are
+        QFile changed(dir.filePath("a.jar"));
+        QVERIFY(changed.open(QIODevice::ReadWrite));
+        QVERIFY(changed.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        changed.close();
+        QVERIFY(cache.resolveEntry("general", "a.jar")->isStale());
+        QVERIFY(!cache.getEntry("general", "a.jar"));
+    }
+
+    void test_concurrentAccess()
+    {
+        QTemporaryDir dir;
+        HttpMetaCache cache;
+        const QStringList bases = { "libraries", "asset_indexes", "general" };
+        for (auto& base : bases) {
+            QDir(dir.path()).mkdir(base);
+            cache.addBase(base, dir.filePath(base));
+        }
+
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back(QThread::create([&cache, &bases, t] {
+                for (int i = 0; i < 200; i++) {
+                    auto& base = bases[(t + i) % bases.size()];
+                    auto path = QString("%1-%2.jar").arg(t).arg(i);
+                    auto entry = cache.resolveEntry(base, path);
+                    entry->setStale(false);
+                    cache.updateEntry(entry);
+                    cache.getEntry(base, path);
+                    if (i % 3 == 0)
+                        cache.evictEntry(cache.getEntry(base, path));
+                }
+            }));
+            threads.back()->start();
+        }
+        for (auto& thread : threads)
+            QVERIFY(thread->wait());
+
+        int found = 0;
+        for (int t = 0; t < 8; t++) {
+            for (int i = 0; i < 200; i++) {
+                if (cache.getEntry(bases[(t + i) % bases.size()], QString("%1-%2.jar").arg(t).arg(i)))
+                    found++;
+            }
+        }
+        // evicting only marks entries stale, they're all still there
+        QCOMPARE(found, 8 * 200);
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
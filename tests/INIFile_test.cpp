@@ -190,6 +190,79 @@ PreLaunchCommand=)";
         FS::deletePath(fileName);
 #endif
     }
+    void test_ParseLikeQSettings_data()
+    {
+        QTest::addColumn<QVariant>("value");
+
+        QTest::newRow("plain") << QVariant("Minecraft 1.20");
+        QTest::newRow("unicode") << QVariant(QString::fromUtf8("Über Modpack \xe2\x9c\xa8"));
+        QTest::newRow("surrounding spaces") << QVariant("  padded  ");
+        QTest::newRow("separators") << QVariant("a=b; c, d");
+        QTest::newRow("escapes") << QVariant("tab\there\nnew line \"quoted\" back\\slash \a\x01""0");
+        QTest::newRow("at sign") << QVariant("@not a type");
+        QTest::newRow("bool") << QVariant(true);
+        QTest::newRow("number") << QVariant(qint64(1234567890123));
+        QTest::newRow("byte array") << QVariant(QByteArray("raw bytes"));
+        QTest::newRow("list") << QVariant(QStringList{ "a", " b ", "c,d", "" });
+        QTest::newRow("empty list") << QVariant(QStringList{});
+        QTest::newRow("mixed list") << QVariant(QVariantList{ 1, "two", QByteArray("three") });
+        QTest::newRow("invalid") << QVariant();
+    }
+
+    void test_ParseLikeQSettings()
+    {
+        QFETCH(QVariant, value);
+        QTemporaryFile file;
+        QCOMPARE(file.open(), true);
+        QString fileName = file.fileName();
+        file.close();
+
+        INIFile f1;
+        f1.set("key", value);
+        QVERIFY(f1.saveFile(fileName));
+
+        QSettings settings{ fileName, QSettings::Format::IniFormat };
+        settings.setFallbacksEnabled(false);
+        QCOMPARE(settings.status(), QSettings::Status::NoError);
+
+        INIFile f2;
+        QVERIFY(f2.loadFile(fileName));
+        QCOMPARE(f2.get("key", "NOT SET"), settings.value("key"));
+    }
+
+    void test_ParseComments()
+    {
+        QByteArray content = "[General]\n; a comment\nConfigVersion=1.2\nname=\"quoted; not a comment\" ; a comment\nlist=a, b\n";
+
+        INIFile f;
+        QVERIFY(f.loadFile(content));
+        QCOMPARE(f.get("name", "NOT SET").toString(), "quoted; not a comment");
+        QCOMPARE(f.get("list", "NOT SET").toStringList(), QStringList({ "a", "b" }));
+    }
+
+    void test_SaveUnchanged()
+    {
+        QTemporaryFile file;
+        QCOMPARE(file.open(), true);
+        file.write("[General]\n; kept as long as nothing changes\nConfigVersion=1.2\nname=Unchanged\n");
+        QString fileName = file.fileName();
+        file.close();
+
+        INIFile f;
+        QVERIFY(f.loadFile(fileName));
+        QVERIFY(f.saveFile(fileName));
+
+        QCOMPARE(file.open(), true);
+        QVERIFY(file.readAll().contains("; kept as long as nothing changes"));
+        file.close();
+
+        f.set("name", "Changed");
+        QVERIFY(f.saveFile(fileName));
+
+        INIFile f2;
+        QVERIFY(f2.loadFile(fileName));
+        QCOMPARE(f2.get("name", "NOT SET").toString(), "Changed");
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -0,0 +1,77 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <settings/INISettingsObject.h>
+
+class INISettingsObjectTest : public QObject {
+    Q_OBJECT
+
+    static QString readValue(const QString& path, const QString& key)
+    {
+        INIFile file;
+        file.loadFile(path);
+        return file.get(key, "NOT SET").toString();
+    }
+
+   private slots:
+    void test_SaveDelayed()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "instance.cfg");
+
+        INISettingsObject settings(path);
+        settings.registerSetting("name", "");
+        settings.setSaveDelay(50);
+
+        for (int i = 0; i < 10; i++)
+            settings.set("name", QString::number(i));
+        QCOMPARE(readValue(path, "name"), QString("NOT SET"));
+        QTRY_COMPARE(readValue(path, "name"), QString("9"));
+
+        settings.set("name", "right away");
+        settings.saveNow();
+        QCOMPARE(readValue(path, "name"), QString("right away"));
+    }
+
+    void test_SaveAllNow()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "instance.cfg");
+
+        {
+            INISettingsObject settings(path);
+            settings.registerSetting("name", "");
+            settings.setSaveDelay(60000);
+            settings.set("name", "on quit");
+            SettingsObject::saveAllNow();
+            QCOMPARE(readValue(path, "name"), QString("on quit"));
+
+            settings.set("name", "on destruction");
+        }
+        QCOMPARE(readValue(path, "name"), QString("on destruction"));
+    }
+
+    void test_DeletedFolder()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto dir = FS::PathCombine(tmp.path(), "instance");
+        QVERIFY(FS::ensureFolderPathExists(dir));
+
+        INISettingsObject settings(FS::PathCombine(dir, "instance.cfg"));
+        settings.registerSetting("name", "");
+        settings.setSaveDelay(60000);
+        settings.set("name", "deleted");
+        QVERIFY(FS::deletePath(dir));
+
+        settings.saveNow();
+        QVERIFY(!QFileInfo::exists(dir));
+    }
+};
+
+QTEST_GUILESS_MAIN(INISettingsObjectTest)
+
+#include "INISettingsObject_test.moc"
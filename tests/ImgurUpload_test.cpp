@@ -0,0 +1,55 @@
+#include <QBuffer>
+#include <QImage>
+#include <QImageReader>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <screenshots/ImgurUpload.h>
+
+class ImgurUploadTest : public QObject {
+    Q_OBJECT
+
+    QString screenshot(const QTemporaryDir& tmp)
+    {
+        QImage image(400, 200, QImage::Format_RGB32);
+        image.fill(Qt::darkGreen);
+        auto path = FS::PathCombine(tmp.path(), "2024-01-01_00.00.00.png");
+        image.save(path, "png", 100);
+        return path;
+    }
+
+   private slots:
+    void test_asIs()
+    {
+        QTemporaryDir tmp;
+        auto path = screenshot(tmp);
+        QVERIFY(ImgurUpload::prepare(path, {}).isEmpty());
+        // already no larger than what fits
+        QVERIFY(ImgurUpload::prepare(path, { 400, false }).isEmpty());
+    }
+
+    void test_downscale()
+    {
+        QTemporaryDir tmp;
+        auto data = ImgurUpload::prepare(screenshot(tmp), { 100, false });
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer, "png");
+        QCOMPARE(reader.size(), QSize(100, 50));
+    }
+
+    void test_recompress()
+    {
+        QTemporaryDir tmp;
+        auto path = screenshot(tmp);
+        auto data = ImgurUpload::prepare(path, { 0, true });
+        QVERIFY(!data.isEmpty());
+        QVERIFY(data.size() < QFileInfo(path).size());
+        QCOMPARE(QImage::fromData(data, "png"), QImage(path));
+    }
+};
+
+QTEST_GUILESS_MAIN(ImgurUploadTest)
+
+#include "ImgurUpload_test.moc"
@@ -0,0 +1,85 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <InstanceSnapshot.h>
+#include <settings/INISettingsObject.h>
+
+class InstanceSnapshotTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_SaveLoad()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "cache", "instances.snapshot");
+
+        InstanceSnapshot snapshot;
+        snapshot.instDir = "/home/user/instances";
+        snapshot.entries.append({ "1.20", 120, 1700000000000, { { "name", "1.20" }, { "totalTimePlayed", qint64(3600) } } });
+        snapshot.entries.append({ "modded", 240, 1700000001000, { { "name", "Modded" }, { "iconKey", "flame" } } });
+        QVERIFY(snapshot.save(path));
+
+        auto loaded = InstanceSnapshot::load(path);
+        QCOMPARE(loaded.instDir, snapshot.instDir);
+        QCOMPARE(loaded.entries.size(), 2);
+        QCOMPARE(loaded.entries[1].id, QString("modded"));
+        QCOMPARE(loaded.entries[1].size, qint64(240));
+        QCOMPARE(loaded.entries[1].modified, qint64(1700000001000));
+        QCOMPARE(loaded.entries[0].values.value("totalTimePlayed").toLongLong(), qint64(3600));
+        QCOMPARE(loaded.entries[1].values.value("iconKey").toString(), QString("flame"));
+    }
+
+    void test_Damaged()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "instances.snapshot");
+
+        InstanceSnapshot snapshot;
+        snapshot.instDir = "/home/user/instances";
+        snapshot.entries.append({ "1.20", 120, 1700000000000, { { "name", "1.20" } } });
+        QVERIFY(snapshot.save(path));
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 4));
+        file.close();
+
+        QVERIFY(InstanceSnapshot::load(path).entries.isEmpty());
+        QVERIFY(InstanceSnapshot::load(FS::PathCombine(tmp.path(), "missing")).instDir.isEmpty());
+    }
+
+    void test_PartialSettings()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        auto path = FS::PathCombine(tmp.path(), "instance.cfg");
+
+        INIFile file;
+        file.set("name", "On disk");
+        file.set("notes", "Read lazily");
+        QVERIFY(file.saveFile(path));
+
+        INIFile known;
+        known.set("name", "From snapshot");
+        INISettingsObject settings(path, known, INISettingsObject::Contents::Partial);
+        settings.registerSetting("name", "");
+        settings.registerSetting("notes", "");
+
+        // trusted as long as nothing else is needed
+        QCOMPARE(settings.get("name").toString(), QString("From snapshot"));
+        QCOMPARE(settings.get("notes").toString(), QString("Read lazily"));
+        QCOMPARE(settings.get("name").toString(), QString("On disk"));
+
+        // completing it again changes nothing
+        settings.complete(known);
+        QCOMPARE(settings.get("name").toString(), QString("On disk"));
+    }
+};
+
+QTEST_GUILESS_MAIN(InstanceSnapshotTest)
+
+#include "InstanceSnapshot_test.moc"
@@ -0,0 +1,102 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <java/JavaCheckCache.h>
+
+class JavaCheckCacheTest : public QObject {
+    Q_OBJECT
+
+    static QString makeBinary(const QTemporaryDir& dir, const QByteArray& contents)
+    {
+        auto path = dir.filePath("java");
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return {};
+        file.write(contents);
+        file.close();
+        file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+        return path;
+    }
+
+    static JavaCheckResult probed(const QString& path)
+    {
+        JavaCheckResult result;
+        result.path = path;
+        result.validity = JavaCheckResult::Validity::Valid;
+        result.javaVersion = QString("17.0.8");
+        result.javaVendor = "Eclipse Adoptium";
+        result.realPlatform = "amd64";
+        result.is_64bit = true;
+        result.mojangPlatform = "64";
+        return result;
+    }
+
+   private slots:
+    void test_knownUntilChanged()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = makeBinary(dir, "not really java");
+        QVERIFY(!path.isEmpty());
+
+        JavaCheckCache cache;
+        QVERIFY(!cache.result(path));
+
+        cache.put(path, probed(path));
+        auto cached = cache.result(path);
+        QVERIFY(cached);
+        QCOMPARE(cached->validity, JavaCheckResult::Validity::Valid);
+        QCOMPARE(cached->javaVersion.toString(), QString("17.0.8"));
+        QCOMPARE(cached->javaVendor, QString("Eclipse Adoptium"));
+        QCOMPARE(cached->realPlatform, QString("amd64"));
+        QCOMPARE(cached->mojangPlatform, QString("64"));
+        QCOMPARE(cached->path, path);
+
+        // an update replaces the binary
+        makeBinary(dir, "not really java, but newer");
+        QVERIFY(!cache.result(path));
+    }
+
+    void test_onlyValidResults()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = makeBinary(dir, "not really java");
+
+        JavaCheckCache cache;
+        auto result = probed(path);
+        result.validity = JavaCheckResult::Validity::Errored;
+        cache.put(path, result);
+        QVERIFY(!cache.result(path));
+
+        // nothing to look at
+        cache.put(dir.filePath("missing"), probed(dir.filePath("missing")));
+        QVERIFY(!cache.result(dir.filePath("missing")));
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = makeBinary(dir, "not really java");
+        auto cache_file = dir.filePath("javacheckcache.json");
+
+        {
+            JavaCheckCache cache(cache_file);
+            cache.put(path, probed(path));
+            cache.saveNow();
+        }
+
+        JavaCheckCache cache(cache_file);
+        cache.load();
+        auto cached = cache.result(path);
+        QVERIFY(cached);
+        QCOMPARE(cached->javaVersion.toString(), QString("17.0.8"));
+        QVERIFY(cached->is_64bit);
+    }
+};
+
+QTEST_GUILESS_MAIN(JavaCheckCacheTest)
+
+#include "JavaCheckCache_test.moc"
@@ -0,0 +1,89 @@
+#include <QTest>
+
+#include <Json.h>
+
+class JsonReaderTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_readsInOrder()
+    {
+        Json::Reader reader(R"( {"name": "example", "count": -12.5e1, "flags": [true, false, null], "nested": {"a": {}, "b": []}} )");
+        QVERIFY(reader.beginObject());
+        QString key;
+
+        QVERIFY(reader.nextKey(key));
+        QCOMPARE(key, QString("name"));
+        QCOMPARE(reader.peek(), Json::Reader::Type::String);
+        QCOMPARE(reader.readString(), QString("example"));
+
+        QVERIFY(reader.nextKey(key));
+        QCOMPARE(key, QString("count"));
+        QCOMPARE(reader.readNumber(), -125.0);
+
+        QVERIFY(reader.nextKey(key));
+        QCOMPARE(key, QString("flags"));
+        QVERIFY(reader.beginArray());
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readBoolean(), true);
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readBoolean(), false);
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.peek(), Json::Reader::Type::Null);
+        reader.readNull();
+        QVERIFY(!reader.nextElement());
+
+        QVERIFY(reader.nextKey(key));
+        QCOMPARE(key, QString("nested"));
+        reader.skipValue();
+
+        QVERIFY(!reader.nextKey(key));
+        QVERIFY(!reader.hasError());
+    }
+
+    void test_escapes()
+    {
+        Json::Reader reader(R"(["a\"b\\c\/d\n", "caf\u00e9", "\ud83d\ude00", "ünï"])");
+        QVERIFY(reader.beginArray());
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readString(), QString("a\"b\\c/d\n"));
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readString(), QString::fromUtf8("caf\xc3\xa9"));
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readString(), QString::fromUtf8("\xf0\x9f\x98\x80"));
+        QVERIFY(reader.nextElement());
+        QCOMPARE(reader.readString(), QString::fromUtf8("ünï"));
+        QVERIFY(!reader.nextElement());
+        QVERIFY(!reader.hasError());
+    }
+
+    void test_errors()
+    {
+        {
+            Json::Reader reader(R"({"a": 1 "b": 2})");
+            QVERIFY(reader.beginObject());
+            QString key;
+            while (reader.nextKey(key))
+                reader.skipValue();
+            QVERIFY(reader.hasError());
+        }
+        {
+            Json::Reader reader(R"(["unterminated)");
+            QVERIFY(reader.beginArray());
+            QVERIFY(reader.nextElement());
+            reader.readString();
+            QVERIFY(reader.hasError());
+            // stays stopped
+            QVERIFY(!reader.nextElement());
+        }
+        {
+            Json::Reader reader("[]");
+            QVERIFY(!reader.beginObject());
+            QVERIFY(reader.hasError());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(JsonReaderTest)
+
+#include "JsonReader_test.moc"
@@ -0,0 +1,144 @@
+#include <QTest>
+
+#include <Json.h>
+
+// how ensureString read a member before the helpers stopped throwing, to measure them by
+static QString referenceEnsureString(const QJsonObject& parent, const QString& key, const QString& default_)
+{
+    const QString localWhat = QString("__placeholder__").replace("__placeholder__", '\'' + key + '\'');
+    if (!parent.contains(key)) {
+        return default_;
+    }
+    auto value = parent.value(key);
+    if (value.isUndefined() || value.isNull()) {
+        return default_;
+    }
+    try {
+        if (!value.isString()) {
+            throw Json::JsonException(localWhat + " is not a string");
+        }
+        return value.toString();
+    } catch (const Json::JsonException&) {
+        return default_;
+    }
+}
+
+class JsonTest : public QObject {
+    Q_OBJECT
+
+    // a version list the size of the ones for Forge, with the optional members in all their forms
+    static QJsonArray versionList()
+    {
+        QJsonArray versions;
+        for (int i = 0; i < 20000; i++) {
+            QJsonObject version;
+            version.insert("version", QString("1.%1").arg(i));
+            version.insert("releaseTime", "2024-01-01T00:00:00+00:00");
+            switch (i % 3) {
+                case 0:
+                    version.insert("type", "release");
+                    break;
+                case 1:
+                    version.insert("type", QJsonValue::Null);
+                    break;
+                default:
+                    version.insert("type", 17);
+                    break;
+            }
+            versions.append(version);
+        }
+        return versions;
+    }
+
+   private slots:
+    void test_sameMessages()
+    {
+        QJsonObject obj{ { "name", 5 }, { "size", 1.5 } };
+        try {
+            Json::requireString(obj, "name");
+            QFAIL("a number was read as a string");
+        } catch (const Json::JsonException& e) {
+            QCOMPARE(e.cause(), QString("'name' is not a string"));
+        }
+        try {
+            Json::requireString(obj, "missing");
+            QFAIL("a missing member was read");
+        } catch (const Json::JsonException& e) {
+            QCOMPARE(e.cause(), QString("'missing's parent does not contain 'missing'"));
+        }
+        try {
+            Json::requireInteger(obj.value("size"), "Size");
+            QFAIL("a fraction was read as an integer");
+        } catch (const Json::JsonException& e) {
+            QCOMPARE(e.cause(), QString("Size is not an integer"));
+        }
+    }
+
+    void test_ensureFallsBack()
+    {
+        QJsonObject obj{ { "name", 5 }, { "empty", QJsonValue::Null }, { "title", "Example" } };
+        QCOMPARE(Json::ensureString(obj, "name", "default"), QString("default"));
+        QCOMPARE(Json::ensureString(obj, "empty", "default"), QString("default"));
+        QCOMPARE(Json::ensureString(obj, "missing", "default"), QString("default"));
+        QCOMPARE(Json::ensureString(obj, "title", "default"), QString("Example"));
+        QCOMPARE(Json::ensureInteger(QJsonValue(2.5), 7), 7);
+        QCOMPARE(Json::ensureUrl(obj, "empty"), QUrl());
+        QVERIFY(Json::ensureUuid(QJsonValue("not a uuid")).isNull());
+    }
+
+    void test_requireIfPresent()
+    {
+        QJsonObject obj{ { "order", 3 }, { "hint", true } };
+        int order = -1;
+        QVERIFY(Json::requireIfPresent(obj, "order", order));
+        QCOMPARE(order, 3);
+        QString missing = "untouched";
+        QVERIFY(!Json::requireIfPresent(obj, "missing", missing));
+        QCOMPARE(missing, QString("untouched"));
+        QString hint;
+        QVERIFY_EXCEPTION_THROWN(Json::requireIfPresent(obj, "hint", hint), Json::JsonException);
+    }
+
+    void benchmark_referenceEnsure()
+    {
+        auto versions = versionList();
+        QBENCHMARK
+        {
+            for (auto version : versions) {
+                auto obj = version.toObject();
+                referenceEnsureString(obj, "type", QString());
+                referenceEnsureString(obj, "missing", QString());
+            }
+        }
+    }
+
+    void benchmark_ensure()
+    {
+        auto versions = versionList();
+        QBENCHMARK
+        {
+            for (auto version : versions) {
+                auto obj = version.toObject();
+                Json::ensureString(obj, "type", QString());
+                Json::ensureString(obj, "missing", QString());
+            }
+        }
+    }
+
+    void benchmark_require()
+    {
+        auto versions = versionList();
+        QBENCHMARK
+        {
+            for (auto version : versions) {
+                auto obj = Json::requireObject(version);
+                Json::requireString(obj, "version");
+                Json::requireString(obj, "releaseTime");
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(JsonTest)
+
+#include "Json_test.moc"
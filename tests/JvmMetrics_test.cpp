@@ -0,0 +1,66 @@
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <launch/JvmMetrics.h>
+
+class JvmMetricsTest : public QObject {
+    Q_OBJECT
+
+    /// the token the launch script hands to the game
+    static QByteArray tokenOf(const JvmMetrics& metrics)
+    {
+        auto lines = metrics.launchScriptLines().split('\n');
+        return lines[1].section(' ', 1).toUtf8();
+    }
+
+    static quint16 portOf(const JvmMetrics& metrics) { return metrics.launchScriptLines().section('\n', 0, 0).section(' ', 1).toUShort(); }
+
+   private slots:
+    void test_parseSample()
+    {
+        auto sample = JvmMetrics::parseSample("sample 61000 104857600 209715200 4294967296 12 340 0.25 48\n");
+        QVERIFY(sample.has_value());
+        QCOMPARE(sample->uptimeMs, qint64(61000));
+        QCOMPARE(sample->heapUsed, qint64(104857600));
+        QCOMPARE(sample->heapCommitted, qint64(209715200));
+        QCOMPARE(sample->heapMax, qint64(4294967296));
+        QCOMPARE(sample->gcCount, qint64(12));
+        QCOMPARE(sample->gcTimeMs, qint64(340));
+        QCOMPARE(sample->cpuLoad, 0.25);
+        QCOMPARE(sample->threads, 48);
+
+        QCOMPARE(JvmMetrics::parseSample("sample 1 -1 2 -1 0 0 -1.0 3")->heapMax, qint64(-1));
+        QVERIFY(!JvmMetrics::parseSample("sample 1 2 3"));
+        QVERIFY(!JvmMetrics::parseSample("sample 1 2 3 4 5 6 x 8"));
+        QVERIFY(!JvmMetrics::parseSample("heap 1 2 3 4 5 6 0.5 8"));
+    }
+
+    void test_report()
+    {
+        JvmMetrics metrics;
+        QVERIFY(metrics.isListening());
+        QSignalSpy added(&metrics, &JvmMetrics::samplesAdded);
+
+        // without the token, nothing it says counts
+        QTcpSocket stranger;
+        stranger.connectToHost(QHostAddress::LocalHost, portOf(metrics));
+        QVERIFY(stranger.waitForConnected());
+        stranger.write("hello nope\nsample 1 2 3 4 5 6 0.5 8\n");
+        QTRY_COMPARE(stranger.state(), QAbstractSocket::UnconnectedState);
+        QVERIFY(metrics.samples().isEmpty());
+
+        QTcpSocket game;
+        game.connectToHost(QHostAddress::LocalHost, portOf(metrics));
+        QVERIFY(game.waitForConnected());
+        game.write("hello " + tokenOf(metrics) + "\nsample 1000 10 20 30 0 0 0.1 5\nsample 2000 11 20 30 1 4 0.2 6\n");
+        QTRY_COMPARE(metrics.samples().size(), 2);
+        QVERIFY(added.count() >= 1);
+        QCOMPARE(metrics.samples().last().gcTimeMs, qint64(4));
+        QVERIFY(!metrics.isListening());
+    }
+};
+
+QTEST_GUILESS_MAIN(JvmMetricsTest)
+
+#include "JvmMetrics_test.moc"
@@ -0,0 +1,102 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+
+#include <java/JvmTuning.h>
+
+static const uint64_t gibibyte = 1024ull * 1024ull * 1024ull;
+
+class JvmTuningTest : public QObject {
+    Q_OBJECT
+
+    JvmTuning::Inputs bigPack()
+    {
+        JvmTuning::Inputs inputs;
+        inputs.javaMajor = 21;
+        inputs.modded = true;
+        inputs.forgeLike = true;
+        inputs.modCount = 300;
+        inputs.totalRam = 32 * gibibyte;
+        inputs.availableRam = 24 * gibibyte;
+        return inputs;
+    }
+
+   private slots:
+    void test_vanilla()
+    {
+        JvmTuning::Inputs inputs;
+        inputs.javaMajor = 21;
+        inputs.totalRam = 16 * gibibyte;
+        inputs.availableRam = 12 * gibibyte;
+        auto tuning = JvmTuning::tune(inputs);
+        QCOMPARE(tuning.maxHeap, 2048);
+        QCOMPARE(tuning.minHeap, 1024);
+        QCOMPARE(tuning.gcArguments.first(), "-XX:+UseG1GC");
+    }
+
+    void test_bigPack()
+    {
+        auto tuning = JvmTuning::tune(bigPack());
+        QCOMPARE(tuning.maxHeap, 6912);
+        QCOMPARE(tuning.minHeap, 3456);
+        QCOMPARE(tuning.gcArguments, QStringList({ "-XX:+UseZGC", "-XX:+ZGenerational" }));
+    }
+
+    void test_limitedByMemory()
+    {
+        auto inputs = bigPack();
+        inputs.totalRam = 8 * gibibyte;
+        inputs.availableRam = 6 * gibibyte;
+        auto tuning = JvmTuning::tune(inputs);
+        QCOMPARE(tuning.maxHeap, 5632);
+        QCOMPARE(tuning.gcArguments.first(), "-XX:+UseG1GC");
+
+        inputs.is64Bit = false;
+        QCOMPARE(JvmTuning::tune(inputs).maxHeap, 1024);
+    }
+
+    void test_collectorByVendor()
+    {
+        auto inputs = bigPack();
+        inputs.javaMajor = 17;
+        inputs.javaVendor = "Eclipse Adoptium";
+        QCOMPARE(JvmTuning::tune(inputs).gcArguments, QStringList({ "-XX:+UseShenandoahGC" }));
+        inputs.javaVendor = "Oracle Corporation";
+        QCOMPARE(JvmTuning::tune(inputs).gcArguments.first(), "-XX:+UseG1GC");
+    }
+
+    void test_previousSession()
+    {
+        auto inputs = bigPack();
+        inputs.previousSession = { 1500, 2048, false };
+        QCOMPARE(JvmTuning::tune(inputs).maxHeap, 3072);
+        inputs.previousSession = { 1500, 4096, true };
+        QCOMPARE(JvmTuning::tune(inputs).maxHeap, 5120);
+    }
+
+    void test_readGcLog()
+    {
+        QTemporaryDir tmp;
+        auto path = FS::PathCombine(tmp.path(), "gc.log");
+        QVERIFY(!JvmTuning::readGcLog(path).isValid());
+
+        FS::write(path,
+                  "[0.5s][info][gc] GC(0) Pause Young (Normal) (G1 Evacuation Pause) 512M->128M(1024M) 3.456ms\n"
+                  "[9.1s][info][gc] GC(5) Pause Full (G1 Compaction Pause) 2G->1500M(2G) 300.123ms\n");
+        auto g1 = JvmTuning::readGcLog(path);
+        QCOMPARE(g1.peakLive, 1500);
+        QCOMPARE(g1.peakCommitted, 2048);
+        QVERIFY(g1.underPressure);
+
+        FS::write(path, "[3.2s][info][gc] GC(0) Garbage Collection (Warmup) 1024M(17%)->208M(3%)\n");
+        auto zgc = JvmTuning::readGcLog(path);
+        QCOMPARE(zgc.peakLive, 208);
+        QCOMPARE(zgc.peakCommitted, 1024);
+        QVERIFY(!zgc.underPressure);
+    }
+};
+
+QTEST_GUILESS_MAIN(JvmTuningTest)
+
+#include "JvmTuning_test.moc"
@@ -0,0 +1,65 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/LaunchPlan.h>
+
+class LaunchPlanTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = dir.filePath(".launchplan.json");
+
+        LaunchPlan plan;
+        plan.key = "c0ffee";
+        plan.classPath = QStringList{ "/libraries/a.jar", "/libraries/b.jar" };
+        plan.nativeJars = QStringList{ "/libraries/lwjgl-natives.jar" };
+        plan.mainClass = "net.minecraft.client.main.Main";
+        plan.jvmArguments = QStringList{ "-javaagent:/libraries/agent.jar=debug" };
+        plan.minecraftArguments = "--username ${auth_player_name} --version ${version_name}";
+        plan.minecraftVersion = "1.20.1";
+        plan.minecraftVersionType = "release";
+        plan.assetsId = "5";
+        plan.traits = { "FirstThreadOnMacOS" };
+        plan.save(path);
+
+        auto loaded = LaunchPlan::load(path, "c0ffee");
+        QVERIFY(loaded);
+        QCOMPARE(loaded->classPath, plan.classPath);
+        QCOMPARE(loaded->nativeJars, plan.nativeJars);
+        QCOMPARE(loaded->mainClass, plan.mainClass);
+        QVERIFY(loaded->appletClass.isEmpty());
+        QCOMPARE(loaded->jvmArguments, plan.jvmArguments);
+        QCOMPARE(loaded->minecraftArguments, plan.minecraftArguments);
+        QCOMPARE(loaded->minecraftVersion, plan.minecraftVersion);
+        QCOMPARE(loaded->minecraftVersionType, plan.minecraftVersionType);
+        QCOMPARE(loaded->assetsId, plan.assetsId);
+        QCOMPARE(loaded->traits, plan.traits);
+    }
+
+    void test_outdated()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = dir.filePath(".launchplan.json");
+
+        QVERIFY(!LaunchPlan::load(path, "c0ffee"));
+
+        LaunchPlan plan;
+        plan.key = "c0ffee";
+        plan.mainClass = "net.minecraft.client.main.Main";
+        plan.save(path);
+
+        // the components changed since
+        QVERIFY(!LaunchPlan::load(path, "decaf"));
+        // nothing to tell whether they did
+        QVERIFY(!LaunchPlan::load(path, QString()));
+    }
+};
+
+QTEST_GUILESS_MAIN(LaunchPlanTest)
+
+#include "LaunchPlan_test.moc"
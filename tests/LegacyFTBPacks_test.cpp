@@ -0,0 +1,51 @@
+#include <QBuffer>
+#include <QTest>
+
+#include <modplatform/legacy_ftb/PackFetchTask.h>
+
+class LegacyFTBPacksTest : public QObject {
+    Q_OBJECT
+
+    static bool parse(QByteArray data, LegacyFTB::ModpackList& list, QString* error = nullptr)
+    {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        return LegacyFTB::PackFetchTask::parsePacks(&buffer, LegacyFTB::PackType::ThirdParty, list, error);
+    }
+
+   private slots:
+    void test_parsePacks()
+    {
+        LegacyFTB::ModpackList list;
+        QVERIFY(parse(R"(<?xml version="1.0" encoding="UTF-8"?>
+<modpacks>
+    <modpack name="Direwolf20" author="FTB" version="1.0.2" mcVersion="1.7.10" oldVersions="1.0.2;;1.0.1" dir="direwolf20"
+        url="direwolf20.zip" logo="dw20.png" mods="Lots" description="A pack"/>
+    <modpack name="Empty" version="" oldVersions=""/>
+    <something name="Not a pack"/>
+</modpacks>)",
+                      list));
+        QCOMPARE(list.size(), 2);
+        auto& pack = list[0];
+        QCOMPARE(pack.name, QString("Direwolf20"));
+        QCOMPARE(pack.mcVersion, QString("1.7.10"));
+        QCOMPARE(pack.oldVersions, (QStringList{ "1.0.2", "1.0.1" }));
+        QVERIFY(pack.bugged);
+        QVERIFY(!pack.broken);
+        QCOMPARE(pack.file, QString("direwolf20.zip"));
+        QCOMPARE(pack.type, LegacyFTB::PackType::ThirdParty);
+        QVERIFY(list[1].broken);
+    }
+
+    void test_reportsErrors()
+    {
+        LegacyFTB::ModpackList list;
+        QString error;
+        QVERIFY(!parse("<modpacks><modpack name=\"a\"></modpacks>", list, &error));
+        QVERIFY(!error.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(LegacyFTBPacksTest)
+
+#include "LegacyFTBPacks_test.moc"
@@ -72,6 +72,21 @@ class LibraryTest : public QObject {
         cache->addBase("libraries", QDir("libraries").absolutePath());
         dataDir = QDir(QFINDTESTDATA("testdata/Library")).absolutePath();
     }
+    void test_rules()
+    {
+        Library lib("org.lwjgl.lwjgl:lwjgl:2.9.1");
+        lib.setRules({ ImplicitRule::create(Allow), OsRule::create(Disallow, "osx", QString()) });
+        QVERIFY(lib.isActive(dummyContext("linux")));
+        QVERIFY(!lib.isActive(dummyContext("osx")));
+        // remembered for the last classifier only, asking for another one works it out again
+        QVERIFY(lib.isActive(dummyContext("linux")));
+        QVERIFY(lib.isActive(dummyContext("osx", "64", "aarch64")));
+        QVERIFY(!lib.isActive(dummyContext("osx")));
+
+        lib.setRules({ OsRule::create(Allow, "osx", QString()) });
+        QVERIFY(lib.isActive(dummyContext("osx")));
+        QVERIFY(!lib.isActive(dummyContext("linux")));
+    }
     void test_legacy()
     {
         RuntimeContext r = dummyContext();
@@ -0,0 +1,56 @@
+#include <QTest>
+
+#include <launch/LogModel.h>
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+    void fill(LogModel& model, int lines)
+    {
+        QStringList batch;
+        QVector<MessageLevel::Enum> levels;
+        for (int i = 0; i < lines; i++) {
+            batch.append(i % 1000 == 500 ? QString("[main/ERROR] Needle number %1").arg(i) : QString("hay %1").arg(i));
+            levels.append(i % 1000 == 500 ? MessageLevel::Error : MessageLevel::Message);
+        }
+        model.append(batch, levels);
+    }
+
+   private slots:
+    void test_find()
+    {
+        LogModel model;
+        model.setMaxLines(10000);
+        fill(model, 10000);
+
+        QCOMPARE(model.find("needle", -1, false), 500);
+        QCOMPARE(model.find("NEEDLE", 500, false), 1500);
+        // wraps around
+        QCOMPARE(model.find("needle", 9500, false), 500);
+        QCOMPARE(model.find("needle", 1500, true), 500);
+        QCOMPARE(model.find("needle", 500, true), 9500);
+        // too short for the index
+        QCOMPARE(model.find("ne", -1, false), 500);
+        QCOMPARE(model.find("nothing like this", -1, false), -1);
+        // level filtered
+        QCOMPARE(model.find("number", -1, false, 1u << MessageLevel::Warning), -1);
+        QCOMPARE(model.find("number", -1, false, 1u << MessageLevel::Error), 500);
+    }
+
+    void test_findAfterOverflow()
+    {
+        LogModel model;
+        model.setMaxLines(2000);
+        fill(model, 5000);
+
+        QCOMPARE(model.rowCount(), 2000);
+        // the first kept line is line 3000, so 'Needle number 3500' is row 500
+        auto row = model.find("needle", -1, false);
+        QCOMPARE(row, 500);
+        QCOMPARE(model.data(model.index(row), Qt::DisplayRole).toString(), QString("[main/ERROR] Needle number 3500"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
@@ -0,0 +1,49 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <launch/LogStore.h>
+
+class LogStoreTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_appendAndRead()
+    {
+        QTemporaryDir spill;
+        LogStore store(spill.path());
+        // enough lines for plenty of sealed and spilled chunks
+        for (int i = 0; i < 100000; i++) {
+            store.append(i % 7 ? MessageLevel::Message : MessageLevel::Error, QString("line %1 ünïcödé").arg(i));
+        }
+        QCOMPARE(store.size(), 100000);
+        for (int i : { 0, 1, 4095, 4096, 50000, 99999 }) {
+            QCOMPARE(store.line(i), QString("line %1 ünïcödé").arg(i));
+            QCOMPARE(store.level(i), i % 7 ? MessageLevel::Message : MessageLevel::Error);
+        }
+    }
+
+    void test_removeFirst()
+    {
+        LogStore store(QString{});
+        for (int i = 0; i < 10000; i++) {
+            store.append(MessageLevel::Message, QString::number(i));
+        }
+        store.removeFirst(5000);
+        QCOMPARE(store.size(), 5000);
+        QCOMPARE(store.line(0), QString("5000"));
+        QCOMPARE(store.line(4999), QString("9999"));
+
+        store.append(MessageLevel::Message, "last");
+        QCOMPARE(store.line(5000), QString("last"));
+
+        store.removeFirst(store.size());
+        QCOMPARE(store.size(), 0);
+        store.append(MessageLevel::Warning, "again");
+        QCOMPARE(store.line(0), QString("again"));
+        QCOMPARE(store.level(0), MessageLevel::Warning);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogStoreTest)
+
+#include "LogStore_test.moc"
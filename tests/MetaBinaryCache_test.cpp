@@ -0,0 +1,84 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <meta/VersionList.h>
+
+class MetaBinaryCacheTest : public QObject {
+    Q_OBJECT
+
+    static bool writeList(const QByteArray& versions)
+    {
+        QDir().mkpath("meta/net.minecraft");
+        QFile file("meta/net.minecraft/index.json");
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        file.write(R"({"formatVersion": 1, "uid": "net.minecraft", "name": "Minecraft", "versions": [)" + versions + "]}");
+        return true;
+    }
+
+    QString m_oldDir;
+    QTemporaryDir m_dir;
+
+   private slots:
+    void init()
+    {
+        QVERIFY(m_dir.isValid());
+        m_oldDir = QDir::currentPath();
+        QDir::setCurrent(m_dir.path());
+        QDir("meta").removeRecursively();
+    }
+
+    void cleanup() { QDir::setCurrent(m_oldDir); }
+
+    void test_sameAsParsed()
+    {
+        QVERIFY(writeList(R"({"version": "1.20.1", "releaseTime": "2023-06-12T13:25:51+00:00", "type": "release",
+                              "requires": [{"uid": "org.lwjgl3", "suggests": "3.3.1"}]},
+                             {"version": "23w31a", "releaseTime": "2023-08-01T11:03:19+00:00", "type": "snapshot"})"));
+
+        Meta::VersionList parsed("net.minecraft");
+        parsed.load(Net::Mode::Offline);
+        QVERIFY(QFile::exists("meta/net.minecraft/index.json.bin"));
+
+        Meta::VersionList cached("net.minecraft");
+        cached.load(Net::Mode::Offline);
+        QCOMPARE(cached.name(), QString("Minecraft"));
+        QCOMPARE(cached.count(), 2);
+        for (int i = 0; i < 2; i++) {
+            auto a = parsed.versions().at(i);
+            auto b = cached.versions().at(i);
+            QCOMPARE(b->version(), a->version());
+            QCOMPARE(b->type(), a->type());
+            QCOMPARE(b->rawTime(), a->rawTime());
+            QCOMPARE(b->requiredSet().size(), a->requiredSet().size());
+        }
+        auto release = cached.getVersion("1.20.1");
+        QCOMPARE(release->requiredSet().size(), size_t(1));
+        Meta::Require lwjgl{ "org.lwjgl3", "", "3.3.1" };
+        QVERIFY(release->requiredSet().begin()->deepEquals(lwjgl));
+    }
+
+    void test_changedFile()
+    {
+        QVERIFY(writeList(R"({"version": "1.20.1", "releaseTime": "2023-06-12T13:25:51+00:00", "type": "release"})"));
+        {
+            Meta::VersionList list("net.minecraft");
+            list.load(Net::Mode::Offline);
+            QCOMPARE(list.count(), 1);
+        }
+
+        // a fresher list came in, the cache of the old one doesn't count anymore
+        QVERIFY(writeList(R"({"version": "1.20.2", "releaseTime": "2023-09-20T09:02:57+00:00", "type": "release"},
+                             {"version": "1.20.1", "releaseTime": "2023-06-12T13:25:51+00:00", "type": "release"})"));
+        Meta::VersionList list("net.minecraft");
+        list.load(Net::Mode::Offline);
+        QCOMPARE(list.count(), 2);
+        QVERIFY(list.hasVersion("1.20.2"));
+    }
+};
+
+QTEST_GUILESS_MAIN(MetaBinaryCacheTest)
+
+#include "MetaBinaryCache_test.moc"
@@ -0,0 +1,102 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/MetaCacheJournal.h>
+
+class MetaCacheJournalTest : public QObject {
+    Q_OBJECT
+
+    static QList<QByteArray> replay(const QString& path, bool* ok = nullptr)
+    {
+        QList<QByteArray> records;
+        MetaCacheJournal journal(path);
+        auto loaded = journal.load([&records](const QByteArray& record) { records.append(QByteArray(record.constData(), record.size())); });
+        if (ok)
+            *ok = loaded;
+        return records;
+    }
+
+   private slots:
+    void test_appendAndReplay()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("metacache.journal");
+
+        bool ok = true;
+        QVERIFY(replay(path, &ok).isEmpty());
+        QVERIFY(!ok);
+
+        MetaCacheJournal journal(path);
+        journal.append("first");
+        journal.append("second");
+        QVERIFY(journal.hasPending());
+        QVERIFY(journal.flush());
+        journal.append(QByteArray());
+        journal.append("fourth");
+        QCOMPARE(journal.recordCount(), 4);
+        QVERIFY(journal.flush());
+
+        QCOMPARE(replay(path, &ok), (QList<QByteArray>{ "first", "second", QByteArray(), "fourth" }));
+        QVERIFY(ok);
+    }
+
+    void test_compact()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("metacache.journal");
+
+        MetaCacheJournal journal(path);
+        for (int i = 0; i < 100; i++)
+            journal.append(QByteArray::number(i));
+        QVERIFY(journal.flush());
+        journal.append("dropped");
+        QVERIFY(journal.compact({ "only" }));
+        QCOMPARE(journal.recordCount(), 1);
+        QVERIFY(!journal.hasPending());
+
+        QCOMPARE(replay(path), QList<QByteArray>{ "only" });
+    }
+
+    void test_tornTail()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("metacache.journal");
+
+        MetaCacheJournal journal(path);
+        journal.append("kept");
+        journal.append("torn apart");
+        QVERIFY(journal.flush());
+
+        // lose the end of the last record, like a crash in the middle of a write would
+        QFile file(path);
+        QVERIFY(file.resize(file.size() - 3));
+
+        QCOMPARE(replay(path), QList<QByteArray>{ "kept" });
+
+        // the garbage is gone, so new records are readable again
+        MetaCacheJournal reopened(path);
+        QVERIFY(reopened.load([](const QByteArray&) {}));
+        reopened.append("after");
+        QVERIFY(reopened.flush());
+        QCOMPARE(replay(path), (QList<QByteArray>{ "kept", "after" }));
+    }
+
+    void test_unknownFormat()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("metacache.journal");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("{\"version\": \"1\"}");
+        file.close();
+
+        bool ok = true;
+        QVERIFY(replay(path, &ok).isEmpty());
+        QVERIFY(!ok);
+    }
+};
+
+QTEST_GUILESS_MAIN(MetaCacheJournalTest)
+
+#include "MetaCacheJournal_test.moc"
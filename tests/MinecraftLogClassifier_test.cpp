@@ -0,0 +1,111 @@
+#include <QFile>
+#include <QTest>
+
+#include <minecraft/MinecraftLogClassifier.h>
+
+Q_DECLARE_METATYPE(MessageLevel::Enum)
+
+class MinecraftLogClassifierTest : public QObject {
+    Q_OBJECT
+
+    // a few lines out of a typical Forge client log, used when no captured log is given
+    QStringList syntheticLog()
+    {
+        static const QStringList sample = {
+            "[12:00:01] [main/INFO]: Loading tweak class name net.minecraftforge.fml.common.launcher.FMLTweaker",
+            "[12:00:02] [Render thread/DEBUG] [net.minecraftforge.registries.GameData/REGISTRIES]: Registry Block Add: minecraft:stone",
+            "[12:00:02] [Worker-Main-1/WARN] [mixin/]: Reference map 'examplemod.refmap.json' could not be read",
+            "2013-08-01 12:00:03 [INFO] [ForgeModLoader] Forge Mod Loader version 6.2.62.771 for Minecraft 1.6.2 loading",
+            "2013-08-01 12:00:03 [SEVERE] [ForgeModLoader] Caught exception from examplemod",
+            "java.lang.NullPointerException: Cannot invoke \"Object.toString()\" because \"value\" is null",
+            "\tat net.minecraft.client.Minecraft.run(Minecraft.java:123)",
+            "\t... 12 more",
+            "Just a plain line printed by some mod",
+        };
+        QStringList lines;
+        lines.reserve(sample.size() * 20000);
+        for (int i = 0; i < 20000; i++) {
+            lines.append(sample);
+        }
+        return lines;
+    }
+
+   private slots:
+    void test_classify_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<MessageLevel::Enum>("input");
+        QTest::addColumn<MessageLevel::Enum>("expected");
+
+        QTest::newRow("log4j info") << "[12:00:01] [main/INFO]: Setting user: Steve" << MessageLevel::StdOut << MessageLevel::Message;
+        QTest::newRow("log4j warn") << "[12:00:01] [main/WARN]: Something odd" << MessageLevel::StdOut << MessageLevel::Warning;
+        QTest::newRow("log4j error") << "[12:00:01] [main/ERROR]: It broke" << MessageLevel::StdOut << MessageLevel::Error;
+        QTest::newRow("log4j fatal") << "[12:00:01] [main/FATAL]: It broke badly" << MessageLevel::StdOut << MessageLevel::Fatal;
+        QTest::newRow("log4j debug") << "[12:00:01] [main/DEBUG]: Details" << MessageLevel::StdOut << MessageLevel::Debug;
+        QTest::newRow("log4j trace") << "[12:00:01] [main/TRACE]: More details" << MessageLevel::StdOut << MessageLevel::Debug;
+        QTest::newRow("forge info") << "2013-08-01 12:00:03 [INFO] [ForgeModLoader] Loading" << MessageLevel::StdErr
+                                    << MessageLevel::Message;
+        QTest::newRow("forge severe") << "2013-08-01 12:00:03 [SEVERE] [ForgeModLoader] Failed" << MessageLevel::StdErr
+                                      << MessageLevel::Error;
+        QTest::newRow("forge warning") << "2013-08-01 12:00:03 [WARNING] [ForgeModLoader] Hmm" << MessageLevel::StdErr
+                                       << MessageLevel::Warning;
+        QTest::newRow("overwriting") << "[12:00:01] [main/INFO]: overwriting existing entry" << MessageLevel::StdOut
+                                     << MessageLevel::Fatal;
+        QTest::newRow("exception in thread") << "Exception in thread \"main\"" << MessageLevel::StdErr << MessageLevel::Error;
+        QTest::newRow("stack frame") << "\tat net.minecraft.client.Minecraft.run(Minecraft.java:123)" << MessageLevel::StdErr
+                                     << MessageLevel::Error;
+        QTest::newRow("caused by") << "Caused by: java.lang.IllegalStateException: nope" << MessageLevel::StdErr << MessageLevel::Error;
+        QTest::newRow("throwable") << "java.lang.NullPointerException" << MessageLevel::StdErr << MessageLevel::Error;
+        QTest::newRow("more frames") << "\t... 12 more" << MessageLevel::StdErr << MessageLevel::Error;
+        QTest::newRow("plain stdout") << "Just a plain line" << MessageLevel::StdOut << MessageLevel::StdOut;
+        QTest::newRow("plain unknown") << "at the end of the day" << MessageLevel::Unknown << MessageLevel::Unknown;
+    }
+
+    void test_classify()
+    {
+        QFETCH(QString, line);
+        QFETCH(MessageLevel::Enum, input);
+        QFETCH(MessageLevel::Enum, expected);
+
+        MinecraftLogClassifier classifier;
+        QCOMPARE(classifier.classify(line, input), expected);
+    }
+
+    void test_classifyBatch()
+    {
+        MinecraftLogClassifier classifier;
+        QStringList lines = { "[12:00:01] [main/WARN]: Something odd", "[12:00:01] [main/WARN]: Already known",
+                              "Caused by: java.lang.IllegalStateException: nope" };
+        QVector<MessageLevel::Enum> levels = { MessageLevel::StdOut, MessageLevel::Launcher, MessageLevel::StdErr };
+        classifier.classify(lines, levels);
+        QCOMPARE(levels[0], MessageLevel::Warning);
+        // lines with a known level are left alone
+        QCOMPARE(levels[1], MessageLevel::Launcher);
+        QCOMPARE(levels[2], MessageLevel::Error);
+    }
+
+    // set PRISM_BENCHMARK_LOG to a captured game log (for example a large Forge debug log) to benchmark against it
+    void benchmark_classifyBatch()
+    {
+        QStringList lines;
+        auto path = qEnvironmentVariable("PRISM_BENCHMARK_LOG");
+        if (!path.isEmpty()) {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            lines = QString::fromUtf8(file.readAll()).remove(QChar::CarriageReturn).split(QChar::LineFeed);
+        } else {
+            lines = syntheticLog();
+        }
+
+        MinecraftLogClassifier classifier;
+        QBENCHMARK
+        {
+            QVector<MessageLevel::Enum> levels(lines.size(), MessageLevel::StdOut);
+            classifier.classify(lines, levels);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MinecraftLogClassifierTest)
+
+#include "MinecraftLogClassifier_test.moc"
@@ -0,0 +1,32 @@
+#include <QTest>
+
+#include <net/Mirrors.h>
+
+class MirrorsTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_knownMirror()
+    {
+        QUrl url("https://piston-data.mojang.com/v1/objects/abcdef/client.jar");
+        auto urls = Net::withMirrors(url);
+        QCOMPARE(urls.size(), 2);
+        QCOMPARE(urls[0], url);
+        QCOMPARE(urls[1], QUrl("https://launcher.mojang.com/v1/objects/abcdef/client.jar"));
+
+        // the other way around too
+        urls = Net::withMirrors(QUrl("https://repo.maven.apache.org/maven2/org/ow2/asm/asm/9.6/asm-9.6.jar"));
+        QCOMPARE(urls.size(), 2);
+        QCOMPARE(urls[1], QUrl("https://repo1.maven.org/maven2/org/ow2/asm/asm/9.6/asm-9.6.jar"));
+    }
+
+    void test_noMirror()
+    {
+        QUrl url("https://libraries.minecraft.net/com/mojang/brigadier/1.0.18/brigadier-1.0.18.jar");
+        QCOMPARE(Net::withMirrors(url), QList<QUrl>{ url });
+    }
+};
+
+QTEST_GUILESS_MAIN(MirrorsTest)
+
+#include "Mirrors_test.moc"
@@ -0,0 +1,83 @@
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/mod/ModDetailsCache.h>
+
+class ModDetailsCacheTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), data.size());
+    }
+
+    static ModDetails details()
+    {
+        ModDetails details;
+        details.mod_id = "examplemod";
+        details.name = "Example Mod";
+        details.version = "1.2.3";
+        details.authors = QStringList{ "Someone", "Someone Else" };
+        details.licenses.append(ModLicense("MIT", "MIT", "https://opensource.org/licenses/MIT", "MIT"));
+        details.icon_file = "assets/examplemod/icon.png";
+        details.bundled.append({ "META-INF/jars/library.jar", "library", "Library", "0.4.2" });
+        return details;
+    }
+
+   private slots:
+    void test_changedFileMisses()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto jar = dir.filePath("example.jar");
+        writeFile(jar, "not really a jar");
+
+        ModDetailsCache cache;
+        QVERIFY(!cache.get(jar));
+
+        cache.put(jar, details());
+        auto cached = cache.get(jar);
+        QVERIFY(cached);
+        QCOMPARE(cached->mod_id, QString("examplemod"));
+        QCOMPARE(cached->authors, details().authors);
+
+        writeFile(jar, "a different jar now");
+        QVERIFY(!cache.get(jar));
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto jar = dir.filePath("example.jar");
+        writeFile(jar, "not really a jar");
+        auto cache_file = dir.filePath("moddetailscache.json");
+
+        {
+            ModDetailsCache cache(cache_file);
+            cache.put(jar, details());
+            cache.saveNow();
+        }
+
+        ModDetailsCache cache(cache_file);
+        cache.load();
+        auto cached = cache.get(jar);
+        QVERIFY(cached);
+        QCOMPARE(cached->name, QString("Example Mod"));
+        QCOMPARE(cached->version, QString("1.2.3"));
+        QCOMPARE(cached->icon_file, QString("assets/examplemod/icon.png"));
+        QCOMPARE(cached->licenses.size(), 1);
+        QCOMPARE(cached->licenses.first().url, QString("https://opensource.org/licenses/MIT"));
+        QCOMPARE(cached->bundled.size(), 1);
+        QCOMPARE(cached->bundled.first().path, QString("META-INF/jars/library.jar"));
+        QCOMPARE(cached->bundled.first().version, QString("0.4.2"));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsCacheTest)
+
+#include "ModDetailsCache_test.moc"
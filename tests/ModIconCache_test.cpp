@@ -0,0 +1,47 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/mod/ModIconCache.h>
+
+class ModIconCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_thumbnail()
+    {
+        QImage big(512, 256, QImage::Format_ARGB32);
+        big.fill(Qt::red);
+        auto thumbnail = ModIconCache::thumbnail(big);
+        // it has to fill the square it's drawn in
+        QCOMPARE(thumbnail.size(), QSize(128, 64));
+
+        QImage small(16, 16, QImage::Format_ARGB32);
+        small.fill(Qt::blue);
+        QCOMPARE(ModIconCache::thumbnail(small).size(), QSize(16, 16));
+    }
+
+    void test_putAndGet()
+    {
+        QTemporaryDir tmp;
+        ModIconCache cache(tmp.path());
+
+        auto hash = QString("0123456789abcdef0123456789abcdef01234567");
+        QVERIFY(cache.get(hash).isNull());
+
+        QImage icon(64, 64, QImage::Format_ARGB32);
+        icon.fill(Qt::green);
+        cache.put(hash, icon);
+
+        auto cached = cache.get(hash);
+        QCOMPARE(cached.size(), icon.size());
+        QCOMPARE(cached.pixelColor(10, 10), QColor(Qt::green));
+
+        // nothing to key them by
+        cache.put("", icon);
+        QVERIFY(cache.get("").isNull());
+    }
+};
+
+QTEST_GUILESS_MAIN(ModIconCacheTest)
+
+#include "ModIconCache_test.moc"
@@ -0,0 +1,65 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include <minecraft/mod/ModInventory.h>
+
+class ModInventoryTest : public QObject {
+    Q_OBJECT
+
+    static ModInventory::Entry entry(const QString& instance, const QString& modId, const QString& version, const QString& sha1)
+    {
+        ModInventory::Entry entry;
+        entry.instanceId = instance;
+        entry.modId = modId;
+        entry.name = modId.toUpper();
+        entry.version = version;
+        entry.fileName = modId + "-" + version + ".jar";
+        entry.sha1 = sha1;
+        return entry;
+    }
+
+   private slots:
+    void test_queries()
+    {
+        ModInventory inventory;
+        QSignalSpy changed(&inventory, &ModInventory::changed);
+        inventory.update("a", { entry("a", "sodium", "0.5.3", "aaaa"), entry("a", "lithium", "0.11", "bbbb") });
+        inventory.update("b", { entry("b", "sodium", "0.5.8", "cccc") });
+        QCOMPARE(changed.count(), 2);
+        QCOMPARE(inventory.instanceCount(), 2);
+        QCOMPARE(inventory.modCount(), 3);
+
+        QCOMPARE(inventory.withModId("Sodium").size(), 2);
+        auto old = inventory.withModId("sodium", "0.5.3");
+        QCOMPARE(old.size(), 1);
+        QCOMPARE(old[0].instanceId, QString("a"));
+
+        auto byHash = inventory.withHash("CCCC");
+        QCOMPARE(byHash.size(), 1);
+        QCOMPARE(byHash[0].instanceId, QString("b"));
+
+        // neither an id nor a hash, so it's looked for in the names
+        QCOMPARE(inventory.find("lith").size(), 1);
+        QCOMPARE(inventory.find("0.5.8.jar").size(), 1);
+        QCOMPARE(inventory.find("  ").size(), 0);
+    }
+
+    void test_replace()
+    {
+        ModInventory inventory;
+        inventory.update("a", { entry("a", "sodium", "0.5.3", "aaaa") });
+        inventory.update("a", { entry("a", "sodium", "0.5.8", "cccc") });
+        QCOMPARE(inventory.withHash("aaaa").size(), 0);
+        QCOMPARE(inventory.withHash("cccc").size(), 1);
+        QCOMPARE(inventory.withModId("sodium", "0.5.3").size(), 0);
+
+        inventory.remove("a");
+        QCOMPARE(inventory.instanceCount(), 0);
+        QCOMPARE(inventory.withModId("sodium").size(), 0);
+        QCOMPARE(inventory.find("sodium").size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(ModInventoryTest)
+
+#include "ModInventory_test.moc"
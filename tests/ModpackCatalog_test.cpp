@@ -0,0 +1,77 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <modplatform/helpers/ModpackCatalog.h>
+
+class ModpackCatalogTest : public QObject {
+    Q_OBJECT
+
+    static ModpackCatalog::Entry entry(const QString& id, const QString& name, qint64 downloads, const QString& description = {})
+    {
+        return { id, name, { "Some Author" }, { "Tech", "Quests" }, description, downloads, QJsonObject{ { "id", id } } };
+    }
+
+    static QStringList ids(const QList<QJsonObject>& found)
+    {
+        QStringList out;
+        for (auto& packObj : found)
+            out.append(packObj.value("id").toString());
+        return out;
+    }
+
+   private slots:
+    void test_search()
+    {
+        ModpackCatalog catalog;
+        catalog.update({ entry("1", "All the Mods 9", 500), entry("2", "Sky Factory", 900, "A skyblock pack"),
+                         entry("3", "Skyblock Adventures", 100) });
+
+        // words are matched by their start, in any field and any case, the most downloaded first
+        QCOMPARE(ids(catalog.search("sky")), QStringList({ "2", "3" }));
+        QCOMPARE(ids(catalog.search("SKYBLOCK")), QStringList({ "2", "3" }));
+        QCOMPARE(ids(catalog.search("all mods")), QStringList({ "1" }));
+        QCOMPARE(ids(catalog.search("quest")), QStringList({ "2", "1", "3" }));
+        QCOMPARE(ids(catalog.search("author")), QStringList({ "2", "1", "3" }));
+        QCOMPARE(ids(catalog.search("sky mods")), QStringList());
+        QCOMPARE(ids(catalog.search("")), QStringList({ "2", "1", "3" }));
+        QCOMPARE(ids(catalog.search("#3")), QStringList({ "3" }));
+        QCOMPARE(ids(catalog.search("#4")), QStringList());
+    }
+
+    void test_update()
+    {
+        ModpackCatalog catalog;
+        catalog.update({ entry("1", "Sky Factory", 100) });
+        catalog.update({ entry("1", "Stone Factory", 100) });
+        QCOMPARE(catalog.size(), 1);
+        QCOMPARE(ids(catalog.search("sky")), QStringList());
+        QCOMPARE(ids(catalog.search("stone")), QStringList({ "1" }));
+
+        // a whole list leaves out what isn't listed anymore
+        catalog.replace({ entry("2", "Sky Factory", 100) });
+        QCOMPARE(ids(catalog.search("factory")), QStringList({ "2" }));
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("catalogs/modrinth.json");
+        {
+            ModpackCatalog catalog(path);
+            QVERIFY(catalog.isEmpty());
+            catalog.update({ entry("1", "Sky Factory", 100), entry("2", "Stoneblock", 200) });
+            catalog.save();
+        }
+        QTRY_VERIFY(QFile::exists(path));
+
+        ModpackCatalog catalog(path);
+        QCOMPARE(catalog.size(), 2);
+        QCOMPARE(ids(catalog.search("factory")), QStringList({ "1" }));
+        QCOMPARE(ids(catalog.search("")), QStringList({ "2", "1" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(ModpackCatalogTest)
+
+#include "ModpackCatalog_test.moc"
@@ -0,0 +1,120 @@
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <MurmurHash2.h>
+
+#include <vector>
+
+class MurmurHash2Test : public QObject {
+    Q_OBJECT
+
+    static bool isCurseForgeWhitespace(char c) { return c == 9 || c == 10 || c == 13 || c == 32; }
+
+    // the way the CF fingerprint used to be computed, byte by byte
+    static uint32_t referenceHash(const QByteArray& data)
+    {
+        return MurmurHash2(data.constData(), static_cast<std::size_t>(data.size()), isCurseForgeWhitespace);
+    }
+
+    static uint32_t strippedHash(const QByteArray& data, std::size_t pieceSize)
+    {
+        MurmurHash2_Incremental hash(MurmurHash2_CountNonWhitespace(data.constData(), static_cast<std::size_t>(data.size())));
+        std::vector<char> stripped(pieceSize);
+        for (std::size_t offset = 0; offset < static_cast<std::size_t>(data.size()); offset += pieceSize) {
+            auto len = std::min(pieceSize, static_cast<std::size_t>(data.size()) - offset);
+            hash.feed(stripped.data(), MurmurHash2_StripWhitespace(data.constData() + offset, len, stripped.data()));
+        }
+        return hash.finish();
+    }
+
+    static QByteArray randomData(QRandomGenerator& random, int size, int whitespaceOneIn)
+    {
+        QByteArray data(size, Qt::Uninitialized);
+        for (auto& c : data) {
+            auto value = random.generate();
+            c = whitespaceOneIn && value % whitespaceOneIn == 0 ? "\t\n\r "[(value >> 8) % 4] : static_cast<char>(value >> 16);
+        }
+        return data;
+    }
+
+    // the jars in PRISM_BENCHMARK_JARS (a mods folder for example), or something random with the same whitespace ratio
+    static QByteArray benchmarkData()
+    {
+        auto path = qEnvironmentVariable("PRISM_BENCHMARK_JARS");
+        if (path.isEmpty()) {
+            QRandomGenerator random(42);
+            return randomData(random, 16 * 1024 * 1024, 0);
+        }
+        QByteArray data;
+        for (auto& jar : QDir(path).entryInfoList({ "*.jar" }, QDir::Files)) {
+            QFile file(jar.absoluteFilePath());
+            if (file.open(QIODevice::ReadOnly)) {
+                data.append(file.readAll());
+            }
+        }
+        return data;
+    }
+
+   private slots:
+    void test_matchesReference_data()
+    {
+        QTest::addColumn<int>("size");
+        QTest::addColumn<int>("whitespaceOneIn");
+        QTest::addColumn<int>("pieceSize");
+
+        QTest::newRow("empty") << 0 << 0 << 16;
+        QTest::newRow("tiny") << 3 << 2 << 16;
+        QTest::newRow("no whitespace") << 1000 << 0 << 64;
+        QTest::newRow("only whitespace") << 1000 << 1 << 64;
+        QTest::newRow("sparse whitespace") << 100000 << 64 << 4096;
+        QTest::newRow("dense whitespace") << 100000 << 3 << 4096;
+        QTest::newRow("odd pieces") << 100000 << 16 << 37;
+    }
+
+    void test_matchesReference()
+    {
+        QFETCH(int, size);
+        QFETCH(int, whitespaceOneIn);
+        QFETCH(int, pieceSize);
+
+        QRandomGenerator random(size);
+        auto data = randomData(random, size, whitespaceOneIn);
+        QCOMPARE(MurmurHash2_CountNonWhitespace(data.constData(), static_cast<std::size_t>(data.size())),
+                 MurmurHash2_FilteredSize(data.constData(), static_cast<std::size_t>(data.size()), isCurseForgeWhitespace));
+        QCOMPARE(strippedHash(data, static_cast<std::size_t>(pieceSize)), referenceHash(data));
+    }
+
+    void test_unalignedInput()
+    {
+        QRandomGenerator random(7);
+        auto data = randomData(random, 4096, 8);
+        for (int offset = 1; offset < 8; offset++) {
+            auto shifted = data.mid(offset);
+            QCOMPARE(strippedHash(shifted, 1000), referenceHash(shifted));
+        }
+    }
+
+    void benchmark_reference()
+    {
+        auto data = benchmarkData();
+        QBENCHMARK
+        {
+            referenceHash(data);
+        }
+    }
+
+    void benchmark_stripped()
+    {
+        auto data = benchmarkData();
+        QBENCHMARK
+        {
+            strippedHash(data, 4 * MiB);
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MurmurHash2Test)
+
+#include "MurmurHash2_test.moc"
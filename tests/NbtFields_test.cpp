@@ -0,0 +1,80 @@
+#include <QTest>
+
+#include <io/stream_writer.h>
+#include <tag_array.h>
+#include <tag_compound.h>
+#include <tag_list.h>
+#include <tag_primitive.h>
+#include <tag_string.h>
+#include <sstream>
+
+#include <minecraft/NbtFields.h>
+
+class NbtFieldsTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray levelDat()
+    {
+        nbt::tag_compound player;
+        player.put("Inventory", nbt::tag_list::of<nbt::tag_compound>({ { { "id", "minecraft:dirt" }, { "Count", nbt::tag_byte(64) } },
+                                                                         { { "id", "minecraft:stone" }, { "Count", nbt::tag_byte(1) } } }));
+        player.put("Pos", nbt::tag_list::of<nbt::tag_double>({ 1.5, 64.0, -3.25 }));
+        player.put("UUID", nbt::tag_int_array{ 1, 2, 3, 4 });
+
+        nbt::tag_compound worldGen;
+        worldGen.put("seed", nbt::tag_long(-4530634556500121041));
+
+        nbt::tag_compound data;
+        data.put("Player", std::move(player));
+        data.put("LevelName", nbt::tag_string("New World"));
+        data.put("GameType", nbt::tag_int(1));
+        data.put("LastPlayed", nbt::tag_long(1700000000000));
+        data.put("WorldGenSettings", std::move(worldGen));
+        data.put("DataPacks", nbt::tag_compound{ { "Enabled", nbt::tag_list::of<nbt::tag_string>({ "vanilla" }) } });
+
+        nbt::tag_compound root;
+        root.put("Data", std::move(data));
+
+        std::ostringstream s;
+        nbt::io::write_tag("", root, s);
+        return QByteArray(s.str().data(), static_cast<int>(s.str().size()));
+    }
+
+   private slots:
+    void test_read()
+    {
+        auto fields = NbtFields::read(levelDat(), { "Data", "Data.LevelName", "Data.GameType", "Data.LastPlayed",
+                                                    "Data.WorldGenSettings.seed", "Data.RandomSeed" });
+        QVERIFY(fields);
+        QCOMPARE(fields->value("Data").type, NbtFields::Type::Compound);
+        QCOMPARE(fields->value("Data.LevelName").type, NbtFields::Type::String);
+        QCOMPARE(fields->value("Data.LevelName").value.toString(), QString("New World"));
+        QCOMPARE(fields->value("Data.GameType").type, NbtFields::Type::Int);
+        QCOMPARE(fields->value("Data.GameType").value.toInt(), 1);
+        QCOMPARE(fields->value("Data.LastPlayed").value.toLongLong(), qlonglong(1700000000000));
+        QCOMPARE(fields->value("Data.WorldGenSettings.seed").type, NbtFields::Type::Long);
+        QCOMPARE(fields->value("Data.WorldGenSettings.seed").value.toLongLong(), qlonglong(-4530634556500121041));
+        // not in the data
+        QVERIFY(!fields->contains("Data.RandomSeed"));
+    }
+
+    void test_skippedFieldsKeepTheirType()
+    {
+        auto fields = NbtFields::read(levelDat(), { "Data.Player", "Data.DataPacks.Enabled" });
+        QVERIFY(fields);
+        QCOMPARE(fields->value("Data.Player").type, NbtFields::Type::Compound);
+        QCOMPARE(fields->value("Data.DataPacks.Enabled").type, NbtFields::Type::List);
+    }
+
+    void test_brokenData()
+    {
+        auto data = levelDat();
+        QVERIFY(!NbtFields::read(data.left(data.size() / 2), { "Data.RandomSeed" }));
+        QVERIFY(!NbtFields::read(QByteArray(), { "Data.LevelName" }));
+        QVERIFY(!NbtFields::read(QByteArray("\x08\x00\x00\x00\x00", 5), { "Data.LevelName" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(NbtFieldsTest)
+
+#include "NbtFields_test.moc"
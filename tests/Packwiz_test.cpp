@@ -20,7 +20,10 @@
 #include <QTemporaryDir>
 #include <QTest>
 
+#include <FileSystem.h>
+
 #include <modplatform/packwiz/Packwiz.h>
+#include <modplatform/packwiz/PackwizIndexCache.h>
 
 class PackwizTest : public QObject {
     Q_OBJECT
@@ -82,6 +85,72 @@ class PackwizTest : public QObject {
         QCOMPARE(metadata.file_id, 3509043);
         QCOMPARE(metadata.project_id, 327154);
     }
+
+    void indexCache()
+    {
+        QTemporaryDir tmp;
+        QDir index_dir(FS::PathCombine(tmp.path(), ".index"));
+        QVERIFY(FS::copy(QFINDTESTDATA("testdata/Packwiz"), index_dir.absolutePath())());
+
+        auto by_name = [](QList<Packwiz::V1::Mod> mods) {
+            QMap<QString, Packwiz::V1::Mod> out;
+            for (auto const& mod : mods)
+                out.insert(mod.name, mod);
+            return out;
+        };
+
+        Packwiz::IndexCache cache(index_dir);
+        auto parsed = by_name(cache.mods());
+        QCOMPARE(parsed.size(), 2);
+        QVERIFY(QFileInfo::exists(cache.path()));
+
+        // everything comes out of the cache file now
+        auto cached = by_name(Packwiz::IndexCache(index_dir).mods());
+        QCOMPARE(cached.keys(), parsed.keys());
+        auto const& flame = cached["Screenshot to Clipboard (Fabric)"];
+        QCOMPARE(flame.file_id, 3509043);
+        QCOMPARE(flame.provider, ModPlatform::ResourceProvider::FLAME);
+        auto const& modrinth = cached["Borderless Mining"];
+        QCOMPARE(modrinth.side, Packwiz::V1::Side::ClientSide);
+        QCOMPARE(modrinth.project_id, "kYq5qkSL");
+        QCOMPARE(modrinth.url, parsed["Borderless Mining"].url);
+
+        QVERIFY(QFile::remove(index_dir.absoluteFilePath("borderless-mining.pw.toml")));
+        auto after_removal = by_name(Packwiz::IndexCache(index_dir).mods());
+        QCOMPARE(after_removal.keys(), QStringList({ "Screenshot to Clipboard (Fabric)" }));
+    }
+
+    void indexBatch()
+    {
+        QTemporaryDir tmp;
+        QDir index_dir(FS::PathCombine(tmp.path(), ".index"));
+        QVERIFY(FS::copy(QFINDTESTDATA("testdata/Packwiz"), index_dir.absolutePath())());
+
+        Packwiz::IndexBatch batch(index_dir);
+        auto modrinth = batch.get(QString("Borderless-Mining"));
+        QVERIFY(modrinth.isValid());
+        QCOMPARE(modrinth.name, "Borderless Mining");
+        QCOMPARE(batch.get(QVariant(327154)).name, "Screenshot to Clipboard (Fabric)");
+
+        // nothing changed, nothing to write
+        modrinth.slug = "borderless-mining";
+        batch.update(modrinth);
+        QCOMPARE(batch.commit(), 0);
+
+        modrinth.filename = "borderless-mining-1.1.2+1.18.jar";
+        batch.update(modrinth);
+        auto added = modrinth;
+        added.slug = "another-mod";
+        added.name = "Another Mod";
+        added.project_id = "AAAAAAAA";
+        batch.update(added);
+        QCOMPARE(batch.get(QString("borderless-mining")).filename, modrinth.filename);
+        QCOMPARE(batch.commit(), 2);
+
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, "borderless-mining").filename, modrinth.filename);
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, "another-mod").name, "Another Mod");
+        QCOMPARE(Packwiz::V1::getIndexForMod(index_dir, "screenshot-to-clipboard-fabric").file_id, 3509043);
+    }
 };
 
 QTEST_GUILESS_MAIN(PackwizTest)
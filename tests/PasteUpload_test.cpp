@@ -0,0 +1,51 @@
+#include <QTest>
+
+#include <net/PasteUpload.h>
+
+class PasteUploadTest : public QObject {
+    Q_OBJECT
+
+    QByteArray lines(int from, int to)
+    {
+        QByteArray out;
+        for (int i = from; i < to; i++)
+            out += QString("line %1\n").arg(i, 4, 10, QChar('0')).toUtf8();
+        return out;
+    }
+
+   private slots:
+    void test_fits()
+    {
+        auto text = lines(0, 100);
+        QCOMPARE(PasteUpload::trimToLimit(text, 0, 0), text);
+        QCOMPARE(PasteUpload::trimToLimit(text, text.size(), 101), text);
+    }
+
+    void test_lines()
+    {
+        auto trimmed = PasteUpload::trimToLimit(lines(0, 1000), 0, 101);
+        QCOMPARE(trimmed.count('\n'), 101);
+        QVERIFY(trimmed.startsWith(lines(0, 25)));
+        QVERIFY(trimmed.endsWith(lines(925, 1000)));
+        QVERIFY(trimmed.contains("[900 lines left out"));
+    }
+
+    void test_bytes()
+    {
+        // every line is 10 bytes
+        auto trimmed = PasteUpload::trimToLimit(lines(0, 1000), 1064, 0);
+        QVERIFY(trimmed.size() <= 1064);
+        QVERIFY(trimmed.startsWith(lines(0, 25)));
+        QVERIFY(trimmed.endsWith(lines(925, 1000)));
+    }
+
+    void test_longLine()
+    {
+        QByteArray text(1000, 'x');
+        QCOMPARE(PasteUpload::trimToLimit(text, 164, 0), text.right(100));
+    }
+};
+
+QTEST_GUILESS_MAIN(PasteUploadTest)
+
+#include "PasteUpload_test.moc"
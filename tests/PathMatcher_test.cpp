@@ -0,0 +1,77 @@
+#include <QTest>
+
+#include <pathmatcher/FSTreeMatcher.h>
+#include <pathmatcher/MultiMatcher.h>
+#include <pathmatcher/RegexpMatcher.h>
+#include <pathmatcher/SimplePrefixMatcher.h>
+
+class PathMatcherTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_prefixes()
+    {
+        MultiMatcher matcher;
+        matcher.add(std::make_shared<SimplePrefixMatcher>("logs/"));
+        matcher.add(std::make_shared<SimplePrefixMatcher>("config/foo/"));
+        matcher.add(std::make_shared<SimplePrefixMatcher>("accounts.json"));
+
+        QVERIFY(matcher.matches("logs/latest.log"));
+        QVERIFY(matcher.matches("config/foo/bar/baz.toml"));
+        QVERIFY(matcher.matches("accounts.json"));
+        // a directory rule only matches what is below it
+        QVERIFY(!matcher.matches("logs"));
+        QVERIFY(!matcher.matches("logs2/latest.log"));
+        QVERIFY(!matcher.matches("config/foo"));
+        QVERIFY(!matcher.matches("config/bar.toml"));
+        QVERIFY(!matcher.matches("accounts.json.bak"));
+        QVERIFY(!matcher.matches("x/accounts.json"));
+
+        QVERIFY(matcher.matchesSubtree("logs") == true);
+        QVERIFY(matcher.matchesSubtree("config/foo/bar") == true);
+        QVERIFY(matcher.matchesSubtree("config") == std::nullopt);
+        QVERIFY(matcher.matchesSubtree("mods") == false);
+        QVERIFY(matcher.matchesSubtree("accounts.json") == false);
+    }
+
+    void test_regexps()
+    {
+        MultiMatcher matcher;
+        matcher.add(std::make_shared<RegexpMatcher>(".*\\.log(\\.[0-9]*)?(\\.gz)?$"));
+        matcher.add(std::make_shared<RegexpMatcher>("crash-.*\\.txt"));
+        matcher.add(std::make_shared<RegexpMatcher>("^config/.*\\.toml$"));
+        auto insensitive = std::make_shared<RegexpMatcher>("^IDMap dump.*\\.txt$");
+        insensitive->caseSensitive();
+        matcher.add(insensitive);
+        // back references only mean something in their own pattern
+        matcher.add(std::make_shared<RegexpMatcher>("^(a+)-\\1$"));
+
+        QVERIFY(matcher.matches("logs/latest.log"));
+        QVERIFY(matcher.matches("logs/2024-01-01-1.log.gz"));
+        QVERIFY(matcher.matches("crash-reports/crash-2024.txt"));
+        QVERIFY(matcher.matches("config/foo.toml"));
+        QVERIFY(matcher.matches("idmap dump 1.txt"));
+        QVERIFY(matcher.matches("some/aa-aa"));
+        // the ones without a slash only look at file names
+        QVERIFY(!matcher.matches("crash-dir/readme.md"));
+        QVERIFY(!matcher.matches("sub/config/foo.toml"));
+        QVERIFY(!matcher.matches("aa-a"));
+        QVERIFY(matcher.matchesSubtree("logs") == std::nullopt);
+    }
+
+    void test_others()
+    {
+        SeparatorPrefixTree<'/'> tree({ "saves/world", "screenshots" });
+        MultiMatcher matcher;
+        matcher.add(std::make_shared<FSTreeMatcher>(tree));
+        QVERIFY(matcher.matches("saves/world/level.dat"));
+        QVERIFY(!matcher.matches("saves/other/level.dat"));
+        QVERIFY(matcher.matchesSubtree("screenshots") == true);
+        QVERIFY(matcher.matchesSubtree("saves") == std::nullopt);
+        QVERIFY(matcher.matchesSubtree("mods") == false);
+    }
+};
+
+QTEST_GUILESS_MAIN(PathMatcherTest)
+
+#include "PathMatcher_test.moc"
@@ -0,0 +1,48 @@
+#include <QTest>
+
+#include <net/PeerCache.h>
+
+class PeerCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_announcement()
+    {
+        auto id = QUuid::createUuid();
+        auto parsed = Net::PeerCache::parseAnnouncement(Net::PeerCache::announcement(id, 41234));
+        QVERIFY(parsed);
+        QCOMPARE(parsed->first, id);
+        QCOMPARE(parsed->second, quint16(41234));
+
+        QVERIFY(!Net::PeerCache::parseAnnouncement("PRISM-PEER-CACHE 2 " + id.toByteArray(QUuid::WithoutBraces) + " 41234"));
+        QVERIFY(!Net::PeerCache::parseAnnouncement("PRISM-PEER-CACHE 1 not-an-id 41234"));
+        QVERIFY(!Net::PeerCache::parseAnnouncement("[MOTD]A world[/MOTD][AD]25565[/AD]"));
+    }
+
+    void test_request()
+    {
+        QByteArray sha1(40, 'a');
+        auto key = Net::PeerCache::parseRequest("GET /objects/sha1/" + sha1 + " HTTP/1.1\r\n");
+        QVERIFY(key);
+        QCOMPARE(key->type, "sha1");
+        QCOMPARE(key->hash, QString(sha1));
+
+        QVERIFY(Net::PeerCache::parseRequest("GET /objects/sha512/" + QByteArray(128, '0') + " HTTP/1.0\r\n"));
+
+        // only whole digests of the known kinds
+        QVERIFY(!Net::PeerCache::parseRequest("GET /objects/sha1/" + QByteArray(39, 'a') + " HTTP/1.1\r\n"));
+        QVERIFY(!Net::PeerCache::parseRequest("GET /objects/md5/" + QByteArray(32, 'a') + " HTTP/1.1\r\n"));
+        QVERIFY(!Net::PeerCache::parseRequest("GET /objects/sha1/../../" + sha1 + " HTTP/1.1\r\n"));
+        QVERIFY(!Net::PeerCache::parseRequest("POST /objects/sha1/" + sha1 + " HTTP/1.1\r\n"));
+    }
+
+    void test_noPeers()
+    {
+        Net::PeerCache cache(nullptr);
+        QVERIFY(cache.urlsFor({ "sha1", QString(40, 'a') }).isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(PeerCacheTest)
+
+#include "PeerCache_test.moc"
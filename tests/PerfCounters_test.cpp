@@ -0,0 +1,42 @@
+#include <QTest>
+
+#include <PerfCounters.h>
+
+class PerfCountersTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_counter()
+    {
+        auto& counter = PerfCounters::counter("test.counter");
+        PerfCounters::add("test.counter");
+        PerfCounters::add("test.counter", 4);
+        QCOMPARE(counter.load(), qint64(5));
+        QCOMPARE(PerfCounters::snapshot().value("test.counter"), qint64(5));
+    }
+
+    void test_duration()
+    {
+        PerfCounters::addDuration("test.duration", 10);
+        PerfCounters::addDuration("test.duration", 30);
+        auto values = PerfCounters::snapshot();
+        QCOMPARE(values.value("test.duration.count"), qint64(2));
+        QCOMPARE(values.value("test.duration.total_ms"), qint64(40));
+        QCOMPARE(values.value("test.duration.max_ms"), qint64(30));
+    }
+
+    void test_gauge()
+    {
+        static qint64 value;
+        value = 3;
+        PerfCounters::addGauge("test.gauge", [] { return value; });
+        QCOMPARE(PerfCounters::snapshot().value("test.gauge"), qint64(3));
+        value = 7;
+        QCOMPARE(PerfCounters::snapshot().value("test.gauge"), qint64(7));
+        QVERIFY(PerfCounters::dump().contains("test.gauge 7\n"));
+    }
+};
+
+QTEST_GUILESS_MAIN(PerfCountersTest)
+
+#include "PerfCounters_test.moc"
@@ -0,0 +1,55 @@
+#include <QTest>
+
+#include <tools/ProfileSummary.h>
+
+class ProfileSummaryTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_collapsedStacks()
+    {
+        auto summary = ProfileSummary::fromCollapsedStacks(
+            "java/lang/Thread.run_[j];net/minecraft/Ticker.tick_[j];net/minecraft/World.update_[j] 60\n"
+            "java/lang/Thread.run_[j];net/minecraft/Renderer.draw_[i] 30\n"
+            "java/lang/Thread.run_[j];net/minecraft/Ticker.tick_[j];net/minecraft/World.update_[j] 5\n"
+            "not a stack\n");
+        QCOMPARE(summary.samples, 95);
+        QVERIFY(!summary.hasGcPauses);
+        QCOMPARE(summary.hotMethods.size(), 3);
+        QCOMPARE(summary.hotMethods[0].name, QString("net/minecraft/World.update"));
+        QCOMPARE(summary.hotMethods[0].samples, 65);
+        QCOMPARE(summary.hotMethods[1].name, QString("net/minecraft/Renderer.draw"));
+
+        QCOMPARE(ProfileSummary::fromCollapsedStacks("a;b 1\na;c 2\na;d 3\n", 2).hotMethods.size(), 2);
+    }
+
+    void test_flightRecording()
+    {
+        auto json = R"({ "recording": { "events": [
+            { "type": "jdk.ExecutionSample", "values": { "stackTrace": { "frames": [
+                { "method": { "type": { "name": "net.minecraft.World" }, "name": "update" } },
+                { "method": { "type": { "name": "java.lang.Thread" }, "name": "run" } } ] } } },
+            { "type": "jdk.ExecutionSample", "values": { "stackTrace": { "frames": [
+                { "method": { "type": { "name": "net.minecraft.World" }, "name": "update" } } ] } } },
+            { "type": "jdk.ExecutionSample", "values": { "stackTrace": { "frames": [
+                { "method": { "type": { "name": "net.minecraft.Renderer" }, "name": "draw" } } ] } } },
+            { "type": "jdk.GarbageCollection", "values": { "sumOfPauses": "PT0.012S", "longestPause": "PT0.01S" } },
+            { "type": "jdk.GarbageCollection", "values": { "sumOfPauses": "PT1.5S", "longestPause": "PT1.5S" } }
+        ] } })";
+        auto summary = ProfileSummary::fromFlightRecording(json);
+        QVERIFY(summary);
+        QCOMPARE(summary->samples, 3);
+        QCOMPARE(summary->hotMethods[0].name, QString("net.minecraft.World.update"));
+        QCOMPARE(summary->hotMethods[0].samples, 2);
+        QVERIFY(summary->hasGcPauses);
+        QCOMPARE(summary->gcPauses, 2);
+        QCOMPARE(summary->gcPauseTotalMs, 1512.0);
+        QCOMPARE(summary->gcPauseLongestMs, 1500.0);
+
+        QVERIFY(!ProfileSummary::fromFlightRecording("not json"));
+    }
+};
+
+QTEST_GUILESS_MAIN(ProfileSummaryTest)
+
+#include "ProfileSummary_test.moc"
@@ -0,0 +1,66 @@
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <RecursiveFileSystemWatcher.h>
+#include <pathmatcher/RegexpMatcher.h>
+
+class RecursiveFileSystemWatcherTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.write("x") == 1);
+    }
+
+   private slots:
+    void test_newDirectoriesAreWatched()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setMatcher(std::make_shared<RegexpMatcher>(".*"));
+        watcher.setRootDir(QDir(dir.path()));
+        watcher.enable();
+        QSignalSpy spy(&watcher, &RecursiveFileSystemWatcher::directoryChanged);
+
+        QVERIFY(QDir(dir.path()).mkpath("mods"));
+        // let the new directory get its own watch before something happens in it
+        QVERIFY(spy.wait());
+        writeFile(dir.filePath("mods/a.jar"));
+        QTRY_VERIFY(watcher.files().contains("mods/a.jar"));
+    }
+
+    void test_burstIsCoalesced()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        RecursiveFileSystemWatcher watcher(nullptr);
+        watcher.setMatcher(std::make_shared<RegexpMatcher>(".*"));
+        watcher.setRootDir(QDir(dir.path()));
+        watcher.enable();
+        QSignalSpy files(&watcher, &RecursiveFileSystemWatcher::filesChanged);
+        QSignalSpy directories(&watcher, &RecursiveFileSystemWatcher::directoryChanged);
+
+        for (int i = 0; i < 50; i++)
+            writeFile(dir.filePath(QString("%1.jar").arg(i)));
+        QVERIFY(files.wait());
+        QTest::qWait(500);
+
+        // any number of changes in the root is one rescan and one signal for it, unless the burst was split by the window
+        QVERIFY(directories.count() <= 2);
+        for (auto& args : directories)
+            QCOMPARE(args.at(0).toString(), QDir(dir.path()).absolutePath());
+        QCOMPARE(watcher.files().size(), 50);
+    }
+};
+
+QTEST_GUILESS_MAIN(RecursiveFileSystemWatcherTest)
+
+#include "RecursiveFileSystemWatcher_test.moc"
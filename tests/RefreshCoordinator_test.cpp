@@ -0,0 +1,63 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/RefreshCoordinator.h>
+
+class RefreshCoordinatorTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_waitsForStart()
+    {
+        RefreshCoordinator coordinator({}, std::chrono::milliseconds(0));
+        int runs = 0;
+        coordinator.add("news", std::chrono::hours(1), [&runs] { runs++; });
+        QTest::qWait(50);
+        QCOMPARE(runs, 0);
+
+        coordinator.start();
+        QTRY_COMPARE(runs, 1);
+
+        // added after the start, it runs on its own
+        coordinator.add("translations", std::chrono::hours(1), [&runs] { runs++; });
+        QTRY_COMPARE(runs, 2);
+    }
+
+    void test_minimumInterval()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("refresh.json");
+        int runs = 0;
+        {
+            RefreshCoordinator coordinator(path, std::chrono::milliseconds(0));
+            coordinator.add("news", std::chrono::hours(1), [&runs] { runs++; });
+            coordinator.start();
+            QTRY_COMPARE(runs, 1);
+        }
+
+        // the next launch doesn't ask again that soon, unless it has to
+        RefreshCoordinator coordinator(path, std::chrono::milliseconds(0));
+        coordinator.add("news", std::chrono::hours(1), [&runs] { runs++; });
+        coordinator.add("news", std::chrono::hours(0), [&runs] { runs += 10; });
+        coordinator.start();
+        QTRY_COMPARE(runs, 11);
+        QTest::qWait(50);
+        QCOMPARE(runs, 11);
+    }
+
+    void test_staggered()
+    {
+        RefreshCoordinator coordinator({}, std::chrono::milliseconds(200));
+        int runs = 0;
+        coordinator.add("first", std::chrono::hours(1), [&runs] { runs++; });
+        coordinator.add("second", std::chrono::hours(1), [&runs] { runs++; });
+        coordinator.start();
+        QTRY_COMPARE(runs, 1);
+        QCOMPARE(runs, 1);
+        QTRY_COMPARE(runs, 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(RefreshCoordinatorTest)
+
+#include "RefreshCoordinator_test.moc"
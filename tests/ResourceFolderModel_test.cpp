@@ -240,6 +240,135 @@ class ResourceFolderModelTest : public QObject {
         QVERIFY(res_2.enabled() == initial_enabled_res_2);
         QVERIFY(res_2.internal_id() == id_2);
     }
+
+    void test_rescanKeepsResources()
+    {
+        QString folder_resource = QFINDTESTDATA("testdata/ResourceFolderModel/test_folder");
+        QString file_mod = QFINDTESTDATA("testdata/ResourceFolderModel/supercoolmod.jar");
+
+        QTemporaryDir tmp;
+        ResourceFolderModel model(tmp.path(), nullptr);
+
+        { EXEC_UPDATE_TASK(model.installResource(file_mod), QVERIFY) }
+        QCOMPARE(model.size(), 1);
+        auto* kept = &model.at(0);
+
+        int inserted = 0;
+        int removed = 0;
+        connect(&model, &ResourceFolderModel::rowsInserted, this, [&] { inserted++; });
+        connect(&model, &ResourceFolderModel::rowsRemoved, this, [&] { removed++; });
+
+        { EXEC_UPDATE_TASK(model.installResource(folder_resource), QVERIFY) }
+        QCOMPARE(model.size(), 2);
+        QCOMPARE(&model.at(0), kept);
+        QCOMPARE(inserted, 1);
+        QCOMPARE(removed, 0);
+
+        QVERIFY(FS::deletePath(FS::PathCombine(tmp.path(), "test_folder")));
+        { EXEC_UPDATE_TASK(model.rescan(), QVERIFY) }
+        QCOMPARE(model.size(), 1);
+        QCOMPARE(&model.at(0), kept);
+        QCOMPARE(inserted, 1);
+        QCOMPARE(removed, 1);
+    }
+
+    void test_batchEnable()
+    {
+        QTemporaryDir tmp;
+        for (int i = 0; i < 40; i++) {
+            QFile file(FS::PathCombine(tmp.path(), QString("mod%1.jar").arg(i)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+
+        ResourceFolderModel model(tmp.path(), nullptr);
+        { EXEC_UPDATE_TASK(model.update(), QVERIFY) }
+        QCOMPARE(model.size(), 40);
+        QVERIFY(model.startWatching());
+
+        QModelIndexList all;
+        for (int row = 0; row < model.size(); row++)
+            all.append(model.index(row, 0));
+
+        int changed = 0;
+        int updated = 0;
+        connect(&model, &ResourceFolderModel::dataChanged, this, [&changed] { changed++; });
+        connect(&model, &ResourceFolderModel::updateFinished, this, [&updated] { updated++; });
+
+        QVERIFY(model.setResourceEnabled(all, EnableAction::DISABLE));
+        QCOMPARE(changed, 1);
+        for (int row = 0; row < model.size(); row++)
+            QVERIFY(!model.at(row).enabled());
+        QCOMPARE(QDir(tmp.path()).entryList({ "*.disabled" }).size(), 40);
+
+        // the renames were the model's own, they don't come back as a rescan
+        QTest::qWait(1000);
+        QCOMPARE(updated, 0);
+        QCOMPARE(model.size(), 40);
+    }
+
+    void test_sortByName()
+    {
+        QTemporaryDir tmp;
+        for (auto name : { "The Zebra.jar", "apple.jar", "Mango.jar" }) {
+            QFile file(FS::PathCombine(tmp.path(), name));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+
+        ResourceFolderModel model(tmp.path(), nullptr);
+        { EXEC_UPDATE_TASK(model.update(), QVERIFY) }
+        QCOMPARE(model.size(), 3);
+
+        auto proxy = model.createFilterProxyModel(this);
+        proxy->sort(ResourceFolderModel::NAME_COLUMN);
+        auto names = [proxy] {
+            QStringList names;
+            for (int row = 0; row < proxy->rowCount(); row++)
+                names.append(proxy->index(row, ResourceFolderModel::NAME_COLUMN).data().toString());
+            return names;
+        };
+        QCOMPARE(names(), QStringList({ "apple", "Mango", "The Zebra" }));
+
+        QVERIFY(QFile::remove(FS::PathCombine(tmp.path(), "apple.jar")));
+        {
+            QFile file(FS::PathCombine(tmp.path(), "Banana.jar"));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+        { EXEC_UPDATE_TASK(model.update(), QVERIFY) }
+        QCOMPARE(names(), QStringList({ "Banana", "Mango", "The Zebra" }));
+    }
+
+    void test_filter()
+    {
+        QTemporaryDir tmp;
+        for (auto name : { "Mango.jar", "Mandarin.jar", "Banana.jar" }) {
+            QFile file(FS::PathCombine(tmp.path(), name));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+
+        ResourceFolderModel model(tmp.path(), nullptr);
+        { EXEC_UPDATE_TASK(model.update(), QVERIFY) }
+
+        auto proxy = model.createFilterProxyModel(this);
+        proxy->sort(ResourceFolderModel::NAME_COLUMN);
+        auto names = [proxy] {
+            QStringList names;
+            for (int row = 0; row < proxy->rowCount(); row++)
+                names.append(proxy->index(row, ResourceFolderModel::NAME_COLUMN).data().toString());
+            return names;
+        };
+
+        proxy->setFilterRegularExpression("Man");
+        QCOMPARE(names(), QStringList({ "Mandarin", "Mango" }));
+        proxy->setFilterRegularExpression("Mang");
+        QCOMPARE(names(), QStringList({ "Mango" }));
+        // going back shows the others again
+        proxy->setFilterRegularExpression("an");
+        QCOMPARE(names(), QStringList({ "Banana", "Mandarin", "Mango" }));
+        proxy->setFilterRegularExpression("^B");
+        QCOMPARE(names(), QStringList({ "Banana" }));
+        proxy->setFilterRegularExpression("");
+        QCOMPARE(proxy->rowCount(), 3);
+    }
 };
 
 QTEST_GUILESS_MAIN(ResourceFolderModelTest)
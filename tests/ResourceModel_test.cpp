@@ -14,6 +14,7 @@ using ResourceDownload::ResourceModel;
     QEventLoop loop;                                                                    \
                                                                                         \
     connect(model, &ResourceModel::dataChanged, &loop, &QEventLoop::quit);              \
+    connect(model, &ResourceModel::rowsInserted, &loop, &QEventLoop::quit);             \
                                                                                         \
     QTimer expire_timer;                                                                \
     expire_timer.callOnTimeout(&loop, &QEventLoop::quit);                               \
@@ -20,6 +20,7 @@
 #include <QTimer>
 
 #include <FileSystem.h>
+#include <MMCZip.h>
 
 #include <minecraft/mod/ResourcePack.h>
 #include <minecraft/mod/tasks/LocalResourcePackParseTask.h>
@@ -44,6 +45,31 @@ class ResourcePackParseTest : public QObject {
         QVERIFY(valid == true);
     }
 
+    void test_zipIndex()
+    {
+        QString source = QFINDTESTDATA("testdata/ResourcePackParse");
+
+        MMCZip::ZipIndex zip(FS::PathCombine(source, "test_resource_pack_idk.zip"));
+        QVERIFY(zip.isValid());
+        QVERIFY(zip.hasRootFolder("assets"));
+        QVERIFY(!zip.hasRootFolder("data"));
+        QVERIFY(!zip.read("missing.txt"));
+
+        auto mcmeta = zip.read("pack.mcmeta");
+        QVERIFY(mcmeta);
+        QVERIFY(mcmeta->contains("\"pack_format\""));
+        QVERIFY(!zip.read("pack.mcmeta", 4));
+
+        auto root = zip.findFolderOfFile("pack.mcmeta");
+        QVERIFY(!root.isNull());
+        QCOMPARE(root, "");
+        QCOMPARE(zip.findFolderOfFile("blah.txt"), "assets/minecraft/textures/");
+        QVERIFY(zip.findFolderOfFile("blah.txt", { "minecraft" }).isNull());
+        QVERIFY(zip.findFolderOfFile("missing.txt").isNull());
+
+        QVERIFY(!MMCZip::ZipIndex(FS::PathCombine(source, "test_folder")).isValid());
+    }
+
     void test_parseFolder()
     {
         QString source = QFINDTESTDATA("testdata/ResourcePackParse");
@@ -0,0 +1,119 @@
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+
+#include <minecraft/mod/tasks/ResourceParseScheduler.h>
+
+/* Records when it ran, optionally waiting on a gate first. Only used for testing. */
+class RecordingTask : public Task {
+    Q_OBJECT
+
+   public:
+    RecordingTask(QString name, QStringList* log, QMutex* log_lock, QSemaphore* gate = nullptr)
+        : Task(nullptr, false), m_name(std::move(name)), m_log(log), m_log_lock(log_lock), m_gate(gate)
+    {}
+
+   private:
+    void executeTask() override
+    {
+        if (m_gate)
+            m_gate->acquire();
+        {
+            QMutexLocker locker(m_log_lock);
+            m_log->append(m_name);
+        }
+        emitSucceeded();
+    }
+
+    QString m_name;
+    QStringList* m_log;
+    QMutex* m_log_lock;
+    QSemaphore* m_gate;
+};
+
+class ResourceParseSchedulerTest : public QObject {
+    Q_OBJECT
+
+    QStringList m_log;
+    QMutex m_log_lock;
+
+    Task::Ptr task(const QString& name, QSemaphore* gate = nullptr)
+    {
+        return Task::Ptr(new RecordingTask(name, &m_log, &m_log_lock, gate));
+    }
+
+    void waitFor(ResourceParseScheduler& scheduler, QObject* owner)
+    {
+        QTRY_COMPARE(scheduler.pendingCount(owner), 0);
+    }
+
+   private slots:
+    void init() { m_log.clear(); }
+
+    void test_Prioritize()
+    {
+        // one at a time, since the files all sit in the same folder
+        ResourceParseScheduler scheduler(1);
+        QSemaphore gate;
+        QObject owner;
+
+        scheduler.schedule(&owner, "/mods/blocker.jar", task("blocker", &gate));
+        scheduler.schedule(&owner, "/mods/a.jar", task("a"));
+        scheduler.schedule(&owner, "/mods/b.jar", task("b"));
+        scheduler.schedule(&owner, "/mods/c.jar", task("c"));
+
+        scheduler.prioritize(&owner, { "/mods/c.jar", "/mods/b.jar" });
+        gate.release();
+        waitFor(scheduler, &owner);
+
+        QCOMPARE(m_log, QStringList({ "blocker", "c", "b", "a" }));
+    }
+
+    void test_Coalesce()
+    {
+        ResourceParseScheduler scheduler(1);
+        QSemaphore gate;
+        QObject owner;
+        QObject other_owner;
+
+        scheduler.schedule(&owner, "/mods/blocker.jar", task("blocker", &gate));
+        auto first = task("first");
+        QVERIFY(!scheduler.schedule(&owner, "/mods/a.jar", first));
+        QCOMPARE(scheduler.schedule(&owner, "/mods/a.jar", task("second")), first);
+        // not the same model, not the same job
+        QVERIFY(!scheduler.schedule(&other_owner, "/mods/a.jar", task("other")));
+
+        gate.release();
+        waitFor(scheduler, &owner);
+        waitFor(scheduler, &other_owner);
+
+        QCOMPARE(m_log, QStringList({ "blocker", "second", "other" }));
+    }
+
+    void test_UnscheduleAndCancel()
+    {
+        ResourceParseScheduler scheduler(1);
+        QSemaphore gate;
+        QObject owner;
+
+        scheduler.schedule(&owner, "/mods/blocker.jar", task("blocker", &gate));
+        auto dropped = task("dropped");
+        scheduler.schedule(&owner, "/mods/a.jar", dropped);
+        scheduler.schedule(&owner, "/mods/b.jar", task("b"));
+        QCOMPARE(scheduler.pendingCount(&owner), 3);
+
+        QVERIFY(scheduler.unschedule(dropped.get()));
+        QVERIFY(!scheduler.unschedule(dropped.get()));
+        QCOMPARE(scheduler.pendingCount(&owner), 2);
+
+        // the running one has to be let go for cancel() to return
+        gate.release();
+        scheduler.cancel(&owner);
+        QCOMPARE(scheduler.pendingCount(&owner), 0);
+        QVERIFY(!m_log.contains("dropped"));
+    }
+};
+
+QTEST_GUILESS_MAIN(ResourceParseSchedulerTest)
+
+#include "ResourceParseScheduler_test.moc"
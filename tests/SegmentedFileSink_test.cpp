@@ -0,0 +1,138 @@
+#include <QCryptographicHash>
+#include <QFile>
+#include <QNetworkReply>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <net/ChecksumValidator.h>
+#include <net/SegmentedFileSink.h>
+
+/* A finished reply with the given status and headers, sinks never read the body from it. */
+class FakeReply : public QNetworkReply {
+   public:
+    FakeReply(int status, const QList<QPair<QByteArray, QByteArray>>& headers)
+    {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, status);
+        for (auto& header : headers)
+            setRawHeader(header.first, header.second);
+        open(QIODevice::ReadOnly);
+    }
+    void abort() override {}
+
+   protected:
+    qint64 readData(char*, qint64) override { return -1; }
+};
+
+class SegmentedFileSinkTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray contents()
+    {
+        QByteArray data;
+        for (int i = 0; i < 300000; i++)
+            data.append(char(i * 13));
+        return data;
+    }
+
+    static QByteArray contentRange(qint64 first, qint64 length, qint64 total)
+    {
+        return QString("bytes %1-%2/%3").arg(first).arg(first + length - 1).arg(total).toLatin1();
+    }
+
+   private slots:
+    void test_segmentsMakeTheFile()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        auto file = std::make_shared<Net::SegmentedFile>(path);
+        const qint64 third = data.size() / 3;
+        QList<qint64> offsets{ 0, third, 2 * third };
+
+        std::vector<std::unique_ptr<Net::SegmentedFileSink>> sinks;
+        for (int i = 0; i < offsets.size(); i++) {
+            auto index = i == 0 ? 0 : file->addSegment();
+            auto length = (i + 1 < offsets.size() ? offsets[i + 1] : data.size()) - offsets[i];
+            sinks.push_back(std::make_unique<Net::SegmentedFileSink>(file, index, offsets[i], length));
+        }
+        auto validator = new Net::ChecksumValidator(QCryptographicHash::Sha1, QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+        sinks[0]->addValidator(validator);
+
+        // finish them out of order, the last one to finish commits the file
+        for (int i : { 2, 0, 1 }) {
+            auto length = (i + 1 < offsets.size() ? offsets[i + 1] : data.size()) - offsets[i];
+            QNetworkRequest request;
+            QCOMPARE(sinks[i]->init(request), Task::State::Running);
+            auto range = "bytes=" + QByteArray::number(offsets[i]) + "-" + QByteArray::number(offsets[i] + length - 1);
+            QCOMPARE(request.rawHeader("Range"), range);
+
+            FakeReply reply(206, { { "Content-Range", contentRange(offsets[i], length, data.size()) } });
+            QCOMPARE(sinks[i]->headersReceived(reply), Task::State::Running);
+            auto chunk = data.mid(offsets[i], length);
+            QCOMPARE(sinks[i]->write(chunk), Task::State::Running);
+            QVERIFY(!QFile::exists(path));
+            QCOMPARE(sinks[i]->finalize(reply), Task::State::Succeeded);
+        }
+
+        QFile result(path);
+        QVERIFY(result.open(QIODevice::ReadOnly));
+        QCOMPARE(result.readAll(), data);
+        QVERIFY(!QFile::exists(path + ".part"));
+    }
+
+    void test_badChecksumFails()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("pack.zip");
+        auto data = contents();
+        auto file = std::make_shared<Net::SegmentedFile>(path);
+        file->addSegment();
+        Net::SegmentedFileSink first(file, 0, 0, 100);
+        Net::SegmentedFileSink second(file, 1, 100, data.size() - 100);
+        first.addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, QByteArray(20, '\0')));
+
+        for (auto* sink : { &first, &second }) {
+            QNetworkRequest request;
+            QCOMPARE(sink->init(request), Task::State::Running);
+        }
+        FakeReply first_reply(206, { { "Content-Range", contentRange(0, 100, data.size()) } });
+        QCOMPARE(first.headersReceived(first_reply), Task::State::Running);
+        auto head = data.left(100);
+        QCOMPARE(first.write(head), Task::State::Running);
+        QCOMPARE(first.finalize(first_reply), Task::State::Succeeded);
+
+        FakeReply second_reply(206, { { "Content-Range", contentRange(100, data.size() - 100, data.size()) } });
+        QCOMPARE(second.headersReceived(second_reply), Task::State::Running);
+        auto tail = data.mid(100);
+        QCOMPARE(second.write(tail), Task::State::Running);
+        QCOMPARE(second.finalize(second_reply), Task::State::Failed);
+        QVERIFY(!QFile::exists(path));
+        QVERIFY(!QFile::exists(path + ".part"));
+    }
+
+    void test_rangesMustMatch()
+    {
+        QTemporaryDir dir;
+        auto file = std::make_shared<Net::SegmentedFile>(dir.filePath("pack.zip"));
+        file->addSegment();
+        Net::SegmentedFileSink sink(file, 1, 1000, 1000);
+        QNetworkRequest request;
+        QCOMPARE(sink.init(request), Task::State::Running);
+
+        // a server that forgot about ranges would send the whole file into the middle of it
+        FakeReply whole(200, {});
+        QCOMPARE(sink.headersReceived(whole), Task::State::Failed);
+
+        FakeReply elsewhere(206, { { "Content-Range", contentRange(0, 1000, 2000) } });
+        QCOMPARE(sink.headersReceived(elsewhere), Task::State::Failed);
+
+        FakeReply right(206, { { "Content-Range", contentRange(1000, 1000, 2000) } });
+        QCOMPARE(sink.headersReceived(right), Task::State::Running);
+        QByteArray too_much(1001, 'x');
+        QCOMPARE(sink.write(too_much), Task::State::Failed);
+    }
+};
+
+QTEST_GUILESS_MAIN(SegmentedFileSinkTest)
+
+#include "SegmentedFileSink_test.moc"
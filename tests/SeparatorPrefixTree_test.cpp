@@ -0,0 +1,240 @@
+#include <QMap>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <SeparatorPrefixTree.h>
+
+/* The tree as it was before it was flattened, a QMap of nodes per node, to check against and to measure it by. */
+class ReferenceTree {
+   public:
+    explicit ReferenceTree(bool contained = false) : m_contained(contained) {}
+
+    ReferenceTree& insert(const QString& path)
+    {
+        auto sepIndex = path.indexOf('/');
+        if (sepIndex == -1) {
+            children[path] = ReferenceTree(true);
+            return children[path];
+        }
+        auto prefix = path.left(sepIndex);
+        if (!children.contains(prefix)) {
+            children[prefix] = ReferenceTree(false);
+        }
+        return children[prefix].insert(path.mid(sepIndex + 1));
+    }
+
+    bool covers(const QString& path) const
+    {
+        if (m_contained) {
+            return true;
+        }
+        auto sepIndex = path.indexOf('/');
+        auto found = children.find(sepIndex == -1 ? path : path.left(sepIndex));
+        if (found == children.end()) {
+            return false;
+        }
+        return (*found).covers(sepIndex == -1 ? QString() : path.mid(sepIndex + 1));
+    }
+
+    bool exists(const QString& path) const
+    {
+        auto sepIndex = path.indexOf('/');
+        auto found = children.find(sepIndex == -1 ? path : path.left(sepIndex));
+        if (found == children.end()) {
+            return false;
+        }
+        return sepIndex == -1 || (*found).exists(path.mid(sepIndex + 1));
+    }
+
+    QStringList toStringList() const
+    {
+        QStringList collected;
+        for (auto iter = children.begin(); iter != children.end(); iter++) {
+            for (auto& nested : iter.value().toStringList()) {
+                collected.append(iter.key() + '/' + nested);
+            }
+            if ((*iter).m_contained) {
+                collected.append(iter.key());
+            }
+        }
+        return collected;
+    }
+
+   private:
+    QMap<QString, ReferenceTree> children;
+    bool m_contained = false;
+};
+
+class SeparatorPrefixTreeTest : public QObject {
+    Q_OBJECT
+
+    // what an instance with a lot of worlds and mods looks like
+    static QStringList instancePaths(int count)
+    {
+        QStringList paths;
+        QRandomGenerator random(42);
+        while (paths.size() < count) {
+            switch (random.bounded(4)) {
+                case 0:
+                    paths.append(QString("saves/world%1/region/r.%2.%3.mca")
+                                     .arg(random.bounded(40))
+                                     .arg(random.bounded(-30, 30))
+                                     .arg(random.bounded(-30, 30)));
+                    break;
+                case 1:
+                    paths.append(QString("mods/mod-%1-%2.jar").arg(random.bounded(3000)).arg(random.bounded(5)));
+                    break;
+                case 2:
+                    paths.append(QString("config/pack%1/sub%2/file%3.toml")
+                                     .arg(random.bounded(50))
+                                     .arg(random.bounded(20))
+                                     .arg(paths.size()));
+                    break;
+                default:
+                    paths.append(QString("screenshots/%1.png").arg(paths.size()));
+                    break;
+            }
+        }
+        return paths;
+    }
+
+   private slots:
+    void test_coversAndCover()
+    {
+        SeparatorPrefixTree<'/'> tree({ "saves/world", "screenshots", "config/" });
+        QVERIFY(tree.covers("saves/world"));
+        QVERIFY(tree.covers("saves/world/level.dat"));
+        QVERIFY(!tree.covers("saves"));
+        QVERIFY(!tree.covers("saves/other"));
+        QVERIFY(tree.covers("config"));
+        QCOMPARE(tree.cover("saves/world/region/r.0.0.mca"), QString("saves/world"));
+        QCOMPARE(tree.cover("screenshots"), QString("screenshots"));
+        QVERIFY(tree.cover("mods").isNull());
+        QVERIFY(tree.exists("saves"));
+        QVERIFY(!tree.contains("mods"));
+        QVERIFY(tree.hasChildren("saves"));
+        QVERIFY(!tree.hasChildren("screenshots"));
+    }
+
+    void test_insertDropsWhatItCovers()
+    {
+        SeparatorPrefixTree<'/'> tree({ "saves/a/b", "saves/a/c", "saves/d" });
+        tree.insert("saves/a");
+        QCOMPARE(tree.toStringList(), QStringList({ "saves/a", "saves/d" }));
+        QVERIFY(!tree.exists("saves/a/b"));
+    }
+
+    void test_remove()
+    {
+        SeparatorPrefixTree<'/'> tree({ "a/b/c", "a/b", "a/d" });
+        QVERIFY(tree.remove("a/b"));
+        // still on the way to a/b/c
+        QVERIFY(tree.exists("a/b"));
+        QVERIFY(!tree.covers("a/b/x"));
+        QVERIFY(tree.remove("a/b/c"));
+        QVERIFY(!tree.exists("a/b"));
+        QVERIFY(tree.exists("a"));
+        QVERIFY(tree.remove("a/d"));
+        QVERIFY(tree.leaf());
+        QVERIFY(!tree.remove("a/d"));
+        // a prefix that isn't contained takes everything below it along
+        tree.insert({ "x/y/1", "x/y/2", "x/z" });
+        QVERIFY(tree.remove("x/y"));
+        QCOMPARE(tree.toStringList(), QStringList({ "x/z" }));
+    }
+
+    void test_matchesReference()
+    {
+        auto paths = instancePaths(20000);
+        SeparatorPrefixTree<'/'> tree;
+        ReferenceTree reference;
+        for (int i = 0; i < paths.size(); i++) {
+            // block whole folders now and then, like the export dialogs do
+            auto path = i % 97 == 0 ? paths[i].section('/', 0, 1) : paths[i];
+            tree.insert(path);
+            reference.insert(path);
+        }
+        QCOMPARE(tree.toStringList(), reference.toStringList());
+
+        auto probes = instancePaths(40000);
+        probes.append({ "saves", "mods", "config/pack1", "", "unknown/path" });
+        for (auto& probe : probes) {
+            QCOMPARE(tree.covers(probe), reference.covers(probe));
+            QCOMPARE(tree.exists(probe), reference.exists(probe));
+        }
+
+        // removing most of them packs the tree again on the way, what's left has to stay the same
+        auto kept = tree.toStringList();
+        for (int i = 0; i < kept.size(); i++) {
+            if (i % 10 != 0) {
+                QVERIFY(tree.remove(kept[i]));
+            }
+        }
+        QStringList expected;
+        for (int i = 0; i < kept.size(); i += 10) {
+            expected.append(kept[i]);
+        }
+        auto left = tree.toStringList();
+        left.sort();
+        expected.sort();
+        QCOMPARE(left, expected);
+        for (auto& path : expected) {
+            QVERIFY(tree.covers(path));
+        }
+    }
+
+    void benchmark_referenceInsert()
+    {
+        auto paths = instancePaths(100000);
+        QBENCHMARK
+        {
+            ReferenceTree tree;
+            for (auto& path : paths) {
+                tree.insert(path);
+            }
+        }
+    }
+
+    void benchmark_flatInsert()
+    {
+        auto paths = instancePaths(100000);
+        QBENCHMARK
+        {
+            SeparatorPrefixTree<'/'> tree;
+            for (auto& path : paths) {
+                tree.insert(path);
+            }
+        }
+    }
+
+    void benchmark_referenceCovers()
+    {
+        auto paths = instancePaths(100000);
+        ReferenceTree tree;
+        for (auto& path : paths) {
+            tree.insert(path);
+        }
+        QBENCHMARK
+        {
+            for (auto& path : paths) {
+                tree.covers(path);
+            }
+        }
+    }
+
+    void benchmark_flatCovers()
+    {
+        auto paths = instancePaths(100000);
+        SeparatorPrefixTree<'/'> tree(paths);
+        QBENCHMARK
+        {
+            for (auto& path : paths) {
+                tree.covers(path);
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(SeparatorPrefixTreeTest)
+
+#include "SeparatorPrefixTree_test.moc"
@@ -0,0 +1,115 @@
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTest>
+
+#include <minecraft/ServerPinger.h>
+
+class ServerPingerTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_handshake()
+    {
+        auto packet = ServerPinger::handshakePacket("mc.example.org", 25565);
+        auto body = ServerPinger::takePacket(packet);
+        QVERIFY(body.has_value());
+        QVERIFY(packet.isEmpty());
+        // id, protocol -1 as a 5 byte VarInt, the host, the port and the next state
+        QCOMPARE(body->size(), 1 + 5 + 1 + 14 + 2 + 1);
+        QCOMPARE(body->at(0), char(0x00));
+        QCOMPARE(body->mid(7, 14), QByteArray("mc.example.org"));
+        QCOMPARE(quint8(body->at(21)), quint8(0x63));
+        QCOMPARE(quint8(body->at(22)), quint8(0xDD));
+        QCOMPARE(body->at(23), char(0x01));
+    }
+
+    void test_partialPacket()
+    {
+        QByteArray buffer("\x05\x00ab", 4);
+        QVERIFY(!ServerPinger::takePacket(buffer).has_value());
+        buffer += "cde";
+        auto body = ServerPinger::takePacket(buffer);
+        QVERIFY(body.has_value());
+        QCOMPARE(*body, QByteArray("\x00" "abcd", 5));
+        QCOMPARE(buffer, QByteArray("e"));
+    }
+
+    void test_parseStatus()
+    {
+        auto status = ServerPinger::parseStatus(R"({
+            "version": { "name": "1.20.4", "protocol": 765 },
+            "players": { "max": 100, "online": 5 },
+            "description": { "text": "A ", "extra": [ { "text": "§cMinecraft" }, " Server" ] },
+            "favicon": "data:image/png;base64,iVBORw0KGgo="
+        })");
+        QVERIFY(status.has_value());
+        QCOMPARE(status->version, "1.20.4");
+        QCOMPARE(status->players, 5);
+        QCOMPARE(status->maxPlayers, 100);
+        QCOMPARE(status->motd, "A Minecraft Server");
+        QCOMPARE(status->favicon, QByteArray("\x89PNG\r\n\x1a\n"));
+        QVERIFY(!ServerPinger::parseStatus("not json").has_value());
+    }
+
+    void test_ping()
+    {
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        connect(&server, &QTcpServer::newConnection, this, [&server] {
+            auto socket = server.nextPendingConnection();
+            auto buffer = std::make_shared<QByteArray>();
+            connect(socket, &QTcpSocket::readyRead, socket, [socket, buffer] {
+                *buffer += socket->readAll();
+                while (auto body = ServerPinger::takePacket(*buffer)) {
+                    if (body->size() == 1) {
+                        QByteArray json(R"({"players":{"max":20,"online":1},"description":"hi"})");
+                        QByteArray status("\x00", 1);
+                        status += char(json.size());
+                        status += json;
+                        socket->write(char(status.size()) + status);
+                    } else if (body->at(0) == 0x01) {
+                        socket->write(char(body->size()) + *body);
+                    }
+                }
+            });
+        });
+
+        ServerPinger pinger;
+        QSignalSpy spy(&pinger, &ServerPinger::finished);
+        auto address = QString("127.0.0.1:%1").arg(server.serverPort());
+        pinger.ping(address);
+        QVERIFY(spy.wait());
+        QCOMPARE(spy.first().at(0).toString(), address);
+
+        auto status = pinger.cached(address);
+        QVERIFY(status.has_value());
+        QVERIFY(status->online);
+        QCOMPARE(status->motd, "hi");
+        QCOMPARE(status->players, 1);
+        QVERIFY(status->ping >= 0);
+
+        // it's cached now, so it isn't pinged again
+        pinger.ping(address);
+        QTest::qWait(100);
+        QCOMPARE(spy.size(), 1);
+    }
+
+    void test_offline()
+    {
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        auto port = server.serverPort();
+        server.close();
+
+        ServerPinger pinger;
+        QSignalSpy spy(&pinger, &ServerPinger::finished);
+        pinger.ping(QString("127.0.0.1:%1").arg(port));
+        QVERIFY(spy.wait());
+        QVERIFY(!pinger.cached(QString("127.0.0.1:%1").arg(port))->online);
+    }
+};
+
+QTEST_GUILESS_MAIN(ServerPingerTest)
+
+#include "ServerPinger_test.moc"
@@ -0,0 +1,68 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <GZip.h>
+#include <launch/SessionLog.h>
+
+class SessionLogTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_writeAndRead()
+    {
+        QTemporaryDir dir;
+        QString path;
+        {
+            SessionLogWriter writer(dir.path());
+            QVERIFY(writer.isOpen());
+            path = writer.path();
+            QStringList lines;
+            for (int i = 0; i < 10000; i++)
+                lines.append(QString("line %1").arg(i));
+            writer.append(lines);
+        }
+
+        SessionLogReader reader(path);
+        QVERIFY(reader.isValid());
+        QCOMPARE(reader.memberCount(), 3);
+        QCOMPARE(reader.firstLine(2), 8192);
+        QCOMPARE(reader.member(1).first(), QString("line 4096"));
+        QCOMPARE(reader.member(2).last(), QString("line 9999"));
+
+        // only the last whole members that fit
+        qint64 firstLine = -1;
+        auto tail = reader.tail(10, &firstLine);
+        QCOMPARE(firstLine, 8192);
+        QCOMPARE(tail.size(), 10000 - 8192);
+        QCOMPARE(reader.tail(1000000, &firstLine).size(), 10000);
+        QCOMPARE(firstLine, 0);
+
+        // and it's still a gzip file to anything else, starting with the first member
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QByteArray data;
+        QVERIFY(GZip::unzip(file, data));
+        QVERIFY(data.startsWith("line 0\nline 1\n"));
+    }
+
+    void test_rotation()
+    {
+        QTemporaryDir dir;
+        for (int i = 0; i < 4; i++) {
+            SessionLogWriter writer(dir.path(), 2);
+            writer.append({ QString("session %1").arg(i) });
+            QTest::qWait(2);
+        }
+
+        auto left = QDir(dir.path()).entryList({ "session-*.log.gz" }, QDir::Files, QDir::Name);
+        QCOMPARE(left.size(), 2);
+        QCOMPARE(SessionLogReader(QDir(dir.path()).absoluteFilePath(left.last())).member(0), QStringList({ "session 3" }));
+        QCOMPARE(QDir(dir.path()).entryList({ "*.idx" }, QDir::Files).size(), 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(SessionLogTest)
+
+#include "SessionLog_test.moc"
@@ -0,0 +1,45 @@
+#include <QDateTime>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <Json.h>
+#include <net/SrvCache.h>
+
+class SrvCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_answersFromFile()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("srv.json");
+        auto expires = double(QDateTime::currentSecsSinceEpoch() + 3600);
+        QJsonObject root;
+        root.insert("_minecraft._tcp.example.org",
+                    QJsonObject({ { "target", "mc.example.org" }, { "port", 25570 }, { "expires", expires } }));
+        root.insert("_minecraft._tcp.example.net", QJsonObject({ { "target", "" }, { "port", 0 }, { "expires", expires } }));
+        Json::write(root, path);
+
+        SrvCache cache(path);
+        int answers = 0;
+        // both are fresh, so they're answered right away without asking DNS
+        cache.resolve("_minecraft._tcp.example.org", this, [&answers](std::optional<SrvCache::Record> record, const QString& error) {
+            QVERIFY(record.has_value());
+            QCOMPARE(record->target, "mc.example.org");
+            QCOMPARE(record->port, 25570);
+            QVERIFY(error.isEmpty());
+            answers++;
+        });
+        cache.resolve("_minecraft._tcp.example.net", this, [&answers](std::optional<SrvCache::Record> record, const QString& error) {
+            QVERIFY(!record.has_value());
+            QVERIFY(error.isEmpty());
+            answers++;
+        });
+        QCOMPARE(answers, 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(SrvCacheTest)
+
+#include "SrvCache_test.moc"
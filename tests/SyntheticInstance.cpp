@@ -0,0 +1,352 @@
+#include "SyntheticInstance.h"
+
+#include <QBuffer>
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+
+#include <io/stream_writer.h>
+#include <quazip/quazip.h>
+#include <quazip/quazipfile.h>
+#include <tag_compound.h>
+#include <tag_primitive.h>
+#include <tag_string.h>
+#include <iterator>
+#include <sstream>
+
+#include "FileSystem.h"
+#include "GZip.h"
+
+namespace SyntheticInstance {
+
+namespace {
+
+// every entry and file gets the same time, so the archives come out the same too
+const QDateTime s_time = QDateTime(QDate(2024, 1, 1), QTime(12, 0), Qt::UTC);
+
+const char* const s_words[] = { "ender", "iron",  "craft", "tech",    "magic", "storage", "power", "farm",  "world", "biome",
+                                "mob",   "quest", "map",   "chest",   "tool",  "armor",   "food",  "light", "pipe",  "wire",
+                                "core",  "lib",   "api",   "utility", "extra", "better",  "more",  "simple" };
+
+QString word(QRandomGenerator& random)
+{
+    return s_words[random.bounded(static_cast<int>(std::size(s_words)))];
+}
+
+// drawn one after the other, arguments to the same call are evaluated in whatever order the compiler likes
+QString words(QRandomGenerator& random, int count, const QString& separator = " ")
+{
+    QStringList drawn;
+    for (int i = 0; i < count; i++) {
+        drawn.append(word(random));
+    }
+    return drawn.join(separator);
+}
+
+QString version(QRandomGenerator& random)
+{
+    auto major = random.bounded(10);
+    auto minor = random.bounded(20);
+    return QString("%1.%2.%3").arg(major).arg(minor).arg(random.bounded(100));
+}
+
+QByteArray randomBytes(QRandomGenerator& random, int size)
+{
+    QByteArray bytes(size, '\0');
+    random.fillRange(reinterpret_cast<quint32*>(bytes.data()), size / 4);
+    return bytes;
+}
+
+bool writeFile(const QString& path, const QByteArray& data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't write" << path << file.errorString();
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+
+struct ZipEntry {
+    QString name;
+    QByteArray data;
+};
+
+bool writeZip(const QString& path, const QList<ZipEntry>& entries)
+{
+    QuaZip zip(path);
+    if (!zip.open(QuaZip::mdCreate)) {
+        qWarning() << "Couldn't create" << path;
+        return false;
+    }
+    for (auto& entry : entries) {
+        QuaZipFile file(&zip);
+        QuaZipNewInfo info(entry.name);
+        info.dateTime = s_time;
+        if (!file.open(QIODevice::WriteOnly, info) || file.write(entry.data) != entry.data.size()) {
+            return false;
+        }
+        file.close();
+    }
+    zip.close();
+    return zip.getZipError() == 0;
+}
+
+QByteArray icon(QRandomGenerator& random)
+{
+    QImage image(64, 64, QImage::Format_ARGB32);
+    image.fill(QColor::fromRgb(random.generate() | 0xff000000));
+    for (int i = 0; i < 256; i++) {
+        image.setPixel(random.bounded(64), random.bounded(64), random.generate() | 0xff000000);
+    }
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+
+// class files, not real ones, but making the jars as big as mods are
+QList<ZipEntry> classes(QRandomGenerator& random, const QString& id)
+{
+    QList<ZipEntry> entries;
+    auto count = random.bounded(5, 40);
+    for (int i = 0; i < count; i++) {
+        auto path = QString("com/example/%1/%2%3.class").arg(id, word(random)).arg(i);
+        entries.append({ path, randomBytes(random, random.bounded(512, 8192)) });
+    }
+    return entries;
+}
+
+bool writeFabricMod(const QString& folder, QRandomGenerator& random, int index)
+{
+    auto name = words(random, 2);
+    auto id = QString("%1_%2").arg(name).arg(index).replace(' ', '_');
+    QJsonObject mod{
+        { "schemaVersion", 1 },
+        { "id", id },
+        { "version", version(random) },
+        { "name", name },
+        { "description", QString("Adds %1 to the game.").arg(words(random, 2, " and ")) },
+        { "authors", QJsonArray{ word(random) + "dev", word(random) + "_team" } },
+        { "contact", QJsonObject{ { "homepage", QString("https://example.com/%1").arg(id) } } },
+        { "license", "MIT" },
+        { "icon", QString("assets/%1/icon.png").arg(id) },
+        { "environment", "*" },
+        { "entrypoints", QJsonObject{ { "main", QJsonArray{ QString("com.example.%1.Main").arg(id) } } } },
+        { "depends", QJsonObject{ { "fabricloader", ">=0.14.0" }, { "minecraft", "~1.20.1" } } },
+    };
+    auto entries = classes(random, id);
+    entries.append({ "fabric.mod.json", QJsonDocument(mod).toJson() });
+    entries.append({ QString("assets/%1/icon.png").arg(id), icon(random) });
+    return writeZip(FS::PathCombine(folder, id + ".jar"), entries);
+}
+
+bool writeForgeMod(const QString& folder, QRandomGenerator& random, int index)
+{
+    auto name = words(random, 2);
+    auto id = QString("%1%2").arg(name).arg(index).remove(' ');
+    auto modVersion = version(random);
+    auto author = word(random) + "dev";
+    auto content = word(random);
+    auto toml = QString(R"(modLoader="javafml"
+loaderVersion="[47,)"
+license="All Rights Reserved"
+issueTrackerURL="https://example.com/%1/issues"
+
+[[mods]]
+modId="%1"
+version="%2"
+displayName="%3"
+displayURL="https://example.com/%1"
+logoFile="%1.png"
+authors="%4"
+description='''
+Adds %5 to the game.
+'''
+
+[[dependencies.%1]]
+    modId="forge"
+    mandatory=true
+    versionRange="[47,)"
+    ordering="NONE"
+    side="BOTH"
+)")
+                    .arg(id, modVersion, name, author, content);
+    auto entries = classes(random, id);
+    entries.append({ "META-INF/mods.toml", toml.toUtf8() });
+    entries.append({ "META-INF/MANIFEST.MF", "Manifest-Version: 1.0\n" });
+    entries.append({ id + ".png", icon(random) });
+    return writeZip(FS::PathCombine(folder, id + ".jar"), entries);
+}
+
+bool writeResourcePack(const QString& folder, QRandomGenerator& random, int index)
+{
+    auto name = QString("%1 Pack %2").arg(words(random, 2)).arg(index);
+    QJsonObject meta{ { "pack", QJsonObject{ { "pack_format", 15 }, { "description", QString("Textures for %1").arg(word(random)) } } } };
+    QList<ZipEntry> entries{ { "pack.mcmeta", QJsonDocument(meta).toJson() }, { "pack.png", icon(random) } };
+    auto textures = random.bounded(10, 100);
+    for (int i = 0; i < textures; i++) {
+        entries.append({ QString("assets/minecraft/textures/block/%1_%2.png").arg(word(random)).arg(i), icon(random) });
+    }
+    return writeZip(FS::PathCombine(folder, name + ".zip"), entries);
+}
+
+QByteArray levelDat(QRandomGenerator& random, const QString& name)
+{
+    nbt::tag_compound data;
+    data.put("LevelName", nbt::tag_string(name.toStdString()));
+    data.put("GameType", nbt::tag_int(random.bounded(4)));
+    data.put("LastPlayed", nbt::tag_long(s_time.toMSecsSinceEpoch()));
+    data.put("RandomSeed", nbt::tag_long(static_cast<qint64>(random.generate64())));
+    data.put("DataVersion", nbt::tag_int(3465));
+    nbt::tag_compound root;
+    root.put("Data", std::move(data));
+
+    std::ostringstream s;
+    nbt::io::write_tag("", root, s);
+    QByteArray compressed;
+    GZip::zip(QByteArray(s.str().data(), static_cast<int>(s.str().size())), compressed);
+    return compressed;
+}
+
+bool writeWorld(const QString& folder, QRandomGenerator& random, int index, int files)
+{
+    auto name = QString("%1 %2").arg(words(random, 2)).arg(index);
+    auto world = FS::PathCombine(folder, name);
+    const QStringList subfolders{ "region", "entities", "poi", "playerdata", "data" };
+    for (auto& subfolder : subfolders) {
+        if (!FS::ensureFolderPathExists(FS::PathCombine(world, subfolder))) {
+            return false;
+        }
+    }
+    if (!writeFile(FS::PathCombine(world, "level.dat"), levelDat(random, name))) {
+        return false;
+    }
+    // mostly chunks, like worlds are
+    for (int i = 0; i < files; i++) {
+        auto kind = random.bounded(10);
+        QString path;
+        if (kind < 8) {
+            auto subfolder = subfolders[kind % 3];
+            path = FS::PathCombine(world, subfolder, QString("r.%1.%2.mca").arg(i % 200 - 100).arg(i / 200 - 100));
+        } else if (kind == 8) {
+            path = FS::PathCombine(world, "playerdata", QString("%1.dat").arg(i));
+        } else {
+            path = FS::PathCombine(world, "data", QString("map_%1.dat").arg(i));
+        }
+        if (!writeFile(path, randomBytes(random, random.bounded(256, 4096)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeLog(const QString& path, QRandomGenerator& random, int lines)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const char* const threads[] = { "main", "Render thread", "Server thread", "Worker-Main-3", "IO-Worker-12" };
+    QByteArray chunk;
+    for (int line = 0; line < lines; line++) {
+        auto seconds = line / 500;
+        auto time = QString("[%1:%2:%3]")
+                        .arg(12 + seconds / 3600, 2, 10, QChar('0'))
+                        .arg(seconds / 60 % 60, 2, 10, QChar('0'))
+                        .arg(seconds % 60, 2, 10, QChar('0'));
+        QString thread = threads[random.bounded(static_cast<int>(std::size(threads)))];
+        auto kind = random.bounded(100);
+        auto pair = words(random, 2);
+        QString text;
+        if (kind < 85) {
+            text = QString("%1 [%2/INFO]: Loaded %3 in %4ms").arg(time, thread, pair).arg(random.bounded(1000));
+        } else if (kind < 97) {
+            text = QString("%1 [%2/WARN]: Missing %3_%4").arg(time, thread, pair.replace(' ', " for ")).arg(random.bounded(500));
+        } else {
+            // an exception with a bit of a trace, these are what the log view spends its time on
+            text = QString("%1 [%2/ERROR]: Exception in %3 is null\njava.lang.NullPointerException").arg(time, thread, pair);
+            auto frames = random.bounded(3, 15);
+            for (int i = 0; i < frames && line + 1 < lines; i++, line++) {
+                auto frame = words(random, 2, ".");
+                text += QString("\n\tat com.example.%1.run(%2.java:%3)").arg(frame, frame.section('.', 1)).arg(random.bounded(2000));
+            }
+        }
+        chunk += text.toUtf8();
+        chunk += '\n';
+        if (chunk.size() > 1 << 20) {
+            if (file.write(chunk) != chunk.size()) {
+                return false;
+            }
+            chunk.clear();
+        }
+    }
+    return file.write(chunk) == chunk.size();
+}
+
+}  // namespace
+
+bool generate(const QString& path, const Scale& scale)
+{
+    QRandomGenerator random(scale.seed);
+    auto name = QString("Synthetic %1").arg(words(random, 2));
+    auto minecraft = FS::PathCombine(path, ".minecraft");
+    auto mods = FS::PathCombine(minecraft, "mods");
+    auto resourcePacks = FS::PathCombine(minecraft, "resourcepacks");
+    auto saves = FS::PathCombine(minecraft, "saves");
+    auto logs = FS::PathCombine(minecraft, "logs");
+    for (auto& folder : { mods, resourcePacks, saves, logs }) {
+        if (!FS::ensureFolderPathExists(folder)) {
+            return false;
+        }
+    }
+
+    auto config = QString("InstanceType=OneSix\nname=%1\niconKey=default\n").arg(name);
+    QJsonObject pack{ { "formatVersion", 1 },
+                      { "components", QJsonArray{ QJsonObject{ { "uid", "net.minecraft" }, { "version", "1.20.1" }, { "important", true } },
+                                                  QJsonObject{ { "uid", "net.fabricmc.fabric-loader" }, { "version", "0.15.11" } } } } };
+    if (!writeFile(FS::PathCombine(path, "instance.cfg"), config.toUtf8()) ||
+        !writeFile(FS::PathCombine(path, "mmc-pack.json"), QJsonDocument(pack).toJson())) {
+        return false;
+    }
+
+    for (int i = 0; i < scale.mods; i++) {
+        // mostly Fabric, with the Forge ones a pack picks up on the way
+        auto written = i % 4 == 3 ? writeForgeMod(mods, random, i) : writeFabricMod(mods, random, i);
+        if (!written) {
+            return false;
+        }
+    }
+    for (int i = 0; i < scale.resourcePacks; i++) {
+        if (!writeResourcePack(resourcePacks, random, i)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < scale.worlds; i++) {
+        auto files = scale.worldFiles / scale.worlds + (i < scale.worldFiles % scale.worlds ? 1 : 0);
+        if (!writeWorld(saves, random, i, files)) {
+            return false;
+        }
+    }
+    return writeLog(FS::PathCombine(logs, "latest.log"), random, scale.logLines);
+}
+
+bool generateInstances(const QString& path, int count, const Scale& scale)
+{
+    for (int i = 0; i < count; i++) {
+        auto instance = scale;
+        instance.seed = scale.seed + i;
+        if (!generate(FS::PathCombine(path, QString("synthetic-%1").arg(i)), instance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace SyntheticInstance
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+
+/**
+ * Writes instances the size of the ones people actually have, for the tests and benchmarks that are about scale.
+ *
+ * Everything comes out of a generator seeded by the scale, so the same scale gives the same files byte for byte: mod
+ * jars with a fabric.mod.json or a mods.toml and an icon, resource packs, worlds with a level.dat and region files, and
+ * a latest.log of game output. The defaults are what a big modpack instance looks like, small() is for tests that only
+ * need a bit of everything.
+ */
+namespace SyntheticInstance {
+
+struct Scale {
+    int mods = 500;
+    int resourcePacks = 40;
+    int worlds = 4;
+    // spread over the worlds
+    int worldFiles = 50000;
+    int logLines = 1000000;
+    quint32 seed = 1;
+
+    static Scale small()
+    {
+        Scale scale;
+        scale.mods = 20;
+        scale.resourcePacks = 4;
+        scale.worlds = 2;
+        scale.worldFiles = 200;
+        scale.logLines = 2000;
+        return scale;
+    }
+};
+
+/// write one instance into path, which is created if needed
+bool generate(const QString& path, const Scale& scale = {});
+
+/// write count instances into path like an instances folder, each seeded after the one before
+bool generateInstances(const QString& path, int count, const Scale& scale = Scale::small());
+
+}  // namespace SyntheticInstance
@@ -0,0 +1,96 @@
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <FileSystem.h>
+
+#include <minecraft/mod/ModFolderModel.h>
+
+#include "SyntheticInstance.h"
+
+class SyntheticInstanceTest : public QObject {
+    Q_OBJECT
+
+    static QMap<QString, QByteArray> contents(const QString& root)
+    {
+        QMap<QString, QByteArray> files;
+        QDir base(root);
+        QDirIterator it(root, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            auto path = it.next();
+            QFile file(path);
+            file.open(QIODevice::ReadOnly);
+            files.insert(base.relativeFilePath(path), file.readAll());
+        }
+        return files;
+    }
+
+    static bool loadMods(ModFolderModel& model)
+    {
+        QEventLoop loop;
+        connect(&model, &ResourceFolderModel::updateFinished, &loop, &QEventLoop::quit);
+        QTimer expire;
+        expire.setSingleShot(true);
+        expire.callOnTimeout(&loop, &QEventLoop::quit);
+        expire.start(60000);
+        model.update();
+        loop.exec();
+        return expire.isActive();
+    }
+
+   private slots:
+    void test_deterministic()
+    {
+        QTemporaryDir first;
+        QTemporaryDir second;
+        QVERIFY(SyntheticInstance::generate(first.path(), SyntheticInstance::Scale::small()));
+        QVERIFY(SyntheticInstance::generate(second.path(), SyntheticInstance::Scale::small()));
+        auto files = contents(first.path());
+        QVERIFY(files.contains("instance.cfg"));
+        QVERIFY(files.contains("mmc-pack.json"));
+        QVERIFY(files.contains(".minecraft/logs/latest.log"));
+        QVERIFY(files == contents(second.path()));
+
+        QTemporaryDir other;
+        auto scale = SyntheticInstance::Scale::small();
+        scale.seed = 2;
+        QVERIFY(SyntheticInstance::generate(other.path(), scale));
+        QVERIFY(files != contents(other.path()));
+    }
+
+    void test_modsParse()
+    {
+        QTemporaryDir dir;
+        auto scale = SyntheticInstance::Scale::small();
+        QVERIFY(SyntheticInstance::generate(dir.path(), scale));
+
+        ModFolderModel model(FS::PathCombine(dir.path(), ".minecraft", "mods"), nullptr, false, false);
+        QVERIFY(loadMods(model));
+        QCOMPARE(model.size(), qsizetype(scale.mods));
+    }
+
+    // a modpack's worth of mods, what opening the mods page of a big instance costs
+    void benchmark_loadMods()
+    {
+        QTemporaryDir dir;
+        SyntheticInstance::Scale scale;
+        scale.resourcePacks = 0;
+        scale.worlds = 0;
+        scale.worldFiles = 0;
+        scale.logLines = 0;
+        QVERIFY(SyntheticInstance::generate(dir.path(), scale));
+
+        QBENCHMARK
+        {
+            ModFolderModel model(FS::PathCombine(dir.path(), ".minecraft", "mods"), nullptr, false, false);
+            QVERIFY(loadMods(model));
+            QCOMPARE(model.size(), qsizetype(scale.mods));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(SyntheticInstanceTest)
+
+#include "SyntheticInstance_test.moc"
@@ -1,3 +1,4 @@
+#include <QSignalSpy>
 #include <QTest>
 #include <QThread>
 #include <QTimer>
@@ -6,6 +7,7 @@
 #include <tasks/MultipleOptionsTask.h>
 #include <tasks/SequentialTask.h>
 #include <tasks/Task.h>
+#include <tasks/TaskGraph.h>
 
 #include <array>
 
@@ -22,7 +24,59 @@ class BasicTask : public Task {
     void executeTask() override { emitSucceeded(); }
 };
 
+/* Fails the first `failures` times it runs. Only used for testing. */
+class FlakyTask : public Task {
+    Q_OBJECT
+
+   public:
+    FlakyTask(int failures) : Task(nullptr, false), m_failures(failures) {}
+
+    int runs = 0;
+
+   private:
+    void executeTask() override
+    {
+        if (runs++ < m_failures)
+            emitFailed("flaky");
+        else
+            emitSucceeded();
+    }
+
+    int m_failures;
+};
+
 /* Does nothing. Only used for testing. */
+/* Finishes `delay` after it starts, unless it's aborted. Only used for testing. */
+class DelayedTask : public Task {
+    Q_OBJECT
+
+   public:
+    DelayedTask(int delay, bool succeed = true) : Task(nullptr, false), m_delay(delay), m_succeed(succeed)
+    {
+        setAbortable(true);
+        m_timer.setSingleShot(true);
+        connect(&m_timer, &QTimer::timeout, this, [this] {
+            if (m_succeed)
+                emitSucceeded();
+            else
+                emitFailed("failed");
+        });
+    }
+
+    bool abort() override
+    {
+        m_timer.stop();
+        return Task::abort();
+    }
+
+   private:
+    void executeTask() override { m_timer.start(m_delay); }
+
+    QTimer m_timer;
+    int m_delay;
+    bool m_succeed;
+};
+
 class BasicTask_MultiStep : public Task {
     Q_OBJECT
 
@@ -121,6 +175,38 @@ class TaskTest : public QObject {
         QCOMPARE(t.getTotalProgress(), total);
     }
 
+    void test_SetProgress_Throttled()
+    {
+        BasicTask t;
+        QSignalSpy spy(&t, &Task::progress);
+
+        for (int i = 1; i <= 1000; i++)
+            t.setProgress(i, 1000);
+
+        // the first one goes out right away, the rest come together
+        QCOMPARE(spy.count(), 1);
+        QVERIFY(QTest::qWaitFor([&]() { return spy.count() == 2; }, 1000));
+        QCOMPARE(spy.last().at(0).toLongLong(), 1000);
+        QCOMPARE(spy.last().at(1).toLongLong(), 1000);
+        QTest::qWait(100);
+        QCOMPARE(spy.count(), 2);
+    }
+
+    void test_SetProgress_FinalBeforeFinished()
+    {
+        BasicTask t;
+        qint64 last = -1;
+        QObject::connect(&t, &Task::progress, [&](qint64 current, qint64) { last = current; });
+        QObject::connect(&t, &Task::finished, [&] { QCOMPARE(last, 2); });
+
+        t.setProgress(1, 2);
+        t.setProgress(2, 2);
+        QCOMPARE(last, 1);
+        t.start();
+
+        QCOMPARE(last, 2);
+    }
+
     void test_basicRun()
     {
         BasicTask t;
@@ -242,6 +328,128 @@ class TaskTest : public QObject {
         QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
     }
 
+    void test_hedgedMultipleOptionsRun()
+    {
+        // the first is slow, the second starts after the delay and wins
+        auto slow = makeShared<DelayedTask>(2000);
+        auto fast = makeShared<DelayedTask>(10);
+        auto unused = makeShared<DelayedTask>(10);
+
+        MultipleOptionsTask t;
+        t.setHedging(std::chrono::milliseconds(50), 2);
+        t.addTask(slow);
+        t.addTask(fast);
+        t.addTask(unused);
+
+        QElapsedTimer clock;
+        clock.start();
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+        QVERIFY(clock.elapsed() < 1000);
+        QVERIFY(fast->wasSuccessful());
+        QCOMPARE(slow->getState(), Task::State::AbortedByUser);
+        QCOMPARE(unused->getState(), Task::State::Inactive);
+    }
+
+    void test_hedgedMultipleOptionsFailures()
+    {
+        // a failure makes way for the next one without waiting for the delay
+        auto failing = makeShared<DelayedTask>(10, false);
+        auto second = makeShared<DelayedTask>(10);
+
+        MultipleOptionsTask t;
+        t.setHedging(std::chrono::milliseconds(5000), 2);
+        t.addTask(failing);
+        t.addTask(second);
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+        QVERIFY(second->wasSuccessful());
+
+        auto first = makeShared<DelayedTask>(10, false);
+        auto last = makeShared<DelayedTask>(20, false);
+        MultipleOptionsTask all;
+        all.setHedging(std::chrono::milliseconds(0), 2);
+        all.addTask(first);
+        all.addTask(last);
+        all.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return all.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!all.wasSuccessful());
+        QVERIFY(first->isFinished() && last->isFinished());
+    }
+
+    void test_taskGraphOrder()
+    {
+        auto first = makeShared<BasicTask>();
+        auto second = makeShared<BasicTask>();
+        auto independent = makeShared<BasicTask>();
+
+        TaskGraph t;
+        t.addTask(second, { first });
+        t.addTask(first);
+        t.addTask(independent);
+
+        QObject::connect(second.get(), &Task::started, [&] { QVERIFY(first->wasSuccessful()); });
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+        QVERIFY(second->wasSuccessful());
+        QVERIFY(independent->wasSuccessful());
+    }
+
+    void test_taskGraphRetry()
+    {
+        auto flaky = makeShared<FlakyTask>(2);
+        auto after = makeShared<BasicTask>();
+
+        TaskGraph t;
+        t.addTask(flaky, {}, 2);
+        t.addTask(after, { flaky });
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(t.wasSuccessful());
+        QCOMPARE(flaky->runs, 3);
+        QVERIFY(after->wasSuccessful());
+    }
+
+    void test_taskGraphDependencyFailed()
+    {
+        auto failing = makeShared<FlakyTask>(1);
+        auto dependent = makeShared<BasicTask>();
+        auto independent = makeShared<BasicTask>();
+
+        TaskGraph t;
+        t.addTask(failing);
+        t.addTask(dependent, { failing });
+        t.addTask(independent);
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!t.wasSuccessful());
+        QCOMPARE(t.failReason(), QString("flaky"));
+        QCOMPARE(dependent->getState(), Task::State::Inactive);
+        QVERIFY(independent->wasSuccessful());
+    }
+
+    void test_taskGraphCycle()
+    {
+        auto a = makeShared<BasicTask>();
+        auto b = makeShared<BasicTask>();
+
+        TaskGraph t;
+        t.addTask(a, { b });
+        t.addTask(b, { a });
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        QVERIFY(!t.wasSuccessful());
+        QCOMPARE(a->getState(), Task::State::Inactive);
+    }
+
     void test_stackOverflowInConcurrentTask()
     {
         QEventLoop loop;
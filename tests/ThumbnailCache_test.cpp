@@ -0,0 +1,78 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <screenshots/ThumbnailCache.h>
+
+class ThumbnailCacheTest : public QObject {
+    Q_OBJECT
+
+    static QString writeScreenshot(const QTemporaryDir& dir, const QString& name, const QSize& size, const QColor& color)
+    {
+        QImage image(size, QImage::Format_RGB32);
+        image.fill(color);
+        auto path = dir.filePath(name);
+        image.save(path);
+        return path;
+    }
+
+   private slots:
+    void test_make()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = writeScreenshot(dir, "wide.png", QSize(1920, 1080), Qt::red);
+
+        auto thumbnail = ThumbnailCache::make(path, 256);
+        QCOMPARE(thumbnail.size(), QSize(256, 256));
+        // letterboxed, the middle has the picture and the top is see-through
+        QCOMPARE(QColor(thumbnail.pixel(128, 128)), QColor(Qt::red));
+        QCOMPARE(qAlpha(thumbnail.pixel(128, 0)), 0);
+
+        QVERIFY(ThumbnailCache::make(dir.filePath("missing.png"), 256).isNull());
+    }
+
+    void test_storeAndFind()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = writeScreenshot(dir, "shot.png", QSize(640, 480), Qt::blue);
+        ThumbnailCache cache(dir.filePath("thumbnails"));
+
+        QVERIFY(cache.find(QFileInfo(path)).isNull());
+        auto thumbnail = ThumbnailCache::make(path, 256);
+        QVERIFY(cache.store(QFileInfo(path), thumbnail));
+        auto found = cache.find(QFileInfo(path));
+        QCOMPARE(found.size(), thumbnail.size());
+
+        // the spec names it after the URI
+        QCOMPARE(QDir(dir.filePath("thumbnails")).entryList(QDir::Files).size(), 1);
+    }
+
+    void test_staleAfterChange()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        auto path = writeScreenshot(dir, "shot.png", QSize(640, 480), Qt::blue);
+        ThumbnailCache cache(dir.filePath("thumbnails"));
+        QVERIFY(cache.store(QFileInfo(path), ThumbnailCache::make(path, 256)));
+
+        // replaced by a different picture, with a different size on disk
+        writeScreenshot(dir, "shot.png", QSize(800, 600), Qt::green);
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        file.close();
+        QVERIFY(cache.find(QFileInfo(path)).isNull());
+
+        cache.remove(QFileInfo(path));
+        QCOMPARE(QDir(dir.filePath("thumbnails")).entryList(QDir::Files).size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(ThumbnailCacheTest)
+
+#include "ThumbnailCache_test.moc"
@@ -0,0 +1,58 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <Trace.h>
+
+class TraceTest : public QObject {
+    Q_OBJECT
+
+    static QJsonArray read(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return QJsonDocument::fromJson(file.readAll()).array();
+    }
+
+   private slots:
+    void test_disabled()
+    {
+        QVERIFY(!Trace::isEnabled());
+        bool evaluated = false;
+        {
+            TRACE_SPAN("test", (evaluated = true, QString("span")));
+        }
+        QVERIFY(!evaluated);
+    }
+
+    void test_events()
+    {
+        QTemporaryDir dir;
+        auto path = dir.filePath("trace.json");
+        QVERIFY(Trace::start(path));
+        {
+            TRACE_SPAN("test", "span");
+        }
+        int id = 0;
+        Trace::asyncBegin("test", "async", &id);
+        Trace::asyncEnd("test", "async", &id);
+        Trace::stop();
+        QVERIFY(!Trace::isEnabled());
+
+        QStringList phases;
+        for (auto event : read(path)) {
+            auto object = event.toObject();
+            if (object["ph"].toString() != "M")
+                QCOMPARE(object["cat"].toString(), QString("test"));
+            phases.append(object["ph"].toString());
+        }
+        QCOMPARE(phases, QStringList({ "M", "X", "b", "e" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(TraceTest)
+
+#include "Trace_test.moc"
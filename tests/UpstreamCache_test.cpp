@@ -0,0 +1,54 @@
+#include <QTest>
+
+#include <net/UpstreamCache.h>
+
+class UpstreamCacheTest : public QObject {
+    Q_OBJECT
+
+   private slots:
+    void test_rewrite()
+    {
+        Net::UpstreamCache cache;
+        auto rewrite = [&cache](const char* url) { return cache.rewrite(QUrl(url)).value_or(QUrl()); };
+        cache.setRules(
+            "https://piston-data.mojang.com/ http://cache.lan/mojang/\n"
+            "https://cdn.modrinth.com/data/ http://cache.lan/modrinth\n"
+            "not a rule\n");
+
+        QCOMPARE(rewrite("https://piston-data.mojang.com/v1/objects/abc/client.jar"),
+                 QUrl("http://cache.lan/mojang/v1/objects/abc/client.jar"));
+        QCOMPARE(rewrite("https://cdn.modrinth.com/data/AANobbMI/versions/x/sodium.jar"),
+                 QUrl("http://cache.lan/modrinth/AANobbMI/versions/x/sodium.jar"));
+        QVERIFY(!cache.rewrite(QUrl("https://cdn.modrinth.com/other/file")));
+        QVERIFY(!cache.rewrite(QUrl("https://libraries.minecraft.net/a.jar")));
+
+        cache.setRules("* http://cache.lan/any");
+        QCOMPARE(rewrite("https://libraries.minecraft.net/a.jar?x=1"), QUrl("http://cache.lan/any/libraries.minecraft.net/a.jar?x=1"));
+    }
+
+    void test_fallback()
+    {
+        Net::UpstreamCache cache(std::chrono::milliseconds(50));
+        cache.setRules("https://meta.prismlauncher.org/ http://cache.lan/meta/");
+        QUrl origin("https://meta.prismlauncher.org/v1/index.json");
+
+        auto cached = cache.rewrite(origin);
+        QVERIFY(cached);
+        cache.reportFailure(*cached);
+        cache.reportFailure(*cached);
+        QVERIFY(cache.rewrite(origin));
+        cache.reportFailure(*cached);
+        QVERIFY(!cache.rewrite(origin));
+
+        // once the wait is over one request checks on it
+        QTest::qWait(80);
+        QVERIFY(cache.rewrite(origin));
+        QVERIFY(!cache.rewrite(origin));
+        cache.reportSuccess(*cached);
+        QVERIFY(cache.rewrite(origin));
+    }
+};
+
+QTEST_GUILESS_MAIN(UpstreamCacheTest)
+
+#include "UpstreamCache_test.moc"
@@ -0,0 +1,123 @@
+#include <QTest>
+
+#include <BaseVersion.h>
+#include <BaseVersionList.h>
+#include <Filter.h>
+#include <VersionProxyModel.h>
+
+class TestVersion : public BaseVersion {
+   public:
+    TestVersion(const QString& name, const QString& type, qint64 time) : m_name(name), m_type(type), m_time(time) {}
+    QString descriptor() override { return m_name; }
+    QString name() override { return m_name; }
+    QString typeString() const override { return m_type; }
+
+    QString m_name;
+    QString m_type;
+    qint64 m_time;
+};
+
+class TestVersionList : public BaseVersionList {
+   public:
+    Task::Ptr getLoadTask() override { return nullptr; }
+    bool isLoaded() override { return true; }
+    const BaseVersion::Ptr at(int i) const override { return m_versions.at(i); }
+    int count() const override { return m_versions.size(); }
+    void sortVersions() override {}
+    RoleList providesRoles() const override { return { VersionPointerRole, VersionRole, VersionIdRole, TypeRole, SortRole }; }
+
+    QVariant data(const QModelIndex& index, int role) const override
+    {
+        if (role == SortRole && index.isValid())
+            return m_versions.at(index.row())->m_time;
+        return BaseVersionList::data(index, role);
+    }
+
+    void add(const QString& name, const QString& type, qint64 time)
+    {
+        beginInsertRows(QModelIndex(), m_versions.size(), m_versions.size());
+        m_versions.append(std::make_shared<TestVersion>(name, type, time));
+        endInsertRows();
+    }
+
+    void setTime(int row, qint64 time)
+    {
+        m_versions[row]->m_time = time;
+        emit dataChanged(index(row), index(row), { SortRole });
+    }
+
+   protected:
+    void updateListData(QList<BaseVersion::Ptr>) override {}
+
+   public:
+    QList<std::shared_ptr<TestVersion>> m_versions;
+};
+
+class VersionProxyModelTest : public QObject {
+    Q_OBJECT
+
+    QStringList shown(const VersionProxyModel& model)
+    {
+        QStringList names;
+        for (int i = 0; i < model.rowCount(); i++)
+            names.append(model.data(model.index(i, 0), BaseVersionList::VersionRole).toString());
+        return names;
+    }
+
+   private slots:
+    void test_filterAndSearch()
+    {
+        TestVersionList list;
+        list.add("1.20.1", "release", 5);
+        list.add("1.20.1-pre1", "snapshot", 4);
+        list.add("1.19.4", "release", 3);
+        list.add("23w31a", "snapshot", 6);
+        list.add("1.20", "release", 2);
+
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        QCOMPARE(shown(model), QStringList({ "23w31a", "1.20.1", "1.20.1-pre1", "1.19.4", "1.20" }));
+
+        model.setFilter(BaseVersionList::TypeRole, new ExactFilter("release"));
+        QCOMPARE(shown(model), QStringList({ "1.20.1", "1.19.4", "1.20" }));
+
+        model.setSearch("1.2");
+        QCOMPARE(shown(model), QStringList({ "1.20.1", "1.20" }));
+        // typing more only narrows it down
+        model.setSearch("1.20.");
+        QCOMPARE(shown(model), QStringList({ "1.20.1" }));
+        // and removing some widens it again
+        model.setSearch("1.");
+        QCOMPARE(shown(model), QStringList({ "1.20.1", "1.19.4", "1.20" }));
+
+        model.setFilter(BaseVersionList::TypeRole, new ExactFilter("snapshot"));
+        QCOMPARE(shown(model), QStringList({ "1.20.1-pre1" }));
+
+        model.clearFilters();
+        QCOMPARE(shown(model), QStringList({ "23w31a", "1.20.1", "1.20.1-pre1", "1.19.4", "1.20" }));
+    }
+
+    void test_sourceChanges()
+    {
+        TestVersionList list;
+        list.add("1.20.1", "release", 5);
+        list.add("1.19.4", "release", 3);
+
+        VersionProxyModel model;
+        model.setSourceModel(&list);
+        model.setSearch("1.");
+        QCOMPARE(shown(model), QStringList({ "1.20.1", "1.19.4" }));
+
+        list.add("1.20.2", "release", 7);
+        list.add("23w31a", "snapshot", 6);
+        QCOMPARE(shown(model), QStringList({ "1.20.2", "1.20.1", "1.19.4" }));
+
+        // moves with its sort key
+        list.setTime(1, 8);
+        QCOMPARE(shown(model), QStringList({ "1.19.4", "1.20.2", "1.20.1" }));
+    }
+};
+
+QTEST_GUILESS_MAIN(VersionProxyModelTest)
+
+#include "VersionProxyModel_test.moc"
@@ -15,6 +15,8 @@
 
 #include <QTest>
 
+#include <algorithm>
+
 #include <Version.h>
 
 class VersionTest : public QObject {
@@ -178,6 +180,40 @@ class VersionTest : public QObject {
         QCOMPARE(v1 > v2, !lessThan && !equal);
         QCOMPARE(v1 == v2, equal);
     }
+
+    // shaped like the Minecraft and Forge version lists, which get sorted whole
+    void benchmark_sortVersionLists()
+    {
+        QList<Version> versions;
+        for (int minor = 0; minor <= 20; minor++) {
+            for (int patch = 0; patch <= 6; patch++) {
+                auto release = patch ? QString("1.%1.%2").arg(minor).arg(patch) : QString("1.%1").arg(minor);
+                versions.append(Version(release));
+                for (int pre = 1; pre <= 3; pre++) {
+                    versions.append(Version(QString("%1-pre%2").arg(release).arg(pre)));
+                    versions.append(Version(QString("%1-rc%2").arg(release).arg(pre)));
+                }
+                for (int forge = 0; forge < 40; forge++) {
+                    versions.append(Version(QString("%1-%2.%3.%4").arg(release).arg(minor + 20).arg(forge / 10).arg(forge % 10)));
+                }
+            }
+        }
+        for (int year = 13; year <= 23; year++) {
+            for (int week = 1; week <= 52; week += 3) {
+                versions.append(Version(QString("%1w%2a").arg(year).arg(week, 2, 10, QChar('0'))));
+            }
+        }
+        // sorting an already sorted list says little
+        for (int i = 0; i < versions.size(); i++) {
+            versions.swapItemsAt(i, (i * 7919) % versions.size());
+        }
+
+        QBENCHMARK
+        {
+            auto sorted = versions;
+            std::sort(sorted.begin(), sorted.end());
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(VersionTest)
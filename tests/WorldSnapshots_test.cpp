@@ -0,0 +1,66 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/WorldSnapshots.h>
+
+class WorldSnapshotsTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray region(char fill)
+    {
+        // three sectors and a bit, each one different
+        QByteArray data;
+        for (char c : { 'a', 'b', fill })
+            data += QByteArray(4096, c);
+        return data + QByteArray(100, 'z');
+    }
+
+   private slots:
+    void test_takeAndRestore()
+    {
+        QTemporaryDir tmp;
+        auto world = FS::PathCombine(tmp.path(), "saves", "New World");
+        FS::write(FS::PathCombine(world, "level.dat"), "level");
+        FS::write(FS::PathCombine(world, "session.lock"), "lock");
+        FS::write(FS::PathCombine(world, "region", "r.0.0.mca"), region('c'));
+
+        auto store = FS::PathCombine(tmp.path(), "snapshots");
+        WorldSnapshots snapshots(store);
+        QString error;
+        auto first = snapshots.take(world, error);
+        QVERIFY2(!first.isEmpty(), qPrintable(error));
+        auto pack = FS::PathCombine(store, "sectors.pack");
+        QCOMPARE(QFileInfo(pack).size(), 3 * 4096 + 100);
+
+        // a chunk changed, only its sector gets stored
+        QTest::qWait(20);
+        FS::write(FS::PathCombine(world, "region", "r.0.0.mca"), region('d'));
+        auto second = snapshots.take(world, error);
+        QVERIFY2(!second.isEmpty(), qPrintable(error));
+        QVERIFY(first != second);
+        QCOMPARE(QFileInfo(pack).size(), 4 * 4096 + 100);
+
+        auto list = snapshots.list("New World");
+        QCOMPARE(list.size(), 2);
+        QCOMPARE(list.first().id, first);
+        QCOMPARE(list.first().size, qint64(5 + 3 * 4096 + 100));
+
+        auto restored = FS::PathCombine(tmp.path(), "restored");
+        QVERIFY2(snapshots.restore(first, restored, error), qPrintable(error));
+        QCOMPARE(FS::read(FS::PathCombine(restored, "level.dat")), QByteArray("level"));
+        QCOMPARE(FS::read(FS::PathCombine(restored, "region", "r.0.0.mca")), region('c'));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(restored, "session.lock")));
+
+        // it must not restore over something
+        QVERIFY(!snapshots.restore(second, restored, error));
+
+        auto latest = FS::PathCombine(tmp.path(), "latest");
+        QVERIFY2(WorldSnapshots(store).restore(second, latest, error), qPrintable(error));
+        QCOMPARE(FS::read(FS::PathCombine(latest, "region", "r.0.0.mca")), region('d'));
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldSnapshotsTest)
+
+#include "WorldSnapshots_test.moc"
@@ -0,0 +1,87 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <minecraft/WorldSummaryCache.h>
+
+class WorldSummaryCacheTest : public QObject {
+    Q_OBJECT
+
+    static void writeFile(const QString& path, const QByteArray& data)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), data.size());
+    }
+
+    static WorldSummary summary()
+    {
+        WorldSummary summary;
+        summary.name = "New World";
+        summary.lastPlayed = QDateTime::fromMSecsSinceEpoch(1700000000000);
+        summary.gameType = 1;
+        // more than a double holds exactly
+        summary.seed = -4530634556500121041;
+        return summary;
+    }
+
+   private slots:
+    void test_changedLevelDatMisses()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QVERIFY(QDir(dir.path()).mkdir("world"));
+        QFileInfo world(dir.filePath("world"));
+        writeFile(dir.filePath("world/level.dat"), "not really a level.dat");
+
+        WorldSummaryCache cache;
+        QVERIFY(!cache.get(world));
+
+        cache.put(world, summary());
+        auto cached = cache.get(world);
+        QVERIFY(cached);
+        QCOMPARE(cached->name, QString("New World"));
+        QCOMPARE(cached->size, int64_t(-1));
+
+        cache.putSize("world", 1234);
+        QCOMPARE(cache.get(world)->size, int64_t(1234));
+
+        writeFile(dir.filePath("world/level.dat"), "the world was played since");
+        QVERIFY(!cache.get(world));
+    }
+
+    void test_saveAndLoad()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QVERIFY(QDir(dir.path()).mkdir("world"));
+        QFileInfo world(dir.filePath("world"));
+        writeFile(dir.filePath("world/level.dat"), "not really a level.dat");
+        auto cache_file = dir.filePath(".worlds.json");
+
+        {
+            WorldSummaryCache cache(cache_file);
+            auto withSize = summary();
+            withSize.size = 5000000000;
+            cache.put(world, withSize);
+            cache.saveNow();
+        }
+
+        WorldSummaryCache cache(cache_file);
+        cache.load();
+        auto cached = cache.get(world);
+        QVERIFY(cached);
+        QCOMPARE(cached->name, QString("New World"));
+        QCOMPARE(cached->lastPlayed, summary().lastPlayed);
+        QVERIFY(cached->gameType);
+        QCOMPARE(*cached->gameType, 1);
+        QCOMPARE(cached->seed, summary().seed);
+        QCOMPARE(cached->size, int64_t(5000000000));
+    }
+};
+
+QTEST_GUILESS_MAIN(WorldSummaryCacheTest)
+
+#include "WorldSummaryCache_test.moc"